@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     computeAsync.i (interfaces)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+%{
+#include <string>
+#include <type_traits>
+%}
+
+%{
+    namespace ELL_API
+    {
+    // Computes a compiled map on a libuv worker thread, reading the input from and writing the output to typed
+    // arrays that the caller allocates. The worker keeps the map and the arrays alive until it calls back.
+    template <typename ElementType>
+    class ComputeWorker : public Nan::AsyncWorker
+    {
+    public:
+        ComputeWorker(Nan::Callback* doneCallback, CompiledMap* map, v8::Local<v8::Value> mapObject, v8::Local<v8::Value> input, v8::Local<v8::Value> output) :
+            Nan::AsyncWorker(doneCallback),
+            _map(map)
+        {
+            SaveToPersistent("map", mapObject);
+            SaveToPersistent("input", input);
+            SaveToPersistent("output", output);
+
+            Nan::TypedArrayContents<ElementType> inputContents(input);
+            Nan::TypedArrayContents<ElementType> outputContents(output);
+            _input = *inputContents;
+            _inputLength = inputContents.length();
+            _output = *outputContents;
+            _outputLength = outputContents.length();
+        }
+
+        virtual void Execute() override
+        {
+            try
+            {
+                Compute(_input, _inputLength, _output, _outputLength);
+            }
+            catch (const ell::utilities::Exception& e)
+            {
+                SetErrorMessage(e.GetMessage().c_str());
+            }
+            catch (const std::exception& e)
+            {
+                SetErrorMessage(e.what());
+            }
+        }
+
+        virtual void HandleOKCallback() override
+        {
+            Nan::HandleScope scope;
+            v8::Local<v8::Value> argv[] = { Nan::Null(), GetFromPersistent("output") };
+            callback->Call(2, argv);
+        }
+
+    private:
+        void Compute(const double* input, size_t inputLength, double* output, size_t outputLength)
+        {
+            _map->ComputeDoubleIntoConcurrent(input, inputLength, output, outputLength);
+        }
+
+        void Compute(const float* input, size_t inputLength, float* output, size_t outputLength)
+        {
+            _map->ComputeFloatIntoConcurrent(input, inputLength, output, outputLength);
+        }
+
+        CompiledMap* _map;
+        const ElementType* _input = nullptr;
+        size_t _inputLength = 0;
+        ElementType* _output = nullptr;
+        size_t _outputLength = 0;
+    };
+
+    template <typename ElementType>
+    std::string QueueComputeWorker(v8::Local<v8::Value> mapObject, v8::Local<v8::Value> input, v8::Local<v8::Value> output, Callback doneCb)
+    {
+        void* map = nullptr;
+        if (!SWIG_IsOK(SWIG_ConvertPtr(mapObject, &map, SWIGTYPE_p_ELL_API__CompiledMap, 0)) || map == nullptr)
+        {
+            delete doneCb.GetFunction();
+            return "map is not a CompiledMap";
+        }
+
+        auto isTypedArray = [](v8::Local<v8::Value> value) { return std::is_same<ElementType, float>::value ? value->IsFloat32Array() : value->IsFloat64Array(); };
+        if (!isTypedArray(input) || !isTypedArray(output))
+        {
+            delete doneCb.GetFunction();
+            return "input and output must be typed arrays of the map's element type";
+        }
+
+        Nan::AsyncQueueWorker(new ComputeWorker<ElementType>(doneCb.GetFunction(), static_cast<CompiledMap*>(map), mapObject, input, output));
+        return "";
+    }
+    }
+%}
+
+%inline {
+    namespace ELL_API
+    {
+    // Computes a compiled map on a worker thread, and calls `doneCb(error, output)` on the main thread when the output is
+    // ready. `input` and `output` must be a Float64Array (for ComputeDoubleAsync) or a Float32Array (for
+    // ComputeFloatAsync) of the map's input and output sizes, and must not be used until the callback runs. Several
+    // requests can be in flight against one map; they compute at the same time if the map was compiled with the
+    // `reentrant` option, each with its own copy of the model's state, and take turns otherwise.
+    void ComputeDoubleAsync(v8::Local<v8::Value> map, v8::Local<v8::Value> input, v8::Local<v8::Value> output, Callback doneCb)
+    {
+        auto error = QueueComputeWorker<double>(map, input, output, doneCb);
+        if (!error.empty())
+        {
+            throw std::invalid_argument(error);
+        }
+    }
+
+    void ComputeFloatAsync(v8::Local<v8::Value> map, v8::Local<v8::Value> input, v8::Local<v8::Value> output, Callback doneCb)
+    {
+        auto error = QueueComputeWorker<float>(map, input, output, doneCb);
+        if (!error.empty())
+        {
+            throw std::invalid_argument(error);
+        }
+    }
+    }
+}
@@ -14,7 +14,14 @@
     %include "ELL_javascript_pre.i"
 #endif // SWIGPYTHON
 
+#ifdef SWIGPYTHON
+%module(directors="1", threads="1") "ell"
+
+// Thread support lets wrappers release the GIL, but only the calls that are marked with %thread do
+%nothread;
+#else
 %module(directors="1") "ell"
+#endif // SWIGPYTHON
 
 // Generate decent docstrings from types and method signatures
 %feature("autodoc", "3");
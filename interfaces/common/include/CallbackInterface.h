@@ -9,6 +9,7 @@
 
 #ifndef SWIG
 
+#include <cstddef>
 #include <vector>
 
 #endif
@@ -103,7 +104,25 @@ namespace api
                       size_t outputSize,
                       ell::api::CallbackBase<TimeTickType>& lagCallback);
 
-        /// <summary> Clears callbacks with the forwarder. </summary>
+        /// <summary>
+        /// Registers buffers that the input and output callbacks read from and write to directly, instead of
+        /// calling the callback objects. This avoids a call into the caller's language, and a copy through a vector,
+        /// on every frame. The caller fills the input buffer before each frame, and can check the output count
+        /// to see when a new output has been written.
+        /// </summary>
+        ///
+        /// <param name="inputBuffer"> The input buffer, which must stay valid until `Clear` is called. </param>
+        /// <param name="inputSize"> The input size. </param>
+        /// <param name="outputBuffer"> The output buffer, which must stay valid until `Clear` is called. </param>
+        /// <param name="outputSize"> The output size. </param>
+        void RegisterBuffers(const InputType* inputBuffer, size_t inputSize, OutputType* outputBuffer, size_t outputSize);
+
+        /// <summary> Gets the number of outputs written to the registered output buffer. </summary>
+        ///
+        /// <returns> The number of outputs written since `RegisterBuffers` was called. </returns>
+        size_t GetOutputCount() const { return _outputCount; }
+
+        /// <summary> Clears callbacks and buffers with the forwarder. </summary>
         void Clear();
 
     private:
@@ -114,6 +133,13 @@ namespace api
 
         std::vector<InputType> _inputBuffer;
         std::vector<OutputType> _outputBuffer;
+
+        // The caller's buffers, if registered with RegisterBuffers
+        const InputType* _registeredInputBuffer;
+        OutputType* _registeredOutputBuffer;
+        size_t _registeredInputSize;
+        size_t _registeredOutputSize;
+        size_t _outputCount;
     };
 } // namespace api
 } // namespace ell
@@ -122,6 +148,7 @@ namespace api
 
 #ifndef SWIG
 
+#include <algorithm>
 #include <assert.h>
 #include <stdexcept>
 
@@ -139,7 +166,12 @@ namespace api
     CallbackForwarder<InputType, OutputType>::CallbackForwarder() :
         _inputCallback(nullptr),
         _outputCallback(nullptr),
-        _lagCallback(nullptr)
+        _lagCallback(nullptr),
+        _registeredInputBuffer(nullptr),
+        _registeredOutputBuffer(nullptr),
+        _registeredInputSize(0),
+        _registeredOutputSize(0),
+        _outputCount(0)
     {
     }
 
@@ -151,6 +183,7 @@ namespace api
                                                             CallbackBase<TimeTickType>& lagCallback)
     {
         // Caller owns the lifetime of these objects
+        Clear();
         _inputCallback = &inputCallback;
         _outputCallback = &outputCallback;
         _lagCallback = &lagCallback;
@@ -159,6 +192,22 @@ namespace api
         _outputBuffer.resize(outputSize);
     }
 
+    template <typename InputType, typename OutputType>
+    void CallbackForwarder<InputType, OutputType>::RegisterBuffers(const InputType* inputBuffer, size_t inputSize, OutputType* outputBuffer, size_t outputSize)
+    {
+        if (inputBuffer == nullptr || outputBuffer == nullptr)
+        {
+            throw std::invalid_argument("Buffers must not be null");
+        }
+
+        // Caller owns the lifetime of these buffers
+        Clear();
+        _registeredInputBuffer = inputBuffer;
+        _registeredOutputBuffer = outputBuffer;
+        _registeredInputSize = inputSize;
+        _registeredOutputSize = outputSize;
+    }
+
     template <typename InputType, typename OutputType>
     void CallbackForwarder<InputType, OutputType>::Clear()
     {
@@ -166,6 +215,12 @@ namespace api
         _outputCallback = nullptr;
         _lagCallback = nullptr;
 
+        _registeredInputBuffer = nullptr;
+        _registeredOutputBuffer = nullptr;
+        _registeredInputSize = 0;
+        _registeredOutputSize = 0;
+        _outputCount = 0;
+
         _inputBuffer.resize(0);
         _outputBuffer.resize(0);
     }
@@ -173,6 +228,12 @@ namespace api
     template <typename InputType, typename OutputType>
     bool CallbackForwarder<InputType, OutputType>::InvokeInput(InputType* buffer)
     {
+        if (_registeredInputBuffer != nullptr)
+        {
+            std::copy_n(_registeredInputBuffer, _registeredInputSize, buffer);
+            return true;
+        }
+
         if (_inputCallback == nullptr)
         {
             throw std::invalid_argument("Register has not yet been called");
@@ -190,6 +251,13 @@ namespace api
     template <typename InputType, typename OutputType>
     void CallbackForwarder<InputType, OutputType>::InvokeOutput(const OutputType* buffer)
     {
+        if (_registeredOutputBuffer != nullptr)
+        {
+            std::copy_n(buffer, _registeredOutputSize, _registeredOutputBuffer);
+            ++_outputCount;
+            return;
+        }
+
         if (_outputCallback == nullptr)
         {
             throw std::invalid_argument("Register has not yet been called");
@@ -203,6 +271,13 @@ namespace api
     template <typename InputType, typename OutputType>
     void CallbackForwarder<InputType, OutputType>::InvokeOutput(OutputType value)
     {
+        if (_registeredOutputBuffer != nullptr)
+        {
+            *_registeredOutputBuffer = value;
+            ++_outputCount;
+            return;
+        }
+
         if (_outputCallback == nullptr)
         {
             throw std::invalid_argument("Register has not yet been called");
@@ -37,6 +37,22 @@ public:
     /// <param name="buffer"> The buffer to copy the data into. </param>
     void CopyTo(std::vector<float>& buffer);
 
+    /// <summary>
+    /// Copy the data in this vector to a buffer owned by the caller, such as a numpy array, and fill the rest of
+    /// the buffer with zeros. Values past the end of the buffer are dropped.
+    /// </summary>
+    /// <param name="output"> The buffer to copy the data into. </param>
+    /// <param name="outputLength"> The number of elements in the buffer. </param>
+    void CopyToDoubleBuffer(double* output, size_t outputLength) const;
+
+    /// <summary>
+    /// Copy the data in this vector to a float buffer owned by the caller, such as a numpy array, and fill the rest
+    /// of the buffer with zeros. Values past the end of the buffer are dropped.
+    /// </summary>
+    /// <param name="output"> The buffer to copy the data into. </param>
+    /// <param name="outputLength"> The number of elements in the buffer. </param>
+    void CopyToFloatBuffer(float* output, size_t outputLength) const;
+
 private:
     class AutoDataVectorImpl;
     friend class AutoSupervisedExample;
@@ -83,6 +83,8 @@ public:
     Node AddConcatenationNode(Model model, const ell::api::math::TensorShape& outputShape, const std::vector<PortElements*>& inputs);
     Node AddConstantNode(Model model, std::vector<double> values, PortType type);
     Node AddConstantNode(Model model, std::vector<double> values, const ell::api::math::TensorShape& outputShape, PortType type);
+    Node AddConstantNodeFromDoubleBuffer(Model model, const double* input, size_t inputLength, const PortMemoryLayout& layout, PortType type);
+    Node AddConstantNodeFromFloatBuffer(Model model, const float* input, size_t inputLength, const PortMemoryLayout& layout, PortType type);
     Node AddDCTNode(Model model, PortElements input, int numFilters);
     Node AddNeuralNetworkPredictorNode(Model model, PortElements input, ell::api::predictors::NeuralNetworkPredictor predictor);
     Node AddFFTNode(Model model, PortElements input, int nfft = 0);
@@ -100,7 +102,7 @@ public:
     Node AddSourceNode(Model model, PortElements input, PortType outputType, const ell::api::math::TensorShape& shape, const std::string& sourceFunctionName);
     Node AddUnaryOperationNode(Model model, PortElements input, UnaryOperationType operation);
     Node AddDTWNode(Model model, std::vector<std::vector<double>> prototype, PortElements input);
-    Node AddVoiceActivityDetectorNode(Model model, PortElements input, double sampleRate, double frameDuration, double tauUp, double tauDown, double largeInput, double gainAtt, double thresholdUp, double thresholdDown, double levelThreshold);
+    Node AddVoiceActivityDetectorNode(Model model, PortElements input, double sampleRate, double frameDuration, double tauUp, double tauDown, double largeInput, double gainAtt, double thresholdUp, double thresholdDown, double levelThreshold, int decimation = 1);
     Node AddRNNNode(Model model, PortElements input, PortElements reset, size_t hiddenUnits, PortElements inputWeights, PortElements hiddenWeights, PortElements inputBias, PortElements hiddenBias, ell::api::predictors::neural::ActivationType activation);
     Node AddGRUNode(Model model, PortElements input, PortElements reset, size_t hiddenUnits, PortElements inputWeights, PortElements hiddenWeights, PortElements inputBias, PortElements hiddenBias, ell::api::predictors::neural::ActivationType activation, ell::api::predictors::neural::ActivationType recurrentActivation);
     Node AddLSTMNode(Model model, PortElements input, PortElements reset, size_t hiddenUnits, PortElements inputWeights, PortElements hiddenWeights, PortElements inputBias, PortElements hiddenBias, ell::api::predictors::neural::ActivationType activation, ell::api::predictors::neural::ActivationType recurrentActivation);
@@ -121,6 +123,9 @@ public:
 
 private:
 #ifndef SWIG
+    template <typename InputType>
+    Node AddConstantNodeFromBuffer(Model model, const InputType* input, size_t inputLength, const PortMemoryLayout& layout, PortType type);
+
     template <typename ElementType>
     Node AddNeuralNetworkPredictorNode(Model model, PortElements input, const ell::predictors::NeuralNetworkPredictor<ElementType>& predictor);
 
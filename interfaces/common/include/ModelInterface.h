@@ -367,6 +367,9 @@ public:
     ell::api::math::TensorShape GetOutputShape() const;
     Model GetModel() const;
 
+    // Returns a map that computes `next` on the output of this map, so both can be compiled into one module.
+    Map Chain(const Map& next) const;
+
     // Note: not templatized because these implement type-specific resolverFunctions
     CompiledMap CompileDouble(const std::string& targetDevice, const std::string& moduleName, const std::string& functionName, const MapCompilerOptions& compilerSettings, const ModelOptimizerOptions& optimizerSettings) const;
     CompiledMap CompileFloat(const std::string& targetDevice, const std::string& moduleName, const std::string& functionName, const MapCompilerOptions& compilerSettings, const ModelOptimizerOptions& optimizerSettings) const;
@@ -436,6 +439,16 @@ public:
     template <typename ElementType>
     void UnregisterCallbacks();
 
+    // Registers buffers that the source and sink nodes read from and write to directly, instead of calling the
+    // registered callbacks, which saves a call into the host language and a copy on every frame. Fill the input
+    // before each call to Step, and check GetOutputFrameCount after it to see if the sink wrote a new output.
+    // The buffers must stay alive, and must not move, until UnregisterCallbacks is called.
+    void RegisterBuffersDouble(const double* input, size_t inputLength, double* output, size_t outputLength);
+    void RegisterBuffersFloat(const float* input, size_t inputLength, float* output, size_t outputLength);
+
+    // Returns the number of outputs the sink node has written to the registered output buffer
+    size_t GetOutputFrameCount();
+
 #ifndef SWIG
     CompiledMap() = default;
     CompiledMap(
@@ -459,16 +472,45 @@ public:
     std::vector<double> ComputeDouble(const std::vector<double>& inputData);
     std::vector<float> ComputeFloat(const std::vector<float>& inputData);
 
+    // Same as ComputeDouble and ComputeFloat, but reads the input from and writes the output to buffers owned by the
+    // caller, such as numpy arrays, without copying them. The lengths must match the input and output sizes of the map.
+    void ComputeDoubleInto(const double* input, size_t inputLength, double* output, size_t outputLength);
+    void ComputeFloatInto(const float* input, size_t inputLength, float* output, size_t outputLength);
+
+    // Computes a batch of samples that are stored one after the other in the input buffer, and writes their outputs
+    // one after the other to the output buffer. Returns the number of samples. The Python wrappers of the Compute*Into
+    // methods release the GIL, so other Python threads run while the map computes.
+    size_t ComputeBatchDoubleInto(const double* input, size_t inputLength, double* output, size_t outputLength);
+    size_t ComputeBatchFloatInto(const float* input, size_t inputLength, float* output, size_t outputLength);
+
+    // Same as ComputeDoubleInto and ComputeFloatInto, but can be called from several threads at once, like the worker
+    // threads of the JavaScript ComputeAsync functions. If the map was compiled with the `reentrant` option, the calls
+    // run at the same time, each with a copy of the model's state that no other call is using. Otherwise they take turns.
+    void ComputeDoubleIntoConcurrent(const double* input, size_t inputLength, double* output, size_t outputLength);
+    void ComputeFloatIntoConcurrent(const float* input, size_t inputLength, float* output, size_t outputLength);
+
+    ell::api::math::TensorShape GetInputShape() const { return _inputShape; }
+    ell::api::math::TensorShape GetOutputShape() const { return _outputShape; }
+
 private:
+    struct ConcurrentComputeState;
+
     template <typename ElementType>
     ell::api::CallbackForwarder<ElementType, ElementType>& GetCallbackForwarder();
 
+    template <typename ElementType>
+    void RegisterBuffers(const ElementType* input, size_t inputLength, ElementType* output, size_t outputLength);
+
+    template <typename ElementType>
+    void ComputeIntoConcurrent(const ElementType* input, size_t inputLength, ElementType* output, size_t outputLength);
+
     std::shared_ptr<ell::model::IRMapCompiler> _compiler;
     std::shared_ptr<ell::model::IRCompiledMap> _map;
     ell::api::math::TensorShape _inputShape;
     ell::api::math::TensorShape _outputShape;
     ell::api::CallbackForwarder<double, double> forwarderDouble;
     ell::api::CallbackForwarder<float, float> forwarderFloat;
+    std::shared_ptr<ConcurrentComputeState> _concurrentComputeState;
 
     enum class TriState
     {
@@ -486,6 +528,7 @@ struct MapCompilerOptions
 {
     bool useBlas = true;
     bool profile = false;
+    bool reentrant = false; // lets the Compute*IntoConcurrent methods run at the same time on several threads
 };
 
 //
@@ -70,6 +70,12 @@ struct ProtoNNTrainerParameters
 
     ///<summary>Whether to output diagnostic messages during the training process</summary>
     bool verbose = false;
+
+    ///<summary>The number of examples in each mini-batch, or 0 for the default</summary>
+    size_t batchSize = 0;
+
+    ///<summary>The number of threads, or 0 to use all the hardware threads</summary>
+    size_t numThreads = 1;
 };
 
 class ProtoNNPredictor
@@ -209,6 +209,67 @@ def copy_from(self, a):
 }
 %enddef
 
+%{
+// Checks that a buffer has elements of the given struct format character, in native byte order
+bool is_buffer_of_format(const Py_buffer& view, char format, Py_ssize_t itemSize)
+{
+    const char* f = view.format;
+    if (f == nullptr || view.itemsize != itemSize)
+    {
+        return false;
+    }
+    if (f[0] == '@' || f[0] == '=')
+    {
+        ++f;
+    }
+    return f[0] == format && f[1] == '\0';
+}
+%}
+
+// Passes a contiguous buffer, such as a numpy array of any shape, to a C++ pointer and length without copying it.
+// The input typemap only reads the buffer, the output typemap requires it to be writable.
+%define TYPEMAP_BUFFER_VIEW(ELEMENT_TYPE, FORMAT_CHAR)
+%typemap(in) (const ELEMENT_TYPE* input, size_t inputLength)
+             (Py_buffer view_ = {})
+{
+    if (PyObject_GetBuffer($input, &view_, PyBUF_ANY_CONTIGUOUS | PyBUF_FORMAT) < 0)
+    {
+        PyErr_Clear();
+        SWIG_exception_fail(SWIG_TypeError, "Cannot get a contiguous buffer to read from");
+    }
+    if (!is_buffer_of_format(view_, FORMAT_CHAR, sizeof(ELEMENT_TYPE)))
+    {
+        SWIG_exception_fail(SWIG_TypeError, "Expected a contiguous array of ELEMENT_TYPE");
+    }
+    $1 = ($1_ltype) view_.buf;
+    $2 = ($2_ltype) (view_.len / view_.itemsize);
+}
+%typemap(freearg) (const ELEMENT_TYPE* input, size_t inputLength)
+{
+    PyBuffer_Release(&view_$argnum);
+}
+
+%typemap(in) (ELEMENT_TYPE* output, size_t outputLength)
+             (Py_buffer view_ = {})
+{
+    if (PyObject_GetBuffer($input, &view_, PyBUF_ANY_CONTIGUOUS | PyBUF_WRITABLE | PyBUF_FORMAT) < 0)
+    {
+        PyErr_Clear();
+        SWIG_exception_fail(SWIG_TypeError, "Cannot get a contiguous buffer to write to");
+    }
+    if (!is_buffer_of_format(view_, FORMAT_CHAR, sizeof(ELEMENT_TYPE)))
+    {
+        SWIG_exception_fail(SWIG_TypeError, "Expected a contiguous array of ELEMENT_TYPE");
+    }
+    $1 = ($1_ltype) view_.buf;
+    $2 = ($2_ltype) (view_.len / view_.itemsize);
+}
+%typemap(freearg) (ELEMENT_TYPE* output, size_t outputLength)
+{
+    PyBuffer_Release(&view_$argnum);
+}
+%enddef
+
 %define CONSTRUCT_VECTOR_WITH_NUMPY(TypeName, nptype)
 %pythoncode %{
     class TypeName(TypeName):
@@ -228,7 +289,8 @@ def copy_from(self, a):
 
 %enddef
 
-%define CONSTRUCT_TENSOR_WITH_NUMPY(TypeName)
+// The numpy data goes through VectorType, which copies it in C++, instead of being converted element by element
+%define CONSTRUCT_TENSOR_WITH_NUMPY(TypeName, VectorType)
 %pythoncode %{
     class TypeName(TypeName):
         def __init__(self, numpyArray = None):
@@ -237,11 +299,11 @@ def copy_from(self, a):
                 if (len(numpyArray.shape) == 1):
                     super(TypeName, self).__init__(numpyArray)
                 elif (len(numpyArray.shape) == 3):
-                    super(TypeName, self).__init__(numpyArray.ravel(), numpyArray.shape[0], numpyArray.shape[1], numpyArray.shape[2])
+                    super(TypeName, self).__init__(VectorType(numpyArray.ravel()), numpyArray.shape[0], numpyArray.shape[1], numpyArray.shape[2])
                 elif (len(numpyArray.shape) == 4):
                     # Create a stacked 3 dimensional tensor
                     numpyArrayStacked = numpyArray.reshape(numpyArray.shape[0] * numpyArray.shape[1], numpyArray.shape[2], numpyArray.shape[3])
-                    super(TypeName, self).__init__(numpyArrayStacked.ravel(), numpyArrayStacked.shape[0], numpyArrayStacked.shape[1], numpyArrayStacked.shape[2])
+                    super(TypeName, self).__init__(VectorType(numpyArrayStacked.ravel()), numpyArrayStacked.shape[0], numpyArrayStacked.shape[1], numpyArrayStacked.shape[2])
                 else:
                     raise ValueError('Invalid number of dimensions!')
             elif numpyArray:
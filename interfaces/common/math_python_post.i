@@ -1,2 +1,2 @@
-CONSTRUCT_TENSOR_WITH_NUMPY(FloatTensor)
-CONSTRUCT_TENSOR_WITH_NUMPY(DoubleTensor)
+CONSTRUCT_TENSOR_WITH_NUMPY(FloatTensor, FloatVector)
+CONSTRUCT_TENSOR_WITH_NUMPY(DoubleTensor, DoubleVector)
@@ -30,11 +30,27 @@ WRAP_CALLABLES_AS_COMPILED_MAP_CALLBACKS(FloatCallbackBase, FloatCallbackBase, f
 %naturalvar ELL_API::PortMemoryLayout::offset;
 %naturalvar ELL_API::PortMemoryLayout::order;
 
+#ifdef SWIGPYTHON
+// These calls only run compiled code, so other Python threads can run while they compute
+%thread ELL_API::CompiledMap::ComputeDouble;
+%thread ELL_API::CompiledMap::ComputeFloat;
+%thread ELL_API::CompiledMap::ComputeDoubleInto;
+%thread ELL_API::CompiledMap::ComputeFloatInto;
+%thread ELL_API::CompiledMap::ComputeBatchDoubleInto;
+%thread ELL_API::CompiledMap::ComputeBatchFloatInto;
+%thread ELL_API::CompiledMap::ComputeDoubleIntoConcurrent;
+%thread ELL_API::CompiledMap::ComputeFloatIntoConcurrent;
+#endif // SWIGPYTHON
+
 // Include the C++ code to be wrapped
 %include "ModelInterface.h"
 %include "ModelBuilderInterface.h"
 %include "macros.i"
 
+#ifdef SWIGJAVASCRIPT
+%include "computeAsync.i"
+#endif // SWIGJAVASCRIPT
+
 // Template instantiations
 %template(RegisterCallbacksDouble) ELL_API::CompiledMap::RegisterCallbacks<double>;
 %template(RegisterCallbacksFloat) ELL_API::CompiledMap::RegisterCallbacks<float>;
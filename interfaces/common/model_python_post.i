@@ -134,6 +134,153 @@ def CompiledMap_Compute(self, inputData: 'Vector', dtype: 'numpy.dtype') -> "std
 
 CompiledMap.Compute = CompiledMap_Compute
 
+# CompiledMap.ComputeInto, which reads and writes numpy arrays in place
+def CompiledMap_ComputeInto(self, inputArray: 'numpy.ndarray', outputArray: 'numpy.ndarray' = None) -> "numpy.ndarray":
+    """
+    CompiledMap_ComputeInto(CompiledMap self, numpy.ndarray inputArray, numpy.ndarray outputArray) -> numpy.ndarray
+
+    Computes the map on a contiguous numpy array of numpy.float or numpy.float32 and writes the result to
+    outputArray, without copying either array. If outputArray is None, a new array of the output size and the
+    input dtype is allocated. Only available for maps with a single input and output, and no source nodes.
+
+    Parameters
+    ----------
+    inputArray: numpy.ndarray
+    outputArray: numpy.ndarray
+
+    """
+    if self.HasSourceNodes():
+        raise TypeError("ComputeInto is not available for maps with source nodes, use Compute instead")
+
+    if outputArray is None:
+        outputArray = np.empty(self.GetOutputShape().Size(), dtype=inputArray.dtype)
+
+    if inputArray.dtype == np.float64 and outputArray.dtype == np.float64:
+        self.ComputeDoubleInto(inputArray, outputArray)
+    elif inputArray.dtype == np.float32 and outputArray.dtype == np.float32:
+        self.ComputeFloatInto(inputArray, outputArray)
+    else:
+        raise TypeError("Invalid type, expected two arrays of numpy.float or of numpy.float32")
+
+    return outputArray
+
+CompiledMap.ComputeInto = CompiledMap_ComputeInto
+
+# CompiledMap.ComputeBatchInto, which computes a batch of samples stored one after the other
+def CompiledMap_ComputeBatchInto(self, inputArray: 'numpy.ndarray', outputArray: 'numpy.ndarray' = None) -> "numpy.ndarray":
+    """
+    CompiledMap_ComputeBatchInto(CompiledMap self, numpy.ndarray inputArray, numpy.ndarray outputArray) -> numpy.ndarray
+
+    Computes the map on a batch of samples, stored one after the other in a contiguous numpy array, for example
+    one row per sample. The outputs are written one after the other to outputArray, and the GIL is released while
+    the batch is computed. If outputArray is None, an array with one row per sample is allocated.
+
+    Parameters
+    ----------
+    inputArray: numpy.ndarray
+    outputArray: numpy.ndarray
+
+    """
+    if self.HasSourceNodes():
+        raise TypeError("ComputeBatchInto is not available for maps with source nodes, use Compute instead")
+
+    if outputArray is None:
+        numSamples = inputArray.size // self.GetInputShape().Size()
+        outputArray = np.empty((numSamples, self.GetOutputShape().Size()), dtype=inputArray.dtype)
+
+    if inputArray.dtype == np.float64 and outputArray.dtype == np.float64:
+        self.ComputeBatchDoubleInto(inputArray, outputArray)
+    elif inputArray.dtype == np.float32 and outputArray.dtype == np.float32:
+        self.ComputeBatchFloatInto(inputArray, outputArray)
+    else:
+        raise TypeError("Invalid type, expected two arrays of numpy.float or of numpy.float32")
+
+    return outputArray
+
+CompiledMap.ComputeBatchInto = CompiledMap_ComputeBatchInto
+
+# CompiledMap.RegisterBuffers, which lets the source and sink nodes use numpy arrays directly
+def CompiledMap_RegisterBuffers(self, inputArray: 'numpy.ndarray', outputArray: 'numpy.ndarray'):
+    """
+    CompiledMap_RegisterBuffers(CompiledMap self, numpy.ndarray inputArray, numpy.ndarray outputArray)
+
+    Registers two contiguous numpy arrays of numpy.float or numpy.float32 for the source node to read each frame
+    from and the sink node to write each output to, instead of calling the registered callbacks. Fill inputArray
+    before each call to Step, and check GetOutputFrameCount after it to see if outputArray holds a new output.
+    The map keeps a reference to the arrays so they stay alive; don't resize them while they're registered.
+
+    Parameters
+    ----------
+    inputArray: numpy.ndarray
+    outputArray: numpy.ndarray
+
+    """
+    if inputArray.dtype == np.float64 and outputArray.dtype == np.float64:
+        self.RegisterBuffersDouble(inputArray, outputArray)
+    elif inputArray.dtype == np.float32 and outputArray.dtype == np.float32:
+        self.RegisterBuffersFloat(inputArray, outputArray)
+    else:
+        raise TypeError("Invalid type, expected two arrays of numpy.float or of numpy.float32")
+    self._registered_buffers = (inputArray, outputArray) # keep them alive
+
+CompiledMap.RegisterBuffers = CompiledMap_RegisterBuffers
+
+# CompiledMap.ComputeAsync, which computes on a worker thread of the map and returns a future
+def CompiledMap_ComputeAsync(self, inputArray: 'numpy.ndarray', outputArray: 'numpy.ndarray' = None) -> "concurrent.futures.Future":
+    """
+    CompiledMap_ComputeAsync(CompiledMap self, numpy.ndarray inputArray, numpy.ndarray outputArray) -> concurrent.futures.Future
+
+    Submits a batch of samples to ComputeBatchInto on a worker thread of this map, and returns a future of the
+    output array. Calls on one map run one at a time, because a compiled map keeps its state in global memory;
+    use a CompiledMapPool of several maps to compute on several cores at once. The arrays must not be modified
+    until the future is done.
+
+    Parameters
+    ----------
+    inputArray: numpy.ndarray
+    outputArray: numpy.ndarray
+
+    """
+    import concurrent.futures
+    executor = getattr(self, "_executor", None)
+    if executor is None:
+        executor = concurrent.futures.ThreadPoolExecutor(max_workers=1)
+        self._executor = executor
+    return executor.submit(self.ComputeBatchInto, inputArray, outputArray)
+
+CompiledMap.ComputeAsync = CompiledMap_ComputeAsync
+
+class CompiledMapPool:
+    """
+    Computes batches of samples on several compiled maps at once, each on its own thread. The maps are typically
+    compiled from the same Map, and each one computes one batch at a time.
+    """
+    def __init__(self, compiledMaps: 'list'):
+        import concurrent.futures
+        import queue
+        if not compiledMaps:
+            raise ValueError("CompiledMapPool needs at least one compiled map")
+        self._maps = list(compiledMaps)
+        self._freeMaps = queue.Queue()
+        for compiledMap in self._maps:
+            self._freeMaps.put(compiledMap)
+        self._executor = concurrent.futures.ThreadPoolExecutor(max_workers=len(self._maps))
+
+    def _compute(self, inputArray, outputArray):
+        compiledMap = self._freeMaps.get()
+        try:
+            return compiledMap.ComputeBatchInto(inputArray, outputArray)
+        finally:
+            self._freeMaps.put(compiledMap)
+
+    def ComputeAsync(self, inputArray: 'numpy.ndarray', outputArray: 'numpy.ndarray' = None) -> "concurrent.futures.Future":
+        """ Submits a batch of samples to the next free map, and returns a future of the output array """
+        return self._executor.submit(self._compute, inputArray, outputArray)
+
+    def Shutdown(self, wait: 'bool' = True):
+        """ Stops the worker threads, after the submitted batches are computed if wait is True """
+        self._executor.shutdown(wait)
+
 # Map.Compute, parameterized on numpy.dtype
 def Map_Compute(self, inputData: 'Vector<ElementType>', dtype: 'numpy.dtype') -> "std::vector< ElementType,std::allocator< ElementType > >":
     """
@@ -219,8 +366,48 @@ def Map_Compile(self, targetDevice: 'std::string const &', moduleName: 'std::str
 
 Map.Compile = Map_Compile
 
+# ModelBuilder.AddConstantNode, which copies numpy arrays straight from their buffer into the node
+_ModelBuilder_AddConstantNode = ModelBuilder.AddConstantNode
+
+def ModelBuilder_AddConstantNode(self, model: 'Model', values, *args) -> "Node":
+    """
+    ModelBuilder_AddConstantNode(ModelBuilder self, Model model, values, TensorShape outputShape, PortType type) -> Node
+    ModelBuilder_AddConstantNode(ModelBuilder self, Model model, values, PortType type) -> Node
+
+    Adds a ConstantNode with the given values and element type. A numpy array of numpy.float32 or numpy.float is
+    copied once, from its buffer into the node, and converted only if its dtype differs from the element type. Other
+    numpy arrays are converted to numpy.float first, and other sequences go through a DoubleVector.
+
+    Parameters
+    ----------
+    model: Model
+    values: numpy.ndarray, DoubleVector or list
+    outputShape: TensorShape (optional)
+    type: PortType
+
+    """
+    if not isinstance(values, np.ndarray):
+        return _ModelBuilder_AddConstantNode(self, model, values, *args)
+
+    if len(args) == 1:
+        portType = args[0]
+        layout = PortMemoryLayout([values.size])
+    else:
+        outputShape, portType = args
+        layout = PortMemoryLayout([outputShape.rows, outputShape.columns, outputShape.channels])
+
+    if values.dtype == np.float32:
+        return self.AddConstantNodeFromFloatBuffer(model, np.ascontiguousarray(values), layout, portType)
+    return self.AddConstantNodeFromDoubleBuffer(model, np.ascontiguousarray(values, dtype=np.float64), layout, portType)
+
+ModelBuilder.AddConstantNode = ModelBuilder_AddConstantNode
+
 del CompiledMap_Compute
+del CompiledMap_ComputeInto
+del CompiledMap_ComputeBatchInto
+del CompiledMap_ComputeAsync
 del Map_Compile
 del Map_Compute
+del ModelBuilder_AddConstantNode
 
 %}
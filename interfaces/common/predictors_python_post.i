@@ -181,6 +181,8 @@ class ConvolutionMethod:
     simple = ConvolutionMethod_simple
     winograd = ConvolutionMethod_winograd
     unrolled = ConvolutionMethod_unrolled
+    depthwise = ConvolutionMethod_depthwise
+    blocked = ConvolutionMethod_blocked
 
 # Remove flat defines so callers only see the class above
 del ConvolutionMethod_automatic
@@ -188,6 +190,8 @@ del ConvolutionMethod_diagonal
 del ConvolutionMethod_simple
 del ConvolutionMethod_winograd
 del ConvolutionMethod_unrolled
+del ConvolutionMethod_depthwise
+del ConvolutionMethod_blocked
 
 # Python friendly class for EpsilonSummand
 class EpsilonSummand:
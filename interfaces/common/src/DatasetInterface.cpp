@@ -14,6 +14,7 @@
 #include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
 
+#include <algorithm>
 #include <vector>
 
 using namespace ell;
@@ -65,6 +66,21 @@ void AutoDataVector::CopyTo(std::vector<float>& buffer)
     InternalCopyTo<float>(source, buffer);
 }
 
+void AutoDataVector::CopyToDoubleBuffer(double* output, size_t outputLength) const
+{
+    // adds the stored values to the zeroed buffer directly, without a dense copy of a sparse vector
+    std::fill(output, output + outputLength, 0.0);
+    _impl->_vector->AddTo(ell::math::RowVectorReference<double>(output, outputLength));
+}
+
+void AutoDataVector::CopyToFloatBuffer(float* output, size_t outputLength) const
+{
+    auto source = _impl->_vector->ToArray();
+    auto size = std::min(source.size(), outputLength);
+    std::copy(source.begin(), source.begin() + size, output);
+    std::fill(output + size, output + outputLength, 0.0f);
+}
+
 class AutoSupervisedExample::AutoSupervisedExampleImpl
 {
 public:
@@ -80,7 +96,7 @@ AutoSupervisedExample::AutoSupervisedExample() :
 }
 
 AutoSupervisedExample::AutoSupervisedExample(AutoDataVector vector, double label) :
-    _impl(std::make_shared<AutoSupervisedExampleImpl>(ell::data::AutoSupervisedExample(vector.ToArray(), { 1.0, label })))
+    _impl(std::make_shared<AutoSupervisedExampleImpl>(ell::data::AutoSupervisedExample(vector._impl->_vector, { 1.0, label })))
 {
 }
 
@@ -126,17 +142,15 @@ void AutoSupervisedDataset::Load(std::string filename)
     // load the dataset
     while (exampleIterator.IsValid())
     {
-        auto example = exampleIterator.Get();
-        auto mappedExample = data::AutoSupervisedExample(example.GetDataVector().ToArray(), example.GetMetadata());
-        _impl->_dataset.AddExample(mappedExample);
+        _impl->_dataset.AddExample(exampleIterator.Get());
         exampleIterator.Next();
     }
 }
 
 void AutoSupervisedDataset::AddExample(const AutoSupervisedExample& e)
 {
-    ell::data::AutoSupervisedExample ex(e.GetData().ToArray(), { 1.0, e.GetLabel() });
-    _impl->_dataset.AddExample(ex);
+    // examples share their data vectors, which are immutable
+    _impl->_dataset.AddExample(e._impl->_example);
 }
 
 void AutoSupervisedDataset::Save(std::string filename)
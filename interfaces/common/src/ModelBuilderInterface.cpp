@@ -577,6 +577,50 @@ Node ModelBuilder::AddConstantNode(Model model, std::vector<double> values, cons
     return Node(newNode);
 }
 
+Node ModelBuilder::AddConstantNodeFromDoubleBuffer(Model model, const double* input, size_t inputLength, const PortMemoryLayout& layout, PortType type)
+{
+    return AddConstantNodeFromBuffer(model, input, inputLength, layout, type);
+}
+
+Node ModelBuilder::AddConstantNodeFromFloatBuffer(Model model, const float* input, size_t inputLength, const PortMemoryLayout& layout, PortType type)
+{
+    return AddConstantNodeFromBuffer(model, input, inputLength, layout, type);
+}
+
+template <typename InputType>
+Node ModelBuilder::AddConstantNodeFromBuffer(Model model, const InputType* input, size_t inputLength, const PortMemoryLayout& layout, PortType type)
+{
+    const auto& memoryLayout = layout.Get();
+    if (inputLength != memoryLayout.GetMemorySize())
+    {
+        throw std::invalid_argument("Error: the buffer size doesn't match the memory layout of the ConstantNode");
+    }
+
+    // The values are copied straight from the buffer into the node, converting them only if the types differ
+    ell::model::Node* newNode = nullptr;
+    switch (type)
+    {
+    case PortType::boolean:
+        newNode = model.GetModel().AddNode<ell::nodes::ConstantNode<bool>>(std::vector<bool>(input, input + inputLength), memoryLayout);
+        break;
+    case PortType::integer:
+        newNode = model.GetModel().AddNode<ell::nodes::ConstantNode<int>>(std::vector<int>(input, input + inputLength), memoryLayout);
+        break;
+    case PortType::real:
+        newNode = model.GetModel().AddNode<ell::nodes::ConstantNode<double>>(std::vector<double>(input, input + inputLength), memoryLayout);
+        break;
+    case PortType::smallReal:
+        newNode = model.GetModel().AddNode<ell::nodes::ConstantNode<float>>(std::vector<float>(input, input + inputLength), memoryLayout);
+        break;
+    case PortType::bigInt:
+        newNode = model.GetModel().AddNode<ell::nodes::ConstantNode<int64_t>>(std::vector<int64_t>(input, input + inputLength), memoryLayout);
+        break;
+    default:
+        throw std::invalid_argument("Error: could not create ConstantNode of the requested type");
+    }
+    return Node(newNode);
+}
+
 Node ModelBuilder::AddUnaryOperationNode(Model model, PortElements input, UnaryOperationType op)
 {
     auto operation = static_cast<ell::nodes::UnaryOperationType>(op);
@@ -817,7 +861,7 @@ Node ModelBuilder::AddDCTNode(Model model, PortElements input, int numFilters)
     return Node(newNode);
 }
 
-Node ModelBuilder::AddVoiceActivityDetectorNode(Model model, PortElements input, double sampleRate, double frameDuration, double tauUp, double tauDown, double largeInput, double gainAtt, double thresholdUp, double thresholdDown, double levelThreshold)
+Node ModelBuilder::AddVoiceActivityDetectorNode(Model model, PortElements input, double sampleRate, double frameDuration, double tauUp, double tauDown, double largeInput, double gainAtt, double thresholdUp, double thresholdDown, double levelThreshold, int decimation)
 {
     auto type = input.GetType();
     auto elements = input.GetPortElements();
@@ -826,10 +870,10 @@ Node ModelBuilder::AddVoiceActivityDetectorNode(Model model, PortElements input,
     switch (type)
     {
     case PortType::real:
-        newNode = model.GetModel().AddNode<ell::nodes::VoiceActivityDetectorNode>(ell::model::PortElements<double>(elements), sampleRate, frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold);
+        newNode = model.GetModel().AddNode<ell::nodes::VoiceActivityDetectorNode>(ell::model::PortElements<double>(elements), sampleRate, frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold, decimation);
         break;
     case PortType::smallReal:
-        newNode = model.GetModel().AddNode<ell::nodes::VoiceActivityDetectorNode>(ell::model::PortElements<float>(elements), sampleRate, frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold);
+        newNode = model.GetModel().AddNode<ell::nodes::VoiceActivityDetectorNode>(ell::model::PortElements<float>(elements), sampleRate, frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold, decimation);
         break;
     default:
         throw std::invalid_argument("Error: could not create BufferNode of the requested type");
@@ -18,16 +18,20 @@
 
 #include <dsp/include/FilterBank.h>
 
+#include <emitters/include/IRReentrancy.h>
 #include <emitters/include/ModuleEmitter.h>
 
 #include <model/include/InputNode.h>
 #include <model/include/Map.h>
+#include <model/include/MapPipeline.h>
 #include <model/include/OutputNode.h>
 
 #include <utilities/include/JsonArchiver.h>
 #include <utilities/include/StringUtil.h>
 
 #include <algorithm>
+#include <memory>
+#include <mutex>
 
 //
 // Callback functions
@@ -722,6 +726,12 @@ Model Map::GetModel() const
     return Model(_map->GetModel().ShallowCopy());
 }
 
+Map Map::Chain(const Map& next) const
+{
+    auto chained = std::make_shared<ell::model::Map>(ell::model::ChainMaps(*_map, *next._map));
+    return Map(chained);
+}
+
 void Map::Load(const std::string& filename)
 {
     ell::common::MapLoadArguments args;
@@ -844,6 +854,7 @@ CompiledMap Map::Compile(const std::string& targetDevice,
     settings.sinkFunctionName = sinkFunctionName;
     settings.compilerSettings.targetDevice.deviceName = targetDevice;
     settings.compilerSettings.useBlas = compilerSettings.useBlas;
+    settings.compilerSettings.reentrant = compilerSettings.reentrant;
 
     ell::model::ModelOptimizerOptions optimizerOptions;
     optimizerOptions["fuseLinearFunctionNodes"] = optimizerSettings.fuseLinearFunctionNodes;
@@ -862,6 +873,67 @@ CompiledMap Map::Compile(const std::string& targetDevice,
 //
 // CompiledMap
 //
+
+// The functions that the Compute*IntoConcurrent methods call, and the copies of the model's state that they aren't using
+struct CompiledMap::ConcurrentComputeState
+{
+    std::mutex mutex;
+    bool isResolved = false;
+    bool isReentrant = false; // the predict function can be called from several threads at once
+    uint64_t predictFunction = 0; // takes a state as its first argument if `initializeStateFunction` isn't 0
+    uint64_t initializeStateFunction = 0;
+    size_t stateSize = 0;
+    size_t stateAlignment = 0;
+    std::vector<std::unique_ptr<std::vector<char>>> freeStates;
+
+    void Resolve(ell::model::IRCompiledMap& map)
+    {
+        if (isResolved)
+        {
+            return;
+        }
+
+        auto& jitter = map.GetJitter();
+        const auto moduleName = map.GetModule().GetModuleName();
+        const auto functionName = map.GetFunctionName();
+        isReentrant = jitter.GetFunctionAddress(moduleName + "_GetStateSize") != 0;
+        predictFunction = isReentrant ? jitter.GetFunctionAddress(ell::emitters::GetReentrantFunctionName(functionName)) : 0;
+        if (predictFunction != 0)
+        {
+            stateSize = static_cast<size_t>(reinterpret_cast<int64_t (*)()>(jitter.ResolveFunctionAddress(moduleName + "_GetStateSize"))());
+            stateAlignment = static_cast<size_t>(reinterpret_cast<int64_t (*)()>(jitter.ResolveFunctionAddress(moduleName + "_GetStateAlignment"))());
+            initializeStateFunction = jitter.ResolveFunctionAddress(moduleName + "_InitializeState");
+        }
+        else
+        {
+            // A reentrant map whose predict function doesn't use the state has no reentrant version of it
+            predictFunction = jitter.ResolveFunctionAddress(functionName);
+        }
+        isResolved = true;
+    }
+
+    std::unique_ptr<std::vector<char>> AcquireState()
+    {
+        if (!freeStates.empty())
+        {
+            auto state = std::move(freeStates.back());
+            freeStates.pop_back();
+            return state;
+        }
+
+        auto state = std::make_unique<std::vector<char>>(stateSize + stateAlignment);
+        reinterpret_cast<void (*)(void*)>(initializeStateFunction)(GetAlignedState(*state));
+        return state;
+    }
+
+    void* GetAlignedState(std::vector<char>& buffer) const
+    {
+        void* state = buffer.data();
+        auto space = buffer.size();
+        return std::align(stateAlignment, stateSize, state, space);
+    }
+};
+
 CompiledMap::CompiledMap(
     std::shared_ptr<ell::model::IRMapCompiler> compiler,
     std::shared_ptr<ell::model::IRCompiledMap> map,
@@ -870,7 +942,8 @@ CompiledMap::CompiledMap(
     _compiler(std::move(compiler)),
     _map(std::move(map)),
     _inputShape(inputShape),
-    _outputShape(outputShape)
+    _outputShape(outputShape),
+    _concurrentComputeState(std::make_shared<ConcurrentComputeState>())
 {}
 
 CompiledMap::~CompiledMap()
@@ -918,6 +991,128 @@ std::vector<float> CompiledMap::ComputeFloat(const std::vector<float>& inputData
     return {};
 }
 
+void CompiledMap::ComputeDoubleInto(const double* input, size_t inputLength, double* output, size_t outputLength)
+{
+    if (_map == nullptr)
+    {
+        throw std::logic_error("CompiledMap has no compiled map");
+    }
+    _map->ComputeIntoBuffer(input, inputLength, output, outputLength);
+}
+
+void CompiledMap::ComputeFloatInto(const float* input, size_t inputLength, float* output, size_t outputLength)
+{
+    if (_map == nullptr)
+    {
+        throw std::logic_error("CompiledMap has no compiled map");
+    }
+    _map->ComputeIntoBuffer(input, inputLength, output, outputLength);
+}
+
+size_t CompiledMap::ComputeBatchDoubleInto(const double* input, size_t inputLength, double* output, size_t outputLength)
+{
+    if (_map == nullptr)
+    {
+        throw std::logic_error("CompiledMap has no compiled map");
+    }
+    return _map->ComputeBatchIntoBuffer(input, inputLength, output, outputLength);
+}
+
+size_t CompiledMap::ComputeBatchFloatInto(const float* input, size_t inputLength, float* output, size_t outputLength)
+{
+    if (_map == nullptr)
+    {
+        throw std::logic_error("CompiledMap has no compiled map");
+    }
+    return _map->ComputeBatchIntoBuffer(input, inputLength, output, outputLength);
+}
+
+void CompiledMap::RegisterBuffersDouble(const double* input, size_t inputLength, double* output, size_t outputLength)
+{
+    RegisterBuffers(input, inputLength, output, outputLength);
+}
+
+void CompiledMap::RegisterBuffersFloat(const float* input, size_t inputLength, float* output, size_t outputLength)
+{
+    RegisterBuffers(input, inputLength, output, outputLength);
+}
+
+template <typename ElementType>
+void CompiledMap::RegisterBuffers(const ElementType* input, size_t inputLength, ElementType* output, size_t outputLength)
+{
+    if (inputLength != _inputShape.Size() || outputLength != _outputShape.Size())
+    {
+        throw std::invalid_argument("Buffer sizes don't match the map");
+    }
+    GetCallbackForwarder<ElementType>().RegisterBuffers(input, inputLength, output, outputLength);
+}
+
+size_t CompiledMap::GetOutputFrameCount()
+{
+    return forwarderDouble.GetOutputCount() + forwarderFloat.GetOutputCount();
+}
+
+void CompiledMap::ComputeDoubleIntoConcurrent(const double* input, size_t inputLength, double* output, size_t outputLength)
+{
+    ComputeIntoConcurrent(input, inputLength, output, outputLength);
+}
+
+void CompiledMap::ComputeFloatIntoConcurrent(const float* input, size_t inputLength, float* output, size_t outputLength)
+{
+    ComputeIntoConcurrent(input, inputLength, output, outputLength);
+}
+
+template <typename ElementType>
+void CompiledMap::ComputeIntoConcurrent(const ElementType* input, size_t inputLength, ElementType* output, size_t outputLength)
+{
+    if (_map == nullptr || _concurrentComputeState == nullptr)
+    {
+        throw std::logic_error("CompiledMap has no compiled map");
+    }
+
+    auto& map = *_map;
+    if (map.NumInputs() != 1 || map.NumOutputs() != 1)
+    {
+        throw std::logic_error("Concurrent compute needs a map with one input and one output");
+    }
+
+    const auto portType = ell::model::Port::GetPortType<ElementType>();
+    if (map.GetInput(0)->GetOutputPort().GetType() != portType || map.GetOutput(0).GetPortType() != portType)
+    {
+        throw std::invalid_argument("Buffer types don't match the map");
+    }
+
+    if (inputLength != map.GetInputSize(0) || outputLength != map.GetOutputSize(0))
+    {
+        throw std::invalid_argument("Buffer sizes don't match the map");
+    }
+
+    auto& computeState = *_concurrentComputeState;
+    std::unique_lock<std::mutex> lock(computeState.mutex);
+    if (HasSourceNodes())
+    {
+        throw std::logic_error("Concurrent compute isn't available for maps with source nodes");
+    }
+
+    computeState.Resolve(map);
+    if (computeState.initializeStateFunction == 0)
+    {
+        // If the map isn't reentrant, it keeps its state in globals, so each call has to finish before the next one starts
+        if (computeState.isReentrant)
+        {
+            lock.unlock();
+        }
+        reinterpret_cast<void (*)(void*, const ElementType*, ElementType*)>(computeState.predictFunction)(map.GetContext(), input, output);
+        return;
+    }
+
+    auto state = computeState.AcquireState();
+    lock.unlock();
+    reinterpret_cast<void (*)(void*, void*, const ElementType*, ElementType*)>(computeState.predictFunction)(computeState.GetAlignedState(*state), map.GetContext(), input, output);
+    lock.lock();
+    computeState.freeStates.push_back(std::move(state));
+}
+
 void CompiledMap::WriteIR(const std::string& filePath)
 {
     if (_map != nullptr)
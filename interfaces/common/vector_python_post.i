@@ -6,3 +6,6 @@ CONSTRUCT_VECTOR_WITH_NUMPY(IntVector, np.int)
 TYPEMAP_VECTOR_TO_ARRAY(double)
 TYPEMAP_VECTOR_TO_ARRAY(float)
 TYPEMAP_VECTOR_TO_ARRAY(int)
+
+TYPEMAP_BUFFER_VIEW(double, 'd')
+TYPEMAP_BUFFER_VIEW(float, 'f')
@@ -10,6 +10,14 @@ def test():
     compiledMap = map.Compile("host", "protonn", "predict", dtype=np.float)
     compiledMap.WriteBitcode("protonnTestData.bc");
 
+    # the in-place, batched and asynchronous compute calls must agree with Compute
+    inputSize = compiledMap.GetInputShape().Size()
+    batch = np.random.rand(4, inputSize)
+    expected = np.array([np.asarray(compiledMap.Compute(row, dtype=np.float)) for row in batch])
+    np.testing.assert_allclose(compiledMap.ComputeInto(batch[0]), expected[0])
+    np.testing.assert_allclose(compiledMap.ComputeBatchInto(batch), expected)
+    np.testing.assert_allclose(compiledMap.ComputeAsync(batch).result(), expected)
+
     if os.path.isfile("protonnTestData.bc"):
         return 0
 
@@ -18,6 +18,14 @@ def exampleTest(example):
     y = np.asarray(v)
     np.testing.assert_equal(x, y)
 
+    # test we can copy AutoDataVector into a numpy array without going through a DoubleVector
+    z = np.full(len(x) + 2, 7.0)
+    av.CopyToDoubleBuffer(z)
+    np.testing.assert_equal(z, np.concatenate([x, [0, 0]]))
+    zf = np.empty(len(x), dtype=np.float32)
+    av.CopyToFloatBuffer(zf)
+    np.testing.assert_equal(zf, x.astype(np.float32))
+
 def test():
     testing = Testing()
     dataset = ell.data.AutoSupervisedDataset()
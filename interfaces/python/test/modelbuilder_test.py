@@ -1,5 +1,6 @@
 import ell_helper
 import ell
+import numpy as np
 from testing import Testing
 
 def makeStringVec(strings):
@@ -17,9 +18,22 @@ def testModelBuilder(testing):
     mb.AddNode(model, "OutputNode<double>", outArgs)
     testing.ProcessTest("Testing ModelBuilder", testing.IsEqual(model.Size(), 2))
 
+def testConstantNodeFromNumpy(testing):
+    model = ell.model.Model()
+    mb = ell.model.ModelBuilder()
+    values = np.arange(24, dtype=np.float32).reshape(2, 3, 4)
+    node = mb.AddConstantNode(model, values, ell.math.TensorShape(2, 3, 4), ell.nodes.PortType.smallReal)
+    output = node.GetOutputPort("output")
+    testing.ProcessTest("Testing ConstantNode from a float32 array", testing.IsEqual(output.GetOutputType(), ell.nodes.PortType.smallReal) and testing.IsEqual(list(output.GetMemoryLayout().size), [2, 3, 4]))
+
+    node = mb.AddConstantNode(model, values.ravel(), ell.nodes.PortType.real)
+    output = node.GetOutputPort("output")
+    testing.ProcessTest("Testing ConstantNode from a converted array", testing.IsEqual(output.GetOutputType(), ell.nodes.PortType.real) and testing.IsEqual(output.Size(), 24))
+
 def test():
     testing = Testing()
     testModelBuilder(testing)
+    testConstantNodeFromNumpy(testing)
     if testing.DidTestFail():
         return 1
     else:
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <data/include/FeatureHashing.h>
+
 #include <utilities/include/CommandLineParser.h>
 
 #include <optional>
@@ -24,6 +26,9 @@ namespace common
         /// <summary> Accessor for the full file path. </summary>
         std::string GetDataFilePath() const;
 
+        /// <summary> Accessor for the feature hashing parameters. </summary>
+        data::FeatureHashingParameters GetFeatureHashingParameters() const;
+
         /// <summary> The filename for the input data file. </summary>
         std::string inputDataFilename = "";
 
@@ -33,6 +38,15 @@ namespace common
         /// <summary> The number of elements in an input data vector. </summary>
         std::string dataDimension = "";
 
+        /// <summary> The number of threads that parse a text data file or hash the features of a binary one, or 0 to use all the hardware threads. </summary>
+        size_t numParsingThreads = 1;
+
+        /// <summary> The feature indices are hashed into 2^featureHashingBits buckets, and 0 leaves them as they are. </summary>
+        size_t featureHashingBits = 0;
+
+        /// <summary> Whether a hash of each feature index decides the sign of its value. </summary>
+        bool featureHashingSign = false;
+
         // not exposed on the command line
         size_t parsedDataDimension = 0;
     };
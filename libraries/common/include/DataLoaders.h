@@ -12,12 +12,14 @@
 
 #include <data/include/Dataset.h>
 #include <data/include/ExampleIterator.h>
+#include <data/include/StreamingDataset.h>
 
 #include <model/include/Map.h>
 
 #include <utilities/include/StringUtil.h>
 
 #include <istream>
+#include <ostream>
 #include <string>
 
 namespace ell
@@ -42,6 +44,29 @@ namespace common
     /// <returns> The data iterator. </returns>
     data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(std::istream& stream);
 
+    /// <summary>
+    /// Gets an AutoSupervisedExampleIterator iterator from an input stream, which parses the stream with several
+    /// threads (see data::ParallelParsingExampleIterator).
+    /// </summary>
+    ///
+    /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of parsing threads, or 0 to use all the hardware threads. With 1 thread, the stream is parsed on the calling thread. </param>
+    ///
+    /// <returns> The data iterator. </returns>
+    data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(std::istream& stream, size_t numThreads);
+
+    /// <summary>
+    /// Gets an AutoSupervisedExampleIterator iterator from an input stream, which hashes the feature indices while
+    /// it parses the stream (see data::FeatureHashingDataVectorParser).
+    /// </summary>
+    ///
+    /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of parsing threads, or 0 to use all the hardware threads. With 1 thread, the stream is parsed on the calling thread. </param>
+    /// <param name="featureHashing"> The feature hashing parameters, where numHashBits of 0 keeps the feature indices. </param>
+    ///
+    /// <returns> The data iterator. </returns>
+    data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(std::istream& stream, size_t numThreads, const data::FeatureHashingParameters& featureHashing);
+
     /// <summary> Gets an AutoSupervisedMultiClassExampleIterator iterator from an input stream. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
@@ -56,6 +81,45 @@ namespace common
     /// <returns> The dataset. </returns>
     data::AutoSupervisedDataset GetDataset(std::istream& stream);
 
+    /// <summary>
+    /// Gets an AutoSupervisedDataset dataset from a file, which is either a text dataset or a binary dataset (see
+    /// data::BinaryDataset). Binary datasets are much faster to load, since they don't need to be parsed.
+    /// </summary>
+    ///
+    /// <param name="filepath"> The path of the dataset file. </param>
+    /// <param name="numParsingThreads"> The number of threads that parse a text dataset, or 0 to use all the hardware threads. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedDataset GetDataset(const std::string& filepath, size_t numParsingThreads = 1);
+
+    /// <summary>
+    /// Gets an AutoSupervisedDataset dataset from data load arguments, and hashes its feature indices if the
+    /// arguments ask for it.
+    /// </summary>
+    ///
+    /// <param name="dataLoadArguments"> The data load arguments. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedDataset GetDataset(const DataLoadArguments& dataLoadArguments);
+
+    /// <summary>
+    /// Gets a StreamingDataset that reads a text dataset or a binary dataset from a file in each epoch, so that
+    /// the examples don't have to fit in memory. A text dataset is parsed once to count its examples.
+    /// </summary>
+    ///
+    /// <param name="filepath"> The path of the dataset file. </param>
+    /// <param name="parameters"> The streaming dataset parameters. </param>
+    /// <param name="numParsingThreads"> The number of threads that parse a text dataset, or 0 to use all the hardware threads. </param>
+    ///
+    /// <returns> The streaming dataset. </returns>
+    data::StreamingDataset GetStreamingDataset(const std::string& filepath, const data::StreamingDatasetParameters& parameters, size_t numParsingThreads = 1);
+
+    /// <summary> Converts a text dataset to the binary dataset format, one example at a time. </summary>
+    ///
+    /// <param name="textStream"> Input stream to load the text dataset from. </param>
+    /// <param name="binaryStream"> Binary and seekable output stream to write the binary dataset to. </param>
+    void ConvertToBinaryDataset(std::istream& textStream, std::ostream& binaryStream);
+
     /// <summary> Gets a dataset from data load arguments. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
@@ -78,7 +142,9 @@ namespace common
 
     /// <summary>
     /// The map is first compiled, then a new dataset is returned
-    /// by running an existing dataset through the compiled map.
+    /// by running an existing dataset through the compiled map. The dataset is split into contiguous ranges that
+    /// are transformed in parallel, each by its own compiled copy of the map, and maps without source nodes
+    /// process the examples of a range in batches, through the batch predict function.
     /// </summary>
     ///
     /// <typeparam name="ExampleType"> Example type. </typeparam>
@@ -86,22 +152,31 @@ namespace common
     /// <param name="input"> Input dataset. </param>
     /// <param name="map"> Map to run input dataset on. </param>
     /// <param name="useBlas"> Use BLAS in the emitted code to speed up linear algerbra operations. </param>
+    /// <param name="numThreads"> The maximal number of threads, or 0 to use all the hardware threads. </param>
     ///
     /// <returns> The transformed dataset. </returns>
     template <typename ExampleType, typename MapType>
-    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas = true);
+    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas = true, size_t numThreads = 0);
 } // namespace common
 } // namespace ell
 
 #pragma region implementation
 
 #include <data/include/SingleLineParsingExampleIterator.h>
+#include <data/include/StlIndexValueIterator.h>
 
 #include <model/include/IRCompiledMap.h>
 #include <model/include/IRMapCompiler.h>
 
 #include <nodes/include/ClockNode.h> // for nodes::TimeTickType
 
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
 namespace ell
 {
 namespace common
@@ -185,61 +260,156 @@ namespace common
         }
     } // namespace detail
 
-    template <typename ExampleType, typename MapType>
-    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas)
+    namespace detail
     {
-        ell::model::MapCompilerOptions settings;
-        settings.compilerSettings.useBlas = useBlas;
-        ell::model::ModelOptimizerOptions optimizerOptions;
+        // The number of examples that amortize the compilation of another copy of the map
+        constexpr size_t minExamplesPerCompiledMap = 256;
 
-        detail::CallbackContext dataContext;
-        model::IRMapCompiler compiler(settings, optimizerOptions);
+        // The number of examples that are passed to the batch predict function at once
+        constexpr size_t compiledMapBatchSize = 64;
 
-        auto module = compiler.GetModule().GetLLVMModule();
-        auto compiledMap = compiler.Compile(map);
-        compiledMap.SetContext(&dataContext);
+        template <typename MapType>
+        model::IRCompiledMap CompileMapForTransform(const MapType& map, bool useBlas, CallbackContext& dataContext)
+        {
+            ell::model::MapCompilerOptions settings;
+            settings.compilerSettings.useBlas = useBlas;
+            settings.emitBatchFunction = map.GetSourceNodes().empty();
+            ell::model::ModelOptimizerOptions optimizerOptions;
+
+            model::IRMapCompiler compiler(settings, optimizerOptions);
+            auto module = compiler.GetModule().GetLLVMModule();
+            auto compiledMap = compiler.Compile(map);
+            compiledMap.SetContext(&dataContext);
+
+            // Unlike reference maps, compiled maps receive the current time as the parameter input and
+            // values through the input callback.
+            if (!map.GetSourceNodes().empty())
+            {
+                ResolveInputCallback(map, module, compiledMap.GetJitter());
+            }
+            return compiledMap;
+        }
 
-        // Unlike reference maps, compiled maps receive the current time as the parameter input and
-        // values through the input callback.
-        if (map.GetSourceNodes().size() > 0)
+        template <typename InputType, typename OutputType, typename ExampleType>
+        void TransformExamplesInBatches(const data::Dataset<ExampleType>& input, size_t begin, size_t end, model::IRCompiledMap& compiledMap, std::vector<ExampleType>& output)
         {
-            detail::ResolveInputCallback(map, module, compiledMap.GetJitter());
-            return input.template Transform<ExampleType>([&compiledMap, &dataContext](const ExampleType& example) {
-                dataContext.inputValues = example.GetDataVector().ToArray();
-                compiledMap.SetInputValue(0, std::vector<nodes::TimeTickType>({ 0 /*currentTime*/ }));
-                auto transformedDataVector = compiledMap.template ComputeOutput<typename ExampleType::DataVectorType>(0);
-                return ExampleType(std::move(transformedDataVector), example.GetMetadata());
-            });
+            std::vector<std::vector<InputType>> inputs;
+            for (auto batchBegin = begin; batchBegin < end; batchBegin += compiledMapBatchSize)
+            {
+                auto batchEnd = std::min(batchBegin + compiledMapBatchSize, end);
+                inputs.clear();
+                for (auto index = batchBegin; index < batchEnd; ++index)
+                {
+                    auto data = input[index].GetDataVector().ToArray();
+                    inputs.emplace_back(data.begin(), data.end());
+                }
+
+                auto outputs = compiledMap.template ComputeBatch<InputType, OutputType>(inputs);
+                for (size_t i = 0; i < outputs.size(); ++i)
+                {
+                    auto outputIterator = data::MakeVectorIndexValueIterator<data::IterationPolicy::skipZeros>(outputs[i]);
+                    output.emplace_back(typename ExampleType::DataVectorType(outputIterator), input[batchBegin + i].GetMetadata());
+                }
+            }
         }
-        else
+
+        template <typename InputType, typename ExampleType>
+        void TransformExamplesInBatches(const data::Dataset<ExampleType>& input, size_t begin, size_t end, model::IRCompiledMap& compiledMap, std::vector<ExampleType>& output)
         {
-            auto type = map.GetInputType();
-            switch (type)
+            switch (compiledMap.GetOutput(0).GetPortType())
             {
             case model::Port::PortType::smallReal:
-            {
-                return input.template Transform<ExampleType>([&compiledMap](const ExampleType& example) {
-                    auto data = example.GetDataVector().ToArray();
-                    std::vector<float> smallData(data.size());
-                    std::transform(data.begin(), data.end(), smallData.begin(), [](double val) { return static_cast<float>(val); });
-                    compiledMap.SetInputValue(0, smallData);
-                    auto transformedDataVector = compiledMap.template ComputeOutput<typename ExampleType::DataVectorType>(0);
-                    return ExampleType(std::move(transformedDataVector), example.GetMetadata());
-                });
-            }
+                TransformExamplesInBatches<InputType, float>(input, begin, end, compiledMap, output);
+                break;
             case model::Port::PortType::real:
+                TransformExamplesInBatches<InputType, double>(input, begin, end, compiledMap, output);
+                break;
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Unexpected output type, expecting float or double");
+            }
+        }
+
+        template <typename ExampleType, typename MapType>
+        void TransformExamples(const data::Dataset<ExampleType>& input, size_t begin, size_t end, const MapType& map, model::IRCompiledMap& compiledMap, CallbackContext& dataContext, std::vector<ExampleType>& output)
+        {
+            output.reserve(end - begin);
+            if (map.GetSourceNodes().size() > 0)
             {
-                return input.template Transform<ExampleType>([&compiledMap](const ExampleType& example) {
-                    compiledMap.SetInputValue(0, example.GetDataVector().ToArray());
+                for (auto index = begin; index < end; ++index)
+                {
+                    const auto& example = input[index];
+                    dataContext.inputValues = example.GetDataVector().ToArray();
+                    compiledMap.SetInputValue(0, std::vector<nodes::TimeTickType>({ 0 /*currentTime*/ }));
                     auto transformedDataVector = compiledMap.template ComputeOutput<typename ExampleType::DataVectorType>(0);
-                    return ExampleType(std::move(transformedDataVector), example.GetMetadata());
-                });
+                    output.emplace_back(std::move(transformedDataVector), example.GetMetadata());
+                }
+                return;
             }
+
+            auto type = map.GetInputType();
+            switch (type)
+            {
+            case model::Port::PortType::smallReal:
+                TransformExamplesInBatches<float>(input, begin, end, compiledMap, output);
+                break;
+            case model::Port::PortType::real:
+                TransformExamplesInBatches<double>(input, begin, end, compiledMap, output);
+                break;
             default:
                 throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch,
                     utilities::FormatString("Unexpected input type %d, expecting float or double", type));
             }
         }
+    } // namespace detail
+
+    template <typename ExampleType, typename MapType>
+    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas, size_t numThreads)
+    {
+        auto numExamples = input.NumExamples();
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        auto numWorkers = std::max<size_t>(std::min(numThreads, numExamples / detail::minExamplesPerCompiledMap), 1);
+
+        // Each worker gets its own compiled map, because the global buffers of a compiled map can't be shared
+        // between threads. The maps are compiled one after the other, and only run in parallel.
+        std::vector<detail::CallbackContext> dataContexts(numWorkers);
+        std::vector<model::IRCompiledMap> compiledMaps;
+        compiledMaps.reserve(numWorkers);
+        for (size_t worker = 0; worker < numWorkers; ++worker)
+        {
+            compiledMaps.push_back(detail::CompileMapForTransform(map, useBlas, dataContexts[worker]));
+        }
+
+        auto examplesPerWorker = (numExamples + numWorkers - 1) / numWorkers;
+        std::vector<std::vector<ExampleType>> outputs(numWorkers);
+        auto transformRange = [&](size_t worker) {
+            auto begin = std::min(worker * examplesPerWorker, numExamples);
+            auto end = std::min(begin + examplesPerWorker, numExamples);
+            detail::TransformExamples(input, begin, end, map, compiledMaps[worker], dataContexts[worker], outputs[worker]);
+        };
+
+        std::vector<std::future<void>> workers;
+        for (size_t worker = 1; worker < numWorkers; ++worker)
+        {
+            workers.push_back(utilities::GetHostThreadPool().AddTask(transformRange, worker));
+        }
+        transformRange(0);
+        for (auto& worker : workers)
+        {
+            utilities::GetHostThreadPool().GetResult(worker);
+        }
+
+        data::Dataset<ExampleType> result;
+        for (auto& output : outputs)
+        {
+            for (auto& example : output)
+            {
+                result.AddExample(std::move(example));
+            }
+        }
+        return result;
     }
 } // namespace common
 } // namespace ell
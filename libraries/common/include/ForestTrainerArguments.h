@@ -21,6 +21,7 @@ namespace common
         , public trainers::HistogramForestTrainerParameters
     {
         bool sortingTrainer;
+        bool sketchThresholds;
     };
 
     /// <summary> Parsed version of sorting tree trainer parameters. </summary>
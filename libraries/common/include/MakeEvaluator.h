@@ -56,10 +56,29 @@ namespace common
 #include <evaluators/include/BinaryErrorAggregator.h>
 #include <evaluators/include/LossAggregator.h>
 
+#include <trainers/include/CompiledEvaluator.h>
+
 namespace ell
 {
 namespace common
 {
+    namespace detail
+    {
+        // Makes a compiled evaluator if the parameters ask for one and the predictor can be compiled, else an interpreted one
+        template <typename PredictorType, typename... AggregatorTypes>
+        std::shared_ptr<evaluators::IEvaluator<PredictorType>> MakeEvaluatorWithAggregators(const data::AnyDataset& anyDataset, const evaluators::EvaluatorParameters& evaluatorParameters, AggregatorTypes... aggregators)
+        {
+            if constexpr (trainers::CompiledPredictorTraits<PredictorType>::isCompilable)
+            {
+                if (evaluatorParameters.compilePredictor)
+                {
+                    return trainers::MakeCompiledEvaluator<PredictorType>(anyDataset, evaluatorParameters, aggregators...);
+                }
+            }
+            return evaluators::MakeEvaluator<PredictorType>(anyDataset, evaluatorParameters, aggregators...);
+        }
+    } // namespace detail
+
     template <typename PredictorType>
     std::shared_ptr<evaluators::IEvaluator<PredictorType>> MakeEvaluator(const data::AnyDataset& anyDataset, const evaluators::EvaluatorParameters& evaluatorParameters, const LossFunctionArguments& lossFunctionArguments)
     {
@@ -68,13 +87,13 @@ namespace common
         switch (lossFunctionArguments.lossFunction)
         {
         case LossFunctionEnum::squared:
-            return evaluators::MakeEvaluator<PredictorType>(anyDataset, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+            return detail::MakeEvaluatorWithAggregators<PredictorType>(anyDataset, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(evaluatorParameters.aucNumBins), evaluators::MakeLossAggregator(functions::SquaredLoss()));
 
         case LossFunctionEnum::log:
-            return evaluators::MakeEvaluator<PredictorType>(anyDataset, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::LogLoss()));
+            return detail::MakeEvaluatorWithAggregators<PredictorType>(anyDataset, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(evaluatorParameters.aucNumBins), evaluators::MakeLossAggregator(functions::LogLoss()));
 
         case LossFunctionEnum::hinge:
-            return evaluators::MakeEvaluator<PredictorType>(anyDataset, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::HingeLoss()));
+            return detail::MakeEvaluatorWithAggregators<PredictorType>(anyDataset, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(evaluatorParameters.aucNumBins), evaluators::MakeLossAggregator(functions::HingeLoss()));
 
         default:
             throw utilities::CommandLineParserErrorException("chosen loss function is not supported by this evaluator");
@@ -89,13 +108,13 @@ namespace common
         switch (lossFunctionArguments.lossFunction)
         {
         case LossFunctionEnum::squared:
-            return evaluators::MakeIncrementalEvaluator<BasePredictorType>(exampleIterator, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+            return evaluators::MakeIncrementalEvaluator<BasePredictorType>(exampleIterator, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(evaluatorParameters.aucNumBins), evaluators::MakeLossAggregator(functions::SquaredLoss()));
 
         case LossFunctionEnum::log:
-            return evaluators::MakeIncrementalEvaluator<BasePredictorType>(exampleIterator, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::LogLoss()));
+            return evaluators::MakeIncrementalEvaluator<BasePredictorType>(exampleIterator, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(evaluatorParameters.aucNumBins), evaluators::MakeLossAggregator(functions::LogLoss()));
 
         case LossFunctionEnum::hinge:
-            return evaluators::MakeIncrementalEvaluator<BasePredictorType>(exampleIterator, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::HingeLoss()));
+            return evaluators::MakeIncrementalEvaluator<BasePredictorType>(exampleIterator, evaluatorParameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(evaluatorParameters.aucNumBins), evaluators::MakeLossAggregator(functions::HingeLoss()));
 
         default:
             throw utilities::CommandLineParserErrorException("chosen loss function is not supported by this evaluator");
@@ -36,26 +36,75 @@ namespace common
 
         // ELL codegen options
         bool profile = false;
+        bool profileHardwareCounters = false;
+        int profileSamplingInterval = 1;
+        double profileSamplingPeriod = 0;
         bool optimize = true;
+        bool reuseIntermediateBuffers = false;
+        bool aliasPortBuffers = true; // let slices, splices and concatenations refer to their inputs' buffers instead of copying them
+        int maxStackPortBufferSize = 0;
+        bool inlineElementwiseNodes = false;
+        int inlineNodeSizeLimit = 0;
+        bool parallelizeBranches = false; // run the independent branches of the model, like ensemble members, as concurrent tasks
+        bool emitBatchFunction = false;
+        int batchFunctionSize = 16;
+        bool emitAsyncFunctions = false;
         bool useBlas = false;
         bool debug = false;
         utilities::Optional<bool> positionIndependentCode = false; // for generating -fPIC object code
+        int codeGenPartitions = 1; // split object code into this many files, compiled in parallel
+        std::string pgoInstrument = ""; // instrument the code for profile-guided optimization, writing the raw profile to this file
+        std::string pgoUse = ""; // optimize with this merged profile from instrumented runs
+        bool reentrant = false; // emit model functions that take a pointer to caller-allocated state
+        bool externalWeights = false; // write the weights to a separate blob, loaded at runtime
+        bool staticMemory = false; // allocate the nodes' scratch arrays as globals instead of on the stack
+        bool deduplicateConstants = true; // store identical constant arrays once
+        bool shareConstantsAcrossModules = false; // let the linker merge identical constant arrays of different models
+        std::string weightsSection = ""; // section to place the weight arrays in, e.g. a flash-resident one on microcontrollers
+        int weightsAlignment = 0; // alignment of the weight arrays, in bytes, e.g. 2097152 for huge pages
+        int weightsPlacementThreshold = 0; // smallest weight array, in bytes, that gets the weights section and alignment
+        bool hugePageWeights = false; // ask the OS for huge pages for an external weights blob
+        bool noHeap = false; // fail to compile if the code would allocate heap memory
 
         // potentially per-node options:
         bool enableVectorization = true;
+        bool useApproximateMath = false;
         int vectorWidth = 4;
+        std::string functionVariants = ""; // comma-separated CPU feature sets to emit node function variants for, e.g. "avx2,avx512"
+        int prefetchDistance = 0; // bytes ahead of their reads that streaming kernels prefetch
+        int nonTemporalStoreThreshold = 0; // smallest write-once output, in bytes, stored with non-temporal stores
         bool parallelize = true;
         bool useThreadPool = true;
+        bool useWorkStealing = false;
+        bool externalThreadPool = false; // run tasks on a thread pool the application provides
+        int taskPriority = 0;
         int maxThreads = 4;
+        int threadPoolSpinCount = 0; // checks for tasks before an idle thread blocks
+        emitters::ParallelLoopSchedule parallelLoopSchedule = emitters::ParallelLoopSchedule::staticBlocks;
+        int parallelLoopChunkSize = 1;
+        emitters::ThreadAffinity threadAffinity = emitters::ThreadAffinity::none;
+        std::string affinityCores = ""; // cores to pin the thread pool's workers to, e.g. "0-3" or "4,5,6,7"
+        int affinitySockets = 1;
+        int parallelizeMinOutputSize = 0; // nodes with smaller outputs aren't parallelized
 
         // optimization options (configurable per-node)
         bool fuseLinearOperations = true;
+        bool fuseElementwiseOperations = true;
+        bool fuseSoftmaxTopK = true; // compute only the top-k probabilities of a softmax that feeds a top-k node
         bool optimizeReorderDataNodes = true;
-        PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, unrolled, simple, diagonal, winograd
+        bool eliminateRedundantConversions = true; // remove casts and reorderings that cancel out
+        bool foldConstants = true; // compute the nodes that only depend on constants ahead of time
+        bool eliminateCommonSubexpressions = true; // merge nodes that compute the same thing from the same inputs
+        PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, unrolled, simple, diagonal, winograd, depthwise, blocked
+        bool implicitGemmConvolution = true; // gather the receptive fields of unrolled convolutions a tile at a time instead of all at once
+        std::string convolutionCostDatabase = ""; // file of measured convolution method costs, used when convolutionMethod is auto
+        bool autotuneConvolutionMethod = false; // measure the convolution methods missing from the cost database
+        bool searchTransformations = false; // only keep the optimizer transformations that reduce the measured runtime
 
         // raw options to store in metadata
         std::vector<std::string> modelOptions; // in format "<option-name>,<option-value-string>"
         std::vector<std::string> nodeOptions; // in format "<node-id>,<option-name>,<option-value-string>"
+        std::vector<std::string> nodeTypeOptions; // in format "<node-type-regex>,<option-name>,<option-value-string>"
 
         // target machine options
         std::string target = ""; // known target names: host, mac, linux, windows, pi0, pi3, pi3_64, aarch64, ios
@@ -67,6 +116,8 @@ namespace common
         std::string targetArchitecture = "";
         std::string targetFeatures = "";
         std::string targetDataLayout = "";
+        int targetL1CacheSize = 0;
+        int targetL2CacheSize = 0;
 
         /// <summary> Gets a `MapCompilerOptions` with the settings specified in the commandline arguments. </summary>
         ///
@@ -91,6 +142,7 @@ namespace common
     private:
         utilities::PropertyBag GetModelOptionsMetadata() const;
         utilities::PropertyBag GetNodeOptionsMetadata() const;
+        utilities::PropertyBag GetNodeRulesMetadata() const;
         utilities::PropertyBag LoadOptionsMetadata() const; // load from file
     };
 
@@ -9,6 +9,8 @@
 #include "DataLoadArguments.h"
 #include "DataLoaders.h"
 
+#include <data/include/BinaryDataset.h>
+
 #include <utilities/include/CStringParser.h>
 #include <utilities/include/Files.h>
 
@@ -26,6 +28,11 @@ namespace common
         return inputDataDirectory.empty() ? inputDataFilename : utilities::JoinPaths(inputDataDirectory, inputDataFilename);
     }
 
+    data::FeatureHashingParameters DataLoadArguments::GetFeatureHashingParameters() const
+    {
+        return { featureHashingBits, featureHashingSign };
+    }
+
     // ParsedDataLoadArguments
     void ParsedDataLoadArguments::AddArgs(utilities::CommandLineParser& parser)
     {
@@ -55,6 +62,27 @@ namespace common
                 "Number of elements to read from each data vector",
                 "");
         }
+
+        parser.AddOption(
+            numParsingThreads,
+            "numParsingThreads",
+            "npt",
+            "Number of threads that parse a text data file (0 to use all the hardware threads)",
+            1);
+
+        parser.AddOption(
+            featureHashingBits,
+            "featureHashingBits",
+            "fhb",
+            "Hash the feature indices into 2^featureHashingBits buckets (0 to keep the indices)",
+            0);
+
+        parser.AddOption(
+            featureHashingSign,
+            "featureHashingSign",
+            "fhs",
+            "Use a hash of each feature index to decide the sign of its value, when hashing the feature indices",
+            false);
     }
 
     ParsedDataLoadArguments::ParsedDataLoadArguments(std::optional<OptionName> filenameOption, std::optional<OptionName> directoryOption, std::optional<OptionName> dimensionOption)
@@ -83,6 +111,12 @@ namespace common
         std::vector<std::string> parseErrorMessages;
         bool isFileReadable = false;
 
+        if (featureHashingBits >= 8 * sizeof(size_t))
+        {
+            parseErrorMessages.push_back("featureHashingBits must be smaller than the number of bits in an index");
+            return parseErrorMessages;
+        }
+
         if (!inputDataFilename.empty())
         {
             isFileReadable = utilities::IsFileReadable(GetDataFilePath());
@@ -90,7 +124,12 @@ namespace common
 
         // dataDimension
         const char* ptr = dataDimension.c_str();
-        if (dataDimension == "auto")
+        if (dataDimension == "auto" && featureHashingBits > 0)
+        {
+            // the hashed indices are smaller than the number of buckets
+            parsedDataDimension = size_t{ 1 } << featureHashingBits;
+        }
+        else if (dataDimension == "auto")
         {
             if (!isFileReadable)
             {
@@ -98,13 +137,20 @@ namespace common
                 return parseErrorMessages;
             }
 
-            auto stream = utilities::OpenIfstream(GetDataFilePath());
-            auto exampleIterator = GetAutoSupervisedExampleIterator(stream);
-            while (exampleIterator.IsValid())
+            if (data::IsBinaryDataset(GetDataFilePath()))
+            {
+                parsedDataDimension = data::BinaryDataset(GetDataFilePath()).NumFeatures();
+            }
+            else
             {
-                auto size = exampleIterator.Get().GetDataVector().PrefixLength();
-                parsedDataDimension = std::max(parsedDataDimension, size);
-                exampleIterator.Next();
+                auto stream = utilities::OpenIfstream(GetDataFilePath());
+                auto exampleIterator = GetAutoSupervisedExampleIterator(stream, numParsingThreads);
+                while (exampleIterator.IsValid())
+                {
+                    auto size = exampleIterator.Get().GetDataVector().PrefixLength();
+                    parsedDataDimension = std::max(parsedDataDimension, size);
+                    exampleIterator.Next();
+                }
             }
         }
         else if (dataDimension != "")
@@ -14,10 +14,14 @@
 #include <data/include/SequentialLineIterator.h>
 
 #include <data/include/AutoDataVector.h>
+#include <data/include/BinaryDataset.h>
+#include <data/include/FeatureHashing.h>
 #include <data/include/GeneralizedSparseParsingIterator.h>
+#include <data/include/ParallelParsingExampleIterator.h>
 #include <data/include/SingleLineParsingExampleIterator.h>
 #include <data/include/WeightLabel.h>
 
+#include <fstream>
 #include <memory>
 #include <stdexcept>
 
@@ -25,12 +29,59 @@ namespace ell
 {
 namespace common
 {
+    namespace
+    {
+        // An example iterator that owns the file stream that it parses
+        class TextFileExampleIterator : public data::IExampleIterator<data::AutoSupervisedExample>
+        {
+        public:
+            TextFileExampleIterator(const std::string& filepath, size_t numParsingThreads) :
+                _stream(utilities::OpenIfstream(filepath)),
+                _exampleIterator(GetAutoSupervisedExampleIterator(_stream, numParsingThreads))
+            {
+            }
+
+            bool IsValid() const override { return _exampleIterator.IsValid(); }
+
+            void Next() override { _exampleIterator.Next(); }
+
+            data::AutoSupervisedExample Get() const override { return _exampleIterator.Get(); }
+
+        private:
+            std::ifstream _stream;
+            data::AutoSupervisedExampleIterator _exampleIterator;
+        };
+    } // namespace
 
     data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(std::istream& stream)
     {
         return GetExampleIterator<data::SequentialLineIterator, data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream);
     }
 
+    data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(std::istream& stream, size_t numThreads)
+    {
+        if (numThreads == 1)
+        {
+            return GetAutoSupervisedExampleIterator(stream);
+        }
+        return data::MakeParallelParsingExampleIterator(stream, data::LabelParser{}, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>{}, numThreads);
+    }
+
+    data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(std::istream& stream, size_t numThreads, const data::FeatureHashingParameters& featureHashing)
+    {
+        if (featureHashing.numHashBits == 0)
+        {
+            return GetAutoSupervisedExampleIterator(stream, numThreads);
+        }
+
+        data::FeatureHashingDataVectorParser<data::GeneralizedSparseParsingIterator> dataVectorParser{ featureHashing };
+        if (numThreads == 1)
+        {
+            return data::MakeSingleLineParsingExampleIterator(data::SequentialLineIterator(stream), data::LabelParser{}, dataVectorParser);
+        }
+        return data::MakeParallelParsingExampleIterator(stream, data::LabelParser{}, dataVectorParser, numThreads);
+    }
+
     data::AutoSupervisedMultiClassExampleIterator GetAutoSupervisedMultiClassExampleIterator(std::istream& stream)
     {
         return GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream);
@@ -41,6 +92,55 @@ namespace common
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
     }
 
+    data::AutoSupervisedDataset GetDataset(const std::string& filepath, size_t numParsingThreads)
+    {
+        if (data::IsBinaryDataset(filepath))
+        {
+            return data::BinaryDataset(filepath).ToDataset();
+        }
+
+        auto stream = utilities::OpenIfstream(filepath);
+        return data::MakeDataset(GetAutoSupervisedExampleIterator(stream, numParsingThreads));
+    }
+
+    data::AutoSupervisedDataset GetDataset(const DataLoadArguments& dataLoadArguments)
+    {
+        auto filepath = dataLoadArguments.GetDataFilePath();
+        auto featureHashing = dataLoadArguments.GetFeatureHashingParameters();
+        if (featureHashing.numHashBits == 0)
+        {
+            return GetDataset(filepath, dataLoadArguments.numParsingThreads);
+        }
+
+        if (data::IsBinaryDataset(filepath))
+        {
+            auto hashExample = [&featureHashing](const data::AutoSupervisedExample& example) {
+                return data::AutoSupervisedExample(data::HashDataVector(example.GetDataVector(), featureHashing), example.GetMetadata());
+            };
+            return data::BinaryDataset(filepath).ToDataset().Transform<data::AutoSupervisedExample>(hashExample, dataLoadArguments.numParsingThreads);
+        }
+
+        auto stream = utilities::OpenIfstream(filepath);
+        return data::MakeDataset(GetAutoSupervisedExampleIterator(stream, dataLoadArguments.numParsingThreads, featureHashing));
+    }
+
+    data::StreamingDataset GetStreamingDataset(const std::string& filepath, const data::StreamingDatasetParameters& parameters, size_t numParsingThreads)
+    {
+        if (data::IsBinaryDataset(filepath))
+        {
+            auto binaryDataset = std::make_shared<data::BinaryDataset>(filepath);
+            auto numExamples = binaryDataset->NumExamples();
+            return data::StreamingDataset([binaryDataset]() { return binaryDataset->GetExampleIterator(); }, numExamples, parameters);
+        }
+
+        return data::StreamingDataset([filepath, numParsingThreads]() { return data::AutoSupervisedExampleIterator(std::make_unique<TextFileExampleIterator>(filepath, numParsingThreads)); }, parameters);
+    }
+
+    void ConvertToBinaryDataset(std::istream& textStream, std::ostream& binaryStream)
+    {
+        data::WriteBinaryDataset(GetAutoSupervisedExampleIterator(textStream), binaryStream);
+    }
+
     data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream)
     {
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
@@ -27,6 +27,34 @@ namespace common
             "aze",
             "Add an evaluation using the constant zero predictor",
             true);
+
+        parser.AddOption(
+            subsampleSize,
+            "evaluationSubsampleSize",
+            "ess",
+            "The number of examples to evaluate, drawn at random once, or 0 to evaluate all the examples",
+            0);
+
+        parser.AddOption(
+            numThreads,
+            "evaluationNumThreads",
+            "ent",
+            "The number of threads used for evaluation, or 0 to use all the hardware threads",
+            1);
+
+        parser.AddOption(
+            aucNumBins,
+            "evaluationAUCBins",
+            "eab",
+            "The number of histogram bins used to approximate the AUC in constant memory, or 0 to compute the exact AUC",
+            0);
+
+        parser.AddOption(
+            compilePredictor,
+            "evaluationCompilePredictor",
+            "ecp",
+            "Compile forest and linear predictors to native code before each evaluation, which is faster on large evaluation sets",
+            false);
     }
 } // namespace common
 } // namespace ell
@@ -32,6 +32,30 @@ namespace common
                          "The number of boosting rounds to perform",
                          "10");
 
+        parser.AddOption(baggingFraction,
+                         "baggingFraction",
+                         "bf",
+                         "The fraction of the examples, chosen at random, that each tree is trained on",
+                         1.0);
+
+        parser.AddOption(gossTopFraction,
+                         "gossTopFraction",
+                         "gtf",
+                         "The fraction of the examples with the largest gradients that each tree is trained on, with gradient-based one-side sampling",
+                         0.0);
+
+        parser.AddOption(gossOtherFraction,
+                         "gossOtherFraction",
+                         "gof",
+                         "The fraction of the examples that each tree samples from the rest, with gradient-based one-side sampling (0 disables it)",
+                         0.0);
+
+        parser.AddOption(samplingRandomSeed,
+                         "samplingRandomSeed",
+                         "srs",
+                         "Random seed used to sample the examples of each tree",
+                         "123456");
+
         parser.AddOption(randomSeed,
                          "randomSeed",
                          "rs",
@@ -47,14 +71,20 @@ namespace common
         parser.AddOption(candidatesPerInput,
                          "candidatesPerInput",
                          "cpi",
-                         "The number of split candidates to create per input element",
-                         8);
+                         "The number of split candidates to create per input element, which is also the number of histogram bins minus one (at most 254)",
+                         254);
 
         parser.AddOption(sortingTrainer,
                          "sortingTrainer",
                          "st",
                          "Use the sorting trainer instead of the histogram trainer",
                          false);
+
+        parser.AddOption(sketchThresholds,
+                         "sketchThresholds",
+                         "skt",
+                         "Find the histogram trainer's split candidates with a quantile sketch of all the examples, instead of sorting a sample of thresholdFinderSampleSize of them",
+                         false);
     }
 } // namespace common
 } // namespace ell
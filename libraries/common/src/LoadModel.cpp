@@ -19,23 +19,32 @@
 #include <nodes/include/ActivationFunctions.h>
 #include <nodes/include/BinaryOperationNode.h>
 #include <nodes/include/BinaryPredicateNode.h>
+#include <nodes/include/BiquadFilterNode.h>
+#include <nodes/include/BlockedConvolutionNode.h>
 #include <nodes/include/BroadcastFunctionNode.h>
 #include <nodes/include/BroadcastOperationNodes.h>
 #include <nodes/include/BufferNode.h>
+#include <nodes/include/CausalConvolutionNode.h>
 #include <nodes/include/ClockNode.h>
 #include <nodes/include/ConcatenationNode.h>
 #include <nodes/include/DCTNode.h>
 #include <nodes/include/DTWDistanceNode.h>
 #include <nodes/include/DelayNode.h>
+#include <nodes/include/DepthwiseConvolutionNode.h>
 #include <nodes/include/DiagonalConvolutionNode.h>
 #include <nodes/include/DotProductNode.h>
 #include <nodes/include/ExtremalValueNode.h>
 #include <nodes/include/FFTNode.h>
 #include <nodes/include/FilterBankNode.h>
+#include <nodes/include/FixedPointDSPNodes.h>
+#include <nodes/include/ForestEvaluatorNode.h>
 #include <nodes/include/ForestPredictorNode.h>
+#include <nodes/include/GateNode.h>
 #include <nodes/include/GRUNode.h>
+#include <nodes/include/HalfPrecisionMatrixVectorProductNode.h>
 #include <nodes/include/HammingWindowNode.h>
 #include <nodes/include/IIRFilterNode.h>
+#include <nodes/include/ImagePreprocessingNode.h>
 #include <nodes/include/L2NormSquaredNode.h>
 #include <nodes/include/LSTMNode.h>
 #include <nodes/include/LinearPredictorNode.h>
@@ -44,9 +53,12 @@
 #include <nodes/include/MatrixVectorProductNode.h>
 #include <nodes/include/MovingAverageNode.h>
 #include <nodes/include/MovingVarianceNode.h>
+#include <nodes/include/MultichannelFFTNode.h>
 #include <nodes/include/MultiplexerNode.h>
 #include <nodes/include/NeuralNetworkPredictorNode.h>
 #include <nodes/include/ProtoNNPredictorNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
+#include <nodes/include/QuantizedMatrixVectorProductNode.h>
 #include <nodes/include/RNNNode.h>
 #include <nodes/include/ReceptiveFieldMatrixNode.h>
 #include <nodes/include/ReinterpretLayoutNode.h>
@@ -54,6 +66,10 @@
 #include <nodes/include/SimpleConvolutionNode.h>
 #include <nodes/include/SinkNode.h>
 #include <nodes/include/SourceNode.h>
+#include <nodes/include/SparseLinearPredictorNode.h>
+#include <nodes/include/SparseMatrixVectorProductNode.h>
+#include <nodes/include/StreamingSpectrogramNode.h>
+#include <nodes/include/TopKNode.h>
 #include <nodes/include/UnaryOperationNode.h>
 #include <nodes/include/UnrolledConvolutionNode.h>
 #include <nodes/include/VoiceActivityDetectorNode.h>
@@ -72,8 +88,10 @@
 #include <predictors/neural/include/TanhActivation.h>
 
 #include <utilities/include/Archiver.h>
+#include <utilities/include/BinaryArchiver.h>
 #include <utilities/include/Files.h>
 #include <utilities/include/JsonArchiver.h>
+#include <utilities/include/MemoryMappedFile.h>
 
 #include <cstdint>
 
@@ -86,205 +104,251 @@ namespace ell
 namespace common
 {
     template <typename ElementType>
-    void RegisterRealNodeTypes(SerializationContext& context)
+    void AddRealNodeTypes(GenericTypeFactory& factory)
     {
-        context.GetTypeFactory().AddType<model::Node, model::InputNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, model::OutputNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, model::SpliceNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, model::SliceNode<ElementType>>();
-
-        context.GetTypeFactory().AddType<model::Node, nodes::AccumulatorNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ArgMaxNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ArgMinNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BinaryOperationNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::HardSigmoidActivationFunction<ElementType>>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::LeakyReLUActivationFunction<ElementType>>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::ReLUActivationFunction<ElementType>>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::SigmoidActivationFunction<ElementType>>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastLinearFunctionNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryOperationNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastBinaryOperationNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastTernaryOperationNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BufferNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ConcatenationNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ConstantNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::DelayNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::DiagonalConvolutionNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::DiagonalConvolutionComputeNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::DotProductNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::DTWDistanceNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::FFTNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::GRUNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::HammingWindowNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::L2NormSquaredNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::IIRFilterNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::LinearPredictorNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::LinearFilterBankNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::LSTMNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MelFilterBankNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MatrixVectorProductNode<ElementType, math::MatrixLayout::rowMajor>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MatrixVectorProductNode<ElementType, math::MatrixLayout::columnMajor>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MatrixMatrixMultiplyNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MatrixVectorMultiplyNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MovingAverageNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MovingVarianceNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::NeuralNetworkPredictorNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ReinterpretLayoutNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::RNNNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::SimpleConvolutionComputeNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::SimpleConvolutionNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::SinkNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::SourceNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::SumNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<bool, ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<int, ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<int64_t, ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<float, ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<double, ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::UnaryOperationNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::UnrolledConvolutionNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::WinogradConvolutionNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::WinogradConvolutionComputeNode<ElementType>>();
+        factory.AddType<model::Node, model::InputNode<ElementType>>();
+        factory.AddType<model::Node, model::OutputNode<ElementType>>();
+        factory.AddType<model::Node, model::SpliceNode<ElementType>>();
+        factory.AddType<model::Node, model::SliceNode<ElementType>>();
+
+        factory.AddType<model::Node, nodes::AccumulatorNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ArgMaxNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ArgMinNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BinaryOperationNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BlockedConvolutionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::HardSigmoidActivationFunction<ElementType>>>();
+        factory.AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::LeakyReLUActivationFunction<ElementType>>>();
+        factory.AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::ReLUActivationFunction<ElementType>>>();
+        factory.AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::SigmoidActivationFunction<ElementType>>>();
+        factory.AddType<model::Node, nodes::BroadcastLinearFunctionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BroadcastUnaryOperationNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BroadcastBinaryOperationNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BroadcastTernaryOperationNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BiquadFilterNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BufferNode<ElementType>>();
+        factory.AddType<model::Node, nodes::CausalConvolutionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ConcatenationNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ConstantNode<ElementType>>();
+        factory.AddType<model::Node, nodes::DelayNode<ElementType>>();
+        factory.AddType<model::Node, nodes::DepthwiseConvolutionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::DiagonalConvolutionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::DiagonalConvolutionComputeNode<ElementType>>();
+        factory.AddType<model::Node, nodes::DotProductNode<ElementType>>();
+        factory.AddType<model::Node, nodes::DTWDistanceNode<ElementType>>();
+        factory.AddType<model::Node, nodes::FFTNode<ElementType>>();
+        factory.AddType<model::Node, nodes::FromFixedPointNode<ElementType>>();
+        factory.AddType<model::Node, nodes::GateNode<ElementType>>();
+        factory.AddType<model::Node, nodes::GRUNode<ElementType>>();
+        factory.AddType<model::Node, nodes::HalfPrecisionMatrixVectorProductNode<ElementType>>();
+        factory.AddType<model::Node, nodes::HammingWindowNode<ElementType>>();
+        factory.AddType<model::Node, nodes::L2NormSquaredNode<ElementType>>();
+        factory.AddType<model::Node, nodes::IIRFilterNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ImagePreprocessingNode<ElementType, ElementType>>();
+        factory.AddType<model::Node, nodes::ImagePreprocessingNode<int, ElementType>>();
+        factory.AddType<model::Node, nodes::LinearPredictorNode<ElementType>>();
+        factory.AddType<model::Node, nodes::LinearFilterBankNode<ElementType>>();
+        factory.AddType<model::Node, nodes::LSTMNode<ElementType>>();
+        factory.AddType<model::Node, nodes::MelFilterBankNode<ElementType>>();
+        factory.AddType<model::Node, nodes::MatrixVectorProductNode<ElementType, math::MatrixLayout::rowMajor>>();
+        factory.AddType<model::Node, nodes::MatrixVectorProductNode<ElementType, math::MatrixLayout::columnMajor>>();
+        factory.AddType<model::Node, nodes::MatrixMatrixMultiplyNode<ElementType>>();
+        factory.AddType<model::Node, nodes::MatrixVectorMultiplyNode<ElementType>>();
+        factory.AddType<model::Node, nodes::MovingAverageNode<ElementType>>();
+        factory.AddType<model::Node, nodes::MovingVarianceNode<ElementType>>();
+        factory.AddType<model::Node, nodes::MultichannelFFTNode<ElementType>>();
+        factory.AddType<model::Node, nodes::NeuralNetworkPredictorNode<ElementType>>();
+        factory.AddType<model::Node, nodes::QuantizedConvolutionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::QuantizedMatrixVectorProductNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ReceptiveFieldMatrixNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ReorderDataNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ReinterpretLayoutNode<ElementType>>();
+        factory.AddType<model::Node, nodes::RNNNode<ElementType>>();
+        factory.AddType<model::Node, nodes::SimpleConvolutionComputeNode<ElementType>>();
+        factory.AddType<model::Node, nodes::SimpleConvolutionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::SinkNode<ElementType>>();
+        factory.AddType<model::Node, nodes::SourceNode<ElementType>>();
+        factory.AddType<model::Node, nodes::SparseLinearPredictorNode<ElementType>>();
+        factory.AddType<model::Node, nodes::SparseMatrixVectorProductNode<ElementType>>();
+        factory.AddType<model::Node, nodes::StreamingSpectrogramNode<ElementType>>();
+        factory.AddType<model::Node, nodes::SumNode<ElementType>>();
+        factory.AddType<model::Node, nodes::TopKNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ToFixedPointNode<ElementType>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<bool, ElementType>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<int, ElementType>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<int64_t, ElementType>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<float, ElementType>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<double, ElementType>>();
+        factory.AddType<model::Node, nodes::UnaryOperationNode<ElementType>>();
+        factory.AddType<model::Node, nodes::UnrolledConvolutionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::WinogradConvolutionNode<ElementType>>();
+        factory.AddType<model::Node, nodes::WinogradConvolutionComputeNode<ElementType>>();
 
         // NN layer nodes
-        context.GetTypeFactory().AddType<model::Node, nodes::ActivationLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BatchNormalizationLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BiasLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BinaryConvolutionalLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ConvolutionalLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::FullyConnectedLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ParametricReLUActivationLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::PoolingLayerNode<ElementType, MeanPoolingFunction>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::PoolingLayerNode<ElementType, MaxPoolingFunction>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::RegionDetectionLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ScalingLayerNode<ElementType>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::SoftmaxLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ActivationLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BatchNormalizationLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BiasLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::BinaryConvolutionalLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ConvolutionalLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::FullyConnectedLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ParametricReLUActivationLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::PoolingLayerNode<ElementType, MeanPoolingFunction>>();
+        factory.AddType<model::Node, nodes::PoolingLayerNode<ElementType, MaxPoolingFunction>>();
+        factory.AddType<model::Node, nodes::RegionDetectionLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::ScalingLayerNode<ElementType>>();
+        factory.AddType<model::Node, nodes::SoftmaxLayerNode<ElementType>>();
 
         // Activations
-        context.GetTypeFactory().AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::HardSigmoidActivation<ElementType>>();
-        context.GetTypeFactory().AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::LeakyReLUActivation<ElementType>>();
-        context.GetTypeFactory().AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::ParametricReLUActivation<ElementType>>();
-        context.GetTypeFactory().AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::ReLUActivation<ElementType>>();
-        context.GetTypeFactory().AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::SigmoidActivation<ElementType>>();
-        context.GetTypeFactory().AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::TanhActivation<ElementType>>();
+        factory.AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::HardSigmoidActivation<ElementType>>();
+        factory.AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::LeakyReLUActivation<ElementType>>();
+        factory.AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::ParametricReLUActivation<ElementType>>();
+        factory.AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::ReLUActivation<ElementType>>();
+        factory.AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::SigmoidActivation<ElementType>>();
+        factory.AddType<predictors::neural::ActivationImpl<ElementType>, predictors::neural::TanhActivation<ElementType>>();
 
         // Map the old type names to the new ones for compatibility reasons.
-        context.GetTypeFactory().AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",SigmoidActivation>");
-        context.GetTypeFactory().AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",HardSigmoidActivation>");
-        context.GetTypeFactory().AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",ReLUActivation>");
-        context.GetTypeFactory().AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",LeakyReLUActivation>");
-        context.GetTypeFactory().AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",TanhActivation>");
-        context.GetTypeFactory().AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",ParametricReLUActivation>");
+        factory.AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",SigmoidActivation>");
+        factory.AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",HardSigmoidActivation>");
+        factory.AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",ReLUActivation>");
+        factory.AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",LeakyReLUActivation>");
+        factory.AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",TanhActivation>");
+        factory.AddType<model::Node, nodes::ActivationLayerNode<ElementType>>("ActivationLayerNode<"s + TypeName<ElementType>::GetName() + ",ParametricReLUActivation>");
     }
 
-    void RegisterNodeTypes(SerializationContext& context)
+    void AddNodeTypes(GenericTypeFactory& factory)
     {
-        RegisterRealNodeTypes<float>(context);
-        RegisterRealNodeTypes<double>(context);
+        AddRealNodeTypes<float>(factory);
+        AddRealNodeTypes<double>(factory);
 
         // Add type erased nodes.
-        context.GetTypeFactory().AddType<model::Node, nodes::VoiceActivityDetectorNode>();
+        factory.AddType<model::Node, nodes::VoiceActivityDetectorNode>();
+
+        // Fixed-point DSP nodes, which process integer signals
+        factory.AddType<model::Node, nodes::FixedPointDCTNode>();
+        factory.AddType<model::Node, nodes::FixedPointFFTNode>();
+        factory.AddType<model::Node, nodes::FixedPointFilterBankNode>();
+        factory.AddType<model::Node, nodes::FixedPointIIRFilterNode>();
+        factory.AddType<model::Node, nodes::FixedPointWindowNode>();
 
         // additional non-real types, only for nodes that support that.
-        context.GetTypeFactory().AddType<model::Node, model::InputNode<bool>>();
-        context.GetTypeFactory().AddType<model::Node, model::InputNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, model::InputNode<int64_t>>();
+        factory.AddType<model::Node, model::InputNode<bool>>();
+        factory.AddType<model::Node, model::InputNode<int>>();
+        factory.AddType<model::Node, model::InputNode<int64_t>>();
+
+        factory.AddType<model::Node, model::OutputNode<bool>>();
+        factory.AddType<model::Node, model::OutputNode<int>>();
+        factory.AddType<model::Node, model::OutputNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, model::OutputNode<bool>>();
-        context.GetTypeFactory().AddType<model::Node, model::OutputNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, model::OutputNode<int64_t>>();
+        factory.AddType<model::Node, model::SpliceNode<bool>>();
+        factory.AddType<model::Node, model::SpliceNode<int>>();
+        factory.AddType<model::Node, model::SpliceNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, model::SpliceNode<bool>>();
-        context.GetTypeFactory().AddType<model::Node, model::SpliceNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, model::SpliceNode<int64_t>>();
+        factory.AddType<model::Node, model::SliceNode<bool>>();
+        factory.AddType<model::Node, model::SliceNode<int>>();
+        factory.AddType<model::Node, model::SliceNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, model::SliceNode<bool>>();
-        context.GetTypeFactory().AddType<model::Node, model::SliceNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, model::SliceNode<int64_t>>();
+        factory.AddType<model::Node, nodes::AccumulatorNode<int>>();
+        factory.AddType<model::Node, nodes::AccumulatorNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::AccumulatorNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::AccumulatorNode<int64_t>>();
+        factory.AddType<model::Node, nodes::ArgMaxNode<int>>();
+        factory.AddType<model::Node, nodes::ArgMaxNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::ArgMaxNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ArgMaxNode<int64_t>>();
+        factory.AddType<model::Node, nodes::ArgMinNode<int>>();
+        factory.AddType<model::Node, nodes::ArgMinNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::ArgMinNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ArgMinNode<int64_t>>();
+        factory.AddType<model::Node, nodes::BinaryPredicateNode<int>>();
+        factory.AddType<model::Node, nodes::BinaryPredicateNode<double>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::BinaryPredicateNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BinaryPredicateNode<double>>();
+        factory.AddType<model::Node, nodes::BroadcastLinearFunctionNode<int>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::BroadcastLinearFunctionNode<int>>();
+        factory.AddType<model::Node, nodes::BufferNode<bool>>();
+        factory.AddType<model::Node, nodes::BufferNode<int>>();
+        factory.AddType<model::Node, nodes::BufferNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::BufferNode<bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BufferNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::BufferNode<int64_t>>();
+        factory.AddType<model::Node, nodes::ClockNode>();
+        factory.AddType<model::Node, nodes::SinkNode<int>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::ClockNode>();
-        context.GetTypeFactory().AddType<model::Node, nodes::SinkNode<int>>();
+        factory.AddType<model::Node, nodes::ConcatenationNode<bool>>();
+        factory.AddType<model::Node, nodes::ConcatenationNode<int>>();
+        factory.AddType<model::Node, nodes::ConcatenationNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::ConcatenationNode<bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ConcatenationNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ConcatenationNode<int64_t>>();
+        factory.AddType<model::Node, nodes::ConstantNode<bool>>();
+        factory.AddType<model::Node, nodes::ConstantNode<int>>();
+        factory.AddType<model::Node, nodes::ConstantNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::ConstantNode<bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ConstantNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ConstantNode<int64_t>>();
+        factory.AddType<model::Node, nodes::DCTNode<float>>();
+        factory.AddType<model::Node, nodes::DCTNode<double>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::DCTNode<float>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::DCTNode<double>>();
+        factory.AddType<model::Node, nodes::DelayNode<bool>>();
+        factory.AddType<model::Node, nodes::DelayNode<int>>();
+        factory.AddType<model::Node, nodes::DelayNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::DelayNode<bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::DelayNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::DelayNode<int64_t>>();
+        factory.AddType<model::Node, nodes::DemultiplexerNode<bool, bool>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::DemultiplexerNode<bool, bool>>();
+        factory.AddType<model::Node, nodes::ForestEvaluatorNode>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<bool, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<int, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<int64_t, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<float, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<double, bool>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<bool, bool>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<int, bool>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<int64_t, bool>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<float, bool>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<double, bool>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<bool, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<int, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<int64_t, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<float, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::MultiplexerNode<double, int>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<bool, int>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<int, int>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<int64_t, int>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<float, int>>();
+        factory.AddType<model::Node, nodes::MultiplexerNode<double, int>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::ProtoNNPredictorNode>();
+        factory.AddType<model::Node, nodes::ProtoNNPredictorNode>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::ReinterpretLayoutNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::ReinterpretLayoutNode<bool>>();
+        factory.AddType<model::Node, nodes::ReinterpretLayoutNode<int>>();
+        factory.AddType<model::Node, nodes::ReinterpretLayoutNode<bool>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::SimpleForestPredictorNode>();
+        factory.AddType<model::Node, nodes::SimpleForestPredictorNode>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::SingleElementThresholdNode>();
+        factory.AddType<model::Node, nodes::SingleElementThresholdNode>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::SumNode<int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::SumNode<int64_t>>();
+        factory.AddType<model::Node, nodes::SumNode<int>>();
+        factory.AddType<model::Node, nodes::SumNode<int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<bool, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<bool, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<bool, int64_t>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<bool, bool>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<bool, int>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<bool, int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<int, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<int, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<int, int64_t>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<int, bool>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<int, int>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<int, int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<int64_t, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<int64_t, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<int64_t, int64_t>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<int64_t, bool>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<int64_t, int>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<int64_t, int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<float, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<float, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<float, int64_t>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<float, bool>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<float, int>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<float, int64_t>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<double, bool>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<double, int>>();
-        context.GetTypeFactory().AddType<model::Node, nodes::TypeCastNode<double, int64_t>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<double, bool>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<double, int>>();
+        factory.AddType<model::Node, nodes::TypeCastNode<double, int64_t>>();
+    }
+
+    namespace
+    {
+        // The node types are added once per process, when the first model is loaded, and every serialization context
+        // shares them rather than adding its own copies
+        const GenericTypeFactory& GetNodeTypeFactory()
+        {
+            static const GenericTypeFactory factory = [] {
+                GenericTypeFactory result;
+                AddNodeTypes(result);
+                return result;
+            }();
+            return factory;
+        }
+    } // namespace
+
+    void RegisterNodeTypes(SerializationContext& context)
+    {
+        context.GetTypeFactory().AddTypes(GetNodeTypeFactory());
     }
 
     void RegisterMapTypes(SerializationContext& context)
@@ -310,6 +374,31 @@ namespace common
         archiver.Archive(obj);
     }
 
+    namespace
+    {
+        // Binary archives are read in place from a memory map, so their arrays are copied straight out of the file's pages
+        bool IsBinaryArchiveFile(const std::string& filename)
+        {
+            auto filestream = OpenIfstream(filename);
+            return BinaryArchiveFormat::HasHeader(filestream);
+        }
+
+        bool HasBinaryArchiveExtension(const std::string& filename)
+        {
+            return GetFileExtension(filename, true) == "ellb";
+        }
+
+        template <typename ObjectType>
+        ObjectType LoadMappedBinaryObject(const std::string& filename, SerializationContext& context)
+        {
+            MemoryMappedFile file(filename);
+            BinaryUnarchiver unarchiver(static_cast<const char*>(file.GetData()), file.GetSize(), context);
+            ObjectType obj;
+            unarchiver.Unarchive(obj);
+            return obj;
+        }
+    } // namespace
+
     model::Model LoadModel(const std::string& filename)
     {
         if (!IsFileReadable(filename))
@@ -317,6 +406,13 @@ namespace common
             throw SystemException(SystemExceptionErrors::fileNotFound);
         }
 
+        if (IsBinaryArchiveFile(filename))
+        {
+            SerializationContext context;
+            RegisterNodeTypes(context);
+            return LoadMappedBinaryObject<model::Model>(filename, context);
+        }
+
         auto filestream = OpenIfstream(filename);
         return LoadArchivedModel<JsonUnarchiver>(filestream);
     }
@@ -328,6 +424,11 @@ namespace common
             throw SystemException(SystemExceptionErrors::fileNotWritable);
         }
         auto filestream = OpenOfstream(filename);
+        if (HasBinaryArchiveExtension(filename))
+        {
+            SaveArchivedObject<BinaryArchiver>(model, filestream);
+            return;
+        }
         SaveModel(model, filestream);
     }
 
@@ -412,10 +513,18 @@ namespace common
             throw SystemException(SystemExceptionErrors::fileNotFound);
         }
 
-        auto filestream = OpenIfstream(filename);
-
         try
         {
+            if (IsBinaryArchiveFile(filename))
+            {
+                SerializationContext context;
+                RegisterNodeTypes(context);
+                RegisterMapTypes(context);
+                AddCustomTypes(context);
+                return LoadMappedBinaryObject<model::Map>(filename, context);
+            }
+
+            auto filestream = OpenIfstream(filename);
             return LoadArchivedMap<JsonUnarchiver>(filestream);
         }
         catch (const std::exception& ex)
@@ -431,6 +540,11 @@ namespace common
             throw SystemException(SystemExceptionErrors::fileNotWritable);
         }
         auto filestream = OpenOfstream(filename);
+        if (HasBinaryArchiveExtension(filename))
+        {
+            SaveArchivedObject<BinaryArchiver>(map, filestream);
+            return;
+        }
         SaveMap(map, filestream);
     }
 
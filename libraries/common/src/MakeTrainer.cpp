@@ -22,6 +22,8 @@
 #include <trainers/include/SortingForestTrainer.h>
 #include <trainers/include/ThresholdFinder.h>
 
+#include <limits>
+
 namespace ell
 {
 namespace common
@@ -127,9 +129,16 @@ namespace common
             {
                 return trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainerArguments);
             }
+            else if (trainerArguments.sketchThresholds)
+            {
+                // the sketch summarizes every example in one pass, so there's no need to sample them
+                auto parameters = trainerArguments;
+                parameters.thresholdFinderSampleSize = std::numeric_limits<size_t>::max();
+                return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::SketchThresholdFinder(trainerArguments.candidatesPerInput), parameters);
+            }
             else
             {
-                return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), trainerArguments);
+                return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::QuantileThresholdFinder(trainerArguments.candidatesPerInput), trainerArguments);
             }
 
         default:
@@ -13,6 +13,9 @@
 #include <utilities/include/JsonArchiver.h>
 #include <utilities/include/StringUtil.h>
 
+#include <iomanip>
+#include <sstream>
+
 namespace ell
 {
 namespace common
@@ -41,6 +44,97 @@ namespace common
             "Emit profiling code",
             false);
 
+        parser.AddOption(
+            profileHardwareCounters,
+            "profileHardwareCounters",
+            "",
+            "Collect hardware performance counters (cycles, instructions, cache and branch misses) in profile regions (requires --profile)",
+            false);
+
+        parser.AddOption(
+            profileSamplingInterval,
+            "profileSamplingInterval",
+            "",
+            "Only time one in every this many calls to the model, leaving out the per-region counters (requires --profile)",
+            1);
+
+        parser.AddOption(
+            profileSamplingPeriod,
+            "profileSamplingPeriod",
+            "",
+            "Only time a call to the model if at least this many milliseconds have passed since the last timed call, leaving out the per-region counters (requires --profile, 0 = don't sample on a timer)",
+            0.0);
+
+        parser.AddOption(
+            reentrant,
+            "reentrant",
+            "",
+            "Emit versions of the model functions that take a pointer to caller-allocated state, so multiple instances of the model can run concurrently (can't be combined with --parallelize or --functionVariants)",
+            false);
+
+        parser.AddOption(
+            externalWeights,
+            "externalWeights",
+            "",
+            "Write the model's weights to a separate .weights file that's loaded at runtime, instead of embedding them in the code",
+            false);
+
+        parser.AddOption(
+            staticMemory,
+            "staticMemory",
+            "",
+            "Allocate the scratch memory nodes use statically, as global variables, instead of on the stack (for microcontrollers)",
+            false);
+
+        parser.AddOption(
+            deduplicateConstants,
+            "deduplicateConstants",
+            "",
+            "Store constant arrays that hold identical data, like tied weights, only once",
+            true);
+
+        parser.AddOption(
+            shareConstantsAcrossModules,
+            "shareConstantsAcrossModules",
+            "",
+            "Name constant arrays after their contents, so the linker keeps a single copy of the arrays shared by several models linked into one program",
+            false);
+
+        parser.AddOption(
+            weightsSection,
+            "weightsSection",
+            "",
+            "Name of the section to place the weight arrays in (e.g., a read-only section the linker script keeps in execute-in-place flash)",
+            "");
+
+        parser.AddOption(
+            weightsAlignment,
+            "weightsAlignment",
+            "",
+            "Alignment of the weight arrays, in bytes (e.g., 2097152 to start them on a huge page). 0 keeps their natural alignment",
+            0);
+
+        parser.AddOption(
+            weightsPlacementThreshold,
+            "weightsPlacementThreshold",
+            "",
+            "Size, in bytes, of the smallest weight array placed with --weightsSection and --weightsAlignment",
+            0);
+
+        parser.AddOption(
+            hugePageWeights,
+            "hugePageWeights",
+            "",
+            "Ask the OS to back the external weights blob with huge pages when it's passed to the model (with --externalWeights, Linux only)",
+            false);
+
+        parser.AddOption(
+            noHeap,
+            "noHeap",
+            "",
+            "Guarantee the compiled code doesn't allocate heap memory, by allocating all its buffers statically (implies --reuseBuffers and --staticMemory)",
+            false);
+
         parser.AddOption(
             optimize,
             "optimize",
@@ -48,6 +142,69 @@ namespace common
             "Optimize output code",
             true);
 
+        parser.AddOption(
+            reuseIntermediateBuffers,
+            "reuseBuffers",
+            "rb",
+            "Share memory between intermediate buffers that are not live at the same time",
+            false);
+
+        parser.AddOption(
+            aliasPortBuffers,
+            "aliasPortBuffers",
+            "",
+            "Compile nodes that only move data around (slices, splices and concatenations) into views of their inputs' buffers instead of copies",
+            true);
+
+        parser.AddOption(
+            maxStackPortBufferSize,
+            "maxStackPortBufferSize",
+            "",
+            "Allocate intermediate buffers of at most this many bytes on the stack of the map function instead of as globals, so they can be kept in registers (0 to keep all of them global)",
+            0);
+
+        parser.AddOption(
+            inlineElementwiseNodes,
+            "inlineElementwiseNodes",
+            "",
+            "Emit the code of elementwise nodes into the map function instead of into functions of their own",
+            false);
+
+        parser.AddOption(
+            inlineNodeSizeLimit,
+            "inlineNodeSizeLimit",
+            "",
+            "Emit the code of nodes whose ports hold at most this many elements in all into the map function instead of into functions of their own (0 to inline none)",
+            0);
+
+        parser.AddOption(
+            parallelizeBranches,
+            "parallelizeBranches",
+            "",
+            "Compute the independent branches of the model that are joined by later nodes, like the members of an ensemble, as concurrent tasks (with --parallelize)",
+            false);
+
+        parser.AddOption(
+            emitBatchFunction,
+            "batchFunction",
+            "bf",
+            "Also emit a function that computes the output for a batch of inputs",
+            false);
+
+        parser.AddOption(
+            batchFunctionSize,
+            "batchFunctionSize",
+            "",
+            "The number of inputs the batch function computes at once, with one matrix product per layer for all of them (with --batchFunction)",
+            16);
+
+        parser.AddOption(
+            emitAsyncFunctions,
+            "asyncFunctions",
+            "",
+            "Also emit functions that compute a frame on another thread while the caller fills in the next one",
+            false);
+
         parser.AddOption(
             useBlas,
             "blas",
@@ -62,6 +219,20 @@ namespace common
             "Fuse sequences of linear operations with constant coefficients into a single operation",
             true);
 
+        parser.AddOption(
+            fuseElementwiseOperations,
+            "fuseElementwiseOps",
+            "",
+            "Fuse activation functions into the linear operation that precedes them",
+            true);
+
+        parser.AddOption(
+            fuseSoftmaxTopK,
+            "fuseSoftmaxTopK",
+            "",
+            "Fuse a softmax into the top-k node that follows it, so only the top-k probabilities are computed",
+            true);
+
         parser.AddOption(
             optimizeReorderDataNodes,
             "optimizeReorderDataNodes",
@@ -69,6 +240,27 @@ namespace common
             "Optimize sequences of reordering nodes",
             true);
 
+        parser.AddOption(
+            eliminateRedundantConversions,
+            "eliminateRedundantConversions",
+            "",
+            "Remove type casts and reorderings that cancel out, moving reorderings past elementwise operations",
+            true);
+
+        parser.AddOption(
+            foldConstants,
+            "foldConstants",
+            "",
+            "Compute the parts of the model that only depend on constants ahead of time",
+            true);
+
+        parser.AddOption(
+            eliminateCommonSubexpressions,
+            "eliminateCommonSubexpressions",
+            "",
+            "Merge nodes that compute the same thing from the same inputs",
+            true);
+
         parser.AddOption(
             convolutionMethod,
             "convolutionMethod",
@@ -78,9 +270,39 @@ namespace common
               { "simple", PreferredConvolutionMethod::simple },
               { "diagonal", PreferredConvolutionMethod::diagonal },
               { "winograd", PreferredConvolutionMethod::winograd },
+              { "depthwise", PreferredConvolutionMethod::depthwise },
+              { "blocked", PreferredConvolutionMethod::blocked },
               { "auto", PreferredConvolutionMethod::automatic } },
             "auto");
 
+        parser.AddOption(
+            implicitGemmConvolution,
+            "implicitGemmConvolution",
+            "",
+            "Compute unrolled convolutions a tile at a time, without materializing the receptive field matrix",
+            true);
+
+        parser.AddOption(
+            convolutionCostDatabase,
+            "convolutionCostDatabase",
+            "",
+            "File with measured costs of the convolution methods, used to choose the method when convolutionMethod is auto",
+            "");
+
+        parser.AddOption(
+            autotuneConvolutionMethod,
+            "autotuneConvolutionMethod",
+            "",
+            "Measure the convolution methods not yet in the convolution cost database, and add them to it",
+            false);
+
+        parser.AddOption(
+            searchTransformations,
+            "searchTransformations",
+            "",
+            "Only apply the model optimizer transformations that reduce the measured runtime of the model",
+            false);
+
         parser.AddOption(
             modelOptions,
             "modelOption",
@@ -95,6 +317,13 @@ namespace common
             "Add a node-specific option",
             std::vector<std::string>{});
 
+        parser.AddOption(
+            nodeTypeOptions,
+            "nodeTypeOption",
+            "",
+            "Add an option for all nodes whose type name matches a regular expression, in the format \"<node_type_regex>,<option_name>,<option_value>\"",
+            std::vector<std::string>{});
+
         parser.AddOption(
             enableVectorization,
             "vectorize",
@@ -109,6 +338,20 @@ namespace common
             "Size of vector units",
             4);
 
+        parser.AddOption(
+            prefetchDistance,
+            "prefetchDistance",
+            "",
+            "Number of bytes ahead of their reads that matrix-vector and matrix-matrix products prefetch (0 to leave prefetching to the hardware)",
+            0);
+
+        parser.AddOption(
+            nonTemporalStoreThreshold,
+            "nonTemporalStoreThreshold",
+            "",
+            "Size, in bytes, from which write-once outputs (e.g., reordered data) bypass the cache (0 to never bypass it)",
+            0);
+
         parser.AddOption(
             parallelize,
             "parallelize",
@@ -123,6 +366,110 @@ namespace common
             "Use thread pool for parallelization (if parallelization enabled)",
             true);
 
+        parser.AddOption(
+            useWorkStealing,
+            "workStealing",
+            "ws",
+            "Use per-thread task deques with work stealing in the thread pool (if thread pool enabled)",
+            false);
+
+        parser.AddOption(
+            parallelLoopSchedule,
+            "parallelLoopSchedule",
+            "",
+            "How parallel loops split their iterations among tasks, for nodes that don't pick a schedule (if parallelization enabled)",
+            { { "static", emitters::ParallelLoopSchedule::staticBlocks },
+              { "dynamic", emitters::ParallelLoopSchedule::dynamic },
+              { "guided", emitters::ParallelLoopSchedule::guided } },
+            "static");
+
+        parser.AddOption(
+            parallelLoopChunkSize,
+            "parallelLoopChunkSize",
+            "",
+            "Iterations a task claims at a time with the dynamic schedule, and the smallest chunk with the guided schedule",
+            1);
+
+        parser.AddOption(
+            threadPoolSpinCount,
+            "threadPoolSpinCount",
+            "",
+            "Number of times idle thread pool workers and waiting clients check for tasks, with a CPU pause backoff, before blocking (if thread pool enabled)",
+            0);
+
+        parser.AddOption(
+            threadAffinity,
+            "threadAffinity",
+            "",
+            "How to pin the thread pool's worker threads to cores on Linux targets (if thread pool enabled)",
+            { { "none", emitters::ThreadAffinity::none },
+              { "compact", emitters::ThreadAffinity::compact },
+              { "scatter", emitters::ThreadAffinity::scatter } },
+            "none");
+
+        parser.AddOption(
+            affinityCores,
+            "affinityCores",
+            "",
+            "Comma-separated cores or core ranges to pin worker threads to, socket by socket (e.g., 4-7 for the big cores of a big.LITTLE CPU). Defaults to cores 0 to maxThreads-1",
+            "");
+
+        parser.AddOption(
+            affinitySockets,
+            "affinitySockets",
+            "",
+            "Number of sockets or clusters the affinity cores are split evenly over, for scatter placement",
+            1);
+
+        parser.AddOption(
+            externalThreadPool,
+            "externalThreadPool",
+            "",
+            "Run parallel tasks on a thread pool the application provides through ELL_SubmitTask and ELL_WaitForTask, so several models can share it (if parallelization enabled)",
+            false);
+
+        parser.AddOption(
+            taskPriority,
+            "taskPriority",
+            "",
+            "The priority of the model's tasks on the external thread pool (higher is more urgent)",
+            0);
+
+        parser.AddOption(
+            useApproximateMath,
+            "approximateMath",
+            "",
+            "Compute exp, tanh, and sigmoid with fast polynomial approximations instead of runtime library calls",
+            false);
+
+        parser.AddOption(
+            functionVariants,
+            "functionVariants",
+            "",
+            "Comma-separated CPU feature sets to emit variants of each node function for, chosen at runtime (avx2, avx512, neon, dotprod)",
+            "");
+
+        parser.AddOption(
+            codeGenPartitions,
+            "codeGenPartitions",
+            "",
+            "Split the object code into this many files (<name>.o, <name>_1.o, ...), which are compiled in parallel",
+            1);
+
+        parser.AddOption(
+            pgoInstrument,
+            "pgoInstrument",
+            "",
+            "Instrument the code for LLVM profile-guided optimization, writing the raw profile (.profraw) to this file at exit. Link with the LLVM profile runtime (e.g., clang -fprofile-instr-generate)",
+            "");
+
+        parser.AddOption(
+            pgoUse,
+            "pgoUse",
+            "",
+            "Optimize with this profile, merged from the raw profiles of instrumented runs with llvm-profdata merge",
+            "");
+
         parser.AddOption(
             maxThreads,
             "threads",
@@ -130,6 +477,13 @@ namespace common
             "Maximum num of parallel threads",
             4);
 
+        parser.AddOption(
+            parallelizeMinOutputSize,
+            "parallelizeMinOutputSize",
+            "",
+            "Don't parallelize nodes with fewer output elements than this (if parallelization enabled, 0 to allow parallelizing all nodes)",
+            1024);
+
         parser.AddOption(
             debug,
             "debug",
@@ -144,7 +498,7 @@ namespace common
             "target",
             "t",
             "Target name",
-            { { "host" }, { "pi0" }, { "pi3" }, { "orangepi0" }, { "pi3_64" }, { "mac" }, { "linux" }, { "windows" }, { "ios" }, { "aarch64" }, { "custom" } },
+            { { "host" }, { "pi0" }, { "pi3" }, { "orangepi0" }, { "pi3_64" }, { "mac" }, { "linux" }, { "windows" }, { "ios" }, { "aarch64" }, { "cortex-m4" }, { "cortex-m7" }, { "custom" } },
             "host");
 
         parser.AddOption(
@@ -182,6 +536,20 @@ namespace common
             "A string describing target-specific features to enable or disable (these are LLVM attributes, in the format the llc -mattr option uses)",
             "");
 
+        parser.AddOption(
+            targetL1CacheSize,
+            "l1CacheSize",
+            "",
+            "The size of the target's L1 data cache in bytes, used to choose loop tile sizes (0 = the target's default)",
+            0);
+
+        parser.AddOption(
+            targetL2CacheSize,
+            "l2CacheSize",
+            "",
+            "The size of the target's L2 cache in bytes, used to choose loop tile sizes (0 = the target's default)",
+            0);
+
         parser.AddOption(
             positionIndependentCode,
             "positionIndependentCode",
@@ -227,10 +595,51 @@ namespace common
         settings.compilerSettings.useBlas = useBlas;
         settings.compilerSettings.allowVectorInstructions = enableVectorization;
         settings.compilerSettings.parallelize = parallelize;
+        settings.compilerSettings.useThreadPool = useThreadPool;
+        settings.compilerSettings.useWorkStealing = useWorkStealing;
+        settings.compilerSettings.externalThreadPool = externalThreadPool;
+        settings.compilerSettings.taskPriority = taskPriority;
+        settings.compilerSettings.maxThreads = maxThreads;
+        settings.compilerSettings.threadPoolSpinCount = threadPoolSpinCount;
+        settings.compilerSettings.parallelLoopSchedule = parallelLoopSchedule;
+        settings.compilerSettings.parallelLoopChunkSize = parallelLoopChunkSize;
+        settings.compilerSettings.threadAffinity = threadAffinity;
+        settings.compilerSettings.affinityCores = affinityCores;
+        settings.compilerSettings.affinitySockets = affinitySockets;
         settings.compilerSettings.vectorWidth = vectorWidth;
+        settings.compilerSettings.prefetchDistance = prefetchDistance;
+        settings.compilerSettings.nonTemporalStoreThreshold = nonTemporalStoreThreshold;
+        settings.compilerSettings.functionVariants = functionVariants;
+        settings.compilerSettings.useApproximateMath = useApproximateMath;
         settings.profile = profile;
-        settings.compilerSettings.profile = profile;
+        settings.profileSamplingInterval = profileSamplingInterval;
+        settings.profileSamplingPeriod = profileSamplingPeriod;
+        settings.reuseIntermediateBuffers = reuseIntermediateBuffers;
+        settings.aliasPortBuffers = aliasPortBuffers;
+        settings.maxStackPortBufferSize = maxStackPortBufferSize;
+        settings.inlineElementwiseNodes = inlineElementwiseNodes;
+        settings.inlineNodeSizeLimit = inlineNodeSizeLimit;
+        settings.parallelizeBranches = parallelizeBranches;
+        settings.emitBatchFunction = emitBatchFunction;
+        settings.batchFunctionSize = batchFunctionSize;
+        settings.emitAsyncFunctions = emitAsyncFunctions;
+        // The region profiler times every call, so it's left out when the node timers are sampled
+        settings.compilerSettings.profile = profile && profileSamplingInterval <= 1 && profileSamplingPeriod <= 0;
+        settings.compilerSettings.profileHardwareCounters = profileHardwareCounters;
+        settings.compilerSettings.reentrant = reentrant;
+        settings.compilerSettings.externalWeights = externalWeights;
+        settings.compilerSettings.staticMemory = staticMemory;
+        settings.compilerSettings.deduplicateConstants = deduplicateConstants;
+        settings.compilerSettings.shareConstantsAcrossModules = shareConstantsAcrossModules;
+        settings.compilerSettings.weightsSection = weightsSection;
+        settings.compilerSettings.weightsAlignment = weightsAlignment;
+        settings.compilerSettings.weightsPlacementThreshold = weightsPlacementThreshold;
+        settings.compilerSettings.hugePageWeights = hugePageWeights;
+        settings.noHeap = noHeap;
         settings.compilerSettings.positionIndependentCode = positionIndependentCode;
+        settings.compilerSettings.codeGenPartitions = codeGenPartitions;
+        settings.compilerSettings.pgoInstrumentFile = pgoInstrument;
+        settings.compilerSettings.pgoProfileFile = pgoUse;
 
         if (target != "")
         {
@@ -262,6 +671,12 @@ namespace common
             settings.compilerSettings.targetDevice.numBits = numBits;
         }
 
+        if (targetL1CacheSize != 0 || targetL2CacheSize != 0)
+        {
+            settings.compilerSettings.targetDevice.l1CacheSize = static_cast<size_t>(targetL1CacheSize);
+            settings.compilerSettings.targetDevice.l2CacheSize = static_cast<size_t>(targetL2CacheSize);
+        }
+
         // Now add any settings specified in the --modelOptions metadata
         auto metadata = GetOptionsMetadata();
         if (metadata.HasEntry("model"))
@@ -276,8 +691,17 @@ namespace common
     {
         model::ModelOptimizerOptions options;
         options["fuseLinearFunctionNodes"] = fuseLinearOperations;
+        options["fuseElementwiseOperations"] = fuseElementwiseOperations;
+        options["fuseSoftmaxTopK"] = fuseSoftmaxTopK;
         options["optimizeReorderDataNodes"] = optimizeReorderDataNodes;
+        options["eliminateRedundantConversions"] = eliminateRedundantConversions;
+        options["foldConstants"] = foldConstants;
+        options["eliminateCommonSubexpressions"] = eliminateCommonSubexpressions;
         options["preferredConvolutionMethod"] = convolutionMethod;
+        options["implicitGemmConvolution"] = implicitGemmConvolution;
+        options["convolutionCostDatabase"] = convolutionCostDatabase;
+        options["autotuneConvolutionMethod"] = autotuneConvolutionMethod;
+        options["searchTransformations"] = searchTransformations;
 
         auto metadata = GetOptionsMetadata();
         if (metadata.HasEntry("model"))
@@ -290,7 +714,7 @@ namespace common
 
     bool MapCompilerArguments::HasOptionsMetadata() const
     {
-        return !nodeOptions.empty() || !modelOptions.empty();
+        return !nodeOptions.empty() || !modelOptions.empty() || !nodeTypeOptions.empty() || (parallelize && parallelizeMinOutputSize > 0);
     }
 
     utilities::PropertyBag MapCompilerArguments::GetOptionsMetadata() const
@@ -308,6 +732,17 @@ namespace common
             result["nodes"] = nodesMetadata;
         }
 
+        utilities::PropertyBag rulesMetadata = GetNodeRulesMetadata();
+        if (!rulesMetadata.IsEmpty())
+        {
+            result["rules"] = rulesMetadata;
+        }
+
+        if (parallelize && parallelizeMinOutputSize > 0)
+        {
+            result["parallelizeMinOutputSize"] = parallelizeMinOutputSize;
+        }
+
         return result;
     }
 
@@ -359,5 +794,38 @@ namespace common
         return nodesMetadata;
     }
 
+    utilities::PropertyBag MapCompilerArguments::GetNodeRulesMetadata() const
+    {
+        utilities::PropertyBag rulesMetadata;
+        for (size_t index = 0; index < nodeTypeOptions.size(); ++index)
+        {
+            const auto& entry = nodeTypeOptions[index];
+            if (!entry.empty())
+            {
+                auto parts = utilities::Split(entry, ',');
+                if (parts.size() == 3u) // node type pattern, key, value
+                {
+                    utilities::PropertyBag options;
+                    options[parts[1]] = parts[2];
+
+                    utilities::PropertyBag rule;
+                    rule["nodeType"] = parts[0];
+                    rule["options"] = options;
+
+                    // Rules are applied in order of their names, so make the names sort in command-line order
+                    std::stringstream ruleName;
+                    ruleName << "nodeTypeOption_" << std::setw(4) << std::setfill('0') << index;
+                    rulesMetadata[ruleName.str()] = rule;
+                }
+                else
+                {
+                    auto msg = "Node type options must be in the format \"<node_type_regex>,<option_name>,<option_value>\", got: " + entry;
+                    throw utilities::CommandLineParserInvalidOptionsException(msg.c_str());
+                }
+            }
+        }
+        return rulesMetadata;
+    }
+
 } // namespace common
 } // namespace ell
@@ -74,6 +74,24 @@ namespace common
                          "nInnerIter",
                          "Number of inner iterations",
                          1);
+
+        parser.AddOption(batchSize,
+                         "batchSize",
+                         "bs",
+                         "The number of examples in each mini-batch, or 0 for the default of 256",
+                         0);
+
+        parser.AddOption(numThreads,
+                         "numThreads",
+                         "nt",
+                         "The number of threads, or 0 to use all the hardware threads",
+                         1);
+
+        parser.AddOption(shuffleExamples,
+                         "shuffleExamples",
+                         "shuf",
+                         "Shuffle the examples, so that each mini-batch is a random sample",
+                         true);
     }
 } // namespace common
 } // namespace ell
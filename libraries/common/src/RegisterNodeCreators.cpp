@@ -29,6 +29,7 @@
 #include <nodes/include/MovingAverageNode.h>
 #include <nodes/include/MovingVarianceNode.h>
 #include <nodes/include/MultiplexerNode.h>
+#include <nodes/include/TopKNode.h>
 #include <nodes/include/UnaryOperationNode.h>
 #include <nodes/include/ValueSelectorNode.h>
 
@@ -121,6 +122,9 @@ namespace common
         builder.RegisterNodeCreator<nodes::SumNode<int>, const model::PortElements<int>&>();
         builder.RegisterNodeCreator<nodes::SumNode<double>, const model::PortElements<double>&>();
 
+        builder.RegisterNodeCreator<nodes::TopKNode<float>, const model::PortElements<float>&, int, bool>();
+        builder.RegisterNodeCreator<nodes::TopKNode<double>, const model::PortElements<double>&, int, bool>();
+
         builder.RegisterNodeCreator<nodes::TypeCastNode<bool, int>, const model::PortElements<bool>&>();
         builder.RegisterNodeCreator<nodes::TypeCastNode<int, double>, const model::PortElements<int>&>();
 
@@ -130,6 +130,14 @@ namespace data
         template <IterationPolicy policy, typename TransformationType>
         void AddTransformedTo(math::RowVectorReference<double> vector, TransformationType transformation) const;
 
+        /// <summary> Calls a function on each element of this data vector, without copying it. </summary>
+        ///
+        /// <typeparam name="policy"> The iteration policy. </typeparam>
+        /// <typeparam name="VisitorType"> The visitor type, which is a functor that takes an IndexValue. </typeparam>
+        /// <param name="visitor"> The visitor, which is called on the elements in order of their indices. </param>
+        template <IterationPolicy policy, typename VisitorType>
+        void VisitElements(VisitorType visitor) const;
+
         /// <summary> Copies the contents of this DataVector into a double array of size PrefixLength(). </summary>
         ///
         /// <returns> The array. </returns>
@@ -299,6 +307,13 @@ namespace data
         _pInternal->AddTransformedTo<policy>(vector, transformation);
     }
 
+    template <typename DefaultDataVectorType>
+    template <IterationPolicy policy, typename VisitorType>
+    void AutoDataVectorBase<DefaultDataVectorType>::VisitElements(VisitorType visitor) const
+    {
+        _pInternal->VisitElements<policy>(visitor);
+    }
+
     template <typename DefaultDataVectorType>
     template <typename ReturnType, typename... ArgTypes>
     ReturnType AutoDataVectorBase<DefaultDataVectorType>::CopyAs(ArgTypes... args) const
@@ -0,0 +1,384 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDataset.h (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "DataVector.h"
+#include "Dataset.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+#include "IndexValue.h"
+#include "WeightLabel.h"
+
+#include <math/include/Vector.h>
+
+#include <utilities/include/MemoryMappedFile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// The binary dataset format. A file starts with a BinaryDatasetHeader, which is followed by the data vectors,
+    /// the index (numExamples + 1 offsets of the data vectors, relative to the start of the file), the labels and the
+    /// weights. Each data vector starts with a BinaryDataVectorHeader and is followed by its elements: the values
+    /// of the prefix of a dense vector, or the indices (as 32 bit integers) followed by the values of the nonzeros of
+    /// a sparse vector. Values are stored in the element type of the data vector type the text parser chose, and every
+    /// array is 8 byte aligned. All numbers are stored in the byte order of the machine that wrote the file.
+    /// </summary>
+    struct BinaryDatasetHeader
+    {
+        static constexpr char magic[8] = { 'E', 'L', 'L', 'D', 'A', 'T', 'A', '\0' };
+        static constexpr uint32_t currentVersion = 1;
+
+        char fileMagic[8];
+        uint32_t version;
+        uint32_t byteOrderMark;
+        uint64_t numExamples;
+        uint64_t numFeatures;
+        uint64_t indexOffset;
+        uint64_t labelsOffset;
+        uint64_t weightsOffset;
+    };
+
+    /// <summary> The header of a data vector in the binary dataset format. </summary>
+    struct BinaryDataVectorHeader
+    {
+        uint32_t type; // an IDataVector::Type
+        uint32_t reserved;
+        uint64_t prefixLength;
+        uint64_t numStoredElements;
+    };
+
+    /// <summary> Writes examples to a stream in the binary dataset format, one example at a time. </summary>
+    class BinaryDatasetWriter
+    {
+    public:
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="stream"> The output stream, which must be binary and seekable, such as a std::ofstream opened with utilities::OpenBinaryOfstream. </param>
+        BinaryDatasetWriter(std::ostream& stream);
+
+        BinaryDatasetWriter(const BinaryDatasetWriter&) = delete;
+        BinaryDatasetWriter& operator=(const BinaryDatasetWriter&) = delete;
+
+        /// <summary> Appends an example to the dataset. </summary>
+        ///
+        /// <param name="example"> The example. </param>
+        void Write(const AutoSupervisedExample& example);
+
+        /// <summary> Writes the index, labels and weights, and completes the header. No examples can be added afterwards. </summary>
+        void Close();
+
+    private:
+        template <typename ValueType>
+        void WriteArray(const ValueType* pValues, size_t count);
+        void WritePadding();
+
+        std::ostream& _stream;
+        uint64_t _position = 0;
+        uint64_t _numFeatures = 0;
+        std::vector<uint64_t> _offsets;
+        std::vector<double> _labels;
+        std::vector<double> _weights;
+        bool _isClosed = false;
+    };
+
+    /// <summary> Writes a dataset to a stream in the binary dataset format. </summary>
+    ///
+    /// <param name="dataset"> The dataset. </param>
+    /// <param name="stream"> The output stream, which must be binary and seekable. </param>
+    void WriteBinaryDataset(const AutoSupervisedDataset& dataset, std::ostream& stream);
+
+    /// <summary>
+    /// Writes the examples of an example iterator to a stream in the binary dataset format. The examples are converted
+    /// one at a time, so a text dataset can be converted without loading all of it into memory.
+    /// </summary>
+    ///
+    /// <param name="exampleIterator"> The example iterator. </param>
+    /// <param name="stream"> The output stream, which must be binary and seekable. </param>
+    void WriteBinaryDataset(AutoSupervisedExampleIterator exampleIterator, std::ostream& stream);
+
+    /// <summary> Checks if a file starts with the header of the binary dataset format. </summary>
+    ///
+    /// <param name="filepath"> The path of the file. </param>
+    ///
+    /// <returns> true if the file is a binary dataset. </returns>
+    bool IsBinaryDataset(const std::string& filepath);
+
+    /// <summary> An index value iterator over the nonzero elements of a BinaryDataVector. </summary>
+    class BinaryDataVectorIterator : public IIndexValueIterator
+    {
+    public:
+        /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+        ///
+        /// <returns> true if valid, false if not. </returns>
+        bool IsValid() const { return _index < _numStoredElements; }
+
+        /// <summary> Proceeds to the next iterate. </summary>
+        void Next();
+
+        /// <summary> Returns the current index-value pair. </summary>
+        ///
+        /// <returns> An IndexValue. </returns>
+        IndexValue Get() const { return { GetIndex(), GetValue() }; }
+
+    private:
+        friend class BinaryDataVector;
+        BinaryDataVectorIterator(IDataVector::Type type, const uint32_t* pIndices, const void* pValues, size_t numStoredElements);
+        void SkipZeros();
+        size_t GetIndex() const { return _pIndices == nullptr ? _index : _pIndices[_index]; }
+        double GetValue() const;
+
+        IDataVector::Type _type;
+        const uint32_t* _pIndices;
+        const void* _pValues;
+        size_t _numStoredElements;
+        size_t _index = 0;
+    };
+
+    /// <summary>
+    /// A read-only view of a data vector that is stored in a BinaryDataset. The view refers to the mapped file
+    /// and owns no memory.
+    /// </summary>
+    class BinaryDataVector
+    {
+    public:
+        /// <summary> Gets the type of the data vector that was stored. </summary>
+        ///
+        /// <returns> The data vector type. </returns>
+        IDataVector::Type GetType() const { return _type; }
+
+        /// <summary> Gets the first index of the suffix of zeros at the end of this vector. </summary>
+        ///
+        /// <returns> The prefix length. </returns>
+        size_t PrefixLength() const { return _prefixLength; }
+
+        /// <summary> Computes the squared 2-norm of the vector. </summary>
+        ///
+        /// <returns> The squared 2-norm of the vector. </returns>
+        double Norm2Squared() const;
+
+        /// <summary> Computes the dot product with another vector. </summary>
+        ///
+        /// <param name="vector"> The other vector. </param>
+        ///
+        /// <returns> A dot product. </returns>
+        double Dot(math::UnorientedConstVectorBase<double> vector) const;
+
+        /// <summary> Adds this data vector to a math::RowVector. </summary>
+        ///
+        /// <param name="vector"> [in,out] The vector that this data vector is added to. </param>
+        void AddTo(math::RowVectorReference<double> vector) const;
+
+        /// <summary> Gets an iterator over the nonzero elements of the vector. </summary>
+        ///
+        /// <returns> The iterator. </returns>
+        BinaryDataVectorIterator GetIterator() const { return BinaryDataVectorIterator(_type, _pIndices, _pValues, _numStoredElements); }
+
+        /// <summary> Copies this data vector into a data vector of a given type, such as an AutoDataVector. </summary>
+        ///
+        /// <typeparam name="ReturnType"> The return type. </typeparam>
+        ///
+        /// <returns> The new data vector. </returns>
+        template <typename ReturnType>
+        ReturnType CopyAs() const
+        {
+            return ReturnType(GetIterator());
+        }
+
+        /// <summary> Calls a function on each stored (index, value) pair, which includes the zeros of a dense vector. </summary>
+        ///
+        /// <typeparam name="FunctionType"> The function type, which takes a size_t index and a double value. </typeparam>
+        /// <param name="function"> The function. </param>
+        template <typename FunctionType>
+        void ForEachStoredElement(FunctionType function) const;
+
+    private:
+        friend class BinaryDataset;
+        BinaryDataVector(const BinaryDataVectorHeader* pHeader);
+
+        template <typename ValueType, typename FunctionType>
+        void ForEachStoredElement(FunctionType function) const;
+
+        IDataVector::Type _type;
+        size_t _prefixLength;
+        size_t _numStoredElements;
+        const uint32_t* _pIndices = nullptr;
+        const void* _pValues = nullptr;
+    };
+
+    /// <summary> A read-only view of an example that is stored in a BinaryDataset. </summary>
+    class BinaryExample
+    {
+    public:
+        using DataVectorType = BinaryDataVector;
+        using MetadataType = WeightLabel;
+
+        /// <summary> Gets the data vector. </summary>
+        ///
+        /// <returns> The data vector. </returns>
+        const BinaryDataVector& GetDataVector() const { return _dataVector; }
+
+        /// <summary> Gets the metadata. </summary>
+        ///
+        /// <returns> The metadata. </returns>
+        const WeightLabel& GetMetadata() const { return _metadata; }
+
+        /// <summary> Copies this example into an example of a given type, such as an AutoSupervisedExample. </summary>
+        ///
+        /// <typeparam name="TargetExampleType"> The target example type. </typeparam>
+        ///
+        /// <returns> The new example. </returns>
+        template <typename TargetExampleType>
+        TargetExampleType CopyAs() const
+        {
+            return TargetExampleType(_dataVector.CopyAs<typename TargetExampleType::DataVectorType>(), _metadata);
+        }
+
+    private:
+        friend class BinaryDataset;
+        BinaryExample(BinaryDataVector dataVector, WeightLabel metadata) :
+            _dataVector(dataVector),
+            _metadata(metadata) {}
+
+        BinaryDataVector _dataVector;
+        WeightLabel _metadata;
+    };
+
+    /// <summary>
+    /// A dataset in the binary dataset format, mapped into memory. Examples are views of the mapped file, so getting
+    /// an example does no heap allocation, and only the pages that are used are read from the file.
+    /// </summary>
+    class BinaryDataset
+    {
+    public:
+        /// <summary> Maps a binary dataset file into memory, and throws an exception if it isn't a valid binary dataset. </summary>
+        ///
+        /// <param name="filepath"> The path of the file. </param>
+        BinaryDataset(const std::string& filepath);
+
+        /// <summary> Returns the number of examples in the dataset. </summary>
+        ///
+        /// <returns> The number of examples. </returns>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary> Returns the maximal prefix length of the data vectors in the dataset. </summary>
+        ///
+        /// <returns> The number of features. </returns>
+        size_t NumFeatures() const { return _numFeatures; }
+
+        /// <summary> Returns a view of an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        BinaryExample GetExample(size_t index) const;
+
+        /// <summary> Returns a view of an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        BinaryExample operator[](size_t index) const { return GetExample(index); }
+
+        /// <summary>
+        /// Returns an iterator that copies the examples into AutoSupervisedExamples one at a time. The iterator must
+        /// not outlive the dataset.
+        /// </summary>
+        ///
+        /// <returns> The iterator. </returns>
+        AutoSupervisedExampleIterator GetExampleIterator() const;
+
+        /// <summary> Copies the examples into a Dataset. </summary>
+        ///
+        /// <returns> The dataset. </returns>
+        AutoSupervisedDataset ToDataset() const;
+
+    private:
+        template <typename ValueType>
+        const ValueType* GetArray(uint64_t offset, size_t count) const;
+
+        utilities::MemoryMappedFile _file;
+        const char* _pData = nullptr;
+        size_t _numExamples = 0;
+        size_t _numFeatures = 0;
+        const uint64_t* _pOffsets = nullptr;
+        const double* _pLabels = nullptr;
+        const double* _pWeights = nullptr;
+    };
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace data
+{
+    template <typename FunctionType>
+    void BinaryDataVector::ForEachStoredElement(FunctionType function) const
+    {
+        switch (_type)
+        {
+        case IDataVector::Type::DoubleDataVector:
+        case IDataVector::Type::SparseDoubleDataVector:
+            ForEachStoredElement<double>(function);
+            break;
+        case IDataVector::Type::FloatDataVector:
+        case IDataVector::Type::SparseFloatDataVector:
+            ForEachStoredElement<float>(function);
+            break;
+        case IDataVector::Type::ShortDataVector:
+        case IDataVector::Type::SparseShortDataVector:
+            ForEachStoredElement<short>(function);
+            break;
+        case IDataVector::Type::ByteDataVector:
+        case IDataVector::Type::SparseByteDataVector:
+            ForEachStoredElement<char>(function);
+            break;
+        case IDataVector::Type::SparseBinaryDataVector:
+            for (size_t i = 0; i < _numStoredElements; ++i)
+            {
+                function(static_cast<size_t>(_pIndices[i]), 1.0);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    template <typename ValueType, typename FunctionType>
+    void BinaryDataVector::ForEachStoredElement(FunctionType function) const
+    {
+        auto pValues = static_cast<const ValueType*>(_pValues);
+        if (_pIndices == nullptr)
+        {
+            for (size_t i = 0; i < _numStoredElements; ++i)
+            {
+                function(i, static_cast<double>(pValues[i]));
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < _numStoredElements; ++i)
+            {
+                function(static_cast<size_t>(_pIndices[i]), static_cast<double>(pValues[i]));
+            }
+        }
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
@@ -100,6 +100,14 @@ namespace data
         template <IterationPolicy policy, typename TransformationType>
         void AddTransformedTo(math::RowVectorReference<double> vector, TransformationType transformation) const;
 
+        /// <summary> Calls a function on each element of this data vector, without copying it. </summary>
+        ///
+        /// <typeparam name="policy"> The iteration policy. </typeparam>
+        /// <typeparam name="VisitorType"> The visitor type, which is a functor that takes an IndexValue. </typeparam>
+        /// <param name="visitor"> The visitor, which is called on the elements in order of their indices. </param>
+        template <IterationPolicy policy, typename VisitorType>
+        void VisitElements(VisitorType visitor) const;
+
         /// <summary> Copies the contents of this DataVector into a double array of size PrefixLength(). </summary>
         ///
         /// <returns> The array. </returns>
@@ -243,6 +251,14 @@ namespace data
         template <IterationPolicy policy, typename TransformationType>
         void AddTransformedTo(math::RowVectorReference<double> vector, TransformationType transformation) const;
 
+        /// <summary> Calls a function on each element of this data vector, without copying it. </summary>
+        ///
+        /// <typeparam name="policy"> The iteration policy. </typeparam>
+        /// <typeparam name="VisitorType"> The visitor type, which is a functor that takes an IndexValue. </typeparam>
+        /// <param name="visitor"> The visitor, which is called on the elements in order of their indices. </param>
+        template <IterationPolicy policy, typename VisitorType>
+        void VisitElements(VisitorType visitor) const;
+
         /// <summary> Returns a (dense) iterator of the vector elements, excluding the final suffix of zeros. </summary>
         ///
         /// <returns> A value iterator. </returns>
@@ -490,6 +506,14 @@ namespace data
         });
     }
 
+    template <IterationPolicy policy, typename VisitorType>
+    void IDataVector::VisitElements(VisitorType visitor) const
+    {
+        InvokeWithThis<void>([&visitor](const auto* pThis) {
+            pThis->template VisitElements<policy>(visitor);
+        });
+    }
+
     template <typename ReturnType>
     ReturnType IDataVector::CopyAs() const
     {
@@ -687,6 +711,18 @@ namespace data
         }
     }
 
+    template <class DerivedType>
+    template <IterationPolicy policy, typename VisitorType>
+    void DataVectorBase<DerivedType>::VisitElements(VisitorType visitor) const
+    {
+        auto indexValueIterator = GetIterator<DerivedType, policy>(*static_cast<const DerivedType*>(this));
+        while (indexValueIterator.IsValid())
+        {
+            visitor(indexValueIterator.Get());
+            indexValueIterator.Next();
+        }
+    }
+
     template <class DerivedType>
     template <typename ReturnType>
     ReturnType DataVectorBase<DerivedType>::CopyAs() const
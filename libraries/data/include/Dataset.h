@@ -13,6 +13,8 @@
 #include "Example.h"
 #include "ExampleIterator.h"
 
+#include <math/include/SparseMatrix.h>
+
 #include <utilities/include/AbstractInvoker.h>
 #include <utilities/include/TypeTraits.h>
 
@@ -29,6 +31,11 @@ namespace data
     template <typename ExampleType>
     class Dataset;
 
+    // forward declarations of the packed and streaming dataset types, which derive from the types in this file
+    class PackedDataset;
+    class StreamingDataset;
+    class StreamingDatasetReader;
+
     /// <summary> Polymorphic interface for datasets, enables dynamic_cast operations. </summary>
     struct DatasetBase
     {
@@ -59,6 +66,19 @@ namespace data
         /// <returns> Number of examples. </returns>
         size_t NumExamples() const { return _size; }
 
+        /// <summary> Returns true if the examples are read from disk by a StreamingDataset, one epoch at a time. </summary>
+        ///
+        /// <returns> true if the dataset is a StreamingDataset. </returns>
+        bool IsStreaming() const;
+
+        /// <summary>
+        /// Starts a new epoch of the StreamingDataset that this AnyDataset refers to, and returns a reader that
+        /// also gives the index of each example. Throws an exception if the dataset is not a StreamingDataset.
+        /// </summary>
+        ///
+        /// <returns> The reader. </returns>
+        StreamingDatasetReader GetStreamingReader() const;
+
     private:
         const DatasetBase* _pDataset;
         size_t _fromIndex;
@@ -191,14 +211,26 @@ namespace data
         /// <returns> The dataset. </returns>
         AnyDataset GetAnyDataset(size_t fromIndex = 0, size_t size = 0) const { return AnyDataset(this, fromIndex, size); }
 
+        /// <summary> Returns the weights of the examples, in example order, in one contiguous array. </summary>
+        ///
+        /// <returns> The weights. </returns>
+        const std::vector<double>& GetWeights() const;
+
+        /// <summary> Returns the labels of the examples, in example order, in one contiguous array. Class indices are converted to double. </summary>
+        ///
+        /// <returns> The labels. </returns>
+        const std::vector<double>& GetLabels() const;
+
         /// <summary> Returns a dataset whose examples have been converted from this dataset. </summary>
         ///
         /// <typeparam name="otherExampleType"> Example type returned by the transformation function. </typeparam>
         /// <param name="transformationFunction"> The function that is called on each example, returning the transformed example. </param>
+        /// <param name="numThreads"> The number of threads that convert ranges of the examples, or 0 to use all the hardware threads.
+        /// The transformation function must be safe to call concurrently unless this is 1. </param>
         ///
         /// <returns> The dataset. </returns>
         template <typename otherExampleType>
-        Dataset<otherExampleType> Transform(std::function<otherExampleType(const DatasetExampleType&)> transformationFunction);
+        Dataset<otherExampleType> Transform(std::function<otherExampleType(const DatasetExampleType&)> transformationFunction, size_t numThreads = 1);
 
         /// <summary> Adds an example at the bottom of the matrix. </summary>
         ///
@@ -260,9 +292,17 @@ namespace data
 
     private:
         size_t CorrectRangeSize(size_t fromIndex, size_t size) const;
+        void UpdateWeightLabelTable() const;
 
         std::vector<DatasetExampleType> _examples;
         size_t _numFeatures = 0;
+
+        // Structure-of-arrays copy of the weights and labels, so passes that only need them don't walk the examples.
+        // Anything that can change the examples marks it stale, and it is rebuilt on the next read. Reading it
+        // isn't safe concurrently with writes to the dataset.
+        mutable std::vector<double> _weights;
+        mutable std::vector<double> _labels;
+        mutable bool _isWeightLabelTableValid = false;
     };
 
     // friendly names
@@ -287,6 +327,20 @@ namespace data
     /// <returns> A Dataset. </returns>
     template <typename ExampleType>
     Dataset<ExampleType> MakeDataset(ExampleIterator<ExampleType> exampleIterator);
+
+    /// <summary>
+    /// Copies the data vectors of a dataset into a compressed sparse row matrix, with one row per example and
+    /// NumFeatures() columns. Only the nonzeros of each data vector are visited, so sparse datasets are converted
+    /// in time proportional to their number of nonzeros.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type of the matrix. </typeparam>
+    /// <typeparam name="DatasetExampleType"> The example type. </typeparam>
+    /// <param name="dataset"> The dataset. </param>
+    ///
+    /// <returns> The sparse matrix. </returns>
+    template <typename ElementType, typename DatasetExampleType>
+    math::CompressedRowMatrix<ElementType> GetCompressedRowMatrix(const Dataset<DatasetExampleType>& dataset);
 } // namespace data
 } // namespace ell
 
@@ -294,10 +348,13 @@ namespace data
 
 #include <utilities/include/Exception.h>
 #include <utilities/include/Logger.h>
+#include <utilities/include/ThreadPool.h>
 
 #include <algorithm>
+#include <future>
 #include <random>
 #include <stdexcept>
+#include <thread>
 
 namespace ell
 {
@@ -315,7 +372,9 @@ namespace data
         // all Dataset types for which GetAnyDataset() is called must be listed below, in the variadic template argument.
         using Invoker = utilities::AbstractInvoker<DatasetBase,
                                                    Dataset<data::AutoSupervisedExample>,
-                                                   Dataset<data::DenseSupervisedExample>>;
+                                                   Dataset<data::DenseSupervisedExample>,
+                                                   PackedDataset,
+                                                   StreamingDataset>;
 
         return Invoker::Invoke<ExampleIterator<ExampleType>>(getExampleIterator, _pDataset);
     }
@@ -349,11 +408,15 @@ namespace data
     {
         std::swap(_examples, other._examples);
         std::swap(_numFeatures, other._numFeatures);
+        std::swap(_weights, other._weights);
+        std::swap(_labels, other._labels);
+        std::swap(_isWeightLabelTableValid, other._isWeightLabelTableValid);
     }
 
     template <typename DatasetExampleType>
     DatasetExampleType& Dataset<DatasetExampleType>::GetExample(size_t index)
     {
+        _isWeightLabelTableValid = false;
         return _examples[index];
     }
 
@@ -366,6 +429,7 @@ namespace data
     template <typename DatasetExampleType>
     DatasetExampleType& Dataset<DatasetExampleType>::operator[](size_t index)
     {
+        _isWeightLabelTableValid = false;
         return _examples[index];
     }
 
@@ -395,6 +459,7 @@ namespace data
     {
         size_t numFeatures = example.GetDataVector().PrefixLength();
         _examples.push_back(std::move(example));
+        _isWeightLabelTableValid = false;
 
         if (_numFeatures < numFeatures)
         {
@@ -402,14 +467,84 @@ namespace data
         }
     }
 
+    namespace detail
+    {
+        inline double GetLabel(const WeightLabel& metadata) { return metadata.label; }
+        inline double GetLabel(const WeightClassIndex& metadata) { return static_cast<double>(metadata.classIndex); }
+    } // namespace detail
+
+    template <typename DatasetExampleType>
+    const std::vector<double>& Dataset<DatasetExampleType>::GetWeights() const
+    {
+        UpdateWeightLabelTable();
+        return _weights;
+    }
+
+    template <typename DatasetExampleType>
+    const std::vector<double>& Dataset<DatasetExampleType>::GetLabels() const
+    {
+        UpdateWeightLabelTable();
+        return _labels;
+    }
+
+    template <typename DatasetExampleType>
+    void Dataset<DatasetExampleType>::UpdateWeightLabelTable() const
+    {
+        if (_isWeightLabelTableValid)
+        {
+            return;
+        }
+
+        _weights.resize(_examples.size());
+        _labels.resize(_examples.size());
+        for (size_t index = 0; index < _examples.size(); ++index)
+        {
+            const auto& metadata = _examples[index].GetMetadata();
+            _weights[index] = metadata.weight;
+            _labels[index] = detail::GetLabel(metadata);
+        }
+        _isWeightLabelTableValid = true;
+    }
+
     template <typename DatasetExampleType>
     template <typename otherExampleType>
-    Dataset<otherExampleType> Dataset<DatasetExampleType>::Transform(std::function<otherExampleType(const DatasetExampleType&)> transformationFunction)
+    Dataset<otherExampleType> Dataset<DatasetExampleType>::Transform(std::function<otherExampleType(const DatasetExampleType&)> transformationFunction, size_t numThreads)
     {
+        const size_t minExamplesPerThread = 1 << 8;
+        auto numExamples = _examples.size();
+        numThreads = numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : numThreads;
+        auto numSlices = std::max<size_t>(std::min<size_t>(numThreads, numExamples / minExamplesPerThread), 1);
+
+        // each slice converts a contiguous range of examples, and the slices are added in order
+        std::vector<std::vector<otherExampleType>> slices(numSlices);
+        auto transformSlice = [&](size_t slice) {
+            auto begin = slice * numExamples / numSlices;
+            auto end = (slice + 1) * numExamples / numSlices;
+            slices[slice].reserve(end - begin);
+            for (size_t index = begin; index < end; ++index)
+            {
+                slices[slice].push_back(transformationFunction(_examples[index]));
+            }
+        };
+
+        std::vector<std::future<void>> tasks;
+        for (size_t slice = 1; slice < numSlices; ++slice)
+        {
+            tasks.push_back(utilities::GetHostThreadPool().AddTask(transformSlice, slice));
+        }
+        transformSlice(0);
+        for (auto& task : tasks)
+        {
+            utilities::GetHostThreadPool().GetResult(task);
+        }
+
         Dataset<otherExampleType> dataset;
-        for (auto& example : _examples)
+        for (auto& slice : slices)
         {
-            dataset.AddExample(transformationFunction(example));
+            for (auto& example : slice)
+            {
+                dataset.AddExample(std::move(example));
+            }
         }
         return dataset;
     }
@@ -419,6 +554,7 @@ namespace data
     {
         _examples.clear();
         _numFeatures = 0;
+        _isWeightLabelTableValid = false;
     }
 
     template <typename DatasetExampleType>
@@ -461,6 +597,7 @@ namespace data
         std::uniform_int_distribution<size_t> dist(rangeFirstIndex, rangeFirstIndex + rangeSize - 1);
         size_t j = dist(rng);
         swap(_examples[targetExampleIndex], _examples[j]);
+        _isWeightLabelTableValid = false;
     }
 
     template <typename DatasetExampleType>
@@ -474,6 +611,7 @@ namespace data
                   [&](const DatasetExampleType& a, const DatasetExampleType& b) -> bool {
                       return sortKey(a) < sortKey(b);
                   });
+        _isWeightLabelTableValid = false;
     }
 
     template <typename DatasetExampleType>
@@ -482,6 +620,7 @@ namespace data
     {
         size = CorrectRangeSize(fromIndex, size);
         std::partition(_examples.begin() + fromIndex, _examples.begin() + fromIndex + size, partitionKey);
+        _isWeightLabelTableValid = false;
     }
 
     template <typename DatasetExampleType>
@@ -519,7 +658,47 @@ namespace data
     {
         return Dataset<ExampleType>(std::move(exampleIterator));
     }
+
+    // the nonzeros of a data vector, constructed by IDataVector::CopyAs
+    template <typename ElementType>
+    struct SparseRowEntries
+    {
+        template <typename IndexValueIteratorType, IsIndexValueIterator<IndexValueIteratorType> Concept = true>
+        SparseRowEntries(IndexValueIteratorType indexValueIterator)
+        {
+            for (; indexValueIterator.IsValid(); indexValueIterator.Next())
+            {
+                auto indexValue = indexValueIterator.Get();
+                indices.push_back(indexValue.index);
+                values.push_back(static_cast<ElementType>(indexValue.value));
+            }
+        }
+
+        std::vector<size_t> indices;
+        std::vector<ElementType> values;
+    };
+
+    template <typename ElementType, typename DatasetExampleType>
+    math::CompressedRowMatrix<ElementType> GetCompressedRowMatrix(const Dataset<DatasetExampleType>& dataset)
+    {
+        std::vector<size_t> offsets(1, 0);
+        std::vector<size_t> indices;
+        std::vector<ElementType> values;
+        offsets.reserve(dataset.NumExamples() + 1);
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            auto entries = dataset[i].GetDataVector().template CopyAs<SparseRowEntries<ElementType>>();
+            indices.insert(indices.end(), entries.indices.begin(), entries.indices.end());
+            values.insert(values.end(), entries.values.begin(), entries.values.end());
+            offsets.push_back(indices.size());
+        }
+        return math::CompressedRowMatrix<ElementType>(dataset.NumExamples(), dataset.NumFeatures(), std::move(offsets), std::move(indices), std::move(values));
+    }
 } // namespace data
 } // namespace ell
 
+// PackedDataset and StreamingDataset are dataset types of AnyDataset, and they derive from DatasetBase
+#include "PackedDataset.h"
+#include "StreamingDataset.h"
+
 #pragma endregion implementation
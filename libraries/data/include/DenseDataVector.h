@@ -101,6 +101,25 @@ namespace data
         template <IterationPolicy policy>
         VectorIndexValueIterator<policy, ElementType> GetIterator() const;
 
+        /// <summary> Computes the dot product with another vector, directly on the stored elements. </summary>
+        ///
+        /// <param name="vector"> The other vector. </param>
+        ///
+        /// <returns> A dot product. </returns>
+        double Dot(math::UnorientedConstVectorBase<double> vector) const override;
+
+        /// <summary> Computes the dot product with another vector, directly on the stored elements. </summary>
+        ///
+        /// <param name="vector"> The other vector. </param>
+        ///
+        /// <returns> A dot product. </returns>
+        float Dot(math::UnorientedConstVectorBase<float> vector) const override;
+
+        /// <summary> Adds this data vector to a math::RowVector, directly from the stored elements. </summary>
+        ///
+        /// <param name="vector"> [in,out] The vector that this DataVector is added to. </param>
+        void AddTo(math::RowVectorReference<double> vector) const override;
+
         /// <summary> Appends an element to the end of the data vector. </summary>
         ///
         /// <param name="index"> Zero-based index of the element, must be bigger than the biggest current index. </param>
@@ -128,6 +147,10 @@ namespace data
 
     private:
         using DataVectorBase<DenseDataVector<ElementType>>::AppendElements;
+
+        template <typename VectorElementType>
+        VectorElementType DotImpl(math::UnorientedConstVectorBase<VectorElementType> vector) const;
+
         size_t _numNonzeros = 0;
         std::vector<ElementType> _data;
     };
@@ -152,6 +175,9 @@ namespace data
 #include <utilities/include/StringUtil.h>
 #include <utilities/include/TypeName.h>
 
+#include <math/include/NativeKernels.h>
+
+#include <algorithm>
 #include <cassert>
 
 namespace ell
@@ -226,6 +252,70 @@ namespace data
         return GetIterator<policy>(PrefixLength());
     }
 
+    template <typename ElementType>
+    double DenseDataVector<ElementType>::Dot(math::UnorientedConstVectorBase<double> vector) const
+    {
+        return DotImpl(vector);
+    }
+
+    template <typename ElementType>
+    float DenseDataVector<ElementType>::Dot(math::UnorientedConstVectorBase<float> vector) const
+    {
+        return DotImpl(vector);
+    }
+
+    template <typename ElementType>
+    template <typename VectorElementType>
+    VectorElementType DenseDataVector<ElementType>::DotImpl(math::UnorientedConstVectorBase<VectorElementType> vector) const
+    {
+        auto size = std::min(_data.size(), vector.Size());
+        const auto* pVector = vector.GetConstDataPointer();
+        auto increment = vector.GetIncrement();
+        if constexpr (std::is_same_v<ElementType, VectorElementType>)
+        {
+            if (increment == 1)
+            {
+                return math::NativeKernels::Dot(_data.data(), pVector, size);
+            }
+        }
+
+        // independent accumulators, so that the conversions and multiply-adds aren't serialized
+        VectorElementType sum0 = 0;
+        VectorElementType sum1 = 0;
+        size_t i = 0;
+        for (; i + 2 <= size; i += 2)
+        {
+            sum0 += static_cast<VectorElementType>(_data[i]) * pVector[i * increment];
+            sum1 += static_cast<VectorElementType>(_data[i + 1]) * pVector[(i + 1) * increment];
+        }
+        if (i < size)
+        {
+            sum0 += static_cast<VectorElementType>(_data[i]) * pVector[i * increment];
+        }
+        return sum0 + sum1;
+    }
+
+    template <typename ElementType>
+    void DenseDataVector<ElementType>::AddTo(math::RowVectorReference<double> vector) const
+    {
+        auto size = std::min(_data.size(), vector.Size());
+        auto* pVector = vector.GetDataPointer();
+        auto increment = vector.GetIncrement();
+        if constexpr (std::is_same_v<ElementType, double>)
+        {
+            if (increment == 1)
+            {
+                math::NativeKernels::Axpy(1.0, _data.data(), pVector, size);
+                return;
+            }
+        }
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            pVector[i * increment] += static_cast<double>(_data[i]);
+        }
+    }
+
     template <typename ElementType>
     void DenseDataVector<ElementType>::AppendElement(size_t index, double value)
     {
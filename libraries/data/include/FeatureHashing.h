@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FeatureHashing.h (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AutoDataVector.h"
+#include "IndexValue.h"
+#include "TextLine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary> Parameters of the feature hashing transform. </summary>
+    struct FeatureHashingParameters
+    {
+        /// <summary> The indices are hashed into 2^numHashBits buckets, and 0 leaves the indices as they are. </summary>
+        size_t numHashBits = 0;
+
+        /// <summary> Whether a second hash of the index decides the sign of the value, so that collisions cancel out on average. </summary>
+        bool useSignHash = false;
+    };
+
+    /// <summary> Computes the hash of a feature index. </summary>
+    ///
+    /// <param name="index"> The feature index. </param>
+    ///
+    /// <returns> The hash of the index. </returns>
+    uint64_t GetFeatureIndexHash(size_t index);
+
+    /// <summary>
+    /// Maps the entries of an index-value iterator to a space of 2^numHashBits indices. Entries that are mapped to
+    /// the same index are added up, and the result is sorted by index.
+    /// </summary>
+    ///
+    /// <typeparam name="IndexValueIteratorType"> The index-value iterator type. </typeparam>
+    /// <param name="indexValueIterator"> The index-value iterator. </param>
+    /// <param name="parameters"> The feature hashing parameters, where numHashBits is positive and smaller than the number of bits in a size_t. </param>
+    ///
+    /// <returns> The hashed entries. </returns>
+    template <typename IndexValueIteratorType, IsIndexValueIterator<IndexValueIteratorType> Concept = true>
+    std::vector<IndexValue> HashIndexValues(IndexValueIteratorType indexValueIterator, const FeatureHashingParameters& parameters);
+
+    /// <summary> Returns a copy of a data vector with hashed indices. </summary>
+    ///
+    /// <typeparam name="DataVectorType"> The data vector type. </typeparam>
+    /// <param name="dataVector"> The data vector. </param>
+    /// <param name="parameters"> The feature hashing parameters, where numHashBits is positive and smaller than the number of bits in a size_t. </param>
+    ///
+    /// <returns> The hashed data vector. </returns>
+    template <typename DataVectorType>
+    AutoDataVector HashDataVector(const DataVectorType& dataVector, const FeatureHashingParameters& parameters);
+
+    /// <summary>
+    /// A helper class that constructs AutoDataVectors with hashed indices using a provided IndexValue iterator,
+    /// so that the dimension of the parsed data is bounded no matter how large the indices in the text are.
+    /// </summary>
+    ///
+    /// <typeparam name="IndexValueParsingIterator"> Parsing iterator type. </typeparam>
+    template <typename IndexValueParsingIterator>
+    struct FeatureHashingDataVectorParser
+    {
+        // The return type of the parser so the example iterator knows how to declare an Example<DataParser::type, MetadataParser::type>
+        using type = AutoDataVector;
+
+        /// <summary> Parses a given text line and constructs an AutoDataVector with hashed indices. </summary>
+        ///
+        /// <param name="textLine"> The text line. </param>
+        ///
+        /// <returns> An AutoDataVector. </returns>
+        AutoDataVector Parse(TextLine& textLine) const;
+
+        /// <summary> The feature hashing parameters. </summary>
+        FeatureHashingParameters parameters;
+    };
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+#include "SparseDataVector.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace data
+{
+    template <typename IndexValueIteratorType, IsIndexValueIterator<IndexValueIteratorType> Concept>
+    std::vector<IndexValue> HashIndexValues(IndexValueIteratorType indexValueIterator, const FeatureHashingParameters& parameters)
+    {
+        if (parameters.numHashBits == 0 || parameters.numHashBits >= 8 * sizeof(size_t))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The number of feature hashing bits must be positive and smaller than the number of bits in an index");
+        }
+
+        // the bucket comes from the low bits of the hash, and the sign from the top bit
+        const uint64_t mask = (uint64_t{ 1 } << parameters.numHashBits) - 1;
+        std::vector<IndexValue> entries;
+        while (indexValueIterator.IsValid())
+        {
+            auto entry = indexValueIterator.Get();
+            auto hash = GetFeatureIndexHash(entry.index);
+            auto value = parameters.useSignHash && (hash >> 63) != 0 ? -entry.value : entry.value;
+            entries.push_back({ static_cast<size_t>(hash & mask), value });
+            indexValueIterator.Next();
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const IndexValue& a, const IndexValue& b) { return a.index < b.index; });
+
+        // add up the values of colliding indices
+        std::vector<IndexValue> result;
+        result.reserve(entries.size());
+        for (const auto& entry : entries)
+        {
+            if (!result.empty() && result.back().index == entry.index)
+            {
+                result.back().value += entry.value;
+            }
+            else
+            {
+                result.push_back(entry);
+            }
+        }
+        return result;
+    }
+
+    template <typename DataVectorType>
+    AutoDataVector HashDataVector(const DataVectorType& dataVector, const FeatureHashingParameters& parameters)
+    {
+        auto sparseDataVector = dataVector.template CopyAs<SparseDoubleDataVector>();
+        return AutoDataVector(HashIndexValues(sparseDataVector.template GetIterator<IterationPolicy::skipZeros>(), parameters));
+    }
+
+    template <typename IndexValueParsingIterator>
+    AutoDataVector FeatureHashingDataVectorParser<IndexValueParsingIterator>::Parse(TextLine& textLine) const
+    {
+        return AutoDataVector(HashIndexValues(IndexValueParsingIterator(textLine), parameters));
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
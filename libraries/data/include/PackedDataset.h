@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PackedDataset.h (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "DataVector.h"
+#include "Dataset.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+#include "IndexValue.h"
+#include "WeightLabel.h"
+
+#include <math/include/Vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary> An index value iterator over the nonzero elements of a PackedDataVector. </summary>
+    class PackedDataVectorIterator : public IIndexValueIterator
+    {
+    public:
+        /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+        ///
+        /// <returns> true if valid, false if not. </returns>
+        bool IsValid() const { return _index < _numStoredElements; }
+
+        /// <summary> Proceeds to the next iterate. </summary>
+        void Next();
+
+        /// <summary> Returns the current index-value pair. </summary>
+        ///
+        /// <returns> An IndexValue. </returns>
+        IndexValue Get() const { return { _pIndices == nullptr ? _index : _pIndices[_index], _pValues[_index] }; }
+
+    private:
+        friend class PackedDataVector;
+        PackedDataVectorIterator(const uint32_t* pIndices, const double* pValues, size_t numStoredElements);
+        void SkipZeros();
+
+        const uint32_t* _pIndices;
+        const double* _pValues;
+        size_t _numStoredElements;
+        size_t _index = 0;
+    };
+
+    /// <summary>
+    /// A read-only view of a data vector that is stored in a PackedDataset. A dense vector is a range of the values
+    /// arena, and a sparse vector is a range of the indices arena and the matching range of the values arena.
+    /// </summary>
+    class PackedDataVector
+    {
+    public:
+        /// <summary> Returns true if the data vector stores its nonzeros and their indices. </summary>
+        ///
+        /// <returns> true if the vector is sparse. </returns>
+        bool IsSparse() const { return _pIndices != nullptr; }
+
+        /// <summary> Gets the first index of the suffix of zeros at the end of this vector. </summary>
+        ///
+        /// <returns> The prefix length. </returns>
+        size_t PrefixLength() const { return _prefixLength; }
+
+        /// <summary> Computes the squared 2-norm of the vector. </summary>
+        ///
+        /// <returns> The squared 2-norm of the vector. </returns>
+        double Norm2Squared() const;
+
+        /// <summary> Computes the dot product with another vector. </summary>
+        ///
+        /// <param name="vector"> The other vector. </param>
+        ///
+        /// <returns> A dot product. </returns>
+        double Dot(math::UnorientedConstVectorBase<double> vector) const;
+
+        /// <summary> Adds this data vector to a math::RowVector. </summary>
+        ///
+        /// <param name="vector"> [in,out] The vector that this data vector is added to. </param>
+        void AddTo(math::RowVectorReference<double> vector) const;
+
+        /// <summary> Gets an iterator over the nonzero elements of the vector. </summary>
+        ///
+        /// <returns> The iterator. </returns>
+        PackedDataVectorIterator GetIterator() const { return PackedDataVectorIterator(_pIndices, _pValues, _numStoredElements); }
+
+        /// <summary> Copies this data vector into a data vector of a given type, such as an AutoDataVector. </summary>
+        ///
+        /// <typeparam name="ReturnType"> The return type. </typeparam>
+        ///
+        /// <returns> The new data vector. </returns>
+        template <typename ReturnType>
+        ReturnType CopyAs() const
+        {
+            return ReturnType(GetIterator());
+        }
+
+        /// <summary> Copies the contents of this data vector into a std::vector of the size of its prefix. </summary>
+        ///
+        /// <returns> The std::vector. </returns>
+        std::vector<double> ToArray() const;
+
+    private:
+        friend class PackedDataset;
+        PackedDataVector(const uint32_t* pIndices, const double* pValues, size_t numStoredElements, size_t prefixLength);
+
+        const uint32_t* _pIndices;
+        const double* _pValues;
+        size_t _numStoredElements;
+        size_t _prefixLength;
+    };
+
+    /// <summary> A read-only view of an example that is stored in a PackedDataset. </summary>
+    class PackedExample
+    {
+    public:
+        using DataVectorType = PackedDataVector;
+        using MetadataType = WeightLabel;
+
+        /// <summary> Gets the data vector. </summary>
+        ///
+        /// <returns> The data vector. </returns>
+        const PackedDataVector& GetDataVector() const { return _dataVector; }
+
+        /// <summary> Gets the metadata. </summary>
+        ///
+        /// <returns> The metadata. </returns>
+        const WeightLabel& GetMetadata() const { return _metadata; }
+
+        /// <summary> Copies this example into an example of a given type, such as an AutoSupervisedExample. </summary>
+        ///
+        /// <typeparam name="TargetExampleType"> The target example type. </typeparam>
+        ///
+        /// <returns> The new example. </returns>
+        template <typename TargetExampleType>
+        TargetExampleType CopyAs() const
+        {
+            return TargetExampleType(_dataVector.CopyAs<typename TargetExampleType::DataVectorType>(), typename TargetExampleType::MetadataType(_metadata));
+        }
+
+    private:
+        friend class PackedDataset;
+        PackedExample(PackedDataVector dataVector, WeightLabel metadata) :
+            _dataVector(dataVector),
+            _metadata(metadata) {}
+
+        PackedDataVector _dataVector;
+        WeightLabel _metadata;
+    };
+
+    /// <summary>
+    /// A supervised dataset that packs all of its data vectors into contiguous arenas, instead of holding a
+    /// separately allocated data vector for each example. The data vectors are stored in one values arena and, in
+    /// CSR form for the sparse vectors, one indices arena, in the order of the examples. Examples are lightweight
+    /// views of the arenas, so iterating over the dataset reads memory sequentially and does no heap allocation.
+    /// </summary>
+    class PackedDataset : public DatasetBase
+    {
+    public:
+        /// <summary> Iterator class. </summary>
+        template <typename IteratorExampleType>
+        class PackedExampleIterator : public IExampleIterator<IteratorExampleType>
+        {
+        public:
+            /// <summary> Constructs a PackedExampleIterator. </summary>
+            ///
+            /// <param name="dataset"> The dataset. </param>
+            /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+            /// <param name="endIndex"> One past the index of the last example to iterate over. </param>
+            PackedExampleIterator(const PackedDataset& dataset, size_t fromIndex, size_t endIndex) :
+                _dataset(dataset),
+                _index(fromIndex),
+                _endIndex(endIndex) {}
+
+            /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+            ///
+            /// <returns> true if the iterator is currently pointing to a valid iterate. </returns>
+            bool IsValid() const override { return _index < _endIndex; }
+
+            /// <summary> Proceeds to the Next iterate. </summary>
+            void Next() override { ++_index; }
+
+            /// <summary> Gets the current example pointer to by the iterator. </summary>
+            ///
+            /// <returns> The example. </returns>
+            IteratorExampleType Get() const override { return _dataset.GetExample(_index).template CopyAs<IteratorExampleType>(); }
+
+        private:
+            const PackedDataset& _dataset;
+            size_t _index;
+            size_t _endIndex;
+        };
+
+        PackedDataset() = default;
+
+        /// <summary> Constructs a PackedDataset by packing the examples of a dataset. </summary>
+        ///
+        /// <typeparam name="ExampleType"> The example type of the dataset, whose metadata is a WeightLabel. </typeparam>
+        /// <param name="dataset"> The dataset. </param>
+        template <typename ExampleType>
+        explicit PackedDataset(const Dataset<ExampleType>& dataset);
+
+        /// <summary> Constructs a PackedDataset by packing the examples of an example iterator. </summary>
+        ///
+        /// <typeparam name="ExampleType"> The example type of the iterator, whose metadata is a WeightLabel. </typeparam>
+        /// <param name="exampleIterator"> The example iterator. </param>
+        template <typename ExampleType>
+        explicit PackedDataset(ExampleIterator<ExampleType> exampleIterator);
+
+        /// <summary>
+        /// Appends a copy of an example to the arenas. A data vector is stored as a sparse vector if
+        /// that takes less memory than storing its prefix.
+        /// </summary>
+        ///
+        /// <typeparam name="ExampleType"> The example type, whose metadata is a WeightLabel. </typeparam>
+        /// <param name="example"> The example. </param>
+        template <typename ExampleType>
+        void AddExample(const ExampleType& example);
+
+        /// <summary> Returns the number of examples in the dataset. </summary>
+        ///
+        /// <returns> Number of examples. </returns>
+        size_t NumExamples() const { return _metadata.size(); }
+
+        /// <summary> Returns the maximal size of any example. </summary>
+        ///
+        /// <returns> Maximal size of any example. </returns>
+        size_t NumFeatures() const { return _numFeatures; }
+
+        /// <summary> Returns a view of an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        PackedExample GetExample(size_t index) const;
+
+        /// <summary> Returns a view of an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        PackedExample operator[](size_t index) const { return GetExample(index); }
+
+        /// <summary> Returns an iterator that copies the examples into a given example type. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+        /// <param name="size"> The number of examples to iterate over, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        template <typename IteratorExampleType = AutoSupervisedExample>
+        ExampleIterator<IteratorExampleType> GetExampleIterator(size_t fromIndex = 0, size_t size = 0) const;
+
+        /// <summary> Returns an AnyDataset that represents an interval of examples from this dataset. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example in the AnyDataset. </param>
+        /// <param name="size"> The number of examples to include, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The dataset. </returns>
+        AnyDataset GetAnyDataset(size_t fromIndex = 0, size_t size = 0) const { return AnyDataset(this, fromIndex, CorrectRangeSize(fromIndex, size)); }
+
+        /// <summary> Copies the examples into a Dataset. </summary>
+        ///
+        /// <returns> The dataset. </returns>
+        AutoSupervisedDataset ToDataset() const;
+
+    private:
+        void AddDenseDataVector(std::vector<double> values, WeightLabel metadata);
+        void AddSparseDataVector(const SparseRowEntries<double>& entries, size_t prefixLength, WeightLabel metadata);
+        size_t CorrectRangeSize(size_t fromIndex, size_t size) const;
+
+        // example i owns [_indexOffsets[i], _indexOffsets[i+1]) of _indices (empty for a dense vector) and
+        // [_valueOffsets[i], _valueOffsets[i+1]) of _values
+        std::vector<size_t> _indexOffsets = { 0 };
+        std::vector<size_t> _valueOffsets = { 0 };
+        std::vector<uint32_t> _indices;
+        std::vector<double> _values;
+        std::vector<size_t> _prefixLengths;
+        std::vector<WeightLabel> _metadata;
+        size_t _numFeatures = 0;
+    };
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace data
+{
+    template <typename ExampleType>
+    PackedDataset::PackedDataset(const Dataset<ExampleType>& dataset)
+    {
+        _metadata.reserve(dataset.NumExamples());
+        _prefixLengths.reserve(dataset.NumExamples());
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            AddExample(dataset[i]);
+        }
+    }
+
+    template <typename ExampleType>
+    PackedDataset::PackedDataset(ExampleIterator<ExampleType> exampleIterator)
+    {
+        while (exampleIterator.IsValid())
+        {
+            AddExample(exampleIterator.Get());
+            exampleIterator.Next();
+        }
+    }
+
+    template <typename ExampleType>
+    void PackedDataset::AddExample(const ExampleType& example)
+    {
+        const auto& dataVector = example.GetDataVector();
+        auto entries = dataVector.template CopyAs<SparseRowEntries<double>>();
+        auto prefixLength = dataVector.PrefixLength();
+
+        // a sparse element takes one index and one value, a dense element takes one value
+        if ((sizeof(uint32_t) + sizeof(double)) * entries.values.size() < sizeof(double) * prefixLength)
+        {
+            AddSparseDataVector(entries, prefixLength, example.GetMetadata());
+        }
+        else
+        {
+            AddDenseDataVector(dataVector.ToArray(), example.GetMetadata());
+        }
+    }
+
+    template <typename IteratorExampleType>
+    ExampleIterator<IteratorExampleType> PackedDataset::GetExampleIterator(size_t fromIndex, size_t size) const
+    {
+        size = CorrectRangeSize(fromIndex, size);
+        return ExampleIterator<IteratorExampleType>(std::make_unique<PackedExampleIterator<IteratorExampleType>>(*this, fromIndex, fromIndex + size));
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
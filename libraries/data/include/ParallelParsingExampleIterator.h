@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelParsingExampleIterator.h (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Example.h"
+#include "ExampleIterator.h"
+#include "TextLine.h"
+
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// An Example iterator that parses a text stream with several threads. The stream is read in chunks that end at
+    /// a line break, and the chunks are parsed in parallel while the examples of earlier chunks are consumed. Each
+    /// line is parsed like SingleLineParsingExampleIterator parses it, and the examples come out in the order of the
+    /// lines.
+    /// </summary>
+    ///
+    /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+    /// <typeparam name="DataVectorParserType"> DataVector parser type. </typeparam>
+    template <typename MetadataParserType, typename DataVectorParserType>
+    class ParallelParsingExampleIterator : public IExampleIterator<ParserExample<DataVectorParserType, MetadataParserType>>
+    {
+    public:
+        using ExampleType = ParserExample<DataVectorParserType, MetadataParserType>;
+
+        /// <summary> The default size of a chunk, in bytes. </summary>
+        static constexpr size_t defaultChunkSize = 1 << 22;
+
+        /// <summary> Constructs a ParallelParsingExampleIterator. </summary>
+        ///
+        /// <param name="stream"> The input stream, which must outlive the iterator. </param>
+        /// <param name="metadataParser"> The metadata parser. </param>
+        /// <param name="dataVectorParser"> The data vector parser. </param>
+        /// <param name="numThreads"> The number of chunks that are parsed at the same time, or 0 to use all the hardware threads. </param>
+        /// <param name="chunkSize"> The approximate size of a chunk, in bytes. </param>
+        ParallelParsingExampleIterator(std::istream& stream, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t numThreads = 0, size_t chunkSize = defaultChunkSize);
+
+        /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+        ///
+        /// <returns> true if the iterator is valid, false otherwise. </returns>
+        bool IsValid() const override { return _exampleIndex < _currentExamples.size(); }
+
+        /// <summary> Proceeds to the next example. </summary>
+        void Next() override;
+
+        /// <summary> Gets the current example. </summary>
+        ///
+        /// <returns> A SupervisedExample. </returns>
+        ExampleType Get() const override { return _currentExamples[_exampleIndex]; }
+
+    private:
+        bool ReadChunk(std::string& chunk);
+        void StartParsingChunks();
+        void NextChunk();
+        static std::vector<ExampleType> ParseChunk(const std::string& chunk, MetadataParserType metadataParser, DataVectorParserType dataVectorParser);
+
+        std::istream& _stream;
+        MetadataParserType _metadataParser;
+        DataVectorParserType _dataVectorParser;
+        size_t _numThreads;
+        size_t _chunkSize;
+
+        std::string _remainder; // the start of a line that was cut off by the end of the last chunk
+        std::deque<std::future<std::vector<ExampleType>>> _parsingChunks;
+        std::vector<ExampleType> _currentExamples;
+        size_t _exampleIndex = 0;
+    };
+
+    /// <summary>
+    /// Helper function that creates a ParallelParsingExampleIterator from a stream, a metadata parser, and a
+    /// datavector parser.
+    /// </summary>
+    ///
+    /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+    /// <typeparam name="DataVectorParserType"> Data vector parser type. </typeparam>
+    /// <param name="stream"> The input stream, which must outlive the iterator. </param>
+    /// <param name="metadataParser"> The metadata parser. </param>
+    /// <param name="dataVectorParser"> The data vector parser. </param>
+    /// <param name="numThreads"> The number of chunks that are parsed at the same time, or 0 to use all the hardware threads. </param>
+    ///
+    /// <returns> The parallel parsing example iterator. </returns>
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto MakeParallelParsingExampleIterator(std::istream& stream, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t numThreads = 0);
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace ell
+{
+namespace data
+{
+    template <typename MetadataParserType, typename DataVectorParserType>
+    ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::ParallelParsingExampleIterator(std::istream& stream, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t numThreads, size_t chunkSize) :
+        _stream(stream),
+        _metadataParser(std::move(metadataParser)),
+        _dataVectorParser(std::move(dataVectorParser)),
+        _numThreads(numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : numThreads),
+        _chunkSize(std::max<size_t>(chunkSize, 1))
+    {
+        NextChunk();
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    void ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::Next()
+    {
+        ++_exampleIndex;
+        if (_exampleIndex == _currentExamples.size())
+        {
+            NextChunk();
+        }
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    bool ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::ReadChunk(std::string& chunk)
+    {
+        chunk = std::move(_remainder);
+        _remainder.clear();
+
+        auto size = chunk.size();
+        chunk.resize(size + _chunkSize);
+        _stream.read(&chunk[size], static_cast<std::streamsize>(_chunkSize));
+        chunk.resize(size + static_cast<size_t>(_stream.gcount()));
+
+        // keep the last partial line for the next chunk
+        if (_stream)
+        {
+            auto lineEnd = chunk.rfind('\n');
+            if (lineEnd != std::string::npos)
+            {
+                _remainder.assign(chunk, lineEnd + 1, std::string::npos);
+                chunk.resize(lineEnd + 1);
+            }
+            else
+            {
+                _remainder = std::move(chunk);
+                chunk.clear();
+            }
+            return true;
+        }
+
+        return !chunk.empty();
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    void ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::StartParsingChunks()
+    {
+        std::string chunk;
+        while (_parsingChunks.size() < _numThreads && ReadChunk(chunk))
+        {
+            if (chunk.empty())
+            {
+                continue;
+            }
+            _parsingChunks.push_back(utilities::GetHostThreadPool().AddTask(&ParseChunk, std::move(chunk), _metadataParser, _dataVectorParser));
+        }
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    void ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::NextChunk()
+    {
+        // chunks of comments and empty lines have no examples
+        _currentExamples.clear();
+        _exampleIndex = 0;
+        StartParsingChunks();
+        while (_currentExamples.empty() && !_parsingChunks.empty())
+        {
+            _currentExamples = utilities::GetHostThreadPool().GetResult(_parsingChunks.front());
+            _parsingChunks.pop_front();
+            StartParsingChunks();
+        }
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::ParseChunk(const std::string& chunk, MetadataParserType metadataParser, DataVectorParserType dataVectorParser) -> std::vector<ExampleType>
+    {
+        std::vector<ExampleType> examples;
+        size_t lineBegin = 0;
+        while (lineBegin < chunk.size())
+        {
+            auto lineEnd = std::min(chunk.find('\n', lineBegin), chunk.size());
+            TextLine line(chunk.substr(lineBegin, lineEnd - lineBegin));
+            lineBegin = lineEnd + 1;
+
+            // skip lines that contain just whitespace or just a comment
+            line.TrimLeadingWhitespace();
+            if (line.IsEndOfContent())
+            {
+                continue;
+            }
+
+            auto metaData = metadataParser.Parse(line);
+            auto dataVector = dataVectorParser.Parse(line);
+            examples.emplace_back(std::move(dataVector), std::move(metaData));
+        }
+        return examples;
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto MakeParallelParsingExampleIterator(std::istream& stream, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t numThreads)
+    {
+        using ExampleType = ParserExample<DataVectorParserType, MetadataParserType>;
+        using IteratorType = ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>;
+        auto iterator = std::make_unique<IteratorType>(stream, std::move(metadataParser), std::move(dataVectorParser), numThreads);
+        return ExampleIterator<ExampleType>(std::move(iterator));
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
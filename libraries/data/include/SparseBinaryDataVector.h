@@ -202,6 +202,10 @@ namespace data
 
     private:
         using DataVectorBase<SparseBinaryDataVectorBase<IndexListType>>::AppendElements;
+
+        // the number of indices that are decoded at once by Dot and AddTo
+        static constexpr size_t indexBlockSize = 64;
+
         IndexListType _indexList;
     };
 
@@ -336,12 +340,23 @@ namespace data
     double SparseBinaryDataVectorBase<IndexListType>::Dot(math::UnorientedConstVectorBase<double> vector) const
     {
         double value = 0.0;
+        auto size = vector.Size();
+        const auto* pVector = vector.GetConstDataPointer();
+        auto increment = vector.GetIncrement();
 
+        size_t indices[indexBlockSize];
         auto iter = _indexList.GetIterator();
-        while (iter.IsValid())
+        while (auto count = iter.Read(indices, indexBlockSize))
         {
-            value += vector[iter.Get()];
-            iter.Next();
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (indices[i] >= size)
+                {
+                    return value;
+                }
+
+                value += pVector[indices[i] * increment];
+            }
         }
 
         return value;
@@ -350,19 +365,23 @@ namespace data
     template <typename IndexListType>
     void SparseBinaryDataVectorBase<IndexListType>::AddTo(math::RowVectorReference<double> vector) const
     {
-        auto iter = _indexList.GetIterator();
         auto size = vector.Size();
+        auto* pVector = vector.GetDataPointer();
+        auto increment = vector.GetIncrement();
 
-        while (iter.IsValid())
+        size_t indices[indexBlockSize];
+        auto iter = _indexList.GetIterator();
+        while (auto count = iter.Read(indices, indexBlockSize))
         {
-            auto index = iter.Get();
-            if (index >= size)
+            for (size_t i = 0; i < count; ++i)
             {
-                return;
-            }
+                if (indices[i] >= size)
+                {
+                    return;
+                }
 
-            vector[index] += 1.0;
-            iter.Next();
+                pVector[indices[i] * increment] += 1.0;
+            }
         }
     }
 } // namespace data
@@ -175,6 +175,25 @@ namespace data
             return GetIterator<policy>(PrefixLength());
         }
 
+        /// <summary> Computes the dot product with another vector, directly on the stored elements. </summary>
+        ///
+        /// <param name="vector"> The other vector. </param>
+        ///
+        /// <returns> A dot product. </returns>
+        double Dot(math::UnorientedConstVectorBase<double> vector) const override;
+
+        /// <summary> Computes the dot product with another vector, directly on the stored elements. </summary>
+        ///
+        /// <param name="vector"> The other vector. </param>
+        ///
+        /// <returns> A dot product. </returns>
+        float Dot(math::UnorientedConstVectorBase<float> vector) const override;
+
+        /// <summary> Adds this data vector to a math::RowVector, directly from the stored elements. </summary>
+        ///
+        /// <param name="vector"> [in,out] The vector that this DataVector is added to. </param>
+        void AddTo(math::RowVectorReference<double> vector) const override;
+
         /// <summary> Appends an element to the end of the data vector. </summary>
         ///
         /// <param name="index"> Zero-based index of the element, must be bigger than the biggest current index. </param>
@@ -202,6 +221,13 @@ namespace data
 
     private:
         using DataVectorBase<SparseDataVector<ElementType, IndexListType>>::AppendElements;
+
+        template <typename VectorElementType>
+        VectorElementType DotImpl(math::UnorientedConstVectorBase<VectorElementType> vector) const;
+
+        // the number of indices that are decoded at once by Dot and AddTo
+        static constexpr size_t indexBlockSize = 64;
+
         IndexListType _indexList;
         std::vector<ElementType> _values;
     };
@@ -334,6 +360,71 @@ namespace data
         AppendElements(std::move(vec));
     }
 
+    template <typename ElementType, typename IndexListType>
+    double SparseDataVector<ElementType, IndexListType>::Dot(math::UnorientedConstVectorBase<double> vector) const
+    {
+        return DotImpl(vector);
+    }
+
+    template <typename ElementType, typename IndexListType>
+    float SparseDataVector<ElementType, IndexListType>::Dot(math::UnorientedConstVectorBase<float> vector) const
+    {
+        return DotImpl(vector);
+    }
+
+    template <typename ElementType, typename IndexListType>
+    template <typename VectorElementType>
+    VectorElementType SparseDataVector<ElementType, IndexListType>::DotImpl(math::UnorientedConstVectorBase<VectorElementType> vector) const
+    {
+        // the indices are decoded in blocks, and they are increasing, so the elements past the end of the other
+        // vector can be skipped all at once
+        auto size = vector.Size();
+        const auto* pVector = vector.GetConstDataPointer();
+        auto increment = vector.GetIncrement();
+        const auto* pValues = _values.data();
+
+        VectorElementType result = 0;
+        size_t indices[indexBlockSize];
+        auto indexIterator = _indexList.GetIterator();
+        while (auto count = indexIterator.Read(indices, indexBlockSize))
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (indices[i] >= size)
+                {
+                    return result;
+                }
+                result += static_cast<VectorElementType>(pValues[i]) * pVector[indices[i] * increment];
+            }
+            pValues += count;
+        }
+        return result;
+    }
+
+    template <typename ElementType, typename IndexListType>
+    void SparseDataVector<ElementType, IndexListType>::AddTo(math::RowVectorReference<double> vector) const
+    {
+        auto size = vector.Size();
+        auto* pVector = vector.GetDataPointer();
+        auto increment = vector.GetIncrement();
+        const auto* pValues = _values.data();
+
+        size_t indices[indexBlockSize];
+        auto indexIterator = _indexList.GetIterator();
+        while (auto count = indexIterator.Read(indices, indexBlockSize))
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (indices[i] >= size)
+                {
+                    return;
+                }
+                pVector[indices[i] * increment] += static_cast<double>(pValues[i]);
+            }
+            pValues += count;
+        }
+    }
+
     template <typename ElementType, typename IndexListType>
     void SparseDataVector<ElementType, IndexListType>::AppendElement(size_t index, double value)
     {
@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StreamingDataset.h (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary> Parameters for a streaming dataset. </summary>
+    struct StreamingDatasetParameters
+    {
+        /// <summary> The number of examples held by the shuffle buffer, where 1 keeps the order of the source. </summary>
+        size_t shuffleBufferSize = 1 << 16;
+
+        /// <summary> The number of examples that are read ahead from the source at once. </summary>
+        size_t prefetchBlockSize = 1 << 12;
+
+        /// <summary> The random seed of the shuffle, which is combined with the epoch number. </summary>
+        std::string randomSeedString;
+    };
+
+    /// <summary>
+    /// Reads one epoch of a streaming dataset, and keeps track of the index of each example. A reader must not
+    /// outlive its dataset.
+    /// </summary>
+    class StreamingDatasetReader
+    {
+    public:
+        /// <summary> Constructs a StreamingDatasetReader. </summary>
+        ///
+        /// <param name="source"> The iterator of the source. </param>
+        /// <param name="fromIndex"> Zero-based index of the first example of the source to read. </param>
+        /// <param name="size"> The number of examples to read, or 0 to read to the end of the source. </param>
+        /// <param name="random"> The random engine of the shuffle. </param>
+        /// <param name="parameters"> The streaming dataset parameters. </param>
+        StreamingDatasetReader(AutoSupervisedExampleIterator source, size_t fromIndex, size_t size, std::default_random_engine random, const StreamingDatasetParameters& parameters);
+
+        StreamingDatasetReader(StreamingDatasetReader&&) = default;
+
+        /// <summary> Destructor. Waits for the block that is being read ahead. </summary>
+        ~StreamingDatasetReader();
+
+        /// <summary> Returns true if the reader is currently pointing to a valid example. </summary>
+        ///
+        /// <returns> true if the reader is valid, false otherwise. </returns>
+        bool IsValid() const { return _isValid; }
+
+        /// <summary> Proceeds to the next example. </summary>
+        void Next();
+
+        /// <summary> Gets the current example. </summary>
+        ///
+        /// <returns> A const reference to the current example. </returns>
+        const AutoSupervisedExample& Get() const { return _current.example; }
+
+        /// <summary>
+        /// Gets the index of the current example among the examples that the reader reads, in the order of the
+        /// source.
+        /// </summary>
+        ///
+        /// <returns> The zero-based index of the current example. </returns>
+        size_t GetIndex() const { return _current.index; }
+
+    private:
+        struct IndexedExample
+        {
+            size_t index = 0;
+            AutoSupervisedExample example;
+        };
+
+        struct BlockSource
+        {
+            AutoSupervisedExampleIterator iterator;
+            size_t nextIndex;
+            size_t endIndex;
+        };
+
+        static std::vector<IndexedExample> ReadBlock(BlockSource& source, size_t blockSize);
+        void StartReadingBlock();
+        bool TakeIncoming(IndexedExample& example);
+
+        size_t _blockSize;
+        std::default_random_engine _random;
+
+        // the source is destroyed after the block that is being read from it
+        std::unique_ptr<BlockSource> _source;
+        std::future<std::vector<IndexedExample>> _nextBlock;
+        std::vector<IndexedExample> _incoming;
+        size_t _incomingIndex = 0;
+
+        std::vector<IndexedExample> _buffer;
+        IndexedExample _current;
+        bool _isValid = false;
+    };
+
+    /// <summary>
+    /// A dataset that keeps its examples on disk, and reads them again for each epoch. The examples of an epoch
+    /// come from a source, typically a file, and pass through a shuffle buffer of a bounded size: each output
+    /// example is drawn at random from the buffer and replaced by the next example of the source. Blocks of the
+    /// source are read on another thread while the examples of the previous block are consumed.
+    /// </summary>
+    class StreamingDataset : public DatasetBase
+    {
+    public:
+        /// <summary> A function that returns an iterator that reads all the examples of the source, from the start. </summary>
+        using ExampleSource = std::function<AutoSupervisedExampleIterator()>;
+
+        /// <summary> Iterator class. </summary>
+        template <typename IteratorExampleType>
+        class StreamingExampleIterator : public IExampleIterator<IteratorExampleType>
+        {
+        public:
+            /// <summary> Constructs a StreamingExampleIterator. </summary>
+            ///
+            /// <param name="reader"> The reader of an epoch. </param>
+            StreamingExampleIterator(StreamingDatasetReader reader) :
+                _reader(std::move(reader)) {}
+
+            /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+            ///
+            /// <returns> true if the iterator is currently pointing to a valid iterate. </returns>
+            bool IsValid() const override { return _reader.IsValid(); }
+
+            /// <summary> Proceeds to the Next iterate. </summary>
+            void Next() override { _reader.Next(); }
+
+            /// <summary> Gets the current example pointer to by the iterator. </summary>
+            ///
+            /// <returns> The example. </returns>
+            IteratorExampleType Get() const override { return _reader.Get().template CopyAs<IteratorExampleType>(); }
+
+        private:
+            StreamingDatasetReader _reader;
+        };
+
+        /// <summary> Constructs a StreamingDataset, and reads the source once to count its examples. </summary>
+        ///
+        /// <param name="source"> The source of the examples. </param>
+        /// <param name="parameters"> The streaming dataset parameters. </param>
+        StreamingDataset(ExampleSource source, const StreamingDatasetParameters& parameters);
+
+        /// <summary> Constructs a StreamingDataset whose source has a known number of examples. </summary>
+        ///
+        /// <param name="source"> The source of the examples. </param>
+        /// <param name="numExamples"> The number of examples in the source. </param>
+        /// <param name="parameters"> The streaming dataset parameters. </param>
+        StreamingDataset(ExampleSource source, size_t numExamples, const StreamingDatasetParameters& parameters);
+
+        /// <summary> Returns the number of examples in the dataset. </summary>
+        ///
+        /// <returns> Number of examples. </returns>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary>
+        /// Starts a new epoch, with a different shuffle than the previous epochs, and returns a reader for it.
+        /// </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example of the source to read. </param>
+        /// <param name="size"> The number of examples to read, a value of zero means all the way to the end. </param>
+        ///
+        /// <returns> The reader. </returns>
+        StreamingDatasetReader GetReader(size_t fromIndex = 0, size_t size = 0) const;
+
+        /// <summary> Starts a new epoch, and returns an iterator that traverses its examples. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example of the source to read. </param>
+        /// <param name="size"> The number of examples to read, a value of zero means all the way to the end. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        template <typename IteratorExampleType = AutoSupervisedExample>
+        ExampleIterator<IteratorExampleType> GetExampleIterator(size_t fromIndex = 0, size_t size = 0) const;
+
+        /// <summary> Returns an AnyDataset that represents an interval of examples from this dataset. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example in the AnyDataset. </param>
+        /// <param name="size"> The number of examples to include, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The dataset. </returns>
+        AnyDataset GetAnyDataset(size_t fromIndex = 0, size_t size = 0) const;
+
+    private:
+        ExampleSource _source;
+        size_t _numExamples;
+        StreamingDatasetParameters _parameters;
+        mutable size_t _numEpochs = 0;
+    };
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace data
+{
+    template <typename IteratorExampleType>
+    ExampleIterator<IteratorExampleType> StreamingDataset::GetExampleIterator(size_t fromIndex, size_t size) const
+    {
+        return ExampleIterator<IteratorExampleType>(std::make_unique<StreamingExampleIterator<IteratorExampleType>>(GetReader(fromIndex, size)));
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
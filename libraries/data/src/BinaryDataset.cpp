@@ -0,0 +1,461 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDataset.cpp (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDataset.h"
+#include "AutoDataVector.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+
+namespace ell
+{
+namespace data
+{
+    namespace
+    {
+        constexpr uint32_t byteOrderMark = 0x01020304;
+        constexpr size_t alignment = 8;
+
+        size_t Align(size_t size)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        bool IsSparse(IDataVector::Type type)
+        {
+            switch (type)
+            {
+            case IDataVector::Type::SparseDoubleDataVector:
+            case IDataVector::Type::SparseFloatDataVector:
+            case IDataVector::Type::SparseShortDataVector:
+            case IDataVector::Type::SparseByteDataVector:
+            case IDataVector::Type::SparseBinaryDataVector:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // the size of a stored value, or 0 for types that store no values
+        size_t GetValueSize(IDataVector::Type type)
+        {
+            switch (type)
+            {
+            case IDataVector::Type::DoubleDataVector:
+            case IDataVector::Type::SparseDoubleDataVector:
+                return sizeof(double);
+            case IDataVector::Type::FloatDataVector:
+            case IDataVector::Type::SparseFloatDataVector:
+                return sizeof(float);
+            case IDataVector::Type::ShortDataVector:
+            case IDataVector::Type::SparseShortDataVector:
+                return sizeof(short);
+            case IDataVector::Type::ByteDataVector:
+            case IDataVector::Type::SparseByteDataVector:
+                return sizeof(char);
+            case IDataVector::Type::SparseBinaryDataVector:
+                return 0;
+            default:
+                throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Unexpected data vector type in binary dataset");
+            }
+        }
+
+        size_t GetStoredSize(IDataVector::Type type, size_t numStoredElements)
+        {
+            auto indicesSize = IsSparse(type) ? Align(numStoredElements * sizeof(uint32_t)) : 0;
+            return sizeof(BinaryDataVectorHeader) + indicesSize + Align(numStoredElements * GetValueSize(type));
+        }
+
+        template <typename ValueType>
+        std::vector<ValueType> CastValues(const std::vector<double>& values)
+        {
+            std::vector<ValueType> result(values.size());
+            std::transform(values.begin(), values.end(), result.begin(), [](double value) { return static_cast<ValueType>(value); });
+            return result;
+        }
+
+        template <typename FunctionType>
+        void CallWithValues(IDataVector::Type type, const std::vector<double>& values, FunctionType function)
+        {
+            switch (GetValueSize(type))
+            {
+            case sizeof(double):
+                function(values);
+                break;
+            case sizeof(float):
+                function(CastValues<float>(values));
+                break;
+            case sizeof(short):
+                function(CastValues<short>(values));
+                break;
+            case sizeof(char):
+                function(CastValues<char>(values));
+                break;
+            default:
+                break;
+            }
+        }
+
+        template <typename ValueType>
+        double GetValue(const void* pValues, size_t index)
+        {
+            return static_cast<double>(static_cast<const ValueType*>(pValues)[index]);
+        }
+
+        class BinaryDatasetExampleIterator : public IExampleIterator<AutoSupervisedExample>
+        {
+        public:
+            BinaryDatasetExampleIterator(const BinaryDataset& dataset) :
+                _dataset(dataset) {}
+
+            bool IsValid() const override { return _index < _dataset.NumExamples(); }
+
+            void Next() override { ++_index; }
+
+            AutoSupervisedExample Get() const override { return _dataset.GetExample(_index).CopyAs<AutoSupervisedExample>(); }
+
+        private:
+            const BinaryDataset& _dataset;
+            size_t _index = 0;
+        };
+    } // namespace
+
+    //
+    // BinaryDatasetWriter
+    //
+
+    BinaryDatasetWriter::BinaryDatasetWriter(std::ostream& stream) :
+        _stream(stream)
+    {
+        // the header is completed by Close
+        BinaryDatasetHeader header = {};
+        WriteArray(&header, 1);
+    }
+
+    void BinaryDatasetWriter::Write(const AutoSupervisedExample& example)
+    {
+        if (_isClosed)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Can't write examples to a closed BinaryDatasetWriter");
+        }
+
+        const auto& dataVector = example.GetDataVector();
+        const auto type = dataVector.GetInternalType();
+        const auto prefixLength = dataVector.PrefixLength();
+
+        _offsets.push_back(_position);
+        _labels.push_back(example.GetMetadata().label);
+        _weights.push_back(example.GetMetadata().weight);
+        _numFeatures = std::max<uint64_t>(_numFeatures, prefixLength);
+
+        BinaryDataVectorHeader header = {};
+        header.type = static_cast<uint32_t>(type);
+        header.prefixLength = prefixLength;
+
+        if (IsSparse(type))
+        {
+            if (prefixLength > std::numeric_limits<uint32_t>::max())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Binary datasets store sparse indices as 32 bit integers");
+            }
+
+            auto entries = dataVector.CopyAs<SparseRowEntries<double>>();
+            std::vector<uint32_t> indices(entries.indices.begin(), entries.indices.end());
+            header.numStoredElements = indices.size();
+            WriteArray(&header, 1);
+            WriteArray(indices.data(), indices.size());
+            WritePadding();
+            CallWithValues(type, entries.values, [this](const auto& values) { WriteArray(values.data(), values.size()); });
+        }
+        else
+        {
+            header.numStoredElements = prefixLength;
+            WriteArray(&header, 1);
+            CallWithValues(type, dataVector.ToArray(), [this](const auto& values) { WriteArray(values.data(), values.size()); });
+        }
+        WritePadding();
+    }
+
+    void BinaryDatasetWriter::Close()
+    {
+        if (_isClosed)
+        {
+            return;
+        }
+        _isClosed = true;
+
+        BinaryDatasetHeader header = {};
+        std::copy(std::begin(BinaryDatasetHeader::magic), std::end(BinaryDatasetHeader::magic), header.fileMagic);
+        header.version = BinaryDatasetHeader::currentVersion;
+        header.byteOrderMark = byteOrderMark;
+        header.numExamples = _labels.size();
+        header.numFeatures = _numFeatures;
+
+        _offsets.push_back(_position);
+        header.indexOffset = _position;
+        WriteArray(_offsets.data(), _offsets.size());
+        header.labelsOffset = _position;
+        WriteArray(_labels.data(), _labels.size());
+        header.weightsOffset = _position;
+        WriteArray(_weights.data(), _weights.size());
+
+        _stream.seekp(0);
+        _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _stream.seekp(0, std::ios::end);
+        _stream.flush();
+        if (!_stream)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Failed to write binary dataset");
+        }
+    }
+
+    template <typename ValueType>
+    void BinaryDatasetWriter::WriteArray(const ValueType* pValues, size_t count)
+    {
+        _stream.write(reinterpret_cast<const char*>(pValues), count * sizeof(ValueType));
+        _position += count * sizeof(ValueType);
+        if (!_stream)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Failed to write binary dataset");
+        }
+    }
+
+    void BinaryDatasetWriter::WritePadding()
+    {
+        const char padding[alignment] = {};
+        WriteArray(padding, Align(_position) - _position);
+    }
+
+    void WriteBinaryDataset(const AutoSupervisedDataset& dataset, std::ostream& stream)
+    {
+        BinaryDatasetWriter writer(stream);
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            writer.Write(dataset[i]);
+        }
+        writer.Close();
+    }
+
+    void WriteBinaryDataset(AutoSupervisedExampleIterator exampleIterator, std::ostream& stream)
+    {
+        BinaryDatasetWriter writer(stream);
+        while (exampleIterator.IsValid())
+        {
+            writer.Write(exampleIterator.Get());
+            exampleIterator.Next();
+        }
+        writer.Close();
+    }
+
+    bool IsBinaryDataset(const std::string& filepath)
+    {
+        std::ifstream stream(filepath, std::ios::binary);
+        char fileMagic[sizeof(BinaryDatasetHeader::magic)] = {};
+        stream.read(fileMagic, sizeof(fileMagic));
+        return stream && std::equal(std::begin(fileMagic), std::end(fileMagic), std::begin(BinaryDatasetHeader::magic));
+    }
+
+    //
+    // BinaryDataVectorIterator
+    //
+
+    BinaryDataVectorIterator::BinaryDataVectorIterator(IDataVector::Type type, const uint32_t* pIndices, const void* pValues, size_t numStoredElements) :
+        _type(type),
+        _pIndices(pIndices),
+        _pValues(pValues),
+        _numStoredElements(numStoredElements)
+    {
+        SkipZeros();
+    }
+
+    void BinaryDataVectorIterator::Next()
+    {
+        ++_index;
+        SkipZeros();
+    }
+
+    void BinaryDataVectorIterator::SkipZeros()
+    {
+        while (IsValid() && GetValue() == 0)
+        {
+            ++_index;
+        }
+    }
+
+    double BinaryDataVectorIterator::GetValue() const
+    {
+        switch (_type)
+        {
+        case IDataVector::Type::DoubleDataVector:
+        case IDataVector::Type::SparseDoubleDataVector:
+            return data::GetValue<double>(_pValues, _index);
+        case IDataVector::Type::FloatDataVector:
+        case IDataVector::Type::SparseFloatDataVector:
+            return data::GetValue<float>(_pValues, _index);
+        case IDataVector::Type::ShortDataVector:
+        case IDataVector::Type::SparseShortDataVector:
+            return data::GetValue<short>(_pValues, _index);
+        case IDataVector::Type::ByteDataVector:
+        case IDataVector::Type::SparseByteDataVector:
+            return data::GetValue<char>(_pValues, _index);
+        default:
+            return 1.0;
+        }
+    }
+
+    //
+    // BinaryDataVector
+    //
+
+    BinaryDataVector::BinaryDataVector(const BinaryDataVectorHeader* pHeader) :
+        _type(static_cast<IDataVector::Type>(pHeader->type)),
+        _prefixLength(pHeader->prefixLength),
+        _numStoredElements(pHeader->numStoredElements)
+    {
+        auto pElements = reinterpret_cast<const char*>(pHeader + 1);
+        if (IsSparse(_type))
+        {
+            _pIndices = reinterpret_cast<const uint32_t*>(pElements);
+            pElements += Align(_numStoredElements * sizeof(uint32_t));
+        }
+
+        if (GetValueSize(_type) > 0)
+        {
+            _pValues = pElements;
+        }
+    }
+
+    double BinaryDataVector::Norm2Squared() const
+    {
+        double result = 0;
+        ForEachStoredElement([&result](size_t, double value) { result += value * value; });
+        return result;
+    }
+
+    double BinaryDataVector::Dot(math::UnorientedConstVectorBase<double> vector) const
+    {
+        double result = 0;
+        auto size = vector.Size();
+        ForEachStoredElement([&](size_t index, double value) {
+            if (index < size)
+            {
+                result += value * vector[index];
+            }
+        });
+        return result;
+    }
+
+    void BinaryDataVector::AddTo(math::RowVectorReference<double> vector) const
+    {
+        auto size = vector.Size();
+        ForEachStoredElement([&](size_t index, double value) {
+            if (index < size)
+            {
+                vector[index] += value;
+            }
+        });
+    }
+
+    //
+    // BinaryDataset
+    //
+
+    BinaryDataset::BinaryDataset(const std::string& filepath) :
+        _file(filepath),
+        _pData(static_cast<const char*>(_file.GetData()))
+    {
+        BinaryDatasetHeader header;
+        if (_file.GetSize() < sizeof(header))
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::abruptEnd, "File is too small to be a binary dataset");
+        }
+        std::memcpy(&header, _pData, sizeof(header));
+
+        if (!std::equal(std::begin(header.fileMagic), std::end(header.fileMagic), std::begin(BinaryDatasetHeader::magic)))
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "File is not a binary dataset");
+        }
+        if (header.version != BinaryDatasetHeader::currentVersion)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::versionMismatch, "Unsupported binary dataset version");
+        }
+        if (header.byteOrderMark != byteOrderMark)
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Binary dataset was written on a machine with a different byte order");
+        }
+
+        _numExamples = header.numExamples;
+        _numFeatures = header.numFeatures;
+        _pOffsets = GetArray<uint64_t>(header.indexOffset, _numExamples + 1);
+        _pLabels = GetArray<double>(header.labelsOffset, _numExamples);
+        _pWeights = GetArray<double>(header.weightsOffset, _numExamples);
+
+        // the data vectors lie in order between the header and the index
+        if (_pOffsets[0] < sizeof(header) || _pOffsets[_numExamples] != header.indexOffset)
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Corrupt binary dataset index");
+        }
+        for (size_t i = 0; i < _numExamples; ++i)
+        {
+            if (_pOffsets[i] % alignment != 0 || _pOffsets[i + 1] < _pOffsets[i] + sizeof(BinaryDataVectorHeader))
+            {
+                throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Corrupt binary dataset index");
+            }
+        }
+    }
+
+    BinaryExample BinaryDataset::GetExample(size_t index) const
+    {
+        if (index >= _numExamples)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Example index out of range");
+        }
+
+        auto pHeader = reinterpret_cast<const BinaryDataVectorHeader*>(_pData + _pOffsets[index]);
+        auto type = static_cast<IDataVector::Type>(pHeader->type);
+        auto isDense = !IsSparse(type);
+        if ((isDense && pHeader->numStoredElements != pHeader->prefixLength) || GetStoredSize(type, pHeader->numStoredElements) > _pOffsets[index + 1] - _pOffsets[index])
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Corrupt data vector in binary dataset");
+        }
+
+        return BinaryExample(BinaryDataVector(pHeader), WeightLabel{ _pWeights[index], _pLabels[index] });
+    }
+
+    AutoSupervisedExampleIterator BinaryDataset::GetExampleIterator() const
+    {
+        return AutoSupervisedExampleIterator(std::make_unique<BinaryDatasetExampleIterator>(*this));
+    }
+
+    AutoSupervisedDataset BinaryDataset::ToDataset() const
+    {
+        AutoSupervisedDataset dataset;
+        for (size_t i = 0; i < _numExamples; ++i)
+        {
+            dataset.AddExample(GetExample(i).CopyAs<AutoSupervisedExample>());
+        }
+        return dataset;
+    }
+
+    template <typename ValueType>
+    const ValueType* BinaryDataset::GetArray(uint64_t offset, size_t count) const
+    {
+        if (offset % alignment != 0 || offset > _file.GetSize() || count > (_file.GetSize() - offset) / sizeof(ValueType))
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::abruptEnd, "Binary dataset is truncated");
+        }
+        return reinterpret_cast<const ValueType*>(_pData + offset);
+    }
+} // namespace data
+} // namespace ell
@@ -7,6 +7,9 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Dataset.h"
+#include "StreamingDataset.h"
+
+#include <utilities/include/Exception.h>
 
 namespace ell
 {
@@ -18,5 +21,20 @@ namespace data
         _size(size)
     {
     }
+
+    bool AnyDataset::IsStreaming() const
+    {
+        return dynamic_cast<const StreamingDataset*>(_pDataset) != nullptr;
+    }
+
+    StreamingDatasetReader AnyDataset::GetStreamingReader() const
+    {
+        auto pStreamingDataset = dynamic_cast<const StreamingDataset*>(_pDataset);
+        if (pStreamingDataset == nullptr)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "AnyDataset does not refer to a StreamingDataset");
+        }
+        return pStreamingDataset->GetReader(_fromIndex, _size);
+    }
 } // namespace data
 } // namespace ell
\ No newline at end of file
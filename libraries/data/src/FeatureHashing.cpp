@@ -0,0 +1,27 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FeatureHashing.cpp (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FeatureHashing.h"
+
+namespace ell
+{
+namespace data
+{
+    uint64_t GetFeatureIndexHash(size_t index)
+    {
+        // the 64 bit finalizer of MurmurHash3, which mixes every bit of the index into every bit of the hash
+        uint64_t hash = static_cast<uint64_t>(index);
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+} // namespace data
+} // namespace ell
@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PackedDataset.cpp (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PackedDataset.h"
+#include "AutoDataVector.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace ell
+{
+namespace data
+{
+    //
+    // PackedDataVectorIterator
+    //
+
+    PackedDataVectorIterator::PackedDataVectorIterator(const uint32_t* pIndices, const double* pValues, size_t numStoredElements) :
+        _pIndices(pIndices),
+        _pValues(pValues),
+        _numStoredElements(numStoredElements)
+    {
+        SkipZeros();
+    }
+
+    void PackedDataVectorIterator::Next()
+    {
+        ++_index;
+        SkipZeros();
+    }
+
+    void PackedDataVectorIterator::SkipZeros()
+    {
+        while (_index < _numStoredElements && _pValues[_index] == 0)
+        {
+            ++_index;
+        }
+    }
+
+    //
+    // PackedDataVector
+    //
+
+    PackedDataVector::PackedDataVector(const uint32_t* pIndices, const double* pValues, size_t numStoredElements, size_t prefixLength) :
+        _pIndices(pIndices),
+        _pValues(pValues),
+        _numStoredElements(numStoredElements),
+        _prefixLength(prefixLength)
+    {
+    }
+
+    double PackedDataVector::Norm2Squared() const
+    {
+        double result = 0;
+        for (size_t i = 0; i < _numStoredElements; ++i)
+        {
+            result += _pValues[i] * _pValues[i];
+        }
+        return result;
+    }
+
+    double PackedDataVector::Dot(math::UnorientedConstVectorBase<double> vector) const
+    {
+        double result = 0;
+        auto size = vector.Size();
+        if (_pIndices == nullptr)
+        {
+            auto numElements = std::min(_numStoredElements, size);
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                result += _pValues[i] * vector[i];
+            }
+            return result;
+        }
+
+        for (size_t i = 0; i < _numStoredElements; ++i)
+        {
+            if (_pIndices[i] < size)
+            {
+                result += _pValues[i] * vector[_pIndices[i]];
+            }
+        }
+        return result;
+    }
+
+    void PackedDataVector::AddTo(math::RowVectorReference<double> vector) const
+    {
+        auto size = vector.Size();
+        if (_pIndices == nullptr)
+        {
+            auto numElements = std::min(_numStoredElements, size);
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                vector[i] += _pValues[i];
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < _numStoredElements; ++i)
+        {
+            if (_pIndices[i] < size)
+            {
+                vector[_pIndices[i]] += _pValues[i];
+            }
+        }
+    }
+
+    std::vector<double> PackedDataVector::ToArray() const
+    {
+        if (_pIndices == nullptr)
+        {
+            return std::vector<double>(_pValues, _pValues + _numStoredElements);
+        }
+
+        std::vector<double> result(_prefixLength);
+        for (size_t i = 0; i < _numStoredElements; ++i)
+        {
+            result[_pIndices[i]] = _pValues[i];
+        }
+        return result;
+    }
+
+    //
+    // PackedDataset
+    //
+
+    PackedExample PackedDataset::GetExample(size_t index) const
+    {
+        if (index >= NumExamples())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Example index out of range");
+        }
+
+        auto indexBegin = _indexOffsets[index];
+        auto valueBegin = _valueOffsets[index];
+        auto numStoredElements = _valueOffsets[index + 1] - valueBegin;
+        auto isSparse = _indexOffsets[index + 1] != indexBegin || numStoredElements != _prefixLengths[index];
+        auto pIndices = isSparse ? _indices.data() + indexBegin : nullptr;
+
+        return PackedExample(PackedDataVector(pIndices, _values.data() + valueBegin, numStoredElements, _prefixLengths[index]), _metadata[index]);
+    }
+
+    AutoSupervisedDataset PackedDataset::ToDataset() const
+    {
+        AutoSupervisedDataset dataset;
+        for (size_t i = 0; i < NumExamples(); ++i)
+        {
+            dataset.AddExample(GetExample(i).CopyAs<AutoSupervisedExample>());
+        }
+        return dataset;
+    }
+
+    void PackedDataset::AddDenseDataVector(std::vector<double> values, WeightLabel metadata)
+    {
+        _values.insert(_values.end(), values.begin(), values.end());
+        _valueOffsets.push_back(_values.size());
+        _indexOffsets.push_back(_indices.size());
+        _prefixLengths.push_back(values.size());
+        _metadata.push_back(metadata);
+        _numFeatures = std::max(_numFeatures, values.size());
+    }
+
+    void PackedDataset::AddSparseDataVector(const SparseRowEntries<double>& entries, size_t prefixLength, WeightLabel metadata)
+    {
+        if (prefixLength > std::numeric_limits<uint32_t>::max())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Packed datasets store sparse indices as 32 bit integers");
+        }
+
+        _indices.insert(_indices.end(), entries.indices.begin(), entries.indices.end());
+        _values.insert(_values.end(), entries.values.begin(), entries.values.end());
+        _valueOffsets.push_back(_values.size());
+        _indexOffsets.push_back(_indices.size());
+        _prefixLengths.push_back(prefixLength);
+        _metadata.push_back(metadata);
+        _numFeatures = std::max(_numFeatures, prefixLength);
+    }
+
+    size_t PackedDataset::CorrectRangeSize(size_t fromIndex, size_t size) const
+    {
+        if (fromIndex > NumExamples())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "fromIndex is greater than the number of examples");
+        }
+
+        if (size == 0 || fromIndex + size > NumExamples())
+        {
+            return NumExamples() - fromIndex;
+        }
+        return size;
+    }
+} // namespace data
+} // namespace ell
@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StreamingDataset.cpp (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StreamingDataset.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/RandomEngines.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+namespace ell
+{
+namespace data
+{
+    StreamingDatasetReader::StreamingDatasetReader(AutoSupervisedExampleIterator source, size_t fromIndex, size_t size, std::default_random_engine random, const StreamingDatasetParameters& parameters) :
+        _blockSize(std::max<size_t>(parameters.prefetchBlockSize, 1)),
+        _random(std::move(random))
+    {
+        // skip to the first example before the first block is read
+        for (size_t i = 0; i < fromIndex && source.IsValid(); ++i)
+        {
+            source.Next();
+        }
+
+        auto endIndex = size == 0 ? std::numeric_limits<size_t>::max() : size;
+        _source = std::make_unique<BlockSource>(BlockSource{ std::move(source), 0, endIndex });
+        StartReadingBlock();
+
+        auto bufferSize = std::max<size_t>(parameters.shuffleBufferSize, 1);
+        _buffer.reserve(bufferSize);
+        IndexedExample example;
+        while (_buffer.size() < bufferSize && TakeIncoming(example))
+        {
+            _buffer.push_back(std::move(example));
+        }
+
+        Next();
+    }
+
+    void StreamingDatasetReader::Next()
+    {
+        if (_buffer.empty())
+        {
+            _isValid = false;
+            return;
+        }
+
+        // draw an example from the buffer, and replace it with the next example of the source
+        std::uniform_int_distribution<size_t> distribution(0, _buffer.size() - 1);
+        auto bufferIndex = distribution(_random);
+        _current = std::move(_buffer[bufferIndex]);
+        if (!TakeIncoming(_buffer[bufferIndex]))
+        {
+            if (bufferIndex != _buffer.size() - 1)
+            {
+                _buffer[bufferIndex] = std::move(_buffer.back());
+            }
+            _buffer.pop_back();
+        }
+        _isValid = true;
+    }
+
+    StreamingDatasetReader::~StreamingDatasetReader()
+    {
+        // the block is read from the source on the thread pool
+        if (_nextBlock.valid())
+        {
+            utilities::GetHostThreadPool().Wait(_nextBlock);
+        }
+    }
+
+    auto StreamingDatasetReader::ReadBlock(BlockSource& source, size_t blockSize) -> std::vector<IndexedExample>
+    {
+        std::vector<IndexedExample> block;
+        block.reserve(blockSize);
+        while (block.size() < blockSize && source.nextIndex < source.endIndex && source.iterator.IsValid())
+        {
+            block.push_back({ source.nextIndex, source.iterator.Get() });
+            source.iterator.Next();
+            ++source.nextIndex;
+        }
+        return block;
+    }
+
+    void StreamingDatasetReader::StartReadingBlock()
+    {
+        _nextBlock = utilities::GetHostThreadPool().AddTask(&ReadBlock, std::ref(*_source), _blockSize);
+    }
+
+    bool StreamingDatasetReader::TakeIncoming(IndexedExample& example)
+    {
+        if (_incomingIndex == _incoming.size())
+        {
+            if (!_nextBlock.valid())
+            {
+                return false;
+            }
+
+            _incoming = utilities::GetHostThreadPool().GetResult(_nextBlock);
+            _incomingIndex = 0;
+
+            // a short block is the last one
+            if (_incoming.size() == _blockSize)
+            {
+                StartReadingBlock();
+            }
+
+            if (_incoming.empty())
+            {
+                return false;
+            }
+        }
+
+        example = std::move(_incoming[_incomingIndex]);
+        ++_incomingIndex;
+        return true;
+    }
+
+    StreamingDataset::StreamingDataset(ExampleSource source, const StreamingDatasetParameters& parameters) :
+        _source(std::move(source)),
+        _numExamples(0),
+        _parameters(parameters)
+    {
+        auto exampleIterator = _source();
+        while (exampleIterator.IsValid())
+        {
+            ++_numExamples;
+            exampleIterator.Next();
+        }
+    }
+
+    StreamingDataset::StreamingDataset(ExampleSource source, size_t numExamples, const StreamingDatasetParameters& parameters) :
+        _source(std::move(source)),
+        _numExamples(numExamples),
+        _parameters(parameters)
+    {
+    }
+
+    StreamingDatasetReader StreamingDataset::GetReader(size_t fromIndex, size_t size) const
+    {
+        if (fromIndex > _numExamples)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "fromIndex is greater than the number of examples");
+        }
+
+        // without a seed, each epoch gets a random seed anyway
+        auto seed = _parameters.randomSeedString.empty() ? "" : _parameters.randomSeedString + "_" + std::to_string(_numEpochs);
+        auto random = utilities::GetRandomEngine(seed);
+        ++_numEpochs;
+        return StreamingDatasetReader(_source(), fromIndex, size, std::move(random), _parameters);
+    }
+
+    AnyDataset StreamingDataset::GetAnyDataset(size_t fromIndex, size_t size) const
+    {
+        if (fromIndex > _numExamples)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "fromIndex is greater than the number of examples");
+        }
+
+        auto maxSize = _numExamples - fromIndex;
+        return AnyDataset(this, fromIndex, size == 0 ? maxSize : std::min(size, maxSize));
+    }
+} // namespace data
+} // namespace ell
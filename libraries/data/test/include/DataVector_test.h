@@ -11,6 +11,7 @@
 namespace ell
 {
 void IDataVectorTests();
+void DataVectorDotTests();
 void DataVectorCopyAsTests();
 void AutoDataVectorTest();
 void TransformedDataVectorTest();
@@ -8,8 +8,14 @@
 
 #pragma once
 
+#include <string>
+
 namespace ell
 {
 void DatasetCastingTests();
-void DatasetSerializationTests();
+void DatasetSerializationTests(const std::string& outputPath);
+void DatasetBinarySerializationTests(const std::string& outputPath);
+void PackedDatasetTests();
+void StreamingDatasetTests();
+void DatasetWeightLabelTableTests();
 } // namespace ell
\ No newline at end of file
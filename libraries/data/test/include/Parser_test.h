@@ -12,4 +12,6 @@ namespace ell
 void DataVectorParseTest();
 void AutoDataVectorParseTest();
 void SingleFileParseTest();
+void ParallelFileParseTest();
+void FeatureHashingParseTest();
 } // namespace ell
\ No newline at end of file
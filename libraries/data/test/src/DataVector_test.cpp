@@ -15,6 +15,7 @@
 #include <data/include/SparseBinaryDataVector.h>
 #include <data/include/SparseDataVector.h>
 
+#include <math/include/Matrix.h>
 #include <math/include/Vector.h>
 
 #include <testing/include/testing.h>
@@ -105,6 +106,73 @@ void IDataVectorTests()
     IDataVectorBinaryTest<data::SparseBinaryDataVector>();
 }
 
+template <typename DataVectorType>
+void DataVectorDotTest()
+{
+    DataVectorType u{ 1, 0, -2, 0, 3, 0, 0, 4, 5 };
+    std::string name = std::string(typeid(DataVectorType).name());
+
+    math::RowVector<float> f{ 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+    testing::ProcessTest("Testing " + name + "::Dot() with a float vector", testing::IsEqual(u.Dot(f), 11.0f));
+
+    // a vector that is shorter than the data vector
+    math::RowVector<double> shortVector{ 2, 2, 2, 2, 2 };
+    testing::ProcessTest("Testing " + name + "::Dot() with a short vector", testing::IsEqual(u.Dot(shortVector), 4.0));
+    u.AddTo(shortVector);
+    testing::ProcessTest("Testing " + name + "::AddTo() with a short vector", testing::IsEqual(shortVector.ToArray(), std::vector<double>{ 3, 2, 0, 2, 5 }));
+
+    // a column of a row major matrix, whose elements are not contiguous
+    math::RowMatrix<double> matrix(9, 2);
+    for (size_t i = 0; i < 9; ++i)
+    {
+        matrix(i, 0) = static_cast<double>(i);
+        matrix(i, 1) = -1;
+    }
+    auto column = matrix.GetColumn(0).Transpose();
+    testing::ProcessTest("Testing " + name + "::Dot() with a strided vector", testing::IsEqual(u.Dot(column), 0 - 4.0 + 12.0 + 28.0 + 40.0));
+    u.AddTo(column);
+    testing::ProcessTest("Testing " + name + "::AddTo() with a strided vector", testing::IsEqual(column.ToArray(), std::vector<double>{ 1, 1, 0, 3, 7, 5, 6, 11, 13 }) && matrix(8, 1) == -1);
+}
+
+template <typename DataVectorType>
+void LongDataVectorDotTest()
+{
+    // enough nonzeros to span several blocks of decoded indices, with gaps of different sizes
+    std::vector<double> values(3000);
+    for (size_t i = 0; i < values.size(); i += 1 + (i % 7) * (i % 11))
+    {
+        values[i] = static_cast<double>(i % 13) - 6;
+    }
+    DataVectorType u(values);
+    data::DoubleDataVector dense(values);
+
+    math::RowVector<double> w(values.size() - 100);
+    for (size_t i = 0; i < w.Size(); ++i)
+    {
+        w[i] = static_cast<double>(i % 17);
+    }
+    auto expected = w;
+    dense.AddTo(expected);
+    u.AddTo(w);
+
+    std::string name = std::string(typeid(DataVectorType).name());
+    testing::ProcessTest("Testing " + name + "::Dot() with a long vector", testing::IsEqual(u.Dot(w), dense.Dot(w)));
+    testing::ProcessTest("Testing " + name + "::AddTo() with a long vector", testing::IsEqual(w.ToArray(), expected.ToArray()));
+}
+
+void DataVectorDotTests()
+{
+    LongDataVectorDotTest<data::SparseDoubleDataVector>();
+    LongDataVectorDotTest<data::SparseShortDataVector>();
+
+    DataVectorDotTest<data::DoubleDataVector>();
+    DataVectorDotTest<data::FloatDataVector>();
+    DataVectorDotTest<data::ShortDataVector>();
+    DataVectorDotTest<data::SparseDoubleDataVector>();
+    DataVectorDotTest<data::SparseFloatDataVector>();
+    DataVectorDotTest<data::SparseShortDataVector>();
+}
+
 template <typename DataVectorType1, typename DataVectorType2>
 void DataVectorCopyAsTest(std::initializer_list<double> list, bool testDense = true)
 {
@@ -10,14 +10,19 @@
 
 #include <common/include/DataLoaders.h>
 
+#include <data/include/BinaryDataset.h>
 #include <data/include/Dataset.h>
+#include <data/include/PackedDataset.h>
+#include <data/include/StreamingDataset.h>
 
 #include <utilities/include/Files.h>
 #include <utilities/include/StringUtil.h>
 
 #include <testing/include/testing.h>
 
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 namespace ell
 {
@@ -71,7 +76,7 @@ void DatasetCastingTests()
     DatasetCastingTestDispatch<data::DenseSupervisedExample>();
 }
 
-void DatasetSerializationTests()
+void DatasetSerializationTests(const std::string& outputPath)
 {
     data::Dataset<data::AutoSupervisedExample> dataset1;
     dataset1.AddExample(GetExample<data::AutoSupervisedExample>());
@@ -79,7 +84,7 @@ void DatasetSerializationTests()
     dataset1.AddExample(GetExample<data::AutoSupervisedExample>());
 
     // save the dataset
-    const std::string filename("dataset1.txt");
+    const std::string filename = utilities::JoinPaths(outputPath, "dataset1.txt");
     auto stream = utilities::OpenOfstream(filename);
     dataset1.Print(stream);
     stream.close();
@@ -119,4 +124,232 @@ void DatasetSerializationTests()
     }
     testing::ProcessTest(utilities::FormatString("DatasetSerializationTest data %d errors", errors), errors == 0);
 }
+
+void DatasetBinarySerializationTests(const std::string& outputPath)
+{
+    // vectors that the AutoDataVector stores as different dense and sparse types
+    std::vector<std::vector<double>> vectors{
+        { 1, 0, 1, 0, 1, 0, 1 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, -3 },
+        { 3, -2, 7, 100, 1, 4 },
+        { 1000, -2000, 3000, 20000 },
+        { 0.5, 0.25, 2, 1.5 },
+        { 1.0 / 3, 2, 3, 0, 0.1 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0.1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0.2 },
+        {}
+    };
+
+    data::AutoSupervisedDataset dataset1;
+    for (size_t i = 0; i < vectors.size(); ++i)
+    {
+        dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector(vectors[i]), data::WeightLabel{ 1.0 + i, i % 2 == 0 ? 1.0 : -1.0 }));
+    }
+
+    // save the dataset
+    const std::string filename = utilities::JoinPaths(outputPath, "dataset1.bin");
+    {
+        auto stream = utilities::OpenBinaryOfstream(filename);
+        data::WriteBinaryDataset(dataset1, stream);
+    }
+
+    // map it back into memory
+    bool isBinary = data::IsBinaryDataset(filename) && !data::IsBinaryDataset(utilities::JoinPaths(outputPath, "dataset1.txt"));
+    data::BinaryDataset dataset2(filename);
+    testing::ProcessTest("DatasetBinarySerializationTest size", isBinary && dataset1.NumExamples() == dataset2.NumExamples() && dataset1.NumFeatures() == dataset2.NumFeatures());
+
+    math::RowVector<double> weights(20);
+    weights.Generate([i = 0]() mutable { return 0.5 * i++; });
+
+    int errors = 0;
+    for (size_t i = 0; i < dataset1.NumExamples(); i++)
+    {
+        const auto& e1 = dataset1.GetExample(i);
+        auto e2 = dataset2.GetExample(i);
+        const auto& v1 = e1.GetDataVector();
+        const auto& v2 = e2.GetDataVector();
+
+        math::RowVector<double> sum1(20);
+        math::RowVector<double> sum2(20);
+        v1.AddTo(sum1);
+        v2.AddTo(sum2);
+
+        auto sameType = v1.GetInternalType() == v2.GetType() && v1.PrefixLength() == v2.PrefixLength();
+        auto sameVector = testing::IsEqual(v1.ToArray(), v2.CopyAs<data::DoubleDataVector>().ToArray()) && sum1 == sum2;
+        auto sameProducts = v1.Dot(weights) == v2.Dot(weights) && v1.Norm2Squared() == v2.Norm2Squared();
+        auto sameMetadata = e1.GetMetadata().label == e2.GetMetadata().label && e1.GetMetadata().weight == e2.GetMetadata().weight;
+        if (!(sameType && sameVector && sameProducts && sameMetadata))
+        {
+            errors++;
+        }
+    }
+    testing::ProcessTest(utilities::FormatString("DatasetBinarySerializationTest data %d errors", errors), errors == 0);
+
+    auto dataset3 = dataset2.ToDataset();
+    std::stringstream ss1, ss3;
+    dataset1.Print(ss1);
+    dataset3.Print(ss3);
+    testing::ProcessTest("DatasetBinarySerializationTest ToDataset", ss1.str() == ss3.str());
+}
+
+void PackedDatasetTests()
+{
+    // vectors that are packed as dense and as sparse vectors
+    std::vector<std::vector<double>> vectors{
+        { 1, 0, 1, 0, 1, 0, 1 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, -3 },
+        { 3, -2, 7, 100, 1, 4 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0.1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0.2 },
+        {}
+    };
+
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < vectors.size(); ++i)
+    {
+        dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector(vectors[i]), data::WeightLabel{ 1.0 + i, i % 2 == 0 ? 1.0 : -1.0 }));
+    }
+    data::PackedDataset packedDataset(dataset);
+    testing::ProcessTest("PackedDatasetTest size", packedDataset.NumExamples() == dataset.NumExamples() && packedDataset.NumFeatures() == dataset.NumFeatures());
+    testing::ProcessTest("PackedDatasetTest storage", !packedDataset[2].GetDataVector().IsSparse() && packedDataset[1].GetDataVector().IsSparse() && packedDataset[3].GetDataVector().IsSparse());
+
+    math::RowVector<double> weights(20);
+    weights.Generate([i = 0]() mutable { return 0.5 * i++; });
+
+    int errors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); i++)
+    {
+        const auto& v1 = dataset[i].GetDataVector();
+        auto e2 = packedDataset.GetExample(i);
+        const auto& v2 = e2.GetDataVector();
+
+        math::RowVector<double> sum1(20);
+        math::RowVector<double> sum2(20);
+        v1.AddTo(sum1);
+        v2.AddTo(sum2);
+
+        if (v1.ToArray() != v2.ToArray() || v1.PrefixLength() != v2.PrefixLength() || v1.Norm2Squared() != v2.Norm2Squared() || v1.Dot(weights) != v2.Dot(weights) || sum1 != sum2 || v1.ToArray() != v2.CopyAs<data::AutoDataVector>().ToArray() || dataset[i].GetMetadata().label != e2.GetMetadata().label || dataset[i].GetMetadata().weight != e2.GetMetadata().weight)
+        {
+            ++errors;
+        }
+    }
+    testing::ProcessTest("PackedDatasetTest data " + std::to_string(errors) + " errors", errors == 0);
+
+    // an interval of a packed dataset, through AnyDataset
+    auto anyDataset = packedDataset.GetAnyDataset(1, 3);
+    data::AutoSupervisedDataset intervalDataset(anyDataset);
+    bool isIntervalEqual = anyDataset.NumExamples() == 3 && intervalDataset.NumExamples() == 3;
+    for (size_t i = 0; isIntervalEqual && i < intervalDataset.NumExamples(); ++i)
+    {
+        isIntervalEqual = intervalDataset[i].GetDataVector().ToArray() == vectors[i + 1];
+    }
+    testing::ProcessTest("PackedDatasetTest AnyDataset", isIntervalEqual && !anyDataset.IsStreaming());
+}
+
+void StreamingDatasetTests()
+{
+    // the label of each example is its index
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector({ 1.0, static_cast<double>(i) }), data::WeightLabel{ 1.0, static_cast<double>(i) }));
+    }
+    auto source = [&dataset]() { return dataset.GetExampleIterator(); };
+
+    auto readLabels = [](data::StreamingDatasetReader reader) {
+        std::vector<double> labels;
+        bool isIndexCorrect = true;
+        while (reader.IsValid())
+        {
+            labels.push_back(reader.Get().GetMetadata().label);
+            isIndexCorrect = isIndexCorrect && reader.Get().GetMetadata().label == static_cast<double>(reader.GetIndex());
+            reader.Next();
+        }
+        return isIndexCorrect ? labels : std::vector<double>{};
+    };
+
+    std::vector<double> allLabels(dataset.NumExamples());
+    std::generate(allLabels.begin(), allLabels.end(), [i = 0.0]() mutable { return i++; });
+
+    // a shuffle buffer of size 1 keeps the order of the source
+    data::StreamingDataset orderedDataset(source, { 1, 8, "XYZ" });
+    testing::ProcessTest("StreamingDatasetTest count", orderedDataset.NumExamples() == dataset.NumExamples());
+    testing::ProcessTest("StreamingDatasetTest ordered", readLabels(orderedDataset.GetReader()) == allLabels);
+
+    // each epoch of a shuffled dataset is a different permutation of the examples
+    data::StreamingDataset shuffledDataset(source, dataset.NumExamples(), { 10, 7, "XYZ" });
+    auto epoch1 = readLabels(shuffledDataset.GetReader());
+    auto epoch2 = readLabels(shuffledDataset.GetReader());
+    bool isShuffled = epoch1 != allLabels && epoch1 != epoch2;
+    std::sort(epoch1.begin(), epoch1.end());
+    std::sort(epoch2.begin(), epoch2.end());
+    testing::ProcessTest("StreamingDatasetTest shuffled", isShuffled && epoch1 == allLabels && epoch2 == allLabels);
+
+    // an interval of a streaming dataset, through AnyDataset
+    auto anyDataset = shuffledDataset.GetAnyDataset(40, 20);
+    auto exampleIterator = anyDataset.GetExampleIterator<data::DenseSupervisedExample>();
+    std::vector<double> intervalLabels;
+    while (exampleIterator.IsValid())
+    {
+        intervalLabels.push_back(exampleIterator.Get().GetMetadata().label);
+        exampleIterator.Next();
+    }
+    std::sort(intervalLabels.begin(), intervalLabels.end());
+    testing::ProcessTest("StreamingDatasetTest AnyDataset", anyDataset.IsStreaming() && !dataset.GetAnyDataset().IsStreaming() && anyDataset.NumExamples() == 10 && intervalLabels == std::vector<double>(allLabels.begin() + 40, allLabels.end()));
+}
+void DatasetWeightLabelTableTests()
+{
+    // the label of each example is its index, and the weight is twice that
+    data::AutoSupervisedDataset dataset;
+    auto addExamples = [&dataset](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector({ 1.0 + i }), data::WeightLabel{ 2.0 * i, static_cast<double>(i) }));
+        }
+    };
+    auto isTableInSync = [&dataset]() {
+        const auto& weights = dataset.GetWeights();
+        const auto& labels = dataset.GetLabels();
+        bool isEqual = weights.size() == dataset.NumExamples() && labels.size() == dataset.NumExamples();
+        for (size_t i = 0; isEqual && i < dataset.NumExamples(); ++i)
+        {
+            const auto& metadata = static_cast<const data::AutoSupervisedDataset&>(dataset)[i].GetMetadata();
+            isEqual = weights[i] == metadata.weight && labels[i] == metadata.label;
+        }
+        return isEqual;
+    };
+
+    addExamples(0, 1000);
+    bool isAddInSync = isTableInSync();
+    addExamples(1000, 1500);
+    isAddInSync = isAddInSync && isTableInSync();
+    testing::ProcessTest("DatasetWeightLabelTableTest add", isAddInSync && dataset.GetLabels()[1234] == 1234.0);
+
+    std::default_random_engine rng(123);
+    dataset.RandomPermute(rng);
+    bool isPermuteInSync = isTableInSync();
+    dataset.Sort([](const data::AutoSupervisedExample& example) { return example.GetMetadata().label; });
+    bool isSortInSync = isTableInSync() && dataset.GetLabels()[10] == 10.0;
+    dataset.Partition([](const data::AutoSupervisedExample& example) { return example.GetMetadata().label > 700; });
+    testing::ProcessTest("DatasetWeightLabelTableTest reorder", isPermuteInSync && isSortInSync && isTableInSync());
+
+    dataset[3].GetMetadata().weight = -1.0;
+    testing::ProcessTest("DatasetWeightLabelTableTest modify", dataset.GetWeights()[3] == -1.0 && isTableInSync());
+
+    // a parallel transform keeps the order of the examples
+    dataset.Sort([](const data::AutoSupervisedExample& example) { return example.GetMetadata().label; });
+    auto negateExample = [](const data::AutoSupervisedExample& example) {
+        return data::AutoSupervisedExample(data::AutoDataVector({ -example.GetDataVector().ToArray()[0] }), data::WeightLabel{ example.GetMetadata().weight, -example.GetMetadata().label });
+    };
+    auto serialDataset = dataset.Transform<data::AutoSupervisedExample>(negateExample);
+    auto parallelDataset = dataset.Transform<data::AutoSupervisedExample>(negateExample, 4);
+    const auto& parallelLabels = parallelDataset.GetLabels();
+    bool isTransformEqual = parallelDataset.NumExamples() == dataset.NumExamples() && parallelDataset.NumFeatures() == serialDataset.NumFeatures() && parallelLabels == serialDataset.GetLabels();
+    for (size_t i = 0; isTransformEqual && i < parallelDataset.NumExamples(); ++i)
+    {
+        isTransformEqual = parallelDataset.GetExample(i).GetDataVector().ToArray() == serialDataset.GetExample(i).GetDataVector().ToArray() && parallelLabels[i] == -static_cast<double>(i);
+    }
+    testing::ProcessTest("DatasetWeightLabelTableTest parallel Transform", isTransformEqual);
+
+    dataset.Reset();
+    testing::ProcessTest("DatasetWeightLabelTableTest reset", dataset.GetLabels().empty() && dataset.GetWeights().empty());
+}
 } // namespace ell
@@ -10,7 +10,9 @@
 
 #include <data/include/AutoDataVector.h>
 #include <data/include/Dataset.h>
+#include <data/include/FeatureHashing.h>
 #include <data/include/GeneralizedSparseParsingIterator.h>
+#include <data/include/ParallelParsingExampleIterator.h>
 #include <data/include/SequentialLineIterator.h>
 #include <data/include/SingleLineParsingExampleIterator.h>
 #include <data/include/TextLine.h>
@@ -142,4 +144,86 @@ void SingleFileParseTest()
     testing::ProcessTest("SingleFileParse test2", dataset[1].GetMetadata().label == -1 && testing::IsEqual(dataset[1].GetDataVector().ToArray(), { 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 3 }));
     testing::ProcessTest("SingleFileParse test3", dataset[2].GetMetadata().label == 1 && testing::IsEqual(dataset[2].GetDataVector().ToArray(), { 2.7, 0, 0, 0, -0.3, 0, 0, 0, 0, 0, 3.14 }));
 }
-} // namespace ell
\ No newline at end of file
+
+void ParallelFileParseTest()
+{
+    std::string string = "// comment\n\n";
+    for (int i = 0; i < 50; ++i)
+    {
+        string += std::to_string(i % 2 == 0 ? 1 : -1) + " " + std::to_string(i % 7) + ":" + std::to_string(i) + " 12:0.5 # comment\n";
+        if (i % 5 == 0)
+        {
+            string += "\n    // another comment\n";
+        }
+    }
+    string += "1.0  0:1 3:3.25"; // no line break at the end
+
+    std::stringstream sequentialStream(string);
+    auto sequentialDataset = data::MakeDataset(data::MakeSingleLineParsingExampleIterator(data::SequentialLineIterator(sequentialStream), data::LabelParser{}, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>{}));
+
+    // small chunks, so that lines are cut and some chunks have no examples
+    for (size_t chunkSize : { 1, 16, 100, 1 << 20 })
+    {
+        std::stringstream stream(string);
+        using IteratorType = data::ParallelParsingExampleIterator<data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>;
+        auto iterator = std::make_unique<IteratorType>(stream, data::LabelParser{}, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>{}, 3, chunkSize);
+        auto dataset = data::MakeDataset(data::AutoSupervisedExampleIterator(std::move(iterator)));
+
+        bool isEqual = dataset.NumExamples() == sequentialDataset.NumExamples();
+        for (size_t i = 0; isEqual && i < dataset.NumExamples(); ++i)
+        {
+            isEqual = dataset[i].GetMetadata().label == sequentialDataset[i].GetMetadata().label && testing::IsEqual(dataset[i].GetDataVector().ToArray(), sequentialDataset[i].GetDataVector().ToArray());
+        }
+        testing::ProcessTest("ParallelFileParse chunk size " + std::to_string(chunkSize), isEqual && dataset.NumExamples() == 51);
+    }
+}
+
+void FeatureHashingParseTest()
+{
+    // indices that don't fit in a 32 bit integer
+    std::string string = "1:1 5000000000:2 5000000001:-3 9000000000:4";
+    std::vector<size_t> indices = { 1, 5000000000, 5000000001, 9000000000 };
+    std::vector<double> values = { 1, 2, -3, 4 };
+
+    for (bool useSignHash : { false, true })
+    {
+        data::FeatureHashingParameters parameters{ 3, useSignHash };
+        std::vector<double> expected(8);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            auto hash = data::GetFeatureIndexHash(indices[i]);
+            expected[hash & 7] += useSignHash && (hash >> 63) != 0 ? -values[i] : values[i];
+        }
+
+        data::TextLine textLine(string);
+        data::FeatureHashingDataVectorParser<data::GeneralizedSparseParsingIterator> parser{ parameters };
+        auto dataVector = parser.Parse(textLine);
+        auto result = dataVector.ToArray(8);
+
+        std::string name = useSignHash ? "FeatureHashingParse with sign hash" : "FeatureHashingParse";
+        testing::ProcessTest(name, dataVector.PrefixLength() <= 8 && testing::IsEqual(result, expected));
+    }
+
+    bool exceptionThrown = false;
+    try
+    {
+        data::TextLine textLine(string);
+        data::FeatureHashingDataVectorParser<data::GeneralizedSparseParsingIterator> parser{ { 0, false } };
+        parser.Parse(textLine);
+    }
+    catch (const utilities::InputException&)
+    {
+        exceptionThrown = true;
+    }
+    testing::ProcessTest("FeatureHashingParse without hash bits", exceptionThrown);
+
+    // hashing a data vector that was already parsed gives the same result as hashing at parse time
+    data::TextLine textLine("1:1 2:2 3:-3 100:4 1000:5");
+    auto dataVector = data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>::Parse(textLine);
+    data::TextLine hashedTextLine("1:1 2:2 3:-3 100:4 1000:5");
+    data::FeatureHashingDataVectorParser<data::GeneralizedSparseParsingIterator> parser{ { 4, true } };
+    auto hashedAtParseTime = parser.Parse(hashedTextLine);
+    auto hashed = data::HashDataVector(dataVector, { 4, true });
+    testing::ProcessTest("HashDataVector", testing::IsEqual(hashed.ToArray(16), hashedAtParseTime.ToArray(16)));
+}
+} // namespace ell
@@ -13,23 +13,38 @@
 
 #include <testing/include/testing.h>
 
+#include <utilities/include/Files.h>
+#include <utilities/include/Unused.h>
+
 using namespace ell;
 
 /// Runs all tests
 ///
-int main()
+int main(int argc, char* argv[])
 {
+    UNUSED(argc);
+
+    // Write test files next to the test executable, in the build output, rather than in the source tree
+    const std::string outputPath = utilities::GetDirectoryPath(argv[0]);
+
     IDataVectorTests();
+    DataVectorDotTests();
     DataVectorCopyAsTests();
     AutoDataVectorTest();
     TransformedDataVectorTest();
     IteratorTests();
     ExampleCopyAsTests();
     DatasetCastingTests();
-    DatasetSerializationTests();
+    DatasetSerializationTests(outputPath);
+    DatasetBinarySerializationTests(outputPath);
+    PackedDatasetTests();
+    StreamingDatasetTests();
+    DatasetWeightLabelTableTests();
     DataVectorParseTest();
     AutoDataVectorParseTest();
     SingleFileParseTest();
+    ParallelFileParseTest();
+    FeatureHashingParseTest();
 
     if (testing::DidTestFail())
     {
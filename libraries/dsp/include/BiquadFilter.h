@@ -0,0 +1,342 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BiquadFilter.h (dsp)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/Archiver.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace ell
+{
+namespace dsp
+{
+    /// <summary>
+    /// The coefficients of a second-order section (biquad) of an IIR filter, normalized so that a0 == 1:
+    ///
+    ///     y[t] = b0*x[t] + b1*x[t-1] + b2*x[t-2] - a1*y[t-1] - a2*y[t-2]
+    /// </summary>
+    template <typename ValueType>
+    struct BiquadCoefficients
+    {
+        ValueType b0 = 1;
+        ValueType b1 = 0;
+        ValueType b2 = 0;
+        ValueType a1 = 0;
+        ValueType a2 = 0;
+    };
+
+    /// <summary>
+    /// Decompose an IIR filter into a cascade of second-order sections, by pairing up the roots of its feedforward
+    /// and recursive polynomials. Complex roots are paired with their conjugates, so the sections have real coefficients.
+    /// </summary>
+    ///
+    /// <param name="b"> The feedforward coefficients of the filter, {b0, b1, b2, ...}. </param>
+    /// <param name="a"> The recursive coefficients of the filter, {a1, a2, ...}, as used by `IIRFilter` (that is, a0 == 1). </param>
+    ///
+    /// <returns> The second-order sections. The overall gain is in the feedforward coefficients of the first section. </returns>
+    template <typename ValueType>
+    std::vector<BiquadCoefficients<ValueType>> GetSecondOrderSections(const std::vector<ValueType>& b, const std::vector<ValueType>& a);
+
+    /// <summary>
+    /// A class representing an IIR filter as a cascade of second-order sections (biquads), applied independently to
+    /// each of several interleaved channels. Each section is computed in transposed direct form II, which keeps two
+    /// state values per channel and is less sensitive to coefficient rounding than a single high-order recurrence.
+    /// </summary>
+    template <typename ValueType>
+    class BiquadFilter : public utilities::IArchivable
+    {
+    public:
+        /// <summary> Default constructor: a filter with no sections. </summary>
+        BiquadFilter() = default;
+
+        /// <summary> Construct a filter given its second-order sections. </summary>
+        ///
+        /// <param name="sections"> The sections of the cascade, applied in order. </param>
+        /// <param name="numChannels"> The number of independent channels to filter. </param>
+        BiquadFilter(const std::vector<BiquadCoefficients<ValueType>>& sections, size_t numChannels);
+
+        /// <summary> Filter a sequence of frames, each holding one sample of every channel. <summary>
+        ///
+        /// <param name="x"> The new input samples to process, frame by frame. Must be a whole number of frames. <param>
+        ///
+        /// <returns> The next output samples from the filter, in the same layout. </returns>
+        std::vector<ValueType> FilterSamples(const std::vector<ValueType>& x);
+
+        /// <summary> Reset the internal state of the filter to zero. </summary>
+        void Reset();
+
+        /// <summary> Gets the sections of the cascade. </summary>
+        const std::vector<BiquadCoefficients<ValueType>>& GetSections() const { return _sections; }
+
+        /// <summary> Gets the number of independent channels. </summary>
+        size_t NumChannels() const { return _numChannels; }
+
+        /// <summary> Gets the name of this type. </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("BiquadFilter"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        std::vector<BiquadCoefficients<ValueType>> _sections;
+        size_t _numChannels = 0;
+        std::vector<ValueType> _state; // for each section, the two state values of each channel
+    };
+} // namespace dsp
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace dsp
+{
+    namespace detail
+    {
+        // Finds the roots of the polynomial c[0]*z^n + c[1]*z^(n-1) + ... + c[n] with the Durand-Kerner method
+        inline std::vector<std::complex<double>> FindPolynomialRoots(std::vector<double> c)
+        {
+            while (!c.empty() && c.front() == 0)
+            {
+                c.erase(c.begin());
+            }
+            if (c.size() < 2)
+            {
+                return {};
+            }
+
+            const auto degree = c.size() - 1;
+            const auto leading = c.front();
+            for (auto& coefficient : c)
+            {
+                coefficient /= leading;
+            }
+
+            auto evaluate = [&c](std::complex<double> z) {
+                std::complex<double> result = 0;
+                for (auto coefficient : c)
+                {
+                    result = result * z + coefficient;
+                }
+                return result;
+            };
+
+            std::vector<std::complex<double>> roots(degree);
+            const std::complex<double> seed = { 0.4, 0.9 };
+            for (size_t index = 0; index < degree; ++index)
+            {
+                roots[index] = std::pow(seed, static_cast<double>(index));
+            }
+
+            for (int iteration = 0; iteration < 1000; ++iteration)
+            {
+                double maxChange = 0;
+                for (size_t index = 0; index < degree; ++index)
+                {
+                    std::complex<double> denominator = 1;
+                    for (size_t other = 0; other < degree; ++other)
+                    {
+                        if (other != index)
+                        {
+                            denominator *= roots[index] - roots[other];
+                        }
+                    }
+                    const auto change = evaluate(roots[index]) / denominator;
+                    roots[index] -= change;
+                    maxChange = std::max(maxChange, std::abs(change));
+                }
+                if (maxChange < 1e-14)
+                {
+                    break;
+                }
+            }
+            return roots;
+        }
+
+        // Orders the roots so that each complex root is followed by its conjugate, and the real roots come last
+        inline std::vector<std::complex<double>> PairConjugateRoots(std::vector<std::complex<double>> roots, size_t numRoots)
+        {
+            const double tolerance = 1e-8;
+            roots.resize(std::max(roots.size(), numRoots), 0.0);
+
+            std::vector<std::complex<double>> result;
+            std::vector<std::complex<double>> realRoots;
+            std::vector<bool> used(roots.size(), false);
+            for (size_t index = 0; index < roots.size(); ++index)
+            {
+                if (used[index])
+                {
+                    continue;
+                }
+                used[index] = true;
+                if (std::abs(roots[index].imag()) <= tolerance * std::max(1.0, std::abs(roots[index])))
+                {
+                    realRoots.push_back(roots[index].real());
+                    continue;
+                }
+
+                // Find the closest unused root to the conjugate
+                size_t best = index;
+                double bestDistance = 0;
+                for (size_t other = index + 1; other < roots.size(); ++other)
+                {
+                    const auto distance = std::abs(roots[other] - std::conj(roots[index]));
+                    if (!used[other] && (best == index || distance < bestDistance))
+                    {
+                        best = other;
+                        bestDistance = distance;
+                    }
+                }
+                if (best == index)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Filter has a complex root with no conjugate");
+                }
+                used[best] = true;
+                result.push_back(roots[index]);
+                result.push_back(std::conj(roots[index]));
+            }
+
+            result.insert(result.end(), realRoots.begin(), realRoots.end());
+            if (result.size() % 2 != 0)
+            {
+                result.push_back(0.0);
+            }
+            return result;
+        }
+    } // namespace detail
+
+    template <typename ValueType>
+    std::vector<BiquadCoefficients<ValueType>> GetSecondOrderSections(const std::vector<ValueType>& b, const std::vector<ValueType>& a)
+    {
+        if (b.empty() || b[0] == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "GetSecondOrderSections: the filter must have a nonzero b0 coefficient");
+        }
+
+        // With a0 == 1 and b0 factored out, H(z) = b0 * prod(1 - z_i/z) / prod(1 - p_i/z), where z_i and p_i are the
+        // roots of the polynomials in z. Missing roots are at the origin, and contribute a factor of 1.
+        std::vector<double> zeroPolynomial(b.begin(), b.end());
+        std::vector<double> polePolynomial = { 1.0 };
+        polePolynomial.insert(polePolynomial.end(), a.begin(), a.end());
+        const auto order = std::max(zeroPolynomial.size(), polePolynomial.size()) - 1;
+        auto zeros = detail::PairConjugateRoots(detail::FindPolynomialRoots(zeroPolynomial), order);
+        auto poles = detail::PairConjugateRoots(detail::FindPolynomialRoots(polePolynomial), order);
+        zeros.resize(std::max(zeros.size(), poles.size()), 0.0);
+        poles.resize(zeros.size(), 0.0);
+
+        std::vector<BiquadCoefficients<ValueType>> result;
+        for (size_t index = 0; index < zeros.size(); index += 2)
+        {
+            // (1 - r1/z)(1 - r2/z) = 1 - (r1 + r2)/z + r1*r2/z^2
+            const double gain = index == 0 ? static_cast<double>(b[0]) : 1.0;
+            BiquadCoefficients<ValueType> section;
+            section.b0 = static_cast<ValueType>(gain);
+            section.b1 = static_cast<ValueType>(-gain * (zeros[index] + zeros[index + 1]).real());
+            section.b2 = static_cast<ValueType>(gain * (zeros[index] * zeros[index + 1]).real());
+            section.a1 = static_cast<ValueType>(-(poles[index] + poles[index + 1]).real());
+            section.a2 = static_cast<ValueType>((poles[index] * poles[index + 1]).real());
+            result.push_back(section);
+        }
+        if (result.empty())
+        {
+            BiquadCoefficients<ValueType> section;
+            section.b0 = b[0];
+            result.push_back(section);
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    BiquadFilter<ValueType>::BiquadFilter(const std::vector<BiquadCoefficients<ValueType>>& sections, size_t numChannels) :
+        _sections(sections),
+        _numChannels(numChannels)
+    {
+        Reset();
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> BiquadFilter<ValueType>::FilterSamples(const std::vector<ValueType>& x)
+    {
+        if (_numChannels == 0 || x.size() % _numChannels != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "BiquadFilter: input must be a whole number of frames");
+        }
+
+        std::vector<ValueType> result(x);
+        const auto numFrames = x.size() / _numChannels;
+        for (size_t sectionIndex = 0; sectionIndex < _sections.size(); ++sectionIndex)
+        {
+            const auto& section = _sections[sectionIndex];
+            auto s1 = _state.data() + (2 * sectionIndex * _numChannels);
+            auto s2 = s1 + _numChannels;
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                auto samples = result.data() + (frame * _numChannels);
+                for (size_t channel = 0; channel < _numChannels; ++channel)
+                {
+                    const auto in = samples[channel];
+                    const auto out = section.b0 * in + s1[channel];
+                    s1[channel] = section.b1 * in - section.a1 * out + s2[channel];
+                    s2[channel] = section.b2 * in - section.a2 * out;
+                    samples[channel] = out;
+                }
+            }
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    void BiquadFilter<ValueType>::Reset()
+    {
+        _state.assign(2 * _sections.size() * _numChannels, 0);
+    }
+
+    template <typename ValueType>
+    void BiquadFilter<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        std::vector<ValueType> coefficients;
+        for (const auto& section : _sections)
+        {
+            coefficients.insert(coefficients.end(), { section.b0, section.b1, section.b2, section.a1, section.a2 });
+        }
+        archiver["coefficients"] << coefficients;
+        archiver["numChannels"] << _numChannels;
+    }
+
+    template <typename ValueType>
+    void BiquadFilter<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        std::vector<ValueType> coefficients;
+        archiver["coefficients"] >> coefficients;
+        archiver["numChannels"] >> _numChannels;
+        _sections.clear();
+        for (size_t index = 0; index + 5 <= coefficients.size(); index += 5)
+        {
+            _sections.push_back({ coefficients[index], coefficients[index + 1], coefficients[index + 2], coefficients[index + 3], coefficients[index + 4] });
+        }
+        Reset();
+    }
+} // namespace dsp
+} // namespace ell
+
+#pragma endregion implementation
@@ -28,7 +28,7 @@ namespace dsp
     // NOTE: these functions all compute "valid" convolutions. So the output size = input size - filter size + 1
 
     /// <summary> The method to use for performing convolutions. </summary>
-    /// Note: the values for these enums should be kept in sync with the values of `ConvolutionalLayer::ConvolutionMethod`
+    /// Note: the values up to `unrolled` should be kept in sync with the values of `ConvolutionalLayer::ConvolutionMethod`
     enum class ConvolutionMethodOption : int
     {
         /// <summary> Allow the function to choose the algorithm to use. </summary>
@@ -41,6 +41,8 @@ namespace dsp
         winograd,
         /// <summary> Normal method of doing convolution via reshaping input into columns and performing a gemm operation. </summary>
         unrolled,
+        /// <summary> Multiplies the spectra of the input and the filters, which is faster for long filters. 1D convolutions use overlap-save blocks. </summary>
+        fft,
     };
 
     /// <summary> Convolve a 1D input with a 1D filter. </summary>
@@ -53,6 +55,15 @@ namespace dsp
     template <typename ValueType>
     math::RowVector<ValueType> Convolve1D(const math::RowVector<ValueType>& input, const math::RowVector<ValueType>& filter, ConvolutionMethodOption method = ConvolutionMethodOption::automatic);
 
+    /// <summary> Convolve a 1D input with a 1D filter, writing the result into existing storage. </summary>
+    ///
+    /// <param name="input"> The input. </param>
+    /// <param name="filter"> The filter to convolve the input with. </param>
+    /// <param name="result"> A vector to store the result in. Must be of length `input.Size() - filter.Size() + 1`. </param>
+    /// <param name="method"> The convolution algorithm to use. The `simple` and `fft` methods write into `result` directly, and the others copy their result into it. </param>
+    template <typename ValueType>
+    void Convolve1D(math::ConstRowVectorReference<ValueType> input, const math::RowVector<ValueType>& filter, math::RowVectorReference<ValueType> result, ConvolutionMethodOption method = ConvolutionMethodOption::automatic);
+
     /// <summary> Spatially (in 2D) convolve a 3D image with a stack of 3D filters. </summary>
     ///
     /// <param name="input"> The input image: a (r x c x d) tensor. </param>
@@ -76,6 +87,17 @@ namespace dsp
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> Convolve2D(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride, ConvolutionMethodOption method = ConvolutionMethodOption::automatic);
 
+    /// <summary> Spatially (in 2D) convolve a 3D image with a stack of 3D filters, writing the result into existing storage. </summary>
+    ///
+    /// <param name="input"> The input image: a (r x c x d) tensor. </param>
+    /// <param name="filters"> The filters to convolve with. A (nf x fr x fc x d) tensor, reshaped as a ((nf*fr) x fc x d) 3D tensor. </param>
+    /// <param name="numFilters"> The number of filters in the `filters` argument. </param>
+    /// <param name="stride"> The number of elements to move/jump when sliding over the input. Typically this is 1 to 3. </param>
+    /// <param name="result"> The tensor to write the result into. </param>
+    /// <param name="method"> The convolution algorithm to use. The `simple` and `fft` methods write into `result` directly, and the others copy their result into it. </param>
+    template <typename ValueType>
+    void Convolve2D(math::ConstChannelColumnRowTensorReference<ValueType> input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<ValueType> result, ConvolutionMethodOption method = ConvolutionMethodOption::automatic);
+
     /// <summary> Convolve a set of 2D images with a corresponding set of 2D filters. </summary>
     ///
     /// <param name="input"> The input image: a (r x c x d) tensor. </param>
@@ -103,12 +125,18 @@ namespace dsp
     extern template math::RowVector<float> Convolve1D(const math::RowVector<float>& input, const math::RowVector<float>& filter, ConvolutionMethodOption method);
     extern template math::RowVector<double> Convolve1D(const math::RowVector<double>& input, const math::RowVector<double>& filter, ConvolutionMethodOption method);
 
+    extern template void Convolve1D(math::ConstRowVectorReference<float> input, const math::RowVector<float>& filter, math::RowVectorReference<float> result, ConvolutionMethodOption method);
+    extern template void Convolve1D(math::ConstRowVectorReference<double> input, const math::RowVector<double>& filter, math::RowVectorReference<double> result, ConvolutionMethodOption method);
+
     extern template math::ChannelColumnRowTensor<float> Convolve2D(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, ConvolutionMethodOption method);
     extern template math::ChannelColumnRowTensor<double> Convolve2D(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, ConvolutionMethodOption method);
 
     extern template math::ChannelColumnRowTensor<float> Convolve2D(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int stride, ConvolutionMethodOption method);
     extern template math::ChannelColumnRowTensor<double> Convolve2D(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int stride, ConvolutionMethodOption method);
 
+    extern template void Convolve2D(math::ConstChannelColumnRowTensorReference<float> input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<float> result, ConvolutionMethodOption method);
+    extern template void Convolve2D(math::ConstChannelColumnRowTensorReference<double> input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<double> result, ConvolutionMethodOption method);
+
     extern template math::ChannelColumnRowTensor<float> Convolve2DDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, ConvolutionMethodOption method);
     extern template math::ChannelColumnRowTensor<double> Convolve2DDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, ConvolutionMethodOption method);
 
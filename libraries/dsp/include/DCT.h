@@ -6,6 +6,10 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#pragma once
+
+#include "FFT.h"
+
 #include <math/include/MathConstants.h>
 #include <math/include/Matrix.h>
 #include <math/include/MatrixOperations.h>
@@ -14,6 +18,7 @@
 #include <utilities/include/Exception.h>
 
 #include <cmath>
+#include <complex>
 #include <vector>
 
 namespace ell
@@ -22,13 +27,13 @@ namespace dsp
 {
     /// <summary> Compute the discrete cosine transform (DCT-II) coefficient matrix for a given size DCT. </summary>
     ///
-    /// <param name="numFilters"> The number of DCT filters to generate --- the output dimension of a signal processed by this filter matrix. </param>
     /// <param name="windowSize"> The size of the signal to be processed. </param>
+    /// <param name="numFilters"> The number of DCT filters to generate --- the output dimension of a signal processed by this filter matrix. </param>
     /// <param name="normalize"> A flag indicating if the resulting DCT matrix should be orthonormal. </param>
     ///
-    /// <returns> The coefficient matrix to multiply by the signal vector. </returns>
+    /// <returns> The (numFilters x windowSize) coefficient matrix to multiply by the signal vector. </returns>
     template <typename ValueType>
-    math::RowMatrix<ValueType> GetDCTMatrix(size_t numFilters, size_t windowSize, bool normalize = false);
+    math::RowMatrix<ValueType> GetDCTMatrix(size_t windowSize, size_t numFilters, bool normalize = false);
 
     /// <summary> Compute the discrete cosine transform (DCT-II) of a vector of values, with an existing coefficient matrix. </summary>
     ///
@@ -43,11 +48,68 @@ namespace dsp
     /// <summary> Compute the discrete cosine transform (DCT-II) of a vector of values. </summary>
     ///
     /// <param name="signal"> The vector to compute the DCT of. </param>
+    /// <param name="numFilters"> The number of DCT coefficients to compute. </param>
     /// <param name="normalize"> A flag indicating if the resulting DCT matrix should be orthonormal. </param>
     ///
-    /// <returns> The DCT of the input signal. </returns>
+    /// <returns> The first `numFilters` DCT coefficients of the input signal. </returns>
+    template <typename ValueType>
+    math::ColumnVector<ValueType> DCT(math::ConstColumnVectorReference<ValueType> signal, size_t numFilters, bool normalize = false);
+
+    /// <summary>
+    /// A precomputed plan for the (unnormalized) discrete cosine transform (DCT-II) of signals of a fixed power-of-2
+    /// size, computed with an FFT of the same size (Makhoul's algorithm). The signal is reordered into
+    /// v[n] = x[2n], v[N-1-n] = x[2n+1], and then X[k] = Re(e^(i*pi*k/2N) * V[k]), where V is the FFT of v. Only the
+    /// first `numFilters` coefficients are computed.
+    /// </summary>
     template <typename ValueType>
-    math::ColumnVector<ValueType> DCT(math::ConstColumnVectorReference<ValueType> signal, bool normalize = false);
+    class DCTPlan
+    {
+    public:
+        using ComplexType = std::complex<ValueType>;
+
+        /// <summary> Default constructor: a plan for a DCT of size 0. </summary>
+        DCTPlan() = default;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="windowSize"> The size of the signal to be processed. Must be a power of 2. </param>
+        /// <param name="numFilters"> The number of DCT coefficients to compute. Must not be larger than the window size. </param>
+        DCTPlan(size_t windowSize, size_t numFilters);
+
+        /// <summary> Gets the size of the signal to be processed. </summary>
+        size_t GetWindowSize() const { return _fftPlan.Size(); }
+
+        /// <summary> Gets the number of DCT coefficients computed. </summary>
+        size_t GetNumFilters() const { return _twiddles.size(); }
+
+        /// <summary> Gets the plan of the FFT of the reordered signal. </summary>
+        const FFTPlan<ValueType>& GetFFTPlan() const { return _fftPlan; }
+
+        /// <summary> Gets the twiddle factors, e^(i*pi*k/2N) for k in [0, numFilters). </summary>
+        const std::vector<ComplexType>& GetTwiddleFactors() const { return _twiddles; }
+
+        /// <summary> Compute the DCT of a signal. </summary>
+        ///
+        /// <param name="signal"> Pointer to the `GetWindowSize()` entries of the signal to process. </param>
+        /// <param name="output"> Pointer to the `GetNumFilters()` entries of the result. </param>
+        void Transform(const ValueType* signal, ValueType* output) const;
+
+    private:
+        FFTPlan<ValueType> _fftPlan;
+        std::vector<ComplexType> _twiddles;
+    };
+
+    /// <summary>
+    /// Indicates if a `DCTPlan` is expected to be faster than multiplying by the DCT matrix. The FFT costs about
+    /// N * (log2(N) + 6) operations regardless of the number of coefficients, so the matrix, whose product is
+    /// well-vectorized, is preferred for non-power-of-2 sizes and for small numbers of coefficients.
+    /// </summary>
+    ///
+    /// <param name="windowSize"> The size of the signal to be processed. </param>
+    /// <param name="numFilters"> The number of DCT coefficients to compute. </param>
+    ///
+    /// <returns> true if the FFT-based DCT should be used. </returns>
+    inline bool IsFastDCTPreferred(size_t windowSize, size_t numFilters);
 } // namespace dsp
 } // namespace ell
 
@@ -95,7 +157,7 @@ namespace dsp
     template <typename ValueType>
     math::ColumnVector<ValueType> DCT(math::ConstRowMatrixReference<ValueType> dctMatrix, math::ConstColumnVectorReference<ValueType> signal, bool normalize)
     {
-        math::ColumnVector<ValueType> result(signal.Size());
+        math::ColumnVector<ValueType> result(dctMatrix.NumRows());
         if (normalize)
         {
             throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
@@ -124,6 +186,70 @@ namespace dsp
         return result;
     }
 
+    //
+    // DCTPlan
+    //
+    template <typename ValueType>
+    DCTPlan<ValueType>::DCTPlan(size_t windowSize, size_t numFilters) :
+        _fftPlan(windowSize)
+    {
+        if (numFilters > windowSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "DCT can't have more coefficients than the window size");
+        }
+
+        const double pi = math::Constants<double>::pi;
+        _twiddles.resize(numFilters);
+        for (size_t k = 0; k < numFilters; ++k)
+        {
+            // FFTPlan uses the e^(+2*pi*i*k/N) convention, so the twiddle factors are conjugated from the usual ones
+            const double angle = pi * k / (2 * windowSize);
+            _twiddles[k] = { static_cast<ValueType>(std::cos(angle)), static_cast<ValueType>(std::sin(angle)) };
+        }
+    }
+
+    template <typename ValueType>
+    void DCTPlan<ValueType>::Transform(const ValueType* signal, ValueType* output) const
+    {
+        const auto windowSize = GetWindowSize();
+        std::vector<ValueType> reordered(windowSize);
+        for (size_t n = 0; 2 * n < windowSize; ++n)
+        {
+            reordered[n] = signal[2 * n];
+        }
+        for (size_t n = 0; 2 * n + 1 < windowSize; ++n)
+        {
+            reordered[windowSize - 1 - n] = signal[2 * n + 1];
+        }
+
+        std::vector<ComplexType> spectrum(windowSize / 2 + 1);
+        _fftPlan.TransformReal(reordered.data(), spectrum.data());
+
+        // The spectrum of the (real-valued) reordered signal is conjugate-symmetric: V[N-k] == conj(V[k])
+        const auto numFilters = GetNumFilters();
+        for (size_t k = 0; k < numFilters; ++k)
+        {
+            const auto v = k <= windowSize / 2 ? spectrum[k] : std::conj(spectrum[windowSize - k]);
+            output[k] = (_twiddles[k] * v).real();
+        }
+    }
+
+    inline bool IsFastDCTPreferred(size_t windowSize, size_t numFilters)
+    {
+        if (!detail::IsPowerOf2(windowSize))
+        {
+            return false;
+        }
+
+        // The FFT costs about N * (log2(N) + 6) operations and a matrix product N * numFilters, and the matrix gets
+        // a factor of 2 for its better vectorization
+        size_t log2Size = 0;
+        while ((size_t{ 1 } << log2Size) < windowSize)
+        {
+            ++log2Size;
+        }
+        return numFilters >= 2 * (log2Size + 6);
+    }
 } // end namespace dsp
 } // namespace ell
 
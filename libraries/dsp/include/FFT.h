@@ -6,10 +6,12 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#pragma once
+
 #include <math/include/MathConstants.h>
 #include <math/include/Vector.h>
 
-#include <utilities/include/Unused.h>
+#include <utilities/include/Exception.h>
 
 #include <complex>
 #include <vector>
@@ -18,10 +20,65 @@ namespace ell
 {
 namespace dsp
 {
+    /// <summary>
+    /// A precomputed plan for discrete ("fast") fourier transforms (FFTs) of a fixed power-of-2 size. The plan holds the
+    /// twiddle factors and bit-reversal permutation tables, so applying it does no trigonometry and no allocation.
+    /// The transform is an iterative, in-place radix-2 transform whose first two stages are done together as radix-4
+    /// butterflies, which need no multiplications. Real-valued signals are transformed by packing them into a complex
+    /// signal of half the size.
+    /// </summary>
+    template <typename ValueType>
+    class FFTPlan
+    {
+    public:
+        using ComplexType = std::complex<ValueType>;
+
+        /// <summary> Default constructor: a plan for an FFT of size 0. </summary>
+        FFTPlan() = default;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="size"> The FFT size. Must be a power of 2. </param>
+        FFTPlan(size_t size);
+
+        /// <summary> Gets the FFT size. </summary>
+        size_t Size() const { return _size; }
+
+        /// <summary> Perform an in-place FFT of a complex-valued signal. </summary>
+        ///
+        /// <param name="signal"> Pointer to the `Size()` entries of the signal to process. </param>
+        void Transform(ComplexType* signal) const;
+
+        /// <summary>
+        /// Perform an FFT of a real-valued signal. The FFT of a real-valued signal is conjugate-symmetric, so only the
+        /// first (N/2)+1 entries are computed.
+        /// </summary>
+        ///
+        /// <param name="signal"> Pointer to the `Size()` entries of the signal to process. </param>
+        /// <param name="output"> Pointer to the (Size() / 2) + 1 entries of the result. </param>
+        void TransformReal(const ValueType* signal, ComplexType* output) const;
+
+        /// <summary> Gets the twiddle factors, w^k = e^(2*pi*i*k/N) for k in [0, N/2). </summary>
+        const std::vector<ComplexType>& GetTwiddleFactors() const { return _twiddles; }
+
+        /// <summary> Gets the bit-reversal permutation for a complex FFT of size `size`, which must be `Size()` or `Size() / 2`. </summary>
+        const std::vector<int>& GetBitReversalPermutation(size_t size) const { return size == _size ? _bitReversal : _halfBitReversal; }
+
+    private:
+        void TransformComplex(ComplexType* signal, size_t size, const std::vector<int>& bitReversal, size_t twiddleStride) const;
+
+        size_t _size = 0;
+        std::vector<ComplexType> _twiddles;
+        std::vector<int> _bitReversal;
+        std::vector<int> _halfBitReversal;
+    };
+
     /// <summary> Perform an in-place discrete ("fast") fourier transform (FFT) of a complex-valued input signal. </summary>
     ///
     /// <param name="signal"> The signal vector to process. Must be a power of 2 in length. </param>
     /// <param name="inverse"> A flag indicating if the inverse FFT should be computed instead. </param>
+    ///
+    /// <remarks> This creates a new `FFTPlan` on every call. Use an `FFTPlan` directly to transform many signals of the same size. </remarks>
     template <typename ValueType>
     void FFT(std::vector<std::complex<ValueType>>& signal, bool inverse = false);
 
@@ -59,145 +116,216 @@ namespace dsp
 {
     namespace detail
     {
-        template <typename Iterator>
-        void Deinterleave(Iterator begin, Iterator end, Iterator scratch)
+        inline bool IsPowerOf2(size_t size)
+        {
+            return size != 0 && (size & (size - 1)) == 0;
+        }
+
+        inline std::vector<int> GetBitReversalPermutation(size_t size)
         {
-            const auto size = end - begin;
-            const auto halfN = size / 2;
-            for (int index = 0; index < halfN; ++index)
+            std::vector<int> result(size, 0);
+            int numBits = 0;
+            while ((size_t{ 1 } << numBits) < size)
             {
-                scratch[index] = begin[2 * index + 1];
-                begin[index] = begin[2 * index];
+                ++numBits;
             }
-            for (int index = 0; index < halfN; ++index)
+            for (size_t index = 0; index < size; ++index)
             {
-                begin[index + halfN] = scratch[index];
+                int reversed = 0;
+                for (int bit = 0; bit < numBits; ++bit)
+                {
+                    reversed |= ((index >> bit) & 1) << (numBits - 1 - bit);
+                }
+                result[index] = reversed;
             }
+            return result;
         }
 
-        template <typename Iterator>
-        void FFT(Iterator begin, Iterator end, Iterator scratch, bool inverse)
+        template <typename ValueType>
+        void MagnitudesFromHalfSpectrum(const std::vector<std::complex<ValueType>>& halfSpectrum, size_t size, ValueType* output)
         {
-            if (inverse)
+            // The spectrum of a real-valued signal is conjugate-symmetric: |X[N-k]| == |X[k]|
+            for (size_t index = 0; index < size; ++index)
             {
-                throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+                output[index] = std::abs(halfSpectrum[index <= size / 2 ? index : size - index]);
             }
-            using ValueType = typename Iterator::value_type::value_type;
-            const ValueType pi = math::Constants<ValueType>::pi;
+        }
+    } // namespace detail
 
-            auto halfN = (end - begin) / 2;
-            if (halfN < 1)
-            {
-                return; // done
-            }
+    //
+    // FFTPlan
+    //
+    template <typename ValueType>
+    FFTPlan<ValueType>::FFTPlan(size_t size) :
+        _size(size)
+    {
+        if (!detail::IsPowerOf2(size))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FFT size must be a power of 2");
+        }
 
-            Deinterleave(begin, end, scratch);
-            auto evens = begin;
-            auto odds = begin + halfN;
+        // Compute the twiddle factors in double precision, so they're as accurate as possible for float FFTs
+        const double pi = math::Constants<double>::pi;
+        _twiddles.resize(size / 2);
+        for (size_t k = 0; k < size / 2; ++k)
+        {
+            const double angle = 2 * pi * k / size;
+            _twiddles[k] = { static_cast<ValueType>(std::cos(angle)), static_cast<ValueType>(std::sin(angle)) };
+        }
 
-            if (halfN > 1)
-            {
-                FFT(evens, evens + halfN, scratch, inverse);
-                FFT(odds, odds + halfN, scratch, inverse);
-            }
+        _bitReversal = detail::GetBitReversalPermutation(size);
+        _halfBitReversal = detail::GetBitReversalPermutation(size > 1 ? size / 2 : 1);
+    }
 
-            for (int k = 0; k < halfN; k++)
+    template <typename ValueType>
+    void FFTPlan<ValueType>::TransformComplex(ComplexType* signal, size_t size, const std::vector<int>& bitReversal, size_t twiddleStride) const
+    {
+        for (size_t index = 0; index < size; ++index)
+        {
+            const auto reversed = static_cast<size_t>(bitReversal[index]);
+            if (index < reversed)
             {
-                // w = e^(2*pi*k/N)
-                std::complex<ValueType> w = std::exp(std::complex<ValueType>(0, pi * k / halfN));
-                auto e = evens[k];
-                auto o = odds[k];
-                auto wo = w * o;
-                evens[k] = e + wo; // even
-                odds[k] = e - wo; // odd
+                std::swap(signal[index], signal[reversed]);
             }
         }
 
-        template <typename Iterator, typename ComplexIterator>
-        void FFTReal(Iterator begin, Iterator end, Iterator scratch, ComplexIterator outputBegin, ComplexIterator outputEnd, bool inverse)
+        if (size < 4)
         {
-            UNUSED(outputEnd);
-            if (inverse)
-            {
-                throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "inverse must be false");
-            }
-
-            using ValueType = typename Iterator::value_type;
-            const ValueType pi = math::Constants<ValueType>::pi;
-
-            auto halfN = (end - begin) / 2;
-            if (halfN < 1)
+            if (size == 2)
             {
-                return; // done
+                const auto x0 = signal[0];
+                const auto x1 = signal[1];
+                signal[0] = x0 + x1;
+                signal[1] = x0 - x1;
             }
+            return;
+        }
 
-            Deinterleave(begin, end, scratch);
-
-            auto evens = begin;
-            auto odds = begin + halfN;
-            auto complexEvens = outputBegin;
-            auto complexOdds = outputBegin + halfN;
+        // The first two radix-2 stages together: with twiddle factors 1 and i, they need no multiplications
+        for (size_t index = 0; index < size; index += 4)
+        {
+            const auto x0 = signal[index];
+            const auto x1 = signal[index + 1];
+            const auto x2 = signal[index + 2];
+            const auto x3 = signal[index + 3];
+            const auto sum01 = x0 + x1;
+            const auto diff01 = x0 - x1;
+            const auto sum23 = x2 + x3;
+            const auto diff23 = x2 - x3;
+            const ComplexType iDiff23 = { -diff23.imag(), diff23.real() };
+            signal[index] = sum01 + sum23;
+            signal[index + 1] = diff01 + iDiff23;
+            signal[index + 2] = sum01 - sum23;
+            signal[index + 3] = diff01 - iDiff23;
+        }
 
-            if (halfN > 1)
-            {
-                FFTReal(evens, evens + halfN, scratch, complexEvens, complexEvens + halfN, inverse);
-                FFTReal(odds, odds + halfN, scratch, complexOdds, complexOdds + halfN, inverse);
-            }
-            else
+        // The remaining radix-2 stages
+        for (size_t length = 8; length <= size; length *= 2)
+        {
+            const auto halfLength = length / 2;
+            const auto stride = twiddleStride * (size / length);
+            for (size_t begin = 0; begin < size; begin += length)
             {
-                // Base case: copy from real to complex
-                for (int index = 0; index < halfN; ++index)
+                auto evens = signal + begin;
+                auto odds = evens + halfLength;
+                for (size_t k = 0; k < halfLength; ++k)
                 {
-                    complexEvens[index] = evens[index];
-                    complexOdds[index] = odds[index];
+                    const auto wo = _twiddles[k * stride] * odds[k];
+                    const auto e = evens[k];
+                    evens[k] = e + wo;
+                    odds[k] = e - wo;
                 }
             }
+        }
+    }
 
-            for (int k = 0; k < halfN; k++)
+    template <typename ValueType>
+    void FFTPlan<ValueType>::Transform(ComplexType* signal) const
+    {
+        TransformComplex(signal, _size, _bitReversal, 1);
+    }
+
+    template <typename ValueType>
+    void FFTPlan<ValueType>::TransformReal(const ValueType* signal, ComplexType* output) const
+    {
+        if (_size < 2)
+        {
+            if (_size == 1)
             {
-                // w = e^(2*pi*k/N)
-                std::complex<ValueType> w = std::exp(std::complex<ValueType>(0, pi * k / halfN));
-                auto e = complexEvens[k];
-                auto o = complexOdds[k];
-                auto wo = w * o;
-                complexEvens[k] = e + wo; // even
-                complexOdds[k] = e - wo; // odd
+                output[0] = signal[0];
             }
+            return;
         }
-    } // namespace detail
 
+        // Pack the even and odd entries into the real and imaginary parts of a complex signal z of half the size, and
+        // transform it in place in the output buffer
+        const auto halfSize = _size / 2;
+        for (size_t index = 0; index < halfSize; ++index)
+        {
+            output[index] = { signal[2 * index], signal[2 * index + 1] };
+        }
+        TransformComplex(output, halfSize, _halfBitReversal, 2);
+
+        // Separate the transforms of the evens (E) and odds (O), then combine them: X[k] = E[k] + w^k * O[k], where
+        //   E[k] = (Z[k] + conj(Z[N/2-k])) / 2
+        //   O[k] = (Z[k] - conj(Z[N/2-k])) / 2i
+        // X[N/2-k] = conj(E[k] - w^k * O[k]), so entries k and N/2-k are computed together
+        const auto z0 = output[0];
+        output[0] = z0.real() + z0.imag();
+        output[halfSize] = z0.real() - z0.imag();
+        for (size_t k = 1; k <= halfSize / 2; ++k)
+        {
+            const auto zk = output[k];
+            const auto zConj = std::conj(output[halfSize - k]);
+            const auto e = (zk + zConj) * ValueType{ 0.5 };
+            const auto d = (zk - zConj) * ValueType{ 0.5 };
+            const ComplexType o = { d.imag(), -d.real() }; // d / i
+            const auto wo = _twiddles[k] * o;
+            output[k] = e + wo;
+            output[halfSize - k] = std::conj(e - wo);
+        }
+    }
+
+    //
+    // FFT functions
+    //
     template <typename ValueType>
     void FFT(std::vector<std::complex<ValueType>>& input, bool inverse)
     {
-        std::vector<std::complex<ValueType>> scratch(input.size() / 2);
-        detail::FFT(std::begin(input), std::end(input), std::begin(scratch), inverse);
+        if (inverse)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+        }
+        FFTPlan<ValueType> plan(input.size());
+        plan.Transform(input.data());
     }
 
     template <typename ValueType>
     void FFT(std::vector<ValueType>& input, bool inverse)
     {
-        auto size = input.size();
-        std::vector<ValueType> scratch(size / 2);
-        std::vector<std::complex<ValueType>> output(size);
-        detail::FFTReal(std::begin(input), std::end(input), std::begin(scratch), std::begin(output), std::end(output), inverse);
-        for (size_t index = 0; index < size; ++index)
+        if (inverse)
         {
-            input[index] = std::abs(output[index]);
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "inverse must be false");
         }
+        auto size = input.size();
+        FFTPlan<ValueType> plan(size);
+        std::vector<std::complex<ValueType>> output(size / 2 + 1);
+        plan.TransformReal(input.data(), output.data());
+        detail::MagnitudesFromHalfSpectrum(output, size, input.data());
     }
 
     template <typename ValueType>
     void FFT(math::RowVector<ValueType>& input, bool inverse)
     {
-        using std::begin;
-        auto size = input.Size();
-        math::RowVector<ValueType> scratch(size / 2);
-        std::vector<std::complex<ValueType>> output(size);
-        detail::FFTReal(begin(input), end(input), begin(scratch), begin(output), end(output), inverse);
-        for (size_t index = 0; index < size; ++index)
+        if (inverse)
         {
-            input[index] = std::abs(output[index]);
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "inverse must be false");
         }
+        auto size = input.Size();
+        FFTPlan<ValueType> plan(size);
+        std::vector<std::complex<ValueType>> output(size / 2 + 1);
+        plan.TransformReal(input.GetDataPointer(), output.data());
+        detail::MagnitudesFromHalfSpectrum(output, size, input.GetDataPointer());
     }
 } // namespace dsp
 } // namespace ell
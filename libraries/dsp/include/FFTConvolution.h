@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FFTConvolution.h (dsp)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FFT.h"
+
+#include <math/include/Tensor.h>
+#include <math/include/Vector.h>
+
+#include <complex>
+#include <vector>
+
+namespace ell
+{
+namespace dsp
+{
+    /// <summary>
+    /// A 1D convolution with a fixed filter, computed with overlap-save FFT blocks. The filter's spectrum is computed
+    /// when the convolution is created, so convolving a signal only transforms the signal. Each block of `GetFFTSize()`
+    /// input entries produces `GetBlockSize()` outputs, and two blocks are transformed at a time, as the real and
+    /// imaginary parts of one complex FFT. Long signals are split among the host threads.
+    /// </summary>
+    template <typename ValueType>
+    class FFTConvolution1D
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="filter"> The filter to convolve with. </param>
+        /// <param name="fftSize"> The FFT size, a power of 2 no smaller than the filter, or 0 to choose one from the filter size. </param>
+        FFTConvolution1D(const math::RowVector<ValueType>& filter, size_t fftSize = 0);
+
+        /// <summary> Gets the size of the filter. </summary>
+        size_t GetFilterSize() const { return _filterSize; }
+
+        /// <summary> Gets the size of the FFTs. </summary>
+        size_t GetFFTSize() const { return _plan.Size(); }
+
+        /// <summary> Gets the number of outputs computed from each FFT block. </summary>
+        size_t GetBlockSize() const { return _plan.Size() - _filterSize + 1; }
+
+        /// <summary> Convolve a 1D input with the filter. </summary>
+        ///
+        /// <param name="input"> The input signal. </param>
+        /// <param name="result"> A vector to store the result in. Its length must be at most `input.Size() - GetFilterSize() + 1`. </param>
+        void Convolve(math::ConstRowVectorReference<ValueType> input, math::RowVectorReference<ValueType> result) const;
+
+    private:
+        void ConvolveBlockPairs(math::ConstRowVectorReference<ValueType> input, math::RowVectorReference<ValueType> result, size_t beginPair, size_t endPair) const;
+
+        FFTPlan<ValueType> _plan;
+        size_t _filterSize = 0;
+
+        // The conjugate of the filter's spectrum, divided by the FFT size
+        std::vector<std::complex<ValueType>> _filterSpectrum;
+    };
+
+    /// <summary> Gets the FFT size that `Convolve1DFFT` uses. </summary>
+    ///
+    /// <param name="inputSize"> The size of the input signal. </param>
+    /// <param name="filterSize"> The size of the filter. </param>
+    ///
+    /// <returns> A power of 2 that is a few times the filter size, or just large enough for the whole input. </returns>
+    size_t GetFFTConvolutionSize(size_t inputSize, size_t filterSize);
+
+    /// <summary> Convolve a 1D input with a 1D filter, using overlap-save FFTs. </summary>
+    ///
+    /// <param name="input"> The input signal. </param>
+    /// <param name="filter"> The filter to convolve with. </param>
+    ///
+    /// <returns> A vector with the result of the convolution `input` (*) `filter`
+    template <typename ValueType>
+    math::RowVector<ValueType> Convolve1DFFT(const math::RowVector<ValueType>& input, const math::RowVector<ValueType>& filter);
+
+    /// <summary> Spatially convolve a 3D image with a stack of 3D filters, multiplying the spectra of the rows. </summary>
+    ///
+    /// <param name="input"> The input image: a (r x c x d) tensor. </param>
+    /// <param name="filters"> The filters to convolve with. A (nf x fr x fc x d) tensor, reshaped as a ((nf*fr) x fc x d) 3D tensor. </param>
+    /// <param name="numFilters"> The number of filters in the `filters` argument. </param>
+    /// <param name="stride"> The number of elements to move/jump when sliding over the input. Typically this is 1 to 3. </param>
+    ///
+    /// <returns> A tensor with the result of the convolution `input` (*) `filter`
+    template <typename ValueType>
+    math::ChannelColumnRowTensor<ValueType> Convolve2DFFT(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride);
+
+    //
+    // Versions that accept the result storage
+    //
+
+    /// <summary> Convolve a 1D input with a 1D filter, using overlap-save FFTs. </summary>
+    ///
+    /// <param name="input"> The input signal. </param>
+    /// <param name="filter"> The filter to convolve with. </param>
+    /// <param name="result"> A vector to store the result in. Its length must be at most `input.Size() - filter.Size() + 1`. </param>
+    template <typename ValueType>
+    void Convolve1DFFT(math::ConstRowVectorReference<ValueType> input, const math::RowVector<ValueType>& filter, math::RowVectorReference<ValueType> result);
+
+    /// <summary>
+    /// Spatially convolve a 3D image with a stack of 3D filters, multiplying the spectra of the rows. Every input row
+    /// and filter row is transformed once, and each output row is the inverse transform of a sum of their products.
+    /// The output rows of each filter are computed in tiles, on the host threads.
+    /// </summary>
+    ///
+    /// <param name="input"> The input image: a (r x c x d) tensor. </param>
+    /// <param name="filters"> The filters to convolve with. A (nf x fr x fc x d) tensor, reshaped as a ((nf*fr) x fc x d) 3D tensor. </param>
+    /// <param name="numFilters"> The number of filters in the `filters` argument. </param>
+    /// <param name="stride"> The number of elements to move/jump when sliding over the input. Typically this is 1 to 3. </param>
+    /// <param name="result"> The tensor to write the result into. </param>
+    template <typename ValueType>
+    void Convolve2DFFT(math::ConstChannelColumnRowTensorReference<ValueType> input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<ValueType> result);
+} // namespace dsp
+} // namespace ell
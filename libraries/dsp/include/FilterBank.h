@@ -75,6 +75,18 @@ namespace dsp
         double _offset;
     };
 
+    /// <summary>
+    /// The coefficients of a set of triangular filters, packed so that only each filter's nonzero support is stored.
+    /// The coefficients of filter `i` are in `values[offsets[i]]` through `values[offsets[i+1]-1]`, and apply to
+    /// the input bins starting at `startBins[i]`.
+    /// </summary>
+    struct PackedTriangleFilterCoefficients
+    {
+        std::vector<int> offsets; // number of filters + 1 entries
+        std::vector<int> startBins; // the first bin of each filter's support
+        std::vector<double> values;
+    };
+
     /// <summary> Base class for an arbitrary set of triangular filters. </summary>
     class TriangleFilterBank : public utilities::IArchivable
     {
@@ -131,6 +143,9 @@ namespace dsp
         /// <summary> Get the offset. </summary>
         double GetOffset() const { return _offset; }
 
+        /// <summary> Get the coefficients of the active filters, packed to their nonzero support. </summary>
+        const PackedTriangleFilterCoefficients& GetPackedCoefficients() const { return _coefficients; }
+
         /// <summary> Gets the name of this type. </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -170,7 +185,8 @@ namespace dsp
         size_t _beginFilter = 0; // index of first filter to use
         size_t _endFilter = 0; // index of last filter to use
         std::vector<size_t> _bins;
-        double _offset;
+        double _offset = 0;
+        PackedTriangleFilterCoefficients _coefficients;
     };
 
     /// <summary> A set of linearly-spaced triangular filters. </summary>
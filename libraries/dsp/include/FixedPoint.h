@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FixedPoint.h (dsp)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace dsp
+{
+    /// <summary> The number of fractional bits of a Q15 value: a Q15 value `q` represents `q / 2^15`. </summary>
+    constexpr int q15FractionalBits = 15;
+
+    /// <summary> The number of fractional bits of a Q31 value: a Q31 value `q` represents `q / 2^31`. </summary>
+    constexpr int q31FractionalBits = 31;
+
+    /// <summary> The range of Q15 values. Q15 values are stored in 32-bit integers, so intermediate results have headroom. </summary>
+    constexpr int32_t q15Min = -32768;
+    constexpr int32_t q15Max = 32767;
+
+    /// <summary> Converts a value in [-1, 1) to Q15, rounding to nearest and saturating values out of range. </summary>
+    int32_t ToQ15(double value);
+
+    /// <summary> Converts a Q15 value to floating point. </summary>
+    double FromQ15(int32_t value);
+
+    /// <summary> Converts a value in [-1, 1) to Q31, rounding to nearest and saturating values out of range. </summary>
+    int32_t ToQ31(double value);
+
+    /// <summary> Converts a Q31 value to floating point. </summary>
+    double FromQ31(int32_t value);
+
+    /// <summary> Clamps a value to the Q15 range. </summary>
+    int32_t SaturateQ15(int64_t value);
+
+    /// <summary> Divides a value by 2^shift, rounding to nearest (ties toward positive infinity). </summary>
+    int64_t RoundingShiftRight(int64_t value, int shift);
+
+    /// <summary> Multiplies two Q15 values, rounding and saturating the result. </summary>
+    int32_t MultiplyQ15(int32_t a, int32_t b);
+
+    /// <summary> Multiplies two Q31 values, rounding and saturating the result. </summary>
+    int32_t MultiplyQ31(int32_t a, int32_t b);
+
+    /// <summary> Returns the largest integer whose square is at most `value`, which must be nonnegative. </summary>
+    int32_t IntegerSquareRoot(int32_t value);
+
+    /// <summary>
+    /// Returns the smallest nonnegative `shift` such that `gain <= 2^shift`, which is the number of bits a value must be
+    /// shifted right by so that multiplying it by `gain` can't overflow.
+    /// </summary>
+    int GetHeadroomShift(double gain);
+
+    /// <summary>
+    /// A precomputed plan for fixed-point FFTs of a power-of-2 size, for processors without floating point hardware.
+    /// The transform is an iterative, in-place radix-2 transform on Q15 values held in 32-bit integers, with Q15
+    /// twiddle factors. Each stage halves its outputs, so nothing overflows, and the result is the FFT divided by
+    /// the FFT size.
+    /// </summary>
+    class FixedPointFFTPlan
+    {
+    public:
+        /// <summary> Default constructor: a plan for an FFT of size 0. </summary>
+        FixedPointFFTPlan() = default;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="size"> The FFT size. Must be a power of 2, at least 2. </param>
+        FixedPointFFTPlan(size_t size);
+
+        /// <summary> Gets the FFT size. </summary>
+        size_t Size() const { return _size; }
+
+        /// <summary> Gets the real parts of the twiddle factors, cos(2*pi*k/N) for k in [0, N/2), in Q15. </summary>
+        const std::vector<int>& GetCosines() const { return _cosines; }
+
+        /// <summary> Gets the negated imaginary parts of the twiddle factors, sin(2*pi*k/N) for k in [0, N/2), in Q15. </summary>
+        const std::vector<int>& GetSines() const { return _sines; }
+
+        /// <summary> Gets the bit-reversal permutation. </summary>
+        const std::vector<int>& GetBitReversalPermutation() const { return _bitReversal; }
+
+        /// <summary>
+        /// Computes the magnitudes of the first N/2 frequency bands of a real-valued Q15 signal, divided by N, in Q15.
+        /// </summary>
+        ///
+        /// <param name="signal"> Pointer to the entries of the signal. </param>
+        /// <param name="signalSize"> The number of entries of the signal, at most `Size()`. The signal is zero-padded to `Size()`. </param>
+        /// <param name="magnitudes"> Pointer to the `Size() / 2` magnitudes to compute. </param>
+        void TransformMagnitudes(const int* signal, size_t signalSize, int* magnitudes) const;
+
+    private:
+        size_t _size = 0;
+        std::vector<int> _cosines;
+        std::vector<int> _sines;
+        std::vector<int> _bitReversal;
+    };
+} // namespace dsp
+} // namespace ell
@@ -10,6 +10,7 @@
 
 #include "Convolution.h"
 
+#include <math/include/Matrix.h>
 #include <math/include/Tensor.h>
 #include <math/include/Vector.h>
 
@@ -47,7 +48,13 @@ namespace dsp
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> Convolve2DUnrolled(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride);
 
+    /// <summary> Unrolls the receptive fields of a 3D image into the columns of a matrix, so that a convolution becomes a matrix product. </summary>
+    ///
+    /// <param name="input"> The input image: a (r x c x d) tensor. </param>
+    /// <param name="filterSize"> The width and height of the filters. </param>
+    /// <param name="stride"> The number of elements to move/jump when sliding over the input. </param>
+    /// <param name="shapedInput"> The matrix to fill: a ((filterSize*filterSize*d) x (number of output pixels)) matrix, which may be part of a larger one. </param>
     template <typename ValueType>
-    void ReceptiveFieldToColumns(math::ConstChannelColumnRowTensorReference<ValueType> input, int filterSize, int stride, math::RowMatrix<ValueType>& shapedInput);
+    void ReceptiveFieldToColumns(math::ConstChannelColumnRowTensorReference<ValueType> input, int filterSize, int stride, math::RowMatrixReference<ValueType> shapedInput);
 } // namespace dsp
 } // namespace ell
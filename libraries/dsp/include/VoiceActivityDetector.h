@@ -48,6 +48,7 @@ namespace dsp
         /// <param name="thresholdUp"> Then we compare the energy of the current frame to the noise floor. If it is thresholdUp times higher, we switch to state VOICE. </param>
         /// <param name="thresholdDown"> Then we compare the energy of the current frame to the noise floor. If it is thresholdDown times lower, we switch to state NO VOICE.  </param>
         /// <param name="levelThreshold"> Special case is when the energy of the frame is lower than levelThreshold, when we force the state to NO VOICE. </param>
+        /// <param name="decimation"> Once the state hasn't changed for this many frames, only every decimation'th frame is processed, and the other frames return the current state. 1 processes every frame. </param>
         VoiceActivityDetector(
             double sampleRate,
             double windowSize,
@@ -58,7 +59,8 @@ namespace dsp
             double gainAtt,
             double thresholdUp,
             double thresholdDown,
-            double levelThreshold);
+            double levelThreshold,
+            int decimation = 1);
 
         /// <summary> Destructor </summary>
         ~VoiceActivityDetector();
@@ -67,12 +69,19 @@ namespace dsp
         void Reset();
 
         /// <summary> Process incoming audio stream, this data should already be floating point in the range[0 - 1].
-        /// This method returns 1 when it detects activity in the stream and 0 otherwise. </summary>
+        /// This method returns 1 when it detects activity in the stream and 0 otherwise. If the window size is 1, the
+        /// data is the level of the frame, as computed by `ProcessLevel`. </summary>
         ///
         /// <param name="data"> The input signal. </param>
         template <typename ValueType>
         int Process(const std::vector<ValueType>& data);
 
+        /// <summary> Process a frame whose level, the mean of its spectrum weighted by `GetWeights`, the front end
+        /// has already computed. This method returns 1 when it detects activity in the stream and 0 otherwise. </summary>
+        ///
+        /// <param name="level"> The level of the frame. </param>
+        int ProcessLevel(double level);
+
         /// <summary> Return true if the two detectors have the same sample rate and window size </summary>
         bool Equals(const VoiceActivityDetector& other) const;
 
@@ -119,6 +128,9 @@ namespace dsp
         /// <summary> Get the levelThreshold parameter provided to constructor </summary>
         double GetLevelThreshold() const;
 
+        /// <summary> Get the decimation parameter provided to constructor </summary>
+        int GetDecimation() const;
+
     protected:
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
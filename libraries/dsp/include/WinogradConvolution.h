@@ -47,7 +47,8 @@ namespace dsp
     template <typename ValueType>
     math::RowVector<ValueType> Convolve1DWinograd(const math::RowVector<ValueType>& input, const math::RowVector<ValueType>& filter);
 
-    /// <summary> Convolve a 1D input with a 1D filter with a user-specified tile size. </summary>
+    /// <summary> Convolve a 1D input with a 1D filter with a user-specified tile size. Any tile and filter size can be used: F(2,3) has an unrolled
+    /// implementation, and the others apply the transform matrices directly. </summary>
     ///
     /// <param name="input"> The input signal. </param>
     /// <param name="filter"> The filter to convolve with. </param>
@@ -84,6 +85,20 @@ namespace dsp
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int tileSize, WinogradFilterOrder order = WinogradFilterOrder::tilesFirst);
 
+    /// <summary> Spatially convolve a 3D image with a stack of 3D filters, with a stride. Strides other than 1 are computed as the sum of
+    /// stride * stride unstrided Winograd convolutions of the subsampled input with the corresponding subsampled filters. </summary>
+    ///
+    /// <param name="input"> The input image: a (r x c x d) tensor. </param>
+    /// <param name="filters"> The filters to convolve with. A (nf x fr x fc x d) tensor, reshaped as a ((nf*fr) x fc x d) 3D tensor. </param>
+    /// <param name="numFilters"> The number of filters in the `filters` argument. </param>
+    /// <param name="tileSize"> The size of the output tiles --- the number of output values to produce at a time. </param>
+    /// <param name="stride"> The number of input elements between adjacent outputs. </param>
+    /// <param name="order"> The ordering to use for the transformed filters. </param>
+    ///
+    /// <returns> A tensor with the result of the convolution `input` (*) `filter`
+    template <typename ValueType>
+    math::ChannelColumnRowTensor<ValueType> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int tileSize, int stride, WinogradFilterOrder order = WinogradFilterOrder::tilesFirst);
+
     /// <summary> Spatially convolve a 3D image with a stack of 3D filters, using pre-transformed filter weights. </summary>
     ///
     /// <param name="input"> The input image: a (r x c x d) tensor. </param>
@@ -118,6 +133,19 @@ namespace dsp
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int tileSize, WinogradFilterOrder order = WinogradFilterOrder::filtersFirst);
 
+    /// <summary> Convolve a set of 2D images with a corresponding set of 2D filters, with a stride. Strides other than 1 are computed as the sum of
+    /// stride * stride unstrided Winograd convolutions of the subsampled input with the corresponding subsampled filters. </summary>
+    ///
+    /// <param name="input"> The input image: a (r x c x d) tensor. </param>
+    /// <param name="filters"> The filters to convolve with. A (fr x fc x d) tensor. </param>
+    /// <param name="tileSize"> The size of the output tiles --- the number of output values to produce at a time. </param>
+    /// <param name="stride"> The number of input elements between adjacent outputs. </param>
+    /// <param name="order"> The ordering to use for the transformed filters. </param>
+    ///
+    /// <returns> A tensor with the result of the convolution `input` (*) `filter`
+    template <typename ValueType>
+    math::ChannelColumnRowTensor<ValueType> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int tileSize, int stride, WinogradFilterOrder order = WinogradFilterOrder::filtersFirst);
+
     /// <summary> Convolve a set of 2D images with a corresponding set of 2D filters, using pre-transformed filter weights. </summary>
     ///
     /// <param name="input"> The input image: a (r x c x d) tensor. </param>
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Convolution.h"
+#include "FFTConvolution.h"
 #include "SimpleConvolution.h"
 #include "UnrolledConvolution.h"
 #include "WinogradConvolution.h"
@@ -32,11 +33,32 @@ namespace dsp
             return Convolve1DUnrolled(signal, filter);
         case ConvolutionMethodOption::winograd:
             return Convolve1DWinograd(signal, filter);
+        case ConvolutionMethodOption::fft:
+            return Convolve1DFFT(signal, filter);
         default:
             throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
         }
     }
 
+    template <typename ValueType>
+    void Convolve1D(math::ConstRowVectorReference<ValueType> signal, const math::RowVector<ValueType>& filter, math::RowVectorReference<ValueType> result, ConvolutionMethodOption method)
+    {
+        switch (method)
+        {
+        case ConvolutionMethodOption::automatic:
+        // fallthrough
+        case ConvolutionMethodOption::simple:
+            Convolve1DSimple(signal, filter, result);
+            break;
+        case ConvolutionMethodOption::fft:
+            Convolve1DFFT(signal, filter, result);
+            break;
+        default:
+            result.CopyFrom(Convolve1D(math::RowVector<ValueType>(signal), filter, method));
+            break;
+        }
+    }
+
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> Convolve2D(const math::ConstChannelColumnRowTensorReference<ValueType>& signal, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, ConvolutionMethodOption method)
     {
@@ -55,17 +77,37 @@ namespace dsp
         case ConvolutionMethodOption::unrolled:
             return Convolve2DUnrolled(signal, filters, numFilters, stride);
         case ConvolutionMethodOption::winograd:
-            if (stride == 1)
-            {
-                const int tileSize = 2;
-                return Convolve2DWinograd(signal, filters, numFilters, tileSize);
-            }
+        {
+            const int tileSize = 2;
+            return Convolve2DWinograd(signal, filters, numFilters, tileSize, stride);
+        }
+        case ConvolutionMethodOption::fft:
+            return Convolve2DFFT(signal, filters, numFilters, stride);
         default:
             break;
         }
         throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
     }
 
+    template <typename ValueType>
+    void Convolve2D(math::ConstChannelColumnRowTensorReference<ValueType> signal, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<ValueType> result, ConvolutionMethodOption method)
+    {
+        switch (method)
+        {
+        case ConvolutionMethodOption::automatic:
+        // fallthrough
+        case ConvolutionMethodOption::simple:
+            Convolve2DSimple(signal, filters, numFilters, stride, result);
+            break;
+        case ConvolutionMethodOption::fft:
+            Convolve2DFFT(signal, filters, numFilters, stride, result);
+            break;
+        default:
+            result.CopyFrom(Convolve2D(signal, filters, numFilters, stride, method));
+            break;
+        }
+    }
+
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> Convolve2DDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<ValueType>& signal, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, ConvolutionMethodOption method)
     {
@@ -84,11 +126,18 @@ namespace dsp
         case ConvolutionMethodOption::unrolled:
             throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
         case ConvolutionMethodOption::winograd:
-            if (stride == 1)
+        {
+            const int tileSize = 2;
+            return Convolve2DWinogradDepthwiseSeparable(signal, filters, numFilters, tileSize, stride);
+        }
+        case ConvolutionMethodOption::fft:
+        {
+            if (numFilters != static_cast<int>(signal.NumChannels()) || filters.NumChannels() != 1)
             {
-                const int tileSize = 2;
-                return Convolve2DWinogradDepthwiseSeparable(signal, filters, numFilters, tileSize);
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Depthwise separable convolution requires numFilters to be the same as the number of input channels and the filter depth to be 1.");
             }
+            return Convolve2DFFT(signal, filters, numFilters, stride);
+        }
         default:
             break;
         }
@@ -101,12 +150,18 @@ namespace dsp
     template math::RowVector<float> Convolve1D(const math::RowVector<float>& signal, const math::RowVector<float>& filter, ConvolutionMethodOption method);
     template math::RowVector<double> Convolve1D(const math::RowVector<double>& signal, const math::RowVector<double>& filter, ConvolutionMethodOption method);
 
+    template void Convolve1D(math::ConstRowVectorReference<float> signal, const math::RowVector<float>& filter, math::RowVectorReference<float> result, ConvolutionMethodOption method);
+    template void Convolve1D(math::ConstRowVectorReference<double> signal, const math::RowVector<double>& filter, math::RowVectorReference<double> result, ConvolutionMethodOption method);
+
     template math::ChannelColumnRowTensor<float> Convolve2D(const math::ConstChannelColumnRowTensorReference<float>& signal, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, ConvolutionMethodOption method);
     template math::ChannelColumnRowTensor<double> Convolve2D(const math::ConstChannelColumnRowTensorReference<double>& signal, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, ConvolutionMethodOption method);
 
     template math::ChannelColumnRowTensor<float> Convolve2D(const math::ConstChannelColumnRowTensorReference<float>& signal, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int stride, ConvolutionMethodOption method);
     template math::ChannelColumnRowTensor<double> Convolve2D(const math::ConstChannelColumnRowTensorReference<double>& signal, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int stride, ConvolutionMethodOption method);
 
+    template void Convolve2D(math::ConstChannelColumnRowTensorReference<float> signal, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<float> result, ConvolutionMethodOption method);
+    template void Convolve2D(math::ConstChannelColumnRowTensorReference<double> signal, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<double> result, ConvolutionMethodOption method);
+
     template math::ChannelColumnRowTensor<float> Convolve2DDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, ConvolutionMethodOption method);
     template math::ChannelColumnRowTensor<double> Convolve2DDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, ConvolutionMethodOption method);
 
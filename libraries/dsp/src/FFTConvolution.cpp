@@ -0,0 +1,372 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FFTConvolution.cpp (dsp)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FFTConvolution.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <future>
+
+namespace ell
+{
+namespace dsp
+{
+    namespace
+    {
+        size_t NextPowerOf2(size_t size)
+        {
+            size_t result = 1;
+            while (result < size)
+            {
+                result *= 2;
+            }
+            return result;
+        }
+
+        // Calls `function(begin, end)` on slices of [0, count) on the host threads, with at least `minCountPerTask`
+        // entries per slice
+        template <typename FunctionType>
+        void ParallelFor(size_t count, size_t minCountPerTask, FunctionType&& function)
+        {
+            auto& threadPool = utilities::GetHostThreadPool();
+            auto numTasks = std::min(threadPool.NumThreads(), count / minCountPerTask);
+            if (numTasks < 2)
+            {
+                function(size_t{ 0 }, count);
+                return;
+            }
+
+            // Compute the first slice on this thread, and the others asynchronously
+            auto sliceSize = (count + numTasks - 1) / numTasks;
+            std::vector<std::future<void>> tasks;
+            for (auto begin = sliceSize; begin < count; begin += sliceSize)
+            {
+                tasks.push_back(threadPool.AddTask(function, begin, std::min(begin + sliceSize, count)));
+            }
+            function(size_t{ 0 }, sliceSize);
+
+            for (auto& task : tasks)
+            {
+                threadPool.GetResult(task);
+            }
+        }
+
+        // Overwrites `spectrum` (a transform of a real signal divided by its size, and multiplied by the conjugate of
+        // another) with the real signal whose transform it is, using the forward transform: x = conj(FFT(conj(X))).
+        // Two such spectra, packed as `a + i*b`, give their two signals in the real and imaginary parts.
+        template <typename ValueType>
+        void InverseTransformScaled(const FFTPlan<ValueType>& plan, std::complex<ValueType>* spectrum)
+        {
+            const auto size = plan.Size();
+            for (size_t k = 0; k < size; ++k)
+            {
+                spectrum[k] = std::conj(spectrum[k]);
+            }
+            plan.Transform(spectrum);
+            for (size_t k = 0; k < size; ++k)
+            {
+                spectrum[k] = std::conj(spectrum[k]);
+            }
+        }
+
+        // Computes the conjugate of the transform of the `size` real entries `getValue(0)`, `getValue(1)`, ...,
+        // divided by the transform's size
+        template <typename ValueType, typename GetValueFunction>
+        void GetFilterSpectrum(const FFTPlan<ValueType>& plan, size_t size, GetValueFunction&& getValue, std::complex<ValueType>* spectrum)
+        {
+            const auto fftSize = plan.Size();
+            std::fill(spectrum, spectrum + fftSize, std::complex<ValueType>{});
+            for (size_t index = 0; index < size; ++index)
+            {
+                spectrum[index] = getValue(index);
+            }
+            plan.Transform(spectrum);
+
+            const auto scale = static_cast<ValueType>(1.0 / fftSize);
+            for (size_t k = 0; k < fftSize; ++k)
+            {
+                spectrum[k] = std::conj(spectrum[k]) * scale;
+            }
+        }
+    } // namespace
+
+    //
+    // FFTConvolution1D
+    //
+    template <typename ValueType>
+    FFTConvolution1D<ValueType>::FFTConvolution1D(const math::RowVector<ValueType>& filter, size_t fftSize) :
+        _filterSize(filter.Size())
+    {
+        if (_filterSize == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FFTConvolution1D: the filter must not be empty");
+        }
+
+        if (fftSize == 0)
+        {
+            fftSize = GetFFTConvolutionSize(0, _filterSize);
+        }
+        if (fftSize < _filterSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FFTConvolution1D: the FFT size must be at least the filter size");
+        }
+
+        _plan = FFTPlan<ValueType>(fftSize);
+        _filterSpectrum.resize(fftSize);
+        GetFilterSpectrum(_plan, _filterSize, [&filter](size_t index) { return filter[index]; }, _filterSpectrum.data());
+    }
+
+    template <typename ValueType>
+    void FFTConvolution1D<ValueType>::Convolve(math::ConstRowVectorReference<ValueType> input, math::RowVectorReference<ValueType> result) const
+    {
+        if (result.Size() + _filterSize - 1 > input.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "FFTConvolution1D: the result is larger than the valid convolution of the input");
+        }
+
+        const auto blockSize = GetBlockSize();
+        const auto numBlocks = (result.Size() + blockSize - 1) / blockSize;
+        const auto numPairs = (numBlocks + 1) / 2;
+        const size_t minPairsPerTask = 8;
+        ParallelFor(numPairs, minPairsPerTask, [this, &input, &result](size_t beginPair, size_t endPair) {
+            ConvolveBlockPairs(input, result, beginPair, endPair);
+        });
+    }
+
+    template <typename ValueType>
+    void FFTConvolution1D<ValueType>::ConvolveBlockPairs(math::ConstRowVectorReference<ValueType> input, math::RowVectorReference<ValueType> result, size_t beginPair, size_t endPair) const
+    {
+        const auto fftSize = GetFFTSize();
+        const auto blockSize = GetBlockSize();
+        const auto inputSize = input.Size();
+        const auto resultSize = result.Size();
+        auto getInput = [&input, inputSize](size_t index) { return index < inputSize ? input[index] : ValueType{ 0 }; };
+
+        std::vector<std::complex<ValueType>> buffer(fftSize);
+        for (auto pair = beginPair; pair < endPair; ++pair)
+        {
+            // The first block of the pair goes in the real part, and the second one in the imaginary part
+            const auto begin = 2 * pair * blockSize;
+            for (size_t index = 0; index < fftSize; ++index)
+            {
+                buffer[index] = { getInput(begin + index), getInput(begin + blockSize + index) };
+            }
+
+            _plan.Transform(buffer.data());
+            for (size_t k = 0; k < fftSize; ++k)
+            {
+                buffer[k] *= _filterSpectrum[k];
+            }
+            InverseTransformScaled(_plan, buffer.data());
+
+            // The first `blockSize` entries of each block don't wrap around
+            for (size_t index = 0; index < blockSize && begin + index < resultSize; ++index)
+            {
+                result[begin + index] = buffer[index].real();
+            }
+            for (size_t index = 0; index < blockSize && begin + blockSize + index < resultSize; ++index)
+            {
+                result[begin + blockSize + index] = buffer[index].imag();
+            }
+        }
+    }
+
+    //
+    // Functions
+    //
+    size_t GetFFTConvolutionSize(size_t inputSize, size_t filterSize)
+    {
+        // With 4 times the filter size, most of each block's outputs are valid
+        const size_t minFFTSize = 16;
+        auto fftSize = NextPowerOf2(std::max(4 * filterSize, minFFTSize));
+        if (inputSize >= filterSize)
+        {
+            fftSize = std::min(fftSize, NextPowerOf2(inputSize));
+        }
+        return fftSize;
+    }
+
+    template <typename ValueType>
+    math::RowVector<ValueType> Convolve1DFFT(const math::RowVector<ValueType>& signal, const math::RowVector<ValueType>& filter)
+    {
+        auto filterSize = filter.Size();
+        auto outputSize = signal.Size() - filterSize + 1;
+        math::RowVector<ValueType> result(outputSize);
+        Convolve1DFFT(signal, filter, result);
+        return result;
+    }
+
+    template <typename ValueType>
+    void Convolve1DFFT(math::ConstRowVectorReference<ValueType> signal, const math::RowVector<ValueType>& filter, math::RowVectorReference<ValueType> result)
+    {
+        FFTConvolution1D<ValueType> convolution(filter, GetFFTConvolutionSize(signal.Size(), filter.Size()));
+        convolution.Convolve(signal, result);
+    }
+
+    template <typename ValueType>
+    math::ChannelColumnRowTensor<ValueType> Convolve2DFFT(const math::ConstChannelColumnRowTensorReference<ValueType>& signal, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride)
+    {
+        const auto filterRows = filters.NumRows() / numFilters;
+        const auto filterColumns = filters.NumColumns();
+        const auto inputRows = signal.NumRows();
+        const auto inputColumns = signal.NumColumns();
+        const auto outputRows = (inputRows - filterRows + 1) / stride;
+        const auto outputColumns = (inputColumns - filterColumns + 1) / stride;
+        math::ChannelColumnRowTensor<ValueType> result(outputRows, outputColumns, numFilters);
+        Convolve2DFFT(signal, filters, numFilters, stride, result);
+        return result;
+    }
+
+    template <typename ValueType>
+    void Convolve2DFFT(math::ConstChannelColumnRowTensorReference<ValueType> signal, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<ValueType> result)
+    {
+        using ComplexType = std::complex<ValueType>;
+
+        const auto numChannels = signal.NumChannels();
+        const auto filterRows = filters.NumRows() / numFilters;
+        const auto filterColumns = filters.NumColumns();
+        const auto numFilterChannels = filters.NumChannels();
+        const auto inputRows = signal.NumRows();
+        const auto inputColumns = signal.NumColumns();
+        const auto outputRows = result.NumRows();
+        const auto outputColumns = result.NumColumns();
+
+        // The transforms are large enough for a whole row, so the valid outputs never wrap around
+        const auto fftSize = NextPowerOf2(inputColumns);
+        const FFTPlan<ValueType> plan(fftSize);
+
+        // The spectrum of each row of each channel of each filter
+        const auto numFilterSpectra = static_cast<size_t>(numFilters) * filterRows * numFilterChannels;
+        std::vector<ComplexType> filterSpectra(numFilterSpectra * fftSize);
+        ParallelFor(numFilterSpectra, 16, [&](size_t begin, size_t end) {
+            for (auto spectrumIndex = begin; spectrumIndex < end; ++spectrumIndex)
+            {
+                const auto filterRowIndex = spectrumIndex / numFilterChannels;
+                const auto channelIndex = spectrumIndex % numFilterChannels;
+                GetFilterSpectrum(plan, filterColumns, [&](size_t columnIndex) { return filters(filterRowIndex, columnIndex, channelIndex); }, filterSpectra.data() + spectrumIndex * fftSize);
+            }
+        });
+
+        // The spectrum of each row of each input channel. Two channels are transformed at a time, as the real and
+        // imaginary parts of one complex signal z, and then separated:
+        //   A[k] = (Z[k] + conj(Z[N-k])) / 2
+        //   B[k] = (Z[k] - conj(Z[N-k])) / 2i
+        const auto numChannelPairs = (numChannels + 1) / 2;
+        std::vector<ComplexType> inputSpectra(inputRows * numChannels * fftSize);
+        ParallelFor(inputRows, 4, [&](size_t beginRow, size_t endRow) {
+            std::vector<ComplexType> buffer(fftSize);
+            for (auto rowIndex = beginRow; rowIndex < endRow; ++rowIndex)
+            {
+                for (size_t pair = 0; pair < numChannelPairs; ++pair)
+                {
+                    const auto channelIndex = 2 * pair;
+                    const auto hasSecondChannel = channelIndex + 1 < numChannels;
+                    std::fill(buffer.begin(), buffer.end(), ComplexType{});
+                    for (size_t columnIndex = 0; columnIndex < inputColumns; ++columnIndex)
+                    {
+                        buffer[columnIndex] = { signal(rowIndex, columnIndex, channelIndex), hasSecondChannel ? signal(rowIndex, columnIndex, channelIndex + 1) : ValueType{ 0 } };
+                    }
+                    plan.Transform(buffer.data());
+
+                    auto first = inputSpectra.data() + (rowIndex * numChannels + channelIndex) * fftSize;
+                    for (size_t k = 0; k < fftSize; ++k)
+                    {
+                        const auto zk = buffer[k];
+                        const auto zConj = std::conj(buffer[(fftSize - k) % fftSize]);
+                        first[k] = (zk + zConj) * ValueType{ 0.5 };
+                        if (hasSecondChannel)
+                        {
+                            const auto d = (zk - zConj) * ValueType{ 0.5 };
+                            first[fftSize + k] = { d.imag(), -d.real() }; // d / i
+                        }
+                    }
+                }
+            }
+        });
+
+        // Each tile is a pair of output rows of one filter, whose spectra are packed as `a + i*b` so one inverse
+        // transform computes both
+        const auto numRowPairs = (outputRows + 1) / 2;
+        const auto numTiles = static_cast<size_t>(numFilters) * numRowPairs;
+        ParallelFor(numTiles, 4, [&](size_t beginTile, size_t endTile) {
+            std::vector<ComplexType> buffer(fftSize);
+            for (auto tile = beginTile; tile < endTile; ++tile)
+            {
+                const auto filterIndex = tile / numRowPairs;
+                const auto rowIndex = 2 * (tile % numRowPairs);
+                const auto channelStart = (filterIndex * numFilterChannels) % numChannels;
+                const auto hasSecondRow = rowIndex + 1 < outputRows;
+
+                std::fill(buffer.begin(), buffer.end(), ComplexType{});
+                for (size_t filterRowIndex = 0; filterRowIndex < filterRows; ++filterRowIndex)
+                {
+                    for (size_t channelIndex = 0; channelIndex < numFilterChannels; ++channelIndex)
+                    {
+                        const auto filterSpectrum = filterSpectra.data() + ((filterIndex * filterRows + filterRowIndex) * numFilterChannels + channelIndex) * fftSize;
+                        const auto firstRowIndex = rowIndex * stride + filterRowIndex;
+                        const auto firstSpectrum = inputSpectra.data() + (firstRowIndex * numChannels + channelStart + channelIndex) * fftSize;
+                        if (hasSecondRow)
+                        {
+                            const auto secondSpectrum = firstSpectrum + stride * numChannels * fftSize;
+                            for (size_t k = 0; k < fftSize; ++k)
+                            {
+                                const auto b = secondSpectrum[k];
+                                buffer[k] += (firstSpectrum[k] + ComplexType{ -b.imag(), b.real() }) * filterSpectrum[k];
+                            }
+                        }
+                        else
+                        {
+                            for (size_t k = 0; k < fftSize; ++k)
+                            {
+                                buffer[k] += firstSpectrum[k] * filterSpectrum[k];
+                            }
+                        }
+                    }
+                }
+                InverseTransformScaled(plan, buffer.data());
+
+                for (size_t columnIndex = 0; columnIndex < outputColumns; ++columnIndex)
+                {
+                    const auto value = buffer[columnIndex * stride];
+                    result(rowIndex, columnIndex, filterIndex) = value.real();
+                    if (hasSecondRow)
+                    {
+                        result(rowIndex + 1, columnIndex, filterIndex) = value.imag();
+                    }
+                }
+            }
+        });
+    }
+
+    //
+    // Explicit instantiations
+    //
+    template class FFTConvolution1D<float>;
+    template class FFTConvolution1D<double>;
+
+    //
+    // Versions that return the result
+    //
+    template math::RowVector<float> Convolve1DFFT(const math::RowVector<float>& signal, const math::RowVector<float>& filter);
+    template math::RowVector<double> Convolve1DFFT(const math::RowVector<double>& signal, const math::RowVector<double>& filter);
+
+    template math::ChannelColumnRowTensor<float> Convolve2DFFT(const math::ConstChannelColumnRowTensorReference<float>& signal, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int stride);
+    template math::ChannelColumnRowTensor<double> Convolve2DFFT(const math::ConstChannelColumnRowTensorReference<double>& signal, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int stride);
+
+    //
+    // Versions that accept the result storage
+    //
+    template void Convolve1DFFT(math::ConstRowVectorReference<float> signal, const math::RowVector<float>& filter, math::RowVectorReference<float> result);
+    template void Convolve1DFFT(math::ConstRowVectorReference<double> signal, const math::RowVector<double>& filter, math::RowVectorReference<double> result);
+
+    template void Convolve2DFFT(math::ConstChannelColumnRowTensorReference<float> signal, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<float> result);
+    template void Convolve2DFFT(math::ConstChannelColumnRowTensorReference<double> signal, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int stride, math::ChannelColumnRowTensorReference<double> result);
+} // namespace dsp
+} // namespace ell
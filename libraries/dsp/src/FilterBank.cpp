@@ -153,17 +153,19 @@ namespace dsp
         //        N/2
         // Y[i] = sum((|X[k]| sqrt(H_i[k]) ^ 2)
         //        k = 0
-        auto numOutputs = _endFilter - _beginFilter;
+        //
+        // Only the filters' nonzero support is visited, using the precomputed coefficients
+        auto numOutputs = NumActiveFilters();
         std::vector<ValueType> result(numOutputs);
-        for (size_t filterIndex = _beginFilter; filterIndex < _endFilter; ++filterIndex)
+        for (size_t filterIndex = 0; filterIndex < numOutputs; ++filterIndex)
         {
-            auto filter = GetFilter(filterIndex);
-            const size_t begin = filter.GetStart();
-            const size_t end = filter.GetEnd();
+            const auto begin = _coefficients.offsets[filterIndex];
+            const auto end = _coefficients.offsets[filterIndex + 1];
+            const auto magnitudes = frequencyMagnitudes.data() + _coefficients.startBins[filterIndex] - begin;
             ValueType sum = 0;
-            for (size_t k = begin; k < end; ++k)
+            for (auto index = begin; index < end; ++index)
             {
-                sum += static_cast<ValueType>(frequencyMagnitudes[k] * filter[k]);
+                sum += static_cast<ValueType>(magnitudes[index] * _coefficients.values[index]);
             }
 
             result[filterIndex] = sum;
@@ -197,6 +199,20 @@ namespace dsp
     void TriangleFilterBank::SetBins(const std::vector<size_t>& bins)
     {
         _bins = bins;
+
+        // Precompute the coefficients of the active filters over their support
+        _coefficients = {};
+        _coefficients.offsets.push_back(0);
+        for (size_t filterIndex = _beginFilter; filterIndex < _endFilter; ++filterIndex)
+        {
+            auto filter = GetFilter(filterIndex);
+            for (auto index = filter.GetStart(); index < filter.GetEnd(); ++index)
+            {
+                _coefficients.values.push_back(filter[index]);
+            }
+            _coefficients.startBins.push_back(static_cast<int>(filter.GetStart()));
+            _coefficients.offsets.push_back(static_cast<int>(_coefficients.values.size()));
+        }
     }
 
     //
@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FixedPoint.cpp (dsp)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FixedPoint.h"
+
+#include <math/include/MathConstants.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace dsp
+{
+    namespace
+    {
+        int32_t ToFixedPoint(double value, int fractionalBits)
+        {
+            const double maxValue = std::ldexp(1.0, 31) - 1;
+            auto scaled = std::round(std::ldexp(value, fractionalBits));
+            scaled = std::max(-maxValue - 1, std::min(maxValue, scaled));
+            return static_cast<int32_t>(scaled);
+        }
+
+        int32_t Saturate32(int64_t value)
+        {
+            return static_cast<int32_t>(std::max<int64_t>(INT32_MIN, std::min<int64_t>(INT32_MAX, value)));
+        }
+    } // namespace
+
+    int32_t ToQ15(double value)
+    {
+        return SaturateQ15(ToFixedPoint(value, q15FractionalBits));
+    }
+
+    double FromQ15(int32_t value)
+    {
+        return std::ldexp(static_cast<double>(value), -q15FractionalBits);
+    }
+
+    int32_t ToQ31(double value)
+    {
+        return ToFixedPoint(value, q31FractionalBits);
+    }
+
+    double FromQ31(int32_t value)
+    {
+        return std::ldexp(static_cast<double>(value), -q31FractionalBits);
+    }
+
+    int32_t SaturateQ15(int64_t value)
+    {
+        return static_cast<int32_t>(std::max<int64_t>(q15Min, std::min<int64_t>(q15Max, value)));
+    }
+
+    int64_t RoundingShiftRight(int64_t value, int shift)
+    {
+        return shift > 0 ? (value + (int64_t{ 1 } << (shift - 1))) >> shift : value;
+    }
+
+    int32_t MultiplyQ15(int32_t a, int32_t b)
+    {
+        return SaturateQ15(RoundingShiftRight(static_cast<int64_t>(a) * b, q15FractionalBits));
+    }
+
+    int32_t MultiplyQ31(int32_t a, int32_t b)
+    {
+        return Saturate32(RoundingShiftRight(static_cast<int64_t>(a) * b, q31FractionalBits));
+    }
+
+    int32_t IntegerSquareRoot(int32_t value)
+    {
+        // Computes one bit of the result per iteration, from the most significant one down
+        int32_t result = 0;
+        int32_t bit = 1 << 30;
+        for (int i = 0; i < 16; ++i)
+        {
+            if (value >= result + bit)
+            {
+                value -= result + bit;
+                result = (result >> 1) + bit;
+            }
+            else
+            {
+                result >>= 1;
+            }
+            bit >>= 2;
+        }
+        return result;
+    }
+
+    int GetHeadroomShift(double gain)
+    {
+        int shift = 0;
+        while (shift < 31 && std::ldexp(1.0, shift) < gain)
+        {
+            ++shift;
+        }
+        return shift;
+    }
+
+    //
+    // FixedPointFFTPlan
+    //
+    FixedPointFFTPlan::FixedPointFFTPlan(size_t size) :
+        _size(size)
+    {
+        if (size < 2 || (size & (size - 1)) != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FixedPointFFTPlan: FFT size must be a power of 2, at least 2");
+        }
+
+        const auto pi = math::Constants<double>::pi;
+        for (size_t k = 0; k < size / 2; ++k)
+        {
+            _cosines.push_back(ToQ15(std::cos(2 * pi * k / size)));
+            _sines.push_back(ToQ15(std::sin(2 * pi * k / size)));
+        }
+
+        int numBits = 0;
+        while ((size_t{ 1 } << numBits) < size)
+        {
+            ++numBits;
+        }
+        _bitReversal.resize(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            int reversed = 0;
+            for (int bit = 0; bit < numBits; ++bit)
+            {
+                reversed |= ((i >> bit) & 1) << (numBits - 1 - bit);
+            }
+            _bitReversal[i] = reversed;
+        }
+    }
+
+    void FixedPointFFTPlan::TransformMagnitudes(const int* signal, size_t signalSize, int* magnitudes) const
+    {
+        // This does exactly what the code `FixedPointFFTNode` emits does, so the two give identical results
+        std::vector<int32_t> re(_size, 0);
+        std::vector<int32_t> im(_size, 0);
+        for (size_t i = 0; i < std::min(signalSize, _size); ++i)
+        {
+            re[_bitReversal[i]] = SaturateQ15(signal[i]);
+        }
+
+        for (size_t half = 1; half < _size; half *= 2)
+        {
+            const auto twiddleStride = _size / (2 * half);
+            for (size_t i = 0; i < _size / 2; ++i)
+            {
+                const auto k = i & (half - 1);
+                const auto top = (i - k) * 2 + k;
+                const auto bottom = top + half;
+                const int32_t c = _cosines[k * twiddleStride];
+                const int32_t s = _sines[k * twiddleStride];
+
+                // t = bottom * e^(-2*pi*i*k/N). By Cauchy-Schwarz the sums of products fit in 32 bits.
+                const int32_t tRe = (re[bottom] * c + im[bottom] * s + (1 << 14)) >> q15FractionalBits;
+                const int32_t tIm = (im[bottom] * c - re[bottom] * s + (1 << 14)) >> q15FractionalBits;
+                const int32_t aRe = re[top];
+                const int32_t aIm = im[top];
+                re[top] = (aRe + tRe + 1) >> 1;
+                im[top] = (aIm + tIm + 1) >> 1;
+                re[bottom] = (aRe - tRe + 1) >> 1;
+                im[bottom] = (aIm - tIm + 1) >> 1;
+            }
+        }
+
+        for (size_t k = 0; k < _size / 2; ++k)
+        {
+            // Clamp to [-32767, 32767], so the sum of squares fits in 32 bits
+            const auto x = std::max(-q15Max, SaturateQ15(re[k]));
+            const auto y = std::max(-q15Max, SaturateQ15(im[k]));
+            magnitudes[k] = SaturateQ15(IntegerSquareRoot(x * x + y * y));
+        }
+    }
+} // namespace dsp
+} // namespace ell
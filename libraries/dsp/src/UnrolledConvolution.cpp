@@ -97,7 +97,7 @@ namespace dsp
     }
 
     template <typename ValueType>
-    void ReceptiveFieldToColumns(math::ConstChannelColumnRowTensorReference<ValueType> input, int filterSize, int stride, math::RowMatrix<ValueType>& shapedInput)
+    void ReceptiveFieldToColumns(math::ConstChannelColumnRowTensorReference<ValueType> input, int filterSize, int stride, math::RowMatrixReference<ValueType> shapedInput)
     {
         const auto numChannels = static_cast<int>(input.NumChannels());
         const auto fieldVolumeSize = filterSize * filterSize * numChannels;
@@ -141,7 +141,7 @@ namespace dsp
     template math::ChannelColumnRowTensor<float> Convolve2DUnrolled(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int stride);
     template math::ChannelColumnRowTensor<double> Convolve2DUnrolled(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int stride);
 
-    template void ReceptiveFieldToColumns(math::ConstChannelColumnRowTensorReference<float> input, int filterSize, int stride, math::RowMatrix<float>& shapedInput);
-    template void ReceptiveFieldToColumns(math::ConstChannelColumnRowTensorReference<double> input, int filterSize, int stride, math::RowMatrix<double>& shapedInput);
+    template void ReceptiveFieldToColumns(math::ConstChannelColumnRowTensorReference<float> input, int filterSize, int stride, math::RowMatrixReference<float> shapedInput);
+    template void ReceptiveFieldToColumns(math::ConstChannelColumnRowTensorReference<double> input, int filterSize, int stride, math::RowMatrixReference<double> shapedInput);
 } // namespace dsp
 } // namespace ell
@@ -204,7 +204,14 @@ namespace dsp
         double _frameDuration;
         double _sampleRate;
         double _windowSize;
+        int _decimation;
         int64_t _time;
+        int64_t _framesSinceChange;
+        int _signal;
+
+        // The weights divided by the window size, so the level of a frame is a dot product
+        std::vector<float> _floatWeights;
+        std::vector<double> _doubleWeights;
 
         VoiceActivityDetectorImpl(
             double sampleRate,
@@ -216,14 +223,78 @@ namespace dsp
             double gainAtt,
             double thresholdUp,
             double thresholdDown,
-            double levelThreshold) :
+            double levelThreshold,
+            int decimation) :
             _cmw(sampleRate, windowSize),
             _tracker(tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold)
         {
+            if (decimation < 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "decimation must be at least 1");
+            }
             _sampleRate = sampleRate;
             _windowSize = windowSize;
             _frameDuration = frameDuration;
+            _decimation = decimation;
+            for (auto weight : _cmw.GetWeights())
+            {
+                _doubleWeights.push_back(weight / windowSize);
+                _floatWeights.push_back(static_cast<float>(weight / windowSize));
+            }
+            Reset();
+        }
+
+        void Reset()
+        {
+            _tracker.Reset();
             _time = 0;
+            _framesSinceChange = 0;
+            _signal = 0;
+        }
+
+        const std::vector<float>& GetScaledWeights(const float*) const { return _floatWeights; }
+        const std::vector<double>& GetScaledWeights(const double*) const { return _doubleWeights; }
+
+        // Returns true, and advances the time, if the state is stable and this frame isn't one of every `_decimation` frames
+        bool SkipFrame()
+        {
+            if (_decimation > 1 && _framesSinceChange >= _decimation && _time % _decimation != 0)
+            {
+                ++_time;
+                ++_framesSinceChange;
+                return true;
+            }
+            return false;
+        }
+
+        int Classify(double level)
+        {
+            double t = _time++ * _frameDuration;
+            int signal = _tracker.Classify(t, level);
+            _framesSinceChange = signal == _signal ? _framesSinceChange + 1 : 0;
+            _signal = signal;
+            return signal;
+        }
+
+        // Computes the dot product with independent partial sums, so the loop can be vectorized without reassociating one sum
+        template <typename ValueType>
+        static ValueType WeightedSum(const ValueType* data, const ValueType* weights, size_t size)
+        {
+            const size_t numSums = 4;
+            ValueType sums[numSums] = {};
+            size_t i = 0;
+            for (; i + numSums <= size; i += numSums)
+            {
+                for (size_t j = 0; j < numSums; ++j)
+                {
+                    sums[j] += data[i + j] * weights[i + j];
+                }
+            }
+            for (; i < size; ++i)
+            {
+                sums[0] += data[i] * weights[i];
+            }
+            return (sums[0] + sums[1]) + (sums[2] + sums[3]);
         }
     };
 
@@ -239,17 +310,17 @@ namespace dsp
         double gainAtt,
         double thresholdUp,
         double thresholdDown,
-        double levelThreshold) :
-        _impl(std::make_unique<VoiceActivityDetectorImpl>(sampleRate, windowSize, frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold))
+        double levelThreshold,
+        int decimation) :
+        _impl(std::make_unique<VoiceActivityDetectorImpl>(sampleRate, windowSize, frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold, decimation))
     {
-        Reset();
     }
 
     VoiceActivityDetector::~VoiceActivityDetector() = default;
 
     void VoiceActivityDetector::Reset()
     {
-        _impl->_tracker.Reset();
+        _impl->Reset();
     }
 
     double VoiceActivityDetector::GetSampleRate() const
@@ -302,6 +373,11 @@ namespace dsp
         return _impl->_tracker._levelThreshold;
     }
 
+    int VoiceActivityDetector::GetDecimation() const
+    {
+        return _impl->_decimation;
+    }
+
     template <typename ValueType>
     int VoiceActivityDetector::Process(const std::vector<ValueType>& data)
     {
@@ -309,15 +385,26 @@ namespace dsp
         {
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "data length should match windowSize");
         }
-        double level = 0;
-        for (int i = 0; i < _impl->_windowSize; i++)
+        if (_impl->SkipFrame())
+        {
+            return _impl->_signal;
+        }
+
+        if (data.size() == 1)
+        {
+            return _impl->Classify(data[0]);
+        }
+        const auto& weights = _impl->GetScaledWeights(data.data());
+        return _impl->Classify(VoiceActivityDetectorImpl::WeightedSum(data.data(), weights.data(), data.size()));
+    }
+
+    int VoiceActivityDetector::ProcessLevel(double level)
+    {
+        if (_impl->SkipFrame())
         {
-            level += data[i] * _impl->_cmw.GetWeight(i);
+            return _impl->_signal;
         }
-        level = level / _impl->_windowSize;
-        double t = _impl->_time++ * _impl->_frameDuration;
-        int signal = _impl->_tracker.Classify(t, level);
-        return signal;
+        return _impl->Classify(level);
     }
 
     const std::vector<double>& VoiceActivityDetector::GetWeights() const
@@ -344,7 +431,8 @@ namespace dsp
                _impl->_tracker._gainAtt == other._impl->_tracker._gainAtt &&
                _impl->_tracker._thresholdUp == other._impl->_tracker._thresholdUp &&
                _impl->_tracker._thresholdDown == other._impl->_tracker._thresholdDown &&
-               _impl->_tracker._levelThreshold == other._impl->_tracker._levelThreshold;
+               _impl->_tracker._levelThreshold == other._impl->_tracker._levelThreshold &&
+               _impl->_decimation == other._impl->_decimation;
     }
 
     void VoiceActivityDetector::WriteToArchive(utilities::Archiver& archiver) const
@@ -359,6 +447,7 @@ namespace dsp
         archiver["thresholdUp"] << _impl->_tracker._thresholdUp;
         archiver["thresholdDown"] << _impl->_tracker._thresholdDown;
         archiver["levelThreshold"] << _impl->_tracker._levelThreshold;
+        archiver["decimation"] << _impl->_decimation;
     }
 
     void VoiceActivityDetector::ReadFromArchive(utilities::Unarchiver& archiver)
@@ -373,6 +462,7 @@ namespace dsp
         double thresholdUp;
         double thresholdDown;
         double levelThreshold;
+        int decimation;
         archiver["windowSize"] >> windowSize;
         archiver["sampleRate"] >> sampleRate;
         archiver["frameDuration"] >> frameDuration;
@@ -383,7 +473,8 @@ namespace dsp
         archiver["thresholdUp"] >> thresholdUp;
         archiver["thresholdDown"] >> thresholdDown;
         archiver["levelThreshold"] >> levelThreshold;
-        _impl = std::make_unique<VoiceActivityDetectorImpl>(sampleRate, windowSize, frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold);
+        archiver.OptionalProperty("decimation", 1) >> decimation;
+        _impl = std::make_unique<VoiceActivityDetectorImpl>(sampleRate, windowSize, frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold, decimation);
     }
 
     //
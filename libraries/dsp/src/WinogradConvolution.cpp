@@ -166,14 +166,15 @@ namespace dsp
                 CopyFrom(dataPtr, startRow, startColumn, channelIndex, rows, columns, increment1, increment2);
             }
 
+            // Copies a block from data with the given number of rows and columns, padding with zeros past its edges
             void CopyFrom(const ValueType* dataPtr, int startRow, int startColumn, int channelIndex, int numRows, int numColumns, int increment1, int increment2)
             {
-                UNUSED(numColumns, numRows);
                 for (int rowIndex = 0; rowIndex < rows; ++rowIndex)
                 {
                     for (int columnIndex = 0; columnIndex < columns; ++columnIndex)
                     {
-                        _data[rowIndex * columns + columnIndex] = dataPtr[(rowIndex + startRow) * increment2 + (columnIndex + startColumn) * increment1 + channelIndex];
+                        const bool inBounds = (rowIndex + startRow < numRows) && (columnIndex + startColumn < numColumns);
+                        _data[rowIndex * columns + columnIndex] = inBounds ? dataPtr[(rowIndex + startRow) * increment2 + (columnIndex + startColumn) * increment1 + channelIndex] : 0;
                     }
                 }
             }
@@ -310,6 +311,127 @@ namespace dsp
             return stream;
         }
 
+        //
+        // Cook-Toom construction of the Winograd matrices, for tile and filter sizes without hardcoded matrices
+        //
+
+        // Returns the first `count` interpolation points, in the usual order: 0, 1, -1, 2, -2, 1/2, -1/2, 3, -3, 1/3, -1/3, ...
+        // Small points keep the entries of the transform matrices small, which keeps the rounding error of large tiles in check.
+        std::vector<double> GetInterpolationPoints(int count)
+        {
+            std::vector<double> points = { 0.0, 1.0, -1.0 };
+            for (int k = 2; static_cast<int>(points.size()) < count; ++k)
+            {
+                points.insert(points.end(), { static_cast<double>(k), static_cast<double>(-k), 1.0 / k, -1.0 / k });
+            }
+            points.resize(count);
+            return points;
+        }
+
+        // Returns the coefficients (lowest order first) of the product of (x - p) for all the given points, except the one at `skipIndex`
+        std::vector<double> GetPolynomialWithRoots(const std::vector<double>& points, int skipIndex)
+        {
+            std::vector<double> coefficients = { 1.0 };
+            for (int index = 0; index < static_cast<int>(points.size()); ++index)
+            {
+                if (index == skipIndex)
+                {
+                    continue;
+                }
+
+                // multiply by (x - p)
+                std::vector<double> product(coefficients.size() + 1, 0.0);
+                for (size_t i = 0; i < coefficients.size(); ++i)
+                {
+                    product[i + 1] += coefficients[i];
+                    product[i] -= points[index] * coefficients[i];
+                }
+                coefficients = product;
+            }
+            return coefficients;
+        }
+
+        enum class WinogradMatrixType
+        {
+            data,
+            filter,
+            result
+        };
+
+        // Generates F(tileSize, filterSize) matrices by interpolating at windowSize - 1 finite points plus the point at infinity.
+        // For point p_j, with M_j(x) = prod_{l != j}(x - p_l) and M(x) = prod_l(x - p_l):
+        //
+        //   B' has the coefficients of M_j as its j-th row, and the coefficients of M as its last row
+        //   G has p_j^k / M_j(p_j) at (j, k), and a 1 in the lower-right corner
+        //   A' has p_j^i at (i, j), and a 1 in the lower-right corner
+        //
+        // This reproduces the hardcoded F(4,3) matrices above (and the F(2,3) ones, up to the signs of some rows).
+        template <typename ValueType>
+        math::RowMatrix<ValueType> GetGeneratedTransformMatrix(WinogradMatrixType type, int tileSize, int filterSize)
+        {
+            if (tileSize < 1 || filterSize < 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Winograd tile size and filter size must be positive");
+            }
+
+            const int windowSize = tileSize + filterSize - 1;
+            const int numPoints = windowSize - 1; // the remaining point is the point at infinity
+            const auto points = GetInterpolationPoints(numPoints);
+            switch (type)
+            {
+            case WinogradMatrixType::data:
+            {
+                math::RowMatrix<ValueType> result(windowSize, windowSize);
+                for (int j = 0; j <= numPoints; ++j)
+                {
+                    const auto coefficients = GetPolynomialWithRoots(points, j); // for j == numPoints, this is M itself
+                    for (int i = 0; i < static_cast<int>(coefficients.size()); ++i)
+                    {
+                        result(j, i) = static_cast<ValueType>(coefficients[i]);
+                    }
+                }
+                return result;
+            }
+            case WinogradMatrixType::filter:
+            {
+                math::RowMatrix<ValueType> result(windowSize, filterSize);
+                for (int j = 0; j < numPoints; ++j)
+                {
+                    const auto coefficients = GetPolynomialWithRoots(points, j);
+                    double denominator = 0;
+                    for (int i = static_cast<int>(coefficients.size()) - 1; i >= 0; --i)
+                    {
+                        denominator = denominator * points[j] + coefficients[i];
+                    }
+
+                    double power = 1.0;
+                    for (int k = 0; k < filterSize; ++k)
+                    {
+                        result(j, k) = static_cast<ValueType>(power / denominator);
+                        power *= points[j];
+                    }
+                }
+                result(numPoints, filterSize - 1) = 1;
+                return result;
+            }
+            case WinogradMatrixType::result:
+            {
+                math::RowMatrix<ValueType> result(tileSize, windowSize);
+                for (int j = 0; j < numPoints; ++j)
+                {
+                    double power = 1.0;
+                    for (int i = 0; i < tileSize; ++i)
+                    {
+                        result(i, j) = static_cast<ValueType>(power);
+                        power *= points[j];
+                    }
+                }
+                result(tileSize - 1, numPoints) = 1;
+                return result;
+            }
+            }
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState);
+        }
     } // End anonymous namespace
 
     //
@@ -406,6 +528,10 @@ namespace dsp
     //       0   1   1   4   4   0
     //       0   1  -1   8  -8   1
     //
+    //
+    // The matrices for other sizes, like F(6,3) or the F(m,2) used by strided convolution, are generated
+    // by `GetGeneratedTransformMatrix`.
+    //
 
     /// <summary> Gets the data-transforming matrix for Winograd convolution (commonly notated as B') </summary>
     template <typename ValueType>
@@ -431,7 +557,7 @@ namespace dsp
                                            { 0,  4,  0, -5,  0,  1 } });
             // clang-format on
         }
-        throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+        return GetGeneratedTransformMatrix<ValueType>(WinogradMatrixType::data, tileSize, filterSize);
     }
 
     template <typename ValueType>
@@ -464,7 +590,7 @@ namespace dsp
                                            {       0.0,       0.0,      1.0 } });
             // clang-format on
         }
-        throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+        return GetGeneratedTransformMatrix<ValueType>(WinogradMatrixType::filter, tileSize, filterSize);
     }
 
     template <typename ValueType>
@@ -493,7 +619,7 @@ namespace dsp
                                            { 0,  1, -1,  8, -8,  1 } });
             // clang-format on
         }
-        throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+        return GetGeneratedTransformMatrix<ValueType>(WinogradMatrixType::result, tileSize, filterSize);
     }
 
     template <typename ValueType>
@@ -584,6 +710,54 @@ namespace dsp
         }
     };
 
+    //
+    // 1D Winograd convolution for any F(m, r), using the transform matrices directly
+    //
+    template <typename ValueType>
+    void ConvolveWinograd1DGeneric(const math::RowVector<ValueType>& input, const math::RowVector<ValueType>& filter, int tileSize, math::RowVector<ValueType>& output)
+    {
+        using Vector = math::ColumnVector<ValueType>;
+        const int filterSize = static_cast<int>(filter.Size());
+        const int windowSize = tileSize + filterSize - 1;
+        const int inputSize = static_cast<int>(input.Size());
+        const int outputSize = static_cast<int>(output.Size());
+
+        const auto Bt = GetLeftDataTransformMatrix<ValueType>(tileSize, filterSize);
+        const auto G = GetLeftFilterTransformMatrix<ValueType>(tileSize, filterSize);
+        const auto At = GetLeftResultTransformMatrix<ValueType>(tileSize, filterSize);
+
+        // Precompute Gg
+        Vector g(filterSize);
+        for (int index = 0; index < filterSize; ++index)
+        {
+            g[index] = filter[index];
+        }
+        Vector Gg(windowSize);
+        math::MultiplyScaleAddUpdate(static_cast<ValueType>(1.0), G, g, static_cast<ValueType>(0.0), Gg);
+
+        // Y = A' * (Gg .* B'd)
+        Vector d(windowSize);
+        Vector X(windowSize);
+        Vector Y(tileSize);
+        for (int index = 0; index < outputSize; index += tileSize)
+        {
+            // The last window may run off the end of the input
+            for (int windowIndex = 0; windowIndex < windowSize; ++windowIndex)
+            {
+                d[windowIndex] = index + windowIndex < inputSize ? input[index + windowIndex] : 0;
+            }
+            math::MultiplyScaleAddUpdate(static_cast<ValueType>(1.0), Bt, d, static_cast<ValueType>(0.0), X);
+            ElementwiseMultiply(X.GetConstDataPointer(), Gg.GetConstDataPointer(), windowSize, X.GetDataPointer());
+            math::MultiplyScaleAddUpdate(static_cast<ValueType>(1.0), At, X, static_cast<ValueType>(0.0), Y);
+
+            const int tileEnd = std::min(tileSize, outputSize - index);
+            for (int tileIndex = 0; tileIndex < tileEnd; ++tileIndex)
+            {
+                output[index + tileIndex] = Y[tileIndex];
+            }
+        }
+    }
+
     //
     // 2D convolution implementation
     //
@@ -1431,7 +1605,7 @@ namespace dsp
                             ElementwiseMultiply(filterPtr, X.GetDataPointer(), windowSize * windowSize, X.GetDataPointer());
 
                             // Now compute output tile Y = At * X * A
-                            FixedWinogradTransform2D<ValueType, 2, 3>::TransformOutputTile(X, outputTile);
+                            FixedWinogradTransform2D<ValueType, tileSize, filterSize>::TransformOutputTile(X, outputTile);
 
                             // copy the tile into the output
                             const int outputTileRows = std::min(static_cast<int>(tileSize), numOutputRows - rowIndex);
@@ -1473,6 +1647,191 @@ namespace dsp
         }
     }; // End of FixedWinograd2D class
 
+    //
+    // Implementation of Winograd convolution for tile and filter sizes without a FixedWinogradTransform2D class (like F(6x6, 3x3)),
+    // applying the transform matrices with matrix multiplies. It uses the same data layouts as FixedWinograd2D.
+    //
+    template <typename ValueType>
+    class GenericWinograd2D
+    {
+    public:
+        using Matrix = math::RowMatrix<ValueType>;
+        using Tensor = math::ChannelColumnRowTensor<ValueType>;
+        using ConstTensorReference = math::ConstChannelColumnRowTensorReference<ValueType>;
+
+        GenericWinograd2D(int tileSize, int filterSize) :
+            _tileSize(tileSize),
+            _filterSize(filterSize),
+            _windowSize(tileSize + filterSize - 1),
+            _Bt(GetLeftDataTransformMatrix<ValueType>(tileSize, filterSize)),
+            _B(GetRightDataTransformMatrix<ValueType>(tileSize, filterSize)),
+            _At(GetLeftResultTransformMatrix<ValueType>(tileSize, filterSize)),
+            _A(GetRightResultTransformMatrix<ValueType>(tileSize, filterSize)),
+            _d(_windowSize, _windowSize),
+            _dB(_windowSize, _windowSize),
+            _X(_windowSize, _windowSize),
+            _XA(_windowSize, tileSize),
+            _Y(tileSize, tileSize)
+        {
+        }
+
+        // Handles the depthwise-separable case as well
+        void Convolve2DFiltersFirst(const ConstTensorReference& input, const ConstTensorReference& transformedFilters, int numFilters, Tensor& output)
+        {
+            const int numChannels = static_cast<int>(input.NumChannels());
+            const int numOutputRows = static_cast<int>(output.NumRows());
+            const int numOutputColumns = static_cast<int>(output.NumColumns());
+            assert(numFilters == static_cast<int>(output.NumChannels()));
+
+            const int numFilterChannels = static_cast<int>(transformedFilters.NumColumns());
+            const int windowEntries = _windowSize * _windowSize;
+            const int filterStride = numFilterChannels * windowEntries;
+
+            output.Fill(0);
+            for (int filterIndex = 0; filterIndex < numFilters; ++filterIndex)
+            {
+                const int channelStart = (filterIndex * numFilterChannels) % numChannels;
+                for (int filterChannel = 0; filterChannel < numFilterChannels; ++filterChannel)
+                {
+                    const int channelIndex = channelStart + filterChannel;
+                    const auto filterPtr = transformedFilters.GetConstDataPointer() + filterIndex * filterStride + filterChannel * windowEntries;
+                    for (int rowIndex = 0; rowIndex < numOutputRows; rowIndex += _tileSize)
+                    {
+                        for (int columnIndex = 0; columnIndex < numOutputColumns; columnIndex += _tileSize)
+                        {
+                            TransformInputWindow(input, rowIndex, columnIndex, channelIndex);
+                            ElementwiseMultiply(filterPtr, _X.GetConstDataPointer(), windowEntries, _X.GetDataPointer());
+                            TransformOutputTile();
+
+                            const int outputTileRows = std::min(_tileSize, numOutputRows - rowIndex);
+                            const int outputTileColumns = std::min(_tileSize, numOutputColumns - columnIndex);
+                            for (int i = 0; i < outputTileRows; ++i)
+                            {
+                                for (int j = 0; j < outputTileColumns; ++j)
+                                {
+                                    output(rowIndex + i, columnIndex + j, filterIndex) += _Y(i, j);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        void Convolve2DTilesFirst(const ConstTensorReference& input,
+                                  const ConstTensorReference& transformedFilters,
+                                  int numFilters,
+                                  Tensor& transformedInputScratch,
+                                  Tensor& transformedOutputScratch,
+                                  Tensor& output)
+        {
+            const int numOutputRows = static_cast<int>(input.NumRows()) - _filterSize + 1;
+            const int numOutputColumns = static_cast<int>(input.NumColumns()) - _filterSize + 1;
+            const int numChannels = static_cast<int>(input.NumChannels());
+            assert(numFilters == static_cast<int>(output.NumChannels()));
+
+            const int numTileRows = ((numOutputRows - 1) / _tileSize) + 1;
+            const int numTileColumns = ((numOutputColumns - 1) / _tileSize) + 1;
+            const int windowEntries = _windowSize * _windowSize;
+
+            // transformedInput is a (windowRows*windowColumns) x (numTileRows * numTileColumns) x (numChannels) tensor
+            const int inputWindowEntryStride = numTileRows * numTileColumns * numChannels;
+            auto transformedInputPtr = transformedInputScratch.GetDataPointer();
+            for (int tileRowIndex = 0; tileRowIndex < numTileRows; ++tileRowIndex)
+            {
+                for (int tileColumnIndex = 0; tileColumnIndex < numTileColumns; ++tileColumnIndex)
+                {
+                    const int tileIndex = tileRowIndex * numTileColumns + tileColumnIndex;
+                    for (int channelIndex = 0; channelIndex < numChannels; ++channelIndex)
+                    {
+                        TransformInputWindow(input, tileRowIndex * _tileSize, tileColumnIndex * _tileSize, channelIndex);
+                        const auto XPtr = _X.GetConstDataPointer();
+                        for (int windowPos = 0; windowPos < windowEntries; ++windowPos)
+                        {
+                            transformedInputPtr[windowPos * inputWindowEntryStride + tileIndex * numChannels + channelIndex] = XPtr[windowPos];
+                        }
+                    }
+                }
+            }
+
+            // transformedOutput is a (windowRows*windowColumns) x (numTileRows * numTileColumns) x (numFilters) tensor
+            ComputeTransformedOutput(transformedInputScratch, transformedFilters, numOutputRows, numOutputColumns, numChannels, numFilters, _tileSize, _filterSize, transformedOutputScratch);
+
+            // Un-transform convolved output and write into output image
+            const int outputWindowEntryStride = numTileRows * numTileColumns * numFilters;
+            const auto transformedOutputPtr = transformedOutputScratch.GetConstDataPointer();
+            for (int tileRowIndex = 0; tileRowIndex < numTileRows; ++tileRowIndex)
+            {
+                const int rowIndex = tileRowIndex * _tileSize;
+                const int outputTileRows = std::min(_tileSize, numOutputRows - rowIndex);
+                for (int tileColumnIndex = 0; tileColumnIndex < numTileColumns; ++tileColumnIndex)
+                {
+                    const int columnIndex = tileColumnIndex * _tileSize;
+                    const int outputTileColumns = std::min(_tileSize, numOutputColumns - columnIndex);
+                    const int tileIndex = tileRowIndex * numTileColumns + tileColumnIndex;
+                    for (int filterIndex = 0; filterIndex < numFilters; ++filterIndex)
+                    {
+                        auto XPtr = _X.GetDataPointer();
+                        for (int windowPos = 0; windowPos < windowEntries; ++windowPos)
+                        {
+                            XPtr[windowPos] = transformedOutputPtr[windowPos * outputWindowEntryStride + tileIndex * numFilters + filterIndex];
+                        }
+                        TransformOutputTile();
+
+                        for (int i = 0; i < outputTileRows; ++i)
+                        {
+                            for (int j = 0; j < outputTileColumns; ++j)
+                            {
+                                output(rowIndex + i, columnIndex + j, filterIndex) = _Y(i, j);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        // Computes X = B'dB for the window of one input channel at the given position, treating entries past the edge of the input as zero
+        void TransformInputWindow(const ConstTensorReference& input, int rowIndex, int columnIndex, int channelIndex)
+        {
+            const int numInputRows = static_cast<int>(input.NumRows());
+            const int numInputColumns = static_cast<int>(input.NumColumns());
+            for (int i = 0; i < _windowSize; ++i)
+            {
+                for (int j = 0; j < _windowSize; ++j)
+                {
+                    const bool inBounds = (rowIndex + i < numInputRows) && (columnIndex + j < numInputColumns);
+                    _d(i, j) = inBounds ? input(rowIndex + i, columnIndex + j, channelIndex) : 0;
+                }
+            }
+            Multiply(_d, _B, _dB);
+            Multiply(_Bt, _dB, _X);
+        }
+
+        // Computes Y = A'XA
+        void TransformOutputTile()
+        {
+            Multiply(_X, _A, _XA);
+            Multiply(_At, _XA, _Y);
+        }
+
+        int _tileSize;
+        int _filterSize;
+        int _windowSize;
+
+        Matrix _Bt;
+        Matrix _B;
+        Matrix _At;
+        Matrix _A;
+
+        // Temporaries
+        Matrix _d;
+        Matrix _dB;
+        Matrix _X;
+        Matrix _XA;
+        Matrix _Y;
+    };
+
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> AllocateScratchInput(int numOutputRows, int numOutputColumns, int numChannels, int tileSize, int filterSize, WinogradFilterOrder order)
     {
@@ -1526,7 +1885,7 @@ namespace dsp
         }
         else
         {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+            GenericWinograd2D<ValueType>(tileSize, filterSize).Convolve2DFiltersFirst(input, transformedFilters, numFilters, output);
         }
     }
 
@@ -1556,8 +1915,89 @@ namespace dsp
         }
         else
         {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+            GenericWinograd2D<ValueType>(tileSize, filterSize).Convolve2DTilesFirst(input, transformedFilters, numFilters, transformedInputScratch, transformedOutputScratch, output);
+        }
+    }
+
+    //
+    // Strided convolution, as a sum of unstrided ones
+    //
+    // With stride s, output(i, j) is the sum over the s*s phases (a, b) of (input_ab (*) filter_ab)(i, j), where input_ab(i, j) = input(s*i + a, s*j + b)
+    // is the input subsampled at that phase, and filter_ab(i, j) = filter(s*i + a, s*j + b) are the filter taps that touch it, padded with zeros
+    // to ceil(filterSize / s) taps. Each phase is an unstrided convolution with a smaller filter, so it can use the Winograd algorithm
+    // (e.g., a 3x3 stride-2 convolution becomes four F(m x m, 2 x 2) convolutions).
+    //
+    template <typename ValueType, typename ConvolveFunction>
+    math::ChannelColumnRowTensor<ValueType> ConvolveStridedPhases(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int stride, ConvolveFunction&& convolve)
+    {
+        using Tensor = math::ChannelColumnRowTensor<ValueType>;
+        if (stride < 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Convolution stride must be positive");
+        }
+
+        // filters is a (numFilters * filterSize) x filterSize x numFilterChannels tensor
+        const int filterSize = static_cast<int>(filters.NumColumns());
+        const int numFilterChannels = static_cast<int>(filters.NumChannels());
+        const int numInputRows = static_cast<int>(input.NumRows());
+        const int numInputColumns = static_cast<int>(input.NumColumns());
+        const int numChannels = static_cast<int>(input.NumChannels());
+        const int numOutputRows = (numInputRows - filterSize + 1) / stride; // the same output size as the other convolution methods
+        const int numOutputColumns = (numInputColumns - filterSize + 1) / stride;
+
+        const int phaseFilterSize = (filterSize + stride - 1) / stride;
+        const int numPhaseRows = numOutputRows + phaseFilterSize - 1;
+        const int numPhaseColumns = numOutputColumns + phaseFilterSize - 1;
+
+        Tensor output(numOutputRows, numOutputColumns, numFilters);
+        Tensor phaseInput(numPhaseRows, numPhaseColumns, numChannels);
+        Tensor phaseFilters(numFilters * phaseFilterSize, phaseFilterSize, numFilterChannels);
+        for (int rowPhase = 0; rowPhase < std::min(stride, filterSize); ++rowPhase)
+        {
+            for (int columnPhase = 0; columnPhase < std::min(stride, filterSize); ++columnPhase)
+            {
+                for (int i = 0; i < numPhaseRows; ++i)
+                {
+                    const int rowIndex = stride * i + rowPhase;
+                    for (int j = 0; j < numPhaseColumns; ++j)
+                    {
+                        const int columnIndex = stride * j + columnPhase;
+                        const bool inBounds = rowIndex < numInputRows && columnIndex < numInputColumns;
+                        for (int channelIndex = 0; channelIndex < numChannels; ++channelIndex)
+                        {
+                            phaseInput(i, j, channelIndex) = inBounds ? input(rowIndex, columnIndex, channelIndex) : 0;
+                        }
+                    }
+                }
+
+                for (int filterIndex = 0; filterIndex < numFilters; ++filterIndex)
+                {
+                    for (int i = 0; i < phaseFilterSize; ++i)
+                    {
+                        const int filterRow = stride * i + rowPhase;
+                        for (int j = 0; j < phaseFilterSize; ++j)
+                        {
+                            const int filterColumn = stride * j + columnPhase;
+                            const bool inBounds = filterRow < filterSize && filterColumn < filterSize;
+                            for (int channelIndex = 0; channelIndex < numFilterChannels; ++channelIndex)
+                            {
+                                phaseFilters(filterIndex * phaseFilterSize + i, j, channelIndex) = inBounds ? filters(filterIndex * filterSize + filterRow, filterColumn, channelIndex) : 0;
+                            }
+                        }
+                    }
+                }
+
+                const auto phaseOutput = convolve(phaseInput, phaseFilters);
+                assert(phaseOutput.Size() == output.Size());
+                const auto phaseOutputPtr = phaseOutput.GetConstDataPointer();
+                auto outputPtr = output.GetDataPointer();
+                for (size_t index = 0; index < output.Size(); ++index)
+                {
+                    outputPtr[index] += phaseOutputPtr[index];
+                }
+            }
         }
+        return output;
     }
 
     //
@@ -1575,7 +2015,6 @@ namespace dsp
     template <typename ValueType>
     math::RowVector<ValueType> Convolve1DWinograd(const math::RowVector<ValueType>& input, const math::RowVector<ValueType>& filter, int tileSize)
     {
-        using namespace std::string_literals;
         const int filterSize = static_cast<int>(filter.Size());
         const int outputSize = static_cast<int>(input.Size()) - filterSize + 1;
         math::RowVector<ValueType> output(outputSize);
@@ -1585,7 +2024,7 @@ namespace dsp
         }
         else
         {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "1D Winograd convolution not implemented for tile size "s + std::to_string(tileSize) + " and filter size " + std::to_string(filterSize));
+            ConvolveWinograd1DGeneric(input, filter, tileSize, output);
         }
         return output;
     }
@@ -1609,6 +2048,19 @@ namespace dsp
         return Convolve2DWinogradPretransformed(input, transformedFilters, numFilters, tileSize, filterSize, order);
     }
 
+    template <typename ValueType>
+    math::ChannelColumnRowTensor<ValueType> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int tileSize, int stride, WinogradFilterOrder order)
+    {
+        if (stride == 1)
+        {
+            return Convolve2DWinograd(input, filters, numFilters, tileSize, order);
+        }
+
+        return ConvolveStridedPhases(input, filters, numFilters, stride, [numFilters, tileSize, order](const auto& phaseInput, const auto& phaseFilters) {
+            return Convolve2DWinograd<ValueType>(phaseInput, phaseFilters, numFilters, tileSize, order);
+        });
+    }
+
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> Convolve2DWinogradPretransformed(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& transformedFilters, int numFilters, int tileSize, int filterSize, WinogradFilterOrder order)
     {
@@ -1659,6 +2111,19 @@ namespace dsp
         return Convolve2DWinogradDepthwiseSeparablePretransformed(input, transformedFilters, numFilters, tileSize, filterSize, order);
     }
 
+    template <typename ValueType>
+    math::ChannelColumnRowTensor<ValueType> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& filters, int numFilters, int tileSize, int stride, WinogradFilterOrder order)
+    {
+        if (stride == 1)
+        {
+            return Convolve2DWinogradDepthwiseSeparable(input, filters, numFilters, tileSize, order);
+        }
+
+        return ConvolveStridedPhases(input, filters, numFilters, stride, [numFilters, tileSize, order](const auto& phaseInput, const auto& phaseFilters) {
+            return Convolve2DWinogradDepthwiseSeparable<ValueType>(phaseInput, phaseFilters, numFilters, tileSize, order);
+        });
+    }
+
     template <typename ValueType>
     math::ChannelColumnRowTensor<ValueType> Convolve2DWinogradDepthwiseSeparablePretransformed(const math::ConstChannelColumnRowTensorReference<ValueType>& input, const math::ConstChannelColumnRowTensorReference<ValueType>& transformedFilters, int numFilters, int tileSize, int filterSize, WinogradFilterOrder order)
     {
@@ -1680,7 +2145,7 @@ namespace dsp
         }
         else
         {
-            assert(false && "Tile and filter size not implemented");
+            GenericWinograd2D<ValueType>(tileSize, filterSize).Convolve2DFiltersFirst(input, transformedFilters, numFilters, output);
         }
 
         return output;
@@ -1699,17 +2164,21 @@ namespace dsp
     // Basic tensor-valued 2D entry points
     template math::ChannelColumnRowTensor<float> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<float> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int tileSize, WinogradFilterOrder order);
+    template math::ChannelColumnRowTensor<float> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int tileSize, int stride, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<float> Convolve2DWinogradPretransformed(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& transformedFilters, int numFilters, int tileSize, int filterSize, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<double> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<double> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int tileSize, WinogradFilterOrder order);
+    template math::ChannelColumnRowTensor<double> Convolve2DWinograd(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int tileSize, int stride, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<double> Convolve2DWinogradPretransformed(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& transformedFilters, int numFilters, int tileSize, int filterSize, WinogradFilterOrder order);
 
     // Depthwise-separable versions
     template math::ChannelColumnRowTensor<float> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<float> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int tileSize, WinogradFilterOrder order);
+    template math::ChannelColumnRowTensor<float> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& filters, int numFilters, int tileSize, int stride, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<float> Convolve2DWinogradDepthwiseSeparablePretransformed(const math::ConstChannelColumnRowTensorReference<float>& input, const math::ConstChannelColumnRowTensorReference<float>& transformedFilters, int numFilters, int tileSize, int filterSize, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<double> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<double> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int tileSize, WinogradFilterOrder order);
+    template math::ChannelColumnRowTensor<double> Convolve2DWinogradDepthwiseSeparable(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& filters, int numFilters, int tileSize, int stride, WinogradFilterOrder order);
     template math::ChannelColumnRowTensor<double> Convolve2DWinogradDepthwiseSeparablePretransformed(const math::ConstChannelColumnRowTensorReference<double>& input, const math::ConstChannelColumnRowTensorReference<double>& transformedFilters, int numFilters, int tileSize, int filterSize, WinogradFilterOrder order);
 
     // Winograd matrix functions
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <dsp/include/Convolution.h>
+#include <dsp/include/WinogradConvolution.h>
 
 struct Extent2D
 {
@@ -31,6 +32,12 @@ void TestConv1D(ell::dsp::ConvolutionMethodOption algorithm);
 template <typename ValueType>
 void TestConv1DVsSimple(int size, int filterSize, ell::dsp::ConvolutionMethodOption algorithm);
 
+template <typename ValueType>
+void TestConv1DWinogradVsSimple(int size, int filterSize, int tileSize);
+
+template <typename ValueType>
+void TestConv1DFFTVsSimple(int size, int filterSize, int fftSize);
+
 // 2D convolution over a tensor
 template <typename ValueType>
 void TestConv2D(ell::dsp::ConvolutionMethodOption algorithm);
@@ -38,9 +45,18 @@ void TestConv2D(ell::dsp::ConvolutionMethodOption algorithm);
 template <typename ValueType>
 void TestConv2DVsSimple(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int stride, ell::dsp::ConvolutionMethodOption algorithm);
 
+template <typename ValueType>
+void TestConv2DWinogradVsSimple(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int tileSize, int stride, ell::dsp::WinogradFilterOrder order);
+
+template <typename ValueType>
+void TestConv2DFFTVsSimple(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int stride);
+
 // Depthwise-separable 2D (multiple "flat" 2D in parallel)
 template <typename ValueType>
 void TestConv2DSeparable(ell::dsp::ConvolutionMethodOption algorithm);
 
 template <typename ValueType>
 void TestConv2DSeparableVsSimple(int numRows, int numColumns, int numChannels, int filterSize, int stride, ell::dsp::ConvolutionMethodOption algorithm);
+
+template <typename ValueType>
+void TestConv2DSeparableWinogradVsSimple(int numRows, int numColumns, int numChannels, int filterSize, int tileSize, int stride);
@@ -13,5 +13,8 @@
 template <typename ValueType>
 void TestFFT(size_t N);
 
+template <typename ValueType>
+void TestFFTPlan(size_t N);
+
 template <typename ValueType>
 void VerifyFFT();
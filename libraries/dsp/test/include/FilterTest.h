@@ -16,3 +16,6 @@ void TestIIRFilterMultiSample();
 
 template <typename ValueType>
 void TestIIRFilterImpulse();
+
+template <typename ValueType>
+void TestBiquadFilter();
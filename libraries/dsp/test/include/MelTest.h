@@ -8,5 +8,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 void TestMelFilterBank();
 void TestMelFilterBank2();
+void TestFilterBankApply(size_t beginFilter, size_t endFilter, double offset);
@@ -12,3 +12,6 @@
 
 template <typename ValueType>
 void TestVoiceActivityDetector(const std::string& path);
+
+void TestVoiceActivityDetectorLevel(const std::string& path);
+void TestVoiceActivityDetectorDecimation();
@@ -11,6 +11,8 @@
 #include "DSPTestUtilities.h"
 
 #include <dsp/include/Convolution.h>
+#include <dsp/include/FFTConvolution.h>
+#include <dsp/include/WinogradConvolution.h>
 
 #include <math/include/MathConstants.h>
 #include <math/include/Tensor.h>
@@ -22,10 +24,12 @@
 
 #include <utilities/include/MillisecondTimer.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 using namespace ell;
@@ -56,6 +60,31 @@ math::ChannelColumnRowTensor<ValueType>& operator-=(math::ChannelColumnRowTensor
 }
 
 const double epsilon = 1e-6;
+
+// Larger Winograd tiles have transform matrices with fractional entries, which float arithmetic can't represent exactly
+template <typename ValueType>
+ValueType GetWinogradTolerance(int tileSize)
+{
+    return static_cast<ValueType>((tileSize > 2 && std::is_same<ValueType, float>::value) ? 1e-3 : epsilon);
+}
+
+// FFTs round every output to about the precision of the largest input times the filter size
+template <typename ValueType>
+ValueType GetFFTTolerance()
+{
+    return static_cast<ValueType>(std::is_same<ValueType, float>::value ? 1e-3 : epsilon);
+}
+
+template <typename ValueType>
+ValueType GetMaxDifference(const std::vector<ValueType>& a, const std::vector<ValueType>& b)
+{
+    ValueType maxDifference = 0;
+    for (size_t index = 0; index < a.size(); ++index)
+    {
+        maxDifference = std::max(maxDifference, std::abs(a[index] - b[index]));
+    }
+    return maxDifference;
+}
 } // namespace
 
 //
@@ -314,6 +343,139 @@ void TestConv2DSeparableVsSimple(int numRows, int numColumns, int numChannels, i
     }
 }
 
+template <typename ValueType>
+void TestConv1DWinogradVsSimple(int length, int filterSize, int tileSize)
+{
+    using Vector = math::RowVector<ValueType>;
+
+    Vector signal(length);
+    Vector filter(filterSize);
+
+    FillInputVector(signal);
+    FillFilterVector(filter);
+
+    // Perform the convolution
+    auto reference = Convolve1D(signal, filter, dsp::ConvolutionMethodOption::simple);
+    auto result = dsp::Convolve1DWinograd(signal, filter, tileSize);
+
+    // Compare results
+    bool ok = testing::ProcessTest("Testing 1D Winograd F(" + std::to_string(tileSize) + "," + std::to_string(filterSize) + ") convolution result", reference.IsEqual(result, GetWinogradTolerance<ValueType>(tileSize)));
+    if (!ok)
+    {
+        std::cout << "Incorrect result for 1D Winograd convolution on input of size " << signal.Size() << std::endl;
+        std::cout << "Max difference:  " << GetMaxDifference(reference.ToArray(), result.ToArray()) << std::endl;
+    }
+}
+
+template <typename ValueType>
+void TestConv2DWinogradVsSimple(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int tileSize, int stride, dsp::WinogradFilterOrder order)
+{
+    using Tensor = math::ChannelColumnRowTensor<ValueType>;
+
+    const auto filterRows = filterSize;
+    const auto filterColumns = filterSize;
+    Tensor signal(numRows, numColumns, numChannels);
+    Tensor filters(numFilters * filterRows, filterColumns, numChannels);
+
+    FillInputTensor(signal);
+    FillFiltersTensor(filters, numFilters);
+
+    // Perform the convolution
+    auto reference = Convolve2D(signal, filters, numFilters, stride, dsp::ConvolutionMethodOption::simple);
+    auto result = dsp::Convolve2DWinograd(signal, filters, numFilters, tileSize, stride, order);
+
+    // Compare results
+    bool ok = testing::ProcessTest("Testing 2D Winograd tile size " + std::to_string(tileSize) + ", stride " + std::to_string(stride) + " convolution result", reference.IsEqual(result, GetWinogradTolerance<ValueType>(tileSize)));
+    if (!ok)
+    {
+        std::cout << "Incorrect result for 2D tensor Winograd convolution on input of size " << signal.NumRows() << " x " << signal.NumColumns() << " x " << signal.NumChannels() << std::endl;
+        std::cout << "Max difference:  " << GetMaxDifference(reference.ToArray(), result.ToArray()) << std::endl;
+    }
+}
+
+template <typename ValueType>
+void TestConv2DSeparableWinogradVsSimple(int numRows, int numColumns, int numChannels, int filterSize, int tileSize, int stride)
+{
+    using Tensor = math::ChannelColumnRowTensor<ValueType>;
+
+    const int numFilters = numChannels;
+    const auto filterRows = filterSize;
+    const auto filterColumns = filterSize;
+    Tensor signal(numRows, numColumns, numChannels);
+    Tensor filters(numFilters * filterRows, filterColumns, 1);
+
+    FillInputTensor(signal);
+    FillFiltersTensor(filters, numFilters);
+
+    // Perform the convolution
+    auto reference = Convolve2DDepthwiseSeparable(signal, filters, numFilters, stride, dsp::ConvolutionMethodOption::simple);
+    auto result = dsp::Convolve2DWinogradDepthwiseSeparable(signal, filters, numFilters, tileSize, stride);
+
+    // Compare results
+    bool ok = testing::ProcessTest("Testing 2D separable Winograd tile size " + std::to_string(tileSize) + ", stride " + std::to_string(stride) + " convolution result", reference.IsEqual(result, GetWinogradTolerance<ValueType>(tileSize)));
+    if (!ok)
+    {
+        std::cout << "Incorrect result for 2D separable tensor Winograd convolution on input of size " << signal.NumRows() << " x " << signal.NumColumns() << " x " << signal.NumChannels() << std::endl;
+        std::cout << "Max difference:  " << GetMaxDifference(reference.ToArray(), result.ToArray()) << std::endl;
+    }
+}
+
+template <typename ValueType>
+void TestConv1DFFTVsSimple(int length, int filterSize, int fftSize)
+{
+    using Vector = math::RowVector<ValueType>;
+
+    Vector signal(length);
+    Vector filter(filterSize);
+
+    FillInputVector(signal);
+    FillFilterVector(filter);
+
+    // Perform the convolution twice with the same filter spectrum, the second time on a shorter signal
+    auto reference = Convolve1D(signal, filter, dsp::ConvolutionMethodOption::simple);
+    dsp::FFTConvolution1D<ValueType> convolution(filter, fftSize);
+    Vector result(reference.Size());
+    convolution.Convolve(signal, result);
+    Vector prefixResult(reference.Size() / 2);
+    convolution.Convolve(signal.GetSubVector(0, prefixResult.Size() + filterSize - 1), prefixResult);
+
+    // Compare results
+    auto tolerance = GetFFTTolerance<ValueType>();
+    bool ok = testing::ProcessTest("Testing 1D FFT, FFT size " + std::to_string(convolution.GetFFTSize()) + " convolution result", reference.IsEqual(result, tolerance) && reference.GetSubVector(0, prefixResult.Size()).IsEqual(prefixResult, tolerance));
+    if (!ok)
+    {
+        std::cout << "Incorrect result for 1D FFT convolution on input of size " << signal.Size() << " with filter of size " << filterSize << std::endl;
+        std::cout << "Max difference:  " << GetMaxDifference(reference.ToArray(), result.ToArray()) << std::endl;
+    }
+}
+
+template <typename ValueType>
+void TestConv2DFFTVsSimple(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int stride)
+{
+    using Tensor = math::ChannelColumnRowTensor<ValueType>;
+
+    const auto filterRows = filterSize;
+    const auto filterColumns = filterSize;
+    Tensor signal(numRows, numColumns, numChannels);
+    Tensor filters(numFilters * filterRows, filterColumns, numChannels);
+
+    FillInputTensor(signal);
+    FillFiltersTensor(filters, numFilters);
+
+    // Perform the convolution, writing the result into existing storage
+    auto reference = Convolve2D(signal, filters, numFilters, stride, dsp::ConvolutionMethodOption::simple);
+    Tensor result(reference.NumRows(), reference.NumColumns(), reference.NumChannels());
+    Convolve2D(signal, filters, numFilters, stride, result, dsp::ConvolutionMethodOption::fft);
+
+    // Compare results
+    bool ok = testing::ProcessTest("Testing 2D FFT, stride " + std::to_string(stride) + " convolution result", reference.IsEqual(result, GetFFTTolerance<ValueType>()));
+    if (!ok)
+    {
+        std::cout << "Incorrect result for 2D tensor FFT convolution on input of size " << signal.NumRows() << " x " << signal.NumColumns() << " x " << signal.NumChannels() << std::endl;
+        std::cout << "Max difference:  " << GetMaxDifference(reference.ToArray(), result.ToArray()) << std::endl;
+    }
+}
+
 //
 // Explicit instantiations
 //
@@ -323,15 +485,25 @@ template void TestConv1D<float>(dsp::ConvolutionMethodOption);
 template void TestConv1D<double>(dsp::ConvolutionMethodOption);
 template void TestConv1DVsSimple<float>(int size, int filterSize, dsp::ConvolutionMethodOption algorithm);
 template void TestConv1DVsSimple<double>(int size, int filterSize, dsp::ConvolutionMethodOption algorithm);
+template void TestConv1DWinogradVsSimple<float>(int size, int filterSize, int tileSize);
+template void TestConv1DWinogradVsSimple<double>(int size, int filterSize, int tileSize);
+template void TestConv1DFFTVsSimple<float>(int size, int filterSize, int fftSize);
+template void TestConv1DFFTVsSimple<double>(int size, int filterSize, int fftSize);
 
 // 2D
 template void TestConv2D<float>(dsp::ConvolutionMethodOption);
 template void TestConv2D<double>(dsp::ConvolutionMethodOption);
 template void TestConv2DVsSimple<float>(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int stride, dsp::ConvolutionMethodOption algorithm);
 template void TestConv2DVsSimple<double>(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int stride, dsp::ConvolutionMethodOption algorithm);
+template void TestConv2DWinogradVsSimple<float>(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int tileSize, int stride, dsp::WinogradFilterOrder order);
+template void TestConv2DWinogradVsSimple<double>(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int tileSize, int stride, dsp::WinogradFilterOrder order);
+template void TestConv2DFFTVsSimple<float>(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int stride);
+template void TestConv2DFFTVsSimple<double>(int numRows, int numColumns, int numChannels, int filterSize, int numFilters, int stride);
 
 // Depthwise-separable (i.e., multiple 2D in parallel)
 template void TestConv2DSeparable<float>(dsp::ConvolutionMethodOption);
 template void TestConv2DSeparable<double>(dsp::ConvolutionMethodOption);
 template void TestConv2DSeparableVsSimple<float>(int numRows, int numColumns, int numChannels, int filterSize, int stride, dsp::ConvolutionMethodOption algorithm);
 template void TestConv2DSeparableVsSimple<double>(int numRows, int numColumns, int numChannels, int filterSize, int stride, dsp::ConvolutionMethodOption algorithm);
+template void TestConv2DSeparableWinogradVsSimple<float>(int numRows, int numColumns, int numChannels, int filterSize, int tileSize, int stride);
+template void TestConv2DSeparableWinogradVsSimple<double>(int numRows, int numColumns, int numChannels, int filterSize, int tileSize, int stride);
@@ -82,6 +82,25 @@ void TestDCTMatrix(const std::vector<std::vector<double>>& refMatrixValues, bool
     }
 }
 
+template <typename ValueType>
+void TestFastDCT(size_t windowSize, size_t numFilters)
+{
+    const ValueType epsilon = static_cast<ValueType>(std::is_same<ValueType, float>::value ? 1e-3 : 1e-9);
+    std::vector<ValueType> signal(windowSize);
+    for (size_t index = 0; index < windowSize; ++index)
+    {
+        signal[index] = static_cast<ValueType>(std::sin(0.37 * index) + 0.01 * index);
+    }
+
+    auto dctMatrix = GetDCTMatrix<ValueType>(windowSize, numFilters);
+    auto expected = DCT<ValueType>(dctMatrix, ColumnVector<ValueType>(signal));
+
+    DCTPlan<ValueType> plan(windowSize, numFilters);
+    std::vector<ValueType> result(numFilters);
+    plan.Transform(signal.data(), result.data());
+    testing::ProcessTest("Testing fast DCT of size " + std::to_string(windowSize) + " with " + std::to_string(numFilters) + " coefficients", testing::IsEqual(expected.ToArray(), result, epsilon));
+}
+
 void TestDCT()
 {
     TestDCTMatrix(dct_precomputed);
@@ -103,4 +122,17 @@ void TestDCT()
     // TestDCTMatrix(GetDCTReference_III_64_40());
     // TestDCTMatrix(GetDCTReference_III_128_13());
     // TestDCTMatrix(GetDCTReference_III_128_40());
+
+    // A truncated DCT matrix is the first rows of the full one
+    auto truncated = GetDCTMatrix<float>(40, 13);
+    auto full = GetDCTMatrix<float>(40, 40);
+    testing::ProcessTest("Testing truncated DCT generation", truncated.NumRows() == 13 && truncated.NumColumns() == 40 && truncated.IsEqual(full.GetSubMatrix(0, 0, 13, 40)));
+
+    // FFT-based DCT vs. the DCT matrix
+    TestFastDCT<float>(2, 2);
+    TestFastDCT<float>(64, 64);
+    TestFastDCT<float>(64, 13);
+    TestFastDCT<double>(128, 128);
+    TestFastDCT<double>(128, 40);
+    TestFastDCT<double>(256, 200);
 }
@@ -65,6 +65,8 @@ std::string GetConvAlgName(dsp::ConvolutionMethodOption alg)
         return "diagonal";
     case dsp::ConvolutionMethodOption::winograd:
         return "winograd";
+    case dsp::ConvolutionMethodOption::fft:
+        return "fft";
     }
     return "";
 }
@@ -11,6 +11,7 @@
 
 #include <dsp/include/FFT.h>
 
+#include <math/include/MathConstants.h>
 #include <math/include/Vector.h>
 #include <math/include/VectorOperations.h>
 
@@ -20,6 +21,7 @@
 
 #include <complex>
 #include <random>
+#include <string>
 #include <vector>
 
 using namespace ell;
@@ -83,6 +85,57 @@ void TestFFT(size_t N)
     }
 }
 
+template <typename ValueType>
+void TestFFTPlan(size_t N)
+{
+    const ValueType epsilon = static_cast<ValueType>(1e-4);
+    FFTPlan<ValueType> plan(N);
+
+    auto randomEngine = utilities::GetRandomEngine();
+    std::uniform_real_distribution<ValueType> uniform(-1, 1);
+    std::vector<ValueType> signal(N);
+    std::vector<std::complex<ValueType>> complexSignal(N);
+    std::vector<std::complex<ValueType>> realOutput(N / 2 + 1);
+
+    // Reuse the plan for several signals
+    for (int iteration = 0; iteration < 3; ++iteration)
+    {
+        for (size_t index = 0; index < N; ++index)
+        {
+            signal[index] = uniform(randomEngine);
+            complexSignal[index] = signal[index];
+        }
+
+        // Compare against the definition of the DFT
+        std::vector<std::complex<ValueType>> reference(N);
+        const double pi = math::Constants<double>::pi;
+        for (size_t k = 0; k < N; ++k)
+        {
+            std::complex<double> sum = 0;
+            for (size_t n = 0; n < N; ++n)
+            {
+                sum += static_cast<double>(signal[n]) * std::exp(std::complex<double>(0, 2 * pi * k * n / N));
+            }
+            reference[k] = { static_cast<ValueType>(sum.real()), static_cast<ValueType>(sum.imag()) };
+        }
+
+        plan.Transform(complexSignal.data());
+        plan.TransformReal(signal.data(), realOutput.data());
+        bool complexOk = true;
+        bool realOk = true;
+        for (size_t k = 0; k < N; ++k)
+        {
+            complexOk = complexOk && std::abs(complexSignal[k] - reference[k]) < epsilon;
+            if (k <= N / 2)
+            {
+                realOk = realOk && std::abs(realOutput[k] - reference[k]) < epsilon;
+            }
+        }
+        testing::ProcessTest("Testing FFT plan of size " + std::to_string(N), complexOk);
+        testing::ProcessTest("Testing real-valued FFT plan of size " + std::to_string(N), realOk);
+    }
+}
+
 template <typename ValueType>
 void VerifyFFT(std::vector<ValueType> input, const std::vector<ValueType>& reference)
 {
@@ -110,5 +163,8 @@ void VerifyFFT()
 template void TestFFT<float>(size_t);
 template void TestFFT<double>(size_t);
 
+template void TestFFTPlan<float>(size_t);
+template void TestFFTPlan<double>(size_t);
+
 template void VerifyFFT<float>();
 template void VerifyFFT<double>();
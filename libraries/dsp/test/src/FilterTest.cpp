@@ -6,10 +6,12 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <dsp/include/BiquadFilter.h>
 #include <dsp/include/IIRFilter.h>
 
 #include <testing/include/testing.h>
 
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -57,6 +59,48 @@ void TestIIRFilterImpulse()
     testing::ProcessTest("Testing FIR filtering of impulse signal", testing::IsEqual(y, bCoeffs, epsilon));
 }
 
+template <typename ValueType>
+void TestBiquadFilter()
+{
+    const ValueType epsilon = static_cast<ValueType>(1e-4);
+    const size_t numChannels = 3;
+    const size_t numFrames = 64;
+
+    // A 4th-order Butterworth lowpass filter (scipy.signal.butter(4, 0.2)), which has a quadruple zero at -1
+    std::vector<ValueType> b = { static_cast<ValueType>(0.00482434), static_cast<ValueType>(0.01929737), static_cast<ValueType>(0.02894606), static_cast<ValueType>(0.01929737), static_cast<ValueType>(0.00482434) };
+    std::vector<ValueType> a = { static_cast<ValueType>(-2.36951301), static_cast<ValueType>(2.31398841), static_cast<ValueType>(-1.05466541), static_cast<ValueType>(0.18737949) };
+    auto sections = GetSecondOrderSections(b, a);
+    testing::ProcessTest("Testing second-order sections of 4th-order filter", sections.size() == 2);
+
+    std::vector<ValueType> x(numChannels * numFrames);
+    for (size_t index = 0; index < x.size(); ++index)
+    {
+        x[index] = static_cast<ValueType>(std::sin(0.7 * index) + static_cast<double>(index % numChannels));
+    }
+
+    // Filter the channels all at once, and in two halves, to check that the state is kept between calls
+    BiquadFilter<ValueType> biquadFilter(sections, numChannels);
+    auto y = biquadFilter.FilterSamples(x);
+    biquadFilter.Reset();
+    auto firstHalf = biquadFilter.FilterSamples(std::vector<ValueType>(x.begin(), x.begin() + x.size() / 2));
+    auto secondHalf = biquadFilter.FilterSamples(std::vector<ValueType>(x.begin() + x.size() / 2, x.end()));
+    firstHalf.insert(firstHalf.end(), secondHalf.begin(), secondHalf.end());
+
+    bool ok = true;
+    IIRFilter<ValueType> filter(b, a);
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        filter.Reset();
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            auto expected = filter.FilterSample(x[frame * numChannels + channel]);
+            ok &= testing::IsEqual(y[frame * numChannels + channel], expected, epsilon);
+        }
+    }
+    testing::ProcessTest("Testing biquad filter cascade vs. direct form IIR filter", ok);
+    testing::ProcessTest("Testing biquad filter state", testing::IsEqual(firstHalf, y, epsilon));
+}
+
 //
 // Explicit instantiations
 //
@@ -68,3 +112,6 @@ template void TestIIRFilterMultiSample<double>();
 
 template void TestIIRFilterImpulse<float>();
 template void TestIIRFilterImpulse<double>();
+
+template void TestBiquadFilter<float>();
+template void TestBiquadFilter<double>();
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FixedPointTest.cpp (dsp)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FixedPointTest.h"
+
+#include <dsp/include/FFT.h>
+#include <dsp/include/FixedPoint.h>
+
+#include <testing/include/testing.h>
+
+#include <utilities/include/RandomEngines.h>
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ell;
+using namespace dsp;
+
+void TestFixedPointConversions()
+{
+    bool ok = ToQ15(0.5) == 16384 && ToQ15(-0.25) == -8192 && ToQ15(1.0) == q15Max && ToQ15(-2.0) == q15Min;
+    ok = ok && FromQ15(16384) == 0.5 && ToQ31(0.5) == (1 << 30) && FromQ31(ToQ31(-0.75)) == -0.75;
+    testing::ProcessTest("Testing Q15 and Q31 conversions", ok);
+
+    ok = SaturateQ15(40000) == q15Max && SaturateQ15(-40000) == q15Min && SaturateQ15(-5) == -5;
+    ok = ok && RoundingShiftRight(3, 1) == 2 && RoundingShiftRight(-3, 1) == -1 && RoundingShiftRight(5, 0) == 5;
+    ok = ok && MultiplyQ15(16384, 16384) == 8192 && MultiplyQ15(q15Min, q15Min) == q15Max && MultiplyQ31(1 << 30, 1 << 30) == (1 << 29);
+    testing::ProcessTest("Testing fixed-point arithmetic", ok);
+
+    ok = IntegerSquareRoot(0) == 0 && IntegerSquareRoot(99) == 9 && IntegerSquareRoot(100) == 10 && IntegerSquareRoot(1 << 30) == (1 << 15);
+    ok = ok && IntegerSquareRoot(2 * q15Max * q15Max) == static_cast<int32_t>(std::sqrt(2.0) * q15Max);
+    testing::ProcessTest("Testing integer square root", ok);
+
+    ok = GetHeadroomShift(0.5) == 0 && GetHeadroomShift(1.0) == 0 && GetHeadroomShift(1.5) == 1 && GetHeadroomShift(40) == 6;
+    testing::ProcessTest("Testing headroom shift", ok);
+}
+
+void TestFixedPointFFT(size_t N)
+{
+    // The fixed-point FFT computes the magnitudes divided by N, with about an LSB of error from each stage
+    const double epsilon = 16.0 / (1 << q15FractionalBits);
+    FixedPointFFTPlan fixedPlan(N);
+    FFTPlan<double> plan(N);
+
+    auto randomEngine = utilities::GetRandomEngine();
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<double> signal(N);
+    std::vector<int> fixedSignal(N);
+    for (size_t index = 0; index < N; ++index)
+    {
+        signal[index] = uniform(randomEngine);
+        fixedSignal[index] = ToQ15(signal[index]);
+        signal[index] = FromQ15(fixedSignal[index]);
+    }
+    std::vector<std::complex<double>> spectrum(N / 2 + 1);
+    plan.TransformReal(signal.data(), spectrum.data());
+
+    std::vector<int> magnitudes(N / 2);
+    fixedPlan.TransformMagnitudes(fixedSignal.data(), fixedSignal.size(), magnitudes.data());
+    bool ok = true;
+    for (size_t k = 0; k < N / 2; ++k)
+    {
+        ok = ok && std::abs(FromQ15(magnitudes[k]) - std::abs(spectrum[k]) / N) < epsilon;
+    }
+    testing::ProcessTest("Testing fixed-point FFT of size " + std::to_string(N), ok);
+
+    // Full-scale signals saturate instead of overflowing
+    std::vector<int> dcSignal(N, q15Max);
+    fixedPlan.TransformMagnitudes(dcSignal.data(), dcSignal.size(), magnitudes.data());
+    testing::ProcessTest("Testing fixed-point FFT of a full-scale DC signal", std::abs(magnitudes[0] - q15Max) <= 1);
+}
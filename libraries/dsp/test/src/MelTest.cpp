@@ -64,3 +64,35 @@ void TestMelFilterBank2()
     VerifyMelFilterBank(8000, 512, 40, GetMelReference_8000_512_40());
     VerifyMelFilterBank(8000, 512, 13, GetMelReference_8000_512_13());
 }
+
+void TestFilterBankApply(size_t beginFilter, size_t endFilter, double offset)
+{
+    using namespace std::string_literals;
+    const double epsilon = 1e-6;
+    const size_t numFilters = 40;
+    const size_t windowSize = 512;
+    const double sampleRate = 16000;
+
+    auto filters = MelFilterBank(windowSize, sampleRate, numFilters, beginFilter, endFilter, offset);
+    std::vector<double> magnitudes(windowSize / 2 + 1);
+    for (size_t index = 0; index < magnitudes.size(); ++index)
+    {
+        magnitudes[index] = 1.0 + static_cast<double>(index % 7) / 3;
+    }
+
+    // Reference: dense dot product of each filter with the signal
+    std::vector<double> reference;
+    for (size_t filterIndex = beginFilter; filterIndex < endFilter; ++filterIndex)
+    {
+        auto filter = filters.GetFilter(filterIndex);
+        double sum = 0;
+        for (size_t index = 0; index < magnitudes.size(); ++index)
+        {
+            sum += magnitudes[index] * filter[index];
+        }
+        reference.push_back(sum);
+    }
+
+    auto result = filters.FilterFrequencyMagnitudes(magnitudes);
+    testing::ProcessTest("Testing filter bank application, filters ["s + std::to_string(beginFilter) + ", " + std::to_string(endFilter) + "), offset " + std::to_string(offset), testing::IsEqual(result, reference, epsilon));
+}
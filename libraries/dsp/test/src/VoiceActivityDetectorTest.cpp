@@ -110,6 +110,85 @@ void TestVoiceActivityDetector(const std::string& path)
     }
 }
 
+void TestVoiceActivityDetectorLevel(const std::string& path)
+{
+    const int FrameSize = 40;
+    VoiceActivityDetector vad(8000, FrameSize, 0.032, 1.54, 0.074326, 2.400160, 0.002885, 3.552713, 0.931252, 0.007885);
+    VoiceActivityDetector levelVad(8000, FrameSize, 0.032, 1.54, 0.074326, 2.400160, 0.002885, 3.552713, 0.931252, 0.007885);
+
+    std::string filename = utilities::JoinPaths(path, { "..", "VadData.txt" });
+    if (!utilities::FileExists(filename))
+    {
+        filename = utilities::JoinPaths(path, { "VadData.txt" });
+    }
+
+    // The level the front end would compute, the mean of the spectrum weighted by the detector's weights
+    const auto& weights = vad.GetWeights();
+    int errors = 0;
+    auto stream = utilities::OpenIfstream(filename);
+    data::AutoSupervisedExampleIterator exampleIterator = ell::common::GetAutoSupervisedExampleIterator(stream);
+    while (exampleIterator.IsValid())
+    {
+        std::vector<double> data = exampleIterator.Get().GetDataVector().ToArray();
+        data.resize(FrameSize);
+        double level = 0;
+        for (int i = 0; i < FrameSize; ++i)
+        {
+            level += data[i] * weights[i];
+        }
+        if (vad.Process(data) != levelVad.ProcessLevel(level / FrameSize))
+        {
+            ++errors;
+        }
+        exampleIterator.Next();
+    }
+    testing::ProcessTest("Testing VoiceActivityDetector::ProcessLevel", errors == 0);
+}
+
+void TestVoiceActivityDetectorDecimation()
+{
+    const int decimation = 4;
+    const int numQuietFrames = 50;
+    VoiceActivityDetector vad(8000, 40, 0.032, 1.54, 0.074326, 2.400160, 0.002885, 3.552713, 0.931252, 0.007885);
+    VoiceActivityDetector decimatedVad(8000, 40, 0.032, 1.54, 0.074326, 2.400160, 0.002885, 3.552713, 0.931252, 0.007885, decimation);
+
+    // Both detectors settle on silence, then the decimated one must see the onset of a loud signal within `decimation` frames
+    bool ok = true;
+    int onset = -1;
+    int decimatedOnset = -1;
+    for (int frame = 0; frame < numQuietFrames + 2 * decimation; ++frame)
+    {
+        double level = frame < numQuietFrames ? 0.01 : 1.0;
+        int signal = vad.ProcessLevel(level);
+        int decimatedSignal = decimatedVad.ProcessLevel(level);
+        if (frame < numQuietFrames)
+        {
+            ok = ok && signal == 0 && decimatedSignal == 0;
+        }
+        if (signal == 1 && onset < 0)
+        {
+            onset = frame;
+        }
+        if (decimatedSignal == 1 && decimatedOnset < 0)
+        {
+            decimatedOnset = frame;
+        }
+    }
+    ok = ok && onset == numQuietFrames && decimatedOnset >= onset && decimatedOnset < onset + decimation;
+    testing::ProcessTest("Testing VoiceActivityDetector decimation", ok);
+
+    SerializationContext context;
+    std::stringstream strstream;
+    {
+        JsonArchiver archiver(strstream);
+        archiver.Archive("vad", decimatedVad);
+    }
+    JsonUnarchiver unarchiver(strstream, context);
+    VoiceActivityDetector decimatedVad2;
+    unarchiver.Unarchive("vad", decimatedVad2);
+    testing::ProcessTest("Deserialize decimated VoiceActivityDetector", decimatedVad2.GetDecimation() == decimation && decimatedVad.Equals(decimatedVad2) && !decimatedVad.Equals(vad));
+}
+
 //
 // Explicit instantiations
 //
@@ -11,6 +11,7 @@
 #include "DSPTestData.h"
 #include "FFTTest.h"
 #include "FilterTest.h"
+#include "FixedPointTest.h"
 #include "MelTest.h"
 #include "VoiceActivityDetectorTest.h"
 #include "WindowTest.h"
@@ -19,6 +20,7 @@
 #include <dsp/include/FFT.h>
 #include <dsp/include/IIRFilter.h>
 #include <dsp/include/WindowFunctions.h>
+#include <dsp/include/WinogradConvolution.h>
 
 #include <utilities/include/Files.h>
 #include <utilities/include/Unused.h>
@@ -41,12 +43,25 @@ void DspTest(const std::string& path)
     // Voice Activity Detection
     TestVoiceActivityDetector<float>(path);
     TestVoiceActivityDetector<double>(path);
+    TestVoiceActivityDetectorLevel(path);
+    TestVoiceActivityDetectorDecimation();
 
     // 1D Convolution
     TestConv1D<float>(ConvolutionMethodOption::simple);
     TestConv1D<float>(ConvolutionMethodOption::winograd);
     TestConv1DVsSimple<float>(32, 3, ConvolutionMethodOption::winograd);
     TestConv1DVsSimple<float>(33, 3, ConvolutionMethodOption::winograd);
+    TestConv1DWinogradVsSimple<float>(33, 3, 4);
+    TestConv1DWinogradVsSimple<float>(33, 3, 6);
+    TestConv1DWinogradVsSimple<float>(64, 5, 4);
+    TestConv1DWinogradVsSimple<double>(65, 2, 6);
+    TestConv1DWinogradVsSimple<double>(64, 7, 3);
+    TestConv1D<double>(ConvolutionMethodOption::fft);
+    TestConv1DVsSimple<double>(33, 3, ConvolutionMethodOption::fft);
+    TestConv1DFFTVsSimple<float>(1000, 31, 0);
+    TestConv1DFFTVsSimple<float>(1000, 31, 32);
+    TestConv1DFFTVsSimple<double>(4096, 512, 0);
+    TestConv1DFFTVsSimple<double>(100000, 700, 2048);
 
     // 2D Convolution
 
@@ -86,6 +101,31 @@ void DspTest(const std::string& path)
     TestConv2DVsSimple<float>(121, 81, 8, 3, 16, 1, ConvolutionMethodOption::winograd);
     TestConv2DVsSimple<float>(60, 40, 64, 3, 128, 1, ConvolutionMethodOption::winograd);
     TestConv2DVsSimple<float>(129, 129, 128, 3, 128, 1, ConvolutionMethodOption::winograd);
+    TestConv2DVsSimple<float>(6, 6, 8, 3, 16, 2, ConvolutionMethodOption::winograd);
+    TestConv2DVsSimple<float>(121, 81, 8, 3, 16, 2, ConvolutionMethodOption::winograd);
+
+    // Winograd, with larger tiles and strides
+    for (auto order : { WinogradFilterOrder::tilesFirst, WinogradFilterOrder::filtersFirst })
+    {
+        TestConv2DWinogradVsSimple<float>(4, 4, 8, 3, 16, 4, 1, order);
+        TestConv2DWinogradVsSimple<float>(121, 81, 8, 3, 16, 4, 1, order);
+        TestConv2DWinogradVsSimple<float>(121, 81, 8, 3, 16, 6, 1, order);
+        TestConv2DWinogradVsSimple<double>(60, 40, 64, 3, 32, 6, 1, order);
+        TestConv2DWinogradVsSimple<double>(30, 31, 8, 5, 8, 4, 1, order);
+        TestConv2DWinogradVsSimple<float>(121, 81, 8, 3, 16, 2, 2, order);
+        TestConv2DWinogradVsSimple<float>(120, 80, 8, 3, 16, 4, 2, order);
+        TestConv2DWinogradVsSimple<double>(61, 40, 16, 5, 8, 4, 2, order);
+        TestConv2DWinogradVsSimple<double>(31, 31, 4, 3, 4, 2, 3, order);
+    }
+
+    // FFT
+    TestConv2D<double>(ConvolutionMethodOption::fft);
+    TestConv2DVsSimple<double>(6, 6, 8, 3, 16, 1, ConvolutionMethodOption::fft);
+    TestConv2DFFTVsSimple<float>(4, 4, 1, 3, 1, 1);
+    TestConv2DFFTVsSimple<float>(121, 81, 8, 3, 16, 1);
+    TestConv2DFFTVsSimple<float>(121, 81, 7, 5, 16, 2);
+    TestConv2DFFTVsSimple<double>(60, 200, 4, 31, 8, 1);
+    TestConv2DFFTVsSimple<double>(61, 40, 16, 5, 8, 3);
 
     // Depthwise-separable 2D convolution
     // Winograd
@@ -99,17 +139,39 @@ void DspTest(const std::string& path)
     TestConv2DSeparableVsSimple<float>(121, 81, 8, 3, 1, ConvolutionMethodOption::winograd);
     TestConv2DSeparableVsSimple<float>(60, 40, 64, 3, 1, ConvolutionMethodOption::winograd);
     TestConv2DSeparableVsSimple<float>(129, 129, 128, 3, 1, ConvolutionMethodOption::winograd);
+    TestConv2DSeparableVsSimple<float>(121, 81, 8, 3, 2, ConvolutionMethodOption::winograd);
+    TestConv2DSeparableWinogradVsSimple<float>(121, 81, 8, 3, 4, 1);
+    TestConv2DSeparableWinogradVsSimple<float>(121, 81, 8, 3, 6, 1);
+    TestConv2DSeparableWinogradVsSimple<float>(120, 80, 8, 3, 4, 2);
+
+    // FFT
+    TestConv2DSeparableVsSimple<double>(121, 81, 8, 3, 1, ConvolutionMethodOption::fft);
+    TestConv2DSeparableVsSimple<double>(60, 40, 7, 5, 2, ConvolutionMethodOption::fft);
 
     // FFT
     TestFFT<float>(16);
     TestFFT<double>(16);
+    for (size_t size : { 1, 2, 4, 8, 64, 512 })
+    {
+        TestFFTPlan<float>(size);
+        TestFFTPlan<double>(size);
+    }
     VerifyFFT<float>();
     VerifyFFT<double>();
 
+    // Fixed-point
+    TestFixedPointConversions();
+    for (size_t size : { 2, 16, 512 })
+    {
+        TestFixedPointFFT(size);
+    }
+
     // Filters
     TestIIRFilter<float>();
     TestIIRFilterMultiSample<float>();
     TestIIRFilterImpulse<float>();
+    TestBiquadFilter<float>();
+    TestBiquadFilter<double>();
 
     // Window functions
     TestHammingWindow<float>();
@@ -121,6 +183,9 @@ void DspTest(const std::string& path)
 
     // Mel filterbank
     TestMelFilterBank();
+    TestFilterBankApply(0, 40, 0);
+    TestFilterBankApply(0, 40, 0.5);
+    TestFilterBankApply(10, 30, 0);
     // TestMelFilterBank2(); // Commented out because our implementation rounds filter centers to integer locations, and the reference (librosa) doesn't
 
     // DCT
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <value/include/LoopSchedule.h>
 #include <value/include/Tensor.h>
 
 namespace ell
@@ -17,6 +18,10 @@ namespace emittable_functions
 
     void SimpleConvolve1D(value::Vector signal, value::Vector filter, value::Vector output);
 
+    /// <summary> A 1D convolution (correlation) whose loop over the outputs is emitted according to a schedule, e.g.,
+    /// `LoopSchedule().Vectorize(8)` to compute 8 outputs side by side </summary>
+    void SimpleConvolve1D(value::Vector signal, value::Vector filter, value::Vector output, const value::LoopSchedule& schedule);
+
     void SimpleDepthwiseSeparableConvolve2D(value::Tensor signal, value::Tensor filter, value::Scalar rowStride,
                                             value::Scalar columnStride, value::Tensor output);
 } // namespace emittable_functions
@@ -17,6 +17,7 @@
 
 #include <cmath>
 #include <complex>
+#include <functional>
 #include <math.h>
 #include <memory>
 #include <vector>
@@ -50,9 +51,10 @@ namespace emittable_functions
         /// <param name="thresholdUp"> Then we compare the energy of the current frame to the noise floor. If it is thresholdUp times higher, we switch to state VOICE. </param>
         /// <param name="thresholdDown"> Then we compare the energy of the current frame to the noise floor. If it is thresholdDown times lower, we switch to state NO VOICE.  </param>
         /// <param name="levelThreshold"> Special case is when the energy of the frame is lower than levelThreshold, when we force the state to NO VOICE. </param>
+        /// <param name="decimation"> Once the state hasn't changed for this many frames, only every decimation'th frame is processed, and the other frames return the current state. 1 processes every frame. </param>
         VoiceActivityDetector(double sampleRate, double windowSize, double frameDuration, double tauUp, double tauDown,
                               double largeInput, double gainAtt, double thresholdUp, double thresholdDown,
-                              double levelThreshold);
+                              double levelThreshold, int decimation = 1);
 
         /// <summary> destructor </summary>
         ~VoiceActivityDetector();
@@ -61,11 +63,19 @@ namespace emittable_functions
         void Reset();
 
         /// <summary> process incoming audio stream, this data should already be floating point in the range[0 - 1].
+        /// If the window size is 1, the data is the level of the frame, as computed by `ProcessLevel`. </summary>
         ///
         /// <param name="data"> The input signal. </param>
         /// <returns> returns 1 when it detects activity in the stream and 0 otherwise  </returns>
         ell::value::Scalar Process(ell::value::Vector data);
 
+        /// <summary> process a frame whose level, the mean of its spectrum weighted by `GetWeights`, the front end
+        /// has already computed. </summary>
+        ///
+        /// <param name="level"> The level of the frame. </param>
+        /// <returns> returns 1 when it detects activity in the stream and 0 otherwise  </returns>
+        ell::value::Scalar ProcessLevel(ell::value::Scalar level);
+
         /// <summary> return true if the two detectors have the same sample rate and window size </summary>
         bool Equals(const VoiceActivityDetector& other) const;
 
@@ -112,9 +122,15 @@ namespace emittable_functions
         /// <summary> Get the levelThreshold parameter provided to constructor </summary>
         double GetLevelThreshold() const;
 
+        /// <summary> Get the decimation parameter provided to constructor </summary>
+        int GetDecimation() const;
+
     protected:
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        ell::value::Scalar ProcessFrame(std::function<ell::value::Scalar()> getLevel);
     };
 } // namespace emittable_functions
 } // namespace ell
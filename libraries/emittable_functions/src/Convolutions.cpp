@@ -30,6 +30,16 @@ namespace emittable_functions
         });
     }
 
+    void SimpleConvolve1D(Vector signal, Vector filter, Vector output, const LoopSchedule& schedule)
+    {
+        For(output, schedule, [&](Scalar index) {
+            Scalar accum;
+            For(filter, [&](Scalar filterIndex) { accum += filter(filterIndex) * signal(index + filterIndex); });
+
+            output(index) = accum;
+        });
+    }
+
     // Depthwise Separable using For loop where input has been explicitly padded
     void SimpleDepthwiseSeparableConvolve2D(Tensor signal,
                                             Tensor filter,
@@ -59,13 +59,20 @@ namespace emittable_functions
             _signal = 0;
         }
 
-        /// <summary> compute the next signal state given input time and power levels </summary>
-        Scalar Classify(Scalar time, Scalar inputLevel)
+        /// <summary> allocate the state that persists between calls </summary>
+        void Allocate()
         {
             _lastLevel = StaticAllocate("lastLevel", 0.1);
             _lastTime = StaticAllocate("lastTime", 0.0);
             _signal = StaticAllocate("signal", 0);
+        }
 
+        /// <summary> the current signal state </summary>
+        Scalar GetSignal() const { return _signal; }
+
+        /// <summary> compute the next signal state given input time and power levels </summary>
+        Scalar Classify(Scalar time, Scalar inputLevel)
+        {
             Scalar level = Cast<double>(inputLevel);
             Scalar timeDelta = time - _lastTime;
             Scalar levelDelta = level - _lastLevel;
@@ -207,7 +214,9 @@ namespace emittable_functions
         const double _frameDuration;
         const double _sampleRate;
         const double _windowSize;
+        const int _decimation;
         Scalar _time;
+        Scalar _framesSinceChange;
 
         VoiceActivityDetectorImpl(double sampleRate,
                                   double windowSize,
@@ -218,13 +227,32 @@ namespace emittable_functions
                                   double gainAtt,
                                   double thresholdUp,
                                   double thresholdDown,
-                                  double levelThreshold) :
+                                  double levelThreshold,
+                                  int decimation) :
             _cmw(sampleRate, windowSize),
             _tracker(tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold),
             _frameDuration(frameDuration),
             _sampleRate(sampleRate),
-            _windowSize(windowSize)
-        {}
+            _windowSize(windowSize),
+            _decimation(decimation)
+        {
+            if (decimation < 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "decimation must be at least 1");
+            }
+        }
+
+        // The weights divided by the window size, in the element type of the data, so the level of a frame is one dot product
+        template <typename ValueType>
+        std::vector<ValueType> GetScaledWeights() const
+        {
+            std::vector<ValueType> weights;
+            for (auto weight : _cmw.GetWeights())
+            {
+                weights.push_back(static_cast<ValueType>(weight / _windowSize));
+            }
+            return weights;
+        }
     };
 
     VoiceActivityDetector::VoiceActivityDetector() = default;
@@ -238,7 +266,8 @@ namespace emittable_functions
                                                  double gainAtt,
                                                  double thresholdUp,
                                                  double thresholdDown,
-                                                 double levelThreshold) :
+                                                 double levelThreshold,
+                                                 int decimation) :
         _impl(std::make_unique<VoiceActivityDetectorImpl>(sampleRate,
                                                           windowSize,
                                                           frameDuration,
@@ -248,7 +277,8 @@ namespace emittable_functions
                                                           gainAtt,
                                                           thresholdUp,
                                                           thresholdDown,
-                                                          levelThreshold))
+                                                          levelThreshold,
+                                                          decimation))
     {}
 
     VoiceActivityDetector::~VoiceActivityDetector() = default;
@@ -256,6 +286,7 @@ namespace emittable_functions
     void VoiceActivityDetector::Reset()
     {
         _impl->_time = int64_t{ 0 };
+        _impl->_framesSinceChange = int64_t{ 0 };
         _impl->_tracker.Reset();
     }
 
@@ -279,6 +310,8 @@ namespace emittable_functions
 
     double VoiceActivityDetector::GetLevelThreshold() const { return _impl->_tracker._levelThreshold; }
 
+    int VoiceActivityDetector::GetDecimation() const { return _impl->_decimation; }
+
     Scalar VoiceActivityDetector::Process(Vector data)
     {
         if (data.Size() != static_cast<size_t>(_impl->_windowSize))
@@ -287,23 +320,67 @@ namespace emittable_functions
                                             "data length should match windowSize");
         }
 
-        _impl->_time = StaticAllocate("time", int64_t{ 0 });
-
-        Vector weights = GetWeights();
-        Scalar windowSize = _impl->_windowSize;
-        Scalar frameDuration = _impl->_frameDuration;
+        // A window of size 1 is the level the front end has already computed
+        if (data.Size() == 1)
+        {
+            return ProcessLevel(data[0]);
+        }
 
         auto dataType = data.GetType();
-        auto level = Dot(data, Cast(weights, dataType));
+        return ProcessFrame([this, data, dataType]() -> Scalar {
+            if (dataType == ValueType::Float)
+            {
+                return Dot(data, Vector(_impl->GetScaledWeights<float>()));
+            }
+            return Dot(data, Cast(Vector(_impl->GetScaledWeights<double>()), dataType));
+        });
+    }
 
-        level /= Cast(windowSize, dataType);
+    Scalar VoiceActivityDetector::ProcessLevel(Scalar level)
+    {
+        return ProcessFrame([level] { return level; });
+    }
+
+    Scalar VoiceActivityDetector::ProcessFrame(std::function<Scalar()> getLevel)
+    {
+        _impl->_time = StaticAllocate("time", int64_t{ 0 });
+        _impl->_tracker.Allocate();
+
+        auto classify = [this, getLevel]() {
+            Scalar frameDuration = _impl->_frameDuration;
+            Scalar castedTime = Cast(_impl->_time, frameDuration.GetType());
+            Scalar t = castedTime * frameDuration;
+            ++_impl->_time;
+            return _impl->_tracker.Classify(t, getLevel());
+        };
 
-        Scalar castedTime = Cast(_impl->_time, frameDuration.GetType());
-        Scalar t = castedTime * frameDuration;
-        ++_impl->_time;
+        if (_impl->_decimation == 1)
+        {
+            return classify();
+        }
 
-        Scalar signal = _impl->_tracker.Classify(t, level);
-        return signal;
+        // Once the state is stable, only classify every `decimation` frames, and skip computing the level of the others
+        _impl->_framesSinceChange = StaticAllocate("framesSinceChange", int64_t{ 0 });
+        Scalar decimation = int64_t{ _impl->_decimation };
+        Scalar result = Allocate(ValueType::Int32, ScalarLayout);
+        result = _impl->_tracker.GetSignal();
+        If((_impl->_framesSinceChange >= decimation) && (_impl->_time % decimation != int64_t{ 0 }),
+           [&] {
+               ++_impl->_time;
+               ++_impl->_framesSinceChange;
+           })
+            .Else([&] {
+                Scalar signal = classify();
+                If(signal == result,
+                   [&] {
+                       ++_impl->_framesSinceChange;
+                   })
+                    .Else([&] {
+                        _impl->_framesSinceChange = int64_t{ 0 };
+                    });
+                result = signal;
+            });
+        return result;
     }
 
     const std::vector<double>& VoiceActivityDetector::GetWeights() const { return _impl->_cmw.GetWeights(); }
@@ -326,7 +403,8 @@ namespace emittable_functions
                _impl->_tracker._gainAtt == other._impl->_tracker._gainAtt &&
                _impl->_tracker._thresholdUp == other._impl->_tracker._thresholdUp &&
                _impl->_tracker._thresholdDown == other._impl->_tracker._thresholdDown &&
-               _impl->_tracker._levelThreshold == other._impl->_tracker._levelThreshold;
+               _impl->_tracker._levelThreshold == other._impl->_tracker._levelThreshold &&
+               _impl->_decimation == other._impl->_decimation;
     }
 
     void VoiceActivityDetector::WriteToArchive(utilities::Archiver& archiver) const
@@ -341,6 +419,7 @@ namespace emittable_functions
         archiver["thresholdUp"] << _impl->_tracker._thresholdUp;
         archiver["thresholdDown"] << _impl->_tracker._thresholdDown;
         archiver["levelThreshold"] << _impl->_tracker._levelThreshold;
+        archiver["decimation"] << _impl->_decimation;
     }
 
     void VoiceActivityDetector::ReadFromArchive(utilities::Unarchiver& archiver)
@@ -355,6 +434,7 @@ namespace emittable_functions
         double thresholdUp;
         double thresholdDown;
         double levelThreshold;
+        int decimation;
         archiver["windowSize"] >> windowSize;
         archiver["sampleRate"] >> sampleRate;
         archiver["frameDuration"] >> frameDuration;
@@ -365,6 +445,7 @@ namespace emittable_functions
         archiver["thresholdUp"] >> thresholdUp;
         archiver["thresholdDown"] >> thresholdDown;
         archiver["levelThreshold"] >> levelThreshold;
+        archiver.OptionalProperty("decimation", 1) >> decimation;
         _impl = std::make_unique<VoiceActivityDetectorImpl>(sampleRate,
                                                             windowSize,
                                                             frameDuration,
@@ -374,7 +455,8 @@ namespace emittable_functions
                                                             gainAtt,
                                                             thresholdUp,
                                                             thresholdDown,
-                                                            levelThreshold);
+                                                            levelThreshold,
+                                                            decimation);
     }
 
 } // namespace emittable_functions
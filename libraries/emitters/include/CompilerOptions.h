@@ -28,6 +28,47 @@ namespace emitters
 
     std::string ToString(BlasType t);
 
+    /// <summary> Ways of JIT-compiling a module's functions to machine code. </summary>
+    enum class JitCompilationMode
+    {
+        /// <summary> Compile the whole module before the first function is called. </summary>
+        wholeModule = 0,
+        /// <summary> Compile each function (with the functions it alone uses) the first time it's called. </summary>
+        lazy,
+        /// <summary> Compile the whole module on a background thread, starting as soon as the module is loaded. </summary>
+        background
+    };
+
+    std::string ToString(JitCompilationMode mode);
+
+    /// <summary> Ways of placing the thread pool's worker threads on cores. </summary>
+    enum class ThreadAffinity
+    {
+        /// <summary> Let the OS schedule the workers on any core. </summary>
+        none = 0,
+        /// <summary> Pin consecutive workers to consecutive cores, filling one socket (or cluster) before the next. </summary>
+        compact,
+        /// <summary> Pin consecutive workers to different sockets (or clusters) in turn. </summary>
+        scatter
+    };
+
+    std::string ToString(ThreadAffinity affinity);
+
+    /// <summary> Ways of splitting the iterations of a parallel loop among its tasks. </summary>
+    enum class ParallelLoopSchedule
+    {
+        /// <summary> Use the `parallelLoopSchedule` compiler option (only meaningful in `ParallelLoopOptions`). </summary>
+        automatic = 0,
+        /// <summary> Each task runs one contiguous block of (nearly) the same number of iterations. </summary>
+        staticBlocks,
+        /// <summary> Each task repeatedly claims the next chunk of iterations from a shared counter, until none are left. </summary>
+        dynamic,
+        /// <summary> Like `dynamic`, but each chunk is the remaining iterations divided by the number of tasks, so chunks shrink as the loop runs. </summary>
+        guided
+    };
+
+    std::string ToString(ParallelLoopSchedule schedule);
+
     /// <summary> Standard compiler switches. </summary>
     struct CompilerOptions
     {
@@ -52,21 +93,121 @@ namespace emitters
         /// <summary> Emit profiling code, </summary>
         bool profile = false;
 
+        /// <summary> Collect hardware performance counters (cycles, instructions, cache and branch misses) in profile regions (if profiling enabled). </summary>
+        bool profileHardwareCounters = false;
+
         /// <summary> Enable ELL's parallelization. </summary>
         bool parallelize = false;
 
         /// <summary> Use thread pool for parallelization (if parallelization enabled). </summary>
         bool useThreadPool = true;
 
+        /// <summary> Schedule thread pool tasks from per-thread deques with work stealing, instead of from a single shared queue. </summary>
+        bool useWorkStealing = false;
+
         /// <summary> Maximum num of parallel threads. </summary>
         int maxThreads = 4;
 
+        /// <summary>
+        /// Number of times an idle thread pool worker checks for new tasks, or a client checks for its tasks to finish,
+        /// pausing for exponentially longer between checks, before blocking on a condition variable. Spinning cuts the
+        /// dispatch latency of short back-to-back parallel loops at the cost of CPU time. 0 blocks right away.
+        /// </summary>
+        int threadPoolSpinCount = 0;
+
+        /// <summary> How to pin the thread pool's worker threads to cores (Linux targets only). </summary>
+        ThreadAffinity threadAffinity = ThreadAffinity::none;
+
+        /// <summary>
+        /// Comma-separated indices or ranges of the cores the worker threads are pinned to (e.g., "4-7" for the big cores
+        /// of a big.LITTLE CPU), listed socket by socket. Empty means cores 0 to `maxThreads` - 1.
+        /// </summary>
+        std::string affinityCores = "";
+
+        /// <summary> Number of sockets (or clusters) the affinity cores are evenly split over, for scatter placement. </summary>
+        int affinitySockets = 1;
+
+        /// <summary>
+        /// Run parallel tasks on a thread pool the application provides, through the `ELL_SubmitTask` and `ELL_WaitForTask`
+        /// functions declared in the module's header, instead of on threads of the module's own (if parallelization enabled).
+        /// This way all the models an application runs can share one pool.
+        /// </summary>
+        bool externalThreadPool = false;
+
+        /// <summary> The priority passed to `ELL_SubmitTask` with the module's tasks (if using an external thread pool). Higher values are more urgent. </summary>
+        int taskPriority = 0;
+
         /// <summary> Allow emitting more efficient code that isn't necessarily IEEE-754 compatible. </summary>
         bool useFastMath = true;
 
+        /// <summary> Compute exp, tanh, and sigmoid with fast polynomial approximations (see `FastExp` in IRMath.h) instead of runtime library calls. </summary>
+        bool useApproximateMath = false;
+
         /// <summary> Allow printing of diagnostic messages from the compiled model. </summary>
         bool includeDiagnosticInfo = false;
 
+        /// <summary> Number of partitions to split the module into when generating object code. The partitions are compiled in parallel. </summary>
+        int codeGenPartitions = 1;
+
+        /// <summary>
+        /// Instrument the optimized code for LLVM profile-guided optimization, writing the raw profile to this file (e.g.,
+        /// "model.profraw") when the program exits. Meant for object code linked with the LLVM profile runtime (e.g., with
+        /// clang's `-fprofile-instr-generate`). Empty doesn't instrument the code.
+        /// </summary>
+        std::string pgoInstrumentFile = "";
+
+        /// <summary>
+        /// Optimize with the profile in this file, merged with `llvm-profdata merge` from the raw profiles of representative
+        /// runs of code instrumented with `pgoInstrumentFile`, to lay out and inline the hot paths. Empty doesn't use a profile.
+        /// </summary>
+        std::string pgoProfileFile = "";
+
+        /// <summary>
+        /// Move the model's mutable state into a caller-allocated struct, and emit versions of the model functions that take
+        /// a pointer to it, so several instances of the model can run concurrently while sharing the weights. Can't be
+        /// combined with `parallelize` or `functionVariants`, whose tasks and variants are called through function pointers.
+        /// </summary>
+        bool reentrant = false;
+
+        /// <summary>
+        /// Move the weights out of the module, into a separate binary blob the caller passes to the module at runtime,
+        /// so they can be replaced without recompiling (see `EmitExternalWeights` in IRExternalWeights.h).
+        /// </summary>
+        bool externalWeights = false;
+
+        /// <summary>
+        /// Allocate the scratch arrays that nodes would put on the stack as internal globals instead, so the model's memory
+        /// is all allocated statically (see `MoveStackArraysToGlobals` in IRStaticMemory.h). Meant for microcontrollers.
+        /// </summary>
+        bool staticMemory = false;
+
+        /// <summary> Store constant arrays that hold identical data only once (see `DeduplicateConstants` in IRConstantDeduplication.h). </summary>
+        bool deduplicateConstants = true;
+
+        /// <summary>
+        /// Name constant arrays after their contents and let the linker keep a single copy of the arrays that several
+        /// modules linked into the same program have in common (if deduplicating constants).
+        /// </summary>
+        bool shareConstantsAcrossModules = false;
+
+        /// <summary>
+        /// Name of the section the weight arrays are placed in, e.g., a read-only section a microcontroller's linker script
+        /// keeps in execute-in-place flash, so the startup code doesn't copy the weights to RAM. Empty uses the default section.
+        /// </summary>
+        std::string weightsSection = "";
+
+        /// <summary> Alignment, in bytes, of the weight arrays (e.g., 2097152 to start them on a 2 MB huge page). 0 keeps their natural alignment. </summary>
+        int weightsAlignment = 0;
+
+        /// <summary> Size, in bytes, of the smallest weight array that gets `weightsSection` and `weightsAlignment`, so small arrays aren't padded out. </summary>
+        int weightsPlacementThreshold = 0;
+
+        /// <summary> Ask the OS to back the weights blob with huge pages when it's passed to the module (if externalizing weights, Linux targets only). </summary>
+        bool hugePageWeights = false;
+
+        /// <summary> How to JIT-compile the module, when it's run in-process instead of emitted to a file. </summary>
+        JitCompilationMode jitCompilationMode = JitCompilationMode::wholeModule;
+
         /// <summary> Name of the target device. </summary>
         TargetDevice targetDevice = { "host" };
 
@@ -74,12 +215,46 @@ namespace emitters
         /// <summary> Emit code that calls an external BLAS library. </summary>
         bool useBlas = true;
 
+        /// <summary>
+        /// Largest number of multiply-adds for which a matrix product whose shape is known at compile time is emitted as
+        /// unrolled code instead of a BLAS call (see IRSmallMatrixKernels.h). Set it per target from the point where the
+        /// unrolled code stops beating the BLAS call; 0 always calls BLAS.
+        /// </summary>
+        int smallMatrixThreshold = 1024;
+
+        /// <summary>
+        /// Distance, in bytes, that kernels streaming through large arrays (the native GEMV and GEMM) prefetch ahead of
+        /// the data they read. 0 leaves prefetching to the hardware.
+        /// </summary>
+        int prefetchDistance = 0;
+
+        /// <summary>
+        /// Size, in bytes, from which outputs that are written once and not read back right away (e.g., reordered data)
+        /// are written with non-temporal stores, which don't evict other data from the cache. 0 never uses them.
+        /// </summary>
+        int nonTemporalStoreThreshold = 0;
+
+        /// <summary>
+        /// How parallel loops split their iterations among tasks, unless the code emitting the loop picks a schedule.
+        /// Dynamic and guided schedules balance loops whose iterations take different amounts of time.
+        /// </summary>
+        ParallelLoopSchedule parallelLoopSchedule = ParallelLoopSchedule::staticBlocks;
+
+        /// <summary> Number of iterations a task claims at a time with the dynamic schedule, and the smallest chunk with the guided schedule. </summary>
+        int parallelLoopChunkSize = 1;
+
         /// <summary> Explicitly unroll loops in certain cases. </summary>
         bool unrollLoops = false;
 
         /// <summary> Emit inline code for common operations. </summary>
         bool inlineOperators = true;
 
+        /// <summary>
+        /// Comma-separated names of CPU feature sets (e.g., "avx2,avx512") to emit variants of each node function for.
+        /// The variant to run is chosen when the module is initialized, based on the features of the CPU.
+        /// </summary>
+        std::string functionVariants = "";
+
         /// <summary> Enable ELL's vectorization </summary>
         bool allowVectorInstructions = false;
 
@@ -99,5 +274,14 @@ namespace utilities
 {
     template <>
     emitters::BlasType FromString<emitters::BlasType>(const std::string& s);
+
+    template <>
+    emitters::JitCompilationMode FromString<emitters::JitCompilationMode>(const std::string& s);
+
+    template <>
+    emitters::ThreadAffinity FromString<emitters::ThreadAffinity>(const std::string& s);
+
+    template <>
+    emitters::ParallelLoopSchedule FromString<emitters::ParallelLoopSchedule>(const std::string& s);
 }
 } // namespace ell
@@ -14,6 +14,14 @@
 #include <llvm/Target/TargetMachine.h> // for CodeGenFileType
 #include <llvm/Target/TargetOptions.h> // for FloatABI::ABIType and FPOpFusion::FpOpFusionMode
 
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+class raw_pwrite_stream;
+}
+
 namespace ell
 {
 namespace emitters
@@ -47,6 +55,8 @@ namespace emitters
         FloatABIType floatABI = FloatABIType::Default;
         FloatFusionMode floatFusionMode = FloatFusionMode::Fast;
         OutputRelocationModel relocModel = OutputRelocationModel::Static;
+
+        int numPartitions = 1; // object code is split into this many files, compiled in parallel
     };
 
     /// <summary> Indicates if the requested output type is a machine code type (vs. IR) </summary>
@@ -57,5 +67,19 @@ namespace emitters
 
     /// <summary> Compile the given module to the given stream </summary>
     void GenerateMachineCode(llvm::raw_ostream& os, IRModuleEmitter& module, ModuleOutputFormat format, const MachineCodeOutputOptions& options);
+
+    /// <summary>
+    /// Compile the given module to object code, split into one partition per stream. The partitions are compiled in
+    /// parallel, and together define all the symbols of the module, so all of them must be linked into the final binary.
+    /// </summary>
+    void GenerateMachineCode(const std::vector<llvm::raw_pwrite_stream*>& partitionStreams, IRModuleEmitter& module, const MachineCodeOutputOptions& options);
+
+    /// <summary> Gets the path of the file a given partition of partitioned object code is written to. </summary>
+    ///
+    /// <param name="filePath"> The path of the object file. Partition 0 is written to this path. </param>
+    /// <param name="partition"> The index of the partition. </param>
+    ///
+    /// <returns> The path of the file for the partition: for instance, "model_2.o" for partition 2 of "model.o". </returns>
+    std::string GetPartitionFilePath(const std::string& filePath, int partition);
 } // namespace emitters
 } // namespace ell
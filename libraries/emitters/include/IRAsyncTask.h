@@ -10,6 +10,7 @@
 
 #include "LLVMUtilities.h"
 
+#include <string>
 #include <vector>
 
 namespace ell
@@ -38,6 +39,13 @@ namespace emitters
     // auto task = function.Async(taskFunction, {x0, x1});
     // ...
     // task.Wait(function); // block until task is done
+    //
+    // A task started with a storage name keeps its state in module globals instead of on the stack, so it
+    // can outlive the function that starts it and be waited for by another function of the same module:
+    //
+    // auto task = startFunction.StartAsyncTask(taskFunction, {x0, x1}, "myTask");
+    // ...
+    // task.Wait(waitFunction);
 
     /// <summary> Class that emits functions as asynchronous tasks. </summary>
     class IRAsyncTask
@@ -67,6 +75,7 @@ namespace emitters
         friend IRFunctionEmitter;
         IRAsyncTask(IRFunctionEmitter& functionEmitter, LLVMFunction taskFunction, const std::vector<LLVMValue>& arguments);
         IRAsyncTask(IRFunctionEmitter& functionEmitter, IRFunctionEmitter& taskFunction, const std::vector<LLVMValue>& arguments);
+        IRAsyncTask(IRFunctionEmitter& functionEmitter, LLVMFunction taskFunction, const std::vector<LLVMValue>& arguments, const std::string& storageName);
 
         LLVMFunction _taskFunction = nullptr;
         std::vector<LLVMValue> _arguments;
@@ -74,12 +83,20 @@ namespace emitters
         LLVMValue _returnValue = nullptr;
 
         bool UsePthreads() const { return _usePthreads; }
+        bool UseExternalThreadPool() const { return _useExternalThreadPool; }
+        bool UsesGlobalStorage() const { return !_storageName.empty(); }
+        LLVMValue TaskStateVariable(IRFunctionEmitter& function, LLVMType type, const std::string& name);
         LLVMFunction GetPthreadWrapper(llvm::StructType* argsStructType);
 
         bool _usePthreads = false;
+        bool _useExternalThreadPool = false;
+        std::string _storageName; // the prefix of the globals that hold the task's state, if it isn't kept on the stack
 
         // For pthreads implementation
         LLVMValue _pthread = nullptr;
+
+        // For the external thread pool: the handle `ELL_SubmitTask` returned
+        LLVMValue _externalTask = nullptr;
     };
 
     /// <summary> Waits for all given tasks to finish </summary>
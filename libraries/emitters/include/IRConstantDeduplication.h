@@ -0,0 +1,36 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRConstantDeduplication.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+namespace ell
+{
+namespace emitters
+{
+    class IRModuleEmitter;
+
+    /// <summary>
+    /// Merges the constant global variables of a module that hold identical data, like the tied weights of a model or
+    /// the parameters of identical `ConstantNode`s in different branches, so each distinct array is only stored once.
+    /// LLVM keeps a single copy of each distinct constant value, found by hashing its contents, so two globals hold the
+    /// same data exactly when they have the same initializer.
+    ///
+    /// With `shareAcrossModules`, each remaining constant array is also renamed after a hash of its contents and given
+    /// "link once" linkage, so the linker keeps a single copy of the arrays that several modules linked into the same
+    /// program have in common.
+    /// </summary>
+    ///
+    /// <param name="module"> The module. Must be called after all the module's functions have been emitted, and before `EmitExternalWeights`. </param>
+    /// <param name="shareAcrossModules"> Indicates whether to let the linker merge the constant arrays with those of other modules. </param>
+    ///
+    /// <returns> The total size of the globals that were removed, in bytes. </returns>
+    uint64_t DeduplicateConstants(IRModuleEmitter& module, bool shareAcrossModules = false);
+} // namespace emitters
+} // namespace ell
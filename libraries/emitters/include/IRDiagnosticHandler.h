@@ -16,6 +16,23 @@ namespace ell
 {
 namespace emitters
 {
+    /// <summary> An optimization remark from an LLVM pass, e.g. that a loop was, or couldn't be, vectorized. </summary>
+    struct IROptimizationRemark
+    {
+        enum class Kind
+        {
+            passed, // the optimization was applied
+            missed, // the optimization was tried and not applied
+            analysis // an explanation for an earlier remark
+        };
+
+        Kind kind;
+        std::string passName; // e.g. "loop-vectorize", "slp-vectorizer", "loop-unroll" or "inline"
+        std::string remarkName; // e.g. "Vectorized"
+        std::string functionName; // the function the remark is about
+        std::string message;
+    };
+
     /// <summary> An LLVM diagnostic handler class that collects warning and error codes </summary>
     class IRDiagnosticHandler
     {
@@ -38,6 +55,21 @@ namespace emitters
         /// <param name="isVerbose"> If true, set the handler to verbose mode, if false, set the handler to quiet mode. </param>
         void SetVerbosity(bool isVerbose);
 
+        /// <summary> Sets whether to collect the remarks of the vectorization, unrolling and inlining passes. LLVM only
+        /// creates the remarks when they're wanted, so collecting them is off by default. </summary>
+        ///
+        /// <param name="collect"> If true, collect the remarks of the passes that run from now on. </param>
+        void SetCollectOptimizationRemarks(bool collect) { _collectOptimizationRemarks = collect; }
+
+        /// <summary> Indicates if the handler collects optimization remarks. </summary>
+        bool CollectsOptimizationRemarks() const { return _collectOptimizationRemarks; }
+
+        /// <summary> Gets the optimization remarks collected so far. </summary>
+        const std::vector<IROptimizationRemark>& GetOptimizationRemarks() const { return _optimizationRemarks; }
+
+        /// <summary> Clears the optimization remarks collected so far. </summary>
+        void ClearOptimizationRemarks() { _optimizationRemarks.clear(); }
+
     private:
         friend class IRModuleEmitter;
 
@@ -53,6 +85,8 @@ namespace emitters
         bool _hadError = false;
         std::vector<std::string> _messagePrefixes;
         std::vector<std::string> _messages;
+        bool _collectOptimizationRemarks = false;
+        std::vector<IROptimizationRemark> _optimizationRemarks;
     };
 } // namespace emitters
 } // namespace ell
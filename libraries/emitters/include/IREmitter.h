@@ -919,6 +919,38 @@ namespace emitters
         /// <returns> Pointer to the resulting llvm::StoreInst. </returns>
         llvm::StoreInst* Store(LLVMValue pPointer, LLVMValue pValue);
 
+        /// <summary> Emits a sequentially-consistent atomic load of a value referenced by a pointer. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the address being loaded. Must point to an integer or pointer type. </param>
+        ///
+        /// <returns> Pointer to the resulting llvm::LoadInst. </returns>
+        llvm::LoadInst* AtomicLoad(LLVMValue pPointer);
+
+        /// <summary> Emits a sequentially-consistent atomic store of a value into a given address. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the address where the value is being stored. </param>
+        /// <param name="pValue"> Pointer to the value being stored. </param>
+        ///
+        /// <returns> Pointer to the resulting llvm::StoreInst. </returns>
+        llvm::StoreInst* AtomicStore(LLVMValue pPointer, LLVMValue pValue);
+
+        /// <summary> Emits an atomic fetch-and-add on an integer referenced by a pointer. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the integer being modified. </param>
+        /// <param name="pValue"> The value to add. </param>
+        ///
+        /// <returns> The value stored at the address before the addition. </returns>
+        LLVMValue AtomicAdd(LLVMValue pPointer, LLVMValue pValue);
+
+        /// <summary> Emits an atomic compare-and-exchange on the value referenced by a pointer. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the value being modified. </param>
+        /// <param name="pExpectedValue"> The value expected to be currently stored at the address. </param>
+        /// <param name="pNewValue"> The value to store if the current value matches the expected value. </param>
+        ///
+        /// <returns> A boolean value that is true if the exchange succeeded. </returns>
+        LLVMValue AtomicCompareExchange(LLVMValue pPointer, LLVMValue pExpectedValue, LLVMValue pNewValue);
+
         /// <summary> Emits instruction to create a stack variable. </summary>
         ///
         /// <param name="type"> The variable type. </param>
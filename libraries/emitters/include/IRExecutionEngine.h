@@ -7,15 +7,23 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "CompilerOptions.h"
 #include "LLVMUtilities.h"
 
 #include <utilities/include/Exception.h>
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/IR/Module.h>
 
+#include <exception>
 #include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace ell
 {
@@ -36,13 +44,18 @@ namespace emitters
         ///
         /// <param name="module"> The module. </param>
         /// <param name="verify"> Indicates if the execution engine should run a verification pass before running the code. </param>
-        IRExecutionEngine(IRModuleEmitter&& module, bool verify = false);
+        /// <param name="mode"> How to compile the module's functions. </param>
+        IRExecutionEngine(IRModuleEmitter&& module, bool verify = false, JitCompilationMode mode = JitCompilationMode::wholeModule);
 
         /// <summary> Inject the primary "owner" module into the execution engine. </summary>
         ///
         /// <param name="pModule"> The module. </param>
         /// <param name="verify"> Indicates if the execution engine should run a verification pass before running the code. </param>
-        IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify = false);
+        /// <param name="mode">
+        /// How to compile the module's functions. In `lazy` mode the module is split into one module per function, and
+        /// each of them is compiled when one of its functions is first requested, or linked to by a function being compiled.
+        /// </param>
+        IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify = false, JitCompilationMode mode = JitCompilationMode::wholeModule);
 
         /// <summary> Destructor </summary>
         ~IRExecutionEngine();
@@ -52,6 +65,20 @@ namespace emitters
         /// <param name="pModule"> The module to add. </param>
         void AddModule(std::unique_ptr<llvm::Module> pModule);
 
+        /// <summary>
+        /// Set the object cache used by the execution engine. When the cache holds an object for a module, the engine
+        /// loads it instead of generating code. Must be called before any functions are requested.
+        /// </summary>
+        ///
+        /// <param name="cache"> The object cache. </param>
+        void SetObjectCache(std::unique_ptr<llvm::ObjectCache> cache);
+
+        /// <summary>
+        /// Start compiling all the modules on a background thread (in `background` mode). Requests for functions made
+        /// meanwhile wait for the compilation to finish. Functions must be defined with `DefineFunction` before this is called.
+        /// </summary>
+        void CompileInBackground();
+
         /// <summary>
         /// Return the address of a named function, JITTing code as needed. Returns 0 if not found.
         /// </summary>
@@ -96,7 +123,10 @@ namespace emitters
         /// <returns> The function address. </returns>
         uint64_t ResolveFunctionAddress(const std::string& name);
 
-        /// <summary> Set the address of a named function. </summary>
+        /// <summary>
+        /// Set the address of a named function. In `lazy` mode, all the functions must be defined before any address is
+        /// requested, since the function objects belong to the module being split.
+        /// </summary>
         ///
         /// <param name="func"> The function being defined. </param>
         /// <param name="address"> The address of the function being defined. </param>
@@ -119,12 +149,24 @@ namespace emitters
 
     private:
         void EnsureEngine();
+        void CreateBuilder(std::unique_ptr<llvm::Module> pModule);
+        void AddLazyModules(std::unique_ptr<llvm::Module> pModule);
         void EnsureClockGetTime();
         void PerformInitialization();
         void PerformFinalization();
 
+        std::unique_ptr<llvm::ObjectCache> _pObjectCache; // must outlive the engine
         std::unique_ptr<llvm::EngineBuilder> _pBuilder;
         std::unique_ptr<llvm::ExecutionEngine> _pEngine;
+
+        JitCompilationMode _mode = JitCompilationMode::wholeModule;
+        bool _verify = false;
+        std::unique_ptr<llvm::Module> _pLazyModule; // the module to split, in `lazy` mode, until the engine is created
+        std::vector<std::unique_ptr<llvm::Module>> _pendingModules;
+        std::vector<std::pair<std::string, uint64_t>> _pendingFunctionDefinitions;
+        std::recursive_mutex _mutex;
+        std::thread _backgroundCompilation;
+        std::exception_ptr _backgroundCompilationError;
     };
 } // namespace emitters
 } // namespace ell
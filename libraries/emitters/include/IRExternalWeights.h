@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRExternalWeights.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+class GlobalVariable;
+}
+
+namespace ell
+{
+namespace emitters
+{
+    class IRModuleEmitter;
+
+    /// <summary> The alignment of the weights blob, and of each array in it. </summary>
+    constexpr uint64_t c_externalWeightsAlignment = 64;
+
+    /// <summary>
+    /// Marks a constant global array as data (like the weights of a model) that `EmitExternalWeights` can move out of
+    /// the module and into the weights blob.
+    /// </summary>
+    ///
+    /// <param name="global"> The global variable. </param>
+    void MarkGlobalAsWeights(llvm::GlobalVariable& global);
+
+    /// <summary> Indicates if a global variable has been marked as weights with `MarkGlobalAsWeights`. </summary>
+    ///
+    /// <param name="global"> The global variable. </param>
+    ///
+    /// <returns> `true` if the global holds weights. </returns>
+    bool IsWeightsGlobal(const llvm::GlobalVariable& global);
+
+    /// <summary>
+    /// Moves the weights of a module out of the module, into a binary blob the caller loads (typically by mapping the file
+    /// into memory) and passes to the module. The code reads the weights through a pointer, so the weights can be replaced
+    /// with others of the same shapes (e.g., from retraining the model) without recompiling, or swapped between calls.
+    ///
+    /// The blob starts with a 64-byte header (the magic number "ELLW", the format version, the size of the blob and a hash of
+    /// the offsets and sizes of the arrays), followed by the arrays, each aligned to `c_externalWeightsAlignment` bytes. The module gets
+    /// `int32_t <module>_SetWeights(char* weights)`, which checks the blob and uses it for subsequent calls, returning 1 if the
+    /// blob matches the module and 0 (leaving the current weights in place) if it doesn't, and `int64_t <module>_GetWeightsSize()`.
+    /// The blob must be aligned to `c_externalWeightsAlignment` bytes, and must stay valid while the module uses it.
+    ///
+    /// With `hugePages`, `<module>_SetWeights` also asks the OS to back the blob with transparent huge pages (`madvise` with
+    /// `MADV_HUGEPAGE`), which cuts the TLB misses of reading large weights. Only whole pages in the blob are affected, so the
+    /// blob should be mapped at a page boundary (as `mmap` does). This only applies to Linux targets, and failures are ignored.
+    /// </summary>
+    ///
+    /// <param name="module"> The module. Must be called after all the module's functions have been emitted, and before it is optimized. </param>
+    /// <param name="hugePages"> Indicates whether to ask for huge pages for the blob. </param>
+    ///
+    /// <returns> The contents of the weights blob. </returns>
+    std::vector<char> EmitExternalWeights(IRModuleEmitter& module, bool hugePages = false);
+
+    /// <summary>
+    /// Places the weights of a module that are at least `minSize` bytes in the given section, aligned to the given number of bytes.
+    /// Large alignments let the loader map big weight arrays on huge pages, and a section the linker script keeps in
+    /// execute-in-place flash keeps the weights of a microcontroller out of RAM.
+    /// </summary>
+    ///
+    /// <param name="module"> The module. Must be called after `DeduplicateConstants`, since the arrays it merges may be placed differently. </param>
+    /// <param name="section"> The name of the section, or empty to leave the weights in the default section. </param>
+    /// <param name="alignment"> The alignment, in bytes, a power of 2, or 0 to keep the natural alignment of the weights. </param>
+    /// <param name="minSize"> The size, in bytes, of the smallest weight array to place. </param>
+    void PlaceWeights(IRModuleEmitter& module, const std::string& section, uint64_t alignment, uint64_t minSize = 0);
+} // namespace emitters
+} // namespace ell
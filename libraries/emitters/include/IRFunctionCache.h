@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRFunctionCache.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <llvm/IR/GlobalValue.h>
+
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+
+namespace ell
+{
+namespace emitters
+{
+    class IRModuleEmitter;
+
+    /// <summary>
+    /// A cache of the IR emitted for functions, so a later compile can link the cached code into its module instead
+    /// of emitting it again. The cache is kept in memory, where it is shared by all the compiles in the process, and
+    /// optionally in a directory, as one IR file per key. The caller is responsible for choosing a key that changes
+    /// whenever anything that affects the emitted code changes.
+    ///
+    /// Only code that is self-contained is cached: the functions and global variables emitted between `BeginEmit` and
+    /// `EndEmit`, which may only use each other and functions or globals that the module declares without defining.
+    /// </summary>
+    class IRFunctionCache
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="directory"> The directory that holds the cached IR, or an empty string to only cache it in memory. It is created if it doesn't exist. </param>
+        IRFunctionCache(const std::string& directory = "");
+
+        /// <summary> Links the code cached under a key into a module, if it's in the cache. </summary>
+        ///
+        /// <param name="module"> The module. </param>
+        /// <param name="key"> The key the code is cached under. </param>
+        ///
+        /// <returns> `true` if the cached code was linked into the module. </returns>
+        bool TryLoad(IRModuleEmitter& module, const std::string& key);
+
+        /// <summary> Starts recording the code emitted into a module, for `EndEmit` to add to the cache. </summary>
+        ///
+        /// <param name="module"> The module. </param>
+        void BeginEmit(IRModuleEmitter& module);
+
+        /// <summary> Adds the code emitted into a module since `BeginEmit` to the cache, if it's self-contained. </summary>
+        ///
+        /// <param name="module"> The module. </param>
+        /// <param name="key"> The key to cache the code under. </param>
+        ///
+        /// <returns> `true` if the code was added to the cache. </returns>
+        bool EndEmit(IRModuleEmitter& module, const std::string& key);
+
+        /// <summary> Removes all the code cached in memory, in all the instances of the cache. </summary>
+        static void ClearMemoryCache();
+
+    private:
+        std::string GetFilePath(const std::string& key) const;
+
+        std::string _directory;
+        std::unordered_set<const llvm::GlobalValue*> _existingValues;
+        size_t _numNamedMetadataOperands = 0;
+    };
+} // namespace emitters
+} // namespace ell
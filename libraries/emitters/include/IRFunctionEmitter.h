@@ -775,6 +775,15 @@ namespace emitters
         /// <returns> Pointer to the emitted variable. </returns>
         llvm::AllocaInst* EmittedVariable(VariableType type, const std::string& name);
 
+        /// <summary> Return an emitted stack array and assign it a name. </summary>
+        ///
+        /// <param name="type"> The array entry type. </param>
+        /// <param name="size"> The array length. </param>
+        /// <param name="name"> The variable name. </param>
+        ///
+        /// <returns> Pointer to the emitted array. </returns>
+        llvm::AllocaInst* EmittedVariable(VariableType type, int size, const std::string& name);
+
         ///
         /// Load and Store
         ///
@@ -802,6 +811,38 @@ namespace emitters
         /// <returns> Pointer to the stored value. </returns>
         LLVMValue Store(LLVMValue pPointer, LLVMValue pValue);
 
+        /// <summary> Emit instruction to atomically load the value referenced by a pointer. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the address to load. Must point to an integer or pointer type. </param>
+        ///
+        /// <returns> Pointer to the loaded value. </returns>
+        LLVMValue AtomicLoad(LLVMValue pPointer);
+
+        /// <summary> Emit instruction to atomically store a value into the pointer location. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the address where the value is being stored. </param>
+        /// <param name="pValue"> Pointer to the value being stored. </param>
+        ///
+        /// <returns> Pointer to the stored value. </returns>
+        LLVMValue AtomicStore(LLVMValue pPointer, LLVMValue pValue);
+
+        /// <summary> Emit instruction to atomically add a value to the integer at the pointer location. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the integer being modified. </param>
+        /// <param name="pValue"> The value to add. </param>
+        ///
+        /// <returns> The value stored at the address before the addition. </returns>
+        LLVMValue AtomicAdd(LLVMValue pPointer, LLVMValue pValue);
+
+        /// <summary> Emit instruction to atomically replace the value at the pointer location if it equals an expected value. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the value being modified. </param>
+        /// <param name="pExpectedValue"> The value expected to be currently stored at the address. </param>
+        /// <param name="pNewValue"> The value to store if the current value matches the expected value. </param>
+        ///
+        /// <returns> A boolean value that is true if the exchange succeeded. </returns>
+        LLVMValue AtomicCompareExchange(LLVMValue pPointer, LLVMValue pExpectedValue, LLVMValue pNewValue);
+
         /// <summary> Emit instruction to initialize a 0 value into the pointer location. </summary>
         ///
         /// <param name="pPointer"> Pointer to the address where the value is being stored. </param>
@@ -903,6 +944,23 @@ namespace emitters
         /// <param name="pValue"> The value to set. </param>
         LLVMValue SetValueAt(llvm::GlobalVariable* pGlobal, LLVMValue pOffset, LLVMValue pValue);
 
+        /// <summary>
+        /// Set an element in an array with a non-temporal store, which hints that the value won't be read again soon,
+        /// so it doesn't need to be kept in the cache.
+        /// </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the array. </param>
+        /// <param name="pOffset"> The offset. </param>
+        /// <param name="pValue"> The value to set. </param>
+        LLVMValue SetValueAtNonTemporal(LLVMValue pPointer, LLVMValue pOffset, LLVMValue pValue);
+
+        /// <summary> Emit a hint to fetch the cache line holding an element of an array, before it's accessed. </summary>
+        ///
+        /// <param name="pPointer"> Pointer to the array. </param>
+        /// <param name="pOffset"> The offset of the element. It may be past the end of the array. </param>
+        /// <param name="forWrite"> `true` if the element is going to be written rather than read. </param>
+        void Prefetch(LLVMValue pPointer, LLVMValue pOffset, bool forWrite = false);
+
         /// <summary> Set the fields of a struct. </summary>
         ///
         /// <param name="structPtr"> The struct to be filled in. </param>
@@ -1225,6 +1283,19 @@ namespace emitters
         /// <returns> A task object representing the running task. </param>
         IRTask StartAsyncTask(IRFunctionEmitter& task, const std::vector<LLVMValue>& arguments);
 
+        /// <summary>
+        /// Creates an asynchronous task on a new thread, whose state is kept in module globals instead of on the stack,
+        /// so the task can keep running after this function returns and be waited for by another function. Only one
+        /// such task can be running per storage name, and the task function can't return a value.
+        /// </summary>
+        ///
+        /// <param name="task"> The function to run asynchronously. </param>
+        /// <param name="arguments"> The arguments to the task function. </param>
+        /// <param name="storageName"> The prefix of the names of the globals that hold the task's state. </param>
+        ///
+        /// <returns> A task object representing the running task. </param>
+        IRTask StartAsyncTask(LLVMFunction task, const std::vector<LLVMValue>& arguments, const std::string& storageName);
+
         /// <summary> Starts an array of tasks using the thread pool, or new threads, depending on the value of the `useThreadPool` compiler setting. </summary>
         ///
         /// <param name="taskFunction"> The function to run asynchronously with many different arguments. </param>
@@ -1533,6 +1604,25 @@ namespace emitters
         template <typename ValueType>
         void CallGEMM(bool transposeA, bool transposeB, int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc);
 
+        /// <summary> Call the matrix-matrix multiply routine that computes C = alpha*A*B + beta*C, with potentially-transposed matrices </summary>
+        ///
+        /// <typeparam name="ValueType"> The datatype to use (must be `float` or `double`) </typeparam>
+        /// <param name="transposeA"> If `true`, use A' instead of A in the above equation </param>
+        /// <param name="transposeB"> If `true`, use B' instead of B in the above equation </param>
+        /// <param name="m"> The number of rows in the matrix A and the output matrix  C </param>
+        /// <param name="n"> The number of columns in the matrix B and the output matrix C </param>
+        /// <param name="k"> The number of rows in the matrix A and columns in matrix B </param>
+        /// <param name="alpha"> The scalar to multiply with the A*B product </param>
+        /// <param name="A"> The matrix to multiply on the left </param>
+        /// <param name="lda"> The stride of the matrix A -- the number of elements between rows </param>
+        /// <param name="B"> The matrix to multiply on the right </param>
+        /// <param name="ldb"> The stride of the matrix B -- the number of elements between rows </param>
+        /// <param name="beta"> The scalar to multiply with C before adding to the alpha*A*B product. If it's 0, C isn't read. </param>
+        /// <param name="C"> The result matrix </param>
+        /// <param name="ldc"> The stride of the matrix C -- the number of elements between rows </param>
+        template <typename ValueType>
+        void CallGEMM(bool transposeA, bool transposeB, int m, int n, int k, ValueType alpha, LLVMValue A, int lda, LLVMValue B, int ldb, ValueType beta, LLVMValue C, int ldc);
+
         /// <summary> Utility function for getting number of threads used by OpenBLAS (if present) </summary>
         LLVMValue GetNumOpenBLASThreads();
 
@@ -1569,6 +1659,9 @@ namespace emitters
         /// <summary> Emits a call to the POSIX `pthread_self` function. </summary>
         LLVMValue PthreadSelf();
 
+        /// <summary> Emits a call to the Linux `pthread_setaffinity_np` function. </summary>
+        LLVMValue PthreadSetAffinity(LLVMValue thread, LLVMValue cpuSetSize, LLVMValue cpuSetPtr);
+
         /// <summary> Emits a call to the POSIX `pthread_mutex_init` function. </summary>
         LLVMValue PthreadMutexInit(LLVMValue mutexPtr, LLVMValue attrPtr);
 
@@ -1629,6 +1722,12 @@ namespace emitters
         /// <summary> Adds an`IRBlockRegion` to the region list and sets it as the current region </summary>
         IRBlockRegion* AddRegion(llvm::BasicBlock* pBlock);
 
+        /// <summary> Gets the number of regions in the region list </summary>
+        size_t NumRegions() const { return _regions.Size(); }
+
+        /// <summary> Gets a region from the region list, which is in the order the regions were added </summary>
+        IRBlockRegion* GetRegion(size_t index) { return _regions.GetAt(index); }
+
         /// <summary> Get the compiler options for the function being emitted. </summary>
         ///
         /// <returns> A `CompilerOptions` object containing the options for this function. </returns>
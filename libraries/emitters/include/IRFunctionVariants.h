@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRFunctionVariants.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TargetDevice.h"
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    class IRModuleEmitter;
+
+    /// <summary> Gets the names of the CPU feature sets that function variants can be emitted for on the given target. </summary>
+    ///
+    /// <param name="target"> The target device. </param>
+    ///
+    /// <returns> The names of the feature sets, from least to most capable. </returns>
+    std::vector<std::string> GetFunctionVariantNames(const TargetDevice& target);
+
+    /// <summary>
+    /// Emits CPU-specific variants of the functions in a module that are tagged with `c_functionVariantsTagName`.
+    /// Each tagged function gets a copy compiled for each of the named feature sets in its tag value, and its body is
+    /// replaced with an indirect call through a function pointer. A module initialization function checks the features
+    /// of the CPU the code is running on (using `cpuid` on x86 and the auxiliary vector on ARM Linux) and points each function
+    /// at the most capable variant the CPU supports, falling back to the original code if it supports none of them.
+    /// </summary>
+    ///
+    /// <param name="module"> The module. Must be called before the module is optimized. </param>
+    void EmitFunctionVariants(IRModuleEmitter& module);
+} // namespace emitters
+} // namespace ell
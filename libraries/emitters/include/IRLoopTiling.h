@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRLoopTiling.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "IRFunctionEmitter.h"
+#include "TargetDevice.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    /// <summary> A level of a target device's data cache. </summary>
+    enum class CacheLevel
+    {
+        L1,
+        L2
+    };
+
+    /// <summary> An array that the body of a loop nest reads or writes. </summary>
+    struct LoopNestArrayAccess
+    {
+        std::vector<size_t> loops; // the indices of the loops whose index variables index the array
+        size_t bytesPerIteration = 0; // the number of bytes of the array one iteration of those loops touches
+    };
+
+    /// <summary> Gets the size of a level of a target device's data cache, in bytes, or 0 if it's unknown or the device has no such cache. </summary>
+    size_t GetCacheSize(const TargetDevice& targetDevice, CacheLevel level);
+
+    /// <summary>
+    /// Chooses tile sizes for the loops of a loop nest, so that the data the body touches while iterating over one
+    /// tile fits in half of a level of the target device's cache. The largest tiles are halved first, and the tile
+    /// of the innermost loop is kept at least a cache line wide. The loops aren't tiled if the cache size is unknown.
+    /// </summary>
+    ///
+    /// <param name="targetDevice"> The target device. </param>
+    /// <param name="loopSizes"> The number of iterations of each loop, from the outermost to the innermost. </param>
+    /// <param name="arrays"> The arrays the body of the loop nest reads or writes. </param>
+    /// <param name="level"> The level of the cache to size the tiles for. </param>
+    ///
+    /// <returns> The tile size of each loop, each between 1 and the number of iterations of the loop. </returns>
+    std::vector<int> GetCacheTileSizes(const TargetDevice& targetDevice, const std::vector<int>& loopSizes, const std::vector<LoopNestArrayAccess>& arrays, CacheLevel level = CacheLevel::L1);
+
+    /// <summary> Splits the ranges of a loop nest into tiles that are sized by `GetCacheTileSizes`. </summary>
+    ///
+    /// <param name="targetDevice"> The target device. </param>
+    /// <param name="ranges"> The range of each loop, from the outermost to the innermost. </param>
+    /// <param name="arrays"> The arrays the body of the loop nest reads or writes. </param>
+    /// <param name="level"> The level of the cache to size the tiles for. </param>
+    ///
+    /// <returns> The tiled range of each loop, for `IRFunctionEmitter::For`. </returns>
+    std::vector<IRFunctionEmitter::ConstTiledLoopRange> GetCacheTiledLoopRanges(const TargetDevice& targetDevice, const std::vector<IRFunctionEmitter::ConstLoopRange>& ranges, const std::vector<LoopNestArrayAccess>& arrays, CacheLevel level = CacheLevel::L1);
+} // namespace emitters
+} // namespace ell
@@ -30,6 +30,20 @@ namespace emitters
     template <typename ValueType>
     IRLocalScalar Tanh(IRLocalScalar a);
 
+    // Fast approximations of transcendental functions. These are computed with polynomial and rational approximations
+    // instead of calls to the C runtime library, so loops that use them can be vectorized, and they also accept
+    // vector values. The maximum errors below are relative to the correctly-rounded result, measured without FMA contraction.
+    // Inputs are assumed to be finite. `Exp` and `Tanh` use them when the `useApproximateMath` compiler option is set.
+
+    /// <summary> Fast approximate exp. Max error 1 ULP for float and 2 ULP for double. Results that would be denormal are flushed to zero. </summary>
+    IRLocalScalar FastExp(IRLocalScalar a);
+
+    /// <summary> Fast approximate tanh. Max error 2 ULP for float and double. </summary>
+    IRLocalScalar FastTanh(IRLocalScalar a);
+
+    /// <summary> Fast approximate logistic sigmoid, 1 / (1 + exp(-a)). Max error 3 ULP for float and double. </summary>
+    IRLocalScalar FastSigmoid(IRLocalScalar a);
+
     IRLocalScalar Min(IRLocalScalar a, IRLocalScalar b);
     template <typename ValueType, utilities::IsFundamental<ValueType> = true>
     IRLocalScalar Min(ValueType a, IRLocalScalar b);
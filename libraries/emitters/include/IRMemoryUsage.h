@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRMemoryUsage.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    class IRModuleEmitter;
+
+    /// <summary> The stack memory used by a function of a module. </summary>
+    struct FunctionMemoryUsage
+    {
+        std::string name;
+        uint64_t frameSize = 0; // the size of the function's own stack allocations, in bytes
+        uint64_t stackSize = 0; // the frame size plus the largest stack size of the functions it calls, in bytes
+        bool isStackSizeBounded = true; // false if the function, or a function it calls, is recursive or allocates a variable amount of stack
+    };
+
+    /// <summary> The memory used by a module, from the sizes of its global variables and stack allocations. </summary>
+    struct ModuleMemoryUsage
+    {
+        uint64_t staticDataSize = 0; // mutable global variables, which need RAM
+        uint64_t constantDataSize = 0; // constant global variables, which can be kept in flash
+        std::vector<FunctionMemoryUsage> functions; // the functions defined by the module
+        std::vector<std::string> heapFunctions; // the heap allocation functions the module calls
+
+        /// <summary> Gets the memory usage of a function of the module, or `nullptr` if it doesn't define a function with that name. </summary>
+        const FunctionMemoryUsage* GetFunction(const std::string& name) const;
+    };
+
+    /// <summary>
+    /// Estimates the memory a module uses. Stack sizes only count the functions' `alloca` instructions, not
+    /// registers spilled by the code generator or the call frames themselves, so they are a lower bound that is
+    /// close for the optimized IR of a model, where most of the stack holds arrays. Calls to functions the module
+    /// doesn't define (other than heap allocation functions) are assumed to use no stack.
+    /// </summary>
+    ///
+    /// <param name="module"> The module. </param>
+    ///
+    /// <returns> The memory usage of the module. </returns>
+    ModuleMemoryUsage GetModuleMemoryUsage(IRModuleEmitter& module);
+
+    /// <summary> Checks that no function of a module allocates heap memory, by calling `malloc` or a related function. </summary>
+    ///
+    /// <param name="module"> The module. </param>
+    ///
+    /// <exception cref="EmitterException"> Thrown if the module calls a heap allocation function. </exception>
+    void VerifyNoHeapAllocation(IRModuleEmitter& module);
+} // namespace emitters
+} // namespace ell
@@ -56,6 +56,30 @@ namespace emitters
     /// </remarks>
     static const std::string c_stepTimeFunctionTagName = "ell.fn.stepTime";
 
+    /// <summary> Indicates a function that should get variants for other CPU feature sets, chosen between at runtime. </summary>
+    /// <remarks>
+    /// Set the values to the names of the feature sets (see `EmitFunctionVariants`).
+    /// </remarks>
+    static const std::string c_functionVariantsTagName = "ell.fn.variants";
+
+    /// <summary> Indicates a function emitted for a model node, so remarks about its code can be traced back to the node. </summary>
+    /// <remarks>
+    /// Set the values to the node's id and type name.
+    /// </remarks>
+    static const std::string c_nodeFunctionTagName = "ell.fn.node";
+
+    /// <summary> Indicates that a mutable global variable is shared by all instances of a reentrant module (see `MarkGlobalShared`). </summary>
+    /// <remarks>
+    /// Set a global-level tag with no values.
+    /// </remarks>
+    static const std::string c_sharedGlobalTagName = "ell.global.shared";
+
+    /// <summary> Indicates that a constant global variable holds weights that can be moved to an external blob (see `MarkGlobalAsWeights`). </summary>
+    /// <remarks>
+    /// Set a global-level tag with no values.
+    /// </remarks>
+    static const std::string c_weightsGlobalTagName = "ell.global.weights";
+
     /// <summary> Gets tag to Indicate the names of a struct's fields. </summary>
     /// <remarks>
     /// Returns a module-level tag, with the type name encoded in the name and field names as the value.
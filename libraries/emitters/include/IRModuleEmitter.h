@@ -12,6 +12,7 @@
 #include "IRAssemblyWriter.h"
 #include "IRDiagnosticHandler.h"
 #include "IREmitter.h"
+#include "IRExternalWeights.h"
 #include "IRFunctionEmitter.h"
 #include "IRProfiler.h"
 #include "IRRuntime.h"
@@ -491,7 +492,8 @@ namespace emitters
         ///
         /// <param name="filePath"> Full pathname of the file. </param>
         /// <param name="format"> The format of the output. </param>
-        /// <param name="options"> Options to control how machine code is generated during output. </params>
+        /// <param name="options"> Options to control how machine code is generated during output. If `options.numPartitions` is greater
+        /// than 1, object code is split into that many files, named by `GetPartitionFilePath`, which are compiled in parallel. </params>
         void WriteToFile(const std::string& filePath, ModuleOutputFormat format, const MachineCodeOutputOptions& options);
 
         /// <summary> Output the compiled module to an output stream with the given format. </summary>
@@ -686,6 +688,10 @@ namespace emitters
         template <typename T>
         LLVMValue EmitLiteralVector(LiteralVectorVariable<T>& var);
 
+        /// Emit IR for a stack vector in the current function. Its contents are undefined until written.
+        template <typename T>
+        LLVMValue EmitLocalVector(VectorVariable<T>& var);
+
         /// Emit IR for a global vector. Global is initialized to zero.
         template <typename T>
         LLVMValue EmitGlobalVector(VectorVariable<T>& var);
@@ -698,6 +704,10 @@ namespace emitters
         template <typename T>
         LLVMValue EmitRef(VectorElementVariable<T>& var);
 
+        /// Emit IR for a view of a range of a vector. The pointer is computed again in each function it's used in.
+        template <typename T>
+        LLVMValue EmitRef(VectorViewVariable<T>& var);
+
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, bool isPublic = false);
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, const VariableTypeList& arguments, bool isPublic = false);
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, const NamedVariableTypeList& arguments, bool isPublic = false);
@@ -716,6 +726,8 @@ namespace emitters
         // Actual code output implementations
         void WriteHeader(std::ostream& stream);
         void WriteToLLVMStream(llvm::raw_ostream& stream, ModuleOutputFormat format, MachineCodeOutputOptions options);
+        void WritePartitionedObjectCode(const std::string& filePath, const MachineCodeOutputOptions& options);
+        MachineCodeOutputOptions CompleteMachineCodeOutputOptions(MachineCodeOutputOptions options) const; // fills in the target device from the compiler options
 
         //
         // Lower-level internal functions
@@ -788,7 +800,9 @@ namespace emitters
     template <typename ValueType>
     llvm::GlobalVariable* IRModuleEmitter::ConstantArray(const std::string& name, const std::vector<ValueType>& value)
     {
-        return AddGlobal(name, _emitter.ArrayType(GetVariableType<ValueType>(), value.size()), _emitter.Literal(value), true);
+        auto global = AddGlobal(name, _emitter.ArrayType(GetVariableType<ValueType>(), value.size()), _emitter.Literal(value), true);
+        MarkGlobalAsWeights(*global);
+        return global;
     }
 
     template <typename ValueType>
@@ -884,6 +898,21 @@ namespace emitters
             _globals.Add(var.EmittedName(), pVal);
             break;
 
+        case VariableScope::local:
+            if (var.IsVectorRef())
+            {
+                pVal = EmitRef<T>(static_cast<VectorViewVariable<T>&>(var));
+            }
+            else if (!var.HasInitValue())
+            {
+                pVal = EmitLocalVector<T>(static_cast<VectorVariable<T>&>(var));
+            }
+            else
+            {
+                throw EmitterException(EmitterError::variableScopeNotSupported);
+            }
+            break;
+
         default:
             throw EmitterException(EmitterError::variableScopeNotSupported);
         }
@@ -938,6 +967,13 @@ namespace emitters
         return ConstantArray(var.EmittedName(), var.Data());
     }
 
+    template <typename T>
+    LLVMValue IRModuleEmitter::EmitLocalVector(VectorVariable<T>& var)
+    {
+        auto& currentFunction = GetCurrentFunction();
+        return currentFunction.EmittedVariable(var.Type(), static_cast<int>(var.Dimension()), var.EmittedName());
+    }
+
     template <typename T>
     LLVMValue IRModuleEmitter::EmitGlobalVector(VectorVariable<T>& var)
     {
@@ -957,6 +993,14 @@ namespace emitters
         LLVMValue pSrcVar = EnsureEmitted(var.Src());
         return currentFunction.PtrOffsetA(pSrcVar, currentFunction.Literal(var.Offset()), var.EmittedName());
     }
+
+    template <typename T>
+    LLVMValue IRModuleEmitter::EmitRef(VectorViewVariable<T>& var)
+    {
+        auto& currentFunction = GetCurrentFunction();
+        LLVMValue pSrcVar = EnsureEmitted(var.Src());
+        return currentFunction.PointerOffset(pSrcVar, var.Offset());
+    }
 } // namespace emitters
 } // namespace ell
 
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRObjectCache.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <memory>
+#include <string>
+
+namespace ell
+{
+namespace emitters
+{
+    /// <summary>
+    /// An on-disk cache of the object code generated by the JIT. Objects are stored in a directory, in files named after
+    /// a caller-supplied key and the module's name. When the execution engine finds an object in the cache, it loads it
+    /// instead of generating code for the module. The caller is responsible for choosing a key that changes whenever
+    /// anything that affects the generated code changes.
+    /// </summary>
+    class IRObjectCache : public llvm::ObjectCache
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="directory"> The directory that holds the cached objects. It is created if it doesn't exist. </param>
+        /// <param name="key"> The key that identifies the code being compiled. </param>
+        IRObjectCache(const std::string& directory, const std::string& key);
+
+        /// <summary> Indicates if the cache holds an object for the module with the given name. </summary>
+        ///
+        /// <param name="moduleName"> The module's identifier. </param>
+        bool HasObject(const std::string& moduleName) const;
+
+        /// <summary> Gets the path of the cached object for the module with the given name. </summary>
+        ///
+        /// <param name="moduleName"> The module's identifier. </param>
+        std::string GetObjectPath(const std::string& moduleName) const;
+
+        /// <summary> Called by the execution engine after generating code for a module. Writes the object to the cache. </summary>
+        void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object) override;
+
+        /// <summary> Called by the execution engine before generating code for a module. Returns the cached object, or `nullptr`. </summary>
+        std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+    private:
+        std::string _directory;
+        std::string _key;
+    };
+} // namespace emitters
+} // namespace ell
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "CompilerOptions.h"
 #include "IRLocalScalar.h"
 #include "LLVMUtilities.h"
 
@@ -27,8 +28,13 @@ namespace emitters
             numTasks(0) {}
         ParallelLoopOptions(int numTasks) :
             numTasks(numTasks) {}
+        ParallelLoopOptions(ParallelLoopSchedule schedule, int chunkSize = 0) :
+            schedule(schedule),
+            chunkSize(chunkSize) {}
 
         int numTasks = 0; // The number of tasks to break the loop into. '0' is the special 'auto' flag
+        ParallelLoopSchedule schedule = ParallelLoopSchedule::automatic; // How to split the iterations among the tasks. 'automatic' uses the compiler options
+        int chunkSize = 0; // The chunk size for dynamic and guided schedules. '0' uses the compiler options
     };
 
     /// <summary> Class that simplifies parallel for loop creation. </summary>
@@ -53,7 +59,10 @@ namespace emitters
         void EmitLoop(int begin, int end, int increment, const ParallelLoopOptions& options, const std::vector<LLVMValue>& capturedValues, BodyFunction body);
         void EmitLoop(IRLocalScalar begin, IRLocalScalar end, IRLocalScalar increment, const ParallelLoopOptions& options, const std::vector<LLVMValue>& capturedValues, BodyFunction body);
 
+        void EmitChunkedLoop(IRLocalScalar begin, IRLocalScalar increment, IRLocalScalar numIterations, int numTasks, ParallelLoopSchedule schedule, int chunkSize, const std::vector<LLVMValue>& capturedValues, BodyFunction body);
+
         IRFunctionEmitter GetTaskFunction(const std::vector<LLVMValue>& capturedValues, BodyFunction body);
+        IRFunctionEmitter GetChunkedTaskFunction(int numTasks, ParallelLoopSchedule schedule, int chunkSize, const std::vector<LLVMValue>& capturedValues, BodyFunction body);
 
         LLVMValue GetIterationVariable();
         LLVMValue LoadIterationVariable();
@@ -37,6 +37,14 @@ namespace emitters
         /// <summary> Gets the LLVM type for a pointer to the `timespec` structure on the current target. </summary>
         LLVMType GetTimespecPointerType();
 
+        //
+        // memory
+        //
+
+        /// <summary> Gets an LLVMFunction representing the madvise function. </summary>
+        /// int madvise(void* addr, size_t length, int advice);
+        LLVMFunction GetMadviseFunction();
+
         //
         // pthreads
         //
@@ -76,6 +84,10 @@ namespace emitters
         /// pthread_t pthread_self(void);
         LLVMFunction GetPthreadSelfFunction();
 
+        /// <summary> Gets an LLVMFunction representing the pthread_setaffinity_np function (Linux only). </summary>
+        /// int pthread_setaffinity_np(pthread_t thread, size_t cpusetsize, const cpu_set_t* cpuset);
+        LLVMFunction GetPthreadSetAffinityFunction();
+
         // pthreads -- synchronization functions
 
         /// <summary> Gets an LLVMFunction representing the pthread_mutex_init function. </summary>
@@ -18,12 +18,20 @@
 // External API for profiling functions
 extern "C" {
 
-/// <summary> A struct that holds information about a profile region. </summary>
+/// <summary>
+/// A struct that holds information about a profile region. The hardware counter fields are only filled in
+/// if the module was compiled with `profileHardwareCounters` enabled, and are zero otherwise.
+/// </summary>
 struct ProfileRegionInfo
 {
     int64_t count;
     double totalTime;
     const char* name;
+    int64_t cycles;
+    int64_t instructions;
+    int64_t l1CacheMisses;
+    int64_t lastLevelCacheMisses;
+    int64_t branchMisses;
 };
 }
 
@@ -41,6 +49,7 @@ namespace emitters
     /// <summary>
     /// A class representing a function-scoped region to profile.
     /// Emitted code within this region will have its total runtime measured, and the total number of times run tallied.
+    /// If hardware counters are enabled, the CPU cycles, instructions retired, cache misses and branch misses are accumulated as well.
     /// </summary>
     class IRProfileRegion
     {
@@ -70,6 +79,8 @@ namespace emitters
         IRProfiler& _profiler;
         IRLocalScalar _index;
         IRLocalScalar _startTime;
+        LLVMValue _startCounters = nullptr;
+        LLVMValue _endCounters = nullptr;
     };
 
     /// <summary>
@@ -126,12 +137,18 @@ namespace emitters
         /// <returns> The name of the emitted "ResetRegionProfilingInfo" function. </returns>
         std::string GetResetRegionProfilingInfoFunctionName() const;
 
+        /// <summary> Get the name of the emitted "ReadHardwareCounters" function. </summary>
+        ///
+        /// <returns> The name of the emitted "ReadHardwareCounters" function. </returns>
+        std::string GetReadHardwareCountersFunctionName() const;
+
     private:
         friend IRProfileRegion;
 
         std::string GetNamespacePrefix() const;
         llvm::StructType* GetRegionType() const;
         IRLocalScalar GetCurrentTime(IRFunctionEmitter& function);
+        void ReadHardwareCounters(IRFunctionEmitter& function, LLVMValue counters);
 
         // Actual implementations of the functions in IRProfileRegion
         void InitRegion(IRProfileRegion& region, const std::string& desiredName);
@@ -146,6 +163,9 @@ namespace emitters
         void EmitGetNumRegionsFunction();
         void EmitGetRegionProfilingInfoFunction();
         void EmitResetRegionProfilingInfoFunction();
+        void EmitReadHardwareCountersFunction();
+        void EmitReadPerfEventCounters(IRFunctionEmitter& function, LLVMValue counters);
+        void EmitReadArmCycleCounter(IRFunctionEmitter& function, LLVMValue counters);
 
         // Lower-level codegen
         // CreateRegion returns the index of the new region
@@ -162,12 +182,14 @@ namespace emitters
 
         emitters::IRModuleEmitter* _module = nullptr;
         bool _profilingEnabled = false;
+        bool _hardwareCountersEnabled = false;
 
         std::unordered_set<std::string> _regionNames;
 
         // Cache these often-used functions so we don't have to keep looking them up by name
         LLVMFunction _getNumRegionsFunction = nullptr;
         LLVMFunction _getRegionBufferFunction = nullptr;
+        LLVMFunction _readHardwareCountersFunction = nullptr;
 
         llvm::StructType* _profileRegionType = nullptr;
         llvm::GlobalVariable* _profileRegionsArray = nullptr;
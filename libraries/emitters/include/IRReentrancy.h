@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRReentrancy.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+
+namespace llvm
+{
+class GlobalVariable;
+}
+
+namespace ell
+{
+namespace emitters
+{
+    class IRModuleEmitter;
+
+    /// <summary>
+    /// Marks a mutable global variable as shared by all instances of a reentrant module, so `EmitReentrantFunctions`
+    /// leaves it as a global instead of moving it into the per-instance state. Used for things like profiling
+    /// counters and the thread pool, which belong to the process rather than to a single instance of the model.
+    /// </summary>
+    ///
+    /// <param name="global"> The global variable. </param>
+    void MarkGlobalShared(llvm::GlobalVariable& global);
+
+    /// <summary> Indicates if a global variable has been marked as shared with `MarkGlobalShared`. </summary>
+    ///
+    /// <param name="global"> The global variable. </param>
+    ///
+    /// <returns> `true` if the global is shared by all instances of the module. </returns>
+    bool IsGlobalShared(const llvm::GlobalVariable& global);
+
+    /// <summary> Gets the name of the reentrant version of a function emitted by `EmitReentrantFunctions`. </summary>
+    ///
+    /// <param name="functionName"> The name of the original function. </param>
+    ///
+    /// <returns> The name of the reentrant version of the function, which takes a pointer to the state as its first argument. </returns>
+    std::string GetReentrantFunctionName(const std::string& functionName);
+
+    /// <summary>
+    /// Makes the functions in a module reentrant by moving its mutable global variables (other than the ones marked as shared)
+    /// into a state struct that the caller allocates. Constant globals, like the weights of a model, stay shared by all instances.
+    ///
+    /// Each function that uses the state, directly or by calling another function that does, gets an extra first argument
+    /// pointing to the state. The functions declared in the header keep their original signatures, and use a default instance
+    /// of the state, so existing callers keep working; the versions that take the state are declared alongside them, named
+    /// with `GetReentrantFunctionName`. The model's Reset function always gets a reentrant version, even if the model has no state.
+    ///
+    /// The module also gets `<module>_GetStateSize` and `<module>_GetStateAlignment` functions, which return the size and
+    /// alignment the caller must allocate the state with, and `<module>_InitializeState`, which sets a state to its initial values.
+    /// </summary>
+    ///
+    /// <param name="module"> The module. Must be called after all the module's functions have been emitted, and before it is optimized. </param>
+    void EmitReentrantFunctions(IRModuleEmitter& module);
+} // namespace emitters
+} // namespace ell
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRRingBuffer.h (emitters)
+//  Authors:  Lisa Ong
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "EmitterTypes.h"
+#include "LLVMUtilities.h"
+
+#include <string>
+
+namespace llvm
+{
+class GlobalVariable;
+}
+
+namespace ell
+{
+namespace emitters
+{
+    class IRFunctionEmitter;
+    class IRModuleEmitter;
+
+    /// <summary>
+    /// A single-producer, single-consumer ring buffer of fixed-size frames, stored in module globals. The producer and
+    /// consumer may run on different threads without locks: each only writes its own index, publishing it with a
+    /// release store, and reads the other's index with an acquire load. The indices count every frame pushed or
+    /// popped, so the buffer holds `head - tail` frames.
+    /// </summary>
+    class IRRingBuffer
+    {
+    public:
+        /// <summary> Constructor. Adds the buffer's storage and indices to the module as globals. </summary>
+        ///
+        /// <param name="module"> The module to add the buffer to. </param>
+        /// <param name="name"> The prefix for the names of the buffer's globals. </param>
+        /// <param name="valueType"> The type of the values in a frame. </param>
+        /// <param name="frameSize"> The number of values in a frame. </param>
+        /// <param name="capacity"> The number of frames the buffer can hold. </param>
+        IRRingBuffer(IRModuleEmitter& module, const std::string& name, VariableType valueType, int frameSize, int capacity);
+
+        /// <summary> Emits code that copies a frame into the buffer if there is room for it. </summary>
+        ///
+        /// <param name="function"> The function being emitted. Must only be called by the producer. </param>
+        /// <param name="frame"> Pointer to the frame to copy. </param>
+        ///
+        /// <returns> A boolean (byte) value that is true if the frame was pushed, and false if the buffer was full. </returns>
+        LLVMValue Push(IRFunctionEmitter& function, LLVMValue frame);
+
+        /// <summary> Emits code that copies the oldest frame out of the buffer, if there is one. </summary>
+        ///
+        /// <param name="function"> The function being emitted. Must only be called by the consumer. </param>
+        /// <param name="frame"> Pointer to the memory to copy the frame to. </param>
+        ///
+        /// <returns> A boolean (byte) value that is true if a frame was popped, and false if the buffer was empty. </returns>
+        LLVMValue Pop(IRFunctionEmitter& function, LLVMValue frame);
+
+        /// <summary> Emits a public function with the signature `bool functionName(ValueType* frame)` that calls `Push`. </summary>
+        ///
+        /// <param name="functionName"> The name of the function. </param>
+        void EmitPushFunction(const std::string& functionName);
+
+        /// <summary> Emits a public function with the signature `bool functionName(ValueType* frame)` that calls `Pop`. </summary>
+        ///
+        /// <param name="functionName"> The name of the function. </param>
+        void EmitPopFunction(const std::string& functionName);
+
+        /// <summary> Gets the number of values in a frame. </summary>
+        int GetFrameSize() const { return _frameSize; }
+
+        /// <summary> Gets the number of frames the buffer can hold. </summary>
+        int GetCapacity() const { return _capacity; }
+
+    private:
+        LLVMValue Transfer(IRFunctionEmitter& function, LLVMValue frame, llvm::GlobalVariable* ownIndex, llvm::GlobalVariable* otherIndex, bool isPush);
+        void EmitTransferFunction(const std::string& functionName, bool isPush);
+
+        IRModuleEmitter& _module;
+        VariableType _valueType;
+        int _frameSize;
+        int _capacity;
+        llvm::GlobalVariable* _frames;
+        llvm::GlobalVariable* _head; // frames pushed so far; written only by the producer
+        llvm::GlobalVariable* _tail; // frames popped so far; written only by the consumer
+    };
+} // namespace emitters
+} // namespace ell
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRSmallMatrixKernels.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CompilerOptions.h"
+#include "IRFunctionEmitter.h"
+#include "LLVMUtilities.h"
+
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    /// <summary>
+    /// Indicates if a matrix product is small enough to emit as fully unrolled code instead of calling GEMV or GEMM,
+    /// according to the `smallMatrixThreshold` compiler option.
+    /// </summary>
+    ///
+    /// <param name="options"> The compiler options. </param>
+    /// <param name="numMultiplyAdds"> The number of multiply-adds the product takes (m * n for GEMV, m * n * k for GEMM). </param>
+    ///
+    /// <returns> `true` if the product should be emitted as unrolled code. </returns>
+    bool UseSmallMatrixKernel(const CompilerOptions& options, int numMultiplyAdds);
+
+    /// <summary>
+    /// Emits fully unrolled code for the row-major matrix-vector product y = A * x, where the matrix is known at
+    /// compile time. The matrix entries are baked into the code as constants, and the products with zero entries are
+    /// left out. Each element of x is loaded once.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="m"> The number of rows of A. </param>
+    /// <param name="n"> The number of columns of A. </param>
+    /// <param name="A"> The entries of A. </param>
+    /// <param name="lda"> The stride between the rows of A. </param>
+    /// <param name="x"> Pointer to the input vector. </param>
+    /// <param name="incx"> The stride between the elements of x. </param>
+    /// <param name="y"> Pointer to the output vector. </param>
+    /// <param name="incy"> The stride between the elements of y. </param>
+    template <typename ValueType>
+    void EmitSmallGEMV(IRFunctionEmitter& function, int m, int n, const std::vector<ValueType>& A, int lda, LLVMValue x, int incx, LLVMValue y, int incy);
+
+    /// <summary>
+    /// Emits fully unrolled code for the row-major matrix-vector product y = A * x. Each entry of A and element of x
+    /// is loaded once.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="m"> The number of rows of A. </param>
+    /// <param name="n"> The number of columns of A. </param>
+    /// <param name="A"> Pointer to the matrix. </param>
+    /// <param name="lda"> The stride between the rows of A. </param>
+    /// <param name="x"> Pointer to the input vector. </param>
+    /// <param name="incx"> The stride between the elements of x. </param>
+    /// <param name="y"> Pointer to the output vector. </param>
+    /// <param name="incy"> The stride between the elements of y. </param>
+    template <typename ValueType>
+    void EmitSmallGEMV(IRFunctionEmitter& function, int m, int n, LLVMValue A, int lda, LLVMValue x, int incx, LLVMValue y, int incy);
+
+    /// <summary>
+    /// Emits fully unrolled code for the row-major matrix-matrix product C = op(A) * op(B), with the same arguments as
+    /// `IRFunctionEmitter::CallGEMM`. Each entry of A and B is loaded once.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="transposeA"> If true, transpose the A matrix. </param>
+    /// <param name="transposeB"> If true, transpose the B matrix. </param>
+    /// <param name="m"> The number of rows of op(A) and C. </param>
+    /// <param name="n"> The number of columns of op(B) and C. </param>
+    /// <param name="k"> The number of columns of op(A) and rows of op(B). </param>
+    /// <param name="A"> Pointer to the A matrix. </param>
+    /// <param name="lda"> The stride between the rows of A. </param>
+    /// <param name="B"> Pointer to the B matrix. </param>
+    /// <param name="ldb"> The stride between the rows of B. </param>
+    /// <param name="C"> Pointer to the output matrix. </param>
+    /// <param name="ldc"> The stride between the rows of C. </param>
+    template <typename ValueType>
+    void EmitSmallGEMM(IRFunctionEmitter& function, bool transposeA, bool transposeB, int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc);
+} // namespace emitters
+} // namespace ell
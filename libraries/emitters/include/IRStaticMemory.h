@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRStaticMemory.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+namespace ell
+{
+namespace emitters
+{
+    class IRModuleEmitter;
+
+    /// <summary>
+    /// Moves the fixed-size scratch arrays the functions in a module allocate on the stack into internal global
+    /// variables, so all the memory a model uses, other than a few bytes of stack, is allocated statically and shows up
+    /// in the linker's memory map. This is meant for microcontrollers, whose stacks are too small for the scratch buffers
+    /// that some nodes use. It assumes no function of the module runs on more than one thread at a time, so it can't be
+    /// used with `parallelize`; the globals are moved into the state of a reentrant module like any other mutable global.
+    /// </summary>
+    ///
+    /// <param name="module"> The module. Must be called after all the module's functions have been emitted, and before `EmitReentrantFunctions`. </param>
+    /// <param name="minimumSize"> The size, in bytes, below which stack allocations are left alone, so scalars can still be kept in registers. </param>
+    ///
+    /// <returns> The total size of the arrays that were moved, in bytes. </returns>
+    uint64_t MoveStackArraysToGlobals(IRModuleEmitter& module, uint64_t minimumSize = 64);
+} // namespace emitters
+} // namespace ell
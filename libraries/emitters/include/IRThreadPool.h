@@ -8,11 +8,13 @@
 
 #pragma once
 
+#include "CompilerOptions.h"
 #include "IREmitter.h"
 #include "LLVMUtilities.h"
 
 #include <llvm/IR/GlobalVariable.h>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -29,6 +31,19 @@ namespace emitters
     //
     // IRThreadPool: Simple thread pool class that schedules tasks in blocks, and associated classes:
     //
+    // By default, all worker threads pop tasks from a single mutex-guarded queue. If the `useWorkStealing`
+    // compiler option is set, each worker instead owns a deque of task indices, packed as a (begin, end) pair
+    // into a single 64-bit word. Workers pop from the front of their own deque, and steal from the back of
+    // other workers' deques when theirs is empty, using atomic compare-and-exchange. The mutex and condition
+    // variables are then only used to put idle workers to sleep and to wake up clients waiting for tasks to finish.
+    //
+    // If the `threadPoolSpinCount` compiler option is set, idle workers and waiting clients first poll the task
+    // counts (read atomically) for a while, with an exponential CPU pause backoff, and only block on the condition
+    // variables if nothing changed in that time.
+    //
+    // On Linux targets, the `threadAffinity` compiler option pins each worker to a core when the pool starts, so the OS
+    // doesn't migrate workers between sockets, or between the big and little cores of a big.LITTLE CPU.
+    //
     // IRThreadPoolTask
     // IRThreadPoolTaskArray
     // IRThreadPoolTaskQueue
@@ -147,6 +162,15 @@ namespace emitters
         /// <returns> The next task in the queue. </param>
         IRThreadPoolTask PopNextTask(IRFunctionEmitter& function);
 
+        /// <summary> Pop a task off the given worker's own deque, or steal one from another worker's deque,
+        /// waiting for one to become available if necessary. Only valid if work stealing is enabled. </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        /// <param name="workerIndex"> The index of the worker thread requesting a task. </param>
+        ///
+        /// <returns> The task taken from the deques. </param>
+        IRThreadPoolTask PopOrStealNextTask(IRFunctionEmitter& function, LLVMValue workerIndex);
+
         /// <summary> Wait for all tasks to finish. </summary>
         ///
         /// <param name="function"> The function currently being emitted into. </param>
@@ -157,10 +181,19 @@ namespace emitters
         /// <returns> A task array object representing the tasks. </param>
         IRThreadPoolTaskArray& GetTaskArray() { return _tasks; }
 
+        /// <summary> Indicates if the queue schedules tasks with per-worker deques and work stealing. </summary>
+        ///
+        /// <returns> `true` if work stealing is enabled. </returns>
+        bool UseWorkStealing() const { return _workerTaskRanges != nullptr; }
+
     private:
         friend class IRThreadPool;
         IRThreadPoolTaskQueue(); // create an empty queue
         void Initialize(IRFunctionEmitter& function); // initializes the task array
+        void InitializeWorkStealing(IRModuleEmitter& module, int numWorkers); // allocates the per-worker deques
+        void SetSpinCount(int spinCount) { _spinCount = spinCount; }
+        bool UseAtomicCounts() const { return UseWorkStealing() || _spinCount > 0; }
+        void SpinWait(IRFunctionEmitter& function, std::function<LLVMValue(IRFunctionEmitter&)> isDone); // busy-waits until `isDone` or the spin count runs out
         LLVMValue GetDataStruct() { return _queueData; }
         LLVMValue DecrementCountField(IRFunctionEmitter& function, LLVMValue fieldPtr);
         llvm::StructType* GetTaskQueueDataType(IRModuleEmitter& module) const;
@@ -179,6 +212,10 @@ namespace emitters
         LLVMValue IsEmpty(IRFunctionEmitter& function) const;
         LLVMValue IsFinished(IRFunctionEmitter& function) const;
 
+        // Work-stealing deques
+        void SetWorkerTaskRanges(IRFunctionEmitter& function, int numTasks);
+        LLVMValue TryTakeTask(IRFunctionEmitter& function, LLVMValue workerRangePtr, LLVMValue isOwner);
+
         bool IsInitialized() const;
         void NotifyWaitingClients(IRFunctionEmitter& function);
         void LockQueueMutex(IRFunctionEmitter& function);
@@ -196,12 +233,22 @@ namespace emitters
         };
         LLVMValue _queueData = nullptr; // a struct with the above fields
         IRThreadPoolTaskArray _tasks;
+
+        int _numWorkers = 0;
+        int _spinCount = 0;
+        llvm::GlobalVariable* _workerTaskRanges = nullptr; // global array of packed (begin, end) task index ranges, one per worker
     };
 
     //
     // IRThreadPool
     //
 
+    /// <summary>
+    /// Gets the core each worker thread of the thread pool is pinned to, from the `threadAffinity`, `affinityCores`, and
+    /// `affinitySockets` compiler options. Returns an empty vector if the workers aren't pinned.
+    /// </summary>
+    std::vector<int> GetThreadPoolWorkerCores(const CompilerOptions& options);
+
     /// <summary> Class representing a set of threads that can run asynchronous tasks. </summary>
     class IRThreadPool
     {
@@ -233,6 +280,8 @@ namespace emitters
         IRModuleEmitter& _module;
         size_t _maxThreads = 0;
         llvm::GlobalVariable* _threads = nullptr; // global array of pthread_t
+        llvm::GlobalVariable* _workerIndices = nullptr; // global array of worker indices passed to the threads (if work stealing)
+        llvm::GlobalVariable* _workerCpuSets = nullptr; // global array of the cpu_set_t each thread is pinned to (if pinning threads)
 
         // task queue
         IRThreadPoolTaskQueue _taskQueue;
@@ -18,6 +18,12 @@ namespace ell
 {
 namespace emitters
 {
+    /// <summary> The name of the function a module compiled with `externalThreadPool` calls to start a task, which the application provides: `void* ELL_SubmitTask(void* (*taskFunction)(void*), void* taskArgument, int32_t priority)` </summary>
+    extern const char* c_submitTaskFunctionName;
+
+    /// <summary> The name of the function a module compiled with `externalThreadPool` calls to wait for a task and get its return value, which the application provides: `void* ELL_WaitForTask(void* task)` </summary>
+    extern const char* c_waitForTaskFunctionName;
+
     //
     // Functions
     //
@@ -45,5 +51,15 @@ namespace emitters
     ///
     /// <returns> An LLVM StructType pointer for a struct that can hold the functions arguments. </returns>
     llvm::StructType* GetTaskArgStructType(IRModuleEmitter& module, LLVMFunction taskFunction);
+
+    /// <summary> Get the declaration of the external thread pool's `ELL_SubmitTask` function. </summary>
+    ///
+    /// <param name="module"> The module being emitted. </param>
+    LLVMFunction GetSubmitTaskFunction(IRModuleEmitter& module);
+
+    /// <summary> Get the declaration of the external thread pool's `ELL_WaitForTask` function. </summary>
+    ///
+    /// <param name="module"> The module being emitted. </param>
+    LLVMFunction GetWaitForTaskFunction(IRModuleEmitter& module);
 } // namespace emitters
 } // namespace ell
@@ -40,6 +40,39 @@ namespace emitters
     template <typename ValueType, utilities::IsFloatingPoint<ValueType> = true>
     LLVMValue FillVector(IRFunctionEmitter& function, llvm::VectorType* type, ValueType elementValue);
 
+    /// <summary> Create a vector filled with copies of a value computed at runtime </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the value </typeparam>
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="vectorSize"> The number of elements in the result vector </param>
+    /// <param name="elementValue"> The value to place in the vector elements </param>
+    ///
+    /// <returns> An LLVM vector with repeated entries of the given value </returns>
+    template <typename ValueType>
+    LLVMValue BroadcastToVector(IRFunctionEmitter& function, int vectorSize, LLVMValue elementValue);
+
+    /// <summary> Load a vector of consecutive elements of an array. The first element needn't be aligned to the size of the vector. </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the array elements </typeparam>
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="pArray"> Pointer to the array </param>
+    /// <param name="offset"> The index of the first element to load </param>
+    /// <param name="vectorSize"> The number of elements to load </param>
+    ///
+    /// <returns> The LLVM vector holding the elements </returns>
+    template <typename ValueType>
+    LLVMValue LoadVector(IRFunctionEmitter& function, LLVMValue pArray, LLVMValue offset, int vectorSize);
+
+    /// <summary> Store a vector into consecutive elements of an array. The first element needn't be aligned to the size of the vector. </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the array elements </typeparam>
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="pArray"> Pointer to the array </param>
+    /// <param name="offset"> The index of the first element to store to </param>
+    /// <param name="vectorValue"> The vector to store </param>
+    template <typename ValueType>
+    void StoreVector(IRFunctionEmitter& function, LLVMValue pArray, LLVMValue offset, LLVMValue vectorValue);
+
     /// <summary> Compute the sum of the entries in a vector </summary>
     ///
     /// Emits explicit vector code to compute the sum. Hopefully, the vecorizing optimizer will
@@ -52,6 +85,15 @@ namespace emitters
     /// <returns> The sum of the elements in the given vector </returns>
     template <typename ValueType>
     LLVMValue HorizontalVectorSum(IRFunctionEmitter& function, LLVMValue vectorValue);
+
+    /// <summary> Compute the maximum of the entries in a floating-point vector </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="vectorValue"> The value to find the largest element of </param>
+    ///
+    /// <returns> The largest element in the given vector </returns>
+    template <typename ValueType>
+    LLVMValue HorizontalVectorMax(IRFunctionEmitter& function, LLVMValue vectorValue);
 } // namespace emitters
 } // namespace ell
 
@@ -73,6 +115,32 @@ namespace emitters
         return llvm::ConstantInt::get(type, elementValue, true);
     }
 
+    template <typename ValueType>
+    LLVMValue BroadcastToVector(IRFunctionEmitter& function, int vectorSize, LLVMValue elementValue)
+    {
+        return function.GetEmitter().GetIRBuilder().CreateVectorSplat(vectorSize, elementValue);
+    }
+
+    template <typename ValueType>
+    LLVMValue LoadVector(IRFunctionEmitter& function, LLVMValue pArray, LLVMValue offset, int vectorSize)
+    {
+        auto& emitter = function.GetEmitter();
+        auto vectorType = emitter.VectorType(GetVariableType<ValueType>(), vectorSize);
+        auto pVector = function.CastPointer(function.PointerOffset(pArray, offset), vectorType->getPointerTo());
+        auto load = emitter.Load(pVector);
+        load->setAlignment(alignof(ValueType));
+        return load;
+    }
+
+    template <typename ValueType>
+    void StoreVector(IRFunctionEmitter& function, LLVMValue pArray, LLVMValue offset, LLVMValue vectorValue)
+    {
+        auto& emitter = function.GetEmitter();
+        auto pVector = function.CastPointer(function.PointerOffset(pArray, offset), vectorValue->getType()->getPointerTo());
+        auto store = emitter.Store(pVector, vectorValue);
+        store->setAlignment(alignof(ValueType));
+    }
+
     // Emit explicit vectorized code to compute the sum of all the elements in a vector.
     // Hopefully, the vecorizing optimizer will take care of this when vecorizing simple
     // loops to sum up values, but for other operations we may want to do it ourselves.
@@ -137,6 +205,45 @@ namespace emitters
         auto half2 = emitter.GetIRBuilder().CreateExtractElement(vectorValue, static_cast<uint64_t>(1));
         return function.Operator(emitters::GetAddForValueType<ValueType>(), half1, half2);
     }
+
+    // Same as HorizontalVectorSum, but taking the larger of the two halves at each step
+    template <typename ValueType>
+    LLVMValue HorizontalVectorMax(IRFunctionEmitter& function, LLVMValue vectorValue)
+    {
+        LLVMType type = vectorValue->getType();
+        if (!type->isVectorTy())
+        {
+            return vectorValue;
+        }
+
+        auto max = [&function](LLVMValue a, LLVMValue b) {
+            return function.Select(function.Comparison(TypedComparison::greaterThanFloat, a, b), a, b);
+        };
+
+        int vectorSize = llvm::cast<llvm::VectorType>(type)->getNumElements();
+        IREmitter& emitter = function.GetEmitter();
+        while (vectorSize > 1)
+        {
+            if (vectorSize % 2 != 0)
+            {
+                throw EmitterException(EmitterError::valueTypeNotSupported); // vectorSize must be a power of 2
+            }
+
+            auto undef = llvm::UndefValue::get(vectorValue->getType());
+            std::vector<uint32_t> elementIndices1;
+            std::vector<uint32_t> elementIndices2;
+            for (int index = 0; index < vectorSize / 2; ++index)
+            {
+                elementIndices1.push_back(index);
+                elementIndices2.push_back((vectorSize / 2) + index);
+            }
+            auto half1 = emitter.GetIRBuilder().CreateShuffleVector(vectorValue, undef, elementIndices1);
+            auto half2 = emitter.GetIRBuilder().CreateShuffleVector(vectorValue, undef, elementIndices2);
+            vectorValue = max(half1, half2);
+            vectorSize /= 2;
+        }
+        return emitter.GetIRBuilder().CreateExtractElement(vectorValue, static_cast<uint64_t>(0));
+    }
 } // namespace emitters
 } // namespace ell
 
@@ -11,6 +11,7 @@
 
 namespace llvm
 {
+class Constant;
 class Function;
 class FunctionType;
 class GlobalVariable;
@@ -67,5 +68,14 @@ namespace emitters
     ///
     /// <returns> The TypedComparison for comparing values of the given type. </returns>
     emitters::TypedComparison GetComparison(LLVMType type, BinaryPredicateType operation);
+
+    /// <summary>
+    /// Replaces the constant expressions (like a `getelementptr` of a global with constant indices) that use a constant
+    /// with equivalent instructions, so every use of the constant is an operand of an instruction in a function.
+    /// Throws an exception if a global initializer uses the constant.
+    /// </summary>
+    ///
+    /// <param name="constant"> The constant (typically a global variable). </param>
+    void ExpandConstantExpressionUses(llvm::Constant& constant);
 } // namespace emitters
 } // namespace ell
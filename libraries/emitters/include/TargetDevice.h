@@ -24,6 +24,9 @@ namespace emitters
         std::string cpu = "";
         std::string features = "";
         size_t numBits = 0;
+        size_t l1CacheSize = 0; // size of the L1 data cache of a core, in bytes (0 = unknown or no cache)
+        size_t l2CacheSize = 0; // size of the L2 cache, in bytes (0 = unknown or no cache)
+        size_t cacheLineSize = 0; // in bytes (0 = unknown)
 
         /// <summary> Indicates if the target device is a Windows system </summary>
         bool IsWindows() const;
@@ -33,11 +36,20 @@ namespace emitters
 
         /// <summary> Indicates if the target device is a macOS system </summary>
         bool IsMacOS() const;
+
+        /// <summary>
+        /// Indicates if the target device is an Arm processor with the DSP extension, whose SIMD32 instructions (like
+        /// the dual 16-bit multiply-accumulate, SMLAD) nodes can use for their integer kernels, as on the Cortex-M4 and M7
+        /// </summary>
+        bool HasDSPExtension() const;
     };
 
     /// <summary> Create a TargetDevice from a device name. </summary>
     TargetDevice GetTargetDevice(std::string deviceName);
 
+    /// <summary> Indicates if a name is one of the device names `GetTargetDevice` accepts, including "host" and "custom". </summary>
+    bool IsKnownTargetDeviceName(const std::string& deviceName);
+
     /// <summary> Create a fully-specified TargetDevice from a partially-specified one. </summary>
     /// Typically, this function is used after manually filling in a subset of the fields of a
     /// `TargetDevice` struct, in order to fill in reasonable values for the remaining fields.
@@ -75,6 +75,25 @@ namespace emitters
     private:
         std::vector<ElementType> _data;
     };
+
+    /// <summary> A vector variable that is a view of a contiguous range of another vector variable </summary>
+    template <typename T>
+    class VectorViewVariable : public VectorVariable<T>
+    {
+    public:
+        /// <summary> Create a view of `size` elements of the source vector, starting at `offset` </summary>
+        VectorViewVariable(Variable& src, int offset, size_t size);
+
+        /// <summary> The source vector this is a view of </summary>
+        Variable& Src() const { return _src; }
+
+        /// <summary> Offset of the view into the source vector </summary>
+        int Offset() const { return _offset; }
+
+    private:
+        Variable& _src;
+        int _offset;
+    };
 } // namespace emitters
 } // namespace ell
 
@@ -124,6 +143,17 @@ namespace emitters
     {
         _data = VariableValueType<T>::ToVariableVector(data);
     }
+
+    //
+    // VectorViewVariable
+    //
+    template <typename T>
+    VectorViewVariable<T>::VectorViewVariable(Variable& src, int offset, size_t size) :
+        VectorVariable<T>(VariableScope::local, size, Variable::VariableFlags::isMutable | Variable::VariableFlags::isVectorRef),
+        _src(src),
+        _offset(offset)
+    {
+    }
 } // namespace emitters
 } // namespace ell
 
@@ -37,6 +37,53 @@ namespace emitters
         }
     }
 
+    std::string ToString(JitCompilationMode mode)
+    {
+        switch (mode)
+        {
+        case JitCompilationMode::wholeModule:
+            return "wholeModule";
+        case JitCompilationMode::lazy:
+            return "lazy";
+        case JitCompilationMode::background:
+            return "background";
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument);
+        }
+    }
+
+    std::string ToString(ThreadAffinity affinity)
+    {
+        switch (affinity)
+        {
+        case ThreadAffinity::none:
+            return "none";
+        case ThreadAffinity::compact:
+            return "compact";
+        case ThreadAffinity::scatter:
+            return "scatter";
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument);
+        }
+    }
+
+    std::string ToString(ParallelLoopSchedule schedule)
+    {
+        switch (schedule)
+        {
+        case ParallelLoopSchedule::automatic:
+            return "automatic";
+        case ParallelLoopSchedule::staticBlocks:
+            return "static";
+        case ParallelLoopSchedule::dynamic:
+            return "dynamic";
+        case ParallelLoopSchedule::guided:
+            return "guided";
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument);
+        }
+    }
+
     /// <summary> Constructor from a property bag </summary>
     CompilerOptions::CompilerOptions(const utilities::PropertyBag& properties)
     {
@@ -64,13 +111,41 @@ namespace emitters
         inlineOperators = properties.GetOrParseEntry<bool>("inlineOperators", inlineOperators);
         allowVectorInstructions = properties.GetOrParseEntry<bool>("allowVectorInstructions", allowVectorInstructions);
         vectorWidth = properties.GetOrParseEntry<int>("vectorWidth", vectorWidth);
+        functionVariants = properties.GetOrParseEntry<std::string>("functionVariants", functionVariants);
         useBlas = properties.GetOrParseEntry<bool>("useBlas", useBlas);
+        parallelLoopSchedule = properties.GetOrParseEntry<ParallelLoopSchedule>("parallelLoopSchedule", parallelLoopSchedule);
+        parallelLoopChunkSize = properties.GetOrParseEntry<int>("parallelLoopChunkSize", parallelLoopChunkSize);
+        smallMatrixThreshold = properties.GetOrParseEntry<int>("smallMatrixThreshold", smallMatrixThreshold);
+        prefetchDistance = properties.GetOrParseEntry<int>("prefetchDistance", prefetchDistance);
+        nonTemporalStoreThreshold = properties.GetOrParseEntry<int>("nonTemporalStoreThreshold", nonTemporalStoreThreshold);
         profile = properties.GetOrParseEntry<bool>("profile", profile);
+        profileHardwareCounters = properties.GetOrParseEntry<bool>("profileHardwareCounters", profileHardwareCounters);
+        reentrant = properties.GetOrParseEntry<bool>("reentrant", reentrant);
+        externalWeights = properties.GetOrParseEntry<bool>("externalWeights", externalWeights);
+        staticMemory = properties.GetOrParseEntry<bool>("staticMemory", staticMemory);
+        deduplicateConstants = properties.GetOrParseEntry<bool>("deduplicateConstants", deduplicateConstants);
+        shareConstantsAcrossModules = properties.GetOrParseEntry<bool>("shareConstantsAcrossModules", shareConstantsAcrossModules);
+        weightsSection = properties.GetOrParseEntry<std::string>("weightsSection", weightsSection);
+        weightsAlignment = properties.GetOrParseEntry<int>("weightsAlignment", weightsAlignment);
+        weightsPlacementThreshold = properties.GetOrParseEntry<int>("weightsPlacementThreshold", weightsPlacementThreshold);
+        hugePageWeights = properties.GetOrParseEntry<bool>("hugePageWeights", hugePageWeights);
         includeDiagnosticInfo = properties.GetOrParseEntry<bool>("includeDiagnosticInfo", includeDiagnosticInfo);
         parallelize = properties.GetOrParseEntry<bool>("parallelize", parallelize);
         useThreadPool = properties.GetOrParseEntry<bool>("useThreadPool", useThreadPool);
+        useWorkStealing = properties.GetOrParseEntry<bool>("useWorkStealing", useWorkStealing);
         maxThreads = properties.GetOrParseEntry<int>("maxThreads", maxThreads);
+        threadPoolSpinCount = properties.GetOrParseEntry<int>("threadPoolSpinCount", threadPoolSpinCount);
+        threadAffinity = properties.GetOrParseEntry<ThreadAffinity>("threadAffinity", threadAffinity);
+        affinityCores = properties.GetOrParseEntry<std::string>("affinityCores", affinityCores);
+        affinitySockets = properties.GetOrParseEntry<int>("affinitySockets", affinitySockets);
+        externalThreadPool = properties.GetOrParseEntry<bool>("externalThreadPool", externalThreadPool);
+        taskPriority = properties.GetOrParseEntry<int>("taskPriority", taskPriority);
         useFastMath = properties.GetOrParseEntry<bool>("useFastMath", useFastMath);
+        useApproximateMath = properties.GetOrParseEntry<bool>("useApproximateMath", useApproximateMath);
+        codeGenPartitions = properties.GetOrParseEntry<int>("codeGenPartitions", codeGenPartitions);
+        pgoInstrumentFile = properties.GetOrParseEntry<std::string>("pgoInstrumentFile", pgoInstrumentFile);
+        pgoProfileFile = properties.GetOrParseEntry<std::string>("pgoProfileFile", pgoProfileFile);
+        jitCompilationMode = properties.GetOrParseEntry<JitCompilationMode>("jitCompilationMode", jitCompilationMode);
         debug = properties.GetOrParseEntry<bool>("debug", debug);
 
         if (properties.HasEntry("deviceName"))
@@ -97,5 +172,51 @@ namespace utilities
         
         return it->second;
     }
+
+    template <>
+    emitters::JitCompilationMode FromString<emitters::JitCompilationMode>(const std::string& s)
+    {
+        static std::map<std::string, emitters::JitCompilationMode> nameMap = { { "wholeModule", emitters::JitCompilationMode::wholeModule },
+                                                                               { "lazy", emitters::JitCompilationMode::lazy },
+                                                                               { "background", emitters::JitCompilationMode::background } };
+        auto it = nameMap.find(s);
+        if (it == nameMap.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Unknown JitCompilationMode");
+        }
+
+        return it->second;
+    }
+
+    template <>
+    emitters::ThreadAffinity FromString<emitters::ThreadAffinity>(const std::string& s)
+    {
+        static std::map<std::string, emitters::ThreadAffinity> nameMap = { { "none", emitters::ThreadAffinity::none },
+                                                                           { "compact", emitters::ThreadAffinity::compact },
+                                                                           { "scatter", emitters::ThreadAffinity::scatter } };
+        auto it = nameMap.find(s);
+        if (it == nameMap.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Unknown ThreadAffinity");
+        }
+
+        return it->second;
+    }
+
+    template <>
+    emitters::ParallelLoopSchedule FromString<emitters::ParallelLoopSchedule>(const std::string& s)
+    {
+        static std::map<std::string, emitters::ParallelLoopSchedule> nameMap = { { "automatic", emitters::ParallelLoopSchedule::automatic },
+                                                                                 { "static", emitters::ParallelLoopSchedule::staticBlocks },
+                                                                                 { "dynamic", emitters::ParallelLoopSchedule::dynamic },
+                                                                                 { "guided", emitters::ParallelLoopSchedule::guided } };
+        auto it = nameMap.find(s);
+        if (it == nameMap.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Unknown ParallelLoopSchedule");
+        }
+
+        return it->second;
+    }
 } // namespace utilities
 } // namespace ell
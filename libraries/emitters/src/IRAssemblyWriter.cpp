@@ -23,6 +23,7 @@
 #include <llvm/Bitcode/BitcodeWriter.h>
 
 #include <llvm/CodeGen/MachineModuleInfo.h>
+#include <llvm/CodeGen/ParallelCG.h>
 #include <llvm/CodeGen/TargetPassConfig.h>
 
 #include <llvm/IR/Attributes.h>
@@ -44,6 +45,10 @@
 
 #include <llvm/Target/TargetMachine.h>
 
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <utilities/include/Files.h>
+
 #include <functional>
 #include <memory>
 #include <string>
@@ -79,6 +84,46 @@ namespace emitters
             options.MCOptions.PreserveAsmComments = true; // Note: not the default
             return options;
         }
+
+        // Sets the triple for the module, and returns the target for it
+        const llvm::Target* GetTarget(llvm::Module& module, const MachineCodeOutputOptions& ellOptions)
+        {
+            auto targetTripleStr = ellOptions.targetDevice.triple.empty() ? llvm::sys::getDefaultTargetTriple() : ellOptions.targetDevice.triple;
+            module.setTargetTriple(llvm::Triple::normalize(targetTripleStr));
+
+            // Get the target-specific parser.
+            std::string error;
+            const llvm::Target* target = llvm::TargetRegistry::lookupTarget(module.getTargetTriple(), error);
+            if (!target)
+            {
+                throw EmitterException(EmitterError::unexpected, std::string("Couldn't create target ") + error);
+            }
+            return target;
+        }
+
+        std::unique_ptr<llvm::TargetMachine> CreateTargetMachine(const llvm::Target& target, const std::string& triple, const MachineCodeOutputOptions& ellOptions)
+        {
+            llvm::TargetOptions targetOptions = MakeTargetOptions();
+            targetOptions.MCOptions.AsmVerbose = ellOptions.verboseOutput;
+            targetOptions.FloatABIType = ellOptions.floatABI;
+
+            OutputRelocationModel relocModel = ellOptions.relocModel;
+            llvm::CodeModel::Model codeModel = llvm::CodeModel::Small; // If this code gets run during JIT, we may have to change to medium/large
+
+            std::unique_ptr<llvm::TargetMachine> targetMachine(target.createTargetMachine(triple,
+                                                                                          ellOptions.targetDevice.cpu,
+                                                                                          ellOptions.targetDevice.features,
+                                                                                          targetOptions,
+                                                                                          relocModel,
+                                                                                          codeModel,
+                                                                                          ellOptions.optimizationLevel));
+
+            if (!targetMachine)
+            {
+                throw EmitterException(EmitterError::unexpected, "Unable to allocate target machine");
+            }
+            return targetMachine;
+        }
     } // namespace
 
     //
@@ -112,37 +157,8 @@ namespace emitters
             throw EmitterException(EmitterError::unexpected, "Module verification failed");
         }
 
-        // Set the triple for the module, and retrieve it as a Triple object
-        auto targetTripleStr = ellOptions.targetDevice.triple.empty() ? llvm::sys::getDefaultTargetTriple() : ellOptions.targetDevice.triple;
-        module.setTargetTriple(llvm::Triple::normalize(targetTripleStr));
-
-        // Get the target-specific parser.
-        std::string error;
-        const llvm::Target* target = llvm::TargetRegistry::lookupTarget(module.getTargetTriple(), error);
-        if (!target)
-        {
-            throw EmitterException(EmitterError::unexpected, std::string("Couldn't create target ") + error);
-        }
-
-        llvm::TargetOptions targetOptions = MakeTargetOptions();
-        targetOptions.MCOptions.AsmVerbose = ellOptions.verboseOutput;
-        targetOptions.FloatABIType = ellOptions.floatABI;
-
-        OutputRelocationModel relocModel = ellOptions.relocModel;
-        llvm::CodeModel::Model codeModel = llvm::CodeModel::Small; // If this code gets run during JIT, we may have to change to medium/large
-
-        std::unique_ptr<llvm::TargetMachine> targetMachine(target->createTargetMachine(module.getTargetTriple(),
-                                                                                       ellOptions.targetDevice.cpu,
-                                                                                       ellOptions.targetDevice.features,
-                                                                                       targetOptions,
-                                                                                       relocModel,
-                                                                                       codeModel,
-                                                                                       ellOptions.optimizationLevel));
-
-        if (!targetMachine)
-        {
-            throw EmitterException(EmitterError::unexpected, "Unable to allocate target machine");
-        }
+        const llvm::Target* target = GetTarget(module, ellOptions);
+        auto targetMachine = CreateTargetMachine(*target, module.getTargetTriple(), ellOptions);
 
         // Build up all of the passes that we want to apply to the module
         llvm::legacy::PassManager passManager;
@@ -216,5 +232,50 @@ namespace emitters
             throw EmitterException(EmitterError::unexpected, "Error compiling module");
         }
     }
+
+    void GenerateMachineCode(const std::vector<llvm::raw_pwrite_stream*>& partitionStreams, IRModuleEmitter& moduleEmitter, const MachineCodeOutputOptions& ellOptions)
+    {
+        llvm::Module& module = *(moduleEmitter.GetLLVMModule());
+
+        if (ellOptions.verifyModule && llvm::verifyModule(module))
+        {
+            throw EmitterException(EmitterError::unexpected, "Module verification failed");
+        }
+
+        const llvm::Target* target = GetTarget(module, ellOptions);
+        std::string triple = module.getTargetTriple();
+        module.setDataLayout(CreateTargetMachine(*target, triple, ellOptions)->createDataLayout());
+        if (!ellOptions.targetDevice.cpu.empty() || !ellOptions.targetDevice.features.empty())
+        {
+            SetFunctionAttributes(ellOptions.targetDevice.cpu, ellOptions.targetDevice.features, module);
+        }
+
+        // splitCodeGen splits the module into one partition per stream (making the functions and globals that are
+        // referenced across partitions external), and runs codegen on each partition on a separate thread. It
+        // consumes the module it's given, so give it a copy.
+        auto moduleCopy = std::unique_ptr<llvm::Module>(llvm::CloneModule(&module));
+        llvm::splitCodeGen(std::move(moduleCopy),
+                           partitionStreams,
+                           {},
+                           [target, triple, ellOptions]() { return CreateTargetMachine(*target, triple, ellOptions); },
+                           MachineCodeType::CGFT_ObjectFile);
+
+        if (moduleEmitter.GetDiagnosticHandler().HadError())
+        {
+            throw EmitterException(EmitterError::unexpected, "Error compiling module");
+        }
+    }
+
+    std::string GetPartitionFilePath(const std::string& filePath, int partition)
+    {
+        if (partition == 0)
+        {
+            return filePath;
+        }
+
+        auto extension = utilities::GetFileExtension(filePath);
+        auto path = utilities::RemoveFileExtension(filePath) + "_" + std::to_string(partition);
+        return extension.empty() ? path : path + "." + extension;
+    }
 } // namespace emitters
 } // namespace ell
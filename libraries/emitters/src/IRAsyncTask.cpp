@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "IRAsyncTask.h"
+#include "EmitterException.h"
 #include "IRFunctionEmitter.h"
 #include "IRThreadUtilities.h"
 
@@ -18,15 +19,8 @@ namespace ell
 namespace emitters
 {
     IRAsyncTask::IRAsyncTask(IRFunctionEmitter& owningFunction, LLVMFunction taskFunction, const std::vector<LLVMValue>& arguments) :
-        _taskFunction(taskFunction),
-        _arguments(arguments)
+        IRAsyncTask(owningFunction, taskFunction, arguments, "")
     {
-        const auto& compilerParameters = owningFunction.GetModule().GetCompilerOptions();
-        _usePthreads = compilerParameters.parallelize && !compilerParameters.targetDevice.IsWindows();
-        if (UsePthreads())
-        {
-            Run(owningFunction);
-        }
     }
 
     IRAsyncTask::IRAsyncTask(IRFunctionEmitter& owningFunction, IRFunctionEmitter& taskFunction, const std::vector<LLVMValue>& arguments) :
@@ -34,6 +28,28 @@ namespace emitters
     {
     }
 
+    IRAsyncTask::IRAsyncTask(IRFunctionEmitter& owningFunction, LLVMFunction taskFunction, const std::vector<LLVMValue>& arguments, const std::string& storageName) :
+        _taskFunction(taskFunction),
+        _arguments(arguments),
+        _storageName(storageName)
+    {
+        if (UsesGlobalStorage() && !taskFunction->getReturnType()->isVoidTy())
+        {
+            throw EmitterException(EmitterError::badFunctionDefinition, "Tasks that keep their state in globals can't return a value");
+        }
+
+        const auto& compilerParameters = owningFunction.GetModule().GetCompilerOptions();
+        _useExternalThreadPool = compilerParameters.parallelize && compilerParameters.externalThreadPool;
+        _usePthreads = compilerParameters.parallelize && !_useExternalThreadPool && !compilerParameters.targetDevice.IsWindows();
+
+        // Without threads, a task that can be waited for by another function runs right away, since its arguments
+        // aren't available there
+        if (UsePthreads() || UseExternalThreadPool() || UsesGlobalStorage())
+        {
+            Run(owningFunction);
+        }
+    }
+
     void IRAsyncTask::Run(IRFunctionEmitter& function)
     {
         auto& module = function.GetModule();
@@ -44,15 +60,27 @@ namespace emitters
         _returnType = _taskFunction->getReturnType();
 
         // call function
-        if (UsePthreads())
+        if (UseExternalThreadPool())
+        {
+            // The argument struct is on the caller's stack unless the task keeps its state in globals, which is fine
+            // because the task is waited for before the caller returns
+            auto taskArgType = GetTaskArgStructType(module, _taskFunction);
+            auto taskArg = TaskStateVariable(function, taskArgType, "taskArg");
+            function.FillStruct(taskArg, _arguments);
+            auto wrapperFunction = GetTaskWrapperFunction(module, _taskFunction);
+            _externalTask = TaskStateVariable(function, int8PtrType, "task");
+            auto priority = function.Literal<int>(module.GetCompilerOptions().taskPriority);
+            function.Store(_externalTask, function.Call(GetSubmitTaskFunction(module), { wrapperFunction, function.CastPointer(taskArg, int8PtrType), priority }));
+        }
+        else if (UsePthreads())
         {
             auto pthreadType = module.GetRuntime().GetPosixEmitter().GetPthreadType();
             auto taskArgType = GetTaskArgStructType(module, _taskFunction);
             llvm::ConstantPointerNull* nullAttr = function.NullPointer(int8PtrType);
 
             // Create stack variables for thread and argument struct
-            _pthread = function.Variable(pthreadType, "thread");
-            auto taskArg = function.Variable(taskArgType, "taskArg");
+            _pthread = TaskStateVariable(function, pthreadType, "thread");
+            auto taskArg = TaskStateVariable(function, taskArgType, "taskArg");
             function.FillStruct(taskArg, _arguments);
             auto pthreadWrapperFunction = GetTaskWrapperFunction(module, _taskFunction);
             auto errCode = function.PthreadCreate(_pthread, nullAttr, pthreadWrapperFunction, function.CastPointer(taskArg, int8PtrType));
@@ -66,7 +94,11 @@ namespace emitters
 
     void IRAsyncTask::Wait(IRFunctionEmitter& functionEmitter)
     {
-        if (UsePthreads())
+        if (UseExternalThreadPool())
+        {
+            _returnValue = functionEmitter.Call(GetWaitForTaskFunction(functionEmitter.GetModule()), { functionEmitter.Load(_externalTask) });
+        }
+        else if (UsePthreads())
         {
             auto& context = functionEmitter.GetLLVMContext();
             auto int8PtrType = llvm::Type::getInt8PtrTy(context);
@@ -75,7 +107,7 @@ namespace emitters
             UNUSED(errCode);
             _returnValue = functionEmitter.Load(returnValuePtr);
         }
-        else
+        else if (!UsesGlobalStorage())
         {
             Run(functionEmitter);
         }
@@ -93,6 +125,15 @@ namespace emitters
         }
     }
 
+    LLVMValue IRAsyncTask::TaskStateVariable(IRFunctionEmitter& function, LLVMType type, const std::string& name)
+    {
+        if (UsesGlobalStorage())
+        {
+            return function.GetModule().Global(type, _storageName + "_" + name);
+        }
+        return function.Variable(type, name);
+    }
+
     LLVMValue IRAsyncTask::IsNull(IRFunctionEmitter& functionEmitter)
     {
         return functionEmitter.FalseBit();
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRConstantDeduplication.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRConstantDeduplication.h"
+#include "IRExternalWeights.h"
+#include "IRModuleEmitter.h"
+
+#include <utilities/include/Logger.h>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Comdat.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/Support/SHA1.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        bool IsMergeableConstant(const llvm::GlobalVariable& global)
+        {
+            return global.isConstant() && global.hasInitializer() && global.hasLocalLinkage() && !global.isThreadLocal() && !global.hasSection();
+        }
+
+        // Renames a constant array after its contents, so the linker merges it with the identical arrays of other modules
+        void ShareWithOtherModules(llvm::Module& module, llvm::GlobalVariable& global)
+        {
+            auto data = llvm::dyn_cast<llvm::ConstantDataSequential>(global.getInitializer());
+            if (data == nullptr)
+            {
+                return;
+            }
+
+            llvm::SHA1 hasher;
+            hasher.update(data->getRawDataValues());
+            auto name = "ELL_SharedConstant_" + llvm::toHex(hasher.final());
+            global.setName(name);
+            global.setLinkage(llvm::GlobalValue::LinkOnceODRLinkage);
+            global.setVisibility(llvm::GlobalValue::HiddenVisibility);
+            if (llvm::Triple(module.getTargetTriple()).supportsCOMDAT())
+            {
+                global.setComdat(module.getOrInsertComdat(global.getName()));
+            }
+        }
+    } // namespace
+
+    uint64_t DeduplicateConstants(IRModuleEmitter& module, bool shareAcrossModules)
+    {
+        auto& llvmModule = *module.GetLLVMModule();
+        const auto& dataLayout = module.GetTargetDataLayout();
+
+        // Identical data means an identical initializer, since LLVM keeps a single copy of each constant. Weights are only
+        // merged with other weights, so the ones `EmitExternalWeights` moves out of the module stay the same.
+        std::map<std::pair<llvm::Constant*, bool>, llvm::GlobalVariable*> uniqueGlobals;
+        std::vector<llvm::GlobalVariable*> duplicates;
+        uint64_t removedSize = 0;
+        for (auto& global : llvmModule.globals())
+        {
+            if (!IsMergeableConstant(global))
+            {
+                continue;
+            }
+
+            global.setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+            auto key = std::make_pair(global.getInitializer(), IsWeightsGlobal(global));
+            auto it = uniqueGlobals.find(key);
+            if (it == uniqueGlobals.end() || it->second->getType() != global.getType())
+            {
+                uniqueGlobals.emplace(key, &global);
+                continue;
+            }
+
+            auto original = it->second;
+            original->setAlignment(std::max(original->getAlignment(), global.getAlignment()));
+            global.replaceAllUsesWith(original);
+            duplicates.push_back(&global);
+            removedSize += dataLayout.getTypeAllocSize(global.getValueType());
+        }
+
+        for (auto global : duplicates)
+        {
+            global->eraseFromParent();
+        }
+
+        if (shareAcrossModules)
+        {
+            for (auto& entry : uniqueGlobals)
+            {
+                ShareWithOtherModules(llvmModule, *entry.second);
+            }
+        }
+
+        Log() << "Merged " << duplicates.size() << " duplicate constants, removing " << removedSize << " bytes" << EOL;
+        return removedSize;
+    }
+} // namespace emitters
+} // namespace ell
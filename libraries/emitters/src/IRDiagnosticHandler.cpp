@@ -10,6 +10,7 @@
 
 #include <llvm/IR/DiagnosticInfo.h>
 #include <llvm/IR/DiagnosticPrinter.h>
+#include <llvm/IR/Function.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/Support/raw_os_ostream.h>
 
@@ -20,10 +21,38 @@ namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        bool IsCollectedRemarkPass(llvm::StringRef passName)
+        {
+            return passName == "loop-vectorize" || passName == "slp-vectorizer" || passName == "loop-unroll" || passName == "inline";
+        }
+
+        // LLVM asks the context's handler which passes should create remarks, and by default only enables the ones
+        // named by the -pass-remarks command line options
+        class RemarkFilteringDiagnosticHandler : public llvm::DiagnosticHandler
+        {
+        public:
+            RemarkFilteringDiagnosticHandler(IRDiagnosticHandler* handler) :
+                llvm::DiagnosticHandler(handler),
+                _handler(handler)
+            {
+            }
+
+            bool isAnalysisRemarkEnabled(llvm::StringRef passName) const override { return _handler->CollectsOptimizationRemarks() && IsCollectedRemarkPass(passName); }
+            bool isMissedOptRemarkEnabled(llvm::StringRef passName) const override { return _handler->CollectsOptimizationRemarks() && IsCollectedRemarkPass(passName); }
+            bool isPassedOptRemarkEnabled(llvm::StringRef passName) const override { return _handler->CollectsOptimizationRemarks() && IsCollectedRemarkPass(passName); }
+            bool isAnyRemarkEnabled() const override { return _handler->CollectsOptimizationRemarks(); }
+
+        private:
+            IRDiagnosticHandler* _handler;
+        };
+    } // namespace
+
     IRDiagnosticHandler::IRDiagnosticHandler(llvm::LLVMContext& context, bool verbose) :
         _verbose(verbose)
     {
-        auto diagnosticHandler = std::make_unique<llvm::DiagnosticHandler>(this);
+        auto diagnosticHandler = std::make_unique<RemarkFilteringDiagnosticHandler>(this);
         diagnosticHandler->DiagHandlerCallback = &HandleMessage;
         context.setDiagnosticHandler(std::move(diagnosticHandler));
     }
@@ -46,6 +75,14 @@ namespace emitters
 
     void IRDiagnosticHandler::HandleMessageImpl(const llvm::DiagnosticInfo& info)
     {
+        auto remark = llvm::dyn_cast<llvm::DiagnosticInfoOptimizationBase>(&info);
+        if (remark != nullptr && _collectOptimizationRemarks && IsCollectedRemarkPass(remark->getPassName()))
+        {
+            auto kind = remark->isPassed() ? IROptimizationRemark::Kind::passed : (remark->isMissed() ? IROptimizationRemark::Kind::missed : IROptimizationRemark::Kind::analysis);
+            _optimizationRemarks.push_back({ kind, remark->getPassName().str(), remark->getRemarkName().str(), remark->getFunction().getName().str(), remark->getMsg() });
+            return;
+        }
+
         auto severity = info.getSeverity();
         switch (severity)
         {
@@ -994,6 +994,43 @@ namespace emitters
         return _irBuilder.CreateStore(pValue, pPointer);
     }
 
+    llvm::LoadInst* IREmitter::AtomicLoad(LLVMValue pPointer)
+    {
+        assert(pPointer != nullptr);
+        auto result = _irBuilder.CreateLoad(pPointer);
+        const auto& dataLayout = _moduleEmitter.GetTargetDataLayout();
+        result->setAlignment(dataLayout.getABITypeAlignment(result->getType()));
+        result->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+        return result;
+    }
+
+    llvm::StoreInst* IREmitter::AtomicStore(LLVMValue pPointer, LLVMValue pValue)
+    {
+        assert(pPointer != nullptr);
+        assert(pValue != nullptr);
+        auto result = _irBuilder.CreateStore(pValue, pPointer);
+        const auto& dataLayout = _moduleEmitter.GetTargetDataLayout();
+        result->setAlignment(dataLayout.getABITypeAlignment(pValue->getType()));
+        result->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+        return result;
+    }
+
+    LLVMValue IREmitter::AtomicAdd(LLVMValue pPointer, LLVMValue pValue)
+    {
+        assert(pPointer != nullptr);
+        assert(pValue != nullptr);
+        return _irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, pPointer, pValue, llvm::AtomicOrdering::SequentiallyConsistent);
+    }
+
+    LLVMValue IREmitter::AtomicCompareExchange(LLVMValue pPointer, LLVMValue pExpectedValue, LLVMValue pNewValue)
+    {
+        assert(pPointer != nullptr);
+        assert(pExpectedValue != nullptr);
+        assert(pNewValue != nullptr);
+        auto result = _irBuilder.CreateAtomicCmpXchg(pPointer, pExpectedValue, pNewValue, llvm::AtomicOrdering::SequentiallyConsistent, llvm::AtomicOrdering::SequentiallyConsistent);
+        return _irBuilder.CreateExtractValue(result, { 1 });
+    }
+
     llvm::AllocaInst* IREmitter::StackAllocate(VariableType type)
     {
         return _irBuilder.CreateAlloca(Type(type), nullptr);
@@ -10,7 +10,9 @@
 #include "IRModuleEmitter.h"
 
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -24,18 +26,27 @@ namespace emitters
         throw emitters::EmitterException(emitters::EmitterError::unexpected, msg);
     }
 
-    IRExecutionEngine::IRExecutionEngine(IRModuleEmitter&& module, bool verify) :
-        IRExecutionEngine(module.TransferOwnership(), verify)
+    IRExecutionEngine::IRExecutionEngine(IRModuleEmitter&& module, bool verify, JitCompilationMode mode) :
+        IRExecutionEngine(module.TransferOwnership(), verify, mode)
     {
     }
 
-    IRExecutionEngine::IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify)
+    IRExecutionEngine::IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify, JitCompilationMode mode) :
+        _mode(mode),
+        _verify(verify)
     {
         llvm::InitializeNativeTarget();
         llvm::InitializeNativeTargetAsmPrinter();
 
-        _pBuilder = std::make_unique<llvm::EngineBuilder>(std::move(pModule));
-        _pBuilder->setEngineKind(llvm::EngineKind::JIT).setVerifyModules(verify).setUseOrcMCJITReplacement(false);
+        if (_mode == JitCompilationMode::lazy)
+        {
+            // The module is split when the engine is created, so functions can still be defined by their objects until then
+            _pLazyModule = std::move(pModule);
+        }
+        else
+        {
+            CreateBuilder(std::move(pModule));
+        }
 
         static bool installed = false;
         if (!installed)
@@ -48,6 +59,11 @@ namespace emitters
 
     IRExecutionEngine::~IRExecutionEngine()
     {
+        if (_backgroundCompilation.joinable())
+        {
+            _backgroundCompilation.join();
+        }
+
         if (_pEngine)
         {
             PerformFinalization();
@@ -57,10 +73,43 @@ namespace emitters
     void IRExecutionEngine::AddModule(std::unique_ptr<llvm::Module> pModule)
     {
         assert(pModule != nullptr);
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
         EnsureEngine();
         _pEngine->addModule(std::move(pModule));
     }
 
+    void IRExecutionEngine::SetObjectCache(std::unique_ptr<llvm::ObjectCache> cache)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _pObjectCache = std::move(cache);
+        if (_pEngine)
+        {
+            _pEngine->setObjectCache(_pObjectCache.get());
+        }
+    }
+
+    void IRExecutionEngine::CompileInBackground()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        if (_backgroundCompilation.joinable())
+        {
+            return;
+        }
+
+        _backgroundCompilation = std::thread([this] {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            try
+            {
+                EnsureEngine();
+                _pEngine->finalizeObject();
+            }
+            catch (...)
+            {
+                _backgroundCompilationError = std::current_exception();
+            }
+        });
+    }
+
     void IRExecutionEngine::PerformInitialization()
     {
         _pEngine->runStaticConstructorsDestructors(false);
@@ -73,12 +122,14 @@ namespace emitters
 
     uint64_t IRExecutionEngine::GetFunctionAddress(const std::string& name)
     {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
         EnsureEngine();
         return _pEngine->getFunctionAddress(name);
     }
 
     uint64_t IRExecutionEngine::GetGlobalValueAddress(const std::string& name)
     {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
         EnsureEngine();
         return _pEngine->getGlobalValueAddress(name);
     }
@@ -95,6 +146,13 @@ namespace emitters
 
     void IRExecutionEngine::DefineFunction(LLVMFunction func, uintptr_t address)
     {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        if (_mode == JitCompilationMode::lazy && !_pEngine)
+        {
+            _pendingFunctionDefinitions.emplace_back(func->getName().str(), static_cast<uint64_t>(address));
+            return;
+        }
+
         EnsureEngine();
         _pEngine->addGlobalMapping(func, (void*)address);
     }
@@ -121,12 +179,62 @@ namespace emitters
         mainFunction();
     }
 
+    void IRExecutionEngine::CreateBuilder(std::unique_ptr<llvm::Module> pModule)
+    {
+        _pBuilder = std::make_unique<llvm::EngineBuilder>(std::move(pModule));
+        _pBuilder->setEngineKind(llvm::EngineKind::JIT).setVerifyModules(_verify).setUseOrcMCJITReplacement(false);
+    }
+
+    void IRExecutionEngine::AddLazyModules(std::unique_ptr<llvm::Module> pModule)
+    {
+        // MCJIT generates the code for a module when one of its symbols is first looked up, so with one function per
+        // module, only the functions that get called (and the functions they call) are ever compiled
+        auto numFunctions = std::count_if(pModule->begin(), pModule->end(), [](const llvm::Function& function) { return !function.isDeclaration(); });
+        auto numPartitions = static_cast<unsigned>(std::max<decltype(numFunctions)>(numFunctions, 1));
+        auto moduleName = pModule->getModuleIdentifier();
+        unsigned partitionIndex = 0;
+        llvm::SplitModule(std::move(pModule), numPartitions, [&](std::unique_ptr<llvm::Module> pPartition) {
+            // Keep the partition names distinct, so the object cache holds an object for each of them
+            pPartition->setModuleIdentifier(moduleName + "_" + std::to_string(partitionIndex++));
+            _pendingModules.push_back(std::move(pPartition));
+        });
+    }
+
     void IRExecutionEngine::EnsureEngine()
     {
+        if (_backgroundCompilationError)
+        {
+            std::rethrow_exception(_backgroundCompilationError);
+        }
+
         if (!_pEngine)
         {
+            if (_pLazyModule)
+            {
+                AddLazyModules(std::move(_pLazyModule));
+                CreateBuilder(std::move(_pendingModules.front()));
+                _pendingModules.erase(_pendingModules.begin());
+            }
+
             auto pEngine = _pBuilder->create();
             _pEngine.reset(pEngine);
+            if (_pObjectCache)
+            {
+                _pEngine->setObjectCache(_pObjectCache.get());
+            }
+
+            for (auto& pModule : _pendingModules)
+            {
+                _pEngine->addModule(std::move(pModule));
+            }
+            _pendingModules.clear();
+
+            for (const auto& definition : _pendingFunctionDefinitions)
+            {
+                _pEngine->addGlobalMapping(definition.first, definition.second);
+            }
+            _pendingFunctionDefinitions.clear();
+
             PerformInitialization();
         }
     }
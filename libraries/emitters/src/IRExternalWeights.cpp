@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRExternalWeights.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRExternalWeights.h"
+#include "EmitterException.h"
+#include "IRMetadata.h"
+#include "IRModuleEmitter.h"
+#include "IRReentrancy.h"
+#include "IRRuntime.h"
+#include "LLVMUtilities.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Hash.h>
+#include <utilities/include/Logger.h>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        constexpr uint32_t c_weightsFormatVersion = 1;
+        constexpr int c_madviseHugePage = 14; // MADV_HUGEPAGE on Linux
+
+        struct WeightsHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint64_t size; // the size of the whole blob, including the header
+            uint64_t layoutHash; // a hash of the offsets and sizes of the arrays, so blobs for other models of the same shape are accepted
+            char reserved[40];
+        };
+        static_assert(sizeof(WeightsHeader) == c_externalWeightsAlignment, "The weights header must keep the arrays aligned");
+
+        struct WeightsArray
+        {
+            llvm::GlobalVariable* global;
+            uint64_t offset; // offset of the array from the start of the blob
+        };
+
+        uint32_t GetWeightsMagic()
+        {
+            uint32_t magic;
+            std::memcpy(&magic, "ELLW", sizeof(magic));
+            return magic;
+        }
+
+        // Indicates if the bytes of a constant can be copied directly into the blob
+        bool HasRawData(const llvm::Constant& constant)
+        {
+            if (llvm::isa<llvm::ConstantAggregateZero>(constant) || llvm::isa<llvm::ConstantDataSequential>(constant))
+            {
+                return true;
+            }
+
+            if (auto array = llvm::dyn_cast<llvm::ConstantArray>(&constant))
+            {
+                for (const auto& element : array->operands())
+                {
+                    if (!HasRawData(*llvm::cast<llvm::Constant>(element.get())))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            return false;
+        }
+
+        // Copies the bytes of a constant to a (zero-filled) buffer
+        void CopyRawData(const llvm::DataLayout& dataLayout, const llvm::Constant& constant, char* buffer)
+        {
+            if (auto data = llvm::dyn_cast<llvm::ConstantDataSequential>(&constant))
+            {
+                auto rawData = data->getRawDataValues();
+                std::memcpy(buffer, rawData.data(), rawData.size());
+            }
+            else if (auto array = llvm::dyn_cast<llvm::ConstantArray>(&constant))
+            {
+                auto elementSize = dataLayout.getTypeAllocSize(array->getType()->getElementType());
+                for (unsigned index = 0; index < array->getNumOperands(); ++index)
+                {
+                    CopyRawData(dataLayout, *array->getOperand(index), buffer + index * elementSize);
+                }
+            }
+        }
+
+        std::vector<WeightsArray> CollectWeights(llvm::Module& module)
+        {
+            std::vector<WeightsArray> weights;
+            for (auto& global : module.globals())
+            {
+                if (IsWeightsGlobal(global) && global.isConstant() && global.hasInitializer() && !global.use_empty() && HasRawData(*global.getInitializer()))
+                {
+                    weights.push_back({ &global, 0 });
+                }
+            }
+            return weights;
+        }
+
+        // Replaces each use of the weights with a pointer into the blob, loading the blob pointer once per call of each function
+        void ReplaceWeightsWithBlobPointers(const std::vector<WeightsArray>& weights, llvm::GlobalVariable& weightsPointer)
+        {
+            std::map<llvm::Function*, llvm::Value*> blobPointers;
+            for (const auto& array : weights)
+            {
+                ExpandConstantExpressionUses(*array.global);
+                std::vector<llvm::User*> users(array.global->user_begin(), array.global->user_end());
+                for (auto user : users)
+                {
+                    auto instruction = llvm::cast<llvm::Instruction>(user);
+                    auto function = instruction->getFunction();
+                    auto& entryBlock = function->getEntryBlock();
+
+                    auto& blobPointer = blobPointers[function];
+                    if (blobPointer == nullptr)
+                    {
+                        llvm::IRBuilder<> irBuilder(&entryBlock, entryBlock.getFirstInsertionPt());
+                        blobPointer = irBuilder.CreateLoad(&weightsPointer, "weights");
+                    }
+
+                    llvm::IRBuilder<> irBuilder(llvm::cast<llvm::Instruction>(blobPointer)->getNextNode());
+                    auto arrayPointer = irBuilder.CreateConstInBoundsGEP1_64(blobPointer, array.offset);
+                    auto typedArrayPointer = irBuilder.CreatePointerCast(arrayPointer, array.global->getType(), array.global->getName());
+                    instruction->replaceUsesOfWith(array.global, typedArrayPointer);
+                }
+            }
+        }
+
+        void EmitWeightsFunctions(IRModuleEmitter& module, llvm::GlobalVariable& weightsPointer, const WeightsHeader& header, bool hugePages)
+        {
+            const auto prefix = module.GetModuleName();
+
+            auto& getSize = module.BeginFunction(prefix + "_GetWeightsSize", VariableType::Int64);
+            getSize.IncludeInHeader();
+            getSize.Return(getSize.Literal<int64_t>(header.size));
+            module.EndFunction();
+
+            auto& setWeights = module.BeginFunction(prefix + "_SetWeights", VariableType::Int32, NamedVariableTypeList{ { "weights", VariableType::BytePointer } });
+            setWeights.IncludeInHeader();
+            {
+                auto& irBuilder = setWeights.GetEmitter().GetIRBuilder();
+                auto weights = setWeights.GetFunctionArgument("weights");
+                auto result = setWeights.Variable(VariableType::Int32, "result");
+                setWeights.StoreZero(result);
+
+                // Check the pointer before reading the header through it
+                auto address = setWeights.CastPointerToInt(weights, VariableType::Int64);
+                auto isNotNull = irBuilder.CreateICmpNE(address, irBuilder.getInt64(0));
+                auto isAligned = irBuilder.CreateICmpEQ(irBuilder.CreateAnd(address, irBuilder.getInt64(c_externalWeightsAlignment - 1)), irBuilder.getInt64(0));
+                setWeights.If(irBuilder.CreateAnd(isNotNull, isAligned), [&](IRFunctionEmitter& function) {
+                    auto& irBuilder = function.GetEmitter().GetIRBuilder();
+                    auto readHeaderField = [&](size_t offset, llvm::Type* type) {
+                        auto fieldPointer = irBuilder.CreateConstInBoundsGEP1_64(weights, offset);
+                        return irBuilder.CreateLoad(irBuilder.CreatePointerCast(fieldPointer, type->getPointerTo()));
+                    };
+                    auto int32Type = irBuilder.getInt32Ty();
+                    auto int64Type = irBuilder.getInt64Ty();
+                    auto matches = irBuilder.CreateICmpEQ(readHeaderField(offsetof(WeightsHeader, magic), int32Type), irBuilder.getInt32(GetWeightsMagic()));
+                    matches = irBuilder.CreateAnd(matches, irBuilder.CreateICmpEQ(readHeaderField(offsetof(WeightsHeader, version), int32Type), irBuilder.getInt32(header.version)));
+                    matches = irBuilder.CreateAnd(matches, irBuilder.CreateICmpEQ(readHeaderField(offsetof(WeightsHeader, size), int64Type), irBuilder.getInt64(header.size)));
+                    matches = irBuilder.CreateAnd(matches, irBuilder.CreateICmpEQ(readHeaderField(offsetof(WeightsHeader, layoutHash), int64Type), irBuilder.getInt64(header.layoutHash)));
+                    function.If(matches, [&](IRFunctionEmitter& function) {
+                        function.Store(&weightsPointer, weights);
+                        if (hugePages)
+                        {
+                            auto madvise = module.GetRuntime().GetPosixEmitter().GetMadviseFunction();
+                            auto lengthType = madvise->getFunctionType()->getParamType(1);
+                            auto adviceType = madvise->getFunctionType()->getParamType(2);
+                            function.Call(madvise, { weights, llvm::ConstantInt::get(lengthType, header.size), llvm::ConstantInt::get(adviceType, c_madviseHugePage) });
+                        }
+                        function.Store(result, function.Literal<int>(1));
+                    });
+                });
+                setWeights.Return(setWeights.Load(result));
+            }
+            module.EndFunction();
+        }
+    } // namespace
+
+    void MarkGlobalAsWeights(llvm::GlobalVariable& global)
+    {
+        global.setMetadata(c_weightsGlobalTagName, llvm::MDNode::get(global.getContext(), {}));
+    }
+
+    bool IsWeightsGlobal(const llvm::GlobalVariable& global)
+    {
+        return global.getMetadata(c_weightsGlobalTagName) != nullptr;
+    }
+
+    std::vector<char> EmitExternalWeights(IRModuleEmitter& module, bool hugePages)
+    {
+        // The blob holds the bytes of the constants in the target's memory layout, which LLVM stores in the host's byte order
+        const auto& dataLayout = module.GetTargetDataLayout();
+        if (dataLayout.isBigEndian() != llvm::sys::IsBigEndianHost)
+        {
+            throw EmitterException(EmitterError::notSupported, "Can't externalize weights for a target with a different byte order than the host");
+        }
+
+        auto& llvmModule = *module.GetLLVMModule();
+        auto weights = CollectWeights(llvmModule);
+
+        WeightsHeader header = {};
+        std::memcpy(header.magic, "ELLW", sizeof(header.magic));
+        header.version = c_weightsFormatVersion;
+        header.size = sizeof(WeightsHeader);
+        size_t layoutHash = 0;
+        for (auto& array : weights)
+        {
+            array.offset = header.size;
+            uint64_t size = dataLayout.getTypeAllocSize(array.global->getValueType());
+            header.size = llvm::alignTo(header.size + size, c_externalWeightsAlignment);
+            utilities::HashCombine(layoutHash, array.offset);
+            utilities::HashCombine(layoutHash, size);
+        }
+        header.layoutHash = layoutHash;
+        Log() << "Externalizing " << weights.size() << " weight arrays (" << header.size << " bytes)" << EOL;
+
+        std::vector<char> blob(header.size);
+        std::memcpy(blob.data(), &header, sizeof(header));
+        for (const auto& array : weights)
+        {
+            CopyRawData(dataLayout, *array.global->getInitializer(), blob.data() + array.offset);
+        }
+
+        // The weights belong to the process rather than to a single instance of a reentrant module
+        auto int8PtrType = llvm::Type::getInt8PtrTy(module.GetLLVMContext());
+        auto weightsPointer = new llvm::GlobalVariable(llvmModule, int8PtrType, false, llvm::GlobalValue::InternalLinkage, llvm::ConstantPointerNull::get(int8PtrType), module.GetModuleName() + "_weights");
+        MarkGlobalShared(*weightsPointer);
+
+        ReplaceWeightsWithBlobPointers(weights, *weightsPointer);
+        for (const auto& array : weights)
+        {
+            assert(array.global->use_empty());
+            array.global->eraseFromParent();
+        }
+
+        EmitWeightsFunctions(module, *weightsPointer, header, hugePages && module.GetCompilerOptions().targetDevice.IsLinux());
+        return blob;
+    }
+
+    void PlaceWeights(IRModuleEmitter& module, const std::string& section, uint64_t alignment, uint64_t minSize)
+    {
+        if (!llvm::isPowerOf2_64(alignment) && alignment != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The alignment of the weights must be a power of 2");
+        }
+
+        const auto& dataLayout = module.GetTargetDataLayout();
+        uint64_t placedSize = 0;
+        int numPlaced = 0;
+        for (auto& global : module.GetLLVMModule()->globals())
+        {
+            if (!IsWeightsGlobal(global) || !global.isConstant() || dataLayout.getTypeAllocSize(global.getValueType()) < minSize)
+            {
+                continue;
+            }
+
+            if (!section.empty())
+            {
+                global.setSection(section);
+            }
+            if (alignment > global.getAlignment())
+            {
+                global.setAlignment(alignment);
+            }
+            placedSize += dataLayout.getTypeAllocSize(global.getValueType());
+            ++numPlaced;
+        }
+        Log() << "Placed " << numPlaced << " weight arrays (" << placedSize << " bytes) in section '" << section << "' with alignment " << alignment << EOL;
+    }
+} // namespace emitters
+} // namespace ell
@@ -0,0 +1,316 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRFunctionCache.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRFunctionCache.h"
+#include "EmitterException.h"
+#include "IRModuleEmitter.h"
+
+#include <utilities/include/Files.h>
+#include <utilities/include/Logger.h>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        std::mutex& GetMemoryCacheMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::unordered_map<std::string, std::string>& GetMemoryCache()
+        {
+            static std::unordered_map<std::string, std::string> cache;
+            return cache;
+        }
+
+        size_t GetNumNamedMetadataOperands(const llvm::Module& module)
+        {
+            size_t result = 0;
+            for (const auto& metadata : module.named_metadata())
+            {
+                result += metadata.getNumOperands();
+            }
+            return result;
+        }
+
+        // Adds the global values a constant refers to, looking through constant expressions and aggregates
+        void AddReferencedValues(const llvm::Constant* constant, std::vector<const llvm::GlobalValue*>& values)
+        {
+            if (auto value = llvm::dyn_cast<llvm::GlobalValue>(constant))
+            {
+                values.push_back(value);
+                return;
+            }
+
+            for (const auto& operand : constant->operands())
+            {
+                if (auto operandConstant = llvm::dyn_cast<llvm::Constant>(operand))
+                {
+                    AddReferencedValues(operandConstant, values);
+                }
+            }
+        }
+
+        std::vector<const llvm::GlobalValue*> GetReferencedValues(const llvm::GlobalValue& value)
+        {
+            std::vector<const llvm::GlobalValue*> result;
+            if (auto function = llvm::dyn_cast<llvm::Function>(&value))
+            {
+                for (const auto& instruction : llvm::instructions(*function))
+                {
+                    for (const auto& operand : instruction.operands())
+                    {
+                        if (auto constant = llvm::dyn_cast<llvm::Constant>(operand))
+                        {
+                            AddReferencedValues(constant, result);
+                        }
+                    }
+                }
+            }
+            else if (auto global = llvm::dyn_cast<llvm::GlobalVariable>(&value))
+            {
+                if (global->hasInitializer())
+                {
+                    AddReferencedValues(global->getInitializer(), result);
+                }
+            }
+            return result;
+        }
+    } // namespace
+
+    IRFunctionCache::IRFunctionCache(const std::string& directory) :
+        _directory(directory)
+    {
+        if (!_directory.empty())
+        {
+            utilities::EnsureDirectoryExists(_directory);
+        }
+    }
+
+    std::string IRFunctionCache::GetFilePath(const std::string& key) const
+    {
+        return utilities::JoinPaths(_directory, key + ".ll");
+    }
+
+    bool IRFunctionCache::TryLoad(IRModuleEmitter& module, const std::string& key)
+    {
+        std::string code;
+        {
+            std::lock_guard<std::mutex> lock(GetMemoryCacheMutex());
+            auto& cache = GetMemoryCache();
+            auto it = cache.find(key);
+            if (it != cache.end())
+            {
+                code = it->second;
+            }
+        }
+
+        if (code.empty() && !_directory.empty() && utilities::FileExists(GetFilePath(key)))
+        {
+            auto buffer = llvm::MemoryBuffer::getFile(GetFilePath(key));
+            if (buffer)
+            {
+                code = (*buffer)->getBuffer().str();
+                std::lock_guard<std::mutex> lock(GetMemoryCacheMutex());
+                GetMemoryCache()[key] = code;
+            }
+        }
+
+        if (code.empty())
+        {
+            return false;
+        }
+
+        auto& llvmModule = *module.GetLLVMModule();
+        llvm::SMDiagnostic error;
+        auto cachedModule = llvm::parseAssemblyString(code, error, llvmModule.getContext());
+        if (!cachedModule)
+        {
+            Log() << "Couldn't parse cached code for key " << key << ": " << error.getMessage().str() << EOL;
+            return false;
+        }
+
+        // The module may already define some of the functions the cached code defines, if they were emitted by other code
+        for (const auto& function : cachedModule->functions())
+        {
+            auto existingFunction = llvmModule.getFunction(function.getName());
+            if (!function.isDeclaration() && !function.hasLocalLinkage() && existingFunction != nullptr && !existingFunction->isDeclaration())
+            {
+                Log() << "Not using cached code for key " << key << ", because the module already defines " << function.getName().str() << EOL;
+                return false;
+            }
+        }
+
+        cachedModule->setDataLayout(llvmModule.getDataLayout());
+        cachedModule->setTargetTriple(llvmModule.getTargetTriple());
+        if (llvm::Linker::linkModules(llvmModule, std::move(cachedModule)))
+        {
+            throw EmitterException(EmitterError::unexpected, "Couldn't link cached code into the module");
+        }
+
+        Log() << "Loaded cached code for key " << key << EOL;
+        return true;
+    }
+
+    void IRFunctionCache::BeginEmit(IRModuleEmitter& module)
+    {
+        auto& llvmModule = *module.GetLLVMModule();
+        _existingValues.clear();
+        for (const auto& function : llvmModule.functions())
+        {
+            _existingValues.insert(&function);
+        }
+        for (const auto& global : llvmModule.globals())
+        {
+            _existingValues.insert(&global);
+        }
+        _numNamedMetadataOperands = GetNumNamedMetadataOperands(llvmModule);
+    }
+
+    bool IRFunctionCache::EndEmit(IRModuleEmitter& module, const std::string& key)
+    {
+        auto& llvmModule = *module.GetLLVMModule();
+
+        // Module metadata, like the functions to declare in the header, isn't part of the cached code
+        if (GetNumNamedMetadataOperands(llvmModule) != _numNamedMetadataOperands)
+        {
+            Log() << "Not caching code for key " << key << ", because it added module metadata" << EOL;
+            return false;
+        }
+
+        std::unordered_set<const llvm::GlobalValue*> emittedValues;
+        for (const auto& function : llvmModule.functions())
+        {
+            if (!function.isDeclaration() && _existingValues.count(&function) == 0)
+            {
+                emittedValues.insert(&function);
+            }
+        }
+        for (const auto& global : llvmModule.globals())
+        {
+            if (!global.isDeclaration() && _existingValues.count(&global) == 0)
+            {
+                emittedValues.insert(&global);
+            }
+        }
+
+        if (emittedValues.empty())
+        {
+            return false;
+        }
+
+        // The emitted code can't use code or data emitted before it, because a later compile won't have it
+        for (auto value : emittedValues)
+        {
+            for (auto referencedValue : GetReferencedValues(*value))
+            {
+                if (!referencedValue->isDeclaration() && emittedValues.count(referencedValue) == 0)
+                {
+                    Log() << "Not caching code for key " << key << ", because it uses " << referencedValue->getName().str() << EOL;
+                    return false;
+                }
+            }
+        }
+
+        // Everything else in the module becomes a declaration, and unused declarations are removed
+        llvm::ValueToValueMapTy valueMap;
+        auto cachedModule = std::unique_ptr<llvm::Module>(llvm::CloneModule(&llvmModule, valueMap, [&emittedValues](const llvm::GlobalValue* value) {
+            return emittedValues.count(value) != 0;
+        }));
+
+        for (auto it = cachedModule->begin(); it != cachedModule->end();)
+        {
+            auto& function = *it++;
+            if (function.isDeclaration() && function.use_empty())
+            {
+                function.eraseFromParent();
+            }
+        }
+        for (auto it = cachedModule->global_begin(); it != cachedModule->global_end();)
+        {
+            auto& global = *it++;
+            if (global.isDeclaration() && global.use_empty())
+            {
+                global.eraseFromParent();
+            }
+        }
+        while (cachedModule->named_metadata_begin() != cachedModule->named_metadata_end())
+        {
+            cachedModule->eraseNamedMetadata(&*cachedModule->named_metadata_begin());
+        }
+
+        std::string code;
+        {
+            llvm::raw_string_ostream stream(code);
+            cachedModule->print(stream, nullptr);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(GetMemoryCacheMutex());
+            GetMemoryCache()[key] = code;
+        }
+
+        if (!_directory.empty())
+        {
+            // Write to a temporary file and then rename it, so other processes never see a partially-written file.
+            // Failing to write to the cache isn't an error: the code has already been emitted.
+            auto path = GetFilePath(key);
+            int fd = 0;
+            llvm::SmallString<256> tempPath;
+            if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tempPath))
+            {
+                Log() << "Couldn't write function cache file " << path << EOL;
+                return true;
+            }
+
+            {
+                llvm::raw_fd_ostream stream(fd, true);
+                stream << code;
+            }
+
+            if (llvm::sys::fs::rename(tempPath, path))
+            {
+                llvm::sys::fs::remove(tempPath);
+                Log() << "Couldn't write function cache file " << path << EOL;
+            }
+        }
+
+        Log() << "Cached code for key " << key << EOL;
+        return true;
+    }
+
+    void IRFunctionCache::ClearMemoryCache()
+    {
+        std::lock_guard<std::mutex> lock(GetMemoryCacheMutex());
+        GetMemoryCache().clear();
+    }
+} // namespace emitters
+} // namespace ell
@@ -755,6 +755,15 @@ namespace emitters
         return result;
     }
 
+    llvm::AllocaInst* IRFunctionEmitter::EmittedVariable(VariableType type, int size, const std::string& name)
+    {
+        EntryBlockScope scope(*this);
+        auto result = GetEmitter().StackAllocate(type, size);
+        result->setName(name);
+        _locals.Add(name, result);
+        return result;
+    }
+
     llvm::AllocaInst* IRFunctionEmitter::Variable(VariableType type, int size)
     {
         EntryBlockScope scope(*this);
@@ -807,6 +816,26 @@ namespace emitters
         return GetEmitter().Store(pPointer, pValue);
     }
 
+    LLVMValue IRFunctionEmitter::AtomicLoad(LLVMValue pPointer)
+    {
+        return GetEmitter().AtomicLoad(pPointer);
+    }
+
+    LLVMValue IRFunctionEmitter::AtomicStore(LLVMValue pPointer, LLVMValue pValue)
+    {
+        return GetEmitter().AtomicStore(pPointer, pValue);
+    }
+
+    LLVMValue IRFunctionEmitter::AtomicAdd(LLVMValue pPointer, LLVMValue pValue)
+    {
+        return GetEmitter().AtomicAdd(pPointer, pValue);
+    }
+
+    LLVMValue IRFunctionEmitter::AtomicCompareExchange(LLVMValue pPointer, LLVMValue pExpectedValue, LLVMValue pNewValue)
+    {
+        return GetEmitter().AtomicCompareExchange(pPointer, pExpectedValue, pNewValue);
+    }
+
     LLVMValue IRFunctionEmitter::StoreZero(LLVMValue pPointer, int numElements /* = 1 */)
     {
         assert(numElements >= 1);
@@ -1022,6 +1051,28 @@ namespace emitters
         return SetValueAt(pPointer, Literal(offset), pValue);
     }
 
+    LLVMValue IRFunctionEmitter::SetValueAtNonTemporal(LLVMValue pPointer, LLVMValue pOffset, LLVMValue pValue)
+    {
+        auto result = SetValueAt(pPointer, pOffset, pValue);
+        if (auto store = llvm::dyn_cast<llvm::StoreInst>(result))
+        {
+            auto& context = GetLLVMContext();
+            auto one = llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 1));
+            store->setMetadata(llvm::LLVMContext::MD_nontemporal, llvm::MDNode::get(context, { one }));
+        }
+        return result;
+    }
+
+    void IRFunctionEmitter::Prefetch(LLVMValue pPointer, LLVMValue pOffset, bool forWrite)
+    {
+        // Prefetches never fault, so the address can be past the end of the array
+        auto address = CastPointer(PointerOffset(pPointer, pOffset), llvm::Type::getInt8PtrTy(GetLLVMContext()));
+        auto prefetch = llvm::Intrinsic::getDeclaration(GetModule().GetLLVMModule(), llvm::Intrinsic::prefetch);
+        const int dataCache = 1;
+        const int highLocality = 3;
+        Call(prefetch, { address, Literal<int>(forWrite ? 1 : 0), Literal<int>(highLocality), Literal<int>(dataCache) });
+    }
+
     // Control flow constructs
 
     //
@@ -1265,6 +1316,11 @@ namespace emitters
         return IRAsyncTask(*this, taskFunction, arguments);
     }
 
+    IRTask IRFunctionEmitter::StartAsyncTask(LLVMFunction taskFunction, const std::vector<LLVMValue>& arguments, const std::string& storageName)
+    {
+        return IRAsyncTask(*this, taskFunction, arguments, storageName);
+    }
+
     //
     // Array of tasks
     //
@@ -1276,7 +1332,8 @@ namespace emitters
     IRTaskArray IRFunctionEmitter::StartTasks(LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& arguments)
     {
         auto compilerSettings = GetCompilerOptions();
-        if (compilerSettings.parallelize && compilerSettings.useThreadPool && !compilerSettings.targetDevice.IsWindows())
+        // With an external thread pool, each task is submitted to it as an async task
+        if (compilerSettings.parallelize && compilerSettings.useThreadPool && !compilerSettings.externalThreadPool && !compilerSettings.targetDevice.IsWindows())
         {
             auto& threadPool = GetModule().GetThreadPool();
             return threadPool.AddTasks(*this, taskFunction, arguments);
@@ -1505,6 +1562,12 @@ namespace emitters
 
     template <typename ValueType>
     void IRFunctionEmitter::CallGEMM(bool transposeA, bool transposeB, int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc)
+    {
+        CallGEMM<ValueType>(transposeA, transposeB, m, n, k, static_cast<ValueType>(1.0), A, lda, B, ldb, static_cast<ValueType>(0.0), C, ldc);
+    }
+
+    template <typename ValueType>
+    void IRFunctionEmitter::CallGEMM(bool transposeA, bool transposeB, int m, int n, int k, ValueType alpha, LLVMValue A, int lda, LLVMValue B, int ldb, ValueType beta, LLVMValue C, int ldc)
     {
         auto useBlas = CanUseBlas();
         LLVMFunction gemm = GetModule().GetRuntime().GetGEMMFunction<ValueType>(useBlas);
@@ -1524,12 +1587,12 @@ namespace emitters
             Literal(m),
             Literal(n),
             Literal(k),
-            Literal(static_cast<ValueType>(1.0)), // alpha
+            Literal(alpha), // alpha
             A,
             Literal(lda), // lda
             B,
             Literal(ldb), // ldb
-            Literal(static_cast<ValueType>(0.0)), // beta
+            Literal(beta), // beta
             C, // C (output)
             Literal(ldc) // ldc
         };
@@ -1599,6 +1662,12 @@ namespace emitters
         return Call(selfFunction, {});
     }
 
+    LLVMValue IRFunctionEmitter::PthreadSetAffinity(LLVMValue thread, LLVMValue cpuSetSize, LLVMValue cpuSetPtr)
+    {
+        auto setAffinityFunction = GetModule().GetRuntime().GetPosixEmitter().GetPthreadSetAffinityFunction();
+        return Call(setAffinityFunction, { thread, cpuSetSize, cpuSetPtr });
+    }
+
     LLVMValue IRFunctionEmitter::PthreadMutexInit(LLVMValue mutexPtr, LLVMValue attrPtr)
     {
         auto initFunction = GetModule().GetRuntime().GetPosixEmitter().GetPthreadMutexInitFunction();
@@ -1819,8 +1888,12 @@ namespace emitters
 
     template void IRFunctionEmitter::CallGEMM<float>(bool transposeA, bool transposeB, int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc);
 
+    template void IRFunctionEmitter::CallGEMM<float>(bool transposeA, bool transposeB, int m, int n, int k, float alpha, LLVMValue A, int lda, LLVMValue B, int ldb, float beta, LLVMValue C, int ldc);
+
     template void IRFunctionEmitter::CallGEMM<double>(int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc);
 
     template void IRFunctionEmitter::CallGEMM<double>(bool transposeA, bool transposeB, int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc);
+
+    template void IRFunctionEmitter::CallGEMM<double>(bool transposeA, bool transposeB, int m, int n, int k, double alpha, LLVMValue A, int lda, LLVMValue B, int ldb, double beta, LLVMValue C, int ldc);
 } // namespace emitters
 } // namespace ell
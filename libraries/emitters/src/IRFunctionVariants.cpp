@@ -0,0 +1,330 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRFunctionVariants.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRFunctionVariants.h"
+#include "EmitterException.h"
+#include "IRMetadata.h"
+#include "IRModuleEmitter.h"
+#include "IRReentrancy.h"
+
+#include <utilities/include/Logger.h>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        // A set of CPU features, along with the bits that indicate the CPU (and OS) support them
+        struct FeatureSet
+        {
+            std::string name;
+            std::vector<llvm::Triple::ArchType> architectures;
+            std::string features; // the LLVM target features to compile the variant with
+
+            // x86: required bits of ecx from cpuid leaf 1, ebx from cpuid leaf 7, and the XCR0 register (the register state saved by the OS)
+            uint32_t cpuidLeaf1Ecx = 0;
+            uint32_t cpuidLeaf7Ebx = 0;
+            uint32_t xcr0 = 0;
+
+            // ARM: required bits of the AT_HWCAP entry of the auxiliary vector
+            uint64_t hwcap = 0;
+
+            // x86: required bits of ecx from cpuid leaf 7
+            uint32_t cpuidLeaf7Ecx = 0;
+        };
+
+        constexpr uint32_t c_fmaBit = 1u << 12;
+        constexpr uint32_t c_osxsaveBit = 1u << 27;
+        constexpr uint32_t c_avxBit = 1u << 28;
+        constexpr uint32_t c_f16cBit = 1u << 29;
+        constexpr uint32_t c_avx2Bit = 1u << 5;
+        constexpr uint32_t c_avx512Bits = (1u << 16) | (1u << 17) | (1u << 30) | (1u << 31); // AVX-512 F, DQ, BW, VL
+        constexpr uint32_t c_avx512PopcntBits = (1u << 12) | (1u << 14); // AVX-512 BITALG, VPOPCNTDQ (in ecx)
+        constexpr uint32_t c_avxStateBits = 0x6; // XMM and YMM registers
+        constexpr uint32_t c_avx512StateBits = 0xe6; // XMM, YMM, opmask, and ZMM registers
+
+        constexpr int c_atHwcap = 16;
+        constexpr uint64_t c_hwcapNeon = 1 << 12; // 32-bit ARM
+        constexpr uint64_t c_hwcapAsimdDotProduct = 1 << 20; // 64-bit ARM
+
+        // In order from least to most capable: when the CPU supports more than one of a function's variants, the last one is used
+        const std::vector<FeatureSet>& GetFeatureSets()
+        {
+            static const std::vector<FeatureSet> featureSets = {
+                { "avx2", { llvm::Triple::x86, llvm::Triple::x86_64 }, "+avx,+avx2,+fma,+f16c", c_osxsaveBit | c_avxBit | c_fmaBit | c_f16cBit, c_avx2Bit, c_avxStateBits, 0 },
+                { "avx512", { llvm::Triple::x86, llvm::Triple::x86_64 }, "+avx,+avx2,+fma,+f16c,+avx512f,+avx512dq,+avx512bw,+avx512vl", c_osxsaveBit | c_avxBit | c_fmaBit | c_f16cBit, c_avx2Bit | c_avx512Bits, c_avx512StateBits, 0 },
+                { "avx512popcnt", { llvm::Triple::x86, llvm::Triple::x86_64 }, "+avx,+avx2,+fma,+f16c,+avx512f,+avx512dq,+avx512bw,+avx512vl,+avx512vpopcntdq,+avx512bitalg", c_osxsaveBit | c_avxBit | c_fmaBit | c_f16cBit, c_avx2Bit | c_avx512Bits, c_avx512StateBits, 0, c_avx512PopcntBits },
+                { "neon", { llvm::Triple::arm, llvm::Triple::thumb }, "+neon", 0, 0, 0, c_hwcapNeon },
+                { "dotprod", { llvm::Triple::aarch64 }, "+dotprod", 0, 0, 0, c_hwcapAsimdDotProduct },
+            };
+            return featureSets;
+        }
+
+        llvm::Triple::ArchType GetArchitecture(const TargetDevice& target)
+        {
+            return llvm::Triple(llvm::Triple::normalize(target.triple)).getArch();
+        }
+
+        bool IsSupportedOnTarget(const FeatureSet& featureSet, const TargetDevice& target)
+        {
+            auto arch = GetArchitecture(target);
+            return std::find(featureSet.architectures.begin(), featureSet.architectures.end(), arch) != featureSet.architectures.end();
+        }
+
+        const FeatureSet& GetFeatureSet(const std::string& name)
+        {
+            const auto& featureSets = GetFeatureSets();
+            auto iter = std::find_if(featureSets.begin(), featureSets.end(), [&name](const FeatureSet& featureSet) { return featureSet.name == name; });
+            if (iter == featureSets.end())
+            {
+                throw EmitterException(EmitterError::badFunctionArguments, "Unknown function variant '" + name + "'");
+            }
+            return *iter;
+        }
+
+        // The values of the CPU feature registers, read once at the start of the resolver function
+        struct CpuFeatureValues
+        {
+            LLVMValue cpuidLeaf1Ecx = nullptr;
+            LLVMValue cpuidLeaf7Ebx = nullptr;
+            LLVMValue cpuidLeaf7Ecx = nullptr;
+            LLVMValue xcr0 = nullptr;
+            LLVMValue hwcap = nullptr;
+        };
+
+        CpuFeatureValues EmitReadX86Features(IRFunctionEmitter& function)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto& context = irBuilder.getContext();
+            auto int32Type = irBuilder.getInt32Ty();
+
+            auto cpuidResultType = llvm::StructType::get(context, { int32Type, int32Type, int32Type, int32Type });
+            auto cpuidType = llvm::FunctionType::get(cpuidResultType, { int32Type, int32Type }, false);
+            auto cpuid = llvm::InlineAsm::get(cpuidType, "cpuid", "={ax},={bx},={cx},={dx},{ax},{cx},~{dirflag},~{fpsr},~{flags}", false);
+
+            CpuFeatureValues result;
+            auto maxLeaf = irBuilder.CreateExtractValue(irBuilder.CreateCall(cpuid, { irBuilder.getInt32(0), irBuilder.getInt32(0) }), 0);
+            result.cpuidLeaf1Ecx = irBuilder.CreateExtractValue(irBuilder.CreateCall(cpuid, { irBuilder.getInt32(1), irBuilder.getInt32(0) }), 2);
+            auto leaf7 = irBuilder.CreateCall(cpuid, { irBuilder.getInt32(7), irBuilder.getInt32(0) });
+            auto hasLeaf7 = irBuilder.CreateICmpUGE(maxLeaf, irBuilder.getInt32(7));
+            result.cpuidLeaf7Ebx = irBuilder.CreateSelect(hasLeaf7, irBuilder.CreateExtractValue(leaf7, 1), irBuilder.getInt32(0));
+            result.cpuidLeaf7Ecx = irBuilder.CreateSelect(hasLeaf7, irBuilder.CreateExtractValue(leaf7, 2), irBuilder.getInt32(0));
+
+            // xgetbv faults unless the OS has enabled it, which it indicates with the OSXSAVE bit
+            auto xcr0 = function.Variable(int32Type, "xcr0");
+            function.Store(xcr0, irBuilder.getInt32(0));
+            auto hasXgetbv = irBuilder.CreateICmpNE(irBuilder.CreateAnd(result.cpuidLeaf1Ecx, irBuilder.getInt32(c_osxsaveBit)), irBuilder.getInt32(0));
+            function.If(hasXgetbv, [xcr0, int32Type, &context](IRFunctionEmitter& function) {
+                auto& irBuilder = function.GetEmitter().GetIRBuilder();
+                auto xgetbvResultType = llvm::StructType::get(context, { int32Type, int32Type });
+                auto xgetbvType = llvm::FunctionType::get(xgetbvResultType, { int32Type }, false);
+                auto xgetbv = llvm::InlineAsm::get(xgetbvType, "xgetbv", "={ax},={dx},{cx},~{dirflag},~{fpsr},~{flags}", false);
+                function.Store(xcr0, irBuilder.CreateExtractValue(irBuilder.CreateCall(xgetbv, { irBuilder.getInt32(0) }), 0));
+            });
+            result.xcr0 = function.Load(xcr0);
+            return result;
+        }
+
+        CpuFeatureValues EmitReadArmFeatures(IRModuleEmitter& module, IRFunctionEmitter& function)
+        {
+            const auto& target = module.GetCompilerOptions().targetDevice;
+            if (!target.IsLinux())
+            {
+                throw EmitterException(EmitterError::targetNotSupported, "Function variants for ARM targets require Linux");
+            }
+
+            // unsigned long getauxval(unsigned long type);
+            auto longType = target.numBits == 64 ? VariableType::Int64 : VariableType::Int32;
+            module.DeclareFunction("getauxval", longType, { longType });
+
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            CpuFeatureValues result;
+            auto hwcap = function.Call("getauxval", { irBuilder.getIntN(target.numBits == 64 ? 64 : 32, c_atHwcap) });
+            result.hwcap = irBuilder.CreateZExtOrTrunc(hwcap, irBuilder.getInt64Ty());
+            return result;
+        }
+
+        LLVMValue EmitHasBits(llvm::IRBuilder<>& irBuilder, LLVMValue value, uint64_t bits)
+        {
+            auto type = value->getType();
+            auto mask = llvm::ConstantInt::get(type, bits);
+            return irBuilder.CreateICmpEQ(irBuilder.CreateAnd(value, mask), mask);
+        }
+
+        LLVMValue EmitIsSupported(IRFunctionEmitter& function, const CpuFeatureValues& values, const FeatureSet& featureSet)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            LLVMValue result = irBuilder.getTrue();
+            auto requireBits = [&](LLVMValue value, uint64_t bits) {
+                if (bits != 0)
+                {
+                    result = irBuilder.CreateAnd(result, EmitHasBits(irBuilder, value, bits));
+                }
+            };
+            requireBits(values.cpuidLeaf1Ecx, featureSet.cpuidLeaf1Ecx);
+            requireBits(values.cpuidLeaf7Ebx, featureSet.cpuidLeaf7Ebx);
+            requireBits(values.cpuidLeaf7Ecx, featureSet.cpuidLeaf7Ecx);
+            requireBits(values.xcr0, featureSet.xcr0);
+            requireBits(values.hwcap, featureSet.hwcap);
+            return result;
+        }
+
+        std::string AddTargetFeatures(llvm::Function& function, const std::string& features)
+        {
+            auto existing = function.getFnAttribute("target-features").getValueAsString().str();
+            return existing.empty() ? features : existing + "," + features;
+        }
+
+        // Replaces the body of the function with a call through a function pointer initially pointing at
+        // a copy of the original code, and returns the function pointer
+        llvm::GlobalVariable* EmitDispatchStub(llvm::Function& function, llvm::Function& defaultImplementation)
+        {
+            auto pointerType = function.getFunctionType()->getPointerTo();
+            auto implementation = new llvm::GlobalVariable(*function.getParent(), pointerType, false, llvm::GlobalValue::InternalLinkage, &defaultImplementation, function.getName() + "_implementation");
+            MarkGlobalShared(*implementation);
+
+            auto linkage = function.getLinkage();
+            function.deleteBody();
+            function.setLinkage(linkage);
+
+            llvm::IRBuilder<> irBuilder(llvm::BasicBlock::Create(function.getContext(), "entry", &function));
+            std::vector<llvm::Value*> args;
+            for (auto& arg : function.args())
+            {
+                args.push_back(&arg);
+            }
+            auto result = irBuilder.CreateCall(irBuilder.CreateLoad(implementation), args);
+            if (function.getReturnType()->isVoidTy())
+            {
+                irBuilder.CreateRetVoid();
+            }
+            else
+            {
+                irBuilder.CreateRet(result);
+            }
+            return implementation;
+        }
+
+        struct FunctionVariant
+        {
+            const FeatureSet* featureSet;
+            llvm::Function* function;
+        };
+
+        struct MultiversionedFunction
+        {
+            llvm::GlobalVariable* implementation;
+            std::vector<FunctionVariant> variants; // from least to most capable
+        };
+    } // namespace
+
+    std::vector<std::string> GetFunctionVariantNames(const TargetDevice& target)
+    {
+        std::vector<std::string> result;
+        for (const auto& featureSet : GetFeatureSets())
+        {
+            if (IsSupportedOnTarget(featureSet, target))
+            {
+                result.push_back(featureSet.name);
+            }
+        }
+        return result;
+    }
+
+    void EmitFunctionVariants(IRModuleEmitter& module)
+    {
+        const auto& target = module.GetCompilerOptions().targetDevice;
+        std::vector<MultiversionedFunction> multiversionedFunctions;
+        for (const auto& taggedFunction : GetFunctionsWithTag(module, c_functionVariantsTagName))
+        {
+            auto& function = *taggedFunction.function;
+            if (function.isDeclaration())
+            {
+                continue;
+            }
+
+            // Get the requested feature sets that apply to this target, from least to most capable
+            std::vector<const FeatureSet*> featureSets;
+            for (const auto& name : taggedFunction.values)
+            {
+                if (name.empty())
+                {
+                    continue;
+                }
+                const auto& featureSet = GetFeatureSet(name);
+                if (!IsSupportedOnTarget(featureSet, target))
+                {
+                    Log() << "Skipping function variant " << name << " of " << function.getName().str() << ": not supported on target " << target.triple << EOL;
+                    continue;
+                }
+                featureSets.push_back(&featureSet);
+            }
+            std::sort(featureSets.begin(), featureSets.end()); // the feature sets are stored in order, so this sorts by capability
+            featureSets.erase(std::unique(featureSets.begin(), featureSets.end()), featureSets.end());
+            if (featureSets.empty())
+            {
+                continue;
+            }
+
+            Log() << "Emitting " << featureSets.size() << " variants of function " << function.getName().str() << EOL;
+            MultiversionedFunction multiversioned;
+            for (auto featureSet : featureSets)
+            {
+                llvm::ValueToValueMapTy valueMap;
+                auto variant = llvm::CloneFunction(&function, valueMap);
+                variant->setName(function.getName() + "_" + featureSet->name);
+                variant->setLinkage(llvm::GlobalValue::InternalLinkage);
+                variant->addFnAttr("target-features", AddTargetFeatures(function, featureSet->features));
+                multiversioned.variants.push_back({ featureSet, variant });
+            }
+
+            llvm::ValueToValueMapTy valueMap;
+            auto defaultImplementation = llvm::CloneFunction(&function, valueMap);
+            defaultImplementation->setName(function.getName() + "_default");
+            defaultImplementation->setLinkage(llvm::GlobalValue::InternalLinkage);
+            multiversioned.implementation = EmitDispatchStub(function, *defaultImplementation);
+            multiversionedFunctions.push_back(multiversioned);
+        }
+
+        if (multiversionedFunctions.empty())
+        {
+            return;
+        }
+
+        // Emit the initialization function that picks the variants to use
+        auto& resolver = module.BeginFunction(module.GetModuleName() + "_ResolveFunctionVariants", VariableType::Void);
+        auto arch = GetArchitecture(target);
+        auto featureValues = (arch == llvm::Triple::x86 || arch == llvm::Triple::x86_64) ? EmitReadX86Features(resolver) : EmitReadArmFeatures(module, resolver);
+        for (const auto& multiversioned : multiversionedFunctions)
+        {
+            for (const auto& variant : multiversioned.variants)
+            {
+                auto implementation = multiversioned.implementation;
+                auto variantFunction = variant.function;
+                resolver.If(EmitIsSupported(resolver, featureValues, *variant.featureSet), [implementation, variantFunction](IRFunctionEmitter& function) {
+                    function.Store(implementation, variantFunction);
+                });
+            }
+        }
+        module.EndFunction();
+        module.AddInitializationFunction(resolver);
+    }
+} // namespace emitters
+} // namespace ell
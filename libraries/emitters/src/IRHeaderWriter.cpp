@@ -10,6 +10,8 @@
 #include "EmitterException.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
+#include "IRReentrancy.h"
+#include "IRThreadUtilities.h"
 
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/IRPrintingPasses.h>
@@ -21,6 +23,7 @@
 #include <utilities/include/StringUtil.h>
 #include <utilities/include/UniqueNameList.h>
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -291,6 +294,19 @@ namespace emitters
                 }
             }
 
+            const auto& compilerOptions = moduleEmitter.GetCompilerOptions();
+            if (compilerOptions.parallelize && compilerOptions.externalThreadPool)
+            {
+                DeclareIfDefGuard swig(os, "SWIG", DeclareIfDefGuard::Type::Negative);
+                os << "//\n// Thread pool functions the application provides, which all its models share\n//\n\n";
+                DeclareIfDefGuard guard(os, "ELL_TASK_FUNCTIONS", DeclareIfDefGuard::Type::Negative);
+                os << "#define ELL_TASK_FUNCTIONS\n\n";
+                os << "// Starts running `taskFunction(taskArgument)`, and returns a handle to the task. Tasks with a higher priority should be run first.\n";
+                os << "void* " << c_submitTaskFunctionName << "(void* (*taskFunction)(void*), void* taskArgument, int32_t priority);\n\n";
+                os << "// Waits for a task to finish, and returns the value its task function returned.\n";
+                os << "void* " << c_waitForTaskFunctionName << "(void* task);\n\n";
+            }
+
             os << "//\n// Functions\n//\n\n";
             // Now write out function signatures
             auto tagValues = GetFunctionsWithTag(moduleEmitter, c_declareFunctionInHeaderTagName);
@@ -321,6 +337,8 @@ namespace emitters
         std::string predictReturnMember;
         std::vector<std::string> predictMethodArgs;
         std::vector<std::string> predictCallArgs;
+        std::vector<std::string> bufferMethodArgs;
+        std::vector<std::string> bufferCallArgs;
         std::stringstream constructorInit;
         std::stringstream predictPreBody;
         std::stringstream predictPostBody;
@@ -485,6 +503,7 @@ namespace emitters
                 // we really want void* on these puppies, but LLVM won't let us...(which is why the argType is int8_t*,
                 // and for our wrapper class, the context will be 'this' so the "C" callbacks can find this object.
                 info.predictCallArgs.push_back("this");
+                info.bufferCallArgs.push_back("context");
             }
             else
             {
@@ -508,6 +527,10 @@ namespace emitters
                         info.predictCallArgs.push_back(argName + ".data()"); // convert vector to raw buffer.
                         passArgument = true;
                     }
+                    // the buffer version of predict writes every output into a buffer owned by the caller.
+                    info.bufferMethodArgs.push_back(argType + "* " + argName);
+                    info.bufferCallArgs.push_back(argName);
+
                     // the predict output arg is a cached member vector so we only have to allocate it once.
                     info.constructorInit << "        _" << argName << ".resize(GetOutputSize(" << outputCount++ << "));\n";
                     info.memberDecls << "    std::vector<" << argType << "> _" << argName << ";\n";
@@ -516,6 +539,8 @@ namespace emitters
                 {
                     // inputs are always passed in and passed through to C predict function
                     info.predictCallArgs.push_back(argName + ".data()"); // convert vector to raw buffer.
+                    info.bufferMethodArgs.push_back("const " + argType + "* " + argName);
+                    info.bufferCallArgs.push_back("const_cast<" + argType + "*>(" + argName + ")"); // the C predict function doesn't write to its inputs
                     passArgument = true;
                 }
                 if (passArgument)
@@ -526,6 +551,64 @@ namespace emitters
         }
     }
 
+    // Writes the versions of predict that take raw buffers for all the inputs and outputs, so callers that already
+    // own their buffers don't pay for any copies or allocations. If the module was compiled to be reentrant, and has
+    // no sink callbacks to deliver to the wrapper, there is also a const version that takes an explicit state and can
+    // be called from several threads at once.
+    void WriteBufferPredictMethods(IRModuleEmitter& moduleEmitter, ModuleCallbackDefinitions& moduleCallbacks, CppWrapperInfo& info)
+    {
+        auto callArgs = [&info](const std::string& context) {
+            auto args = info.bufferCallArgs;
+            std::replace(args.begin(), args.end(), std::string("context"), context);
+            return utilities::Join(args, ", ");
+        };
+
+        info.helperMethods << "#if !defined(SWIG)\n";
+        info.helperMethods << "    // Computes the outputs into buffers owned by the caller, without copying or allocating anything.\n";
+        info.helperMethods << "    void " << info.predictMethodName << "(" << utilities::Join(info.bufferMethodArgs, ", ") << ")\n";
+        info.helperMethods << "    {\n";
+        info.helperMethods << "        " << info.predictFunctionName << "(" << callArgs("this") << ");\n";
+        info.helperMethods << "    }\n\n";
+
+        auto& llvmModule = *moduleEmitter.GetLLVMModule();
+        bool isReentrant = llvmModule.getFunction(info.moduleName + "_GetStateSize") != nullptr;
+        if (isReentrant && moduleCallbacks.sinks.empty())
+        {
+            // a predict function that doesn't use the state doesn't get a reentrant version, it's already reentrant
+            auto reentrantFunctionName = GetReentrantFunctionName(info.predictFunctionName);
+            bool usesState = llvmModule.getFunction(reentrantFunctionName) != nullptr;
+
+            info.helperMethods << "    static int64_t GetStateSize()\n";
+            info.helperMethods << "    {\n";
+            info.helperMethods << "        return " << info.moduleName << "_GetStateSize();\n";
+            info.helperMethods << "    }\n\n";
+            info.helperMethods << "    static int64_t GetStateAlignment()\n";
+            info.helperMethods << "    {\n";
+            info.helperMethods << "        return " << info.moduleName << "_GetStateAlignment();\n";
+            info.helperMethods << "    }\n\n";
+            info.helperMethods << "    // Sets a state of GetStateSize() bytes, aligned to GetStateAlignment(), to its initial values.\n";
+            info.helperMethods << "    static void InitializeState(void* state)\n";
+            info.helperMethods << "    {\n";
+            info.helperMethods << "        " << info.moduleName << "_InitializeState(static_cast<int8_t*>(state));\n";
+            info.helperMethods << "    }\n\n";
+            info.helperMethods << "    // Computes the outputs into buffers owned by the caller, using a state owned by the caller instead of the\n";
+            info.helperMethods << "    // wrapper's, so different threads can predict at the same time, each with its own state.\n";
+            info.helperMethods << "    void " << info.predictMethodName << "(void* state, " << utilities::Join(info.bufferMethodArgs, ", ") << ") const\n";
+            info.helperMethods << "    {\n";
+            if (usesState)
+            {
+                info.helperMethods << "        " << reentrantFunctionName << "(static_cast<int8_t*>(state), " << callArgs("nullptr") << ");\n";
+            }
+            else
+            {
+                info.helperMethods << "        (void)state;\n";
+                info.helperMethods << "        " << info.predictFunctionName << "(" << callArgs("nullptr") << ");\n";
+            }
+            info.helperMethods << "    }\n\n";
+        }
+        info.helperMethods << "#endif // !defined(SWIG)\n\n";
+    }
+
     void WritePredictMethod(ModuleCallbackDefinitions& moduleCallbacks, CppWrapperInfo& info)
     {
         bool hasSourceNodes = !moduleCallbacks.sources.empty();
@@ -610,6 +693,10 @@ namespace emitters
         WriteSinkNotificationCallbacks(moduleCallbacks, info);
 
         WritePredictMethod(moduleCallbacks, info);
+        if (!hasSourceNodes)
+        {
+            WriteBufferPredictMethods(moduleEmitter, moduleCallbacks, info);
+        }
 
         // now write out the final completed code.
 
@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRLoopTiling.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRLoopTiling.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        size_t GetWorkingSetSize(const std::vector<int>& tileSizes, const std::vector<LoopNestArrayAccess>& arrays)
+        {
+            size_t result = 0;
+            for (const auto& array : arrays)
+            {
+                size_t size = array.bytesPerIteration;
+                for (auto loop : array.loops)
+                {
+                    size *= static_cast<size_t>(tileSizes[loop]);
+                }
+                result += size;
+            }
+            return result;
+        }
+
+        // The smallest tile of the innermost loop that covers a cache line of each array it indexes
+        int GetMinInnermostTileSize(const TargetDevice& targetDevice, size_t innermostLoop, const std::vector<LoopNestArrayAccess>& arrays)
+        {
+            int result = 1;
+            for (const auto& array : arrays)
+            {
+                if (array.bytesPerIteration > 0 && std::find(array.loops.begin(), array.loops.end(), innermostLoop) != array.loops.end())
+                {
+                    result = std::max(result, static_cast<int>(targetDevice.cacheLineSize / array.bytesPerIteration));
+                }
+            }
+            return result;
+        }
+    } // namespace
+
+    size_t GetCacheSize(const TargetDevice& targetDevice, CacheLevel level)
+    {
+        switch (level)
+        {
+        case CacheLevel::L1:
+            return targetDevice.l1CacheSize;
+        case CacheLevel::L2:
+            return targetDevice.l2CacheSize;
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unknown cache level");
+        }
+    }
+
+    std::vector<int> GetCacheTileSizes(const TargetDevice& targetDevice, const std::vector<int>& loopSizes, const std::vector<LoopNestArrayAccess>& arrays, CacheLevel level)
+    {
+        for (const auto& array : arrays)
+        {
+            for (auto loop : array.loops)
+            {
+                if (loop >= loopSizes.size())
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Array is indexed by a loop that isn't in the loop nest");
+                }
+            }
+        }
+
+        std::vector<int> tileSizes;
+        std::transform(loopSizes.begin(), loopSizes.end(), std::back_inserter(tileSizes), [](int size) { return std::max(size, 1); });
+        const auto cacheSize = GetCacheSize(targetDevice, level);
+        if (cacheSize == 0 || tileSizes.empty())
+        {
+            return tileSizes;
+        }
+
+        // Leave half of the cache for the data the loop nest doesn't account for
+        const auto budget = cacheSize / 2;
+        std::vector<int> minTileSizes(tileSizes.size(), 1);
+        minTileSizes.back() = std::min(tileSizes.back(), GetMinInnermostTileSize(targetDevice, tileSizes.size() - 1, arrays));
+        while (GetWorkingSetSize(tileSizes, arrays) > budget)
+        {
+            // Halve the largest tile that can still shrink, preferring the outer loops
+            int largest = -1;
+            for (size_t loop = 0; loop < tileSizes.size(); ++loop)
+            {
+                if (tileSizes[loop] > minTileSizes[loop] && (largest < 0 || tileSizes[loop] > tileSizes[largest]))
+                {
+                    largest = static_cast<int>(loop);
+                }
+            }
+            if (largest < 0)
+            {
+                break;
+            }
+            tileSizes[largest] = std::max((tileSizes[largest] + 1) / 2, minTileSizes[largest]);
+        }
+        return tileSizes;
+    }
+
+    std::vector<IRFunctionEmitter::ConstTiledLoopRange> GetCacheTiledLoopRanges(const TargetDevice& targetDevice, const std::vector<IRFunctionEmitter::ConstLoopRange>& ranges, const std::vector<LoopNestArrayAccess>& arrays, CacheLevel level)
+    {
+        std::vector<int> loopSizes;
+        std::transform(ranges.begin(), ranges.end(), std::back_inserter(loopSizes), [](const IRFunctionEmitter::ConstLoopRange& range) { return range.end - range.begin; });
+        auto tileSizes = GetCacheTileSizes(targetDevice, loopSizes, arrays, level);
+
+        std::vector<IRFunctionEmitter::ConstTiledLoopRange> result;
+        for (size_t loop = 0; loop < ranges.size(); ++loop)
+        {
+            result.push_back({ ranges[loop].begin, ranges[loop].end, tileSizes[loop] });
+        }
+        return result;
+    }
+} // namespace emitters
+} // namespace ell
@@ -12,6 +12,8 @@
 
 #include <utilities/include/Exception.h>
 
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Value.h>
 
 #include <functional>
@@ -20,12 +22,151 @@ namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        bool UseApproximateMath(const IRLocalScalar& a)
+        {
+            return a.function.GetCompilerOptions().useApproximateMath && a.value->getType()->getScalarType()->isFloatingPointTy();
+        }
+
+        // Returns the integer type with the same number of bits (and vector elements) as the given floating-point type
+        llvm::Type* GetIntegerType(llvm::Type* type, int bits)
+        {
+            auto intType = llvm::Type::getIntNTy(type->getContext(), bits);
+            if (type->isVectorTy())
+            {
+                return llvm::VectorType::get(intType, type->getVectorNumElements());
+            }
+            return intType;
+        }
+
+        LLVMValue Clamp(llvm::IRBuilder<>& irBuilder, LLVMValue x, LLVMValue low, LLVMValue high)
+        {
+            x = irBuilder.CreateSelect(irBuilder.CreateFCmpOLT(x, low), low, x);
+            return irBuilder.CreateSelect(irBuilder.CreateFCmpOGT(x, high), high, x);
+        }
+
+        // Evaluates the polynomial with the given coefficients (highest degree first) with Horner's rule
+        LLVMValue Polynomial(llvm::IRBuilder<>& irBuilder, LLVMValue x, std::initializer_list<double> coefficients)
+        {
+            auto type = x->getType();
+            LLVMValue result = nullptr;
+            for (auto coefficient : coefficients)
+            {
+                auto c = llvm::ConstantFP::get(type, coefficient);
+                result = result == nullptr ? c : irBuilder.CreateFAdd(irBuilder.CreateFMul(result, x), c);
+            }
+            return result;
+        }
+
+        // exp(x) = 2^n * exp(r), where n = round(x / ln(2)) and |r| <= ln(2) / 2
+        LLVMValue EmitFastExp(llvm::IRBuilder<>& irBuilder, LLVMValue x)
+        {
+            auto type = x->getType();
+            bool isDouble = type->getScalarType()->isDoubleTy();
+            auto constant = [type](double value) { return llvm::ConstantFP::get(type, value); };
+
+            // Smallest and largest inputs with normal results
+            auto minX = constant(isDouble ? -708.39641853226410622 : -87.3365478515625);
+            auto maxX = constant(isDouble ? 709.78271289338399678 : 88.72283172607421875);
+            auto clampedX = Clamp(irBuilder, x, minX, maxX);
+
+            // n = round(x * log2(e)), computed with a truncating conversion so it doesn't need a call to `floor`
+            auto t = irBuilder.CreateFMul(clampedX, constant(1.4426950408889634073599));
+            auto half = irBuilder.CreateSelect(irBuilder.CreateFCmpOLT(t, constant(0)), constant(-0.5), constant(0.5));
+            auto int32Type = GetIntegerType(type, 32);
+            auto n = irBuilder.CreateFPToSI(irBuilder.CreateFAdd(t, half), int32Type);
+            auto nFloat = irBuilder.CreateSIToFP(n, type);
+
+            // r = x - n * ln(2), with ln(2) split in two parts so the first product is exact
+            auto r = irBuilder.CreateFSub(clampedX, irBuilder.CreateFMul(nFloat, constant(isDouble ? 6.93145751953125E-1 : 0.693359375)));
+            r = irBuilder.CreateFSub(r, irBuilder.CreateFMul(nFloat, constant(isDouble ? 1.42860682030941723212E-6 : -2.12194440e-4)));
+
+            LLVMValue expR = nullptr;
+            if (isDouble)
+            {
+                // Pade approximation: exp(r) = 1 + 2 * P(r^2) * r / (Q(r^2) - P(r^2) * r)  (from Cephes)
+                auto rr = irBuilder.CreateFMul(r, r);
+                auto px = irBuilder.CreateFMul(r, Polynomial(irBuilder, rr, { 1.26177193074810590878E-4, 3.02994407707441961300E-2, 9.99999999999999999910E-1 }));
+                auto qx = Polynomial(irBuilder, rr, { 3.00198505138664455042E-6, 2.52448340349684104192E-3, 2.27265548208155028766E-1, 2.00000000000000000009E0 });
+                auto ratio = irBuilder.CreateFDiv(px, irBuilder.CreateFSub(qx, px));
+                expR = irBuilder.CreateFAdd(constant(1.0), irBuilder.CreateFMul(constant(2.0), ratio));
+            }
+            else
+            {
+                // exp(r) = 1 + r + r^2 * P(r)  (from Cephes)
+                auto p = Polynomial(irBuilder, r, { 1.9875691500E-4, 1.3981999507E-3, 8.3334519073E-3, 4.1665795894E-2, 1.6666665459E-1, 5.0000001201E-1 });
+                auto rr = irBuilder.CreateFMul(r, r);
+                expR = irBuilder.CreateFAdd(irBuilder.CreateFAdd(irBuilder.CreateFMul(p, rr), r), constant(1.0));
+            }
+
+            // Multiply by 2^n, built directly from the exponent bits. n is split in two halves, because 2^n itself
+            // may not be representable (for instance, when x is close to maxX).
+            int mantissaBits = isDouble ? 52 : 23;
+            int exponentBias = isDouble ? 1023 : 127;
+            auto intType = GetIntegerType(type, isDouble ? 64 : 32);
+            auto n1 = irBuilder.CreateAShr(n, llvm::ConstantInt::get(int32Type, 1));
+            auto n2 = irBuilder.CreateSub(n, n1);
+            auto powerOfTwo = [&](LLVMValue exponent) {
+                auto bits = irBuilder.CreateAdd(irBuilder.CreateSExt(exponent, intType), llvm::ConstantInt::get(intType, exponentBias));
+                return irBuilder.CreateBitCast(irBuilder.CreateShl(bits, llvm::ConstantInt::get(intType, mantissaBits)), type);
+            };
+            auto result = irBuilder.CreateFMul(irBuilder.CreateFMul(expR, powerOfTwo(n1)), powerOfTwo(n2));
+
+            // Handle underflow and overflow
+            result = irBuilder.CreateSelect(irBuilder.CreateFCmpOLT(x, minX), constant(0), result);
+            return irBuilder.CreateSelect(irBuilder.CreateFCmpOGT(x, maxX), llvm::ConstantFP::getInfinity(type), result);
+        }
+
+        // tanh(x) = x + x^3 * P(x^2) for |x| < 0.625, and sign(x) * (1 - 2 / (exp(2|x|) + 1)) otherwise  (from Cephes)
+        LLVMValue EmitFastTanh(llvm::IRBuilder<>& irBuilder, LLVMValue x)
+        {
+            auto type = x->getType();
+            bool isDouble = type->getScalarType()->isDoubleTy();
+            auto constant = [type](double value) { return llvm::ConstantFP::get(type, value); };
+
+            auto xx = irBuilder.CreateFMul(x, x);
+            LLVMValue smallResult = nullptr;
+            if (isDouble)
+            {
+                auto p = Polynomial(irBuilder, xx, { -9.64399179425052238628E-1, -9.92877231001918586564E1, -1.61468768441708447952E3 });
+                auto q = Polynomial(irBuilder, xx, { 1.0, 1.12811678491632931402E2, 2.23548839060100448583E3, 4.84406305325125486048E3 });
+                smallResult = irBuilder.CreateFAdd(x, irBuilder.CreateFMul(irBuilder.CreateFMul(x, xx), irBuilder.CreateFDiv(p, q)));
+            }
+            else
+            {
+                auto p = Polynomial(irBuilder, xx, { -5.70498872745E-3, 2.06390887954E-2, -5.37397155531E-2, 1.33314422036E-1, -3.33332819422E-1 });
+                smallResult = irBuilder.CreateFAdd(x, irBuilder.CreateFMul(irBuilder.CreateFMul(p, xx), x));
+            }
+
+            auto isNegative = irBuilder.CreateFCmpOLT(x, constant(0));
+            auto absX = irBuilder.CreateSelect(isNegative, irBuilder.CreateFNeg(x), x);
+            auto e = EmitFastExp(irBuilder, irBuilder.CreateFMul(absX, constant(2.0)));
+            auto largeResult = irBuilder.CreateFSub(constant(1.0), irBuilder.CreateFDiv(constant(2.0), irBuilder.CreateFAdd(e, constant(1.0))));
+            largeResult = irBuilder.CreateSelect(isNegative, irBuilder.CreateFNeg(largeResult), largeResult);
+
+            return irBuilder.CreateSelect(irBuilder.CreateFCmpOLT(absX, constant(0.625)), smallResult, largeResult);
+        }
+
+        LLVMValue EmitFastSigmoid(llvm::IRBuilder<>& irBuilder, LLVMValue x)
+        {
+            auto one = llvm::ConstantFP::get(x->getType(), 1.0);
+            auto e = EmitFastExp(irBuilder, irBuilder.CreateFNeg(x));
+            return irBuilder.CreateFDiv(one, irBuilder.CreateFAdd(one, e));
+        }
+    } // namespace
+
     //
     // Math functions
     //
     template <typename ValueType>
     IRLocalScalar Tanh(IRLocalScalar a)
     {
+        if (UseApproximateMath(a))
+        {
+            return FastTanh(a);
+        }
+
         auto f = a.function.GetModule().GetRuntime().GetTanhFunction<ValueType>();
         return { a.function, a.function.Call(f, { a }) };
     }
@@ -44,6 +185,11 @@ namespace emitters
 
     IRLocalScalar Exp(IRLocalScalar a)
     {
+        if (UseApproximateMath(a))
+        {
+            return FastExp(a);
+        }
+
         auto f = a.function.GetModule().GetRuntime().GetExpFunction((a.value)->getType());
         return { a.function, a.function.Call(f, { a }) };
     }
@@ -66,6 +212,21 @@ namespace emitters
         return { a.function, a.function.Call(f, { a }) };
     }
 
+    IRLocalScalar FastExp(IRLocalScalar a)
+    {
+        return { a.function, EmitFastExp(a.function.GetEmitter().GetIRBuilder(), a.value) };
+    }
+
+    IRLocalScalar FastTanh(IRLocalScalar a)
+    {
+        return { a.function, EmitFastTanh(a.function.GetEmitter().GetIRBuilder(), a.value) };
+    }
+
+    IRLocalScalar FastSigmoid(IRLocalScalar a)
+    {
+        return { a.function, EmitFastSigmoid(a.function.GetEmitter().GetIRBuilder(), a.value) };
+    }
+
     IRLocalScalar Min(IRLocalScalar a, IRLocalScalar b)
     {
         detail::VerifyArgTypesCompatible(a, b);
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRMemoryUsage.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRMemoryUsage.h"
+#include "EmitterException.h"
+#include "IRModuleEmitter.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        const std::set<std::string> c_heapFunctionNames = {
+            "malloc",
+            "calloc",
+            "realloc",
+            "free",
+            "aligned_alloc",
+            "posix_memalign",
+            "_Znwm", // operator new(size_t)
+            "_Znam", // operator new[](size_t)
+            "_Znwj", // operator new(size_t), 32-bit
+            "_Znaj", // operator new[](size_t), 32-bit
+            "_ZdlPv", // operator delete(void*)
+            "_ZdaPv" // operator delete[](void*)
+        };
+
+        class StackSizeCalculator
+        {
+        public:
+            StackSizeCalculator(const llvm::DataLayout& dataLayout) :
+                _dataLayout(dataLayout) {}
+
+            // Computes the stack size of a function and of all the functions it calls
+            FunctionMemoryUsage& GetUsage(llvm::Function& function)
+            {
+                auto it = _usage.find(&function);
+                if (it != _usage.end())
+                {
+                    if (_inProgress.count(&function) != 0)
+                    {
+                        // A recursive call
+                        it->second.isStackSizeBounded = false;
+                    }
+                    return it->second;
+                }
+
+                auto& usage = _usage[&function];
+                usage.name = function.getName().str();
+                _inProgress.insert(&function);
+
+                uint64_t largestCalleeStackSize = 0;
+                for (auto& block : function)
+                {
+                    for (auto& instruction : block)
+                    {
+                        if (auto allocation = llvm::dyn_cast<llvm::AllocaInst>(&instruction))
+                        {
+                            auto count = llvm::dyn_cast<llvm::ConstantInt>(allocation->getArraySize());
+                            if (count == nullptr || !allocation->isStaticAlloca())
+                            {
+                                usage.isStackSizeBounded = false;
+                            }
+                            else
+                            {
+                                usage.frameSize += _dataLayout.getTypeAllocSize(allocation->getAllocatedType()) * count->getZExtValue();
+                            }
+                        }
+
+                        if (auto call = llvm::dyn_cast<llvm::CallInst>(&instruction))
+                        {
+                            auto callee = call->getCalledFunction();
+                            if (callee == nullptr)
+                            {
+                                // An indirect call, to a callback we know nothing about
+                                usage.isStackSizeBounded = usage.isStackSizeBounded && call->isInlineAsm();
+                            }
+                            else if (!callee->isDeclaration())
+                            {
+                                auto& calleeUsage = GetUsage(*callee);
+                                largestCalleeStackSize = std::max(largestCalleeStackSize, calleeUsage.stackSize);
+                                usage.isStackSizeBounded = usage.isStackSizeBounded && calleeUsage.isStackSizeBounded;
+                            }
+                        }
+                    }
+                }
+
+                _inProgress.erase(&function);
+                usage.stackSize = usage.frameSize + largestCalleeStackSize;
+                return usage;
+            }
+
+        private:
+            const llvm::DataLayout& _dataLayout;
+            std::unordered_map<const llvm::Function*, FunctionMemoryUsage> _usage;
+            std::set<const llvm::Function*> _inProgress;
+        };
+    } // namespace
+
+    const FunctionMemoryUsage* ModuleMemoryUsage::GetFunction(const std::string& name) const
+    {
+        auto it = std::find_if(functions.begin(), functions.end(), [&name](const FunctionMemoryUsage& function) { return function.name == name; });
+        return it == functions.end() ? nullptr : &(*it);
+    }
+
+    ModuleMemoryUsage GetModuleMemoryUsage(IRModuleEmitter& module)
+    {
+        auto& llvmModule = *module.GetLLVMModule();
+        const auto& dataLayout = module.GetTargetDataLayout();
+
+        ModuleMemoryUsage result;
+        for (const auto& global : llvmModule.globals())
+        {
+            if (global.isDeclaration())
+            {
+                continue;
+            }
+
+            auto size = dataLayout.getTypeAllocSize(global.getValueType());
+            if (global.isConstant())
+            {
+                result.constantDataSize += size;
+            }
+            else
+            {
+                result.staticDataSize += size;
+            }
+        }
+
+        StackSizeCalculator calculator(dataLayout);
+        for (auto& function : llvmModule)
+        {
+            if (function.isDeclaration())
+            {
+                if (c_heapFunctionNames.count(function.getName().str()) != 0 && !function.use_empty())
+                {
+                    result.heapFunctions.push_back(function.getName().str());
+                }
+                continue;
+            }
+            result.functions.push_back(calculator.GetUsage(function));
+        }
+        return result;
+    }
+
+    void VerifyNoHeapAllocation(IRModuleEmitter& module)
+    {
+        auto usage = GetModuleMemoryUsage(module);
+        if (!usage.heapFunctions.empty())
+        {
+            std::string names;
+            for (const auto& name : usage.heapFunctions)
+            {
+                names += (names.empty() ? "" : ", ") + name;
+            }
+            throw EmitterException(EmitterError::notSupported, "The module allocates heap memory, by calling " + names);
+        }
+    }
+} // namespace emitters
+} // namespace ell
@@ -34,6 +34,8 @@
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/Utils/ModuleUtils.h>
 
+#include <mutex>
+
 namespace ell
 {
 namespace emitters
@@ -631,6 +633,7 @@ namespace emitters
         }
 
         options.verifyModule = true;
+        options.numPartitions = compilerOptions.codeGenPartitions;
         options.floatFusionMode = compilerOptions.useFastMath ? FloatFusionMode::Fast : FloatFusionMode::Standard;
         if (compilerOptions.positionIndependentCode.HasValue())
         {
@@ -676,6 +679,12 @@ namespace emitters
 
     void IRModuleEmitter::WriteToFile(const std::string& filePath, ModuleOutputFormat format, const MachineCodeOutputOptions& options)
     {
+        if (ModuleOutputFormat::objectCode == format && options.numPartitions > 1)
+        {
+            WritePartitionedObjectCode(filePath, options);
+            return;
+        }
+
         auto openFlags = (ModuleOutputFormat::bitcode == format || ModuleOutputFormat::objectCode == format) ? llvm::sys::fs::F_None : llvm::sys::fs::F_Text;
         std::error_code error;
         llvm::ToolOutputFile out(filePath, error, openFlags);
@@ -693,6 +702,36 @@ namespace emitters
         out.keep();
     }
 
+    void IRModuleEmitter::WritePartitionedObjectCode(const std::string& filePath, const MachineCodeOutputOptions& options)
+    {
+        std::vector<std::unique_ptr<llvm::ToolOutputFile>> outputFiles;
+        std::vector<llvm::raw_pwrite_stream*> outputStreams;
+        for (int partition = 0; partition < options.numPartitions; ++partition)
+        {
+            std::error_code error;
+            outputFiles.push_back(std::make_unique<llvm::ToolOutputFile>(GetPartitionFilePath(filePath, partition), error, llvm::sys::fs::F_None));
+            if (error)
+            {
+                throw LLVMException(error);
+            }
+            outputStreams.push_back(&outputFiles.back()->os());
+        }
+
+        GenerateMachineCode(outputStreams, *this, CompleteMachineCodeOutputOptions(options));
+
+        for (auto& out : outputFiles)
+        {
+            if (out->os().has_error())
+            {
+                throw EmitterException(EmitterError::writeStreamFailed);
+            }
+        }
+        for (auto& out : outputFiles)
+        {
+            out->keep();
+        }
+    }
+
     void IRModuleEmitter::WriteToStream(std::ostream& stream, ModuleOutputFormat format)
     {
         MachineCodeOutputOptions options;
@@ -729,6 +768,11 @@ namespace emitters
     }
 
     void IRModuleEmitter::WriteToLLVMStream(llvm::raw_ostream& os, ModuleOutputFormat format, MachineCodeOutputOptions options)
+    {
+        GenerateMachineCode(os, *this, format, CompleteMachineCodeOutputOptions(options));
+    }
+
+    MachineCodeOutputOptions IRModuleEmitter::CompleteMachineCodeOutputOptions(MachineCodeOutputOptions options) const
     {
         const auto& params = GetCompilerOptions();
 
@@ -747,7 +791,7 @@ namespace emitters
             options.targetDevice.features = params.targetDevice.features;
         }
 
-        GenerateMachineCode(os, *this, format, options);
+        return options;
     }
 
     void IRModuleEmitter::LoadIR(const std::string& text)
@@ -1004,19 +1048,23 @@ namespace emitters
     //
     void IRModuleEmitter::InitializeLLVM()
     {
-        // All targets
-        llvm::InitializeAllTargetInfos();
-        llvm::InitializeAllTargets();
-        llvm::InitializeAllTargetMCs();
-        llvm::InitializeAllAsmPrinters();
-        llvm::InitializeAllAsmParsers();
-        llvm::InitializeAllDisassemblers();
-
-        // Native target (perhaps unnecessary, since we're initializing _all_ the targets above)
-        llvm::InitializeNativeTarget();
-        llvm::InitializeNativeTargetAsmPrinter();
-        llvm::InitializeNativeTargetAsmParser();
-        llvm::InitializeNativeTargetDisassembler();
+        // The target registry is global, so it's only initialized once, even when modules are emitted on several threads
+        static std::once_flag initializeTargetsFlag;
+        std::call_once(initializeTargetsFlag, [] {
+            // All targets
+            llvm::InitializeAllTargetInfos();
+            llvm::InitializeAllTargets();
+            llvm::InitializeAllTargetMCs();
+            llvm::InitializeAllAsmPrinters();
+            llvm::InitializeAllAsmParsers();
+            llvm::InitializeAllDisassemblers();
+
+            // Native target (perhaps unnecessary, since we're initializing _all_ the targets above)
+            llvm::InitializeNativeTarget();
+            llvm::InitializeNativeTargetAsmPrinter();
+            llvm::InitializeNativeTargetAsmParser();
+            llvm::InitializeNativeTargetDisassembler();
+        });
 
         // Create a diagnostic handler to record if there was an error
         _diagnosticHandler = std::unique_ptr<IRDiagnosticHandler>(new IRDiagnosticHandler(*_llvmContext));
@@ -1028,18 +1076,21 @@ namespace emitters
         llvm::PassRegistry* registry = llvm::PassRegistry::getPassRegistry();
 
         // Initialize all of the optimization passes (probably unnecessary)
-        llvm::initializeCore(*registry);
-        llvm::initializeTransformUtils(*registry);
-        llvm::initializeScalarOpts(*registry);
-        // llvm::initializeObjCARCOpts(*registry);
-        llvm::initializeVectorization(*registry);
-        llvm::initializeInstCombine(*registry);
-        llvm::initializeIPO(*registry); // IPO == interprocedural optimizations
-        llvm::initializeInstrumentation(*registry);
-        llvm::initializeAnalysis(*registry);
-        llvm::initializeCodeGen(*registry);
-        llvm::initializeGlobalISel(*registry);
-        llvm::initializeTarget(*registry);
+        static std::once_flag initializePassesFlag;
+        std::call_once(initializePassesFlag, [registry] {
+            llvm::initializeCore(*registry);
+            llvm::initializeTransformUtils(*registry);
+            llvm::initializeScalarOpts(*registry);
+            // llvm::initializeObjCARCOpts(*registry);
+            llvm::initializeVectorization(*registry);
+            llvm::initializeInstCombine(*registry);
+            llvm::initializeIPO(*registry); // IPO == interprocedural optimizations
+            llvm::initializeInstrumentation(*registry);
+            llvm::initializeAnalysis(*registry);
+            llvm::initializeCodeGen(*registry);
+            llvm::initializeGlobalISel(*registry);
+            llvm::initializeTarget(*registry);
+        });
 
         return registry;
     }
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRObjectCache.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRObjectCache.h"
+
+#include <utilities/include/Files.h>
+#include <utilities/include/Logger.h>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    IRObjectCache::IRObjectCache(const std::string& directory, const std::string& key) :
+        _directory(directory),
+        _key(key)
+    {
+        utilities::EnsureDirectoryExists(_directory);
+    }
+
+    bool IRObjectCache::HasObject(const std::string& moduleName) const
+    {
+        return utilities::FileExists(GetObjectPath(moduleName));
+    }
+
+    std::string IRObjectCache::GetObjectPath(const std::string& moduleName) const
+    {
+        return utilities::JoinPaths(_directory, _key + "_" + moduleName + ".o");
+    }
+
+    void IRObjectCache::notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object)
+    {
+        // Write to a temporary file and then rename it, so other processes never see a partially-written object.
+        // Failing to write to the cache isn't an error: the code has already been generated.
+        auto path = GetObjectPath(module->getModuleIdentifier());
+        int fd = 0;
+        llvm::SmallString<256> tempPath;
+        if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tempPath))
+        {
+            Log() << "Couldn't write object cache file " << path << EOL;
+            return;
+        }
+
+        {
+            llvm::raw_fd_ostream stream(fd, true);
+            stream << object.getBuffer();
+        }
+
+        if (llvm::sys::fs::rename(tempPath, path))
+        {
+            llvm::sys::fs::remove(tempPath);
+            Log() << "Couldn't write object cache file " << path << EOL;
+            return;
+        }
+        Log() << "Wrote object cache file " << path << EOL;
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> IRObjectCache::getObject(const llvm::Module* module)
+    {
+        auto path = GetObjectPath(module->getModuleIdentifier());
+        if (!utilities::FileExists(path))
+        {
+            return nullptr;
+        }
+
+        auto buffer = llvm::MemoryBuffer::getFile(path);
+        if (!buffer)
+        {
+            return nullptr;
+        }
+
+        Log() << "Loaded object cache file " << path << EOL;
+
+        // The execution engine may hold on to the buffer after the file is replaced, so give it its own copy
+        return llvm::MemoryBuffer::getMemBufferCopy((*buffer)->getBuffer());
+    }
+} // namespace emitters
+} // namespace ell
@@ -10,6 +10,9 @@
 #include "IRModuleEmitter.h"
 #include "LLVMInclude.h"
 
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
 #include <llvm/IR/Module.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
@@ -46,6 +49,23 @@ namespace emitters
         builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, builder.SizeLevel, false);
         builder.LoopVectorize = true;
         builder.SLPVectorize = true;
+
+        // Profile-guided optimization: the instrumentation and the profile are both added by the module passes
+        const auto& options = _module.GetCompilerOptions();
+        if (!options.pgoInstrumentFile.empty())
+        {
+            builder.EnablePGOInstrGen = true;
+            builder.PGOInstrGen = options.pgoInstrumentFile;
+        }
+        if (!options.pgoProfileFile.empty())
+        {
+            if (!utilities::IsFileReadable(options.pgoProfileFile))
+            {
+                throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound, "Can't read the profile file " + options.pgoProfileFile);
+            }
+            builder.PGOInstrUse = options.pgoProfileFile;
+        }
+
         builder.populateFunctionPassManager(_functionPasses);
         builder.populateModulePassManager(_modulePasses);
 
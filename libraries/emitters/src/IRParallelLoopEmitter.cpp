@@ -12,12 +12,36 @@
 #include "IRMath.h"
 #include "IRModuleEmitter.h"
 
+#include <algorithm>
+#include <string>
 #include <vector>
 
 namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        // With work stealing, loops are split into more tasks than threads, so idle threads have something to steal
+        const int workStealingTasksPerThread = 4;
+
+        ParallelLoopSchedule GetSchedule(const ParallelLoopOptions& options, const CompilerOptions& compilerSettings)
+        {
+            auto schedule = options.schedule == ParallelLoopSchedule::automatic ? compilerSettings.parallelLoopSchedule : options.schedule;
+            return schedule == ParallelLoopSchedule::automatic ? ParallelLoopSchedule::staticBlocks : schedule;
+        }
+
+        int GetDefaultNumTasks(const CompilerOptions& compilerSettings, ParallelLoopSchedule schedule)
+        {
+            // Dynamic and guided schedules balance the load themselves, so they need only one task per thread
+            if (schedule != ParallelLoopSchedule::staticBlocks)
+            {
+                return compilerSettings.maxThreads;
+            }
+            return (compilerSettings.useThreadPool && compilerSettings.useWorkStealing) ? compilerSettings.maxThreads * workStealingTasksPerThread : compilerSettings.maxThreads;
+        }
+    } // namespace
+
     IRParallelForLoopEmitter::IRParallelForLoopEmitter(IRFunctionEmitter& functionEmitter) :
         _functionEmitter(functionEmitter) {}
 
@@ -31,7 +55,7 @@ namespace emitters
         ParallelLoopOptions newOptions = options;
         if (newOptions.numTasks == 0)
         {
-            newOptions.numTasks = std::min(numIterations, compilerSettings.maxThreads);
+            newOptions.numTasks = std::min(numIterations, GetDefaultNumTasks(compilerSettings, GetSchedule(options, compilerSettings)));
         }
         EmitLoop(_functionEmitter.LocalScalar<int32_t>(begin), _functionEmitter.LocalScalar<int32_t>(end), _functionEmitter.LocalScalar<int32_t>(increment), newOptions, capturedValues, body);
     }
@@ -39,13 +63,19 @@ namespace emitters
     void IRParallelForLoopEmitter::EmitLoop(IRLocalScalar begin, IRLocalScalar end, IRLocalScalar increment, const ParallelLoopOptions& options, const std::vector<LLVMValue>& capturedValues, BodyFunction body)
     {
         auto compilerSettings = _functionEmitter.GetCompilerOptions();
-        const int numTasks = options.numTasks == 0 ? compilerSettings.maxThreads : options.numTasks;
+        const auto schedule = GetSchedule(options, compilerSettings);
+        const int numTasks = options.numTasks == 0 ? GetDefaultNumTasks(compilerSettings, schedule) : options.numTasks;
         auto span = end - begin;
         auto numIterations = (span - 1) / increment + 1;
         // TODO: explicitly check for empty loop?
 
         auto taskSize = (numIterations - 1) / numTasks + 1;
-        if (compilerSettings.parallelize && numTasks > 1)
+        if (compilerSettings.parallelize && numTasks > 1 && schedule != ParallelLoopSchedule::staticBlocks)
+        {
+            const int chunkSize = std::max(options.chunkSize == 0 ? compilerSettings.parallelLoopChunkSize : options.chunkSize, 1);
+            EmitChunkedLoop(begin, increment, numIterations, numTasks, schedule, chunkSize, capturedValues, body);
+        }
+        else if (compilerSettings.parallelize && numTasks > 1)
         {
             auto taskFunction = GetTaskFunction(capturedValues, body);
 
@@ -70,6 +100,25 @@ namespace emitters
         }
     }
 
+    void IRParallelForLoopEmitter::EmitChunkedLoop(IRLocalScalar begin, IRLocalScalar increment, IRLocalScalar numIterations, int numTasks, ParallelLoopSchedule schedule, int chunkSize, const std::vector<LLVMValue>& capturedValues, BodyFunction body)
+    {
+        // The tasks claim chunks of iterations from a shared counter of the iterations handed out so far. It can live on
+        // the stack, because this function waits for the tasks to finish.
+        auto nextIterationVar = _functionEmitter.Variable(VariableType::Int32, "nextIteration");
+        _functionEmitter.Store(nextIterationVar, _functionEmitter.Literal<int>(0));
+
+        auto taskFunction = GetChunkedTaskFunction(numTasks, schedule, chunkSize, capturedValues, body);
+        std::vector<std::vector<LLVMValue>> taskArgs;
+        for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+        {
+            std::vector<LLVMValue> args{ begin, increment, numIterations, nextIterationVar };
+            std::copy(capturedValues.begin(), capturedValues.end(), std::back_inserter(args));
+            taskArgs.push_back(args);
+        }
+        auto tasks = _functionEmitter.StartTasks(taskFunction, taskArgs);
+        tasks.WaitAll(_functionEmitter);
+    }
+
     IRFunctionEmitter IRParallelForLoopEmitter::GetTaskFunction(const std::vector<LLVMValue>& capturedValues, BodyFunction body)
     {
         std::string name = "parForTask";
@@ -102,5 +151,84 @@ namespace emitters
         _functionEmitter.GetModule().EndFunction();
         return taskFunction;
     }
+
+    IRFunctionEmitter IRParallelForLoopEmitter::GetChunkedTaskFunction(int numTasks, ParallelLoopSchedule schedule, int chunkSize, const std::vector<LLVMValue>& capturedValues, BodyFunction body)
+    {
+        std::string name = "parForChunkedTask";
+
+        // args = begin, increment, number of iterations, pointer to the next unclaimed iteration, captured args
+        auto& irEmitter = _functionEmitter.GetModule().GetIREmitter();
+        auto returnType = irEmitter.Type(VariableType::Void);
+        auto argTypes = irEmitter.GetLLVMTypes({ VariableType::Int32, VariableType::Int32, VariableType::Int32, VariableType::Int32Pointer });
+        auto capturedTypes = GetLLVMTypes(capturedValues);
+        std::copy(capturedTypes.begin(), capturedTypes.end(), std::back_inserter(argTypes));
+        auto taskFunction = _functionEmitter.GetModule().BeginFunction(name, returnType, argTypes);
+
+        {
+            auto arguments = taskFunction.Arguments().begin();
+            auto begin = taskFunction.LocalScalar(&(*arguments++));
+            auto increment = taskFunction.LocalScalar(&(*arguments++));
+            auto numIterations = taskFunction.LocalScalar(&(*arguments++));
+            LLVMValue nextIterationPtr = &(*arguments++);
+            std::vector<LLVMValue> innerCapturedValues;
+            int numCapturedValues = static_cast<int>(capturedValues.size());
+            for (int index = 0; index < numCapturedValues; ++index)
+            {
+                auto capturedValue = &(*arguments++);
+                capturedValue->setName("captured_" + std::to_string(index));
+                innerCapturedValues.push_back(capturedValue);
+            }
+
+            auto& context = taskFunction.GetLLVMContext();
+            auto boolType = llvm::Type::getInt1Ty(context);
+            auto chunkBeginVar = taskFunction.Variable(VariableType::Int32, "chunkBegin");
+            auto chunkEndVar = taskFunction.Variable(VariableType::Int32, "chunkEnd");
+            auto keepGoingVar = taskFunction.Variable(boolType, "keepGoing");
+            taskFunction.Store(keepGoingVar, taskFunction.TrueBit());
+            taskFunction.While(keepGoingVar, [=](IRFunctionEmitter& taskFunction) {
+                if (schedule == ParallelLoopSchedule::dynamic)
+                {
+                    auto chunkBegin = taskFunction.LocalScalar(taskFunction.AtomicAdd(nextIterationPtr, taskFunction.Literal<int>(chunkSize)));
+                    taskFunction.Store(chunkBeginVar, chunkBegin);
+                    taskFunction.Store(chunkEndVar, Min(chunkBegin + chunkSize, numIterations));
+                }
+                else
+                {
+                    // The chunk size depends on how many iterations are left, so the counter is advanced with a compare-and-exchange
+                    auto retryVar = taskFunction.Variable(boolType, "retry");
+                    taskFunction.Store(retryVar, taskFunction.TrueBit());
+                    taskFunction.While(retryVar, [=](IRFunctionEmitter& taskFunction) {
+                        auto next = taskFunction.LocalScalar(taskFunction.AtomicLoad(nextIterationPtr));
+                        auto remaining = numIterations - next;
+                        taskFunction.If(remaining <= 0, [=](IRFunctionEmitter& taskFunction) {
+                                        taskFunction.Store(chunkBeginVar, next);
+                                        taskFunction.Store(retryVar, taskFunction.FalseBit());
+                                    })
+                            .Else([=](IRFunctionEmitter& taskFunction) {
+                                auto size = Max((remaining + (numTasks - 1)) / numTasks, chunkSize);
+                                auto chunkEnd = Min(next + size, numIterations);
+                                taskFunction.If(taskFunction.AtomicCompareExchange(nextIterationPtr, next, chunkEnd), [=](IRFunctionEmitter& taskFunction) {
+                                    taskFunction.Store(chunkBeginVar, next);
+                                    taskFunction.Store(chunkEndVar, chunkEnd);
+                                    taskFunction.Store(retryVar, taskFunction.FalseBit());
+                                });
+                            });
+                    });
+                }
+
+                auto chunkBegin = taskFunction.LocalScalar(taskFunction.Load(chunkBeginVar));
+                taskFunction.If(chunkBegin >= numIterations, [=](IRFunctionEmitter& taskFunction) {
+                                taskFunction.Store(keepGoingVar, taskFunction.FalseBit());
+                            })
+                    .Else([=](IRFunctionEmitter& taskFunction) {
+                        taskFunction.For(chunkBegin, taskFunction.Load(chunkEndVar), taskFunction.Literal<int>(1), [=](IRFunctionEmitter& taskFunction, LLVMValue i) {
+                            body(taskFunction, begin + taskFunction.LocalScalar(i) * increment, innerCapturedValues);
+                        });
+                    });
+            });
+        }
+        _functionEmitter.GetModule().EndFunction();
+        return taskFunction;
+    }
 } // namespace emitters
 } // namespace ell
@@ -80,6 +80,19 @@ namespace emitters
         return GetTimespecType()->getPointerTo();
     }
 
+    //
+    // memory
+    //
+
+    LLVMFunction IRPosixRuntime::GetMadviseFunction()
+    {
+        // Signature: int madvise(void* addr, size_t length, int advice);
+        auto& context = _module.GetLLVMContext();
+        auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto functionType = llvm::FunctionType::get(GetIntType(), { int8PtrType, GetPointerSizedIntType(), GetIntType() }, false);
+        return static_cast<LLVMFunction>(_module.GetLLVMModule()->getOrInsertFunction("madvise", functionType));
+    }
+
     //
     // pthreads -- types
     //
@@ -333,6 +346,17 @@ namespace emitters
         return static_cast<LLVMFunction>(_module.GetLLVMModule()->getOrInsertFunction("pthread_self", functionType));
     }
 
+    LLVMFunction IRPosixRuntime::GetPthreadSetAffinityFunction()
+    {
+        // Signature: int pthread_setaffinity_np(pthread_t thread, size_t cpusetsize, const cpu_set_t* cpuset);
+        auto& context = _module.GetLLVMContext();
+        auto pthreadType = GetPthreadType();
+        auto intType = GetIntType();
+        auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto functionType = llvm::FunctionType::get(intType, { pthreadType, GetPointerSizedIntType(), int8PtrType }, false);
+        return static_cast<LLVMFunction>(_module.GetLLVMModule()->getOrInsertFunction("pthread_setaffinity_np", functionType));
+    }
+
     //
     // pthreads -- synchronization functions
     //
@@ -11,10 +11,14 @@
 #include "IRFunctionEmitter.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
+#include "IRReentrancy.h"
 #include "LLVMUtilities.h"
 
 #include <utilities/include/UniqueId.h>
 
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/InlineAsm.h>
+
 #include <algorithm>
 #include <functional>
 #include <iterator>
@@ -31,9 +35,85 @@ namespace emitters
         {
             count = 0,
             totalTime = 1,
-            name = 2
+            name = 2,
+            cycles = 3,
+            instructions = 4,
+            l1CacheMisses = 5,
+            lastLevelCacheMisses = 6,
+            branchMisses = 7
         };
-    }
+
+        // The hardware counters occupy consecutive fields of the region info struct, starting with `cycles`
+        const int c_numHardwareCounters = 5;
+
+        // The perf_event configuration for each hardware counter, in the same order as the region info fields.
+        // Values are from linux/perf_event.h
+        struct PerfEventConfig
+        {
+            uint32_t type;
+            uint64_t config;
+        };
+
+        const uint32_t c_perfTypeHardware = 0; // PERF_TYPE_HARDWARE
+        const uint32_t c_perfTypeHardwareCache = 3; // PERF_TYPE_HW_CACHE
+        const PerfEventConfig c_perfEvents[c_numHardwareCounters] = {
+            { c_perfTypeHardware, 0 }, // PERF_COUNT_HW_CPU_CYCLES
+            { c_perfTypeHardware, 1 }, // PERF_COUNT_HW_INSTRUCTIONS
+            { c_perfTypeHardwareCache, 0x10000 }, // PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+            { c_perfTypeHardware, 3 }, // PERF_COUNT_HW_CACHE_MISSES (last-level cache)
+            { c_perfTypeHardware, 5 } // PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        // We only fill in the fields of the original (PERF_ATTR_SIZE_VER0) perf_event_attr struct, viewed as an array of 64-bit words:
+        // word 0 holds `type` and `size`, word 1 `config`, word 4 `read_format` and word 5 the flag bits
+        const int c_perfEventAttrSize = 64;
+        const int c_perfEventAttrWords = c_perfEventAttrSize / 8;
+        const uint64_t c_perfFormatGroup = 1 << 3; // PERF_FORMAT_GROUP
+        const uint64_t c_perfExcludeKernelAndHypervisor = (1 << 5) | (1 << 6); // exclude_kernel | exclude_hv
+
+        // Value of the group file descriptor before we've tried to open the counters
+        const int c_perfEventsNotOpened = -2;
+
+        enum class HardwareCounterSource
+        {
+            perfEvent,
+            armCycleCounter
+        };
+
+        HardwareCounterSource GetHardwareCounterSource(const TargetDevice& target)
+        {
+            if (target.IsLinux())
+            {
+                return HardwareCounterSource::perfEvent;
+            }
+
+            // Without an OS to manage the PMU, we can only read the cycle counter (which must have been enabled for user mode)
+            auto arch = llvm::Triple(target.triple).getArch();
+            if (arch == llvm::Triple::aarch64 || arch == llvm::Triple::arm)
+            {
+                return HardwareCounterSource::armCycleCounter;
+            }
+            throw EmitterException(EmitterError::targetNotSupported, "Hardware performance counters require Linux or an ARM target with a PMU");
+        }
+
+        int64_t GetPerfEventOpenSyscallNumber(const TargetDevice& target)
+        {
+            switch (llvm::Triple(target.triple).getArch())
+            {
+            case llvm::Triple::x86_64:
+                return 298;
+            case llvm::Triple::x86:
+                return 336;
+            case llvm::Triple::aarch64:
+                return 241;
+            case llvm::Triple::arm:
+            case llvm::Triple::thumb:
+                return 364;
+            default:
+                throw EmitterException(EmitterError::targetNotSupported, "perf_event_open is not supported for target " + target.triple);
+            }
+        }
+    } // namespace
 
     //
     // IRProfileRegionBlock
@@ -102,6 +182,8 @@ namespace emitters
 
         assert(_module != nullptr);
 
+        _hardwareCountersEnabled = _module->GetCompilerOptions().profileHardwareCounters;
+
         _module->DeclarePrintf();
         CreateStructTypes();
         CreateRegionData();
@@ -123,6 +205,11 @@ namespace emitters
         return GetNamespacePrefix() + "_ResetRegionProfilingInfo";
     }
 
+    std::string IRProfiler::GetReadHardwareCountersFunctionName() const
+    {
+        return GetNamespacePrefix() + "_ReadHardwareCounters";
+    }
+
     std::string IRProfiler::GetNamespacePrefix() const
     {
         return _module->GetModuleName();
@@ -139,6 +226,12 @@ namespace emitters
         return function.LocalScalar(time);
     }
 
+    void IRProfiler::ReadHardwareCounters(IRFunctionEmitter& function, LLVMValue counters)
+    {
+        assert(_readHardwareCountersFunction != nullptr);
+        function.Call(_readHardwareCountersFunction, { counters });
+    }
+
     void IRProfiler::InitRegion(IRProfileRegion& region, const std::string& desiredName)
     {
         if (!_profilingEnabled)
@@ -171,6 +264,17 @@ namespace emitters
         auto countPtr = function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::count));
         auto count = function.LocalScalar(function.Load(countPtr));
         function.Store(countPtr, count + static_cast<int64_t>(1));
+
+        // Read the counters last, so the bookkeeping above isn't included in the region's counts
+        if (_hardwareCountersEnabled)
+        {
+            if (region._startCounters == nullptr)
+            {
+                region._startCounters = function.Variable(VariableType::Int64, c_numHardwareCounters);
+                region._endCounters = function.Variable(VariableType::Int64, c_numHardwareCounters);
+            }
+            ReadHardwareCounters(function, region._startCounters);
+        }
     }
 
     void IRProfiler::ExitRegion(IRProfileRegion& region)
@@ -178,8 +282,13 @@ namespace emitters
         if (!_profilingEnabled)
             return;
 
-        // Increment stored time
         auto& function = region.GetFunction();
+        if (_hardwareCountersEnabled)
+        {
+            ReadHardwareCounters(function, region._endCounters);
+        }
+
+        // Increment stored time
         auto regionPtr = GetRegionPointer(function, region.GetIndex());
         auto timePtr = function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::totalTime));
         auto startTime = region.GetStartTime();
@@ -187,6 +296,19 @@ namespace emitters
         auto storedTime = function.LocalArray(timePtr);
         storedTime[0] = storedTime[0] + newTime;
 
+        // Accumulate hardware counter deltas
+        if (_hardwareCountersEnabled)
+        {
+            auto startCounters = function.LocalArray(region._startCounters);
+            auto endCounters = function.LocalArray(region._endCounters);
+            for (int index = 0; index < c_numHardwareCounters; ++index)
+            {
+                auto counterPtr = function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::cycles) + index);
+                auto storedCounter = function.LocalArray(counterPtr);
+                storedCounter[0] = storedCounter[0] + (endCounters[index] - startCounters[index]);
+            }
+        }
+
         // reset start time to "unassigned"
         region.SetStartTime(function.LocalScalar());
     }
@@ -202,6 +324,10 @@ namespace emitters
         auto timePtr = function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::totalTime));
         function.StoreZero(countPtr);
         function.StoreZero(timePtr);
+        for (int index = 0; index < c_numHardwareCounters; ++index)
+        {
+            function.StoreZero(function.GetStructFieldPointer(regionPtr, static_cast<size_t>(RegionInfoFields::cycles) + index));
+        }
     }
 
     std::string IRProfiler::GetUniqueRegionName(const std::string& desiredName) const
@@ -239,7 +365,14 @@ namespace emitters
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
 
         // ProfileRegionInfo struct fields
-        emitters::NamedLLVMTypeList infoFields = { { "count", int64Type }, { "totalTime", doubleType }, { "name", int8PtrType } };
+        emitters::NamedLLVMTypeList infoFields = { { "count", int64Type },
+                                                   { "totalTime", doubleType },
+                                                   { "name", int8PtrType },
+                                                   { "cycles", int64Type },
+                                                   { "instructions", int64Type },
+                                                   { "l1CacheMisses", int64Type },
+                                                   { "lastLevelCacheMisses", int64Type },
+                                                   { "branchMisses", int64Type } };
         _profileRegionType = _module->GetOrCreateStruct(GetNamespacePrefix() + "_ProfileRegionInfo", infoFields);
         _module->IncludeTypeInHeader(_profileRegionType->getName());
     }
@@ -255,12 +388,17 @@ namespace emitters
         EmitGetNumRegionsFunction();
         EmitGetRegionProfilingInfoFunction();
         EmitResetRegionProfilingInfoFunction();
+        if (_hardwareCountersEnabled)
+        {
+            EmitReadHardwareCountersFunction();
+        }
     }
 
     void IRProfiler::CreateRegionData()
     {
         assert(_profileRegionsArray == nullptr);
         _profileRegionsArray = _module->GlobalArray(GetNamespacePrefix() + "_profileprofileRegionsArray_" + std::to_string(_regionCount), _profileRegionType, _regionCount);
+        MarkGlobalShared(*_profileRegionsArray);
     }
 
     void IRProfiler::ReallocateRegionData()
@@ -269,6 +407,7 @@ namespace emitters
 
         // reallocate the global array --- we use a new name to avoid having LLVM just give us back the existing one
         auto profileRegionsArray = _module->GlobalArray(GetNamespacePrefix() + "_profileprofileRegionsArray_" + std::to_string(_regionCount), _profileRegionType, _regionCount);
+        MarkGlobalShared(*profileRegionsArray);
         if (_profileRegionsArray != profileRegionsArray)
         {
             if (_profileRegionsArray != nullptr)
@@ -377,6 +516,130 @@ namespace emitters
         _module->EndFunction();
     }
 
+    void IRProfiler::EmitReadHardwareCountersFunction()
+    {
+        auto source = GetHardwareCounterSource(_module->GetCompilerOptions().targetDevice);
+
+        const emitters::NamedVariableTypeList parameters = { { "counters", emitters::VariableType::Int64Pointer } };
+        auto function = _module->BeginFunction(GetReadHardwareCountersFunctionName(), VariableType::Void, parameters);
+        auto counters = function.GetFunctionArgument("counters");
+        function.StoreZero(counters, c_numHardwareCounters);
+        if (source == HardwareCounterSource::perfEvent)
+        {
+            EmitReadPerfEventCounters(function, counters);
+        }
+        else
+        {
+            EmitReadArmCycleCounter(function, counters);
+        }
+        function.Return();
+        _module->EndFunction();
+        _readHardwareCountersFunction = function.GetFunction();
+    }
+
+    // The counters are opened as a single perf_event group on the first call, so that one `read` returns all of them, measured over
+    // the same interval. Counters the kernel or CPU doesn't support are left out of the group (and read as zero); if even the cycle
+    // counter can't be opened (e.g., because of perf_event_paranoid settings) all of the counters read as zero.
+    void IRProfiler::EmitReadPerfEventCounters(IRFunctionEmitter& function, LLVMValue counters)
+    {
+        const auto& target = _module->GetCompilerOptions().targetDevice;
+        auto& context = _module->GetLLVMContext();
+        auto int32Type = llvm::Type::getInt32Ty(context);
+        auto longType = llvm::Type::getIntNTy(context, target.numBits == 64 ? 64 : 32);
+        auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+
+        // long syscall(long number, ...);
+        // ssize_t read(int fd, void* buf, size_t count);
+        auto syscallFunction = _module->DeclareFunction("syscall", llvm::FunctionType::get(longType, { longType }, true));
+        auto readFunction = _module->DeclareFunction("read", llvm::FunctionType::get(longType, { int32Type, int8PtrType, longType }, false));
+
+        // The group's file descriptor, and the position of each counter in the values returned by `read` (or 0 if it isn't in the group)
+        auto groupFdGlobal = _module->Global<int>(GetNamespacePrefix() + "_perfEventGroupFd", c_perfEventsNotOpened);
+        auto slotsGlobal = _module->GlobalArray(VariableType::Int32, GetNamespacePrefix() + "_perfEventSlots", c_numHardwareCounters);
+        MarkGlobalShared(*groupFdGlobal);
+        MarkGlobalShared(*slotsGlobal);
+
+        auto syscallNumber = llvm::ConstantInt::get(longType, GetPerfEventOpenSyscallNumber(target));
+        function.If(TypedComparison::equals, function.Load(groupFdGlobal), function.Literal<int>(c_perfEventsNotOpened), [=](IRFunctionEmitter& function) {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto attr = function.Variable(VariableType::Int64, c_perfEventAttrWords);
+            auto groupFd = function.Variable(VariableType::Int32, "groupFd");
+            auto numOpened = function.Variable(VariableType::Int32, "numOpened");
+            function.Store(groupFd, function.Literal<int>(-1));
+            function.StoreZero(numOpened);
+
+            for (int index = 0; index < c_numHardwareCounters; ++index)
+            {
+                auto openEvent = [=, &irBuilder](IRFunctionEmitter& function) {
+                    const auto& event = c_perfEvents[index];
+                    function.StoreZero(attr, c_perfEventAttrWords);
+                    function.SetValueAt(attr, 0, function.Literal<int64_t>(event.type | (static_cast<uint64_t>(c_perfEventAttrSize) << 32)));
+                    function.SetValueAt(attr, 1, function.Literal<int64_t>(event.config));
+                    function.SetValueAt(attr, 4, function.Literal<int64_t>(c_perfFormatGroup));
+                    function.SetValueAt(attr, 5, function.Literal<int64_t>(c_perfExcludeKernelAndHypervisor));
+
+                    // perf_event_open(&attr, pid = 0 (this thread), cpu = -1 (any), group_fd, flags = 0)
+                    auto result = function.Call(syscallFunction, { syscallNumber, function.CastPointer(attr, int8PtrType), function.Literal<int>(0), function.Literal<int>(-1), function.Load(groupFd), llvm::ConstantInt::get(longType, 0) });
+                    auto fd = irBuilder.CreateTrunc(result, int32Type);
+                    function.If(TypedComparison::greaterThanOrEquals, fd, function.Literal<int>(0), [=](IRFunctionEmitter& function) {
+                        if (index == 0)
+                        {
+                            function.Store(groupFd, fd);
+                        }
+                        auto slot = function.LocalScalar(function.Load(numOpened)) + 1;
+                        function.SetValueAt(slotsGlobal, function.Literal<int>(index), slot);
+                        function.Store(numOpened, slot);
+                    });
+                };
+
+                // The remaining counters are only useful as members of the cycle counter's group
+                if (index == 0)
+                {
+                    openEvent(function);
+                }
+                else
+                {
+                    function.If(TypedComparison::greaterThanOrEquals, function.Load(groupFd), function.Literal<int>(0), openEvent);
+                }
+            }
+            function.Store(groupFdGlobal, function.Load(groupFd));
+        });
+
+        function.If(TypedComparison::greaterThanOrEquals, function.Load(groupFdGlobal), function.Literal<int>(0), [=](IRFunctionEmitter& function) {
+            // The group read format is { u64 nr; u64 values[nr]; }
+            auto values = function.Variable(VariableType::Int64, c_numHardwareCounters + 1);
+            function.StoreZero(values, c_numHardwareCounters + 1);
+            function.Call(readFunction, { function.Load(groupFdGlobal), function.CastPointer(values, int8PtrType), llvm::ConstantInt::get(longType, (c_numHardwareCounters + 1) * 8) });
+            for (int index = 0; index < c_numHardwareCounters; ++index)
+            {
+                auto slot = function.ValueAt(slotsGlobal, function.Literal<int>(index));
+                auto value = function.Select(function.Comparison(TypedComparison::greaterThan, slot, function.Literal<int>(0)), function.ValueAt(values, slot), function.Literal<int64_t>(0));
+                function.SetValueAt(counters, index, value);
+            }
+        });
+    }
+
+    // The cycle counter is the only PMU counter we can read without first programming the event counters, which needs privileged code
+    void IRProfiler::EmitReadArmCycleCounter(IRFunctionEmitter& function, LLVMValue counters)
+    {
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+        auto arch = llvm::Triple(_module->GetCompilerOptions().targetDevice.triple).getArch();
+        LLVMValue cycles = nullptr;
+        if (arch == llvm::Triple::aarch64)
+        {
+            auto readType = llvm::FunctionType::get(irBuilder.getInt64Ty(), false);
+            cycles = irBuilder.CreateCall(llvm::InlineAsm::get(readType, "mrs $0, pmccntr_el0", "=r", true));
+        }
+        else
+        {
+            // PMCCNTR is only 32 bits wide on ARMv7, so the count wraps after a few seconds
+            auto readType = llvm::FunctionType::get(irBuilder.getInt32Ty(), false);
+            auto cycles32 = irBuilder.CreateCall(llvm::InlineAsm::get(readType, "mrc p15, 0, $0, c9, c13, 0", "=r", true));
+            cycles = irBuilder.CreateZExt(cycles32, irBuilder.getInt64Ty());
+        }
+        function.SetValueAt(counters, 0, cycles); // cycles are the first counter
+    }
+
     LLVMValue IRProfiler::GetRegionBuffer(IRFunctionEmitter& function)
     {
         assert(_getRegionBufferFunction != nullptr);
@@ -0,0 +1,436 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRReentrancy.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRReentrancy.h"
+#include "EmitterException.h"
+#include "IRMetadata.h"
+#include "IRModuleEmitter.h"
+#include "LLVMUtilities.h"
+
+#include <utilities/include/Logger.h>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        // Every field of the state is aligned to a cache line, which is also enough for any vector load or store emitted code does
+        constexpr uint64_t c_stateFieldAlignment = 64;
+
+        struct StateField
+        {
+            llvm::GlobalVariable* global;
+            unsigned index; // index of the field in the state struct
+        };
+
+        struct FunctionWithState
+        {
+            llvm::Function* original;
+            llvm::Function* withState;
+            bool isPublic; // public functions keep their original signature, using the default state
+        };
+
+        struct StateLayout
+        {
+            llvm::StructType* type = nullptr;
+            std::vector<StateField> fields;
+            uint64_t size = 0;
+        };
+
+        bool IsStateGlobal(const llvm::GlobalVariable& global)
+        {
+            return !global.isConstant() && !global.isDeclaration() && !global.getName().startswith("llvm.") && !IsGlobalShared(global);
+        }
+
+        StateLayout CreateStateLayout(IRModuleEmitter& module, const std::vector<llvm::GlobalVariable*>& globals)
+        {
+            auto& context = module.GetLLVMContext();
+            const auto& dataLayout = module.GetTargetDataLayout();
+            auto byteType = llvm::Type::getInt8Ty(context);
+
+            // The fields are laid out explicitly, with padding, in a packed struct
+            StateLayout layout;
+            std::vector<llvm::Type*> fieldTypes;
+            auto addPadding = [&](uint64_t alignment) {
+                auto alignedSize = llvm::alignTo(layout.size, alignment);
+                if (alignedSize != layout.size)
+                {
+                    fieldTypes.push_back(llvm::ArrayType::get(byteType, alignedSize - layout.size));
+                    layout.size = alignedSize;
+                }
+            };
+
+            for (auto global : globals)
+            {
+                auto type = global->getValueType();
+                addPadding(std::max<uint64_t>({ c_stateFieldAlignment, static_cast<uint64_t>(global->getAlignment()), static_cast<uint64_t>(dataLayout.getABITypeAlignment(type)) }));
+                layout.fields.push_back({ global, static_cast<unsigned>(fieldTypes.size()) });
+                fieldTypes.push_back(type);
+                layout.size += dataLayout.getTypeAllocSize(type);
+            }
+            addPadding(c_stateFieldAlignment);
+
+            layout.type = llvm::StructType::create(context, fieldTypes, module.GetModuleName() + "_State", true);
+            assert(dataLayout.getTypeAllocSize(layout.type) == layout.size);
+            return layout;
+        }
+
+        // Returns the functions that use the state globals, directly or through the functions they call
+        std::vector<llvm::Function*> GetFunctionsUsingState(llvm::Module& module, const std::vector<llvm::GlobalVariable*>& globals, llvm::Function* resetFunction)
+        {
+            std::set<llvm::Function*> result;
+            std::vector<llvm::Function*> worklist;
+            auto add = [&](llvm::Function* function) {
+                if (result.insert(function).second)
+                {
+                    worklist.push_back(function);
+                }
+            };
+
+            for (auto global : globals)
+            {
+                for (auto user : global->users())
+                {
+                    add(llvm::cast<llvm::Instruction>(user)->getFunction());
+                }
+            }
+            if (resetFunction != nullptr)
+            {
+                add(resetFunction);
+            }
+
+            while (!worklist.empty())
+            {
+                auto function = worklist.back();
+                worklist.pop_back();
+                for (auto user : function->users())
+                {
+                    auto call = llvm::dyn_cast<llvm::CallInst>(user);
+                    if (call != nullptr && call->getCalledFunction() == function)
+                    {
+                        add(call->getFunction());
+                    }
+                }
+            }
+
+            // Return the functions in module order, so the output doesn't depend on pointer values
+            std::vector<llvm::Function*> ordered;
+            for (auto& function : module)
+            {
+                if (result.count(&function) != 0)
+                {
+                    ordered.push_back(&function);
+                }
+            }
+            return ordered;
+        }
+
+        // Shifts the parameter attributes to make room for the state argument
+        llvm::AttributeList AddStateParameterAttributes(llvm::LLVMContext& context, const llvm::AttributeList& attributes, unsigned numParameters)
+        {
+            std::vector<llvm::AttributeSet> parameterAttributes = { llvm::AttributeSet() };
+            for (unsigned index = 0; index < numParameters; ++index)
+            {
+                parameterAttributes.push_back(attributes.getParamAttributes(index));
+            }
+            return llvm::AttributeList::get(context, attributes.getFnAttributes(), attributes.getRetAttributes(), parameterAttributes);
+        }
+
+        llvm::Function* CreateFunctionWithState(llvm::Function& function, const std::string& name)
+        {
+            auto& context = function.getContext();
+            auto functionType = function.getFunctionType();
+            std::vector<llvm::Type*> parameterTypes = { llvm::Type::getInt8PtrTy(context) };
+            parameterTypes.insert(parameterTypes.end(), functionType->param_begin(), functionType->param_end());
+            auto newType = llvm::FunctionType::get(functionType->getReturnType(), parameterTypes, functionType->isVarArg());
+
+            auto newFunction = llvm::Function::Create(newType, function.getLinkage(), name, function.getParent());
+            newFunction->setCallingConv(function.getCallingConv());
+            newFunction->setAttributes(AddStateParameterAttributes(context, function.getAttributes(), functionType->getNumParams()));
+            newFunction->addParamAttr(0, llvm::Attribute::NoAlias);
+            newFunction->arg_begin()->setName("state");
+
+            // Move the body over
+            newFunction->getBasicBlockList().splice(newFunction->begin(), function.getBasicBlockList());
+            auto newArg = newFunction->arg_begin() + 1;
+            for (auto& arg : function.args())
+            {
+                arg.replaceAllUsesWith(&*newArg);
+                newArg->takeName(&arg);
+                ++newArg;
+            }
+            return newFunction;
+        }
+
+        void RedirectCalls(llvm::Function& function, llvm::Function& functionWithState, bool keepOtherUses)
+        {
+            std::vector<llvm::User*> users(function.user_begin(), function.user_end());
+            for (auto user : users)
+            {
+                auto call = llvm::dyn_cast<llvm::CallInst>(user);
+                if (call == nullptr || call->getCalledFunction() != &function)
+                {
+                    if (keepOtherUses)
+                    {
+                        continue;
+                    }
+                    throw EmitterException(EmitterError::notSupported, "Can't emit reentrant code for function " + function.getName().str() + ", because its address is taken");
+                }
+
+                // Every caller is itself a function with state, which gets it as its first argument
+                auto caller = call->getFunction();
+                std::vector<llvm::Value*> args = { &*caller->arg_begin() };
+                args.insert(args.end(), call->arg_begin(), call->arg_end());
+                auto newCall = llvm::CallInst::Create(&functionWithState, args, "", call);
+                newCall->setCallingConv(call->getCallingConv());
+                newCall->setTailCallKind(call->getTailCallKind());
+                newCall->setAttributes(AddStateParameterAttributes(call->getContext(), call->getAttributes(), call->getNumArgOperands()));
+                newCall->setDebugLoc(call->getDebugLoc());
+                newCall->takeName(call);
+                call->replaceAllUsesWith(newCall);
+                call->eraseFromParent();
+            }
+        }
+
+        // Replaces the body of a public function with a call to its reentrant version, using the default state
+        void EmitDefaultStateWrapper(llvm::Function& function, llvm::Function& functionWithState, llvm::GlobalVariable& defaultState)
+        {
+            llvm::IRBuilder<> irBuilder(llvm::BasicBlock::Create(function.getContext(), "entry", &function));
+            std::vector<llvm::Value*> args = { irBuilder.CreatePointerCast(&defaultState, irBuilder.getInt8PtrTy()) };
+            for (auto& arg : function.args())
+            {
+                args.push_back(&arg);
+            }
+            auto result = irBuilder.CreateCall(&functionWithState, args);
+            if (function.getReturnType()->isVoidTy())
+            {
+                irBuilder.CreateRetVoid();
+            }
+            else
+            {
+                irBuilder.CreateRet(result);
+            }
+        }
+
+        // Replaces the uses of the state globals with pointers into the state argument of the function using them
+        void ReplaceGlobalsWithStateFields(const StateLayout& layout)
+        {
+            std::map<llvm::Function*, llvm::Value*> typedStatePointers;
+            for (const auto& field : layout.fields)
+            {
+                std::map<llvm::Function*, llvm::Value*> fieldPointers;
+                std::vector<llvm::User*> users(field.global->user_begin(), field.global->user_end());
+                for (auto user : users)
+                {
+                    auto instruction = llvm::cast<llvm::Instruction>(user);
+                    auto function = instruction->getFunction();
+                    auto& fieldPointer = fieldPointers[function];
+                    if (fieldPointer == nullptr)
+                    {
+                        auto& entryBlock = function->getEntryBlock();
+                        llvm::IRBuilder<> irBuilder(&entryBlock, entryBlock.getFirstInsertionPt());
+                        auto& statePointer = typedStatePointers[function];
+                        if (statePointer == nullptr)
+                        {
+                            statePointer = irBuilder.CreatePointerCast(&*function->arg_begin(), layout.type->getPointerTo(), "typedState");
+                        }
+                        else if (auto stateInstruction = llvm::dyn_cast<llvm::Instruction>(statePointer))
+                        {
+                            irBuilder.SetInsertPoint(stateInstruction->getNextNode());
+                        }
+                        fieldPointer = irBuilder.CreateConstInBoundsGEP2_32(layout.type, statePointer, 0, field.index, field.global->getName());
+                    }
+                    instruction->replaceUsesOfWith(field.global, fieldPointer);
+                }
+            }
+        }
+
+        void EmitStateFunctions(IRModuleEmitter& module, const StateLayout& layout, const std::map<llvm::GlobalVariable*, llvm::GlobalVariable*>& initialValues)
+        {
+            const auto prefix = module.GetModuleName();
+
+            auto& getSize = module.BeginFunction(prefix + "_GetStateSize", VariableType::Int64);
+            getSize.IncludeInHeader();
+            getSize.Return(getSize.Literal<int64_t>(layout.size));
+            module.EndFunction();
+
+            auto& getAlignment = module.BeginFunction(prefix + "_GetStateAlignment", VariableType::Int64);
+            getAlignment.IncludeInHeader();
+            getAlignment.Return(getAlignment.Literal<int64_t>(c_stateFieldAlignment));
+            module.EndFunction();
+
+            const auto& dataLayout = module.GetTargetDataLayout();
+            auto& initialize = module.BeginFunction(prefix + "_InitializeState", VariableType::Void, NamedVariableTypeList{ { "state", VariableType::BytePointer } });
+            initialize.IncludeInHeader();
+            {
+                auto& irBuilder = initialize.GetEmitter().GetIRBuilder();
+                auto state = initialize.CastPointer(initialize.GetFunctionArgument("state"), layout.type->getPointerTo());
+                for (const auto& field : layout.fields)
+                {
+                    auto fieldPointer = irBuilder.CreateConstInBoundsGEP2_32(layout.type, state, 0, field.index);
+                    auto size = initialize.Literal<int64_t>(dataLayout.getTypeAllocSize(field.global->getValueType()));
+                    auto initialValue = initialValues.find(field.global);
+                    if (initialValue == initialValues.end())
+                    {
+                        initialize.GetEmitter().MemorySet(fieldPointer, irBuilder.getInt8(0), size);
+                    }
+                    else
+                    {
+                        initialize.GetEmitter().MemoryCopy(initialValue->second, fieldPointer, size);
+                    }
+                }
+            }
+            initialize.Return();
+            module.EndFunction();
+        }
+    } // namespace
+
+    void MarkGlobalShared(llvm::GlobalVariable& global)
+    {
+        global.setMetadata(c_sharedGlobalTagName, llvm::MDNode::get(global.getContext(), {}));
+    }
+
+    bool IsGlobalShared(const llvm::GlobalVariable& global)
+    {
+        return global.getMetadata(c_sharedGlobalTagName) != nullptr;
+    }
+
+    std::string GetReentrantFunctionName(const std::string& functionName)
+    {
+        return functionName + "_reentrant";
+    }
+
+    void EmitReentrantFunctions(IRModuleEmitter& module)
+    {
+        auto& llvmModule = *module.GetLLVMModule();
+
+        std::vector<llvm::GlobalVariable*> stateGlobals;
+        for (auto& global : llvmModule.globals())
+        {
+            if (IsStateGlobal(global))
+            {
+                stateGlobals.push_back(&global);
+            }
+        }
+        for (auto global : stateGlobals)
+        {
+            ExpandConstantExpressionUses(*global);
+        }
+
+        auto layout = CreateStateLayout(module, stateGlobals);
+        Log() << "Moving " << stateGlobals.size() << " global variables into a " << layout.size << " byte reentrant state" << EOL;
+
+        // The default state is used by the functions that keep their original signatures
+        std::vector<llvm::Constant*> defaultStateValues;
+        for (auto fieldType : layout.type->elements())
+        {
+            defaultStateValues.push_back(llvm::Constant::getNullValue(fieldType));
+        }
+        for (const auto& field : layout.fields)
+        {
+            defaultStateValues[field.index] = field.global->getInitializer();
+        }
+        auto defaultState = new llvm::GlobalVariable(llvmModule, layout.type, false, llvm::GlobalValue::InternalLinkage, llvm::ConstantStruct::get(layout.type, defaultStateValues), module.GetModuleName() + "_defaultState");
+        defaultState->setAlignment(c_stateFieldAlignment);
+        MarkGlobalShared(*defaultState);
+
+        auto resetFunction = llvmModule.getFunction(module.GetModuleName() + "_Reset");
+        auto functions = GetFunctionsUsingState(llvmModule, stateGlobals, resetFunction);
+        std::vector<FunctionWithState> functionsWithState;
+        for (auto function : functions)
+        {
+            if (function->isVarArg())
+            {
+                throw EmitterException(EmitterError::notSupported, "Can't emit reentrant code for variadic function " + function->getName().str());
+            }
+
+            bool isPublic = function->getMetadata(c_declareFunctionInHeaderTagName) != nullptr;
+            auto name = function->getName().str();
+            auto functionWithState = CreateFunctionWithState(*function, isPublic ? GetReentrantFunctionName(name) : "");
+            if (isPublic)
+            {
+                // The original function stays in the header, with its metadata
+                module.InsertFunctionMetadata(functionWithState->getName().str(), c_declareFunctionInHeaderTagName, { "" });
+                functionWithState->setSubprogram(function->getSubprogram());
+                function->setSubprogram(nullptr);
+
+                const auto& declaration = module.GetFunctionDeclaration(name);
+                NamedVariableTypeList args = { { "state", VariableType::BytePointer } };
+                args.insert(args.end(), declaration.GetArguments().begin(), declaration.GetArguments().end());
+                auto& reentrantDeclaration = module.GetFunctionDeclaration(functionWithState->getName().str());
+                reentrantDeclaration = FunctionDeclaration(functionWithState->getName().str(), declaration.GetReturnType(), args);
+                reentrantDeclaration.GetComments() = declaration.GetComments();
+            }
+            else
+            {
+                llvm::SmallVector<std::pair<unsigned, llvm::MDNode*>, 4> metadata;
+                function->getAllMetadata(metadata);
+                for (const auto& entry : metadata)
+                {
+                    functionWithState->setMetadata(entry.first, entry.second);
+                }
+                functionWithState->takeName(function);
+            }
+            functionsWithState.push_back({ function, functionWithState, isPublic });
+        }
+
+        ReplaceGlobalsWithStateFields(layout);
+
+        for (const auto& entry : functionsWithState)
+        {
+            RedirectCalls(*entry.original, *entry.withState, entry.isPublic);
+            if (entry.isPublic)
+            {
+                EmitDefaultStateWrapper(*entry.original, *entry.withState, *defaultState);
+            }
+            else
+            {
+                entry.original->eraseFromParent();
+            }
+        }
+
+        // Keep the globals with initial values as constants, to initialize new states with
+        std::map<llvm::GlobalVariable*, llvm::GlobalVariable*> initialValues;
+        for (auto global : stateGlobals)
+        {
+            assert(global->use_empty());
+            if (global->getInitializer()->isNullValue())
+            {
+                continue;
+            }
+            global->setConstant(true);
+            global->setName(global->getName() + "_initialValue");
+            initialValues[global] = global;
+        }
+
+        EmitStateFunctions(module, layout, initialValues);
+
+        for (auto global : stateGlobals)
+        {
+            if (initialValues.count(global) == 0)
+            {
+                global->eraseFromParent();
+            }
+        }
+    }
+} // namespace emitters
+} // namespace ell
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRRingBuffer.cpp (emitters)
+//  Authors:  Lisa Ong
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRRingBuffer.h"
+#include "EmitterException.h"
+#include "IRFunctionEmitter.h"
+#include "IRModuleEmitter.h"
+#include "IRReentrancy.h"
+
+#include <llvm/IR/Instructions.h>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        LLVMValue LoadIndex(IRFunctionEmitter& function, llvm::GlobalVariable* index, llvm::AtomicOrdering ordering)
+        {
+            auto load = function.GetEmitter().GetIRBuilder().CreateLoad(index);
+            load->setAlignment(sizeof(int64_t));
+            load->setAtomic(ordering);
+            return load;
+        }
+
+        void StoreIndex(IRFunctionEmitter& function, llvm::GlobalVariable* index, LLVMValue value, llvm::AtomicOrdering ordering)
+        {
+            auto store = function.GetEmitter().GetIRBuilder().CreateStore(value, index);
+            store->setAlignment(sizeof(int64_t));
+            store->setAtomic(ordering);
+        }
+    } // namespace
+
+    IRRingBuffer::IRRingBuffer(IRModuleEmitter& module, const std::string& name, VariableType valueType, int frameSize, int capacity) :
+        _module(module),
+        _valueType(valueType),
+        _frameSize(frameSize),
+        _capacity(capacity)
+    {
+        if (frameSize <= 0 || capacity <= 0)
+        {
+            throw EmitterException(EmitterError::badFunctionArguments, "Ring buffer frame size and capacity must be positive");
+        }
+
+        _frames = module.GlobalArray(valueType, name + "_frames", static_cast<size_t>(frameSize) * capacity);
+        _head = module.Global<int64_t>(name + "_head", 0);
+        _tail = module.Global<int64_t>(name + "_tail", 0);
+
+        // The producer and consumer are typically outside any one instance of a reentrant model, so the buffer
+        // stays in the globals rather than moving into per-instance state
+        MarkGlobalShared(*_frames);
+        MarkGlobalShared(*_head);
+        MarkGlobalShared(*_tail);
+    }
+
+    LLVMValue IRRingBuffer::Push(IRFunctionEmitter& function, LLVMValue frame)
+    {
+        return Transfer(function, frame, _head, _tail, true);
+    }
+
+    LLVMValue IRRingBuffer::Pop(IRFunctionEmitter& function, LLVMValue frame)
+    {
+        return Transfer(function, frame, _tail, _head, false);
+    }
+
+    LLVMValue IRRingBuffer::Transfer(IRFunctionEmitter& function, LLVMValue frame, llvm::GlobalVariable* ownIndex, llvm::GlobalVariable* otherIndex, bool isPush)
+    {
+        // Only this side writes its own index, so it can read it without synchronization. The acquire load of the other
+        // index makes the other side's frame copies visible before we overwrite (push) or read (pop) the slot.
+        auto own = function.LocalScalar(LoadIndex(function, ownIndex, llvm::AtomicOrdering::Monotonic));
+        auto other = function.LocalScalar(LoadIndex(function, otherIndex, llvm::AtomicOrdering::Acquire));
+        auto isReady = isPush ? ((own - other) < static_cast<int64_t>(_capacity)) : ((other - own) > static_cast<int64_t>(0));
+
+        auto result = function.Variable(GetVariableType<bool>(), isPush ? "pushed" : "popped");
+        function.Store(result, function.Literal<bool>(false));
+        function.If(isReady, [this, frame, own, ownIndex, isPush, result](IRFunctionEmitter& function) {
+            auto slot = function.LocalScalar(function.CastValue<int>(own % static_cast<int64_t>(_capacity)));
+            auto slotPointer = function.PointerOffset(_frames, slot * _frameSize);
+            auto source = isPush ? frame : slotPointer;
+            auto destination = isPush ? slotPointer : frame;
+            function.For(_frameSize, [source, destination](IRFunctionEmitter& function, LLVMValue i) {
+                function.SetValueAt(destination, i, function.ValueAt(source, i));
+            });
+
+            // Publish the slot to the other side
+            StoreIndex(function, ownIndex, own + static_cast<int64_t>(1), llvm::AtomicOrdering::Release);
+            function.Store(result, function.Literal<bool>(true));
+        });
+        return function.Load(result);
+    }
+
+    void IRRingBuffer::EmitPushFunction(const std::string& functionName)
+    {
+        EmitTransferFunction(functionName, true);
+    }
+
+    void IRRingBuffer::EmitPopFunction(const std::string& functionName)
+    {
+        EmitTransferFunction(functionName, false);
+    }
+
+    void IRRingBuffer::EmitTransferFunction(const std::string& functionName, bool isPush)
+    {
+        const NamedVariableTypeList parameters = { { "frame", GetPointerType(_valueType) } };
+        auto function = _module.BeginFunction(functionName, GetVariableType<bool>(), parameters);
+        _module.DeclareFunction(functionName, GetVariableType<bool>(), parameters);
+        function.IncludeInHeader();
+
+        auto frame = &(*function.Arguments().begin());
+        function.Return(isPush ? Push(function, frame) : Pop(function, frame));
+        _module.EndFunction();
+    }
+} // namespace emitters
+} // namespace ell
@@ -8,11 +8,17 @@
 
 #include "IRRuntime.h"
 #include "IRFunctionEmitter.h"
+#include "IRLoopTiling.h"
+#include "IRMath.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
+#include "IRVectorUtilities.h"
 
 #include <utilities/include/Unused.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace ell
 {
 namespace emitters
@@ -22,6 +28,18 @@ namespace emitters
         //
         // Native implementations of matrix operation functions (as opposed to calling out to BLAS)
         //
+        // Software prefetching, if enabled, fetches whole cache lines a fixed distance ahead of the element being read
+        int GetPrefetchElements(const CompilerOptions& options, size_t elementSize)
+        {
+            return options.prefetchDistance > 0 ? std::max(options.prefetchDistance / static_cast<int>(elementSize), 1) : 0;
+        }
+
+        int GetCacheLineElements(const CompilerOptions& options, size_t elementSize)
+        {
+            const auto cacheLineSize = options.targetDevice.cacheLineSize != 0 ? options.targetDevice.cacheLineSize : 64;
+            return std::max(static_cast<int>(cacheLineSize / elementSize), 1);
+        }
+
         template <typename ValueType>
         LLVMFunction EmitGEMVFunction(IRModuleEmitter& module, const std::string& functionName, const NamedVariableTypeList& argTypes)
         {
@@ -41,23 +59,46 @@ namespace emitters
             auto beta = function.LocalScalar(&(*arguments++)); // 9
             auto y = function.LocalArray(&(*arguments++)); // 10
             auto incy = function.LocalScalar(&(*arguments++)); // 11
-            UNUSED(order, transpose, alpha, beta);
+            UNUSED(order, transpose);
 
             LLVMValue accum = function.Variable(emitters::GetVariableType<ValueType>(), "accum");
+            const auto prefetchElements = GetPrefetchElements(module.GetCompilerOptions(), sizeof(ValueType));
+            const auto lineElements = GetCacheLineElements(module.GetCompilerOptions(), sizeof(ValueType));
 
-            function.For(m, [A, x, y, incx, incy, lda, n, accum](IRFunctionEmitter& function, auto rowIndex) {
+            // y = alpha * A * x + beta * y. As in BLAS, y isn't read if beta is 0.
+            auto zero = function.LocalScalar<ValueType>(0);
+            function.For(m, [A, x, y, incx, incy, lda, n, alpha, beta, zero, accum, prefetchElements, lineElements](IRFunctionEmitter& function, auto rowIndex) {
                 function.StoreZero(accum);
-                function.For(n, [rowIndex, A, x, incx, lda, accum](IRFunctionEmitter& function, auto columnIndex) {
+                auto accumulateProduct = [rowIndex, A, x, incx, lda, accum](IRFunctionEmitter& function, IRLocalScalar columnIndex) {
                     auto aIndex = (rowIndex * lda) + columnIndex;
                     auto xIndex = columnIndex * incx;
                     auto aVal = A[aIndex];
                     auto xVal = x[xIndex];
                     auto aTimesX = aVal * xVal;
                     function.Store(accum, function.Load(accum) + aTimesX);
-                });
+                };
+
+                if (prefetchElements > 0)
+                {
+                    // Prefetch the row of A once per cache line, outside the loop over the line, so that loop can still be vectorized
+                    function.For(function.Literal<int>(0), n, function.Literal<int>(lineElements), [=](IRFunctionEmitter& function, IRLocalScalar lineBegin) {
+                        function.Prefetch(A, (rowIndex * lda) + lineBegin + prefetchElements);
+                        function.For(lineBegin, Min(n, lineBegin + lineElements), accumulateProduct);
+                    });
+                }
+                else
+                {
+                    function.For(n, accumulateProduct);
+                }
 
                 auto yIndex = rowIndex * incy;
-                y[yIndex] = function.Load(accum);
+                auto result = alpha * function.LocalScalar(function.Load(accum));
+                function.If(beta == zero, [&](IRFunctionEmitter&) {
+                            y[yIndex] = result;
+                        })
+                    .Else([&](IRFunctionEmitter&) {
+                        y[yIndex] = result + (beta * y[yIndex]);
+                    });
             });
 
             function.Return(function.Literal<int>(0));
@@ -65,6 +106,98 @@ namespace emitters
             return function.GetFunction();
         }
 
+        // Block sizes for the native GEMM. A blockK x blockN panel of B and a blockM x blockK panel of A are
+        // packed into contiguous buffers, and the product is computed by a kernel that keeps a
+        // kernelRows x (kernelVectors * vectorWidth) tile of C in registers.
+        struct GEMMBlockSizes
+        {
+            int blockM;
+            int blockN;
+            int blockK;
+            int kernelRows;
+            int kernelVectors;
+        };
+
+        GEMMBlockSizes GetGEMMBlockSizes(const TargetDevice& targetDevice)
+        {
+            const auto& architecture = targetDevice.architecture;
+            if (architecture == "aarch64" || architecture == "aarch64_be" || architecture == "arm64")
+            {
+                // 32 vector registers: an 8 x 2-vector tile of accumulators, plus the B vectors
+                return { 64, 128, 128, 8, 2 };
+            }
+            if (architecture.compare(0, 3, "arm") == 0 || architecture.compare(0, 5, "thumb") == 0)
+            {
+                // 16 vector registers, and smaller caches (e.g., 32KB L1 and 512KB L2 on a Pi 3)
+                return { 32, 64, 128, 4, 2 };
+            }
+
+            // x86-64: 16 vector registers, 32KB L1 and at least 256KB L2
+            return { 64, 128, 128, 4, 2 };
+        }
+
+        // Shrinks the panels so that the panels of A and B the kernel streams through fit in the L1 cache, and the packed
+        // panels fit in the L2 cache, of devices with smaller caches than the architecture's defaults are sized for
+        GEMMBlockSizes GetCacheFittedGEMMBlockSizes(const TargetDevice& targetDevice, int vectorSize, size_t elementSize)
+        {
+            auto blockSizes = GetGEMMBlockSizes(targetDevice);
+            const auto kernelColumns = static_cast<size_t>(blockSizes.kernelVectors * vectorSize);
+            const auto kernelRows = static_cast<size_t>(blockSizes.kernelRows);
+            const std::vector<LoopNestArrayAccess> kernelArrays = { { { 0 }, kernelRows * elementSize },
+                                                                    { { 0 }, kernelColumns * elementSize },
+                                                                    { {}, kernelRows * kernelColumns * elementSize } };
+            blockSizes.blockK = GetCacheTileSizes(targetDevice, { blockSizes.blockK }, kernelArrays, CacheLevel::L1)[0];
+
+            const auto blockK = static_cast<size_t>(blockSizes.blockK);
+            const std::vector<LoopNestArrayAccess> panelArrays = { { { 0 }, blockK * elementSize },
+                                                                   { {}, blockK * static_cast<size_t>(blockSizes.blockN) * elementSize } };
+            auto blockM = GetCacheTileSizes(targetDevice, { blockSizes.blockM }, panelArrays, CacheLevel::L2)[0];
+            blockSizes.blockM = std::max(blockM - (blockM % blockSizes.kernelRows), blockSizes.kernelRows);
+            return blockSizes;
+        }
+
+        // With `parallelize`, several threads can run the native GEMM at once, so each keeps its packed panels on its own
+        // stack. They're limited to this many bytes, which leaves room on the smallest default thread stacks (512KB on macOS).
+        const size_t c_maxStackGEMMPanelBytes = 64 * 1024;
+
+        // Shrinks the panels until the packed panels of A and B fit in `maxBytes`, halving the longer of blockM and blockN
+        // first, since a shorter blockK means reading and writing C more often
+        void FitGEMMPanels(GEMMBlockSizes& blockSizes, int kernelColumns, size_t elementSize, size_t maxBytes)
+        {
+            auto panelBytes = [&]() {
+                return static_cast<size_t>(blockSizes.blockM + blockSizes.blockN) * static_cast<size_t>(blockSizes.blockK) * elementSize;
+            };
+            while (panelBytes() > maxBytes)
+            {
+                if (blockSizes.blockM > blockSizes.kernelRows && blockSizes.blockM >= blockSizes.blockN)
+                {
+                    blockSizes.blockM = std::max(((blockSizes.blockM / 2) / blockSizes.kernelRows) * blockSizes.kernelRows, blockSizes.kernelRows);
+                }
+                else if (blockSizes.blockN > kernelColumns)
+                {
+                    blockSizes.blockN = std::max(((blockSizes.blockN / 2) / kernelColumns) * kernelColumns, kernelColumns);
+                }
+                else if (blockSizes.blockK > 1)
+                {
+                    blockSizes.blockK /= 2;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        // Returns a pointer to the first element of a zero-initialized internal global array. The pointer is computed by an
+        // instruction, not a constant expression, so passes that move globals (like `EmitReentrantFunctions`) see the use.
+        LLVMValue GetGlobalScratchArray(IRFunctionEmitter& function, const std::string& name, LLVMType elementType, size_t size)
+        {
+            auto& module = function.GetModule();
+            auto global = module.GlobalArray(name, elementType, size);
+            auto zero = function.Literal<int>(0);
+            return function.GetEmitter().GetIRBuilder().Insert(llvm::GetElementPtrInst::CreateInBounds(global->getValueType(), global, { zero, zero }), name + "_begin");
+        }
+
         template <typename ValueType>
         LLVMFunction EmitGEMMFunction(IRModuleEmitter& module, const std::string& functionName, const NamedVariableTypeList& argTypes)
         {
@@ -89,31 +222,177 @@ namespace emitters
             auto beta = function.LocalScalar(&(*arguments++)); // 11
             auto C = function.LocalArray(&(*arguments++)); // 12
             auto ldc = function.LocalScalar(&(*arguments++)); // 13
-            UNUSED(CblasNoTrans, order, alpha, beta);
+            UNUSED(CblasNoTrans, order);
 
             // C = A x B, A: mxk, B: kxn, C: mxn
             // A': kxm, B': nxk
 
-            // Loop orders:
-            // A*B:   i, k, j
-            // A'*B:  k, i, j
-            // A*B':  i, j, k
-            // A'*B': k, j, i (?)
-
-            // Clear output
-            auto count = ldc * m;
-            function.MemorySet<ValueType>(C, function.Literal<int>(0), function.Literal<uint8_t>(0), count);
-
-            // Accumulate partial values into output
-            function.For(m, [A, B, C, lda, ldb, ldc, transposeA, transposeB, n, k](IRFunctionEmitter& function, auto i) {
-                function.For(k, [i, A, B, C, lda, ldb, ldc, transposeA, transposeB, n](IRFunctionEmitter& function, auto k) {
-                    function.For(n, [i, k, A, B, C, lda, ldb, ldc, transposeA, transposeB](IRFunctionEmitter& function, auto j) {
-                        auto aOffset = function.LocalScalar(function.Select(transposeA, (k * lda) + i, (i * lda) + k));
-                        auto bOffset = function.LocalScalar(function.Select(transposeB, (j * ldb) + k, (k * ldb) + j));
-                        auto cOffset = (i * ldc) + j;
-
-                        // accumulate product in C[i, j]
-                        C[cOffset] = C[cOffset] + (A[aOffset] * B[bOffset]);
+            const auto& compilerOptions = module.GetCompilerOptions();
+            const int vectorSize = compilerOptions.allowVectorInstructions ? std::max(compilerOptions.vectorWidth, 1) : 1;
+            auto blockSizes = GetCacheFittedGEMMBlockSizes(compilerOptions.targetDevice, vectorSize, sizeof(ValueType));
+            const int kernelRows = blockSizes.kernelRows;
+            const int kernelVectors = blockSizes.kernelVectors;
+            const int kernelColumns = kernelVectors * vectorSize;
+            blockSizes.blockN = ((blockSizes.blockN + kernelColumns - 1) / kernelColumns) * kernelColumns;
+            const bool usePanelGlobals = !compilerOptions.parallelize;
+            if (!usePanelGlobals)
+            {
+                FitGEMMPanels(blockSizes, kernelColumns, sizeof(ValueType), c_maxStackGEMMPanelBytes);
+            }
+            const int blockM = blockSizes.blockM; // multiple of kernelRows
+            const int blockK = blockSizes.blockK;
+            const int blockN = blockSizes.blockN; // multiple of kernelColumns
+            const auto prefetchElements = GetPrefetchElements(compilerOptions, sizeof(ValueType));
+
+            auto& emitter = function.GetEmitter();
+            auto& irBuilder = emitter.GetIRBuilder();
+            auto elementPointerType = emitter.Type(emitters::GetVariableType<ValueType>())->getPointerTo();
+            auto vectorType = emitter.VectorType(emitters::GetVariableType<ValueType>(), vectorSize);
+            auto zero = function.Literal(static_cast<ValueType>(0));
+
+            // Packed panels. B and the output tile are allocated as arrays of vectors, so the vector loads and stores are aligned.
+            // packedA[(rowPanel * blockK + p) * kernelRows + r] = A[i, p], where i = rowPanel * kernelRows + r
+            // packedB[(columnPanel * blockK + p) * kernelColumns + c] = B[p, j], where j = columnPanel * kernelColumns + c
+            // The panels can be tens or hundreds of KB, too big for a microcontroller's stack, so unless several threads can
+            // run the GEMM at once they're module-level scratch arrays (which become part of the state of a reentrant module).
+            LLVMValue packedAValues = nullptr;
+            LLVMValue packedBVectors = nullptr;
+            if (usePanelGlobals)
+            {
+                packedAValues = GetGlobalScratchArray(function, functionName + "_packedA", emitter.Type(emitters::GetVariableType<ValueType>()), blockM * blockK);
+                packedBVectors = GetGlobalScratchArray(function, functionName + "_packedB", vectorType, (blockN / vectorSize) * blockK);
+            }
+            else
+            {
+                packedAValues = function.Variable(emitters::GetVariableType<ValueType>(), blockM * blockK);
+                packedBVectors = function.Variable(vectorType, (blockN / vectorSize) * blockK);
+            }
+            auto packedA = function.LocalArray(packedAValues);
+            auto packedB = function.LocalArray(function.CastPointer(packedBVectors, elementPointerType));
+            auto tileVectors = function.Variable(vectorType, kernelRows * kernelVectors);
+            auto tile = function.LocalArray(function.CastPointer(tileVectors, elementPointerType));
+            std::vector<LLVMValue> accumulators;
+            for (int index = 0; index < kernelRows * kernelVectors; ++index)
+            {
+                accumulators.push_back(function.Variable(vectorType, "accum"));
+            }
+
+            // C = alpha * A x B + beta * C: scale the output by beta first, then add alpha times each tile of the
+            // product. As in BLAS, C isn't read if beta is 0.
+            auto scalarZero = function.LocalScalar<ValueType>(0);
+            auto scalarOne = function.LocalScalar<ValueType>(1);
+            function.If(beta == scalarZero, [&](IRFunctionEmitter& function) {
+                        auto count = ldc * m;
+                        function.MemorySet<ValueType>(C, function.Literal<int>(0), function.Literal<uint8_t>(0), count);
+                    })
+                .ElseIf(beta != scalarOne, [&](IRFunctionEmitter& function) {
+                    function.For(m, [&](IRFunctionEmitter& function, auto i) {
+                        function.For(n, [&](IRFunctionEmitter& function, auto j) {
+                            auto cOffset = (i * ldc) + j;
+                            C[cOffset] = beta * C[cOffset];
+                        });
+                    });
+                });
+
+            // Accumulate partial values into output, one (blockK x blockN) panel of B and (blockM x blockK) panel of A at a time
+            function.For(function.Literal<int>(0), n, function.Literal<int>(blockN), [&](IRFunctionEmitter& function, auto jBlock) {
+                auto numColumns = Min(n - jBlock, blockN);
+                auto numColumnPanels = (numColumns + (kernelColumns - 1)) / kernelColumns;
+
+                function.For(function.Literal<int>(0), k, function.Literal<int>(blockK), [&](IRFunctionEmitter& function, auto kBlock) {
+                    auto depth = Min(k - kBlock, blockK);
+
+                    // Pack B, padding the last column panel with zeros
+                    function.For(numColumnPanels, [&](IRFunctionEmitter& function, auto columnPanel) {
+                        function.For(depth, [&](IRFunctionEmitter& function, auto p) {
+                            if (prefetchElements > 0)
+                            {
+                                auto row = kBlock + p;
+                                auto j = jBlock + columnPanel * kernelColumns;
+                                function.Prefetch(B, function.LocalScalar(function.Select(transposeB, (j * ldb) + row, (row * ldb) + j)) + prefetchElements);
+                            }
+
+                            function.For(kernelColumns, [&](IRFunctionEmitter& function, auto c) {
+                                auto column = columnPanel * kernelColumns + c;
+                                auto isValid = column < numColumns;
+                                auto row = kBlock + p;
+                                auto j = jBlock + column;
+                                auto bOffset = function.Select(transposeB, (j * ldb) + row, (row * ldb) + j);
+                                IRLocalScalar bValue = B[function.LocalScalar(function.Select(isValid, bOffset, function.Literal<int>(0)))];
+                                packedB[((columnPanel * blockK + p) * kernelColumns) + c] = function.Select(isValid, bValue, zero);
+                            });
+                        });
+                    });
+
+                    function.For(function.Literal<int>(0), m, function.Literal<int>(blockM), [&](IRFunctionEmitter& function, auto iBlock) {
+                        auto numRows = Min(m - iBlock, blockM);
+                        auto numRowPanels = (numRows + (kernelRows - 1)) / kernelRows;
+
+                        // Pack A, padding the last row panel with zeros
+                        function.For(numRowPanels, [&](IRFunctionEmitter& function, auto rowPanel) {
+                            function.For(depth, [&](IRFunctionEmitter& function, auto p) {
+                                for (int r = 0; r < kernelRows; ++r)
+                                {
+                                    auto row = rowPanel * kernelRows + r;
+                                    auto isValid = row < numRows;
+                                    auto i = iBlock + row;
+                                    auto column = kBlock + p;
+                                    auto aOffset = function.Select(transposeA, (column * lda) + i, (i * lda) + column);
+                                    if (prefetchElements > 0)
+                                    {
+                                        function.Prefetch(A, function.LocalScalar(aOffset) + prefetchElements);
+                                    }
+                                    IRLocalScalar aValue = A[function.LocalScalar(function.Select(isValid, aOffset, function.Literal<int>(0)))];
+                                    packedA[((rowPanel * blockK + p) * kernelRows) + r] = function.Select(isValid, aValue, zero);
+                                }
+                            });
+                        });
+
+                        // Compute each (kernelRows x kernelColumns) tile of the output in registers
+                        function.For(numColumnPanels, [&](IRFunctionEmitter& function, auto columnPanel) {
+                            function.For(numRowPanels, [&](IRFunctionEmitter& function, auto rowPanel) {
+                                for (auto accumulator : accumulators)
+                                {
+                                    function.Store(accumulator, FillVector<ValueType>(function, vectorType, 0));
+                                }
+
+                                function.For(depth, [&](IRFunctionEmitter& function, auto p) {
+                                    std::vector<LLVMValue> bValues;
+                                    for (int v = 0; v < kernelVectors; ++v)
+                                    {
+                                        bValues.push_back(function.ValueAt(packedBVectors, ((columnPanel * blockK + p) * kernelVectors) + v));
+                                    }
+
+                                    for (int r = 0; r < kernelRows; ++r)
+                                    {
+                                        IRLocalScalar aValue = packedA[((rowPanel * blockK + p) * kernelRows) + r];
+                                        auto aVector = irBuilder.CreateVectorSplat(vectorSize, aValue);
+                                        for (int v = 0; v < kernelVectors; ++v)
+                                        {
+                                            auto product = function.Operator(emitters::GetMultiplyForValueType<ValueType>(), aVector, bValues[v]);
+                                            function.OperationAndUpdate(accumulators[r * kernelVectors + v], emitters::GetAddForValueType<ValueType>(), product);
+                                        }
+                                    }
+                                });
+
+                                // Add the tile into the valid part of the output
+                                for (int index = 0; index < kernelRows * kernelVectors; ++index)
+                                {
+                                    function.SetValueAt(tileVectors, function.Literal<int>(index), function.Load(accumulators[index]));
+                                }
+
+                                auto tileRows = Min(numRows - rowPanel * kernelRows, kernelRows);
+                                auto tileColumns = Min(numColumns - columnPanel * kernelColumns, kernelColumns);
+                                function.For(tileRows, [&](IRFunctionEmitter& function, auto r) {
+                                    function.For(tileColumns, [&](IRFunctionEmitter& function, auto c) {
+                                        auto i = iBlock + (rowPanel * kernelRows) + r;
+                                        auto j = jBlock + (columnPanel * kernelColumns) + c;
+                                        auto cOffset = (i * ldc) + j;
+                                        C[cOffset] = C[cOffset] + (alpha * tile[(r * kernelColumns) + c]);
+                                    });
+                                });
+                            });
+                        });
                     });
                 });
             });
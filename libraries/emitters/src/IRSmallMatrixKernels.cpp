@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRSmallMatrixKernels.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRSmallMatrixKernels.h"
+#include "EmitterTypes.h"
+
+#include <functional>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        // Sums the products of each row of a matrix with a vector. `getEntry` returns nullptr for known zero entries.
+        template <typename ValueType>
+        void EmitUnrolledRowProducts(IRFunctionEmitter& function, int m, int n, std::function<LLVMValue(int, int)> getEntry, const std::vector<LLVMValue>& xValues, LLVMValue y, int incy)
+        {
+            const auto multiply = GetMultiplyForValueType<ValueType>();
+            const auto add = GetAddForValueType<ValueType>();
+            for (int i = 0; i < m; ++i)
+            {
+                LLVMValue sum = nullptr;
+                for (int j = 0; j < n; ++j)
+                {
+                    auto entry = getEntry(i, j);
+                    if (entry == nullptr)
+                    {
+                        continue;
+                    }
+                    auto product = function.Operator(multiply, entry, xValues[j]);
+                    sum = sum == nullptr ? product : function.Operator(add, sum, product);
+                }
+                function.SetValueAt(y, i * incy, sum == nullptr ? function.Literal<ValueType>(0) : sum);
+            }
+        }
+
+        std::vector<LLVMValue> LoadElements(IRFunctionEmitter& function, LLVMValue pointer, int size, int increment)
+        {
+            std::vector<LLVMValue> result;
+            for (int index = 0; index < size; ++index)
+            {
+                result.push_back(function.ValueAt(pointer, index * increment));
+            }
+            return result;
+        }
+    } // namespace
+
+    bool UseSmallMatrixKernel(const CompilerOptions& options, int numMultiplyAdds)
+    {
+        return numMultiplyAdds <= options.smallMatrixThreshold;
+    }
+
+    template <typename ValueType>
+    void EmitSmallGEMV(IRFunctionEmitter& function, int m, int n, const std::vector<ValueType>& A, int lda, LLVMValue x, int incx, LLVMValue y, int incy)
+    {
+        auto xValues = LoadElements(function, x, n, incx);
+        auto getEntry = [&](int i, int j) -> LLVMValue {
+            auto value = A[i * lda + j];
+            return value == 0 ? nullptr : function.Literal<ValueType>(value);
+        };
+        EmitUnrolledRowProducts<ValueType>(function, m, n, getEntry, xValues, y, incy);
+    }
+
+    template <typename ValueType>
+    void EmitSmallGEMV(IRFunctionEmitter& function, int m, int n, LLVMValue A, int lda, LLVMValue x, int incx, LLVMValue y, int incy)
+    {
+        auto xValues = LoadElements(function, x, n, incx);
+        auto getEntry = [&](int i, int j) {
+            return function.ValueAt(A, i * lda + j);
+        };
+        EmitUnrolledRowProducts<ValueType>(function, m, n, getEntry, xValues, y, incy);
+    }
+
+    template <typename ValueType>
+    void EmitSmallGEMM(IRFunctionEmitter& function, bool transposeA, bool transposeB, int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc)
+    {
+        // Load every entry of op(B) once, then compute C one row at a time, as the product of that row of op(A) with op(B)
+        std::vector<std::vector<LLVMValue>> bColumns(n);
+        for (int j = 0; j < n; ++j)
+        {
+            bColumns[j] = transposeB ? LoadElements(function, function.PointerOffset(B, j * ldb), k, 1) : LoadElements(function, function.PointerOffset(B, j), k, ldb);
+        }
+
+        const auto multiply = GetMultiplyForValueType<ValueType>();
+        const auto add = GetAddForValueType<ValueType>();
+        for (int i = 0; i < m; ++i)
+        {
+            auto aRow = transposeA ? LoadElements(function, function.PointerOffset(A, i), k, lda) : LoadElements(function, function.PointerOffset(A, i * lda), k, 1);
+            for (int j = 0; j < n; ++j)
+            {
+                LLVMValue sum = function.Literal<ValueType>(0);
+                for (int p = 0; p < k; ++p)
+                {
+                    auto product = function.Operator(multiply, aRow[p], bColumns[j][p]);
+                    sum = p == 0 ? product : function.Operator(add, sum, product);
+                }
+                function.SetValueAt(C, i * ldc + j, sum);
+            }
+        }
+    }
+
+    // Explicit instantiations
+    template void EmitSmallGEMV<float>(IRFunctionEmitter& function, int m, int n, const std::vector<float>& A, int lda, LLVMValue x, int incx, LLVMValue y, int incy);
+    template void EmitSmallGEMV<double>(IRFunctionEmitter& function, int m, int n, const std::vector<double>& A, int lda, LLVMValue x, int incx, LLVMValue y, int incy);
+    template void EmitSmallGEMV<float>(IRFunctionEmitter& function, int m, int n, LLVMValue A, int lda, LLVMValue x, int incx, LLVMValue y, int incy);
+    template void EmitSmallGEMV<double>(IRFunctionEmitter& function, int m, int n, LLVMValue A, int lda, LLVMValue x, int incx, LLVMValue y, int incy);
+    template void EmitSmallGEMM<float>(IRFunctionEmitter& function, bool transposeA, bool transposeB, int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc);
+    template void EmitSmallGEMM<double>(IRFunctionEmitter& function, bool transposeA, bool transposeB, int m, int n, int k, LLVMValue A, int lda, LLVMValue B, int ldb, LLVMValue C, int ldc);
+} // namespace emitters
+} // namespace ell
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRStaticMemory.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRStaticMemory.h"
+#include "EmitterException.h"
+#include "IRModuleEmitter.h"
+
+#include <utilities/include/Logger.h>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    uint64_t MoveStackArraysToGlobals(IRModuleEmitter& module, uint64_t minimumSize)
+    {
+        if (module.GetCompilerOptions().parallelize)
+        {
+            throw EmitterException(EmitterError::notSupported, "Can't allocate scratch memory statically for a module that runs functions in parallel");
+        }
+
+        auto& context = module.GetLLVMContext();
+        auto& llvmModule = *module.GetLLVMModule();
+        const auto& dataLayout = module.GetTargetDataLayout();
+        auto int32Type = llvm::Type::getInt32Ty(context);
+
+        uint64_t totalSize = 0;
+        for (auto& function : llvmModule)
+        {
+            if (function.isDeclaration())
+            {
+                continue;
+            }
+
+            // Only the allocations in the entry block happen once per call, with a size known at compile time
+            std::vector<llvm::AllocaInst*> allocations;
+            for (auto& instruction : function.getEntryBlock())
+            {
+                auto allocation = llvm::dyn_cast<llvm::AllocaInst>(&instruction);
+                if (allocation != nullptr && allocation->isStaticAlloca())
+                {
+                    allocations.push_back(allocation);
+                }
+            }
+
+            for (auto allocation : allocations)
+            {
+                auto elementType = allocation->getAllocatedType();
+                auto count = llvm::cast<llvm::ConstantInt>(allocation->getArraySize())->getZExtValue();
+                auto size = dataLayout.getTypeAllocSize(elementType) * count;
+                if (size < minimumSize)
+                {
+                    continue;
+                }
+
+                auto globalType = allocation->isArrayAllocation() ? llvm::ArrayType::get(elementType, count) : elementType;
+                auto global = new llvm::GlobalVariable(llvmModule, globalType, false, llvm::GlobalValue::InternalLinkage, llvm::Constant::getNullValue(globalType), function.getName() + "_scratch");
+                global->setAlignment(allocation->getAlignment());
+
+                // Address the global with an instruction, not a constant expression, so passes that move globals (like `EmitReentrantFunctions`) see the use
+                llvm::Value* replacement = global;
+                if (allocation->isArrayAllocation())
+                {
+                    auto zero = llvm::ConstantInt::get(int32Type, 0);
+                    replacement = llvm::GetElementPtrInst::CreateInBounds(globalType, global, { zero, zero }, "", allocation);
+                }
+                replacement->takeName(allocation);
+                allocation->replaceAllUsesWith(replacement);
+                allocation->eraseFromParent();
+                totalSize += size;
+            }
+        }
+
+        Log() << "Moved " << totalSize << " bytes of stack arrays into static memory" << EOL;
+        return totalSize;
+    }
+} // namespace emitters
+} // namespace ell
@@ -12,17 +12,141 @@
 #include "IRHeaderWriter.h"
 #include "IRLoopEmitter.h"
 #include "IRModuleEmitter.h"
+#include "IRReentrancy.h"
 #include "IRThreadUtilities.h"
 
 #include <utilities/include/Exception.h>
+#include <utilities/include/StringUtil.h>
 #include <utilities/include/Unused.h>
 
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/InlineAsm.h>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
 #include <vector>
 
 namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        // Work-stealing deques store a worker's contiguous range of task indices in a single 64-bit word,
+        // with `begin` in the upper 32 bits and `end` in the lower 32 bits, so that both ends of the deque
+        // can be updated with a single compare-and-exchange
+        const int64_t taskRangeShift = 32;
+
+        LLVMValue PackTaskRange(IRFunctionEmitter& function, LLVMValue begin, LLVMValue end)
+        {
+            auto int64Type = llvm::Type::getInt64Ty(function.GetLLVMContext());
+            auto high = function.Operator(TypedOperator::shiftLeft, function.CastValue(begin, int64Type), function.Literal<int64_t>(taskRangeShift));
+            return function.Operator(TypedOperator::logicalOr, high, function.CastValue(end, int64Type));
+        }
+
+        // The longest run of CPU pauses between two checks of a spin wait
+        const int maxSpinPauses = 64;
+
+        // Tells the CPU we're in a spin loop, so it can save power and yield to a hyperthread sibling
+        void EmitCpuPause(IRFunctionEmitter& function)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto arch = llvm::Triple(function.GetModule().GetCompilerOptions().targetDevice.triple).getArch();
+            std::string instruction;
+            switch (arch)
+            {
+            case llvm::Triple::x86:
+            case llvm::Triple::x86_64:
+                instruction = "pause";
+                break;
+            case llvm::Triple::arm:
+            case llvm::Triple::thumb:
+            case llvm::Triple::aarch64:
+                instruction = "yield";
+                break;
+            default:
+                return;
+            }
+            auto pauseType = llvm::FunctionType::get(irBuilder.getVoidTy(), false);
+            irBuilder.CreateCall(llvm::InlineAsm::get(pauseType, instruction, "~{memory}", true));
+        }
+
+        // Worker CPU sets are laid out like glibc's `cpu_set_t`: a bitmask of 1024 CPUs, in 64-bit words
+        const int cpuSetSize = 1024;
+        const int cpuSetWordBits = 64;
+        const int cpuSetNumWords = cpuSetSize / cpuSetWordBits;
+
+        // Parses a comma-separated list of core indices and ranges, like "0,2,4-7"
+        std::vector<int> ParseCoreList(const std::string& coreList)
+        {
+            std::vector<int> cores;
+            for (const auto& entry : utilities::Split(coreList, ','))
+            {
+                auto range = utilities::Split(entry, '-');
+                if (entry.empty() || range.size() > 2)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Invalid affinityCores entry '" + entry + "'");
+                }
+
+                try
+                {
+                    auto first = std::stoi(range[0]);
+                    auto last = range.size() == 2 ? std::stoi(range[1]) : first;
+                    if (first < 0 || last < first || last >= cpuSetSize)
+                    {
+                        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Invalid affinityCores entry '" + entry + "'");
+                    }
+                    for (int core = first; core <= last; ++core)
+                    {
+                        cores.push_back(core);
+                    }
+                }
+                catch (const std::logic_error&)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Invalid affinityCores entry '" + entry + "'");
+                }
+            }
+            return cores;
+        }
+    } // namespace
+
+    std::vector<int> GetThreadPoolWorkerCores(const CompilerOptions& options)
+    {
+        if (options.threadAffinity == ThreadAffinity::none || options.maxThreads <= 0)
+        {
+            return {};
+        }
+
+        auto cores = ParseCoreList(options.affinityCores);
+        if (cores.empty())
+        {
+            cores.resize(options.maxThreads);
+            std::iota(cores.begin(), cores.end(), 0);
+        }
+
+        auto numCores = static_cast<int>(cores.size());
+        auto numSockets = std::min(std::max(options.affinitySockets, 1), numCores);
+        auto coresPerSocket = numCores / numSockets;
+
+        std::vector<int> workerCores(options.maxThreads);
+        for (int worker = 0; worker < options.maxThreads; ++worker)
+        {
+            if (options.threadAffinity == ThreadAffinity::compact)
+            {
+                workerCores[worker] = cores[worker % numCores];
+            }
+            else
+            {
+                // Round-robin over the sockets, then over the cores of each socket
+                auto socket = worker % numSockets;
+                auto slot = (worker / numSockets) % coresPerSocket;
+                workerCores[worker] = cores[socket * coresPerSocket + slot];
+            }
+        }
+        return workerCores;
+    }
+
     //
     // IRThreadPool
     //
@@ -39,6 +163,32 @@ namespace emitters
 
         // Create global array to hold pthread objects
         _threads = _module.GlobalArray("taskThreads", pthreadType, _maxThreads);
+        MarkGlobalShared(*_threads);
+
+        _taskQueue.SetSpinCount(_module.GetCompilerOptions().threadPoolSpinCount);
+        if (_module.GetCompilerOptions().useWorkStealing)
+        {
+            // Each worker thread gets a pointer to its own index, so it knows which deque it owns
+            std::vector<int> workerIndices(_maxThreads);
+            std::iota(workerIndices.begin(), workerIndices.end(), 0);
+            _workerIndices = _module.GlobalArray("taskWorkerIndices", workerIndices);
+            MarkGlobalShared(*_workerIndices);
+            _taskQueue.InitializeWorkStealing(_module, static_cast<int>(_maxThreads));
+        }
+
+        // pthread_setaffinity_np is a Linux extension; other targets leave the workers unpinned
+        auto workerCores = GetThreadPoolWorkerCores(_module.GetCompilerOptions());
+        if (!workerCores.empty() && _module.GetCompilerOptions().targetDevice.IsLinux())
+        {
+            std::vector<int64_t> cpuSets(_maxThreads * cpuSetNumWords, 0);
+            for (size_t worker = 0; worker < _maxThreads; ++worker)
+            {
+                auto core = workerCores[worker];
+                cpuSets[worker * cpuSetNumWords + core / cpuSetWordBits] |= int64_t{ 1 } << (core % cpuSetWordBits);
+            }
+            _workerCpuSets = _module.GlobalArray("taskWorkerCpuSets", cpuSets);
+            MarkGlobalShared(*_workerCpuSets);
+        }
 
         AddGlobalInitializer();
         AddGlobalFinalizer();
@@ -51,6 +201,7 @@ namespace emitters
         auto boolType = llvm::Type::getInt1Ty(context);
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
         auto isInitedVar = _module.Global(boolType, "isInitialized"); // initialized to false
+        MarkGlobalShared(*isInitedVar);
 
         auto initThreadPoolFunction = _module.BeginFunction("initThreadPool", VariableType::Void);
         {
@@ -62,9 +213,20 @@ namespace emitters
 
                 auto workerThreadFunction = this->GetWorkerThreadFunction(); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
                 llvm::ConstantPointerNull* nullAttr = initThreadPoolFunction.NullPointer(int8PtrType);
-                initThreadPoolFunction.For(_maxThreads, [this, int8PtrType, nullAttr, workerThreadFunction](auto& initThreadPoolFunction, LLVMValue index) {
+                initThreadPoolFunction.For(_maxThreads, [this, int8PtrType, nullAttr, workerThreadFunction](IRFunctionEmitter& initThreadPoolFunction, LLVMValue index) {
                     auto threadPtr = initThreadPoolFunction.PointerOffset(_threads, index);
-                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastPointer(_taskQueue.GetDataStruct(), int8PtrType));
+                    auto threadArg = _workerIndices != nullptr ? initThreadPoolFunction.PointerOffset(_workerIndices, index) : _taskQueue.GetDataStruct();
+                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastPointer(threadArg, int8PtrType));
+
+                    // Pin each worker as soon as it starts, before any tasks are queued. Failures (e.g., a core that's offline) leave it unpinned.
+                    if (_workerCpuSets != nullptr)
+                    {
+                        auto cpuSetIndex = initThreadPoolFunction.Operator(TypedOperator::multiply, index, initThreadPoolFunction.Literal<int>(cpuSetNumWords));
+                        auto cpuSetPtr = initThreadPoolFunction.PointerOffset(_workerCpuSets, cpuSetIndex);
+                        auto sizeType = _module.GetTargetDataLayout().getIntPtrType(_module.GetLLVMContext());
+                        auto cpuSetBytes = initThreadPoolFunction.CastValue(initThreadPoolFunction.Literal<int64_t>(cpuSetSize / 8), sizeType);
+                        initThreadPoolFunction.PthreadSetAffinity(initThreadPoolFunction.Load(threadPtr), cpuSetBytes, initThreadPoolFunction.CastPointer(cpuSetPtr, int8PtrType));
+                    }
                 });
             });
         }
@@ -118,10 +280,17 @@ namespace emitters
 
         auto workerThreadFunction = _module.BeginFunction("WorkerThreadFunction", int8PtrType, { int8PtrType });
         {
+            LLVMValue workerIndex = nullptr;
+            if (_taskQueue.UseWorkStealing())
+            {
+                auto workerIndexPtr = &(*workerThreadFunction.Arguments().begin());
+                workerIndex = workerThreadFunction.Load(workerThreadFunction.CastPointer(workerIndexPtr, llvm::Type::getInt32PtrTy(context)));
+            }
+
             auto notDoneVar = workerThreadFunction.Variable(boolType, "notDone");
             workerThreadFunction.Store(notDoneVar, workerThreadFunction.TrueBit());
-            workerThreadFunction.While(notDoneVar, [this, notDoneVar](IRFunctionEmitter& workerThreadFunction) {
-                auto task = _taskQueue.PopNextTask(workerThreadFunction);
+            workerThreadFunction.While(notDoneVar, [this, notDoneVar, workerIndex](IRFunctionEmitter& workerThreadFunction) {
+                auto task = _taskQueue.UseWorkStealing() ? _taskQueue.PopOrStealNextTask(workerThreadFunction, workerIndex) : _taskQueue.PopNextTask(workerThreadFunction);
                 // check for a poison "null" task, indicating we should break out of the loop and terminate the thread
                 workerThreadFunction.If(
                                         workerThreadFunction.Operator(TypedOperator::logicalOr, task.IsNull(workerThreadFunction), _taskQueue.GetShutdownFlag(workerThreadFunction)),
@@ -131,15 +300,28 @@ namespace emitters
                     .Else([this, &task](IRFunctionEmitter& workerThreadFunction) {
                         task.Run(workerThreadFunction);
 
-                        // Decrement count of unfinished tasks
-                        _taskQueue.LockQueueMutex(workerThreadFunction);
-                        auto unfinishedCount = _taskQueue.DecrementUnfinishedTasks(workerThreadFunction);
-                        _taskQueue.UnlockQueueMutex(workerThreadFunction);
-
-                        // if zero, signal client cond var
-                        workerThreadFunction.If(workerThreadFunction.Comparison(TypedComparison::equals, unfinishedCount, workerThreadFunction.Literal<int>(0)), [this](auto& workerThreadFunction) {
-                            _taskQueue.NotifyWaitingClients(workerThreadFunction);
-                        });
+                        if (_taskQueue.UseWorkStealing())
+                        {
+                            // Decrement count of unfinished tasks atomically, and only take the lock to signal the client
+                            auto unfinishedCount = _taskQueue.DecrementUnfinishedTasks(workerThreadFunction);
+                            workerThreadFunction.If(workerThreadFunction.Comparison(TypedComparison::equals, unfinishedCount, workerThreadFunction.Literal<int>(0)), [this](IRFunctionEmitter& workerThreadFunction) {
+                                _taskQueue.LockQueueMutex(workerThreadFunction);
+                                _taskQueue.NotifyWaitingClients(workerThreadFunction);
+                                _taskQueue.UnlockQueueMutex(workerThreadFunction);
+                            });
+                        }
+                        else
+                        {
+                            // Decrement count of unfinished tasks
+                            _taskQueue.LockQueueMutex(workerThreadFunction);
+                            auto unfinishedCount = _taskQueue.DecrementUnfinishedTasks(workerThreadFunction);
+                            _taskQueue.UnlockQueueMutex(workerThreadFunction);
+
+                            // if zero, signal client cond var
+                            workerThreadFunction.If(workerThreadFunction.Comparison(TypedComparison::equals, unfinishedCount, workerThreadFunction.Literal<int>(0)), [this](auto& workerThreadFunction) {
+                                _taskQueue.NotifyWaitingClients(workerThreadFunction);
+                            });
+                        }
                     });
             });
 
@@ -178,7 +360,9 @@ namespace emitters
         auto taskQueueDataType = GetTaskQueueDataType(module);
 
         // Allocate a data struct
-        _queueData = module.Global(taskQueueDataType, "taskQueueData");
+        auto queueData = module.Global(taskQueueDataType, "taskQueueData");
+        MarkGlobalShared(*queueData);
+        _queueData = queueData;
 
         // Get pointers to the fields
         auto queueMutex = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::queueMutex));
@@ -201,6 +385,19 @@ namespace emitters
         _tasks.Initialize(function);
     }
 
+    void IRThreadPoolTaskQueue::InitializeWorkStealing(IRModuleEmitter& module, int numWorkers)
+    {
+        if (_workerTaskRanges != nullptr)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Error: initializing thread pool work-stealing deques more than once");
+        }
+
+        // Zero-initialized, so every deque starts out empty
+        _numWorkers = numWorkers;
+        _workerTaskRanges = module.GlobalArray(VariableType::Int64, "taskWorkerRanges", numWorkers);
+        MarkGlobalShared(*_workerTaskRanges);
+    }
+
     IRThreadPoolTaskArray& IRThreadPoolTaskQueue::StartTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& arguments)
     {
         assert(IsInitialized());
@@ -212,6 +409,11 @@ namespace emitters
         LockQueueMutex(function);
         _tasks.SetTasks(function, taskFunction, arguments);
         SetInitialCount(function, function.Literal<int>(numTasks));
+        if (UseWorkStealing())
+        {
+            // The counts must be visible before any worker can take one of the new tasks
+            SetWorkerTaskRanges(function, static_cast<int>(numTasks));
+        }
         function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
         UnlockQueueMutex(function);
         return GetTaskArray();
@@ -234,6 +436,7 @@ namespace emitters
         auto queueMutex = GetQueueMutexPointer(function);
         auto workAvailableCondVar = GetWorkAvailableConditionVariablePointer(function);
 
+        SpinWait(function, [this](IRFunctionEmitter& function) { return function.Operator(UnaryOperatorType::logicalNot, IsEmpty(function)); });
         LockQueueMutex(function);
         function.Store(isEmptyVar, function.Operator(TypedOperator::logicalAnd, IsEmpty(function), function.Operator(UnaryOperatorType::logicalNot, GetShutdownFlag(function))));
         function.While(isEmptyVar, [=](auto& function) {
@@ -252,6 +455,107 @@ namespace emitters
         return _tasks.GetTask(function, newCount);
     }
 
+    IRThreadPoolTask IRThreadPoolTaskQueue::PopOrStealNextTask(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        assert(IsInitialized());
+        assert(UseWorkStealing());
+
+        auto& context = function.GetLLVMContext();
+        auto boolType = llvm::Type::getInt1Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+        const auto numWorkers = _numWorkers;
+
+        auto taskIndexVar = function.Variable(int32Type, "taskIndex");
+        auto keepLookingVar = function.Variable(boolType, "keepLooking");
+        auto isIdleVar = function.Variable(boolType, "isIdle");
+        function.Store(taskIndexVar, function.Literal<int>(-1));
+        function.Store(keepLookingVar, function.TrueBit());
+        function.While(keepLookingVar, [=](IRFunctionEmitter& function) {
+            // Look in our own deque first, then in the other workers' deques, starting with our neighbor
+            function.For(numWorkers, [=](IRFunctionEmitter& function, LLVMValue offset) {
+                auto notFound = function.Comparison(TypedComparison::lessThan, function.Load(taskIndexVar), function.Literal<int>(0));
+                function.If(notFound, [=](IRFunctionEmitter& function) {
+                    auto victimIndex = function.Operator(TypedOperator::moduloSigned, function.Operator(TypedOperator::add, workerIndex, offset), function.Literal<int>(numWorkers));
+                    auto isOwner = function.Comparison(TypedComparison::equals, offset, function.Literal<int>(0));
+                    auto workerRangePtr = function.PointerOffset(_workerTaskRanges, victimIndex);
+                    function.Store(taskIndexVar, this->TryTakeTask(function, workerRangePtr, isOwner));
+                });
+            });
+
+            auto found = function.Comparison(TypedComparison::greaterThanOrEquals, function.Load(taskIndexVar), function.Literal<int>(0));
+            function.If(found, [=](IRFunctionEmitter& function) {
+                          this->DecrementUnscheduledTasks(function);
+                          function.Store(keepLookingVar, function.FalseBit());
+                      })
+                .Else([=](IRFunctionEmitter& function) {
+                    // All deques are empty: sleep until more tasks are started, or until the pool is shut down.
+                    // If some tasks are still unscheduled, another thread is in the middle of taking them and we just look again.
+                    auto queueMutex = this->GetQueueMutexPointer(function);
+                    auto workAvailableCondVar = this->GetWorkAvailableConditionVariablePointer(function);
+                    this->SpinWait(function, [this](IRFunctionEmitter& function) { return function.Operator(UnaryOperatorType::logicalNot, IsEmpty(function)); });
+                    this->LockQueueMutex(function);
+                    function.Store(isIdleVar, function.Operator(TypedOperator::logicalAnd, this->IsEmpty(function), function.Operator(UnaryOperatorType::logicalNot, this->GetShutdownFlag(function))));
+                    function.While(isIdleVar, [=](IRFunctionEmitter& function) {
+                        function.PthreadCondWait(workAvailableCondVar, queueMutex);
+                        function.Store(isIdleVar, function.Operator(TypedOperator::logicalAnd, this->IsEmpty(function), function.Operator(UnaryOperatorType::logicalNot, this->GetShutdownFlag(function))));
+                    });
+                    function.If(this->GetShutdownFlag(function), [=](IRFunctionEmitter& function) {
+                        function.Store(keepLookingVar, function.FalseBit());
+                    });
+                    this->UnlockQueueMutex(function);
+                });
+        });
+
+        // A negative index (if we're shutting down) returns a null task
+        return _tasks.GetTask(function, function.Load(taskIndexVar));
+    }
+
+    LLVMValue IRThreadPoolTaskQueue::TryTakeTask(IRFunctionEmitter& function, LLVMValue workerRangePtr, LLVMValue isOwner)
+    {
+        auto& context = function.GetLLVMContext();
+        auto boolType = llvm::Type::getInt1Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+
+        auto takenIndexVar = function.Variable(int32Type, "takenTaskIndex");
+        auto retryVar = function.Variable(boolType, "retry");
+        function.Store(takenIndexVar, function.Literal<int>(-1));
+        function.Store(retryVar, function.TrueBit());
+        function.While(retryVar, [=](IRFunctionEmitter& function) {
+            auto range = function.AtomicLoad(workerRangePtr);
+            auto begin = function.CastValue(function.Operator(TypedOperator::logicalShiftRight, range, function.Literal<int64_t>(taskRangeShift)), int32Type);
+            auto end = function.CastValue(range, int32Type);
+            function.If(function.Comparison(TypedComparison::greaterThanOrEquals, begin, end), [=](IRFunctionEmitter& function) {
+                        function.Store(retryVar, function.FalseBit());
+                    })
+                .Else([=](IRFunctionEmitter& function) {
+                    // The owner takes tasks from the front of its deque, thieves take them from the back.
+                    // If another thread modified the deque since we loaded it, the exchange fails and we try again.
+                    auto newBegin = function.Select(isOwner, function.Operator(TypedOperator::add, begin, function.Literal<int>(1)), begin);
+                    auto newEnd = function.Select(isOwner, end, function.Operator(TypedOperator::subtract, end, function.Literal<int>(1)));
+                    auto succeeded = function.AtomicCompareExchange(workerRangePtr, range, PackTaskRange(function, newBegin, newEnd));
+                    function.If(succeeded, [=](IRFunctionEmitter& function) {
+                        function.Store(takenIndexVar, function.Select(isOwner, begin, newEnd));
+                        function.Store(retryVar, function.FalseBit());
+                    });
+                });
+        });
+        return function.Load(takenIndexVar);
+    }
+
+    void IRThreadPoolTaskQueue::SetWorkerTaskRanges(IRFunctionEmitter& function, int numTasks)
+    {
+        assert(UseWorkStealing());
+
+        // Split the tasks into contiguous, evenly-sized blocks, one per worker
+        for (int workerIndex = 0; workerIndex < _numWorkers; ++workerIndex)
+        {
+            const int64_t begin = (static_cast<int64_t>(workerIndex) * numTasks) / _numWorkers;
+            const int64_t end = (static_cast<int64_t>(workerIndex + 1) * numTasks) / _numWorkers;
+            auto workerRangePtr = function.PointerOffset(_workerTaskRanges, function.Literal<int>(workerIndex));
+            function.AtomicStore(workerRangePtr, function.Literal<int64_t>((begin << taskRangeShift) | end));
+        }
+    }
+
     bool IRThreadPoolTaskQueue::IsInitialized() const
     {
         return _queueData != nullptr;
@@ -271,6 +575,16 @@ namespace emitters
 
     void IRThreadPoolTaskQueue::ShutDown(IRFunctionEmitter& function)
     {
+        if (UseWorkStealing())
+        {
+            // Idle workers check the flag while holding the lock, so set it under the lock to avoid missed wakeups
+            LockQueueMutex(function);
+            SetShutdownFlag(function);
+            function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
+            UnlockQueueMutex(function);
+            return;
+        }
+
         SetShutdownFlag(function);
 
         // Now wake up the threads so they see it is time to shutdown.
@@ -288,6 +602,7 @@ namespace emitters
         auto mutex = GetQueueMutexPointer(function);
         auto workFinishedCondVar = GetWorkFinishedConditionVariablePointer(function);
 
+        SpinWait(function, [this](IRFunctionEmitter& function) { return IsFinished(function); });
         LockQueueMutex(function);
         function.Store(isNotDoneVar, function.Operator(UnaryOperatorType::logicalNot, IsFinished(function)));
         function.While(isNotDoneVar, [=](auto& function) {
@@ -331,38 +646,94 @@ namespace emitters
     {
         assert(IsInitialized());
         auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
-        return function.Load(fieldPtr);
+        return UseAtomicCounts() ? function.AtomicLoad(fieldPtr) : function.Load(fieldPtr);
     }
 
     LLVMValue IRThreadPoolTaskQueue::GetUnfinishedCount(IRFunctionEmitter& function) const
     {
         assert(IsInitialized());
         auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
-        return function.Load(fieldPtr);
+        return UseAtomicCounts() ? function.AtomicLoad(fieldPtr) : function.Load(fieldPtr);
     }
 
     void IRThreadPoolTaskQueue::SetInitialCount(IRFunctionEmitter& function, LLVMValue numTasks)
     {
         assert(IsInitialized());
+        if (UseAtomicCounts())
+        {
+            function.AtomicStore(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount)), numTasks);
+            function.AtomicStore(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount)), numTasks);
+            return;
+        }
         function.Store(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount)), numTasks);
         function.Store(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount)), numTasks);
     }
 
     LLVMValue IRThreadPoolTaskQueue::DecrementCountField(IRFunctionEmitter& function, LLVMValue fieldPtr)
     {
-        auto count = function.Load(fieldPtr);
+        // Called with the queue mutex held. The count is only accessed atomically so that spinning threads can poll it without the lock.
+        const bool useAtomics = UseAtomicCounts();
+        auto count = useAtomics ? function.AtomicLoad(fieldPtr) : function.Load(fieldPtr);
         auto newCount = function.Operator(TypedOperator::subtract, count, function.Literal<int>(1));
         auto isNotZero = function.Comparison(TypedComparison::notEquals, count, function.Literal<int>(0));
-        function.If(isNotZero, [=](auto& function) {
-            function.Store(fieldPtr, newCount);
+        function.If(isNotZero, [=](IRFunctionEmitter& function) {
+            if (useAtomics)
+            {
+                function.AtomicStore(fieldPtr, newCount);
+            }
+            else
+            {
+                function.Store(fieldPtr, newCount);
+            }
         });
         return newCount;
     }
 
+    void IRThreadPoolTaskQueue::SpinWait(IRFunctionEmitter& function, std::function<LLVMValue(IRFunctionEmitter&)> isDone)
+    {
+        if (_spinCount <= 0)
+        {
+            return;
+        }
+
+        auto& context = function.GetLLVMContext();
+        auto boolType = llvm::Type::getInt1Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+
+        auto spinningVar = function.Variable(boolType, "spinning");
+        auto spinsLeftVar = function.Variable(int32Type, "spinsLeft");
+        auto numPausesVar = function.Variable(int32Type, "numPauses");
+        function.Store(spinningVar, function.TrueBit());
+        function.Store(spinsLeftVar, function.Literal<int>(_spinCount));
+        function.Store(numPausesVar, function.Literal<int>(1));
+        function.While(spinningVar, [=](IRFunctionEmitter& function) {
+            auto spinsLeft = function.Load(spinsLeftVar);
+            auto outOfSpins = function.Comparison(TypedComparison::lessThanOrEquals, spinsLeft, function.Literal<int>(0));
+            function.If(function.Operator(TypedOperator::logicalOr, outOfSpins, isDone(function)), [=](IRFunctionEmitter& function) {
+                        function.Store(spinningVar, function.FalseBit());
+                    })
+                .Else([=](IRFunctionEmitter& function) {
+                    // Back off exponentially, so long waits don't hammer the cache line holding the counts
+                    auto numPauses = function.Load(numPausesVar);
+                    function.For(numPauses, [](IRFunctionEmitter& function, LLVMValue) {
+                        EmitCpuPause(function);
+                    });
+                    auto canGrow = function.Comparison(TypedComparison::lessThan, numPauses, function.Literal<int>(maxSpinPauses));
+                    function.Store(numPausesVar, function.Select(canGrow, function.Operator(TypedOperator::multiply, numPauses, function.Literal<int>(2)), numPauses));
+                    function.Store(spinsLeftVar, function.Operator(TypedOperator::subtract, spinsLeft, function.Literal<int>(1)));
+                });
+        });
+    }
+
     LLVMValue IRThreadPoolTaskQueue::DecrementUnscheduledTasks(IRFunctionEmitter& function)
     {
         assert(IsInitialized());
         auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
+        if (UseWorkStealing())
+        {
+            // A task has already been taken from a deque, so the count can't drop below zero
+            return function.Operator(TypedOperator::subtract, function.AtomicAdd(fieldPtr, function.Literal<int>(-1)), function.Literal<int>(1));
+        }
         return DecrementCountField(function, fieldPtr);
     }
 
@@ -370,6 +741,10 @@ namespace emitters
     {
         assert(IsInitialized());
         auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
+        if (UseWorkStealing())
+        {
+            return function.Operator(TypedOperator::subtract, function.AtomicAdd(fieldPtr, function.Literal<int>(-1)), function.Literal<int>(1));
+        }
         return DecrementCountField(function, fieldPtr);
     }
 
@@ -466,7 +841,9 @@ namespace emitters
         auto taskArrayDataType = GetTaskArrayDataType(module);
 
         // Allocate our data struct
-        _taskArrayData = module.Global(taskArrayDataType, "taskArrayData");
+        auto taskArrayData = module.Global(taskArrayDataType, "taskArrayData");
+        MarkGlobalShared(*taskArrayData);
+        _taskArrayData = taskArrayData;
     }
 
     llvm::StructType* IRThreadPoolTaskArray::GetTaskArrayDataType(IRModuleEmitter& module) // TODO: come up with a naming convention for "class" structs like this
@@ -13,6 +13,9 @@ namespace ell
 {
 namespace emitters
 {
+    const char* c_submitTaskFunctionName = "ELL_SubmitTask";
+    const char* c_waitForTaskFunctionName = "ELL_WaitForTask";
+
     //
     // Functions
     //
@@ -74,5 +77,20 @@ namespace emitters
     {
         return GetTaskWrapperFunction(module, taskFunction.GetFunction());
     }
+
+    LLVMFunction GetSubmitTaskFunction(IRModuleEmitter& module)
+    {
+        auto& context = module.GetLLVMContext();
+        auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto taskFunctionType = llvm::FunctionType::get(int8PtrType, { int8PtrType }, false);
+        auto functionType = llvm::FunctionType::get(int8PtrType, { taskFunctionType->getPointerTo(), int8PtrType, llvm::Type::getInt32Ty(context) }, false);
+        return module.DeclareFunction(c_submitTaskFunctionName, functionType);
+    }
+
+    LLVMFunction GetWaitForTaskFunction(IRModuleEmitter& module)
+    {
+        auto int8PtrType = llvm::Type::getInt8PtrTy(module.GetLLVMContext());
+        return module.DeclareFunction(c_waitForTaskFunctionName, llvm::FunctionType::get(int8PtrType, { int8PtrType }, false));
+    }
 } // namespace emitters
 } // namespace ell
@@ -9,8 +9,10 @@
 #include "LLVMUtilities.h"
 #include "EmitterException.h"
 
-#include <llvm/IR/Type.h>
+#include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
 namespace ell
@@ -33,6 +35,8 @@ namespace emitters
 
     emitters::TypedOperator GetOperator(LLVMType type, BinaryOperatorType operation)
     {
+        // Vectors use the operators of their elements
+        type = type->getScalarType();
         if (type->isIntegerTy() && type->getIntegerBitWidth() == 1)
         {
             return GetBooleanOperator(operation);
@@ -51,6 +55,7 @@ namespace emitters
 
     emitters::TypedComparison GetComparison(LLVMType type, BinaryPredicateType comparison)
     {
+        type = type->getScalarType();
         if (type->isIntegerTy())
         {
             return GetIntegerComparison(comparison);
@@ -62,5 +67,53 @@ namespace emitters
 
         throw EmitterException(EmitterError::valueTypeNotSupported);
     }
+
+    void ExpandConstantExpressionUses(llvm::Constant& constant)
+    {
+        std::vector<llvm::User*> users(constant.user_begin(), constant.user_end());
+        for (auto user : users)
+        {
+            auto expression = llvm::dyn_cast<llvm::ConstantExpr>(user);
+            if (expression == nullptr)
+            {
+                if (!llvm::isa<llvm::Instruction>(user))
+                {
+                    throw EmitterException(EmitterError::notSupported, "Can't replace the uses of " + constant.getName().str() + " with instructions, because a global initializer refers to it");
+                }
+                continue;
+            }
+
+            ExpandConstantExpressionUses(*expression);
+            std::vector<llvm::User*> expressionUsers(expression->user_begin(), expression->user_end());
+            for (auto expressionUser : expressionUsers)
+            {
+                auto instruction = llvm::dyn_cast<llvm::Instruction>(expressionUser);
+                if (instruction == nullptr)
+                {
+                    throw EmitterException(EmitterError::notSupported, "Can't replace the uses of " + constant.getName().str() + " with instructions, because a global initializer refers to it");
+                }
+
+                if (auto phi = llvm::dyn_cast<llvm::PHINode>(instruction))
+                {
+                    for (unsigned index = 0; index < phi->getNumIncomingValues(); ++index)
+                    {
+                        if (phi->getIncomingValue(index) == expression)
+                        {
+                            auto expanded = expression->getAsInstruction();
+                            expanded->insertBefore(phi->getIncomingBlock(index)->getTerminator());
+                            phi->setIncomingValue(index, expanded);
+                        }
+                    }
+                }
+                else
+                {
+                    auto expanded = expression->getAsInstruction();
+                    expanded->insertBefore(instruction);
+                    instruction->replaceUsesOfWith(expression, expanded);
+                }
+            }
+            expression->destroyConstant();
+        }
+    }
 } // namespace emitters
 } // namespace ell
@@ -34,11 +34,14 @@ namespace emitters
         std::string c_armv7Triple = "armv7--linux-gnueabihf"; // raspberry pi 3 and orangepi0
         std::string c_arm64Triple = "aarch64-unknown-linux-gnu"; // DragonBoard
         std::string c_iosTriple = "aarch64-apple-ios"; // alternates: "arm64-apple-ios7.0.0", "thumbv7-apple-ios7.0"
+        std::string c_cortexMTriple = "thumbv7em-none-eabihf"; // bare-metal Cortex-M4 / M7, with hardware floating point
 
         // CPUs
         std::string c_pi0Cpu = "arm1136jf-s";
         std::string c_pi3Cpu = "cortex-a53";
         std::string c_orangePi0Cpu = "cortex-a7";
+        std::string c_cortexM4Cpu = "cortex-m4";
+        std::string c_cortexM7Cpu = "cortex-m7";
 
         // clang settings:
         // target=armv7-apple-darwin
@@ -50,36 +53,58 @@ namespace emitters
         std::string c_arm64DataLayout = "e-m:e-i64:64-i128:128-n32:64-S128"; // DragonBoard
         std::string c_iosDataLayout = "e-m:o-i64:64-i128:128-n32:64-S128";
 
+        // Cache sizes set by the user are kept
+        void SetCacheSizes(TargetDevice& targetDevice, size_t l1CacheSize, size_t l2CacheSize, size_t cacheLineSize)
+        {
+            if (targetDevice.l1CacheSize == 0 && targetDevice.l2CacheSize == 0)
+            {
+                targetDevice.l1CacheSize = l1CacheSize;
+                targetDevice.l2CacheSize = l2CacheSize;
+            }
+            if (targetDevice.cacheLineSize == 0)
+            {
+                targetDevice.cacheLineSize = cacheLineSize;
+            }
+        }
+
+        const size_t c_kB = 1024;
+
         const std::map<std::string, std::function<void(TargetDevice&)>> KnownTargetDeviceMap = {
             { "mac", [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_macTriple;
                  targetDevice.dataLayout = c_macDataLayout;
+                 SetCacheSizes(targetDevice, 32 * c_kB, 256 * c_kB, 64);
              } },
             { "linux", [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_linuxTriple;
                  targetDevice.dataLayout = c_linuxDataLayout;
+                 SetCacheSizes(targetDevice, 32 * c_kB, 256 * c_kB, 64);
              } },
             { "windows", [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_windowsTriple;
                  targetDevice.dataLayout = c_windowsDataLayout;
+                 SetCacheSizes(targetDevice, 32 * c_kB, 256 * c_kB, 64);
              } },
             { "pi0", [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_armv6Triple;
                  targetDevice.dataLayout = c_armDataLayout;
                  targetDevice.numBits = 32;
                  targetDevice.cpu = c_pi0Cpu; // maybe not necessary
+                 SetCacheSizes(targetDevice, 16 * c_kB, 128 * c_kB, 32);
              } },
             { "pi3", [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_armv7Triple;
                  targetDevice.dataLayout = c_armDataLayout;
                  targetDevice.numBits = 32;
                  targetDevice.cpu = c_pi3Cpu; // maybe not necessary
+                 SetCacheSizes(targetDevice, 32 * c_kB, 512 * c_kB, 64);
              } },
             { "orangepi0" /* orangepi (Raspbian) */, [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_armv7Triple;
                  targetDevice.dataLayout = c_armDataLayout;
                  targetDevice.numBits = 32;
                  targetDevice.cpu = c_orangePi0Cpu; // maybe not necessary
+                 SetCacheSizes(targetDevice, 32 * c_kB, 256 * c_kB, 64);
              } },
             { "pi3_64" /* pi3 (openSUSE) */, [](TargetDevice& targetDevice) {
                  // need to set arch to aarch64?
@@ -87,16 +112,34 @@ namespace emitters
                  targetDevice.dataLayout = c_arm64DataLayout;
                  targetDevice.numBits = 64;
                  targetDevice.cpu = c_pi3Cpu;
+                 SetCacheSizes(targetDevice, 32 * c_kB, 512 * c_kB, 64);
              } },
             { "aarch64" /* arm64 linux (DragonBoard) */, [](TargetDevice& targetDevice) {
                  // need to set arch to aarch64?
                  targetDevice.triple = c_arm64Triple;
                  targetDevice.dataLayout = c_arm64DataLayout;
                  targetDevice.numBits = 64;
+                 SetCacheSizes(targetDevice, 32 * c_kB, 512 * c_kB, 64);
              } },
             { "ios", [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_iosTriple;
                  targetDevice.dataLayout = c_iosDataLayout;
+                 SetCacheSizes(targetDevice, 64 * c_kB, 3072 * c_kB, 64);
+             } },
+            { "cortex-m4", [](TargetDevice& targetDevice) {
+                 targetDevice.triple = c_cortexMTriple;
+                 targetDevice.dataLayout = c_armDataLayout;
+                 targetDevice.numBits = 32;
+                 targetDevice.cpu = c_cortexM4Cpu;
+                 targetDevice.features = "+dsp";
+             } },
+            { "cortex-m7", [](TargetDevice& targetDevice) {
+                 targetDevice.triple = c_cortexMTriple;
+                 targetDevice.dataLayout = c_armDataLayout;
+                 targetDevice.numBits = 32;
+                 targetDevice.cpu = c_cortexM7Cpu;
+                 targetDevice.features = "+dsp";
+                 SetCacheSizes(targetDevice, 16 * c_kB, 0, 32); // the data cache size is configurable, 16KB is common
              } }
         };
 
@@ -132,6 +175,17 @@ namespace emitters
         return tripleObj.getOS() == llvm::Triple::MacOSX || tripleObj.getOS() == llvm::Triple::Darwin;
     }
 
+    bool TargetDevice::HasDSPExtension() const
+    {
+        if (features.find("-dsp") != std::string::npos)
+        {
+            return false;
+        }
+        auto tripleObj = GetNormalizedTriple(triple);
+        auto isArm = tripleObj.getArch() == llvm::Triple::thumb || tripleObj.getArch() == llvm::Triple::arm;
+        return isArm && (features.find("+dsp") != std::string::npos || cpu == c_cortexM4Cpu || cpu == c_cortexM7Cpu || tripleObj.getArchName().startswith("thumbv7em"));
+    }
+
     TargetDevice GetTargetDevice(std::string deviceName)
     {
         TargetDevice target;
@@ -140,6 +194,11 @@ namespace emitters
         return target;
     }
 
+    bool IsKnownTargetDeviceName(const std::string& deviceName)
+    {
+        return deviceName == "host" || deviceName == "custom" || KnownTargetDeviceMap.find(deviceName) != KnownTargetDeviceMap.end();
+    }
+
     void CompleteTargetDevice(TargetDevice& targetDevice)
     {
         auto deviceName = targetDevice.deviceName;
@@ -211,6 +270,9 @@ namespace emitters
 
             llvm::DataLayout dataLayout(targetMachine->createDataLayout());
             targetDevice.dataLayout = dataLayout.getStringRepresentation();
+
+            // LLVM doesn't know the host's cache sizes, so assume a typical desktop core
+            SetCacheSizes(targetDevice, 32 * c_kB, 256 * c_kB, 64);
         }
 
         bool HasKnownDeviceName(TargetDevice& targetDevice)
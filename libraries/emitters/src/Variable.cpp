@@ -136,5 +136,24 @@ namespace emitters
             throw EmitterException(EmitterError::valueTypeNotSupported);
         }
     }
+
+    Variable* VariableAllocator::AddVectorViewVariable(VariableType type, Variable& src, int offset, int size)
+    {
+        switch (type)
+        {
+        case VariableType::Double:
+            return AddVariable<VectorViewVariable<double>>(src, offset, size);
+        case VariableType::Float:
+            return AddVariable<VectorViewVariable<float>>(src, offset, size);
+        case VariableType::Int32:
+            return AddVariable<VectorViewVariable<int>>(src, offset, size);
+        case VariableType::Int64:
+            return AddVariable<VectorViewVariable<int64_t>>(src, offset, size);
+        case VariableType::Byte:
+            return AddVariable<VectorViewVariable<uint8_t>>(src, offset, size);
+        default:
+            throw EmitterException(EmitterError::valueTypeNotSupported);
+        }
+    }
 } // namespace emitters
 } // namespace ell
@@ -7,8 +7,14 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <emitters/include/CompilerOptions.h>
+
 void TestIRAsyncTask(bool parallel);
 
 void TestParallelTasks(bool parallel, bool useThreadPool);
 
-void TestParallelFor(int start, int end, int increment, bool parallel);
+void TestExternalThreadPool();
+
+void TestParallelFor(int start, int end, int increment, bool parallel, bool useWorkStealing = false, int spinCount = 0, ell::emitters::ParallelLoopSchedule schedule = ell::emitters::ParallelLoopSchedule::staticBlocks);
+
+void TestThreadPoolWorkerCores();
@@ -9,4 +9,6 @@
 
 void TestIRAddFunction();
 void TestCompilableFunction();
+void TestApproximateMathFunctions();
+void TestCacheTileSizes();
 void TestStringCompareFunction();
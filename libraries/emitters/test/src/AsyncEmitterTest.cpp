@@ -16,7 +16,10 @@
 #include <emitters/include/IREmitter.h>
 #include <emitters/include/IRExecutionEngine.h>
 #include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRHeaderWriter.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRThreadPool.h>
+#include <emitters/include/IRThreadUtilities.h>
 #include <emitters/include/LLVMUtilities.h>
 
 #include <testing/include/testing.h>
@@ -24,8 +27,10 @@
 #include <iostream>
 #include <memory>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 using namespace ell;
 using namespace ell::emitters;
@@ -209,16 +214,120 @@ void TestParallelTasks(bool parallel, bool useThreadPool)
     }
 }
 
+//
+// TestExternalThreadPool
+//
+namespace
+{
+// A stand-in for the application's thread pool, which runs each task on a thread of its own
+struct ExternalTask
+{
+    std::thread thread;
+    void* result = nullptr;
+};
+
+std::vector<int> g_externalTaskPriorities;
+
+void* SubmitExternalTask(void* (*taskFunction)(void*), void* taskArgument, int32_t priority)
+{
+    g_externalTaskPriorities.push_back(priority);
+    auto task = new ExternalTask;
+    task->thread = std::thread([task, taskFunction, taskArgument] { task->result = taskFunction(taskArgument); });
+    return task;
+}
+
+void* WaitForExternalTask(void* handle)
+{
+    std::unique_ptr<ExternalTask> task(static_cast<ExternalTask*>(handle));
+    task->thread.join();
+    return task->result;
+}
+} // namespace
+
+void TestExternalThreadPool()
+{
+    const int priority = 2;
+    CompilerOptions options;
+    options.optimize = false;
+    options.targetDevice.deviceName = "host";
+    options.parallelize = true;
+    options.externalThreadPool = true;
+    options.taskPriority = priority;
+    IRModuleEmitter module("ExternalThreadPoolTest", options);
+
+    auto& context = module.GetLLVMContext();
+    LLVMType int32Type = llvm::Type::getInt32Ty(context);
+    LLVMType int32PtrType = int32Type->getPointerTo();
+
+    auto taskFunction = module.BeginFunction("ExternalTaskFunction", int32Type, { int32PtrType, int32Type, int32Type });
+    {
+        auto arguments = taskFunction.Arguments().begin();
+        auto arr = taskFunction.LocalArray(&(*arguments++));
+        auto begin = &(*arguments++);
+        auto end = &(*arguments++);
+        taskFunction.For(begin, end, [arr](emitters::IRFunctionEmitter& taskFunction, auto i) {
+            arr[i] = i;
+        });
+        taskFunction.Return(end);
+    }
+    module.EndFunction();
+
+    const int arraySize = 100;
+    const int numTasks = 4;
+    const int taskSize = arraySize / numTasks;
+    std::string testFunctionName = "TestExternalThreadPool";
+    auto testFunction = module.BeginFunction(testFunctionName, VariableType::Int32);
+    {
+        auto data = testFunction.Variable(VariableType::Int32, arraySize);
+        std::vector<std::vector<LLVMValue>> taskArrayArgs;
+        for (int index = 0; index < numTasks; ++index)
+        {
+            taskArrayArgs.push_back({ data, testFunction.Literal<int>(index * taskSize), testFunction.Literal<int>((index + 1) * taskSize) });
+        }
+        auto tasks = testFunction.StartTasks(taskFunction, taskArrayArgs);
+        tasks.WaitAll(testFunction);
+
+        // Sum the array the tasks filled in
+        auto sum = testFunction.Variable(VariableType::Int32, "sum");
+        testFunction.Store(sum, testFunction.Literal<int>(0));
+        testFunction.For(arraySize, [data, sum](emitters::IRFunctionEmitter& testFunction, auto i) {
+            testFunction.Store(sum, testFunction.LocalScalar(testFunction.Load(sum)) + testFunction.ValueAt(data, i));
+        });
+        testFunction.Return(testFunction.Load(sum));
+    }
+    module.EndFunction();
+
+    std::stringstream header;
+    WriteModuleHeader(header, module);
+    testing::ProcessTest("Testing external thread pool functions are declared in the header", header.str().find(c_submitTaskFunctionName) != std::string::npos && header.str().find(c_waitForTaskFunctionName) != std::string::npos);
+
+    auto submitTaskFunction = GetSubmitTaskFunction(module);
+    auto waitForTaskFunction = GetWaitForTaskFunction(module);
+    IRExecutionEngine executionEngine(std::move(module));
+    executionEngine.DefineFunction(submitTaskFunction, reinterpret_cast<uintptr_t>(&SubmitExternalTask));
+    executionEngine.DefineFunction(waitForTaskFunction, reinterpret_cast<uintptr_t>(&WaitForExternalTask));
+
+    g_externalTaskPriorities.clear();
+    auto function = (IntFunction)executionEngine.ResolveFunctionAddress(testFunctionName);
+    auto result = function();
+    testing::ProcessTest("Testing tasks run on the external thread pool", testing::IsEqual(result, arraySize * (arraySize - 1) / 2));
+    testing::ProcessTest("Testing tasks are submitted with the module's priority", g_externalTaskPriorities == std::vector<int>(numTasks, priority));
+}
+
 //
 // TestParallelFor
 //
-void TestParallelFor(int begin, int end, int increment, bool parallel)
+void TestParallelFor(int begin, int end, int increment, bool parallel, bool useWorkStealing, int spinCount, ParallelLoopSchedule schedule)
 {
     CompilerOptions options;
     options.optimize = false;
     options.targetDevice.deviceName = "host";
     options.parallelize = parallel;
     options.useThreadPool = true;
+    options.useWorkStealing = useWorkStealing;
+    options.threadPoolSpinCount = spinCount;
+    options.parallelLoopSchedule = schedule;
+    options.parallelLoopChunkSize = 3;
     IRModuleEmitter module("ParallelForTest", options);
 
     // Function to run test
@@ -258,7 +367,7 @@ void TestParallelFor(int begin, int end, int increment, bool parallel)
         // Call the function
         auto functionPtr = (IntFunction)executionEngine.ResolveFunctionAddress(functionName);
         auto result = functionPtr();
-        testing::ProcessTest("Testing compilable parallel for loop", testing::IsEqual(result, 0));
+        testing::ProcessTest(std::string("Testing compilable parallel for loop") + (useWorkStealing ? " with work stealing" : "") + (spinCount > 0 ? " with spin waiting" : "") + (schedule != ParallelLoopSchedule::staticBlocks ? " with " + ToString(schedule) + " schedule" : ""), testing::IsEqual(result, 0));
     }
     catch (utilities::Exception& exception)
     {
@@ -267,3 +376,38 @@ void TestParallelFor(int begin, int end, int increment, bool parallel)
         throw;
     }
 }
+
+void TestThreadPoolWorkerCores()
+{
+    CompilerOptions options;
+    options.maxThreads = 4;
+    testing::ProcessTest("Testing thread pool worker cores without affinity", testing::IsTrue(GetThreadPoolWorkerCores(options).empty()));
+
+    options.threadAffinity = ThreadAffinity::compact;
+    testing::ProcessTest("Testing compact thread pool worker cores", testing::IsEqual(GetThreadPoolWorkerCores(options), std::vector<int>{ 0, 1, 2, 3 }));
+
+    options.affinityCores = "4-7";
+    testing::ProcessTest("Testing compact thread pool worker cores on big cores", testing::IsEqual(GetThreadPoolWorkerCores(options), std::vector<int>{ 4, 5, 6, 7 }));
+
+    options.maxThreads = 6;
+    options.affinityCores = "0,1,8,9";
+    testing::ProcessTest("Testing compact thread pool worker cores with more workers than cores", testing::IsEqual(GetThreadPoolWorkerCores(options), std::vector<int>{ 0, 1, 8, 9, 0, 1 }));
+
+    options.maxThreads = 4;
+    options.threadAffinity = ThreadAffinity::scatter;
+    options.affinityCores = "0-3,8-11";
+    options.affinitySockets = 2;
+    testing::ProcessTest("Testing scatter thread pool worker cores", testing::IsEqual(GetThreadPoolWorkerCores(options), std::vector<int>{ 0, 8, 1, 9 }));
+
+    options.affinityCores = "0,x";
+    bool threwException = false;
+    try
+    {
+        GetThreadPoolWorkerCores(options);
+    }
+    catch (const utilities::InputException&)
+    {
+        threwException = true;
+    }
+    testing::ProcessTest("Testing invalid thread pool affinity cores", threwException);
+}
@@ -17,11 +17,18 @@
 #include <emitters/include/IRExecutionEngine.h>
 #include <emitters/include/IRFunctionEmitter.h>
 #include <emitters/include/IRLocalScalar.h>
+#include <emitters/include/IRLoopTiling.h>
+#include <emitters/include/IRMath.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/TargetDevice.h>
 #include <emitters/include/Variable.h>
 
 #include <testing/include/testing.h>
 
+#include <utilities/include/TypeName.h>
+
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <ostream>
@@ -122,6 +129,69 @@ void TestCompilableFunction()
     testing::ProcessTest("Testing compilable function", testing::IsEqual(computedResult, compiledResult));
 }
 
+template <typename ValueType>
+void TestApproximateMathFunction(const std::string& name, std::function<IRLocalScalar(IRLocalScalar)> compileFunction, std::function<ValueType(ValueType)> computeFunction, ValueType tolerance)
+{
+    CompilerOptions options;
+    IRModuleEmitter module("ApproximateMath", options);
+
+    std::string functionName = name + "_" + utilities::GetTypeName<ValueType>();
+    NamedVariableTypeList args;
+    args.push_back({ "x", GetVariableType<ValueType>() });
+    auto function = module.BeginFunction(functionName, GetVariableType<ValueType>(), args);
+    auto result = compileFunction(function.LocalScalar(function.GetFunctionArgument("x")));
+    function.Return(result);
+    module.EndFunction();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledFunction = (ValueType(*)(ValueType))executionEngine.ResolveFunctionAddress(functionName);
+    bool ok = true;
+    for (int index = -400; index <= 400; ++index)
+    {
+        auto x = static_cast<ValueType>(index) / 16;
+        auto expected = computeFunction(x);
+        auto actual = compiledFunction(x);
+        if (std::abs(actual - expected) > tolerance * std::abs(expected))
+        {
+            ok = false;
+        }
+    }
+    testing::ProcessTest("Testing approximate " + functionName, ok);
+}
+
+void TestApproximateMathFunctions()
+{
+    TestApproximateMathFunction<float>("Exp", [](IRLocalScalar x) { return FastExp(x); }, [](float x) { return std::exp(x); }, 4e-7f);
+    TestApproximateMathFunction<float>("Tanh", [](IRLocalScalar x) { return FastTanh(x); }, [](float x) { return std::tanh(x); }, 4e-7f);
+    TestApproximateMathFunction<float>("Sigmoid", [](IRLocalScalar x) { return FastSigmoid(x); }, [](float x) { return 1 / (1 + std::exp(-x)); }, 6e-7f);
+    TestApproximateMathFunction<double>("Exp", [](IRLocalScalar x) { return FastExp(x); }, [](double x) { return std::exp(x); }, 1e-15);
+    TestApproximateMathFunction<double>("Tanh", [](IRLocalScalar x) { return FastTanh(x); }, [](double x) { return std::tanh(x); }, 1e-15);
+    TestApproximateMathFunction<double>("Sigmoid", [](IRLocalScalar x) { return FastSigmoid(x); }, [](double x) { return 1 / (1 + std::exp(-x)); }, 2e-15);
+}
+
+void TestCacheTileSizes()
+{
+    // A 256 x 256 loop nest that reads one float array and writes another
+    std::vector<LoopNestArrayAccess> arrays = { { { 0, 1 }, sizeof(float) }, { { 0, 1 }, sizeof(float) } };
+    auto pi3 = GetTargetDevice("pi3");
+    auto tileSizes = GetCacheTileSizes(pi3, { 256, 256 }, arrays);
+    auto workingSetSize = tileSizes[0] * tileSizes[1] * 2 * sizeof(float);
+    testing::ProcessTest("Testing cache tile sizes fit in the L1 cache", testing::IsEqual(tileSizes, std::vector<int>{ 32, 64 }) && workingSetSize <= pi3.l1CacheSize / 2);
+
+    auto l2TileSizes = GetCacheTileSizes(pi3, { 256, 256 }, arrays, CacheLevel::L2);
+    testing::ProcessTest("Testing cache tile sizes for the L2 cache", testing::IsEqual(l2TileSizes, std::vector<int>{ 128, 256 }));
+
+    // The innermost tile stays a cache line wide
+    auto narrowTileSizes = GetCacheTileSizes(pi3, { 4096, 256 }, { { { 0, 1 }, sizeof(float) }, { { 0 }, 8192 } });
+    testing::ProcessTest("Testing cache tile sizes keep the innermost tile a cache line wide", narrowTileSizes[1] >= static_cast<int>(pi3.cacheLineSize / sizeof(float)));
+
+    auto cortexM4TileSizes = GetCacheTileSizes(GetTargetDevice("cortex-m4"), { 256, 256 }, arrays);
+    testing::ProcessTest("Testing loops aren't tiled without a data cache", testing::IsEqual(cortexM4TileSizes, std::vector<int>{ 256, 256 }));
+
+    auto ranges = GetCacheTiledLoopRanges(pi3, { { 10, 266 }, { 0, 256 } }, arrays);
+    testing::ProcessTest("Testing cache tiled loop ranges", ranges.size() == 2 && ranges[0].begin == 10 && ranges[0].end == 266 && ranges[0].blockSize == 32 && ranges[1].blockSize == 64);
+}
+
 void TestStringCompareFunction()
 {
     CompilerOptions options;
@@ -151,3 +151,63 @@ void TestProfileRegion()
     testing::ProcessTest("Testing profile regions", testing::IsEqual(r1->count, 0));
     testing::ProcessTest("Testing profile regions", testing::IsEqual(r1->totalTime, 0.0));
 }
+
+void TestProfileRegionHardwareCounters()
+{
+    CompilerOptions options;
+    options.optimize = false;
+    options.profile = true;
+    options.profileHardwareCounters = true;
+    std::string moduleName = "CompilableFunction";
+    IRModuleEmitter module(moduleName, options);
+
+    std::string functionName = "TestProfileRegionHardwareCounters";
+    auto function = module.BeginFunction(functionName, VariableType::Void);
+    {
+        IRProfileRegion bigRegion(function, "BigRegion");
+        bigRegion.Enter();
+        int vecSize = 10000;
+        int numIter = 100;
+        auto vec = function.Variable(VariableType::Double, vecSize);
+        function.For(numIter, [vec, vecSize](IRFunctionEmitter& function, auto) {
+            auto dotSum = function.DotProduct(vecSize, vec, vec);
+            UNUSED(dotSum);
+        });
+        bigRegion.Exit();
+
+        IRProfileRegion emptyRegion(function, "EmptyRegion");
+        emptyRegion.Enter();
+        emptyRegion.Exit();
+    }
+    function.Return();
+    module.EndFunction();
+
+    auto getRegionInfoFunctionName = module.GetProfiler().GetGetRegionProfilingInfoFunctionName();
+    auto resetRegionsFunctionName = module.GetProfiler().GetResetRegionProfilingInfoFunctionName();
+
+    IRExecutionEngine executionEngine(std::move(module));
+
+    using VoidFunctionType = void (*)();
+    using GetRegionFunctionType = ProfileRegionInfo* (*)(int32_t);
+    auto compiledFunction = (VoidFunctionType)executionEngine.ResolveFunctionAddress(functionName);
+    auto getRegionInfoFunction = (GetRegionFunctionType)executionEngine.ResolveFunctionAddress(getRegionInfoFunctionName);
+    auto resetProfileResultsFunction = (VoidFunctionType)executionEngine.ResolveFunctionAddress(resetRegionsFunctionName);
+
+    compiledFunction();
+    compiledFunction();
+
+    // The counters read as zero if the machine doesn't let us read them, so we can only check them relative to each other
+    auto r0 = getRegionInfoFunction(0);
+    auto r1 = getRegionInfoFunction(1);
+    testing::ProcessTest("Testing hardware counter profile regions", testing::IsEqual(r0->count, 2) && testing::IsEqual(r1->count, 2));
+    testing::ProcessTest("Testing hardware counter profile regions", r0->cycles >= 0 && r0->instructions >= 0 && r0->l1CacheMisses >= 0 && r0->lastLevelCacheMisses >= 0 && r0->branchMisses >= 0);
+    testing::ProcessTest("Testing hardware counter profile regions", r0->cycles >= r1->cycles && r0->instructions >= r1->instructions);
+    if (r0->instructions > 0)
+    {
+        // 100 iterations of a 10000-element dot product retire at least a million instructions
+        testing::ProcessTest("Testing hardware counter profile regions", r0->instructions > 1000000);
+    }
+
+    resetProfileResultsFunction();
+    testing::ProcessTest("Testing hardware counter profile regions reset", testing::IsEqual(r0->cycles, static_cast<int64_t>(0)) && testing::IsEqual(r0->instructions, static_cast<int64_t>(0)) && testing::IsEqual(r0->branchMisses, static_cast<int64_t>(0)));
+}
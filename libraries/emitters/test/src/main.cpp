@@ -59,6 +59,8 @@ void TestIRFunction()
 {
     TestIRAddFunction();
     TestCompilableFunction();
+    TestApproximateMathFunctions();
+    TestCacheTileSizes();
 }
 
 void TestAsyncEmitter()
@@ -69,6 +71,7 @@ void TestAsyncEmitter()
     TestParallelTasks(false, false); // deferred mode (no threads)
     TestParallelTasks(true, false); // async mode (always spin up a new thread)
     // TestParallelTasks(true, true);   // threadpool mode -- threadpool sometimes crashes or hangs when run in the JIT
+    TestExternalThreadPool();
 
     //
     TestParallelFor(0, 100, 1, false);
@@ -83,6 +86,16 @@ void TestAsyncEmitter()
     TestParallelFor(10, 90, 2, true);
     TestParallelFor(10, 90, 3, true);
     TestParallelFor(30, 40, 11, true);
+    TestParallelFor(0, 100, 1, true, true);
+    TestParallelFor(10, 90, 3, true, true);
+    TestParallelFor(30, 40, 11, true, true);
+    TestParallelFor(0, 100, 1, true, false, 1000);
+    TestParallelFor(10, 90, 3, true, true, 1000);
+    TestParallelFor(0, 100, 1, true, false, 0, emitters::ParallelLoopSchedule::dynamic);
+    TestParallelFor(10, 90, 3, true, false, 0, emitters::ParallelLoopSchedule::dynamic);
+    TestParallelFor(0, 100, 1, true, false, 0, emitters::ParallelLoopSchedule::guided);
+    TestParallelFor(30, 40, 11, true, true, 0, emitters::ParallelLoopSchedule::guided);
+    TestThreadPoolWorkerCores();
 }
 
 void TestPosixEmitter()
@@ -94,6 +107,7 @@ void TestPosixEmitter()
 void TestProfiler()
 {
     TestProfileRegion();
+    TestProfileRegionHardwareCounters();
 }
 
 void TestStdlibEmitter()
@@ -15,10 +15,20 @@ namespace ell
 {
 namespace evaluators
 {
-    /// <summary> An evaluation aggregator that computes AUC. </summary>
+    /// <summary>
+    /// An evaluation aggregator that computes AUC. By default, the aggregator keeps every prediction and computes
+    /// the exact AUC. With a number of bins, it instead keeps weighted histograms of the positive and negative
+    /// predictions, so that its memory is constant and each update takes constant time. The histogram bins are
+    /// uniform in p / (1 + |p|), which maps the predictions to (-1, 1) without changing their order.
+    /// </summary>
     class AUCAggregator
     {
     public:
+        /// <summary> Constructs an instance of AUCAggregator. </summary>
+        ///
+        /// <param name="numBins"> The number of histogram bins, or 0 to compute the exact AUC. </param>
+        AUCAggregator(size_t numBins = 0);
+
         /// <summary> Updates this aggregator. </summary>
         ///
         /// <param name="prediction"> The real valued prediction. </param>
@@ -31,6 +41,11 @@ namespace evaluators
         /// <returns> The current value. </returns>
         std::vector<double> GetResult() const;
 
+        /// <summary> Adds the updates of another aggregator, which aggregated a different set of examples, to this aggregator. </summary>
+        ///
+        /// <param name="other"> The other aggregator. </param>
+        void Merge(const AUCAggregator& other);
+
         /// <summary> Resets the aggregator to its initial state. </summary>
         void Reset();
 
@@ -39,7 +54,17 @@ namespace evaluators
         /// <returns> The header string vector. </returns>
         std::vector<std::string> GetValueNames() const;
 
+        /// <summary>
+        /// Returns a bound on the difference between the current result and the exact AUC, which comes from the
+        /// pairs of positive and negative predictions that fall in the same histogram bin. The bound is 0 when
+        /// the aggregator computes the exact AUC.
+        /// </summary>
+        ///
+        /// <returns> The error bound. </returns>
+        double GetErrorBound() const;
+
     private:
+        size_t GetBin(double prediction) const;
         struct Aggregate
         {
             double prediction;
@@ -49,7 +74,10 @@ namespace evaluators
             bool operator<(const Aggregate& other) const;
         };
 
+        size_t _numBins;
         mutable std::vector<Aggregate> _aggregates; // mutable because Get() const has to sort this vector
+        std::vector<double> _positiveWeights;
+        std::vector<double> _negativeWeights;
     };
 } // namespace evaluators
 } // namespace ell
@@ -47,6 +47,16 @@ namespace evaluators
         ///
         /// <param name="os"> [in,out] The output stream. </param>
         virtual void Print(std::ostream& os) const = 0;
+
+        /// <summary>
+        /// Returns true if the next call to Evaluate runs the predictor, and false if the evaluation frequency skips it.
+        /// </summary>
+        ///
+        /// <returns> true if the next evaluation is due. </returns>
+        virtual bool IsEvaluationDue() const { return true; }
+
+        /// <summary> Counts a call to Evaluate that is not due, without the predictor that it would have skipped. </summary>
+        virtual void SkipEvaluation() {}
     };
 
     /// <summary> Evaluator parameters. </summary>
@@ -54,6 +64,18 @@ namespace evaluators
     {
         size_t evaluationFrequency;
         bool addZeroEvaluation;
+
+        /// <summary> The number of examples to evaluate, drawn at random from the dataset once, or 0 to evaluate all of them. </summary>
+        size_t subsampleSize = 0;
+
+        /// <summary> The number of threads that evaluate shards of the examples, or 0 to use all the hardware threads. </summary>
+        size_t numThreads = 1;
+
+        /// <summary> The number of histogram bins of the AUC aggregators made from these parameters, or 0 for the exact AUC. </summary>
+        size_t aucNumBins = 0;
+
+        /// <summary> If true, the predictor is compiled to native code before each evaluation (see `trainers::CompiledEvaluator`). </summary>
+        bool compilePredictor = false;
     };
 
     /// <summary> Implements an evaluator that holds a data set and a set of evaluation aggregators. </summary>
@@ -83,6 +105,16 @@ namespace evaluators
         /// <returns> The goodness of the most recent evaluation. </returns>
         double GetGoodness() const override;
 
+        /// <summary>
+        /// Returns true if the next call to Evaluate runs the predictor, and false if the evaluation frequency skips it.
+        /// </summary>
+        ///
+        /// <returns> true if the next evaluation is due. </returns>
+        bool IsEvaluationDue() const override;
+
+        /// <summary> Counts a call to Evaluate that is not due, without the predictor that it would have skipped. </summary>
+        void SkipEvaluation() override;
+
         /// <summary> Returns a vector of names that describe the evaluation values represented in this Evaluator. </summary>
         ///
         /// <returns> A vector of names. </returns>
@@ -100,10 +132,21 @@ namespace evaluators
         void Print(std::ostream& os) const override;
 
     protected:
+        using AggregatorTupleType = std::tuple<AggregatorTypes...>;
+
+        // the type of example used by this evaluator
+        using ExampleType = data::Example<typename PredictorType::DataVectorType, data::WeightLabel>;
+
         void EvaluateZero();
 
+        // Calls getPrediction(index, example) for each example, on shards of the examples that run in parallel, and
+        // aggregates the predictions if updateAggregators is true. Each shard updates its own copy of the aggregators,
+        // and the copies are merged in the order of the shards.
+        template <typename PredictionFunctionType>
+        void EvaluateExamples(PredictionFunctionType getPrediction, bool updateAggregators);
+
         template <size_t Index>
-        using AggregatorType = typename std::tuple_element<Index, std::tuple<AggregatorTypes...>>::type;
+        using AggregatorType = typename std::tuple_element<Index, AggregatorTupleType>::type;
 
         struct ElementUpdaterParameters
         {
@@ -124,6 +167,18 @@ namespace evaluators
             AggregatorT& _aggregator;
         };
 
+        template <typename AggregatorT>
+        class ElementMerger
+        {
+        public:
+            ElementMerger(AggregatorT& aggregator, const AggregatorT& other);
+            void operator()();
+
+        private:
+            AggregatorT& _aggregator;
+            const AggregatorT& _other;
+        };
+
         template <typename AggregatorT>
         class ElementResetter
         {
@@ -137,7 +192,10 @@ namespace evaluators
         };
 
         template <std::size_t Index>
-        auto GetElementUpdateFunction(const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>;
+        auto GetElementUpdateFunction(AggregatorTupleType& aggregators, const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>;
+
+        template <std::size_t Index>
+        auto GetElementMergeFunction(const AggregatorTupleType& other) -> ElementMerger<AggregatorType<Index>>;
 
         template <std::size_t Index>
         auto GetElementResetFunction() -> ElementResetter<AggregatorType<Index>>;
@@ -145,20 +203,23 @@ namespace evaluators
         template <std::size_t... Sequence>
         void DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...>);
 
+        template <std::size_t... Sequence>
+        void DispatchUpdate(AggregatorTupleType& aggregators, double prediction, double label, double weight, std::index_sequence<Sequence...>);
+
+        template <std::size_t... Sequence>
+        void DispatchMerge(const AggregatorTupleType& other, std::index_sequence<Sequence...>);
+
         template <std::size_t... Sequence>
         void Aggregate(std::index_sequence<Sequence...>);
 
         template <std::size_t... Sequence>
         std::vector<std::vector<std::string>> DispatchGetValueNames(std::index_sequence<Sequence...>) const;
 
-        // the type of example used by this evaluator
-        using ExampleType = data::Example<typename PredictorType::DataVectorType, data::WeightLabel>;
-
         // member variables
         data::Dataset<ExampleType> _dataset;
         EvaluatorParameters _evaluatorParameters;
         size_t _evaluateCounter = 0;
-        typename std::tuple<AggregatorTypes...> _aggregatorTuple;
+        AggregatorTupleType _aggregatorTuple;
         std::vector<std::vector<std::vector<double>>> _values;
     };
 
@@ -177,6 +238,13 @@ namespace evaluators
 
 #pragma region implementation
 
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <future>
+#include <random>
+#include <thread>
+
 namespace ell
 {
 namespace evaluators
@@ -189,6 +257,15 @@ namespace evaluators
     {
         static_assert(sizeof...(AggregatorTypes) > 0, "Evaluator must contains at least one aggregator");
 
+        // keep a fixed random subset, so that all the evaluations are comparable
+        auto subsampleSize = _evaluatorParameters.subsampleSize;
+        if (subsampleSize > 0 && subsampleSize < _dataset.NumExamples())
+        {
+            std::default_random_engine rng;
+            _dataset.RandomPermute(rng, subsampleSize);
+            _dataset = data::Dataset<ExampleType>(_dataset.GetAnyDataset(0, subsampleSize));
+        }
+
         if (_evaluatorParameters.addZeroEvaluation)
         {
             EvaluateZero();
@@ -204,20 +281,19 @@ namespace evaluators
             return;
         }
 
-        auto iterator = _dataset.GetExampleReferenceIterator();
-
-        while (iterator.IsValid())
-        {
-            const auto& example = iterator.Get();
+        EvaluateExamples([&predictor](size_t, const ExampleType& example) { return predictor.Predict(example.GetDataVector()); }, true);
+    }
 
-            double weight = example.GetMetadata().weight;
-            double label = example.GetMetadata().label;
-            double prediction = predictor.Predict(example.GetDataVector());
+    template <typename PredictorType, typename... AggregatorTypes>
+    bool Evaluator<PredictorType, AggregatorTypes...>::IsEvaluationDue() const
+    {
+        return (_evaluateCounter + 1) % _evaluatorParameters.evaluationFrequency == 0;
+    }
 
-            DispatchUpdate(prediction, label, weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
-            iterator.Next();
-        }
-        Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
+    template <typename PredictorType, typename... AggregatorTypes>
+    void Evaluator<PredictorType, AggregatorTypes...>::SkipEvaluation()
+    {
+        ++_evaluateCounter;
     }
 
     template <typename PredictorType, typename... AggregatorTypes>
@@ -277,19 +353,58 @@ namespace evaluators
     template <typename PredictorType, typename... AggregatorTypes>
     void Evaluator<PredictorType, AggregatorTypes...>::EvaluateZero()
     {
-        auto iterator = _dataset.GetExampleIterator();
+        EvaluateExamples([](size_t, const ExampleType&) { return 0.0; }, true);
+    }
 
-        while (iterator.IsValid())
-        {
-            const auto& example = iterator.Get();
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <typename PredictionFunctionType>
+    void Evaluator<PredictorType, AggregatorTypes...>::EvaluateExamples(PredictionFunctionType getPrediction, bool updateAggregators)
+    {
+        const size_t minExamplesPerThread = 1 << 10;
+        auto numExamples = _dataset.NumExamples();
+        auto numThreads = _evaluatorParameters.numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : _evaluatorParameters.numThreads;
+        auto numShards = std::max<size_t>(std::min<size_t>(numThreads, numExamples / minExamplesPerThread), 1);
+
+        // the labels and weights are read from the dataset's contiguous side table, which is brought up to date
+        // here, before the shards read it concurrently
+        const auto& dataset = _dataset;
+        const auto& labels = dataset.GetLabels();
+        const auto& weights = dataset.GetWeights();
+
+        // the aggregators are reset between evaluations, so copies of them start out empty
+        std::vector<AggregatorTupleType> shardAggregators(numShards - 1, _aggregatorTuple);
+        auto evaluateShard = [&](size_t shard) {
+            auto& aggregators = shard == 0 ? _aggregatorTuple : shardAggregators[shard - 1];
+            auto end = (shard + 1) * numExamples / numShards;
+            for (size_t index = shard * numExamples / numShards; index < end; ++index)
+            {
+                double prediction = getPrediction(index, dataset[index]);
+                if (updateAggregators)
+                {
+                    DispatchUpdate(aggregators, prediction, labels[index], weights[index], std::make_index_sequence<sizeof...(AggregatorTypes)>());
+                }
+            }
+        };
 
-            double weight = example.GetMetadata().weight;
-            double label = example.GetMetadata().label;
+        std::vector<std::future<void>> shards;
+        for (size_t shard = 1; shard < numShards; ++shard)
+        {
+            shards.push_back(utilities::GetHostThreadPool().AddTask(evaluateShard, shard));
+        }
+        evaluateShard(0);
+        for (auto& shard : shards)
+        {
+            utilities::GetHostThreadPool().GetResult(shard);
+        }
 
-            DispatchUpdate(0.0, label, weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
-            iterator.Next();
+        if (updateAggregators)
+        {
+            for (const auto& aggregators : shardAggregators)
+            {
+                DispatchMerge(aggregators, std::make_index_sequence<sizeof...(AggregatorTypes)>());
+            }
+            Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
         }
-        Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
     }
 
     template <typename PredictorType, typename... AggregatorTypes>
@@ -307,6 +422,21 @@ namespace evaluators
         _aggregator.Update(_params.prediction, _params.label, _params.weight);
     }
 
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <typename AggregatorT>
+    Evaluator<PredictorType, AggregatorTypes...>::ElementMerger<AggregatorT>::ElementMerger(AggregatorT& aggregator, const AggregatorT& other) :
+        _aggregator(aggregator),
+        _other(other)
+    {
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <typename AggregatorT>
+    void Evaluator<PredictorType, AggregatorTypes...>::ElementMerger<AggregatorT>::operator()()
+    {
+        _aggregator.Merge(_other);
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     template <typename AggregatorT>
     Evaluator<PredictorType, AggregatorTypes...>::ElementResetter<AggregatorT>::ElementResetter(AggregatorT& aggregator) :
@@ -323,9 +453,16 @@ namespace evaluators
 
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t Index>
-    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementUpdateFunction(const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>
+    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementUpdateFunction(AggregatorTupleType& aggregators, const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>
+    {
+        return { std::get<Index>(aggregators), params };
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t Index>
+    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementMergeFunction(const AggregatorTupleType& other) -> ElementMerger<AggregatorType<Index>>
     {
-        return { std::get<Index>(_aggregatorTuple), params };
+        return { std::get<Index>(_aggregatorTuple), std::get<Index>(other) };
     }
 
     template <typename PredictorType, typename... AggregatorTypes>
@@ -339,12 +476,27 @@ namespace evaluators
     template <std::size_t... Sequence>
     void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...>)
     {
-        // Call (X.Update(), 0) for each X in _aggregatorTuple
+        DispatchUpdate(_aggregatorTuple, prediction, label, weight, std::index_sequence<Sequence...>());
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t... Sequence>
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(AggregatorTupleType& aggregators, double prediction, double label, double weight, std::index_sequence<Sequence...>)
+    {
+        // Call (X.Update(), 0) for each X in aggregators
         ElementUpdaterParameters params{ prediction, label, weight };
-        utilities::InOrderFunctionEvaluator(GetElementUpdateFunction<Sequence>(params)...);
+        utilities::InOrderFunctionEvaluator(GetElementUpdateFunction<Sequence>(aggregators, params)...);
         // [this, prediction, label, weight]() { std::get<Sequence>(_aggregatorTuple).Update(prediction, label, weight); }...); // GCC bug prevents compilation
     }
 
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t... Sequence>
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchMerge(const AggregatorTupleType& other, std::index_sequence<Sequence...>)
+    {
+        // Call X.Merge() for each X in _aggregatorTuple
+        utilities::InOrderFunctionEvaluator(GetElementMergeFunction<Sequence>(other)...);
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t... Sequence>
     void Evaluator<PredictorType, AggregatorTypes...>::Aggregate(std::index_sequence<Sequence...>)
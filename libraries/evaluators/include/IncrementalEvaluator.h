@@ -117,29 +117,12 @@ namespace evaluators
         ++BaseClassType::_evaluateCounter;
         bool evaluate = BaseClassType::_evaluateCounter % BaseClassType::_evaluatorParameters.evaluationFrequency == 0 ? true : false;
 
-        auto iterator = BaseClassType::_dataset.GetExampleIterator();
-        size_t index = 0;
-
-        while (iterator.IsValid())
-        {
-            const auto& example = iterator.Get();
-
-            double exampleWeight = example.GetMetadata().weight;
-            double label = example.GetMetadata().label;
+        // the cached predictions are updated on every call, and aggregated only when the evaluation is due
+        auto updatePrediction = [&](size_t index, const typename BaseClassType::ExampleType& example) {
             _predictions[index] += basePredictorWeight * basePredictor.Predict(example.GetDataVector());
-
-            if (evaluate)
-            {
-                BaseClassType::DispatchUpdate(_predictions[index] * evaluationRescale, label, exampleWeight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
-            }
-
-            iterator.Next();
-            ++index;
-        }
-        if (evaluate)
-        {
-            BaseClassType::Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
-        }
+            return _predictions[index] * evaluationRescale;
+        };
+        BaseClassType::EvaluateExamples(updatePrediction, evaluate);
     }
 
     template <typename BasePredictorType, typename... AggregatorTypes>
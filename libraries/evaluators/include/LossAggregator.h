@@ -39,6 +39,11 @@ namespace evaluators
         /// <returns> The current value. </returns>
         std::vector<double> GetResult() const;
 
+        /// <summary> Adds the updates of another aggregator, which aggregated a different set of examples, to this aggregator. </summary>
+        ///
+        /// <param name="other"> The other aggregator. </param>
+        void Merge(const LossAggregator& other);
+
         /// <summary> Resets the aggregator to its initial state. </summary>
         void Reset();
 
@@ -85,6 +90,13 @@ namespace evaluators
         return { meanLoss };
     }
 
+    template <typename LossFunctionType>
+    void LossAggregator<LossFunctionType>::Merge(const LossAggregator& other)
+    {
+        _sumWeights += other._sumWeights;
+        _sumWeightedLosses += other._sumWeightedLosses;
+    }
+
     template <typename LossFunctionType>
     void LossAggregator<LossFunctionType>::Reset()
     {
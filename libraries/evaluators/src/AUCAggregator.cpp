@@ -8,39 +8,75 @@
 
 #include "AUCAggregator.h"
 
+#include <utilities/include/Exception.h>
+
 #include <algorithm>
+#include <cmath>
 
 namespace ell
 {
 namespace evaluators
 {
+    AUCAggregator::AUCAggregator(size_t numBins) :
+        _numBins(numBins),
+        _positiveWeights(numBins),
+        _negativeWeights(numBins)
+    {
+    }
+
     void AUCAggregator::Update(double prediction, double label, double weight)
     {
-        _aggregates.push_back(Aggregate{ prediction, label, weight });
+        if (_numBins == 0)
+        {
+            _aggregates.push_back(Aggregate{ prediction, label, weight });
+            return;
+        }
+
+        auto bin = GetBin(prediction);
+        if (label <= 0)
+        {
+            _negativeWeights[bin] += weight;
+        }
+        else
+        {
+            _positiveWeights[bin] += weight;
+        }
     }
 
     std::vector<double> AUCAggregator::GetResult() const
     {
-        // sort aggregates by prediction
-        std::sort(_aggregates.begin(), _aggregates.end());
-
-        // collect statistics
         double sumPositiveWeights = 0.0;
         double sumNegativeWeights = 0.0;
         double sumOrderedWeights = 0.0;
 
-        for (size_t i = 0; i < _aggregates.size(); ++i)
+        if (_numBins == 0)
         {
-            double weight = _aggregates[i].weight;
+            // sort aggregates by prediction
+            std::sort(_aggregates.begin(), _aggregates.end());
 
-            if (_aggregates[i].label <= 0)
+            // collect statistics
+            for (size_t i = 0; i < _aggregates.size(); ++i)
             {
-                sumNegativeWeights += weight;
+                double weight = _aggregates[i].weight;
+                if (_aggregates[i].label <= 0)
+                {
+                    sumNegativeWeights += weight;
+                }
+                else
+                {
+                    sumPositiveWeights += weight;
+                    sumOrderedWeights += sumNegativeWeights * weight;
+                }
             }
-            else
+        }
+        else
+        {
+            // like ties of exact predictions, the pairs in the same bin are not counted as ordered
+            for (size_t bin = 0; bin < _numBins; ++bin)
             {
-                sumPositiveWeights += weight;
-                sumOrderedWeights += sumNegativeWeights * weight;
+                sumOrderedWeights += sumNegativeWeights * _positiveWeights[bin];
+                sumPositiveWeights += _positiveWeights[bin];
+                sumNegativeWeights += _negativeWeights[bin];
             }
         }
 
@@ -54,9 +90,53 @@ namespace evaluators
         return { auc };
     }
 
+    double AUCAggregator::GetErrorBound() const
+    {
+        double sumPositiveWeights = 0.0;
+        double sumNegativeWeights = 0.0;
+        double sumTiedWeights = 0.0;
+        for (size_t bin = 0; bin < _numBins; ++bin)
+        {
+            sumTiedWeights += _positiveWeights[bin] * _negativeWeights[bin];
+            sumPositiveWeights += _positiveWeights[bin];
+            sumNegativeWeights += _negativeWeights[bin];
+        }
+
+        if (sumPositiveWeights > 0 && sumNegativeWeights > 0)
+        {
+            return sumTiedWeights / sumPositiveWeights / sumNegativeWeights;
+        }
+        return 0.0;
+    }
+
+    void AUCAggregator::Merge(const AUCAggregator& other)
+    {
+        if (other._numBins != _numBins)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Merged AUC aggregators must have the same number of bins");
+        }
+
+        _aggregates.insert(_aggregates.end(), other._aggregates.begin(), other._aggregates.end());
+        for (size_t bin = 0; bin < _numBins; ++bin)
+        {
+            _positiveWeights[bin] += other._positiveWeights[bin];
+            _negativeWeights[bin] += other._negativeWeights[bin];
+        }
+    }
+
     void AUCAggregator::Reset()
     {
         _aggregates.resize(0);
+        std::fill(_positiveWeights.begin(), _positiveWeights.end(), 0.0);
+        std::fill(_negativeWeights.begin(), _negativeWeights.end(), 0.0);
+    }
+
+    size_t AUCAggregator::GetBin(double prediction) const
+    {
+        // (p / (1 + |p|) + 1) / 2 is in [0, 1]
+        auto position = 0.5 * (prediction / (1.0 + std::abs(prediction)) + 1.0);
+        auto bin = static_cast<size_t>(position * static_cast<double>(_numBins));
+        return std::min(bin, _numBins - 1);
     }
 
     bool AUCAggregator::Aggregate::operator<(const Aggregate& other) const
@@ -51,6 +51,14 @@ namespace evaluators
         return { errorRate, precision, recall, f1 };
     }
 
+    void BinaryErrorAggregator::Merge(const BinaryErrorAggregator& other)
+    {
+        _sumTruePositives += other._sumTruePositives;
+        _sumTrueNegatives += other._sumTrueNegatives;
+        _sumFalsePositives += other._sumFalsePositives;
+        _sumFalseNegatives += other._sumFalseNegatives;
+    }
+
     void BinaryErrorAggregator::Reset()
     {
         _sumTruePositives = 0.0;
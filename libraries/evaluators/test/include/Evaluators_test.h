@@ -10,4 +10,6 @@
 namespace ell
 {
 void TestEvaluators();
+void TestParallelEvaluator();
+void TestHistogramAUCAggregator();
 }
\ No newline at end of file
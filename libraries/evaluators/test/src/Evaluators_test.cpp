@@ -20,7 +20,9 @@
 
 #include <testing/include/testing.h>
 
+#include <cmath>
 #include <iostream>
+#include <random>
 
 namespace ell
 {
@@ -45,4 +47,81 @@ void TestEvaluators()
     std::cout << "Goodness: " << evaluator->GetGoodness() << std::endl;
     testing::ProcessTest("Evaluator sanity check", !testing::IsEqual(evaluator->GetGoodness(), 0.0, 1e-8));
 }
+
+void TestParallelEvaluator()
+{
+    // enough examples for several shards
+    using ExampleType = data::DenseSupervisedDataset::DatasetExampleType;
+    data::DenseSupervisedDataset dataset;
+    std::default_random_engine random(1234);
+    std::normal_distribution<double> distribution;
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        double x0 = distribution(random);
+        double x1 = distribution(random);
+        dataset.AddExample(ExampleType{ { x0, x1 }, data::WeightLabel{ 1.0, x0 + 0.5 * distribution(random) > 0 ? 1.0 : -1.0 } });
+    }
+
+    using PredictorType = predictors::LinearPredictor<double>;
+    PredictorType predictor({ 1.0, 0.5 }, 0.1);
+    auto makeEvaluator = [&dataset](const evaluators::EvaluatorParameters& parameters) {
+        return evaluators::Evaluator<PredictorType, evaluators::BinaryErrorAggregator, evaluators::AUCAggregator, evaluators::LossAggregator<functions::SquaredLoss>>(dataset.GetAnyDataset(0, dataset.NumExamples()), parameters, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+    };
+
+    auto serialEvaluator = makeEvaluator({ 1, true });
+    auto parallelEvaluator = makeEvaluator({ 1, true, 0, 4 });
+    serialEvaluator.Evaluate(predictor);
+    parallelEvaluator.Evaluate(predictor);
+
+    const auto& serialValues = serialEvaluator.GetValues();
+    const auto& parallelValues = parallelEvaluator.GetValues();
+    bool isEqual = serialValues.size() == 2 && parallelValues.size() == 2;
+    for (size_t i = 0; isEqual && i < serialValues.size(); ++i)
+    {
+        for (size_t j = 0; j < serialValues[i].size(); ++j)
+        {
+            isEqual = isEqual && testing::IsEqual(serialValues[i][j], parallelValues[i][j], 1e-10);
+        }
+    }
+    testing::ProcessTest("Parallel evaluator matches serial evaluator", isEqual);
+
+    // the frequency skips evaluations, and a subsample approximates the full evaluation
+    auto subsampleEvaluator = makeEvaluator({ 2, false, 2000, 2 });
+    testing::ProcessTest("Evaluator skips evaluation", !subsampleEvaluator.IsEvaluationDue());
+    subsampleEvaluator.SkipEvaluation();
+    testing::ProcessTest("Evaluator evaluation is due", subsampleEvaluator.IsEvaluationDue());
+    subsampleEvaluator.Evaluate(predictor);
+    const auto& subsampleValues = subsampleEvaluator.GetValues();
+    testing::ProcessTest("Subsampled evaluator", subsampleValues.size() == 1 && std::abs(subsampleValues[0][1][0] - serialValues[1][1][0]) < 0.05);
+}
+
+void TestHistogramAUCAggregator()
+{
+    std::default_random_engine random(4321);
+    std::normal_distribution<double> distribution;
+    evaluators::AUCAggregator exactAggregator;
+    evaluators::AUCAggregator histogramAggregator(1 << 12);
+    std::vector<evaluators::AUCAggregator> shardAggregators(4, evaluators::AUCAggregator(1 << 12));
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        double label = i % 3 == 0 ? 1.0 : -1.0;
+        double prediction = 3.0 * distribution(random) + label;
+        double weight = 1.0 + (i % 2);
+        exactAggregator.Update(prediction, label, weight);
+        histogramAggregator.Update(prediction, label, weight);
+        shardAggregators[i % shardAggregators.size()].Update(prediction, label, weight);
+    }
+
+    for (size_t shard = 1; shard < shardAggregators.size(); ++shard)
+    {
+        shardAggregators[0].Merge(shardAggregators[shard]);
+    }
+
+    auto exactAUC = exactAggregator.GetResult()[0];
+    auto histogramAUC = histogramAggregator.GetResult()[0];
+    auto errorBound = histogramAggregator.GetErrorBound();
+    testing::ProcessTest("Histogram AUC error bound", errorBound > 0 && errorBound < 0.01 && exactAggregator.GetErrorBound() == 0);
+    testing::ProcessTest("Histogram AUC within error bound", histogramAUC <= exactAUC && exactAUC - histogramAUC <= errorBound);
+    testing::ProcessTest("Merged histogram AUC", testing::IsEqual(shardAggregators[0].GetResult()[0], histogramAUC, 1e-12));
+}
 } // namespace ell
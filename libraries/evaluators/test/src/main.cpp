@@ -24,6 +24,8 @@ int main()
     try
     {
         TestEvaluators();
+        TestParallelEvaluator();
+        TestHistogramAUCAggregator();
     }
     catch (const utilities::Exception& exception)
     {
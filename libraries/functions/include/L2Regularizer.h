@@ -40,6 +40,16 @@ namespace functions
         /// <param name="w"> The output. </param>
         void ConjugateGradient(math::ConstColumnVectorReference<double> v, math::ColumnVectorReference<double> w) const;
 
+        /// <summary>
+        /// Computes the conjugate gradient function of a single coordinate. The regularizer is a sum of functions of
+        /// its coordinates, so each coordinate of the conjugate gradient depends only on the same coordinate of v.
+        /// </summary>
+        ///
+        /// <param name="v"> The coordinate of v. </param>
+        ///
+        /// <returns> The coordinate of the output vector. </returns>
+        double ConjugateGradient(double v) const;
+
         /// <summary>
         /// Computes the conjugate gradient function. Namely, Given vector v, compute g = argmax_w {v'*w - f(w)} = argmin_w {-v'*w + f(w)}
         /// </summary>
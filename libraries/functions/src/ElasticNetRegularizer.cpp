@@ -77,35 +77,31 @@ namespace functions
     {
         for (size_t j = 0; j < v.Size(); ++j)
         {
-            double z = v[j] - _ratioL1L2;
-            if (z > 0)
-            {
-                w[j] = z;
-                continue;
-            }
+            w[j] = ConjugateGradient(v[j]);
+        }
+    }
 
-            z = v[j] + _ratioL1L2;
-            if (z < 0)
-            {
-                w[j] = z;
-            }
+    double ElasticNetRegularizer::ConjugateGradient(double v) const
+    {
+        double z = v - _ratioL1L2;
+        if (z > 0)
+        {
+            return z;
+        }
 
-            w[j] = 0;
+        z = v + _ratioL1L2;
+        if (z < 0)
+        {
+            return z;
         }
+
+        return 0;
     }
 
     void ElasticNetRegularizer::ConjugateGradient(math::ConstColumnVectorReference<double> v, double d, math::ColumnVectorReference<double> w, double& b) const
     {
         ConjugateGradient(v, w);
-        b = d - _ratioL1L2;
-        if (b < 0)
-        {
-            b = d + _ratioL1L2;
-            if (b > 0)
-            {
-                b = 0;
-            }
-        }
+        b = ConjugateGradient(d);
     }
 } // namespace functions
 } // namespace ell
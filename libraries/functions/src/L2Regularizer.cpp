@@ -27,6 +27,11 @@ namespace functions
         w.CopyFrom(v);
     }
 
+    double L2Regularizer::ConjugateGradient(double v) const
+    {
+        return v;
+    }
+
     void L2Regularizer::ConjugateGradient(math::ConstColumnVectorReference<double> v, double d, math::ColumnVectorReference<double> w, double& b) const
     {
         w.CopyFrom(v);
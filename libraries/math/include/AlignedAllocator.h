@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     AlignedAllocator.h (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> The alignment, in bytes, of the storage of Vector, Matrix and Tensor: a cache line, which is also enough for any SIMD load. </summary>
+    constexpr size_t storageAlignment = 64;
+
+    /// <summary> An allocator for stl containers that aligns the storage it allocates. </summary>
+    ///
+    /// <typeparam name="T"> The type of element being allocated. </typeparam>
+    /// <typeparam name="alignment"> The alignment of the storage, in bytes. Must be a power of 2. </typeparam>
+    template <typename T, size_t alignment = storageAlignment>
+    class AlignedAllocator
+    {
+    public:
+        static_assert((alignment & (alignment - 1)) == 0 && alignment >= alignof(T), "alignment must be a power of 2, and at least the alignment of T");
+
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, alignment>;
+        };
+
+        AlignedAllocator() = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, alignment>&) noexcept
+        {}
+
+        /// <summary> Allocates aligned storage for a number of elements. </summary>
+        ///
+        /// <param name="size"> The number of elements. </param>
+        ///
+        /// <returns> A pointer to the storage. </returns>
+        T* allocate(size_t size);
+
+        /// <summary> Frees storage returned by allocate. </summary>
+        ///
+        /// <param name="pData"> The pointer returned by allocate. </param>
+        /// <param name="size"> The number of elements that was allocated. </param>
+        void deallocate(T* pData, size_t size) noexcept;
+    };
+
+    template <typename T, typename U, size_t alignment>
+    bool operator==(const AlignedAllocator<T, alignment>&, const AlignedAllocator<U, alignment>&) noexcept
+    {
+        return true;
+    }
+
+    template <typename T, typename U, size_t alignment>
+    bool operator!=(const AlignedAllocator<T, alignment>&, const AlignedAllocator<U, alignment>&) noexcept
+    {
+        return false;
+    }
+
+    /// <summary> The storage type of Vector, Matrix and Tensor: a std::vector whose data is aligned to storageAlignment. </summary>
+    template <typename ElementType>
+    using AlignedVector = std::vector<ElementType, AlignedAllocator<ElementType>>;
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace math
+{
+    template <typename T, size_t alignment>
+    T* AlignedAllocator<T, alignment>::allocate(size_t size)
+    {
+        return static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t{ alignment }));
+    }
+
+    template <typename T, size_t alignment>
+    void AlignedAllocator<T, alignment>::deallocate(T* pData, size_t /*size*/) noexcept
+    {
+        ::operator delete(pData, std::align_val_t{ alignment });
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
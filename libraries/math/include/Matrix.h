@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "AlignedAllocator.h"
 #include "Vector.h"
 
 #include <utilities/include/IArchivable.h>
@@ -542,14 +543,6 @@ namespace math
         /// <param name="list"> A list of elements. These elements are expected to be in the layout order of this matrix's layout type. </param>
         Matrix(size_t numRows, size_t numColumns, const std::vector<ElementType>& data);
 
-        /// <summary> Constructs a matrix from an vector. The vector has
-        /// (numRows * numColumns) number of elements. </summary>
-        ///
-        /// <param name="numRows"> Number of rows in the matrix. </param>
-        /// <param name="numColumns"> Number of columns in the matrix. </param>
-        /// <param name="list"> A list of elements. These elements are expected to be in the layout order of this matrix's layout type. </param>
-        Matrix(size_t numRows, size_t numColumns, std::vector<ElementType>&& data);
-
         /// <summary> Move Constructor. </summary>
         ///
         /// <param name="other"> [in,out] The matrix being moved. </param>
@@ -583,7 +576,7 @@ namespace math
         /// <summary> Returns a copy of the contents of the Matrix. </summary>
         ///
         /// <returns> A std::vector with a copy of the contents of the Matrix. </returns>
-        std::vector<ElementType> ToArray() const { return _data; }
+        std::vector<ElementType> ToArray() const { return { _data.begin(), _data.end() }; }
 
         /// <summary> Swaps the contents of this matrix with the contents of another matrix. </summary>
         ///
@@ -593,7 +586,7 @@ namespace math
         /// @}
 
     private:
-        std::vector<ElementType> _data;
+        AlignedVector<ElementType> _data;
     };
 
     /// <summary> A class that implements helper functions for archiving/unarchiving Matrix instances. </summary>
@@ -1057,15 +1050,7 @@ namespace math
     template <typename ElementType, MatrixLayout layout>
     Matrix<ElementType, layout>::Matrix(size_t numRows, size_t numColumns, const std::vector<ElementType>& data) :
         MatrixReference<ElementType, layout>(nullptr, numRows, numColumns),
-        _data(data)
-    {
-        this->_pData = _data.data();
-    }
-
-    template <typename ElementType, MatrixLayout layout>
-    Matrix<ElementType, layout>::Matrix(size_t numRows, size_t numColumns, std::vector<ElementType>&& data) :
-        MatrixReference<ElementType, layout>(nullptr, numRows, numColumns),
-        _data(std::move(data))
+        _data(data.begin(), data.end())
     {
         this->_pData = _data.data();
     }
@@ -9,6 +9,7 @@
 
 #include "Common.h"
 #include "Matrix.h"
+#include "NativeKernels.h"
 #include "Vector.h"
 
 #ifdef USE_BLAS
@@ -425,6 +426,7 @@ namespace math
 
 #pragma region implementation
 
+#include "Parallel.h"
 #include "VectorOperations.h"
 
 #include <utilities/include/Debug.h>
@@ -1062,6 +1064,14 @@ namespace math
 
     namespace Internal
     {
+        // matrix products with less work than this (in multiply-adds) per task are not worth splitting off
+        constexpr size_t minDenseWorkPerTask = 1 << 18;
+
+        // the granularity of the split of the output of a matrix product between tasks. Row bands are multiples of
+        // the kernel's tile height, and column bands are multiples of its tile width
+        constexpr size_t denseRowsPerBlock = 4;
+        constexpr size_t denseColumnsPerBlock = 64;
+
         template <typename ElementType, MatrixLayout layout>
         void MatrixOperations<ImplementationType::native>::RankOneUpdate(ElementType scalar, ConstColumnVectorReference<ElementType> vectorA, ConstRowVectorReference<ElementType> vectorB, MatrixReference<ElementType, layout> matrix)
         {
@@ -1077,6 +1087,20 @@ namespace math
         template <typename ElementType, MatrixLayout layout>
         void MatrixOperations<ImplementationType::native>::MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB)
         {
+            if constexpr (layout == MatrixLayout::columnMajor)
+            {
+                // The columns are contiguous, so add each scaled column to the output
+                if (vectorB.GetIncrement() == 1)
+                {
+                    NativeKernels::Scale(scalarB, vectorB.GetDataPointer(), vectorB.Size());
+                    for (size_t j = 0; j < matrix.NumColumns(); ++j)
+                    {
+                        NativeKernels::Axpy(scalarA * vectorA[j], matrix.GetConstDataPointer() + j * matrix.GetIncrement(), vectorB.GetDataPointer(), vectorB.Size());
+                    }
+                    return;
+                }
+            }
+
             for (size_t i = 0; i < matrix.NumRows(); ++i)
             {
                 auto row = matrix.GetRow(i);
@@ -1093,14 +1117,65 @@ namespace math
         template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
         void MatrixOperations<ImplementationType::native>::MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarB, MatrixReference<ElementType, layoutC> matrixC)
         {
-            for (size_t i = 0; i < matrixA.NumRows(); ++i)
+            if constexpr (layoutC == MatrixLayout::columnMajor)
+            {
+                // C' = B' * A', where the transpose of C is row major
+                MultiplyScaleAddUpdate(scalarA, matrixB.Transpose(), matrixA.Transpose(), scalarB, matrixC.Transpose());
+            }
+            else
             {
-                for (size_t j = 0; j < matrixB.NumColumns(); ++j)
+                auto m = matrixA.NumRows();
+                auto n = matrixB.NumColumns();
+                auto k = matrixA.NumColumns();
+
+                // The kernel reads rows of B, so a column major B is copied to row major first
+                const ElementType* pB = matrixB.GetConstDataPointer();
+                size_t bRowIncrement = matrixB.GetIncrement();
+                AlignedVector<ElementType> rowMajorB;
+                if constexpr (layoutB == MatrixLayout::columnMajor)
                 {
-                    auto row = matrixA.GetRow(i);
-                    auto column = matrixB.GetColumn(j);
-                    matrixC(i, j) = scalarA * Dot(row, column) + scalarB * matrixC(i, j);
+                    rowMajorB.resize(k * n);
+                    for (size_t p = 0; p < k; ++p)
+                    {
+                        for (size_t j = 0; j < n; ++j)
+                        {
+                            rowMajorB[p * n + j] = matrixB(p, j);
+                        }
+                    }
+                    pB = rowMajorB.data();
+                    bRowIncrement = n;
                 }
+
+                // Each task updates a band of rows of C, or a band of columns if C has few rows. Every element of C
+                // is computed the same way regardless of the split, so the result doesn't depend on the number of threads
+                const auto pA = matrixA.GetConstDataPointer();
+                const auto aRowIncrement = matrixA.GetRowIncrement();
+                const auto aColumnIncrement = matrixA.GetColumnIncrement();
+                const auto pC = matrixC.GetDataPointer();
+                const auto cRowIncrement = matrixC.GetIncrement();
+                auto updateBlock = [&](size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd) {
+                    for (size_t i = rowBegin; i < rowEnd; ++i)
+                    {
+                        NativeKernels::Scale(scalarB, pC + i * cRowIncrement + columnBegin, columnEnd - columnBegin);
+                    }
+                    NativeKernels::MultiplyAddUpdate(rowEnd - rowBegin, columnEnd - columnBegin, k, scalarA, pA + rowBegin * aRowIncrement, aRowIncrement, aColumnIncrement, pB + columnBegin, bRowIncrement, pC + rowBegin * cRowIncrement + columnBegin, cRowIncrement);
+                };
+
+                const auto numRowBlocks = (m + denseRowsPerBlock - 1) / denseRowsPerBlock;
+                const auto numColumnBlocks = (n + denseColumnsPerBlock - 1) / denseColumnsPerBlock;
+                const auto splitRows = numRowBlocks >= numColumnBlocks;
+                const auto numBlocks = splitRows ? numRowBlocks : numColumnBlocks;
+                const auto numTasks = GetNumTasks(m * n * k, minDenseWorkPerTask, numBlocks);
+                ParallelForRanges(numBlocks, numTasks, [&](size_t, size_t begin, size_t end) {
+                    if (splitRows)
+                    {
+                        updateBlock(begin * denseRowsPerBlock, std::min(end * denseRowsPerBlock, m), 0, n);
+                    }
+                    else
+                    {
+                        updateBlock(0, m, begin * denseColumnsPerBlock, std::min(end * denseColumnsPerBlock, n));
+                    }
+                });
             }
         }
 
@@ -0,0 +1,398 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     NativeKernels.h (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> Vectorized kernels used by the native implementations of the vector and matrix operations, on contiguous data. </summary>
+    namespace NativeKernels
+    {
+        /// <summary> Wraps the SIMD register type of an element type. The generic version is a scalar, so the kernels still
+        /// work (unrolled) for element types, and targets, without a SIMD specialization. </summary>
+        ///
+        /// <typeparam name="ElementType"> The element type. </typeparam>
+        template <typename ElementType>
+        struct SimdRegister
+        {
+            using Type = ElementType;
+            static constexpr size_t width = 1;
+
+            static Type Zero() { return 0; }
+            static Type Broadcast(ElementType value) { return value; }
+            static Type Load(const ElementType* pData) { return *pData; }
+            static void Store(ElementType* pData, Type value) { *pData = value; }
+            static Type Add(Type a, Type b) { return a + b; }
+            static Type Subtract(Type a, Type b) { return a - b; }
+            static Type Multiply(Type a, Type b) { return a * b; }
+            static Type MultiplyAdd(Type a, Type b, Type c) { return a * b + c; }
+            static ElementType Sum(Type value) { return value; }
+        };
+
+        /// <summary> Computes the dot product of two contiguous arrays. </summary>
+        ///
+        /// <param name="pA"> The first array. </param>
+        /// <param name="pB"> The second array. </param>
+        /// <param name="size"> The number of elements in each array. </param>
+        ///
+        /// <returns> The dot product. </returns>
+        template <typename ElementType>
+        ElementType Dot(const ElementType* pA, const ElementType* pB, size_t size);
+
+        /// <summary> Adds a scaled contiguous array to another one: y += scalar * x. </summary>
+        ///
+        /// <param name="scalar"> The scalar that multiplies x. </param>
+        /// <param name="pX"> The array x. </param>
+        /// <param name="pY"> The array y, which is updated. </param>
+        /// <param name="size"> The number of elements in each array. </param>
+        template <typename ElementType>
+        void Axpy(ElementType scalar, const ElementType* pX, ElementType* pY, size_t size);
+
+        /// <summary> Multiplies a contiguous array by a scalar. </summary>
+        ///
+        /// <param name="scalar"> The scalar. </param>
+        /// <param name="pData"> The array, which is updated. </param>
+        /// <param name="size"> The number of elements in the array. </param>
+        template <typename ElementType>
+        void Scale(ElementType scalar, ElementType* pData, size_t size);
+
+        /// <summary> Computes C += scalar * A * B, where A is m x k, B is k x n, and C is m x n. The rows of B and C must be
+        /// contiguous, while A can have any layout. The product is blocked so that the panel of B in use stays in cache, and
+        /// computed in tiles of C that are kept in registers. </summary>
+        ///
+        /// <param name="m"> The number of rows of A and C. </param>
+        /// <param name="n"> The number of columns of B and C. </param>
+        /// <param name="k"> The number of columns of A and rows of B. </param>
+        /// <param name="scalar"> The scalar that multiplies the product. </param>
+        /// <param name="pA"> The first element of A. </param>
+        /// <param name="aRowIncrement"> The distance between consecutive rows of A. </param>
+        /// <param name="aColumnIncrement"> The distance between consecutive columns of A. </param>
+        /// <param name="pB"> The first element of B. </param>
+        /// <param name="bRowIncrement"> The distance between consecutive rows of B. </param>
+        /// <param name="pC"> The first element of C, which is updated. </param>
+        /// <param name="cRowIncrement"> The distance between consecutive rows of C. </param>
+        template <typename ElementType>
+        void MultiplyAddUpdate(size_t m, size_t n, size_t k, ElementType scalar, const ElementType* pA, size_t aRowIncrement, size_t aColumnIncrement, const ElementType* pB, size_t bRowIncrement, ElementType* pC, size_t cRowIncrement);
+    } // namespace NativeKernels
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace math
+{
+    namespace NativeKernels
+    {
+#if defined(__AVX__)
+        template <>
+        struct SimdRegister<float>
+        {
+            using Type = __m256;
+            static constexpr size_t width = 8;
+
+            static Type Zero() { return _mm256_setzero_ps(); }
+            static Type Broadcast(float value) { return _mm256_set1_ps(value); }
+            static Type Load(const float* pData) { return _mm256_loadu_ps(pData); }
+            static void Store(float* pData, Type value) { _mm256_storeu_ps(pData, value); }
+            static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+            static Type Subtract(Type a, Type b) { return _mm256_sub_ps(a, b); }
+            static Type Multiply(Type a, Type b) { return _mm256_mul_ps(a, b); }
+#if defined(__FMA__)
+            static Type MultiplyAdd(Type a, Type b, Type c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+            static Type MultiplyAdd(Type a, Type b, Type c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+            static float Sum(Type value)
+            {
+                __m128 sum = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+                sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+                sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+                return _mm_cvtss_f32(sum);
+            }
+        };
+
+        template <>
+        struct SimdRegister<double>
+        {
+            using Type = __m256d;
+            static constexpr size_t width = 4;
+
+            static Type Zero() { return _mm256_setzero_pd(); }
+            static Type Broadcast(double value) { return _mm256_set1_pd(value); }
+            static Type Load(const double* pData) { return _mm256_loadu_pd(pData); }
+            static void Store(double* pData, Type value) { _mm256_storeu_pd(pData, value); }
+            static Type Add(Type a, Type b) { return _mm256_add_pd(a, b); }
+            static Type Subtract(Type a, Type b) { return _mm256_sub_pd(a, b); }
+            static Type Multiply(Type a, Type b) { return _mm256_mul_pd(a, b); }
+#if defined(__FMA__)
+            static Type MultiplyAdd(Type a, Type b, Type c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+            static Type MultiplyAdd(Type a, Type b, Type c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+            static double Sum(Type value)
+            {
+                __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+                return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+            }
+        };
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        template <>
+        struct SimdRegister<float>
+        {
+            using Type = __m128;
+            static constexpr size_t width = 4;
+
+            static Type Zero() { return _mm_setzero_ps(); }
+            static Type Broadcast(float value) { return _mm_set1_ps(value); }
+            static Type Load(const float* pData) { return _mm_loadu_ps(pData); }
+            static void Store(float* pData, Type value) { _mm_storeu_ps(pData, value); }
+            static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+            static Type Subtract(Type a, Type b) { return _mm_sub_ps(a, b); }
+            static Type Multiply(Type a, Type b) { return _mm_mul_ps(a, b); }
+            static Type MultiplyAdd(Type a, Type b, Type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+            static float Sum(Type value)
+            {
+                value = _mm_add_ps(value, _mm_movehl_ps(value, value));
+                value = _mm_add_ss(value, _mm_shuffle_ps(value, value, 1));
+                return _mm_cvtss_f32(value);
+            }
+        };
+
+        template <>
+        struct SimdRegister<double>
+        {
+            using Type = __m128d;
+            static constexpr size_t width = 2;
+
+            static Type Zero() { return _mm_setzero_pd(); }
+            static Type Broadcast(double value) { return _mm_set1_pd(value); }
+            static Type Load(const double* pData) { return _mm_loadu_pd(pData); }
+            static void Store(double* pData, Type value) { _mm_storeu_pd(pData, value); }
+            static Type Add(Type a, Type b) { return _mm_add_pd(a, b); }
+            static Type Subtract(Type a, Type b) { return _mm_sub_pd(a, b); }
+            static Type Multiply(Type a, Type b) { return _mm_mul_pd(a, b); }
+            static Type MultiplyAdd(Type a, Type b, Type c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+            static double Sum(Type value) { return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value))); }
+        };
+#elif defined(__ARM_NEON)
+        template <>
+        struct SimdRegister<float>
+        {
+            using Type = float32x4_t;
+            static constexpr size_t width = 4;
+
+            static Type Zero() { return vdupq_n_f32(0); }
+            static Type Broadcast(float value) { return vdupq_n_f32(value); }
+            static Type Load(const float* pData) { return vld1q_f32(pData); }
+            static void Store(float* pData, Type value) { vst1q_f32(pData, value); }
+            static Type Add(Type a, Type b) { return vaddq_f32(a, b); }
+            static Type Subtract(Type a, Type b) { return vsubq_f32(a, b); }
+            static Type Multiply(Type a, Type b) { return vmulq_f32(a, b); }
+            static Type MultiplyAdd(Type a, Type b, Type c) { return vmlaq_f32(c, a, b); }
+            static float Sum(Type value)
+            {
+                float32x2_t sum = vadd_f32(vget_low_f32(value), vget_high_f32(value));
+                return vget_lane_f32(vpadd_f32(sum, sum), 0);
+            }
+        };
+
+#if defined(__aarch64__)
+        template <>
+        struct SimdRegister<double>
+        {
+            using Type = float64x2_t;
+            static constexpr size_t width = 2;
+
+            static Type Zero() { return vdupq_n_f64(0); }
+            static Type Broadcast(double value) { return vdupq_n_f64(value); }
+            static Type Load(const double* pData) { return vld1q_f64(pData); }
+            static void Store(double* pData, Type value) { vst1q_f64(pData, value); }
+            static Type Add(Type a, Type b) { return vaddq_f64(a, b); }
+            static Type Subtract(Type a, Type b) { return vsubq_f64(a, b); }
+            static Type Multiply(Type a, Type b) { return vmulq_f64(a, b); }
+            static Type MultiplyAdd(Type a, Type b, Type c) { return vfmaq_f64(c, a, b); }
+            static double Sum(Type value) { return vaddvq_f64(value); }
+        };
+#endif // defined(__aarch64__)
+#endif
+
+        template <typename ElementType>
+        ElementType Dot(const ElementType* pA, const ElementType* pB, size_t size)
+        {
+            using Register = SimdRegister<ElementType>;
+            constexpr size_t width = Register::width;
+
+            // Four independent accumulators hide the latency of the multiply-adds
+            auto sum0 = Register::Zero();
+            auto sum1 = Register::Zero();
+            auto sum2 = Register::Zero();
+            auto sum3 = Register::Zero();
+            size_t i = 0;
+            for (; i + 4 * width <= size; i += 4 * width)
+            {
+                sum0 = Register::MultiplyAdd(Register::Load(pA + i), Register::Load(pB + i), sum0);
+                sum1 = Register::MultiplyAdd(Register::Load(pA + i + width), Register::Load(pB + i + width), sum1);
+                sum2 = Register::MultiplyAdd(Register::Load(pA + i + 2 * width), Register::Load(pB + i + 2 * width), sum2);
+                sum3 = Register::MultiplyAdd(Register::Load(pA + i + 3 * width), Register::Load(pB + i + 3 * width), sum3);
+            }
+            for (; i + width <= size; i += width)
+            {
+                sum0 = Register::MultiplyAdd(Register::Load(pA + i), Register::Load(pB + i), sum0);
+            }
+
+            ElementType result = Register::Sum(Register::Add(Register::Add(sum0, sum1), Register::Add(sum2, sum3)));
+            for (; i < size; ++i)
+            {
+                result += pA[i] * pB[i];
+            }
+            return result;
+        }
+
+        template <typename ElementType>
+        void Axpy(ElementType scalar, const ElementType* pX, ElementType* pY, size_t size)
+        {
+            using Register = SimdRegister<ElementType>;
+            constexpr size_t width = Register::width;
+
+            auto scalarRegister = Register::Broadcast(scalar);
+            size_t i = 0;
+            for (; i + 2 * width <= size; i += 2 * width)
+            {
+                Register::Store(pY + i, Register::MultiplyAdd(scalarRegister, Register::Load(pX + i), Register::Load(pY + i)));
+                Register::Store(pY + i + width, Register::MultiplyAdd(scalarRegister, Register::Load(pX + i + width), Register::Load(pY + i + width)));
+            }
+            for (; i + width <= size; i += width)
+            {
+                Register::Store(pY + i, Register::MultiplyAdd(scalarRegister, Register::Load(pX + i), Register::Load(pY + i)));
+            }
+            for (; i < size; ++i)
+            {
+                pY[i] += scalar * pX[i];
+            }
+        }
+
+        template <typename ElementType>
+        void Scale(ElementType scalar, ElementType* pData, size_t size)
+        {
+            using Register = SimdRegister<ElementType>;
+            constexpr size_t width = Register::width;
+
+            auto scalarRegister = Register::Broadcast(scalar);
+            auto zero = Register::Zero();
+            size_t i = 0;
+            for (; i + width <= size; i += width)
+            {
+                Register::Store(pData + i, Register::MultiplyAdd(scalarRegister, Register::Load(pData + i), zero));
+            }
+            for (; i < size; ++i)
+            {
+                pData[i] *= scalar;
+            }
+        }
+
+        template <typename ElementType>
+        void MultiplyAddUpdate(size_t m, size_t n, size_t k, ElementType scalar, const ElementType* pA, size_t aRowIncrement, size_t aColumnIncrement, const ElementType* pB, size_t bRowIncrement, ElementType* pC, size_t cRowIncrement)
+        {
+            using Register = SimdRegister<ElementType>;
+            constexpr size_t width = Register::width;
+
+            // Each tile of C is tileRows x tileColumns, and fits in registers along with a row of B and an element of A
+            constexpr size_t tileRows = 4;
+            constexpr size_t tileColumns = 2 * width;
+
+            // A kBlockSize x nBlockSize panel of B stays in the L2 cache while it is used for every row of A
+            constexpr size_t kBlockSize = 128;
+            constexpr size_t nBlockSize = 64 * tileColumns;
+
+            auto a = [&](size_t row, size_t column) { return pA[row * aRowIncrement + column * aColumnIncrement]; };
+            auto scalarRegister = Register::Broadcast(scalar);
+
+            for (size_t kBegin = 0; kBegin < k; kBegin += kBlockSize)
+            {
+                auto kEnd = std::min(k, kBegin + kBlockSize);
+                for (size_t nBegin = 0; nBegin < n; nBegin += nBlockSize)
+                {
+                    auto nEnd = std::min(n, nBegin + nBlockSize);
+
+                    size_t i = 0;
+                    for (; i + tileRows <= m; i += tileRows)
+                    {
+                        size_t j = nBegin;
+                        for (; j + tileColumns <= nEnd; j += tileColumns)
+                        {
+                            typename Register::Type sums[tileRows][2];
+                            for (size_t r = 0; r < tileRows; ++r)
+                            {
+                                sums[r][0] = Register::Zero();
+                                sums[r][1] = Register::Zero();
+                            }
+
+                            for (size_t p = kBegin; p < kEnd; ++p)
+                            {
+                                auto b0 = Register::Load(pB + p * bRowIncrement + j);
+                                auto b1 = Register::Load(pB + p * bRowIncrement + j + width);
+                                for (size_t r = 0; r < tileRows; ++r)
+                                {
+                                    auto aValue = Register::Broadcast(a(i + r, p));
+                                    sums[r][0] = Register::MultiplyAdd(aValue, b0, sums[r][0]);
+                                    sums[r][1] = Register::MultiplyAdd(aValue, b1, sums[r][1]);
+                                }
+                            }
+
+                            for (size_t r = 0; r < tileRows; ++r)
+                            {
+                                auto pCTile = pC + (i + r) * cRowIncrement + j;
+                                Register::Store(pCTile, Register::MultiplyAdd(scalarRegister, sums[r][0], Register::Load(pCTile)));
+                                Register::Store(pCTile + width, Register::MultiplyAdd(scalarRegister, sums[r][1], Register::Load(pCTile + width)));
+                            }
+                        }
+
+                        // The columns left over at the end of the panel
+                        for (size_t r = 0; r < tileRows; ++r)
+                        {
+                            for (size_t column = j; column < nEnd; ++column)
+                            {
+                                ElementType sum = 0;
+                                for (size_t p = kBegin; p < kEnd; ++p)
+                                {
+                                    sum += a(i + r, p) * pB[p * bRowIncrement + column];
+                                }
+                                pC[(i + r) * cRowIncrement + column] += scalar * sum;
+                            }
+                        }
+                    }
+
+                    // The rows left over at the end of the matrix
+                    for (; i < m; ++i)
+                    {
+                        for (size_t p = kBegin; p < kEnd; ++p)
+                        {
+                            Axpy(scalar * a(i, p), pB + p * bRowIncrement + nBegin, pC + i * cRowIncrement + nBegin, nEnd - nBegin);
+                        }
+                    }
+                }
+            }
+        }
+    } // namespace NativeKernels
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Parallel.h (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Sets the number of threads used by the native implementations of the math operations, and by OpenBLAS. The
+    /// default is to use all the hardware threads.
+    /// </summary>
+    ///
+    /// <param name="numThreads"> The number of threads, or 0 to use all the hardware threads. </param>
+    void SetNumThreads(size_t numThreads);
+
+    /// <summary> Gets the number of threads used by the native implementations of the math operations. </summary>
+    ///
+    /// <returns> The number of threads, which is at least 1. </returns>
+    size_t GetNumThreads();
+
+    namespace Internal
+    {
+        /// <summary>
+        /// Gets the number of tasks to split an operation into, so that each task does at least a given amount of
+        /// work.
+        /// </summary>
+        ///
+        /// <param name="work"> The total amount of work. </param>
+        /// <param name="minWorkPerTask"> The smallest amount of work that is worth running on its own thread. </param>
+        /// <param name="maxTasks"> The maximal number of tasks, typically the number of independent parts of the output. </param>
+        /// <param name="numThreads"> (Optional) The maximal number of threads, or 0 to use GetNumThreads(). </param>
+        ///
+        /// <returns> The number of tasks, which is at least 1. </returns>
+        size_t GetNumTasks(size_t work, size_t minWorkPerTask, size_t maxTasks, size_t numThreads = 0);
+
+        /// <summary>
+        /// Calls task(taskIndex) for each taskIndex in [0, numTasks) on the shared math thread pool, and waits for
+        /// all of them to finish. The calling thread runs the first task, and helps with the rest while it waits. If
+        /// a task throws, one of the exceptions is rethrown on the calling thread.
+        /// </summary>
+        ///
+        /// <param name="numTasks"> The number of tasks. </param>
+        /// <param name="task"> The task, which receives its index. </param>
+        void ParallelFor(size_t numTasks, const std::function<void(size_t)>& task);
+
+        /// <summary>
+        /// Splits [0, count) into numTasks contiguous ranges, and calls task(taskIndex, begin, end) on each of them
+        /// in parallel.
+        /// </summary>
+        ///
+        /// <param name="count"> The size of the range to split. </param>
+        /// <param name="numTasks"> The number of tasks. </param>
+        /// <param name="task"> The task, which receives its index and its range. </param>
+        template <typename TaskType>
+        void ParallelForRanges(size_t count, size_t numTasks, TaskType task);
+    } // namespace Internal
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <algorithm>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        template <typename TaskType>
+        void ParallelForRanges(size_t count, size_t numTasks, TaskType task)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            const auto countPerTask = (count + numTasks - 1) / numTasks;
+            numTasks = (count + countPerTask - 1) / countPerTask;
+            if (numTasks == 1)
+            {
+                task(0, 0, count);
+                return;
+            }
+
+            ParallelFor(numTasks, [&](size_t taskIndex) {
+                auto begin = taskIndex * countPerTask;
+                task(taskIndex, begin, std::min(begin + countPerTask, count));
+            });
+        }
+    } // namespace Internal
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
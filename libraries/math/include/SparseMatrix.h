@@ -0,0 +1,423 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseMatrix.h (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// A reference to a constant sparse vector, stored as two parallel arrays: the indices of the nonzero elements,
+    /// in increasing order, and their values.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Vector element type. </typeparam>
+    /// <typeparam name="orientation"> The orientation. </typeparam>
+    template <typename ElementType, VectorOrientation orientation>
+    class ConstSparseVectorReference
+    {
+    public:
+        /// <summary> Constructs an instance of ConstSparseVectorReference. </summary>
+        ///
+        /// <param name="pIndices"> Pointer to the indices of the nonzero elements. </param>
+        /// <param name="pValues"> Pointer to the values of the nonzero elements. </param>
+        /// <param name="numNonzeros"> The number of nonzero elements. </param>
+        /// <param name="size"> The size of the vector. </param>
+        ConstSparseVectorReference(const size_t* pIndices, const ElementType* pValues, size_t numNonzeros, size_t size);
+
+        /// <summary> Gets the size of the vector, including its zeros. </summary>
+        ///
+        /// <returns> The size of the vector. </returns>
+        size_t Size() const { return _size; }
+
+        /// <summary> Gets the number of stored (nonzero) elements. </summary>
+        ///
+        /// <returns> The number of nonzero elements. </returns>
+        size_t NumNonzeros() const { return _numNonzeros; }
+
+        /// <summary> Gets a pointer to the indices of the nonzero elements. </summary>
+        ///
+        /// <returns> Pointer to the indices. </returns>
+        const size_t* GetIndicesPointer() const { return _pIndices; }
+
+        /// <summary> Gets a pointer to the values of the nonzero elements. </summary>
+        ///
+        /// <returns> Pointer to the values. </returns>
+        const ElementType* GetValuesPointer() const { return _pValues; }
+
+        /// <summary> Computes the squared 2-norm. </summary>
+        ///
+        /// <returns> The squared 2-norm. </returns>
+        ElementType Norm2Squared() const;
+
+        /// <summary> Gets a reference to the transpose of this vector. </summary>
+        ///
+        /// <returns> A reference to the transpose of this vector. </returns>
+        auto Transpose() const -> ConstSparseVectorReference<ElementType, TransposeVectorOrientation<orientation>::value>
+        {
+            // STYLE intentional deviation from project style - long implementation should be in the implementation region
+            return ConstSparseVectorReference<ElementType, TransposeVectorOrientation<orientation>::value>(_pIndices, _pValues, _numNonzeros, _size);
+        }
+
+    private:
+        const size_t* _pIndices;
+        const ElementType* _pValues;
+        size_t _numNonzeros;
+        size_t _size;
+    };
+
+    template <typename ElementType>
+    using ConstSparseRowVectorReference = ConstSparseVectorReference<ElementType, VectorOrientation::row>;
+
+    template <typename ElementType>
+    using ConstSparseColumnVectorReference = ConstSparseVectorReference<ElementType, VectorOrientation::column>;
+
+    /// <summary>
+    /// A reference to a constant compressed sparse matrix. A row major matrix is stored in CSR format and a column
+    /// major matrix in CSC format: the nonzeros of interval (row or column) i are stored at positions
+    /// [offsets[i], offsets[i+1]) of the indices and values arrays. The transpose of a CSR matrix is the CSC matrix
+    /// that shares its arrays, so both formats are always available without copying.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type. </typeparam>
+    /// <typeparam name="layout"> The layout: rowMajor for CSR and columnMajor for CSC. </typeparam>
+    template <typename ElementType, MatrixLayout layout>
+    class ConstSparseMatrixReference
+    {
+    public:
+        /// <summary> The orientation of the sparse vectors that the matrix intervals are stored as. </summary>
+        static constexpr VectorOrientation intervalOrientation = layout == MatrixLayout::rowMajor ? VectorOrientation::row : VectorOrientation::column;
+
+        /// <summary> Constructs an instance of ConstSparseMatrixReference. </summary>
+        ///
+        /// <param name="numRows"> Number of rows in the matrix. </param>
+        /// <param name="numColumns"> Number of columns in the matrix. </param>
+        /// <param name="pOffsets"> Pointer to the interval offsets, an array of size NumIntervals() + 1. </param>
+        /// <param name="pIndices"> Pointer to the minor indices of the nonzeros. </param>
+        /// <param name="pValues"> Pointer to the values of the nonzeros. </param>
+        ConstSparseMatrixReference(size_t numRows, size_t numColumns, const size_t* pOffsets, const size_t* pIndices, const ElementType* pValues);
+
+        /// <summary> Gets the number of rows. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of columns. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _numColumns; }
+
+        /// <summary> Gets the number of intervals: the number of rows of a CSR matrix or of columns of a CSC matrix. </summary>
+        ///
+        /// <returns> The number of intervals. </returns>
+        size_t NumIntervals() const { return layout == MatrixLayout::rowMajor ? _numRows : _numColumns; }
+
+        /// <summary> Gets the number of stored (nonzero) elements. </summary>
+        ///
+        /// <returns> The number of nonzero elements. </returns>
+        size_t NumNonzeros() const { return _pOffsets[NumIntervals()]; }
+
+        /// <summary> Gets the matrix layout. </summary>
+        ///
+        /// <returns> The matrix layout. </returns>
+        MatrixLayout GetLayout() const { return layout; }
+
+        /// <summary> Gets a pointer to the interval offsets. </summary>
+        ///
+        /// <returns> Pointer to the offsets. </returns>
+        const size_t* GetOffsetsPointer() const { return _pOffsets; }
+
+        /// <summary> Gets a pointer to the minor indices of the nonzeros. </summary>
+        ///
+        /// <returns> Pointer to the indices. </returns>
+        const size_t* GetIndicesPointer() const { return _pIndices; }
+
+        /// <summary> Gets a pointer to the values of the nonzeros. </summary>
+        ///
+        /// <returns> Pointer to the values. </returns>
+        const ElementType* GetValuesPointer() const { return _pValues; }
+
+        /// <summary> Gets a reference to an interval: a row of a CSR matrix or a column of a CSC matrix. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the interval. </param>
+        ///
+        /// <returns> A sparse vector reference to the interval. </returns>
+        ConstSparseVectorReference<ElementType, intervalOrientation> GetMajorVector(size_t index) const;
+
+        /// <summary> Gets a reference to the transpose of this matrix, which shares its storage and has the opposite layout. </summary>
+        ///
+        /// <returns> A reference to the transpose of this matrix. </returns>
+        auto Transpose() const -> ConstSparseMatrixReference<ElementType, TransposeMatrixLayout<layout>::value>
+        {
+            // STYLE intentional deviation from project style - long implementation should be in the implementation region
+            return ConstSparseMatrixReference<ElementType, TransposeMatrixLayout<layout>::value>(_numColumns, _numRows, _pOffsets, _pIndices, _pValues);
+        }
+
+    protected:
+        size_t _numRows;
+        size_t _numColumns;
+        const size_t* _pOffsets;
+        const size_t* _pIndices;
+        const ElementType* _pValues;
+    };
+
+    /// <summary> A compressed sparse matrix that owns its storage. </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type. </typeparam>
+    /// <typeparam name="layout"> The layout: rowMajor for CSR and columnMajor for CSC. </typeparam>
+    template <typename ElementType, MatrixLayout layout>
+    class SparseMatrix : public ConstSparseMatrixReference<ElementType, layout>
+    {
+    public:
+        /// <summary> Constructs an all-zeros sparse matrix of a given size. </summary>
+        ///
+        /// <param name="numRows"> Number of rows in the matrix. </param>
+        /// <param name="numColumns"> Number of columns in the matrix. </param>
+        SparseMatrix(size_t numRows = 0, size_t numColumns = 0);
+
+        /// <summary> Constructs a sparse matrix from its compressed arrays, which are moved into the matrix. </summary>
+        ///
+        /// <param name="numRows"> Number of rows in the matrix. </param>
+        /// <param name="numColumns"> Number of columns in the matrix. </param>
+        /// <param name="offsets"> The interval offsets: NumIntervals() + 1 nondecreasing values that start at 0 and end at the number of nonzeros. </param>
+        /// <param name="indices"> The minor indices of the nonzeros, increasing within each interval. </param>
+        /// <param name="values"> The values of the nonzeros. </param>
+        SparseMatrix(size_t numRows, size_t numColumns, std::vector<size_t> offsets, std::vector<size_t> indices, std::vector<ElementType> values);
+
+        /// <summary> Constructs a sparse matrix from the nonzero elements of a dense matrix. </summary>
+        ///
+        /// <typeparam name="denseLayout"> The layout of the dense matrix. </typeparam>
+        /// <param name="matrix"> The dense matrix. </param>
+        template <MatrixLayout denseLayout>
+        SparseMatrix(ConstMatrixReference<ElementType, denseLayout> matrix);
+
+        /// <summary> Copy Constructor. </summary>
+        ///
+        /// <param name="other"> The matrix being copied. </param>
+        SparseMatrix(const SparseMatrix<ElementType, layout>& other);
+
+        /// <summary> Move Constructor. </summary>
+        ///
+        /// <param name="other"> [in,out] The matrix being moved. </param>
+        SparseMatrix(SparseMatrix<ElementType, layout>&& other);
+
+        /// <summary> Assignment operator. </summary>
+        ///
+        /// <param name="other"> The other matrix. </param>
+        ///
+        /// <returns> A reference to this matrix. </returns>
+        SparseMatrix<ElementType, layout>& operator=(SparseMatrix<ElementType, layout> other);
+
+        /// <summary> Swaps the contents of this matrix with the contents of another matrix. </summary>
+        ///
+        /// <param name="other"> [in,out] The other matrix. </param>
+        void Swap(SparseMatrix<ElementType, layout>& other);
+
+    private:
+        void ResetPointers();
+
+        std::vector<size_t> _offsets;
+        std::vector<size_t> _indices;
+        std::vector<ElementType> _values;
+    };
+
+    /// <summary> A sparse matrix in the compressed sparse row (CSR) format. </summary>
+    template <typename ElementType>
+    using CompressedRowMatrix = SparseMatrix<ElementType, MatrixLayout::rowMajor>;
+
+    /// <summary> A sparse matrix in the compressed sparse column (CSC) format. </summary>
+    template <typename ElementType>
+    using CompressedColumnMatrix = SparseMatrix<ElementType, MatrixLayout::columnMajor>;
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Debug.h>
+#include <utilities/include/Exception.h>
+
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    //
+    // ConstSparseVectorReference
+    //
+
+    template <typename ElementType, VectorOrientation orientation>
+    ConstSparseVectorReference<ElementType, orientation>::ConstSparseVectorReference(const size_t* pIndices, const ElementType* pValues, size_t numNonzeros, size_t size) :
+        _pIndices(pIndices),
+        _pValues(pValues),
+        _numNonzeros(numNonzeros),
+        _size(size)
+    {}
+
+    template <typename ElementType, VectorOrientation orientation>
+    ElementType ConstSparseVectorReference<ElementType, orientation>::Norm2Squared() const
+    {
+        ElementType result = 0;
+        for (size_t i = 0; i < _numNonzeros; ++i)
+        {
+            result += _pValues[i] * _pValues[i];
+        }
+        return result;
+    }
+
+    //
+    // ConstSparseMatrixReference
+    //
+
+    template <typename ElementType, MatrixLayout layout>
+    ConstSparseMatrixReference<ElementType, layout>::ConstSparseMatrixReference(size_t numRows, size_t numColumns, const size_t* pOffsets, const size_t* pIndices, const ElementType* pValues) :
+        _numRows(numRows),
+        _numColumns(numColumns),
+        _pOffsets(pOffsets),
+        _pIndices(pIndices),
+        _pValues(pValues)
+    {}
+
+    template <typename ElementType, MatrixLayout layout>
+    auto ConstSparseMatrixReference<ElementType, layout>::GetMajorVector(size_t index) const -> ConstSparseVectorReference<ElementType, intervalOrientation>
+    {
+        DEBUG_THROW(index >= NumIntervals(), utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "interval index exceeds matrix dimensions."));
+
+        auto begin = _pOffsets[index];
+        auto minorSize = layout == MatrixLayout::rowMajor ? _numColumns : _numRows;
+        return ConstSparseVectorReference<ElementType, intervalOrientation>(_pIndices + begin, _pValues + begin, _pOffsets[index + 1] - begin, minorSize);
+    }
+
+    //
+    // SparseMatrix
+    //
+
+    template <typename ElementType, MatrixLayout layout>
+    SparseMatrix<ElementType, layout>::SparseMatrix(size_t numRows, size_t numColumns) :
+        ConstSparseMatrixReference<ElementType, layout>(numRows, numColumns, nullptr, nullptr, nullptr),
+        _offsets(this->NumIntervals() + 1, 0)
+    {
+        ResetPointers();
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    SparseMatrix<ElementType, layout>::SparseMatrix(size_t numRows, size_t numColumns, std::vector<size_t> offsets, std::vector<size_t> indices, std::vector<ElementType> values) :
+        ConstSparseMatrixReference<ElementType, layout>(numRows, numColumns, nullptr, nullptr, nullptr),
+        _offsets(std::move(offsets)),
+        _indices(std::move(indices)),
+        _values(std::move(values))
+    {
+        auto numIntervals = this->NumIntervals();
+        auto minorSize = layout == MatrixLayout::rowMajor ? numColumns : numRows;
+        if (_offsets.size() != numIntervals + 1 || _offsets.front() != 0 || _offsets.back() != _indices.size() || _indices.size() != _values.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "sparse matrix offsets, indices and values are inconsistent");
+        }
+        for (size_t i = 0; i < numIntervals; ++i)
+        {
+            if (_offsets[i] > _offsets[i + 1])
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "sparse matrix offsets must be nondecreasing");
+            }
+            for (auto j = _offsets[i]; j < _offsets[i + 1]; ++j)
+            {
+                if (_indices[j] >= minorSize || (j > _offsets[i] && _indices[j] <= _indices[j - 1]))
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "sparse matrix indices must be increasing within each interval and smaller than the matrix dimension");
+                }
+            }
+        }
+        ResetPointers();
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    template <MatrixLayout denseLayout>
+    SparseMatrix<ElementType, layout>::SparseMatrix(ConstMatrixReference<ElementType, denseLayout> matrix) :
+        ConstSparseMatrixReference<ElementType, layout>(matrix.NumRows(), matrix.NumColumns(), nullptr, nullptr, nullptr)
+    {
+        auto numIntervals = this->NumIntervals();
+        auto minorSize = layout == MatrixLayout::rowMajor ? matrix.NumColumns() : matrix.NumRows();
+        _offsets.reserve(numIntervals + 1);
+        _offsets.push_back(0);
+        for (size_t i = 0; i < numIntervals; ++i)
+        {
+            for (size_t j = 0; j < minorSize; ++j)
+            {
+                auto value = layout == MatrixLayout::rowMajor ? matrix(i, j) : matrix(j, i);
+                if (value != 0)
+                {
+                    _indices.push_back(j);
+                    _values.push_back(value);
+                }
+            }
+            _offsets.push_back(_indices.size());
+        }
+        ResetPointers();
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    SparseMatrix<ElementType, layout>::SparseMatrix(const SparseMatrix<ElementType, layout>& other) :
+        ConstSparseMatrixReference<ElementType, layout>(other.NumRows(), other.NumColumns(), nullptr, nullptr, nullptr),
+        _offsets(other._offsets),
+        _indices(other._indices),
+        _values(other._values)
+    {
+        ResetPointers();
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    SparseMatrix<ElementType, layout>::SparseMatrix(SparseMatrix<ElementType, layout>&& other) :
+        ConstSparseMatrixReference<ElementType, layout>(other.NumRows(), other.NumColumns(), nullptr, nullptr, nullptr),
+        _offsets(std::move(other._offsets)),
+        _indices(std::move(other._indices)),
+        _values(std::move(other._values))
+    {
+        ResetPointers();
+        other._numRows = 0;
+        other._numColumns = 0;
+        other._offsets.assign(1, 0);
+        other.ResetPointers();
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    SparseMatrix<ElementType, layout>& SparseMatrix<ElementType, layout>::operator=(SparseMatrix<ElementType, layout> other)
+    {
+        Swap(other);
+        return *this;
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void SparseMatrix<ElementType, layout>::Swap(SparseMatrix<ElementType, layout>& other)
+    {
+        std::swap(this->_numRows, other._numRows);
+        std::swap(this->_numColumns, other._numColumns);
+        std::swap(_offsets, other._offsets);
+        std::swap(_indices, other._indices);
+        std::swap(_values, other._values);
+        ResetPointers();
+        other.ResetPointers();
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void SparseMatrix<ElementType, layout>::ResetPointers()
+    {
+        this->_pOffsets = _offsets.data();
+        this->_pIndices = _indices.data();
+        this->_pValues = _values.data();
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
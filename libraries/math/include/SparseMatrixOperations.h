@@ -0,0 +1,326 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseMatrixOperations.h (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.h"
+#include "Matrix.h"
+#include "Parallel.h"
+#include "SparseMatrix.h"
+#include "Vector.h"
+
+#include <cstddef>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> Gets the transpose of a sparse vector. </summary>
+    ///
+    /// <typeparam name="ElementType"> Vector element type. </typeparam>
+    /// <typeparam name="orientation"> The orientation. </typeparam>
+    /// <param name="vector"> The sparse vector. </param>
+    ///
+    /// <returns> The transposed vector. </returns>
+    template <typename ElementType, VectorOrientation orientation>
+    auto Transpose(ConstSparseVectorReference<ElementType, orientation> vector)
+    {
+        return vector.Transpose();
+    }
+
+    /// <summary> Computes the dot product of a sparse vector and a dense vector. </summary>
+    ///
+    /// <typeparam name="SparseElementType"> The element type of the sparse vector. </typeparam>
+    /// <typeparam name="ElementType"> The element type of the dense vector, which is also the type of the result. </typeparam>
+    /// <param name="vectorA"> The sparse vector. </param>
+    /// <param name="vectorB"> The dense vector. </param>
+    ///
+    /// <returns> The dot product. </returns>
+    template <typename SparseElementType, VectorOrientation orientationA, typename ElementType, VectorOrientation orientationB>
+    ElementType Dot(ConstSparseVectorReference<SparseElementType, orientationA> vectorA, ConstVectorReference<ElementType, orientationB> vectorB);
+
+    /// <summary> Adds a scaled sparse vector to a dense vector, vectorB += scalarA * vectorA. </summary>
+    ///
+    /// <typeparam name="SparseElementType"> The element type of the sparse vector. </typeparam>
+    /// <typeparam name="ElementType"> The element type of the dense vector. </typeparam>
+    /// <typeparam name="orientation"> The vector orientation. </typeparam>
+    /// <param name="scalarA"> The scalar that multiplies the sparse vector. </param>
+    /// <param name="vectorA"> The sparse vector. </param>
+    /// <param name="vectorB"> The dense vector, which is updated. </param>
+    template <typename ElementType, typename SparseElementType, VectorOrientation orientation>
+    void ScaleAddUpdate(ElementType scalarA, ConstSparseVectorReference<SparseElementType, orientation> vectorA, One, VectorReference<ElementType, orientation> vectorB);
+
+    /// <summary>
+    /// Sparse matrix vector multiplication, vectorB = scalarA * matrix * vectorA + scalarB * vectorB. A CSR matrix
+    /// computes the rows of the result in parallel. A CSC matrix scatters its columns into one partial result per
+    /// thread, and the partial results are then summed in parallel.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix and vector element type. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="scalarA"> The scalar that multiplies the matrix. </param>
+    /// <param name="matrix"> The sparse matrix. </param>
+    /// <param name="vectorA"> The column vector that multiplies the matrix from the right. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB. </param>
+    /// <param name="vectorB"> A column vector, multiplied by scalarB and used to store the result. </param>
+    /// <param name="numThreads"> (Optional) The maximal number of threads, or 0 to use GetNumThreads(). Small products run on the calling thread. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstSparseMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB, size_t numThreads = 0);
+
+    /// <summary>
+    /// Sparse (left-side) row-vector matrix multiplication, vectorB = scalarA * vectorA * matrix + scalarB * vectorB,
+    /// which is computed as the product of the transposed matrix and vector.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix and vector element type. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="scalarA"> The scalar that multiplies the matrix. </param>
+    /// <param name="vectorA"> The row vector that multiplies the matrix from the left. </param>
+    /// <param name="matrix"> The sparse matrix. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB. </param>
+    /// <param name="vectorB"> A row vector, multiplied by scalarB and used to store the result. </param>
+    /// <param name="numThreads"> (Optional) The maximal number of threads, or 0 to use GetNumThreads(). </param>
+    template <typename ElementType, MatrixLayout layout>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstSparseMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB, size_t numThreads = 0);
+
+    /// <summary>
+    /// Sparse-dense matrix matrix multiplication, matrixC = scalarA * matrixA * matrixB + scalarC * matrixC. A CSR
+    /// matrixA computes the rows of the result in parallel, and a CSC matrixA computes blocks of columns of the
+    /// result in parallel.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type. </typeparam>
+    /// <typeparam name="layoutA"> Sparse matrix layout. </typeparam>
+    /// <typeparam name="layoutB"> Dense matrix layout. </typeparam>
+    /// <typeparam name="layoutC"> Result matrix layout. </typeparam>
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrixA"> The sparse matrix. </param>
+    /// <param name="matrixB"> The dense matrix that multiplies matrixA from the right. </param>
+    /// <param name="scalarC"> The scalar that multiplies matrixC. </param>
+    /// <param name="matrixC"> A matrix, multiplied by scalarC and used to store the result. </param>
+    /// <param name="numThreads"> (Optional) The maximal number of threads, or 0 to use GetNumThreads(). </param>
+    template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstSparseMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC, size_t numThreads = 0);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "VectorOperations.h"
+
+#include <utilities/include/Debug.h>
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // products with less work than this (in multiply-adds) per task are not worth splitting off
+        constexpr size_t minSparseWorkPerTask = 1 << 15;
+
+        template <typename ElementType>
+        void ScaleForUpdate(ElementType scalar, ElementType* pData, size_t size, size_t increment)
+        {
+            if (scalar == 0)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pData[i * increment] = 0;
+                }
+            }
+            else if (scalar != 1)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pData[i * increment] *= scalar;
+                }
+            }
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        void ScaleForUpdate(ElementType scalar, MatrixReference<ElementType, layout> matrix)
+        {
+            if (scalar == 0)
+            {
+                matrix.Reset();
+            }
+            else if (scalar != 1)
+            {
+                for (size_t i = 0; i < matrix.NumRows(); ++i)
+                {
+                    ScaleUpdate<ImplementationType::native>(scalar, matrix.GetRow(i));
+                }
+            }
+        }
+    } // namespace Internal
+
+    template <typename SparseElementType, VectorOrientation orientationA, typename ElementType, VectorOrientation orientationB>
+    ElementType Dot(ConstSparseVectorReference<SparseElementType, orientationA> vectorA, ConstVectorReference<ElementType, orientationB> vectorB)
+    {
+        DEBUG_CHECK_SIZES(vectorA.Size() != vectorB.Size(), "Incompatible vector sizes.");
+
+        const auto pIndices = vectorA.GetIndicesPointer();
+        const auto pValues = vectorA.GetValuesPointer();
+        const auto pData = vectorB.GetConstDataPointer();
+        const auto increment = vectorB.GetIncrement();
+
+        ElementType result = 0;
+        for (size_t i = 0; i < vectorA.NumNonzeros(); ++i)
+        {
+            result += static_cast<ElementType>(pValues[i]) * pData[pIndices[i] * increment];
+        }
+        return result;
+    }
+
+    template <typename ElementType, typename SparseElementType, VectorOrientation orientation>
+    void ScaleAddUpdate(ElementType scalarA, ConstSparseVectorReference<SparseElementType, orientation> vectorA, One, VectorReference<ElementType, orientation> vectorB)
+    {
+        DEBUG_CHECK_SIZES(vectorA.Size() != vectorB.Size(), "Incompatible vector sizes.");
+
+        const auto pIndices = vectorA.GetIndicesPointer();
+        const auto pValues = vectorA.GetValuesPointer();
+        const auto pData = vectorB.GetDataPointer();
+        const auto increment = vectorB.GetIncrement();
+
+        for (size_t i = 0; i < vectorA.NumNonzeros(); ++i)
+        {
+            pData[pIndices[i] * increment] += scalarA * static_cast<ElementType>(pValues[i]);
+        }
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstSparseMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB, size_t numThreads)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumColumns() != vectorA.Size() || matrix.NumRows() != vectorB.Size(), "Incompatible matrix vector sizes.");
+
+        const auto pOffsets = matrix.GetOffsetsPointer();
+        const auto pIndices = matrix.GetIndicesPointer();
+        const auto pValues = matrix.GetValuesPointer();
+        const auto pInput = vectorA.GetConstDataPointer();
+        const auto inputIncrement = vectorA.GetIncrement();
+        const auto pOutput = vectorB.GetDataPointer();
+        const auto outputIncrement = vectorB.GetIncrement();
+        const auto numIntervals = matrix.NumIntervals();
+        const auto numTasks = Internal::GetNumTasks(matrix.NumNonzeros(), Internal::minSparseWorkPerTask, numIntervals, numThreads);
+
+        if constexpr (layout == MatrixLayout::rowMajor)
+        {
+            // each row of the output is a sparse dot product, so rows are independent
+            Internal::ParallelForRanges(numIntervals, numTasks, [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ElementType sum = 0;
+                    for (auto k = pOffsets[i]; k < pOffsets[i + 1]; ++k)
+                    {
+                        sum += pValues[k] * pInput[pIndices[k] * inputIncrement];
+                    }
+                    auto& output = pOutput[i * outputIncrement];
+                    output = scalarB == 0 ? scalarA * sum : scalarA * sum + scalarB * output;
+                }
+            });
+        }
+        else
+        {
+            // each column scatters into the whole output, so every thread but the first scatters into its own
+            // buffer, and the buffers are summed into the output afterwards
+            const auto size = vectorB.Size();
+            Internal::ScaleForUpdate(scalarB, pOutput, size, outputIncrement);
+            std::vector<std::vector<ElementType>> buffers(numTasks - 1, std::vector<ElementType>(size));
+
+            Internal::ParallelForRanges(numIntervals, numTasks, [&](size_t taskIndex, size_t begin, size_t end) {
+                auto pTarget = taskIndex == 0 ? pOutput : buffers[taskIndex - 1].data();
+                auto targetIncrement = taskIndex == 0 ? outputIncrement : 1;
+                for (size_t j = begin; j < end; ++j)
+                {
+                    auto scaledInput = scalarA * pInput[j * inputIncrement];
+                    for (auto k = pOffsets[j]; k < pOffsets[j + 1]; ++k)
+                    {
+                        pTarget[pIndices[k] * targetIncrement] += scaledInput * pValues[k];
+                    }
+                }
+            });
+
+            if (!buffers.empty())
+            {
+                Internal::ParallelForRanges(size, numTasks, [&](size_t, size_t begin, size_t end) {
+                    for (const auto& buffer : buffers)
+                    {
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            pOutput[i * outputIncrement] += buffer[i];
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstSparseMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB, size_t numThreads)
+    {
+        MultiplyScaleAddUpdate(scalarA, matrix.Transpose(), vectorA.Transpose(), scalarB, vectorB.Transpose(), numThreads);
+    }
+
+    template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstSparseMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC, size_t numThreads)
+    {
+        DEBUG_CHECK_SIZES(matrixA.NumColumns() != matrixB.NumRows() || matrixA.NumRows() != matrixC.NumRows() || matrixB.NumColumns() != matrixC.NumColumns(), "Incompatible matrix sizes.");
+
+        const auto pOffsets = matrixA.GetOffsetsPointer();
+        const auto pIndices = matrixA.GetIndicesPointer();
+        const auto pValues = matrixA.GetValuesPointer();
+        const auto numIntervals = matrixA.NumIntervals();
+        const auto numColumns = matrixC.NumColumns();
+        const auto work = matrixA.NumNonzeros() * numColumns;
+
+        if constexpr (layoutA == MatrixLayout::rowMajor)
+        {
+            // row i of the result is a combination of the rows of matrixB selected by row i of matrixA
+            const auto numTasks = Internal::GetNumTasks(work, Internal::minSparseWorkPerTask, numIntervals, numThreads);
+            Internal::ParallelForRanges(numIntervals, numTasks, [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    auto row = matrixC.GetRow(i);
+                    Internal::ScaleForUpdate(scalarC, row.GetDataPointer(), row.Size(), row.GetIncrement());
+                    for (auto k = pOffsets[i]; k < pOffsets[i + 1]; ++k)
+                    {
+                        ScaleAddUpdate<ImplementationType::native>(scalarA * pValues[k], matrixB.GetRow(pIndices[k]), One(), row);
+                    }
+                }
+            });
+        }
+        else
+        {
+            // column j of matrixA scatters row j of matrixB into the rows of the result, so threads split the
+            // columns of matrixB and the result instead of the intervals of matrixA
+            const size_t minColumnsPerTask = 8;
+            const auto numTasks = Internal::GetNumTasks(work, Internal::minSparseWorkPerTask, std::max<size_t>(numColumns / minColumnsPerTask, 1), numThreads);
+            Internal::ParallelForRanges(numColumns, numTasks, [&](size_t, size_t begin, size_t end) {
+                auto blockC = matrixC.GetSubMatrix(0, begin, matrixC.NumRows(), end - begin);
+                auto blockB = matrixB.GetSubMatrix(0, begin, matrixB.NumRows(), end - begin);
+                Internal::ScaleForUpdate(scalarC, blockC);
+                for (size_t j = 0; j < numIntervals; ++j)
+                {
+                    auto rowB = blockB.GetRow(j);
+                    for (auto k = pOffsets[j]; k < pOffsets[j + 1]; ++k)
+                    {
+                        ScaleAddUpdate<ImplementationType::native>(scalarA * pValues[k], rowB, One(), blockC.GetRow(pIndices[k]));
+                    }
+                }
+            });
+        }
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "AlignedAllocator.h"
 #include "Matrix.h"
 #include "Vector.h"
 
@@ -820,14 +821,6 @@ namespace math
         /// <param name="data"> Vector of data elements that will be copied to this Tensor. </param>
         Tensor(size_t numRows, size_t numColumns, size_t numChannels, const std::vector<ElementType>& data);
 
-        /// <summary> Constructs a tensor of the given shape with the specified data. </summary>
-        ///
-        /// <param name="numRows"> Number of rows. </param>
-        /// <param name="numColumns"> Number of columns. </param>
-        /// <param name="numChannels"> Number of channels. </param>
-        /// <param name="data"> Vector of data elements that will be moved to this Tensor. </param>
-        Tensor(size_t numRows, size_t numColumns, size_t numChannels, std::vector<ElementType>&& data);
-
         /// <summary> Constructs a the zero tensor of given shape. </summary>
         ///
         /// <param name="shape"> The tensor shape (given in logical coordinates: rows, columns, channels). </param>
@@ -862,7 +855,7 @@ namespace math
         /// <summary> Returns a copy of the contents of the Tensor. </summary>
         ///
         /// <returns> A std::vector with a copy of the contents of the Tensor. </returns>
-        std::vector<ElementType> ToArray() const { return _data; }
+        std::vector<ElementType> ToArray() const { return { _data.begin(), _data.end() }; }
 
         /// <summary> Swaps the contents of this tensor with the contents of another tensor. </summary>
         ///
@@ -873,7 +866,7 @@ namespace math
 
     private:
         using ConstTensorRef = ConstTensorReference<ElementType, dimension0, dimension1, dimension2>;
-        std::vector<ElementType> _data;
+        AlignedVector<ElementType> _data;
     };
 
     /// <summary> A class that implements helper functions for archiving/unarchiving Tensor instances. </summary>
@@ -1647,15 +1640,7 @@ namespace math
     template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
     Tensor<ElementType, dimension0, dimension1, dimension2>::Tensor(size_t numRows, size_t numColumns, size_t numChannels, const std::vector<ElementType>& data) :
         TensorRef(TensorShape{ numRows, numColumns, numChannels }),
-        _data(data)
-    {
-        this->_pData = _data.data();
-    }
-
-    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
-    Tensor<ElementType, dimension0, dimension1, dimension2>::Tensor(size_t numRows, size_t numColumns, size_t numChannels, std::vector<ElementType>&& data) :
-        TensorRef(TensorShape{ numRows, numColumns, numChannels }),
-        _data(std::move(data))
+        _data(data.begin(), data.end())
     {
         this->_pData = _data.data();
     }
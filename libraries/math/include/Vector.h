@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "AlignedAllocator.h"
+
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/StlStridedIterator.h>
 
@@ -46,6 +48,10 @@ namespace math
         static constexpr VectorOrientation value = VectorOrientation::row;
     };
 
+    /// <summary> A lazy elementwise vector expression, defined in VectorExpressions.h. </summary>
+    template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+    class VectorExpression;
+
     /// <summary> Represents a constant reference to a vector, without a specified row or column orientation. </summary>
     ///
     /// <typeparam name="ElementType"> ElementType. </typeparam>
@@ -287,6 +293,17 @@ namespace math
         /// <param name="value"> The value. </param>
         void Fill(ElementType value);
 
+        /// <summary>
+        /// Evaluates a vector expression into this vector, in a single pass over the elements. Defined in
+        /// VectorExpressions.h.
+        /// </summary>
+        ///
+        /// <param name="expression"> The expression, which must have the same size as this vector. </param>
+        ///
+        /// <returns> A reference to this vector. </returns>
+        template <typename OperationType, typename LeftType, typename RightType>
+        VectorReference<ElementType, orientation>& operator=(const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression);
+
         /// <summary>
         /// Generates elements of the vector by repeatedly calling a generator function (such as a random
         /// number generator).
@@ -352,7 +369,7 @@ namespace math
         /// <summary> Constructs a vector by copying a std::vector. </summary>
         ///
         /// <param name="data"> The std::vector to copy. </param>
-        Vector(std::vector<ElementType> data);
+        Vector(const std::vector<ElementType>& data);
 
         /// <summary> Constructs a vector from an initializer list. </summary>
         ///
@@ -379,6 +396,12 @@ namespace math
         /// <param name="other"> The vector being copied. </param>
         Vector(ConstVectorReference<ElementType, TransposeVectorOrientation<orientation>::value>& other);
 
+        /// <summary> Constructs a vector by evaluating a vector expression. Defined in VectorExpressions.h. </summary>
+        ///
+        /// <param name="expression"> The expression. </param>
+        template <typename OperationType, typename LeftType, typename RightType>
+        Vector(const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression);
+
         /// <summary> Assignment operator. </summary>
         ///
         /// <param name="other"> The other vector. </param>
@@ -386,6 +409,14 @@ namespace math
         /// <returns> A reference to this vector. </returns>
         Vector<ElementType, orientation>& operator=(Vector<ElementType, orientation> other);
 
+        /// <summary> Evaluates a vector expression into this vector, resizing it if needed. Defined in VectorExpressions.h. </summary>
+        ///
+        /// <param name="expression"> The expression. </param>
+        ///
+        /// <returns> A reference to this vector. </returns>
+        template <typename OperationType, typename LeftType, typename RightType>
+        Vector<ElementType, orientation>& operator=(const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression);
+
         /// <summary> Resize the vector. This function possibly invalidates references to the old vector. </summary>
         ///
         /// <param name="size"> The new vector size. </param>
@@ -402,19 +433,19 @@ namespace math
         using ConstVectorReference<ElementType, orientation>::_increment;
 
         template <typename T, VectorOrientation o>
-        friend auto begin(Vector<T, o>& vector) -> utilities::StlStridedIterator<typename std::vector<T>::iterator>;
+        friend auto begin(Vector<T, o>& vector) -> utilities::StlStridedIterator<typename AlignedVector<T>::iterator>;
 
         template <typename T, VectorOrientation o>
-        friend auto end(Vector<T, o>& vector) -> utilities::StlStridedIterator<typename std::vector<T>::iterator>;
+        friend auto end(Vector<T, o>& vector) -> utilities::StlStridedIterator<typename AlignedVector<T>::iterator>;
 
         template <typename T, VectorOrientation o>
-        friend auto begin(const Vector<T, o>& vector) -> utilities::StlStridedIterator<typename std::vector<T>::const_iterator>;
+        friend auto begin(const Vector<T, o>& vector) -> utilities::StlStridedIterator<typename AlignedVector<T>::const_iterator>;
 
         template <typename T, VectorOrientation o>
-        friend auto end(const Vector<T, o>& vector) -> utilities::StlStridedIterator<typename std::vector<T>::const_iterator>;
+        friend auto end(const Vector<T, o>& vector) -> utilities::StlStridedIterator<typename AlignedVector<T>::const_iterator>;
 
         // member variables
-        std::vector<ElementType> _data;
+        AlignedVector<ElementType> _data;
     };
 
     /// <summary> Get iterator to the beginning of a Vector </summary>
@@ -423,7 +454,7 @@ namespace math
     ///
     /// <returns> A stl iterator to the beginning of the vector. </returns>
     template <typename ElementType, VectorOrientation orientation>
-    auto begin(Vector<ElementType, orientation>& vector) -> utilities::StlStridedIterator<typename std::vector<ElementType>::iterator>;
+    auto begin(Vector<ElementType, orientation>& vector) -> utilities::StlStridedIterator<typename AlignedVector<ElementType>::iterator>;
 
     /// <summary> Get a const stl iterator to the beginning of a Vector </summary>
     ///
@@ -431,7 +462,7 @@ namespace math
     ///
     /// <returns> A stl iterator to the beginning of the vector. </returns>
     template <typename ElementType, VectorOrientation orientation>
-    auto begin(const Vector<ElementType, orientation>& vector) -> utilities::StlStridedIterator<typename std::vector<ElementType>::const_iterator>;
+    auto begin(const Vector<ElementType, orientation>& vector) -> utilities::StlStridedIterator<typename AlignedVector<ElementType>::const_iterator>;
 
     /// <summary> Get iterator to the end of a Vector </summary>
     ///
@@ -439,7 +470,7 @@ namespace math
     ///
     /// <returns> A stl iterator to the end of the vector. </returns>
     template <typename ElementType, VectorOrientation orientation>
-    auto end(Vector<ElementType, orientation>& vector) -> utilities::StlStridedIterator<typename std::vector<ElementType>::iterator>;
+    auto end(Vector<ElementType, orientation>& vector) -> utilities::StlStridedIterator<typename AlignedVector<ElementType>::iterator>;
 
     /// <summary> Get a const stl iterator to the end of a Vector </summary>
     ///
@@ -447,7 +478,7 @@ namespace math
     ///
     /// <returns> A stl iterator to the end of the vector. </returns>
     template <typename ElementType, VectorOrientation orientation>
-    auto end(const Vector<ElementType, orientation>& vector) -> utilities::StlStridedIterator<typename std::vector<ElementType>::const_iterator>;
+    auto end(const Vector<ElementType, orientation>& vector) -> utilities::StlStridedIterator<typename AlignedVector<ElementType>::const_iterator>;
 
     /// <summary> A class that implements helper functions for archiving/unarchiving Vector instances. </summary>
     class VectorArchiver
@@ -808,9 +839,9 @@ namespace math
     }
 
     template <typename ElementType, VectorOrientation orientation>
-    Vector<ElementType, orientation>::Vector(std::vector<ElementType> data) :
+    Vector<ElementType, orientation>::Vector(const std::vector<ElementType>& data) :
         VectorReference<ElementType, orientation>(nullptr, data.size(), 1),
-        _data(std::move(data))
+        _data(data.begin(), data.end())
     {
         this->_pData = _data.data();
     }
@@ -881,25 +912,25 @@ namespace math
     }
 
     template <typename ElementType, VectorOrientation orientation>
-    utilities::StlStridedIterator<typename std::vector<ElementType>::iterator> begin(Vector<ElementType, orientation>& vector)
+    utilities::StlStridedIterator<typename AlignedVector<ElementType>::iterator> begin(Vector<ElementType, orientation>& vector)
     {
         return { vector._data.begin(), static_cast<ptrdiff_t>(vector.GetIncrement()) };
     }
 
     template <typename ElementType, VectorOrientation orientation>
-    utilities::StlStridedIterator<typename std::vector<ElementType>::const_iterator> begin(const Vector<ElementType, orientation>& vector)
+    utilities::StlStridedIterator<typename AlignedVector<ElementType>::const_iterator> begin(const Vector<ElementType, orientation>& vector)
     {
         return { vector._data.cbegin(), static_cast<ptrdiff_t>(vector.GetIncrement()) };
     }
 
     template <typename ElementType, VectorOrientation orientation>
-    utilities::StlStridedIterator<typename std::vector<ElementType>::iterator> end(Vector<ElementType, orientation>& vector)
+    utilities::StlStridedIterator<typename AlignedVector<ElementType>::iterator> end(Vector<ElementType, orientation>& vector)
     {
         return { vector._data.end(), static_cast<ptrdiff_t>(vector.GetIncrement()) };
     }
 
     template <typename ElementType, VectorOrientation orientation>
-    utilities::StlStridedIterator<typename std::vector<ElementType>::const_iterator> end(const Vector<ElementType, orientation>& vector)
+    utilities::StlStridedIterator<typename AlignedVector<ElementType>::const_iterator> end(const Vector<ElementType, orientation>& vector)
     {
         return { vector._data.cend(), static_cast<ptrdiff_t>(vector.GetIncrement()) };
     }
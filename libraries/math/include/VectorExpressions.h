@@ -0,0 +1,481 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     VectorExpressions.h (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "NativeKernels.h"
+#include "Vector.h"
+#include "VectorOperations.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Lazy elementwise vector expressions. The arithmetic operators below do not compute anything: they build an
+    /// expression tree that holds references to their vector operands, and the tree is evaluated, in a single
+    /// vectorized pass and without temporaries, when it is assigned to a vector. For example,
+    /// <code> v = 2.0 * x + 3.0 * y - z; </code>
+    /// reads each element of x, y and z exactly once and writes each element of v exactly once. Because the tree
+    /// holds references, an expression must be evaluated before its operands go out of scope.
+    /// </summary>
+    namespace Internal
+    {
+        /// <summary> Elementwise addition. </summary>
+        struct AddOperation
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return a + b; }
+
+            template <typename RegisterType>
+            static typename RegisterType::Type ApplyRegister(typename RegisterType::Type a, typename RegisterType::Type b) { return RegisterType::Add(a, b); }
+        };
+
+        /// <summary> Elementwise subtraction. </summary>
+        struct SubtractOperation
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return a - b; }
+
+            template <typename RegisterType>
+            static typename RegisterType::Type ApplyRegister(typename RegisterType::Type a, typename RegisterType::Type b) { return RegisterType::Subtract(a, b); }
+        };
+
+        /// <summary> Elementwise multiplication. </summary>
+        struct MultiplyOperation
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return a * b; }
+
+            template <typename RegisterType>
+            static typename RegisterType::Type ApplyRegister(typename RegisterType::Type a, typename RegisterType::Type b) { return RegisterType::Multiply(a, b); }
+        };
+
+        /// <summary> An expression leaf that refers to a vector. </summary>
+        template <typename ElementType, VectorOrientation orientation>
+        class VectorOperand
+        {
+        public:
+            using ValueType = ElementType;
+            static constexpr VectorOrientation vectorOrientation = orientation;
+            static constexpr bool isScalar = false;
+
+            VectorOperand(ConstVectorReference<ElementType, orientation> vector) :
+                _vector(vector) {}
+
+            size_t Size() const { return _vector.Size(); }
+            bool IsContiguous() const { return _vector.GetIncrement() == 1; }
+            ElementType operator[](size_t index) const { return _vector[index]; }
+
+            template <typename RegisterType>
+            typename RegisterType::Type Load(size_t index) const { return RegisterType::Load(_vector.GetConstDataPointer() + index); }
+
+        private:
+            ConstVectorReference<ElementType, orientation> _vector;
+        };
+
+        /// <summary> An expression leaf that holds a scalar, which is broadcast to every element. </summary>
+        template <typename ElementType>
+        class ScalarOperand
+        {
+        public:
+            static constexpr bool isScalar = true;
+
+            ScalarOperand(ElementType value) :
+                _value(value) {}
+
+            bool IsContiguous() const { return true; }
+            ElementType operator[](size_t) const { return _value; }
+
+            template <typename RegisterType>
+            typename RegisterType::Type Load(size_t) const { return RegisterType::Broadcast(_value); }
+
+        private:
+            ElementType _value;
+        };
+
+        /// <summary>
+        /// An expression leaf that refers to a vector with an arbitrary elementwise transformation. The transformation
+        /// is applied one element at a time and the results are loaded into a register, so the rest of the expression
+        /// stays vectorized even when the vector is strided.
+        /// </summary>
+        template <typename ElementType, VectorOrientation orientation, typename TransformationType>
+        class TransformedOperand
+        {
+        public:
+            using ValueType = ElementType;
+            static constexpr VectorOrientation vectorOrientation = orientation;
+            static constexpr bool isScalar = false;
+
+            TransformedOperand(ConstVectorReference<ElementType, orientation> vector, TransformationType transformation) :
+                _vector(vector),
+                _transformation(transformation) {}
+
+            size_t Size() const { return _vector.Size(); }
+            bool IsContiguous() const { return true; }
+            ElementType operator[](size_t index) const { return _transformation(_vector[index]); }
+
+            template <typename RegisterType>
+            typename RegisterType::Type Load(size_t index) const
+            {
+                ElementType lanes[RegisterType::width];
+                for (size_t lane = 0; lane < RegisterType::width; ++lane)
+                {
+                    lanes[lane] = (*this)[index + lane];
+                }
+                return RegisterType::Load(lanes);
+            }
+
+        private:
+            ConstVectorReference<ElementType, orientation> _vector;
+            mutable TransformationType _transformation;
+        };
+    } // namespace Internal
+
+    /// <summary> An expression node that applies an elementwise binary operation to two operands. </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="orientation"> The orientation of the vector that the expression evaluates to. </typeparam>
+    /// <typeparam name="OperationType"> The elementwise operation. </typeparam>
+    /// <typeparam name="LeftType"> The left operand: a leaf or another expression. </typeparam>
+    /// <typeparam name="RightType"> The right operand: a leaf or another expression. </typeparam>
+    template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+    class VectorExpression
+    {
+    public:
+        using ValueType = ElementType;
+        static constexpr VectorOrientation vectorOrientation = orientation;
+        static constexpr bool isScalar = false;
+
+        /// <summary> Constructs an expression node. </summary>
+        ///
+        /// <param name="left"> The left operand. </param>
+        /// <param name="right"> The right operand. </param>
+        VectorExpression(LeftType left, RightType right);
+
+        /// <summary> Gets the size of the vector that the expression evaluates to. </summary>
+        ///
+        /// <returns> The size. </returns>
+        size_t Size() const;
+
+        /// <summary> Computes one element of the expression. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the element. </param>
+        ///
+        /// <returns> The value of the element. </returns>
+        ElementType operator[](size_t index) const { return OperationType::Apply(_left[index], _right[index]); }
+
+        /// <summary> Checks if the expression can be evaluated with register loads, which requires contiguous vector operands. </summary>
+        ///
+        /// <returns> True if the expression can be evaluated with register loads. </returns>
+        bool IsContiguous() const { return _left.IsContiguous() && _right.IsContiguous(); }
+
+        /// <summary> Computes a register's worth of consecutive elements of the expression. </summary>
+        ///
+        /// <typeparam name="RegisterType"> The NativeKernels::SimdRegister type. </typeparam>
+        /// <param name="index"> Zero-based index of the first element. </param>
+        ///
+        /// <returns> The register. </returns>
+        template <typename RegisterType>
+        typename RegisterType::Type Load(size_t index) const
+        {
+            return OperationType::template ApplyRegister<RegisterType>(_left.template Load<RegisterType>(index), _right.template Load<RegisterType>(index));
+        }
+
+    private:
+        LeftType _left;
+        RightType _right;
+    };
+
+    namespace Internal
+    {
+        template <typename ElementType, VectorOrientation orientation>
+        VectorOperand<ElementType, orientation> MakeOperand(ConstVectorReference<ElementType, orientation> vector)
+        {
+            return { vector };
+        }
+
+        template <typename ElementType, VectorOrientation orientation, typename TransformationType>
+        TransformedOperand<ElementType, orientation, TransformationType> MakeOperand(TransformedConstVectorReference<ElementType, orientation, TransformationType> vector)
+        {
+            return { vector.GetVector(), vector.GetTransformation() };
+        }
+
+        // scalar * vector is the most common transformation, so it becomes a vectorized multiplication
+        template <typename ElementType, VectorOrientation orientation>
+        VectorExpression<ElementType, orientation, MultiplyOperation, ScalarOperand<ElementType>, VectorOperand<ElementType, orientation>> MakeOperand(TransformedConstVectorReference<ElementType, orientation, ScaleFunction<ElementType>> vector)
+        {
+            return { ScalarOperand<ElementType>(vector.GetTransformation()._value), VectorOperand<ElementType, orientation>(vector.GetVector()) };
+        }
+
+        template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+        const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& MakeOperand(const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression)
+        {
+            return expression;
+        }
+
+        template <typename T>
+        using OperandType = std::decay_t<decltype(MakeOperand(std::declval<const T&>()))>;
+
+        template <typename T, typename = void>
+        struct IsVectorOperand : std::false_type
+        {};
+
+        template <typename T>
+        struct IsVectorOperand<T, std::void_t<OperandType<T>>> : std::true_type
+        {};
+
+        template <typename T>
+        struct IsExpressionNode : std::false_type
+        {};
+
+        template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+        struct IsExpressionNode<VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>> : std::true_type
+        {};
+
+        template <typename ElementType, VectorOrientation orientation, typename TransformationType>
+        struct IsExpressionNode<TransformedConstVectorReference<ElementType, orientation, TransformationType>> : std::true_type
+        {};
+
+        // vector (op) vector, vector (op) scalar and scalar (op) vector
+        template <typename LeftType, typename RightType>
+        constexpr bool IsOperandPair = (IsVectorOperand<LeftType>::value && (IsVectorOperand<RightType>::value || std::is_arithmetic<RightType>::value)) ||
+                                       (std::is_arithmetic<LeftType>::value && IsVectorOperand<RightType>::value);
+
+        template <typename OperationType, typename LeftType, typename RightType>
+        auto MakeExpression(const LeftType& left, const RightType& right);
+
+        template <typename ElementType, VectorOrientation orientation, typename ExpressionType>
+        void EvaluateVectorExpression(const ExpressionType& expression, VectorReference<ElementType, orientation> output);
+    } // namespace Internal
+
+    /// <summary> Lazy elementwise addition of two vectors, or of a vector and a scalar. </summary>
+    ///
+    /// <param name="left"> A vector, a vector expression, or a scalar. </param>
+    /// <param name="right"> A vector, a vector expression, or a scalar. </param>
+    ///
+    /// <returns> A vector expression. </returns>
+    template <typename LeftType, typename RightType, std::enable_if_t<Internal::IsOperandPair<LeftType, RightType>, int> = 0>
+    auto operator+(const LeftType& left, const RightType& right)
+    {
+        return Internal::MakeExpression<Internal::AddOperation>(left, right);
+    }
+
+    /// <summary> Lazy elementwise subtraction of two vectors, or of a vector and a scalar. </summary>
+    ///
+    /// <param name="left"> A vector, a vector expression, or a scalar. </param>
+    /// <param name="right"> A vector, a vector expression, or a scalar. </param>
+    ///
+    /// <returns> A vector expression. </returns>
+    template <typename LeftType, typename RightType, std::enable_if_t<Internal::IsOperandPair<LeftType, RightType>, int> = 0>
+    auto operator-(const LeftType& left, const RightType& right)
+    {
+        return Internal::MakeExpression<Internal::SubtractOperation>(left, right);
+    }
+
+    /// <summary> Lazy elementwise negation of a vector. </summary>
+    ///
+    /// <param name="operand"> A vector or a vector expression. </param>
+    ///
+    /// <returns> A vector expression. </returns>
+    template <typename OperandType, std::enable_if_t<Internal::IsVectorOperand<OperandType>::value, int> = 0>
+    auto operator-(const OperandType& operand)
+    {
+        return Internal::MakeExpression<Internal::MultiplyOperation>(-1, operand);
+    }
+
+    /// <summary>
+    /// Lazy multiplication of a vector expression by a scalar. Multiplying a plain vector by a scalar on the left is
+    /// handled by the existing operator*, whose result is also a valid expression operand.
+    /// </summary>
+    ///
+    /// <param name="left"> A vector expression or a scalar. </param>
+    /// <param name="right"> A vector expression or a scalar. </param>
+    ///
+    /// <returns> A vector expression. </returns>
+    template <typename LeftType, typename RightType, std::enable_if_t<(Internal::IsExpressionNode<LeftType>::value && std::is_arithmetic<RightType>::value) || (std::is_arithmetic<LeftType>::value && Internal::IsExpressionNode<RightType>::value), int> = 0>
+    auto operator*(const LeftType& left, const RightType& right)
+    {
+        return Internal::MakeExpression<Internal::MultiplyOperation>(left, right);
+    }
+
+    /// <summary> Lazy multiplication of a vector by a scalar on the right. </summary>
+    ///
+    /// <param name="vector"> The vector. </param>
+    /// <param name="scalar"> The scalar. </param>
+    ///
+    /// <returns> A vector expression. </returns>
+    template <typename ElementType, VectorOrientation orientation, typename ScalarType, std::enable_if_t<std::is_arithmetic<ScalarType>::value, int> = 0>
+    auto operator*(ConstVectorReference<ElementType, orientation> vector, ScalarType scalar)
+    {
+        return Internal::MakeExpression<Internal::MultiplyOperation>(vector, scalar);
+    }
+
+    /// <summary>
+    /// Lazy elementwise multiplication of two vectors. This is a function rather than operator*, because multiplying
+    /// a row vector by a column vector is already the dot product.
+    /// </summary>
+    ///
+    /// <param name="left"> A vector or a vector expression. </param>
+    /// <param name="right"> A vector or a vector expression. </param>
+    ///
+    /// <returns> A vector expression. </returns>
+    template <typename LeftType, typename RightType, std::enable_if_t<Internal::IsVectorOperand<LeftType>::value && Internal::IsVectorOperand<RightType>::value, int> = 0>
+    auto ElementwiseMultiply(const LeftType& left, const RightType& right)
+    {
+        return Internal::MakeExpression<Internal::MultiplyOperation>(left, right);
+    }
+
+    /// <summary> Adds a vector expression to a vector, in a single pass. </summary>
+    ///
+    /// <param name="vector"> The vector being updated. </param>
+    /// <param name="expression"> The expression, which must have the same size as the vector. </param>
+    template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+    void operator+=(VectorReference<ElementType, orientation> vector, const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression);
+
+    /// <summary> Subtracts a vector expression from a vector, in a single pass. </summary>
+    ///
+    /// <param name="vector"> The vector being updated. </param>
+    /// <param name="expression"> The expression, which must have the same size as the vector. </param>
+    template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+    void operator-=(VectorReference<ElementType, orientation> vector, const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Debug.h>
+
+namespace ell
+{
+namespace math
+{
+    template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+    VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>::VectorExpression(LeftType left, RightType right) :
+        _left(std::move(left)),
+        _right(std::move(right))
+    {
+        if constexpr (!LeftType::isScalar && !RightType::isScalar)
+        {
+            DEBUG_CHECK_SIZES(_left.Size() != _right.Size(), "Incompatible vector sizes.");
+        }
+    }
+
+    template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+    size_t VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>::Size() const
+    {
+        if constexpr (LeftType::isScalar)
+        {
+            return _right.Size();
+        }
+        else
+        {
+            return _left.Size();
+        }
+    }
+
+    namespace Internal
+    {
+        template <typename OperationType, typename LeftType, typename RightType>
+        auto MakeExpression(const LeftType& left, const RightType& right)
+        {
+            if constexpr (std::is_arithmetic<LeftType>::value)
+            {
+                using RightOperandType = OperandType<RightType>;
+                using ElementType = typename RightOperandType::ValueType;
+                return VectorExpression<ElementType, RightOperandType::vectorOrientation, OperationType, ScalarOperand<ElementType>, RightOperandType>(ScalarOperand<ElementType>(static_cast<ElementType>(left)), MakeOperand(right));
+            }
+            else if constexpr (std::is_arithmetic<RightType>::value)
+            {
+                using LeftOperandType = OperandType<LeftType>;
+                using ElementType = typename LeftOperandType::ValueType;
+                return VectorExpression<ElementType, LeftOperandType::vectorOrientation, OperationType, LeftOperandType, ScalarOperand<ElementType>>(MakeOperand(left), ScalarOperand<ElementType>(static_cast<ElementType>(right)));
+            }
+            else
+            {
+                using LeftOperandType = OperandType<LeftType>;
+                using RightOperandType = OperandType<RightType>;
+                static_assert(std::is_same<typename LeftOperandType::ValueType, typename RightOperandType::ValueType>::value, "vector expression operands must have the same element type");
+                static_assert(LeftOperandType::vectorOrientation == RightOperandType::vectorOrientation, "vector expression operands must have the same orientation");
+                return VectorExpression<typename LeftOperandType::ValueType, LeftOperandType::vectorOrientation, OperationType, LeftOperandType, RightOperandType>(MakeOperand(left), MakeOperand(right));
+            }
+        }
+
+        template <typename ElementType, VectorOrientation orientation, typename ExpressionType>
+        void EvaluateVectorExpression(const ExpressionType& expression, VectorReference<ElementType, orientation> output)
+        {
+            DEBUG_CHECK_SIZES(expression.Size() != output.Size(), "Incompatible vector sizes.");
+
+            const size_t size = output.Size();
+            size_t index = 0;
+            if (output.GetIncrement() == 1 && expression.IsContiguous())
+            {
+                // each register is loaded from every operand before it is stored, so the output can alias an operand
+                using RegisterType = NativeKernels::SimdRegister<ElementType>;
+                ElementType* pOutput = output.GetDataPointer();
+                for (; index + RegisterType::width <= size; index += RegisterType::width)
+                {
+                    RegisterType::Store(pOutput + index, expression.template Load<RegisterType>(index));
+                }
+            }
+
+            for (; index < size; ++index)
+            {
+                output[index] = expression[index];
+            }
+        }
+    } // namespace Internal
+
+    template <typename ElementType, VectorOrientation orientation>
+    template <typename OperationType, typename LeftType, typename RightType>
+    VectorReference<ElementType, orientation>& VectorReference<ElementType, orientation>::operator=(const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression)
+    {
+        Internal::EvaluateVectorExpression(expression, *this);
+        return *this;
+    }
+
+    template <typename ElementType, VectorOrientation orientation>
+    template <typename OperationType, typename LeftType, typename RightType>
+    Vector<ElementType, orientation>::Vector(const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression) :
+        Vector<ElementType, orientation>(expression.Size())
+    {
+        Internal::EvaluateVectorExpression(expression, *this);
+    }
+
+    template <typename ElementType, VectorOrientation orientation>
+    template <typename OperationType, typename LeftType, typename RightType>
+    Vector<ElementType, orientation>& Vector<ElementType, orientation>::operator=(const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression)
+    {
+        // if the sizes differ, this vector cannot be one of the operands, so resizing it is safe
+        if (this->Size() != expression.Size())
+        {
+            Resize(expression.Size());
+        }
+        Internal::EvaluateVectorExpression(expression, *this);
+        return *this;
+    }
+
+    template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+    void operator+=(VectorReference<ElementType, orientation> vector, const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression)
+    {
+        Internal::EvaluateVectorExpression(vector + expression, vector);
+    }
+
+    template <typename ElementType, VectorOrientation orientation, typename OperationType, typename LeftType, typename RightType>
+    void operator-=(VectorReference<ElementType, orientation> vector, const VectorExpression<ElementType, orientation, OperationType, LeftType, RightType>& expression)
+    {
+        Internal::EvaluateVectorExpression(vector - expression, vector);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
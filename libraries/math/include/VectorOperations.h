@@ -11,6 +11,7 @@
 #include "BlasWrapper.h"
 #include "Common.h"
 #include "Matrix.h"
+#include "NativeKernels.h"
 #include "Transformations.h"
 #include "Vector.h"
 
@@ -1129,6 +1130,12 @@ namespace math
         {
             const ElementType* pVectorAData = vectorA.GetConstDataPointer();
             const ElementType* pVectorBData = vectorB.GetConstDataPointer();
+            if (vectorA.GetIncrement() == 1 && vectorB.GetIncrement() == 1)
+            {
+                result = NativeKernels::Dot(pVectorAData, pVectorBData, vectorA.Size());
+                return;
+            }
+
             const ElementType* pVectorAEnd = pVectorAData + vectorA.GetIncrement() * vectorA.Size();
             result = 0;
 
@@ -1228,6 +1235,12 @@ namespace math
         template <typename ElementType, VectorOrientation orientation>
         void VectorOperations<ImplementationType::native>::ScaleUpdate(ElementType scalar, VectorReference<ElementType, orientation> vector)
         {
+            if (vector.GetIncrement() == 1)
+            {
+                NativeKernels::Scale(scalar, vector.GetDataPointer(), vector.Size());
+                return;
+            }
+
             UnaryVectorUpdateImplementation(vector, [scalar](ElementType& v) { v *= scalar; });
         }
 
@@ -1242,6 +1255,12 @@ namespace math
         template <typename ElementType, VectorOrientation orientation>
         void VectorOperations<ImplementationType::native>::ScaleAddUpdate(ElementType scalarA, ConstVectorReference<ElementType, orientation> vectorA, One, VectorReference<ElementType, orientation> vectorB)
         {
+            if (vectorA.GetIncrement() == 1 && vectorB.GetIncrement() == 1)
+            {
+                NativeKernels::Axpy(scalarA, vectorA.GetConstDataPointer(), vectorB.GetDataPointer(), vectorB.Size());
+                return;
+            }
+
             BinaryVectorUpdateImplementation(vectorA, vectorB, [scalarA](ElementType a, ElementType& b) { b += scalarA * a; });
         }
 
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Parallel.cpp (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Parallel.h"
+#include "BlasWrapper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace
+    {
+        // 0 means all the hardware threads
+        std::atomic<size_t> numThreadsSetting{ 0 };
+
+        size_t GetHardwareConcurrency()
+        {
+            return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+
+        // A fixed set of worker threads that run tasks from a shared queue. The workers are started the first time
+        // the pool is used, and are stopped when the program exits.
+        class ThreadPool
+        {
+        public:
+            ThreadPool()
+            {
+                auto numWorkers = GetHardwareConcurrency() - 1;
+                for (size_t i = 0; i < numWorkers; ++i)
+                {
+                    _workers.emplace_back([this]() { RunWorker(); });
+                }
+            }
+
+            ~ThreadPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stopping = true;
+                }
+                _workAvailable.notify_all();
+                for (auto& worker : _workers)
+                {
+                    worker.join();
+                }
+            }
+
+            void RunAndWait(size_t numTasks, const std::function<void(size_t)>& task)
+            {
+                size_t numRemaining = numTasks - 1;
+                std::exception_ptr exception;
+
+                auto runTask = [&](size_t taskIndex) {
+                    try
+                    {
+                        task(taskIndex);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        exception = std::current_exception();
+                    }
+                };
+
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    for (size_t taskIndex = 1; taskIndex < numTasks; ++taskIndex)
+                    {
+                        _queue.emplace_back([&, taskIndex]() {
+                            runTask(taskIndex);
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            --numRemaining;
+                            _taskDone.notify_all();
+                        });
+                    }
+                }
+                _workAvailable.notify_all();
+
+                runTask(0);
+
+                // help with the queued tasks (which may belong to other callers) rather than block, so that nested
+                // calls can't run out of workers
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (numRemaining > 0)
+                {
+                    if (!_queue.empty())
+                    {
+                        auto queuedTask = std::move(_queue.front());
+                        _queue.pop_front();
+                        lock.unlock();
+                        queuedTask();
+                        lock.lock();
+                    }
+                    else
+                    {
+                        _taskDone.wait(lock);
+                    }
+                }
+
+                if (exception)
+                {
+                    std::rethrow_exception(exception);
+                }
+            }
+
+        private:
+            void RunWorker()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (true)
+                {
+                    _workAvailable.wait(lock, [this]() { return _stopping || !_queue.empty(); });
+                    if (_stopping)
+                    {
+                        return;
+                    }
+
+                    auto queuedTask = std::move(_queue.front());
+                    _queue.pop_front();
+                    lock.unlock();
+                    queuedTask();
+                    lock.lock();
+                }
+            }
+
+            std::mutex _mutex;
+            std::condition_variable _workAvailable;
+            std::condition_variable _taskDone;
+            std::deque<std::function<void()>> _queue;
+            std::vector<std::thread> _workers;
+            bool _stopping = false;
+        };
+
+        ThreadPool& GetThreadPool()
+        {
+            static ThreadPool threadPool;
+            return threadPool;
+        }
+    } // namespace
+
+    void SetNumThreads(size_t numThreads)
+    {
+        numThreadsSetting = numThreads;
+        Blas::SetNumThreads(static_cast<int>(numThreads));
+    }
+
+    size_t GetNumThreads()
+    {
+        auto numThreads = numThreadsSetting.load();
+        return numThreads == 0 ? GetHardwareConcurrency() : numThreads;
+    }
+
+    namespace Internal
+    {
+        size_t GetNumTasks(size_t work, size_t minWorkPerTask, size_t maxTasks, size_t numThreads)
+        {
+            if (numThreads == 0)
+            {
+                numThreads = GetNumThreads();
+            }
+            return std::max<size_t>(std::min({ numThreads, work / minWorkPerTask, maxTasks }), 1);
+        }
+
+        void ParallelFor(size_t numTasks, const std::function<void(size_t)>& task)
+        {
+            if (numTasks == 0)
+            {
+                return;
+            }
+
+            if (numTasks == 1)
+            {
+                task(0);
+                return;
+            }
+
+            GetThreadPool().RunAndWait(numTasks, task);
+        }
+    } // namespace Internal
+} // namespace math
+} // namespace ell
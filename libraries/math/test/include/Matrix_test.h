@@ -11,10 +11,12 @@
 
 #include <math/include/Matrix.h>
 #include <math/include/MatrixOperations.h>
+#include <math/include/Parallel.h>
 #include <math/include/Vector.h>
 
 #include <utilities/include/JsonArchiver.h>
 
+#include <array>
 #include <sstream>
 
 using namespace ell;
@@ -190,6 +192,12 @@ void TestVectorMatrixMultiplyScaleAddUpdate();
 template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::MatrixLayout layout3, math::ImplementationType implementation>
 void TestMatrixMatrixMultiplyScaleAddUpdate();
 
+template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::MatrixLayout layout3, math::ImplementationType implementation>
+void TestLargeMatrixMatrixMultiplyScaleAddUpdate();
+
+template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2>
+void TestMultithreadedMatrixMatrixMultiplyScaleAddUpdate();
+
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixElementwiseMultiplySet();
 
@@ -1521,6 +1529,69 @@ void TestMatrixMatrixMultiplyScaleAddUpdate()
     testing::ProcessTest(implementationName + "::MultiplyScaleAddUpdate(scalar, Matrix, Matrix, scalar, Matrix)", C == R && CCC == R);
 }
 
+template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::MatrixLayout layout3, math::ImplementationType implementation>
+void TestLargeMatrixMatrixMultiplyScaleAddUpdate()
+{
+    auto implementationName = math::Internal::MatrixOperations<implementation>::GetImplementationName();
+
+    // Large enough to use several tiles of the native kernel, and sizes that leave rows and columns over
+    const size_t m = 13;
+    const size_t n = 37;
+    const size_t k = 19;
+    math::Matrix<ElementType, layout1> A(m, k);
+    math::Matrix<ElementType, layout2> B(k, n);
+    math::Matrix<ElementType, layout3> C(m, n);
+    A.Generate([i = 0]() mutable { return static_cast<ElementType>(i++ % 5) - 2; });
+    B.Generate([i = 0]() mutable { return static_cast<ElementType>(i++ % 7) - 3; });
+    C.Fill(1);
+
+    math::Matrix<ElementType, layout3> R(m, n);
+    for (size_t i = 0; i < m; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            ElementType sum = 0;
+            for (size_t p = 0; p < k; ++p)
+            {
+                sum += A(i, p) * B(p, j);
+            }
+            R(i, j) = 2 * sum + 3;
+        }
+    }
+
+    math::MultiplyScaleAddUpdate<implementation>(static_cast<ElementType>(2), A, B, static_cast<ElementType>(3), C);
+
+    testing::ProcessTest(implementationName + "::MultiplyScaleAddUpdate(scalar, Matrix, Matrix, scalar, Matrix) with large matrices", C == R);
+}
+
+template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2>
+void TestMultithreadedMatrixMatrixMultiplyScaleAddUpdate()
+{
+    // Large enough to be split between threads, by rows in the first case and by columns in the second
+    bool ok = true;
+    for (auto [m, n, k] : { std::array<size_t, 3>{ 203, 75, 120 }, std::array<size_t, 3>{ 6, 1001, 90 } })
+    {
+        math::Matrix<ElementType, layout1> A(m, k);
+        math::Matrix<ElementType, layout2> B(k, n);
+        A.Generate([i = 0]() mutable { return static_cast<ElementType>(i++ % 5) - 2; });
+        B.Generate([i = 0]() mutable { return static_cast<ElementType>(i++ % 7) - 3; });
+
+        math::Matrix<ElementType, layout2> singleThreaded(m, n);
+        singleThreaded.Fill(1);
+        math::Matrix<ElementType, layout2> multithreaded = singleThreaded;
+
+        math::SetNumThreads(1);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(static_cast<ElementType>(2), A, B, static_cast<ElementType>(3), singleThreaded);
+        math::SetNumThreads(4);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(static_cast<ElementType>(2), A, B, static_cast<ElementType>(3), multithreaded);
+        math::SetNumThreads(0);
+
+        ok = ok && singleThreaded == multithreaded;
+    }
+
+    testing::ProcessTest("Native::MultiplyScaleAddUpdate(scalar, Matrix, Matrix, scalar, Matrix) with multiple threads", ok);
+}
+
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixElementwiseMultiplySet()
 {
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseMatrix_test.h (math_test)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <testing/include/testing.h>
+
+#include <math/include/SparseMatrix.h>
+
+using namespace ell;
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestSparseMatrixConstruction();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestSparseMatrixVectorMultiply();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestSparseMatrixMatrixMultiply();
+
+template <typename ElementType>
+void TestSparseVectorOperations();
+
+#pragma region implementation
+
+#include <math/include/MatrixOperations.h>
+#include <math/include/SparseMatrixOperations.h>
+#include <math/include/VectorOperations.h>
+
+#include <utilities/include/Exception.h>
+
+#include <random>
+
+// generates a dense matrix in which roughly a given fraction of the elements are nonzero
+template <typename ElementType, math::MatrixLayout layout>
+math::Matrix<ElementType, layout> GetRandomSparseDenseMatrix(size_t numRows, size_t numColumns, double density)
+{
+    std::default_random_engine engine(1234);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::uniform_int_distribution<int> values(-5, 5);
+
+    math::Matrix<ElementType, layout> matrix(numRows, numColumns);
+    matrix.Generate([&]() { return uniform(engine) < density ? static_cast<ElementType>(values(engine)) : 0; });
+    return matrix;
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestSparseMatrixConstruction()
+{
+    math::Matrix<ElementType, layout> dense{
+        { 1, 0, 2, 0 },
+        { 0, 0, 0, 0 },
+        { 0, 3, 0, 4 }
+    };
+    math::SparseMatrix<ElementType, layout> sparse(dense);
+
+    bool isRowMajor = layout == math::MatrixLayout::rowMajor;
+    auto interval = sparse.GetMajorVector(isRowMajor ? 2 : 3);
+    bool ok = sparse.NumRows() == 3 && sparse.NumColumns() == 4 && sparse.NumNonzeros() == 4 && sparse.NumIntervals() == (isRowMajor ? 3 : 4);
+    ok = ok && interval.NumNonzeros() == (isRowMajor ? 2 : 1) && interval.Size() == (isRowMajor ? 4 : 3) && interval.Norm2Squared() == (isRowMajor ? 25 : 16);
+
+    // the transpose shares the arrays and has the opposite layout
+    auto transpose = sparse.Transpose();
+    ok = ok && transpose.NumRows() == 4 && transpose.NumColumns() == 3 && transpose.GetValuesPointer() == sparse.GetValuesPointer();
+
+    // copies have their own arrays
+    auto copy = sparse;
+    ok = ok && copy.NumNonzeros() == 4 && copy.GetValuesPointer() != sparse.GetValuesPointer() && copy.GetMajorVector(0).GetValuesPointer()[0] == 1;
+
+    bool threw = false;
+    try
+    {
+        // index 2 is repeated within the first interval
+        math::SparseMatrix<ElementType, layout> invalid(3, 3, { 0, 2, 2, 2 }, { 2, 2 }, { 1, 1 });
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+
+    testing::ProcessTest("SparseMatrix construction <" + std::string(isRowMajor ? "CSR" : "CSC") + ">", ok && threw);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestSparseMatrixVectorMultiply()
+{
+    // large enough to be split among threads
+    const size_t numRows = 400;
+    const size_t numColumns = 300;
+    auto dense = GetRandomSparseDenseMatrix<ElementType, layout>(numRows, numColumns, 0.6);
+    math::SparseMatrix<ElementType, layout> sparse(dense);
+
+    math::ColumnVector<ElementType> x(numColumns);
+    x.Generate([i = 0]() mutable { return static_cast<ElementType>(i++ % 7) - 3; });
+    math::ColumnVector<ElementType> y(numRows);
+    y.Fill(1);
+    math::ColumnVector<ElementType> expected = y;
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(static_cast<ElementType>(2), dense, x, static_cast<ElementType>(3), expected);
+
+    math::ColumnVector<ElementType> singleThreaded = y;
+    math::MultiplyScaleAddUpdate(static_cast<ElementType>(2), sparse, x, static_cast<ElementType>(3), singleThreaded, 1);
+    math::ColumnVector<ElementType> multiThreaded = y;
+    math::MultiplyScaleAddUpdate(static_cast<ElementType>(2), sparse, x, static_cast<ElementType>(3), multiThreaded, 4);
+
+    // the transpose product, as used by full-batch gradients
+    math::RowVector<ElementType> r(numRows);
+    r.Generate([i = 0]() mutable { return static_cast<ElementType>(i++ % 5) - 2; });
+    math::RowVector<ElementType> expectedGradient(numColumns);
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(static_cast<ElementType>(1), r, dense, static_cast<ElementType>(0), expectedGradient);
+    math::RowVector<ElementType> gradient(numColumns);
+    gradient.Fill(std::numeric_limits<ElementType>::quiet_NaN()); // scalarB == 0 ignores the previous contents
+    math::MultiplyScaleAddUpdate(static_cast<ElementType>(1), r, sparse, static_cast<ElementType>(0), gradient, 4);
+
+    bool isRowMajor = layout == math::MatrixLayout::rowMajor;
+    testing::ProcessTest("SparseMatrix vector multiply <" + std::string(isRowMajor ? "CSR" : "CSC") + ">", singleThreaded == expected && multiThreaded == expected && gradient == expectedGradient);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestSparseMatrixMatrixMultiply()
+{
+    const size_t numRows = 200;
+    const size_t innerSize = 150;
+    const size_t numColumns = 37;
+    auto dense = GetRandomSparseDenseMatrix<ElementType, layout>(numRows, innerSize, 0.3);
+    math::SparseMatrix<ElementType, layout> sparse(dense);
+
+    auto matrixB = GetRandomSparseDenseMatrix<ElementType, math::MatrixLayout::rowMajor>(innerSize, numColumns, 1.0);
+    auto matrixC = GetRandomSparseDenseMatrix<ElementType, math::MatrixLayout::columnMajor>(numRows, numColumns, 1.0);
+
+    math::ColumnMatrix<ElementType> expected = matrixC;
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(static_cast<ElementType>(2), dense, matrixB, static_cast<ElementType>(-1), expected);
+
+    math::ColumnMatrix<ElementType> singleThreaded = matrixC;
+    math::MultiplyScaleAddUpdate(static_cast<ElementType>(2), sparse, matrixB, static_cast<ElementType>(-1), singleThreaded, 1);
+    math::ColumnMatrix<ElementType> multiThreaded = matrixC;
+    math::MultiplyScaleAddUpdate(static_cast<ElementType>(2), sparse, matrixB, static_cast<ElementType>(-1), multiThreaded, 4);
+
+    bool isRowMajor = layout == math::MatrixLayout::rowMajor;
+    testing::ProcessTest("SparseMatrix matrix multiply <" + std::string(isRowMajor ? "CSR" : "CSC") + ">", singleThreaded == expected && multiThreaded == expected);
+}
+
+template <typename ElementType>
+void TestSparseVectorOperations()
+{
+    std::vector<size_t> indices{ 1, 3, 4 };
+    std::vector<ElementType> values{ 2, -1, 3 };
+    math::ConstSparseRowVectorReference<ElementType> sparse(indices.data(), values.data(), indices.size(), 6);
+
+    math::RowVector<double> dense{ 1, 2, 3, 4, 5, 6 };
+    auto dot = math::Dot(sparse, dense);
+    math::ScaleAddUpdate(2.0, sparse, math::One(), dense);
+    math::RowVector<double> expected{ 1, 6, 3, 2, 11, 6 };
+
+    testing::ProcessTest("SparseVector Dot and ScaleAddUpdate", dot == 15 && dense == expected);
+}
+
+#pragma endregion implementation
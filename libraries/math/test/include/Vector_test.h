@@ -40,6 +40,9 @@ void TestVectorNorm2Squared();
 template <typename ElementType>
 void TestVectorToArray();
 
+template <typename ElementType>
+void TestStorageAlignment();
+
 // ConstVectorReference
 
 template <typename ElementType, math::VectorOrientation orientation>
@@ -112,6 +115,9 @@ void TestVectorDivideEqualsOperator();
 template <typename ElementType, math::VectorOrientation orientation>
 void TestVectorElementwiseMultiplySet();
 
+template <typename ElementType, math::VectorOrientation orientation>
+void TestVectorExpressions();
+
 template <typename ElementType, math::VectorOrientation orientation>
 void TestVectorVectorDot();
 
@@ -234,12 +240,14 @@ void TestVectorArchiver();
 
 #pragma region implementation
 
+#include <math/include/VectorExpressions.h>
 #include <math/include/VectorOperations.h>
 
 #include <testing/include/testing.h>
 
 #include <utilities/include/JsonArchiver.h>
 
+#include <cstdint>
 #include <sstream>
 
 template <typename ElementType>
@@ -349,6 +357,19 @@ void TestVectorToArray()
     testing::ProcessTest("Vector::ToArray", p.ToArray() == r0 && q.ToArray() == r1 && r == r0 && s == r1 && t == r0 && u == r1);
 }
 
+template <typename ElementType>
+void TestStorageAlignment()
+{
+    auto isAligned = [](const ElementType* pData) { return reinterpret_cast<uintptr_t>(pData) % math::storageAlignment == 0; };
+
+    math::ColumnVector<ElementType> u(std::vector<ElementType>{ 1, 2, 3 });
+    math::RowVector<ElementType> v(7);
+    v.Resize(29);
+    math::Matrix<ElementType, math::MatrixLayout::rowMajor> A(3, 5);
+
+    testing::ProcessTest("Vector and Matrix storage alignment", isAligned(u.GetConstDataPointer()) && isAligned(v.GetConstDataPointer()) && isAligned(A.GetConstDataPointer()));
+}
+
 template <typename ElementType, math::VectorOrientation orientation>
 void TestVectorEqualityOperator()
 {
@@ -625,6 +646,58 @@ void TestVectorElementwiseMultiplySet()
     testing::ProcessTest("ElementwiseMultiplySet(Vector, Vector)", w == r);
 }
 
+template <typename ElementType, math::VectorOrientation orientation>
+void TestVectorExpressions()
+{
+    // 37 elements exercises both the register loop and the tail loop
+    const size_t size = 37;
+    math::Vector<ElementType, orientation> x(size);
+    math::Vector<ElementType, orientation> y(size);
+    math::Vector<ElementType, orientation> z(size);
+    math::Vector<ElementType, orientation> strided(2 * size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        x[i] = static_cast<ElementType>(i);
+        y[i] = static_cast<ElementType>(i % 5) - 2;
+        z[i] = static_cast<ElementType>(i % 3);
+        strided[2 * i] = static_cast<ElementType>(size - i);
+    }
+    math::ConstVectorReference<ElementType, orientation> s(strided.GetConstDataPointer(), size, 2);
+
+    math::Vector<ElementType, orientation> r1(size), r2(size), r3(size), r4(size), r5(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        r1[i] = 2 * x[i] + 3 * y[i] - z[i];
+        r2[i] = x[i] * y[i] - s[i] * 2 + 1;
+        r3[i] = -x[i] + 2 * (y[i] - z[i]);
+        r4[i] = x[i] + r1[i];
+        r5[i] = z[i] - r1[i];
+    }
+
+    math::Vector<ElementType, orientation> v(size);
+    v = 2.0 * x + 3.0 * y - z;
+    testing::ProcessTest("VectorExpression: v = a * x + b * y - z", v == r1);
+
+    math::Vector<ElementType, orientation> w = math::ElementwiseMultiply(x, y) - s * 2 + 1;
+    testing::ProcessTest("VectorExpression: strided operand", w == r2);
+
+    math::Vector<ElementType, orientation> u;
+    u = -x + 2 * (y - z);
+    testing::ProcessTest("VectorExpression: negation and scaled expression", u.Size() == size && u == r3);
+
+    v = v + x;
+    testing::ProcessTest("VectorExpression: output aliases an operand", v == r4);
+
+    v = 2.0 * x + 3.0 * y - z;
+    math::Vector<ElementType, orientation> t = z;
+    t -= v + 0;
+    testing::ProcessTest("VectorExpression: operator-=", t == r5);
+
+    math::VectorReference<ElementType, orientation> strideOutput(strided.GetDataPointer(), size, 2);
+    strideOutput = 2.0 * x + 3.0 * y - z;
+    testing::ProcessTest("VectorExpression: strided output", strideOutput == r1);
+}
+
 template <typename ElementType, math::VectorOrientation orientation>
 void TestVectorVectorDot()
 {
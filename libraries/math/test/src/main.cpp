@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Matrix_test.h"
+#include "SparseMatrix_test.h"
 #include "Tensor_test.h"
 #include "Vector_test.h"
 #include "math_profile.h"
@@ -82,6 +83,7 @@ void RunOrientedVectorTests()
     TestVectorTimesEqualsOperator<ElementType, orientation>();
     TestVectorDivideEqualsOperator<ElementType, orientation>();
     TestVectorElementwiseMultiplySet<ElementType, orientation>();
+    TestVectorExpressions<ElementType, orientation>();
     TestVectorVectorDot<ElementType, orientation>();
     TestVectorArchiver<ElementType, orientation>();
     TestVectorCumulativeSumUpdate<ElementType, orientation>();
@@ -104,6 +106,7 @@ void RunVectorTests()
     TestVectorNorm2<ElementType>();
     TestVectorNorm2Squared<ElementType>();
     TestVectorToArray<ElementType>();
+    TestStorageAlignment<ElementType>();
 
     RunOrientedVectorTests<ElementType, math::VectorOrientation::row>();
     RunOrientedVectorTests<ElementType, math::VectorOrientation::column>();
@@ -119,6 +122,7 @@ void RunTripleLayoutMatrixImplementationTests()
     TestMatrixScaleAddSetOneMatrixScalar<ElementType, layout1, layout2, layout3, implementation>();
     TestMatrixScaleAddSetScalarMatrixScalar<ElementType, layout1, layout2, layout3, implementation>();
     TestMatrixMatrixMultiplyScaleAddUpdate<ElementType, layout1, layout2, layout3, implementation>();
+    TestLargeMatrixMatrixMultiplyScaleAddUpdate<ElementType, layout1, layout2, layout3, implementation>();
 }
 
 template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::ImplementationType implementation>
@@ -158,6 +162,7 @@ template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout l
 void RunDoubleLayoutMatrixTests()
 {
     TestMatrixCopyCtor<ElementType, layout1, layout2>();
+    TestMultithreadedMatrixMatrixMultiplyScaleAddUpdate<ElementType, layout1, layout2>();
 }
 
 template <typename ElementType, math::MatrixLayout layout>
@@ -221,6 +226,23 @@ void RunMatrixTests()
     RunLayoutMatrixTests<ElementType, math::MatrixLayout::rowMajor>();
 }
 
+template <typename ElementType, math::MatrixLayout layout>
+void RunLayoutSparseMatrixTests()
+{
+    TestSparseMatrixConstruction<ElementType, layout>();
+    TestSparseMatrixVectorMultiply<ElementType, layout>();
+    TestSparseMatrixMatrixMultiply<ElementType, layout>();
+}
+
+template <typename ElementType>
+void RunSparseMatrixTests()
+{
+    TestSparseVectorOperations<ElementType>();
+
+    RunLayoutSparseMatrixTests<ElementType, math::MatrixLayout::columnMajor>();
+    RunLayoutSparseMatrixTests<ElementType, math::MatrixLayout::rowMajor>();
+}
+
 template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2, math::ImplementationType implementation>
 void RunLayoutTensorImplementationTests()
 {
@@ -281,6 +303,9 @@ int main()
     RunMatrixTests<float>();
     RunMatrixTests<double>();
 
+    RunSparseMatrixTests<float>();
+    RunSparseMatrixTests<double>();
+
     RunTensorTests<float>();
     RunTensorTests<double>();
 
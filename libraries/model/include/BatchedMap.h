@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BatchedMap.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Map.h"
+#include "ModelTransformer.h"
+#include "OutputPort.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary>
+    /// The state of making a batched copy of a model, in which every port that depends on the model's input holds the
+    /// values of a batch of samples. A batched port is kept either stacked, as a single port with the samples one after
+    /// another along its outermost dimension, or as one port per sample, and is converted from one form to the other
+    /// when a node needs it. Nodes that can compute a whole batch at once get their stacked inputs from here in
+    /// `Node::Batch`.
+    /// </summary>
+    class BatchContext
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="batchSize"> The number of samples in a batch. </param>
+        BatchContext(int batchSize);
+
+        /// <summary> Returns the number of samples in a batch. </summary>
+        int GetBatchSize() const { return _batchSize; }
+
+        /// <summary> Indicates if a port of the original model holds different values for each sample of the batch. </summary>
+        ///
+        /// <param name="port"> The port of the original model. </param>
+        bool IsBatched(const OutputPortBase& port) const;
+
+        /// <summary>
+        /// Returns the port of the new model that holds the values of a batched port for all the samples, one after
+        /// another along the outermost dimension. Joins the ports of the samples if needed.
+        /// </summary>
+        ///
+        /// <param name="transformer"> The transformer making the new model. </param>
+        /// <param name="port"> The batched port of the original model. </param>
+        ///
+        /// <returns> The stacked port, or `nullptr` if the samples have padding and so can't be stacked. </returns>
+        const OutputPortBase* GetStackedPort(ModelTransformer& transformer, const OutputPortBase& port);
+
+        /// <summary> Returns the port of the new model that holds the values of a batched port for one sample. Slices the stacked port if needed. </summary>
+        ///
+        /// <param name="transformer"> The transformer making the new model. </param>
+        /// <param name="port"> The batched port of the original model. </param>
+        /// <param name="sample"> The index of the sample in the batch. </param>
+        const OutputPortBase& GetSamplePort(ModelTransformer& transformer, const OutputPortBase& port, int sample);
+
+        /// <summary> Records the port of the new model that holds the values of a port of the original model for the whole batch, stacked. </summary>
+        ///
+        /// <param name="port"> The port of the original model. </param>
+        /// <param name="stackedPort"> The port of the new model, with the layout of `port` repeated along its outermost dimension. </param>
+        void SetStackedPort(const OutputPortBase& port, const OutputPortBase& stackedPort);
+
+        /// <summary> Records the ports of the new model that hold the values of a port of the original model, one per sample. </summary>
+        ///
+        /// <param name="port"> The port of the original model. </param>
+        /// <param name="samplePorts"> The ports of the new model, one per sample of the batch. </param>
+        void SetSamplePorts(const OutputPortBase& port, const std::vector<const OutputPortBase*>& samplePorts);
+
+    private:
+        struct BatchedPort
+        {
+            const OutputPortBase* stacked = nullptr;
+            std::vector<const OutputPortBase*> samples;
+        };
+
+        int _batchSize;
+        std::unordered_map<const OutputPortBase*, BatchedPort> _ports;
+    };
+
+    /// <summary> Returns the layout of a batch of values with a given layout, stacked along the outermost dimension. </summary>
+    ///
+    /// <param name="layout"> The layout of one sample, which must not have padding. </param>
+    /// <param name="batchSize"> The number of samples in the batch. </param>
+    PortMemoryLayout GetStackedLayout(const PortMemoryLayout& layout, int batchSize);
+
+    /// <summary>
+    /// Indicates if `MakeBatchedMap` can batch a map: the map has a single input and a single output, neither of them
+    /// padded, and all the nodes of its model are pure.
+    /// </summary>
+    ///
+    /// <param name="map"> The map. </param>
+    bool CanMakeBatchedMap(const Map& map);
+
+    /// <summary>
+    /// Makes a map that computes a batch of samples per call. Its input is the inputs of the samples one after another,
+    /// and its output the outputs of the samples one after another. The nodes that implement `Node::Batch`, such as
+    /// matrix products with constant weights, compute the whole batch at once, so that each layer does one big matrix
+    /// product instead of one per sample. The other nodes are copied once per sample.
+    /// </summary>
+    ///
+    /// <param name="map"> The map to batch, which must satisfy `CanMakeBatchedMap`. </param>
+    /// <param name="batchSize"> The number of samples in a batch. </param>
+    ///
+    /// <returns> The batched map. </returns>
+    Map MakeBatchedMap(const Map& map, int batchSize);
+} // namespace model
+} // namespace ell
@@ -28,6 +28,9 @@ namespace model
         /// <returns> The name of this type. </returns>
         static std::string GetTypeName() { return "CompilableCodeNode"; }
 
+        /// <summary> Indicates if the node is pure. Code nodes can keep state (see `Reset`), so they are assumed not to be. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         CompilableCodeNode(std::string name, const std::vector<InputPortBase*>& inputs, const std::vector<OutputPortBase*>& outputs);
 
@@ -50,6 +53,8 @@ namespace model
 
         void SetFunctionParameters() const;
 
+        void DefineFunctions();
+
         std::string _name;
         mutable value::FunctionDeclaration _fn;
         mutable value::FunctionDeclaration _resetFn;
@@ -38,6 +38,17 @@ namespace model
         /// <summary> Indicates if this node is able to compile itself to code. </summary>
         bool IsCompilable(const MapCompiler* compiler) const override { return true; }
 
+        /// <summary>
+        /// Called just before the node producing one of this node's inputs is compiled, if the port it produces doesn't have a
+        /// variable yet. Nodes that only copy their inputs into their output (like `SpliceNode`) can override this to have the
+        /// producer write straight into the right part of their output, with `MapCompiler::TrySetPortVariableToView`.
+        /// The default implementation does nothing.
+        /// </summary>
+        ///
+        /// <param name="compiler"> The compiler. </param>
+        /// <param name="input"> The input port whose referenced port is about to be computed. </param>
+        virtual void OnBeginCompileInput(MapCompiler& compiler, const InputPortBase& input) {}
+
     protected:
         CompilableNode(const std::vector<InputPortBase*>& inputs, const std::vector<OutputPortBase*>& outputs) :
             Node(inputs, outputs) {}
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompileTimingReport.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary> The time and memory one phase of compiling a map took. </summary>
+    struct CompilePhaseTiming
+    {
+        std::string name;
+        int depth = 0; // the number of enclosing phases
+        double milliseconds = 0; // wall time
+        size_t peakMemory = 0; // the process's peak resident set size at the end of the phase, in bytes
+        size_t peakMemoryIncrease = 0; // how much the phase raised the process's peak resident set size, in bytes
+    };
+
+    /// <summary> Records the time and memory each phase of compiling a map takes, with the phases in the order they started. </summary>
+    class CompileTimingReport
+    {
+    public:
+        /// <summary> Records one phase, from its construction to its destruction. Does nothing if default-constructed. </summary>
+        class Phase
+        {
+        public:
+            Phase() = default;
+            Phase(CompileTimingReport& report, const std::string& name);
+            Phase(Phase&& other);
+            Phase(const Phase&) = delete;
+            Phase& operator=(const Phase&) = delete;
+            ~Phase();
+
+            /// <summary> Ends the phase before the object is destroyed. </summary>
+            void End();
+
+        private:
+            CompileTimingReport* _report = nullptr;
+            size_t _index = 0;
+            std::chrono::steady_clock::time_point _start;
+            size_t _startPeakMemory = 0;
+        };
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="enabled"> If false, phases aren't recorded. </param>
+        CompileTimingReport(bool enabled = false) :
+            _enabled(enabled) {}
+
+        /// <summary> Indicates if phases are being recorded. </summary>
+        bool IsEnabled() const { return _enabled; }
+
+        /// <summary> Starts recording a phase, nested in the phases that haven't ended yet. </summary>
+        ///
+        /// <param name="name"> The name of the phase. </param>
+        ///
+        /// <returns> An object that ends the phase when it's destroyed. </returns>
+        Phase BeginPhase(const std::string& name);
+
+        /// <summary> Adds the phases of another report, nested in the phases of this one that haven't ended yet. </summary>
+        ///
+        /// <param name="other"> The report to add. </param>
+        void Append(const CompileTimingReport& other);
+
+        /// <summary> Gets the recorded phases. </summary>
+        const std::vector<CompilePhaseTiming>& GetPhases() const { return _phases; }
+
+    private:
+        bool _enabled = false;
+        int _depth = 0;
+        std::vector<CompilePhaseTiming> _phases;
+    };
+
+    /// <summary> Writes a compile timing report as text, with nested phases indented under their parents. </summary>
+    ///
+    /// <param name="report"> The report. </param>
+    /// <param name="stream"> The stream to write to. </param>
+    void WriteCompileTimingReport(const CompileTimingReport& report, std::ostream& stream);
+
+    /// <summary> Gets the peak resident set size of the process so far. </summary>
+    ///
+    /// <returns> The peak resident set size, in bytes, or 0 if the platform doesn't report it. </returns>
+    size_t GetPeakResidentSetSize();
+} // namespace model
+} // namespace ell
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ComputeSchedule.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GateNodeBase.h"
+#include "Model.h"
+#include "OutputPort.h"
+#include "PortElements.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class Node;
+
+    /// <summary>
+    /// A schedule for computing some outputs of a model. The node order is resolved once, and the nodes are also
+    /// grouped into stages, where every node only depends on nodes from earlier stages, so the nodes within a stage
+    /// can be computed concurrently. The schedule can be reused for as long as no nodes are added to the model or
+    /// rewired, which saves visiting the model again on every compute.
+    /// </summary>
+    class ComputeSchedule
+    {
+    public:
+        ComputeSchedule() = default;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="model"> The model to compute. </param>
+        /// <param name="outputs"> The output elements to compute. </param>
+        ComputeSchedule(const Model& model, const PortElementsBase& outputs);
+
+        /// <summary> Checks if this schedule computes the given outputs of the model in its current state. </summary>
+        ///
+        /// <param name="model"> The model to compute. </param>
+        /// <param name="outputs"> The output elements to compute. </param>
+        ///
+        /// <returns> true if the schedule can be used to compute the outputs. </returns>
+        bool IsScheduleFor(const Model& model, const PortElementsBase& outputs) const;
+
+        /// <summary>
+        /// Computes the scheduled nodes. With one thread they are computed in the model's visiting order, otherwise
+        /// one stage at a time. Models with gate nodes are always computed with one thread, skipping the nodes
+        /// whose gate is closed. The threads compute in the execution context that is active on the calling thread.
+        /// </summary>
+        ///
+        /// <param name="numThreads"> The number of threads to compute the nodes of a stage with, or 0 to use one per core. </param>
+        void Compute(size_t numThreads) const;
+
+        /// <summary> Gets the values of the scheduled outputs, after they are computed. </summary>
+        ///
+        /// <param name="values"> The vector to copy the output values to. </param>
+        template <typename ValueType>
+        void GetOutput(std::vector<ValueType>& values) const;
+
+        /// <summary> Gets the number of stages in the schedule. </summary>
+        size_t NumStages() const { return _stages.size(); }
+
+        /// <summary> Gets the nodes of one of the stages. </summary>
+        ///
+        /// <param name="index"> The index of the stage. </param>
+        ///
+        /// <returns> The nodes of the stage, which don't depend on each other. </returns>
+        const std::vector<const Node*>& GetStage(size_t index) const { return _stages[index]; }
+
+        /// <summary> Gets the number of nodes in the schedule. </summary>
+        size_t NumNodes() const { return _nodes.size(); }
+
+        /// <summary> Gets the nodes of the schedule, in the order they are computed with one thread. </summary>
+        const std::vector<const Node*>& GetNodes() const { return _nodes; }
+
+    private:
+        void ComputeSerially() const;
+
+        Model _model;
+        size_t _modelSize = 0;
+        PortElementsBase _outputs;
+        std::vector<const Node*> _nodes;
+        std::vector<std::vector<const Node*>> _stages;
+        std::vector<GatedNodeRange> _gatedRanges;
+    };
+} // namespace model
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace model
+{
+    template <typename ValueType>
+    void ComputeSchedule::GetOutput(std::vector<ValueType>& values) const
+    {
+        values.clear();
+        values.reserve(_outputs.Size());
+        for (const auto& range : _outputs.GetRanges())
+        {
+            const auto& output = range.ReferencedPort()->GetOutput<ValueType>();
+            auto begin = output.begin() + range.GetStartIndex();
+            values.insert(values.end(), begin, begin + range.Size());
+        }
+    }
+} // namespace model
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ExecutionContext.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "OutputPort.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace ell
+{
+namespace value
+{
+    class ComputeContext;
+}
+
+namespace model
+{
+    class ComputeSchedule;
+    class Model;
+    class PortElementsBase;
+
+    /// <summary>
+    /// The state of one interpreted computation of a model: the outputs of its ports, including the values of its
+    /// input nodes, the compute schedule and the context of the nodes that compute with the value library. While an
+    /// execution context is active on a thread (see `ExecutionContextGuard`), output ports read and write their
+    /// outputs in it instead of in the port, so several threads can compute the same model at once, each with its own
+    /// context. Only nodes whose `IsReentrant` is true can be computed this way.
+    /// </summary>
+    class ExecutionContext
+    {
+    public:
+        ExecutionContext();
+        ExecutionContext(const ExecutionContext&) = delete;
+        ExecutionContext& operator=(const ExecutionContext&) = delete;
+        ~ExecutionContext();
+
+        /// <summary> Gets the schedule that computes some outputs of a model, and prepares the outputs of its nodes.
+        /// The schedule is kept until the model or the requested outputs change. Throws if a node of the schedule isn't
+        /// reentrant. </summary>
+        ///
+        /// <param name="model"> The model to compute. </param>
+        /// <param name="outputs"> The output elements to compute. </param>
+        ///
+        /// <returns> The schedule. </returns>
+        const ComputeSchedule& GetSchedule(const Model& model, const PortElementsBase& outputs);
+
+        /// <summary> Gets the context of the nodes that compute with the value library. </summary>
+        value::ComputeContext& GetComputeContext() { return *_computeContext; }
+
+        /// <summary> Gets the output of a port in this context. </summary>
+        ///
+        /// <param name="port"> The port. </param>
+        ///
+        /// <returns> The output of the port. </returns>
+        OutputPortBase::CachedOutput& GetOutput(const OutputPortBase& port);
+
+        /// <summary> Gets the execution context that is active on the calling thread. </summary>
+        ///
+        /// <returns> The active context, or nullptr if there is none. </returns>
+        static ExecutionContext* GetCurrent();
+
+    private:
+        friend class ExecutionContextGuard;
+
+        std::unordered_map<const OutputPortBase*, OutputPortBase::CachedOutput> _outputs;
+        std::unique_ptr<ComputeSchedule> _schedule;
+        std::unique_ptr<value::ComputeContext> _computeContext;
+    };
+
+    /// <summary> Makes an execution context active on the calling thread, and restores the previous one when it goes out of scope. </summary>
+    class ExecutionContextGuard
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="context"> The context to activate, or nullptr to compute with the outputs stored in the ports. </param>
+        ExecutionContextGuard(ExecutionContext* context);
+        ExecutionContextGuard(const ExecutionContextGuard&) = delete;
+        ExecutionContextGuard& operator=(const ExecutionContextGuard&) = delete;
+        ~ExecutionContextGuard();
+
+    private:
+        ExecutionContext* _previousContext;
+    };
+} // namespace model
+} // namespace ell
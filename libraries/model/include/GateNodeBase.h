@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GateNodeBase.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CompilableNode.h"
+#include "InputPort.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary>
+    /// Base class for nodes that gate the computation of part of a model. A gate node passes its gated input
+    /// through while its condition is true, and holds its previous output while it's false. The nodes whose
+    /// outputs are only used, directly or through other such nodes, by the gated input of a gate node are only
+    /// computed while the gate's condition is true.
+    /// </summary>
+    class GateNodeBase : public CompilableNode
+    {
+    public:
+        /// <summary> Gets the input port whose value is passed through while the condition is true. </summary>
+        virtual const InputPortBase& GetGatedInput() const = 0;
+
+        /// <summary> Gets the condition input port, which holds a single value. </summary>
+        virtual const InputPort<bool>& GetConditionInput() const = 0;
+
+        /// <summary> Checks if the condition is true, when computing the model. </summary>
+        bool IsConditionTrue() const { return GetConditionInput()[0]; }
+
+    protected:
+        GateNodeBase(const std::vector<InputPortBase*>& inputs, const std::vector<OutputPortBase*>& outputs) :
+            CompilableNode(inputs, outputs) {}
+    };
+
+    /// <summary> A range of nodes that are only computed while the condition of a gate node is true. </summary>
+    struct GatedNodeRange
+    {
+        const GateNodeBase* gate = nullptr;
+        size_t begin = 0; // the index of the first gated node
+        size_t end = 0; // one past the index of the last gated node, which is the index of the gate node itself
+    };
+
+    /// <summary> An order to compute the nodes of a model in, where the nodes a gate node controls come right before it. </summary>
+    struct GatedComputeOrder
+    {
+        std::vector<const Node*> nodes;
+        std::vector<GatedNodeRange> gatedRanges; // sorted by `begin`, with the outer range first where gates are nested
+    };
+
+    /// <summary>
+    /// Gets an order to compute some nodes in, where the nodes controlled by each gate node are moved to just
+    /// before the gate node, so they can be skipped together. Nodes without inputs are never gated.
+    /// </summary>
+    ///
+    /// <param name="nodes"> The nodes to compute, in an order where each node comes after its parents. Nodes used by nodes that aren't in the list are never gated. </param>
+    ///
+    /// <returns> The nodes in the order to compute them in, and the ranges of gated nodes. </returns>
+    GatedComputeOrder GetGatedComputeOrder(const std::vector<const Node*>& nodes);
+} // namespace model
+} // namespace ell
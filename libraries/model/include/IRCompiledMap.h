@@ -12,6 +12,9 @@
 #include "IRModelProfiler.h"
 #include "InputNode.h"
 #include "Map.h"
+#include "CompileTimingReport.h"
+#include "MapMemoryReport.h"
+#include "MapOptimizationRemarks.h"
 #include "Node.h"
 #include "OutputPort.h"
 #include "PortElements.h"
@@ -21,12 +24,14 @@
 #include <emitters/include/ModuleEmitter.h>
 
 #include <utilities/include/Boolean.h>
+#include <utilities/include/Exception.h>
 #include <utilities/include/TypeName.h>
 
 #include <functional>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
@@ -104,6 +109,41 @@ namespace model
         /// <returns> The jitter. </returns>
         emitters::IRExecutionEngine& GetJitter();
 
+        /// <summary> Gets the key the JIT-compiled code is stored under in the object cache. </summary>
+        ///
+        /// <returns> The object cache key, or an empty string if the map wasn't compiled with an object cache directory. </returns>
+        const std::string& GetObjectCacheKey() const { return _objectCacheKey; }
+
+        /// <summary> Indicates if the map was compiled with external weights (see `CompilerOptions::externalWeights`). </summary>
+        ///
+        /// <returns> `true` if the weights are in a separate blob instead of in the code. </returns>
+        bool HasExternalWeights() const { return !_externalWeights.empty(); }
+
+        /// <summary> Output the external weights blob to the given file, for the compiled code to load at runtime. </summary>
+        ///
+        /// <param name="filePath"> The file to write to </param>
+        void WriteExternalWeights(const std::string& filePath) const;
+
+        /// <summary> Output the external weights blob to a stream. </summary>
+        ///
+        /// <param name="stream"> The stream to write to </param>
+        void WriteExternalWeights(std::ostream& stream) const;
+
+        /// <summary> Gets the report of the memory the compiled code uses. </summary>
+        ///
+        /// <returns> The memory report, computed from the optimized code. </returns>
+        const MapMemoryReport& GetMemoryReport() const { return _memoryReport; }
+
+        /// <summary> Gets the LLVM optimization remarks about the compiled code, for each node function. </summary>
+        ///
+        /// <returns> The remarks, which are empty unless the map was compiled with `collectOptimizationRemarks`. </returns>
+        const MapOptimizationRemarks& GetOptimizationRemarks() const { return _optimizationRemarks; }
+
+        /// <summary> Gets the time and memory each phase of compiling the map took. </summary>
+        ///
+        /// <returns> The report, which is empty unless the map was compiled with `recordCompileTimings`. </returns>
+        const CompileTimingReport& GetCompileTimingReport() const { return _compileTimingReport; }
+
         //
         // Node profiling support
         //
@@ -117,6 +157,13 @@ namespace model
         /// <summary> Reset the performance summary for the model to zero. </summary>
         void ResetModelProfilingInfo();
 
+        /// <summary>
+        /// Get a pointer to the struct counting the calls to the model, and how many of them were timed. When the
+        /// map is compiled with `profileSamplingInterval` or `profileSamplingPeriod`, the performance counters only
+        /// add up the timed calls.
+        /// </summary>
+        ProfilingSamplingCounters* GetProfilingSamplingCounters();
+
         /// <summary> Get the number of nodes that have profiling information. </summary>
         int GetNumProfiledNodes();
 
@@ -189,6 +236,65 @@ namespace model
         /// <summary> Get the context object to use in the predict call </summary>
         void* GetContext() const { return _context; }
 
+        /// <summary>
+        /// Computes the output of the map for a batch of input samples with a single call to the
+        /// `<mapFunctionName>_batch` function. The map must have been compiled with the `emitBatchFunction` option.
+        /// </summary>
+        ///
+        /// <param name="inputs"> The input samples. </param>
+        ///
+        /// <returns> The output for each input sample. </returns>
+        template <typename InputType, typename OutputType>
+        std::vector<std::vector<OutputType>> ComputeBatch(const std::vector<std::vector<InputType>>& inputs);
+
+        /// <summary>
+        /// Computes the output of the map by calling the predict function directly on buffers that the caller owns,
+        /// so that neither the input nor the output is copied. The map must have one input and one output.
+        /// </summary>
+        ///
+        /// <param name="input"> The input buffer. </param>
+        /// <param name="inputSize"> The number of elements in the input buffer, which must be the input size of the map. </param>
+        /// <param name="output"> The output buffer. </param>
+        /// <param name="outputSize"> The number of elements in the output buffer, which must be the output size of the map. </param>
+        template <typename InputType, typename OutputType>
+        void ComputeIntoBuffer(const InputType* input, size_t inputSize, OutputType* output, size_t outputSize);
+
+        /// <summary>
+        /// Computes the output of the map for a batch of input samples that are stored one after the other in a
+        /// buffer that the caller owns, and writes the outputs one after the other to another buffer. Uses the
+        /// `<mapFunctionName>_batch` function if the map was compiled with the `emitBatchFunction` option, and calls
+        /// the predict function once per sample otherwise. The map must have one input and one output.
+        /// </summary>
+        ///
+        /// <param name="input"> The input buffer. </param>
+        /// <param name="inputSize"> The number of elements in the input buffer, which must be a multiple of the input size of the map. </param>
+        /// <param name="output"> The output buffer. </param>
+        /// <param name="outputSize"> The number of elements in the output buffer, which must be the output size of the map times the number of samples. </param>
+        ///
+        /// <returns> The number of samples. </returns>
+        template <typename InputType, typename OutputType>
+        size_t ComputeBatchIntoBuffer(const InputType* input, size_t inputSize, OutputType* output, size_t outputSize);
+
+        /// <summary>
+        /// Starts computing the output of the map for one frame on another thread, by calling the `<mapFunctionName>_async`
+        /// function. The input is copied before this returns, so the caller can fill its buffer with the next frame right
+        /// away. The output of a frame is written to its output buffer by the time the next call to `StartComputeAsync` or
+        /// `WaitForComputeAsync` returns. The map must have been compiled with the `emitAsyncFunctions` option.
+        /// </summary>
+        ///
+        /// <param name="input"> The input buffer. </param>
+        /// <param name="inputSize"> The number of elements in the input buffer, which must be the input size of the map. </param>
+        /// <param name="output"> The output buffer, which must stay valid until the output has been written. </param>
+        /// <param name="outputSize"> The number of elements in the output buffer, which must be the output size of the map. </param>
+        template <typename InputType, typename OutputType>
+        void StartComputeAsync(const InputType* input, size_t inputSize, OutputType* output, size_t outputSize);
+
+        /// <summary>
+        /// Waits for the frame started by the last call to `StartComputeAsync`, if any, and writes its output, by calling the
+        /// `<mapFunctionName>_wait` function.
+        /// </summary>
+        void WaitForComputeAsync();
+
     protected:
         void WriteCode(const std::string& filePath, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
         void WriteCode(std::ostream& stream, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
@@ -208,9 +314,13 @@ namespace model
     private:
         friend class IRMapCompiler;
 
-        IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule);
+        IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule, const std::string& objectCacheKey = "");
 
         void EnsureExecutionEngine();
+        void SetExternalWeights(std::vector<char> weights);
+        void SetMemoryReport(MapMemoryReport report) { _memoryReport = std::move(report); }
+        void SetOptimizationRemarks(MapOptimizationRemarks remarks) { _optimizationRemarks = std::move(remarks); }
+        void SetCompileTimingReport(CompileTimingReport report) { _compileTimingReport = std::move(report); }
         void SetComputeFunction();
         template <typename InputType>
         void SetComputeFunctionForInputType();
@@ -223,6 +333,13 @@ namespace model
 
         std::unique_ptr<emitters::IRExecutionEngine> _executionEngine;
         bool _verifyJittedModule = false;
+        std::string _objectCacheKey; // empty if the JIT-compiled code isn't cached
+        std::vector<char> _externalWeights; // the external weights blob, padded so the JIT-compiled code can use it from an aligned offset
+        size_t _externalWeightsOffset = 0;
+        size_t _externalWeightsSize = 0;
+        MapMemoryReport _memoryReport;
+        MapOptimizationRemarks _optimizationRemarks;
+        CompileTimingReport _compileTimingReport;
         void* _context = nullptr;
 
         template <typename T>
@@ -310,6 +427,138 @@ namespace model
         }
     }
 
+    template <typename InputType, typename OutputType>
+    std::vector<std::vector<OutputType>> IRCompiledMap::ComputeBatch(const std::vector<std::vector<InputType>>& inputs)
+    {
+        static_assert(!std::is_same_v<InputType, bool> && !std::is_same_v<OutputType, bool>, "ComputeBatch doesn't support boolean inputs or outputs");
+
+        if (!_compilerOptions.emitBatchFunction || NumInputs() != 1 || NumOutputs() != 1)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Map wasn't compiled with a batch predict function");
+        }
+
+        if (GetInput(0)->GetOutputPort().GetType() != Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+
+        // Pack the samples into contiguous arrays
+        const auto inputSize = GetInputSize(0);
+        const auto outputSize = GetOutputSize(0);
+        std::vector<InputType> inputBuffer;
+        inputBuffer.reserve(inputs.size() * inputSize);
+        for (const auto& input : inputs)
+        {
+            if (input.size() != inputSize)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Input sample has the wrong size");
+            }
+            inputBuffer.insert(inputBuffer.end(), input.begin(), input.end());
+        }
+        std::vector<OutputType> outputBuffer(inputs.size() * outputSize);
+        ComputeBatchIntoBuffer(inputBuffer.data(), inputBuffer.size(), outputBuffer.data(), outputBuffer.size());
+
+        std::vector<std::vector<OutputType>> result;
+        result.reserve(inputs.size());
+        for (size_t index = 0; index < inputs.size(); ++index)
+        {
+            auto begin = outputBuffer.begin() + index * outputSize;
+            result.emplace_back(begin, begin + outputSize);
+        }
+        return result;
+    }
+
+    template <typename InputType, typename OutputType>
+    void IRCompiledMap::ComputeIntoBuffer(const InputType* input, size_t inputSize, OutputType* output, size_t outputSize)
+    {
+        static_assert(!std::is_same_v<InputType, bool> && !std::is_same_v<OutputType, bool>, "ComputeIntoBuffer doesn't support boolean inputs or outputs");
+
+        if (NumInputs() != 1 || NumOutputs() != 1)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "ComputeIntoBuffer needs a map with one input and one output");
+        }
+
+        if (GetInput(0)->GetOutputPort().GetType() != Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+
+        if (inputSize != GetInputSize(0) || outputSize != GetOutputSize(0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Buffer sizes don't match the map");
+        }
+
+        auto functionPointer = GetJitter().ResolveFunctionAddress(_functionName);
+        auto fn = reinterpret_cast<void (*)(void*, const InputType*, OutputType*)>(functionPointer);
+        fn(_context, input, output);
+    }
+
+    template <typename InputType, typename OutputType>
+    size_t IRCompiledMap::ComputeBatchIntoBuffer(const InputType* input, size_t inputSize, OutputType* output, size_t outputSize)
+    {
+        static_assert(!std::is_same_v<InputType, bool> && !std::is_same_v<OutputType, bool>, "ComputeBatchIntoBuffer doesn't support boolean inputs or outputs");
+
+        if (NumInputs() != 1 || NumOutputs() != 1)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "ComputeBatchIntoBuffer needs a map with one input and one output");
+        }
+
+        if (GetInput(0)->GetOutputPort().GetType() != Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+
+        const auto sampleInputSize = GetInputSize(0);
+        const auto sampleOutputSize = GetOutputSize(0);
+        const auto numSamples = sampleInputSize == 0 ? 0 : inputSize / sampleInputSize;
+        if (numSamples * sampleInputSize != inputSize || numSamples * sampleOutputSize != outputSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Buffer sizes don't match a whole number of samples");
+        }
+
+        if (_compilerOptions.emitBatchFunction)
+        {
+            auto functionPointer = GetJitter().ResolveFunctionAddress(_functionName + "_batch");
+            auto fn = reinterpret_cast<void (*)(void*, int, const InputType*, OutputType*)>(functionPointer);
+            fn(_context, static_cast<int>(numSamples), input, output);
+        }
+        else
+        {
+            auto functionPointer = GetJitter().ResolveFunctionAddress(_functionName);
+            auto fn = reinterpret_cast<void (*)(void*, const InputType*, OutputType*)>(functionPointer);
+            for (size_t index = 0; index < numSamples; ++index)
+            {
+                fn(_context, input + index * sampleInputSize, output + index * sampleOutputSize);
+            }
+        }
+        return numSamples;
+    }
+
+    template <typename InputType, typename OutputType>
+    void IRCompiledMap::StartComputeAsync(const InputType* input, size_t inputSize, OutputType* output, size_t outputSize)
+    {
+        static_assert(!std::is_same_v<InputType, bool> && !std::is_same_v<OutputType, bool>, "StartComputeAsync doesn't support boolean inputs or outputs");
+
+        if (!_compilerOptions.emitAsyncFunctions || NumInputs() != 1 || NumOutputs() != 1)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Map wasn't compiled with async predict functions");
+        }
+
+        if (GetInput(0)->GetOutputPort().GetType() != Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+
+        if (inputSize != GetInputSize(0) || outputSize != GetOutputSize(0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Buffer sizes don't match the map");
+        }
+
+        auto functionPointer = GetJitter().ResolveFunctionAddress(_functionName + "_async");
+        auto fn = reinterpret_cast<void (*)(void*, const InputType*, OutputType*)>(functionPointer);
+        fn(_context, input, output);
+    }
+
     template <typename ElementType>
     ElementType* IRCompiledMap::GetGlobalValuePointer(const std::string& name)
     {
@@ -147,16 +147,38 @@ namespace model
         /// <returns> The generated name. </returns>
         std::string GetGlobalName(const Node& node, const std::string& baseName) const;
 
+        /// <summary>
+        /// Gets the key the code emitted for a node's function is cached under, when compiling with `cacheNodeFunctions`.
+        /// The key changes whenever the node, the layouts of its ports or its compiler options change.
+        /// </summary>
+        ///
+        /// <param name="node"> The node. </param>
+        /// <param name="functionName"> The name of the node's function. </param>
+        /// <returns> The key. </returns>
+        std::string GetNodeFunctionCacheKey(const Node& node, const std::string& functionName) const;
+
     protected:
         void OnBeginCompileModel(const Model& model) override;
         void OnEndCompileModel(const Model& model) override;
         void OnBeginCompileNode(const Node& node) override;
         void OnEndCompileNode(const Node& node) override;
+        void OnBeginGatedNodes(const GateNodeBase& gate) override;
+        void OnEndGatedNodes(const GateNodeBase& gate) override;
+        void OnBeginParallelBranches(size_t numBranches) override;
+        void OnBeginParallelBranch(size_t index) override;
+        void OnEndParallelBranch(size_t index) override;
+        void OnEndParallelBranches() override;
         void PushScope() override;
         void PopScope() override;
         emitters::ModuleEmitter* GetModuleEmitter() override { return &_moduleEmitter; }
         virtual std::string GetPredictFunctionName() const;
+        std::string GetBatchPredictFunctionName() const;
+        std::string GetAsyncPredictFunctionName() const;
+        std::string GetWaitPredictFunctionName() const;
         virtual void EmitModelAPIFunctions(const Map& map);
+        void EmitBatchPredictFunction(const Map& map);
+        emitters::LLVMFunction EmitBatchedMapFunction(const Map& map, int batchSize);
+        void EmitAsyncPredictFunctions(const Map& map);
 
         emitters::IRModuleEmitter _moduleEmitter;
         ModelProfiler _profiler;
@@ -165,6 +187,7 @@ namespace model
         NodeMap<emitters::IRBlockRegion*>& GetCurrentNodeBlocks();
         const Node* GetUniqueParent(const Node& node);
         void RefineAndOptimize(Map& map);
+        MapMemoryReport GetMemoryReport();
         bool TryMergeNodeIntoRegion(emitters::IRBlockRegion* pDestination, const Node& src);
 
         void EmitGetInputSizeFunction(const Map& map);
@@ -184,6 +207,22 @@ namespace model
 
         // stack of node regions
         std::vector<NodeMap<emitters::IRBlockRegion*>> _nodeRegions;
+
+        // The code of the nodes controlled by a gate node, which is skipped while the gate's condition is false
+        struct GatedBlock
+        {
+            emitters::IRBlockRegion* pRegion; // starts with the test of the condition, and ends after the gated nodes
+            emitters::LLVMValue condition;
+            size_t firstNodeRegion; // the index of the first region added for the gated nodes
+            std::vector<const Node*> nodes;
+        };
+        std::vector<GatedBlock> _gatedBlocks;
+
+        // The functions computing the independent branches of the model, which take the arguments of the map function,
+        // so the nodes in them can use its inputs and outputs
+        emitters::NamedLLVMTypeList _branchArguments;
+        std::vector<emitters::LLVMFunction> _branchFunctions;
+        bool _hasParallelBranches = false;
     };
 } // namespace model
 } // namespace ell
@@ -14,6 +14,8 @@
 #include <emitters/include/EmitterTypes.h>
 #include <emitters/include/LLVMUtilities.h>
 
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <string>
 
@@ -25,6 +27,7 @@ struct NodeInfo
 {
     const char* nodeName;
     const char* nodeType;
+    const char* nodeAncestor; // id of the node in the original model this node was created from
 };
 
 /// <summary> A struct that holds summary information about a node's runtime performance </summary>
@@ -33,6 +36,13 @@ struct PerformanceCounters
     int count;
     double totalTime;
 };
+
+/// <summary> A struct that counts the calls to a model whose profiling is sampled </summary>
+struct ProfilingSamplingCounters
+{
+    int64_t callCount; // the number of calls to the model
+    int64_t sampledCallCount; // the number of calls that were timed, which are the calls the performance counters add up
+};
 }
 
 namespace ell
@@ -48,6 +58,7 @@ namespace model
     // import NodeInfo and PerformanceCounters into our namespace
     using ::NodeInfo;
     using ::PerformanceCounters;
+    using ::ProfilingSamplingCounters;
     class Model;
 
     /// <summary> A utility class that emits IR to populate NodeInfo structs. </summary>
@@ -91,8 +102,8 @@ namespace model
         emitters::LLVMValue _performanceCountersPtr = nullptr;
         llvm::StructType* _performanceCountersType = nullptr;
 
-        // Temporary value used during processing
-        emitters::LLVMValue _startTime = nullptr;
+        // Temporary variable used during processing, so the start and end can be emitted in different blocks
+        emitters::LLVMValue _startTimeVariable = nullptr;
     };
 
     /// <summary> A utility class that holds a NodeInfoEmitter and a PerformanceCounterEmitter. </summary>
@@ -129,13 +140,20 @@ namespace model
         /// <param name="module"> The `IRModuleEmitter` to compile the model profiling information into. </param>
         /// <param name="model"> The model to profile </param>
         /// <param name="enableProfiling"> Indicates whether profiling should be enabled for this model. </param>
-        ModelProfiler(emitters::IRModuleEmitter& module, Model& model, bool enableProfiling);
+        /// <param name="samplingInterval"> Only time one in every this many calls to the model (1 = time every call). </param>
+        /// <param name="samplingPeriod"> If positive, only time a call to the model if at least this many milliseconds have passed since the last timed call. </param>
+        ModelProfiler(emitters::IRModuleEmitter& module, Model& model, bool enableProfiling, int samplingInterval = 1, double samplingPeriod = 0);
 
         /// <summary> Indicates if profiling is enabled. </summary>
         ///
         /// <returns> true if profiling is enabled, false if disabled. </returns>
         bool IsProfilingEnabled() const { return _profilingEnabled; }
 
+        /// <summary> Indicates if only some of the calls to the model are timed. </summary>
+        ///
+        /// <returns> true if profiling is enabled and sampled, false otherwise. </returns>
+        bool IsSamplingEnabled() const { return _profilingEnabled && (_samplingInterval > 1 || _samplingPeriod > 0); }
+
         /// <summary> Emit static initialization code to allocate and initialize info and perf counter data. </summary>
         void EmitInitialization();
 
@@ -185,6 +203,7 @@ namespace model
         void EmitGetNumNodeTypesFunction();
 
         void EmitGetModelPerformanceCountersFunction();
+        void EmitGetProfilingSamplingCountersFunction();
         void EmitPrintModelProfilingInfoFunction();
         void EmitResetModelProfilingInfoFunction();
 
@@ -199,16 +218,25 @@ namespace model
         void EmitResetNodeTypeProfilingInfoFunction();
 
         emitters::LLVMValue CallGetCurrentTime(emitters::IRFunctionEmitter& function);
+        emitters::LLVMValue EmitStartSample(emitters::IRFunctionEmitter& function);
+        void IfSampled(emitters::IRFunctionEmitter& function, std::function<void(emitters::IRFunctionEmitter&)> body);
 
         emitters::IRModuleEmitter* _module = nullptr;
         Model* _model = nullptr;
         bool _profilingEnabled = false;
+        int _samplingInterval = 1;
+        double _samplingPeriod = 0;
 
         llvm::StructType* _nodeInfoType = nullptr;
         llvm::StructType* _performanceCountersType = nullptr;
+        llvm::StructType* _samplingCountersType = nullptr;
 
         llvm::GlobalVariable* _modelPerformanceCountersArray = nullptr;
 
+        llvm::GlobalVariable* _samplingCountersArray = nullptr;
+        llvm::GlobalVariable* _lastSampleTime = nullptr;
+        llvm::GlobalVariable* _isSampledCall = nullptr; // set at the start of each call to the model
+
         llvm::GlobalVariable* _nodeInfoArray = nullptr;
         llvm::GlobalVariable* _nodePerformanceCountersArray = nullptr;
 
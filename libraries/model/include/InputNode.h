@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ExecutionContext.h"
 #include "InputNodeBase.h"
 #include "InputPort.h"
 #include "OutputPort.h"
@@ -163,7 +164,11 @@ namespace model
     template <typename ValueType>
     void InputNode<ValueType>::Compute() const
     {
-        _output.SetOutput(_inputValues);
+        // In an execution context, the input values were set in the context's output of the node
+        if (ExecutionContext::GetCurrent() == nullptr)
+        {
+            _output.SetOutput(_inputValues);
+        }
     }
 
     template <typename ValueType>
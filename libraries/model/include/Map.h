@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "ComputeSchedule.h"
+#include "ExecutionContext.h"
 #include "InputNode.h"
 #include "Node.h"
 #include "PortElements.h"
@@ -101,9 +103,48 @@ namespace model
         template <typename OutputVectorType, typename InputVectorType, data::IsDataVector<OutputVectorType> OutputConcept = true, data::IsDataVector<InputVectorType> InputConcept = true>
         OutputVectorType Compute(const InputVectorType& inputValues);
 
+        /// <summary>
+        /// Computes the map's output from input values without changing the map, keeping the input values, node outputs
+        /// and compute schedule in an execution context instead. Several threads can compute the same map at once, each
+        /// with its own context, as long as no thread changes the map. Every node the output depends on must be reentrant
+        /// (see `IsReentrant`).
+        /// </summary>
+        ///
+        /// <param name="inputValues"> The input to the map </param>
+        /// <param name="context"> The execution context, which must not be used by another thread at the same time </param>
+        /// <returns> A vector of output values </returns>
+        template <typename OutputType, typename InputType, utilities::IsFundamental<OutputType> OutputConcept = true, utilities::IsFundamental<InputType> InputConcept = true>
+        std::vector<OutputType> Compute(const std::vector<InputType>& inputValues, ExecutionContext& context) const;
+
+        /// <summary> Computes the map's output from input values without changing the map, keeping the execution state in a context </summary>
+        ///
+        /// <param name="inputValues"> The input to the map </param>
+        /// <param name="context"> The execution context, which must not be used by another thread at the same time </param>
+        /// <returns> A vector of output values </returns>
+        template <typename OutputVectorType, typename InputVectorType, data::IsDataVector<OutputVectorType> OutputConcept = true, data::IsDataVector<InputVectorType> InputConcept = true>
+        OutputVectorType Compute(const InputVectorType& inputValues, ExecutionContext& context) const;
+
+        /// <summary> Checks if the map's outputs can be computed in an execution context: all the nodes they depend on are reentrant </summary>
+        ///
+        /// <returns> true if the map can be computed in an execution context </returns>
+        bool IsReentrant() const;
+
         /// <summary> Reset the state of the model </summary>
         void Reset();
 
+        /// <summary>
+        /// Sets the number of threads used to compute the map's outputs. With more than one thread, nodes that don't
+        /// depend on each other are computed concurrently, so they must not share mutable state.
+        /// </summary>
+        ///
+        /// <param name="numThreads"> The number of threads, 1 to compute serially (the default), or 0 to use one per core. </param>
+        void SetNumComputeThreads(size_t numThreads) { _numComputeThreads = numThreads; }
+
+        /// <summary> Gets the number of threads used to compute the map's outputs. </summary>
+        ///
+        /// <returns> The number of threads, or 0 if one per core is used. </returns>
+        size_t GetNumComputeThreads() const { return _numComputeThreads; }
+
         /// <summary> Returns the number of inputs to the map </summary>
         ///
         /// <returns> The number of inputs to the map </returns>
@@ -450,6 +491,23 @@ namespace model
         std::vector<const Node*> GetMatchingNodesByType(const std::string name) const;
         void FixTransformedIO(ModelTransformer& transformer);
 
+        template <typename ValueType>
+        std::vector<ValueType> ComputeModelOutput(const PortElementsBase& outputs);
+
+        const ComputeSchedule& GetContextSchedule(ExecutionContext& context) const;
+
+        template <typename ValueType>
+        void SetContextInputValue(const InputNodeBase* node, const std::vector<ValueType>& inputValues) const;
+
+        template <typename DataVectorType, typename ElementsType, data::IsDataVector<DataVectorType> Concept = true>
+        void SetContextInputValue(const InputNodeBase* node, const DataVectorType& inputValues) const;
+
+        template <typename ValueType>
+        std::vector<ValueType> GetContextOutput(const ComputeSchedule& schedule) const;
+
+        template <typename DataVectorType, typename ElementsType, data::IsDataVector<DataVectorType> Concept = true>
+        DataVectorType GetContextOutput(const ComputeSchedule& schedule) const;
+
         Model _model;
 
         std::vector<InputNodeBase*> _inputNodes;
@@ -462,6 +520,9 @@ namespace model
         utilities::PropertyBag _metadata;
 
         value::ComputeContext _computeContext{"map_compute"};
+
+        size_t _numComputeThreads = 1;
+        ComputeSchedule _computeSchedule;
     };
 
     /// <summary> A serialization context used during Map deserialization. Wraps an existing `ModelSerializationContext` </summary>
@@ -519,6 +580,120 @@ namespace model
         return ComputeOutput<OutputVectorType>(GetOutput(0));
     }
 
+    template <typename OutputType, typename InputType, utilities::IsFundamental<OutputType>, utilities::IsFundamental<InputType>>
+    std::vector<OutputType> Map::Compute(const std::vector<InputType>& inputValues, ExecutionContext& context) const
+    {
+        if (_inputNodes.size() != 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Map::Compute can only be called on maps with a single input");
+        }
+
+        auto node = dynamic_cast<const InputNode<InputType>*>(GetInput(0));
+        if (node == nullptr)
+        {
+            std::string nodeType = "missing InputNode<";
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, nodeType + utilities::TypeName<InputType>::GetName() + ">");
+        }
+
+        ExecutionContextGuard guard(&context);
+        value::ContextGuard<> computeGuard(context.GetComputeContext());
+        const auto& schedule = GetContextSchedule(context);
+        SetContextInputValue(node, inputValues);
+        schedule.Compute(_numComputeThreads);
+        return GetContextOutput<OutputType>(schedule);
+    }
+
+    template <typename OutputVectorType, typename InputVectorType, data::IsDataVector<OutputVectorType>, data::IsDataVector<InputVectorType>>
+    OutputVectorType Map::Compute(const InputVectorType& inputValues, ExecutionContext& context) const
+    {
+        if (_inputNodes.size() != 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Map::Compute can only be called on maps with a single input");
+        }
+
+        ExecutionContextGuard guard(&context);
+        value::ContextGuard<> computeGuard(context.GetComputeContext());
+        const auto& schedule = GetContextSchedule(context);
+        auto node = GetInput(0);
+        switch (node->GetOutputPort().GetType())
+        {
+        case Port::PortType::smallReal:
+            SetContextInputValue<InputVectorType, float>(node, inputValues);
+            break;
+        case Port::PortType::real:
+            SetContextInputValue<InputVectorType, double>(node, inputValues);
+            break;
+        case Port::PortType::integer:
+            SetContextInputValue<InputVectorType, int>(node, inputValues);
+            break;
+        case Port::PortType::bigInt:
+            SetContextInputValue<InputVectorType, int64_t>(node, inputValues);
+            break;
+        case Port::PortType::boolean:
+            SetContextInputValue<InputVectorType, bool>(node, inputValues);
+            break;
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument);
+        }
+
+        schedule.Compute(_numComputeThreads);
+
+        switch (GetOutput(0).GetPortType())
+        {
+        case Port::PortType::smallReal:
+            return GetContextOutput<OutputVectorType, float>(schedule);
+        case Port::PortType::real:
+            return GetContextOutput<OutputVectorType, double>(schedule);
+        case Port::PortType::integer:
+            return GetContextOutput<OutputVectorType, int>(schedule);
+        case Port::PortType::bigInt:
+            return GetContextOutput<OutputVectorType, int64_t>(schedule);
+        case Port::PortType::boolean:
+            return GetContextOutput<OutputVectorType, bool>(schedule);
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument);
+        }
+    }
+
+    template <typename ValueType>
+    void Map::SetContextInputValue(const InputNodeBase* node, const std::vector<ValueType>& inputValues) const
+    {
+        const auto& output = node->GetOutputPort();
+        if (output.Size() != inputValues.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
+                                            ell::utilities::FormatString("InputNode output size %zu doesn't match input size %zu", output.Size(), inputValues.size()));
+        }
+
+        // The input node doesn't overwrite its output in an execution context
+        output.SetOutput(inputValues);
+    }
+
+    template <typename DataVectorType, typename ElementsType, data::IsDataVector<DataVectorType>>
+    void Map::SetContextInputValue(const InputNodeBase* node, const DataVectorType& inputValues) const
+    {
+        auto inputSize = node->GetOutputPort().Size();
+        auto inputArray = inputValues.ToArray(inputSize);
+        std::vector<ElementsType> array = utilities::TransformVector(inputArray.begin(), inputArray.end(), [](auto x) { return MapImpl::FromDouble<ElementsType>(x); });
+        SetContextInputValue(node, array);
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> Map::GetContextOutput(const ComputeSchedule& schedule) const
+    {
+        std::vector<ValueType> result;
+        schedule.GetOutput(result);
+        return result;
+    }
+
+    template <typename DataVectorType, typename ElementsType, data::IsDataVector<DataVectorType>>
+    DataVectorType Map::GetContextOutput(const ComputeSchedule& schedule) const
+    {
+        auto resultVector = GetContextOutput<ElementsType>(schedule);
+        auto resultVectorIterator = data::MakeVectorIndexValueIterator<data::IterationPolicy::skipZeros>(resultVector);
+        return { resultVectorIterator };
+    }
+
     //
     // SetInput
     //
@@ -9,9 +9,14 @@
 #pragma once
 
 #include "CompilableNodeUtilities.h"
+#include "CompileTimingReport.h"
+#include "GateNodeBase.h"
 #include "MapCompilerOptions.h"
+#include "MapMemoryReport.h"
 #include "ModelOptimizerOptions.h"
 #include "OutputPort.h"
+#include "ParallelBranches.h"
+#include "PortBufferAllocator.h"
 
 #include <emitters/include/CompilerOptions.h>
 #include <emitters/include/EmitterTypes.h>
@@ -21,9 +26,12 @@
 #include <utilities/include/UniqueNameList.h>
 
 #include <cassert>
+#include <memory>
 #include <stack>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace ell
 {
@@ -80,6 +88,17 @@ namespace model
         /// <returns> The ModelOptimizerOptions struct used by the map compiler to control code generation. </returns>
         ModelOptimizerOptions GetModelOptimizerOptions(const Node& node) const;
 
+        /// <summary>
+        /// Indicates if the node's code should be emitted into the function that uses it, rather than into a function of
+        /// its own. This is the case if the node's options set `inlineNodes`, or if the node is elementwise and
+        /// `inlineElementwiseNodes` is set, or if its ports hold at most `inlineNodeSizeLimit` elements in all.
+        /// </summary>
+        ///
+        /// <param name="node"> The node to check. </param>
+        ///
+        /// <returns> `true` if the node should be inlined. </returns>
+        bool ShouldInlineNode(const Node& node) const;
+
         //
         // Routines for Node implementers
         //
@@ -108,6 +127,38 @@ namespace model
         /// <summary> Associate the given variable with the output port. </summary>
         void SetVariableForPort(const Port& port, emitters::Variable* pVar);
 
+        /// <summary>
+        /// Makes the variable for an output port a view of a contiguous range of another port's variable, instead of giving
+        /// the port a buffer of its own, so nodes that only copy data between the two can skip the copy. The source port gets
+        /// a variable if it doesn't have one yet. Does nothing if `aliasPortBuffers` is off, if the port already has a variable,
+        /// if it's a scalar, or if the source's variable is an output argument of the map function (which the caller may pass as null).
+        /// </summary>
+        ///
+        /// <param name="port"> The port to make a view. </param>
+        /// <param name="source"> The port whose variable the view is into. </param>
+        /// <param name="offset"> The offset of the view into the source's variable, in elements. </param>
+        ///
+        /// <returns> `true` if the port's variable is now a view of the source's. </returns>
+        bool TrySetPortVariableToView(const OutputPortBase& port, const OutputPortBase& source, int offset);
+
+        /// <summary> Indicates if a port's variable is the view of another port's variable made by `TrySetPortVariableToView`. </summary>
+        ///
+        /// <param name="port"> The port to check. </param>
+        /// <param name="source"> The port whose variable the view should be into. </param>
+        /// <param name="offset"> The offset of the view into the source's variable, in elements. </param>
+        ///
+        /// <returns> `true` if the port's variable is a view into the source's variable at the given offset. </returns>
+        bool IsPortVariableView(const OutputPortBase& port, const OutputPortBase& source, int offset);
+
+        /// <summary> Gets the port buffer memory live while each node of the last compiled map runs, in the order the nodes were compiled. </summary>
+        const std::vector<NodeMemoryUsage>& GetNodeMemoryUsage() const { return _nodeMemoryUsage; }
+
+        /// <summary>
+        /// Gets the report the compiler records the time and memory of its phases in, if `recordCompileTimings` is set.
+        /// Transformations run by the compiler can add their own phases to it.
+        /// </summary>
+        CompileTimingReport& GetCompileTimingReport() const { return _compileTimingReport; }
+
     protected:
         MapCompiler(const MapCompilerOptions& settings, const ModelOptimizerOptions& optimizerOptions);
 
@@ -128,6 +179,13 @@ namespace model
         /// </summary>
         emitters::NamedVariableTypeList AllocateMapFunctionArguments(Map& map, emitters::ModuleEmitter& emitter);
 
+        /// <summary>
+        /// Compiles the nodes of another version of the map, such as a batched one, into the current function, whose
+        /// arguments were allocated by `AllocateMapFunctionArguments`. The memory usage recorded for the map compiled by
+        /// `CompileMap` is kept.
+        /// </summary>
+        void CompileAdditionalMapNodes(Map& map);
+
         //
         // These methods may be implemented by specific compilers
         //
@@ -135,6 +193,12 @@ namespace model
         virtual void OnEndCompileModel(const Model& /*model*/) {}
         virtual void OnBeginCompileNode(const Node& /*node*/) {}
         virtual void OnEndCompileNode(const Node& /*node*/) {}
+        virtual void OnBeginGatedNodes(const GateNodeBase& /*gate*/) {}
+        virtual void OnEndGatedNodes(const GateNodeBase& /*gate*/) {}
+        virtual void OnBeginParallelBranches(size_t /*numBranches*/) {}
+        virtual void OnBeginParallelBranch(size_t /*index*/) {}
+        virtual void OnEndParallelBranch(size_t /*index*/) {}
+        virtual void OnEndParallelBranches() {}
         virtual void PushScope();
         virtual void PopScope();
         virtual emitters::ModuleEmitter* GetModuleEmitter() = 0;
@@ -149,6 +213,13 @@ namespace model
         friend class CompilableNode;
 
         void CompileNodes(Model& model);
+        void CompileNode(const Node& node, std::unordered_set<const Node*>& visitedNodes);
+        bool CanParallelizeBranches(const GatedComputeOrder& order) const;
+        void CompileParallelBranches(const ParallelBranchOrder& order, std::unordered_set<const Node*>& visitedNodes);
+        emitters::Variable* AllocateSharedPortVariable(const OutputPortBase& port);
+        emitters::Variable* AllocateStackPortVariable(const OutputPortBase& port);
+        bool CanAllocatePortOnStack(const OutputPortBase& port) const;
+        bool IsSharingBuffers() const;
         emitters::Variable* AllocatePortFunctionArgument(emitters::ModuleEmitter& emitter, const OutputPortBase& port, ArgType argType, ell::utilities::UniqueNameList& list);
         emitters::Variable* AllocatePortFunctionArgument(emitters::ModuleEmitter& emitter, const PortElementBase& element, ArgType argType, ell::utilities::UniqueNameList& list);
 
@@ -158,6 +229,23 @@ namespace model
         // map from ports to runtime variables, for all ports in the model
         // stored as a stack, with the top of the stack being the innermost scope
         std::vector<std::unordered_map<const Port*, emitters::Variable*>> _portToVarMaps; // Do we need separate elementToVarMaps?
+
+        // shared buffers for intermediate results, used if `reuseIntermediateBuffers` is set
+        std::unique_ptr<PortBufferAllocator> _bufferAllocator;
+        std::vector<emitters::Variable*> _sharedBufferVariables;
+        std::unordered_map<const emitters::Variable*, size_t> _sharedBufferIndices;
+
+        // the memory used by the port buffers, for the memory report
+        size_t _dedicatedPortBufferSize = 0; // buffers that aren't shared, which are live for the whole map function
+        size_t _stackPortBufferSize = 0; // the part of the dedicated buffers allocated on the stack of the map function
+        bool _isCompilingNodes = false;
+        bool _isCompilingBranches = false;
+        std::vector<NodeMemoryUsage> _nodeMemoryUsage;
+
+        // variables made by `TrySetPortVariableToView`, with the variable and offset they're a view into
+        std::unordered_map<const emitters::Variable*, std::pair<emitters::Variable*, int>> _portVariableViews;
+
+        mutable CompileTimingReport _compileTimingReport;
     };
 } // namespace model
 } // namespace ell
@@ -187,6 +275,7 @@ namespace model
 
         pModuleEmitter->AllocateVariable(*pVar);
         SetVariableForPort(port, pVar);
+        _dedicatedPortBufferSize += port.Size() * GetPortElementSize(port.GetType());
         return pVar;
     }
 
@@ -36,9 +36,26 @@ namespace model
         std::string sinkFunctionName;
         bool verifyJittedModule = false;
         bool profile = false;
+        int profileSamplingInterval = 1; // with `profile`, only time one in every this many calls to the map
+        double profileSamplingPeriod = 0; // with `profile`, if positive, only time a call if this many milliseconds have passed since the last timed one (overrides `profileSamplingInterval`)
+        bool reuseIntermediateBuffers = false; // share global buffers between output ports that aren't live at the same time
+        bool aliasPortBuffers = true; // let nodes that only copy data (e.g., slices and splices) use views of their inputs' buffers instead
+        int maxStackPortBufferSize = 0; // if positive, port buffers of at most this many bytes, whose contents don't outlive a call to the map function, are allocated on its stack instead of as globals
+        bool parallelizeBranches = false; // with `compilerSettings.parallelize`, compute the independent branches of the model (like the members of an ensemble) as concurrent tasks
+        bool emitBatchFunction = false; // also emit a `<mapFunctionName>_batch` function that processes several samples per call
+        int batchFunctionSize = 16; // with `emitBatchFunction`, compute this many samples at once when the map can be batched, so each matrix product is done once for all of them
+        bool emitAsyncFunctions = false; // also emit `<mapFunctionName>_async` and `<mapFunctionName>_wait` functions that compute a frame on another thread while the next one is filled in
+        std::string objectCacheDirectory; // if set, cache the JIT-compiled object code in this directory and reuse it on later runs
+        bool cacheNodeFunctions = false; // reuse the code emitted for a node's function by earlier compiles of an identical node, with identical options
+        std::string nodeFunctionCacheDirectory; // with `cacheNodeFunctions`, also cache the node functions' IR in this directory, so later runs can reuse it
+        bool recordCompileTimings = false; // record the wall time and peak memory of each compile phase and model transformation in a `CompileTimingReport`
+        bool noHeap = false; // guarantee the compiled code never allocates heap memory: implies `reuseIntermediateBuffers` and `compilerSettings.staticMemory`
+        bool collectOptimizationRemarks = false; // collect LLVM's vectorization, unrolling and inlining remarks for each node function, keeping the node functions out of line so the remarks can be traced back to the nodes
 
         // per-node options
         bool inlineNodes = false;
+        bool inlineElementwiseNodes = false; // with `inlineNodes` off, still inline nodes whose output elements each depend only on the corresponding input elements
+        int inlineNodeSizeLimit = 0; // with `inlineNodes` off, still inline nodes whose input and output ports hold at most this many elements in all
 
         // lower-level emitters settings
         emitters::CompilerOptions compilerSettings;
@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MapMemoryReport.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary> The memory in use while a node runs. </summary>
+    struct NodeMemoryUsage
+    {
+        std::string nodeId;
+        std::string nodeType;
+        size_t liveBufferSize = 0; // the size, in bytes, of the port buffers that hold live values while the node runs
+    };
+
+    /// <summary> The memory a compiled map uses, for checking a model against a device's RAM budget. </summary>
+    struct MapMemoryReport
+    {
+        uint64_t staticMemorySize = 0; // mutable global variables: the port buffers, scratch arrays and node state, in bytes
+        uint64_t constantMemorySize = 0; // constant global variables, like the weights, in bytes
+        uint64_t stackSize = 0; // estimated stack high-water of the predict function, in bytes
+        bool isStackSizeBounded = true; // false if the predict function calls callbacks, recursive functions or allocates a variable amount of stack
+        std::vector<std::string> heapFunctions; // the heap allocation functions the compiled code calls
+        std::vector<NodeMemoryUsage> nodes; // in the order the nodes run
+
+        /// <summary> Gets the largest amount of port buffer memory live at one time. </summary>
+        size_t GetPeakLiveBufferSize() const;
+    };
+
+    /// <summary> Writes a memory report as text. </summary>
+    ///
+    /// <param name="report"> The report. </param>
+    /// <param name="stream"> The stream to write to. </param>
+    void WriteMemoryReport(const MapMemoryReport& report, std::ostream& stream);
+} // namespace model
+} // namespace ell
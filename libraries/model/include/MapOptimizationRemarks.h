@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MapOptimizationRemarks.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <emitters/include/IRDiagnosticHandler.h>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary> The optimization remarks about the code of one function of a compiled map. </summary>
+    struct FunctionOptimizationRemarks
+    {
+        std::string functionName;
+        std::string nodeId; // the node the function was emitted for (the first one, if identical nodes share it), or empty
+        std::string nodeType;
+        std::vector<emitters::IROptimizationRemark> remarks; // in the order the passes created them
+
+        /// <summary> Counts the remarks of a given kind from a given pass. </summary>
+        size_t Count(emitters::IROptimizationRemark::Kind kind, const std::string& passName) const;
+    };
+
+    /// <summary> The LLVM optimization remarks about a compiled map, grouped by function. </summary>
+    struct MapOptimizationRemarks
+    {
+        std::vector<FunctionOptimizationRemarks> functions; // the node functions first, in the order they were emitted
+    };
+
+    /// <summary> Groups optimization remarks by the function they are about. </summary>
+    ///
+    /// <param name="remarks"> The remarks. </param>
+    /// <param name="nodeFunctions"> For each node function, its name and the id and type name of its node. </param>
+    ///
+    /// <returns> The remarks, grouped by function. </returns>
+    MapOptimizationRemarks GroupOptimizationRemarks(const std::vector<emitters::IROptimizationRemark>& remarks, const std::vector<FunctionOptimizationRemarks>& nodeFunctions);
+
+    /// <summary> Writes a summary of the optimization remarks for each function as text: the number of loops that were
+    /// vectorized, not vectorized and unrolled, the number of calls inlined, and the reasons given for the missed
+    /// optimizations. </summary>
+    ///
+    /// <param name="remarks"> The remarks. </param>
+    /// <param name="stream"> The stream to write to. </param>
+    void WriteOptimizationRemarks(const MapOptimizationRemarks& remarks, std::ostream& stream);
+} // namespace model
+} // namespace ell
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MapPipeline.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Map.h"
+
+#include <utilities/include/LockFreeQueue.h>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class ModelProfileData;
+    class Node;
+
+    /// <summary>
+    /// Gets the estimated cost of computing a node. With profile data, the cost is the node's average running time,
+    /// otherwise it is the number of values the node reads and writes.
+    /// </summary>
+    ///
+    /// <param name="node"> The node. </param>
+    /// <param name="profileData"> Optional profile data, gathered by running the model the node belongs to. </param>
+    ///
+    /// <returns> The estimated cost of the node. </returns>
+    double GetPipelineNodeCost(const Node& node, const ModelProfileData* profileData);
+
+    /// <summary>
+    /// Splits a map into a chain of maps that compute it one after the other, for running them as the stages of a
+    /// pipeline. The nodes are kept in dependency order, and the map is only cut where a single output port
+    /// carries all the values the later nodes need from the earlier ones, which becomes the output of one stage
+    /// and the input of the next. Of those cuts, the ones that minimize the cost of the most expensive stage are
+    /// chosen. Constant nodes are copied into every stage that uses them.
+    /// </summary>
+    ///
+    /// <param name="map"> The map to split. It must have a single input and a single output, and no sink nodes. </param>
+    /// <param name="numStages"> The number of stages wanted. Fewer are returned if the map can't be cut that many times. </param>
+    /// <param name="profileData"> Optional profile data, gathered by running the map compiled with profiling enabled. </param>
+    ///
+    /// <returns> The stages. The first stage has the inputs of the map, and the last stage its outputs. </returns>
+    std::vector<Map> SplitMapIntoStages(const Map& map, size_t numStages, const ModelProfileData* profileData = nullptr);
+
+    /// <summary>
+    /// Joins two maps into one that computes the second map on the output of the first, e.g. an audio featurizer
+    /// followed by a classifier, so they can be compiled into a single module. The first map's output node, if any,
+    /// is dropped, so the value passed between them is an ordinary port of the joined model rather than a copy
+    /// made by the host.
+    /// </summary>
+    ///
+    /// <param name="first"> The first map. It must have a single input and a single output, and no sink nodes. </param>
+    /// <param name="second"> The second map. It must have a single input and a single output, and no sink nodes, and
+    /// its input must have the type and size of the first map's output. </param>
+    ///
+    /// <returns> The joined map, with the input of the first map and the output of the second. </returns>
+    Map ChainMaps(const Map& first, const Map& second);
+
+    /// <summary>
+    /// Runs a chain of maps as a pipeline, each stage on its own thread, so a new input can be started before
+    /// the previous ones finish. The stages pass values through lock-free queues, and wait by yielding the thread,
+    /// which keeps the latency of each hop low at the cost of keeping the cores busy while the pipeline runs.
+    /// The maps can be compiled maps, as long as each one has a single input and output.
+    /// </summary>
+    class MapPipeline
+    {
+    public:
+        /// <summary> Constructor. Starts the stage threads. </summary>
+        ///
+        /// <param name="stages"> The maps to run, in order. The output of each map is the input of the next one. </param>
+        /// <param name="queueSize"> The number of values that can wait in front of each stage. </param>
+        MapPipeline(const std::vector<Map*>& stages, size_t queueSize = 4);
+
+        MapPipeline(const MapPipeline&) = delete;
+        MapPipeline& operator=(const MapPipeline&) = delete;
+
+        /// <summary> Destructor. Stops the stage threads, dropping any values still in the pipeline. </summary>
+        ~MapPipeline();
+
+        /// <summary> Sends an input into the pipeline, waiting while the first stage's queue is full. </summary>
+        ///
+        /// <param name="input"> The input to the first stage. </param>
+        void Push(const std::vector<double>& input);
+
+        /// <summary> Gets the next output of the pipeline, waiting until there is one. </summary>
+        ///
+        /// <returns> The output of the last stage, in the order the inputs were pushed. </returns>
+        std::vector<double> Pop();
+
+        /// <summary> Gets the next output of the pipeline, if there is one. </summary>
+        ///
+        /// <param name="output"> Receives the output of the last stage. </param>
+        ///
+        /// <returns> true if there was an output. </returns>
+        bool TryPop(std::vector<double>& output);
+
+        /// <summary> Gets the number of stages. </summary>
+        size_t NumStages() const { return _stages.size(); }
+
+    private:
+        using Queue = utilities::LockFreeQueue<std::vector<double>>;
+
+        void RunStage(size_t index);
+        void Stop();
+        void RethrowStageError();
+
+        std::vector<Map*> _stages;
+        std::vector<std::unique_ptr<Queue>> _queues; // _queues[i] feeds stage i, and the last queue holds the outputs
+        std::vector<std::thread> _threads;
+        std::atomic<bool> _stop;
+        std::mutex _errorMutex;
+        std::exception_ptr _error;
+    };
+} // namespace model
+} // namespace ell
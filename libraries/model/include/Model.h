@@ -63,8 +63,11 @@ namespace model
         void SetOutputNodesToVisit(const std::vector<const Node*>& outputs);
         void SetOutputPortsToVisit(const std::vector<const OutputPortBase*>& outputs);
 
+        bool IsNodeVisited(const Node* node) const;
+
         const Model* _model = nullptr;
-        std::unordered_set<const Node*> _visitedNodes;
+        std::vector<bool> _visitedNodes; // indexed by the nodes' positions in the model
+
         std::unordered_set<const InputPortBase*> _submodelInputs;
         std::unordered_set<const Node*> _submodelInputParents;
         std::vector<const Node*> _nodesToVisit;
@@ -179,7 +182,7 @@ namespace model
         /// <summary> Get number of nodes </summary>
         ///
         /// <returns> The number of nodes in the model </summary>
-        size_t Size() const { return _data->idToNodeMap.size(); }
+        size_t Size() const { return _data->nodes.size(); }
 
         /// <summary> Retrieves a set of nodes by type </summary>
         ///
@@ -389,12 +392,14 @@ namespace model
         friend class Map;
         friend void swap(Model& a, Model& b);
 
-        using IDToNodeMap = std::map<Node::NodeId, std::shared_ptr<Node>, std::less<Node::NodeId>>;
+        using NodeArray = std::vector<std::unique_ptr<Node>>;
+        using IDToNodeMap = std::unordered_map<Node::NodeId, Node*>;
         struct ModelData
         {
-            // The id->node map acts both as the main container that holds the shared pointers to nodes, and as the index
-            // to look nodes up by id.
-            // We keep it sorted by id to make visiting all nodes deterministically ordered
+            // The node array is the main container that owns the nodes. It keeps them densely, in the order they were
+            // added, which makes visiting all nodes deterministically ordered, and a node's position in it is a cheap
+            // integer key for it. The id->node map is only the index to look nodes up by id.
+            NodeArray nodes;
             IDToNodeMap idToNodeMap;
             utilities::PropertyBag metadata;
         };
@@ -412,7 +417,7 @@ namespace model
         void VerifyInputs(const Node& node) const;
         Node::NodeId GetUniqueId(const Node::NodeId& desiredId);
         static Node::NodeId GetNextId(Node::NodeId id);
-        const IDToNodeMap& GetNodeMap() const;
+        const NodeArray& GetNodeArray() const;
 
         template <typename Visitor>
         void VisitIteratedNodes(NodeIterator& iter, Visitor&& visitor) const;
@@ -24,7 +24,9 @@ namespace model
         diagonal,
         simple,
         winograd,
-        unrolled
+        unrolled,
+        depthwise,
+        blocked
     };
 
     // Interchange format:
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ModelProfileData.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/PropertyBag.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class IRCompiledMap;
+
+    /// <summary> The accumulated running time of a node in the original (uncompiled) model. </summary>
+    struct NodeProfileData : public utilities::IArchivable
+    {
+        std::string nodeId; // the id of the node in the model that was compiled, before any refinement or optimization
+        std::string nodeType;
+        int count = 0;
+        double totalTime = 0; // milliseconds
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "NodeProfileData"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+    };
+
+    /// <summary> Settings that control how profile data is turned into per-node compiler options. </summary>
+    struct ProfileGuidedOptions
+    {
+        /// <summary> The hottest nodes that together account for this fraction of the total time get the "hot" options. </summary>
+        double hotTimeFraction = 0.9;
+
+        /// <summary> Compiler options set on the hot nodes. </summary>
+        utilities::PropertyBag hotNodeOptions;
+
+        /// <summary> Compiler options set on all the other (cold) nodes. </summary>
+        utilities::PropertyBag coldNodeOptions;
+
+        /// <summary> Gets the default settings: hot nodes are unrolled, vectorized, and parallelized, and cold nodes are kept small. </summary>
+        static ProfileGuidedOptions GetDefault();
+    };
+
+    /// <summary>
+    /// Per-node timing information gathered by running a model compiled with profiling enabled. The times are keyed
+    /// on the ids of the nodes in the model that was compiled, so the data can be used when compiling that model again.
+    /// </summary>
+    class ModelProfileData : public utilities::IArchivable
+    {
+    public:
+        ModelProfileData() = default;
+
+        /// <summary> Gets the profile data from the performance counters of a map compiled with profiling enabled. </summary>
+        ///
+        /// <param name="map"> The compiled map. It must have been compiled with the `profile` option set. </param>
+        explicit ModelProfileData(IRCompiledMap& map);
+
+        /// <summary> Adds time to the given node, creating an entry for it if necessary. </summary>
+        void AddNodeTime(const std::string& nodeId, const std::string& nodeType, int count, double totalTime);
+
+        /// <summary> Returns the profile data for all the nodes. </summary>
+        const std::vector<NodeProfileData>& GetNodes() const { return _nodes; }
+
+        /// <summary> Returns the total time spent in all the nodes. </summary>
+        double GetTotalTime() const;
+
+        /// <summary>
+        /// Gets per-node compiler options derived from the timing data, in the form accepted by `SetCompilerOptionsTransformation`:
+        /// `{ 'nodes' : { <node-id> : <options>, ... } }`.
+        /// </summary>
+        ///
+        /// <param name="options"> The settings that decide which nodes are hot, and which options hot and cold nodes get. </param>
+        ///
+        /// <returns> A `PropertyBag` with a 'nodes' entry containing the options for each profiled node. </returns>
+        utilities::PropertyBag GetCompilerOptions(const ProfileGuidedOptions& options) const;
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "ModelProfileData"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        std::vector<NodeProfileData> _nodes;
+    };
+
+    /// <summary> Loads profile data from a JSON file. </summary>
+    ModelProfileData LoadModelProfileData(const std::string& filename);
+
+    /// <summary> Loads profile data from a JSON stream. </summary>
+    ModelProfileData LoadModelProfileData(std::istream& stream);
+
+    /// <summary> Saves profile data to a JSON file. </summary>
+    void SaveModelProfileData(const ModelProfileData& profileData, const std::string& filename);
+
+    /// <summary> Saves profile data to a JSON stream. </summary>
+    void SaveModelProfileData(const ModelProfileData& profileData, std::ostream& stream);
+} // namespace model
+} // namespace ell
@@ -31,6 +31,7 @@ namespace ell
 {
 namespace model
 {
+    class BatchContext;
     class InputNodeBase;
     template <typename ValueType>
     class InputNode;
@@ -260,6 +261,14 @@ namespace model
         /// <returns> Returns `true` if the node refined itself into something different. </returns>
         bool RefineNode(const Node& node);
 
+        /// <summary> Adds nodes to the new model that compute the target node for a whole batch of samples at once (see BatchedMap.h) </summary>
+        ///
+        /// <param name="node"> The target node, some of whose inputs are batched </param>
+        /// <param name="batch"> The state of the batching, which holds the batched versions of the node's inputs </param>
+        ///
+        /// <returns> Returns `true` if the node batched itself, or `false` if it has to be copied once per sample. </returns>
+        bool BatchNode(const Node& node, BatchContext& batch);
+
         /// <summary> Sets up an old-to-new model output mapping. Called by node implementors </summary>
         ///
         /// <param name="oldPort"> The port in the old model to map to the new model. </param>
@@ -304,6 +313,7 @@ namespace model
             bool IsOutputMapped(const OutputPortBase& queryPort) const;
             const OutputPortBase& GetCorrespondingPort(const OutputPortBase& port, bool isInPlace) const;
             void MapNodeOutput(const OutputPortBase* oldPort, const OutputPortBase* newPort);
+            void UnmapNodeOutput(const OutputPortBase* oldPort);
             static PortOutputsMap ConcatenateMaps(const PortOutputsMap& oldMap, const PortOutputsMap& newMap, bool isInPlace);
 
         private:
@@ -326,12 +336,13 @@ namespace model
 
         /// <summary>
         /// Assign ancestor to newly transformed or refined nodes. This maps relationship between nodes of original
-        /// model and nodes of new model. Note that, this assumes new nodes are always appended at the end of existing
-        /// nodes. Thus, it assigns ancestor from the node at the end of model to the last node without ancestor.
+        /// model and nodes of new model. New nodes are always appended at the end of the model's node array, so only
+        /// the nodes added since `firstNewNodeIndex` that don't have an ancestor yet are visited.
         /// </summary>
         ///
         /// <param name="ancestorNode"> The ancestor node or the immediate parent node that contains ancestor information. </param>
-        void AssignNodeAncestor(const Node& ancestorNode);
+        /// <param name="firstNewNodeIndex"> The size of the destination model before the ancestor node was transformed. </param>
+        void AssignNodeAncestor(const Node& ancestorNode, size_t firstNewNodeIndex);
 
         Model _model;
         TransformContext _context;
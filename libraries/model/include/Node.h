@@ -22,6 +22,7 @@ namespace ell
 /// <summary> model namespace </summary>
 namespace model
 {
+    class BatchContext;
     class InputPortBase;
     class MapCompiler;
     class Model;
@@ -173,6 +174,23 @@ namespace model
         /// <summary> Resets any state on the node, if any </summary>
         virtual void Reset() {}
 
+        /// <summary>
+        /// Indicates if the node's outputs depend only on the current values of its inputs: it carries no state from one call
+        /// to `Compute` to the next, and has no side effects. Pure nodes with constant inputs can be computed ahead of time.
+        /// </summary>
+        ///
+        /// <returns> `true` if the node is pure. </returns>
+        virtual bool IsPure() const { return true; }
+
+        /// <summary>
+        /// Indicates if several threads can compute the node at once, each in its own execution context (see
+        /// ExecutionContext.h): the node keeps its outputs in its output ports only, and changes no state of its own in
+        /// `Compute`. Pure nodes are reentrant, unless they keep scratch state in mutable members.
+        /// </summary>
+        ///
+        /// <returns> `true` if the node is reentrant. </returns>
+        virtual bool IsReentrant() const { return IsPure(); }
+
         /// <summary> Get this object's metadata object. </summary>
         ///
         /// <returns> A reference to the PropertyBag containing the metadata for this object. </returns>
@@ -207,15 +225,18 @@ namespace model
         friend class Model;
         friend class ModelEditor;
         friend class ModelTransformer;
+        friend class NodeIterator;
 
         virtual void Copy(ModelTransformer& transformer) const = 0;
         virtual bool Refine(ModelTransformer& transformer) const;
+        virtual bool Batch(ModelTransformer& transformer, BatchContext& batch) const;
 
         void SetId(Node::NodeId id);
         void SetModel(Model* model);
         void UpdateInputPorts();
 
         std::unique_ptr<Model> _model;
+        size_t _modelIndex = 0; // the node's position in the model's node array
         NodeId _id;
         std::vector<InputPortBase*> _inputs;
         std::vector<OutputPortBase*> _outputs;
@@ -14,7 +14,10 @@ namespace ell
 {
 namespace model
 {
-    /// <summary> A transformation that invokes the registered transformations on a submodel. </summary>
+    /// <summary>
+    /// A transformation that invokes the registered transformations on a submodel. If the "searchTransformations"
+    /// optimizer option is set, each transformation is only kept if it doesn't increase the measured runtime of the model.
+    /// </summary>
     class OptimizeModelTransformation : public Transformation
     {
     public:
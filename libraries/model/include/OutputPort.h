@@ -30,6 +30,13 @@ namespace model
     class OutputPortBase : public Port
     {
     public:
+        /// <summary> The type of the output of a port. </summary>
+        using CachedOutput = std::variant<std::vector<double>,
+                                          std::vector<float>,
+                                          std::vector<int64_t>,
+                                          std::vector<int32_t>,
+                                          std::vector<bool>>;
+
         OutputPortBase() = default;
         OutputPortBase(const OutputPortBase& other) = delete;
         OutputPortBase(OutputPortBase&& other) = default;
@@ -82,7 +89,7 @@ namespace model
         /// <returns> The ports that are referencing this port. </returns>
         const std::vector<const InputPortBase*>& GetReferences() const;
 
-        /// <summary> Returns the cached output from this port </summary>
+        /// <summary> Returns the cached output from this port, or its output in the active execution context, if there is one </summary>
         ///
         /// <returns> The cached output from this port </returns>
         template <typename ValueType>
@@ -140,6 +147,7 @@ namespace model
         static std::string GetTypeName() { return "OutputPortBase"; }
 
     protected:
+        friend class ExecutionContext;
         friend class InputPortBase;
 
         void AddReference(const InputPortBase* reference) const;
@@ -155,13 +163,10 @@ namespace model
 
     private:
         void InitializeCachedOutput();
+        CachedOutput MakeEmptyOutput() const;
+        CachedOutput& GetCachedOutput() const;
 
-        mutable std::variant<std::vector<double>,
-                             std::vector<float>,
-                             std::vector<int64_t>,
-                             std::vector<int32_t>,
-                             std::vector<bool>>
-            _cachedOutput;
+        mutable CachedOutput _cachedOutput;
     };
 
     /// <summary> Represents an output from a node </summary>
@@ -226,7 +231,7 @@ namespace model
     template <typename ValueType>
     const std::vector<ValueType>& OutputPortBase::GetOutput() const
     {
-        return std::get<std::vector<ValueType>>(_cachedOutput);
+        return std::get<std::vector<ValueType>>(GetCachedOutput());
     }
 
     template <typename ValueType>
@@ -252,7 +257,7 @@ namespace model
     {
         using ValueType = typename std::iterator_traits<IteratorType>::value_type;
         using VectorType = std::vector<ValueType>;
-        std::get<VectorType>(_cachedOutput).assign(begin, end);
+        std::get<VectorType>(GetCachedOutput()).assign(begin, end);
     }
 
     //
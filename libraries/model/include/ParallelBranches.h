@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelBranches.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class Node;
+
+    /// <summary>
+    /// An order to compute the nodes of a model in, where the nodes between the sources and the nodes that join their
+    /// results (like the members of an ensemble and the node that averages their outputs) are split into independent
+    /// branches, which can be computed concurrently.
+    /// </summary>
+    struct ParallelBranchOrder
+    {
+        std::vector<const Node*> sources; // the nodes without parents, computed before the branches
+        std::vector<std::vector<const Node*>> branches; // the branches, which don't use each other's nodes
+        std::vector<const Node*> tail; // the nodes that use more than one branch, and the nodes that use them, computed after the branches
+    };
+
+    /// <summary>
+    /// Splits some nodes into independent branches. Each node whose parents, other than the sources, are all in
+    /// the same branch is added to that branch, and a node without any such parents starts a new branch.
+    /// </summary>
+    ///
+    /// <param name="nodes"> The nodes to compute, in an order where each node comes after its parents. </param>
+    ///
+    /// <returns> The sources, branches and tail, each in the order of `nodes`. </returns>
+    ParallelBranchOrder GetParallelBranchOrder(const std::vector<const Node*>& nodes);
+} // namespace model
+} // namespace ell
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PortBufferAllocator.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Port.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class Model;
+    class Node;
+    class OutputPortBase;
+
+    /// <summary>
+    /// Assigns the output ports of a model to a small set of shared buffers, based on the liveness of each port.
+    /// A port is live from the time its node is compiled until the last node reading from it has been compiled.
+    /// Ports that are no longer live release their buffer, which can then be reused by ports compiled later
+    /// that have the same element type and fit in the buffer. The allocator only does the bookkeeping: the
+    /// creation of the variables backing the buffers is left to the map compiler.
+    /// </summary>
+    class PortBufferAllocator
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="model"> The model whose ports are to be allocated. Nodes are assumed to be compiled in `Model::Visit` order. </param>
+        PortBufferAllocator(const Model& model);
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="nodes"> The nodes whose ports are to be allocated, in the order they are compiled in. </param>
+        PortBufferAllocator(const std::vector<const Node*>& nodes);
+
+        /// <summary> Indicates if the given port may be stored in a shared buffer. </summary>
+        ///
+        /// <param name="port"> The port to check. </param>
+        ///
+        /// <returns> `true` if the port belongs to the model and has no padding in its memory layout. </returns>
+        bool CanShareBuffer(const OutputPortBase& port) const;
+
+        /// <summary> Gets a buffer for the given port, reusing a free buffer if there is one large enough. </summary>
+        ///
+        /// <param name="port"> The port to allocate a buffer for. Must satisfy `CanShareBuffer`. </param>
+        ///
+        /// <returns> The index of the buffer assigned to the port. </returns>
+        size_t AllocateBuffer(const OutputPortBase& port);
+
+        /// <summary> Records that another port refers to the given buffer, extending the buffer's lifetime if necessary. </summary>
+        ///
+        /// <param name="bufferIndex"> The index of the buffer. </param>
+        /// <param name="port"> The port aliasing the buffer. </param>
+        void AddPortToBuffer(size_t bufferIndex, const Port& port);
+
+        /// <summary> Releases the buffers whose ports are not read by any node after the given one. </summary>
+        ///
+        /// <param name="node"> The node that was just compiled. </param>
+        void ReleaseBuffers(const Node& node);
+
+        /// <summary> Gets the number of buffers allocated so far. </summary>
+        size_t NumBuffers() const { return _buffers.size(); }
+
+        /// <summary> Gets the number of ports that have been assigned a buffer. </summary>
+        size_t NumAllocatedPorts() const { return _numAllocatedPorts; }
+
+        /// <summary> Gets the size, in elements, of a buffer. </summary>
+        size_t GetBufferSize(size_t bufferIndex) const;
+
+        /// <summary> Gets the element type of a buffer. </summary>
+        Port::PortType GetBufferType(size_t bufferIndex) const;
+
+        /// <summary> Gets the total size, in elements, of all the buffers. </summary>
+        size_t GetTotalBufferSize() const;
+
+        /// <summary> Gets the total size, in bytes, of the buffers currently assigned to live ports. </summary>
+        size_t GetLiveBufferBytes() const;
+
+    private:
+        struct Buffer
+        {
+            Port::PortType type;
+            size_t size;
+            int lastUse;
+            bool isFree;
+        };
+
+        int GetLastUse(const Port& port) const;
+
+        std::unordered_map<const Node*, int> _nodeIndices; // position of each node in visit order
+        std::unordered_map<const Port*, int> _lastUses; // index of the last node reading from each output port
+        std::vector<Buffer> _buffers;
+        size_t _numAllocatedPorts = 0;
+    };
+} // namespace model
+} // namespace ell
@@ -41,5 +41,25 @@ namespace model
     /// <param name="layout"> The layout of the memory </param>
     /// <returns> A value representing `true` if the location is out of bounds </returns>
     emitters::IRLocalScalar EmitIsOutOfBounds(emitters::IRFunctionEmitter& function, const std::vector<emitters::IRLocalScalar>& physicalCoordinates, const PortMemoryLayout& layout);
+
+    /// <summary>
+    /// Gets the channel-blocked version of a (row, column, channel) layout. The channels are split into blocks of
+    /// `channelBlockSize` channels, and each block is stored as a separate (row, column, channel) image, so the channels
+    /// of a block are contiguous and the blocks are far apart ("NCHWc" order). The blocked layout has the 4 logical
+    /// dimensions (row, column, channel block, channel within block), stored in the physical order (channel block, row, column,
+    /// channel within block). The number of channels is rounded up to a multiple of the block size, and the row and column
+    /// padding is kept.
+    /// </summary>
+    ///
+    /// <param name="layout"> The (row, column, channel) layout to block. The channel dimension must not be padded. </param>
+    /// <param name="channelBlockSize"> The number of channels in a block. </param>
+    /// <returns> The channel-blocked layout. </returns>
+    PortMemoryLayout GetChannelBlockedLayout(const PortMemoryLayout& layout, int channelBlockSize);
+
+    /// <summary> Indicates if a layout is a channel-blocked layout, as returned by `GetChannelBlockedLayout`. </summary>
+    ///
+    /// <param name="layout"> The layout. </param>
+    /// <returns> `true` if the layout is channel-blocked. </returns>
+    bool IsChannelBlockedLayout(const PortMemoryLayout& layout);
 } // namespace model
 } // namespace ell
\ No newline at end of file
@@ -29,24 +29,42 @@ namespace model
         ///     The schema of the data in the property bag is:
         ///     ```
         ///     { 'model' : <options>,
-        //        'nodes' : { <node-id> : <options>,
+        ///       'nodes' : { <node-id> : <options>,
         ///                   <node-id> : <options>,
-        ///        ...      }
+        ///        ...      },
+        ///       'rules' : { <rule-name> : { 'nodeType' : <regex>,
+        ///                                   'name' : <regex>,
+        ///                                   'minOutputSize' : <int>,
+        ///                                   'maxOutputSize' : <int>,
+        ///                                   'options' : <options> },
+        ///        ...      },
+        ///       'parallelizeMinOutputSize' : <int>
         ///     }
         ///     ```
         ///     where `<options>` represents a `ModelOptimizerOptions` encoded as a `PropertyBag`.
-        ///     Note that the 'model' entry, the 'nodes' entry, my either (or both) be absent.
+        ///     Note that any of the entries may be absent.
         ///     If the 'nodes' entry is present, it need not contain all (or even any) settings
         ///     for the nodes in the model.
+        ///
+        ///     Each rule in the 'rules' entry applies its options to every node that matches all of the rule's
+        ///     criteria: the node's type name and name (its friendly name if it has one, else its id) must match
+        ///     the 'nodeType' and 'name' regular expressions, and the total size of its outputs must be in the range
+        ///     ['minOutputSize', 'maxOutputSize']. Absent criteria match every node. Rules are applied in order of
+        ///     their names, so later rules override earlier ones.
+        ///
+        ///     If 'parallelizeMinOutputSize' is present, nodes whose total output size is smaller than it have
+        ///     parallelization turned off, since the work in them doesn't pay for launching the tasks.
+        ///
+        ///     The options for a node are set in order: the size threshold, then the rules, then the 'nodes' entry.
         /// </param>
         ///
         /// <returns>
         ///     Returns a transformation that will set the given options on the model it is applied to.
         ///     The result model will have a metadata property called 'optimizerOptions' that contains the 'model' options,
-        ///     and each node named in the 'nodes' section will also have a 'optimizerOptions' metadata property containing
-        ///     the options provided for that node.
+        ///     and each node with any options set will also have a 'optimizerOptions' metadata property containing
+        ///     the options for that node.
         ///
-        ///     If neither the 'model' or 'nodes' sections are present, the transformation just returns the input submodel.
+        ///     If none of the sections are present, the transformation just returns the input submodel.
         /// </returns>
         explicit SetCompilerOptionsTransformation(const utilities::PropertyBag& options);
 
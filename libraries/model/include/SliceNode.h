@@ -123,13 +123,19 @@ namespace model
             throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Input and output port types must match");
         }
 
-        auto input = function.LocalArray(compiler.EnsurePortEmitted(_input));
-        auto output = function.LocalArray(compiler.EnsurePortEmitted(_output));
-
         auto layout = _input.GetReferencedPort().GetMemoryLayout();
         const auto increment = layout.GetCumulativeIncrement(0); // slowest-moving dimension
         const auto inputOffset = static_cast<int>(_largestDimensionStart * increment);
         const auto rangeSize = _largestDimensionCount * increment;
+
+        // The slice is contiguous, so its output can just point into the input
+        if (compiler.TrySetPortVariableToView(_output, _input.GetReferencedPort(), inputOffset))
+        {
+            return;
+        }
+
+        auto input = function.LocalArray(compiler.EnsurePortEmitted(_input));
+        auto output = function.LocalArray(compiler.EnsurePortEmitted(_output));
         function.For(rangeSize, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar i) {
             output[i] = input[inputOffset + i];
         });
@@ -57,6 +57,9 @@ namespace model
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Has the producers of the node's inputs write straight into the right part of its output. </summary>
+        void OnBeginCompileInput(MapCompiler& compiler, const InputPortBase& input) override;
+
     protected:
         void Compute() const override;
         void Compile(IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -67,6 +70,7 @@ namespace model
 
     private:
         void Copy(ModelTransformer& transformer) const override;
+        bool IsScalarSplice() const { return _inputPorts.size() == 1 && _inputPorts[0]->Size() == 1; }
         static PortMemoryLayout ComputeOutputLayout(const std::vector<const OutputPortBase*>& inputPorts);
 
         std::vector<std::unique_ptr<InputPort<ValueType>>> _inputPorts;
@@ -144,23 +148,62 @@ namespace model
         _output.SetOutput(output);
     }
 
+    template <typename ValueType>
+    void SpliceNode<ValueType>::OnBeginCompileInput(MapCompiler& compiler, const InputPortBase& input)
+    {
+        if (IsScalarSplice())
+        {
+            return;
+        }
+
+        int rangeStart = 0;
+        for (const auto& inputPort : _inputPorts)
+        {
+            const auto& referencedPort = inputPort->GetReferencedPort();
+            if (inputPort.get() == &input)
+            {
+                compiler.TrySetPortVariableToView(referencedPort, _output, rangeStart);
+                return;
+            }
+            rangeStart += static_cast<int>(referencedPort.Size());
+        }
+    }
+
     template <typename ValueType>
     void SpliceNode<ValueType>::Compile(IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
+        // The inputs whose producers wrote them straight into the output (see `OnBeginCompileInput`) don't need to be copied
+        std::vector<std::pair<const OutputPortBase*, int>> rangesToCopy;
+        int rangeStart = 0;
+        for (const auto& inputPort : _inputPorts)
+        {
+            const auto& referencedPort = inputPort->GetReferencedPort();
+            if (IsScalarSplice() || !compiler.IsPortVariableView(referencedPort, _output, rangeStart))
+            {
+                rangesToCopy.emplace_back(&referencedPort, rangeStart);
+            }
+            rangeStart += static_cast<int>(referencedPort.Size());
+        }
+
+        if (rangesToCopy.empty())
+        {
+            return;
+        }
+
         llvm::Value* pOutput = compiler.EnsurePortEmitted(_output);
         // check if the pOutput variable is null
-        function.If(ell::emitters::TypedComparison::notEquals, pOutput, function.NullPointer(pOutput->getType()->getPointerElementType()->getPointerTo()), [pOutput, &compiler, this](emitters::IRFunctionEmitter& function) {
-            if (_inputPorts.size() == 1 && _inputPorts[0]->Size() == 1)
+        function.If(ell::emitters::TypedComparison::notEquals, pOutput, function.NullPointer(pOutput->getType()->getPointerElementType()->getPointerTo()), [pOutput, &compiler, &rangesToCopy, this](emitters::IRFunctionEmitter& function) {
+            if (IsScalarSplice())
             {
                 llvm::Value* pVal = compiler.LoadPortElementVariable(_inputPorts[0]->GetInputElement(0));
                 function.Store(pOutput, pVal);
             }
             else
             {
-                int rangeStart = 0;
-                for (const auto& inputPort : _inputPorts)
+                for (const auto& range : rangesToCopy)
                 {
-                    const auto& referencedPort = inputPort->GetReferencedPort();
+                    const auto& referencedPort = *range.first;
+                    auto rangeStart = range.second;
                     auto input = function.LocalArray(compiler.EnsurePortEmitted(referencedPort));
                     auto output = function.LocalArray(pOutput);
                     auto rangeSize = referencedPort.Size();
@@ -168,7 +211,6 @@ namespace model
                     function.For(rangeSize, [=](emitters::IRFunctionEmitter& function, auto i) {
                         output[i + rangeStart] = input[i];
                     });
-                    rangeStart += rangeSize;
                 }
             }
         });
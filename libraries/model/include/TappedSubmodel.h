@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     TappedSubmodel.h (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ComputeSchedule.h"
+#include "InputNode.h"
+#include "Model.h"
+#include "OutputPort.h"
+#include "Submodel.h"
+
+#include <utilities/include/Exception.h>
+
+#include <value/include/ComputeContext.h>
+#include <value/include/EmitterContext.h>
+
+#include <functional>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary>
+    /// Computes a submodel and reports the values of some of its ports, the "taps", after each computation. The taps are
+    /// the submodel's outputs followed by any other ports of the model they depend on, such as the outputs of
+    /// intermediate layers. The part of the model that computes the taps is copied once, when the tapped submodel is
+    /// made, and every computation computes all the taps in a single pass over it, so reading the values of many
+    /// intermediate ports costs one copy of the model and one forward pass per input, not one of each per port.
+    /// </summary>
+    class TappedSubmodel
+    {
+    public:
+        /// <summary> A function that receives the values of a tap. </summary>
+        ///
+        /// <param name="tapIndex"> The index of the tap. </param>
+        /// <param name="values"> The values of the tap's port, converted to double. </param>
+        using TapCallback = std::function<void(size_t tapIndex, const std::vector<double>& values)>;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="submodel"> The submodel to compute. Each port its inputs read becomes an input of the tapped
+        /// submodel, in order of first use. The input nodes of the model that the taps still depend on are inputs after those; source nodes aren't inputs, and get their values from their callbacks. </param>
+        /// <param name="taps"> Ports of the submodel's model to report after the submodel's outputs. </param>
+        TappedSubmodel(const Submodel& submodel, const std::vector<const OutputPortBase*>& taps = {});
+
+        TappedSubmodel(const TappedSubmodel&) = delete;
+        TappedSubmodel& operator=(const TappedSubmodel&) = delete;
+
+        /// <summary> Returns the number of inputs. </summary>
+        size_t NumInputs() const { return _inputs.size(); }
+
+        /// <summary> Returns the size of an input. </summary>
+        ///
+        /// <param name="index"> The index of the input. </param>
+        size_t GetInputSize(size_t index = 0) const;
+
+        /// <summary> Returns the number of taps. </summary>
+        size_t NumTaps() const { return _taps.size(); }
+
+        /// <summary> Returns the size of a tap. </summary>
+        ///
+        /// <param name="index"> The index of the tap. </param>
+        size_t GetTapSize(size_t index) const;
+
+        /// <summary> Returns the copy of a tap's port that is computed. </summary>
+        ///
+        /// <param name="index"> The index of the tap. </param>
+        const OutputPortBase& GetTap(size_t index) const;
+
+        /// <summary> Sets the number of threads that compute the nodes of a stage of the model concurrently. </summary>
+        ///
+        /// <param name="numThreads"> The number of threads, or 0 for one per hardware thread. The default is 1. </param>
+        void SetNumComputeThreads(size_t numThreads) { _numComputeThreads = numThreads; }
+
+        /// <summary> Sets the value of an input, converted to the type of the input. </summary>
+        ///
+        /// <param name="index"> The index of the input. </param>
+        /// <param name="inputValues"> The values, one per element of the input. </param>
+        template <typename ValueType>
+        void SetInputValue(size_t index, const std::vector<ValueType>& inputValues);
+
+        /// <summary> Computes the taps from the current input values, and passes the values of each one to a callback, in order. </summary>
+        ///
+        /// <param name="callback"> The function that receives the values of the taps. </param>
+        void Compute(const TapCallback& callback);
+
+    private:
+        template <typename NodeValueType, typename ValueType>
+        void SetNodeInput(InputNodeBase* node, const std::vector<ValueType>& inputValues);
+
+        Model _model;
+        std::vector<InputNodeBase*> _inputs;
+        std::vector<const OutputPortBase*> _taps;
+        ComputeSchedule _schedule;
+        size_t _numComputeThreads = 1;
+        value::ComputeContext _computeContext{ "tapped_submodel_compute" };
+    };
+} // namespace model
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace model
+{
+    template <typename ValueType>
+    void TappedSubmodel::SetInputValue(size_t index, const std::vector<ValueType>& inputValues)
+    {
+        if (index >= _inputs.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "TappedSubmodel input index out of range");
+        }
+
+        auto node = _inputs[index];
+        switch (node->GetOutputType())
+        {
+        case Port::PortType::boolean:
+            SetNodeInput<bool>(node, inputValues);
+            break;
+        case Port::PortType::integer:
+            SetNodeInput<int>(node, inputValues);
+            break;
+        case Port::PortType::bigInt:
+            SetNodeInput<int64_t>(node, inputValues);
+            break;
+        case Port::PortType::smallReal:
+            SetNodeInput<float>(node, inputValues);
+            break;
+        case Port::PortType::real:
+            SetNodeInput<double>(node, inputValues);
+            break;
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "TappedSubmodel input has an unsupported type");
+        }
+    }
+
+    template <typename NodeValueType, typename ValueType>
+    void TappedSubmodel::SetNodeInput(InputNodeBase* node, const std::vector<ValueType>& inputValues)
+    {
+        std::vector<NodeValueType> values;
+        values.reserve(inputValues.size());
+        for (auto value : inputValues)
+        {
+            values.push_back(static_cast<NodeValueType>(value));
+        }
+        static_cast<InputNode<NodeValueType>*>(node)->SetInput(std::move(values));
+    }
+} // namespace model
+} // namespace ell
+
+#pragma endregion implementation
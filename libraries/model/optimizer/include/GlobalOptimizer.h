@@ -14,10 +14,13 @@
 #include "GlobalOptimizerOptions.h"
 #include "Objective.h"
 
+#include <model/include/ModelTransformer.h>
 #include <model/include/Submodel.h>
+#include <model/include/TransformContext.h>
 #include <model/include/Transformation.h>
 
 #include <memory>
+#include <optional>
 
 namespace ell
 {
@@ -25,7 +28,10 @@ namespace model
 {
     namespace optimizer
     {
-        /// Base class for a global model optimizer
+        /// <summary>
+        /// Base class for a global model optimizer. Subclasses propose transformations, and the optimizer keeps the ones
+        /// whose effect on the objective (as evaluated on the output of the cost model) is acceptable.
+        /// </summary>
         class Optimizer
         {
         public:
@@ -33,10 +39,22 @@ namespace model
             Optimizer(CostModelType costModel, ObjectiveType objective);
             virtual ~Optimizer() = default;
 
+            /// <summary> Optimize a submodel. </summary>
             virtual Submodel Optimize(const Submodel& submodel, const Environment& environment, const OptimizerOptions& options);
 
+            /// <summary> Optimize a submodel, applying the transformations that are kept with the given transformer and context. </summary>
+            ///
+            /// <param name="submodel"> The submodel to optimize. </param>
+            /// <param name="transformer"> The transformer to use when applying the transformations that are kept, so the caller can map the old outputs to the new ones. </param>
+            /// <param name="context"> The context passed to the transformations. </param>
+            /// <param name="environment"> The environment to optimize for. </param>
+            /// <param name="options"> The optimizer options. </param>
+            ///
+            /// <returns> The optimized submodel. </returns>
+            virtual Submodel Optimize(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context, const Environment& environment, const OptimizerOptions& options);
+
         protected:
-            Objective::ObjectiveValue GetObjectiveDelta(const Transformation& transformation, const Submodel& submodel, const Environment& environment);
+            std::optional<Objective::ObjectiveValue> TryEvaluateObjective(const Submodel& submodel, const Environment& environment) const;
             Objective::ObjectiveValue EvaluateObjective(const Cost& cost) const;
             virtual void Reset(){};
             virtual bool IsDone() const = 0;
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MeasuredCostModel.h (model/optimizer)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Cost.h"
+#include "CostModel.h"
+#include "Environment.h"
+#include "Objective.h"
+
+#include <model/include/MapCompilerOptions.h>
+#include <model/include/Submodel.h>
+
+namespace ell
+{
+namespace model
+{
+    namespace optimizer
+    {
+        /// <summary>
+        /// A cost model that compiles the submodel with the JIT and measures how long it takes to run. The cost has a
+        /// single "runtime" component, in milliseconds per evaluation. Only whole models (submodels without inputs)
+        /// can be measured, and only when the environment is the host machine.
+        /// </summary>
+        class MeasuredCostModel : public CostModel
+        {
+        public:
+            /// <summary> Constructor </summary>
+            ///
+            /// <param name="settings"> The settings to compile the submodel with. </param>
+            /// <param name="numIterations"> The number of evaluations to average over. </param>
+            MeasuredCostModel(const MapCompilerOptions& settings, int numIterations = 10);
+
+            /// <summary> Returns `true` if the submodel can be compiled and run in the given environment. </summary>
+            bool HasCost(const Submodel& submodel, const Environment& environment) const override;
+
+            /// <summary> Returns the measured runtime of the submodel. </summary>
+            Cost GetCost(const Submodel& submodel, const Environment& environment) const override;
+
+        private:
+            MapCompilerOptions _settings;
+            int _numIterations;
+        };
+
+        /// <summary> An objective that is the "runtime" component of a cost (lower is better). </summary>
+        class RuntimeObjective : public Objective
+        {
+        public:
+            /// <summary> Returns the runtime for the given cost. </summary>
+            ObjectiveValue Evaluate(const Cost& cost) const override;
+        };
+    } // namespace optimizer
+} // namespace model
+} // namespace ell
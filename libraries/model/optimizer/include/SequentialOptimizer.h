@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SequentialOptimizer.h (model/optimizer)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GlobalOptimizer.h"
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    namespace optimizer
+    {
+        /// <summary>
+        /// Simple greedy optimizer that has a list of transformations and tries them in order, keeping each one that
+        /// doesn't increase the objective (so objectives should be "lower is better", like runtime).
+        /// </summary>
+        class SequentialOptimizer : public Optimizer
+        {
+        public:
+            template <typename CostModelType, typename ObjectiveType>
+            SequentialOptimizer(CostModelType costModel, ObjectiveType objective);
+
+            /// <summary> Adds a transformation to try. The optimizer keeps a copy of the transformation. </summary>
+            template <typename TransformationType, std::enable_if_t<std::is_base_of_v<Transformation, TransformationType> && !std::is_abstract_v<TransformationType>, void*> = nullptr>
+            void AddTransformation(TransformationType transformation);
+
+            /// <summary> Adds a transformation to try. The transformation must outlive the optimizer. </summary>
+            void AddTransformation(const Transformation& transformation);
+
+        protected:
+            void Reset() override;
+            bool IsDone() const override;
+            const Transformation& GetTransformation() override;
+            bool KeepTransformation(const Objective::ObjectiveValue& objectiveDelta) const override;
+
+        private:
+            std::vector<std::unique_ptr<Transformation>> _ownedTransformations;
+            std::vector<const Transformation*> _transformations;
+            std::vector<const Transformation*>::iterator _currentTransformation;
+        };
+    } // namespace optimizer
+} // namespace model
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace model
+{
+    namespace optimizer
+    {
+        template <typename CostModelType, typename ObjectiveType>
+        SequentialOptimizer::SequentialOptimizer(CostModelType costModel, ObjectiveType objective) :
+            Optimizer(std::move(costModel), std::move(objective))
+        {}
+
+        template <typename TransformationType, std::enable_if_t<std::is_base_of_v<Transformation, TransformationType> && !std::is_abstract_v<TransformationType>, void*>>
+        void SequentialOptimizer::AddTransformation(TransformationType transformation)
+        {
+            _ownedTransformations.emplace_back(std::make_unique<TransformationType>(std::move(transformation)));
+            _transformations.push_back(_ownedTransformations.back().get());
+        }
+    } // namespace optimizer
+} // namespace model
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GlobalOptimizer.cpp (model/optimizer)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GlobalOptimizer.h"
+
+#include <utilities/include/Exception.h>
+
+namespace ell
+{
+using namespace emitters;
+
+namespace model
+{
+    namespace optimizer
+    {
+        std::optional<Objective::ObjectiveValue> Optimizer::TryEvaluateObjective(const Submodel& submodel, const Environment& environment) const
+        {
+            if (!_costModel->HasCost(submodel, environment))
+            {
+                return std::nullopt;
+            }
+            return EvaluateObjective(_costModel->GetCost(submodel, environment));
+        }
+
+        Objective::ObjectiveValue Optimizer::EvaluateObjective(const Cost& cost) const
+        {
+            return _objective->Evaluate(cost);
+        }
+
+        Submodel Optimizer::Optimize(const Submodel& submodel, const Environment& environment, const OptimizerOptions& options)
+        {
+            ModelTransformer transformer;
+            TransformContext context;
+            return Optimize(submodel, transformer, context, environment, options);
+        }
+
+        Submodel Optimizer::Optimize(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context, const Environment& environment, const OptimizerOptions& options)
+        {
+            Submodel currentSubmodel(submodel);
+            auto currentObjective = TryEvaluateObjective(currentSubmodel, environment);
+            Reset();
+            while (!IsDone())
+            {
+                const auto& t = GetTransformation();
+
+                // Try the transformation out with a separate transformer, so a rejected transformation doesn't leave
+                // mappings behind in the caller's transformer
+                ModelTransformer trialTransformer;
+                auto trialSubmodel = t.Transform(currentSubmodel, trialTransformer, context);
+                auto trialObjective = TryEvaluateObjective(trialSubmodel, environment);
+
+                // If we can't evaluate the objective, the delta is zero
+                Objective::ObjectiveValue objectiveDelta = {};
+                if (currentObjective && trialObjective)
+                {
+                    objectiveDelta = *trialObjective - *currentObjective;
+                }
+
+                if (KeepTransformation(objectiveDelta))
+                {
+                    currentSubmodel = t.Transform(currentSubmodel, transformer, context);
+                    currentObjective = trialObjective;
+                }
+            }
+            return currentSubmodel;
+        }
+    } // namespace optimizer
+} // namespace model
+} // namespace ell
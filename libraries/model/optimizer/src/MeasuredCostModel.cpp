@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MeasuredCostModel.cpp (model/optimizer)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MeasuredCostModel.h"
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputNode.h>
+#include <model/include/Map.h>
+#include <model/include/ModelOptimizerOptions.h>
+
+#include <data/include/DenseDataVector.h>
+
+#include <utilities/include/Exception.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    namespace optimizer
+    {
+        namespace
+        {
+            bool IsHostEnvironment(const Environment& environment)
+            {
+                if (!environment.HasTargetDevice())
+                {
+                    return true;
+                }
+                const auto& deviceName = environment.GetTargetDevice().deviceName;
+                return deviceName.empty() || deviceName == "host";
+            }
+
+            Map GetMap(const Submodel& submodel)
+            {
+                const auto& model = submodel.GetModel();
+                std::vector<std::pair<std::string, InputNodeBase*>> inputs;
+                for (auto inputNode : model.GetNodesByType<InputNodeBase>())
+                {
+                    // The map makes a deep copy of the model, so it won't modify the input node
+                    inputs.emplace_back("input" + std::to_string(inputs.size()), const_cast<InputNodeBase*>(inputNode));
+                }
+
+                std::vector<std::pair<std::string, PortElementsBase>> outputs;
+                for (auto output : submodel.GetOutputs())
+                {
+                    outputs.emplace_back("output" + std::to_string(outputs.size()), PortElementsBase(*output));
+                }
+                return { model, inputs, outputs };
+            }
+        } // namespace
+
+        //
+        // MeasuredCostModel
+        //
+        MeasuredCostModel::MeasuredCostModel(const MapCompilerOptions& settings, int numIterations) :
+            _settings(settings),
+            _numIterations(numIterations)
+        {
+            if (numIterations <= 0)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "MeasuredCostModel: number of iterations must be positive");
+            }
+        }
+
+        bool MeasuredCostModel::HasCost(const Submodel& submodel, const Environment& environment) const
+        {
+            return submodel.NumInputs() == 0 && submodel.NumOutputs() > 0 && IsHostEnvironment(environment);
+        }
+
+        Cost MeasuredCostModel::GetCost(const Submodel& submodel, const Environment& environment) const
+        {
+            if (!HasCost(submodel, environment))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "MeasuredCostModel: can't measure this submodel in this environment");
+            }
+
+            // Compile the submodel as it is: turn off the model optimizer so the compiler doesn't apply the
+            // transformations we're trying to evaluate (or start another search)
+            auto settings = _settings;
+            settings.profile = false;
+            settings.moduleName = "measure";
+            settings.mapFunctionName = "measure";
+            ModelOptimizerOptions optimizerOptions;
+            optimizerOptions["optimizeModel"] = false;
+            IRMapCompiler compiler(settings, optimizerOptions);
+            auto compiledMap = compiler.Compile(GetMap(submodel));
+
+            for (size_t index = 0; index < compiledMap.NumInputs(); ++index)
+            {
+                auto inputSize = compiledMap.GetInput(index)->GetOutputPort().Size();
+                compiledMap.SetInputValue(static_cast<int>(index), data::DoubleDataVector(std::vector<double>(inputSize)));
+            }
+
+            // Warm up caches before measuring
+            compiledMap.ComputeOutput<data::DoubleDataVector>(0);
+
+            std::vector<double> times;
+            for (int iteration = 0; iteration < _numIterations; ++iteration)
+            {
+                auto start = std::chrono::steady_clock::now();
+                compiledMap.ComputeOutput<data::DoubleDataVector>(0);
+                auto end = std::chrono::steady_clock::now();
+                times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            }
+
+            double mean = 0;
+            for (auto time : times)
+            {
+                mean += time;
+            }
+            mean /= times.size();
+
+            double variance = 0;
+            for (auto time : times)
+            {
+                variance += (time - mean) * (time - mean);
+            }
+            variance /= times.size();
+
+            Cost cost;
+            cost["runtime"] = MeasuredCostValue(mean, variance);
+            return cost;
+        }
+
+        //
+        // RuntimeObjective
+        //
+        Objective::ObjectiveValue RuntimeObjective::Evaluate(const Cost& cost) const
+        {
+            return cost.GetCostComponent("runtime").GetValue();
+        }
+    } // namespace optimizer
+} // namespace model
+} // namespace ell
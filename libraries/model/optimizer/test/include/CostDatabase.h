@@ -8,14 +8,14 @@
 
 #pragma once
 
-#include "Cost.h"
-#include "Environment.h"
-
 #include <model/include/OutputNode.h>
 #include <model/include/Port.h>
 #include <model/include/Submodel.h>
 #include <model/include/Transformation.h>
 
+#include <model/optimizer/include/Cost.h>
+#include <model/optimizer/include/Environment.h>
+
 #include <utilities/include/Exception.h>
 #include <utilities/include/Hash.h>
 #include <utilities/include/MemoryLayout.h>
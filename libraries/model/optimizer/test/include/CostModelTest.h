@@ -15,3 +15,4 @@
 void TestExampleCostModels();
 
 void TestSimpleCostModel();
+void TestMeasuredCostModel();
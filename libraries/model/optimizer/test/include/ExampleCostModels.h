@@ -8,13 +8,14 @@
 
 #pragma once
 
-#include "Cost.h"
 #include "CostDatabase.h"
-#include "CostModel.h"
 
 #include <model/include/Submodel.h>
 #include <model/include/Transformation.h>
 
+#include <model/optimizer/include/Cost.h>
+#include <model/optimizer/include/CostModel.h>
+
 #include <functional>
 #include <unordered_map>
 
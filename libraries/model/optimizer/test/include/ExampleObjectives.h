@@ -8,8 +8,8 @@
 
 #pragma once
 
-#include "Cost.h"
-#include "Objective.h"
+#include <model/optimizer/include/Cost.h>
+#include <model/optimizer/include/Objective.h>
 
 class SimpleObjective : public ell::model::optimizer::Objective
 {
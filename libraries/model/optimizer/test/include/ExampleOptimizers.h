@@ -8,11 +8,11 @@
 
 #pragma once
 
-#include "Cost.h"
-#include "GlobalOptimizer.h"
-
 #include <model/include/Transformation.h>
 
+#include <model/optimizer/include/Cost.h>
+#include <model/optimizer/include/GlobalOptimizer.h>
+
 #include <utilities/include/Exception.h>
 
 //
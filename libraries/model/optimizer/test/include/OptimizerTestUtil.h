@@ -8,12 +8,12 @@
 
 #pragma once
 
-#include "Cost.h"
-#include "Objective.h"
-
 #include <model/include/Submodel.h>
 #include <model/include/Transformation.h>
 
+#include <model/optimizer/include/Cost.h>
+#include <model/optimizer/include/Objective.h>
+
 //
 // Optimizer test utilities
 //
@@ -27,6 +27,7 @@ struct TransformationTestData
 };
 
 ell::model::Submodel GetSimpleSubmodel();
+ell::model::Submodel GetSimpleWholeModelSubmodel();
 ell::model::Submodel GetCombineNodesTestSubmodel();
 TransformationTestData GetCombineNodesTestData();
 
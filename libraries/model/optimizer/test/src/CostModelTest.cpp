@@ -7,14 +7,19 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "CostModelTest.h"
-#include "CostModel.h"
-#include "Environment.h"
 #include "ExampleCostModels.h"
 #include "ExampleTransformations.h"
 #include "OptimizerTestUtil.h"
 
+#include <model/include/MapCompilerOptions.h>
 #include <model/include/Submodel.h>
 
+#include <model/optimizer/include/CostModel.h>
+#include <model/optimizer/include/Environment.h>
+#include <model/optimizer/include/MeasuredCostModel.h>
+
+#include <emitters/include/TargetDevice.h>
+
 #include <testing/include/testing.h>
 
 #include <iostream>
@@ -30,6 +35,7 @@ using namespace ell::testing;
 void TestExampleCostModels()
 {
     TestSimpleCostModel();
+    TestMeasuredCostModel();
 }
 
 void TestSimpleCostModel()
@@ -50,3 +56,18 @@ void TestSimpleCostModel()
     auto cost2 = costModel2.GetCost(m, environment);
     ProcessTest("SimpleCostModel", cost2.GetCostComponent("runtime").GetValue() == 5);
 }
+
+void TestMeasuredCostModel()
+{
+    auto submodel = GetSimpleWholeModelSubmodel();
+    Environment environment({ "host" });
+
+    MeasuredCostModel costModel(MapCompilerOptions{}, 3);
+    ProcessTest("MeasuredCostModel can't measure a submodel with inputs", !costModel.HasCost(GetSimpleSubmodel(), environment));
+    ProcessTest("MeasuredCostModel can't measure on another device", !costModel.HasCost(submodel, Environment(ell::emitters::GetTargetDevice("pi3"))));
+
+    auto cost = costModel.GetCost(submodel, environment);
+    auto runtime = cost.GetCostComponent("runtime");
+    ProcessTest("MeasuredCostModel", costModel.HasCost(submodel, environment) && runtime.IsCostType<MeasuredCostValue>() && runtime.GetValue() >= 0);
+    ProcessTest("RuntimeObjective", RuntimeObjective{}.Evaluate(cost) == runtime.GetValue());
+}
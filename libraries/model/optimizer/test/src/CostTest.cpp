@@ -7,7 +7,8 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "CostTest.h"
-#include "Cost.h"
+
+#include <model/optimizer/include/Cost.h>
 
 #include <testing/include/testing.h>
 
@@ -7,13 +7,14 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "OptimizerTest.h"
-#include "Environment.h"
 #include "ExampleCostModels.h"
 #include "ExampleObjectives.h"
 #include "ExampleOptimizers.h"
 #include "ExampleTransformations.h"
 #include "OptimizerTestUtil.h"
-#include "SequentialOptimizer.h"
+
+#include <model/optimizer/include/Environment.h>
+#include <model/optimizer/include/SequentialOptimizer.h>
 
 #include <testing/include/testing.h>
 
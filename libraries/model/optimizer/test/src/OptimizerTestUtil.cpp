@@ -83,6 +83,16 @@ Submodel GetSimpleSubmodel()
     return Submodel(m, { &GetInputPort(out1) }, { &out2 });
 }
 
+// Returns the same model as `GetSimpleSubmodel`, as a submodel with no inputs
+Submodel GetSimpleWholeModelSubmodel()
+{
+    Model m;
+    const auto& in = AddInput<float>(m, 4);
+    const auto& out1 = AddOutput(m, in);
+    const auto& out2 = AddOutput(m, out1);
+    return Submodel(m, {}, { &out2 });
+}
+
 // Returns a simple submodel to test the CombineNodesTransformation
 // The model is a linear chain with an input node and a series of output nodes, some
 // of which contain metadata with the key 'a'.
@@ -0,0 +1,296 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BatchedMap.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BatchedMap.h"
+#include "InputNode.h"
+#include "OutputNode.h"
+#include "PortElements.h"
+#include "Submodel.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        InputNodeBase* AddStackedInputNode(ModelTransformer& transformer, const InputNodeBase& node, int batchSize)
+        {
+            auto layout = GetStackedLayout(node.GetOutputPort().GetMemoryLayout(), batchSize);
+            switch (node.GetOutputType())
+            {
+            case Port::PortType::boolean:
+                return transformer.AddNode<InputNode<bool>>(layout);
+            case Port::PortType::integer:
+                return transformer.AddNode<InputNode<int>>(layout);
+            case Port::PortType::bigInt:
+                return transformer.AddNode<InputNode<int64_t>>(layout);
+            case Port::PortType::smallReal:
+                return transformer.AddNode<InputNode<float>>(layout);
+            case Port::PortType::real:
+                return transformer.AddNode<InputNode<double>>(layout);
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Batched map input has an unsupported type");
+            }
+        }
+
+        template <typename ValueType>
+        const OutputPortBase& AddStackedOutputNode(ModelTransformer& transformer, const OutputPortBase& stackedInput)
+        {
+            const auto& input = static_cast<const OutputPort<ValueType>&>(stackedInput);
+            return transformer.AddNode<OutputNode<ValueType>>(input, stackedInput.GetMemoryLayout().GetActiveSize())->output;
+        }
+
+        const OutputPortBase& AddStackedOutputNode(ModelTransformer& transformer, const OutputPortBase& stackedInput)
+        {
+            switch (stackedInput.GetType())
+            {
+            case Port::PortType::boolean:
+                return AddStackedOutputNode<bool>(transformer, stackedInput);
+            case Port::PortType::integer:
+                return AddStackedOutputNode<int>(transformer, stackedInput);
+            case Port::PortType::bigInt:
+                return AddStackedOutputNode<int64_t>(transformer, stackedInput);
+            case Port::PortType::smallReal:
+                return AddStackedOutputNode<float>(transformer, stackedInput);
+            case Port::PortType::real:
+                return AddStackedOutputNode<double>(transformer, stackedInput);
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Batched map output has an unsupported type");
+            }
+        }
+
+        const OutputPortBase& GetMapOutputPort(const Map& map)
+        {
+            return *map.GetOutput(0).GetRanges()[0].ReferencedPort();
+        }
+
+        // Copies a node once per sample, each copy reading the ports of its own sample
+        void CopyNodePerSample(const Node& node, ModelTransformer& transformer, BatchContext& batch)
+        {
+            const auto& outputs = node.GetOutputPorts();
+            std::vector<std::vector<const OutputPortBase*>> samplePorts(outputs.size());
+            for (int sample = 0; sample < batch.GetBatchSize(); ++sample)
+            {
+                for (auto input : node.GetInputPorts())
+                {
+                    const auto& port = input->GetReferencedPort();
+                    if (batch.IsBatched(port))
+                    {
+                        transformer.MapNodeOutput(port, batch.GetSamplePort(transformer, port, sample));
+                    }
+                }
+
+                transformer.CopyNode(node);
+                for (size_t index = 0; index < outputs.size(); ++index)
+                {
+                    samplePorts[index].push_back(&transformer.GetCorrespondingOutputs(*outputs[index]));
+                }
+            }
+
+            for (size_t index = 0; index < outputs.size(); ++index)
+            {
+                batch.SetSamplePorts(*outputs[index], samplePorts[index]);
+            }
+        }
+    } // namespace
+
+    //
+    // BatchContext
+    //
+    BatchContext::BatchContext(int batchSize) :
+        _batchSize(batchSize)
+    {
+        if (batchSize < 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Batch size must be at least 1");
+        }
+    }
+
+    bool BatchContext::IsBatched(const OutputPortBase& port) const
+    {
+        return _ports.find(&port) != _ports.end();
+    }
+
+    const OutputPortBase* BatchContext::GetStackedPort(ModelTransformer& transformer, const OutputPortBase& port)
+    {
+        auto it = _ports.find(&port);
+        if (it == _ports.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port isn't batched");
+        }
+
+        auto& batchedPort = it->second;
+        if (batchedPort.stacked == nullptr)
+        {
+            std::vector<PortRange> ranges;
+            for (auto samplePort : batchedPort.samples)
+            {
+                if (samplePort->GetMemoryLayout().HasPadding())
+                {
+                    return nullptr;
+                }
+                ranges.emplace_back(*samplePort);
+            }
+
+            // The producers of the samples write them straight into the joined port when it's compiled
+            batchedPort.stacked = &transformer.SimplifyOutputs(PortElementsBase(ranges));
+        }
+        return batchedPort.stacked;
+    }
+
+    const OutputPortBase& BatchContext::GetSamplePort(ModelTransformer& transformer, const OutputPortBase& port, int sample)
+    {
+        auto it = _ports.find(&port);
+        if (it == _ports.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port isn't batched");
+        }
+
+        auto& batchedPort = it->second;
+        if (batchedPort.samples.empty())
+        {
+            // Slices of the stacked port are compiled as views into it
+            const auto& stacked = *batchedPort.stacked;
+            auto sampleSize = stacked.Size() / _batchSize;
+            for (int index = 0; index < _batchSize; ++index)
+            {
+                batchedPort.samples.push_back(&transformer.SimplifyOutputs(PortElementsBase(stacked, index * sampleSize, sampleSize)));
+            }
+        }
+        return *batchedPort.samples[sample];
+    }
+
+    void BatchContext::SetStackedPort(const OutputPortBase& port, const OutputPortBase& stackedPort)
+    {
+        if (stackedPort.Size() != port.Size() * _batchSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Stacked port must hold the values of every sample of the batch");
+        }
+        _ports[&port] = { &stackedPort, {} };
+    }
+
+    void BatchContext::SetSamplePorts(const OutputPortBase& port, const std::vector<const OutputPortBase*>& samplePorts)
+    {
+        if (static_cast<int>(samplePorts.size()) != _batchSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "There must be one port per sample of the batch");
+        }
+        _ports[&port] = { nullptr, samplePorts };
+    }
+
+    //
+    // Functions
+    //
+    PortMemoryLayout GetStackedLayout(const PortMemoryLayout& layout, int batchSize)
+    {
+        auto size = layout.GetActiveSize();
+        size[0] *= batchSize;
+        return { size, layout.GetLogicalDimensionOrder() };
+    }
+
+    bool CanMakeBatchedMap(const Map& map)
+    {
+        if (map.NumInputs() != 1 || map.NumOutputs() != 1 || !map.GetOutput(0).IsFullPortOutput())
+        {
+            return false;
+        }
+
+        if (map.GetInput(0)->GetOutputPort().GetMemoryLayout().HasPadding() || GetMapOutputPort(map).GetMemoryLayout().HasPadding())
+        {
+            return false;
+        }
+
+        // Nodes with state or side effects must see the samples one at a time, in order
+        const auto& model = map.GetModel();
+        if (model.GetNodesByType<InputNodeBase>().size() != 1)
+        {
+            return false;
+        }
+
+        auto iter = model.GetNodeIterator();
+        while (iter.IsValid())
+        {
+            if (!iter.Get()->IsPure())
+            {
+                return false;
+            }
+            iter.Next();
+        }
+        return true;
+    }
+
+    Map MakeBatchedMap(const Map& map, int batchSize)
+    {
+        if (!CanMakeBatchedMap(map))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Map can't be batched");
+        }
+
+        const auto inputNode = map.GetInput(0);
+        const auto& outputPort = GetMapOutputPort(map);
+
+        BatchContext batch(batchSize);
+        InputNodeBase* stackedInputNode = nullptr;
+        Model batchedModel;
+        TransformContext context;
+        ModelTransformer transformer;
+        Submodel submodel(map.GetModel(), { &outputPort });
+        transformer.TransformSubmodelOnto(submodel, batchedModel, {}, context, [&](const Node& node, ModelTransformer& transformer) {
+            if (&node == inputNode)
+            {
+                stackedInputNode = AddStackedInputNode(transformer, *inputNode, batchSize);
+                batch.SetStackedPort(inputNode->GetOutputPort(), stackedInputNode->GetOutputPort());
+                return;
+            }
+
+            // Nodes that don't depend on the input, such as weights, are the same for every sample
+            const auto& inputs = node.GetInputPorts();
+            if (std::none_of(inputs.begin(), inputs.end(), [&batch](const InputPortBase* input) { return batch.IsBatched(input->GetReferencedPort()); }))
+            {
+                transformer.CopyNode(node);
+                return;
+            }
+
+            if (dynamic_cast<const OutputNodeBase*>(&node) != nullptr)
+            {
+                auto stackedInput = batch.GetStackedPort(transformer, inputs[0]->GetReferencedPort());
+                if (stackedInput == nullptr)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Batched map output must not have padding");
+                }
+                batch.SetStackedPort(*node.GetOutputPort(0), AddStackedOutputNode(transformer, *stackedInput));
+            }
+            else if (!transformer.BatchNode(node, batch))
+            {
+                CopyNodePerSample(node, transformer, batch);
+            }
+
+            // The transformer needs the map's output to correspond to a port of the same size
+            for (auto output : node.GetOutputPorts())
+            {
+                if (output == &outputPort)
+                {
+                    transformer.MapNodeOutput(outputPort, batch.GetSamplePort(transformer, outputPort, 0));
+                }
+            }
+        });
+
+        if (stackedInputNode == nullptr || !batch.IsBatched(outputPort))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Batched map output must depend on its input");
+        }
+
+        auto stackedOutput = batch.GetStackedPort(transformer, outputPort);
+        return Map(std::move(batchedModel), { { map.GetInputName(0), stackedInputNode } }, { { map.GetOutputName(0), PortElementsBase(*stackedOutput) } });
+    }
+} // namespace model
+} // namespace ell
@@ -84,6 +84,16 @@ namespace model
         (void)_fn.Parameters(parameters);
     }
 
+    void CompilableCodeNode::DefineFunctions()
+    {
+        // Nodes of the same type whose compiled state is the same (all stateless nodes, for instance) generate identical
+        // functions, which the context can emit only once
+        (void)_fn.BodyParameters(GetRuntimeTypeName(), GetInternalStateIdentifier());
+        Define(_fn);
+
+        DefineReset(_resetFn);
+    }
+
     std::string CompilableCodeNode::GetCompiledFunctionName() const
     {
         SetFunctionParameters();
@@ -108,9 +118,7 @@ namespace model
     {
         if (!_fn.IsDefined())
         {
-            Define(_fn);
-
-            DefineReset(_resetFn);
+            DefineFunctions();
             if (_resetFn.IsDefined())
             {
                 auto& resetFn = compiler.GetModule().BeginResetFunction(_resetFn.GetFunctionName() + "_stub");
@@ -214,9 +222,7 @@ namespace model
         SetFunctionParameters();
         if (!_fn.IsDefined())
         {
-            const_cast<CompilableCodeNode*>(this)->Define(_fn);
-
-            const_cast<CompilableCodeNode*>(this)->DefineReset(_resetFn);
+            const_cast<CompilableCodeNode*>(this)->DefineFunctions();
         }
 
         const auto& inputs = GetInputPorts();
@@ -12,9 +12,12 @@
 #include "MapCompiler.h"
 
 #include <emitters/include/EmitterException.h>
+#include <emitters/include/IRFunctionCache.h>
+#include <emitters/include/IRMetadata.h>
 #include <emitters/include/LLVMUtilities.h>
 
 #include <utilities/include/Logger.h>
+#include <utilities/include/StringUtil.h>
 #include <utilities/include/UniqueId.h>
 #include <utilities/include/UniqueNameList.h>
 
@@ -40,7 +43,7 @@ namespace model
 
         emitters::IRModuleEmitter& moduleEmitter = irCompiler->GetModule();
         auto& enclosingFunction = moduleEmitter.GetCurrentFunction();
-        if (ShouldCompileInline() || compiler.GetMapCompilerOptions(*this).inlineNodes)
+        if (ShouldCompileInline() || compiler.ShouldInlineNode(*this))
         {
             Log() << "Inlining node " << DiagnosticString(*this) << " into function " << enclosingFunction.GetFunctionName() << EOL;
 
@@ -59,38 +62,72 @@ namespace model
             auto functionName = GetCompiledFunctionName();
             if (!moduleEmitter.HasFunction(functionName))
             {
-                Log() << "Creating new function for " << DiagnosticString(*this) << EOL;
-
-                compiler.PushScope();
-                emitters::NamedVariableTypeList args = GetNodeFunctionParameterList(*irCompiler);
-
-                // TODO: combine precompiled-IR case with use-own-function case
-                if (HasPrecompiledIR())
+                // The code emitted for an identical node by an earlier compile can be linked in instead of being emitted again.
+                // Profiling code uses the profiler's globals, so it's never cached.
+                const auto nodeOptions = compiler.GetMapCompilerOptions(*this);
+                const bool useFunctionCache = nodeOptions.cacheNodeFunctions && !nodeOptions.profile && !nodeOptions.compilerSettings.profile && !HasPrecompiledIR();
+                emitters::IRFunctionCache functionCache(useFunctionCache ? nodeOptions.nodeFunctionCacheDirectory : "");
+                const auto cacheKey = useFunctionCache ? irCompiler->GetNodeFunctionCacheKey(*this, functionName) : "";
+                if (useFunctionCache && functionCache.TryLoad(moduleEmitter, cacheKey))
                 {
-                    Log() << DiagnosticString(*this) << " has precompiled IR" << EOL;
-                    auto functionCode = GetPrecompiledIR();
-                    moduleEmitter.LoadIR(functionCode);
+                    Log() << "Using cached function for " << DiagnosticString(*this) << EOL;
                 }
-                else if (HasOwnFunction())
+                else
                 {
-                    Log() << DiagnosticString(*this) << " has its own function" << EOL;
-                    auto oldOptions = enclosingFunction.GetCompilerOptions();
-                    enclosingFunction.SetCompilerOptions(compiler.GetMapCompilerOptions(*this).compilerSettings);
-                    EmitNodeFunction(*irCompiler);
-                    enclosingFunction.SetCompilerOptions(oldOptions);
+                    Log() << "Creating new function for " << DiagnosticString(*this) << EOL;
+                    if (useFunctionCache)
+                    {
+                        functionCache.BeginEmit(moduleEmitter);
+                    }
+
+                    compiler.PushScope();
+                    emitters::NamedVariableTypeList args = GetNodeFunctionParameterList(*irCompiler);
+
+                    // TODO: combine precompiled-IR case with use-own-function case
+                    if (HasPrecompiledIR())
+                    {
+                        Log() << DiagnosticString(*this) << " has precompiled IR" << EOL;
+                        auto functionCode = GetPrecompiledIR();
+                        moduleEmitter.LoadIR(functionCode);
+                    }
+                    else if (HasOwnFunction())
+                    {
+                        Log() << DiagnosticString(*this) << " has its own function" << EOL;
+                        auto oldOptions = enclosingFunction.GetCompilerOptions();
+                        enclosingFunction.SetCompilerOptions(compiler.GetMapCompilerOptions(*this).compilerSettings);
+                        EmitNodeFunction(*irCompiler);
+                        enclosingFunction.SetCompilerOptions(oldOptions);
+                    }
+                    else
+                    {
+                        auto function = moduleEmitter.BeginFunction(functionName, emitters::VariableType::Void, args);
+                        function.SetCompilerOptions(compiler.GetMapCompilerOptions(*this).compilerSettings);
+                        function.SetAttributeForArguments(emitters::IRFunctionEmitter::Attributes::NoAlias);
+
+                        irCompiler->NewNodeRegion(*this);
+                        Compile(*irCompiler, function);
+                        irCompiler->TryMergeNodeRegion(*this);
+                        moduleEmitter.EndFunction();
+                    }
+                    compiler.PopScope();
+
+                    if (useFunctionCache)
+                    {
+                        functionCache.EndEmit(moduleEmitter, cacheKey);
+                    }
                 }
-                else
+
+                if (compiler.GetMapCompilerOptions().collectOptimizationRemarks && moduleEmitter.HasFunction(functionName))
+                {
+                    moduleEmitter.InsertFunctionMetadata(functionName, emitters::c_nodeFunctionTagName, { GetId().ToString(), GetRuntimeTypeName() });
+                    moduleEmitter.GetFunction(functionName)->addFnAttr(llvm::Attribute::NoInline);
+                }
+
+                const auto& functionVariants = compiler.GetMapCompilerOptions(*this).compilerSettings.functionVariants;
+                if (!functionVariants.empty() && moduleEmitter.HasFunction(functionName))
                 {
-                    auto function = moduleEmitter.BeginFunction(functionName, emitters::VariableType::Void, args);
-                    function.SetCompilerOptions(compiler.GetMapCompilerOptions(*this).compilerSettings);
-                    function.SetAttributeForArguments(emitters::IRFunctionEmitter::Attributes::NoAlias);
-
-                    irCompiler->NewNodeRegion(*this);
-                    Compile(*irCompiler, function);
-                    irCompiler->TryMergeNodeRegion(*this);
-                    moduleEmitter.EndFunction();
+                    moduleEmitter.InsertFunctionMetadata(functionName, emitters::c_functionVariantsTagName, utilities::Split(functionVariants, ','));
                 }
-                compiler.PopScope();
             }
             else
             {
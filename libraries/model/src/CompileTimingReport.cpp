@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompileTimingReport.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CompileTimingReport.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#if defined(WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace ell
+{
+namespace model
+{
+    CompileTimingReport::Phase::Phase(CompileTimingReport& report, const std::string& name) :
+        _report(&report),
+        _index(report._phases.size()),
+        _start(std::chrono::steady_clock::now()),
+        _startPeakMemory(GetPeakResidentSetSize())
+    {
+        CompilePhaseTiming timing;
+        timing.name = name;
+        timing.depth = report._depth++;
+        report._phases.push_back(timing);
+    }
+
+    CompileTimingReport::Phase::Phase(Phase&& other) :
+        _report(other._report),
+        _index(other._index),
+        _start(other._start),
+        _startPeakMemory(other._startPeakMemory)
+    {
+        other._report = nullptr;
+    }
+
+    CompileTimingReport::Phase::~Phase()
+    {
+        End();
+    }
+
+    void CompileTimingReport::Phase::End()
+    {
+        if (_report == nullptr)
+        {
+            return;
+        }
+
+        auto& timing = _report->_phases[_index];
+        timing.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+        timing.peakMemory = GetPeakResidentSetSize();
+        timing.peakMemoryIncrease = timing.peakMemory - std::min(timing.peakMemory, _startPeakMemory);
+        --_report->_depth;
+        _report = nullptr;
+    }
+
+    CompileTimingReport::Phase CompileTimingReport::BeginPhase(const std::string& name)
+    {
+        return _enabled ? Phase(*this, name) : Phase();
+    }
+
+    void CompileTimingReport::Append(const CompileTimingReport& other)
+    {
+        for (auto timing : other._phases)
+        {
+            timing.depth += _depth;
+            _phases.push_back(timing);
+        }
+    }
+
+    void WriteCompileTimingReport(const CompileTimingReport& report, std::ostream& stream)
+    {
+        const int indentSize = 2;
+        size_t nameWidth = 5;
+        for (const auto& phase : report.GetPhases())
+        {
+            nameWidth = std::max(nameWidth, phase.depth * indentSize + phase.name.size());
+        }
+
+        stream << std::left << std::setw(static_cast<int>(nameWidth) + 2) << "phase" << std::right << std::setw(12) << "time (ms)" << std::setw(16) << "peak memory" << std::setw(16) << "peak increase" << "\n";
+        for (const auto& phase : report.GetPhases())
+        {
+            stream << std::string(phase.depth * indentSize, ' ') << std::left << std::setw(static_cast<int>(nameWidth) + 2 - phase.depth * indentSize) << phase.name
+                   << std::right << std::setw(12) << std::fixed << std::setprecision(1) << phase.milliseconds
+                   << std::setw(16) << phase.peakMemory << std::setw(16) << phase.peakMemoryIncrease << "\n";
+        }
+    }
+
+    size_t GetPeakResidentSetSize()
+    {
+#if defined(WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss); // bytes
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+    }
+} // namespace model
+} // namespace ell
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ComputeSchedule.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ComputeSchedule.h"
+#include "ExecutionContext.h"
+#include "GateNodeBase.h"
+#include "Node.h"
+#include "OutputPort.h"
+
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <unordered_map>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        void ComputeNodes(const std::vector<const Node*>& nodes, size_t begin, size_t end)
+        {
+            for (auto index = begin; index < end; ++index)
+            {
+                nodes[index]->Compute();
+            }
+        }
+
+        void ComputeNodesInContext(ExecutionContext* context, const std::vector<const Node*>& nodes, size_t begin, size_t end)
+        {
+            ExecutionContextGuard guard(context);
+            ComputeNodes(nodes, begin, end);
+        }
+    } // namespace
+
+    ComputeSchedule::ComputeSchedule(const Model& model, const PortElementsBase& outputs) :
+        _model(model.ShallowCopy()),
+        _modelSize(model.Size()),
+        _outputs(outputs)
+    {
+        std::vector<const OutputPortBase*> ports;
+        for (const auto& range : outputs.GetRanges())
+        {
+            if (std::find(ports.begin(), ports.end(), range.ReferencedPort()) == ports.end())
+            {
+                ports.push_back(range.ReferencedPort());
+            }
+        }
+
+        // The visit order puts every node after its parents, so a node's stage is one past its latest parent's stage
+        std::unordered_map<const Node*, size_t> nodeStages;
+        model.VisitSubmodel(ports, [this, &nodeStages](const Node& node) {
+            size_t stage = 0;
+            for (auto parent : node.GetParentNodes())
+            {
+                auto parentStage = nodeStages.find(parent);
+                if (parentStage != nodeStages.end())
+                {
+                    stage = std::max(stage, parentStage->second + 1);
+                }
+            }
+
+            nodeStages[&node] = stage;
+            if (stage == _stages.size())
+            {
+                _stages.emplace_back();
+            }
+            _stages[stage].push_back(&node);
+            _nodes.push_back(&node);
+        });
+
+        auto order = GetGatedComputeOrder(_nodes);
+        _nodes = order.nodes;
+        _gatedRanges = order.gatedRanges;
+    }
+
+    void ComputeSchedule::ComputeSerially() const
+    {
+        size_t range = 0;
+        for (size_t index = 0; index < _nodes.size();)
+        {
+            // Skip the ranges of nodes inside a range that was skipped
+            if (range < _gatedRanges.size() && _gatedRanges[range].begin < index)
+            {
+                ++range;
+                continue;
+            }
+
+            if (range < _gatedRanges.size() && _gatedRanges[range].begin == index)
+            {
+                const auto& gatedRange = _gatedRanges[range++];
+                if (!gatedRange.gate->IsConditionTrue())
+                {
+                    index = gatedRange.end;
+                }
+                continue;
+            }
+
+            _nodes[index++]->Compute();
+        }
+    }
+
+    bool ComputeSchedule::IsScheduleFor(const Model& model, const PortElementsBase& outputs) const
+    {
+        // Nodes are only ever added to a model, so a model that kept its size still has the same nodes
+        return _model == model && _modelSize == model.Size() && _outputs == outputs;
+    }
+
+    void ComputeSchedule::Compute(size_t numThreads) const
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        if (numThreads == 1 || !_gatedRanges.empty())
+        {
+            ComputeSerially();
+            return;
+        }
+
+        for (const auto& stage : _stages)
+        {
+            auto numTasks = std::min(numThreads, stage.size());
+            if (numTasks < 2)
+            {
+                ComputeNodes(stage, 0, stage.size());
+                continue;
+            }
+
+            // Compute a slice of the stage on this thread, and the others asynchronously
+            auto sliceSize = (stage.size() + numTasks - 1) / numTasks;
+            std::vector<std::future<void>> tasks;
+            for (auto begin = sliceSize; begin < stage.size(); begin += sliceSize)
+            {
+                auto end = std::min(begin + sliceSize, stage.size());
+                tasks.push_back(utilities::GetHostThreadPool().AddTask(ComputeNodesInContext, ExecutionContext::GetCurrent(), std::cref(stage), begin, end));
+            }
+            ComputeNodes(stage, 0, sliceSize);
+
+            for (auto& task : tasks)
+            {
+                utilities::GetHostThreadPool().GetResult(task);
+            }
+        }
+    }
+} // namespace model
+} // namespace ell
@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ExecutionContext.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ExecutionContext.h"
+#include "ComputeSchedule.h"
+#include "Node.h"
+
+#include <utilities/include/Exception.h>
+
+#include <value/include/ComputeContext.h>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        thread_local ExecutionContext* s_currentContext = nullptr;
+    }
+
+    ExecutionContext::ExecutionContext() :
+        _computeContext(std::make_unique<value::ComputeContext>("map_execution"))
+    {
+    }
+
+    ExecutionContext::~ExecutionContext() = default;
+
+    const ComputeSchedule& ExecutionContext::GetSchedule(const Model& model, const PortElementsBase& outputs)
+    {
+        if (_schedule && _schedule->IsScheduleFor(model, outputs))
+        {
+            return *_schedule;
+        }
+
+        auto schedule = std::make_unique<ComputeSchedule>(model, outputs);
+        for (auto node : schedule->GetNodes())
+        {
+            if (!node->IsReentrant())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, node->GetRuntimeTypeName() + " keeps state of its own, so it can't be computed in an execution context");
+            }
+        }
+
+        // The nodes of a stage may run on several threads, so their outputs are added before any of them runs
+        _outputs.clear();
+        for (auto node : schedule->GetNodes())
+        {
+            for (auto port : node->GetOutputPorts())
+            {
+                GetOutput(*port);
+            }
+        }
+        _schedule = std::move(schedule);
+        return *_schedule;
+    }
+
+    OutputPortBase::CachedOutput& ExecutionContext::GetOutput(const OutputPortBase& port)
+    {
+        auto output = _outputs.find(&port);
+        if (output == _outputs.end())
+        {
+            output = _outputs.emplace(&port, port.MakeEmptyOutput()).first;
+        }
+        return output->second;
+    }
+
+    ExecutionContext* ExecutionContext::GetCurrent()
+    {
+        return s_currentContext;
+    }
+
+    ExecutionContextGuard::ExecutionContextGuard(ExecutionContext* context) :
+        _previousContext(s_currentContext)
+    {
+        s_currentContext = context;
+    }
+
+    ExecutionContextGuard::~ExecutionContextGuard()
+    {
+        s_currentContext = _previousContext;
+    }
+} // namespace model
+} // namespace ell
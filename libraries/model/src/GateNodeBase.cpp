@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GateNodeBase.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GateNodeBase.h"
+#include "Node.h"
+#include "OutputPort.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        using GateList = std::vector<const GateNodeBase*>;
+
+        GateList Intersect(const GateList& a, const GateList& b)
+        {
+            GateList result;
+            std::copy_if(a.begin(), a.end(), std::back_inserter(result), [&b](const GateNodeBase* gate) { return std::find(b.begin(), b.end(), gate) != b.end(); });
+            return result;
+        }
+    } // namespace
+
+    GatedComputeOrder GetGatedComputeOrder(const std::vector<const Node*>& nodes)
+    {
+        // Find the gates controlling each node, from the last node back, so a node's users are done before the node
+        std::unordered_set<const Node*> nodeSet(nodes.begin(), nodes.end());
+        std::unordered_map<const Node*, GateList> nodeGates;
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+        {
+            auto node = *it;
+            if (node->NumInputPorts() == 0)
+            {
+                continue;
+            }
+
+            GateList gates;
+            bool isUsed = false;
+            for (auto output : node->GetOutputPorts())
+            {
+                for (auto input : output->GetReferences())
+                {
+                    auto user = input->GetNode();
+                    GateList userGates;
+                    if (nodeSet.count(user) != 0)
+                    {
+                        auto gatesOfUser = nodeGates.find(user);
+                        if (gatesOfUser != nodeGates.end())
+                        {
+                            userGates = gatesOfUser->second;
+                        }
+                        auto gate = dynamic_cast<const GateNodeBase*>(user);
+                        if (gate != nullptr && input == &gate->GetGatedInput())
+                        {
+                            userGates.push_back(gate);
+                        }
+                    }
+                    gates = isUsed ? Intersect(gates, userGates) : userGates;
+                    isUsed = true;
+                }
+            }
+
+            if (!gates.empty())
+            {
+                nodeGates[node] = gates;
+            }
+        }
+
+        if (nodeGates.empty())
+        {
+            return { nodes, {} };
+        }
+
+        // Hold back each gated node until its innermost gate node is computed
+        std::unordered_map<const GateNodeBase*, std::vector<const Node*>> heldNodes;
+        GatedComputeOrder result;
+        std::function<void(const Node*)> addNode = [&](const Node* node) {
+            auto gate = dynamic_cast<const GateNodeBase*>(node);
+            if (gate != nullptr && heldNodes.count(gate) != 0)
+            {
+                auto gatedNodes = heldNodes[gate];
+                auto rangeIndex = result.gatedRanges.size();
+                result.gatedRanges.push_back({ gate, result.nodes.size(), 0 });
+                for (auto gatedNode : gatedNodes)
+                {
+                    addNode(gatedNode);
+                }
+                result.gatedRanges[rangeIndex].end = result.nodes.size();
+            }
+            result.nodes.push_back(node);
+        };
+
+        for (auto node : nodes)
+        {
+            auto gates = nodeGates.find(node);
+            if (gates == nodeGates.end())
+            {
+                addNode(node);
+                continue;
+            }
+
+            // The innermost gate is the one controlled by the most other gates
+            auto numGates = [&nodeGates](const GateNodeBase* gate) {
+                auto it = nodeGates.find(gate);
+                return it == nodeGates.end() ? size_t{ 0 } : it->second.size();
+            };
+            auto innermostGate = *std::max_element(gates->second.begin(), gates->second.end(), [&numGates](const GateNodeBase* a, const GateNodeBase* b) {
+                return numGates(a) < numGates(b);
+            });
+            heldNodes[innermostGate].push_back(node);
+        }
+        return result;
+    }
+} // namespace model
+} // namespace ell
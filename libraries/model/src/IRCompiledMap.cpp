@@ -14,6 +14,8 @@
 #include "Port.h"
 
 #include <emitters/include/EmitterException.h>
+#include <emitters/include/IRExternalWeights.h>
+#include <emitters/include/IRObjectCache.h>
 #include <emitters/include/IROptimizer.h>
 
 #include <utilities/include/Exception.h>
@@ -21,6 +23,7 @@
 
 #include <llvm/Transforms/Utils/Cloning.h>
 
+#include <algorithm>
 #include <sstream>
 
 namespace ell
@@ -35,16 +38,24 @@ namespace model
         _moduleName(std::move(other._moduleName)),
         _executionEngine(std::move(other._executionEngine)),
         _verifyJittedModule(other._verifyJittedModule),
+        _objectCacheKey(std::move(other._objectCacheKey)),
+        _externalWeights(std::move(other._externalWeights)),
+        _externalWeightsOffset(other._externalWeightsOffset),
+        _externalWeightsSize(other._externalWeightsSize),
+        _memoryReport(std::move(other._memoryReport)),
+        _optimizationRemarks(std::move(other._optimizationRemarks)),
+        _compileTimingReport(std::move(other._compileTimingReport)),
         _computeFunctionDefined(false)
     {
     }
 
     // private constructor:
-    IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule) :
+    IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule, const std::string& objectCacheKey) :
         CompiledMap(std::move(map), functionName, options),
         _module(module),
         _moduleName(_module.GetModuleName()),
         _verifyJittedModule(verifyJittedModule),
+        _objectCacheKey(objectCacheKey),
         _computeFunctionDefined(false)
     {
     }
@@ -65,16 +76,78 @@ namespace model
         if (!_executionEngine)
         {
             auto moduleClone = std::unique_ptr<llvm::Module>(llvm::CloneModule(_module.GetLLVMModule()));
-            _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule);
+            auto jitCompilationMode = _compilerOptions.compilerSettings.jitCompilationMode;
+            _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule, jitCompilationMode);
+            if (!_objectCacheKey.empty())
+            {
+                _executionEngine->SetObjectCache(std::make_unique<emitters::IRObjectCache>(_compilerOptions.objectCacheDirectory, _objectCacheKey));
+            }
+
+            if (HasExternalWeights())
+            {
+                auto setWeights = reinterpret_cast<int32_t (*)(char*)>(_executionEngine->ResolveFunctionAddress(_moduleName + "_SetWeights"));
+                if (setWeights(_externalWeights.data() + _externalWeightsOffset) == 0)
+                {
+                    throw emitters::EmitterException(emitters::EmitterError::badFunctionArguments, "The external weights don't match the compiled model");
+                }
+            }
+
+            if (jitCompilationMode == emitters::JitCompilationMode::background)
+            {
+                _executionEngine->CompileInBackground();
+            }
         }
     }
 
+    void IRCompiledMap::SetExternalWeights(std::vector<char> weights)
+    {
+        _externalWeightsSize = weights.size();
+        if (weights.empty())
+        {
+            _externalWeights.clear();
+            return;
+        }
+
+        // Over-allocate, so the blob can start on the alignment boundary the compiled code requires
+        _externalWeights.assign(weights.size() + emitters::c_externalWeightsAlignment, 0);
+        auto address = reinterpret_cast<uintptr_t>(_externalWeights.data());
+        _externalWeightsOffset = static_cast<size_t>((emitters::c_externalWeightsAlignment - address % emitters::c_externalWeightsAlignment) % emitters::c_externalWeightsAlignment);
+        std::copy(weights.begin(), weights.end(), _externalWeights.begin() + _externalWeightsOffset);
+    }
+
+    void IRCompiledMap::WriteExternalWeights(const std::string& filePath) const
+    {
+        auto stream = utilities::OpenBinaryOfstream(filePath);
+        WriteExternalWeights(stream);
+    }
+
+    void IRCompiledMap::WriteExternalWeights(std::ostream& stream) const
+    {
+        if (!HasExternalWeights())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "The map wasn't compiled with external weights");
+        }
+        stream.write(_externalWeights.data() + _externalWeightsOffset, _externalWeightsSize);
+    }
+
     void IRCompiledMap::FinishJitting()
     {
         EnsureExecutionEngine();
         SetComputeFunction();
     }
 
+    void IRCompiledMap::WaitForComputeAsync()
+    {
+        if (!_compilerOptions.emitAsyncFunctions || NumInputs() != 1 || NumOutputs() != 1)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Map wasn't compiled with async predict functions");
+        }
+
+        auto functionPointer = GetJitter().ResolveFunctionAddress(_functionName + "_wait");
+        auto fn = reinterpret_cast<void (*)()>(functionPointer);
+        fn();
+    }
+
     void IRCompiledMap::SetComputeFunction()
     {
         switch (GetInput(0)->GetOutputPort().GetType())
@@ -298,6 +371,13 @@ namespace model
         fn();
     }
 
+    ProfilingSamplingCounters* IRCompiledMap::GetProfilingSamplingCounters()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<ProfilingSamplingCounters* (*)()>(jitter.GetFunctionAddress(_moduleName + "_GetProfilingSamplingCounters"));
+        return fn();
+    }
+
     void IRCompiledMap::PrintNodeProfilingInfo()
     {
         auto& jitter = GetJitter();
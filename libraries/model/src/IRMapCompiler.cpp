@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "IRMapCompiler.h"
+#include "BatchedMap.h"
 #include "CompilableNode.h"
 #include "CompilableNodeUtilities.h"
 #include "IRModelProfiler.h"
@@ -16,16 +17,31 @@
 #include "RefineTransformation.h"
 
 #include <emitters/include/EmitterException.h>
+#include <emitters/include/IRConstantDeduplication.h>
 #include <emitters/include/IRMetadata.h>
+#include <emitters/include/IRExternalWeights.h>
+#include <emitters/include/IRFunctionVariants.h>
+#include <emitters/include/IRMemoryUsage.h>
+#include <emitters/include/IRObjectCache.h>
+#include <emitters/include/IRReentrancy.h>
+#include <emitters/include/IRStaticMemory.h>
 #include <emitters/include/LLVMUtilities.h>
 #include <emitters/include/Variable.h>
 
+#include <utilities/include/Files.h>
+#include <utilities/include/JsonArchiver.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/StringUtil.h>
 
 #include <value/include/LLVMContext.h>
 
+#include <llvm/Config/llvm-config.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 #include <tuple>
 #include <vector>
 
@@ -35,6 +51,85 @@ namespace model
 {
     using namespace logging;
 
+    namespace
+    {
+        std::string GetHashString(const std::string& description)
+        {
+            std::stringstream key;
+            key << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>{}(description);
+            return key.str();
+        }
+
+        // The optimized code depends on the contents of a profile file rather than its name, which stays the same as profiles are refreshed
+        std::string GetFileContentsHashString(const std::string& filename)
+        {
+            if (filename.empty() || !utilities::IsFileReadable(filename))
+            {
+                return filename;
+            }
+
+            auto stream = utilities::OpenIfstream(filename);
+            std::stringstream contents;
+            contents << stream.rdbuf();
+            return GetHashString(contents.str());
+        }
+
+        // Writes a description of everything in the options that affects the generated code, along with the LLVM version.
+        // Options added to `MapCompilerOptions` or `CompilerOptions` that affect code generation must be added here.
+        void WriteOptionsDescription(std::ostream& description, const MapCompilerOptions& options, const ModelOptimizerOptions& optimizerOptions, const emitters::TargetDevice& target)
+        {
+            description << "llvm:" << LLVM_VERSION_STRING << ";";
+            description << "moduleName:" << options.moduleName << ";mapFunctionName:" << options.mapFunctionName
+                        << ";sourceFunctionName:" << options.sourceFunctionName << ";sinkFunctionName:" << options.sinkFunctionName
+                        << ";profile:" << options.profile << ";profileSamplingInterval:" << options.profileSamplingInterval << ";profileSamplingPeriod:" << options.profileSamplingPeriod << ";reuseIntermediateBuffers:" << options.reuseIntermediateBuffers << ";aliasPortBuffers:" << options.aliasPortBuffers
+                        << ";maxStackPortBufferSize:" << options.maxStackPortBufferSize << ";parallelizeBranches:" << options.parallelizeBranches
+                        << ";emitBatchFunction:" << options.emitBatchFunction << ";batchFunctionSize:" << options.batchFunctionSize << ";emitAsyncFunctions:" << options.emitAsyncFunctions << ";inlineNodes:" << options.inlineNodes
+                        << ";inlineElementwiseNodes:" << options.inlineElementwiseNodes << ";inlineNodeSizeLimit:" << options.inlineNodeSizeLimit << ";noHeap:" << options.noHeap
+                        << ";collectOptimizationRemarks:" << options.collectOptimizationRemarks << ";";
+
+            const auto& settings = options.compilerSettings;
+            description << "optimize:" << settings.optimize << ";blasType:" << emitters::ToString(settings.blasType)
+                        << ";positionIndependentCode:" << (settings.positionIndependentCode.HasValue() ? static_cast<int>(settings.positionIndependentCode.GetValue()) : -1)
+                        << ";profile:" << settings.profile << ";profileHardwareCounters:" << settings.profileHardwareCounters << ";parallelize:" << settings.parallelize << ";useThreadPool:" << settings.useThreadPool
+                        << ";useWorkStealing:" << settings.useWorkStealing << ";externalThreadPool:" << settings.externalThreadPool << ";taskPriority:" << settings.taskPriority << ";maxThreads:" << settings.maxThreads << ";threadPoolSpinCount:" << settings.threadPoolSpinCount
+                        << ";threadAffinity:" << emitters::ToString(settings.threadAffinity) << ";affinityCores:" << settings.affinityCores << ";affinitySockets:" << settings.affinitySockets << ";useFastMath:" << settings.useFastMath << ";useApproximateMath:" << settings.useApproximateMath
+                        << ";includeDiagnosticInfo:" << settings.includeDiagnosticInfo << ";codeGenPartitions:" << settings.codeGenPartitions << ";jitCompilationMode:" << emitters::ToString(settings.jitCompilationMode)
+                        << ";useBlas:" << settings.useBlas << ";smallMatrixThreshold:" << settings.smallMatrixThreshold << ";unrollLoops:" << settings.unrollLoops
+                        << ";inlineOperators:" << settings.inlineOperators << ";allowVectorInstructions:" << settings.allowVectorInstructions
+                        << ";parallelLoopSchedule:" << emitters::ToString(settings.parallelLoopSchedule) << ";parallelLoopChunkSize:" << settings.parallelLoopChunkSize
+                        << ";prefetchDistance:" << settings.prefetchDistance << ";nonTemporalStoreThreshold:" << settings.nonTemporalStoreThreshold
+                        << ";vectorWidth:" << settings.vectorWidth << ";functionVariants:" << settings.functionVariants << ";debug:" << settings.debug << ";reentrant:" << settings.reentrant << ";externalWeights:" << settings.externalWeights << ";staticMemory:" << settings.staticMemory << ";deduplicateConstants:" << settings.deduplicateConstants << ";shareConstantsAcrossModules:" << settings.shareConstantsAcrossModules
+                        << ";weightsSection:" << settings.weightsSection << ";weightsAlignment:" << settings.weightsAlignment << ";weightsPlacementThreshold:" << settings.weightsPlacementThreshold << ";hugePageWeights:" << settings.hugePageWeights << ";";
+            description << "pgoInstrumentFile:" << settings.pgoInstrumentFile << ";pgoProfile:" << GetFileContentsHashString(settings.pgoProfileFile) << ";";
+
+            description << "deviceName:" << target.deviceName << ";triple:" << target.triple << ";architecture:" << target.architecture
+                        << ";dataLayout:" << target.dataLayout << ";cpu:" << target.cpu << ";features:" << target.features << ";numBits:" << target.numBits
+                        << ";l1CacheSize:" << target.l1CacheSize << ";l2CacheSize:" << target.l2CacheSize << ";cacheLineSize:" << target.cacheLineSize << ";";
+
+            auto keys = optimizerOptions.AsPropertyBag().Keys();
+            std::sort(keys.begin(), keys.end());
+            for (const auto& key : keys)
+            {
+                description << key << ":" << optimizerOptions.GetEntry(key).ToString() << ";";
+            }
+        }
+
+
+        // Returns a key that changes whenever anything that affects the generated code changes: the map (including any
+        // per-node options in its metadata), the compiler and optimizer options, the target device, and the LLVM version.
+        std::string GetObjectCacheKey(const Map& map, const MapCompilerOptions& options, const ModelOptimizerOptions& optimizerOptions, const emitters::TargetDevice& target)
+        {
+            std::stringstream description;
+            {
+                utilities::JsonArchiver archiver(description);
+                archiver.Archive(map);
+            }
+
+            WriteOptionsDescription(description, options, optimizerOptions, target);
+            return GetHashString(description.str());
+        }
+    } // namespace
+
     IRMapCompiler::IRMapCompiler() :
         IRMapCompiler(MapCompilerOptions{}, ModelOptimizerOptions{})
     {
@@ -60,6 +155,28 @@ namespace model
         return GetNamespacePrefix() + "_" + baseName + "_" + node.GetId().ToString();
     }
 
+    std::string IRMapCompiler::GetNodeFunctionCacheKey(const Node& node, const std::string& functionName) const
+    {
+        std::stringstream description;
+        description << "function:" << functionName << ";";
+        {
+            // The node's archive holds its parameters, like its weights, but not the layouts of the ports it reads from
+            utilities::JsonArchiver archiver(description);
+            archiver.Archive(node);
+            for (auto input : node.GetInputPorts())
+            {
+                archiver.Archive("inputLayout", input->GetReferencedPort().GetMemoryLayout());
+            }
+            for (auto output : node.GetOutputPorts())
+            {
+                archiver.Archive("outputLayout", output->GetMemoryLayout());
+            }
+        }
+
+        WriteOptionsDescription(description, GetMapCompilerOptions(node), GetModelOptimizerOptions(node), GetModule().GetCompilerOptions().targetDevice);
+        return GetHashString(description.str());
+    }
+
     std::string IRMapCompiler::GetPredictFunctionName() const
     {
         return GetMapCompilerOptions().mapFunctionName;
@@ -69,7 +186,38 @@ namespace model
     {
         Log() << "Compile called for map" << EOL;
 
+        // The thread pool's tasks and synchronization objects are allocated by the threading library
+        if (GetMapCompilerOptions().noHeap && GetMapCompilerOptions().compilerSettings.parallelize)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, "Code that runs in parallel can't be compiled without heap allocation");
+        }
+
+        // Parallel tasks and function variants are started through function pointers, which can't be given the state of a reentrant module
+        if (GetMapCompilerOptions().compilerSettings.reentrant && GetMapCompilerOptions().compilerSettings.parallelize)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, "Reentrant code can't be compiled with parallelize, because parallel tasks are started through function pointers that can't take the model's state");
+        }
+        if (GetMapCompilerOptions().compilerSettings.reentrant && !GetMapCompilerOptions().compilerSettings.functionVariants.empty())
+        {
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, "Reentrant code can't be compiled with function variants, because the variants are called through function pointers that can't take the model's state");
+        }
+
+        // Look for object code generated for this map by an earlier run
+        std::string objectCacheKey;
+        bool hasCachedObject = false;
+        const auto& objectCacheDirectory = GetMapCompilerOptions().objectCacheDirectory;
+        if (!objectCacheDirectory.empty())
+        {
+            objectCacheKey = GetObjectCacheKey(map, GetMapCompilerOptions(), GetModelOptimizerOptions(), GetModule().GetCompilerOptions().targetDevice);
+            emitters::IRObjectCache cache(objectCacheDirectory, objectCacheKey);
+            hasCachedObject = cache.HasObject(GetModule().GetLLVMModule()->getModuleIdentifier());
+            Log() << "Object cache key " << objectCacheKey << (hasCachedObject ? " found" : " not found") << " in " << objectCacheDirectory << EOL;
+        }
+
+        auto& timings = GetCompileTimingReport();
+        auto modelPhase = timings.BeginPhase("Refine and optimize model");
         RefineAndOptimize(map);
+        modelPhase.End();
 
         // Renaming callbacks based on map compiler parameters
         // Note: a more elegant solution is emit variables which get assigned to
@@ -83,10 +231,11 @@ namespace model
             Log() << "Enabling profiling in emitted IR" << EOL;
             GetModule().AddPreprocessorDefinition(GetNamespacePrefix() + "_PROFILING", "1");
         }
-        _profiler = { GetModule(), map.GetModel(), GetMapCompilerOptions().profile };
+        _profiler = { GetModule(), map.GetModel(), GetMapCompilerOptions().profile, GetMapCompilerOptions().profileSamplingInterval, GetMapCompilerOptions().profileSamplingPeriod };
         _profiler.EmitInitialization();
 
         {
+            auto phase = timings.BeginPhase("Emit node code");
             value::ContextGuard<value::LLVMContext> guard(_moduleEmitter);
 
             // Now we have the refined map, compile it
@@ -94,11 +243,66 @@ namespace model
             CompileMap(map, GetPredictFunctionName());
         }
 
+        auto apiPhase = timings.BeginPhase("Emit model API functions");
+        if (GetMapCompilerOptions().emitBatchFunction)
+        {
+            EmitBatchPredictFunction(map);
+        }
+
+        if (GetMapCompilerOptions().emitAsyncFunctions)
+        {
+            EmitAsyncPredictFunctions(map);
+        }
+
         // Emit runtime model APIs
         EmitModelAPIFunctions(map);
+        apiPhase.End();
 
-        if (GetMapCompilerOptions().compilerSettings.optimize)
+        auto modulePhase = timings.BeginPhase("Transform module");
+        if (GetMapCompilerOptions().compilerSettings.deduplicateConstants)
         {
+            emitters::DeduplicateConstants(_moduleEmitter, GetMapCompilerOptions().compilerSettings.shareConstantsAcrossModules);
+        }
+
+        const auto& compilerSettings = GetMapCompilerOptions().compilerSettings;
+        std::vector<char> externalWeights;
+        if (compilerSettings.externalWeights)
+        {
+            externalWeights = emitters::EmitExternalWeights(_moduleEmitter, compilerSettings.hugePageWeights);
+        }
+        else if (!compilerSettings.weightsSection.empty() || compilerSettings.weightsAlignment > 0)
+        {
+            emitters::PlaceWeights(_moduleEmitter, compilerSettings.weightsSection, compilerSettings.weightsAlignment, compilerSettings.weightsPlacementThreshold);
+        }
+
+        // Move the scratch arrays off the stack first, so they become part of the state of a reentrant module
+        if (GetMapCompilerOptions().compilerSettings.staticMemory)
+        {
+            emitters::MoveStackArraysToGlobals(_moduleEmitter);
+        }
+
+        if (GetMapCompilerOptions().noHeap)
+        {
+            emitters::VerifyNoHeapAllocation(_moduleEmitter);
+        }
+
+        // Move the mutable globals into caller-allocated state once all the functions that use them have been emitted
+        if (GetMapCompilerOptions().compilerSettings.reentrant)
+        {
+            emitters::EmitReentrantFunctions(_moduleEmitter);
+        }
+
+        // Emit the CPU-specific variants of the node functions before optimizing, so each variant is optimized for its features
+        emitters::EmitFunctionVariants(_moduleEmitter);
+        modulePhase.End();
+
+        MapOptimizationRemarks optimizationRemarks;
+
+        // The cached object was generated from the optimized IR, so there's no need to optimize it again
+        if (GetMapCompilerOptions().compilerSettings.optimize && !hasCachedObject)
+        {
+            auto phase = timings.BeginPhase("Optimize IR");
+
             // Save callback declarations in case they get optimized away
             std::vector<std::tuple<std::string, llvm::FunctionType*, std::vector<std::string>>> savedCallbacks;
             auto callbacks = emitters::GetFunctionsWithTag(_moduleEmitter, emitters::c_callbackFunctionTagName);
@@ -107,10 +311,29 @@ namespace model
                 savedCallbacks.emplace_back(callbackInfo.function->getName(), callbackInfo.function->getFunctionType(), callbackInfo.values);
             }
 
+            // The node functions are found before optimizing, since the ones that are only called once may be removed
+            std::vector<FunctionOptimizationRemarks> nodeFunctions;
+            auto& diagnosticHandler = _moduleEmitter.GetDiagnosticHandler();
+            if (GetMapCompilerOptions().collectOptimizationRemarks)
+            {
+                for (const auto& nodeFunction : emitters::GetFunctionsWithTag(_moduleEmitter, emitters::c_nodeFunctionTagName))
+                {
+                    nodeFunctions.push_back({ nodeFunction.function->getName().str(), nodeFunction.values[0], nodeFunction.values[1], {} });
+                }
+                diagnosticHandler.ClearOptimizationRemarks();
+                diagnosticHandler.SetCollectOptimizationRemarks(true);
+            }
+
             emitters::IROptimizer optimizer(_moduleEmitter);
             optimizer.AddStandardPasses();
             _moduleEmitter.Optimize(optimizer);
 
+            if (GetMapCompilerOptions().collectOptimizationRemarks)
+            {
+                diagnosticHandler.SetCollectOptimizationRemarks(false);
+                optimizationRemarks = GroupOptimizationRemarks(diagnosticHandler.GetOptimizationRemarks(), nodeFunctions);
+            }
+
             // Reinsert callback declarations after optimization
             for (const auto& savedCallback : savedCallbacks)
             {
@@ -120,22 +343,246 @@ namespace model
             }
         }
 
-        return IRCompiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), _moduleEmitter, GetMapCompilerOptions().verifyJittedModule);
+        auto memoryReportPhase = timings.BeginPhase("Compute memory report");
+        auto memoryReport = GetMemoryReport();
+        memoryReportPhase.End();
+
+        IRCompiledMap compiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), _moduleEmitter, GetMapCompilerOptions().verifyJittedModule, objectCacheKey);
+        compiledMap.SetExternalWeights(std::move(externalWeights));
+        compiledMap.SetMemoryReport(std::move(memoryReport));
+        compiledMap.SetOptimizationRemarks(std::move(optimizationRemarks));
+        compiledMap.SetCompileTimingReport(timings);
+        return compiledMap;
+    }
+
+    MapMemoryReport IRMapCompiler::GetMemoryReport()
+    {
+        auto usage = emitters::GetModuleMemoryUsage(_moduleEmitter);
+
+        MapMemoryReport report;
+        report.staticMemorySize = usage.staticDataSize;
+        report.constantMemorySize = usage.constantDataSize;
+        report.heapFunctions = usage.heapFunctions;
+        report.nodes = GetNodeMemoryUsage();
+        if (auto predictFunction = usage.GetFunction(GetPredictFunctionName()))
+        {
+            report.stackSize = predictFunction->stackSize;
+            report.isStackSizeBounded = predictFunction->isStackSizeBounded;
+        }
+
+        Log() << "Memory use: " << report.staticMemorySize << " bytes of static memory, " << report.constantMemorySize << " bytes of constants, "
+              << report.stackSize << " bytes of stack" << (report.isStackSizeBounded ? "" : " or more") << EOL;
+        return report;
     }
 
     void IRMapCompiler::RefineAndOptimize(Map& map)
     {
+        auto& timings = GetCompileTimingReport();
         TransformContext context(this);
+        auto optimizePhase = timings.BeginPhase("Optimize model");
         OptimizeModelTransformation optimizer;
         map.Transform(optimizer, context);
+        optimizePhase.End();
 
         // Add an extra refine here, in case the optimizer doesn't do it
+        auto refinePhase = timings.BeginPhase("Refine model");
         RefineTransformation refiner;
         map.Transform(refiner, context);
+        refinePhase.End();
 
+        auto prunePhase = timings.BeginPhase("Prune model");
         map.Prune();
     }
 
+    void IRMapCompiler::EmitBatchPredictFunction(const Map& map)
+    {
+        if (map.NumInputs() != 1 || map.NumOutputs() != 1)
+        {
+            Log() << "Not emitting batch predict function, because the map doesn't have exactly one input and one output" << EOL;
+            return;
+        }
+
+        auto predictFunction = _moduleEmitter.GetFunction(GetPredictFunctionName());
+        if (predictFunction == nullptr)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::functionNotFound, "Couldn't find predict function " + GetPredictFunctionName());
+        }
+
+        // The batch function takes the same arguments as the predict function, plus the number of samples, and
+        // reads and writes the samples as contiguous arrays
+        auto predictType = predictFunction->getFunctionType();
+        auto int32Type = llvm::Type::getInt32Ty(_moduleEmitter.GetLLVMContext());
+        const emitters::NamedLLVMTypeList parameters = { { "context", predictType->getParamType(0) },
+                                                         { "count", int32Type },
+                                                         { "inputs", predictType->getParamType(1) },
+                                                         { "outputs", predictType->getParamType(2) } };
+
+        // Whole batches go through a batched copy of the map, whose layers each do one matrix product for all the
+        // samples, and the samples left over go through the predict function one at a time
+        const auto batchSize = GetMapCompilerOptions().batchFunctionSize;
+        emitters::LLVMFunction batchedFunction = nullptr;
+        if (batchSize > 1 && !GetMapCompilerOptions().profile && CanMakeBatchedMap(map))
+        {
+            batchedFunction = EmitBatchedMapFunction(map, batchSize);
+        }
+
+        Log() << "Emitting batch predict function " << GetBatchPredictFunctionName() << EOL;
+        auto function = _moduleEmitter.BeginFunction(GetBatchPredictFunctionName(), llvm::Type::getVoidTy(_moduleEmitter.GetLLVMContext()), parameters);
+        function.IncludeInHeader();
+
+        auto context = function.GetFunctionArgument("context");
+        auto count = function.LocalScalar(function.GetFunctionArgument("count"));
+        auto inputs = function.GetFunctionArgument("inputs");
+        auto outputs = function.GetFunctionArgument("outputs");
+        const auto inputSize = static_cast<int>(map.GetInputSize(0));
+        const auto outputSize = static_cast<int>(map.GetOutputSize(0));
+        emitters::LLVMValue batchedCount = function.Literal<int>(0);
+        if (batchedFunction != nullptr)
+        {
+            auto numBatches = count / batchSize;
+            function.For(numBatches, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
+                auto input = fn.PointerOffset(inputs, i * (batchSize * inputSize));
+                auto output = fn.PointerOffset(outputs, i * (batchSize * outputSize));
+                fn.Call(batchedFunction, { context, input, output });
+            });
+            batchedCount = numBatches * batchSize;
+        }
+
+        function.For(batchedCount, count, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
+            auto input = fn.PointerOffset(inputs, i * inputSize);
+            auto output = fn.PointerOffset(outputs, i * outputSize);
+            fn.Call(predictFunction, { context, input, output });
+        });
+        _moduleEmitter.EndFunction();
+    }
+
+    emitters::LLVMFunction IRMapCompiler::EmitBatchedMapFunction(const Map& map, int batchSize)
+    {
+        Log() << "Batching the map to compute " << batchSize << " samples at once" << EOL;
+        auto batchedMap = MakeBatchedMap(map, batchSize);
+
+        // The batched function is only called by the batch predict function, which has set up the context
+        const auto functionName = GetBatchPredictFunctionName() + "_" + std::to_string(batchSize);
+        auto arguments = AllocateMapFunctionArguments(batchedMap, _moduleEmitter);
+        auto& function = _moduleEmitter.BeginFunction(functionName, emitters::VariableType::Void, arguments);
+        function.SetAttributeForArguments(emitters::IRFunctionEmitter::Attributes::NoAlias);
+        function.AddRegion(function.GetCurrentBlock());
+        CompileAdditionalMapNodes(batchedMap);
+        _moduleEmitter.EndFunction();
+        return function.GetFunction();
+    }
+
+    std::string IRMapCompiler::GetBatchPredictFunctionName() const
+    {
+        return GetPredictFunctionName() + "_batch";
+    }
+
+    void IRMapCompiler::EmitAsyncPredictFunctions(const Map& map)
+    {
+        if (map.NumInputs() != 1 || map.NumOutputs() != 1)
+        {
+            Log() << "Not emitting async predict functions, because the map doesn't have exactly one input and one output" << EOL;
+            return;
+        }
+
+        auto predictFunction = _moduleEmitter.GetFunction(GetPredictFunctionName());
+        if (predictFunction == nullptr)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::functionNotFound, "Couldn't find predict function " + GetPredictFunctionName());
+        }
+
+        auto predictType = predictFunction->getFunctionType();
+        auto voidType = llvm::Type::getVoidTy(_moduleEmitter.GetLLVMContext());
+        auto contextType = predictType->getParamType(0);
+        auto inputPointerType = predictType->getParamType(1);
+        auto outputPointerType = predictType->getParamType(2);
+        const auto inputSize = static_cast<int>(map.GetInputSize(0));
+        const auto outputSize = static_cast<int>(map.GetOutputSize(0));
+        const auto& dataLayout = _moduleEmitter.GetTargetDataLayout();
+        const auto inputBytes = inputSize * static_cast<int>(dataLayout.getTypeAllocSize(inputPointerType->getPointerElementType()));
+        const auto outputBytes = outputSize * static_cast<int>(dataLayout.getTypeAllocSize(outputPointerType->getPointerElementType()));
+        auto copyBytes = [](emitters::IRFunctionEmitter& fn, emitters::LLVMValue source, emitters::LLVMValue destination, int count) {
+            fn.GetEmitter().MemoryCopy(source, destination, fn.Literal<int>(count));
+        };
+        const auto asyncName = GetAsyncPredictFunctionName();
+        const auto waitName = GetWaitPredictFunctionName();
+        Log() << "Emitting async predict functions " << asyncName << " and " << waitName << EOL;
+
+        // Two slots for the input and the output, so that the input of the next frame and the output of the previous
+        // one are copied while a frame is being computed
+        auto inputType = PortTypeToVariableType(map.GetInputType(0));
+        auto outputType = PortTypeToVariableType(map.GetOutputType(0));
+        auto inputSlot0 = _moduleEmitter.GlobalArray(inputType, asyncName + "_input0", inputSize);
+        auto inputSlot1 = _moduleEmitter.GlobalArray(inputType, asyncName + "_input1", inputSize);
+        auto outputSlot0 = _moduleEmitter.GlobalArray(outputType, asyncName + "_output0", outputSize);
+        auto outputSlot1 = _moduleEmitter.GlobalArray(outputType, asyncName + "_output1", outputSize);
+        auto frameIndex = _moduleEmitter.Global(emitters::VariableType::Int32, asyncName + "_frameIndex");
+        auto isFramePending = _moduleEmitter.Global(emitters::VariableType::Int32, asyncName + "_isFramePending");
+        auto pendingOutput = _moduleEmitter.Global(outputPointerType, asyncName + "_pendingOutput");
+
+        // The task is started and waited for by internal functions, since it has to exist before code that waits for it can be emitted
+        auto startFunction = _moduleEmitter.BeginFunction(asyncName + "_start", voidType, emitters::NamedLLVMTypeList{ { "context", contextType }, { "input", inputPointerType }, { "output", outputPointerType } });
+        auto task = startFunction.StartAsyncTask(predictFunction, { startFunction.GetFunctionArgument("context"), startFunction.GetFunctionArgument("input"), startFunction.GetFunctionArgument("output") }, asyncName + "_task");
+        _moduleEmitter.EndFunction();
+
+        auto finishFunction = _moduleEmitter.BeginFunction(asyncName + "_finish", voidType, emitters::NamedLLVMTypeList{});
+        {
+            // Wait for the pending frame, and copy its output from the slot it was computed in
+            finishFunction.If(emitters::TypedComparison::notEquals, finishFunction.Load(isFramePending), finishFunction.Literal<int>(0), [&](emitters::IRFunctionEmitter& fn) {
+                task.Wait(fn);
+                auto isOddFrame = (fn.LocalScalar(fn.Load(frameIndex)) % 2) == 1;
+                auto outputSlot = fn.Select(isOddFrame, fn.PointerOffset(outputSlot1, 0), fn.PointerOffset(outputSlot0, 0));
+                copyBytes(fn, outputSlot, fn.Load(pendingOutput), outputBytes);
+                fn.Store(isFramePending, fn.Literal<int>(0));
+            });
+        }
+        _moduleEmitter.EndFunction();
+
+        const emitters::NamedLLVMTypeList parameters = { { "context", contextType }, { "input", inputPointerType }, { "output", outputPointerType } };
+        auto function = _moduleEmitter.BeginFunction(asyncName, voidType, parameters);
+        function.IncludeInHeader();
+        {
+            auto nextFrameIndex = function.LocalScalar(function.Load(frameIndex)) + 1;
+            auto isOddFrame = (nextFrameIndex % 2) == 1;
+            auto inputSlot = function.Select(isOddFrame, function.PointerOffset(inputSlot1, 0), function.PointerOffset(inputSlot0, 0));
+            auto outputSlot = function.Select(isOddFrame, function.PointerOffset(outputSlot1, 0), function.PointerOffset(outputSlot0, 0));
+
+            // Copy the input before waiting, so the caller can reuse its buffer for the frame after this one
+            copyBytes(function, function.GetFunctionArgument("input"), inputSlot, inputBytes);
+
+            // Wait for the previous frame and start this one, then drain the previous frame's output while this one is computed
+            auto previousOutputSlot = function.Select(isOddFrame, function.PointerOffset(outputSlot0, 0), function.PointerOffset(outputSlot1, 0));
+            auto previousOutput = function.Load(pendingOutput);
+            auto wasFramePending = function.Load(isFramePending);
+            function.If(emitters::TypedComparison::notEquals, wasFramePending, function.Literal<int>(0), [&](emitters::IRFunctionEmitter& fn) {
+                task.Wait(fn);
+            });
+            function.Store(frameIndex, nextFrameIndex);
+            function.Store(pendingOutput, function.GetFunctionArgument("output"));
+            function.Store(isFramePending, function.Literal<int>(1));
+            function.Call(startFunction.GetFunction(), { function.GetFunctionArgument("context"), inputSlot, outputSlot });
+            function.If(emitters::TypedComparison::notEquals, wasFramePending, function.Literal<int>(0), [&](emitters::IRFunctionEmitter& fn) {
+                copyBytes(fn, previousOutputSlot, previousOutput, outputBytes);
+            });
+        }
+        _moduleEmitter.EndFunction();
+
+        auto waitFunction = _moduleEmitter.BeginFunction(waitName, voidType, emitters::NamedLLVMTypeList{});
+        waitFunction.IncludeInHeader();
+        waitFunction.Call(finishFunction.GetFunction(), {});
+        _moduleEmitter.EndFunction();
+    }
+
+    std::string IRMapCompiler::GetAsyncPredictFunctionName() const
+    {
+        return GetPredictFunctionName() + "_async";
+    }
+
+    std::string IRMapCompiler::GetWaitPredictFunctionName() const
+    {
+        return GetPredictFunctionName() + "_wait";
+    }
+
     void IRMapCompiler::EmitModelAPIFunctions(const Map& map)
     {
         EmitGetInputSizeFunction(map);
@@ -590,7 +1037,23 @@ namespace model
     emitters::LLVMValue IRMapCompiler::EnsurePortEmitted(const OutputPortBase& port)
     {
         auto pVar = GetOrAllocatePortVariable(port);
-        return GetModule().EnsureEmitted(*pVar);
+        auto pValue = GetModule().EnsureEmitted(*pVar);
+
+        // Align the storage of ports held in globals or on the stack to the vector size, so vectorized node code can use aligned loads and stores
+        const auto& compilerOptions = GetModule().GetCompilerOptions();
+        if (compilerOptions.allowVectorInstructions)
+        {
+            auto vectorBytes = static_cast<unsigned>(compilerOptions.vectorWidth * GetModule().GetIREmitter().SizeOf(PortTypeToVariableType(port.GetType())));
+            if (auto global = llvm::dyn_cast<llvm::GlobalVariable>(pValue); global != nullptr && global->getAlignment() < vectorBytes)
+            {
+                global->setAlignment(vectorBytes);
+            }
+            else if (auto stackArray = llvm::dyn_cast<llvm::AllocaInst>(pValue); stackArray != nullptr && stackArray->getAlignment() < vectorBytes)
+            {
+                stackArray->setAlignment(vectorBytes);
+            }
+        }
+        return pValue;
     }
 
     void IRMapCompiler::OnBeginCompileModel(const Model& model)
@@ -606,6 +1069,7 @@ namespace model
         currentFunction.IncludeInHeader();
         currentFunction.IncludeInPredictInterface();
 
+        _hasParallelBranches = false;
         _profiler.StartModel(currentFunction);
     }
 
@@ -624,6 +1088,27 @@ namespace model
             currentFunction.AddRegion(currentFunction.GetCurrentBlock());
         }
 
+        // Give the nodes reading this node's outputs a chance to have them written straight into their own buffers
+        for (auto output : node.GetOutputPorts())
+        {
+            for (auto input : output->GetReferences())
+            {
+                if (GetVariableForPort(*output) != nullptr)
+                {
+                    break;
+                }
+                if (auto consumer = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(input->GetNode())))
+                {
+                    consumer->OnBeginCompileInput(*this, *input);
+                }
+            }
+        }
+
+        if (!_gatedBlocks.empty())
+        {
+            _gatedBlocks.back().nodes.push_back(&node);
+        }
+
         _profiler.InitNode(currentFunction, node);
         _profiler.StartNode(currentFunction, node);
     }
@@ -646,6 +1131,142 @@ namespace model
         Log() << "Finished compiling node " << DiagnosticString(node) << EOL;
     }
 
+    void IRMapCompiler::OnBeginGatedNodes(const GateNodeBase& gate)
+    {
+        Log() << "Compiling the nodes controlled by " << DiagnosticString(gate) << EOL;
+
+        // The condition is tested in a region of its own, which the code of the gated nodes is folded into at the end
+        auto& currentFunction = GetModule().GetCurrentFunction();
+        auto pBlock = currentFunction.Block("gate_" + IdString(gate));
+        currentFunction.SetCurrentBlock(pBlock);
+        auto pRegion = currentFunction.AddRegion(pBlock);
+        auto condition = LoadPortElementVariable(gate.GetConditionInput().GetInputElement(0));
+        _gatedBlocks.push_back({ pRegion, condition, currentFunction.NumRegions(), {} });
+    }
+
+    void IRMapCompiler::OnEndGatedNodes(const GateNodeBase& gate)
+    {
+        assert(!_gatedBlocks.empty());
+        auto gatedBlock = _gatedBlocks.back();
+        _gatedBlocks.pop_back();
+
+        // Chain the regions of the gated nodes together, and branch around them when the condition is false
+        auto& currentFunction = GetModule().GetCurrentFunction();
+        auto pDoneBlock = currentFunction.Block("gate_done_" + IdString(gate));
+        emitters::IRBlockRegion* pGatedRegion = nullptr;
+        for (auto index = gatedBlock.firstNodeRegion; index < currentFunction.NumRegions(); ++index)
+        {
+            auto pRegion = currentFunction.GetRegion(index);
+            if (!pRegion->IsTopLevel())
+            {
+                continue;
+            }
+
+            if (pGatedRegion == nullptr)
+            {
+                pGatedRegion = pRegion;
+            }
+            else
+            {
+                currentFunction.ConcatRegions(pGatedRegion, pRegion);
+            }
+        }
+
+        currentFunction.SetCurrentBlock(gatedBlock.pRegion->End());
+        if (pGatedRegion != nullptr)
+        {
+            currentFunction.Branch(gatedBlock.condition, true, pGatedRegion->Start(), pDoneBlock);
+            currentFunction.SetCurrentBlock(pGatedRegion->End());
+            currentFunction.DeleteTerminatingBranch();
+            pGatedRegion->IsTopLevel() = false;
+        }
+        currentFunction.Branch(pDoneBlock);
+        gatedBlock.pRegion->SetEnd(pDoneBlock);
+        currentFunction.SetCurrentBlock(pDoneBlock);
+
+        // Code merged into a gated node's region later on goes after the whole gated block
+        for (auto node : gatedBlock.nodes)
+        {
+            GetCurrentNodeBlocks().Set(*node, gatedBlock.pRegion);
+        }
+        if (!_gatedBlocks.empty())
+        {
+            auto& nodes = _gatedBlocks.back().nodes;
+            nodes.insert(nodes.end(), gatedBlock.nodes.begin(), gatedBlock.nodes.end());
+        }
+
+        Log() << "Finished compiling the nodes controlled by " << DiagnosticString(gate) << EOL;
+    }
+
+    void IRMapCompiler::OnBeginParallelBranches(size_t numBranches)
+    {
+        Log() << "Compiling " << numBranches << " branches as parallel tasks" << EOL;
+        _hasParallelBranches = true;
+        _branchArguments.clear();
+        _branchFunctions.clear();
+        for (auto& argument : GetModule().GetCurrentFunction().Arguments())
+        {
+            _branchArguments.push_back({ argument.getName().str(), argument.getType() });
+        }
+    }
+
+    void IRMapCompiler::OnBeginParallelBranch(size_t index)
+    {
+        auto voidType = GetModule().GetIREmitter().Type(emitters::VariableType::Void);
+        auto& branchFunction = GetModule().BeginFunction(GetPredictFunctionName() + "_branch" + std::to_string(index), voidType, _branchArguments);
+        _branchFunctions.push_back(branchFunction.GetFunction());
+    }
+
+    void IRMapCompiler::OnEndParallelBranch(size_t /*index*/)
+    {
+        GetModule().EndFunction();
+    }
+
+    void IRMapCompiler::OnEndParallelBranches()
+    {
+        // Each task calls the function of one branch
+        auto& irEmitter = GetModule().GetIREmitter();
+        emitters::NamedLLVMTypeList taskArguments = { { "branchIndex", irEmitter.Type(emitters::VariableType::Int32) } };
+        taskArguments.insert(taskArguments.end(), _branchArguments.begin(), _branchArguments.end());
+        auto& taskFunction = GetModule().BeginFunction(GetPredictFunctionName() + "_branchTask", irEmitter.Type(emitters::VariableType::Void), taskArguments);
+        {
+            auto branchIndex = taskFunction.GetFunctionArgument("branchIndex");
+            emitters::IRValueList arguments;
+            for (const auto& argument : _branchArguments)
+            {
+                arguments.push_back(taskFunction.GetFunctionArgument(argument.first));
+            }
+            for (size_t index = 0; index < _branchFunctions.size(); ++index)
+            {
+                taskFunction.If(emitters::TypedComparison::equals, branchIndex, taskFunction.Literal<int>(static_cast<int>(index)), [&](emitters::IRFunctionEmitter& function) {
+                    function.Call(_branchFunctions[index], arguments);
+                });
+            }
+        }
+        auto pTaskFunction = taskFunction.GetFunction();
+        GetModule().EndFunction();
+
+        // The tasks are started and waited for in a region of their own, after the regions of the nodes the branches use
+        auto& currentFunction = GetModule().GetCurrentFunction();
+        auto pBlock = currentFunction.Block("parallel_branches");
+        currentFunction.SetCurrentBlock(pBlock);
+        auto pRegion = currentFunction.AddRegion(pBlock);
+        std::vector<std::vector<emitters::LLVMValue>> tasksArguments;
+        for (size_t index = 0; index < _branchFunctions.size(); ++index)
+        {
+            std::vector<emitters::LLVMValue> arguments = { currentFunction.Literal<int>(static_cast<int>(index)) };
+            for (auto& argument : currentFunction.Arguments())
+            {
+                arguments.push_back(&argument);
+            }
+            tasksArguments.push_back(arguments);
+        }
+        auto tasks = currentFunction.StartTasks(pTaskFunction, tasksArguments);
+        tasks.WaitAll(currentFunction);
+        pRegion->SetEnd(currentFunction.GetCurrentBlock());
+        Log() << "Finished compiling the parallel branches" << EOL;
+    }
+
     void IRMapCompiler::PushScope()
     {
         MapCompiler::PushScope();
@@ -760,6 +1381,27 @@ namespace model
 
         Log() << "Trying to merge emitted code for node " << DiagnosticString(src) << " with existing code region in " << currentFunction.GetFunctionName() << EOL;
 
+        // Merging moves the node's code next to its parent's, which would break the liveness assumptions for shared buffers
+        if (GetMapCompilerOptions().reuseIntermediateBuffers)
+        {
+            Log() << "Not merging code regions, because intermediate buffers are shared" << EOL;
+            return false;
+        }
+
+        // Merging could move a node's code into another branch's function, or ahead of the tasks computing its inputs
+        if (_hasParallelBranches)
+        {
+            Log() << "Not merging code regions, because the model has parallel branches" << EOL;
+            return false;
+        }
+
+        // Merging could move a gated node's code out of its gated block
+        if (!_gatedBlocks.empty())
+        {
+            Log() << "Not merging code regions, because the node is controlled by a gate node" << EOL;
+            return false;
+        }
+
         emitters::IRBlockRegion* pSrcRegion = GetCurrentNodeBlocks().Get(src);
         if (pSrcRegion == nullptr || pSrcRegion == pDestRegion)
         {
@@ -777,7 +1419,7 @@ namespace model
     emitters::IRBlockRegion* IRMapCompiler::GetMergeableNodeRegion(const PortElementBase& element)
     {
         const Node* pNode = nullptr;
-        if (HasSingleDescendant(element))
+        if (HasSingleDescendant(element) && _gatedBlocks.empty())
         {
             emitters::Variable* pVar = GetVariableForPort(*element.ReferencedPort());
             if (pVar != nullptr && !pVar->IsLiteral())
@@ -12,6 +12,7 @@
 #include <emitters/include/IRFunctionEmitter.h>
 #include <emitters/include/IRMetadata.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRReentrancy.h>
 #include <emitters/include/LLVMUtilities.h>
 
 #include <algorithm>
@@ -82,7 +83,8 @@ namespace model
         auto& emitter = _module->GetIREmitter();
         auto& irBuilder = emitter.GetIRBuilder();
 
-        _startTime = startTime;
+        _startTimeVariable = function.Variable(emitters::VariableType::Double, "startTime");
+        function.Store(_startTimeVariable, startTime);
 
         // Increment node entry counter
         auto countPtr = irBuilder.CreateInBoundsGEP(_performanceCountersType, _performanceCountersPtr, { emitter.Literal(0), emitter.Literal(0) });
@@ -97,7 +99,7 @@ namespace model
         auto& irBuilder = emitter.GetIRBuilder();
 
         // Compute time elapsed and increment total time counter
-        auto elapsedTime = function.Operator(emitters::TypedOperator::subtractFloat, endTime, _startTime);
+        auto elapsedTime = function.Operator(emitters::TypedOperator::subtractFloat, endTime, function.Load(_startTimeVariable));
         auto totalTimePtr = irBuilder.CreateInBoundsGEP(_performanceCountersPtr, { emitter.Literal(0), emitter.Literal(1) }, "accumTime");
         function.OperationAndUpdate(totalTimePtr, emitters::TypedOperator::addFloat, elapsedTime);
     }
@@ -159,10 +161,12 @@ namespace model
         // Emit functions
     }
 
-    ModelProfiler::ModelProfiler(emitters::IRModuleEmitter& module, Model& model, bool enableProfiling) :
+    ModelProfiler::ModelProfiler(emitters::IRModuleEmitter& module, Model& model, bool enableProfiling, int samplingInterval, double samplingPeriod) :
         _module(&module),
         _model(&model),
         _profilingEnabled(enableProfiling),
+        _samplingInterval(samplingInterval),
+        _samplingPeriod(samplingPeriod),
         _nodeInfoType(nullptr),
         _performanceCountersType(nullptr)
     {
@@ -198,6 +202,10 @@ namespace model
         emitters::NamedLLVMTypeList countersFields = { { "count", int64Type }, { "totalTime", doubleType } };
         _performanceCountersType = _module->GetOrCreateStruct(GetNamespacePrefix() + "_PerformanceCounters", countersFields);
         _module->IncludeTypeInHeader(_performanceCountersType->getName());
+
+        emitters::NamedLLVMTypeList samplingCountersFields = { { "callCount", int64Type }, { "sampledCallCount", int64Type } };
+        _samplingCountersType = _module->GetOrCreateStruct(GetNamespacePrefix() + "_ProfilingSamplingCounters", samplingCountersFields);
+        _module->IncludeTypeInHeader(_samplingCountersType->getName());
     }
 
     void ModelProfiler::StartModel(emitters::IRFunctionEmitter& function)
@@ -207,7 +215,7 @@ namespace model
             return;
         }
 
-        auto startTime = CallGetCurrentTime(function);
+        auto sampleTime = EmitStartSample(function);
         auto& emitter = _module->GetIREmitter();
         auto& irBuilder = emitter.GetIRBuilder();
 
@@ -216,7 +224,10 @@ namespace model
         _modelPerformanceCounters = { *_module, modelPerformanceCountersPtr, _performanceCountersType };
 
         _modelPerformanceCounters.Init(function);
-        _modelPerformanceCounters.Start(function, startTime);
+        IfSampled(function, [this, sampleTime](emitters::IRFunctionEmitter& function) {
+            auto startTime = sampleTime != nullptr ? sampleTime : CallGetCurrentTime(function);
+            _modelPerformanceCounters.Start(function, startTime);
+        });
     }
 
     void ModelProfiler::EndModel(emitters::IRFunctionEmitter& function)
@@ -226,8 +237,10 @@ namespace model
             return;
         }
 
-        auto endTime = CallGetCurrentTime(function);
-        _modelPerformanceCounters.End(function, endTime);
+        IfSampled(function, [this](emitters::IRFunctionEmitter& function) {
+            auto endTime = CallGetCurrentTime(function);
+            _modelPerformanceCounters.End(function, endTime);
+        });
     }
 
     void ModelProfiler::InitNode(emitters::IRFunctionEmitter& function, const Node& node)
@@ -252,9 +265,11 @@ namespace model
         auto& performanceCounters = GetPerformanceCountersForNode(node);
         auto& typePerformanceCounters = GetTypePerformanceCountersForNode(node);
 
-        auto startTime = CallGetCurrentTime(function);
-        performanceCounters.Start(function, startTime);
-        typePerformanceCounters.Start(function, startTime);
+        IfSampled(function, [this, &performanceCounters, &typePerformanceCounters](emitters::IRFunctionEmitter& function) {
+            auto startTime = CallGetCurrentTime(function);
+            performanceCounters.Start(function, startTime);
+            typePerformanceCounters.Start(function, startTime);
+        });
     }
 
     void ModelProfiler::EndNode(emitters::IRFunctionEmitter& function, const Node& node)
@@ -266,9 +281,11 @@ namespace model
         auto& performanceCounters = GetPerformanceCountersForNode(node);
         auto& typePerformanceCounters = GetTypePerformanceCountersForNode(node);
 
-        auto endTime = CallGetCurrentTime(function);
-        performanceCounters.End(function, endTime);
-        typePerformanceCounters.End(function, endTime);
+        IfSampled(function, [this, &performanceCounters, &typePerformanceCounters](emitters::IRFunctionEmitter& function) {
+            auto endTime = CallGetCurrentTime(function);
+            performanceCounters.End(function, endTime);
+            typePerformanceCounters.End(function, endTime);
+        });
     }
 
     void ModelProfiler::EmitModelProfilerFunctions()
@@ -282,6 +299,7 @@ namespace model
         assert(_model != nullptr);
 
         EmitGetModelPerformanceCountersFunction();
+        EmitGetProfilingSamplingCountersFunction();
         EmitPrintModelProfilingInfoFunction();
         EmitResetModelProfilingInfoFunction();
 
@@ -301,6 +319,9 @@ namespace model
     void ModelProfiler::AllocateNodeData()
     {
         _modelPerformanceCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_ModelPerformanceCountersArray", _performanceCountersType, 2);
+        _samplingCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_ProfilingSamplingCountersArray", _samplingCountersType, 1);
+        _lastSampleTime = _module->Global(emitters::VariableType::Double, GetNamespacePrefix() + "_LastProfilingSampleTime");
+        _isSampledCall = _module->Global(emitters::VariableType::Boolean, GetNamespacePrefix() + "_IsProfilingSampledCall");
 
         int numNodes = _model->Size();
         _nodeInfoArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeInfoArray", _nodeInfoType, numNodes);
@@ -309,6 +330,11 @@ namespace model
         // Note: We're grossly overallocating global array for types
         _nodeTypeInfoArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeTypeInfoArray", _nodeInfoType, numNodes);
         _nodeTypePerformanceCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeTypePerformanceCountersArray", _performanceCountersType, numNodes);
+
+        for (auto array : { _modelPerformanceCountersArray, _samplingCountersArray, _lastSampleTime, _isSampledCall, _nodeInfoArray, _nodePerformanceCountersArray, _nodeTypeInfoArray, _nodeTypePerformanceCountersArray })
+        {
+            emitters::MarkGlobalShared(*array);
+        }
     }
 
     std::string ModelProfiler::GetNamespacePrefix() const
@@ -329,6 +355,19 @@ namespace model
         _module->EndFunction();
     }
 
+    void ModelProfiler::EmitGetProfilingSamplingCountersFunction()
+    {
+        auto& emitter = _module->GetIREmitter();
+        auto& irBuilder = emitter.GetIRBuilder();
+
+        auto function = _module->BeginFunction(GetNamespacePrefix() + "_GetProfilingSamplingCounters", _samplingCountersType->getPointerTo());
+        function.IncludeInHeader();
+
+        auto samplingCountersPtr = irBuilder.CreateInBoundsGEP(_samplingCountersArray, { function.Literal(0), function.Literal(0) });
+        function.Return(samplingCountersPtr);
+        _module->EndFunction();
+    }
+
     void ModelProfiler::EmitGetNumNodeTypesFunction()
     {
         auto& context = _module->GetLLVMContext();
@@ -425,6 +464,13 @@ namespace model
         auto countPtr = irBuilder.CreateInBoundsGEP(modelPerformanceCountersPtr, { function.Literal(0), function.Literal(0) });
         auto totalTimePtr = irBuilder.CreateInBoundsGEP(modelPerformanceCountersPtr, { function.Literal(0), function.Literal(1) });
         function.Printf("Total time: %f ms\tcount: %d\n", { function.Load(totalTimePtr), function.Load(countPtr) });
+        if (IsSamplingEnabled())
+        {
+            auto samplingCountersPtr = irBuilder.CreateInBoundsGEP(_samplingCountersArray, { function.Literal(0), function.Literal(0) });
+            auto callCountPtr = irBuilder.CreateInBoundsGEP(samplingCountersPtr, { function.Literal(0), function.Literal(0) });
+            auto sampledCallCountPtr = irBuilder.CreateInBoundsGEP(samplingCountersPtr, { function.Literal(0), function.Literal(1) });
+            function.Printf("Timed calls: %lld of %lld\n", { function.Load(sampledCallCountPtr), function.Load(callCountPtr) });
+        }
 
         _module->EndFunction();
     }
@@ -445,6 +491,11 @@ namespace model
         function.StoreZero(countPtr);
         function.StoreZero(totalTimePtr);
 
+        auto samplingCountersPtr = irBuilder.CreateInBoundsGEP(_samplingCountersArray, { function.Literal(0), function.Literal(0) });
+        function.StoreZero(irBuilder.CreateInBoundsGEP(samplingCountersPtr, { function.Literal(0), function.Literal(0) }));
+        function.StoreZero(irBuilder.CreateInBoundsGEP(samplingCountersPtr, { function.Literal(0), function.Literal(1) }));
+        function.StoreZero(_lastSampleTime);
+
         _module->EndFunction();
     }
 
@@ -592,5 +643,56 @@ namespace model
         auto time = _module->GetRuntime().GetCurrentTime(function);
         return time;
     }
+
+    emitters::LLVMValue ModelProfiler::EmitStartSample(emitters::IRFunctionEmitter& function)
+    {
+        auto& emitter = _module->GetIREmitter();
+        auto& irBuilder = emitter.GetIRBuilder();
+
+        auto samplingCountersPtr = irBuilder.CreateInBoundsGEP(_samplingCountersArray, { emitter.Literal(0), emitter.Literal(0) });
+        auto callCountPtr = irBuilder.CreateInBoundsGEP(samplingCountersPtr, { emitter.Literal(0), emitter.Literal(0) });
+        auto sampledCallCountPtr = irBuilder.CreateInBoundsGEP(samplingCountersPtr, { emitter.Literal(0), emitter.Literal(1) });
+        function.OperationAndUpdate(callCountPtr, emitters::TypedOperator::add, function.Literal<int64_t>(1));
+        if (!IsSamplingEnabled())
+        {
+            function.OperationAndUpdate(sampledCallCountPtr, emitters::TypedOperator::add, function.Literal<int64_t>(1));
+            return nullptr;
+        }
+
+        // Decide whether to time this call, either by the time since the last timed call or by counting calls
+        emitters::LLVMValue currentTime = nullptr;
+        emitters::LLVMValue isSampled = nullptr;
+        if (_samplingPeriod > 0)
+        {
+            currentTime = CallGetCurrentTime(function);
+            auto elapsedTime = function.Operator(emitters::TypedOperator::subtractFloat, currentTime, function.Load(_lastSampleTime));
+            isSampled = function.Comparison(emitters::TypedComparison::greaterThanOrEqualsFloat, elapsedTime, function.Literal(_samplingPeriod));
+        }
+        else
+        {
+            auto remainder = function.Operator(emitters::TypedOperator::moduloSigned, function.Load(callCountPtr), function.Literal<int64_t>(_samplingInterval));
+            isSampled = function.Comparison(emitters::TypedComparison::equals, remainder, function.Literal<int64_t>(0));
+        }
+        function.Store(_isSampledCall, isSampled);
+
+        function.If(isSampled, [this, currentTime, sampledCallCountPtr](emitters::IRFunctionEmitter& function) {
+            function.OperationAndUpdate(sampledCallCountPtr, emitters::TypedOperator::add, function.Literal<int64_t>(1));
+            if (currentTime != nullptr)
+            {
+                function.Store(_lastSampleTime, currentTime);
+            }
+        });
+        return currentTime;
+    }
+
+    void ModelProfiler::IfSampled(emitters::IRFunctionEmitter& function, std::function<void(emitters::IRFunctionEmitter&)> body)
+    {
+        if (!IsSamplingEnabled())
+        {
+            body(function);
+            return;
+        }
+        function.If(function.Load(_isSampledCall), body);
+    }
 } // namespace model
 } // namespace ell
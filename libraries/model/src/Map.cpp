@@ -77,7 +77,8 @@ namespace model
         _model.Verify();
     }
 
-    Map::Map(const Map& other)
+    Map::Map(const Map& other) :
+        _numComputeThreads(other._numComputeThreads)
     {
         TransformContext context;
         ModelTransformer transformer;
@@ -131,29 +132,44 @@ namespace model
         node->SetInput(inputValues);
     }
 
+    template <typename ValueType>
+    std::vector<ValueType> Map::ComputeModelOutput(const PortElementsBase& outputs)
+    {
+        // The schedule for the outputs is kept until the model or the requested outputs change
+        if (!_computeSchedule.IsScheduleFor(_model, outputs))
+        {
+            _computeSchedule = ComputeSchedule(_model, outputs);
+        }
+        _computeSchedule.Compute(_numComputeThreads);
+
+        std::vector<ValueType> result;
+        _computeSchedule.GetOutput(result);
+        return result;
+    }
+
     std::vector<bool> Map::ComputeBoolOutput(const PortElementsBase& outputs)
     {
-        return _model.ComputeOutput<bool>(outputs);
+        return ComputeModelOutput<bool>(outputs);
     }
 
     std::vector<int> Map::ComputeIntOutput(const PortElementsBase& outputs)
     {
-        return _model.ComputeOutput<int>(outputs);
+        return ComputeModelOutput<int>(outputs);
     }
 
     std::vector<int64_t> Map::ComputeInt64Output(const PortElementsBase& outputs)
     {
-        return _model.ComputeOutput<int64_t>(outputs);
+        return ComputeModelOutput<int64_t>(outputs);
     }
 
     std::vector<float> Map::ComputeFloatOutput(const PortElementsBase& outputs)
     {
-        return _model.ComputeOutput<float>(outputs);
+        return ComputeModelOutput<float>(outputs);
     }
 
     std::vector<double> Map::ComputeDoubleOutput(const PortElementsBase& outputs)
     {
-        return _model.ComputeOutput<double>(outputs);
+        return ComputeModelOutput<double>(outputs);
     }
 
     template <>
@@ -201,6 +217,27 @@ namespace model
         _model.Reset();
     }
 
+    const ComputeSchedule& Map::GetContextSchedule(ExecutionContext& context) const
+    {
+        return context.GetSchedule(_model, GetOutput(0));
+    }
+
+    bool Map::IsReentrant() const
+    {
+        for (const auto& output : _outputElements)
+        {
+            ComputeSchedule schedule(_model, output);
+            for (auto node : schedule.GetNodes())
+            {
+                if (!node->IsReentrant())
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     void Map::AddInput(const std::string& inputName, InputNodeBase* inputNode)
     {
         _inputNodes.push_back(inputNode);
@@ -236,6 +273,8 @@ namespace model
         swap(a._outputNames, b._outputNames);
         swap(a._outputElementsMap, b._outputElementsMap);
         swap(a._computeContext, b._computeContext);
+        swap(a._numComputeThreads, b._numComputeThreads);
+        swap(a._computeSchedule, b._computeSchedule);
     }
 
     std::vector<const Node*> Map::GetAllOutputNodes() const
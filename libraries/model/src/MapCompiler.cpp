@@ -18,15 +18,63 @@
 #include <utilities/include/Logger.h>
 #include <utilities/include/PropertyBag.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace model
 {
     using namespace logging;
 
+    namespace
+    {
+        MapCompilerOptions GetEffectiveOptions(MapCompilerOptions settings)
+        {
+            // Code that doesn't use the heap has all its buffers planned at compile time
+            if (settings.noHeap)
+            {
+                settings.reuseIntermediateBuffers = true;
+                settings.compilerSettings.staticMemory = true;
+            }
+            return settings;
+        }
+
+        // Elementwise nodes compute each output element from the input elements at the same position (or from scalar
+        // inputs), so their code is a single loop, however large their ports are
+        bool IsElementwise(const Node& node)
+        {
+            const auto& outputs = node.GetOutputPorts();
+            const auto& inputs = node.GetInputPorts();
+            if (outputs.size() != 1 || inputs.empty() || outputs[0]->Size() == 0)
+            {
+                return false;
+            }
+
+            const auto& outputLayout = outputs[0]->GetMemoryLayout();
+            return std::all_of(inputs.begin(), inputs.end(), [&outputLayout](const InputPortBase* input) {
+                return input->Size() == 1 || input->GetMemoryLayout() == outputLayout;
+            });
+        }
+
+        size_t GetTotalPortSize(const Node& node)
+        {
+            size_t size = 0;
+            for (const auto* input : node.GetInputPorts())
+            {
+                size += input->Size();
+            }
+            for (const auto* output : node.GetOutputPorts())
+            {
+                size += output->Size();
+            }
+            return size;
+        }
+    } // namespace
+
     MapCompiler::MapCompiler(const MapCompilerOptions& settings, const ModelOptimizerOptions& optimizerOptions) :
-        _parameters(settings),
-        _optimizerOptions(optimizerOptions)
+        _parameters(GetEffectiveOptions(settings)),
+        _optimizerOptions(optimizerOptions),
+        _compileTimingReport(settings.recordCompileTimings)
     {
         PushScope();
     }
@@ -83,6 +131,23 @@ namespace model
         return options;
     }
 
+    bool MapCompiler::ShouldInlineNode(const Node& node) const
+    {
+        const auto options = GetMapCompilerOptions(node);
+        if (options.inlineNodes)
+        {
+            return true;
+        }
+
+        // Small and elementwise nodes cost little to optimize as part of their consumer, and calling them out of line
+        // keeps LLVM from fusing their loops with their neighbors'
+        if (options.inlineElementwiseNodes && IsElementwise(node))
+        {
+            return true;
+        }
+        return options.inlineNodeSizeLimit > 0 && GetTotalPortSize(node) <= static_cast<size_t>(options.inlineNodeSizeLimit);
+    }
+
     void MapCompiler::CompileMap(Map& map, const std::string& functionName)
     {
         using namespace std::string_literals;
@@ -115,40 +180,171 @@ namespace model
         Log() << "Finished 'predict' function" << EOL;
     }
 
+    void MapCompiler::CompileAdditionalMapNodes(Map& map)
+    {
+        auto nodeMemoryUsage = std::move(_nodeMemoryUsage);
+        auto dedicatedPortBufferSize = _dedicatedPortBufferSize;
+        auto stackPortBufferSize = _stackPortBufferSize;
+        CompileNodes(map.GetModel());
+        _nodeMemoryUsage = std::move(nodeMemoryUsage);
+        _dedicatedPortBufferSize = dedicatedPortBufferSize;
+        _stackPortBufferSize = stackPortBufferSize;
+    }
+
     void MapCompiler::CompileNodes(Model& model)
     {
+        _nodeMemoryUsage.clear();
+        _stackPortBufferSize = 0;
+
+        // Nodes controlled by a gate node are compiled together, right before it, so they can be skipped together
+        std::vector<const Node*> nodes;
+        model.Visit([&nodes](const Node& node) { nodes.push_back(&node); });
+        auto order = GetGatedComputeOrder(nodes);
+
+        if (_parameters.reuseIntermediateBuffers)
+        {
+            _bufferAllocator = std::make_unique<PortBufferAllocator>(order.nodes);
+        }
+
+        _isCompilingNodes = true;
         std::unordered_set<const Node*> visitedNodes;
-        model.Visit([this, &visitedNodes](const Node& node) {
-            for (const auto* inputPort : node.GetInputPorts())
+        if (CanParallelizeBranches(order))
+        {
+            CompileParallelBranches(GetParallelBranchOrder(order.nodes), visitedNodes);
+            order.nodes.clear();
+        }
+
+        size_t nextRange = 0;
+        std::vector<const GatedNodeRange*> openRanges;
+        for (size_t index = 0; index < order.nodes.size(); ++index)
+        {
+            while (nextRange < order.gatedRanges.size() && order.gatedRanges[nextRange].begin == index)
             {
-                const auto* dependent = inputPort->GetReferencedPort().GetNode();
-                if (visitedNodes.find(dependent) == visitedNodes.end())
+                const auto& range = order.gatedRanges[nextRange++];
+                if (range.begin != range.end)
                 {
-                    throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Visited node before all its descendants!");
+                    OnBeginGatedNodes(*range.gate);
+                    openRanges.push_back(&range);
                 }
             }
-            if (!node.IsCompilable(this))
+
+            CompileNode(*order.nodes[index], visitedNodes);
+
+            while (!openRanges.empty() && openRanges.back()->end == index + 1)
             {
-                std::string typeName = node.GetRuntimeTypeName();
-                throw emitters::EmitterException(emitters::EmitterError::notSupported, std::string("Uncompilable node type: " + typeName));
+                OnEndGatedNodes(*openRanges.back()->gate);
+                openRanges.pop_back();
             }
+        }
+
+        _isCompilingNodes = false;
+        if (_stackPortBufferSize > 0)
+        {
+            Log() << "Stored port variables with a total size of " << _stackPortBufferSize << " bytes on the stack" << EOL;
+        }
+
+        if (_bufferAllocator)
+        {
+            Log() << "Stored " << _bufferAllocator->NumAllocatedPorts() << " port variables in " << _bufferAllocator->NumBuffers()
+                  << " shared buffers, with a total size of " << _bufferAllocator->GetTotalBufferSize() << " elements" << EOL;
+            _bufferAllocator.reset();
+            _sharedBufferVariables.clear();
+            _sharedBufferIndices.clear();
+        }
+    }
+
+    void MapCompiler::CompileNode(const Node& node, std::unordered_set<const Node*>& visitedNodes)
+    {
+        for (const auto* inputPort : node.GetInputPorts())
+        {
+            const auto* dependent = inputPort->GetReferencedPort().GetNode();
+            if (visitedNodes.find(dependent) == visitedNodes.end())
+            {
+                throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Visited node before all its descendants!");
+            }
+        }
+        if (!node.IsCompilable(this))
+        {
+            std::string typeName = node.GetRuntimeTypeName();
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, std::string("Uncompilable node type: " + typeName));
+        }
+
+        auto compilableNode = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(&node));
+        if (!compilableNode)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Encountered null compilable node");
+        }
+
+        visitedNodes.insert(&node);
+        Log() << "Now compiling node " << DiagnosticString(node) << EOL;
+        OnBeginCompileNode(node);
+        compilableNode->CompileNode(*this);
+        OnEndCompileNode(node);
+
+        // The buffers assigned so far and not yet released are the ones live while the node runs
+        auto liveBufferSize = _dedicatedPortBufferSize + (_bufferAllocator ? _bufferAllocator->GetLiveBufferBytes() : 0);
+        _nodeMemoryUsage.push_back({ node.GetId().ToString(), node.GetRuntimeTypeName(), liveBufferSize });
+
+        if (_bufferAllocator)
+        {
+            _bufferAllocator->ReleaseBuffers(node);
+        }
+    }
 
-            auto compilableNode = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(&node));
-            if (!compilableNode)
+    bool MapCompiler::CanParallelizeBranches(const GatedComputeOrder& order) const
+    {
+        // Shared buffers are assigned assuming the nodes run one after the other, and reentrant modules pass their state
+        // down the calls of the map function, which the thread pool's tasks aren't part of
+        const auto& settings = _parameters.compilerSettings;
+        if (!_parameters.parallelizeBranches || !settings.parallelize || IsSharingBuffers() || settings.reentrant || !order.gatedRanges.empty())
+        {
+            return false;
+        }
+        return GetParallelBranchOrder(order.nodes).branches.size() > 1;
+    }
+
+    void MapCompiler::CompileParallelBranches(const ParallelBranchOrder& order, std::unordered_set<const Node*>& visitedNodes)
+    {
+        Log() << "Compiling " << order.branches.size() << " independent branches as parallel tasks" << EOL;
+        for (auto node : order.sources)
+        {
+            CompileNode(*node, visitedNodes);
+        }
+
+        // The branches run in functions of their own, so their ports can't be on the stack of the map function
+        _isCompilingBranches = true;
+        OnBeginParallelBranches(order.branches.size());
+        for (size_t index = 0; index < order.branches.size(); ++index)
+        {
+            OnBeginParallelBranch(index);
+            for (auto node : order.branches[index])
             {
-                throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Encountered null compilable node");
+                CompileNode(*node, visitedNodes);
             }
+            OnEndParallelBranch(index);
+        }
+        OnEndParallelBranches();
+        _isCompilingBranches = false;
 
-            visitedNodes.insert(&node);
-            Log() << "Now compiling node " << DiagnosticString(node) << EOL;
-            OnBeginCompileNode(node);
-            compilableNode->CompileNode(*this);
-            OnEndCompileNode(node);
-        });
+        for (auto node : order.tail)
+        {
+            CompileNode(*node, visitedNodes);
+        }
     }
 
     emitters::Variable* MapCompiler::AllocatePortVariable(const OutputPortBase& port)
     {
+        // Small buffers go on the stack even when buffers are shared, since LLVM can often keep them in registers
+        if (CanAllocatePortOnStack(port))
+        {
+            return AllocateStackPortVariable(port);
+        }
+
+        if (IsSharingBuffers() && _bufferAllocator->CanShareBuffer(port))
+        {
+            return AllocateSharedPortVariable(port);
+        }
+
         auto pModuleEmitter = GetModuleEmitter();
         assert(port.Size() != 0);
 
@@ -156,9 +352,66 @@ namespace model
         auto pVar = pModuleEmitter->Variables().AddVectorVariable(emitters::VariableScope::global, varType, port.Size());
         pModuleEmitter->AllocateVariable(*pVar);
         SetVariableForPort(port, pVar);
+        _dedicatedPortBufferSize += port.Size() * GetPortElementSize(port.GetType());
         return pVar;
     }
 
+    emitters::Variable* MapCompiler::AllocateStackPortVariable(const OutputPortBase& port)
+    {
+        auto pModuleEmitter = GetModuleEmitter();
+        emitters::VariableType varType = PortTypeToVariableType(port.GetType());
+        auto pVar = pModuleEmitter->Variables().AddVectorVariable(emitters::VariableScope::local, varType, port.Size());
+        pModuleEmitter->AllocateVariable(*pVar);
+        SetVariableForPort(port, pVar);
+
+        // The stack frame of the map function is live for the whole call, like the dedicated buffers
+        auto size = port.Size() * GetPortElementSize(port.GetType());
+        _dedicatedPortBufferSize += size;
+        _stackPortBufferSize += size;
+        return pVar;
+    }
+
+    bool MapCompiler::CanAllocatePortOnStack(const OutputPortBase& port) const
+    {
+        // Only ports computed by the body of the map function are call-scoped: variables in inner scopes are function
+        // arguments, and nodes keep their state across calls in variables of their own, not in their output ports
+        if (_parameters.maxStackPortBufferSize <= 0 || !_isCompilingNodes || _isCompilingBranches || _portToVarMaps.size() != 1 || port.Size() == 0)
+        {
+            return false;
+        }
+
+        // Padded ports rely on the contents of their padding area, which is only written once, when the global is initialized
+        if (port.GetMemoryLayout().HasPadding())
+        {
+            return false;
+        }
+        return port.Size() * GetPortElementSize(port.GetType()) <= static_cast<size_t>(_parameters.maxStackPortBufferSize);
+    }
+
+    emitters::Variable* MapCompiler::AllocateSharedPortVariable(const OutputPortBase& port)
+    {
+        auto bufferIndex = _bufferAllocator->AllocateBuffer(port);
+        if (bufferIndex == _sharedBufferVariables.size())
+        {
+            auto pModuleEmitter = GetModuleEmitter();
+            emitters::VariableType varType = PortTypeToVariableType(_bufferAllocator->GetBufferType(bufferIndex));
+            auto pVar = pModuleEmitter->Variables().AddVectorVariable(emitters::VariableScope::global, varType, _bufferAllocator->GetBufferSize(bufferIndex));
+            pModuleEmitter->AllocateVariable(*pVar);
+            _sharedBufferVariables.push_back(pVar);
+            _sharedBufferIndices[pVar] = bufferIndex;
+        }
+
+        auto pVar = _sharedBufferVariables[bufferIndex];
+        SetVariableForPort(port, pVar);
+        return pVar;
+    }
+
+    bool MapCompiler::IsSharingBuffers() const
+    {
+        // Only variables in the outermost scope (the body of the map function) are shared
+        return _bufferAllocator != nullptr && _portToVarMaps.size() == 1;
+    }
+
     emitters::Variable* MapCompiler::GetOrAllocatePortVariable(const OutputPortBase& port)
     {
         emitters::Variable* pVar = GetVariableForPort(port);
@@ -248,7 +501,50 @@ namespace model
 
     void MapCompiler::SetVariableForPort(const Port& port, emitters::Variable* pVar)
     {
+        if (IsSharingBuffers())
+        {
+            // Ports aliasing a shared buffer, directly or through views, keep it alive for as long as they're used
+            const emitters::Variable* pBufferVar = pVar;
+            for (auto view = _portVariableViews.find(pBufferVar); view != _portVariableViews.end(); view = _portVariableViews.find(pBufferVar))
+            {
+                pBufferVar = view->second.first;
+            }
+            auto it = _sharedBufferIndices.find(pBufferVar);
+            if (it != _sharedBufferIndices.end())
+            {
+                _bufferAllocator->AddPortToBuffer(it->second, port);
+            }
+        }
         _portToVarMaps.back()[&port] = pVar;
     }
+
+    bool MapCompiler::TrySetPortVariableToView(const OutputPortBase& port, const OutputPortBase& source, int offset)
+    {
+        // Scalar ports keep their own variables, since some nodes treat them as values rather than arrays
+        if (!_parameters.aliasPortBuffers || GetVariableForPort(port) != nullptr || port.Size() <= 1)
+        {
+            return false;
+        }
+
+        auto pSourceVar = GetOrAllocatePortVariable(source);
+        auto varType = PortTypeToVariableType(port.GetType());
+        if (pSourceVar->Scope() == emitters::VariableScope::output || pSourceVar->IsScalar() || pSourceVar->Type() != varType ||
+            offset < 0 || offset + port.Size() > pSourceVar->Dimension())
+        {
+            return false;
+        }
+
+        auto pVar = GetModuleEmitter()->Variables().AddVectorViewVariable(varType, *pSourceVar, offset, static_cast<int>(port.Size()));
+        _portVariableViews[pVar] = { pSourceVar, offset };
+        SetVariableForPort(port, pVar);
+        return true;
+    }
+
+    bool MapCompiler::IsPortVariableView(const OutputPortBase& port, const OutputPortBase& source, int offset)
+    {
+        auto pVar = GetVariableForPort(port);
+        auto it = _portVariableViews.find(pVar);
+        return it != _portVariableViews.end() && it->second.first == GetVariableForPort(source) && it->second.second == offset;
+    }
 } // namespace model
 } // namespace ell
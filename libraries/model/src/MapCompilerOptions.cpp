@@ -33,7 +33,25 @@ namespace model
         sinkFunctionName = properties.GetOrParseEntry("sinkFunctionName", sinkFunctionName);
         verifyJittedModule = properties.GetOrParseEntry("verifyJittedModule", verifyJittedModule);
         profile = properties.GetOrParseEntry("profile", profile);
+        profileSamplingInterval = properties.GetOrParseEntry("profileSamplingInterval", profileSamplingInterval);
+        profileSamplingPeriod = properties.GetOrParseEntry("profileSamplingPeriod", profileSamplingPeriod);
+        reuseIntermediateBuffers = properties.GetOrParseEntry("reuseIntermediateBuffers", reuseIntermediateBuffers);
+        aliasPortBuffers = properties.GetOrParseEntry("aliasPortBuffers", aliasPortBuffers);
+        maxStackPortBufferSize = properties.GetOrParseEntry("maxStackPortBufferSize", maxStackPortBufferSize);
+        parallelizeBranches = properties.GetOrParseEntry("parallelizeBranches", parallelizeBranches);
+        emitBatchFunction = properties.GetOrParseEntry("emitBatchFunction", emitBatchFunction);
+        batchFunctionSize = properties.GetOrParseEntry("batchFunctionSize", batchFunctionSize);
+        emitAsyncFunctions = properties.GetOrParseEntry("emitAsyncFunctions", emitAsyncFunctions);
+        objectCacheDirectory = properties.GetOrParseEntry("objectCacheDirectory", objectCacheDirectory);
+        cacheNodeFunctions = properties.GetOrParseEntry("cacheNodeFunctions", cacheNodeFunctions);
+        nodeFunctionCacheDirectory = properties.GetOrParseEntry("nodeFunctionCacheDirectory", nodeFunctionCacheDirectory);
+        recordCompileTimings = properties.GetOrParseEntry("recordCompileTimings", recordCompileTimings);
+        noHeap = properties.GetOrParseEntry("noHeap", noHeap);
+        collectOptimizationRemarks = properties.GetOrParseEntry("collectOptimizationRemarks", collectOptimizationRemarks);
         inlineNodes = properties.GetOrParseEntry("inlineNodes", inlineNodes);
+        inlineElementwiseNodes = properties.GetOrParseEntry("inlineElementwiseNodes", inlineElementwiseNodes);
+        inlineNodeSizeLimit = properties.GetOrParseEntry("inlineNodeSizeLimit", inlineNodeSizeLimit);
+        compilerSettings = compilerSettings.AppendOptions(properties);
     }
 } // namespace model
 } // namespace ell
@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MapMemoryReport.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MapMemoryReport.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace ell
+{
+namespace model
+{
+    size_t MapMemoryReport::GetPeakLiveBufferSize() const
+    {
+        size_t result = 0;
+        for (const auto& node : nodes)
+        {
+            result = std::max(result, node.liveBufferSize);
+        }
+        return result;
+    }
+
+    void WriteMemoryReport(const MapMemoryReport& report, std::ostream& stream)
+    {
+        stream << "Static memory: " << report.staticMemorySize << " bytes\n";
+        stream << "Constant memory: " << report.constantMemorySize << " bytes\n";
+        stream << "Stack high-water estimate: " << report.stackSize << " bytes" << (report.isStackSizeBounded ? "" : " (unbounded: the code calls callbacks or allocates a variable amount of stack)") << "\n";
+        stream << "Heap allocation: ";
+        if (report.heapFunctions.empty())
+        {
+            stream << "none\n";
+        }
+        else
+        {
+            for (size_t i = 0; i < report.heapFunctions.size(); ++i)
+            {
+                stream << (i == 0 ? "" : ", ") << report.heapFunctions[i];
+            }
+            stream << "\n";
+        }
+        stream << "Peak live port buffers: " << report.GetPeakLiveBufferSize() << " bytes\n";
+
+        size_t typeWidth = 4;
+        for (const auto& node : report.nodes)
+        {
+            typeWidth = std::max(typeWidth, node.nodeType.size());
+        }
+
+        stream << "\n"
+               << std::left << std::setw(8) << "id" << std::setw(static_cast<int>(typeWidth) + 2) << "type" << std::right << std::setw(14) << "live bytes" << "\n";
+        for (const auto& node : report.nodes)
+        {
+            stream << std::left << std::setw(8) << node.nodeId << std::setw(static_cast<int>(typeWidth) + 2) << node.nodeType << std::right << std::setw(14) << node.liveBufferSize << "\n";
+        }
+    }
+} // namespace model
+} // namespace ell
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MapOptimizationRemarks.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MapOptimizationRemarks.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace ell
+{
+namespace model
+{
+    using Kind = emitters::IROptimizationRemark::Kind;
+
+    size_t FunctionOptimizationRemarks::Count(Kind kind, const std::string& passName) const
+    {
+        return static_cast<size_t>(std::count_if(remarks.begin(), remarks.end(), [&](const auto& remark) {
+            return remark.kind == kind && remark.passName == passName;
+        }));
+    }
+
+    MapOptimizationRemarks GroupOptimizationRemarks(const std::vector<emitters::IROptimizationRemark>& remarks, const std::vector<FunctionOptimizationRemarks>& nodeFunctions)
+    {
+        MapOptimizationRemarks result;
+        std::unordered_map<std::string, size_t> functionIndices;
+        for (const auto& nodeFunction : nodeFunctions)
+        {
+            functionIndices[nodeFunction.functionName] = result.functions.size();
+            result.functions.push_back({ nodeFunction.functionName, nodeFunction.nodeId, nodeFunction.nodeType, {} });
+        }
+
+        for (const auto& remark : remarks)
+        {
+            auto it = functionIndices.find(remark.functionName);
+            if (it == functionIndices.end())
+            {
+                it = functionIndices.insert({ remark.functionName, result.functions.size() }).first;
+                result.functions.push_back({ remark.functionName, "", "", {} });
+            }
+            result.functions[it->second].remarks.push_back(remark);
+        }
+
+        // Leave out the node functions nothing was said about
+        result.functions.erase(std::remove_if(result.functions.begin(), result.functions.end(), [](const auto& function) { return function.remarks.empty(); }), result.functions.end());
+        return result;
+    }
+
+    void WriteOptimizationRemarks(const MapOptimizationRemarks& remarks, std::ostream& stream)
+    {
+        for (const auto& function : remarks.functions)
+        {
+            if (function.nodeId.empty())
+            {
+                stream << function.functionName << "\n";
+            }
+            else
+            {
+                stream << "Node " << function.nodeId << " (" << function.nodeType << "), function " << function.functionName << "\n";
+            }
+
+            auto vectorizedLoops = function.Count(Kind::passed, "loop-vectorize");
+            auto missedLoops = function.Count(Kind::missed, "loop-vectorize");
+            auto vectorizedSlp = function.Count(Kind::passed, "slp-vectorizer");
+            auto unrolledLoops = function.Count(Kind::passed, "loop-unroll");
+            auto inlinedCalls = function.Count(Kind::passed, "inline");
+            stream << "  " << vectorizedLoops << " loops vectorized, " << missedLoops << " loops not vectorized, "
+                   << vectorizedSlp << " SLP-vectorized regions, " << unrolledLoops << " loops unrolled, " << inlinedCalls << " calls inlined\n";
+
+            for (const auto& remark : function.remarks)
+            {
+                if (remark.kind != Kind::passed)
+                {
+                    stream << "  " << (remark.kind == Kind::missed ? "missed " : "note ") << remark.passName << ": " << remark.message << "\n";
+                }
+            }
+        }
+    }
+} // namespace model
+} // namespace ell
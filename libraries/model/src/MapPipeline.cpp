@@ -0,0 +1,462 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MapPipeline.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MapPipeline.h"
+#include "InputNode.h"
+#include "ModelProfileData.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+#include "OutputNodeBase.h"
+#include "Submodel.h"
+
+#include <data/include/DenseDataVector.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        // Nodes without inputs, other than input nodes, are copied into each stage that needs them, and never cross a cut
+        bool IsFreeNode(const Node& node)
+        {
+            return node.NumInputPorts() == 0 && dynamic_cast<const InputNodeBase*>(&node) == nullptr;
+        }
+
+        InputNodeBase* AddInputNode(Model& model, const OutputPortBase& port)
+        {
+            auto layout = port.GetMemoryLayout();
+            switch (port.GetType())
+            {
+            case Port::PortType::boolean:
+                return model.AddNode<InputNode<bool>>(layout);
+            case Port::PortType::integer:
+                return model.AddNode<InputNode<int>>(layout);
+            case Port::PortType::bigInt:
+                return model.AddNode<InputNode<int64_t>>(layout);
+            case Port::PortType::smallReal:
+                return model.AddNode<InputNode<float>>(layout);
+            case Port::PortType::real:
+                return model.AddNode<InputNode<double>>(layout);
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+            }
+        }
+
+        // Finds the input ports that read the stage's input, among the nodes needed to compute an output of the stage
+        void GetStageInputs(const OutputPortBase& output, const OutputPortBase& stageInput, std::unordered_set<const Node*>& visitedNodes, std::vector<const InputPortBase*>& inputs)
+        {
+            auto node = output.GetNode();
+            if (!visitedNodes.insert(node).second)
+            {
+                return;
+            }
+
+            for (auto input : node->GetInputPorts())
+            {
+                const auto& referencedPort = input->GetReferencedPort();
+                if (&referencedPort == &stageInput)
+                {
+                    inputs.push_back(input);
+                }
+                else
+                {
+                    GetStageInputs(referencedPort, stageInput, visitedNodes, inputs);
+                }
+            }
+        }
+
+        const OutputPortBase* GetSingleOutputPort(const Map& map, const std::string& functionName)
+        {
+            if (map.NumInputs() != 1 || map.NumOutputs() != 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, functionName + " requires a map with a single input and a single output");
+            }
+            if (map.GetNumSinkNodes() != 0)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, functionName + " can't use a map with sink nodes");
+            }
+
+            auto mapOutput = map.GetOutput(0);
+            if (!mapOutput.IsFullPortOutput())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, functionName + " requires a map whose output is a full port");
+            }
+            return mapOutput.GetRanges()[0].ReferencedPort();
+        }
+
+        // Chooses the stage boundaries (indices into the node list) that minimize the cost of the most expensive stage
+        std::vector<size_t> GetBalancedBoundaries(const std::vector<double>& prefixCost, const std::vector<const OutputPortBase*>& cutPorts, const std::unordered_map<const OutputPortBase*, size_t>& producers, size_t numStages)
+        {
+            auto numNodes = prefixCost.size() - 1;
+            std::vector<size_t> candidates = { 0 };
+            for (size_t cut = 1; cut < numNodes; ++cut)
+            {
+                if (cutPorts[cut] != nullptr)
+                {
+                    candidates.push_back(cut);
+                }
+            }
+            candidates.push_back(numNodes);
+
+            // A stage must compute the port it sends to the next stage, rather than passing its own input along
+            auto isValidStage = [&](size_t begin, size_t end) {
+                return end == numNodes || producers.at(cutPorts[end]) >= begin;
+            };
+
+            const auto infinity = std::numeric_limits<double>::infinity();
+            auto numCandidates = candidates.size();
+            for (auto stages = std::min(numStages, numCandidates - 1); stages > 1; --stages)
+            {
+                // cost[k][j]: the smallest maximum stage cost of splitting the nodes before candidates[j] into k stages
+                std::vector<std::vector<double>> cost(stages + 1, std::vector<double>(numCandidates, infinity));
+                std::vector<std::vector<size_t>> previous(stages + 1, std::vector<size_t>(numCandidates, 0));
+                cost[0][0] = 0;
+                for (size_t k = 1; k <= stages; ++k)
+                {
+                    for (size_t j = 1; j < numCandidates; ++j)
+                    {
+                        for (size_t i = 0; i < j; ++i)
+                        {
+                            if (cost[k - 1][i] == infinity || !isValidStage(candidates[i], candidates[j]))
+                            {
+                                continue;
+                            }
+
+                            auto stageCost = std::max(cost[k - 1][i], prefixCost[candidates[j]] - prefixCost[candidates[i]]);
+                            if (stageCost < cost[k][j])
+                            {
+                                cost[k][j] = stageCost;
+                                previous[k][j] = i;
+                            }
+                        }
+                    }
+                }
+
+                if (cost[stages][numCandidates - 1] != infinity)
+                {
+                    std::vector<size_t> boundaries(stages + 1);
+                    auto j = numCandidates - 1;
+                    for (auto k = stages; k > 0; --k)
+                    {
+                        boundaries[k] = candidates[j];
+                        j = previous[k][j];
+                    }
+                    boundaries[0] = 0;
+                    return boundaries;
+                }
+            }
+            return { 0, numNodes };
+        }
+    } // namespace
+
+    double GetPipelineNodeCost(const Node& node, const ModelProfileData* profileData)
+    {
+        if (profileData != nullptr)
+        {
+            auto id = node.GetId().ToString();
+            for (const auto& nodeData : profileData->GetNodes())
+            {
+                if (nodeData.nodeId == id)
+                {
+                    return nodeData.count > 0 ? nodeData.totalTime / nodeData.count : 0.0;
+                }
+            }
+            return 0.0;
+        }
+
+        if (node.NumInputPorts() == 0)
+        {
+            return 0.0;
+        }
+
+        size_t size = 0;
+        for (auto input : node.GetInputPorts())
+        {
+            size += input->Size();
+        }
+        for (auto output : node.GetOutputPorts())
+        {
+            size += output->Size();
+        }
+        return static_cast<double>(size);
+    }
+
+    std::vector<Map> SplitMapIntoStages(const Map& map, size_t numStages, const ModelProfileData* profileData)
+    {
+        auto outputPort = GetSingleOutputPort(map, "SplitMapIntoStages");
+        if (numStages == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SplitMapIntoStages needs at least one stage");
+        }
+
+        const auto& model = map.GetModel();
+
+        std::vector<const Node*> nodes;
+        model.VisitSubmodel(std::vector<const OutputPortBase*>{ outputPort }, [&nodes](const Node& node) {
+            if (!IsFreeNode(node))
+            {
+                nodes.push_back(&node);
+            }
+        });
+
+        // For each port, the index of the node that computes it, and of the last node that reads it
+        auto numNodes = nodes.size();
+        std::unordered_map<const OutputPortBase*, size_t> producers;
+        std::unordered_map<const OutputPortBase*, size_t> lastUses;
+        std::vector<double> prefixCost = { 0.0 };
+        for (size_t index = 0; index < numNodes; ++index)
+        {
+            for (auto output : nodes[index]->GetOutputPorts())
+            {
+                producers[output] = index;
+            }
+            for (auto input : nodes[index]->GetInputPorts())
+            {
+                const auto& referencedPort = input->GetReferencedPort();
+                if (!IsFreeNode(*referencedPort.GetNode()))
+                {
+                    lastUses[&referencedPort] = index;
+                }
+            }
+            prefixCost.push_back(prefixCost.back() + GetPipelineNodeCost(*nodes[index], profileData));
+        }
+        lastUses[outputPort] = numNodes;
+
+        // The map can be cut in front of a node if a single port computed before it is read after it
+        std::vector<const OutputPortBase*> cutPorts(numNodes, nullptr);
+        for (size_t cut = 1; cut < numNodes; ++cut)
+        {
+            const OutputPortBase* cutPort = nullptr;
+            size_t numCrossingPorts = 0;
+            for (const auto& use : lastUses)
+            {
+                auto producer = producers[use.first];
+                if (producer < cut && use.second >= cut)
+                {
+                    cutPort = use.first;
+                    ++numCrossingPorts;
+                }
+            }
+
+            if (numCrossingPorts == 1 && lastUses[cutPort] < numNodes && dynamic_cast<const InputNodeBase*>(cutPort->GetNode()) == nullptr)
+            {
+                cutPorts[cut] = cutPort;
+            }
+        }
+
+        auto boundaries = GetBalancedBoundaries(prefixCost, cutPorts, producers, numStages);
+
+        std::vector<Map> stages;
+        const OutputPortBase* stageInput = nullptr;
+        for (size_t stage = 0; stage + 1 < boundaries.size(); ++stage)
+        {
+            auto end = boundaries[stage + 1];
+            auto stageOutput = end == numNodes ? outputPort : cutPorts[end];
+
+            Model stageModel;
+            ModelTransformer transformer;
+            TransformContext context;
+            InputNodeBase* inputNode = nullptr;
+            if (stageInput == nullptr)
+            {
+                Submodel submodel(model, { stageOutput });
+                transformer.CopySubmodelOnto(submodel, stageModel, {}, context);
+                inputNode = transformer.GetCorrespondingInputNode(map.GetInput(0));
+            }
+            else
+            {
+                inputNode = AddInputNode(stageModel, *stageInput);
+                std::vector<const InputPortBase*> submodelInputs;
+                std::unordered_set<const Node*> visitedNodes;
+                GetStageInputs(*stageOutput, *stageInput, visitedNodes, submodelInputs);
+
+                Submodel submodel(model, submodelInputs, { stageOutput });
+                std::vector<const OutputPortBase*> onto(submodelInputs.size(), &inputNode->GetOutputPort());
+                transformer.CopySubmodelOnto(submodel, stageModel, onto, context);
+            }
+
+            const auto& newOutput = transformer.GetCorrespondingOutputs(*stageOutput);
+            auto inputName = stage == 0 ? map.GetInputName(0) : "input";
+            auto outputName = end == numNodes ? map.GetOutputName(0) : "output";
+            stages.emplace_back(stageModel, std::vector<std::pair<std::string, InputNodeBase*>>{ { inputName, inputNode } }, std::vector<std::pair<std::string, PortElementsBase>>{ { outputName, PortElementsBase(newOutput) } });
+            stageInput = stageOutput;
+        }
+        return stages;
+    }
+
+    Map ChainMaps(const Map& first, const Map& second)
+    {
+        auto firstOutput = GetSingleOutputPort(first, "ChainMaps");
+        auto secondOutput = GetSingleOutputPort(second, "ChainMaps");
+
+        // Feed the second map from the value the first map's output node copies
+        if (auto outputNode = dynamic_cast<const OutputNodeBase*>(firstOutput->GetNode()))
+        {
+            firstOutput = &outputNode->GetInputPort(0)->GetReferencedPort();
+        }
+
+        const auto& secondInput = second.GetInput(0)->GetOutputPort();
+        if (firstOutput->GetType() != secondInput.GetType() || firstOutput->Size() != secondInput.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "ChainMaps requires the input of the second map to match the output of the first one");
+        }
+
+        Model model;
+        TransformContext context;
+        ModelTransformer firstTransformer;
+        firstTransformer.CopySubmodelOnto(Submodel(first.GetModel(), { firstOutput }), model, {}, context);
+        auto inputNode = firstTransformer.GetCorrespondingInputNode(first.GetInput(0));
+        const auto& joinedPort = firstTransformer.GetCorrespondingOutputs(*firstOutput);
+
+        const OutputPortBase* newOutput = &joinedPort;
+        if (secondOutput != &secondInput)
+        {
+            std::vector<const InputPortBase*> secondInputs;
+            std::unordered_set<const Node*> visitedNodes;
+            GetStageInputs(*secondOutput, secondInput, visitedNodes, secondInputs);
+
+            ModelTransformer secondTransformer;
+            std::vector<const OutputPortBase*> onto(secondInputs.size(), &joinedPort);
+            secondTransformer.CopySubmodelOnto(Submodel(second.GetModel(), secondInputs, { secondOutput }), model, onto, context);
+            newOutput = &secondTransformer.GetCorrespondingOutputs(*secondOutput);
+        }
+
+        return Map(model, { { first.GetInputName(0), inputNode } }, { { second.GetOutputName(0), PortElementsBase(*newOutput) } });
+    }
+
+    //
+    // MapPipeline
+    //
+    MapPipeline::MapPipeline(const std::vector<Map*>& stages, size_t queueSize) :
+        _stages(stages),
+        _stop(false)
+    {
+        if (stages.empty() || queueSize == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "MapPipeline needs at least one stage and a nonzero queue size");
+        }
+
+        for (auto stage : stages)
+        {
+            if (stage->NumInputs() != 1 || stage->NumOutputs() != 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The stages of a MapPipeline must have a single input and a single output");
+            }
+        }
+
+        for (size_t index = 0; index <= stages.size(); ++index)
+        {
+            _queues.push_back(std::make_unique<Queue>(queueSize));
+        }
+
+        for (size_t index = 0; index < stages.size(); ++index)
+        {
+            _threads.emplace_back(&MapPipeline::RunStage, this, index);
+        }
+    }
+
+    MapPipeline::~MapPipeline()
+    {
+        Stop();
+        for (auto& thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    void MapPipeline::Push(const std::vector<double>& input)
+    {
+        auto value = input;
+        while (!_queues.front()->TryPush(std::move(value)))
+        {
+            RethrowStageError();
+            std::this_thread::yield();
+        }
+    }
+
+    std::vector<double> MapPipeline::Pop()
+    {
+        std::vector<double> output;
+        while (!TryPop(output))
+        {
+            std::this_thread::yield();
+        }
+        return output;
+    }
+
+    bool MapPipeline::TryPop(std::vector<double>& output)
+    {
+        RethrowStageError();
+        return _queues.back()->TryPop(output);
+    }
+
+    void MapPipeline::RunStage(size_t index)
+    {
+        auto& stage = *_stages[index];
+        auto& inputQueue = *_queues[index];
+        auto& outputQueue = *_queues[index + 1];
+        std::vector<double> input;
+        try
+        {
+            while (!_stop)
+            {
+                if (!inputQueue.TryPop(input))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                stage.SetInputValue(0, data::DoubleDataVector(input));
+                auto output = stage.ComputeOutput<data::DoubleDataVector>(0).ToArray();
+                while (!outputQueue.TryPush(std::move(output)))
+                {
+                    if (_stop)
+                    {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(_errorMutex);
+            if (!_error)
+            {
+                _error = std::current_exception();
+            }
+            Stop();
+        }
+    }
+
+    void MapPipeline::Stop()
+    {
+        _stop = true;
+    }
+
+    void MapPipeline::RethrowStageError()
+    {
+        if (_stop)
+        {
+            std::lock_guard<std::mutex> lock(_errorMutex);
+            if (_error)
+            {
+                std::rethrow_exception(_error);
+            }
+        }
+    }
+} // namespace model
+} // namespace ell
@@ -122,7 +122,7 @@ namespace model
         }
         else
         {
-            return it->second.get();
+            return it->second;
         }
     }
 
@@ -135,7 +135,7 @@ namespace model
         }
         else
         {
-            return it->second.get();
+            return it->second;
         }
     }
 
@@ -262,13 +262,14 @@ namespace model
 
     Node* Model::AddExistingNode(std::unique_ptr<Node> node)
     {
-        std::shared_ptr<Node> sharedNode(std::move(node));
-        EnsureNodeHasUniqueId(*sharedNode);
-        sharedNode->SetModel(this);
-        sharedNode->UpdateInputPorts();
-        VerifyInputs(*sharedNode);
-        _data->idToNodeMap[sharedNode->GetId()] = sharedNode;
-        return sharedNode.get();
+        EnsureNodeHasUniqueId(*node);
+        node->SetModel(this);
+        node->UpdateInputPorts();
+        VerifyInputs(*node);
+        node->_modelIndex = _data->nodes.size();
+        _data->idToNodeMap[node->GetId()] = node.get();
+        _data->nodes.push_back(std::move(node));
+        return _data->nodes.back().get();
     }
 
     void Model::EnsureNodeHasUniqueId(Node& node)
@@ -287,9 +288,9 @@ namespace model
 
     void Model::VerifyNodes() const
     {
-        for (auto it : _data->idToNodeMap)
+        for (const auto& node : _data->nodes)
         {
-            const Model* otherModel = it.second->GetModel();
+            const Model* otherModel = node->GetModel();
             if ((*otherModel) != (*this))
             {
                 throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Model input validation error: nodes come from a different model");
@@ -350,9 +351,9 @@ namespace model
         return Node::NodeId(utilities::Join(substrings, "_"));
     }
 
-    const Model::IDToNodeMap& Model::GetNodeMap() const
+    const Model::NodeArray& Model::GetNodeArray() const
     {
-        return _data->idToNodeMap;
+        return _data->nodes;
     }
 
     const OutputPortBase& Model::SimplifyOutputs(const PortElementsBase& elements)
@@ -473,7 +474,17 @@ namespace model
 
     void NodeIterator::SetNodeVisited(const Node* node)
     {
-        _visitedNodes.insert(node);
+        // nodes may be added to the model while it's being iterated over
+        if (node->_modelIndex >= _visitedNodes.size())
+        {
+            _visitedNodes.resize(std::max(_model->Size(), node->_modelIndex + 1));
+        }
+        _visitedNodes[node->_modelIndex] = true;
+    }
+
+    bool NodeIterator::IsNodeVisited(const Node* node) const
+    {
+        return node->_modelIndex < _visitedNodes.size() && _visitedNodes[node->_modelIndex];
     }
 
     void NodeIterator::SetSubmodelInputs(const std::vector<const InputPortBase*>& inputs)
@@ -503,12 +514,11 @@ namespace model
         if (ShouldAddAllValidOutputs())
         {
             // Add everything except inputs on submodelInputs list (and their inputs)
-            for (auto node : _model->GetNodeMap())
+            for (const auto& node : _model->GetNodeArray())
             {
-                const Node* nodePtr = node.second.get();
-                if (ShouldAddNodeToValidOutputs(nodePtr))
+                if (ShouldAddNodeToValidOutputs(node.get()))
                 {
-                    _nodesToVisit.push_back(nodePtr);
+                    _nodesToVisit.push_back(node.get());
                 }
             }
         }
@@ -578,7 +588,7 @@ namespace model
             const Node* node = _nodesToVisit.back();
 
             // check if we've already visited this node
-            if (_visitedNodes.find(node) != _visitedNodes.end())
+            if (IsNodeVisited(node))
             {
                 _nodesToVisit.pop_back();
                 continue;
@@ -593,7 +603,7 @@ namespace model
                 {
                     for (const auto& parentNode : inputPort->GetParentNodes())
                     {
-                        canVisit = canVisit && _visitedNodes.find(parentNode) != _visitedNodes.end();
+                        canVisit = canVisit && IsNodeVisited(parentNode);
                     }
                 }
             }
@@ -655,7 +665,7 @@ namespace model
             const Node* node = _nodesToVisit.back();
 
             // check if we've already visited this node
-            if (_visitedNodes.find(node) != _visitedNodes.end())
+            if (IsNodeVisited(node))
             {
                 _nodesToVisit.pop_back();
                 continue;
@@ -666,13 +676,13 @@ namespace model
             const auto children = node->GetDependentNodes();
             for (const auto& childNode : children)
             {
-                canVisit = canVisit && _visitedNodes.find(childNode) != _visitedNodes.end();
+                canVisit = canVisit && IsNodeVisited(childNode);
             }
 
             if (canVisit)
             {
                 _nodesToVisit.pop_back();
-                _visitedNodes.insert(node);
+                SetNodeVisited(node);
                 _currentNode = node;
                 break;
             }
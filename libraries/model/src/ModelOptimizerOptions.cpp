@@ -30,6 +30,8 @@ namespace model
             ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, simple);
             ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, winograd);
             ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, unrolled);
+            ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, depthwise);
+            ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, blocked);
         default:
             throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Unknown PreferredConvolutionMethod");
         };
@@ -83,6 +85,8 @@ namespace utilities
         ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, simple);
         ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, winograd);
         ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, unrolled);
+        ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, depthwise);
+        ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, blocked);
 
         throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Unknown PreferredConvolutionMethod");
     }
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ModelProfileData.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ModelProfileData.h"
+#include "IRCompiledMap.h"
+
+#include <utilities/include/Archiver.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/JsonArchiver.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace ell
+{
+namespace model
+{
+    //
+    // NodeProfileData
+    //
+    void NodeProfileData::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        archiver["nodeId"] << nodeId;
+        archiver["nodeType"] << nodeType;
+        archiver["count"] << count;
+        archiver["totalTime"] << totalTime;
+    }
+
+    void NodeProfileData::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        archiver["nodeId"] >> nodeId;
+        archiver["nodeType"] >> nodeType;
+        archiver["count"] >> count;
+        archiver["totalTime"] >> totalTime;
+    }
+
+    //
+    // ProfileGuidedOptions
+    //
+    ProfileGuidedOptions ProfileGuidedOptions::GetDefault()
+    {
+        ProfileGuidedOptions result;
+        result.hotNodeOptions["unrollLoops"] = true;
+        result.hotNodeOptions["allowVectorInstructions"] = true;
+        result.hotNodeOptions["parallelize"] = true;
+
+        result.coldNodeOptions["unrollLoops"] = false;
+        result.coldNodeOptions["allowVectorInstructions"] = false;
+        result.coldNodeOptions["parallelize"] = false;
+        result.coldNodeOptions["inlineOperators"] = false;
+        return result;
+    }
+
+    //
+    // ModelProfileData
+    //
+    ModelProfileData::ModelProfileData(IRCompiledMap& map)
+    {
+        auto numNodes = map.GetNumProfiledNodes();
+        for (int index = 0; index < numNodes; ++index)
+        {
+            auto info = map.GetNodeInfo(index);
+            auto stats = map.GetNodePerformanceCounters(index);
+
+            // Nodes created by refinement or optimization are charged to the node they came from
+            std::string nodeId = info->nodeAncestor != nullptr ? info->nodeAncestor : info->nodeName;
+            AddNodeTime(nodeId, info->nodeType, stats->count, stats->totalTime);
+        }
+    }
+
+    void ModelProfileData::AddNodeTime(const std::string& nodeId, const std::string& nodeType, int count, double totalTime)
+    {
+        auto iter = std::find_if(_nodes.begin(), _nodes.end(), [&nodeId](const NodeProfileData& node) { return node.nodeId == nodeId; });
+        if (iter == _nodes.end())
+        {
+            NodeProfileData node;
+            node.nodeId = nodeId;
+            node.nodeType = nodeType;
+            node.count = count;
+            node.totalTime = totalTime;
+            _nodes.push_back(node);
+        }
+        else
+        {
+            iter->count = std::max(iter->count, count);
+            iter->totalTime += totalTime;
+        }
+    }
+
+    double ModelProfileData::GetTotalTime() const
+    {
+        return std::accumulate(_nodes.begin(), _nodes.end(), 0.0, [](double sum, const NodeProfileData& node) { return sum + node.totalTime; });
+    }
+
+    utilities::PropertyBag ModelProfileData::GetCompilerOptions(const ProfileGuidedOptions& options) const
+    {
+        std::vector<const NodeProfileData*> nodesByTime;
+        for (const auto& node : _nodes)
+        {
+            nodesByTime.push_back(&node);
+        }
+        std::stable_sort(nodesByTime.begin(), nodesByTime.end(), [](auto a, auto b) { return a->totalTime > b->totalTime; });
+
+        // The hottest nodes, up to and including the one that crosses the threshold, are hot
+        const auto hotTime = options.hotTimeFraction * GetTotalTime();
+        double accumulatedTime = 0;
+        utilities::PropertyBag nodeOptions;
+        for (auto node : nodesByTime)
+        {
+            bool isHot = node->totalTime > 0 && accumulatedTime < hotTime;
+            accumulatedTime += node->totalTime;
+            nodeOptions.SetEntry(node->nodeId, isHot ? options.hotNodeOptions : options.coldNodeOptions);
+        }
+
+        utilities::PropertyBag result;
+        result.SetEntry("nodes", nodeOptions);
+        return result;
+    }
+
+    void ModelProfileData::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        archiver["nodes"] << _nodes;
+    }
+
+    void ModelProfileData::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        archiver["nodes"] >> _nodes;
+    }
+
+    //
+    // Loading and saving
+    //
+    ModelProfileData LoadModelProfileData(const std::string& filename)
+    {
+        if (!utilities::IsFileReadable(filename))
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound);
+        }
+
+        auto filestream = utilities::OpenIfstream(filename);
+        return LoadModelProfileData(filestream);
+    }
+
+    ModelProfileData LoadModelProfileData(std::istream& stream)
+    {
+        utilities::SerializationContext context;
+        utilities::JsonUnarchiver unarchiver(stream, context);
+        ModelProfileData profileData;
+        unarchiver.Unarchive(profileData);
+        return profileData;
+    }
+
+    void SaveModelProfileData(const ModelProfileData& profileData, const std::string& filename)
+    {
+        if (!utilities::IsFileWritable(filename))
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable);
+        }
+
+        auto filestream = utilities::OpenOfstream(filename);
+        SaveModelProfileData(profileData, filestream);
+    }
+
+    void SaveModelProfileData(const ModelProfileData& profileData, std::ostream& stream)
+    {
+        utilities::JsonArchiver archiver(stream);
+        archiver.Archive(profileData);
+    }
+} // namespace model
+} // namespace ell
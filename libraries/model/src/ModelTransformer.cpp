@@ -175,6 +175,11 @@ namespace model
         _outputPortMap[oldPort] = newPort;
     }
 
+    void ModelTransformer::PortOutputsMap::UnmapNodeOutput(const OutputPortBase* oldPort)
+    {
+        _outputPortMap.erase(oldPort);
+    }
+
     ModelTransformer::PortOutputsMap ModelTransformer::PortOutputsMap::ConcatenateMaps(const PortOutputsMap& prevMap, const PortOutputsMap& newMap, bool isInPlace)
     {
         PortOutputsMap result;
@@ -184,6 +189,15 @@ namespace model
             result.MapNodeOutput(entry.first, &newMappedValue);
         }
 
+        // In place, the intermediate ports are still part of the model, so keep their mappings too
+        if (isInPlace)
+        {
+            for (const auto& entry : newMap._outputPortMap)
+            {
+                result._outputPortMap.insert(entry);
+            }
+        }
+
         return result;
     }
 
@@ -222,7 +236,7 @@ namespace model
 
     Submodel ModelTransformer::CopySubmodelOnto(const Submodel& submodel, Model& destModel, const std::vector<const OutputPortBase*>& onto, const TransformContext& context)
     {
-        auto result = TransformSubmodelOnto(submodel, destModel, {}, context, [](const Node& node, ModelTransformer& transformer) {
+        auto result = TransformSubmodelOnto(submodel, destModel, onto, context, [](const Node& node, ModelTransformer& transformer) {
             transformer.CopyNode(node);
         });
 
@@ -330,8 +344,9 @@ namespace model
         std::vector<const InputPortBase*> sourceInputs = submodel.GetInputs();
         MapCorrespondingInputs(sourceInputs, onto);
         submodel.GetModel().VisitSubmodel(sourceInputs, submodel.GetOutputs(), [this, transformFunction](const Node& node) {
+            auto firstNewNodeIndex = _model.Size();
             transformFunction(node, *this);
-            AssignNodeAncestor(node);
+            AssignNodeAncestor(node, firstNewNodeIndex);
         });
 
         if (!previousElementMap.IsEmpty())
@@ -509,14 +524,35 @@ namespace model
         }
     }
 
+    bool ModelTransformer::BatchNode(const Node& node, BatchContext& batch)
+    {
+        return node.Batch(*this, batch);
+    }
+
     bool ModelTransformer::RefineNode(const Node& node)
     {
         // If the node action is "refine" or the default, try to refine the node, otherwise leave it alone
         auto action = GetContext().GetNodeAction(node);
         if (action == NodeAction::refine || action == NodeAction::abstain)
         {
+            // When refining in place, a compilable node whose inputs didn't change is already in its final form
+            auto isUnchanged = !ShouldCopyNode(node);
+            if (isUnchanged && action == NodeAction::abstain && GetContext().IsNodeCompilable(node))
+            {
+                return false;
+            }
+
+            auto firstNewNodeIndex = _model.Size();
             auto didRefineNode = node.Refine(*this);
-            AssignNodeAncestor(node);
+            if (isUnchanged && !didRefineNode)
+            {
+                // The node just copied itself, so keep using the original and don't make its dependents copy themselves too
+                for (auto output : node.GetOutputPorts())
+                {
+                    _elementsMap.UnmapNodeOutput(output);
+                }
+            }
+            AssignNodeAncestor(node, firstNewNodeIndex);
             return didRefineNode;
         }
         else
@@ -527,28 +563,25 @@ namespace model
         return false;
     }
 
-    void ModelTransformer::AssignNodeAncestor(const Node& ancestorNode)
+    void ModelTransformer::AssignNodeAncestor(const Node& ancestorNode, size_t firstNewNodeIndex)
     {
-        auto iter = _model.GetReverseNodeIterator();
-        while (iter.IsValid())
+        const auto& nodes = _model.GetNodeArray();
+        for (auto index = firstNewNodeIndex; index < nodes.size(); ++index)
         {
-            auto node = const_cast<Node*>(iter.Get());
+            auto& node = nodes[index];
             if (node->GetMetadata().HasEntry("ancestor"))
             {
-                break;
+                continue;
+            }
+
+            if (ancestorNode.GetMetadata().HasEntry("ancestor"))
+            {
+                node->GetMetadata().SetEntry("ancestor", ancestorNode.GetMetadata().GetEntry<std::string>("ancestor"));
             }
             else
             {
-                if (ancestorNode.GetMetadata().HasEntry("ancestor"))
-                {
-                    node->GetMetadata().SetEntry("ancestor", ancestorNode.GetMetadata().GetEntry<std::string>("ancestor"));
-                }
-                else
-                {
-                    node->GetMetadata().SetEntry("ancestor", ancestorNode.GetId().ToString());
-                }
+                node->GetMetadata().SetEntry("ancestor", ancestorNode.GetId().ToString());
             }
-            iter.Next();
         }
     }
 } // namespace model
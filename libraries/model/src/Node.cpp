@@ -13,6 +13,7 @@
 #include "OutputPort.h"
 
 #include <utilities/include/IArchivable.h>
+#include <utilities/include/Unused.h>
 
 #include <unordered_set>
 
@@ -188,6 +189,13 @@ namespace model
         return false;
     }
 
+    // Default implementation of Batch leaves it to the transformer to copy the node once per sample
+    bool Node::Batch(ModelTransformer& transformer, BatchContext& batch) const
+    {
+        UNUSED(transformer, batch);
+        return false;
+    }
+
     void Node::Print(std::ostream& os) const
     {
         bool isFirstInputPort = true;
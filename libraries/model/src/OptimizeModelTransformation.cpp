@@ -7,19 +7,55 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "OptimizeModelTransformation.h"
+#include "MapCompiler.h"
 #include "TransformationRegistry.h"
 
+#include <model/optimizer/include/Environment.h>
+#include <model/optimizer/include/GlobalOptimizerOptions.h>
+#include <model/optimizer/include/MeasuredCostModel.h>
+#include <model/optimizer/include/SequentialOptimizer.h>
+
+#include <utilities/include/Logger.h>
+
 namespace ell
 {
 namespace model
 {
+    using namespace utilities::logging;
+
     Submodel OptimizeModelTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
     {
         Submodel result = submodel;
         const auto& registry = TransformationRegistry::GetGlobalRegistry();
 
+        auto compiler = context.GetCompiler();
+        if (compiler)
+        {
+            auto optimizerOptions = compiler->GetModelOptimizerOptions(submodel.GetModel());
+            if (!optimizerOptions.GetEntry<bool>("optimizeModel", true))
+            {
+                return result;
+            }
+
+            // Search for the set of transformations that minimizes the measured runtime
+            if (optimizerOptions.GetEntry<bool>("searchTransformations", false))
+            {
+                auto settings = compiler->GetMapCompilerOptions(submodel.GetModel());
+                optimizer::SequentialOptimizer searchOptimizer(optimizer::MeasuredCostModel(settings), optimizer::RuntimeObjective{});
+                for (const auto& transformation : registry)
+                {
+                    searchOptimizer.AddTransformation(*transformation);
+                }
+
+                Log() << "Searching for the fastest set of model transformations..." << EOL;
+                optimizer::Environment environment(settings.compilerSettings.targetDevice);
+                return searchOptimizer.Optimize(result, transformer, context, environment, optimizer::OptimizerOptions{});
+            }
+        }
+
         for (const auto& transformation : registry)
         {
+            auto phase = compiler ? compiler->GetCompileTimingReport().BeginPhase(transformation->GetRuntimeTypeName()) : CompileTimingReport::Phase();
             result = transformation->Transform(result, transformer, context);
         }
         return result;
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "OutputPort.h"
+#include "ExecutionContext.h"
 #include "InputPort.h"
 
 #include <utilities/include/Exception.h>
@@ -40,7 +41,8 @@ namespace model
 
     std::vector<double> OutputPortBase::GetDoubleOutput() const
     {
-        if (auto doubleVector = std::get_if<std::vector<double>>(&_cachedOutput); doubleVector != nullptr)
+        const auto& cachedOutput = GetCachedOutput();
+        if (auto doubleVector = std::get_if<std::vector<double>>(&cachedOutput); doubleVector != nullptr)
         {
             return *doubleVector;
         }
@@ -50,13 +52,14 @@ namespace model
                 [](auto&& value) -> std::vector<double> {
                     return std::vector<double>(value.begin(), value.end());
                 },
-                _cachedOutput);
+                cachedOutput);
         }
     }
 
     double OutputPortBase::GetDoubleOutput(size_t index) const
     {
-        if (auto doubleVector = std::get_if<std::vector<double>>(&_cachedOutput); doubleVector != nullptr)
+        const auto& cachedOutput = GetCachedOutput();
+        if (auto doubleVector = std::get_if<std::vector<double>>(&cachedOutput); doubleVector != nullptr)
         {
             return (*doubleVector)[index];
         }
@@ -66,7 +69,7 @@ namespace model
                 [index](auto&& value) -> double {
                     return static_cast<double>(value[index]);
                 },
-                _cachedOutput);
+                cachedOutput);
         }
     }
 
@@ -141,24 +144,24 @@ namespace model
     }
 
     void OutputPortBase::InitializeCachedOutput()
+    {
+        _cachedOutput = MakeEmptyOutput();
+    }
+
+    OutputPortBase::CachedOutput OutputPortBase::MakeEmptyOutput() const
     {
         switch (GetType())
         {
         case PortType::bigInt:
-            _cachedOutput = std::vector<int64_t>{};
-            break;
+            return std::vector<int64_t>{};
         case PortType::boolean:
-            _cachedOutput = std::vector<bool>{};
-            break;
+            return std::vector<bool>{};
         case PortType::integer:
-            _cachedOutput = std::vector<int32_t>{};
-            break;
+            return std::vector<int32_t>{};
         case PortType::real:
-            _cachedOutput = std::vector<double>{};
-            break;
+            return std::vector<double>{};
         case PortType::smallReal:
-            _cachedOutput = std::vector<float>{};
-            break;
+            return std::vector<float>{};
         case PortType::categorical:
             [[fallthrough]];
         case PortType::none:
@@ -168,6 +171,15 @@ namespace model
         }
     }
 
+    OutputPortBase::CachedOutput& OutputPortBase::GetCachedOutput() const
+    {
+        if (auto context = ExecutionContext::GetCurrent(); context != nullptr)
+        {
+            return context->GetOutput(*this);
+        }
+        return _cachedOutput;
+    }
+
     static_assert(sizeof(OutputPortBase) == sizeof(OutputPort<double>), "OutputPort<T> must have the same layout as OutputPortBase");
 } // namespace model
 } // namespace ell
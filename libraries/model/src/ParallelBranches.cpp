@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelBranches.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ParallelBranches.h"
+#include "Node.h"
+
+#include <set>
+#include <unordered_map>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        constexpr int c_tailBranch = -1;
+    }
+
+    ParallelBranchOrder GetParallelBranchOrder(const std::vector<const Node*>& nodes)
+    {
+        ParallelBranchOrder result;
+        std::unordered_map<const Node*, int> nodeBranches; // the branch of each node that isn't a source, or `c_tailBranch`
+        for (auto node : nodes)
+        {
+            auto parents = node->GetParentNodes();
+            if (parents.empty())
+            {
+                result.sources.push_back(node);
+                continue;
+            }
+
+            std::set<int> parentBranches;
+            for (auto parent : parents)
+            {
+                auto it = nodeBranches.find(parent);
+                if (it != nodeBranches.end())
+                {
+                    parentBranches.insert(it->second);
+                }
+            }
+
+            if (parentBranches.empty())
+            {
+                nodeBranches[node] = static_cast<int>(result.branches.size());
+                result.branches.push_back({ node });
+            }
+            else if (parentBranches.size() == 1 && *parentBranches.begin() != c_tailBranch)
+            {
+                auto branch = *parentBranches.begin();
+                nodeBranches[node] = branch;
+                result.branches[branch].push_back(node);
+            }
+            else
+            {
+                nodeBranches[node] = c_tailBranch;
+                result.tail.push_back(node);
+            }
+        }
+        return result;
+    }
+} // namespace model
+} // namespace ell
@@ -147,5 +147,25 @@ namespace model
             return "Unknown";
         };
     }
+
+    size_t GetPortElementSize(ell::model::Port::PortType type)
+    {
+        switch (type)
+        {
+        case ell::model::Port::PortType::smallReal:
+            return sizeof(float);
+        case ell::model::Port::PortType::real:
+            return sizeof(double);
+        case ell::model::Port::PortType::integer:
+        case ell::model::Port::PortType::categorical:
+            return sizeof(int);
+        case ell::model::Port::PortType::bigInt:
+            return sizeof(int64_t);
+        case ell::model::Port::PortType::boolean:
+            return sizeof(bool);
+        default:
+            return 0;
+        };
+    }
 } // namespace model
 } // namespace ell
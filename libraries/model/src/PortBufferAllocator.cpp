@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PortBufferAllocator.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PortBufferAllocator.h"
+#include "InputPort.h"
+#include "Model.h"
+#include "Node.h"
+#include "OutputPort.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        std::vector<const Node*> GetVisitOrder(const Model& model)
+        {
+            std::vector<const Node*> nodes;
+            model.Visit([&nodes](const Node& node) { nodes.push_back(&node); });
+            return nodes;
+        }
+    } // namespace
+
+    PortBufferAllocator::PortBufferAllocator(const Model& model) :
+        PortBufferAllocator(GetVisitOrder(model))
+    {
+    }
+
+    PortBufferAllocator::PortBufferAllocator(const std::vector<const Node*>& nodes)
+    {
+        int index = 0;
+        for (auto node : nodes)
+        {
+            _nodeIndices[node] = index;
+
+            // An output port is live at least until its own node has been compiled
+            for (const auto* output : node->GetOutputPorts())
+            {
+                _lastUses[output] = index;
+            }
+
+            for (const auto* input : node->GetInputPorts())
+            {
+                const auto* referencedPort = &input->GetReferencedPort();
+                _lastUses[referencedPort] = std::max(_lastUses[referencedPort], index);
+            }
+            ++index;
+        }
+    }
+
+    bool PortBufferAllocator::CanShareBuffer(const OutputPortBase& port) const
+    {
+        if (_lastUses.find(&port) == _lastUses.end() || port.Size() == 0)
+        {
+            return false;
+        }
+
+        // Padded ports rely on the contents of their padding area, so they keep their own buffer
+        return !port.GetMemoryLayout().HasPadding();
+    }
+
+    size_t PortBufferAllocator::AllocateBuffer(const OutputPortBase& port)
+    {
+        if (!CanShareBuffer(port))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port can't be assigned a shared buffer");
+        }
+
+        auto type = port.GetType();
+        auto size = port.Size();
+        auto lastUse = GetLastUse(port);
+
+        // Find the smallest free buffer the port fits into
+        auto bestFit = _buffers.end();
+        for (auto it = _buffers.begin(); it != _buffers.end(); ++it)
+        {
+            if (it->isFree && it->type == type && it->size >= size && (bestFit == _buffers.end() || it->size < bestFit->size))
+            {
+                bestFit = it;
+            }
+        }
+
+        ++_numAllocatedPorts;
+        if (bestFit != _buffers.end())
+        {
+            bestFit->isFree = false;
+            bestFit->lastUse = lastUse;
+            return static_cast<size_t>(bestFit - _buffers.begin());
+        }
+
+        _buffers.push_back({ type, size, lastUse, false });
+        return _buffers.size() - 1;
+    }
+
+    void PortBufferAllocator::AddPortToBuffer(size_t bufferIndex, const Port& port)
+    {
+        auto& buffer = _buffers.at(bufferIndex);
+        buffer.lastUse = std::max(buffer.lastUse, GetLastUse(port));
+    }
+
+    void PortBufferAllocator::ReleaseBuffers(const Node& node)
+    {
+        auto it = _nodeIndices.find(&node);
+        if (it == _nodeIndices.end())
+        {
+            return;
+        }
+
+        for (auto& buffer : _buffers)
+        {
+            if (!buffer.isFree && buffer.lastUse <= it->second)
+            {
+                buffer.isFree = true;
+            }
+        }
+    }
+
+    size_t PortBufferAllocator::GetBufferSize(size_t bufferIndex) const
+    {
+        return _buffers.at(bufferIndex).size;
+    }
+
+    Port::PortType PortBufferAllocator::GetBufferType(size_t bufferIndex) const
+    {
+        return _buffers.at(bufferIndex).type;
+    }
+
+    size_t PortBufferAllocator::GetTotalBufferSize() const
+    {
+        size_t result = 0;
+        for (const auto& buffer : _buffers)
+        {
+            result += buffer.size;
+        }
+        return result;
+    }
+
+    size_t PortBufferAllocator::GetLiveBufferBytes() const
+    {
+        size_t result = 0;
+        for (const auto& buffer : _buffers)
+        {
+            if (!buffer.isFree)
+            {
+                result += buffer.size * GetPortElementSize(buffer.type);
+            }
+        }
+        return result;
+    }
+
+    int PortBufferAllocator::GetLastUse(const Port& port) const
+    {
+        auto it = _lastUses.find(&port);
+        if (it == _lastUses.end())
+        {
+            return -1;
+        }
+        return it->second;
+    }
+} // namespace model
+} // namespace ell
@@ -45,5 +45,32 @@ namespace model
         }
         return result;
     }
+
+    PortMemoryLayout GetChannelBlockedLayout(const PortMemoryLayout& layout, int channelBlockSize)
+    {
+        if (layout.NumDimensions() != 3 || !layout.IsCanonicalOrder())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Only (row, column, channel) layouts can be channel-blocked");
+        }
+        if (layout.GetOffset(2) != 0 || layout.GetExtent(2) != layout.GetActiveSize(2))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Can't channel-block a layout with padded channels");
+        }
+        if (channelBlockSize < 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Channel block size must be positive");
+        }
+
+        const int numBlocks = (layout.GetActiveSize(2) - 1) / channelBlockSize + 1;
+        MemoryShape size = { numBlocks, layout.GetActiveSize(0), layout.GetActiveSize(1), channelBlockSize };
+        MemoryShape extent = { numBlocks, layout.GetExtent(0), layout.GetExtent(1), channelBlockSize };
+        MemoryShape offset = { 0, layout.GetOffset(0), layout.GetOffset(1), 0 };
+        return { size, extent, offset, DimensionOrder{ 2, 0, 1, 3 } };
+    }
+
+    bool IsChannelBlockedLayout(const PortMemoryLayout& layout)
+    {
+        return layout.NumDimensions() == 4 && layout.GetLogicalDimensionOrder() == DimensionOrder{ 2, 0, 1, 3 } && layout.GetOffset(3) == 0 && layout.GetExtent(3) == layout.GetActiveSize(3);
+    }
 } // namespace model
 } // namespace ell
@@ -18,18 +18,29 @@ namespace model
 {
     namespace
     {
-        bool IsModelCompilable(const Model& model, const TransformContext& context)
+        bool IsSubmodelCompilable(const Submodel& submodel, const TransformContext& context)
         {
-            auto iter = model.GetNodeIterator();
-            while (iter.IsValid())
-            {
-                if (!context.IsNodeCompilable(*iter.Get()))
+            bool isCompilable = true;
+            submodel.Visit([&isCompilable, &context](const Node& node) {
+                isCompilable = isCompilable && context.IsNodeCompilable(node);
+            });
+            return isCompilable;
+        }
+
+        // Gets the outputs of the nodes nothing depends on, which together reach every node in the model. Returns
+        // false if one of those nodes has no outputs, in which case the model can't be described by its outputs.
+        bool TryGetSinkOutputs(const Model& model, std::vector<const OutputPortBase*>& outputs)
+        {
+            bool hasOutputs = true;
+            model.Visit([&outputs, &hasOutputs](const Node& node) {
+                if (node.GetDependentNodes().empty())
                 {
-                    return false;
+                    const auto& nodeOutputs = node.GetOutputPorts();
+                    hasOutputs = hasOutputs && !nodeOutputs.empty();
+                    outputs.insert(outputs.end(), nodeOutputs.begin(), nodeOutputs.end());
                 }
-                iter.Next();
-            }
-            return true;
+            });
+            return hasOutputs;
         }
     } // namespace
 
@@ -40,29 +51,64 @@ namespace model
 
     Submodel RefineTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
     {
+        if (_maxIterations <= 0)
+        {
+            return submodel;
+        }
+
         bool didRefineAny = false;
         auto refineFunction = [&didRefineAny](const Node& node, ModelTransformer& transformer) {
             bool didRefineNode = transformer.RefineNode(node);
             didRefineAny |= didRefineNode;
         };
 
-        Submodel newSubmodel = submodel;
-        for (int i = 0; i < _maxIterations; ++i)
+        // The first pass refines the submodel onto a new model
+        Model newModel;
+        newModel.GetMetadata() = submodel.GetModel().GetMetadata();
+        auto newSubmodel = transformer.TransformSubmodelOnto(submodel, newModel, {}, context, refineFunction);
+        if (!didRefineAny || _maxIterations == 1 || IsSubmodelCompilable(newSubmodel, context))
         {
-            didRefineAny = false;
-            auto currentSubmodel = std::move(newSubmodel);
-            Model newModel;
-            newModel.GetMetadata() = currentSubmodel.GetModel().GetMetadata();
-            newSubmodel = transformer.TransformSubmodelOnto(currentSubmodel, newModel, {}, context, refineFunction);
+            return newSubmodel;
+        }
+
+        // The remaining passes refine the new model in place, which only rewrites the nodes that still refine and
+        // the nodes downstream of them, instead of copying the whole model every time. The nodes they replace are
+        // left behind, unreachable from the outputs, so the live part of the model is copied out at the end.
+        auto outputs = newSubmodel.GetOutputs();
+        bool canRefineInPlace = !outputs.empty() || TryGetSinkOutputs(newModel, outputs);
+        if (canRefineInPlace)
+        {
+            newSubmodel = Submodel{ newModel, outputs };
+        }
 
-            // check for early end condition
-            if (!didRefineAny || IsModelCompilable(newModel, context))
+        for (int i = 1; i < _maxIterations; ++i)
+        {
+            didRefineAny = false;
+            Model destModel = canRefineInPlace ? newModel.ShallowCopy() : Model{};
+            if (!canRefineInPlace)
+            {
+                destModel.GetMetadata() = newModel.GetMetadata();
+            }
+            newSubmodel = transformer.TransformSubmodelOnto(newSubmodel, destModel, {}, context, refineFunction);
+            if (!didRefineAny || IsSubmodelCompilable(newSubmodel, context))
             {
                 break;
             }
         }
 
-        return newSubmodel;
+        if (!canRefineInPlace)
+        {
+            return newSubmodel;
+        }
+
+        Model compactModel;
+        compactModel.GetMetadata() = newModel.GetMetadata();
+        auto result = transformer.CopySubmodelOnto(newSubmodel, compactModel, {}, context);
+        if (submodel.GetOutputs().empty())
+        {
+            return { compactModel };
+        }
+        return result;
     }
 
 } // namespace model
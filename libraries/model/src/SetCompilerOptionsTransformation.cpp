@@ -11,6 +11,9 @@
 #include <utilities/include/Exception.h>
 #include <utilities/include/StlVectorUtil.h>
 
+#include <algorithm>
+#include <regex>
+
 namespace ell
 {
 namespace model
@@ -22,13 +25,119 @@ namespace model
             return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
         }
 
-        void CopyAndSetOptionsMetadata(const Node& node, ModelTransformer& transformer, const utilities::PropertyBag& nodeOptions)
+        size_t GetTotalOutputSize(const Node& node)
+        {
+            size_t result = 0;
+            for (auto output : node.GetOutputPorts())
+            {
+                result += output->Size();
+            }
+            return result;
+        }
+
+        void AppendOptions(const utilities::PropertyBag& source, utilities::PropertyBag& dest)
+        {
+            for (const auto& key : source.Keys())
+            {
+                dest[key] = source.GetEntry(key);
+            }
+        }
+
+        bool MatchesPattern(const std::string& str, const std::string& pattern)
+        {
+            try
+            {
+                return std::regex_match(str, std::regex(pattern));
+            }
+            catch (const std::regex_error&)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Invalid node pattern in compiler options rule: " + pattern);
+            }
+        }
+
+        bool RuleMatchesNode(const utilities::PropertyBag& rule, const Node& node)
+        {
+            if (rule.HasEntry("nodeType") && !MatchesPattern(node.GetRuntimeTypeName(), rule.GetEntry<std::string>("nodeType")))
+            {
+                return false;
+            }
+
+            if (rule.HasEntry("name"))
+            {
+                auto name = node.GetFriendlyName();
+                if (name.empty())
+                {
+                    name = node.GetId().ToString();
+                }
+
+                if (!MatchesPattern(name, rule.GetEntry<std::string>("name")))
+                {
+                    return false;
+                }
+            }
+
+            auto outputSize = static_cast<int>(GetTotalOutputSize(node));
+            if (rule.HasEntry("minOutputSize") && outputSize < rule.GetOrParseEntry<int>("minOutputSize"))
+            {
+                return false;
+            }
+            if (rule.HasEntry("maxOutputSize") && outputSize > rule.GetOrParseEntry<int>("maxOutputSize"))
+            {
+                return false;
+            }
+            return true;
+        }
+
+        utilities::PropertyBag GetNodeOptions(const Node& node, const utilities::PropertyBag& options)
+        {
+            utilities::PropertyBag result;
+            if (options.HasEntry("parallelizeMinOutputSize"))
+            {
+                auto threshold = options.GetOrParseEntry<int>("parallelizeMinOutputSize");
+                if (static_cast<int>(GetTotalOutputSize(node)) < threshold)
+                {
+                    result["parallelize"] = false;
+                }
+            }
+
+            if (options.HasEntry("rules"))
+            {
+                const auto& rules = options.GetEntry<utilities::PropertyBag>("rules");
+                auto ruleNames = rules.Keys();
+                std::sort(ruleNames.begin(), ruleNames.end());
+                for (const auto& ruleName : ruleNames)
+                {
+                    const auto& rule = rules.GetEntry<utilities::PropertyBag>(ruleName);
+                    if (RuleMatchesNode(rule, node))
+                    {
+                        AppendOptions(rule.GetEntry<utilities::PropertyBag>("options", {}), result);
+                    }
+                }
+            }
+
+            if (options.HasEntry("nodes"))
+            {
+                auto idStr = node.GetId().ToString();
+                const auto& nodeOptions = options.GetEntry<utilities::PropertyBag>("nodes");
+                if (nodeOptions.HasEntry(idStr))
+                {
+                    AppendOptions(nodeOptions.GetEntry<utilities::PropertyBag>(idStr), result);
+                }
+            }
+            return result;
+        }
+
+        void CopyAndSetOptionsMetadata(const Node& node, ModelTransformer& transformer, const utilities::PropertyBag& options)
         {
-            auto idStr = node.GetId().ToString();
-            if (nodeOptions.HasEntry(idStr))
+            auto newOptions = GetNodeOptions(node, options);
+            if (!newOptions.IsEmpty())
             {
+                // Keep any options the node already has that aren't overridden
+                auto nodeOptions = node.GetMetadata().GetEntry<utilities::PropertyBag>("compileOptions", {});
+                AppendOptions(newOptions, nodeOptions);
+
                 utilities::PropertyBag nodeMetadata;
-                nodeMetadata["compileOptions"] = nodeOptions.GetEntry<utilities::PropertyBag>(idStr);
+                nodeMetadata["compileOptions"] = nodeOptions;
                 transformer.CopyNodeWithMetadata(node, nodeMetadata);
             }
             else
@@ -45,7 +154,8 @@ namespace model
 
     Submodel SetCompilerOptionsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
     {
-        if (!_options.HasEntry("model") && !_options.HasEntry("nodes"))
+        const bool hasNodeOptions = _options.HasEntry("nodes") || _options.HasEntry("rules") || _options.HasEntry("parallelizeMinOutputSize");
+        if (!_options.HasEntry("model") && !hasNodeOptions)
         {
             return submodel;
         }
@@ -53,10 +163,10 @@ namespace model
         auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(submodel.GetInputs()));
         model::Model destModel;
         Submodel result(destModel);
-        if (_options.HasEntry("nodes"))
+        if (hasNodeOptions)
         {
             result = transformer.TransformSubmodelOnto(submodel, destModel, onto, context, [this](const Node& node, ModelTransformer& transformer) {
-                CopyAndSetOptionsMetadata(node, transformer, _options.GetEntry<utilities::PropertyBag>("nodes"));
+                CopyAndSetOptionsMetadata(node, transformer, _options);
             });
         }
         else
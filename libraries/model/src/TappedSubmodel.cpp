@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     TappedSubmodel.cpp (model)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "TappedSubmodel.h"
+#include "ModelTransformer.h"
+#include "PortElements.h"
+
+#include <algorithm>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        InputNodeBase* AddInputNode(Model& model, const OutputPortBase& port)
+        {
+            const auto& layout = port.GetMemoryLayout();
+            switch (port.GetType())
+            {
+            case Port::PortType::boolean:
+                return model.AddNode<InputNode<bool>>(layout);
+            case Port::PortType::integer:
+                return model.AddNode<InputNode<int>>(layout);
+            case Port::PortType::bigInt:
+                return model.AddNode<InputNode<int64_t>>(layout);
+            case Port::PortType::smallReal:
+                return model.AddNode<InputNode<float>>(layout);
+            case Port::PortType::real:
+                return model.AddNode<InputNode<double>>(layout);
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "TappedSubmodel input has an unsupported type");
+            }
+        }
+    } // namespace
+
+    TappedSubmodel::TappedSubmodel(const Submodel& submodel, const std::vector<const OutputPortBase*>& taps)
+    {
+        auto ports = submodel.GetOutputs();
+        ports.insert(ports.end(), taps.begin(), taps.end());
+        if (ports.empty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "TappedSubmodel needs at least one port to compute");
+        }
+
+        // Each port the submodel's inputs read is replaced by an input node
+        std::vector<const OutputPortBase*> cutPorts;
+        std::vector<const OutputPortBase*> onto;
+        for (auto input : submodel.GetInputs())
+        {
+            const auto& cutPort = input->GetReferencedPort();
+            auto index = static_cast<size_t>(std::find(cutPorts.begin(), cutPorts.end(), &cutPort) - cutPorts.begin());
+            if (index == cutPorts.size())
+            {
+                cutPorts.push_back(&cutPort);
+                _inputs.push_back(AddInputNode(_model, cutPort));
+            }
+            onto.push_back(&_inputs[index]->GetOutputPort());
+        }
+
+        TransformContext context;
+        ModelTransformer transformer;
+        Submodel tapped(submodel.GetModel(), submodel.GetInputs(), ports);
+        auto copy = transformer.CopySubmodelOnto(tapped, _model, onto, context);
+        _taps = copy.GetOutputs();
+
+        // Input nodes of the model that the taps still depend on are inputs too. Source nodes get their values from their callbacks.
+        for (auto inputNode : _model.GetNodesByType<InputNodeBase>())
+        {
+            if (dynamic_cast<SourceNodeBase*>(inputNode) == nullptr && std::find(_inputs.begin(), _inputs.end(), inputNode) == _inputs.end())
+            {
+                _inputs.push_back(inputNode);
+            }
+        }
+
+        std::vector<PortRange> ranges;
+        for (auto tap : _taps)
+        {
+            ranges.emplace_back(*tap);
+        }
+        _schedule = ComputeSchedule(_model, PortElementsBase(ranges));
+    }
+
+    size_t TappedSubmodel::GetInputSize(size_t index) const
+    {
+        if (index >= _inputs.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "TappedSubmodel input index out of range");
+        }
+        return _inputs[index]->GetOutputPort().Size();
+    }
+
+    size_t TappedSubmodel::GetTapSize(size_t index) const
+    {
+        return GetTap(index).Size();
+    }
+
+    const OutputPortBase& TappedSubmodel::GetTap(size_t index) const
+    {
+        if (index >= _taps.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "TappedSubmodel tap index out of range");
+        }
+        return *_taps[index];
+    }
+
+    void TappedSubmodel::Compute(const TapCallback& callback)
+    {
+        value::ContextGuard<> guard(_computeContext);
+        _schedule.Compute(_numComputeThreads);
+        for (size_t index = 0; index < _taps.size(); ++index)
+        {
+            callback(index, _taps[index]->GetDoubleOutput());
+        }
+    }
+} // namespace model
+} // namespace ell
@@ -33,12 +33,18 @@ void TestCompilableVectorOutputNode();
 void TestCompilableAccumulatorNode();
 void TestCompilableDotProductNode();
 void TestCompilableDelayNode();
-void TestCompilableDTWDistanceNode();
+void TestCompilableDTWDistanceNode(size_t bandWidth = 0, double abandonThreshold = 0);
 void TestCompilableMulticlassDTW();
+void TestCompilableForestPredictorNode(bool compileToKernel);
 void TestCompilableScalarSumNode();
 void TestCompilableSumNode();
+void TestCompilableArgMaxNode();
+void TestCompilableTopKNode(bool normalize);
+void TestCompilableSparseLinearPredictorNode();
 void TestCompilableUnaryOperationNode();
 void TestL2NormSquaredNodeCompiled();
+template <math::MatrixLayout layout>
+void TestSquaredEuclideanDistanceNodeCompiled(bool useSmallMatrixKernel);
 void TestMatrixVectorProductNodeCompile();
 void TestCompilableBinaryOperationNode();
 void TestCompilableBinaryOperationNode2();
@@ -47,32 +53,38 @@ void TestCompilableBinaryPredicateNode();
 void TestCompilableMultiplexerNode();
 void TestCompilableTypeCastNode(size_t dimension);
 void TestReinterpretLayoutNode();
-void TestReorderDataNode1();
+void TestReorderDataNode1(int nonTemporalStoreThreshold = 0);
 void TestReorderDataNode2();
 void TestReorderDataNode3();
 void TestReceptiveFieldMatrixNode(size_t numChannels, bool useNewReshape);
 void TestCompilableAccumulatorNodeFunction();
 void TestCompilableSourceNode();
 void TestCompilableSinkNode();
+void TestCompilableSourceNodeRingBuffer();
+void TestCompilableSinkNodeRingBuffer();
 template <typename ElementType>
 void TestCompilableDotProductNode2(int dimension);
 void TestFloatNode();
 void TestMultipleOutputNodes();
 void TestShapeFunctionGeneration();
 void TestCompilableClockNode();
-void TestCompilableFFTNode();
+void TestCompilableFFTNode(int fftSize, int inputSize);
+void TestCompilableMultichannelFFTNode(int numChannels, int fftSize, int inputSize);
+void TestCompilableImagePreprocessingNode();
 
 //
 // mathy nodes
 //
-void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas);
-void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas);
-void TestOrderedMatrixMatrixMultiplyNode(int m, int n, int k, bool transposeA, bool transposeB, bool transposeC, bool useBlas);
+void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas, bool useSmallMatrixKernel = false, int prefetchDistance = 0);
+void TestConstantMatrixVectorMultiplyNode(int m, int n);
+void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas, bool allowVectorInstructions = false, int prefetchDistance = 0, bool parallelize = false);
+void TestOrderedMatrixMatrixMultiplyNode(int m, int n, int k, bool transposeA, bool transposeB, bool transposeC, bool useBlas, bool useSmallMatrixKernel = false);
 
 void TestBroadcasUnaryOperationNodeCompile();
 void TestBroadcasBinaryOperationNodeCompileAdd();
 void TestBroadcasBinaryOperationNodeCompileSubtract();
 void TestBroadcasBinaryOperationNodeCompileWithOrdering();
+void TestBroadcastTernaryOperationNodeCompileVectorized();
 
 //
 // NN layer nodes
@@ -96,6 +108,7 @@ void TestBatchNormalizationLayerNode(size_t inputPadding = 0, size_t outputPaddi
 void TestBiasLayerNode(size_t inputPadding = 0, size_t outputPadding = 0);
 void TestBinaryConvolutionalLayerNode(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters, size_t inputPadding = 1, size_t outputPadding = 0, ell::predictors::neural::PaddingScheme = ell::predictors::neural::PaddingScheme::zeros, bool scaleByFilterMeans = true);
 void TestBroadcastLinearFunctionNode();
+void TestBroadcastLinearFunctionNodeVectorized();
 void TestConvolutionalLayerNode(ConvolutionMethod convolutionMethod, size_t inputPadding = 1, size_t outputPadding = 0);
 void TestConvolutionalLayerNode2(ConvolutionMethod convolutionMethod, size_t inputPadding = 1, size_t outputPadding = 0);
 void TestConvolutionalLayerNode3(ConvolutionMethod convolutionMethod, size_t inputPadding = 1, size_t outputPadding = 0);
@@ -103,7 +116,7 @@ void TestFullyConnectedLayerNode(size_t inputPadding = 0, size_t outputPadding =
 void TestMaxPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPadding = 0, size_t outputPadding = 0);
 void TestMeanPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPadding = 0, size_t outputPadding = 0);
 void TestScalingLayerNode(size_t inputPadding = 0, size_t outputPadding = 0);
-void TestSoftmaxLayerNode(size_t inputPadding = 0, size_t outputPadding = 0);
+void TestSoftmaxLayerNode(size_t inputPadding = 0, size_t outputPadding = 0, size_t numChannels = 2);
 void TestFusedLinearLayerNodes(size_t rows, size_t columns, size_t channels);
 void TestRegionDetectionNode();
 
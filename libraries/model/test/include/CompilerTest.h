@@ -38,6 +38,28 @@ void TestSum(bool expanded, bool optimize = false);
 void TestAccumulator(bool expanded);
 void TestDelay();
 void TestSqrt();
+void TestPortBufferAllocator();
+void TestReuseIntermediateBuffers();
+void TestAliasPortBuffers();
+void TestStackPortBuffers();
+void TestSelectiveNodeInlining();
+void TestObjectCache();
+void TestNodeFunctionCache();
+void TestJitCompilationModes();
+void TestCompileTimingReport();
+void TestFunctionVariants();
+void TestBatchPredictFunction();
+void TestBatchedMatrixProducts();
+void TestAsyncPredictFunctions();
+void TestReentrantMap();
+void TestExternalWeights();
+void TestStaticMemory();
+void TestDeduplicateConstants();
+void TestWeightsPlacement();
+void TestPGOInstrumentation();
+void TestParallelBranches();
+void TestNoHeap();
+void TestOptimizationRemarks();
 void TestBinaryPredicate(bool expanded);
 void TestMultiplexer();
 void TestSlidingAverage();
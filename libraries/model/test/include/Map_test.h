@@ -10,6 +10,11 @@
 void TestMapCreate();
 void TestMapCompute();
 void TestMapComputeDataVector();
+void TestMapParallelCompute();
+void TestMapExecutionContext();
+void TestMapPipeline();
+void TestChainMaps();
+void TestMapGateNode();
 void TestMapRefine();
 void TestMapSerialization();
 void TestMapClockNode();
@@ -13,3 +13,4 @@ void TestModelOptimizerOptions();
 // Lower-level tests (called by the above)
 void TestArchiveModelOptimizerOptions();
 void TestModelOptimizerOptionsMetadata();
+void TestCompilerOptionsRules();
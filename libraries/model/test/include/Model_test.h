@@ -21,4 +21,5 @@ void TestShallowCopyModel();
 
 void TestRefineSplitOutputs();
 void TestCustomRefine();
+void TestRefineIterations();
 void TestChangeInputForNode();
@@ -9,3 +9,5 @@
 #pragma once
 
 void TestPerformanceCounters();
+void TestSampledPerformanceCounters();
+void TestModelProfileData();
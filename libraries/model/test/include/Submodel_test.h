@@ -13,3 +13,4 @@ void TestSubmodels();
 // Individual tests
 void TestSubmodelConstructors();
 void TestSubmodelVisit();
+void TestTappedSubmodel();
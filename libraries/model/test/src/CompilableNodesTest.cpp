@@ -45,6 +45,9 @@
 #include <nodes/include/DotProductNode.h>
 #include <nodes/include/ExtremalValueNode.h>
 #include <nodes/include/FFTNode.h>
+#include <nodes/include/ImagePreprocessingNode.h>
+#include <nodes/include/MultichannelFFTNode.h>
+#include <nodes/include/ForestPredictorNode.h>
 #include <nodes/include/FullyConnectedLayerNode.h>
 #include <nodes/include/IRNode.h>
 #include <nodes/include/L2NormSquaredNode.h>
@@ -62,7 +65,10 @@
 #include <nodes/include/SinkNode.h>
 #include <nodes/include/SoftmaxLayerNode.h>
 #include <nodes/include/SourceNode.h>
+#include <nodes/include/SparseLinearPredictorNode.h>
+#include <nodes/include/SquaredEuclideanDistanceNode.h>
 #include <nodes/include/SumNode.h>
+#include <nodes/include/TopKNode.h>
 #include <nodes/include/TypeCastNode.h>
 #include <nodes/include/UnaryOperationNode.h>
 
@@ -93,6 +99,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -243,22 +250,21 @@ void TestCompilableDelayNode()
     });
 }
 
-void TestCompilableDTWDistanceNode()
+void TestCompilableDTWDistanceNode(size_t bandWidth, double abandonThreshold)
 {
     model::Model model;
     std::vector<std::vector<double>> prototype = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } };
     auto inputNode = model.AddNode<model::InputNode<double>>(3);
-    auto dtwNode = model.AddNode<DTWDistanceNode<double>>(inputNode->output, prototype);
+    auto dtwNode = model.AddNode<DTWDistanceNode<double>>(inputNode->output, prototype, bandWidth, abandonThreshold);
     auto map = model::Map(model, { { "input", inputNode } }, { { "output", dtwNode->output } });
 
-    std::string name = "DTWDistanceNode";
+    std::string name = utilities::FormatString("DTWDistanceNode (band width %d, abandon threshold %g)", static_cast<int>(bandWidth), abandonThreshold);
     TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
         model::IRMapCompiler compiler;
         auto compiledMap = compiler.Compile(map);
 
         // compare output
         std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 }, { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 7, 4, 2 }, { 5, 2, 1 } };
-        std::vector<std::vector<double>> expected = { { 2.7 }, { 1.35 }, { 0 }, { 1.8 }, { 2.55 }, { 2.25 }, { 2.7 }, { 1.35 }, { 0 }, { 1.65 }, { 2.4 } };
         VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
     });
 }
@@ -334,6 +340,45 @@ void TestCompilableMulticlassDTW()
     });
 }
 
+void TestCompilableForestPredictorNode(bool compileToKernel)
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+
+    // 5 trees of different depths, so the compiled kernel walks a full block of trees and a padded one
+    predictors::SimpleForestPredictor forest;
+    auto root = forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.3 }, EdgePredictorVector{ -1.0, 1.0 } });
+    auto child = forest.Split(SplitAction{ forest.GetChildId(root, 0), SplitRule{ 1, 0.6 }, EdgePredictorVector{ -2.0, 2.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(child, 0), SplitRule{ 1, 0.4 }, EdgePredictorVector{ -2.1, 2.1 } });
+    forest.Split(SplitAction{ forest.GetChildId(child, 1), SplitRule{ 2, 0.7 }, EdgePredictorVector{ -2.2, 2.2 } });
+    forest.Split(SplitAction{ forest.GetChildId(root, 1), SplitRule{ 2, 0.9 }, EdgePredictorVector{ -4.0, 4.0 } });
+    for (size_t treeIndex = 1; treeIndex < 5; ++treeIndex)
+    {
+        auto treeRoot = forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ treeIndex % 3, 0.1 * treeIndex }, EdgePredictorVector{ 0.5 * treeIndex, -0.25 * treeIndex } });
+        for (size_t depth = 0; depth < treeIndex; ++depth)
+        {
+            treeRoot = forest.Split(SplitAction{ forest.GetChildId(treeRoot, depth % 2), SplitRule{ depth % 3, 0.2 * depth + 0.1 }, EdgePredictorVector{ 1.0 + depth, -1.0 - depth } });
+        }
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto forestNode = model.AddNode<SimpleForestPredictorNode>(inputNode->output, forest);
+    auto edgeIndicatorNode = model.AddNode<TypeCastNode<bool, double>>(forestNode->edgeIndicatorVector);
+    auto combinedNode = model.AddNode<model::SpliceNode<double>>(std::vector<const model::OutputPortBase*>{ &forestNode->output, &forestNode->treeOutputs, &edgeIndicatorNode->output });
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", combinedNode->output } });
+
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions.SetEntry("compileForestToKernel", compileToKernel);
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<std::vector<double>> signal = { { 0.2, 0.5, 0.1 }, { 0.9, 0.1, 0.8 }, { 0.4, 0.7, 0.95 }, { 0.05, 0.35, 0.6 }, { 0.6, 0.9, 0.3 } };
+    VerifyCompiledOutput(map, compiledMap, signal, compileToKernel ? "ForestPredictorNode (kernel)" : "ForestPredictorNode (expanded)");
+}
+
 void TestCompilableScalarSumNode()
 {
     model::Model model;
@@ -375,6 +420,80 @@ void TestCompilableSumNode()
     });
 }
 
+void TestCompilableArgMaxNode()
+{
+    // 19 values leave some over after the vector blocks, and the repeated extremal values check that the first one wins
+    std::vector<std::vector<double>> signal = { { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9, 7, 9, 3, 2, 3, 8 },
+                                                { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 },
+                                                { -5, -3, -8, -3, -1, -9, -1, -4, -2, -7, -6, -9, -1, -3, -2, -8, -5, -4, -6 } };
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(signal[0].size());
+    auto argMaxNode = model.AddNode<ArgMaxNode<double>>(inputNode->output);
+    auto argMinNode = model.AddNode<ArgMinNode<double>>(inputNode->output);
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    auto verify = [&](const auto& output, const std::string& name) {
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", output } });
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, name, "vectorized");
+    };
+    verify(argMaxNode->val, "ArgMaxNode val");
+    verify(argMaxNode->argVal, "ArgMaxNode argVal");
+    verify(argMinNode->val, "ArgMinNode val");
+    verify(argMinNode->argVal, "ArgMinNode argVal");
+}
+
+void TestCompilableTopKNode(bool normalize)
+{
+    std::vector<std::vector<double>> signal = { { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9, 7, 9, 3, 2, 3, 8 },
+                                                { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 },
+                                                { -5, -3, -8, -3, -1, -9, -1, -4, -2, -7, -6, -9, -1, -3, -2, -8, -5, -4, -6 } };
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(signal[0].size());
+    auto topKNode = model.AddNode<TopKNode<double>>(inputNode->output, 4, normalize);
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    std::string name = normalize ? "TopKNode (normalized)" : "TopKNode";
+    auto verify = [&](const auto& output, const std::string& portName) {
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", output } });
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, name, portName);
+    };
+    verify(topKNode->val, "val");
+    verify(topKNode->argVal, "argVal");
+}
+
+void TestCompilableSparseLinearPredictorNode()
+{
+    const int dim = 1000;
+    const size_t maxNonZeros = 4;
+    math::ColumnVector<double> weights(dim);
+    for (int i = 0; i < dim; ++i)
+    {
+        weights[i] = 0.01 * i - 3;
+    }
+    predictors::LinearPredictor<double> predictor(weights, 0.5);
+
+    // Out-of-range indices are ignored, like the unused pairs
+    std::vector<std::vector<double>> signal = { GetSparseLinearPredictorInput<double>({ { 3, 1.5 }, { 999, -2 }, { 10, 0.25 } }, maxNonZeros),
+                                                GetSparseLinearPredictorInput<double>({}, maxNonZeros),
+                                                GetSparseLinearPredictorInput<double>({ { 0, 4 }, { dim, 7 }, { -5, 3 }, { 500, 1 } }, maxNonZeros) };
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(2 * maxNonZeros);
+    auto predictorNode = model.AddNode<SparseLinearPredictorNode<double>>(inputNode->output, predictor);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", predictorNode->output } });
+
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+    VerifyCompiledOutput(map, compiledMap, signal, "SparseLinearPredictorNode");
+}
+
 std::vector<std::vector<double>> GetExpectedUnaryOperationOutput(std::vector<std::vector<double>> signal, UnaryOperationType op)
 {
     SigmoidActivationFunction<double> sigmoid;
@@ -494,6 +613,40 @@ void TestL2NormSquaredNodeCompiled()
     });
 }
 
+template <math::MatrixLayout layout>
+void TestSquaredEuclideanDistanceNodeCompiled(bool useSmallMatrixKernel)
+{
+    math::Matrix<double, layout> m{
+        { 1.2, 1.1, 0.8 },
+        { 0.6, 0.9, 1.3 },
+        { 0.3, 1.0, 0.4 },
+        { -.4, 0.2, -.7 }
+    };
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto testNode = model.AddNode<SquaredEuclideanDistanceNode<double, layout>>(inputNode->output, m);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
+    std::string name = std::string("SquaredEuclideanDistanceNode") + (layout == math::MatrixLayout::rowMajor ? "_rowMajor" : "_columnMajor") + (useSmallMatrixKernel ? "_small" : "");
+    TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.optimize = true;
+        if (!useSmallMatrixKernel)
+        {
+            settings.compilerSettings.smallMatrixThreshold = 0;
+        }
+        model::IRMapCompiler compiler(settings, {});
+        auto compiledMap = compiler.Compile(map);
+
+        // compare output
+        std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 }, { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 7, 4, 2 }, { 5, 2, 1 } };
+        VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
+    });
+}
+
+template void TestSquaredEuclideanDistanceNodeCompiled<math::MatrixLayout::rowMajor>(bool);
+template void TestSquaredEuclideanDistanceNodeCompiled<math::MatrixLayout::columnMajor>(bool);
+
 std::vector<std::vector<double>> GetExpectedMatrixVectorProduct(math::ConstRowMatrixReference<double> m, std::vector<std::vector<double>> signal)
 {
     std::vector<std::vector<double>> result;
@@ -813,7 +966,7 @@ void TestReinterpretLayoutNode()
     });
 }
 
-void TestReorderDataNode1()
+void TestReorderDataNode1(int nonTemporalStoreThreshold)
 {
     using ElementType = float;
     int numRows = 3;
@@ -839,7 +992,9 @@ void TestReorderDataNode1()
     auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputSize);
     auto testNode = model.AddNode<ReorderDataNode<ElementType>>(inputNode->output, inputLayout, outputLayout);
     auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
-    model::IRMapCompiler compiler;
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.nonTemporalStoreThreshold = nonTemporalStoreThreshold;
+    model::IRMapCompiler compiler(settings, {});
     auto compiledMap = compiler.Compile(map);
 
     std::vector<ElementType> input(inputSize);
@@ -1154,6 +1309,78 @@ void TestSinkNode_CompiledSinkNode_OutputCallback(void* context, double* output)
 TESTING_FORCE_DEFINE_SYMBOL(TestSinkNode_CompiledSinkNode_OutputCallback, void, void*, double*);
 }
 
+void TestCompilableSourceNodeRingBuffer()
+{
+    using PushFunction = bool(double*);
+    const size_t inputSize = 3;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<TimeTickType>>(2);
+    auto testNode = model.AddNode<SourceNode<double>>(inputNode->output, inputSize, "CompiledSourceNode_InputCallback");
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.moduleName = "TestSourceNodeRingBuffer";
+    settings.compilerSettings.optimize = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions.SetEntry("useRingBufferTransport", true);
+    optimizerOptions.SetEntry("ringBufferCapacity", 2);
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    auto push = reinterpret_cast<PushFunction*>(compiledMap.GetJitter().ResolveFunctionAddress("TestSourceNodeRingBuffer_CompiledSourceNode_InputCallback_Push"));
+
+    std::vector<std::vector<double>> frames = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } };
+    bool ok = push(frames[0].data()) && push(frames[1].data()) && !push(frames[2].data());
+    testing::ProcessTest("Testing SourceNode ring buffer push until full", ok);
+
+    auto compute = [&compiledMap](TimeTickType time) {
+        compiledMap.SetInputValue(0, std::vector<TimeTickType>{ time, time });
+        return compiledMap.ComputeOutput<double>(0);
+    };
+    ok = testing::IsEqual(compute(1), frames[0]);
+    ok &= testing::IsEqual(compute(2), frames[1]);
+    ok &= testing::IsEqual(compute(3), frames[1]); // empty: keeps the previous sample
+    ok &= push(frames[2].data());
+    ok &= testing::IsEqual(compute(4), frames[2]);
+    testing::ProcessTest("Testing SourceNode ring buffer samples", ok);
+}
+
+void TestCompilableSinkNodeRingBuffer()
+{
+    using PopFunction = bool(double*);
+    const size_t inputSize = 4;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(inputSize);
+    auto condition = model.AddNode<ConstantNode<bool>>(true);
+    auto testNode = model.AddNode<SinkNode<double>>(inputNode->output, condition->output, "CompiledSinkNode_OutputCallback");
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", testNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.moduleName = "TestSinkNodeRingBuffer";
+    settings.compilerSettings.optimize = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions.SetEntry("useRingBufferTransport", true);
+    optimizerOptions.SetEntry("ringBufferCapacity", 2);
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    auto pop = reinterpret_cast<PopFunction*>(compiledMap.GetJitter().ResolveFunctionAddress("TestSinkNodeRingBuffer_CompiledSinkNode_OutputCallback_Pop"));
+
+    std::vector<std::vector<double>> frames = { { 1, 2, 3, 4 }, { 5, 6, 7, 8 }, { 9, 10, 11, 12 } };
+    for (const auto& frame : frames)
+    {
+        // outputs are still passed through while the ring buffer is full
+        compiledMap.SetInputValue(0, frame);
+        auto output = compiledMap.ComputeOutput<double>(0);
+        testing::ProcessTest("Testing SinkNode ring buffer output", testing::IsEqual(output, frame));
+    }
+
+    // The third frame was dropped because the buffer was full
+    std::vector<double> popped(inputSize);
+    bool ok = pop(popped.data()) && testing::IsEqual(popped, frames[0]);
+    ok &= pop(popped.data()) && testing::IsEqual(popped, frames[1]);
+    ok &= !pop(popped.data());
+    testing::ProcessTest("Testing SinkNode ring buffer pop", ok);
+}
+
 void TestCompilableSinkNode(size_t inputSize, bool triggerValue)
 {
     std::string sinkFunctionName = "CompiledSinkNode_OutputCallback";
@@ -1295,7 +1522,7 @@ void TestShapeFunctionGeneration()
                          hasInputFunc && hasOutputFunc && hasStoreInstruction);
 }
 
-void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas)
+void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas, bool useSmallMatrixKernel, int prefetchDistance)
 {
     using ValueType = float;
     std::vector<ValueType> vectorVals(n);
@@ -1313,6 +1540,8 @@ void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas)
     TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
         model::MapCompilerOptions settings;
         settings.compilerSettings.useBlas = useBlas;
+        settings.compilerSettings.smallMatrixThreshold = useSmallMatrixKernel ? m * n : 0;
+        settings.compilerSettings.prefetchDistance = prefetchDistance;
         model::ModelOptimizerOptions optimizerOptions;
         model::IRMapCompiler compiler(settings, optimizerOptions);
         auto compiledMap = compiler.Compile(map);
@@ -1325,7 +1554,41 @@ void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas)
     });
 }
 
-void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas)
+void TestConstantMatrixVectorMultiplyNode(int m, int n)
+{
+    using ValueType = float;
+    std::vector<ValueType> matrixVals(m * n);
+    FillVector(matrixVals);
+    for (int i = 0; i < m * n; i += 3)
+    {
+        matrixVals[i] = 0;
+    }
+
+    model::Model model;
+    auto inputVectorNode = model.AddNode<model::InputNode<ValueType>>(n);
+    auto inputMatrixNode = model.AddNode<ConstantNode<ValueType>>(matrixVals);
+
+    auto matVecMultNode = model.AddNode<MatrixVectorMultiplyNode<ValueType>>(inputMatrixNode->output, m, n, n, inputVectorNode->output);
+
+    auto map = model::Map(model, { { "inputVector", inputVectorNode } }, { { "output", matVecMultNode->output } });
+
+    std::string name = "ConstantMatrixVectorMultiplyNode";
+    TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.smallMatrixThreshold = m * n;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+
+        // compare output
+        std::vector<ValueType> vectorVals(n);
+        FillVector(vectorVals);
+        std::vector<std::vector<ValueType>> signal = { vectorVals };
+        VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
+    });
+}
+
+void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas, bool allowVectorInstructions, int prefetchDistance, bool parallelize)
 {
     using ValueType = float;
     std::vector<ValueType> matrixBVals(k * n);
@@ -1352,15 +1615,30 @@ void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas)
 
         model::MapCompilerOptions settings;
         settings.compilerSettings.useBlas = useBlas;
+        settings.compilerSettings.allowVectorInstructions = allowVectorInstructions;
+        settings.compilerSettings.smallMatrixThreshold = 0;
+        settings.compilerSettings.prefetchDistance = prefetchDistance;
+        settings.compilerSettings.parallelize = parallelize;
         model::ModelOptimizerOptions optimizerOptions;
         model::IRMapCompiler compiler(settings, optimizerOptions);
         auto compiledMap = compiler.Compile(map);
 
+        // Unless the GEMM can run on several threads at once, its packed panels are module-level scratch arrays
+        bool hasPanelGlobals = false;
+        for (const auto& global : compiledMap.GetModule().GetLLVMModule()->globals())
+        {
+            hasPanelGlobals = hasPanelGlobals || global.getName().endswith("_packedB");
+        }
+        if (!useBlas)
+        {
+            testing::ProcessTest(utilities::FormatString("Testing %s panels are %s", name.c_str(), parallelize ? "on the stack" : "globals"), hasPanelGlobals != parallelize);
+        }
+
         VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
     });
 }
 
-void TestOrderedMatrixMatrixMultiplyNode(int m, int n, int k, bool transposeA, bool transposeB, bool transposeC, bool useBlas)
+void TestOrderedMatrixMatrixMultiplyNode(int m, int n, int k, bool transposeA, bool transposeB, bool transposeC, bool useBlas, bool useSmallMatrixKernel)
 {
     using ValueType = float;
 
@@ -1391,13 +1669,15 @@ void TestOrderedMatrixMatrixMultiplyNode(int m, int n, int k, bool transposeA, b
     TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
         model::MapCompilerOptions settings;
         settings.compilerSettings.useBlas = useBlas;
+        settings.compilerSettings.smallMatrixThreshold = useSmallMatrixKernel ? m * n * k : 0;
         model::ModelOptimizerOptions optimizerOptions;
         model::IRMapCompiler compiler(settings, optimizerOptions);
         auto compiledMap = compiler.Compile(map);
 
         std::stringstream id;
         id << std::boolalpha << "OrderedMatrixMatrixMultiplyNode(m = " << m << ", n = " << n << ", k = " << k << ", transposeA = "
-           << transposeA << ", transposeB = " << transposeB << ", transposeC = " << transposeC << ", useBlas = " << useBlas << ") iteration " << iteration;
+           << transposeA << ", transposeB = " << transposeB << ", transposeC = " << transposeC << ", useBlas = " << useBlas
+           << ", useSmallMatrixKernel = " << useSmallMatrixKernel << ") iteration " << iteration;
         VerifyCompiledOutput(map, compiledMap, signal, id.str());
     });
 }
@@ -1480,13 +1760,13 @@ void TestCompilableClockNode()
     testing::ProcessTest("Testing lag notification count", testing::IsEqual(lagNotificationCallbackCount, 2));
 }
 
-void TestCompilableFFTNode()
+void TestCompilableFFTNode(int fftSize, int inputSize)
 {
     using ValueType = float;
-    const int N = 8;
+    const int N = inputSize;
     model::Model model;
     auto inputNode = model.AddNode<model::InputNode<ValueType>>(N);
-    auto fftNode = model.AddNode<FFTNode<ValueType>>(inputNode->output, N);
+    auto fftNode = model.AddNode<FFTNode<ValueType>>(inputNode->output, fftSize);
 
     std::vector<ValueType> input1(N, 1.0); // DC
     std::vector<ValueType> input2(N, 0); // impulse
@@ -1496,11 +1776,11 @@ void TestCompilableFFTNode()
     {
         input3[index] = std::sin(2 * math::Constants<ValueType>::pi * index / N);
     }
-    std::vector<std::vector<ValueType>> signal = { input1, input2, input3 };
+    std::vector<std::vector<ValueType>> signal = { input1, input2, input3, GetRandomVector<ValueType>(N, -1, 1) };
 
     auto map = model::Map(model, { { "input", inputNode } }, { { "output", fftNode->output } });
 
-    std::string name = "FFTNode";
+    std::string name = "FFTNode_" + std::to_string(fftSize) + "_" + std::to_string(inputSize);
     TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
         model::MapCompilerOptions settings;
         model::ModelOptimizerOptions optimizerOptions;
@@ -1513,6 +1793,86 @@ void TestCompilableFFTNode()
     });
 }
 
+void TestCompilableMultichannelFFTNode(int numChannels, int fftSize, int inputSize)
+{
+    using ValueType = float;
+    const int N = inputSize * numChannels;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(N);
+    auto fftNode = model.AddNode<MultichannelFFTNode<ValueType>>(inputNode->output, numChannels, fftSize);
+
+    // Each channel gets a different sinusoid
+    std::vector<ValueType> input1(N, 0);
+    for (int index = 0; index < inputSize; ++index)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            input1[index * numChannels + channel] = std::sin(2 * math::Constants<ValueType>::pi * (channel + 1) * index / inputSize);
+        }
+    }
+    std::vector<std::vector<ValueType>> signal = { input1, GetRandomVector<ValueType>(N, -1, 1) };
+
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", fftNode->output } });
+
+    std::string name = "MultichannelFFTNode_" + std::to_string(numChannels) + "_" + std::to_string(fftSize) + "_" + std::to_string(inputSize);
+    for (bool vectorize : { false, true })
+    {
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.allowVectorInstructions = vectorize;
+        settings.compilerSettings.vectorWidth = 4;
+        model::IRMapCompiler compiler(settings, {});
+        auto compiledMap = compiler.Compile(map);
+
+        // compare output
+        VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s vectorize %d", name.c_str(), vectorize));
+    }
+}
+
+void TestCompilableImagePreprocessingNode()
+{
+    // A float image: crop a 6x8 BGR image to 6x6, resize it to 4x4, swap to RGB and normalize it
+    {
+        using ValueType = float;
+        const int inputRows = 6, inputColumns = 8, numChannels = 3;
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ValueType>>(inputRows * inputColumns * numChannels);
+        std::vector<ValueType> mean = { 0.5f, 0.25f, 0 };
+        std::vector<ValueType> scale = { 2, 4, 1 };
+        auto preprocessNode = model.AddNode<ImagePreprocessingNode<ValueType, ValueType>>(inputNode->output, inputRows, inputColumns, 4, 4, true, std::vector<int>{ 2, 1, 0 }, mean, scale);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", preprocessNode->output } });
+        model::IRMapCompiler compiler;
+        auto compiledMap = compiler.Compile(map);
+
+        std::vector<std::vector<ValueType>> signal = { GetRandomVector<ValueType>(inputRows * inputColumns * numChannels, 0, 1), GetRandomVector<ValueType>(inputRows * inputColumns * numChannels, 0, 1) };
+        VerifyCompiledOutput(map, compiledMap, signal, "ImagePreprocessingNode_float");
+    }
+
+    // A packed 8-bit image: resize a 4x6 BGR image to 3x5 without cropping, and convert it to float
+    {
+        using ValueType = float;
+        const int inputRows = 4, inputColumns = 6, numChannels = 3;
+        const int numBytes = inputRows * inputColumns * numChannels;
+        const int numElements = numBytes / sizeof(int);
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<int>>(numElements);
+        auto preprocessNode = model.AddNode<ImagePreprocessingNode<int, ValueType>>(inputNode->output, inputRows, inputColumns, 3, 5, false, std::vector<int>{ 2, 1, 0 }, std::vector<ValueType>{}, std::vector<ValueType>(numChannels, 1.0f / 255));
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", preprocessNode->output } });
+        model::IRMapCompiler compiler;
+        auto compiledMap = compiler.Compile(map);
+
+        std::vector<std::vector<int>> signal;
+        for (int frame = 0; frame < 2; ++frame)
+        {
+            auto values = GetRandomVector<int>(numBytes, 0, 255);
+            std::vector<unsigned char> bytes(values.begin(), values.end());
+            std::vector<int> packed(numElements);
+            std::memcpy(packed.data(), bytes.data(), numBytes);
+            signal.push_back(packed);
+        }
+        VerifyCompiledOutput(map, compiledMap, signal, "ImagePreprocessingNode_packed");
+    }
+}
+
 class BinaryFunctionIRNode : public IRNode
 {
 public:
@@ -1706,6 +2066,48 @@ void TestNeuralNetworkPredictorNode1()
     VerifyCompiledOutput(unarchivedMap, compiledMap, signal, predictorNode->GetRuntimeTypeName() + "_1");
 }
 
+void TestBroadcastLinearFunctionNodeVectorized()
+{
+    using ElementType = float;
+
+    int rows = 5;
+    int cols = 7; // not a multiple of the vector size, to test the remainder loop
+    std::vector<ElementType> inputValues(rows * cols);
+    std::iota(inputValues.begin(), inputValues.end(), -3.0f);
+
+    // Broadcast the coefficients across the rows (where they're the same for the whole inner loop) and across the columns
+    for (size_t secondaryInputDimension : { 0, 1 })
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ElementType>>(model::MemoryShape{ rows, cols });
+
+        int secondarySize = secondaryInputDimension == 0 ? rows : cols;
+        std::vector<ElementType> scaleValues(secondarySize);
+        std::vector<ElementType> biasValues(secondarySize);
+        std::iota(scaleValues.begin(), scaleValues.end(), 1.0f);
+        std::iota(biasValues.begin(), biasValues.end(), -2.0f);
+        auto scaleValuesNode = model.AddNode<ConstantNode<ElementType>>(scaleValues, model::MemoryShape{ secondarySize });
+        auto biasValuesNode = model.AddNode<ConstantNode<ElementType>>(biasValues, model::MemoryShape{ secondarySize });
+        auto computeNode = model.AddNode<BroadcastLinearFunctionNode<ElementType>>(inputNode->output,
+                                                                                   inputNode->output.GetMemoryLayout(),
+                                                                                   scaleValuesNode->output,
+                                                                                   biasValuesNode->output,
+                                                                                   secondaryInputDimension,
+                                                                                   inputNode->output.GetMemoryLayout());
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.allowVectorInstructions = true;
+        settings.compilerSettings.vectorWidth = 4;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+
+        std::vector<std::vector<ElementType>> signal = { inputValues };
+        VerifyCompiledOutput(map, compiledMap, signal, "TestBroadcastLinearFunctionNodeVectorized_" + std::to_string(secondaryInputDimension));
+    }
+}
+
 void TestBroadcastLinearFunctionNode()
 {
     using ElementType = double;
@@ -2920,6 +3322,15 @@ void TestPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size
 
     VerifyLayerMap<ElementType>(map, computeNode, inputWithPadding, output);
 
+    // Compile again with the channels pooled in vectors
+    std::vector<std::vector<ElementType>> signal = { inputWithPadding.ToArray() };
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    VerifyCompiledOutput(map, compiledMap, signal, computeNode->GetRuntimeTypeName(), "vectorized");
+
     // Test archiving / unarchiving produces same result
     utilities::SerializationContext context;
     common::RegisterNodeTypes(context);
@@ -2931,7 +3342,6 @@ void TestPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size
     model::Map unarchivedMap;
     unarchiver >> unarchivedMap;
 
-    std::vector<std::vector<ElementType>> signal = { inputWithPadding.ToArray() };
     std::vector<std::vector<ElementType>> expectedOutput = { output.ToArray() };
     VerifyMapOutput(unarchivedMap, signal, expectedOutput, "Unarchived model with MaxPoolingLayerNode");
 }
@@ -2985,7 +3395,7 @@ void TestScalingLayerNode(size_t inputPaddingSize, size_t outputPaddingSize)
     VerifyArchiveAndUnarchivingMap<ElementType>(map, computeNode, inputWithPadding, output);
 }
 
-void TestSoftmaxLayerNode(size_t inputPaddingSize, size_t outputPaddingSize)
+void TestSoftmaxLayerNode(size_t inputPaddingSize, size_t outputPaddingSize, size_t numChannels)
 {
     using ElementType = double;
     using LayerType = predictors::neural::SoftmaxLayer<ElementType>;
@@ -2995,13 +3405,13 @@ void TestSoftmaxLayerNode(size_t inputPaddingSize, size_t outputPaddingSize)
     using Shape = typename Layer<ElementType>::Shape;
 
     // Build a model
-    TensorType inputWithPadding(2 + 2 * inputPaddingSize, 2 + 2 * inputPaddingSize, 2);
-    TensorReferenceType input = inputWithPadding.GetSubTensor(inputPaddingSize, inputPaddingSize, 0, 2, 2, 2);
+    TensorType inputWithPadding(2 + 2 * inputPaddingSize, 2 + 2 * inputPaddingSize, numChannels);
+    TensorReferenceType input = inputWithPadding.GetSubTensor(inputPaddingSize, inputPaddingSize, 0, 2, 2, numChannels);
     input(0, 0, 0) = 1.0;
     input(0, 1, 0) = -2.0;
     input(1, 0, 1) = 3.0;
     input(1, 1, 1) = -4.0;
-    Shape outputShape = { 2 + 2 * outputPaddingSize, 2 + 2 * outputPaddingSize, 2 };
+    Shape outputShape = { 2 + 2 * outputPaddingSize, 2 + 2 * outputPaddingSize, numChannels };
     LayerParameters layerParameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, ZeroPadding(outputPaddingSize) };
     LayerType layer(layerParameters);
     layer.Compute();
@@ -3015,6 +3425,17 @@ void TestSoftmaxLayerNode(size_t inputPaddingSize, size_t outputPaddingSize)
 
     VerifyLayerMap<ElementType>(map, computeNode, inputWithPadding, output);
 
+    // Compile again with vector instructions, using a vector width that leaves values over for the scalar loops
+    // when there are 3 channels
+    std::vector<std::vector<ElementType>> signal = { inputWithPadding.ToArray() };
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    settings.compilerSettings.vectorWidth = 8;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    VerifyCompiledOutput(map, compiledMap, signal, computeNode->GetRuntimeTypeName(), "vectorized");
+
     // Test archiving / unarchiving produces same result
     VerifyArchiveAndUnarchivingMap<ElementType>(map, computeNode, inputWithPadding, output);
 }
@@ -3227,6 +3648,13 @@ void TestRegionDetectionNode()
         // compare computed vs. compiled output
         std::vector<std::vector<ElementType>> signal = { input.ToArray() };
         VerifyCompiledOutput(map, compiledMap, signal, computeNode->GetRuntimeTypeName());
+
+        // and again with the class probabilities computed in vectors
+        model::MapCompilerOptions vectorSettings;
+        vectorSettings.compilerSettings.allowVectorInstructions = true;
+        model::IRMapCompiler vectorCompiler(vectorSettings, optimizerOptions);
+        auto vectorCompiledMap = vectorCompiler.Compile(map);
+        VerifyCompiledOutput(map, vectorCompiledMap, signal, computeNode->GetRuntimeTypeName(), "vectorized");
     }
 }
 
@@ -3378,3 +3806,40 @@ void TestBroadcasBinaryOperationNodeCompileWithOrdering()
     auto computed = compiledMap.Compute<double>(input1Vals);
     testing::ProcessTest("TestBroadcastBinaryOperationNodeCompileWithOrdering", testing::IsEqual(computed, expected));
 }
+
+void TestBroadcastTernaryOperationNodeCompileVectorized()
+{
+    model::Model model;
+    int numRows = 2;
+    int numColumns = 3;
+    int numChannels = 10; // not a multiple of the vector size, to test the remainder loop
+
+    model::PortMemoryLayout inputLayout({ numRows, numColumns, numChannels });
+    model::PortMemoryLayout scaleLayout({ 1, numColumns, 1 });
+
+    std::vector<double> scaleVals{ 2, 4, 6 };
+    std::vector<double> biasVals(inputLayout.GetMemorySize());
+    std::iota(biasVals.begin(), biasVals.end(), 0.5);
+
+    auto inputNode = model.AddNode<model::InputNode<double>>(inputLayout);
+    auto scaleNode = model.AddNode<ConstantNode<double>>(scaleVals, scaleLayout);
+    auto biasNode = model.AddNode<ConstantNode<double>>(biasVals, inputLayout);
+    auto op = BroadcastTernaryOperationNode<double>::OperationType::fma;
+    auto outputNode = model.AddNode<BroadcastTernaryOperationNode<double>>(inputNode->output,
+                                                                           scaleNode->output,
+                                                                           biasNode->output,
+                                                                           op);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", outputNode->output } });
+
+    // Compile model
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    settings.compilerSettings.vectorWidth = 4;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<std::vector<double>> signal = { std::vector<double>(inputLayout.GetMemorySize()) };
+    std::iota(signal[0].begin(), signal[0].end(), -10.0);
+    VerifyCompiledOutput(map, compiledMap, signal, "TestBroadcastTernaryOperationNodeCompileVectorized");
+}
@@ -12,16 +12,22 @@
 #include <model_testing/include/ModelTestUtilities.h>
 
 #include <model/include/CompilableNode.h>
+#include <model/include/CompileTimingReport.h>
 #include <model/include/IRCompiledMap.h>
 #include <model/include/IRMapCompiler.h>
 #include <model/include/Map.h>
 #include <model/include/Model.h>
+#include <model/include/ParallelBranches.h>
+#include <model/include/PortBufferAllocator.h>
+#include <model/include/SliceNode.h>
+#include <model/include/SpliceNode.h>
 
 #include <nodes/include/AccumulatorNode.h>
 #include <nodes/include/ClockNode.h>
 #include <nodes/include/ConstantNode.h>
 #include <nodes/include/DelayNode.h>
 #include <nodes/include/DotProductNode.h>
+#include <nodes/include/FFTNode.h>
 #include <nodes/include/ForestPredictorNode.h>
 #include <nodes/include/L2NormSquaredNode.h>
 #include <nodes/include/LinearPredictorNode.h>
@@ -36,19 +42,36 @@
 #include <emitters/include/EmitterTypes.h>
 #include <emitters/include/IREmitter.h>
 #include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRExternalWeights.h>
+#include <emitters/include/IRFunctionVariants.h>
+#include <emitters/include/IRMemoryUsage.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRObjectCache.h>
+#include <emitters/include/IRReentrancy.h>
 #include <emitters/include/ScalarVariable.h>
+#include <emitters/include/TargetDevice.h>
 #include <emitters/include/VectorVariable.h>
 
 #include <predictors/include/LinearPredictor.h>
 #include <predictors/include/ProtoNNPredictor.h>
 
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
+#include <utilities/include/MemoryMappedFile.h>
+#include <utilities/include/StringUtil.h>
 
 #include <testing/include/testing.h>
 
+#include <llvm/IR/Constants.h>
+
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <memory>
 #include <ostream>
+#include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -231,6 +254,11 @@ void TestProtoNNPredictorMap()
     model::IRMapCompiler compiler(settings, optimizerOptions);
     auto compiledMap = compiler.Compile(map);
 
+    model::ModelOptimizerOptions thresholdOptimizerOptions;
+    thresholdOptimizerOptions.SetEntry("protoNNSimilarityThreshold", 1e-7);
+    model::IRMapCompiler thresholdCompiler(settings, thresholdOptimizerOptions);
+    auto thresholdCompiledMap = thresholdCompiler.Compile(map);
+
     testing::ProcessTest("Testing IsValid of original map", testing::IsEqual(compiledMap.IsValid(), true));
 
     for (unsigned i = 0; i < features.size(); ++i)
@@ -255,6 +283,11 @@ void TestProtoNNPredictorMap()
         compiledMap.SetInputValue(0, input);
         auto compiledOutput = compiledMap.ComputeOutput<double>(0);
         testing::ProcessTest("refined and compiled output vectors don't match", IsEqual(refinedOutput, compiledOutput, 1e-5));
+
+        // Skipping the prototypes with negligible similarity only changes the scores by their contributions
+        thresholdCompiledMap.SetInputValue(0, input);
+        auto thresholdOutput = thresholdCompiledMap.ComputeOutput<double>(0);
+        testing::ProcessTest("compiled output with similarity threshold doesn't match", IsEqual(refinedOutput, thresholdOutput, 1e-4));
     }
 }
 
@@ -534,6 +567,830 @@ void TestSqrt()
     PrintIR(compiledMap);
 }
 
+namespace
+{
+// Creates a chain of nodes where the first intermediate result stays live until near the end
+model::Map MakeIntermediateBufferMap(ModelMaker& mb)
+{
+    auto input1 = mb.Inputs<double>(8);
+    auto sqrt1 = mb.Sqrt<double>(input1->output);
+    auto sqrt2 = mb.Sqrt<double>(sqrt1->output);
+    auto sqrt3 = mb.Sqrt<double>(sqrt2->output);
+    auto sum = mb.Add<double>(sqrt3->output, sqrt1->output);
+    auto sqrt4 = mb.Sqrt<double>(sum->output);
+    auto outputNode = mb.Outputs<double>(sqrt4->output);
+    return { mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+}
+} // namespace
+
+void TestPortBufferAllocator()
+{
+    ModelMaker mb;
+    auto map = MakeIntermediateBufferMap(mb);
+    const auto& model = map.GetModel();
+
+    model::PortBufferAllocator allocator(model);
+    std::vector<size_t> bufferIndices;
+    model.Visit([&](const model::Node& node) {
+        // The input and output ports are function arguments
+        if (node.GetInputPorts().size() > 0 && dynamic_cast<const model::OutputNodeBase*>(&node) == nullptr)
+        {
+            for (auto output : node.GetOutputPorts())
+            {
+                bufferIndices.push_back(allocator.AllocateBuffer(*output));
+            }
+        }
+        allocator.ReleaseBuffers(node);
+    });
+
+    // sqrt2 and sum can share a buffer, as can sqrt1 and sqrt4
+    std::vector<size_t> expectedIndices = { 0, 1, 2, 1, 0 };
+    testing::ProcessTest("Testing PortBufferAllocator buffer assignment", bufferIndices == expectedIndices);
+    testing::ProcessTest("Testing PortBufferAllocator buffer count", allocator.NumBuffers() == 3 && allocator.NumAllocatedPorts() == 5);
+    testing::ProcessTest("Testing PortBufferAllocator total size", allocator.GetTotalBufferSize() == 3 * 8);
+}
+
+void TestReuseIntermediateBuffers()
+{
+    ModelMaker mb;
+    auto map = MakeIntermediateBufferMap(mb);
+
+    model::MapCompilerOptions settings;
+    settings.reuseIntermediateBuffers = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 16, 25, 36, 49, 64, 81, 100 }, { 0.5, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5, 7.5 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "ReuseIntermediateBuffers");
+}
+
+void TestAliasPortBuffers()
+{
+    // The slice is a view of the first sqrt's output, and the second sqrt and the sum write straight into the splice's output
+    ModelMaker mb;
+    auto input1 = mb.Inputs<double>(8);
+    auto sqrt1 = mb.Sqrt<double>(input1->output);
+    auto slice = mb.Model.AddNode<model::SliceNode<double>>(sqrt1->output, 2, 4);
+    auto sqrt2 = mb.Sqrt<double>(slice->output);
+    auto sum = mb.Add<double>(slice->output, sqrt2->output);
+    auto splice = mb.Model.AddNode<model::SpliceNode<double>>(std::vector<const model::OutputPortBase*>{ &sqrt2->output, &sum->output });
+    auto sqrt3 = mb.Sqrt<double>(splice->output);
+    auto outputNode = mb.Outputs<double>(sqrt3->output);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 16, 25, 36, 49, 64, 81, 100 } };
+    for (bool reuseIntermediateBuffers : { false, true })
+    {
+        model::MapCompilerOptions settings;
+        settings.aliasPortBuffers = true;
+        settings.reuseIntermediateBuffers = reuseIntermediateBuffers;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+        PrintIR(compiledMap);
+        VerifyCompiledOutput(map, compiledMap, signal, reuseIntermediateBuffers ? "AliasPortBuffers with shared buffers" : "AliasPortBuffers");
+    }
+}
+
+void TestStackPortBuffers()
+{
+    ModelMaker mb;
+    auto map = MakeIntermediateBufferMap(mb);
+
+    // The intermediate ports hold 8 doubles, so they go on the stack with a 64-byte limit, and stay global with a 32-byte one
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 16, 25, 36, 49, 64, 81, 100 } };
+    for (int maxStackPortBufferSize : { 32, 64 })
+    {
+        for (bool inlineNodes : { false, true })
+        {
+            model::MapCompilerOptions settings;
+            settings.maxStackPortBufferSize = maxStackPortBufferSize;
+            settings.inlineNodes = inlineNodes;
+            model::ModelOptimizerOptions optimizerOptions;
+            model::IRMapCompiler compiler(settings, optimizerOptions);
+            auto compiledMap = compiler.Compile(map);
+            PrintIR(compiledMap);
+            VerifyCompiledOutput(map, compiledMap, signal, "StackPortBuffers (" + std::to_string(maxStackPortBufferSize) + " bytes" + (inlineNodes ? ", inline nodes)" : ")"));
+        }
+    }
+}
+
+void TestSelectiveNodeInlining()
+{
+    ModelMaker mb;
+    auto input1 = mb.Inputs<double>(8);
+    auto sqrt1 = mb.Sqrt<double>(input1->output);
+    auto dot = mb.DotProduct<double>(sqrt1->output, input1->output);
+    auto outputNode = mb.Outputs<double>(dot->output);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+
+    model::MapCompilerOptions settings;
+    settings.inlineElementwiseNodes = true;
+    model::IRMapCompiler compiler(settings, {});
+    testing::ProcessTest("Testing inlining elementwise nodes", compiler.ShouldInlineNode(*sqrt1) && !compiler.ShouldInlineNode(*dot));
+
+    // The dot product's ports hold 17 elements
+    settings.inlineElementwiseNodes = false;
+    settings.inlineNodeSizeLimit = 16;
+    model::IRMapCompiler smallLimitCompiler(settings, {});
+    settings.inlineNodeSizeLimit = 17;
+    model::IRMapCompiler largeLimitCompiler(settings, {});
+    testing::ProcessTest("Testing inlining small nodes", !smallLimitCompiler.ShouldInlineNode(*dot) && largeLimitCompiler.ShouldInlineNode(*dot) && largeLimitCompiler.ShouldInlineNode(*sqrt1));
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 16, 25, 36, 49, 64, 81, 100 } };
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+    VerifyCompiledOutput(map, compiledMap, signal, "SelectiveNodeInlining");
+}
+
+void TestObjectCache()
+{
+    auto cacheDirectory = utilities::JoinPaths(OutputPath(""), "objectCache");
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.objectCacheDirectory = cacheDirectory;
+    model::ModelOptimizerOptions optimizerOptions;
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 16, 25, 36, 49, 64, 81, 100 }, { 0.5, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5, 7.5 } };
+
+    // The first compile fills the cache, and the second one loads the object code back from it
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+        ModelMaker mb;
+        auto map = MakeIntermediateBufferMap(mb);
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, "ObjectCache_" + std::to_string(iteration));
+
+        emitters::IRObjectCache cache(cacheDirectory, compiledMap.GetObjectCacheKey());
+        testing::ProcessTest("Testing object cache contains the compiled map", cache.HasObject(compiledMap.GetModule().GetModuleName()));
+    }
+
+    // Settings that change the emitted code, like the size below which matrix products are unrolled, change the key
+    ModelMaker mb;
+    auto map = MakeIntermediateBufferMap(mb);
+    auto key = model::IRMapCompiler(settings, optimizerOptions).Compile(map).GetObjectCacheKey();
+    auto unrollSettings = settings;
+    unrollSettings.compilerSettings.smallMatrixThreshold = 0;
+    auto unrollKey = model::IRMapCompiler(unrollSettings, optimizerOptions).Compile(map).GetObjectCacheKey();
+    testing::ProcessTest("Testing object cache key depends on the small matrix threshold", key != unrollKey);
+}
+
+void TestNodeFunctionCache()
+{
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.cacheNodeFunctions = true;
+    settings.nodeFunctionCacheDirectory = utilities::JoinPaths(OutputPath(""), "nodeFunctionCache");
+    model::ModelOptimizerOptions optimizerOptions;
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 16, 25, 36, 49, 64, 81, 100 }, { 0.5, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5, 7.5 } };
+
+    // The first compile emits the node functions, and the second one links them in from the cache
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+        ModelMaker mb;
+        auto map = MakeIntermediateBufferMap(mb);
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, "NodeFunctionCache_" + std::to_string(iteration));
+    }
+}
+
+void TestJitCompilationModes()
+{
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 16, 25, 36, 49, 64, 81, 100 }, { 0.5, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5, 7.5 } };
+    for (auto mode : { emitters::JitCompilationMode::lazy, emitters::JitCompilationMode::background })
+    {
+        ModelMaker mb;
+        auto map = MakeIntermediateBufferMap(mb);
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.jitCompilationMode = mode;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+        VerifyCompiledOutput(map, compiledMap, signal, "JitCompilationMode_" + emitters::ToString(mode));
+    }
+}
+
+void TestCompileTimingReport()
+{
+    ModelMaker mb;
+    auto map = MakeIntermediateBufferMap(mb);
+    model::MapCompilerOptions settings;
+    settings.recordCompileTimings = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    const auto& phases = compiledMap.GetCompileTimingReport().GetPhases();
+    std::stringstream reportText;
+    model::WriteCompileTimingReport(compiledMap.GetCompileTimingReport(), reportText);
+    std::cout << reportText.str();
+    auto findPhase = [&phases](const std::string& name) {
+        return std::find_if(phases.begin(), phases.end(), [&name](const model::CompilePhaseTiming& phase) { return phase.name == name; });
+    };
+    auto optimizePhase = findPhase("Optimize model");
+    testing::ProcessTest("Testing compile timing report has the compile phases", findPhase("Emit node code") != phases.end() && findPhase("Optimize IR") != phases.end());
+    testing::ProcessTest("Testing compile timing report nests the model phases", optimizePhase != phases.end() && optimizePhase->depth == 1 && (optimizePhase + 1) != phases.end() && (optimizePhase + 1)->depth == 2);
+    testing::ProcessTest("Testing compile timing report has the peak memory", optimizePhase != phases.end() && (optimizePhase->peakMemory > 0 || model::GetPeakResidentSetSize() == 0));
+
+    model::IRMapCompiler untimedCompiler;
+    auto untimedMap = untimedCompiler.Compile(map);
+    testing::ProcessTest("Testing compile timing report is empty by default", untimedMap.GetCompileTimingReport().GetPhases().empty());
+}
+
+void TestFunctionVariants()
+{
+    ModelMaker mb;
+    auto map = MakeIntermediateBufferMap(mb);
+
+    // Emit a variant of each node function for every feature set known for the host, whether or not this machine has them
+    model::MapCompilerOptions settings;
+    auto hostVariants = emitters::GetFunctionVariantNames(emitters::GetTargetDevice("host"));
+    settings.compilerSettings.functionVariants = utilities::Join(hostVariants, ",");
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 16, 25, 36, 49, 64, 81, 100 }, { 0.5, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5, 7.5 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "FunctionVariants");
+}
+
+void TestBatchPredictFunction()
+{
+    std::vector<double> data = { 5, 10, 15, 20 };
+
+    ModelMaker mb;
+    auto c1 = mb.Constant<double>(data);
+    auto input1 = mb.Inputs<double>(4);
+    auto product = mb.Multiply<double>(c1->output, input1->output);
+    auto sqrt = mb.Sqrt<double>(product->output);
+    auto outputNode = mb.Outputs<double>(sqrt->output);
+
+    model::MapCompilerOptions settings;
+    settings.emitBatchFunction = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+    model::IRCompiledMap compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { 4, 3, 2, 1 }, { 0.5, 1.5, 2.5, 3.5 }, { 9, 8, 7, 6 } };
+    auto batchResult = compiledMap.ComputeBatch<double, double>(signal);
+
+    bool ok = batchResult.size() == signal.size();
+    for (size_t index = 0; ok && index < signal.size(); ++index)
+    {
+        ok = testing::IsEqual(map.Compute<double, double>(signal[index]), batchResult[index]);
+    }
+    testing::ProcessTest("Testing compiled batch predict function", ok);
+}
+
+void TestBatchedMatrixProducts()
+{
+    const int m = 3;
+    const int n = 4;
+    math::RowMatrix<double> weights(m, n);
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            weights(i, j) = 0.25 * (i + 1) + 0.5 * j;
+        }
+    }
+
+    ModelMaker mb;
+    auto input1 = mb.Inputs<double>(n);
+    auto product = mb.Model.AddNode<nodes::MatrixVectorProductNode<double, math::MatrixLayout::rowMajor>>(input1->output, weights);
+    auto sqrt = mb.Sqrt<double>(product->output);
+    auto outputNode = mb.Outputs<double>(sqrt->output);
+
+    // 11 samples: two batches of 4, which each do one matrix product, and 3 more computed one at a time
+    model::MapCompilerOptions settings;
+    settings.emitBatchFunction = true;
+    settings.batchFunctionSize = 4;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+    model::IRCompiledMap compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    bool hasBatchedFunction = false;
+    for (const auto& function : compiledMap.GetModule().GetLLVMModule()->functions())
+    {
+        hasBatchedFunction = hasBatchedFunction || function.getName().endswith("_batch_4");
+    }
+    testing::ProcessTest("Testing batch predict function computes whole batches with a batched map", hasBatchedFunction);
+
+    std::vector<std::vector<double>> signal;
+    for (int index = 0; index < 11; ++index)
+    {
+        signal.push_back({ 1.0 + index, 2.0, 0.5 * index, 3.0 - 0.25 * index });
+    }
+    auto batchResult = compiledMap.ComputeBatch<double, double>(signal);
+
+    bool ok = batchResult.size() == signal.size();
+    for (size_t index = 0; ok && index < signal.size(); ++index)
+    {
+        ok = testing::IsEqual(map.Compute<double, double>(signal[index]), batchResult[index], 1e-8);
+    }
+    testing::ProcessTest("Testing compiled batch predict function with batched matrix products", ok);
+}
+
+void TestAsyncPredictFunctions()
+{
+    std::vector<double> data = { 5, 10, 15, 20 };
+
+    ModelMaker mb;
+    auto c1 = mb.Constant<double>(data);
+    auto input1 = mb.Inputs<double>(4);
+    auto product = mb.Multiply<double>(c1->output, input1->output);
+    auto delay = mb.Delay<double>(product->output, 1);
+    auto outputNode = mb.Outputs<double>(delay->output);
+
+    model::MapCompilerOptions settings;
+    settings.emitAsyncFunctions = true;
+    settings.compilerSettings.parallelize = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+    model::IRCompiledMap compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    // The frames share one input buffer, which is refilled as soon as each frame has been started
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { 4, 3, 2, 1 }, { 0.5, 1.5, 2.5, 3.5 }, { 9, 8, 7, 6 }, { 2, 4, 6, 8 } };
+    std::vector<double> input(4);
+    std::vector<std::vector<double>> asyncResult(signal.size(), std::vector<double>(4));
+    for (size_t index = 0; index < signal.size(); ++index)
+    {
+        input = signal[index];
+        compiledMap.StartComputeAsync(input.data(), input.size(), asyncResult[index].data(), asyncResult[index].size());
+    }
+    compiledMap.WaitForComputeAsync();
+
+    bool ok = true;
+    for (size_t index = 0; index < signal.size(); ++index)
+    {
+        ok = ok && testing::IsEqual(map.Compute<double, double>(signal[index]), asyncResult[index]);
+    }
+    testing::ProcessTest("Testing compiled async predict functions", ok);
+}
+
+void TestReentrantMap()
+{
+    ModelMaker mb;
+    auto input1 = mb.Inputs<double>(4);
+    auto delay = mb.Delay<double>(input1->output, 2);
+    auto outputNode = mb.Outputs<double>(delay->output);
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.reentrant = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    model::Map map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+    model::IRCompiledMap compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    using ReentrantPredictFunction = void (*)(void*, void*, double*, double*);
+    auto& jitter = compiledMap.GetJitter();
+    const auto moduleName = compiledMap.GetModule().GetModuleName();
+    auto getStateSize = reinterpret_cast<int64_t (*)()>(jitter.ResolveFunctionAddress(moduleName + "_GetStateSize"));
+    auto getStateAlignment = reinterpret_cast<int64_t (*)()>(jitter.ResolveFunctionAddress(moduleName + "_GetStateAlignment"));
+    auto initializeState = reinterpret_cast<void (*)(void*)>(jitter.ResolveFunctionAddress(moduleName + "_InitializeState"));
+    auto predict = reinterpret_cast<ReentrantPredictFunction>(jitter.ResolveFunctionAddress(emitters::GetReentrantFunctionName(settings.mapFunctionName)));
+
+    // Two instances of the model, each with its own (suitably aligned) state
+    auto stateSize = static_cast<size_t>(getStateSize());
+    auto stateAlignment = static_cast<size_t>(getStateAlignment());
+    std::vector<std::vector<char>> stateBuffers(2, std::vector<char>(stateSize + stateAlignment));
+    std::vector<void*> states;
+    for (auto& buffer : stateBuffers)
+    {
+        void* state = buffer.data();
+        auto space = buffer.size();
+        states.push_back(std::align(stateAlignment, stateSize, state, space));
+        initializeState(states.back());
+    }
+
+    // Interleave the calls to the two instances, and check each one matches the model running on its signal alone
+    std::vector<std::vector<std::vector<double>>> signals = { { { 1, 2, 3, 4 }, { 5, 6, 7, 8 }, { 9, 10, 11, 12 }, { 13, 14, 15, 16 } },
+                                                              { { -1, -2, -3, -4 }, { -5, -6, -7, -8 }, { -9, -10, -11, -12 }, { -13, -14, -15, -16 } } };
+    std::vector<std::vector<std::vector<double>>> expected(signals.size());
+    for (size_t instance = 0; instance < signals.size(); ++instance)
+    {
+        map.Reset();
+        for (const auto& input : signals[instance])
+        {
+            expected[instance].push_back(map.Compute<double, double>(input));
+        }
+    }
+
+    bool ok = true;
+    for (size_t step = 0; step < signals[0].size(); ++step)
+    {
+        for (size_t instance = 0; instance < signals.size(); ++instance)
+        {
+            std::vector<double> output(4);
+            predict(states[instance], nullptr, signals[instance][step].data(), output.data());
+            ok = ok && testing::IsEqual(output, expected[instance][step]);
+        }
+    }
+    testing::ProcessTest("Testing reentrant predict function with separate states", ok);
+
+    // The original predict function still works, using the module's default state
+    std::vector<double> output;
+    for (const auto& input : signals[0])
+    {
+        output = compiledMap.Compute<double, double>(input);
+    }
+    testing::ProcessTest("Testing predict function of reentrant map", testing::IsEqual(output, expected[0].back()));
+
+    // Parallel tasks and function variants are called through function pointers, which can't take the state
+    auto isRejected = [&](const model::MapCompilerOptions& unsupportedSettings) {
+        try
+        {
+            model::IRMapCompiler(unsupportedSettings, optimizerOptions).Compile(map);
+        }
+        catch (const emitters::EmitterException&)
+        {
+            return true;
+        }
+        return false;
+    };
+    auto parallelSettings = settings;
+    parallelSettings.compilerSettings.parallelize = true;
+    auto variantSettings = settings;
+    variantSettings.compilerSettings.functionVariants = "avx2";
+    testing::ProcessTest("Testing reentrant map with parallelize is rejected", isRejected(parallelSettings));
+    testing::ProcessTest("Testing reentrant map with function variants is rejected", isRejected(variantSettings));
+}
+
+void TestExternalWeights()
+{
+    auto makeMap = [](ModelMaker& mb, const std::vector<double>& weights) {
+        auto c1 = mb.Constant<double>(weights);
+        auto input1 = mb.Inputs<double>(4);
+        auto product = mb.Multiply<double>(c1->output, input1->output);
+        auto outputNode = mb.Outputs<double>(product->output);
+        return model::Map{ mb.Model, { { "input", input1 } }, { { "output", outputNode->output } } };
+    };
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.externalWeights = true;
+    model::ModelOptimizerOptions optimizerOptions;
+
+    ModelMaker mb1;
+    auto map1 = makeMap(mb1, { 5, 10, 15, 20 });
+    model::IRMapCompiler compiler1(settings, optimizerOptions);
+    auto compiledMap1 = compiler1.Compile(map1);
+    PrintIR(compiledMap1);
+    testing::ProcessTest("Testing compiled map has external weights", compiledMap1.HasExternalWeights());
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { 4, 3, 2, 1 } };
+    VerifyCompiledOutput(map1, compiledMap1, signal, "ExternalWeights");
+
+    // Swap in the weights of another model of the same shape, loaded from a file
+    ModelMaker mb2;
+    auto map2 = makeMap(mb2, { -1, 0.5, 2, 4 });
+    model::IRMapCompiler compiler2(settings, optimizerOptions);
+    auto compiledMap2 = compiler2.Compile(map2);
+    auto weightsFilename = OutputPath("ExternalWeights.weights");
+    compiledMap2.WriteExternalWeights(weightsFilename);
+    utilities::MemoryMappedFile weightsFile(weightsFilename);
+
+    auto& jitter = compiledMap1.GetJitter();
+    const auto moduleName = compiledMap1.GetModule().GetModuleName();
+    auto getWeightsSize = reinterpret_cast<int64_t (*)()>(jitter.ResolveFunctionAddress(moduleName + "_GetWeightsSize"));
+    auto setWeights = reinterpret_cast<int32_t (*)(char*)>(jitter.ResolveFunctionAddress(moduleName + "_SetWeights"));
+    testing::ProcessTest("Testing external weights size", static_cast<size_t>(getWeightsSize()) == weightsFile.GetSize());
+    testing::ProcessTest("Testing setting external weights", setWeights(static_cast<char*>(weightsFile.GetData())) == 1);
+
+    bool ok = true;
+    for (const auto& input : signal)
+    {
+        ok = ok && testing::IsEqual(compiledMap1.Compute<double, double>(input), map2.Compute<double, double>(input));
+    }
+    testing::ProcessTest("Testing compiled map with swapped external weights", ok);
+
+    // A blob for a model of a different shape is rejected
+    std::vector<char> wrongWeights(static_cast<char*>(weightsFile.GetData()), static_cast<char*>(weightsFile.GetData()) + weightsFile.GetSize());
+    wrongWeights[8] ^= 1; // the size field of the header
+    std::vector<char> wrongWeightsBuffer(wrongWeights.size() + emitters::c_externalWeightsAlignment);
+    void* alignedWrongWeights = wrongWeightsBuffer.data();
+    auto space = wrongWeightsBuffer.size();
+    std::align(emitters::c_externalWeightsAlignment, wrongWeights.size(), alignedWrongWeights, space);
+    std::copy(wrongWeights.begin(), wrongWeights.end(), static_cast<char*>(alignedWrongWeights));
+    testing::ProcessTest("Testing mismatched external weights are rejected", setWeights(static_cast<char*>(alignedWrongWeights)) == 0);
+}
+
+void TestStaticMemory()
+{
+    // The FFT node keeps its complex working buffer in a stack array
+    const size_t fftSize = 64;
+    ModelMaker mb;
+    auto inputNode = mb.Inputs<double>(fftSize);
+    auto fftNode = mb.Model.AddNode<nodes::FFTNode<double>>(inputNode->output, fftSize);
+    auto outputNode = mb.Outputs<double>(fftNode->output);
+    model::Map map{ mb.Model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.staticMemory = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    bool hasScratchGlobal = false;
+    for (const auto& global : compiledMap.GetModule().GetLLVMModule()->globals())
+    {
+        hasScratchGlobal = hasScratchGlobal || global.getName().endswith("_scratch");
+    }
+    testing::ProcessTest("Testing static memory moves scratch arrays to globals", hasScratchGlobal);
+
+    std::vector<std::vector<double>> signal(2, std::vector<double>(fftSize));
+    for (size_t i = 0; i < fftSize; ++i)
+    {
+        signal[0][i] = std::sin(0.3 * i);
+        signal[1][i] = (i % 4) - 1.5;
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, "StaticMemory");
+
+    testing::ProcessTest("Testing Cortex-M4 has the DSP extension", emitters::GetTargetDevice("cortex-m4").HasDSPExtension());
+    testing::ProcessTest("Testing Raspberry Pi 3 has no DSP extension", !emitters::GetTargetDevice("pi3").HasDSPExtension());
+}
+
+void TestDeduplicateConstants()
+{
+    // Two constant nodes with the same values, like tied weights
+    std::vector<double> weights = { 5, 10, 15, 20 };
+    ModelMaker mb;
+    auto inputNode = mb.Inputs<double>(4);
+    auto c1 = mb.Constant<double>(weights);
+    auto c2 = mb.Constant<double>(weights);
+    auto product = mb.Multiply<double>(c1->output, inputNode->output);
+    auto sum = mb.Add<double>(product->output, c2->output);
+    auto outputNode = mb.Outputs<double>(sum->output);
+    model::Map map{ mb.Model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    // Without optimization, so the constants aren't folded into the code
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = false;
+    settings.compilerSettings.shareConstantsAcrossModules = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    std::set<const llvm::Constant*> initializers;
+    bool hasDuplicates = false;
+    bool hasSharedConstant = false;
+    for (const auto& global : compiledMap.GetModule().GetLLVMModule()->globals())
+    {
+        if (global.isConstant() && global.hasInitializer() && llvm::isa<llvm::ConstantDataSequential>(global.getInitializer()))
+        {
+            hasDuplicates = hasDuplicates || !initializers.insert(global.getInitializer()).second;
+            hasSharedConstant = hasSharedConstant || global.getName().startswith("ELL_SharedConstant_");
+        }
+    }
+    testing::ProcessTest("Testing identical constants are stored once", !hasDuplicates);
+    testing::ProcessTest("Testing constants are named for sharing across modules", hasSharedConstant);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { 4, 3, 2, 1 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "DeduplicateConstants");
+}
+
+void TestWeightsPlacement()
+{
+    // A large weight array, which is placed, and a small one, which isn't
+    std::vector<double> weights = { 5, 10, 15, 20, 25, 30, 35, 40 };
+    ModelMaker mb;
+    auto inputNode = mb.Inputs<double>(8);
+    auto largeConstant = mb.Constant<double>(weights);
+    auto smallConstant = mb.Constant<double>(2.0);
+    auto dotProduct = mb.Model.AddNode<nodes::DotProductNode<double>>(largeConstant->output, inputNode->output);
+    auto sum = mb.Add<double>(dotProduct->output, smallConstant->output);
+    auto outputNode = mb.Outputs<double>(sum->output);
+    model::Map map{ mb.Model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    // ELF section names, so the test only places the weights in a section when JIT-compiling for Linux
+    const bool useSection = emitters::GetTargetDevice("host").IsLinux();
+    const std::string sectionName = useSection ? ".rodata.ell_weights" : "";
+    const uint64_t alignment = 4096;
+
+    // Without optimization, so the constants aren't folded into the code
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = false;
+    settings.compilerSettings.weightsSection = sectionName;
+    settings.compilerSettings.weightsAlignment = static_cast<int>(alignment);
+    settings.compilerSettings.weightsPlacementThreshold = static_cast<int>(weights.size() * sizeof(double));
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    bool largeIsPlaced = false;
+    bool smallIsPlaced = false;
+    for (const auto& global : compiledMap.GetModule().GetLLVMModule()->globals())
+    {
+        if (!emitters::IsWeightsGlobal(global))
+        {
+            continue;
+        }
+        bool isPlaced = global.getAlignment() == alignment && global.getSection() == sectionName;
+        if (global.getValueType()->isArrayTy() && global.getValueType()->getArrayNumElements() == weights.size())
+        {
+            largeIsPlaced = isPlaced;
+        }
+        else
+        {
+            smallIsPlaced = smallIsPlaced || isPlaced;
+        }
+    }
+    testing::ProcessTest("Testing large weights are placed in the weights section", largeIsPlaced);
+    testing::ProcessTest("Testing small weights are left in place", !smallIsPlaced);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 8, 7, 6, 5, 4, 3, 2, 1 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "WeightsPlacement");
+}
+
+void TestPGOInstrumentation()
+{
+    ModelMaker mb;
+    auto inputNode = mb.Inputs<double>(4);
+    auto sumNode = mb.Model.AddNode<nodes::SumNode<double>>(inputNode->output);
+    auto outputNode = mb.Outputs<double>(sumNode->output);
+    model::Map map{ mb.Model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    // The instrumented code needs the LLVM profile runtime, so it's only inspected, not run
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.pgoInstrumentFile = OutputPath("PGOInstrumentation.profraw");
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    bool hasCounters = false;
+    for (const auto& global : compiledMap.GetModule().GetLLVMModule()->globals())
+    {
+        hasCounters = hasCounters || global.getName().startswith("__profc_");
+    }
+    testing::ProcessTest("Testing instrumented code has profile counters", hasCounters);
+
+    // A missing profile is an error rather than silently unoptimized code
+    model::MapCompilerOptions useSettings;
+    useSettings.compilerSettings.pgoProfileFile = OutputPath("PGOInstrumentation_missing.profdata");
+    model::IRMapCompiler useCompiler(useSettings, optimizerOptions);
+    bool threw = false;
+    try
+    {
+        useCompiler.Compile(map);
+    }
+    catch (const utilities::SystemException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("Testing a missing profile file is an error", threw);
+}
+
+void TestParallelBranches()
+{
+    // An ensemble of three members whose outputs are added together
+    ModelMaker mb;
+    auto inputNode = mb.Inputs<double>(8);
+    std::vector<const model::OutputPort<double>*> memberOutputs;
+    for (int member = 0; member < 3; ++member)
+    {
+        std::vector<double> weights(8);
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            weights[i] = member + 0.5 * i;
+        }
+        auto weightsNode = mb.Constant<double>(weights);
+        auto product = mb.Multiply<double>(weightsNode->output, inputNode->output);
+        auto sumNode = mb.Model.AddNode<nodes::SumNode<double>>(product->output);
+        memberOutputs.push_back(&sumNode->output);
+    }
+    auto partialSum = mb.Add<double>(*memberOutputs[0], *memberOutputs[1]);
+    auto total = mb.Add<double>(partialSum->output, *memberOutputs[2]);
+    auto outputNode = mb.Outputs<double>(total->output);
+    model::Map map{ mb.Model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    std::vector<const model::Node*> nodes;
+    map.GetModel().Visit([&nodes](const model::Node& node) { nodes.push_back(&node); });
+    auto order = model::GetParallelBranchOrder(nodes);
+    bool isSplit = order.sources.size() == 4 && order.branches.size() == 3 && order.tail.size() == 3;
+    for (const auto& branch : order.branches)
+    {
+        isSplit = isSplit && branch.size() == 2;
+    }
+    testing::ProcessTest("Testing ensemble members are independent branches", isSplit);
+
+    model::MapCompilerOptions settings;
+    settings.parallelizeBranches = true;
+    settings.compilerSettings.parallelize = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    bool hasBranchTask = false;
+    for (const auto& function : compiledMap.GetModule().GetLLVMModule()->functions())
+    {
+        hasBranchTask = hasBranchTask || function.getName().endswith("_branchTask");
+    }
+    testing::ProcessTest("Testing ensemble members are computed by parallel tasks", hasBranchTask);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 8, 7, 6, 5, 4, 3, 2, 1 }, { 0, 1, 0, -1, 0, 1, 0, -1 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "ParallelBranches");
+}
+
+void TestNoHeap()
+{
+    ModelMaker mb;
+    auto inputNode = mb.Inputs<double>(64);
+    auto fftNode = mb.Model.AddNode<nodes::FFTNode<double>>(inputNode->output, 64);
+    auto sumNode = mb.Model.AddNode<nodes::SumNode<double>>(fftNode->output);
+    auto outputNode = mb.Outputs<double>(sumNode->output);
+    model::Map map{ mb.Model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    model::MapCompilerOptions settings;
+    settings.noHeap = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    testing::ProcessTest("Testing no-heap mode shares buffers", compiler.GetMapCompilerOptions().reuseIntermediateBuffers && compiler.GetMapCompilerOptions().compilerSettings.staticMemory);
+
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+    std::vector<std::vector<double>> signal(1, std::vector<double>(64));
+    for (size_t i = 0; i < 64; ++i)
+    {
+        signal[0][i] = std::cos(0.2 * i);
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, "NoHeap");
+
+    const auto& report = compiledMap.GetMemoryReport();
+    std::stringstream reportText;
+    model::WriteMemoryReport(report, reportText);
+    std::cout << reportText.str();
+    testing::ProcessTest("Testing memory report has no heap allocation", report.heapFunctions.empty());
+    testing::ProcessTest("Testing memory report has the node buffers", !report.nodes.empty() && report.GetPeakLiveBufferSize() >= 64 * sizeof(double));
+    testing::ProcessTest("Testing memory report static memory holds the buffers", report.staticMemorySize >= report.GetPeakLiveBufferSize());
+
+    // Code that calls `malloc` is rejected
+    emitters::IRModuleEmitter module("NoHeapTest", emitters::CompilerOptions{});
+    auto& function = module.BeginFunction("AllocatesMemory", emitters::VariableType::Void);
+    function.Malloc<double>(10);
+    module.EndFunction();
+    bool threw = false;
+    try
+    {
+        emitters::VerifyNoHeapAllocation(module);
+    }
+    catch (const emitters::EmitterException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("Testing no-heap mode rejects code that calls malloc", threw);
+}
+
+void TestOptimizationRemarks()
+{
+    ModelMaker mb;
+    auto inputNode = mb.Inputs<float>(256);
+    auto sumNode = mb.Model.AddNode<nodes::SumNode<float>>(inputNode->output);
+    auto outputNode = mb.Outputs<float>(sumNode->output);
+    model::Map map{ mb.Model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    model::MapCompilerOptions settings;
+    settings.collectOptimizationRemarks = true;
+    settings.compilerSettings.optimize = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<std::vector<float>> signal = { GetRandomVector<float>(256, -1, 1) };
+    VerifyCompiledOutput(map, compiledMap, signal, "OptimizationRemarks");
+
+    const auto& remarks = compiledMap.GetOptimizationRemarks();
+    std::stringstream remarksText;
+    model::WriteOptimizationRemarks(remarks, remarksText);
+    std::cout << remarksText.str();
+
+    // The sum's loop is either vectorized or not, and either way the vectorizer says so about the node's function
+    bool foundSumRemark = false;
+    for (const auto& function : remarks.functions)
+    {
+        if (function.nodeType == sumNode->GetRuntimeTypeName())
+        {
+            foundSumRemark = function.Count(emitters::IROptimizationRemark::Kind::passed, "loop-vectorize") + function.Count(emitters::IROptimizationRemark::Kind::missed, "loop-vectorize") > 0;
+        }
+    }
+    testing::ProcessTest("Testing optimization remarks are traced back to the node", foundSumRemark);
+}
+
 void TestBinaryPredicate(bool expanded)
 {
     std::vector<double> data = { 5 };
@@ -14,22 +14,28 @@
 
 #include <data/include/DenseDataVector.h>
 
+#include <model/include/ComputeSchedule.h>
+#include <model/include/ExecutionContext.h>
 #include <model/include/InputNode.h>
 #include <model/include/Map.h>
+#include <model/include/MapPipeline.h>
 #include <model/include/Model.h>
 #include <model/include/OutputNode.h>
 #include <model/include/PortElements.h>
 
 #include <nodes/include/ClockNode.h>
 #include <nodes/include/ExtremalValueNode.h>
+#include <nodes/include/GateNode.h>
 #include <nodes/include/MovingAverageNode.h>
 #include <nodes/include/SinkNode.h>
 #include <nodes/include/SourceNode.h>
 
+#include <utilities/include/Exception.h>
 #include <utilities/include/JsonArchiver.h>
 
 #include <testing/include/testing.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <sstream>
@@ -102,6 +108,230 @@ void TestMapComputeDataVector()
     testing::ProcessTest("Testing map compute 2", testing::IsEqual(resultValues[0], 8.5) && testing::IsEqual(resultValues[1], 10.5));
 }
 
+void TestMapParallelCompute()
+{
+    auto model = GetSimpleModel();
+    auto inputNodes = model.GetNodesByType<model::InputNode<double>>();
+    auto outputNodes = model.GetNodesByType<model::OutputNode<double>>();
+
+    // The argmin and argmax branches of the model don't depend on each other
+    model::ComputeSchedule schedule(model, model::PortElementsBase{ outputNodes[0]->output });
+    testing::ProcessTest("Testing compute schedule", schedule.NumStages() == 5 && schedule.GetStage(1).size() == 2 && schedule.GetStage(2).size() == 2 && schedule.NumNodes() == model.Size());
+
+    auto map = model::Map(model, { { "doubleInput", inputNodes[0] } }, { { "doubleOutput", outputNodes[0]->output } });
+    auto parallelMap = map;
+    parallelMap.SetNumComputeThreads(2);
+
+    auto input = std::vector<std::vector<double>>{ { 1.0, 2.0, 3.0 },
+                                                   { 4.0, 5.0, 6.0 },
+                                                   { 7.0, 8.0, 9.0 },
+                                                   { 10.0, 11.0, 12.0 } };
+    bool ok = true;
+    std::vector<double> resultValues;
+    for (const auto& inVec : input)
+    {
+        map.SetInputValue("doubleInput", inVec);
+        parallelMap.SetInputValue("doubleInput", inVec);
+        auto serialValues = map.ComputeOutput<double>("doubleOutput");
+        resultValues = parallelMap.ComputeOutput<double>("doubleOutput");
+        ok = ok && testing::IsEqual(serialValues, resultValues);
+    }
+
+    testing::ProcessTest("Testing map parallel compute", ok && testing::IsEqual(resultValues[0], 8.5) && testing::IsEqual(resultValues[1], 10.5));
+}
+
+void TestMapExecutionContext()
+{
+    // in -> (argmin, argmax) -> out has no node with state of its own
+    model::Model model;
+    auto in = model.AddNode<model::InputNode<double>>(3);
+    auto minAndArgMin = model.AddNode<nodes::ArgMinNode<double>>(in->output);
+    auto maxAndArgMax = model.AddNode<nodes::ArgMaxNode<double>>(in->output);
+    auto out = model.AddNode<model::OutputNode<double>>(model::PortElements<double>({ minAndArgMin->val, maxAndArgMax->val }));
+    auto map = model::Map(model, { { "input", in } }, { { "output", out->output } });
+    map.SetNumComputeThreads(2);
+    testing::ProcessTest("Testing map is reentrant", map.IsReentrant());
+
+    // Several threads compute the same const map, each in its own context
+    const auto& sharedMap = map;
+    std::vector<int> threadResults(4, 1);
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < threadResults.size(); ++threadIndex)
+    {
+        threads.emplace_back([&sharedMap, &threadResults, threadIndex]() {
+            model::ExecutionContext context;
+            for (int index = 0; index < 200; ++index)
+            {
+                double value = static_cast<double>(threadIndex * 1000 + index);
+                auto result = sharedMap.Compute<double>(std::vector<double>{ value, value - 1, value + 1 }, context);
+                if (result != std::vector<double>{ value - 1, value + 1 })
+                {
+                    threadResults[threadIndex] = 0;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    bool ok = std::all_of(threadResults.begin(), threadResults.end(), [](int result) { return result == 1; });
+
+    // The map's own computation is unaffected
+    map.SetInputValue("input", std::vector<double>{ 5.0, 3.0, 4.0 });
+    auto mapResult = map.ComputeOutput<double>("output");
+    model::ExecutionContext context;
+    auto contextResult = sharedMap.Compute<data::DoubleDataVector>(data::DoubleDataVector(std::vector<double>{ 2.0, 1.0, 7.0 }), context).ToArray();
+    testing::ProcessTest("Testing map compute in execution contexts", ok && testing::IsEqual(mapResult, std::vector<double>{ 3.0, 5.0 }) && testing::IsEqual(contextResult, std::vector<double>{ 1.0, 7.0 }));
+
+    // Moving averages keep their samples in the node
+    auto simpleModel = GetSimpleModel();
+    auto inputNodes = simpleModel.GetNodesByType<model::InputNode<double>>();
+    auto outputNodes = simpleModel.GetNodesByType<model::OutputNode<double>>();
+    const auto statefulMap = model::Map(simpleModel, { { "doubleInput", inputNodes[0] } }, { { "doubleOutput", outputNodes[0]->output } });
+    bool threw = false;
+    try
+    {
+        statefulMap.Compute<double>(std::vector<double>{ 1.0, 2.0, 3.0 }, context);
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("Testing stateful map in execution context", !statefulMap.IsReentrant() && threw);
+}
+
+void TestMapPipeline()
+{
+    // in -> avg1 -> avg2 -> avg3 -> avg4 -> out, where the moving averages make each output depend on earlier inputs
+    model::Model model;
+    auto in = model.AddNode<model::InputNode<double>>(4);
+    const model::OutputPort<double>* previous = &in->output;
+    for (int index = 0; index < 4; ++index)
+    {
+        previous = &model.AddNode<nodes::MovingAverageNode<double>>(*previous, index + 2)->output;
+    }
+    auto out = model.AddNode<model::OutputNode<double>>(*previous);
+    auto map = model::Map(model, { { "input", in } }, { { "output", out->output } });
+
+    auto stages = model::SplitMapIntoStages(map, 3);
+    std::vector<model::Map*> stagePointers;
+    for (auto& stage : stages)
+    {
+        stagePointers.push_back(&stage);
+    }
+    bool ok = stages.size() == 3 && stages[0].GetInputName(0) == "input" && stages[2].GetOutputName(0) == "output";
+
+    std::vector<std::vector<double>> outputs;
+    {
+        model::MapPipeline pipeline(stagePointers, 2);
+        for (int index = 0; index < 10; ++index)
+        {
+            pipeline.Push({ double(index), double(2 * index), 1.0, -double(index) });
+            std::vector<double> output;
+            if (pipeline.TryPop(output))
+            {
+                outputs.push_back(output);
+            }
+        }
+        while (outputs.size() < 10)
+        {
+            outputs.push_back(pipeline.Pop());
+        }
+    }
+
+    for (int index = 0; index < 10; ++index)
+    {
+        map.SetInputValue(0, std::vector<double>{ double(index), double(2 * index), 1.0, -double(index) });
+        ok = ok && testing::IsEqual(map.ComputeOutput<double>(0), outputs[index]);
+    }
+    testing::ProcessTest("Testing map pipeline", ok);
+}
+
+void TestChainMaps()
+{
+    // featurizer: in -> avg -> out, classifier: in -> avg -> out
+    model::Model featurizerModel;
+    auto featurizerIn = featurizerModel.AddNode<model::InputNode<double>>(3);
+    auto featurizerAverage = featurizerModel.AddNode<nodes::MovingAverageNode<double>>(featurizerIn->output, 2);
+    auto featurizerOut = featurizerModel.AddNode<model::OutputNode<double>>(featurizerAverage->output);
+    auto featurizer = model::Map(featurizerModel, { { "audio", featurizerIn } }, { { "features", featurizerOut->output } });
+
+    model::Model classifierModel;
+    auto classifierIn = classifierModel.AddNode<model::InputNode<double>>(3);
+    auto classifierAverage = classifierModel.AddNode<nodes::MovingAverageNode<double>>(classifierIn->output, 3);
+    auto classifierOut = classifierModel.AddNode<model::OutputNode<double>>(classifierAverage->output);
+    auto classifier = model::Map(classifierModel, { { "features", classifierIn } }, { { "scores", classifierOut->output } });
+
+    auto chained = model::ChainMaps(featurizer, classifier);
+    bool ok = chained.GetInputName(0) == "audio" && chained.GetOutputName(0) == "scores";
+
+    // The featurizer's output node is dropped
+    int numOutputNodes = 0;
+    chained.GetModel().Visit([&numOutputNodes](const model::Node& node) {
+        numOutputNodes += dynamic_cast<const model::OutputNodeBase*>(&node) != nullptr ? 1 : 0;
+    });
+    ok = ok && numOutputNodes == 1;
+
+    for (int index = 0; index < 6; ++index)
+    {
+        std::vector<double> input = { double(index), double(index * index), -1.0 };
+        featurizer.SetInputValue(0, input);
+        classifier.SetInputValue(0, featurizer.ComputeOutput<double>(0));
+        chained.SetInputValue(0, input);
+        ok = ok && testing::IsEqual(classifier.ComputeOutput<double>(0), chained.ComputeOutput<double>(0));
+    }
+
+    bool threw = false;
+    try
+    {
+        model::Model otherModel;
+        auto otherIn = otherModel.AddNode<model::InputNode<double>>(4);
+        auto other = model::Map(otherModel, { { "input", otherIn } }, { { "output", otherIn->output } });
+        model::ChainMaps(featurizer, other);
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("Testing ChainMaps", ok && threw);
+}
+
+void TestMapGateNode()
+{
+    // in -> avg -> gate -> out, where the moving average is only computed on frames where the condition is true
+    model::Model model;
+    auto in = model.AddNode<model::InputNode<double>>(2);
+    auto condition = model.AddNode<model::InputNode<bool>>(1);
+    auto average = model.AddNode<nodes::MovingAverageNode<double>>(in->output, 2);
+    auto gate = model.AddNode<nodes::GateNode<double>>(average->output, condition->output);
+    auto out = model.AddNode<model::OutputNode<double>>(gate->output);
+    auto map = model::Map(model, { { "input", in }, { "condition", condition } }, { { "output", out->output } });
+
+    std::vector<const model::Node*> nodes;
+    map.GetModel().Visit([&nodes](const model::Node& node) { nodes.push_back(&node); });
+    auto order = model::GetGatedComputeOrder(nodes);
+    bool ok = order.gatedRanges.size() == 1 && order.gatedRanges[0].end - order.gatedRanges[0].begin == 1 &&
+              order.nodes[order.gatedRanges[0].begin]->GetRuntimeTypeName() == nodes::MovingAverageNode<double>::GetTypeName();
+
+    std::vector<double> previousInput = { 0, 0 };
+    std::vector<double> expected = { 0, 0 };
+    for (int index = 0; index < 8; ++index)
+    {
+        std::vector<double> input = { double(index), double(10 * index) };
+        bool isOpen = index % 3 != 1;
+        map.SetInputValue("input", input);
+        map.SetInputValue("condition", std::vector<bool>{ isOpen });
+        if (isOpen)
+        {
+            expected = { (input[0] + previousInput[0]) / 2, (input[1] + previousInput[1]) / 2 };
+            previousInput = input;
+        }
+        ok = ok && testing::IsEqual(map.ComputeOutput<double>("output"), expected);
+    }
+    testing::ProcessTest("Testing map gate node", ok);
+}
+
 void TestMapRefine()
 {
     auto model = GetSimpleModel();
@@ -37,12 +37,13 @@ using namespace ell::emitters;
 namespace
 {
 
-model::IRMapCompiler CreateMapCompiler(const std::string& moduleName, const std::string& mapFunctionName)
+model::IRMapCompiler CreateMapCompiler(const std::string& moduleName, const std::string& mapFunctionName, bool reentrant = false)
 {
     model::MapCompilerOptions settings;
     settings.moduleName = moduleName;
     settings.mapFunctionName = mapFunctionName;
     settings.compilerSettings.optimize = true;
+    settings.compilerSettings.reentrant = reentrant;
 
     return model::IRMapCompiler(settings, model::ModelOptimizerOptions{});
 }
@@ -162,6 +163,42 @@ void TestCppHeader()
     TestCppHeader<float>();
 }
 
+template <typename ElementType>
+void TestCppHeaderNoCallbacks(bool reentrant)
+{
+    auto mapCompiler = CreateMapCompiler("TestModule", "TestModule_Predict", reentrant);
+    auto compiledMap = GetCompiledMapNoCallbacks<ElementType>(mapCompiler);
+    auto& module = compiledMap.GetModule();
+
+    std::stringstream ss;
+    WriteModuleHeader(ss, module);
+    WriteModuleCppWrapper(ss, module);
+    auto result = ss.str();
+
+    std::string typeString = ToTypeString<ElementType>();
+    bool hasBufferPredict = std::string::npos != result.find(std::string("void Predict(const ") + typeString + "* input, " + typeString + "* output)");
+    bool hasBufferPredictCall = std::string::npos != result.find(std::string("TestModule_Predict(this, const_cast<") + typeString + "*>(input), output);");
+    bool hasReentrantPredict = std::string::npos != result.find(std::string("void Predict(void* state, const ") + typeString + "* input, " + typeString + "* output) const");
+    bool hasStateSize = std::string::npos != result.find("return TestModule_GetStateSize();");
+    testing::ProcessTest("Testing C++ wrapper buffer predict", testing::IsTrue(hasBufferPredict && hasBufferPredictCall));
+    testing::ProcessTest("Testing C++ wrapper reentrant predict", testing::IsTrue(hasReentrantPredict == reentrant && hasStateSize == reentrant));
+
+    testing::ProcessTest("Checking that all delimiters are processed", testing::IsTrue(std::string::npos == result.find("@@")));
+
+    if (testing::DidTestFail())
+    {
+        std::cout << result << std::endl;
+    }
+}
+
+void TestCppHeaderNoCallbacks()
+{
+    TestCppHeaderNoCallbacks<double>(false);
+    TestCppHeaderNoCallbacks<float>(false);
+    TestCppHeaderNoCallbacks<double>(true);
+    TestCppHeaderNoCallbacks<float>(true);
+}
+
 template <typename ElementType>
 void TestSwigCallbackInterfaces()
 {
@@ -236,6 +273,7 @@ void TestSwigNoCallbackInterfaces()
 void TestModelHeaderOutput()
 {
     TestCppHeader();
+    TestCppHeaderNoCallbacks();
     TestSwigCallbackInterfaces();
     TestSwigNoCallbackInterfaces();
 }
@@ -74,6 +74,7 @@ void TestModelOptimizerOptions()
 {
     TestArchiveModelOptimizerOptions();
     TestModelOptimizerOptionsMetadata();
+    TestCompilerOptionsRules();
 }
 
 void TestArchiveModelOptimizerOptions()
@@ -139,3 +140,51 @@ void TestModelOptimizerOptionsMetadata()
     ProcessTest("Checking new node 1 options metadata", IsTrue(HasSameOptionsInMetadata(*newNode1, node1Options)));
     ProcessTest("Checking new node 1 options metadata", IsTrue(HasSameOptionsInMetadata(*newNode3, node3Options)));
 }
+
+void TestCompilerOptionsRules()
+{
+    Model model;
+    auto smallInput = model.AddNode<InputNode<float>>(16);
+    auto smallOutput = model.AddNode<OutputNode<float>>(smallInput->output);
+    auto bigInput = model.AddNode<InputNode<float>>(4096);
+    auto bigOutput = model.AddNode<OutputNode<float>>(bigInput->output);
+
+    utilities::PropertyBag outputNodeOptions;
+    outputNodeOptions["unrollLoops"] = true;
+    utilities::PropertyBag outputNodeRule;
+    outputNodeRule["nodeType"] = std::string("OutputNode<.*>");
+    outputNodeRule["options"] = outputNodeOptions;
+
+    utilities::PropertyBag bigNodeOptions;
+    bigNodeOptions["maxThreads"] = 8;
+    utilities::PropertyBag bigNodeRule;
+    bigNodeRule["minOutputSize"] = 1024;
+    bigNodeRule["options"] = bigNodeOptions;
+
+    utilities::PropertyBag rules;
+    rules["outputNodes"] = outputNodeRule;
+    rules["bigNodes"] = bigNodeRule;
+
+    utilities::PropertyBag properties;
+    properties["rules"] = rules;
+    properties["parallelizeMinOutputSize"] = 1024;
+
+    SetCompilerOptionsTransformation transformation(properties);
+    ModelTransformer transformer;
+    TransformContext context;
+    Submodel submodel{ model };
+    transformation.Transform(submodel, transformer, context);
+
+    auto getOptions = [&transformer](const OutputPort<float>& port) {
+        return transformer.GetCorrespondingOutputs(port).GetNode()->GetMetadata().GetEntry<utilities::PropertyBag>("compileOptions", {});
+    };
+    auto smallInputOptions = getOptions(smallInput->output);
+    auto smallOutputOptions = getOptions(smallOutput->output);
+    auto bigInputOptions = getOptions(bigInput->output);
+    auto bigOutputOptions = getOptions(bigOutput->output);
+
+    ProcessTest("Checking small nodes aren't parallelized", IsFalse(smallInputOptions.GetEntry<bool>("parallelize", true)) && IsFalse(smallOutputOptions.GetEntry<bool>("parallelize", true)));
+    ProcessTest("Checking big nodes keep the parallelization setting", IsFalse(bigInputOptions.HasEntry("parallelize")) && IsFalse(bigOutputOptions.HasEntry("parallelize")));
+    ProcessTest("Checking node type rule", IsTrue(smallOutputOptions.GetEntry<bool>("unrollLoops", false)) && IsTrue(bigOutputOptions.GetEntry<bool>("unrollLoops", false)) && IsFalse(bigInputOptions.HasEntry("unrollLoops")));
+    ProcessTest("Checking output size rule", bigInputOptions.GetEntry<int>("maxThreads", 0) == 8 && bigOutputOptions.GetEntry<int>("maxThreads", 0) == 8 && IsFalse(smallInputOptions.HasEntry("maxThreads")));
+}
@@ -530,6 +530,111 @@ void TestRefineSplitOutputs()
     }
 }
 
+// Define new node that takes several refinement passes to become compilable
+template <typename ValueType>
+class RefineChainNode : public model::Node
+{
+public:
+    RefineChainNode() :
+        Node({ &_input }, { &_output }),
+        _input(this, {}, inputPortName),
+        _output(this, outputPortName, 0){};
+    RefineChainNode(const model::OutputPort<ValueType>& input, int numRefinements) :
+        Node({ &_input }, { &_output }),
+        _input(this, input, inputPortName),
+        _output(this, outputPortName, input.Size()),
+        _numRefinements(numRefinements){};
+
+    static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("RefineChainNode"); }
+    std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    void Copy(model::ModelTransformer& transformer) const override
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<RefineChainNode<ValueType>>(newInput, _numRefinements);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    bool Refine(model::ModelTransformer& transformer) const override
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        if (_numRefinements > 0)
+        {
+            auto newNode = transformer.AddNode<RefineChainNode<ValueType>>(newInput, _numRefinements - 1);
+            transformer.MapNodeOutput(output, newNode->output);
+        }
+        else
+        {
+            auto newNode = transformer.AddNode<model::OutputNode<ValueType>>(newInput);
+            transformer.MapNodeOutput(output, newNode->output);
+        }
+        return true;
+    }
+
+    const model::OutputPort<ValueType>& output = _output;
+    static constexpr const char* inputPortName = "input";
+    static constexpr const char* outputPortName = "output";
+
+    void WriteToArchive(utilities::Archiver& archiver) const override
+    {
+        archiver["input"] << _input;
+        archiver["output"] << _output;
+        archiver["numRefinements"] << _numRefinements;
+    }
+
+    void ReadFromArchive(utilities::Unarchiver& archiver) override
+    {
+        archiver["input"] >> _input;
+        archiver["output"] >> _output;
+        archiver["numRefinements"] >> _numRefinements;
+    }
+
+protected:
+    void Compute() const override { _output.SetOutput(_input.GetValue()); }
+
+private:
+    model::InputPort<ValueType> _input;
+    model::OutputPort<ValueType> _output;
+    int _numRefinements = 0;
+};
+
+void TestRefineIterations()
+{
+    // Create a model with a node that needs several passes to refine, next to nodes that don't change
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(2);
+    auto constantNode = model.AddNode<nodes::ConstantNode<double>>(std::vector<double>{ 1.0, 2.0 });
+    auto dotNode = model.AddNode<nodes::DotProductNode<double>>(inputNode->output, constantNode->output);
+    auto chainNode = model.AddNode<RefineChainNode<double>>(inputNode->output, 3);
+
+    model::ModelTransformer transformer;
+    model::TransformContext context;
+    context.AddNodeActionFunction([](const model::Node& node) { return dynamic_cast<const nodes::DotProductNode<double>*>(&node) == nullptr ? model::NodeAction::abstain : model::NodeAction::compile; });
+    model::RefineTransformation t;
+    auto newModel = t.TransformModel(model, transformer, context);
+
+    // The replaced nodes from the intermediate passes don't remain in the result
+    testing::ProcessTest("testing refine iterations model size", newModel.Size() == 4);
+
+    auto newInputNode = transformer.GetCorrespondingInputNode(inputNode);
+    const auto& newDotOutput = transformer.GetCorrespondingOutputs(model::PortElements<double>{ dotNode->output });
+    const auto& newChainOutput = transformer.GetCorrespondingOutputs(model::PortElements<double>{ chainNode->output });
+    testing::ProcessTest("testing refine iterations result", dynamic_cast<const model::OutputNode<double>*>(newChainOutput.GetNode()) != nullptr);
+
+    std::vector<std::vector<double>> inputValues = { { 1.0, 2.0 }, { 1.0, 0.5 }, { 2.0, 4.0 } };
+    for (const auto& inputValue : inputValues)
+    {
+        inputNode->SetInput(inputValue);
+        auto dotValues = model.ComputeOutput(dotNode->output);
+        auto chainValues = model.ComputeOutput(chainNode->output);
+
+        newInputNode->SetInput(inputValue);
+        auto newDotValues = newModel.ComputeOutput(newDotOutput);
+        auto newChainValues = newModel.ComputeOutput(newChainOutput);
+        testing::ProcessTest("testing refine iterations model", testing::IsEqual(dotValues, newDotValues) && testing::IsEqual(chainValues, newChainValues));
+    }
+}
+
 void TestCustomRefine()
 {
     // Create a simple computation model
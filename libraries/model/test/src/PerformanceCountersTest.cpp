@@ -19,6 +19,7 @@
 #include <model/include/InputNode.h>
 #include <model/include/Map.h>
 #include <model/include/Model.h>
+#include <model/include/ModelProfileData.h>
 #include <model/include/OutputNode.h>
 
 #include <nodes/include/ConstantNode.h>
@@ -30,6 +31,7 @@
 
 #include <iostream>
 #include <ostream>
+#include <sstream>
 #include <string>
 
 using namespace ell;
@@ -134,3 +136,92 @@ void TestPerformanceCounters()
         testing::ProcessTest("ModelProfiler GetNodePerformanceCounters", nodeStats->count == numIter);
     }
 }
+
+void TestSampledPerformanceCounters()
+{
+    model::Model model;
+    int m = 20;
+    int k = 50;
+    int n = 30;
+    int numIter = 10;
+    int samplingInterval = 4;
+    auto inputNode = model.AddNode<model::InputNode<double>>(m * k);
+    auto matrix2Node = model.AddNode<nodes::ConstantNode<double>>(GenerateMatrixValues(k, n));
+    auto matrixMultNode = model.AddNode<nodes::MatrixMatrixMultiplyNode<double>>(inputNode->output, m, n, k, k, matrix2Node->output, n, n);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", matrixMultNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.profile = true;
+    settings.profileSamplingInterval = samplingInterval;
+    model::IRMapCompiler compiler(settings, {});
+    auto compiledMap = compiler.Compile(map);
+
+    auto input = GenerateMatrixValues(m, k);
+    for (int index = 0; index < numIter; ++index)
+    {
+        compiledMap.SetInputValue(0, input);
+        compiledMap.ComputeOutput<double>(0);
+    }
+
+    // Only every 4th call is timed: calls 4 and 8
+    auto samplingCounters = compiledMap.GetProfilingSamplingCounters();
+    int numSampled = numIter / samplingInterval;
+    testing::ProcessTest("ModelProfiler sampling counters", samplingCounters->callCount == numIter && samplingCounters->sampledCallCount == numSampled);
+    testing::ProcessTest("ModelProfiler sampled model counters", compiledMap.GetModelPerformanceCounters()->count == numSampled);
+
+    bool ok = true;
+    for (int nodeIndex = 0; nodeIndex < compiledMap.GetNumProfiledNodes(); ++nodeIndex)
+    {
+        ok = ok && compiledMap.GetNodePerformanceCounters(nodeIndex)->count == numSampled;
+    }
+    testing::ProcessTest("ModelProfiler sampled node counters", ok);
+
+    compiledMap.ResetModelProfilingInfo();
+    testing::ProcessTest("ModelProfiler reset sampling counters", samplingCounters->callCount == 0 && samplingCounters->sampledCallCount == 0);
+}
+
+void TestModelProfileData()
+{
+    model::Model model;
+    int m = 20;
+    int k = 50;
+    int n = 30;
+    auto inputNode = model.AddNode<model::InputNode<double>>(m * k);
+    auto matrix2Node = model.AddNode<nodes::ConstantNode<double>>(GenerateMatrixValues(k, n));
+    auto matrixMultNode = model.AddNode<nodes::MatrixMatrixMultiplyNode<double>>(inputNode->output, m, n, k, k, matrix2Node->output, n, n);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", matrixMultNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.profile = true;
+    model::IRMapCompiler compiler(settings, {});
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue(0, GenerateMatrixValues(m, k));
+    compiledMap.ComputeOutput<double>(0);
+
+    model::ModelProfileData profileData(compiledMap);
+
+    // Every profiled node must be charged to a node in the original map
+    bool ok = !profileData.GetNodes().empty();
+    for (const auto& node : profileData.GetNodes())
+    {
+        model::Node::NodeId id(node.nodeId);
+        ok = ok && (model.GetNode(id) != nullptr || map.GetModel().GetNode(id) != nullptr);
+    }
+    testing::ProcessTest("ModelProfileData nodes refer to the original model", ok);
+
+    std::stringstream stream;
+    model::SaveModelProfileData(profileData, stream);
+    auto loadedData = model::LoadModelProfileData(stream);
+    testing::ProcessTest("ModelProfileData round trip", loadedData.GetNodes().size() == profileData.GetNodes().size() && testing::IsEqual(loadedData.GetTotalTime(), profileData.GetTotalTime(), 1e-6));
+
+    // The matrix multiply is by far the most expensive node, so with a small hot fraction it's the only hot one
+    model::ModelProfileData syntheticData;
+    syntheticData.AddNodeTime("1", "InputNode<double>", 1, 0.1);
+    syntheticData.AddNodeTime("2", "MatrixMatrixMultiplyNode<double>", 1, 9.0);
+    syntheticData.AddNodeTime("3", "OutputNode<double>", 1, 0.9);
+    auto options = model::ProfileGuidedOptions::GetDefault();
+    options.hotTimeFraction = 0.5;
+    auto nodeOptions = syntheticData.GetCompilerOptions(options).GetEntry<utilities::PropertyBag>("nodes");
+    auto isHot = [&nodeOptions](const std::string& id) { return nodeOptions.GetEntry<utilities::PropertyBag>(id).GetEntry<bool>("unrollLoops"); };
+    testing::ProcessTest("ModelProfileData hot node options", isHot("2") && !isHot("1") && !isHot("3"));
+}
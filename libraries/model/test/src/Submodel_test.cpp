@@ -14,9 +14,13 @@
 #include <model/include/Model.h>
 #include <model/include/OutputNode.h>
 #include <model/include/Submodel.h>
+#include <model/include/TappedSubmodel.h>
+
+#include <nodes/include/ExtremalValueNode.h>
 
 #include <testing/include/testing.h>
 
+#include <algorithm>
 #include <set>
 
 using namespace ell;
@@ -26,6 +30,7 @@ void TestSubmodels()
 {
     TestSubmodelConstructors();
     TestSubmodelVisit();
+    TestTappedSubmodel();
 }
 
 void TestSubmodelConstructors()
@@ -64,3 +69,40 @@ void TestSubmodelVisit()
         testing::ProcessTest("Testing Submodel::Visit", testing::IsEqual(count, submodel.Size()) && testing::IsEqual(static_cast<int>(visitedNodes.size()), count));
     }
 }
+
+void TestTappedSubmodel()
+{
+    model::Model model;
+    auto in = model.AddNode<model::InputNode<double>>(3);
+    auto minAndArgMin = model.AddNode<nodes::ArgMinNode<double>>(in->output);
+    auto maxAndArgMax = model.AddNode<nodes::ArgMaxNode<double>>(in->output);
+    auto out = model.AddNode<model::OutputNode<double>>(model::PortElements<double>({ minAndArgMin->val, maxAndArgMax->val }));
+    auto modelSize = model.Size();
+
+    // The submodel's output, followed by the intermediate ports it's computed from
+    std::vector<std::vector<double>> values;
+    auto record = [&values](size_t tapIndex, const std::vector<double>& tapValues) {
+        values.resize(std::max(values.size(), tapIndex + 1));
+        values[tapIndex] = tapValues;
+    };
+    {
+        std::vector<const OutputPortBase*> outputs{ &out->output };
+        TappedSubmodel tapped(Submodel{ model, outputs }, { &minAndArgMin->val, &maxAndArgMax->val });
+        tapped.SetInputValue(0, std::vector<float>{ 5, 3, 4 });
+        tapped.Compute(record);
+        bool ok = tapped.NumInputs() == 1 && tapped.NumTaps() == 3 && testing::IsEqual(tapped.GetTapSize(0), static_cast<size_t>(2));
+        ok = ok && testing::IsEqual(values[0], std::vector<double>{ 3, 5 }) && testing::IsEqual(values[1], std::vector<double>{ 3 }) && testing::IsEqual(values[2], std::vector<double>{ 5 });
+        testing::ProcessTest("Testing TappedSubmodel with intermediate taps", ok && model.Size() == modelSize);
+    }
+
+    // A submodel that starts at an intermediate port gets an input in its place
+    values.clear();
+    {
+        std::vector<const InputPortBase*> inputs{ &minAndArgMin->input };
+        std::vector<const OutputPortBase*> outputs{ &minAndArgMin->val };
+        TappedSubmodel tapped(Submodel{ model, inputs, outputs });
+        tapped.SetInputValue(0, std::vector<double>{ 7, 1, 2 });
+        tapped.Compute(record);
+        testing::ProcessTest("Testing TappedSubmodel with inputs", tapped.NumInputs() == 1 && tapped.NumTaps() == 1 && testing::IsEqual(values[0], std::vector<double>{ 1 }));
+    }
+}
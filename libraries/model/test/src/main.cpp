@@ -53,11 +53,17 @@ int main()
         TestMapCreate();
         TestMapCompute();
         TestMapComputeDataVector();
+        TestMapParallelCompute();
+        TestMapExecutionContext();
+        TestMapPipeline();
+        TestChainMaps();
+        TestMapGateNode();
         TestMapRefine();
         TestMapSerialization();
         TestMapClockNode();
 
         TestCustomRefine();
+        TestRefineIterations();
 
         // Metadata tests
         TestModelMetadata();
@@ -26,6 +26,7 @@ void TestIRCompiler()
 {
     TestReinterpretLayoutNode();
     TestBroadcastLinearFunctionNode();
+    TestBroadcastLinearFunctionNodeVectorized();
 
     TestNodeMetadata();
     TestMultiOutputMap();
@@ -57,6 +58,28 @@ void TestIRCompiler()
     TestAccumulator(true);
     TestDelay();
     TestSqrt();
+    TestPortBufferAllocator();
+    TestReuseIntermediateBuffers();
+    TestAliasPortBuffers();
+    TestStackPortBuffers();
+    TestSelectiveNodeInlining();
+    TestObjectCache();
+    TestNodeFunctionCache();
+    TestJitCompilationModes();
+    TestCompileTimingReport();
+    TestFunctionVariants();
+    TestBatchPredictFunction();
+    TestBatchedMatrixProducts();
+    TestAsyncPredictFunctions();
+    TestReentrantMap();
+    TestExternalWeights();
+    TestStaticMemory();
+    TestDeduplicateConstants();
+    TestWeightsPlacement();
+    TestPGOInstrumentation();
+    TestParallelBranches();
+    TestNoHeap();
+    TestOptimizationRemarks();
     TestBinaryPredicate(false);
     TestSlidingAverage();
     TestDotProductOutput();
@@ -66,8 +89,19 @@ void TestIRCompiler()
     // TestForest(); // FAILS -- crash
     TestMatrixVectorMultiplyNode(10, 5, true);
     TestMatrixVectorMultiplyNode(10, 5, false);
+    TestMatrixVectorMultiplyNode(10, 5, false, true);
+    TestMatrixVectorMultiplyNode(10, 37, false, false, 64);
+    TestConstantMatrixVectorMultiplyNode(16, 64);
     TestMatrixMatrixMultiplyNode(4, 5, 6, true);
     TestMatrixMatrixMultiplyNode(4, 5, 6, false);
+    TestMatrixMatrixMultiplyNode(4, 5, 6, false, true);
+
+    // Sizes that span several blocks of the native GEMM, with partial blocks and tiles at the edges
+    TestMatrixMatrixMultiplyNode(67, 131, 6, false);
+    TestMatrixMatrixMultiplyNode(67, 131, 6, false, true);
+    TestMatrixMatrixMultiplyNode(2, 3, 130, false, true);
+    TestMatrixMatrixMultiplyNode(67, 131, 6, false, true, 256);
+    TestMatrixMatrixMultiplyNode(67, 131, 300, false, true, 0, true); // panels shrunk to fit on the stack
 
     // Using BLAS
     TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, false, false, false, true);
@@ -88,6 +122,13 @@ void TestIRCompiler()
     TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, true, false, true, false);
     TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, false, true, true, false);
     TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, true, true, true, false);
+    TestOrderedMatrixMatrixMultiplyNode(67, 131, 6, true, true, false, false);
+
+    // Unrolled small-matrix kernel
+    TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, false, false, false, false, true);
+    TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, true, false, false, false, true);
+    TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, false, true, false, false, true);
+    TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, true, true, true, false, true);
 
     // TestMatrixMatrixMultiplyNode(15, 25600, 27, false); // Fails due to numerical  issues
 
@@ -97,10 +138,24 @@ void TestIRCompiler()
     TestCompilableDotProductNode();
     TestCompilableDelayNode();
     TestCompilableDTWDistanceNode();
+    TestCompilableDTWDistanceNode(1, 0);
+    TestCompilableDTWDistanceNode(0, 1.5);
+    TestCompilableDTWDistanceNode(2, 1.5);
     TestCompilableMulticlassDTW();
+    TestCompilableForestPredictorNode(true);
+    TestCompilableForestPredictorNode(false);
     TestCompilableScalarSumNode();
     TestCompilableSumNode();
+    TestCompilableArgMaxNode();
+    TestCompilableTopKNode(false);
+    TestCompilableTopKNode(true);
+    TestCompilableSparseLinearPredictorNode();
     TestCompilableUnaryOperationNode();
+    TestL2NormSquaredNodeCompiled();
+    TestSquaredEuclideanDistanceNodeCompiled<math::MatrixLayout::rowMajor>(true);
+    TestSquaredEuclideanDistanceNodeCompiled<math::MatrixLayout::rowMajor>(false);
+    TestSquaredEuclideanDistanceNodeCompiled<math::MatrixLayout::columnMajor>(true);
+    TestSquaredEuclideanDistanceNodeCompiled<math::MatrixLayout::columnMajor>(false);
     TestCompilableBinaryOperationNode();
     TestCompilableBinaryOperationNode2();
     TestCompilableScalarBinaryPredicateNode();
@@ -110,6 +165,7 @@ void TestIRCompiler()
     TestCompilableTypeCastNode(2);
     TestCompilableTypeCastNode(10);
     TestReorderDataNode1();
+    TestReorderDataNode1(1);
     TestReorderDataNode2();
     TestReorderDataNode3();
     TestReceptiveFieldMatrixNode(1, true); // new version
@@ -119,10 +175,23 @@ void TestIRCompiler()
     TestCompilableAccumulatorNodeFunction();
     TestCompilableSourceNode();
     TestCompilableSinkNode();
+    TestCompilableSourceNodeRingBuffer();
+    TestCompilableSinkNodeRingBuffer();
     TestCompilableClockNode();
-    TestCompilableFFTNode();
+    TestCompilableFFTNode(8, 8);
+    TestCompilableFFTNode(2, 2);
+    TestCompilableFFTNode(4, 3);
+    TestCompilableFFTNode(512, 512);
+    TestCompilableFFTNode(512, 400);
+    TestCompilableMultichannelFFTNode(1, 8, 8);
+    TestCompilableMultichannelFFTNode(2, 2, 2);
+    TestCompilableMultichannelFFTNode(8, 64, 64);
+    TestCompilableMultichannelFFTNode(6, 16, 12);
+    TestCompilableImagePreprocessingNode();
 
     TestPerformanceCounters();
+    TestSampledPerformanceCounters();
+    TestModelProfileData();
     TestCompilableDotProductNode2<float>(3); // uses IR
     TestCompilableDotProductNode2<double>(3); // uses IR
     TestCompilableDotProductNode2<float>(4); // uses IR
@@ -186,9 +255,14 @@ void TestIRCompiler()
     // test weird case we are seeing in some cntk models
     TestMaxPoolingLayerNode(7, 7, 16, 4, 4, 2, 2, 0, 0);
 
+    // channel counts that leave some channels over after the vector blocks
+    TestMaxPoolingLayerNode(10, 10, 18, 5, 5, 3, 2, 1, 0);
+    TestMaxPoolingLayerNode(8, 8, 3, 4, 4, 2, 2, 0, 0);
+
     TestMeanPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 0, 0);
     TestMeanPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 0, 1);
     TestMeanPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 0, 2);
+    TestMeanPoolingLayerNode(8, 8, 18, 6, 6, 3, 1, 0, 0);
     // TestMeanPoolingLayerNode(8, 8, 16, 6, 6, 3, 1, 1, 0);
 
     // TestMeanPoolingLayerNode(8, 8, 16, 2, 1, 2, 1, 0, 0);
@@ -201,12 +275,15 @@ void TestIRCompiler()
     TestSoftmaxLayerNode();
     TestSoftmaxLayerNode(0, 1);
     TestSoftmaxLayerNode(0, 2);
+    TestSoftmaxLayerNode(0, 0, 3);
     // TestSoftmaxLayerNode(1, 0); // Input padding not supported (yet)
 
     TestBinaryConvolutionalLayerNode(32, 32, 3, 4);
     TestBinaryConvolutionalLayerNode(32, 32, 3, 4, 1, 0, PaddingScheme::zeros, true);
     TestBinaryConvolutionalLayerNode(32, 32, 3, 4, 1, 0, PaddingScheme::minusOnes, false);
     TestBinaryConvolutionalLayerNode(32, 32, 3, 4, 1, 0, PaddingScheme::minusOnes, true);
+    TestBinaryConvolutionalLayerNode(16, 16, 32, 7); // a block of filters plus leftover filters
+    TestBinaryConvolutionalLayerNode(16, 16, 32, 7, 1, 0, PaddingScheme::minusOnes, false);
 
     // TestConvolutionalLayerNode(ConvolutionMethod::unrolled);
     TestConvolutionalLayerNode(ConvolutionMethod::unrolled, 1, 0);
@@ -244,6 +321,7 @@ void TestIRCompiler()
     TestBroadcasBinaryOperationNodeCompileSubtract();
     TestBroadcasBinaryOperationNodeCompileAdd();
     TestBroadcasBinaryOperationNodeCompileWithOrdering();
+    TestBroadcastTernaryOperationNodeCompileVectorized();
 }
 
 int main(int argc, char* argv[])
@@ -247,5 +247,81 @@ namespace nodes
         std::string GetRuntimeTypeName() const { return GetTypeName(); }
     };
 
+    //
+    // Activation function applied to the result of a linear function: f(x, a, b) = activation(a*x + b)
+    //
+    template <typename ValueType, typename ActivationFunctionType>
+    class LinearActivationFunction : public BroadcastTernaryFunction<ValueType>
+    {
+    public:
+        LinearActivationFunction() = default;
+
+        /// <summary> Constructor specifying the activation function. </summary>
+        ///
+        /// <param name="activation"> The activation function to apply to the output of the linear function. </param>
+        LinearActivationFunction(ActivationFunctionType activation) :
+            _activation(activation) {}
+
+        /// <summary> Computes the activation of a linear function (on the host machine) </summary>
+        ///
+        /// <param name="x"> The primary value </param>
+        /// <param name="a"> The scale value </param>
+        /// <param name="b"> The bias value </param>
+        /// <returns> The value the function f(x,a,b) = activation(ax + b) </returns>
+        ValueType Compute(ValueType x, ValueType a, ValueType b) const override;
+        using BroadcastTernaryFunction<ValueType>::Compute;
+
+        /// <summary> Emits IR to compute the activation of a linear function </summary>
+        ///
+        /// <param name="function"> The function being compiled. </param>
+        /// <param name="x"> The primary value </param>
+        /// <param name="a"> The scale value, or `nullptr` if the scale is 1 </param>
+        /// <param name="b"> The bias value, or `nullptr` if the bias is 0 </param>
+        /// <returns> The value the function f(x,a,b) = activation(ax + b) </returns>
+        emitters::LLVMValue Compile(emitters::IRFunctionEmitter& function, emitters::LLVMValue x, emitters::LLVMValue a, emitters::LLVMValue b) const override;
+        using BroadcastTernaryFunction<ValueType>::Compile;
+
+        /// <summary> Gets the activation function </summary>
+        ///
+        /// <returns> The activation function </returns>
+        const ActivationFunctionType& GetActivationFunction() const { return _activation; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType, ActivationFunctionType>("LinearActivationFunction"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const { return GetTypeName(); }
+
+    private:
+        ActivationFunctionType _activation;
+    };
+
 } // namespace nodes
 } // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType, typename ActivationFunctionType>
+    ValueType LinearActivationFunction<ValueType, ActivationFunctionType>::Compute(ValueType x, ValueType a, ValueType b) const
+    {
+        return _activation.Compute(BroadcastLinearFunction<ValueType>{}.Compute(x, a, b));
+    }
+
+    template <typename ValueType, typename ActivationFunctionType>
+    emitters::LLVMValue LinearActivationFunction<ValueType, ActivationFunctionType>::Compile(emitters::IRFunctionEmitter& function, emitters::LLVMValue x, emitters::LLVMValue a, emitters::LLVMValue b) const
+    {
+        auto linearValue = (a == nullptr && b == nullptr) ? x : BroadcastLinearFunction<ValueType>{}.Compile(function, x, a, b);
+        return _activation.Compile(function, linearValue);
+    }
+} // namespace nodes
+} // namespace ell
+
+#pragma endregion implementation
@@ -20,6 +20,7 @@
 
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace ell
 {
@@ -245,6 +246,7 @@ namespace nodes
                                  emitters::LLVMValue pInputPaddingMaskSums,
                                  emitters::LLVMValue pOutput,
                                  emitters::LLVMValue filterIndex,
+                                 int numFilters,
                                  bool hasZeroPadding,
                                  int outputColumns,
                                  int packedRowSize,
@@ -263,14 +265,14 @@ namespace nodes
         void EmitInnerLoop(emitters::IRFunctionEmitter& function,
                            emitters::LLVMValue reshapedInput,
                            emitters::LLVMValue paddingMask,
-                           emitters::LLVMValue weights,
-                           emitters::LLVMValue xorSumVariable,
+                           const std::vector<emitters::LLVMValue>& weights,
+                           const std::vector<emitters::LLVMValue>& xorSumVariables,
                            emitters::LLVMFunction popCountFunction,
                            int startBlock,
                            int numBlocks,
                            bool hasZeroPadding);
 
-        emitters::IRFunctionEmitter GetTaskFunction(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
+        emitters::IRFunctionEmitter GetTaskFunction(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int filterBlockSize);
 
         // Input
         model::InputPort<PackedBitsType> _input;
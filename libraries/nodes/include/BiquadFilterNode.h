@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BiquadFilterNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <dsp/include/BiquadFilter.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that applies an IIR filter, as a cascade of second-order sections, to each channel of a multichannel
+    /// signal. The input is a whole number of frames, oldest first, and each frame holds one sample of every channel.
+    /// Use `dsp::GetSecondOrderSections` to decompose the coefficients of an `IIRFilterNode` into sections.
+    ///
+    /// The recurrence of a channel is serial in time, but the channels are independent, so the compiled code filters
+    /// as many channels at once as fit in a vector, with the filter state kept in registers across the frames.
+    /// </summary>
+    template <typename ValueType>
+    class BiquadFilterNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        BiquadFilterNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to process, frame by frame. </param>
+        /// <param name="sections"> The second-order sections of the filter, applied in order. </param>
+        /// <param name="numChannels"> The number of channels in a frame. </param>
+        BiquadFilterNode(const model::OutputPort<ValueType>& input, const std::vector<dsp::BiquadCoefficients<ValueType>>& sections, size_t numChannels);
+
+        /// <summary> Gets the second-order sections of the filter. </summary>
+        const std::vector<dsp::BiquadCoefficients<ValueType>>& GetSections() const { return _filter.GetSections(); }
+
+        /// <summary> Gets the number of channels in a frame. </summary>
+        size_t NumChannels() const { return _filter.NumChannels(); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("BiquadFilterNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Reset the state of the node </summary>
+        void Reset() override { _filter.Reset(); }
+
+        /// <summary> Indicates if the node is pure. The filter keeps its state between calls, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // Stored state: filter sections and number of channels
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void ValidateParameters() const;
+        void EmitChannelBlock(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::LLVMValue output, emitters::LLVMValue state, emitters::LLVMValue channel, int blockSize) const;
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        mutable dsp::BiquadFilter<ValueType> _filter;
+    };
+} // namespace nodes
+} // namespace ell
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BlockedConvolutionNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <math/include/Tensor.h>
+
+#include <model/include/IRMapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/PortElements.h>
+#include <model/include/PortMemoryLayout.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that implements convolution on channel-blocked data (see `model::GetChannelBlockedLayout`). Each output
+    /// value is a vector of a block of output channels, which is contiguous in memory, so the inner loop multiplies a
+    /// broadcast input value by a unit-stride vector of weights. Consecutive blocked layers can pass the blocked data
+    /// to each other directly, so the data is only reordered at the edges of the blocked region of the model.
+    /// If blocked convolution is specified, a ConvolutionalLayerNode will refine itself into a BlockedConvolutionNode.
+    /// </summary>
+    template <typename ValueType>
+    class BlockedConvolutionNode : public model::CompilableNode
+    {
+    public:
+        using TensorType = math::ChannelColumnRowTensor<ValueType>;
+        using ConstTensorReferenceType = math::ConstChannelColumnRowTensorReference<ValueType>;
+
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default constructor. </summary>
+        BlockedConvolutionNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The ports to get input data from. </param>
+        /// <param name="inputMemoryLayout"> The channel-blocked layout of the input data. Its padding must be the convolution's padding. </param>
+        /// <param name="outputMemoryLayout"> The channel-blocked layout of the output data. It must have the same block size as the input. </param>
+        /// <param name="filterWeights"> The weights for the convolutional filters. Stored
+        ///  as a 3D tensor of dimensions (nf*fw) x fw x d, where nf == # filters, fw == filter width, and d == input depth. </param>
+        /// <param name="stride"> The output stride. </param>
+        BlockedConvolutionNode(const model::OutputPort<ValueType>& input,
+                               const model::PortMemoryLayout& inputMemoryLayout,
+                               const model::PortMemoryLayout& outputMemoryLayout,
+                               const ConstTensorReferenceType& filterWeights,
+                               int stride);
+
+        /// <summary> Gets information about the input memory layout </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
+
+        /// <summary> Gets information about the output memory layout </summary>
+        model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
+
+        /// <summary> Returns true if the node can accept input with this memory layout order, else false </summary>
+        ///
+        /// <param name="order"> The memory layout order for all the input ports </summary>
+        /// <returns> If the node can accept the input memory layout order, true, else false </returns>
+        bool CanAcceptInputLayout(const utilities::DimensionOrder& order) const override
+        {
+            return GetInputMemoryLayout().GetLogicalDimensionOrder() == order;
+        }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("BlockedConvolutionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: convolutional parameters and memory layout
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void ValidateLayouts() const;
+
+        // Returns the weights in (output block, filter row, filter column, input channel, output channel within block) order,
+        // so the weights for a block of output channels are contiguous. The channels past the end of the last block are zero.
+        std::vector<ValueType> GetBlockedWeights() const;
+
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        model::PortMemoryLayout _inputMemoryLayout;
+
+        TensorType _filterWeights;
+
+        int _stride = 1;
+    };
+} // namespace nodes
+} // namespace ell
@@ -273,6 +273,8 @@ namespace nodes
         // Helpers for generating nested loops to visit all input/output values
         void ComputeDimensionLoop(size_t dimension, std::vector<ValueType>& output, size_t prevInputDimensionOffset, size_t prevOutputDimensionOffset, std::vector<ValueType>& secondaryValues) const;
         void EmitComputeDimensionLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, size_t dimension, emitters::IRLocalScalar begin, emitters::IRLocalScalar end, emitters::LLVMValue primaryInput, const std::vector<emitters::LLVMValue>& secondaryInputs, emitters::LLVMValue output, emitters::IRLocalScalar prevInputDimensionOffset, emitters::IRLocalScalar prevOutputDimensionOffset, std::vector<emitters::LLVMValue>& secondaryValues) const;
+        bool CanVectorizeInnerLoop(const emitters::CompilerOptions& options, int loopSize) const;
+        void EmitVectorizedInnerLoop(emitters::IRFunctionEmitter& function, int begin, int end, emitters::LLVMValue primaryInput, const std::vector<emitters::LLVMValue>& secondaryInputs, emitters::LLVMValue output, emitters::IRLocalScalar inputDimensionOffset, emitters::IRLocalScalar outputDimensionOffset, const std::vector<emitters::LLVMValue>& secondaryValues) const;
         emitters::IRFunctionEmitter GetTaskFunction(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const emitters::LLVMTypeList& portTypes) const;
 
         void WriteToArchive(utilities::Archiver& archiver) const override;
@@ -334,10 +336,10 @@ namespace nodes
         using BroadcastFunctionNode<ValueType, FunctionType>::GetOutputMemoryLayout;
         using BroadcastFunctionNode<ValueType, FunctionType>::GetBroadcastDimension;
         using BroadcastFunctionNode<ValueType, FunctionType>::NumPrimaryInputDimensions;
-
-    protected:
         using BroadcastFunctionNode<ValueType, FunctionType>::GetFunction;
+        using BroadcastFunctionNode<ValueType, FunctionType>::GetOutputPadding;
 
+    protected:
         utilities::ArchiveVersion GetArchiveVersion() const override;
         bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
@@ -840,6 +842,19 @@ namespace nodes
         const auto broadcastDimension = GetBroadcastDimension();
         const auto numSecondaryInputs = NumSecondaryInputs();
 
+        if (dimension == numDimensions - 1 && begin.IsConstantInt() && end.IsConstantInt() && CanVectorizeInnerLoop(function.GetCompilerOptions(), end.GetIntValue<int>() - begin.GetIntValue<int>()))
+        {
+            auto inputDimensionOffset = function.LocalScalar<int>(inputOffset[dimension]);
+            auto outputDimensionOffset = function.LocalScalar<int>(outputOffset[dimension]);
+            if (dimension != 0)
+            {
+                inputDimensionOffset = inputDimensionOffset + (prevInputDimensionOffset * inputStride[dimension]);
+                outputDimensionOffset = outputDimensionOffset + (prevOutputDimensionOffset * outputStride[dimension]);
+            }
+            EmitVectorizedInnerLoop(function, begin.GetIntValue<int>(), end.GetIntValue<int>(), primaryInput, secondaryInputs, output, inputDimensionOffset, outputDimensionOffset, secondaryValues);
+            return;
+        }
+
         function.For(begin, end, [dimension, numDimensions, inputSize, inputOffset, inputStride, outputOffset, outputStride, broadcastDimension, numSecondaryInputs, prevInputDimensionOffset, prevOutputDimensionOffset, primaryInput, secondaryInputs, output, &secondaryValues, &compiler, this](emitters::IRFunctionEmitter& function, auto loopIndex) {
             // Calculate the offset within this dimension = (loopIndex + offset[dimension])
             auto thisInputDimensionInternalOffset = loopIndex + inputOffset[dimension];
@@ -889,6 +904,72 @@ namespace nodes
         });
     }
 
+    template <typename ValueType, typename FunctionType>
+    bool BroadcastFunctionNode<ValueType, FunctionType>::CanVectorizeInnerLoop(const emitters::CompilerOptions& options, int loopSize) const
+    {
+        return options.allowVectorInstructions && GetFunction().CanUseVectorTypes() && loopSize >= options.vectorWidth;
+    }
+
+    // Emits the innermost loop with vector operations over blocks of `vectorWidth` contiguous elements, followed by
+    // a scalar loop over the remaining elements. Secondary values that are the same for the whole loop are broadcast
+    // to vectors once, before the loop.
+    template <typename ValueType, typename FunctionType>
+    void BroadcastFunctionNode<ValueType, FunctionType>::EmitVectorizedInnerLoop(emitters::IRFunctionEmitter& function, int begin, int end, emitters::LLVMValue primaryInput, const std::vector<emitters::LLVMValue>& secondaryInputs, emitters::LLVMValue output, emitters::IRLocalScalar inputDimensionOffset, emitters::IRLocalScalar outputDimensionOffset, const std::vector<emitters::LLVMValue>& secondaryValues) const
+    {
+        const int vectorSize = function.GetCompilerOptions().vectorWidth;
+        const int vectorEnd = begin + ((end - begin) / vectorSize) * vectorSize;
+        const bool isBroadcastDimension = GetBroadcastDimension() == NumPrimaryInputDimensions() - 1;
+        const auto numSecondaryInputs = NumSecondaryInputs();
+
+        std::vector<emitters::LLVMValue> secondaryVectors(numSecondaryInputs, nullptr);
+        if (!isBroadcastDimension)
+        {
+            for (int index = 0; index < numSecondaryInputs; ++index)
+            {
+                if (secondaryValues[index] != nullptr)
+                {
+                    secondaryVectors[index] = emitters::BroadcastToVector<ValueType>(function, vectorSize, secondaryValues[index]);
+                }
+            }
+        }
+
+        function.For(begin, vectorEnd, vectorSize, [=](emitters::IRFunctionEmitter& function, auto loopIndex) {
+            auto vectorArgs = secondaryVectors;
+            if (isBroadcastDimension)
+            {
+                for (int index = 0; index < numSecondaryInputs; ++index)
+                {
+                    vectorArgs[index] = this->IsSecondaryInputPresent(index) ? emitters::LoadVector<ValueType>(function, secondaryInputs[index], loopIndex, vectorSize) : nullptr;
+                }
+            }
+
+            auto primaryValue = emitters::LoadVector<ValueType>(function, primaryInput, inputDimensionOffset + loopIndex, vectorSize);
+            auto outputValue = this->GetFunction().Compile(function, primaryValue, vectorArgs);
+            emitters::StoreVector<ValueType>(function, output, outputDimensionOffset + loopIndex, outputValue);
+        });
+
+        if (vectorEnd == end)
+        {
+            return;
+        }
+
+        // Remaining elements
+        function.For(vectorEnd, end, [=](emitters::IRFunctionEmitter& function, auto loopIndex) {
+            auto scalarArgs = secondaryValues;
+            if (isBroadcastDimension)
+            {
+                for (int index = 0; index < numSecondaryInputs; ++index)
+                {
+                    scalarArgs[index] = this->IsSecondaryInputPresent(index) ? function.ValueAt(secondaryInputs[index], loopIndex) : nullptr;
+                }
+            }
+
+            auto primaryValue = function.ValueAt(primaryInput, inputDimensionOffset + loopIndex);
+            auto outputValue = this->GetFunction().Compile(function, primaryValue, scalarArgs);
+            function.SetValueAt(output, outputDimensionOffset + loopIndex, outputValue);
+        });
+    }
+
     template <typename ValueType, typename FunctionType>
     bool BroadcastFunctionNode<ValueType, FunctionType>::IsSecondaryInputPresent(int index) const
     {
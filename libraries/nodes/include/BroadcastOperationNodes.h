@@ -81,6 +81,9 @@ namespace nodes
         virtual ValueType ComputeOperation(const std::vector<ValueType>& args) const = 0;
         virtual emitters::IRLocalScalar CompileOperation(const std::vector<emitters::IRLocalScalar>& args) const = 0;
 
+        /// <summary> Indicates if `CompileOperation` can operate on vectors of values. </summary>
+        virtual bool CanVectorizeOperation() const { return false; }
+
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
 
@@ -107,6 +110,14 @@ namespace nodes
                                   const std::vector<emitters::IRLocalScalar>& inputValues,
                                   emitters::IRLocalScalar prevOutputDimensionOffset,
                                   emitters::IRLocalArray& output) const;
+        bool CanVectorizeInnerLoop(const emitters::CompilerOptions& options) const;
+        void CompileVectorizedInnerLoop(emitters::IRFunctionEmitter& function,
+                                        const std::vector<emitters::IRLocalArray>& inputs,
+                                        const std::vector<emitters::IRLocalScalar>& prevInputDimensionOffsets,
+                                        const std::vector<int>& lastActiveInputDimensions,
+                                        const std::vector<emitters::IRLocalScalar>& inputValues,
+                                        emitters::IRLocalScalar prevOutputDimensionOffset,
+                                        emitters::IRLocalArray& output) const;
         std::vector<int> GetLastActiveInputDimensions() const;
 
         utilities::ArchiveVersion GetArchiveVersion() const override;
@@ -170,6 +181,7 @@ namespace nodes
         using BroadcastOperationNode<ValueType, FunctionType>::SetFunction;
         ValueType ComputeOperation(const std::vector<ValueType>& args) const override;
         emitters::IRLocalScalar CompileOperation(const std::vector<emitters::IRLocalScalar>& args) const override;
+        bool CanVectorizeOperation() const override;
 
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
@@ -237,6 +249,7 @@ namespace nodes
         using BroadcastOperationNode<ValueType, FunctionType>::SetFunction;
         ValueType ComputeOperation(const std::vector<ValueType>& args) const override;
         emitters::IRLocalScalar CompileOperation(const std::vector<emitters::IRLocalScalar>& args) const override;
+        bool CanVectorizeOperation() const override;
 
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
@@ -309,6 +322,7 @@ namespace nodes
         using BroadcastOperationNode<ValueType, FunctionType>::SetFunction;
         ValueType ComputeOperation(const std::vector<ValueType>& args) const override;
         emitters::IRLocalScalar CompileOperation(const std::vector<emitters::IRLocalScalar>& args) const override;
+        bool CanVectorizeOperation() const override;
 
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
@@ -519,6 +533,12 @@ namespace nodes
         const auto numDimensions = outputLayout.NumDimensions();
         const auto numInputs = NumInputPorts();
 
+        if (dimension == numDimensions - 1 && CanVectorizeInnerLoop(function.GetCompilerOptions()))
+        {
+            CompileVectorizedInnerLoop(function, inputs, prevInputDimensionOffsets, lastActiveInputDimensions, inputValues, prevOutputDimensionOffset, output);
+            return;
+        }
+
         function.For(0, outputSize[dimension], [&](emitters::IRFunctionEmitter& function, auto loopIndex) {
             auto thisOutputDimensionOffset = prevOutputDimensionOffset + loopIndex * outputIncrement[dimension];
             std::vector<emitters::IRLocalScalar> thisInputDimensionOffsets(numInputs, function.LocalScalar<int>(0));
@@ -555,6 +575,102 @@ namespace nodes
         });
     }
 
+    // The innermost loop can use vector operations if the operation supports them, and each input is either contiguous
+    // along the innermost dimension, or broadcast along it
+    template <typename ValueType, typename FunctionType>
+    bool BroadcastOperationNode<ValueType, FunctionType>::CanVectorizeInnerLoop(const emitters::CompilerOptions& options) const
+    {
+        if (!options.allowVectorInstructions || !CanVectorizeOperation())
+        {
+            return false;
+        }
+
+        const auto& outputLayout = GetOutputMemoryLayout();
+        const auto innermostDimension = outputLayout.NumDimensions() - 1;
+        if (outputLayout.GetLogicalDimensionActiveSize()[innermostDimension] < options.vectorWidth || outputLayout.GetLogicalDimensionIncrement()[innermostDimension] != 1)
+        {
+            return false;
+        }
+
+        for (int inputIndex = 0; inputIndex < NumInputPorts(); ++inputIndex)
+        {
+            const auto& inputLayout = GetInput(inputIndex).GetMemoryLayout();
+            if (inputLayout.GetLogicalDimensionActiveSize()[innermostDimension] != 1 && inputLayout.GetLogicalDimensionIncrement()[innermostDimension] != 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Emits the innermost loop with vector operations over blocks of `vectorWidth` contiguous elements, followed by
+    // a scalar loop over the remaining elements. The inputs broadcast along the innermost dimension are loaded and
+    // copied into vectors once, before the loop.
+    template <typename ValueType, typename FunctionType>
+    void BroadcastOperationNode<ValueType, FunctionType>::CompileVectorizedInnerLoop(emitters::IRFunctionEmitter& function,
+                                                                                     const std::vector<emitters::IRLocalArray>& inputs,
+                                                                                     const std::vector<emitters::IRLocalScalar>& prevInputDimensionOffsets,
+                                                                                     const std::vector<int>& lastActiveInputDimensions,
+                                                                                     const std::vector<emitters::IRLocalScalar>& inputValuesIn,
+                                                                                     emitters::IRLocalScalar prevOutputDimensionOffset,
+                                                                                     emitters::IRLocalArray& output) const
+    {
+        const auto& outputLayout = GetOutputMemoryLayout();
+        const auto dimension = outputLayout.NumDimensions() - 1;
+        const auto outputGlobalOffset = static_cast<int>(outputLayout.GetFirstEntryOffset());
+        const int size = outputLayout.GetLogicalDimensionActiveSize()[dimension];
+        const int vectorSize = function.GetCompilerOptions().vectorWidth;
+        const int vectorEnd = (size / vectorSize) * vectorSize;
+        const auto numInputs = NumInputPorts();
+
+        auto inputValues = inputValuesIn;
+        std::vector<bool> isBroadcast(numInputs);
+        std::vector<emitters::IRLocalScalar> inputOffsets;
+        std::vector<emitters::IRLocalScalar> broadcastVectors;
+        for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+        {
+            const auto& inputLayout = GetInput(inputIndex).GetMemoryLayout();
+            const auto inputGlobalOffset = static_cast<int>(inputLayout.GetFirstEntryOffset());
+            auto inputOffset = prevInputDimensionOffsets[inputIndex] + inputGlobalOffset;
+            inputOffsets.push_back(inputOffset);
+
+            isBroadcast[inputIndex] = inputLayout.GetLogicalDimensionActiveSize()[dimension] == 1;
+            if (isBroadcast[inputIndex] && dimension == lastActiveInputDimensions[inputIndex])
+            {
+                inputValues[inputIndex] = inputs[inputIndex][inputOffset];
+            }
+            broadcastVectors.push_back(isBroadcast[inputIndex] ? function.LocalScalar(emitters::BroadcastToVector<ValueType>(function, vectorSize, inputValues[inputIndex])) : function.LocalScalar());
+        }
+        auto outputOffset = prevOutputDimensionOffset + outputGlobalOffset;
+
+        function.For(0, vectorEnd, vectorSize, [&](emitters::IRFunctionEmitter& function, auto loopIndex) {
+            std::vector<emitters::IRLocalScalar> args;
+            for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+            {
+                args.push_back(isBroadcast[inputIndex] ? broadcastVectors[inputIndex] : function.LocalScalar(emitters::LoadVector<ValueType>(function, inputs[inputIndex].value, inputOffsets[inputIndex] + loopIndex, vectorSize)));
+            }
+            emitters::StoreVector<ValueType>(function, output.value, outputOffset + loopIndex, CompileOperation(args));
+        });
+
+        if (vectorEnd == size)
+        {
+            return;
+        }
+
+        // Remaining elements
+        function.For(vectorEnd, size, [&](emitters::IRFunctionEmitter& function, auto loopIndex) {
+            auto args = inputValues;
+            for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+            {
+                if (!isBroadcast[inputIndex])
+                {
+                    args[inputIndex] = inputs[inputIndex][inputOffsets[inputIndex] + loopIndex];
+                }
+            }
+            output[outputOffset + loopIndex] = CompileOperation(args);
+        });
+    }
+
     template <typename ValueType, typename FunctionType>
     void BroadcastOperationNode<ValueType, FunctionType>::Compute() const
     {
@@ -681,6 +797,12 @@ namespace nodes
         return GetFunction().Compile(args[0].function, args[0]);
     }
 
+    template <typename ValueType>
+    bool BroadcastUnaryOperationNode<ValueType>::CanVectorizeOperation() const
+    {
+        return _operation == UnaryOperationType::square;
+    }
+
     template <typename ValueType>
     void BroadcastUnaryOperationNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
@@ -769,6 +891,21 @@ namespace nodes
         return GetFunction().Compile(args[0].function, args[0], args[1]);
     }
 
+    template <typename ValueType>
+    bool BroadcastBinaryOperationNode<ValueType>::CanVectorizeOperation() const
+    {
+        switch (_operation)
+        {
+        case BinaryOperationType::add:
+        case BinaryOperationType::subtract:
+        case BinaryOperationType::multiply:
+        case BinaryOperationType::divide:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     template <typename ValueType>
     void BroadcastBinaryOperationNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
@@ -866,6 +1003,12 @@ namespace nodes
         return GetFunction().Compile(args[0].function, args[0], args[1], args[2]);
     }
 
+    template <typename ValueType>
+    bool BroadcastTernaryOperationNode<ValueType>::CanVectorizeOperation() const
+    {
+        return _operation == TernaryOperationType::fma;
+    }
+
     template <typename ValueType>
     void BroadcastTernaryOperationNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
@@ -66,6 +66,9 @@ namespace nodes
         /// <returns> The window size </returns>
         size_t GetWindowSize() const { return _windowSize; }
 
+        /// <summary> Indicates if the node is pure. The buffer keeps previous inputs, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -154,23 +157,38 @@ namespace nodes
             inputSize = windowSize;
         }
         auto offset = windowSize - inputSize;
-       
-        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
-        auto bufferVar = function.GetModule().Variables().AddVectorVariable<ValueType>(emitters::VariableScope::global, windowSize);
-        function.GetModule().AllocateVariable(*bufferVar);
-        emitters::LLVMValue buffer = function.GetModule().EnsureEmitted(*bufferVar);
 
-        if (offset > 0)
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        if (offset == 0)
         {
-            // shift the buffer left by the input size to make room for new input
-            function.MemoryMove<ValueType>(buffer, inputSize, 0, offset);
+            // The window is just the latest input
+            function.MemoryCopy<ValueType>(pInput, 0, pOutput, 0, windowSize);
+            return;
         }
-        // Copy input to right hand side of the buffer
-        function.MemoryCopy<ValueType>(pInput, 0, buffer, offset, inputSize);
+
+        // The buffer is a ring buffer that holds the window twice in a row, so the window is always contiguous, starting
+        // at `start`, the index of its oldest value. The input overwrites the oldest values in both copies, which is the
+        // same as shifting the window left by the input size, without moving the rest of the window.
+        auto& module = function.GetModule();
+        auto bufferVar = module.Variables().AddVectorVariable<ValueType>(emitters::VariableScope::global, 2 * windowSize);
+        module.AllocateVariable(*bufferVar);
+        emitters::LLVMValue buffer = module.EnsureEmitted(*bufferVar);
+        llvm::GlobalVariable* startVar = module.Global<int>(compiler.GetGlobalName(*this, "start"), 0);
+
+        auto start = function.LocalScalar(function.Load(startVar));
+        auto size = function.LocalScalar<int>(windowSize);
+        function.For(inputSize, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar i) {
+            auto index = function.LocalScalar(function.Operator(emitters::TypedOperator::moduloSigned, start + i, size));
+            auto value = function.ValueAt(pInput, i);
+            function.SetValueAt(buffer, index, value);
+            function.SetValueAt(buffer, index + size, value);
+        });
+        auto newStart = function.LocalScalar(function.Operator(emitters::TypedOperator::moduloSigned, start + inputSize, size));
+        function.Store(startVar, newStart);
 
         // Copy to output
-        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
-        function.MemoryCopy<ValueType>(buffer, 0, pOutput, 0, windowSize);
+        function.MemoryCopy<ValueType>(buffer, newStart, pOutput, function.LocalScalar<int>(0), size);
     }
 
     template <typename ValueType>
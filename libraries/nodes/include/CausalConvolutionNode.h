@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CausalConvolutionNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that computes a 1-D causal convolution over a window of frames, such as the output of a `BufferNode`.
+    /// The input is `numFrames` frames of `frameSize` values, oldest first, and the output is the
+    /// `numFrames - filterSize + 1` frames of `numFilters` values that the filters produce without padding, also oldest
+    /// first. The weights are stored filter by filter, and each filter stores its `filterSize` taps oldest first, each tap
+    /// holding `frameSize` values.
+    ///
+    /// A node whose window is exactly `filterSize` frames produces one output frame per input window, which is how
+    /// `StreamingConvolutionTransformation` computes only the newest output frame of a sliding window.
+    /// </summary>
+    template <typename ValueType>
+    class CausalConvolutionNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        CausalConvolutionNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The window of frames to convolve. </param>
+        /// <param name="frameSize"> The number of values in an input frame. </param>
+        /// <param name="filterSize"> The number of frames each filter spans. </param>
+        /// <param name="weights"> The filter weights, `numFilters * filterSize * frameSize` values. </param>
+        CausalConvolutionNode(const model::OutputPort<ValueType>& input, size_t frameSize, size_t filterSize, const std::vector<ValueType>& weights);
+
+        /// <summary> Gets the number of values in an input frame. </summary>
+        size_t GetFrameSize() const { return _frameSize; }
+
+        /// <summary> Gets the number of frames each filter spans. </summary>
+        size_t GetFilterSize() const { return _filterSize; }
+
+        /// <summary> Gets the number of filters, which is the number of values in an output frame. </summary>
+        size_t GetNumFilters() const { return _weights.size() / (_filterSize * _frameSize); }
+
+        /// <summary> Gets the number of frames in the input window. </summary>
+        size_t GetNumInputFrames() const { return _input.Size() / _frameSize; }
+
+        /// <summary> Gets the number of frames in the output. </summary>
+        size_t GetNumOutputFrames() const { return GetNumInputFrames() - _filterSize + 1; }
+
+        /// <summary> Gets the filter weights. </summary>
+        const std::vector<ValueType>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("CausalConvolutionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: frameSize, filterSize, weights
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void ValidateParameters() const;
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        size_t _frameSize = 0;
+        size_t _filterSize = 0;
+        std::vector<ValueType> _weights;
+    };
+} // namespace nodes
+} // namespace ell
@@ -73,6 +73,9 @@ namespace nodes
         /// <returns> Ticks until the next interval. </param>
         TimeTickType GetTicksUntilNextInterval(TimeTickType now) const;
 
+        /// <summary> Indicates if the node is pure. The clock depends on the time it is called, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
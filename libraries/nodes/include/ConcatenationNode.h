@@ -120,14 +120,8 @@ namespace nodes
     {
         assert(GetPortVariableType(_input) == GetPortVariableType(_output));
 
-        auto inputIsInputNode = (dynamic_cast<const model::InputNodeBase*>(_input.GetInputElement(0).ReferencedPort()->GetNode()) != nullptr);
-        // TODO: re-enable this branch when scalar port bug is fixed
-        if (_input.Size() != 1 && _output.Size() != 1 && !inputIsInputNode && false)
-        {
-            auto pVar = compiler.GetVariableForPort(_input.GetReferencedPort());
-            compiler.SetVariableForPort(_output, pVar);
-        }
-        else
+        // The output has the same data as the input, so it can just refer to the input's buffer
+        if (_output.Size() != _input.Size() || !compiler.TrySetPortVariableToView(_output, _input.GetReferencedPort(), 0))
         {
             auto input = function.LocalArray(compiler.EnsurePortEmitted(_input));
             auto output = function.LocalArray(compiler.EnsurePortEmitted(_output));
@@ -52,19 +52,19 @@ namespace nodes
         /// Constructor for a vector constant
         ///
         /// <param name="value"> The vector value </param>
-        ConstantNode(const std::vector<ValueType>& value);
+        ConstantNode(std::vector<ValueType> value);
 
         /// Constructor for an arbitrary-shaped array constant
         ///
         /// <param name="value"> The vector value </param>
         /// <param name="shape"> The shape of the output data </param>
-        ConstantNode(const std::vector<ValueType>& value, const model::MemoryShape& shape);
+        ConstantNode(std::vector<ValueType> value, const model::MemoryShape& shape);
 
         /// Constructor for an arbitrary-shaped array constant
         ///
         /// <param name="value"> The vector value </param>
         /// <param name="layout"> The memory layout of the output data </param>
-        ConstantNode(const std::vector<ValueType>& value, const model::PortMemoryLayout& layout);
+        ConstantNode(std::vector<ValueType> value, const model::PortMemoryLayout& layout);
 
         /// <summary> Gets the values contained in this node </summary>
         ///
@@ -173,22 +173,22 @@ namespace nodes
 
     // Constructor for a vector constant
     template <typename ValueType>
-    ConstantNode<ValueType>::ConstantNode(const std::vector<ValueType>& values) :
+    ConstantNode<ValueType>::ConstantNode(std::vector<ValueType> values) :
         CompilableNode({}, { &_output }),
         _output(this, defaultOutputPortName, values.size()),
-        _values(values){};
+        _values(std::move(values)){};
 
     template <typename ValueType>
-    ConstantNode<ValueType>::ConstantNode(const std::vector<ValueType>& values, const model::MemoryShape& shape) :
+    ConstantNode<ValueType>::ConstantNode(std::vector<ValueType> values, const model::MemoryShape& shape) :
         CompilableNode({}, { &_output }),
         _output(this, defaultOutputPortName, shape),
-        _values(values){};
+        _values(std::move(values)){};
 
     template <typename ValueType>
-    ConstantNode<ValueType>::ConstantNode(const std::vector<ValueType>& values, const model::PortMemoryLayout& layout) :
+    ConstantNode<ValueType>::ConstantNode(std::vector<ValueType> values, const model::PortMemoryLayout& layout) :
         CompilableNode({}, { &_output }),
         _output(this, defaultOutputPortName, layout),
-        _values(values){};
+        _values(std::move(values)){};
 
     template <typename ValueType>
     void ConstantNode<ValueType>::Compute() const
@@ -17,6 +17,10 @@
 #include <model/include/OutputPort.h>
 #include <model/include/PortElements.h>
 
+#include <dsp/include/DCT.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
 #include <math/include/Matrix.h>
 
 #include <utilities/include/TypeName.h>
@@ -30,12 +34,16 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that performs a real-valued discrete cosine transform (DCT) on its input </summary>
+    /// <summary>
+    /// A node that performs a real-valued discrete cosine transform (DCT) on its input, computing only the first
+    /// `numFilters` coefficients. Small transforms, and those that are not a power of 2 in size, are refined into a
+    /// matrix-vector product. The node compiles larger ones itself, with an FFT of the same size (see `dsp::DCTPlan`).
+    /// </summary>
     ///
     /// <typeparam name="ValueType"> The element type. </typeparam>
     ///
     template <typename ValueType>
-    class DCTNode : public model::Node
+    class DCTNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -53,6 +61,9 @@ namespace nodes
         /// <param name="numFilters"> The number of DCT filters to use. Also, the output dimension. </param>
         DCTNode(const model::OutputPort<ValueType>& input, size_t numFilters);
 
+        /// <summary> Gets the number of DCT filters, which is the output dimension. </summary>
+        size_t GetNumFilters() const { return _dctCoeffs.NumRows(); }
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -63,8 +74,15 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if the node computes the DCT with an FFT, instead of being refined into a matrix-vector product. </summary>
+        bool UsesFastDCT() const { return dsp::IsFastDCTPreferred(_input.Size(), _dctCoeffs.NumRows()); }
+
+        /// <summary> Indicates if this node is able to compile itself to code. </summary>
+        bool IsCompilable(const model::MapCompiler* compiler) const override { return UsesFastDCT(); }
+
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         bool Refine(model::ModelTransformer& transformer) const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
@@ -72,6 +90,7 @@ namespace nodes
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
+        void Initialize(size_t numFilters);
 
         // Inputs
         model::InputPort<ValueType> _input;
@@ -79,8 +98,9 @@ namespace nodes
         // Output
         model::OutputPort<ValueType> _output;
 
-        // DCT Matrix
+        // DCT Matrix, and the plan of the FFT-based DCT when it's used
         math::RowMatrix<ValueType> _dctCoeffs;
+        dsp::DCTPlan<ValueType> _plan;
     };
 } // namespace nodes
 } // namespace ell
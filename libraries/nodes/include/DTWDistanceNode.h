@@ -32,7 +32,17 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that computes the dynamic time-warping distance between its inputs </summary>
+    /// <summary>
+    /// A node that computes the dynamic time-warping distance between the recent history of its input and a prototype.
+    /// Each new input sample updates one column of the time-warping matrix, so the cost per sample is proportional to the
+    /// prototype length. Two optional settings bound the work and the warping:
+    ///
+    /// * A Sakoe-Chiba band width: a match whose number of input samples differs from the number of prototype frames by more
+    ///   than the band width at any point along its path is rejected.
+    /// * An early-abandon threshold: a partial match whose (normalized) distance already reaches the threshold can only get
+    ///   worse, so it is abandoned without computing the rest of its sample distances. A distance at or above the threshold
+    ///   is reported as the largest representable value.
+    /// </summary>
     template <typename ValueType>
     class DTWDistanceNode : public model::CompilableNode
     {
@@ -50,7 +60,9 @@ namespace nodes
         ///
         /// <param name="input"> The signals to compare to the prototype </param>
         /// <param name="prototype"> The prototype </param>
-        DTWDistanceNode(const model::OutputPort<ValueType>& input, const std::vector<std::vector<ValueType>>& prototype);
+        /// <param name="bandWidth"> The Sakoe-Chiba band width, or 0 for an unconstrained warping path </param>
+        /// <param name="abandonThreshold"> The early-abandon distance threshold, or 0 to compute every distance in full </param>
+        DTWDistanceNode(const model::OutputPort<ValueType>& input, const std::vector<std::vector<ValueType>>& prototype, size_t bandWidth = 0, double abandonThreshold = 0);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -62,12 +74,21 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
-        /// <summary></summary>
+        /// <summary> Gets the prototype </summary>
         std::vector<std::vector<ValueType>> GetPrototype() const { return _prototype; }
 
+        /// <summary> Gets the Sakoe-Chiba band width, or 0 if the warping path is unconstrained </summary>
+        size_t GetBandWidth() const { return _bandWidth; }
+
+        /// <summary> Gets the early-abandon distance threshold, or 0 if early abandoning is disabled </summary>
+        double GetAbandonThreshold() const { return _abandonThreshold; }
+
         /// <summary> Reset the state of the node </summary>
         void Reset() override;
 
+        /// <summary> Indicates if the node is pure. The distance depends on previous inputs, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -79,6 +100,8 @@ namespace nodes
         void Copy(model::ModelTransformer& transformer) const override;
 
         std::vector<ValueType> GetPrototypeData() const;
+        ValueType GetAbandonDistance() const;
+        bool IsInBand(int currentTime, int start, size_t index) const;
 
         model::InputPort<ValueType> _input;
         model::OutputPort<ValueType> _output;
@@ -86,7 +109,8 @@ namespace nodes
         size_t _sampleDimension;
         size_t _prototypeLength;
         std::vector<std::vector<ValueType>> _prototype;
-        // double _threshold;
+        size_t _bandWidth = 0;
+        double _abandonThreshold = 0;
         double _prototypeVariance;
 
         mutable std::vector<ValueType> _d;
@@ -139,13 +163,18 @@ namespace nodes
     }
 
     template <typename ValueType>
-    DTWDistanceNode<ValueType>::DTWDistanceNode(const model::OutputPort<ValueType>& input, const std::vector<std::vector<ValueType>>& prototype) :
+    DTWDistanceNode<ValueType>::DTWDistanceNode(const model::OutputPort<ValueType>& input, const std::vector<std::vector<ValueType>>& prototype, size_t bandWidth, double abandonThreshold) :
         CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, 1),
-        _prototype(prototype)
+        _prototype(prototype),
+        _bandWidth(bandWidth),
+        _abandonThreshold(abandonThreshold)
     {
-        // _threshold = std::sqrt(-2 * std::log(confidenceThreshold)) * _prototypeVariance;
+        if (abandonThreshold < 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "DTWDistanceNode: the early-abandon threshold must not be negative");
+        }
         Reset();
     }
 
@@ -175,53 +204,76 @@ namespace nodes
         return static_cast<float>(s);
     }
 
+    template <typename ValueType>
+    ValueType DTWDistanceNode<ValueType>::GetAbandonDistance() const
+    {
+        // The distances are accumulated unnormalized, so the threshold is scaled by the prototype variance
+        const auto maxDistance = std::numeric_limits<ValueType>::max();
+        if (_abandonThreshold == 0 || _abandonThreshold * _prototypeVariance >= maxDistance)
+        {
+            return maxDistance;
+        }
+        return static_cast<ValueType>(_abandonThreshold * _prototypeVariance);
+    }
+
+    template <typename ValueType>
+    bool DTWDistanceNode<ValueType>::IsInBand(int currentTime, int start, size_t index) const
+    {
+        // The match covers input samples [start, currentTime] and prototype frames [1, index]
+        auto lengthDifference = (currentTime - start + 1) - static_cast<int>(index);
+        return _bandWidth == 0 || std::abs(lengthDifference) <= static_cast<int>(_bandWidth);
+    }
+
     template <typename ValueType>
     void DTWDistanceNode<ValueType>::Compute() const
     {
         std::vector<ValueType> input = _input.GetValue();
+        const auto abandonDistance = GetAbandonDistance();
         auto t = ++_currentTime;
-        auto dLast = _d[0] = 0;
-        auto sLast = _s[0] = t;
 
-        ValueType bestDist = 0;
-        int bestStart = 0;
+        // `_d` and `_s` hold the previous column of the time-warping matrix, and are updated in place. `dLast`
+        // and `sLast` hold the previous column's entry for the row above the one being updated.
+        ValueType dLast = _d[0];
+        int sLast = _s[0];
+        _d[0] = 0;
+        _s[0] = t;
+
         for (size_t index = 1; index < _prototypeLength + 1; ++index)
         {
-            auto d_iMinus1 = _d[index - 1];
             auto dPrev_iMinus1 = dLast;
-            auto dPrev_i = _d[index];
-            auto s_iMinus1 = _s[index - 1];
             auto sPrev_iMinus1 = sLast;
-            auto sPrev_i = _s[index];
+            dLast = _d[index];
+            sLast = _s[index];
+
+            // Find the best predecessor inside the band: from above, from the left, or diagonally
+            ValueType bestDist = std::numeric_limits<ValueType>::max();
+            int bestStart = t;
+            auto consider = [&](ValueType d, int s) {
+                if (d < bestDist && IsInBand(t, s, index))
+                {
+                    bestDist = d;
+                    bestStart = s;
+                }
+            };
+            consider(_d[index - 1], _s[index - 1]);
+            consider(dLast, sLast);
+            consider(dPrev_iMinus1, sPrev_iMinus1);
 
-            bestDist = d_iMinus1;
-            bestStart = s_iMinus1;
-            if (dPrev_i < bestDist)
+            if (bestDist >= abandonDistance)
             {
-                bestDist = dPrev_i;
-                bestStart = sPrev_i;
+                bestDist = std::numeric_limits<ValueType>::max();
             }
-            if (dPrev_iMinus1 < bestDist)
+            else
             {
-                bestDist = dPrev_iMinus1;
-                bestStart = sPrev_iMinus1;
+                bestDist += distance(_prototype[index - 1], input);
             }
-            bestDist += distance(_prototype[index - 1], input);
 
             _d[index] = bestDist;
             _s[index] = bestStart;
         }
-        assert(bestDist == _d[_prototypeLength]);
-        assert(bestStart == _s[_prototypeLength]);
-        auto result = bestDist / _prototypeVariance;
-
-        // Ensure best match is between 80% and 120% of prototype length
-        auto timeDiff = _currentTime - bestStart;
-        if (timeDiff < _prototypeLength * 0.8 || timeDiff > _prototypeLength * 1.2)
-        {
-            bestDist = std::numeric_limits<ValueType>::max();
-        }
 
+        auto bestDist = _d[_prototypeLength];
+        auto result = bestDist >= abandonDistance ? std::numeric_limits<ValueType>::max() : bestDist / _prototypeVariance;
         _output.SetOutput({ static_cast<ValueType>(result) });
     };
 
@@ -229,7 +281,7 @@ namespace nodes
     void DTWDistanceNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
         const auto& newinput = transformer.GetCorrespondingInputs(_input);
-        auto newNode = transformer.AddNode<DTWDistanceNode<ValueType>>(newinput, _prototype);
+        auto newNode = transformer.AddNode<DTWDistanceNode<ValueType>>(newinput, _prototype, _bandWidth, _abandonThreshold);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
@@ -255,60 +307,101 @@ namespace nodes
         assert(inputType == GetPortVariableType(_output));
         VerifyIsScalar(_output);
 
+        auto& module = function.GetModule();
         auto input = function.LocalArray(compiler.EnsurePortEmitted(_input));
         auto result = compiler.EnsurePortEmitted(_output);
 
-        // The prototype (constant)
-        emitters::Variable* pVarPrototype = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(GetPrototypeData());
+        const auto maxDistance = std::numeric_limits<ValueType>::max();
+        const auto abandonDistance = GetAbandonDistance();
+        const auto sampleDimension = static_cast<int>(_sampleDimension);
+        const auto bandWidth = static_cast<int>(_bandWidth);
+        const bool useBand = _bandWidth != 0;
 
-        // Global variables for the dynamic programming memory
-        emitters::Variable* pVarD = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, _prototypeLength + 1);
+        // The prototype (constant)
+        auto prototypeVector = function.LocalArray(module.ConstantArray(compiler.GetGlobalName(*this, "prototype"), GetPrototypeData()));
 
-        // get global state vars
-        auto prototypeVector = function.LocalArray(function.GetModule().EnsureEmitted(*pVarPrototype));
-        auto pD = function.LocalArray(function.GetModule().EnsureEmitted(*pVarD));
+        // Global variables for the dynamic programming memory: the current column of the time-warping matrix and,
+        // if the path is constrained to a band, the start time of each entry's match
+        std::vector<ValueType> initialD(_prototypeLength + 1, maxDistance);
+        initialD[0] = 0;
+        auto pD = function.LocalArray(module.GlobalArray(compiler.GetGlobalName(*this, "d"), initialD));
+        auto pS = function.LocalArray(useBand ? module.GlobalArray<int>(compiler.GetGlobalName(*this, "s"), _prototypeLength + 1) : nullptr);
+        auto pTime = useBand ? module.Global<int>(compiler.GetGlobalName(*this, "currentTime"), 0) : nullptr;
 
-        // incorrect usage of function.Variable --- should use IRModuleEmitter::EmitX(variable)
-        auto dist = function.Variable(inputType, "dist");
-        auto protoIndex = function.Variable(emitters::VariableType::Int32, "i");
         auto dLast = function.Variable(inputType, "dLast");
+        auto sLast = function.Variable(emitters::VariableType::Int32, "sLast");
         auto bestDist = function.Variable(inputType, "bestDist");
+        auto bestStart = function.Variable(emitters::VariableType::Int32, "bestStart");
 
         // initialize variables
-        function.StoreZero(protoIndex);
-        function.StoreZero(dLast);
+        auto t = useBand ? function.LocalScalar(function.Load(pTime)) + 1 : function.LocalScalar<int>(0);
+        function.Store(dLast, static_cast<emitters::IRLocalScalar>(pD[0]));
+        if (useBand)
+        {
+            function.Store(pTime, t);
+            function.Store(sLast, static_cast<emitters::IRLocalScalar>(pS[0]));
+            pS[0] = t;
+        }
+        pD[0] = function.Literal<ValueType>(0);
 
-        function.For(_prototypeLength, [pD, dLast, bestDist, dist, protoIndex, input, prototypeVector, this](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar iMinusOne) {
+        function.For(_prototypeLength, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar iMinusOne) {
             auto i = iMinusOne + 1;
-            auto d_iMinus1 = pD[iMinusOne];
+            auto d_iMinus1 = static_cast<emitters::IRLocalScalar>(pD[iMinusOne]);
             auto dPrev_iMinus1 = function.LocalScalar(function.Load(dLast));
-            auto dPrev_i = pD[i];
-
-            function.Store(bestDist, static_cast<emitters::IRLocalScalar>(d_iMinus1));
-
-            function.If(dPrev_i < d_iMinus1, [bestDist, dPrev_i](auto& function) {
-                function.Store(bestDist, static_cast<emitters::IRLocalScalar>(dPrev_i));
-            });
-
-            function.If(dPrev_iMinus1 < function.Load(bestDist), [bestDist, dPrev_iMinus1](auto& function) {
-                function.Store(bestDist, dPrev_iMinus1);
-            });
-
-            // Get dist
-            function.StoreZero(dist);
-            function.For(_sampleDimension, [dist, protoIndex, input, prototypeVector](emitters::IRFunctionEmitter& function, auto j) {
-                auto inputValue = input[j];
-                auto protoValue = prototypeVector[function.LocalScalar(function.Load(protoIndex))];
-                auto absDiff = emitters::Abs(inputValue - protoValue);
-                function.OperationAndUpdate(dist, emitters::GetAddForValueType<ValueType>(), absDiff);
-                function.OperationAndUpdate(protoIndex, emitters::TypedOperator::add, function.Literal(1));
-            });
-
-            function.OperationAndUpdate(bestDist, emitters::GetAddForValueType<ValueType>(), function.Load(dist)); // x += dist;
-            pD[i] = function.Load(bestDist); // d[i] = x;
+            auto dPrev_i = static_cast<emitters::IRLocalScalar>(pD[i]);
+            function.Store(dLast, dPrev_i);
+
+            // Find the best predecessor inside the band: from above, from the left, or diagonally
+            function.Store(bestDist, function.Literal<ValueType>(maxDistance));
+            if (useBand)
+            {
+                auto s_iMinus1 = static_cast<emitters::IRLocalScalar>(pS[iMinusOne]);
+                auto sPrev_iMinus1 = function.LocalScalar(function.Load(sLast));
+                auto sPrev_i = static_cast<emitters::IRLocalScalar>(pS[i]);
+                function.Store(sLast, sPrev_i);
+
+                auto consider = [&](emitters::IRLocalScalar d, emitters::IRLocalScalar s) {
+                    auto lengthDifference = t - s + 1 - i;
+                    auto inBand = (lengthDifference <= bandWidth) && (lengthDifference >= -bandWidth);
+                    function.If((d < function.LocalScalar(function.Load(bestDist))) && inBand, [bestDist, bestStart, d, s](auto& function) {
+                        function.Store(bestDist, d);
+                        function.Store(bestStart, s);
+                    });
+                };
+                consider(d_iMinus1, s_iMinus1);
+                consider(dPrev_i, sPrev_i);
+                consider(dPrev_iMinus1, sPrev_iMinus1);
+            }
+            else
+            {
+                auto best = emitters::Min(emitters::Min(d_iMinus1, dPrev_i), dPrev_iMinus1);
+                function.Store(bestDist, best);
+            }
+
+            function.If(function.LocalScalar(function.Load(bestDist)) >= abandonDistance, [pD, i, maxDistance](auto& function) {
+                        pD[i] = function.template Literal<ValueType>(maxDistance);
+                    })
+                .Else([pD, i, iMinusOne, bestDist, input, prototypeVector, sampleDimension](auto& function) {
+                    // The distance to this prototype frame, unrolled over the sample dimension
+                    auto protoBase = iMinusOne * sampleDimension;
+                    auto dist = function.LocalScalar(function.Load(bestDist));
+                    for (int j = 0; j < sampleDimension; ++j)
+                    {
+                        auto inputValue = static_cast<emitters::IRLocalScalar>(input[j]);
+                        auto protoValue = static_cast<emitters::IRLocalScalar>(prototypeVector[protoBase + j]);
+                        dist = dist + emitters::Abs(inputValue - protoValue);
+                    }
+                    pD[i] = dist;
+                });
+
+            if (useBand)
+            {
+                pS[i] = function.LocalScalar(function.Load(bestStart));
+            }
         });
 
-        function.Store(result, function.Load(bestDist) / function.LocalScalar<ValueType>(_prototypeVariance));
+        auto finalDist = static_cast<emitters::IRLocalScalar>(pD[static_cast<int>(_prototypeLength)]);
+        function.Store(result, function.Select(finalDist >= abandonDistance, function.Literal<ValueType>(maxDistance), finalDist / function.LocalScalar<ValueType>(_prototypeVariance)));
     }
 
     template <typename ValueType>
@@ -331,6 +424,8 @@ namespace nodes
         archiver["prototype_columns"] << numColumns;
         math::Matrix<double, math::MatrixLayout::columnMajor> temp(numRows, numColumns, elements);
         math::MatrixArchiver::Write(temp, "prototype", archiver);
+        archiver["bandWidth"] << _bandWidth;
+        archiver["abandonThreshold"] << _abandonThreshold;
     }
 
     template <typename ValueType>
@@ -349,6 +444,11 @@ namespace nodes
         {
             _prototype.emplace_back(temp.GetRow(i).ToArray());
         }
+        if (archiver.HasNextPropertyName("bandWidth"))
+        {
+            archiver["bandWidth"] >> _bandWidth;
+            archiver["abandonThreshold"] >> _abandonThreshold;
+        }
         Reset();
     }
 } // namespace nodes
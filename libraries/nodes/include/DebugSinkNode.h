@@ -70,6 +70,9 @@ namespace nodes
         /// <returns> The node label. </returns>
         virtual std::string GetLabel() const { return _label; }
 
+        /// <summary> Indicates if the node is pure. The node calls a user-provided callback, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         bool ShouldCompileInline() const override;
         void Compute() const override;
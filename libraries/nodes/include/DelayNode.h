@@ -61,6 +61,9 @@ namespace nodes
         /// <summary>Return the window size</summary>
         size_t GetWindowSize() const { return _windowSize; }
 
+        /// <summary> Indicates if the node is pure. The node outputs previous inputs, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -142,16 +145,25 @@ namespace nodes
         //
         // Delay nodes are always long lived - either globals or heap. Currently, we use globals
         // Each sample chunk is of size == sampleSize. The number of chunks we hold onto == windowSize
-        // We need two buffers - one for the entire lot, one for the "last" chunk forwarded to the next operator
         //
-        emitters::Variable* delayLineVar = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, bufferSize);
-        emitters::LLVMValue delayLine = function.GetModule().EnsureEmitted(*delayLineVar);
+        auto& module = function.GetModule();
+        emitters::Variable* delayLineVar = module.Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, bufferSize);
+        emitters::LLVMValue delayLine = module.EnsureEmitted(*delayLineVar);
+        llvm::GlobalVariable* headVar = module.Global<int>(compiler.GetGlobalName(*this, "head"), 0);
 
         //
-        // We implement a delay as a Shift Register
+        // We implement a delay as a ring buffer of samples, where `head` is the index of the oldest one. The oldest sample
+        // is the output, and the input takes its place, so only one sample is copied in and out instead of shifting the
+        // whole delay line.
         //
         emitters::LLVMValue inputBuffer = compiler.EnsurePortEmitted(input);
-        function.ShiftAndUpdate<ValueType>(delayLine, bufferSize, sampleSize, inputBuffer, result);
+        auto head = function.LocalScalar(function.Load(headVar));
+        auto offset = head * static_cast<int>(sampleSize);
+        auto zero = function.LocalScalar<int>(0);
+        auto count = function.LocalScalar<int>(static_cast<int>(sampleSize));
+        function.MemoryCopy<ValueType>(delayLine, offset, result, zero, count);
+        function.MemoryCopy<ValueType>(inputBuffer, zero, delayLine, offset, count);
+        function.Store(headVar, function.Operator(emitters::TypedOperator::moduloSigned, head + 1, function.LocalScalar<int>(static_cast<int>(windowSize))));
     }
 
     template <typename ValueType>
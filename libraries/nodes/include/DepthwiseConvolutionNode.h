@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DepthwiseConvolutionNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <math/include/Tensor.h>
+
+#include <model/include/IRMapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/PortElements.h>
+#include <model/include/PortMemoryLayout.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that implements depthwise separable convolution (one filter per input channel) directly on
+    /// (row, column, channel)-ordered data, without reshaping the input. Adjacent channels are contiguous in memory,
+    /// so the channels are processed in blocks of the compiler's vector width.
+    /// If depthwise convolution is specified, a depthwise separable ConvolutionalLayerNode will refine
+    /// itself into a DepthwiseConvolutionNode.
+    /// </summary>
+    template <typename ValueType>
+    class DepthwiseConvolutionNode : public model::CompilableNode
+    {
+    public:
+        using TensorType = math::ChannelColumnRowTensor<ValueType>;
+        using ConstTensorReferenceType = math::ConstChannelColumnRowTensorReference<ValueType>;
+
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default constructor. </summary>
+        DepthwiseConvolutionNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The ports to get input data from. </param>
+        /// <param name="inputMemoryLayout"> The layout of the input data, in (row, column, channel) order. Its padding must be the convolution's padding. </param>
+        /// <param name="outputMemoryLayout"> The layout of the output data, in (row, column, channel) order. </param>
+        /// <param name="filterWeights"> The weights for the convolutional filters. Stored
+        ///  as a 3D tensor of dimensions (d*fw) x fw x 1, where d == input depth (== # filters) and fw == filter width. </param>
+        /// <param name="stride"> The output stride. </param>
+        DepthwiseConvolutionNode(const model::OutputPort<ValueType>& input,
+                                 const model::PortMemoryLayout& inputMemoryLayout,
+                                 const model::PortMemoryLayout& outputMemoryLayout,
+                                 const ConstTensorReferenceType& filterWeights,
+                                 int stride);
+
+        /// <summary> Gets information about the input memory layout </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
+
+        /// <summary> Gets information about the output memory layout </summary>
+        model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
+
+        /// <summary> Returns true if the node can accept input with this memory layout order, else false </summary>
+        ///
+        /// <param name="order"> The memory layout order for all the input ports </summary>
+        /// <returns> If the node can accept the input memory layout order, true, else false </returns>
+        bool CanAcceptInputLayout(const utilities::DimensionOrder& order) const override
+        {
+            return GetInputMemoryLayout().GetLogicalDimensionOrder() == order;
+        }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("DepthwiseConvolutionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: convolutional parameters and memory layout
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        // Returns the weights in (row, column, channel) order, so the weights for a block of channels are contiguous
+        std::vector<ValueType> GetInterleavedWeights() const;
+
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        model::PortMemoryLayout _inputMemoryLayout;
+
+        TensorType _filterWeights;
+
+        int _stride = 1;
+    };
+} // namespace nodes
+} // namespace ell
@@ -16,9 +16,12 @@
 #include <model/include/Node.h>
 #include <model/include/OutputPort.h>
 
+#include <emitters/include/IRVectorUtilities.h>
+
 #include <utilities/include/TypeName.h>
 
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 namespace ell
@@ -76,6 +79,7 @@ namespace nodes
         bool HasState() const override { return false; }
         emitters::LLVMFunction GetOperator(model::IRMapCompiler& compiler) const;
         void CompileLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
+        void CompileVectorizedLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
         void CompileExpanded(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
@@ -224,7 +228,16 @@ namespace nodes
         VerifyIsScalar(argVal);
         if (!function.GetCompilerOptions().unrollLoops)
         {
-            CompileLoop(compiler, function);
+            size_t vectorSize = function.GetCompilerOptions().vectorWidth;
+            bool vectorize = function.GetCompilerOptions().allowVectorInstructions && (input.Size() > vectorSize);
+            if (vectorize)
+            {
+                CompileVectorizedLoop(compiler, function);
+            }
+            else
+            {
+                CompileLoop(compiler, function);
+            }
         }
         else
         {
@@ -260,6 +273,74 @@ namespace nodes
         function.Store(outArgVal, function.Load(bestIndex));
     }
 
+    template <typename ValueType, bool max>
+    void ExtremalValueNode<ValueType, max>::CompileVectorizedLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue inputVal = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue outVal = compiler.EnsurePortEmitted(val);
+        emitters::LLVMValue outArgVal = compiler.EnsurePortEmitted(argVal);
+        const int size = static_cast<int>(input.Size());
+        const int vectorSize = function.GetCompilerOptions().vectorWidth;
+        const int numBlocks = size / vectorSize;
+        auto& emitter = function.GetEmitter();
+        auto& irBuilder = emitter.GetIRBuilder();
+        auto comparison = GetComparison();
+        auto equality = emitters::GetComparison<ValueType>(emitters::BinaryPredicateType::equal);
+
+        // Each vector lane keeps the extremal value and the index of its first occurrence among the elements it sees
+        auto vectorType = emitter.VectorType(GetPortVariableType(input), vectorSize);
+        auto indexVectorType = emitter.VectorType(emitters::VariableType::Int32, vectorSize);
+        std::vector<uint32_t> laneIndexValues(vectorSize);
+        std::iota(laneIndexValues.begin(), laneIndexValues.end(), 0);
+        emitters::LLVMValue laneIndices = llvm::ConstantDataVector::get(emitter.GetContext(), laneIndexValues);
+
+        emitters::LLVMValue bestVector = function.Variable(vectorType, "bestValVector");
+        emitters::LLVMValue bestIndexVector = function.Variable(indexVectorType, "bestArgValVector");
+        function.Store(bestVector, emitters::LoadVector<ValueType>(function, inputVal, function.Literal(0), vectorSize));
+        function.Store(bestIndexVector, laneIndices);
+        function.For(1, numBlocks, 1, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockIndex) {
+            auto offset = function.LocalScalar(blockIndex) * vectorSize;
+            auto value = emitters::LoadVector<ValueType>(function, inputVal, offset, vectorSize);
+            auto indices = function.Operator(emitters::TypedOperator::add, emitters::BroadcastToVector<int>(function, vectorSize, offset), laneIndices);
+            auto isBetter = function.Comparison(comparison, value, function.Load(bestVector));
+            function.Store(bestVector, function.Select(isBetter, value, function.Load(bestVector)));
+            function.Store(bestIndexVector, function.Select(isBetter, indices, function.Load(bestIndexVector)));
+        });
+
+        // Combine the lanes, preferring the smallest index among equal values so the result matches the scalar loop
+        emitters::LLVMValue vectorValues = function.Load(bestVector);
+        emitters::LLVMValue vectorIndices = function.Load(bestIndexVector);
+        emitters::LLVMValue bestValue = irBuilder.CreateExtractElement(vectorValues, static_cast<uint64_t>(0));
+        emitters::LLVMValue bestValueIndex = irBuilder.CreateExtractElement(vectorIndices, static_cast<uint64_t>(0));
+        for (int lane = 1; lane < vectorSize; ++lane)
+        {
+            auto laneValue = irBuilder.CreateExtractElement(vectorValues, static_cast<uint64_t>(lane));
+            auto laneIndex = irBuilder.CreateExtractElement(vectorIndices, static_cast<uint64_t>(lane));
+            auto isTiedEarlier = function.LogicalAnd(function.Comparison(equality, laneValue, bestValue), function.Comparison(emitters::TypedComparison::lessThan, laneIndex, bestValueIndex));
+            auto isBetter = function.LogicalOr(function.Comparison(comparison, laneValue, bestValue), isTiedEarlier);
+            bestValue = function.Select(isBetter, laneValue, bestValue);
+            bestValueIndex = function.Select(isBetter, laneIndex, bestValueIndex);
+        }
+
+        // The leftover elements come after all the others, so they only win if they're strictly better
+        emitters::LLVMValue bestVal = function.Variable(GetPortVariableType(input), "bestVal");
+        emitters::LLVMValue bestIndex = function.Variable(ell::emitters::VariableType::Int32, "bestArgVal");
+        function.Store(bestVal, bestValue);
+        function.Store(bestIndex, bestValueIndex);
+        if (numBlocks * vectorSize < size)
+        {
+            function.For(numBlocks * vectorSize, size, 1, [inputVal, bestVal, bestIndex, comparison](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+                auto val = function.ValueAt(inputVal, i);
+                function.If(comparison, val, function.Load(bestVal), [bestVal, bestIndex, val, i](auto& function) {
+                    function.Store(bestVal, val);
+                    function.Store(bestIndex, i);
+                });
+            });
+        }
+        function.Store(outVal, function.Load(bestVal));
+        function.Store(outArgVal, function.Load(bestIndex));
+    }
+
     template <typename ValueType, bool max>
     void ExtremalValueNode<ValueType, max>::CompileExpanded(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <dsp/include/FFT.h>
+
 #include <emitters/include/LLVMUtilities.h>
 
 #include <model/include/CompilableNode.h>
@@ -30,7 +32,11 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that performs a real-valued discrete ("fast") fourier transform (FFT) on its input </summary>
+    /// <summary>
+    /// A node that performs a real-valued discrete ("fast") fourier transform (FFT) on its input, and outputs the magnitudes
+    /// of the frequency bands. The twiddle factors and bit-reversal permutation are computed when the node is created (see
+    /// `dsp::FFTPlan`), and the emitted code stores them as constant tables, so each evaluation only does the butterflies.
+    /// </summary>
     template <typename ValueType>
     class FFTNode : public model::CompilableNode
     {
@@ -57,6 +63,9 @@ namespace nodes
         /// <param name="fftSize"> The FFT size. The output size of this node will be fftSize/2. </param>
         FFTNode(const model::OutputPort<ValueType>& input, size_t fftSize);
 
+        /// <summary> Gets the FFT size. </summary>
+        size_t GetFFTSize() const { return _fftSize; }
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -77,24 +86,6 @@ namespace nodes
     private:
         void Copy(model::ModelTransformer& transformer) const override;
 
-        // Emitting IR for FFT implemenations
-        void EmitFFT_2(emitters::IRFunctionEmitter& function, emitters::LLVMValue input);
-        void EmitFFT_4(emitters::IRFunctionEmitter& function, emitters::LLVMValue input);
-        void EmitFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch);
-        void EmitRealFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch, emitters::LLVMValue complexInput);
-
-        // Getting FFT functions
-        emitters::LLVMFunction GetRealFFTFunction(emitters::IRModuleEmitter& moduleEmitter, size_t length);
-        emitters::LLVMFunction GetFFTFunction(emitters::IRModuleEmitter& moduleEmitter, size_t length);
-
-        // Hand-unrolled fixed-size versions
-        emitters::LLVMFunction GetFFTFunction_2(emitters::IRModuleEmitter& moduleEmitter);
-        emitters::LLVMFunction GetFFTFunction_4(emitters::IRModuleEmitter& moduleEmitter);
-
-        // Performing FFT (either by calling a function or emitting inline code)
-        void DoFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch);
-        void DoRealFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch, emitters::LLVMValue complexInput);
-
         // Inputs
         model::InputPort<ValueType> _input;
 
@@ -102,8 +93,34 @@ namespace nodes
         model::OutputPort<ValueType> _output;
 
         size_t _fftSize;
+        dsp::FFTPlan<ValueType> _plan;
     };
 
+    /// <summary> Emits code that computes the magnitudes of the real-valued FFT of a signal, as `FFTNode` does. </summary>
+    ///
+    /// <param name="compiler"> The compiler, used to name the constant tables. </param>
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="node"> The node the code is emitted for, used to name the constant tables. </param>
+    /// <param name="plan"> The FFT plan. </param>
+    /// <param name="signal"> Pointer to the `plan.Size()` values of the signal. </param>
+    /// <param name="magnitudes"> Pointer to the `plan.Size() / 2` magnitudes to compute. </param>
+    template <typename ValueType>
+    void EmitFFTMagnitudes(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<ValueType>& plan, emitters::LLVMValue signal, emitters::LLVMValue magnitudes);
+
+    /// <summary>
+    /// Emits code that computes the first (N/2)+1 entries of the FFT of a real-valued signal, as
+    /// `dsp::FFTPlan::TransformReal` does. The complex values are stored interleaved: (real, imaginary).
+    /// </summary>
+    ///
+    /// <param name="compiler"> The compiler, used to name the constant tables. </param>
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="node"> The node the code is emitted for, used to name the constant tables. </param>
+    /// <param name="plan"> The FFT plan. </param>
+    /// <param name="signal"> Pointer to the `plan.Size()` values of the signal. </param>
+    /// <param name="spectrum"> Pointer to the `plan.Size() + 2` values of the spectrum to compute. </param>
+    template <typename ValueType>
+    void EmitRealFFT(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<ValueType>& plan, emitters::LLVMValue signal, emitters::LLVMValue spectrum);
+
     template <typename ValueType>
     const model::OutputPort<ValueType>& AppendFFT(const model::OutputPort<ValueType>& input, size_t fftSize)
     {
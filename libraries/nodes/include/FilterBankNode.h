@@ -57,7 +57,9 @@ namespace nodes
     /// 
     /// the idea then is the filters can overlap to create smooth samples of each band in the input, and the output then is sized to
     /// the number of filters.  The implementation is optimized on the assumption that each triangle is a relatively small slice of 
-    /// the input such that it is faster to compute each triangle than to do a dot products for each filter against the entire input.
+    /// the input such that it is faster to compute each triangle than to do a dot products for each filter against the entire input:
+    /// the filter coefficients are precomputed into a table packed to each filter's support, so the cost is proportional to the total
+    /// support of the filters rather than the number of filters times the input size.
     /// </summary>
     template <typename ValueType>
     class FilterBankNode : public model::CompilableNode
@@ -69,6 +71,9 @@ namespace nodes
         const model::OutputPort<ValueType>& output = _output;
         /// @}
 
+        /// <summary> Gets the filter bank. </summary>
+        const dsp::TriangleFilterBank& GetFilters() const { return _filters; }
+
     protected:
         /// <summary> Construct a FilterBankeNode from the given filters </summary>
         FilterBankNode(const dsp::TriangleFilterBank& filters);
@@ -94,6 +99,17 @@ namespace nodes
         ValueType _offset;
     };
 
+    /// <summary> Emits code that applies the active filters of a filter bank to a frequency response, as `FilterBankNode` does. </summary>
+    ///
+    /// <param name="compiler"> The compiler, used to name the coefficient tables. </param>
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="node"> The node the code is emitted for, used to name the coefficient tables. </param>
+    /// <param name="filters"> The filter bank. </param>
+    /// <param name="input"> Pointer to the frequency magnitudes to filter. </param>
+    /// <param name="output"> Pointer to the `filters.NumActiveFilters()` outputs. </param>
+    template <typename ValueType>
+    void EmitFilterBank(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::TriangleFilterBank& filters, emitters::LLVMValue input, emitters::LLVMValue output);
+
     /// <summary>
     /// A node that applies a linearly-spaced filter bank to an FFT output
     /// </summary>
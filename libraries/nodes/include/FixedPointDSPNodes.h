@@ -0,0 +1,430 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FixedPointDSPNodes.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortElements.h>
+
+#include <dsp/include/FilterBank.h>
+#include <dsp/include/FixedPoint.h>
+
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <vector>
+
+// The nodes in this file process Q15 fixed-point signals (see dsp/FixedPoint.h), for processors without floating
+// point hardware. The signals are held in 32-bit integer ports, the coefficients are Q15 (or, for IIR filters, a
+// fixed-point format chosen to fit them), and products are accumulated in 64-bit integers and then rounded and
+// saturated to Q15. A node whose result could exceed the Q15 range shifts its output right by a fixed number of
+// bits instead, so a signal is `q * scale / 2^15` for some `scale` that's known when the model is built (see
+// `FixedPointDSPTransformation`).
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> A node that converts a floating point signal to Q15, as `ToQ15(x / scale)`. </summary>
+    template <typename ValueType>
+    class ToFixedPointNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<int>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        ToFixedPointNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to convert. </param>
+        /// <param name="scale"> The value that's represented by 1.0 in Q15. Values with a larger magnitude saturate. </param>
+        ToFixedPointNode(const model::OutputPort<ValueType>& input, double scale);
+
+        /// <summary> Gets the value that's represented by 1.0 in Q15. </summary>
+        double GetScale() const { return _scale; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("ToFixedPointNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: scale
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        model::InputPort<ValueType> _input;
+        model::OutputPort<int> _output;
+        double _scale = 1.0;
+    };
+
+    /// <summary> A node that converts a Q15 signal to floating point, as `FromQ15(q) * scale`. </summary>
+    template <typename ValueType>
+    class FromFixedPointNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<int>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        FromFixedPointNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to convert. </param>
+        /// <param name="scale"> The value that's represented by 1.0 in Q15. </param>
+        FromFixedPointNode(const model::OutputPort<int>& input, double scale);
+
+        /// <summary> Gets the value that's represented by 1.0 in Q15. </summary>
+        double GetScale() const { return _scale; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("FromFixedPointNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: scale
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        model::InputPort<int> _input;
+        model::OutputPort<ValueType> _output;
+        double _scale = 1.0;
+    };
+
+    /// <summary> A node that multiplies a Q15 signal by a Q15 window, such as a Hamming window. </summary>
+    class FixedPointWindowNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<int>& input = _input;
+        const model::OutputPort<int>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        FixedPointWindowNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to apply the window to. </param>
+        /// <param name="window"> The Q15 window, the same size as the input. </param>
+        FixedPointWindowNode(const model::OutputPort<int>& input, const std::vector<int>& window);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "FixedPointWindowNode"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: window
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        model::InputPort<int> _input;
+        model::OutputPort<int> _output;
+        std::vector<int> _window;
+    };
+
+    /// <summary>
+    /// A node that computes the magnitudes of the first N/2 frequency bands of a Q15 signal, divided by the FFT size N,
+    /// in Q15 (see `dsp::FixedPointFFTPlan`).
+    /// </summary>
+    class FixedPointFFTNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<int>& input = _input;
+        const model::OutputPort<int>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        FixedPointFFTNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to process, which is zero-padded to the FFT size. </param>
+        /// <param name="fftSize"> The FFT size, a power of 2 at least as large as the input. The output size of this node will be fftSize / 2. </param>
+        FixedPointFFTNode(const model::OutputPort<int>& input, size_t fftSize);
+
+        /// <summary> Gets the FFT size. </summary>
+        size_t GetFFTSize() const { return _plan.Size(); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "FixedPointFFTNode"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return false; }
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        model::InputPort<int> _input;
+        model::OutputPort<int> _output;
+        dsp::FixedPointFFTPlan _plan;
+    };
+
+    /// <summary>
+    /// A node that applies a bank of triangular filters to Q15 frequency magnitudes, as `FilterBankNode` does, and
+    /// shifts the results right by `outputShift` bits.
+    /// </summary>
+    class FixedPointFilterBankNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<int>& input = _input;
+        const model::OutputPort<int>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        FixedPointFilterBankNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The frequency magnitudes to filter. </param>
+        /// <param name="filters"> The filter bank. Its coefficients are converted to Q15. </param>
+        /// <param name="outputShift"> The number of bits to shift the results right by. </param>
+        FixedPointFilterBankNode(const model::OutputPort<int>& input, const dsp::TriangleFilterBank& filters, int outputShift);
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The frequency magnitudes to filter. </param>
+        /// <param name="offsets"> The offset of each filter's coefficients, and the total number of coefficients at the end. </param>
+        /// <param name="startBins"> The first bin of each filter's support. </param>
+        /// <param name="coefficients"> The filters' Q15 coefficients, packed to their nonzero support. </param>
+        /// <param name="outputShift"> The number of bits to shift the results right by. </param>
+        FixedPointFilterBankNode(const model::OutputPort<int>& input, const std::vector<int>& offsets, const std::vector<int>& startBins, const std::vector<int>& coefficients, int outputShift);
+
+        /// <summary> Gets the number of bits the results are shifted right by. </summary>
+        int GetOutputShift() const { return _outputShift; }
+
+        /// <summary> Gets the largest sum of a filter's coefficients, which is the largest gain of the filter bank. </summary>
+        static double GetMaxGain(const dsp::TriangleFilterBank& filters);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "FixedPointFilterBankNode"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: filter coefficients
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        model::InputPort<int> _input;
+        model::OutputPort<int> _output;
+
+        // The filters' Q15 coefficients, packed to their nonzero support (see `dsp::PackedTriangleFilterCoefficients`)
+        std::vector<int> _offsets;
+        std::vector<int> _startBins;
+        std::vector<int> _coefficients;
+        int _outputShift = 0;
+    };
+
+    /// <summary>
+    /// A node that computes the discrete cosine transform (DCT-II) of a Q15 signal, as `DCTNode` does, and shifts the
+    /// results right by `outputShift` bits.
+    /// </summary>
+    class FixedPointDCTNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<int>& input = _input;
+        const model::OutputPort<int>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        FixedPointDCTNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to process. </param>
+        /// <param name="numFilters"> The number of DCT coefficients to compute. </param>
+        /// <param name="outputShift"> The number of bits to shift the results right by. </param>
+        FixedPointDCTNode(const model::OutputPort<int>& input, size_t numFilters, int outputShift);
+
+        /// <summary> Gets the number of bits the results are shifted right by. </summary>
+        int GetOutputShift() const { return _outputShift; }
+
+        /// <summary> Gets the largest gain of a DCT, which is the input size. </summary>
+        static double GetMaxGain(size_t inputSize) { return static_cast<double>(inputSize); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "FixedPointDCTNode"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: size
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Initialize(size_t numFilters);
+
+        model::InputPort<int> _input;
+        model::OutputPort<int> _output;
+
+        // The Q15 DCT matrix, row-major, `numFilters` x input size
+        std::vector<int> _coefficients;
+        size_t _numFilters = 0;
+        int _outputShift = 0;
+    };
+
+    /// <summary>
+    /// A node that applies an infinite impulse response (IIR) filter to a Q15 signal, as `IIRFilterNode` does. The
+    /// feedforward coefficients are divided by 2^outputShift, so the output is shifted right by `outputShift` bits.
+    /// </summary>
+    class FixedPointIIRFilterNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<int>& input = _input;
+        const model::OutputPort<int>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        FixedPointIIRFilterNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to process. </param>
+        /// <param name="b"> The feedforward coefficients of the filter. </param>
+        /// <param name="a"> The recursive coefficients of the filter. </param>
+        /// <param name="outputShift"> The number of bits to shift the output right by. </param>
+        FixedPointIIRFilterNode(const model::OutputPort<int>& input, const std::vector<double>& b, const std::vector<double>& a, int outputShift);
+
+        /// <summary> Gets the number of bits the output is shifted right by. </summary>
+        int GetOutputShift() const { return _outputShift; }
+
+        /// <summary>
+        /// Gets the sum of the magnitudes of the first samples of the filter's impulse response, which bounds the
+        /// gain of a stable filter.
+        /// </summary>
+        static double GetMaxGain(const std::vector<double>& b, const std::vector<double>& a);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "FixedPointIIRFilterNode"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Indicates if the node is pure. The filter keeps previous inputs and outputs, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: coefficients, and the past inputs and outputs
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Initialize();
+
+        model::InputPort<int> _input;
+        model::OutputPort<int> _output;
+
+        std::vector<double> _originalB;
+        std::vector<double> _originalA;
+        int _outputShift = 0;
+
+        // The fixed-point coefficients, with `_coefficientBits` fractional bits
+        std::vector<int> _b;
+        std::vector<int> _a;
+        int _coefficientBits = dsp::q15FractionalBits;
+
+        // Past inputs and outputs, most recent first
+        mutable std::vector<int> _previousInput;
+        mutable std::vector<int> _previousOutput;
+    };
+} // namespace nodes
+} // namespace ell
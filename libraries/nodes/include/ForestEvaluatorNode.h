@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestEvaluatorNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <predictors/include/ForestPredictor.h>
+
+#include <utilities/include/IArchivable.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A forest of binary threshold trees, flattened into arrays. The interior nodes of each tree are numbered in
+    /// breadth-first order, and the trees are stored one after another. Node 0 is a sink that every leaf edge leads to:
+    /// it has zero-valued edges that lead back to itself, so a traversal can run for a fixed number of steps without
+    /// checking whether it has reached a leaf.
+    /// </summary>
+    struct FlatForest
+    {
+        size_t numTrees = 0;
+        size_t numEdges = 0; // the number of edges in the original forest
+        double bias = 0;
+        std::vector<int> roots; // the root node of each tree
+        std::vector<int> depths; // the number of interior nodes on the longest path of each tree
+        std::vector<int> featureIndices; // the input element each node compares
+        std::vector<double> thresholds; // the threshold each node compares against
+        std::vector<int> children; // 2 entries per node: the node each edge leads to
+        std::vector<double> edgeValues; // 2 entries per node: the value each edge adds to the tree output
+        std::vector<int> edgeIndices; // 2 entries per node: the index of each edge in the original forest, or `numEdges` for the sink
+
+        /// <summary> Gets the number of input elements the forest reads. </summary>
+        size_t GetInputSize() const;
+    };
+
+    /// <summary> Flattens a forest of single-element threshold trees. </summary>
+    ///
+    /// <param name="forest"> The forest to flatten. </param>
+    ///
+    /// <returns> The flattened forest. </returns>
+    FlatForest GetFlatForest(const predictors::SimpleForestPredictor& forest);
+
+    /// <summary>
+    /// A node that evaluates a flattened forest of single-element threshold trees, with the same outputs as
+    /// `SimpleForestPredictorNode`. The compiled code walks several trees at once: each step selects an edge with a
+    /// compare rather than a branch, and the trees in a group run until the deepest of them reaches a leaf.
+    /// </summary>
+    class ForestEvaluatorNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        static constexpr const char* treeOutputsPortName = "treeOutputs";
+        static constexpr const char* edgeIndicatorVectorPortName = "edgeIndicatorVector";
+        const model::InputPort<double>& input = _input;
+        const model::OutputPort<double>& output = _output;
+        const model::OutputPort<double>& treeOutputs = _treeOutputs;
+        const model::OutputPort<bool>& edgeIndicatorVector = _edgeIndicatorVector;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        ForestEvaluatorNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The forest's input. </param>
+        /// <param name="forest"> The flattened forest. </param>
+        ForestEvaluatorNode(const model::OutputPort<double>& input, const FlatForest& forest);
+
+        /// <summary> Gets the flattened forest. </summary>
+        const FlatForest& GetForest() const { return _forest; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "ForestEvaluatorNode"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: forest
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void ValidateForest() const;
+
+        // Input
+        model::InputPort<double> _input;
+
+        // Outputs
+        model::OutputPort<double> _output;
+        model::OutputPort<double> _treeOutputs;
+        model::OutputPort<bool> _edgeIndicatorVector;
+
+        FlatForest _forest;
+    };
+} // namespace nodes
+} // namespace ell
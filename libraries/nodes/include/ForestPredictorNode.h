@@ -11,6 +11,7 @@
 #include "BinaryOperationNode.h"
 #include "ConstantNode.h"
 #include "DemultiplexerNode.h"
+#include "ForestEvaluatorNode.h"
 #include "ForestPredictorNode.h"
 #include "MultiplexerNode.h"
 #include "SingleElementThresholdNode.h"
@@ -25,6 +26,7 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -70,7 +72,11 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
-        /// <summary> Refines this node in the model being constructed by the transformer </summary>
+        /// <summary>
+        /// Refines this node in the model being constructed by the transformer. A forest of single-element threshold
+        /// trees with constant edges is refined to a `ForestEvaluatorNode`, unless the "compileForestToKernel" option is
+        /// false; other forests are expanded into a graph of split-rule, edge-predictor and multiplexer nodes.
+        /// </summary>
         bool Refine(model::ModelTransformer& transformer) const override;
 
     protected:
@@ -158,6 +164,21 @@ namespace nodes
     bool ForestPredictorNode<SplitRuleType, EdgePredictorType>::Refine(model::ModelTransformer& transformer) const
     {
         const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
+
+        if constexpr (std::is_same<SplitRuleType, predictors::SingleElementThresholdPredictor>::value && std::is_same<EdgePredictorType, predictors::ConstantPredictor>::value)
+        {
+            const auto* compiler = transformer.GetContext().GetCompiler();
+            auto compileToKernel = compiler == nullptr || compiler->GetModelOptimizerOptions(*this).template GetEntry<bool>("compileForestToKernel", true);
+            if (compileToKernel)
+            {
+                auto evaluatorNode = transformer.AddNode<ForestEvaluatorNode>(newPortElements, GetFlatForest(_forest));
+                transformer.MapNodeOutput(output, evaluatorNode->output);
+                transformer.MapNodeOutput(treeOutputs, evaluatorNode->treeOutputs);
+                transformer.MapNodeOutput(edgeIndicatorVector, evaluatorNode->edgeIndicatorVector);
+                return true;
+            }
+        }
+
         const auto& interiorNodes = _forest.GetInteriorNodes();
 
         // create a place to store references to the output ports of the sub-models at each interior node
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FusedLinearActivation.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <model/include/IRMapCompiler.h>
+#include <model/include/Node.h>
+
+#include <predictors/neural/include/Activation.h>
+
+#include <utilities/include/IArchivable.h>
+
+#include <memory>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// The elementwise operations a matrix product node applies to its output while writing it, instead of leaving
+    /// them to separate nodes that would read and write the whole output again: a linear function with per-channel
+    /// coefficients (a refined bias, scaling or batch normalization layer), followed by an optional activation.
+    /// The output is treated as a sequence of pixels with the channels innermost, so the value at index `i` uses the
+    /// coefficients of channel `i % numChannels`.
+    /// </summary>
+    template <typename ValueType>
+    class FusedLinearActivation
+    {
+    public:
+        using ActivationType = predictors::neural::Activation<ValueType>;
+
+        /// <summary> The coefficients of the linear function, once emitted as global constants. </summary>
+        struct EmittedCoefficients
+        {
+            llvm::GlobalVariable* scale = nullptr;
+            llvm::GlobalVariable* bias = nullptr;
+        };
+
+        /// <summary> Default constructor, which applies nothing. </summary>
+        FusedLinearActivation() = default;
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="scale"> The per-channel scale, or an empty vector for none. </param>
+        /// <param name="bias"> The per-channel bias, or an empty vector for none. </param>
+        FusedLinearActivation(std::vector<ValueType> scale, std::vector<ValueType> bias);
+
+        /// <summary> Indicates if there is nothing to apply. </summary>
+        bool IsEmpty() const { return _scale.empty() && _bias.empty() && !HasActivation(); }
+
+        /// <summary> Indicates if an activation is applied after the linear function. </summary>
+        bool HasActivation() const { return _activation != nullptr; }
+
+        /// <summary> Returns the number of channels of the linear function, or 0 if there is no linear function. </summary>
+        int GetNumChannels() const { return static_cast<int>(_scale.empty() ? _bias.size() : _scale.size()); }
+
+        /// <summary> Indicates if `ThenLinear` can append a linear function with the given number of channels. </summary>
+        bool CanAppendLinear(int numChannels) const { return !HasActivation() && (GetNumChannels() == 0 || GetNumChannels() == numChannels); }
+
+        /// <summary> Returns the operations that apply these and then another linear function, composed into one. </summary>
+        ///
+        /// <param name="scale"> The per-channel scale of the new function, or an empty vector for none. </param>
+        /// <param name="bias"> The per-channel bias of the new function, or an empty vector for none. </param>
+        FusedLinearActivation<ValueType> ThenLinear(const std::vector<ValueType>& scale, const std::vector<ValueType>& bias) const;
+
+        /// <summary> Returns the operations that apply these and then an activation. There must not be one already. </summary>
+        ///
+        /// <param name="activation"> The activation, which can't be a parametric ReLU. </param>
+        FusedLinearActivation<ValueType> ThenActivation(const ActivationType& activation) const;
+
+        /// <summary> Applies the operations on the host machine. </summary>
+        ///
+        /// <param name="values"> The output values, updated in place. </param>
+        void Apply(std::vector<ValueType>& values) const;
+
+        /// <summary> Emits the coefficients of the linear function as global constants of the module. </summary>
+        ///
+        /// <param name="compiler"> The compiler, used to name the constants. </param>
+        /// <param name="node"> The node that owns the operations. </param>
+        /// <param name="function"> The function being emitted. </param>
+        EmittedCoefficients EmitCoefficients(model::IRMapCompiler& compiler, const model::Node& node, emitters::IRFunctionEmitter& function) const;
+
+        /// <summary> Emits code that applies the operations in place to a range of the output. </summary>
+        ///
+        /// <param name="function"> The function being emitted. </param>
+        /// <param name="coefficients"> The coefficients returned by `EmitCoefficients`. </param>
+        /// <param name="values"> Pointer to the first value of the range, which must be the first channel of a pixel. </param>
+        /// <param name="size"> The number of values in the range, a multiple of the number of channels. </param>
+        void EmitApply(emitters::IRFunctionEmitter& function, const EmittedCoefficients& coefficients, emitters::LLVMValue values, int size) const;
+
+        /// <summary> Adds the operations to an archive, as properties of the node that owns them. </summary>
+        void WriteToArchive(utilities::Archiver& archiver) const;
+
+        /// <summary> Reads the operations from an archive, where they are optional. </summary>
+        void ReadFromArchive(utilities::Unarchiver& archiver);
+
+    private:
+        std::vector<ValueType> _scale;
+        std::vector<ValueType> _bias;
+        std::shared_ptr<const ActivationType> _activation;
+    };
+} // namespace nodes
+} // namespace ell
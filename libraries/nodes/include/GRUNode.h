@@ -46,6 +46,7 @@ namespace nodes
         /// <param name="hiddenBias"> The bias to be applied to the hidden state, must contain a stack of 3 (reset, hidden, output). </param>
         /// <param name="activation"> The activation function. </param>
         /// <param name="recurrentActivation"> The recurrent activation function. </param>
+        /// <param name="sequenceLength"> The number of frames in the input. The output holds the hidden state after each frame. </param>
         /// <param name="validateWeights"> Whether to check the size of the weights. </param>
         GRUNode(const model::OutputPort<ValueType>& input,
                 const model::OutputPortBase& resetTrigger,
@@ -56,6 +57,7 @@ namespace nodes
                 const model::OutputPort<ValueType>& hiddenBias,
                 const ActivationType& activation,
                 const ActivationType& recurrentActivation,
+                size_t sequenceLength = 1,
                 bool validateWeights = true);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GateNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/GateNodeBase.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortElements.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that passes its input through while its condition is true, and holds its previous output while
+    /// it's false. The nodes that only compute this node's input are skipped while the condition is false, in
+    /// the compiled code as well as when computing the model. The output starts at zero.
+    /// </summary>
+    template <typename ValueType>
+    class GateNode : public model::GateNodeBase
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        static constexpr const char* conditionPortName = "condition";
+        const model::InputPort<ValueType>& input = _input;
+        const model::InputPort<bool>& condition = _condition;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        GateNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The input to pass through while the condition is true. </param>
+        /// <param name="condition"> A single boolean value that says whether to compute the input. </param>
+        GateNode(const model::OutputPort<ValueType>& input, const model::OutputPort<bool>& condition);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("GateNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Indicates if the node is pure. The node can output previous inputs, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
+        /// <summary> Gets the input port whose value is passed through while the condition is true. </summary>
+        const model::InputPortBase& GetGatedInput() const override { return _input; }
+
+        /// <summary> Gets the condition input port. </summary>
+        const model::InputPort<bool>& GetConditionInput() const override { return _condition; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        bool HasState() const override { return true; }
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+        model::InputPort<bool> _condition;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        // The value held while the condition is false
+        mutable std::vector<ValueType> _heldValue;
+    };
+} // namespace nodes
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    GateNode<ValueType>::GateNode() :
+        GateNodeBase({ &_input, &_condition }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _condition(this, {}, conditionPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    GateNode<ValueType>::GateNode(const model::OutputPort<ValueType>& input, const model::OutputPort<bool>& condition) :
+        GateNodeBase({ &_input, &_condition }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _condition(this, condition, conditionPortName),
+        _output(this, defaultOutputPortName, _input.Size()),
+        _heldValue(_input.Size())
+    {
+        if (condition.Size() != 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "GateNode condition must be a single value");
+        }
+    }
+
+    template <typename ValueType>
+    void GateNode<ValueType>::Compute() const
+    {
+        if (_condition[0])
+        {
+            _heldValue = _input.GetValue();
+        }
+        _output.SetOutput(_heldValue);
+    }
+
+    template <typename ValueType>
+    void GateNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        auto size = static_cast<int>(output.Size());
+
+        // The held value lives in a global, because the input's buffer may be reused while the gate is closed
+        emitters::Variable* heldValueVar = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, output.Size());
+        emitters::LLVMValue heldValue = function.GetModule().EnsureEmitted(*heldValueVar);
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue conditionValue = compiler.LoadPortElementVariable(condition.GetInputElement(0));
+        function.If(emitters::TypedComparison::equals, conditionValue, function.Literal(true), [pInput, heldValue, size](emitters::IRFunctionEmitter& function) {
+            function.MemoryCopy<ValueType>(pInput, heldValue, size);
+        });
+
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        function.MemoryCopy<ValueType>(heldValue, pOutput, size);
+    }
+
+    template <typename ValueType>
+    void GateNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        const auto& newCondition = transformer.GetCorrespondingInputs(_condition);
+        auto newNode = transformer.AddNode<GateNode<ValueType>>(newInput, newCondition);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void GateNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[conditionPortName] << _condition;
+    }
+
+    template <typename ValueType>
+    void GateNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[conditionPortName] >> _condition;
+        _output.SetSize(_input.Size());
+        _heldValue.assign(_input.Size(), ValueType{});
+    }
+} // namespace nodes
+} // namespace ell
+
+#pragma endregion implementation
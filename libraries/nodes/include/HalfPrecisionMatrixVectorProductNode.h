@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     HalfPrecisionMatrixVectorProductNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortElements.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <math/include/Matrix.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> The 16-bit floating point formats that weights can be stored in. </summary>
+    enum class HalfPrecisionFormat
+    {
+        /// <summary> IEEE 754 half precision: 5 exponent bits and 10 mantissa bits. </summary>
+        float16,
+        /// <summary> The upper 16 bits of an IEEE 754 single precision value: 8 exponent bits and 7 mantissa bits. </summary>
+        bfloat16
+    };
+
+    /// <summary>
+    /// Converts a value to a 16-bit floating point value, rounding to nearest even. Values too large for the
+    /// format are clamped to its largest finite value, so weights never become infinite.
+    /// </summary>
+    ///
+    /// <param name="value"> The value to convert. </param>
+    /// <param name="format"> The 16-bit format. </param>
+    ///
+    /// <returns> The bits of the 16-bit value. </returns>
+    uint16_t ToHalfPrecision(float value, HalfPrecisionFormat format);
+
+    /// <summary> Converts a 16-bit floating point value to single precision. The conversion is exact. </summary>
+    ///
+    /// <param name="bits"> The bits of the 16-bit value. </param>
+    /// <param name="format"> The 16-bit format. </param>
+    ///
+    /// <returns> The value. </returns>
+    float FromHalfPrecision(uint16_t bits, HalfPrecisionFormat format);
+
+    /// <summary> A matrix stored as 16-bit floating point values. </summary>
+    struct HalfPrecisionMatrix
+    {
+        size_t numRows = 0;
+        size_t numColumns = 0;
+        HalfPrecisionFormat format = HalfPrecisionFormat::float16;
+        std::vector<uint16_t> values; // row-major, `numRows` x `numColumns`
+    };
+
+    /// <summary> Converts a matrix to 16-bit floating point values. </summary>
+    ///
+    /// <param name="matrix"> The matrix to convert. </param>
+    /// <param name="format"> The 16-bit format. </param>
+    ///
+    /// <returns> The converted matrix. </returns>
+    template <typename ValueType, math::MatrixLayout layout>
+    HalfPrecisionMatrix ToHalfPrecisionMatrix(math::ConstMatrixReference<ValueType, layout> matrix, HalfPrecisionFormat format);
+
+    /// <summary>
+    /// A node that multiplies a matrix with a vector, where the matrix is stored as 16-bit floating point values
+    /// (float16 or bfloat16) to halve the memory traffic of reading it. Each weight is widened to single precision
+    /// as it's loaded, and the products are accumulated in `ValueType`.
+    /// </summary>
+    template <typename ValueType>
+    class HalfPrecisionMatrixVectorProductNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        HalfPrecisionMatrixVectorProductNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The vector to multiply. </param>
+        /// <param name="weights"> The 16-bit matrix. </param>
+        HalfPrecisionMatrixVectorProductNode(const model::OutputPort<ValueType>& input, const HalfPrecisionMatrix& weights);
+
+        /// <summary> Gets the 16-bit matrix. </summary>
+        const HalfPrecisionMatrix& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("HalfPrecisionMatrixVectorProductNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: weights
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        emitters::LLVMValue EmitWidenWeight(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, emitters::LLVMValue weight) const;
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        HalfPrecisionMatrix _weights;
+    };
+} // namespace nodes
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType, math::MatrixLayout layout>
+    HalfPrecisionMatrix ToHalfPrecisionMatrix(math::ConstMatrixReference<ValueType, layout> matrix, HalfPrecisionFormat format)
+    {
+        HalfPrecisionMatrix result;
+        result.numRows = matrix.NumRows();
+        result.numColumns = matrix.NumColumns();
+        result.format = format;
+        result.values.reserve(result.numRows * result.numColumns);
+        for (size_t i = 0; i < result.numRows; ++i)
+        {
+            for (size_t j = 0; j < result.numColumns; ++j)
+            {
+                result.values.push_back(ToHalfPrecision(static_cast<float>(matrix(i, j)), format));
+            }
+        }
+        return result;
+    }
+} // namespace nodes
+} // namespace ell
+
+#pragma endregion implementation
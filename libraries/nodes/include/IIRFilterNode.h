@@ -51,6 +51,12 @@ namespace nodes
         /// <param name="a"> The recursive coefficients for the filter. </param>
         IIRFilterNode(const model::OutputPort<ValueType>& input, const std::vector<ValueType>& b, const std::vector<ValueType>& a);
 
+        /// <summary> Gets the feedforward coefficients of the filter. </summary>
+        std::vector<ValueType> GetFeedforwardCoefficients() const { return _filter.GetFeedforwardCoefficients(); }
+
+        /// <summary> Gets the recursive coefficients of the filter. </summary>
+        std::vector<ValueType> GetRecursiveCoefficients() const { return _filter.GetRecursiveCoefficients(); }
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -61,6 +67,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if the node is pure. The filter keeps previous inputs and outputs, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
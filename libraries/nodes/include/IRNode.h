@@ -63,6 +63,9 @@ namespace nodes
         /// <summary></summary>
         std::string GetIRCode() const { return _irCode; }
 
+        /// <summary> Indicates if the node is pure. The node runs arbitrary code, so it is assumed not to be. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         /// <summary> Constructor </summary>
         ///
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ImagePreprocessingNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that turns a camera frame into the input of an image model, in a single pass over the output pixels:
+    /// - an optional center crop to the largest region with the aspect ratio of the output, so the image isn't stretched,
+    /// - a bilinear resize to the output size, with the same pixel-center convention as OpenCV's `INTER_LINEAR`,
+    /// - a reordering of the channels (e.g. BGR to RGB),
+    /// - a normalization of each output channel, `(value - mean) * scale`,
+    /// - a conversion to `ValueType`.
+    ///
+    /// Both the input and output images are stored row by row, with the channels of each pixel interleaved. A
+    /// `float` or `double` input holds one value per element. An `int` input holds the frame's 8-bit unsigned values packed
+    /// 4 to an element, in memory order, so a `uint8` frame can be passed as is (e.g. `frame.view(numpy.int32)` in Python).
+    /// </summary>
+    template <typename InputValueType, typename ValueType>
+    class ImagePreprocessingNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<InputValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        ImagePreprocessingNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The input image. Its number of channels is its size divided by the number of pixels. </param>
+        /// <param name="inputRows"> The number of rows of the input image. </param>
+        /// <param name="inputColumns"> The number of columns of the input image. </param>
+        /// <param name="outputRows"> The number of rows of the output image. </param>
+        /// <param name="outputColumns"> The number of columns of the output image. </param>
+        /// <param name="centerCrop"> If true, crop the input to the output's aspect ratio before resizing it. </param>
+        /// <param name="channelOrder"> For each output channel, the input channel it comes from. The number of channels is its size. </param>
+        /// <param name="mean"> The value to subtract from each output channel. Empty for 0. </param>
+        /// <param name="scale"> The value to multiply each output channel by, after subtracting the mean. Empty for 1. </param>
+        ImagePreprocessingNode(const model::OutputPort<InputValueType>& input,
+                               int inputRows,
+                               int inputColumns,
+                               int outputRows,
+                               int outputColumns,
+                               bool centerCrop,
+                               const std::vector<int>& channelOrder,
+                               const std::vector<ValueType>& mean = {},
+                               const std::vector<ValueType>& scale = {});
+
+        /// <summary> Gets the number of channels of the input image. </summary>
+        int NumInputChannels() const { return _inputChannels; }
+
+        /// <summary> Gets the number of channels of the output image. </summary>
+        int NumOutputChannels() const { return static_cast<int>(_channelOrder.size()); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<InputValueType, ValueType>("ImagePreprocessingNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // Stored state: image sizes, crop, channel order, mean and scale
+
+    private:
+        // The two source rows (or columns) of each output row (or column) and the weight of the second one
+        struct SampleTable
+        {
+            std::vector<int> index0;
+            std::vector<int> index1;
+            std::vector<ValueType> weight;
+        };
+
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Initialize();
+        SampleTable GetSampleTable(int inputSize, int cropSize, int outputSize) const;
+        ValueType GetInputValue(const std::vector<InputValueType>& input, int index) const;
+        emitters::LLVMValue EmitInputValue(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::IRLocalScalar index) const;
+
+        // Inputs
+        model::InputPort<InputValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        int _inputRows = 0;
+        int _inputColumns = 0;
+        int _inputChannels = 0;
+        int _outputRows = 0;
+        int _outputColumns = 0;
+        bool _centerCrop = false;
+        std::vector<int> _channelOrder;
+        std::vector<ValueType> _mean;
+        std::vector<ValueType> _scale;
+        SampleTable _rows;
+        SampleTable _columns;
+    };
+} // namespace nodes
+} // namespace ell
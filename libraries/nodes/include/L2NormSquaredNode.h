@@ -8,12 +8,10 @@
 
 #pragma once
 
-#include "SumNode.h"
-#include "UnaryOperationNode.h"
-
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/InputPort.h>
 #include <model/include/ModelTransformer.h>
-#include <model/include/Node.h>
 #include <model/include/OutputPort.h>
 #include <model/include/PortElements.h>
 
@@ -28,7 +26,7 @@ namespace nodes
 {
     /// <summary> A node that takes a vector input and returns its magnitude squared </summary>
     template <typename ValueType>
-    class L2NormSquaredNode : public model::Node
+    class L2NormSquaredNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -54,11 +52,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
-        /// <summary> Refines this node in the model being constructed by the transformer </summary>
-        bool Refine(model::ModelTransformer& transformer) const override;
-
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return false; }
@@ -83,7 +79,7 @@ namespace nodes
 {
     template <typename ValueType>
     L2NormSquaredNode<ValueType>::L2NormSquaredNode() :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, {}, defaultInputPortName),
         _output(this, defaultOutputPortName, 1)
     {
@@ -91,7 +87,7 @@ namespace nodes
 
     template <typename ValueType>
     L2NormSquaredNode<ValueType>::L2NormSquaredNode(const model::OutputPort<ValueType>& input) :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, 1)
     {
@@ -118,14 +114,14 @@ namespace nodes
     }
 
     template <typename ValueType>
-    bool L2NormSquaredNode<ValueType>::Refine(model::ModelTransformer& transformer) const
+    void L2NormSquaredNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
-        const auto& squaredInput = AppendUnaryOperation(newPortElements, UnaryOperationType::square);
-        const auto& sum = AppendSum(squaredInput);
+        static_assert(!std::is_same<ValueType, bool>(), "Cannot instantiate boolean L2NormSquared nodes");
 
-        transformer.MapNodeOutput(output, sum);
-        return true;
+        // The squared norm is the dot product of the input with itself, which is vectorized without a squared copy of the input
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        function.DotProduct(static_cast<int>(input.Size()), pInput, pInput, pOutput);
     }
 
     template <typename ValueType>
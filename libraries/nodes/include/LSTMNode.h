@@ -49,6 +49,7 @@ namespace nodes
         /// <param name="hiddenBias"> The bias to be applied to the hidden state, must be a stack of 4 (input, forget, candidate, output) </param>
         /// <param name="activation"> The activation function. </param>
         /// <param name="recurrentActivation"> The recurrent activation function. </param>
+        /// <param name="sequenceLength"> The number of frames in the input. The output holds the hidden state after each frame. </param>
         /// <param name="validateWeights"> Whether to check the size of the weights. </param>
         LSTMNode(const model::OutputPort<ValueType>& input,
                  const model::OutputPortBase& resetTrigger,
@@ -59,6 +60,7 @@ namespace nodes
                  const model::OutputPort<ValueType>& hiddenBias,
                  const ActivationType& activation,
                  const ActivationType& recurrentActivation,
+                 size_t sequenceLength = 1,
                  bool validateWeights = true);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
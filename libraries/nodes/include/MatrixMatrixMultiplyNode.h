@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "FusedLinearActivation.h"
+
 #include <emitters/include/IRFunctionEmitter.h>
 
 #include <model/include/CompilableNode.h>
@@ -81,7 +83,8 @@ namespace nodes
         /// <param name="transpose1"> If true, transpose the left-hand input matrix. </param>
         /// <param name="transpose2"> If true, transpose the right-hand input matrix. </param>
         /// <param name="transposeOutput"> If true, transpose the output matrix. </param>
-        MatrixMatrixMultiplyNode(const model::OutputPort<ValueType>& input1, int m, int n, int k, int matrix1Stride, bool transpose1, const model::OutputPort<ValueType>& input2, int matrix2Stride, bool transpose2, int outputMatrixStride, bool transposeOutput);
+        /// <param name="outputOperations"> The elementwise operations to apply to the output as it's written, in the order it's stored. </param>
+        MatrixMatrixMultiplyNode(const model::OutputPort<ValueType>& input1, int m, int n, int k, int matrix1Stride, bool transpose1, const model::OutputPort<ValueType>& input2, int matrix2Stride, bool transpose2, int outputMatrixStride, bool transposeOutput, const FusedLinearActivation<ValueType>& outputOperations = {});
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -93,6 +96,28 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the elementwise operations applied to the output as it's written. </summary>
+        const FusedLinearActivation<ValueType>& GetOutputOperations() const { return _outputOperations; }
+
+        /// <summary>
+        /// Indicates if the output is stored contiguously, in rows that hold whole pixels of the given number of
+        /// channels, so that elementwise operations with per-channel coefficients can be fused into the product.
+        /// </summary>
+        ///
+        /// <param name="numChannels"> The number of channels of the operations' coefficients, or 0 if they have none. </param>
+        bool CanFuseOutputOperations(int numChannels) const;
+
+        /// <summary>
+        /// Adds a node to the model this node is in that computes the same product, from the same inputs, with other
+        /// output operations. Used to fuse the operations of later nodes into the product.
+        /// </summary>
+        ///
+        /// <param name="transformer"> The transformer building the model this node is in. </param>
+        /// <param name="outputOperations"> The output operations of the new node, which replace those of this one. </param>
+        ///
+        /// <returns> The new node. </returns>
+        MatrixMatrixMultiplyNode<ValueType>* AddNodeWithOutputOperations(model::ModelTransformer& transformer, const FusedLinearActivation<ValueType>& outputOperations) const;
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -100,10 +125,12 @@ namespace nodes
         bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
-        bool HasState() const override { return true; } // stored state:  m, n, k, lda, ldb, ldc, transpose
+        bool HasState() const override { return true; } // stored state:  m, n, k, lda, ldb, ldc, transpose, output operations
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
+        bool Batch(model::ModelTransformer& transformer, model::BatchContext& batch) const override;
+        void EmitBlockedGEMM(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, emitters::LLVMValue pInput1, emitters::LLVMValue pInput2, emitters::LLVMValue pOutput);
 
         // Inputs
         model::InputPort<ValueType> _input1;
@@ -117,6 +144,8 @@ namespace nodes
         int _m = 0, _n = 0, _k = 0;
         int _lda = 0, _ldb = 0, _ldc = 0;
         bool _transpose1 = false, _transpose2 = false, _transposeOutput = false;
+
+        FusedLinearActivation<ValueType> _outputOperations;
     };
 } // namespace nodes
 } // namespace ell
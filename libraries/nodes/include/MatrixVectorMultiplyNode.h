@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "FusedLinearActivation.h"
+
 #include <model/include/CompilableNode.h>
 #include <model/include/IRMapCompiler.h>
 #include <model/include/InputPort.h>
@@ -51,7 +53,8 @@ namespace nodes
         ///
         /// <param name="inputMatrix"> The left-hand input of the matrix multiplication. </param>
         /// <param name="inputVector"> The right-hand input of the matrix multiplication. </param>
-        MatrixVectorMultiplyNode(const model::OutputPort<ValueType>& inputMatrix, size_t m, size_t n, size_t matrixStride, const model::OutputPort<ValueType>& inputVector);
+        /// <param name="outputOperations"> The elementwise operations to apply to the output as it's written. </param>
+        MatrixVectorMultiplyNode(const model::OutputPort<ValueType>& inputMatrix, size_t m, size_t n, size_t matrixStride, const model::OutputPort<ValueType>& inputVector, const FusedLinearActivation<ValueType>& outputOperations = {});
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -63,15 +66,44 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the number of rows in the matrix. </summary>
+        size_t GetNumRows() const { return _m; }
+
+        /// <summary> Gets the number of columns in the matrix. </summary>
+        size_t GetNumColumns() const { return _n; }
+
+        /// <summary> Gets the distance between the starts of consecutive rows of the matrix. </summary>
+        size_t GetMatrixStride() const { return _lda; }
+
+        /// <summary> Gets the elementwise operations applied to the output as it's written. </summary>
+        const FusedLinearActivation<ValueType>& GetOutputOperations() const { return _outputOperations; }
+
+        /// <summary> Indicates if the output holds whole pixels of the given number of channels, so that elementwise operations with per-channel coefficients can be fused into the product. </summary>
+        ///
+        /// <param name="numChannels"> The number of channels of the operations' coefficients, or 0 if they have none. </param>
+        bool CanFuseOutputOperations(int numChannels) const { return numChannels == 0 || _m % numChannels == 0; }
+
+        /// <summary>
+        /// Adds a node to the model this node is in that computes the same product, from the same inputs, with other
+        /// output operations. Used to fuse the operations of later nodes into the product.
+        /// </summary>
+        ///
+        /// <param name="transformer"> The transformer building the model this node is in. </param>
+        /// <param name="outputOperations"> The output operations of the new node, which replace those of this one. </param>
+        ///
+        /// <returns> The new node. </returns>
+        MatrixVectorMultiplyNode<ValueType>* AddNodeWithOutputOperations(model::ModelTransformer& transformer, const FusedLinearActivation<ValueType>& outputOperations) const;
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
-        bool HasState() const override { return true; } // stored state: m, n, lda, incx
+        bool HasState() const override { return true; } // stored state: m, n, lda, incx, output operations
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
+        bool Batch(model::ModelTransformer& transformer, model::BatchContext& batch) const override;
 
         // Inputs
         model::InputPort<ValueType> _inputMatrix;
@@ -84,6 +116,8 @@ namespace nodes
         // Matrix is MxN, vector is of length N
         size_t _m, _n;
         size_t _lda, _incx;
+
+        FusedLinearActivation<ValueType> _outputOperations;
     };
 } // namespace nodes
 } // namespace ell
@@ -64,6 +64,9 @@ namespace nodes
         /// <summary> Refines this node in the model being constructed by the transformer </summary>
         bool Refine(model::ModelTransformer& transformer) const override;
 
+        /// <summary> Gets the projection matrix </summary>
+        const math::Matrix<ValueType, layout>& GetProjectionMatrix() const { return _w; }
+
     protected:
         void Compute() const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
@@ -60,6 +60,9 @@ namespace nodes
         /// <summary> Refines this node in the model being constructed by the transformer </summary>
         bool Refine(model::ModelTransformer& transformer) const override;
 
+        /// <summary> Indicates if the node is pure. The average depends on previous inputs, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MultichannelFFTNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <dsp/include/FFT.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that performs a real-valued FFT of each channel of a multichannel frame, and outputs the magnitudes of the
+    /// frequency bands, like an `FFTNode` per channel. The input holds the samples oldest first, and each sample holds
+    /// one value of every channel. The output is interleaved the same way: band `k` of channel `c` is at
+    /// `k * numChannels + c`. All the channels share one set of twiddle factor and bit-reversal tables, and the compiled
+    /// code does the butterflies of as many channels at once as fit in a vector.
+    /// </summary>
+    template <typename ValueType>
+    class MultichannelFFTNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        MultichannelFFTNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The interleaved samples of the channels. Its size must be a multiple of `numChannels`. </param>
+        /// <param name="numChannels"> The number of channels. </param>
+        /// <param name="fftSize"> The FFT size, a power of 2. Channels with fewer samples are zero-padded, and extra samples are ignored. The output size of this node will be (fftSize / 2) * numChannels. </param>
+        MultichannelFFTNode(const model::OutputPort<ValueType>& input, size_t numChannels, size_t fftSize);
+
+        /// <summary> Gets the number of channels. </summary>
+        size_t NumChannels() const { return _numChannels; }
+
+        /// <summary> Gets the FFT size. </summary>
+        size_t GetFFTSize() const { return _fftSize; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("MultichannelFFTNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // Stored state: numChannels, fftSize
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Initialize();
+        void EmitChannelBlock(emitters::IRFunctionEmitter& function, emitters::LLVMValue signal, emitters::LLVMValue output, emitters::LLVMValue twiddles, emitters::LLVMValue bitReversal, emitters::LLVMValue channel, int blockSize) const;
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        size_t _numChannels = 0;
+        size_t _fftSize = 0;
+        dsp::FFTPlan<ValueType> _plan;
+    };
+} // namespace nodes
+} // namespace ell
@@ -130,6 +130,9 @@ namespace nodes
         /// <summary> Gets the neural network base class Layer from the actual layer wrapped by this node </summary>
         typename predictors::neural::Layer<ValueType>& GetBaseLayer() const override { return _layer; }
 
+        /// <summary> Layer nodes are not reentrant: they compute in the input and output tensors of the layer they wrap. </summary>
+        bool IsReentrant() const override { return false; }
+
     protected:
         size_t NumInputDimensions() const { return _inputLayout.NumDimensions(); }
         model::PortMemoryLayout CalculateMemoryLayout(size_t padding, typename predictors::neural::Layer<ValueType>::Shape dataBufferSize);
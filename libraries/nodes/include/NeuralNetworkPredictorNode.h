@@ -109,6 +109,9 @@ namespace nodes
         /// <summary> Reset the state of the node </summary>
         void Reset() override;
 
+        /// <summary> Indicates if the node is pure. Recurrent layers keep state between calls, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         bool Refine(model::ModelTransformer& transformer) const override;
@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/Model.h>
 #include <model/include/ModelTransformer.h>
 #include <model/include/Node.h>
@@ -20,8 +24,15 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that represents a ProtoNN predictor. </summary>
-    class ProtoNNPredictorNode : public model::Node
+    /// <summary>
+    /// A node that represents a ProtoNN predictor. The compiled code is one fused pass over the prototypes: it projects
+    /// the input once, and then computes the distance, the Gaussian similarity and the label scores of each prototype in
+    /// turn, so the only intermediate buffer is the projected input.
+    ///
+    /// With the per-node option `protoNNSimilarityThreshold` set to a positive value, the compiled code skips the
+    /// prototypes whose similarity would be below it, which avoids their exponential and label updates.
+    /// </summary>
+    class ProtoNNPredictorNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -58,6 +69,7 @@ namespace nodes
 
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
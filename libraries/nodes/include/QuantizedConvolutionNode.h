@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedConvolutionNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "QuantizedMatrixVectorProductNode.h"
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortMemoryLayout.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that computes a convolution using 8-bit integer arithmetic. The filters are stored quantized, one row of
+    /// a `QuantizedMatrix` per filter, and the input is quantized on the fly with a fixed scale, as in
+    /// `QuantizedMatrixVectorProductNode`. The emitted code is an implicit GEMM: it gathers the quantized receptive
+    /// fields of a few output pixels at a time into a small 8-bit panel, and multiplies each row of the panel with each
+    /// filter using `EmitInt8DotProduct`. On Arm targets with the DSP extension (like the Cortex-M4 and M7), the panel
+    /// holds the quantized values paired up into 16-bit halves instead, and is multiplied with the filters using
+    /// `EmitDualMACDotProduct`, which does two multiply-accumulates per instruction.
+    /// </summary>
+    template <typename ValueType>
+    class QuantizedConvolutionNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default constructor. </summary>
+        QuantizedConvolutionNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The ports to get input data from. </param>
+        /// <param name="inputMemoryLayout"> The layout of the input data, in (row, column, channel) order with no padding between channels. Its padding supplies the zeros around the edges of the image. </param>
+        /// <param name="outputMemoryLayout"> The layout of the output data, in (row, column, channel) order with no padding. </param>
+        /// <param name="filterWeights"> The quantized filters, one per row, each in (row, column, channel) order. </param>
+        /// <param name="filterSize"> The width and height of the filters. </param>
+        /// <param name="stride"> The stride of the convolution. </param>
+        /// <param name="inputScale"> The scale used to quantize the input: inputs are clamped to [-127 * inputScale, 127 * inputScale]. </param>
+        QuantizedConvolutionNode(const model::OutputPort<ValueType>& input,
+                                 const model::PortMemoryLayout& inputMemoryLayout,
+                                 const model::PortMemoryLayout& outputMemoryLayout,
+                                 const QuantizedMatrix<ValueType>& filterWeights,
+                                 int filterSize,
+                                 int stride,
+                                 ValueType inputScale);
+
+        /// <summary> Gets information about the input memory layout </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
+
+        /// <summary> Gets information about the output memory layout </summary>
+        model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
+
+        /// <summary> Gets the quantized filters. </summary>
+        const QuantizedMatrix<ValueType>& GetFilterWeights() const { return _filterWeights; }
+
+        /// <summary> Gets the scale used to quantize the input. </summary>
+        ValueType GetInputScale() const { return _inputScale; }
+
+        /// <summary> Returns true if the node can accept input with this memory layout order, else false </summary>
+        ///
+        /// <param name="order"> The memory layout order for all the input ports </summary>
+        /// <returns> If the node can accept the input memory layout order, true, else false </returns>
+        bool CanAcceptInputLayout(const utilities::DimensionOrder& order) const override
+        {
+            return GetInputMemoryLayout().GetLogicalDimensionOrder() == order;
+        }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("QuantizedConvolutionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: weights, scales, convolutional parameters and memory layout
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void CheckLayouts() const;
+        void CompileWithDSPExtension(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
+        std::vector<ValueType> GetOutputScales() const;
+
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        model::PortMemoryLayout _inputMemoryLayout;
+
+        QuantizedMatrix<ValueType> _filterWeights;
+
+        int _filterSize = 0;
+        int _stride = 1;
+        ValueType _inputScale = 1;
+    };
+} // namespace nodes
+} // namespace ell
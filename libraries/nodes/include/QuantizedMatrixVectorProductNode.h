@@ -0,0 +1,253 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixVectorProductNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortElements.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRLocalScalar.h>
+
+#include <math/include/Matrix.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> A matrix quantized to 8-bit signed integers, with a separate scale factor for each row. </summary>
+    template <typename ValueType>
+    struct QuantizedMatrix
+    {
+        size_t numRows = 0;
+        size_t numColumns = 0;
+        std::vector<int8_t> values; // row-major, `numRows` x `numColumns`
+        std::vector<ValueType> rowScales; // original value = `values[i, j]` * `rowScales[i]`
+    };
+
+    /// <summary> Quantizes a matrix to 8-bit integers, using a symmetric range for each row. </summary>
+    ///
+    /// <param name="matrix"> The matrix to quantize. </param>
+    ///
+    /// <returns> The quantized matrix. </returns>
+    template <typename ValueType, math::MatrixLayout layout>
+    QuantizedMatrix<ValueType> QuantizeMatrix(math::ConstMatrixReference<ValueType, layout> matrix);
+
+    /// <summary> Quantizes a value to an 8-bit integer in the range [-127, 127]. </summary>
+    ///
+    /// <param name="value"> The value to quantize. </param>
+    /// <param name="scale"> The scale of the quantized representation: `value` is approximately the result times `scale`. </param>
+    ///
+    /// <returns> The quantized value. </returns>
+    template <typename ValueType>
+    int QuantizeValue(ValueType value, ValueType scale);
+
+    /// <summary> Emits code that quantizes a value the way `QuantizeValue` does. </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="value"> The value to quantize. </param>
+    /// <param name="scale"> The scale of the quantized representation. </param>
+    ///
+    /// <returns> The quantized value, as an 8-bit integer. </returns>
+    template <typename ValueType>
+    emitters::LLVMValue EmitQuantizeValue(emitters::IRFunctionEmitter& function, emitters::LLVMValue value, ValueType scale);
+
+    /// <summary>
+    /// Emits code for the dot product of two arrays of 8-bit integers, accumulated in 32 bits. The bulk of the arrays
+    /// is processed in vectors with one lane per byte of a vector register: each block is multiplied into 16-bit
+    /// products and added into 32-bit lanes, which vector backends turn into widening multiply-add instructions
+    /// (like PMADDWD on x86 and SMLAL or SDOT on Arm).
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="a"> Pointer to the first array. </param>
+    /// <param name="b"> Pointer to the second array. </param>
+    /// <param name="size"> The number of elements in each array. </param>
+    ///
+    /// <returns> The dot product, as a 32-bit integer. </returns>
+    emitters::LLVMValue EmitInt8DotProduct(emitters::IRFunctionEmitter& function, emitters::LLVMValue a, emitters::LLVMValue b, int size);
+
+    /// <summary>
+    /// Packs the rows of a matrix of 8-bit integers 4 to a 32-bit word, zero-padding each row to a whole number of
+    /// words, for `EmitDualMACDotProduct`.
+    /// </summary>
+    ///
+    /// <param name="values"> The values, in row-major order. </param>
+    /// <param name="numRows"> The number of rows. </param>
+    /// <param name="numColumns"> The number of columns. </param>
+    ///
+    /// <returns> The packed rows, each `(numColumns + 3) / 4` words long. </returns>
+    std::vector<int> PackInt8ValuesIntoWords(const std::vector<int8_t>& values, size_t numRows, size_t numColumns);
+
+    /// <summary>
+    /// Emits code that pairs up quantized values into the 16-bit halves of 32-bit words, in the order that
+    /// `EmitDualMACDotProduct` unpacks the weights in: (x0, x2) then (x1, x3) for each group of 4 values.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="values"> Pointer to the quantized values, one per 32-bit integer, zero-padded to `4 * numWords` values. </param>
+    /// <param name="packedValues"> Pointer to the `2 * numWords` 32-bit integers to write the pairs to. </param>
+    /// <param name="numWords"> The number of words of packed weights the values are multiplied with. </param>
+    void EmitPackDualMACInput(emitters::IRFunctionEmitter& function, emitters::LLVMValue values, emitters::LLVMValue packedValues, int numWords);
+
+    /// <summary>
+    /// Emits code for the dot product of a row of weights packed by `PackInt8ValuesIntoWords` with an input packed by
+    /// `EmitPackDualMACInput`, for Arm targets with the DSP extension (like the Cortex-M4 and M7). SXTB16 sign-extends
+    /// bytes 0 and 2 of a word of weights into two 16-bit halves, and SXTB16 of the word rotated by 8 bits does bytes 1
+    /// and 3, so each SMLAD multiplies two weights by two inputs and adds both products to the sum, as the CMSIS-NN
+    /// kernels do.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="packedWeights"> Pointer to the packed row of weights. </param>
+    /// <param name="packedInput"> Pointer to the packed input. </param>
+    /// <param name="numWords"> The number of words in the row of weights. </param>
+    ///
+    /// <returns> The dot product, as a 32-bit integer. </returns>
+    emitters::LLVMValue EmitDualMACDotProduct(emitters::IRFunctionEmitter& function, emitters::LLVMValue packedWeights, emitters::LLVMValue packedInput, int numWords);
+
+    /// <summary>
+    /// A node that multiplies a matrix with a vector using 8-bit integer arithmetic. The matrix is stored quantized,
+    /// with one scale per row, and the input vector is quantized on the fly with a fixed scale (usually obtained by
+    /// calibrating on representative data). Products are accumulated in 32-bit integers, and are converted back to
+    /// `ValueType` at the end. The emitted code computes each row with `EmitInt8DotProduct`, except on Arm targets
+    /// with the DSP extension (like the Cortex-M4 and M7), where it does two multiply-accumulates per instruction, as
+    /// the CMSIS-NN kernels do.
+    /// </summary>
+    template <typename ValueType>
+    class QuantizedMatrixVectorProductNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        QuantizedMatrixVectorProductNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The vector to multiply. </param>
+        /// <param name="weights"> The quantized matrix. </param>
+        /// <param name="inputScale"> The scale used to quantize the input: inputs are clamped to [-127 * inputScale, 127 * inputScale]. </param>
+        QuantizedMatrixVectorProductNode(const model::OutputPort<ValueType>& input, const QuantizedMatrix<ValueType>& weights, ValueType inputScale);
+
+        /// <summary> Gets the quantized matrix. </summary>
+        const QuantizedMatrix<ValueType>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the scale used to quantize the input. </summary>
+        ValueType GetInputScale() const { return _inputScale; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("QuantizedMatrixVectorProductNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: weights, scales
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        std::vector<ValueType> GetOutputScales() const;
+        void CompileWithDSPExtension(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        QuantizedMatrix<ValueType> _weights;
+        ValueType _inputScale = 1;
+    };
+} // namespace nodes
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType, math::MatrixLayout layout>
+    QuantizedMatrix<ValueType> QuantizeMatrix(math::ConstMatrixReference<ValueType, layout> matrix)
+    {
+        QuantizedMatrix<ValueType> result;
+        result.numRows = matrix.NumRows();
+        result.numColumns = matrix.NumColumns();
+        result.values.reserve(result.numRows * result.numColumns);
+        result.rowScales.reserve(result.numRows);
+        for (size_t i = 0; i < result.numRows; ++i)
+        {
+            ValueType maxAbsValue = 0;
+            for (size_t j = 0; j < result.numColumns; ++j)
+            {
+                maxAbsValue = std::max(maxAbsValue, std::abs(matrix(i, j)));
+            }
+
+            // An all-zero row quantizes to zero with any scale
+            auto scale = maxAbsValue > 0 ? maxAbsValue / 127 : static_cast<ValueType>(1);
+            for (size_t j = 0; j < result.numColumns; ++j)
+            {
+                result.values.push_back(static_cast<int8_t>(QuantizeValue(matrix(i, j), scale)));
+            }
+            result.rowScales.push_back(scale);
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    int QuantizeValue(ValueType value, ValueType scale)
+    {
+        // Clamp before rounding, so the conversion to int can't overflow
+        auto scaledValue = std::clamp(value / scale, static_cast<ValueType>(-127), static_cast<ValueType>(127));
+        return static_cast<int>(scaledValue >= 0 ? scaledValue + static_cast<ValueType>(0.5) : scaledValue - static_cast<ValueType>(0.5));
+    }
+
+    template <typename ValueType>
+    emitters::LLVMValue EmitQuantizeValue(emitters::IRFunctionEmitter& function, emitters::LLVMValue value, ValueType scale)
+    {
+        auto scaledValue = function.LocalScalar(value) / scale;
+        auto minValue = function.LocalScalar<ValueType>(-127);
+        auto maxValue = function.LocalScalar<ValueType>(127);
+        auto clampedValue = function.LocalScalar(function.Select(scaledValue < minValue, minValue, scaledValue));
+        clampedValue = function.LocalScalar(function.Select(clampedValue > maxValue, maxValue, clampedValue));
+        auto roundedValue = function.Select(clampedValue >= static_cast<ValueType>(0), clampedValue + static_cast<ValueType>(0.5), clampedValue - static_cast<ValueType>(0.5));
+        return function.CastValue<char>(roundedValue);
+    }
+} // namespace nodes
+} // namespace ell
+
+#pragma endregion implementation
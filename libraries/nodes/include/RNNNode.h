@@ -20,13 +20,18 @@
 
 #include <utilities/include/StringUtil.h>
 
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace ell
 {
 namespace nodes
 {
-    ///<summary> The RNNNode implements simple recurrent neural network. See  See http://colah.github.io/posts/2015-08-Understanding-LSTMs/ </summary>
+    ///<summary>
+    /// The RNNNode implements simple recurrent neural network. See  See http://colah.github.io/posts/2015-08-Understanding-LSTMs/
+    /// The input can hold a sequence of several frames, oldest first, in which case the output holds the hidden state after each frame.
+    /// </summary>
     template <typename ValueType>
     class RNNNode : public model::CompilableNode
     {
@@ -62,7 +67,7 @@ namespace nodes
         /// <param name="inputBias"> The bias to be applied to the input. </param>
         /// <param name="hiddenBias"> The bias to be applied to the hidden state. </param>
         /// <param name="activation"> The activation function. </param>
-        /// <param name="recurrentActivation"> The recurrent activation function. </param>
+        /// <param name="sequenceLength"> The number of frames in the input. </param>
         /// <param name="validateWeights"> Whether to check the size of the weights. </param>
         RNNNode(const model::OutputPort<ValueType>& input,
                 const model::OutputPortBase& resetTrigger,
@@ -72,6 +77,7 @@ namespace nodes
                 const model::OutputPort<ValueType>& inputBias,
                 const model::OutputPort<ValueType>& hiddenBias,
                 const ActivationType& activation,
+                size_t sequenceLength = 1,
                 bool validateWeights = true);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
@@ -84,9 +90,18 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the number of frames in the input. </summary>
+        size_t GetSequenceLength() const { return _sequenceLength; }
+
+        /// <summary> Gets the size of one frame of the input. </summary>
+        size_t GetFrameSize() const { return _input.Size() / _sequenceLength; }
+
         /// <summary> Resets any state on the node, if any </summary>
         void Reset() override;
 
+        /// <summary> Indicates if the node is pure. The hidden state is kept between calls, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -105,11 +120,35 @@ namespace nodes
         model::InputPort<ValueType> _hiddenBias;
         model::OutputPort<ValueType> _output;
         ActivationType _activation;
+        size_t _sequenceLength = 1;
+
+        // Checks the sequence length and sets the output size
+        void ValidateSequenceLength();
 
         void ApplySoftmax(emitters::IRFunctionEmitter& function, emitters::LLVMValue data, size_t dataLength);
 
         void ApplyActivation(emitters::IRFunctionEmitter& function, const ActivationType& activation, emitters::LLVMValue data, size_t dataLength);
 
+        // Emits the gate pre-activations (W_i x + b_i + W_h h + b_h) for one time step into `preactivations`, which holds
+        // (2 * numGates - numFusedGates) * hiddenUnits values. Each of the first numFusedGates gates gets the sum of its input and
+        // hidden terms; each remaining gate gets its input term followed by its hidden term. If `inputProjection` is given, it
+        // holds the input terms W_i x + b_i of this time step, and only the hidden terms are computed. Otherwise, if the weights
+        // and biases are constant, they are packed into a single [W_i | W_h] matrix at compile time and the whole step is one GEMV over [x; h].
+        void EmitGatePreactivations(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int numGates, int numFusedGates, emitters::LLVMValue hiddenState, emitters::IRLocalArray preactivations, emitters::LLVMValue inputProjection = nullptr);
+
+        // Emits the input terms W_i x_t + b_i of every frame of the input as one GEMM into a sequenceLength x (numGates * hiddenUnits) matrix.
+        emitters::LLVMValue EmitInputProjections(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int numGates);
+
+        // The body of a time step: gets the input terms of the step (or nullptr if they aren't precomputed) and the step index
+        using TimeStepFunction = std::function<void(emitters::IRFunctionEmitter& function, emitters::LLVMValue inputProjection, emitters::IRLocalScalar timeStep)>;
+
+        // Emits `step` for each frame of the input. For a sequence, the input terms don't depend on the hidden state, so they are
+        // all computed up front by EmitInputProjections, and only the hidden terms remain in the time loop.
+        void EmitTimeSteps(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int numGates, TimeStepFunction step);
+
+        // Packs the weights and biases in the layout EmitGatePreactivations produces. Returns false if they aren't constant.
+        bool GetPackedGateWeights(int numGates, int numFusedGates, std::vector<ValueType>& weights, std::vector<ValueType>& bias) const;
+
         using VectorType = math::ColumnVector<ValueType>;
 
         // Hidden state for compute
@@ -117,6 +156,9 @@ namespace nodes
 
         bool ShouldReset() const;
 
+        // Checks the reset trigger and sets the output to `output`, the hidden states after each frame
+        void SetSequenceOutput(std::vector<ValueType>& output) const;
+
     private:
         mutable int _lastResetValue;
     };
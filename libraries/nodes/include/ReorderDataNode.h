@@ -53,7 +53,8 @@ namespace nodes
         ///
         /// <param name="input"> The input to reorder. </param>
         /// <param name="inputMemoryLayout"> The memory layout of the input. Only data in the "active" area will be copied. </param>
-        /// <param name="outputMemoryLayout"> The memory layout of the output. Data will be copied into the "active" area, and the rest will be zeroed out. </param>
+        /// <param name="outputMemoryLayout"> The memory layout of the output. Data will be copied into the "active" area, and the rest will be zeroed out.
+        ///   If one of the layouts is the channel-blocked version of the other (see `model::GetChannelBlockedLayout`), the channels are blocked or unblocked. </param>
         ReorderDataNode(const model::OutputPort<ValueType>& input, const model::PortMemoryLayout& inputMemoryLayout, const model::PortMemoryLayout& outputMemoryLayout, ValueType paddingValue = 0);
 
         /// <summary> Constructor with reordering </summary>
@@ -119,6 +120,11 @@ namespace nodes
         model::MemoryCoordinates ReorderOutputToInputLocation(model::MemoryCoordinates outputLocation) const;
         std::vector<emitters::IRLocalScalar> ReorderOutputToInputLocation(std::vector<emitters::IRLocalScalar> outputLocation) const;
 
+        // Blocking the channels rounds them up to a whole number of blocks: the extra output channels have no corresponding input
+        bool HasChannelPadding() const;
+        bool IsChannelPadding(model::MemoryCoordinates outputLocation) const;
+        emitters::IRLocalScalar IsChannelPadding(std::vector<emitters::IRLocalScalar> outputLocation) const;
+
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
 
@@ -211,6 +217,72 @@ namespace nodes
             }
             return result;
         }
+
+        // Channel-blocked layouts (see `model::GetChannelBlockedLayout`) split the channel dimension into
+        // (channel block, channel within block), so copying to or from one converts between the two forms of the channel index
+        inline int GetChannelBlockSize(const model::PortMemoryLayout& layout)
+        {
+            return model::IsChannelBlockedLayout(layout) ? layout.GetLogicalDimensionActiveSize(3) : 0;
+        }
+
+        inline bool ConvertsChannelBlocks(const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout)
+        {
+            const auto inputBlockSize = GetChannelBlockSize(inputLayout);
+            const auto outputBlockSize = GetChannelBlockSize(outputLayout);
+            if (inputLayout.NumDimensions() == outputLayout.NumDimensions())
+            {
+                return inputBlockSize != 0 && outputBlockSize != 0 && inputBlockSize != outputBlockSize;
+            }
+            return (inputLayout.NumDimensions() == outputLayout.NumDimensions() + 1 && inputBlockSize != 0) ||
+                   (outputLayout.NumDimensions() == inputLayout.NumDimensions() + 1 && outputBlockSize != 0);
+        }
+
+        // The number of channels stored in a (possibly channel-blocked) layout
+        inline int GetNumChannels(const model::PortMemoryLayout& layout)
+        {
+            const auto blockSize = GetChannelBlockSize(layout);
+            return blockSize == 0 ? layout.GetLogicalDimensionActiveSize(2) : layout.GetLogicalDimensionActiveSize(2) * blockSize;
+        }
+
+        template <typename IndexType>
+        std::vector<IndexType> MergeChannelBlocks(const std::vector<IndexType>& coordinates, int blockSize)
+        {
+            return { coordinates[0], coordinates[1], coordinates[2] * blockSize + coordinates[3] };
+        }
+
+        template <typename IndexType>
+        std::vector<IndexType> SplitChannelBlocks(const std::vector<IndexType>& coordinates, int blockSize)
+        {
+            return { coordinates[0], coordinates[1], coordinates[2] / blockSize, coordinates[2] % blockSize };
+        }
+
+        // Converts logical output coordinates into logical input coordinates
+        template <typename IndexType>
+        std::vector<IndexType> ConvertChannelBlocks(const std::vector<IndexType>& coordinates, const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout)
+        {
+            auto result = coordinates;
+            if (ConvertsChannelBlocks(inputLayout, outputLayout))
+            {
+                if (auto outputBlockSize = GetChannelBlockSize(outputLayout); outputBlockSize != 0)
+                {
+                    result = MergeChannelBlocks(result, outputBlockSize);
+                }
+                if (auto inputBlockSize = GetChannelBlockSize(inputLayout); inputBlockSize != 0)
+                {
+                    result = SplitChannelBlocks(result, inputBlockSize);
+                }
+            }
+            return result;
+        }
+
+        inline void CheckLayoutDimensions(const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout)
+        {
+            if (inputLayout.NumDimensions() != outputLayout.NumDimensions() && !ConvertsChannelBlocks(inputLayout, outputLayout))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
+                                                "Error: input and output layouts must have same dimension");
+            }
+        }
     } // namespace ReorderDataNodeDetail
 
     //
@@ -236,11 +308,7 @@ namespace nodes
         _paddingValue(paddingValue)
     {
         _inputMemoryLayout = _input.GetMemoryLayout();
-        if (_inputMemoryLayout.NumDimensions() != outputMemoryLayout.NumDimensions())
-        {
-            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
-                                            "Error: input and output layouts must have same dimension");
-        }
+        ReorderDataNodeDetail::CheckLayoutDimensions(_inputMemoryLayout, outputMemoryLayout);
     }
 
     template <typename ValueType>
@@ -254,11 +322,7 @@ namespace nodes
         _inputMemoryLayout(inputMemoryLayout),
         _paddingValue(paddingValue)
     {
-        if (inputMemoryLayout.NumDimensions() != outputMemoryLayout.NumDimensions())
-        {
-            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
-                                            "Error: input and output layouts must have same dimension");
-        }
+        ReorderDataNodeDetail::CheckLayoutDimensions(inputMemoryLayout, outputMemoryLayout);
     }
 
     //
@@ -325,11 +389,39 @@ namespace nodes
 
         auto logicalCoordinates =
             ReorderDataNodeDetail::PhysicalToLogical(physicalOutputCoordinates, outputDimensionOrder);
+        logicalCoordinates = ReorderDataNodeDetail::ConvertChannelBlocks(logicalCoordinates.ToVector(), GetInputMemoryLayout(), GetOutputMemoryLayout());
         auto physicalInputCoordinates =
             ReorderDataNodeDetail::LogicalToPhysical(logicalCoordinates, inputDimensionOrder);
         return physicalInputCoordinates;
     }
 
+    template <typename ValueType>
+    bool ReorderDataNode<ValueType>::IsChannelPadding(model::MemoryCoordinates physicalOutputCoordinates) const
+    {
+        const auto outputLayout = GetOutputMemoryLayout();
+        auto logicalCoordinates = ReorderDataNodeDetail::PhysicalToLogical(physicalOutputCoordinates, outputLayout.GetLogicalDimensionOrder());
+        const auto blockSize = ReorderDataNodeDetail::GetChannelBlockSize(outputLayout);
+        return (logicalCoordinates[2] * blockSize) + logicalCoordinates[3] >= ReorderDataNodeDetail::GetNumChannels(GetInputMemoryLayout());
+    }
+
+    template <typename ValueType>
+    emitters::IRLocalScalar ReorderDataNode<ValueType>::IsChannelPadding(std::vector<emitters::IRLocalScalar> physicalOutputCoordinates) const
+    {
+        const auto outputLayout = GetOutputMemoryLayout();
+        auto logicalCoordinates = ReorderDataNodeDetail::PhysicalToLogical(physicalOutputCoordinates, outputLayout.GetLogicalDimensionOrder());
+        const auto blockSize = ReorderDataNodeDetail::GetChannelBlockSize(outputLayout);
+        return (logicalCoordinates[2] * blockSize) + logicalCoordinates[3] >= ReorderDataNodeDetail::GetNumChannels(GetInputMemoryLayout());
+    }
+
+    template <typename ValueType>
+    bool ReorderDataNode<ValueType>::HasChannelPadding() const
+    {
+        const auto inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        return ReorderDataNodeDetail::ConvertsChannelBlocks(inputLayout, outputLayout) && ReorderDataNodeDetail::GetChannelBlockSize(outputLayout) != 0 &&
+               ReorderDataNodeDetail::GetNumChannels(outputLayout) > ReorderDataNodeDetail::GetNumChannels(inputLayout);
+    }
+
     // TODO: for each dimension, loop over minimum of input and output interval. Then we don't have to check if the value is out-of-bounds
     template <typename ValueType>
     std::vector<emitters::IRLocalScalar> ReorderDataNode<ValueType>::ReorderOutputToInputLocation(
@@ -340,6 +432,7 @@ namespace nodes
 
         auto logicalCoordinates =
             ReorderDataNodeDetail::PhysicalToLogical(physicalOutputCoordinates, outputDimensionOrder);
+        logicalCoordinates = ReorderDataNodeDetail::ConvertChannelBlocks(logicalCoordinates, GetInputMemoryLayout(), GetOutputMemoryLayout());
         auto physicalInputCoordinates =
             ReorderDataNodeDetail::LogicalToPhysical(logicalCoordinates, inputDimensionOrder);
         return physicalInputCoordinates;
@@ -363,11 +456,16 @@ namespace nodes
                                                           std::vector<int>& coordinates,
                                                           std::vector<ValueType>& output) const
     {
-        if (dimension == inputMemoryLayout.NumDimensions() - 1) // last dimension
+        if (dimension == outputMemoryLayout.NumDimensions() - 1) // last dimension
         {
+            const bool hasChannelPadding = HasChannelPadding();
             for (int index = 0; index < outputMemoryLayout.GetActiveSize(dimension); ++index)
             {
                 coordinates[dimension] = index;
+                if (hasChannelPadding && IsChannelPadding(coordinates))
+                {
+                    continue;
+                }
 
                 auto inputLocation = ReorderOutputToInputLocation(coordinates);
                 auto inputIndex = inputMemoryLayout.GetEntryOffset(inputLocation);
@@ -397,13 +495,9 @@ namespace nodes
         }
         else
         {
-            const int numDimensions = inputMemoryLayout.NumDimensions();
+            const int numDimensions = outputMemoryLayout.NumDimensions();
             const int outputSize = outputMemoryLayout.GetMemorySize();
-            if (numDimensions != outputMemoryLayout.NumDimensions())
-            {
-                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
-                                                "Error: input and output layouts must have same dimension");
-            }
+            ReorderDataNodeDetail::CheckLayoutDimensions(inputMemoryLayout, outputMemoryLayout);
 
             std::vector<ValueType> output(outputSize, _paddingValue); // initialize to padding value
             std::vector<int> coordinates(numDimensions);
@@ -422,9 +516,14 @@ namespace nodes
         const auto inputMemoryLayout = GetInputMemoryLayout();
         const auto outputMemoryLayout = GetOutputMemoryLayout();
 
-        const int numDimensions = inputMemoryLayout.NumDimensions();
+        const int numDimensions = outputMemoryLayout.NumDimensions();
         const int outputSize = outputMemoryLayout.GetMemorySize();
-        UNUSED(outputSize);
+        const bool hasChannelPadding = HasChannelPadding();
+
+        // The output is written once, in order, and large outputs are read by the next node long after the first
+        // entries were written, so they're kept out of the cache to leave it for the input
+        const auto nonTemporalStoreThreshold = function.GetCompilerOptions().nonTemporalStoreThreshold;
+        const bool useNonTemporalStores = nonTemporalStoreThreshold > 0 && outputSize * static_cast<int>(sizeof(ValueType)) >= nonTemporalStoreThreshold;
 
         std::vector<emitters::IRFunctionEmitter::ConstLoopRange> ranges;
         for (int dimensionIndex = 0; dimensionIndex < numDimensions; ++dimensionIndex)
@@ -437,11 +536,33 @@ namespace nodes
                       output,
                       inputMemoryLayout,
                       outputMemoryLayout,
+                      hasChannelPadding,
+                      useNonTemporalStores,
                       this](emitters::IRFunctionEmitter& function, std::vector<emitters::IRLocalScalar> indices) {
-                         auto inputLocation = ReorderOutputToInputLocation(indices);
-                         auto inputIndex = model::EmitGetEntryOffset(function, inputLocation, inputMemoryLayout);
-                         auto outputIndex = model::EmitGetEntryOffset(function, indices, outputMemoryLayout);
-                         output[outputIndex] = input[inputIndex];
+                         auto copyEntry = [&](emitters::IRFunctionEmitter& function) {
+                             auto inputLocation = ReorderOutputToInputLocation(indices);
+                             auto inputIndex = model::EmitGetEntryOffset(function, inputLocation, inputMemoryLayout);
+                             auto outputIndex = model::EmitGetEntryOffset(function, indices, outputMemoryLayout);
+                             emitters::IRLocalScalar value = input[inputIndex];
+                             if (useNonTemporalStores)
+                             {
+                                 function.SetValueAtNonTemporal(output, outputIndex, value);
+                             }
+                             else
+                             {
+                                 output[outputIndex] = value;
+                             }
+                         };
+
+                         if (hasChannelPadding)
+                         {
+                             // The extra channels from rounding up to whole blocks keep the padding value
+                             function.If(~IsChannelPadding(indices), copyEntry);
+                         }
+                         else
+                         {
+                             copyEntry(function);
+                         }
                      });
     }
 
@@ -16,6 +16,7 @@
 #include <model/include/OutputNodeBase.h>
 
 #include <emitters/include/IRMetadata.h>
+#include <emitters/include/IRRingBuffer.h>
 
 #include <utilities/include/TypeTraits.h>
 
@@ -36,6 +37,14 @@ namespace nodes
     template <typename ValueType>
     using SinkFunction = std::function<void(const std::vector<ValueType>&)>;
 
+    /// <summary>
+    /// A node that delivers data to user code through a callback when its trigger is true.
+    ///
+    /// When the "useRingBufferTransport" option is set for the node, the compiled node pushes its triggered outputs into
+    /// a lock-free single-producer, single-consumer ring buffer instead of calling the callback. The buffer holds
+    /// "ringBufferCapacity" outputs (16 by default); outputs are dropped while it is full. The module exports
+    /// `bool <prefix>_<sinkFunctionName>_Pop(ValueType* data)`, which another thread calls to take the oldest output.
+    /// </summary>
     template <typename ValueType>
     class SinkNode : public model::SinkNodeBase
     {
@@ -92,6 +101,9 @@ namespace nodes
         /// <param name="function"> The sink function to set. </param>
         void SetSinkFunction(SinkFunction<ValueType> function) { _sink = function; }
 
+        /// <summary> Indicates if the node is pure. The node calls a user-provided callback, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -105,6 +117,7 @@ namespace nodes
     private:
         void Copy(model::ModelTransformer& transformer) const override;
 
+        void EmitCallback(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const std::string& prefixedName, emitters::LLVMValue pInput, emitters::LLVMValue triggerValue);
         void SetOutputValuesLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
         void SetOutputValuesExpanded(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
 
@@ -184,6 +197,35 @@ namespace nodes
         std::string prefixedName(compiler.GetNamespacePrefix() + "_" + GetCallbackName());
         auto& module = function.GetModule();
         auto triggerValue = function.ValueAt(pTrigger, 0);
+        const auto nodeOptions = compiler.GetModelOptimizerOptions(*this);
+        if (nodeOptions.template GetEntry<bool>("useRingBufferTransport", false))
+        {
+            emitters::IRRingBuffer ringBuffer(module, prefixedName + "_ringBuffer", emitters::GetVariableType<ValueType>(), static_cast<int>(input.Size()), nodeOptions.template GetEntry<int>("ringBufferCapacity", 16));
+            function.If(emitters::TypedComparison::equals, triggerValue, function.Literal(true), [pInput, &ringBuffer](emitters::IRFunctionEmitter& function) {
+                ringBuffer.Push(function, function.PointerOffset(pInput, function.Literal(0)));
+            });
+            ringBuffer.EmitPopFunction(prefixedName + "_Pop");
+        }
+        else
+        {
+            EmitCallback(compiler, function, prefixedName, pInput, triggerValue);
+        }
+
+        // Set output values as well, useful when user code is in a non-event-driven mode
+        if (!IsScalar(input) && !function.GetCompilerOptions().unrollLoops)
+        {
+            SetOutputValuesLoop(compiler, function);
+        }
+        else
+        {
+            SetOutputValuesExpanded(compiler, function);
+        }
+    }
+
+    template <typename ValueType>
+    void SinkNode<ValueType>::EmitCallback(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const std::string& prefixedName, emitters::LLVMValue pInput, emitters::LLVMValue triggerValue)
+    {
+        auto& module = function.GetModule();
         std::string name = this->GetFriendlyName();
         if (name.empty())
         {
@@ -206,16 +248,6 @@ namespace nodes
 
         // Tag the sink function as a callback that is emitted in headers
         module.IncludeInCallbackInterface(prefixedName, "SinkNode");
-
-        // Set output values as well, useful when user code is in a non-event-driven mode
-        if (!IsScalar(input) && !function.GetCompilerOptions().unrollLoops)
-        {
-            SetOutputValuesLoop(compiler, function);
-        }
-        else
-        {
-            SetOutputValuesExpanded(compiler, function);
-        }
     }
 
     template <typename ValueType>
@@ -27,6 +27,19 @@ namespace ell
 {
 namespace nodes
 {
+    /// <summary>
+    /// Emits code that computes the softmax of a contiguous array of values. The first pass finds the maximum, and
+    /// the second computes the exponentials, stores them and accumulates their sum in one sweep; a final sweep scales
+    /// them by the reciprocal of the sum. Each pass works in vectors when the compiler allows vector instructions.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="input"> Pointer to the first input value. </param>
+    /// <param name="output"> Pointer to the first output value. May be the same as `input`. </param>
+    /// <param name="size"> The number of values. </param>
+    template <typename ValueType>
+    void EmitSoftmax(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::LLVMValue output, int size);
+
     /// <summary> A node that wraps a neural net SoftmaxLayer. </summary>
     template <typename ValueType>
     class SoftmaxLayerNode : public NeuralNetworkLayerNode<SoftmaxLayerNode<ValueType>, predictors::neural::SoftmaxLayer<ValueType>, ValueType>
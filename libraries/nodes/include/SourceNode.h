@@ -12,6 +12,7 @@
 
 #include <emitters/include/IRMetadata.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRRingBuffer.h>
 #include <emitters/include/LLVMUtilities.h>
 
 #include <model/include/CompilableNode.h>
@@ -36,7 +37,15 @@ namespace nodes
     template <typename ValueType>
     using SourceFunction = std::function<bool(std::vector<ValueType>&)>;
 
-    /// <summary> A node that provides a source of data through a sampling function callback. </summary>
+    /// <summary>
+    /// A node that provides a source of data through a sampling function callback.
+    ///
+    /// When the "useRingBufferTransport" option is set for the node, the compiled node reads its samples from a
+    /// lock-free single-producer, single-consumer ring buffer instead of calling the callback. The buffer holds
+    /// "ringBufferCapacity" samples (16 by default), and the module exports `bool <prefix>_<sourceFunctionName>_Push(ValueType* sample)`,
+    /// which another thread (e.g., audio capture) calls to add a sample. Each call to predict takes the oldest sample, or
+    /// repeats the previous one if the buffer is empty.
+    /// </summary>
     template <typename ValueType>
     class SourceNode : public model::SourceNodeBase
     {
@@ -99,6 +108,9 @@ namespace nodes
         /// <param name="inputValues"> The values for this node to output </param>
         void SetInput(std::vector<ValueType> inputValues);
 
+        /// <summary> Indicates if the node is pure. The node gets its input from a user-provided callback, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -216,25 +228,36 @@ namespace nodes
         emitters::LLVMValue bufferedSampleTime = function.Load(pBufferedSampleTime);
         UNUSED(bufferedSampleTime);
 
-        // Callback function
-        const emitters::NamedVariableTypeList parameters = { { "context", emitters::VariableType::BytePointer },
-                                                             { name, emitters::GetPointerType(emitters::GetVariableType<ValueType>()) } };
         std::string prefixedName(compiler.GetNamespacePrefix() + "_" + GetCallbackName());
-        module.DeclareFunction(prefixedName, emitters::GetVariableType<bool>(), parameters);
-        module.IncludeInCallbackInterface(prefixedName, "SourceNode");
+        const auto nodeOptions = compiler.GetModelOptimizerOptions(*this);
+        if (nodeOptions.template GetEntry<bool>("useRingBufferTransport", false))
+        {
+            // Take the next sample from the ring buffer, if there is one, leaving the previous sample in place if not
+            emitters::IRRingBuffer ringBuffer(module, prefixedName + "_ringBuffer", emitters::GetVariableType<ValueType>(), static_cast<int>(output.Size()), nodeOptions.template GetEntry<int>("ringBufferCapacity", 16));
+            ringBuffer.Pop(function, function.PointerOffset(pBufferedSample, 0));
+            ringBuffer.EmitPushFunction(prefixedName + "_Push");
+        }
+        else
+        {
+            // Callback function
+            const emitters::NamedVariableTypeList parameters = { { "context", emitters::VariableType::BytePointer },
+                                                                 { name, emitters::GetPointerType(emitters::GetVariableType<ValueType>()) } };
+            module.DeclareFunction(prefixedName, emitters::GetVariableType<bool>(), parameters);
+            module.IncludeInCallbackInterface(prefixedName, "SourceNode");
+
+            emitters::LLVMFunction pSamplingFunction = module.GetFunction(prefixedName);
 
-        emitters::LLVMFunction pSamplingFunction = module.GetFunction(prefixedName);
+            // look up our global context object
+            auto context = module.GlobalPointer(compiler.GetNamespacePrefix() + "_context", emitters::VariableType::Byte);
+            auto globalContext = function.Load(context);
 
-        // look up our global context object
-        auto context = module.GlobalPointer(compiler.GetNamespacePrefix() + "_context", emitters::VariableType::Byte);
-        auto globalContext = function.Load(context);
+            // Invoke the callback and optionally interpolate.
+            function.Call(pSamplingFunction, { globalContext, function.PointerOffset(pBufferedSample, 0) });
+        }
 
         // Locals
         auto sampleTime = function.ValueAt(pInput, function.Literal(0));
 
-        // Invoke the callback and optionally interpolate.
-        function.Call(pSamplingFunction, { globalContext, function.PointerOffset(pBufferedSample, 0) });
-
         // TODO: Interpolate if there is a sample, and currentTime > sampleTime
         // Note: currentTime can be retrieved via currentTime = function.ValueAt(pInput, function.Literal(1));
 
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseLinearPredictorNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <predictors/include/LinearPredictor.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that represents a linear predictor whose input is sparse. Instead of the dense input vector, the node's
+    /// input is a list of (index, value) pairs, stored one after the other, so the prediction only reads the weights of the
+    /// nonzero entries. Pairs with an index outside of [0, predictor size) are ignored, so the unused entries of a list
+    /// with fewer than `GetMaxNonZeros()` pairs can be filled with an index of -1. The indices are stored as `ValueType`,
+    /// which represents every index exactly up to 2^24 for `float` and 2^53 for `double`.
+    /// </summary>
+    template <typename ValueType>
+    class SparseLinearPredictorNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        using LinearPredictorType = typename predictors::LinearPredictor<ValueType>;
+
+        /// <summary> Default Constructor </summary>
+        SparseLinearPredictorNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The (index, value) pairs of the signal's nonzero entries. Its size must be even. </param>
+        /// <param name="predictor"> The linear predictor to use when making the prediction. </param>
+        SparseLinearPredictorNode(const model::OutputPort<ValueType>& input, const LinearPredictorType& predictor);
+
+        /// <summary> Gets the most nonzero entries the input can hold. </summary>
+        size_t GetMaxNonZeros() const { return _input.Size() / 2; }
+
+        /// <summary> Gets the predictor's weights. </summary>
+        const std::vector<ValueType>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the predictor's bias. </summary>
+        ValueType GetBias() const { return _bias; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("SparseLinearPredictorNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: weights, bias
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void ValidateInputSize() const;
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        std::vector<ValueType> _weights;
+        ValueType _bias = 0;
+    };
+
+    /// <summary> Gets the input of a `SparseLinearPredictorNode` for a list of nonzero entries. </summary>
+    ///
+    /// <param name="entries"> The (index, value) pairs of the nonzero entries. </param>
+    /// <param name="maxNonZeros"> The most nonzero entries the node's input holds. </param>
+    ///
+    /// <returns> The input, with the unused pairs' indices set to -1. </returns>
+    template <typename ValueType>
+    std::vector<ValueType> GetSparseLinearPredictorInput(const std::vector<std::pair<int, ValueType>>& entries, size_t maxNonZeros);
+} // namespace nodes
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    std::vector<ValueType> GetSparseLinearPredictorInput(const std::vector<std::pair<int, ValueType>>& entries, size_t maxNonZeros)
+    {
+        if (entries.size() > maxNonZeros)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "GetSparseLinearPredictorInput: too many nonzero entries");
+        }
+
+        std::vector<ValueType> result(2 * maxNonZeros, 0);
+        for (size_t i = 0; i < maxNonZeros; ++i)
+        {
+            result[2 * i] = i < entries.size() ? static_cast<ValueType>(entries[i].first) : static_cast<ValueType>(-1);
+            result[2 * i + 1] = i < entries.size() ? entries[i].second : 0;
+        }
+        return result;
+    }
+} // namespace nodes
+} // namespace ell
+
+#pragma endregion implementation
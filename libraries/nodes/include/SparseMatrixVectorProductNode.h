@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseMatrixVectorProductNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortElements.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <math/include/Matrix.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> A matrix in compressed sparse row (CSR) format. Only the nonzero entries are stored. </summary>
+    template <typename ValueType>
+    struct SparseMatrix
+    {
+        size_t numRows = 0;
+        size_t numColumns = 0;
+        std::vector<int> rowOffsets; // `numRows` + 1 entries: the nonzeros of row i are at [rowOffsets[i], rowOffsets[i+1])
+        std::vector<int> columnIndices; // the column of each nonzero entry
+        std::vector<ValueType> values; // the value of each nonzero entry
+
+        /// <summary> Gets the fraction of the matrix's entries that are nonzero. </summary>
+        double GetDensity() const { return numRows * numColumns == 0 ? 0.0 : static_cast<double>(values.size()) / (numRows * numColumns); }
+    };
+
+    /// <summary> Converts a dense matrix to compressed sparse row format, dropping the entries that are exactly zero. </summary>
+    ///
+    /// <param name="matrix"> The matrix to convert. </param>
+    ///
+    /// <returns> The sparse matrix. </returns>
+    template <typename ValueType, math::MatrixLayout layout>
+    SparseMatrix<ValueType> GetSparseMatrix(math::ConstMatrixReference<ValueType, layout> matrix);
+
+    /// <summary>
+    /// A node that multiplies a sparse matrix, stored in compressed sparse row format, with a vector. Only the nonzero
+    /// entries of the matrix are stored and multiplied, so pruned layers use less memory and run faster than with the
+    /// dense `MatrixVectorProductNode`.
+    /// </summary>
+    template <typename ValueType>
+    class SparseMatrixVectorProductNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        SparseMatrixVectorProductNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The vector to multiply. </param>
+        /// <param name="weights"> The sparse matrix. </param>
+        SparseMatrixVectorProductNode(const model::OutputPort<ValueType>& input, const SparseMatrix<ValueType>& weights);
+
+        /// <summary> Gets the sparse matrix. </summary>
+        const SparseMatrix<ValueType>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("SparseMatrixVectorProductNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: weights
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void ValidateWeights() const;
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        SparseMatrix<ValueType> _weights;
+    };
+} // namespace nodes
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType, math::MatrixLayout layout>
+    SparseMatrix<ValueType> GetSparseMatrix(math::ConstMatrixReference<ValueType, layout> matrix)
+    {
+        SparseMatrix<ValueType> result;
+        result.numRows = matrix.NumRows();
+        result.numColumns = matrix.NumColumns();
+        result.rowOffsets.reserve(result.numRows + 1);
+        result.rowOffsets.push_back(0);
+        for (size_t i = 0; i < result.numRows; ++i)
+        {
+            for (size_t j = 0; j < result.numColumns; ++j)
+            {
+                auto value = matrix(i, j);
+                if (value != 0)
+                {
+                    result.columnIndices.push_back(static_cast<int>(j));
+                    result.values.push_back(value);
+                }
+            }
+            result.rowOffsets.push_back(static_cast<int>(result.values.size()));
+        }
+        return result;
+    }
+} // namespace nodes
+} // namespace ell
+
+#pragma endregion implementation
@@ -8,18 +8,14 @@
 
 #pragma once
 
-#include "BinaryOperationNode.h"
-#include "ConstantNode.h"
-#include "L2NormSquaredNode.h"
-#include "MatrixVectorProductNode.h"
-#include "SquaredEuclideanDistanceNode.h"
-#include "UnaryOperationNode.h"
+#include <emitters/include/IRSmallMatrixKernels.h>
 
 #include <utilities/include/Exception.h>
 
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/Model.h>
 #include <model/include/ModelTransformer.h>
-#include <model/include/Node.h>
 
 #include <math/include/Matrix.h>
 #include <math/include/MatrixOperations.h>
@@ -37,7 +33,7 @@ namespace nodes
     /// <typeparam name="layout"> The Matrix layout. </typeparam>
     ///
     template <typename ValueType, math::MatrixLayout layout>
-    class SquaredEuclideanDistanceNode : public model::Node
+    class SquaredEuclideanDistanceNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -66,17 +62,17 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
-        /// <summary> Refines this node in the model being constructed by the transformer </summary>
-        bool Refine(model::ModelTransformer& transformer) const override;
-
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; }
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
+        std::vector<ValueType> GetScaledVectors() const;
+        std::vector<ValueType> GetVectorNorms() const;
 
         // Inputs
         model::InputPort<ValueType> _input;
@@ -110,7 +106,7 @@ namespace nodes
 {
     template <typename ValueType, math::MatrixLayout layout>
     SquaredEuclideanDistanceNode<ValueType, layout>::SquaredEuclideanDistanceNode() :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, {}, defaultInputPortName),
         _output(this, defaultOutputPortName, 1),
         _vectorsAsMatrix(0, 0)
@@ -119,7 +115,7 @@ namespace nodes
 
     template <typename ValueType, math::MatrixLayout layout>
     SquaredEuclideanDistanceNode<ValueType, layout>::SquaredEuclideanDistanceNode(const model::OutputPort<ValueType>& input, const math::Matrix<ValueType, layout>& vectorsAsMatrix) :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, vectorsAsMatrix.NumRows()),
         _vectorsAsMatrix(vectorsAsMatrix)
@@ -158,48 +154,6 @@ namespace nodes
         transformer.MapNodeOutput(output, newNode->output);
     }
 
-    // We compute the distance (P - V)^2 as P^2 - 2 * P * V + V^2 where P is the input point and V is the set of vectors
-    template <typename ValueType, math::MatrixLayout layout>
-    bool SquaredEuclideanDistanceNode<ValueType, layout>::Refine(model::ModelTransformer& transformer) const
-    {
-        const auto& inputPortElements = transformer.GetCorrespondingInputs(_input);
-
-        // P^2 => scalar value
-        auto inputNorm2SquaredNode = transformer.AddNode<L2NormSquaredNode<double>>(inputPortElements);
-
-        // -2 * P * V => row-wise vector
-        auto vectorsAsMatrix = _vectorsAsMatrix;
-        vectorsAsMatrix.Transform([](double d) { return -2.0 * d; });
-        auto productNode = transformer.AddNode<MatrixVectorProductNode<double, math::MatrixLayout::rowMajor>>(inputPortElements, vectorsAsMatrix);
-
-        // Will hold the scalar value of P^2 for each row in the matrix
-        model::PortElements<ValueType> inputNorm2SquaredNodeOutputs;
-        // V^2 => row-wise vector of Norm-2 squared values of each vector in _vectorsAsMatrix
-        model::PortElements<ValueType> vectorNorm2SquaredConstantNodeOutputs;
-        for (size_t index = 0; index < _vectorsAsMatrix.NumRows(); ++index)
-        {
-            inputNorm2SquaredNodeOutputs.Append(inputNorm2SquaredNode->output);
-
-            auto matrixRow = _vectorsAsMatrix.GetRow(index);
-            const auto& rowNorm2Squared = AppendConstant(transformer, static_cast<ValueType>(matrixRow.Norm2Squared()));
-            vectorNorm2SquaredConstantNodeOutputs.Append(rowNorm2Squared);
-        }
-
-        // Add the three node outputs:
-        //   * inputNorm2SquaredNodeOutputs (A)
-        //   * vectorNorm2SquaredConstantNodeOutputs (B)
-        //   * productNode->output (C)
-        // and map it to output node
-        auto& A = transformer.SimplifyOutputs(inputNorm2SquaredNodeOutputs);
-        auto& B = transformer.SimplifyOutputs(vectorNorm2SquaredConstantNodeOutputs);
-        auto& C = productNode->output;
-        const auto& aPlusB = AppendBinaryOperation(A, B, BinaryOperationType::add);
-        const auto& aPlusBPlusC = AppendBinaryOperation(aPlusB, C, BinaryOperationType::add);
-        transformer.MapNodeOutput(output, aPlusBPlusC);
-
-        return true;
-    }
-
     template <typename ValueType, math::MatrixLayout layout>
     void SquaredEuclideanDistanceNode<ValueType, layout>::Compute() const
     {
@@ -224,6 +178,70 @@ namespace nodes
         _output.SetOutput(result.ToArray());
     }
 
+    // The vectors scaled by -2, in row-major order
+    template <typename ValueType, math::MatrixLayout layout>
+    std::vector<ValueType> SquaredEuclideanDistanceNode<ValueType, layout>::GetScaledVectors() const
+    {
+        std::vector<ValueType> result;
+        result.reserve(_vectorsAsMatrix.NumRows() * _vectorsAsMatrix.NumColumns());
+        for (size_t i = 0; i < _vectorsAsMatrix.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < _vectorsAsMatrix.NumColumns(); ++j)
+            {
+                result.push_back(static_cast<ValueType>(-2) * _vectorsAsMatrix(i, j));
+            }
+        }
+        return result;
+    }
+
+    template <typename ValueType, math::MatrixLayout layout>
+    std::vector<ValueType> SquaredEuclideanDistanceNode<ValueType, layout>::GetVectorNorms() const
+    {
+        std::vector<ValueType> result;
+        result.reserve(_vectorsAsMatrix.NumRows());
+        for (size_t i = 0; i < _vectorsAsMatrix.NumRows(); ++i)
+        {
+            result.push_back(static_cast<ValueType>(_vectorsAsMatrix.GetRow(i).Norm2Squared()));
+        }
+        return result;
+    }
+
+    // We compute the distance (P - V)^2 as P^2 - 2 * P * V + V^2 where P is the input point and V is the set of vectors.
+    // The -2 * V matrix and the V^2 row norms are constants, so this is one matrix-vector product and a dot product.
+    template <typename ValueType, math::MatrixLayout layout>
+    void SquaredEuclideanDistanceNode<ValueType, layout>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        static_assert(!std::is_same<ValueType, bool>(), "Cannot instantiate boolean SquaredEuclideanDistance nodes");
+
+        auto& module = function.GetModule();
+        const auto& compilerSettings = function.GetCompilerOptions();
+        const int m = static_cast<int>(_vectorsAsMatrix.NumRows());
+        const int n = static_cast<int>(_vectorsAsMatrix.NumColumns());
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        // output = -2 * V * P
+        auto scaledVectors = GetScaledVectors();
+        if (emitters::UseSmallMatrixKernel(compilerSettings, m * n) && !compilerSettings.externalWeights)
+        {
+            emitters::EmitSmallGEMV<ValueType>(function, m, n, scaledVectors, n, pInput, 1, pOutput, 1);
+        }
+        else
+        {
+            auto pVectors = module.ConstantArray(compiler.GetGlobalName(*this, "vectors"), scaledVectors);
+            function.CallGEMV<ValueType>(m, n, function.PointerOffset(pVectors, 0), n, pInput, 1, pOutput, 1);
+        }
+
+        // output += P^2 + V^2
+        auto inputNorm = function.LocalScalar(function.DotProduct(n, pInput, pInput));
+        auto vectorNorms = function.LocalArray(module.ConstantArray(compiler.GetGlobalName(*this, "vectorNorms"), GetVectorNorms()));
+        auto result = function.LocalArray(pOutput);
+        function.For(m, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar i) {
+            result[i] = static_cast<emitters::IRLocalScalar>(result[i]) + inputNorm + static_cast<emitters::IRLocalScalar>(vectorNorms[i]);
+        });
+    }
+
     template <typename ValueType, math::MatrixLayout layout>
     SquaredEuclideanDistanceNode<ValueType, layout>* AddNodeToModelTransformer(const model::PortElements<ValueType>& input, math::ConstMatrixReference<ValueType, layout> vectorsAsMatrix, model::ModelTransformer& transformer)
     {
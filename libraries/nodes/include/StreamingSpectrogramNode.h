@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StreamingSpectrogramNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <dsp/include/FFT.h>
+#include <dsp/include/FilterBank.h>
+
+#include <math/include/Matrix.h>
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that computes mel-frequency features from a stream of audio, one hop at a time. It fuses
+    /// `BufferNode` -> `HammingWindowNode` -> `FFTNode` -> `MelFilterBankNode` [-> `DCTNode`] and gives the same
+    /// outputs. Each input is one hop of new samples. The node keeps the last `windowSize` samples, applies the Hamming
+    /// window, zero-pads to `fftSize`, and outputs the filter bank energies, or their first `numDCTCoefficients` DCT
+    /// coefficients if that is nonzero.
+    ///
+    /// The compiled code stores the samples in a ring buffer that it writes twice, at `i` and `i + windowSize`, so the
+    /// current window is always contiguous and no samples are shifted. The window, FFT and filter tables are constants,
+    /// and the intermediate results are in stack buffers, so nothing is allocated per hop.
+    /// </summary>
+    template <typename ValueType>
+    class StreamingSpectrogramNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        StreamingSpectrogramNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The newest hop of samples. Its size must not be larger than the window size. </param>
+        /// <param name="windowSize"> The number of samples in a window. </param>
+        /// <param name="fftSize"> The FFT size, a power of 2 that is at least the window size. </param>
+        /// <param name="filters"> The mel filter bank to apply to the FFT magnitudes. </param>
+        /// <param name="numDCTCoefficients"> The number of DCT coefficients to output, or 0 to output the filter bank energies. </param>
+        StreamingSpectrogramNode(const model::OutputPort<ValueType>& input, size_t windowSize, size_t fftSize, const dsp::MelFilterBank& filters, size_t numDCTCoefficients = 0);
+
+        /// <summary> Gets the number of samples in a window. </summary>
+        size_t GetWindowSize() const { return _windowSize; }
+
+        /// <summary> Gets the FFT size. </summary>
+        size_t GetFFTSize() const { return _fftSize; }
+
+        /// <summary> Gets the mel filter bank. </summary>
+        const dsp::MelFilterBank& GetFilters() const { return _filters; }
+
+        /// <summary> Gets the number of DCT coefficients, or 0 if the node outputs the filter bank energies. </summary>
+        size_t GetNumDCTCoefficients() const { return _numDCTCoefficients; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("StreamingSpectrogramNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Reset the state of the node </summary>
+        void Reset() override;
+
+        /// <summary> Indicates if the node is pure. The node keeps previous samples, so it is not. </summary>
+        bool IsPure() const override { return false; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: windowSize, fftSize, filters, numDCTCoefficients
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Initialize();
+
+        // Inputs
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        size_t _windowSize = 0;
+        size_t _fftSize = 0;
+        dsp::MelFilterBank _filters;
+        size_t _numDCTCoefficients = 0;
+
+        // Derived from the parameters
+        std::vector<ValueType> _window;
+        dsp::FFTPlan<ValueType> _plan;
+        math::RowMatrix<ValueType> _dctCoeffs;
+
+        mutable std::vector<ValueType> _samples;
+    };
+} // namespace nodes
+} // namespace ell
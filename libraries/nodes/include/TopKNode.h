@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     TopKNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <emitters/include/IRMath.h>
+#include <emitters/include/IRVectorUtilities.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/TypeName.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that outputs the `k` largest values of its input in decreasing order, along with their indices. Equal
+    /// values are ordered by index. If the node is normalized, it outputs the softmax probabilities of the `k` largest
+    /// values instead of the values themselves, so a softmax followed by a top-k only has to write `k` probabilities.
+    /// </summary>
+    template <typename ValueType>
+    class TopKNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        static constexpr const char* inputPortName = "input";
+        static constexpr const char* valPortName = "val";
+        static constexpr const char* argValPortName = "argVal";
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& val = _val;
+        const model::OutputPort<int>& argVal = _argVal;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        TopKNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The node to get the input data from </param>
+        /// <param name="k"> The number of values to output. Must be no larger than the input size. </param>
+        /// <param name="normalize"> If `true`, output the softmax probabilities of the largest values </param>
+        TopKNode(const model::OutputPort<ValueType>& input, int k, bool normalize = false);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("TopKNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Gets the number of values this node outputs </summary>
+        ///
+        /// <returns> The number of values this node outputs </returns>
+        int GetK() const { return _k; }
+
+        /// <summary> Indicates if this node outputs softmax probabilities instead of input values </summary>
+        ///
+        /// <returns> `true` if this node outputs softmax probabilities </returns>
+        bool IsNormalized() const { return _normalize; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        bool HasState() const override { return true; } // stored state: k, normalize
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void VerifyParameters() const;
+        emitters::LLVMValue EmitExpSum(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, int size, emitters::IRLocalScalar maxValue) const;
+
+        // My inputs
+        model::InputPort<ValueType> _input;
+
+        // My outputs
+        model::OutputPort<ValueType> _val;
+        model::OutputPort<int> _argVal;
+
+        int _k = 1;
+        bool _normalize = false;
+    };
+} // namespace nodes
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    TopKNode<ValueType>::TopKNode() :
+        CompilableNode({ &_input }, { &_val, &_argVal }),
+        _input(this, {}, inputPortName),
+        _val(this, valPortName, 1),
+        _argVal(this, argValPortName, 1)
+    {
+    }
+
+    template <typename ValueType>
+    TopKNode<ValueType>::TopKNode(const model::OutputPort<ValueType>& input, int k, bool normalize) :
+        CompilableNode({ &_input }, { &_val, &_argVal }),
+        _input(this, input, inputPortName),
+        _val(this, valPortName, k),
+        _argVal(this, argValPortName, k),
+        _k(k),
+        _normalize(normalize)
+    {
+        VerifyParameters();
+    }
+
+    template <typename ValueType>
+    void TopKNode<ValueType>::VerifyParameters() const
+    {
+        if (_k < 1 || static_cast<size_t>(_k) > _input.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "TopKNode: k must be between 1 and the input size");
+        }
+
+        if (_normalize && !std::is_floating_point<ValueType>::value)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "TopKNode: only floating-point values can be normalized");
+        }
+    }
+
+    template <typename ValueType>
+    void TopKNode<ValueType>::Compute() const
+    {
+        auto inputValues = _input.GetValue();
+        std::vector<int> indices(inputValues.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        std::partial_sort(indices.begin(), indices.begin() + _k, indices.end(), [&inputValues](int a, int b) {
+            return inputValues[a] > inputValues[b] || (inputValues[a] == inputValues[b] && a < b);
+        });
+        indices.resize(_k);
+
+        std::vector<ValueType> values(_k);
+        std::transform(indices.begin(), indices.end(), values.begin(), [&inputValues](int index) { return inputValues[index]; });
+        if (_normalize)
+        {
+            auto maxValue = values[0];
+            double sum = 0;
+            for (auto x : inputValues)
+            {
+                sum += std::exp(x - maxValue);
+            }
+            std::transform(values.begin(), values.end(), values.begin(), [maxValue, sum](ValueType x) { return static_cast<ValueType>(std::exp(x - maxValue) / sum); });
+        }
+
+        _val.SetOutput(values);
+        _argVal.SetOutput(indices);
+    }
+
+    template <typename ValueType>
+    void TopKNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        auto input = function.LocalArray(compiler.EnsurePortEmitted(_input));
+        auto outVal = function.LocalArray(compiler.EnsurePortEmitted(_val));
+        auto outArgVal = function.LocalArray(compiler.EnsurePortEmitted(_argVal));
+        const int size = static_cast<int>(_input.Size());
+        const int k = _k;
+
+        // The best values seen so far are kept in decreasing order in a small array. Empty slots have index -1.
+        auto bestValues = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), k));
+        auto bestIndices = function.LocalArray(function.Variable(emitters::VariableType::Int32, k));
+        function.For(k, [bestValues, bestIndices](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar slot) {
+            bestValues[slot] = function.Literal(std::numeric_limits<ValueType>::lowest());
+            bestIndices[slot] = function.Literal(-1);
+        });
+
+        function.For(size, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar i) {
+            emitters::IRLocalScalar value = input[i];
+            auto isBetter = [=](auto slot) {
+                emitters::IRLocalScalar slotValue = bestValues[slot];
+                emitters::IRLocalScalar slotIndex = bestIndices[slot];
+                return (value > slotValue) || (slotIndex < 0);
+            };
+
+            // Most values don't beat the smallest kept value. The others are inserted by shifting the smaller
+            // values down one slot, reading each slot before it's overwritten.
+            function.If(isBetter(k - 1), [=](emitters::IRFunctionEmitter& function) {
+                function.For(k - 1, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar index) {
+                    auto slot = function.LocalScalar(k - 1) - index;
+                    auto previousSlot = slot - 1;
+                    auto shiftDown = isBetter(previousSlot);
+                    auto insertHere = isBetter(slot);
+                    emitters::IRLocalScalar previousValue = bestValues[previousSlot];
+                    emitters::IRLocalScalar previousIndex = bestIndices[previousSlot];
+                    emitters::IRLocalScalar slotValue = bestValues[slot];
+                    emitters::IRLocalScalar slotIndex = bestIndices[slot];
+                    bestValues[slot] = function.Select(shiftDown, previousValue, function.Select(insertHere, value, slotValue));
+                    bestIndices[slot] = function.Select(shiftDown, previousIndex, function.Select(insertHere, i, slotIndex));
+                });
+
+                auto insertFirst = isBetter(0);
+                emitters::IRLocalScalar firstValue = bestValues[0];
+                emitters::IRLocalScalar firstIndex = bestIndices[0];
+                bestValues[0] = function.Select(insertFirst, value, firstValue);
+                bestIndices[0] = function.Select(insertFirst, i, firstIndex);
+            });
+        });
+
+        if (!_normalize)
+        {
+            function.For(k, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar slot) {
+                outVal[slot] = bestValues[slot];
+                outArgVal[slot] = bestIndices[slot];
+            });
+            return;
+        }
+
+        // Only the kept values are normalized; the rest of the distribution only contributes to the sum
+        emitters::IRLocalScalar maxValue = bestValues[0];
+        auto scale = function.LocalScalar(function.Operator(emitters::GetDivideForValueType<ValueType>(), function.Literal<ValueType>(1), EmitExpSum(function, input, size, maxValue)));
+        function.For(k, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar slot) {
+            emitters::IRLocalScalar slotValue = bestValues[slot];
+            outVal[slot] = emitters::Exp(slotValue - maxValue) * scale;
+            outArgVal[slot] = bestIndices[slot];
+        });
+    }
+
+    template <typename ValueType>
+    emitters::LLVMValue TopKNode<ValueType>::EmitExpSum(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, int size, emitters::IRLocalScalar maxValue) const
+    {
+        const auto& compilerSettings = function.GetCompilerOptions();
+        const int vectorSize = compilerSettings.allowVectorInstructions ? compilerSettings.vectorWidth : 1;
+        const int numVectorBlocks = vectorSize > 1 ? size / vectorSize : 0;
+        const int firstScalarIndex = numVectorBlocks * vectorSize;
+        const auto valueType = emitters::GetVariableType<ValueType>();
+
+        auto sumVar = function.Variable(valueType, "topKExpSum");
+        function.StoreZero(sumVar);
+        if (numVectorBlocks > 0)
+        {
+            auto vectorType = function.GetEmitter().VectorType(valueType, vectorSize);
+            auto maxVector = emitters::BroadcastToVector<ValueType>(function, vectorSize, maxValue);
+            auto sumVectorVar = function.Variable(vectorType, "topKExpSumVector");
+            function.Store(sumVectorVar, emitters::FillVector<ValueType>(function, vectorType, 0));
+            function.For(numVectorBlocks, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar blockIndex) {
+                auto value = emitters::LoadVector<ValueType>(function, input, blockIndex * vectorSize, vectorSize);
+                auto eulerValue = emitters::Exp(function.LocalScalar(function.Operator(emitters::GetSubtractForValueType<ValueType>(), value, maxVector))).value;
+                function.Store(sumVectorVar, function.Operator(emitters::GetAddForValueType<ValueType>(), function.Load(sumVectorVar), eulerValue));
+            });
+            function.Store(sumVar, emitters::HorizontalVectorSum<ValueType>(function, function.Load(sumVectorVar)));
+        }
+        if (firstScalarIndex < size)
+        {
+            function.For(firstScalarIndex, size, 1, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue index) {
+                auto eulerValue = emitters::Exp(function.LocalScalar(function.ValueAt(input, index)) - maxValue);
+                function.Store(sumVar, eulerValue + function.Load(sumVar));
+            });
+        }
+        return function.Load(sumVar);
+    }
+
+    template <typename ValueType>
+    void TopKNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[inputPortName] << _input;
+        archiver["k"] << _k;
+        archiver["normalize"] << _normalize;
+    }
+
+    template <typename ValueType>
+    void TopKNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[inputPortName] >> _input;
+        archiver["k"] >> _k;
+        archiver["normalize"] >> _normalize;
+        _val.SetSize(_k);
+        _argVal.SetSize(_k);
+        VerifyParameters();
+    }
+
+    template <typename ValueType>
+    void TopKNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<TopKNode<ValueType>>(newPortElements, _k, _normalize);
+        transformer.MapNodeOutput(val, newNode->val);
+        transformer.MapNodeOutput(argVal, newNode->argVal);
+    }
+} // namespace nodes
+} // namespace ell
+
+#pragma endregion implementation
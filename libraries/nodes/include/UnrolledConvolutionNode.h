@@ -93,7 +93,7 @@ namespace nodes
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
         /// <summary> Indicates if this node is able to compile itself to code. </summary>
-        bool IsCompilable(const model::MapCompiler* compiler) const override { return _isDepthwiseSeparable; }
+        bool IsCompilable(const model::MapCompiler* compiler) const override { return _isDepthwiseSeparable || CanCompileImplicitGemm(compiler); }
 
     protected:
         bool Refine(model::ModelTransformer& transformer) const override;
@@ -108,6 +108,11 @@ namespace nodes
 
         MatrixType GetWeightsMatrix(const ConstTensorReferenceType& weightsTensor) const;
 
+        // Implicit GEMM: multiply the weights by the receptive fields of a few output pixels at a time, gathered into a small panel,
+        // instead of refining into a ReceptiveFieldMatrixNode that holds the receptive fields of the whole image
+        bool CanCompileImplicitGemm(const model::MapCompiler* compiler) const;
+        void CompileImplicitGemm(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
+
         // Input
         model::InputPort<ValueType> _input;
 
@@ -25,8 +25,10 @@ namespace ell
 namespace nodes
 {
     /// <summary>
-    /// A voice activity detection node that takes an mfcc vector input and produces an activity detected output signal.
-    /// The output signal is an integer value where 0 means no activity and 1 means activity detected.
+    /// A voice activity detection node that takes a power spectrum input and produces an activity detected output signal.
+    /// The output signal is an integer value where 0 means no activity and 1 means activity detected. An input of size 1
+    /// is the level of the frame (the mean of its spectrum weighted by the detector's weights), if the front end has
+    /// already computed it.
     /// </summary>
     class VoiceActivityDetectorNode : public model::CompilableCodeNode
     {
@@ -52,7 +54,7 @@ namespace nodes
         /// <param name="thresholdUp"> Then we compare the energy of the current frame to the noise floor. If it is thresholdUp times higher � we switch to state VOICE. </param>
         /// <param name="thresholdDown"> Then we compare the energy of the current frame to the noise floor. If it is thresholdDown times lower � we switch to state NO VOICE.  </param>
         /// <param name="levelThreshold"> Special case is when the energy of the frame is lower than levelThreshold, when we force the state to NO VOICE. </param>
-        /// <summary>
+        /// <param name="decimation"> Once the state hasn't changed for this many frames, only every decimation'th frame is processed, and the other frames output the current state. </param>
         VoiceActivityDetectorNode(
             const model::OutputPortBase& input,
             double sampleRate,
@@ -63,7 +65,8 @@ namespace nodes
             double gainAtt,
             double thresholdUp,
             double thresholdDown,
-            double levelThreshold);
+            double levelThreshold,
+            int decimation = 1);
 
         /// <summary> Gets the name of this type. </summary>
         ///
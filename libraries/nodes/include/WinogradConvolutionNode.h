@@ -54,11 +54,13 @@ namespace nodes
         /// <param name="filterWeights"> The weights for the convolutional filters. </param>
         /// <param name="outputMemoryLayout"> The layout of the output data. </param>
         /// <param name="stride"> The number of elements to move/jump when sliding over the input. Typically this is 1 to 3. </param>
+        /// <param name="tileSize"> The size of the output tiles. The filter order is chosen based on the number of filter channels. </param>
         WinogradConvolutionNode(const model::OutputPort<ValueType>& input,
                                 const model::PortMemoryLayout& inputMemoryLayout,
                                 const model::PortMemoryLayout& outputMemoryLayout,
                                 const ConstTensorReferenceType& filterWeights,
-                                int stride);
+                                int stride,
+                                int tileSize = 2);
 
         /// <summary> Constructor. </summary>
         ///
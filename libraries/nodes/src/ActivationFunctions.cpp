@@ -124,6 +124,11 @@ namespace nodes
     template <typename ValueType>
     emitters::IRLocalScalar SigmoidActivationFunction<ValueType>::Compile(emitters::IRLocalScalar x) const
     {
+        if (x.function.GetCompilerOptions().useApproximateMath)
+        {
+            return emitters::FastSigmoid(x);
+        }
+
         auto function = x.function;
         const auto zero = emitters::IRLocalScalar(function, function.Literal(ValueType{ 0.0 }));
         const auto one = emitters::IRLocalScalar(function, function.Literal(static_cast<ValueType>(1.0)));
@@ -11,6 +11,7 @@
 #include "BroadcastFunctionNode.h"
 #include "ActivationFunctions.h"
 #include "ConstantNode.h"
+#include "ReorderDataNode.h"
 
 #include <predictors/neural/include/LeakyReLUActivation.h>
 #include <predictors/neural/include/ParametricReLUActivation.h>
@@ -53,29 +54,46 @@ namespace nodes
         auto tanh = dynamic_cast<predictors::neural::TanhActivation<ValueType>*>(ptr);
         auto prelu = dynamic_cast<predictors::neural::ParametricReLUActivation<ValueType>*>(ptr);
 
+        const auto originalOutputLayout = this->GetOutputMemoryLayout();
         auto inputLayout = this->GetInputMemoryLayout();
-        auto outputLayout = this->GetOutputMemoryLayout();
+        auto outputLayout = originalOutputLayout;
+        const auto* activationInput = &newInput;
+
+        // If the input was just unblocked from a channel-blocked layout, apply the activation to the blocked data instead
+        // and unblock the result. Between blocked layers, OptimizeReorderDataNodesTransformation then removes the reorders.
+        auto unblockNode = dynamic_cast<const ReorderDataNode<ValueType>*>(newInput.GetNode());
+        const bool isBlocked = unblockNode != nullptr && model::IsChannelBlockedLayout(unblockNode->GetInputMemoryLayout()) && ReorderDataNodeDetail::ConvertsChannelBlocks(unblockNode->GetInputMemoryLayout(), unblockNode->GetOutputMemoryLayout()) &&
+                               inputLayout.IsCanonicalOrder() && inputLayout.GetExtent(2) == inputLayout.GetActiveSize(2) && outputLayout.IsCanonicalOrder() && outputLayout.GetExtent(2) == outputLayout.GetActiveSize(2);
+        if (isBlocked)
+        {
+            const auto channelBlockSize = unblockNode->GetInputMemoryLayout().GetLogicalDimensionActiveSize(3);
+            auto blockedInputLayout = model::GetChannelBlockedLayout(inputLayout, channelBlockSize);
+            auto blockNode = transformer.AddNode<ReorderDataNode<ValueType>>(newInput, inputLayout, blockedInputLayout);
+            activationInput = &blockNode->output;
+            inputLayout = blockedInputLayout;
+            outputLayout = model::GetChannelBlockedLayout(outputLayout, channelBlockSize);
+        }
 
         ell::model::Node* computeNode = nullptr;
         if (hardSigmoid)
         {
-            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, HardSigmoidActivationFunction<ValueType>>>(newInput, inputLayout, outputLayout, HardSigmoidActivationFunction<ValueType>{});
+            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, HardSigmoidActivationFunction<ValueType>>>(*activationInput, inputLayout, outputLayout, HardSigmoidActivationFunction<ValueType>{});
         }
         else if (leakyReLU)
         {
-            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, LeakyReLUActivationFunction<ValueType>>>(newInput, inputLayout, outputLayout, LeakyReLUActivationFunction<ValueType>(leakyReLU->GetLeakyFactor()));
+            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, LeakyReLUActivationFunction<ValueType>>>(*activationInput, inputLayout, outputLayout, LeakyReLUActivationFunction<ValueType>(leakyReLU->GetLeakyFactor()));
         }
         else if (sigmoid)
         {
-            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, SigmoidActivationFunction<ValueType>>>(newInput, inputLayout, outputLayout, SigmoidActivationFunction<ValueType>{});
+            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, SigmoidActivationFunction<ValueType>>>(*activationInput, inputLayout, outputLayout, SigmoidActivationFunction<ValueType>{});
         }
         else if (relu)
         {
-            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, ReLUActivationFunction<ValueType>>>(newInput, inputLayout, outputLayout, ReLUActivationFunction<ValueType>{});
+            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, ReLUActivationFunction<ValueType>>>(*activationInput, inputLayout, outputLayout, ReLUActivationFunction<ValueType>{});
         }
         else if (tanh)
         {
-            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, TanhActivationFunction<ValueType>>>(newInput, inputLayout, outputLayout, TanhActivationFunction<ValueType>{});
+            computeNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, TanhActivationFunction<ValueType>>>(*activationInput, inputLayout, outputLayout, TanhActivationFunction<ValueType>{});
         }
         else if (prelu)
         {
@@ -86,6 +104,14 @@ namespace nodes
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "ActivationLayerNode given a new Activation type it doesn't recognize");
         }
 
+        if (isBlocked)
+        {
+            const auto& computeOutput = static_cast<const model::OutputPort<ValueType>&>(*computeNode->GetOutputPort(0));
+            auto unblockOutputNode = transformer.AddNode<ReorderDataNode<ValueType>>(computeOutput, outputLayout, originalOutputLayout);
+            transformer.MapNodeOutput(this->output, unblockOutputNode->output);
+            return true;
+        }
+
         transformer.MapNodeOutput(this->output, *(computeNode->GetOutputPort(0)));
         return true;
     }
@@ -12,15 +12,18 @@
 
 #include <emitters/include/IRAsyncTask.h>
 #include <emitters/include/IREmitter.h>
+#include <emitters/include/IRMetadata.h>
 #include <emitters/include/IRThreadPool.h>
 #include <emitters/include/IRVectorUtilities.h>
 #include <emitters/include/LLVMUtilities.h>
 
 #include <emitters/include/IRHeaderWriter.h>
 
+#include <utilities/include/StringUtil.h>
 #include <utilities/include/Unused.h>
 
 #include <algorithm>
+#include <functional>
 #include <numeric>
 
 namespace ell
@@ -36,12 +39,32 @@ namespace nodes
         // Functions
         //
 
+        // The number of filters (output channels) the XNOR kernel computes at once
+        const int defaultFilterBlockSize = 4;
+
         // computes ceil(a/b)
         int CeilDiv(int a, int b)
         {
             return (a - 1) / b + 1;
         }
 
+        // Emits a loop over the filters in [begin, end) in blocks of `filterBlockSize` filters, followed by a loop over the leftover filters
+        void EmitFilterBlockLoop(emitters::IRFunctionEmitter& function, emitters::LLVMValue begin, emitters::LLVMValue end, int filterBlockSize, std::function<void(emitters::IRFunctionEmitter&, emitters::LLVMValue, int)> body)
+        {
+            auto blockBegin = function.LocalScalar(begin);
+            auto numFilters = function.LocalScalar(end) - blockBegin;
+            auto blockEnd = blockBegin + (numFilters / filterBlockSize) * filterBlockSize;
+            if (filterBlockSize > 1)
+            {
+                function.For(blockBegin, blockEnd, function.Literal<int>(filterBlockSize), [body, filterBlockSize](emitters::IRFunctionEmitter& function, emitters::LLVMValue filterIndex) {
+                    body(function, filterIndex, filterBlockSize);
+                });
+            }
+            function.For(blockEnd, end, function.Literal<int>(1), [body](emitters::IRFunctionEmitter& function, emitters::LLVMValue filterIndex) {
+                body(function, filterIndex, 1);
+            });
+        }
+
         size_t GetFilterVolumeSize(const predictors::neural::BinaryConvolutionalParameters& convolutionalParameters, const model::PortMemoryLayout& inputMemoryLayout)
         {
             const auto inputDepth = inputMemoryLayout.GetActiveSize(2);
@@ -524,33 +547,43 @@ namespace nodes
     void BinaryXnorNode<ValueType, PackedBitsType>::EmitInnerLoop(emitters::IRFunctionEmitter& function,
                                                                   emitters::LLVMValue reshapedInputPtr,
                                                                   emitters::LLVMValue paddingMaskPtr,
-                                                                  emitters::LLVMValue weightsPtr,
-                                                                  emitters::LLVMValue xorSumVariable,
+                                                                  const std::vector<emitters::LLVMValue>& weightsPtrs,
+                                                                  const std::vector<emitters::LLVMValue>& xorSumVariables,
                                                                   emitters::LLVMFunction popCountFunction,
                                                                   int startBlock,
                                                                   int numBlocks,
                                                                   bool hasZeroPadding)
     {
+        assert(weightsPtrs.size() == xorSumVariables.size());
         auto reshapedInput = function.LocalArray(reshapedInputPtr);
         auto paddingMask = function.LocalArray(paddingMaskPtr);
-        auto weights = function.LocalArray(weightsPtr);
-        function.For(startBlock, startBlock + numBlocks, [reshapedInput, paddingMask, weights, xorSumVariable, popCountFunction, hasZeroPadding](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+        std::vector<emitters::IRLocalArray> weights;
+        for (auto weightsPtr : weightsPtrs)
+        {
+            weights.push_back(function.LocalArray(weightsPtr));
+        }
+
+        function.For(startBlock, startBlock + numBlocks, [reshapedInput, paddingMask, weights, xorSumVariables, popCountFunction, hasZeroPadding](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
             auto blockIndex = function.LocalScalar(i);
 
+            // Load the input (and padding mask) once, and use it for each of the filters in the block
             auto inputVal = reshapedInput[blockIndex];
-            auto filterVal = weights[blockIndex];
-            auto xorVal = inputVal ^ filterVal;
-
-            if (hasZeroPadding)
+            auto paddingMaskVal = hasZeroPadding ? paddingMask[blockIndex] : function.LocalScalar();
+            for (size_t filter = 0; filter < weights.size(); ++filter)
             {
-                // Mask out the bits associated with zero padding from the XOR value
-                auto paddingMaskVal = paddingMask[blockIndex];
-                xorVal = paddingMaskVal & xorVal;
-            }
+                auto filterVal = weights[filter][blockIndex];
+                auto xorVal = inputVal ^ filterVal;
+
+                if (hasZeroPadding)
+                {
+                    // Mask out the bits associated with zero padding from the XOR value
+                    xorVal = paddingMaskVal & xorVal;
+                }
 
-            auto xorCount = function.Call(popCountFunction, { xorVal });
-            const auto plus = emitters::TypedOperator::add;
-            function.OperationAndUpdate(xorSumVariable, plus, xorCount);
+                auto xorCount = function.Call(popCountFunction, { xorVal });
+                const auto plus = emitters::TypedOperator::add;
+                function.OperationAndUpdate(xorSumVariables[filter], plus, xorCount);
+            }
         });
     }
 
@@ -610,12 +643,16 @@ namespace nodes
             useVectorInstructions = false;
         }
 
+        // Each pass over the input computes a block of filters, so the input is loaded once per block instead of once per filter
+        const int filterBlockSize = std::max(1, std::min(compiler.GetModelOptimizerOptions(*this).template GetEntry<int>("binaryConvolutionFilterBlockSize", defaultFilterBlockSize), static_cast<int>(numFilters)));
+
+        // Split the filters among the tasks in whole blocks
         const int numDesiredTasks = compilerSettings.maxThreads;
-        const int taskSize = CeilDiv(numFilters, numDesiredTasks);
+        const int taskSize = CeilDiv(CeilDiv(numFilters, numDesiredTasks), filterBlockSize) * filterBlockSize;
         const int numTasks = CeilDiv(numFilters, taskSize);
         if (compilerSettings.parallelize && numTasks > 1)
         {
-            auto taskFunction = GetTaskFunction(compiler, function);
+            auto taskFunction = GetTaskFunction(compiler, function, filterBlockSize);
             std::vector<std::vector<emitters::LLVMValue>> taskArgs;
             for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
             {
@@ -629,8 +666,7 @@ namespace nodes
         }
         else // single-threaded
         {
-            function.For(numFilters, [=, &compiler](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
-                auto filterIndex = function.LocalScalar(i);
+            EmitFilterBlockLoop(function, function.Literal<int>(0), function.Literal<int>(numFilters), filterBlockSize, [=, &compiler](emitters::IRFunctionEmitter& function, emitters::LLVMValue filterIndex, int numFiltersInBlock) {
                 ComputeFilterOutput(compiler,
                                     function,
                                     pInput,
@@ -640,6 +676,7 @@ namespace nodes
                                     pInputPaddingMaskSums,
                                     pOutput,
                                     filterIndex,
+                                    numFiltersInBlock,
                                     hasZeroPadding,
                                     outputColumns,
                                     packedRowSize,
@@ -652,7 +689,7 @@ namespace nodes
     }
 
     template <typename ValueType, typename PackedBitsType>
-    emitters::IRFunctionEmitter BinaryXnorNode<ValueType, PackedBitsType>::GetTaskFunction(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    emitters::IRFunctionEmitter BinaryXnorNode<ValueType, PackedBitsType>::GetTaskFunction(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int filterBlockSize)
     {
         // Get port variables
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
@@ -728,7 +765,7 @@ namespace nodes
             auto blockStartVal = &(*arguments++);
             auto blockEndVal = &(*arguments++);
 
-            taskFunction.For(blockStartVal, blockEndVal, taskFunction.Literal<int>(1), [pInput, pFilterWeights, pFilterMeans, pInputPaddingMask, pInputPaddingMaskSums, pOutput, hasZeroPadding, outputColumns, packedRowSize, packedRowStride, useVectorInstructions, vectorSize, numVectorBlocks, &compiler, this](emitters::IRFunctionEmitter& taskFunction, emitters::LLVMValue filterIndex) {
+            EmitFilterBlockLoop(taskFunction, blockStartVal, blockEndVal, filterBlockSize, [pInput, pFilterWeights, pFilterMeans, pInputPaddingMask, pInputPaddingMaskSums, pOutput, hasZeroPadding, outputColumns, packedRowSize, packedRowStride, useVectorInstructions, vectorSize, numVectorBlocks, &compiler, this](emitters::IRFunctionEmitter& taskFunction, emitters::LLVMValue filterIndex, int numFiltersInBlock) {
                 ComputeFilterOutput(compiler,
                                     taskFunction,
                                     pInput,
@@ -738,6 +775,7 @@ namespace nodes
                                     pInputPaddingMaskSums,
                                     pOutput,
                                     filterIndex,
+                                    numFiltersInBlock,
                                     hasZeroPadding,
                                     outputColumns,
                                     packedRowSize,
@@ -750,6 +788,12 @@ namespace nodes
             taskFunction.Return();
         }
         function.GetModule().EndFunction();
+
+        // The task function does the work, so it needs the same CPU-specific variants as the node function
+        if (!compilerSettings.functionVariants.empty())
+        {
+            function.GetModule().InsertFunctionMetadata(taskFunction.GetFunctionName(), emitters::c_functionVariantsTagName, utilities::Split(compilerSettings.functionVariants, ','));
+        }
         return taskFunction;
     }
 
@@ -763,6 +807,7 @@ namespace nodes
                                                                         emitters::LLVMValue pInputPaddingMaskSums,
                                                                         emitters::LLVMValue pOutput,
                                                                         emitters::LLVMValue filterIndexPtr,
+                                                                        int numFilters,
                                                                         bool hasZeroPadding,
                                                                         int outputColumns,
                                                                         int packedRowSize,
@@ -787,7 +832,7 @@ namespace nodes
 
         const auto partialBlockSize = fieldVolumeSize % numBits;
 
-        auto filterIndex = function.LocalScalar(filterIndexPtr);
+        auto firstFilterIndex = function.LocalScalar(filterIndexPtr);
 
         // Get LLVM types
         auto& emitter = function.GetEmitter();
@@ -796,25 +841,45 @@ namespace nodes
         auto vectorType = emitter.VectorType(packedBitsType, vectorSize);
         auto vectorPointerType = vectorType->getPointerTo();
 
+        // LLVM lowers the vector popcount to the target's instructions: e.g., `vcnt` followed by pairwise adds on NEON,
+        // and `vpopcntq` on x86 CPUs with AVX-512 VPOPCNTDQ (see the "avx512popcnt" function variant)
         emitters::LLVMFunction popcountFunction = function.GetModule().GetIntrinsic(llvm::Intrinsic::ctpop, { packedBitsType });
         emitters::LLVMFunction vecPopcountFunction = function.GetModule().GetIntrinsic(llvm::Intrinsic::ctpop, { vectorType });
 
-        // The start of the binarized weights matrix for this filter
-        auto weightsBegin = filterIndex * packedRowStride;
-        auto weightsBeginPtr = function.PointerOffset(pFilterWeights, weightsBegin);
-        auto weightsVector = function.CastPointer(weightsBeginPtr, vectorPointerType);
+        const int numScalarBlocks = packedRowSize - (vectorSize * numVectorBlocks);
 
-        emitters::LLVMValue filterMean = nullptr;
-        if (_convolutionalParameters.weightsScale == scaleOutputByFilterMeans)
+        std::vector<emitters::IRLocalScalar> filterIndices;
+        std::vector<emitters::LLVMValue> weightsBeginPtrs;
+        std::vector<emitters::LLVMValue> weightsVectors;
+        std::vector<emitters::LLVMValue> filterMeans;
+        std::vector<emitters::LLVMValue> vectorSumVars;
+        std::vector<emitters::LLVMValue> sumVars;
+        for (int filter = 0; filter < numFilters; ++filter)
         {
-            filterMean = function.ValueAt(pFilterMeans, filterIndex);
-        }
+            auto filterIndex = firstFilterIndex + filter;
+            filterIndices.push_back(filterIndex);
 
-        const int numScalarBlocks = packedRowSize - (vectorSize * numVectorBlocks);
+            // The start of the binarized weights matrix for this filter
+            auto weightsBegin = filterIndex * packedRowStride;
+            auto weightsBeginPtr = function.PointerOffset(pFilterWeights, weightsBegin);
+            weightsBeginPtrs.push_back(weightsBeginPtr);
+            weightsVectors.push_back(function.CastPointer(weightsBeginPtr, vectorPointerType));
 
-        // Variables to hold the running sum of xor values
-        emitters::LLVMValue vectorSumVar = useVectorInstructions ? function.Variable(vectorType, "vecXorSum") : nullptr;
-        emitters::LLVMValue sumVar = numScalarBlocks > 0 ? function.Variable(packedBitsType, "xorSum") : nullptr;
+            if (_convolutionalParameters.weightsScale == scaleOutputByFilterMeans)
+            {
+                filterMeans.push_back(function.ValueAt(pFilterMeans, filterIndex));
+            }
+
+            // Variables to hold the running sum of xor values
+            if (useVectorInstructions)
+            {
+                vectorSumVars.push_back(function.Variable(vectorType, "vecXorSum"));
+            }
+            if (numScalarBlocks > 0)
+            {
+                sumVars.push_back(function.Variable(packedBitsType, "xorSum"));
+            }
+        }
 
         // Compute and accumulate xnor counts
 
@@ -828,73 +893,84 @@ namespace nodes
             auto inputBeginPtr = function.PointerOffset(pInput, inputBegin);
             auto paddingMaskBeginPtr = function.PointerOffset(pInputPaddingMask, paddingBegin);
 
-            auto vectorXorSum = function.LocalScalar();
+            std::vector<emitters::IRLocalScalar> vectorXorSums(numFilters, function.LocalScalar());
             if (numVectorBlocks > 0)
             {
-                assert(vectorSumVar != nullptr);
+                assert(vectorSumVars.size() == static_cast<size_t>(numFilters));
 
                 // cast to vector pointer
                 auto inputVector = function.CastPointer(inputBeginPtr, vectorPointerType);
                 auto paddingMaskVector = function.CastPointer(paddingMaskBeginPtr, vectorPointerType);
 
-                // If vector instructions are enabled, create a variable to store the running vector sum
-                function.Store(vectorSumVar, emitters::FillVector<PackedBitsType>(function, vectorType, 0));
-                EmitInnerLoop(function, inputVector, paddingMaskVector, weightsVector, vectorSumVar, vecPopcountFunction, 0, numVectorBlocks, hasZeroPadding);
+                // If vector instructions are enabled, use a variable to store the running vector sum of each filter
+                for (auto vectorSumVar : vectorSumVars)
+                {
+                    function.Store(vectorSumVar, emitters::FillVector<PackedBitsType>(function, vectorType, 0));
+                }
+                EmitInnerLoop(function, inputVector, paddingMaskVector, weightsVectors, vectorSumVars, vecPopcountFunction, 0, numVectorBlocks, hasZeroPadding);
 
                 // Accumulate horizontal sum into output
-                vectorXorSum = emitters::HorizontalVectorSum<PackedBitsType>(function, function.Load(vectorSumVar));
-                assert(vectorXorSum.value->getType() == packedBitsType);
+                for (int filter = 0; filter < numFilters; ++filter)
+                {
+                    vectorXorSums[filter] = emitters::HorizontalVectorSum<PackedBitsType>(function, function.Load(vectorSumVars[filter]));
+                    assert(vectorXorSums[filter].value->getType() == packedBitsType);
+                }
             }
 
             // Now compute the non-vectorized values
-            const int numScalarBlocks = packedRowSize - (vectorSize * numVectorBlocks);
             if (numScalarBlocks > 0)
             {
-                assert(sumVar != nullptr);
-                function.StoreZero(sumVar);
+                assert(sumVars.size() == static_cast<size_t>(numFilters));
+                for (auto sumVar : sumVars)
+                {
+                    function.StoreZero(sumVar);
+                }
                 auto start = vectorSize * numVectorBlocks;
-                EmitInnerLoop(function, inputBeginPtr, paddingMaskBeginPtr, weightsBeginPtr, sumVar, popcountFunction, start, numScalarBlocks, hasZeroPadding);
+                EmitInnerLoop(function, inputBeginPtr, paddingMaskBeginPtr, weightsBeginPtrs, sumVars, popcountFunction, start, numScalarBlocks, hasZeroPadding);
             }
 
-            emitters::LLVMValue xorSum = (sumVar == nullptr) ? nullptr : function.Load(sumVar);
-            if (vectorXorSum.value != nullptr)
+            emitters::LLVMValue paddingSum = hasZeroPadding ? function.ValueAt(pInputPaddingMaskSums, outputColumnIndex) : nullptr;
+            for (int filter = 0; filter < numFilters; ++filter)
             {
-                xorSum = (xorSum == nullptr) ? vectorXorSum : xorSum + vectorXorSum;
-            }
-            assert(xorSum != nullptr);
+                emitters::LLVMValue xorSum = sumVars.empty() ? nullptr : function.Load(sumVars[filter]);
+                if (vectorXorSums[filter].value != nullptr)
+                {
+                    xorSum = (xorSum == nullptr) ? vectorXorSums[filter] : xorSum + vectorXorSums[filter];
+                }
+                assert(xorSum != nullptr);
 
-            // Output scaling
-            auto sumInt = function.CastValue<int>(xorSum);
-            auto scaledSum = (function.LocalScalar<int>(-2) * sumInt) + (numBits * packedRowSize);
+                // Output scaling
+                auto sumInt = function.CastValue<int>(xorSum);
+                auto scaledSum = (function.LocalScalar<int>(-2) * sumInt) + (numBits * packedRowSize);
 
-            auto scaledSumWithPadding = scaledSum;
-            if (hasZeroPadding)
-            {
-                // Add back the zero padding, if any (since the scaled sum is made negative, use the minus operation)
-                emitters::LLVMValue paddingSum = function.ValueAt(pInputPaddingMaskSums, outputColumnIndex);
-                scaledSumWithPadding = scaledSum - paddingSum;
-            }
-            auto sumFloat = function.CastValue<ValueType>(scaledSumWithPadding);
+                auto scaledSumWithPadding = scaledSum;
+                if (hasZeroPadding)
+                {
+                    // Add back the zero padding, if any (since the scaled sum is made negative, use the minus operation)
+                    scaledSumWithPadding = scaledSum - paddingSum;
+                }
+                auto sumFloat = function.CastValue<ValueType>(scaledSumWithPadding);
 
-            auto adjustedSum = function.LocalScalar(sumFloat);
-            if (partialBlockSize != 0)
-            {
-                const auto filterAdjust = numBits - partialBlockSize;
-                adjustedSum = sumFloat - function.LocalScalar<ValueType>(filterAdjust);
-            }
+                auto adjustedSum = function.LocalScalar(sumFloat);
+                if (partialBlockSize != 0)
+                {
+                    const auto filterAdjust = numBits - partialBlockSize;
+                    adjustedSum = sumFloat - function.LocalScalar<ValueType>(filterAdjust);
+                }
 
-            auto outIndex = (filterIndex * outputColumns) + outputColumnIndex;
-            if (_convolutionalParameters.weightsScale == scaleOutputByFilterMeans)
-            {
-                // Scale output by the filters mean
-                assert(filterMean != nullptr);
-                auto scaledOutput = adjustedSum * filterMean;
-                function.SetValueAt(pOutput, outIndex, scaledOutput);
-            }
-            else
-            {
-                // No output scaling
-                function.SetValueAt(pOutput, outIndex, adjustedSum);
+                auto outIndex = (filterIndices[filter] * outputColumns) + outputColumnIndex;
+                if (_convolutionalParameters.weightsScale == scaleOutputByFilterMeans)
+                {
+                    // Scale output by the filters mean
+                    assert(filterMeans.size() == static_cast<size_t>(numFilters));
+                    auto scaledOutput = adjustedSum * filterMeans[filter];
+                    function.SetValueAt(pOutput, outIndex, scaledOutput);
+                }
+                else
+                {
+                    // No output scaling
+                    function.SetValueAt(pOutput, outIndex, adjustedSum);
+                }
             }
         });
     }
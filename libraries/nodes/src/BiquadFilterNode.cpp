@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BiquadFilterNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BiquadFilterNode.h"
+
+#include <emitters/include/EmitterTypes.h>
+#include <emitters/include/IRLocalScalar.h>
+
+#include <utilities/include/Exception.h>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    BiquadFilterNode<ValueType>::BiquadFilterNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    BiquadFilterNode<ValueType>::BiquadFilterNode(const model::OutputPort<ValueType>& input, const std::vector<dsp::BiquadCoefficients<ValueType>>& sections, size_t numChannels) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, _input.Size()),
+        _filter(sections, numChannels)
+    {
+        ValidateParameters();
+    }
+
+    template <typename ValueType>
+    void BiquadFilterNode<ValueType>::ValidateParameters() const
+    {
+        if (NumChannels() == 0 || _input.Size() % NumChannels() != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "BiquadFilterNode: input must be a whole number of frames");
+        }
+    }
+
+    template <typename ValueType>
+    void BiquadFilterNode<ValueType>::Compute() const
+    {
+        _output.SetOutput(_filter.FilterSamples(_input.GetValue()));
+    }
+
+    template <typename ValueType>
+    void BiquadFilterNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<BiquadFilterNode<ValueType>>(newPortElements, GetSections(), NumChannels());
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void BiquadFilterNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        // For each section, the two state values of each channel, as in dsp::BiquadFilter
+        const int numChannels = static_cast<int>(NumChannels());
+        auto& module = function.GetModule();
+        llvm::GlobalVariable* stateArray = module.GlobalArray("biquadState_"s + GetInternalStateIdentifier(), std::vector<ValueType>(2 * GetSections().size() * NumChannels(), 0));
+        emitters::LLVMValue state = function.PointerOffset(stateArray, 0);
+
+        // Filter the channels in blocks of the vector width, and the leftover channels one at a time
+        const auto& compilerSettings = function.GetCompilerOptions();
+        const int vectorSize = compilerSettings.allowVectorInstructions ? compilerSettings.vectorWidth : 1;
+        const int numVectorBlocks = vectorSize > 1 ? numChannels / vectorSize : 0;
+        const int firstScalarChannel = numVectorBlocks * vectorSize;
+        if (numVectorBlocks > 0)
+        {
+            function.For(numVectorBlocks, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockIndex) {
+                EmitChannelBlock(function, pInput, pOutput, state, function.LocalScalar(blockIndex) * vectorSize, vectorSize);
+            });
+        }
+        if (firstScalarChannel < numChannels)
+        {
+            function.For(firstScalarChannel, numChannels, 1, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue channel) {
+                EmitChannelBlock(function, pInput, pOutput, state, channel, 1);
+            });
+        }
+    }
+
+    template <typename ValueType>
+    void BiquadFilterNode<ValueType>::EmitChannelBlock(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::LLVMValue output, emitters::LLVMValue state, emitters::LLVMValue channelValue, int blockSize) const
+    {
+        using emitters::IRLocalScalar;
+
+        const auto& sections = GetSections();
+        const int numSections = static_cast<int>(sections.size());
+        const int numChannels = static_cast<int>(NumChannels());
+        const int numFrames = static_cast<int>(_input.Size()) / numChannels;
+        const auto channel = function.LocalScalar(channelValue);
+
+        // The values are loaded and stored as vectors of `blockSize` channels, or as scalars if `blockSize` is 1. The
+        // frames aren't necessarily aligned to the vector size, so vectors use the element alignment.
+        const auto valueType = emitters::GetVariableType<ValueType>();
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+        const bool isVector = blockSize > 1;
+        auto blockType = isVector ? function.GetEmitter().VectorType(valueType, blockSize) : function.GetEmitter().Type(valueType);
+        auto blockPointerType = blockType->getPointerTo();
+        const unsigned alignment = sizeof(ValueType);
+        auto load = [=, &irBuilder](emitters::IRFunctionEmitter& function, emitters::LLVMValue pointer, IRLocalScalar offset) -> emitters::LLVMValue {
+            if (!isVector)
+            {
+                return function.ValueAt(pointer, offset);
+            }
+            return irBuilder.CreateAlignedLoad(function.CastPointer(function.PointerOffset(pointer, offset), blockPointerType), alignment);
+        };
+        auto store = [=, &irBuilder](emitters::IRFunctionEmitter& function, emitters::LLVMValue pointer, IRLocalScalar offset, emitters::LLVMValue value) {
+            if (!isVector)
+            {
+                function.SetValueAt(pointer, offset, value);
+                return;
+            }
+            irBuilder.CreateAlignedStore(value, function.CastPointer(function.PointerOffset(pointer, offset), blockPointerType), alignment);
+        };
+        auto coefficient = [=, &irBuilder, &function](ValueType value) -> emitters::LLVMValue {
+            auto literal = function.Literal<ValueType>(value);
+            return isVector ? irBuilder.CreateVectorSplat(blockSize, literal) : literal;
+        };
+
+        // Keep the state of the block in local variables, so it stays in registers across the frames
+        std::vector<emitters::LLVMValue> stateVars;
+        for (int index = 0; index < 2 * numSections; ++index)
+        {
+            auto var = function.Variable(blockType, "biquadState");
+            function.Store(var, load(function, state, channel + (index * numChannels)));
+            stateVars.push_back(var);
+        }
+
+        struct SectionCoefficients
+        {
+            emitters::LLVMValue b0, b1, b2, a1, a2;
+        };
+        std::vector<SectionCoefficients> coefficients;
+        for (const auto& section : sections)
+        {
+            coefficients.push_back({ coefficient(section.b0), coefficient(section.b1), coefficient(section.b2), coefficient(section.a1), coefficient(section.a2) });
+        }
+
+        const auto add = emitters::GetAddForValueType<ValueType>();
+        const auto subtract = emitters::GetSubtractForValueType<ValueType>();
+        const auto multiply = emitters::GetMultiplyForValueType<ValueType>();
+        function.For(numFrames, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue frameValue) {
+            auto offset = channel + (function.LocalScalar(frameValue) * numChannels);
+            auto x = load(function, input, offset);
+
+            // Each section, in transposed direct form II:
+            //   y = b0*x + s1, s1 = b1*x - a1*y + s2, s2 = b2*x - a2*y
+            for (int sectionIndex = 0; sectionIndex < numSections; ++sectionIndex)
+            {
+                const auto& c = coefficients[sectionIndex];
+                auto s1Var = stateVars[2 * sectionIndex];
+                auto s2Var = stateVars[2 * sectionIndex + 1];
+                auto y = function.Operator(add, function.Operator(multiply, c.b0, x), function.Load(s1Var));
+                auto s1 = function.Operator(add, function.Operator(subtract, function.Operator(multiply, c.b1, x), function.Operator(multiply, c.a1, y)), function.Load(s2Var));
+                auto s2 = function.Operator(subtract, function.Operator(multiply, c.b2, x), function.Operator(multiply, c.a2, y));
+                function.Store(s1Var, s1);
+                function.Store(s2Var, s2);
+                x = y;
+            }
+            store(function, output, offset, x);
+        });
+
+        for (int index = 0; index < 2 * numSections; ++index)
+        {
+            store(function, state, channel + (index * numChannels), function.Load(stateVars[index]));
+        }
+    }
+
+    template <typename ValueType>
+    void BiquadFilterNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["filter"] << _filter;
+    }
+
+    template <typename ValueType>
+    void BiquadFilterNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["filter"] >> _filter;
+        _output.SetSize(_input.Size());
+        ValidateParameters();
+    }
+
+    // Explicit instantiations
+    template class BiquadFilterNode<float>;
+    template class BiquadFilterNode<double>;
+} // namespace nodes
+} // namespace ell
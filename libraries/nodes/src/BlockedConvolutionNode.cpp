@@ -0,0 +1,306 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BlockedConvolutionNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BlockedConvolutionNode.h"
+
+#include <emitters/include/IRVectorUtilities.h>
+
+#include <math/include/Tensor.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        using namespace ::ell::emitters;
+
+        // The blocks of the buffers aren't necessarily aligned to the vector size, so load and store vectors with the element alignment
+        LLVMValue LoadVector(IRFunctionEmitter& function, LLVMValue pointer, LLVMType vectorPointerType, unsigned alignment)
+        {
+            auto vectorPointer = function.CastPointer(pointer, vectorPointerType);
+            return function.GetEmitter().GetIRBuilder().CreateAlignedLoad(vectorPointer, alignment);
+        }
+
+        void StoreVector(IRFunctionEmitter& function, LLVMValue pointer, LLVMType vectorPointerType, unsigned alignment, LLVMValue value)
+        {
+            auto vectorPointer = function.CastPointer(pointer, vectorPointerType);
+            function.GetEmitter().GetIRBuilder().CreateAlignedStore(value, vectorPointer, alignment);
+        }
+
+        int GetNumBlocks(int size, int blockSize)
+        {
+            return (size - 1) / blockSize + 1;
+        }
+    } // namespace
+
+    template <typename ValueType>
+    BlockedConvolutionNode<ValueType>::BlockedConvolutionNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    BlockedConvolutionNode<ValueType>::BlockedConvolutionNode(const model::OutputPort<ValueType>& input,
+                                                              const model::PortMemoryLayout& inputMemoryLayout,
+                                                              const model::PortMemoryLayout& outputMemoryLayout,
+                                                              const ConstTensorReferenceType& filterWeights,
+                                                              int stride) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, outputMemoryLayout),
+        _inputMemoryLayout(inputMemoryLayout),
+        _filterWeights(filterWeights),
+        _stride(stride)
+    {
+        ValidateLayouts();
+    }
+
+    template <typename ValueType>
+    void BlockedConvolutionNode<ValueType>::ValidateLayouts() const
+    {
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        if (!model::IsChannelBlockedLayout(inputLayout) || !model::IsChannelBlockedLayout(outputLayout))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "BlockedConvolutionNode: input and output layouts must be channel-blocked");
+        }
+
+        const int blockSize = inputLayout.GetLogicalDimensionActiveSize(3);
+        if (outputLayout.GetLogicalDimensionActiveSize(3) != blockSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "BlockedConvolutionNode: input and output must have the same channel block size");
+        }
+
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int numInputChannels = static_cast<int>(_filterWeights.NumChannels());
+        const int numFilters = static_cast<int>(_filterWeights.NumRows()) / filterSize;
+        if (inputLayout.GetLogicalDimensionActiveSize(2) != GetNumBlocks(numInputChannels, blockSize) || outputLayout.GetLogicalDimensionActiveSize(2) != GetNumBlocks(numFilters, blockSize))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "BlockedConvolutionNode: number of channel blocks doesn't match the weights");
+        }
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> BlockedConvolutionNode<ValueType>::GetBlockedWeights() const
+    {
+        const int blockSize = GetInputMemoryLayout().GetLogicalDimensionActiveSize(3);
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int numInputChannels = static_cast<int>(_filterWeights.NumChannels());
+        const int numFilters = static_cast<int>(_filterWeights.NumRows()) / filterSize;
+        const int numPaddedInputChannels = GetInputMemoryLayout().GetLogicalDimensionActiveSize(2) * blockSize;
+        const int numOutputBlocks = GetOutputMemoryLayout().GetLogicalDimensionActiveSize(2);
+
+        std::vector<ValueType> weights(numOutputBlocks * filterSize * filterSize * numPaddedInputChannels * blockSize);
+        for (int outputBlock = 0; outputBlock < numOutputBlocks; ++outputBlock)
+        {
+            for (int filterRow = 0; filterRow < filterSize; ++filterRow)
+            {
+                for (int filterColumn = 0; filterColumn < filterSize; ++filterColumn)
+                {
+                    for (int inputChannel = 0; inputChannel < numInputChannels; ++inputChannel)
+                    {
+                        const int offset = (((outputBlock * filterSize + filterRow) * filterSize + filterColumn) * numPaddedInputChannels + inputChannel) * blockSize;
+                        for (int lane = 0; lane < blockSize; ++lane)
+                        {
+                            const int filter = outputBlock * blockSize + lane;
+                            if (filter < numFilters)
+                            {
+                                weights[offset + lane] = _filterWeights(filter * filterSize + filterRow, filterColumn, inputChannel);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return weights;
+    }
+
+    template <typename ValueType>
+    void BlockedConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<BlockedConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, GetOutputMemoryLayout(), _filterWeights, _stride);
+        transformer.MapNodeOutput(this->output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void BlockedConvolutionNode<ValueType>::Compute() const
+    {
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int blockSize = inputLayout.GetLogicalDimensionActiveSize(3);
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int numInputBlocks = inputLayout.GetLogicalDimensionActiveSize(2);
+        const int numPaddedInputChannels = numInputBlocks * blockSize;
+        const int numOutputBlocks = outputLayout.GetLogicalDimensionActiveSize(2);
+        const int outputRows = outputLayout.GetLogicalDimensionActiveSize(0);
+        const int outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        const auto inputIncrement = inputLayout.GetLogicalDimensionIncrement();
+        const auto outputIncrement = outputLayout.GetLogicalDimensionIncrement();
+        const auto outputOffset = outputLayout.GetLogicalDimensionOffset();
+
+        const auto input = _input.GetValue();
+        const auto weights = GetBlockedWeights();
+        std::vector<ValueType> result(outputLayout.GetMemorySize());
+        std::vector<ValueType> sum(blockSize);
+        for (int outputBlock = 0; outputBlock < numOutputBlocks; ++outputBlock)
+        {
+            for (int row = 0; row < outputRows; ++row)
+            {
+                for (int column = 0; column < outputColumns; ++column)
+                {
+                    std::fill(sum.begin(), sum.end(), ValueType{ 0 });
+                    for (int filterRow = 0; filterRow < filterSize; ++filterRow)
+                    {
+                        for (int filterColumn = 0; filterColumn < filterSize; ++filterColumn)
+                        {
+                            const int fieldOffset = ((row * _stride + filterRow) * inputIncrement[0]) + ((column * _stride + filterColumn) * inputIncrement[1]);
+                            const int weightsOffset = ((outputBlock * filterSize + filterRow) * filterSize + filterColumn) * numPaddedInputChannels * blockSize;
+                            for (int inputChannel = 0; inputChannel < numPaddedInputChannels; ++inputChannel)
+                            {
+                                const auto inputValue = input[fieldOffset + ((inputChannel / blockSize) * inputIncrement[2]) + (inputChannel % blockSize)];
+                                for (int lane = 0; lane < blockSize; ++lane)
+                                {
+                                    sum[lane] += inputValue * weights[weightsOffset + (inputChannel * blockSize) + lane];
+                                }
+                            }
+                        }
+                    }
+
+                    const int outputIndex = ((row + outputOffset[0]) * outputIncrement[0]) + ((column + outputOffset[1]) * outputIncrement[1]) + (outputBlock * outputIncrement[2]);
+                    std::copy(sum.begin(), sum.end(), result.begin() + outputIndex);
+                }
+            }
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void BlockedConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(this->input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(this->output);
+
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int blockSize = inputLayout.GetLogicalDimensionActiveSize(3);
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int numInputBlocks = inputLayout.GetLogicalDimensionActiveSize(2);
+        const int numPaddedInputChannels = numInputBlocks * blockSize;
+        const int numOutputBlocks = outputLayout.GetLogicalDimensionActiveSize(2);
+        const int outputRows = outputLayout.GetLogicalDimensionActiveSize(0);
+        const int outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        const int stride = _stride;
+
+        // The input buffer includes its padding, which supplies the zeros around the edges of the image
+        const int inputRowIncrement = static_cast<int>(inputLayout.GetLogicalDimensionIncrement(0));
+        const int inputColumnIncrement = static_cast<int>(inputLayout.GetLogicalDimensionIncrement(1));
+        const int inputBlockIncrement = static_cast<int>(inputLayout.GetLogicalDimensionIncrement(2));
+        const int outputRowIncrement = static_cast<int>(outputLayout.GetLogicalDimensionIncrement(0));
+        const int outputColumnIncrement = static_cast<int>(outputLayout.GetLogicalDimensionIncrement(1));
+        const int outputBlockIncrement = static_cast<int>(outputLayout.GetLogicalDimensionIncrement(2));
+        const int outputBufferOffset = (outputLayout.GetLogicalDimensionOffset(0) * outputRowIncrement) + (outputLayout.GetLogicalDimensionOffset(1) * outputColumnIncrement);
+        const int weightsTapIncrement = numPaddedInputChannels * blockSize;
+
+        // Weights, in (output block, row, column, input channel, output channel) order
+        auto pVarWeights = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(GetBlockedWeights());
+        auto pWeights = function.GetModule().EnsureEmitted(*pVarWeights);
+
+        // The vectors hold one block of output channels
+        auto& emitter = function.GetEmitter();
+        auto vectorType = emitter.VectorType(emitters::GetVariableType<ValueType>(), blockSize);
+        auto vectorPointerType = vectorType->getPointerTo();
+        const unsigned alignment = sizeof(ValueType);
+
+        function.ParallelFor(outputRows, { pInput, pWeights, pOutput }, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar outputRow, const std::vector<emitters::LLVMValue>& capturedValues) {
+            auto input = capturedValues[0];
+            auto weights = capturedValues[1];
+            auto output = function.PointerOffset(capturedValues[2], outputBufferOffset);
+            auto inputRow = outputRow * stride;
+            auto accumulator = function.Variable(vectorType, "accumulator");
+
+            function.For(numOutputBlocks, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue outputBlockValue) {
+                auto outputBlock = function.LocalScalar(outputBlockValue);
+                auto blockWeights = function.PointerOffset(weights, outputBlock * (filterSize * filterSize * weightsTapIncrement));
+
+                function.For(outputColumns, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue columnValue) {
+                    auto outputColumn = function.LocalScalar(columnValue);
+                    auto fieldOffset = (inputRow * inputRowIncrement) + (outputColumn * (stride * inputColumnIncrement));
+                    function.Store(accumulator, emitters::FillVector<ValueType>(function, vectorType, 0));
+
+                    function.For(numInputBlocks, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue inputBlockValue) {
+                        auto inputBlock = function.LocalScalar(inputBlockValue);
+                        auto blockInput = function.PointerOffset(input, fieldOffset + (inputBlock * inputBlockIncrement));
+                        auto tapWeights = function.PointerOffset(blockWeights, inputBlock * (blockSize * blockSize));
+                        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+
+                        // The filters and blocks are small, so we unroll the loops over the filter taps and the channels in the input block.
+                        // Each input value is broadcast and multiplied by the weights for the whole output block.
+                        emitters::LLVMValue sum = function.Load(accumulator);
+                        for (int filterRow = 0; filterRow < filterSize; ++filterRow)
+                        {
+                            for (int filterColumn = 0; filterColumn < filterSize; ++filterColumn)
+                            {
+                                const int inputOffset = (filterRow * inputRowIncrement) + (filterColumn * inputColumnIncrement);
+                                const int weightsOffset = (filterRow * filterSize + filterColumn) * weightsTapIncrement;
+                                for (int channel = 0; channel < blockSize; ++channel)
+                                {
+                                    auto inputValue = irBuilder.CreateVectorSplat(blockSize, function.ValueAt(blockInput, function.Literal<int>(inputOffset + channel)));
+                                    auto weightsValue = LoadVector(function, function.PointerOffset(tapWeights, weightsOffset + (channel * blockSize)), vectorPointerType, alignment);
+                                    auto product = function.Operator(emitters::GetMultiplyForValueType<ValueType>(), inputValue, weightsValue);
+                                    sum = function.Operator(emitters::GetAddForValueType<ValueType>(), sum, product);
+                                }
+                            }
+                        }
+                        function.Store(accumulator, sum);
+                    });
+
+                    auto outputIndex = (outputRow * outputRowIncrement) + (outputColumn * outputColumnIncrement) + (outputBlock * outputBlockIncrement);
+                    StoreVector(function, function.PointerOffset(output, outputIndex), vectorPointerType, alignment, function.Load(accumulator));
+                });
+            });
+        });
+    }
+
+    template <typename ValueType>
+    void BlockedConvolutionNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        model::CompilableNode::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["inputLayout"] << _inputMemoryLayout;
+        archiver["outputLayout"] << GetOutputMemoryLayout();
+        archiver["stride"] << _stride;
+        math::TensorArchiver::Write(_filterWeights, "weights", archiver);
+    }
+
+    template <typename ValueType>
+    void BlockedConvolutionNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        model::CompilableNode::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["inputLayout"] >> _inputMemoryLayout;
+        model::PortMemoryLayout outputMemoryLayout;
+        archiver["outputLayout"] >> outputMemoryLayout;
+        _output.SetMemoryLayout(outputMemoryLayout);
+        archiver["stride"] >> _stride;
+        math::TensorArchiver::Read(_filterWeights, "weights", archiver);
+        ValidateLayouts();
+    }
+
+    // Explicit specializations
+    template class BlockedConvolutionNode<float>;
+    template class BlockedConvolutionNode<double>;
+} // namespace nodes
+} // namespace ell
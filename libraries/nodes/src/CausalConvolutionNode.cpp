@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CausalConvolutionNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CausalConvolutionNode.h"
+
+#include <emitters/include/IRLocalScalar.h>
+
+#include <utilities/include/Exception.h>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    CausalConvolutionNode<ValueType>::CausalConvolutionNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    CausalConvolutionNode<ValueType>::CausalConvolutionNode(const model::OutputPort<ValueType>& input, size_t frameSize, size_t filterSize, const std::vector<ValueType>& weights) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0),
+        _frameSize(frameSize),
+        _filterSize(filterSize),
+        _weights(weights)
+    {
+        ValidateParameters();
+        _output.SetSize(GetNumOutputFrames() * GetNumFilters());
+    }
+
+    template <typename ValueType>
+    void CausalConvolutionNode<ValueType>::ValidateParameters() const
+    {
+        if (_frameSize == 0 || _filterSize == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "CausalConvolutionNode: frame size and filter size must be positive");
+        }
+
+        if (_input.Size() % _frameSize != 0 || GetNumInputFrames() < _filterSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "CausalConvolutionNode: input must be a whole number of frames, at least as many as the filter size");
+        }
+
+        if (_weights.empty() || _weights.size() % (_filterSize * _frameSize) != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "CausalConvolutionNode: weights must hold filterSize * frameSize values for each filter");
+        }
+    }
+
+    template <typename ValueType>
+    void CausalConvolutionNode<ValueType>::Compute() const
+    {
+        const auto numFilters = GetNumFilters();
+        const auto numOutputFrames = GetNumOutputFrames();
+        const auto filterVolume = _filterSize * _frameSize;
+        std::vector<ValueType> result(numOutputFrames * numFilters);
+        for (size_t frame = 0; frame < numOutputFrames; ++frame)
+        {
+            for (size_t filter = 0; filter < numFilters; ++filter)
+            {
+                ValueType sum = 0;
+                for (size_t index = 0; index < filterVolume; ++index)
+                {
+                    sum += _weights[filter * filterVolume + index] * _input[frame * _frameSize + index];
+                }
+                result[frame * numFilters + filter] = sum;
+            }
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void CausalConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        auto pWeights = function.GetModule().ConstantArray(compiler.GetGlobalName(*this, "weights"), _weights);
+
+        // The filters of an output frame span `filterSize` consecutive input frames, so each output frame is
+        // the product of the (numFilters x filterSize * frameSize) weights matrix with a slice of the input
+        const int numFilters = static_cast<int>(GetNumFilters());
+        const int frameSize = static_cast<int>(_frameSize);
+        const int filterVolume = static_cast<int>(_filterSize * _frameSize);
+        auto weights = function.PointerOffset(pWeights, 0);
+        function.For(static_cast<int>(GetNumOutputFrames()), [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto frame = function.LocalScalar(i);
+            auto inputFrame = function.PointerOffset(pInput, frame * frameSize);
+            auto outputFrame = function.PointerOffset(pOutput, frame * numFilters);
+            function.CallGEMV<ValueType>(numFilters, filterVolume, weights, filterVolume, inputFrame, 1, outputFrame, 1);
+        });
+    }
+
+    template <typename ValueType>
+    void CausalConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<CausalConvolutionNode<ValueType>>(newInput, _frameSize, _filterSize, _weights);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void CausalConvolutionNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["frameSize"] << _frameSize;
+        archiver["filterSize"] << _filterSize;
+        archiver["weights"] << _weights;
+    }
+
+    template <typename ValueType>
+    void CausalConvolutionNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["frameSize"] >> _frameSize;
+        archiver["filterSize"] >> _filterSize;
+        archiver["weights"] >> _weights;
+        ValidateParameters();
+        _output.SetSize(GetNumOutputFrames() * GetNumFilters());
+    }
+
+    // Explicitly instantiate versions
+    template class CausalConvolutionNode<float>;
+    template class CausalConvolutionNode<double>;
+} // namespace nodes
+} // namespace ell
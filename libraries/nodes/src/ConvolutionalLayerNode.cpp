@@ -7,6 +7,8 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "ConvolutionalLayerNode.h"
+#include "BlockedConvolutionNode.h"
+#include "DepthwiseConvolutionNode.h"
 #include "DiagonalConvolutionNode.h"
 #include "ReorderDataNode.h"
 #include "SimpleConvolutionNode.h"
@@ -20,6 +22,11 @@ namespace ell
 {
 namespace nodes
 {
+    namespace
+    {
+        const int defaultChannelBlockSize = 8;
+    }
+
     template <typename ValueType>
     ConvolutionalLayerNode<ValueType>::ConvolutionalLayerNode(const model::OutputPort<ValueType>& input, const predictors::neural::ConvolutionalLayer<ValueType>& layer) :
         NeuralNetworkLayerNode<ConvolutionalLayerNode<ValueType>, predictors::neural::ConvolutionalLayer<ValueType>, ValueType>(input, layer)
@@ -47,6 +54,15 @@ namespace nodes
 
         auto convInputLayout = originalInputLayout.ReorderedCopy({ shouldReorderToChannelMajor ? utilities::ChannelMajorTensorOrder : utilities::RowMajorTensorOrder });
         auto convOutputLayout = originalOutputLayout.ReorderedCopy({ shouldReorderToChannelMajor ? utilities::ChannelMajorTensorOrder : utilities::RowMajorTensorOrder });
+        if (convParams.method == ConvolutionMethod::blocked)
+        {
+            // The reorders before and after the convolution block and unblock the channels. Between consecutive blocked
+            // layers, OptimizeReorderDataNodesTransformation removes them, so the data stays blocked.
+            const auto* compiler = transformer.GetContext().GetCompiler();
+            auto channelBlockSize = compiler != nullptr ? compiler->GetModelOptimizerOptions(*this).template GetEntry<int>("channelBlockSize", compiler->GetMapCompilerOptions(*this).compilerSettings.vectorWidth) : defaultChannelBlockSize;
+            convInputLayout = model::GetChannelBlockedLayout(convInputLayout, channelBlockSize);
+            convOutputLayout = model::GetChannelBlockedLayout(convOutputLayout, channelBlockSize);
+        }
 
         auto preConvReorderNode = transformer.AddNode<ReorderDataNode<ValueType>>(*newInput, originalInputLayout, convInputLayout);
         newInput = &preConvReorderNode->output;
@@ -76,7 +92,22 @@ namespace nodes
         break;
         case ConvolutionMethod::winograd:
         {
-            auto convNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride);
+            const int defaultTileSize = 2;
+            const auto* compiler = transformer.GetContext().GetCompiler();
+            auto tileSize = compiler != nullptr ? compiler->GetModelOptimizerOptions(*this).template GetEntry<int>("winogradTileSize", defaultTileSize) : defaultTileSize;
+            auto convNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride, tileSize);
+            convOutput = static_cast<model::OutputPort<ValueType>*>(convNode->GetOutputPort(0));
+        }
+        break;
+        case ConvolutionMethod::depthwise:
+        {
+            auto convNode = transformer.AddNode<DepthwiseConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride);
+            convOutput = static_cast<model::OutputPort<ValueType>*>(convNode->GetOutputPort(0));
+        }
+        break;
+        case ConvolutionMethod::blocked:
+        {
+            auto convNode = transformer.AddNode<BlockedConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride);
             convOutput = static_cast<model::OutputPort<ValueType>*>(convNode->GetOutputPort(0));
         }
         break;
@@ -8,9 +8,10 @@
 
 #include "DCTNode.h"
 
+#include "FFTNode.h"
 #include "MatrixVectorProductNode.h"
 
-#include <dsp/include/DCT.h>
+#include <emitters/include/IRLocalScalar.h>
 
 namespace ell
 {
@@ -18,7 +19,7 @@ namespace nodes
 {
     template <typename ValueType>
     DCTNode<ValueType>::DCTNode() :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, {}, defaultInputPortName),
         _output(this, defaultOutputPortName, 0),
         _dctCoeffs(0, 0)
@@ -27,22 +28,91 @@ namespace nodes
 
     template <typename ValueType>
     DCTNode<ValueType>::DCTNode(const model::OutputPort<ValueType>& input, size_t numFilters) :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, numFilters),
         _dctCoeffs(0, 0)
     {
-        _dctCoeffs = dsp::GetDCTMatrix<ValueType>(numFilters, _input.Size());
+        Initialize(numFilters);
+    }
+
+    template <typename ValueType>
+    void DCTNode<ValueType>::Initialize(size_t numFilters)
+    {
+        _dctCoeffs = dsp::GetDCTMatrix<ValueType>(_input.Size(), numFilters);
+        _plan = UsesFastDCT() ? dsp::DCTPlan<ValueType>(_input.Size(), numFilters) : dsp::DCTPlan<ValueType>();
     }
 
     template <typename ValueType>
     void DCTNode<ValueType>::Compute() const
     {
+        if (UsesFastDCT())
+        {
+            const auto& input = _input.GetValue();
+            std::vector<ValueType> result(_plan.GetNumFilters());
+            _plan.Transform(input.data(), result.data());
+            _output.SetOutput(result);
+            return;
+        }
+
         math::ColumnVector<ValueType> x(_input.GetValue());
         auto result = dsp::DCT(_dctCoeffs, x);
         _output.SetOutput(result.ToArray());
     };
 
+    template <typename ValueType>
+    void DCTNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using emitters::IRLocalScalar;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        const int windowSize = static_cast<int>(_plan.GetWindowSize());
+        const int halfSize = windowSize / 2;
+        const int numFilters = static_cast<int>(_plan.GetNumFilters());
+        auto valueType = function.GetEmitter().Type(emitters::GetVariableType<ValueType>());
+
+        // Reorder the signal, v[n] = x[2n] and v[N-1-n] = x[2n+1] (the window size is a power of 2, at least 2)
+        emitters::LLVMValue reordered = function.Variable(valueType, windowSize);
+        function.For(halfSize, [pInput, reordered, windowSize](emitters::IRFunctionEmitter& function, IRLocalScalar n) {
+            function.SetValueAt(reordered, n, function.ValueAt(pInput, n * 2));
+            function.SetValueAt(reordered, (windowSize - 1) - n, function.ValueAt(pInput, n * 2 + 1));
+        });
+
+        emitters::LLVMValue spectrum = function.Variable(valueType, windowSize + 2);
+        EmitRealFFT(compiler, function, *this, _plan.GetFFTPlan(), reordered, spectrum);
+
+        std::vector<ValueType> dctTwiddles;
+        dctTwiddles.reserve(2 * numFilters);
+        for (const auto& w : _plan.GetTwiddleFactors())
+        {
+            dctTwiddles.push_back(w.real());
+            dctTwiddles.push_back(w.imag());
+        }
+        auto twiddles = function.GetModule().ConstantArray(compiler.GetGlobalName(*this, "dctTwiddles"), dctTwiddles);
+
+        // X[k] = Re(t[k] * V[k]), and past the middle of the spectrum V[k] = conj(V[N-k])
+        function.For(std::min(numFilters, halfSize + 1), [twiddles, spectrum, pOutput](emitters::IRFunctionEmitter& function, IRLocalScalar k) {
+            auto tRe = function.LocalScalar(function.ValueAt(twiddles, k * 2));
+            auto tIm = function.LocalScalar(function.ValueAt(twiddles, k * 2 + 1));
+            auto vRe = function.LocalScalar(function.ValueAt(spectrum, k * 2));
+            auto vIm = function.LocalScalar(function.ValueAt(spectrum, k * 2 + 1));
+            function.SetValueAt(pOutput, k, (tRe * vRe) - (tIm * vIm));
+        });
+        if (numFilters > halfSize + 1)
+        {
+            function.For(halfSize + 1, numFilters, [twiddles, spectrum, pOutput, windowSize](emitters::IRFunctionEmitter& function, IRLocalScalar k) {
+                auto mirrorIndex = function.LocalScalar(windowSize) - k;
+                auto tRe = function.LocalScalar(function.ValueAt(twiddles, k * 2));
+                auto tIm = function.LocalScalar(function.ValueAt(twiddles, k * 2 + 1));
+                auto vRe = function.LocalScalar(function.ValueAt(spectrum, mirrorIndex * 2));
+                auto vIm = function.LocalScalar(function.ValueAt(spectrum, mirrorIndex * 2 + 1));
+                function.SetValueAt(pOutput, k, (tRe * vRe) + (tIm * vIm));
+            });
+        }
+    }
+
     template <typename ValueType>
     void DCTNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
@@ -75,7 +145,7 @@ namespace nodes
         Node::ReadFromArchive(archiver);
         archiver[defaultInputPortName] >> _input;
         archiver["numFilters"] >> numFilters;
-        _dctCoeffs = dsp::GetDCTMatrix<ValueType>(numFilters, _input.Size());
+        Initialize(numFilters);
         _output.SetSize(numFilters);
     }
 
@@ -0,0 +1,273 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DepthwiseConvolutionNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DepthwiseConvolutionNode.h"
+
+#include <emitters/include/IRVectorUtilities.h>
+
+#include <math/include/Tensor.h>
+
+#include <utilities/include/Exception.h>
+
+#include <cassert>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        using namespace ::ell::emitters;
+
+        // The (row, column, channel) data isn't aligned to the vector size, so load and store vectors with the element alignment
+        LLVMValue LoadVector(IRFunctionEmitter& function, LLVMValue pointer, LLVMType vectorPointerType, unsigned alignment)
+        {
+            auto vectorPointer = function.CastPointer(pointer, vectorPointerType);
+            return function.GetEmitter().GetIRBuilder().CreateAlignedLoad(vectorPointer, alignment);
+        }
+
+        void StoreVector(IRFunctionEmitter& function, LLVMValue pointer, LLVMType vectorPointerType, unsigned alignment, LLVMValue value)
+        {
+            auto vectorPointer = function.CastPointer(pointer, vectorPointerType);
+            function.GetEmitter().GetIRBuilder().CreateAlignedStore(value, vectorPointer, alignment);
+        }
+    } // namespace
+
+    template <typename ValueType>
+    DepthwiseConvolutionNode<ValueType>::DepthwiseConvolutionNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    DepthwiseConvolutionNode<ValueType>::DepthwiseConvolutionNode(const model::OutputPort<ValueType>& input,
+                                                                  const model::PortMemoryLayout& inputMemoryLayout,
+                                                                  const model::PortMemoryLayout& outputMemoryLayout,
+                                                                  const ConstTensorReferenceType& filterWeights,
+                                                                  int stride) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, outputMemoryLayout),
+        _inputMemoryLayout(inputMemoryLayout),
+        _filterWeights(filterWeights),
+        _stride(stride)
+    {
+        if (filterWeights.NumChannels() != 1 || static_cast<int>(filterWeights.NumRows()) != static_cast<int>(filterWeights.NumColumns()) * inputMemoryLayout.GetLogicalDimensionActiveSize(2))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "DepthwiseConvolutionNode: weights must have one filter per input channel");
+        }
+        if (inputMemoryLayout.GetLogicalDimensionActiveSize(2) != outputMemoryLayout.GetLogicalDimensionActiveSize(2))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "DepthwiseConvolutionNode: input and output must have the same number of channels");
+        }
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> DepthwiseConvolutionNode<ValueType>::GetInterleavedWeights() const
+    {
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int numChannels = _inputMemoryLayout.GetLogicalDimensionActiveSize(2);
+        std::vector<ValueType> weights(filterSize * filterSize * numChannels);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int filterRow = 0; filterRow < filterSize; ++filterRow)
+            {
+                for (int filterColumn = 0; filterColumn < filterSize; ++filterColumn)
+                {
+                    weights[(filterRow * filterSize + filterColumn) * numChannels + channel] = _filterWeights(channel * filterSize + filterRow, filterColumn, 0);
+                }
+            }
+        }
+        return weights;
+    }
+
+    template <typename ValueType>
+    void DepthwiseConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<DepthwiseConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, GetOutputMemoryLayout(), _filterWeights, _stride);
+        transformer.MapNodeOutput(this->output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void DepthwiseConvolutionNode<ValueType>::Compute() const
+    {
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int numChannels = outputLayout.GetLogicalDimensionActiveSize(2);
+        const int outputRows = outputLayout.GetLogicalDimensionActiveSize(0);
+        const int outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        const auto inputIncrement = inputLayout.GetCumulativeIncrement();
+        const auto outputIncrement = outputLayout.GetCumulativeIncrement();
+        const auto outputOffset = outputLayout.GetLogicalDimensionOffset();
+
+        const auto input = _input.GetValue();
+        const auto weights = GetInterleavedWeights();
+        std::vector<ValueType> result(outputLayout.GetMemorySize());
+        for (int row = 0; row < outputRows; ++row)
+        {
+            for (int column = 0; column < outputColumns; ++column)
+            {
+                const int outputIndex = ((row + outputOffset[0]) * outputIncrement[0]) + ((column + outputOffset[1]) * outputIncrement[1]) + outputOffset[2];
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    ValueType sum = 0;
+                    for (int filterRow = 0; filterRow < filterSize; ++filterRow)
+                    {
+                        for (int filterColumn = 0; filterColumn < filterSize; ++filterColumn)
+                        {
+                            const int inputIndex = ((row * _stride + filterRow) * inputIncrement[0]) + ((column * _stride + filterColumn) * inputIncrement[1]) + channel;
+                            sum += input[inputIndex] * weights[(filterRow * filterSize + filterColumn) * numChannels + channel];
+                        }
+                    }
+                    result[outputIndex + channel] = sum;
+                }
+            }
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void DepthwiseConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(this->input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(this->output);
+
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int numChannels = outputLayout.GetLogicalDimensionActiveSize(2);
+        const int outputRows = outputLayout.GetLogicalDimensionActiveSize(0);
+        const int outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        const int stride = _stride;
+
+        // The input buffer includes its padding, which supplies the zeros around the edges of the image
+        const auto inputIncrement = inputLayout.GetCumulativeIncrement();
+        const auto outputIncrement = outputLayout.GetCumulativeIncrement();
+        const auto outputOffset = outputLayout.GetLogicalDimensionOffset();
+        const int inputRowIncrement = inputIncrement[0];
+        const int inputColumnIncrement = inputIncrement[1];
+        const int outputRowIncrement = outputIncrement[0];
+        const int outputColumnIncrement = outputIncrement[1];
+        const int outputBufferOffset = (outputOffset[0] * outputIncrement[0]) + (outputOffset[1] * outputIncrement[1]) + outputOffset[2];
+
+        // Weights, in (row, column, channel) order
+        auto pVarWeights = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(GetInterleavedWeights());
+        auto pWeights = function.GetModule().EnsureEmitted(*pVarWeights);
+
+        // Process the channels in blocks of the vector width, and the leftover channels one at a time
+        const auto& compilerSettings = function.GetCompilerOptions();
+        const int vectorSize = compilerSettings.allowVectorInstructions ? compilerSettings.vectorWidth : 1;
+        const int numVectorBlocks = vectorSize > 1 ? numChannels / vectorSize : 0;
+        const int firstScalarChannel = numVectorBlocks * vectorSize;
+        auto& emitter = function.GetEmitter();
+        auto vectorType = numVectorBlocks > 0 ? emitter.VectorType(emitters::GetVariableType<ValueType>(), vectorSize) : nullptr;
+        auto vectorPointerType = numVectorBlocks > 0 ? vectorType->getPointerTo() : nullptr;
+        const unsigned alignment = sizeof(ValueType);
+
+        // Each output row only reads `filterSize` rows of the input, so rows are processed in parallel, and the
+        // filter taps for a block of channels stay in registers while sweeping across the row
+        function.ParallelFor(outputRows, { pInput, pWeights, pOutput }, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar outputRow, const std::vector<emitters::LLVMValue>& capturedValues) {
+            auto input = capturedValues[0];
+            auto weights = capturedValues[1];
+            auto output = function.PointerOffset(capturedValues[2], outputBufferOffset);
+            auto inputRow = outputRow * stride;
+
+            if (numVectorBlocks > 0)
+            {
+                function.For(numVectorBlocks, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockValue) {
+                    auto channel = function.LocalScalar(blockValue) * vectorSize;
+
+                    // The filters are typically small, so we unroll the loops over the filter taps
+                    std::vector<emitters::LLVMValue> filterTaps;
+                    for (int tap = 0; tap < filterSize * filterSize; ++tap)
+                    {
+                        filterTaps.push_back(LoadVector(function, function.PointerOffset(weights, channel + (tap * numChannels)), vectorPointerType, alignment));
+                    }
+
+                    function.For(outputColumns, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue columnValue) {
+                        auto outputColumn = function.LocalScalar(columnValue);
+                        auto fieldOffset = (inputRow * inputRowIncrement) + (outputColumn * (stride * inputColumnIncrement)) + channel;
+
+                        emitters::LLVMValue sum = emitters::FillVector<ValueType>(function, vectorType, 0);
+                        for (int filterRow = 0; filterRow < filterSize; ++filterRow)
+                        {
+                            for (int filterColumn = 0; filterColumn < filterSize; ++filterColumn)
+                            {
+                                auto inputOffset = fieldOffset + ((filterRow * inputRowIncrement) + (filterColumn * inputColumnIncrement));
+                                auto inputValue = LoadVector(function, function.PointerOffset(input, inputOffset), vectorPointerType, alignment);
+                                auto product = function.Operator(emitters::GetMultiplyForValueType<ValueType>(), inputValue, filterTaps[filterRow * filterSize + filterColumn]);
+                                sum = function.Operator(emitters::GetAddForValueType<ValueType>(), sum, product);
+                            }
+                        }
+
+                        auto outputIndex = (outputRow * outputRowIncrement) + (outputColumn * outputColumnIncrement) + channel;
+                        StoreVector(function, function.PointerOffset(output, outputIndex), vectorPointerType, alignment, sum);
+                    });
+                });
+            }
+
+            if (firstScalarChannel < numChannels)
+            {
+                function.For(outputColumns, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue columnValue) {
+                    auto outputColumn = function.LocalScalar(columnValue);
+                    function.For(firstScalarChannel, numChannels, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue channelValue) {
+                        auto channel = function.LocalScalar(channelValue);
+                        auto fieldOffset = (inputRow * inputRowIncrement) + (outputColumn * (stride * inputColumnIncrement)) + channel;
+
+                        auto sum = function.LocalScalar(ValueType{ 0 });
+                        for (int filterRow = 0; filterRow < filterSize; ++filterRow)
+                        {
+                            for (int filterColumn = 0; filterColumn < filterSize; ++filterColumn)
+                            {
+                                auto inputOffset = fieldOffset + ((filterRow * inputRowIncrement) + (filterColumn * inputColumnIncrement));
+                                auto weightsOffset = channel + ((filterRow * filterSize + filterColumn) * numChannels);
+                                sum = sum + (function.LocalScalar(function.ValueAt(input, inputOffset)) * function.ValueAt(weights, weightsOffset));
+                            }
+                        }
+
+                        auto outputIndex = (outputRow * outputRowIncrement) + (outputColumn * outputColumnIncrement) + channel;
+                        function.SetValueAt(output, outputIndex, sum);
+                    });
+                });
+            }
+        });
+    }
+
+    template <typename ValueType>
+    void DepthwiseConvolutionNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        model::CompilableNode::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["inputLayout"] << _inputMemoryLayout;
+        archiver["outputLayout"] << GetOutputMemoryLayout();
+        archiver["stride"] << _stride;
+        math::TensorArchiver::Write(_filterWeights, "weights", archiver);
+    }
+
+    template <typename ValueType>
+    void DepthwiseConvolutionNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        model::CompilableNode::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["inputLayout"] >> _inputMemoryLayout;
+        model::PortMemoryLayout outputMemoryLayout;
+        archiver["outputLayout"] >> outputMemoryLayout;
+        _output.SetMemoryLayout(outputMemoryLayout);
+        archiver["stride"] >> _stride;
+        math::TensorArchiver::Read(_filterWeights, "weights", archiver);
+    }
+
+    // Explicit specializations
+    template class DepthwiseConvolutionNode<float>;
+    template class DepthwiseConvolutionNode<double>;
+} // namespace nodes
+} // namespace ell
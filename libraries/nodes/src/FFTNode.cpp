@@ -8,24 +8,15 @@
 
 #include "FFTNode.h"
 
-#include <emitters/include/EmitterException.h>
 #include <emitters/include/EmitterTypes.h>
 #include <emitters/include/IRLocalValue.h>
 #include <emitters/include/IRMath.h>
-#include <emitters/include/LLVMUtilities.h>
-
-#include <math/include/MathConstants.h>
 
 #include <dsp/include/FFT.h>
 
-#include <llvm/IR/Type.h>
-
+#include <algorithm>
 #include <cmath>
-
-#define USE_STORED_TWIDDLE_FACTORS 1
-#define USE_FIXED_SMALL_FFT 1
-#define MAX_INLINE_FFT_SIZE 0 // 0 to disable inlining FFT code
-#define USE_REAL_FFT 0 // The real-valued FFT is slower than the complex one. Disable it for now.
+#include <complex>
 
 namespace ell
 {
@@ -33,254 +24,128 @@ namespace nodes
 {
     namespace detail
     {
-        //
-        // Complex functions for emitters
-        //
-        template <typename ValueType>
-        llvm::StructType* GetComplexType(emitters::IRModuleEmitter& module)
-        {
-            auto& emitter = module.GetIREmitter();
-            auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-            return module.GetAnonymousStructType({ valueType, valueType }, true);
-        }
+        using emitters::IRFunctionEmitter;
+        using emitters::IRLocalScalar;
+        using emitters::LLVMValue;
 
-        inline llvm::StructType* GetComplexType(emitters::IRModuleEmitter& module, emitters::LLVMType valueType)
+        // The complex values are stored interleaved: (real, imaginary)
+        struct ComplexValue
         {
-            return module.GetAnonymousStructType({ valueType, valueType }, true);
-        }
+            IRLocalScalar re;
+            IRLocalScalar im;
+        };
 
-        inline emitters::IRLocalValue ComplexAdd(emitters::IRLocalValue a, emitters::IRLocalValue b)
+        inline ComplexValue LoadComplex(IRFunctionEmitter& function, LLVMValue data, IRLocalScalar index)
         {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType() == b.value->getType()))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re + b.re
-            // c.im = a.im + b.im
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(a.value->getType(), "c_add");
-            function.FillStruct(result, { a_re + b_re, a_im + b_im });
-            return { function, function.Load(result) };
+            return { function.LocalScalar(function.ValueAt(data, index * 2)), function.LocalScalar(function.ValueAt(data, index * 2 + 1)) };
         }
 
-        inline emitters::IRLocalValue RealComplexAdd(emitters::IRLocalScalar a_re, emitters::IRLocalValue b)
+        inline void StoreComplex(IRFunctionEmitter& function, LLVMValue data, IRLocalScalar index, ComplexValue value)
         {
-            if (!(b.value->getType()->isStructTy() && b.value->getType()->getNumContainedTypes() == 2 && a_re.value->getType() == b.value->getType()->getContainedType(0)))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re + b.re
-            // c.im = b.im
-            auto& function = a_re.function;
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(b.value->getType(), "rc_add");
-            function.FillStruct(result, { a_re + b_re, b_im });
-            return { function, function.Load(result) };
+            function.SetValueAt(data, index * 2, value.re);
+            function.SetValueAt(data, index * 2 + 1, value.im);
         }
 
-        inline emitters::IRLocalValue ComplexSubtract(emitters::IRLocalValue a, emitters::IRLocalValue b)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType() == b.value->getType()))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re - b.re
-            // c.im = a.im - b.im
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(a.value->getType(), "c_sub");
-            function.FillStruct(result, { a_re - b_re, a_im - b_im });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue RealComplexSubtract(emitters::IRLocalScalar a_re, emitters::IRLocalValue b)
-        {
-            if (!(b.value->getType()->isStructTy() && b.value->getType()->getNumContainedTypes() == 2 && a_re.value->getType() == b.value->getType()->getContainedType(0)))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
+        inline ComplexValue operator+(ComplexValue a, ComplexValue b) { return { a.re + b.re, a.im + b.im }; }
+        inline ComplexValue operator-(ComplexValue a, ComplexValue b) { return { a.re - b.re, a.im - b.im }; }
+        inline ComplexValue operator*(ComplexValue a, ComplexValue b) { return { (a.re * b.re) - (a.im * b.im), (a.re * b.im) + (a.im * b.re) }; }
+        inline ComplexValue TimesI(ComplexValue a) { return { -a.im, a.re }; }
+        inline IRLocalScalar Abs(ComplexValue a) { return emitters::Sqrt((a.re * a.re) + (a.im * a.im)); }
 
-            // c.re = a.re - b.re
-            // c.im = b.im
-            auto& function = a_re.function;
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(b.value->getType(), "rc_sub");
-            function.FillStruct(result, { a_re - b_re, b_im });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue ComplexMultiply(emitters::IRLocalValue a, emitters::IRLocalValue b)
+        // Emits the butterflies of an in-place, iterative FFT of `length` complex values that are already in bit-reversed order.
+        // The twiddle factors for a stage of size L are w^(k * twiddleStride * length / L).
+        inline void EmitFFTStages(IRFunctionEmitter& function, LLVMValue data, int length, LLVMValue twiddles, int twiddleStride)
         {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType() == b.value->getType()))
+            if (length < 4)
             {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
+                if (length == 2)
+                {
+                    auto zero = function.LocalScalar(0);
+                    auto one = function.LocalScalar(1);
+                    auto x0 = LoadComplex(function, data, zero);
+                    auto x1 = LoadComplex(function, data, one);
+                    StoreComplex(function, data, zero, x0 + x1);
+                    StoreComplex(function, data, one, x0 - x1);
+                }
+                return;
             }
 
-            // c.re = a.re * b.re - a.im * b.im
-            // c.im = a.im * b.re + a.re * b.im
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(a.value->getType(), "c_mul");
-            function.FillStruct(result, { (a_re * b_re) - (a_im * b_im), (a_im * b_re) + (a_re * b_im) });
-            return { function, function.Load(result) };
-        }
-
-        template <typename ValueType>
-        inline emitters::IRLocalValue TimesI(emitters::IRLocalValue a)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = -a.im
-            // c.im = i*a.re
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto result = function.Variable(a.value->getType(), "c_times_i");
-            function.FillStruct(result, { -a_im, a_re });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue ComplexRealMultiply(emitters::IRLocalValue a, emitters::IRLocalScalar b_re)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType()->getContainedType(0) == b_re.value->getType()))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re * b
-            // c.im = a.im * b
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto result = function.Variable(a.value->getType(), "rc_mul");
-            function.FillStruct(result, { (a_re * b_re), (a_im * b_re) });
-            return { function, function.Load(result) };
-        }
+            // The first two radix-2 stages together: with twiddle factors 1 and i, they need no multiplications
+            function.For(length / 4, [data](IRFunctionEmitter& function, IRLocalScalar group) {
+                auto index = group * 4;
+                auto x0 = LoadComplex(function, data, index);
+                auto x1 = LoadComplex(function, data, index + 1);
+                auto x2 = LoadComplex(function, data, index + 2);
+                auto x3 = LoadComplex(function, data, index + 3);
+                auto sum01 = x0 + x1;
+                auto diff01 = x0 - x1;
+                auto sum23 = x2 + x3;
+                auto iDiff23 = TimesI(x2 - x3);
+                StoreComplex(function, data, index, sum01 + sum23);
+                StoreComplex(function, data, index + 1, diff01 + iDiff23);
+                StoreComplex(function, data, index + 2, sum01 - sum23);
+                StoreComplex(function, data, index + 3, diff01 - iDiff23);
+            });
 
-        inline emitters::IRLocalValue ComplexAbs(emitters::IRLocalValue a)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2))
+            // The remaining radix-2 stages
+            for (int stageLength = 8; stageLength <= length; stageLength *= 2)
             {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
+                const int halfLength = stageLength / 2;
+                const int stride = twiddleStride * (length / stageLength);
+                function.For(length / stageLength, [=](IRFunctionEmitter& function, IRLocalScalar group) {
+                    auto begin = group * stageLength;
+                    function.For(halfLength, [=](IRFunctionEmitter& function, IRLocalScalar k) {
+                        auto w = LoadComplex(function, twiddles, k * stride);
+                        auto evenIndex = begin + k;
+                        auto oddIndex = evenIndex + halfLength;
+                        auto e = LoadComplex(function, data, evenIndex);
+                        auto wo = w * LoadComplex(function, data, oddIndex);
+                        StoreComplex(function, data, evenIndex, e + wo);
+                        StoreComplex(function, data, oddIndex, e - wo);
+                    });
+                });
             }
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            // result = sqrt(real^2 + imag^2)
-            // Note, this is more accurately computed as std::hypot(std::real(z), std::imag(z))
-            auto magSquared = (a_re * a_re) + (a_im * a_im);
-            return { function, Sqrt(magSquared) };
-        }
-
-        inline emitters::IRLocalValue ImaginaryExp(emitters::IRLocalScalar x)
-        {
-            auto& function = x.function;
-            auto& module = function.GetModule();
-            auto type = x.value->getType();
-            auto complexType = GetComplexType(module, type);
-            // returns e ^ ix == cos(x) + isin(x)
-            auto result = function.Variable(complexType, "i_exp");
-            function.FillStruct(result, { Cos(x), Sin(x) });
-            return { function, function.Load(result) };
         }
 
-        //
-        // FFT-specific functions
-        //
         template <typename ValueType>
-        std::vector<std::complex<ValueType>> GetTwiddleFactors(size_t size)
+        std::vector<ValueType> GetInterleavedTwiddleFactors(const dsp::FFTPlan<ValueType>& plan)
         {
-            // size == FFT length / 2
-            const auto pi = math::Constants<ValueType>::pi;
-            std::vector<std::complex<ValueType>> result(size);
-            for (size_t k = 0; k < size; ++k)
+            const auto& twiddles = plan.GetTwiddleFactors();
+            std::vector<ValueType> result;
+            result.reserve(twiddles.size() * 2);
+            for (const auto& w : twiddles)
             {
-                result[k] = std::exp(std::complex<ValueType>(0, pi * k / size));
+                result.push_back(w.real());
+                result.push_back(w.imag());
             }
             return result;
         }
 
+        // Emits the FFT of the complex signal z of size N/2 made by packing the even and odd entries of the real-valued
+        // signal of size N into its real and imaginary parts (see dsp::FFTPlan::TransformReal), and returns a pointer to
+        // the (interleaved) result. `twiddles` is set to the table of twiddle factors.
         template <typename ValueType>
-        std::string GetFFTFunctionName(size_t length)
-        {
-            // function name: FFTC_<T>_<N>  (e.g., FFTC_float_2)
-            // function signature: void FFTC(complex<T>*, complex<T>*)
-            return std::string("FFTC_") + utilities::GetTypeName<ValueType>() + "_" + std::to_string(length);
-        }
-
-        template <typename ValueType>
-        std::string GetRealFFTFunctionName(size_t length)
+        LLVMValue EmitPackedRealFFT(model::IRMapCompiler& compiler, IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<ValueType>& plan, LLVMValue signal, LLVMValue& twiddles)
         {
-            // function name: FFTR_<T>_<N>  (e.g., FFT_float_32)
-            // function signature: void FFTR(T*, T*, complex<T>*)
-            return std::string("FFTR_") + utilities::GetTypeName<ValueType>() + "_" + std::to_string(length);
-        }
-
-        template <typename ValueType>
-        std::vector<emitters::LLVMType> GetFFTFunctionArguments(emitters::IRModuleEmitter& module)
-        {
-            auto complexType = detail::GetComplexType<ValueType>(module);
-            auto complexPtrType = complexType->getPointerTo();
-            return { complexPtrType, complexPtrType };
-        }
-
-        template <typename ValueType>
-        std::vector<emitters::LLVMType> GetRealFFTFunctionArguments(emitters::IRModuleEmitter& module)
-        {
-            auto& emitter = module.GetIREmitter();
-            auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-            auto valuePtrType = valueType->getPointerTo();
-            auto complexType = detail::GetComplexType(module, valueType);
-            auto complexPtrType = complexType->getPointerTo();
-            return { valuePtrType, valuePtrType, complexPtrType };
-        }
-
-        template <typename ValueType>
-        emitters::IRFunctionEmitter GetFFTFunctionEmitter(emitters::IRModuleEmitter& module, size_t length)
-        {
-            auto& context = module.GetLLVMContext();
-            auto voidType = llvm::Type::getVoidTy(context);
-
-            std::string functionName = GetFFTFunctionName<ValueType>(length);
-            auto argumentTypes = detail::GetFFTFunctionArguments<ValueType>(module);
-            emitters::IRFunctionEmitter function = module.BeginFunction(functionName, voidType, argumentTypes);
-            function.SetAttributeForArguments(emitters::IRFunctionEmitter::Attributes::NoAlias);
-
-            return function;
-        }
+            const int fftSize = static_cast<int>(plan.Size());
+            const int halfSize = fftSize / 2;
+            auto& module = function.GetModule();
+            auto valueType = function.GetEmitter().Type(emitters::GetVariableType<ValueType>());
 
-        template <typename ValueType>
-        emitters::IRFunctionEmitter GetRealFFTFunctionEmitter(emitters::IRModuleEmitter& module, size_t length)
-        {
-            auto& context = module.GetLLVMContext();
-            auto voidType = llvm::Type::getVoidTy(context);
+            twiddles = module.ConstantArray(compiler.GetGlobalName(node, "twiddles"), GetInterleavedTwiddleFactors(plan));
+            auto bitReversal = module.ConstantArray(compiler.GetGlobalName(node, "bitReversal"), plan.GetBitReversalPermutation(halfSize));
+            LLVMValue complexBuffer = function.Variable(valueType, fftSize);
 
-            std::string functionName = GetRealFFTFunctionName<ValueType>(length);
-            auto argumentTypes = detail::GetRealFFTFunctionArguments<ValueType>(module);
-            emitters::IRFunctionEmitter function = module.BeginFunction(functionName, voidType, argumentTypes);
-            function.SetAttributeForArguments(emitters::IRFunctionEmitter::Attributes::NoAlias);
+            // Pack the signal into the complex buffer, in bit-reversed order
+            function.For(halfSize, [signal, complexBuffer, bitReversal](IRFunctionEmitter& function, IRLocalScalar index) {
+                auto sourceIndex = function.LocalScalar(function.ValueAt(bitReversal, index));
+                function.SetValueAt(complexBuffer, index * 2, function.ValueAt(signal, sourceIndex * 2));
+                function.SetValueAt(complexBuffer, index * 2 + 1, function.ValueAt(signal, sourceIndex * 2 + 1));
+            });
 
-            return function;
+            EmitFFTStages(function, complexBuffer, halfSize, twiddles, 2);
+            return complexBuffer;
         }
-
     } // namespace detail
 
     template <typename ValueType>
@@ -302,6 +167,7 @@ namespace nodes
         double nearestPowerOf2Size = std::pow(2, std::ceil(std::log2(input.Size())));
         _fftSize = static_cast<size_t>(nearestPowerOf2Size);
         _output.SetSize(_fftSize / 2);
+        _plan = dsp::FFTPlan<ValueType>(_fftSize);
     }
 
     template <typename ValueType>
@@ -316,341 +182,27 @@ namespace nodes
         {
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "fftSize must be a power of 2");
         }
-    }
-
-    inline void Deinterleave(emitters::IRFunctionEmitter& function, emitters::LLVMValue array, emitters::LLVMValue halfLength, emitters::LLVMValue scratch)
-    {
-        auto halfN = function.LocalScalar(halfLength);
-        function.For(halfN, [&scratch, &array](emitters::IRFunctionEmitter& function, auto index) {
-            auto evenIndex = index * 2;
-            auto oddIndex = evenIndex + 1;
-            function.SetValueAt(scratch, index, function.ValueAt(array, oddIndex));
-            function.SetValueAt(array, index, function.ValueAt(array, evenIndex));
-        });
-
-        function.For(halfN, [&scratch, &array, halfN](emitters::IRFunctionEmitter& function, auto index) {
-            function.SetValueAt(array, index + halfN, function.ValueAt(scratch, index));
-        });
-    }
-
-    inline void Deinterleave(emitters::IRFunctionEmitter& function, emitters::LLVMValue array, int halfN, emitters::LLVMValue scratch)
-    {
-        Deinterleave(function, array, function.Literal(halfN), scratch);
-    }
-
-    // FFT1 twiddle factors: [1]
-    // FFT2 twiddle factors: [1, -1]
-    // FFT4 twiddle factors: [1, i, -1, -i]
-    // FFT8 twiddle factors: [1, sqrt2/2+i*sqrt2/2, i, -sqrt2/2+i*sqrt2/2, -1, -sqrt2/2-i*sqrt2/2, -i, sqrt2/2-i*sqrt2/2]
-
-    template <typename ValueType>
-    void FFTNode<ValueType>::EmitFFT_2(emitters::IRFunctionEmitter& function, emitters::LLVMValue input)
-    {
-        // FFT of length 2: x' = [x0+x1, x0-x1]
-        auto x0 = function.LocalScalar(function.ValueAt(input, 0));
-        auto x1 = function.LocalScalar(function.ValueAt(input, 1));
-        function.SetValueAt(input, 0, detail::ComplexAdd(x0, x1));
-        function.SetValueAt(input, 1, detail::ComplexSubtract(x0, x1));
-    }
-
-    template <typename ValueType>
-    emitters::LLVMFunction FFTNode<ValueType>::GetFFTFunction_2(emitters::IRModuleEmitter& module)
-    {
-        const auto length = 2;
-        auto functionName = detail::GetFFTFunctionName<ValueType>(length);
-        auto existingFunction = module.GetFunction(functionName);
-        if (existingFunction != nullptr)
-        {
-            return existingFunction;
-        }
-
-        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, length);
-        {
-            auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-            EmitFFT_2(function, input);
-        }
-        module.EndFunction();
-        return function.GetFunction();
+        _plan = dsp::FFTPlan<ValueType>(_fftSize);
     }
 
     template <typename ValueType>
-    void FFTNode<ValueType>::EmitFFT_4(emitters::IRFunctionEmitter& function, emitters::LLVMValue input)
-    {
-        // FFT of length 4: X = [x0+x1+x2+x3, x0+ix1-x2-ix3, x0-x1+x2-x3, x0-ix1-x2+ix3]
-        // Input x = {x0, x1, x2, x3}
-        auto x0 = function.LocalScalar(function.ValueAt(input, 0));
-        auto x1 = function.LocalScalar(function.ValueAt(input, 1));
-        auto x2 = function.LocalScalar(function.ValueAt(input, 2));
-        auto x3 = function.LocalScalar(function.ValueAt(input, 3));
-
-        // deinterleave -> {x0, x2, x1, x3}
-        // call fft2 on each half:
-        //   -> {x0+x2, x0-x2, x1+x3, x1-x3}
-        // apply twiddle factor w_0 = 1:
-        //  -> { (x0+x2) + (x1+x3), ..., (x0+x2) - (x1+x3), ...}
-        // apply twiddle factor w_1 = i:
-        //  -> { (x0+x2) + (x1+x3), (x0-x2) + i(x1-x3), (x0+x2) - (x1+x3), (x0-x2) - i(x1-x3)}
-
-        auto x0px2 = detail::ComplexAdd(x0, x2);
-        auto x0mx2 = detail::ComplexSubtract(x0, x2);
-        auto x1px3 = detail::ComplexAdd(x1, x3);
-        auto x1mx3 = detail::ComplexSubtract(x1, x3);
-        function.SetValueAt(input, 0, detail::ComplexAdd(x0px2, x1px3));
-        function.SetValueAt(input, 1, detail::ComplexAdd(x0mx2, detail::TimesI<ValueType>(x1mx3)));
-        function.SetValueAt(input, 2, detail::ComplexSubtract(x0px2, x1px3));
-        function.SetValueAt(input, 3, detail::ComplexSubtract(x0mx2, detail::TimesI<ValueType>(x1mx3)));
-    }
-
-    template <typename ValueType>
-    emitters::LLVMFunction FFTNode<ValueType>::GetFFTFunction_4(emitters::IRModuleEmitter& module)
-    {
-        const auto length = 4;
-        auto functionName = detail::GetFFTFunctionName<ValueType>(length);
-        auto existingFunction = module.GetFunction(functionName);
-        if (existingFunction != nullptr)
-        {
-            return existingFunction;
-        }
-
-        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, length);
-        {
-            auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-
-            EmitFFT_4(function, input);
-        }
-        module.EndFunction();
-        return function.GetFunction();
-    }
-
-    // Fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    void FFTNode<ValueType>::EmitFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch)
-    {
-#if (USE_FIXED_SMALL_FFT)
-        if (length == 2)
-        {
-            EmitFFT_2(function, input);
-        }
-        if (length == 4)
-        {
-            EmitFFT_4(function, input);
-        }
-#endif // USE_FIXED_SMALL_FFT
-
-        // TODO: assert(bitcount(length) == 1)  (i.e., length is a power of 2)
-        auto& module = function.GetModule();
-        auto& emitter = module.GetIREmitter();
-        auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-        auto complexType = detail::GetComplexType(module, valueType);
-        auto complexPtrType = complexType->getPointerTo();
-
-        auto halfN = length / 2;
-        assert(halfN >= 1);
-
-        Deinterleave(function, input, halfN, scratch);
-        auto evens = input;
-        auto odds = function.PointerOffset(evens, halfN);
-
-        if (halfN > 1) // call recursive case if necessary
-        {
-            DoFFT(function, halfN, evens, scratch);
-            DoFFT(function, halfN, odds, scratch);
-        }
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-        auto twiddleFactors = detail::GetTwiddleFactors<ValueType>(halfN);
-        std::vector<ValueType> twiddleFactorsUnwrapped(twiddleFactors.size() * 2);
-        ValueType* dataPtr = reinterpret_cast<ValueType*>(twiddleFactors.data());
-        std::copy(dataPtr, dataPtr + twiddleFactorsUnwrapped.size(), twiddleFactorsUnwrapped.begin());
-        auto twiddleFactorsUnwrappedVar = module.ConstantArray(std::string("twiddles_") + std::to_string(halfN), twiddleFactorsUnwrapped); // TODO: encode type name in variable name
-        auto twiddleFactorsVar = function.CastPointer(twiddleFactorsUnwrappedVar, complexPtrType);
-#else
-        bool twiddleFactorsVar = false;
-#endif
-
-        function.For(halfN, [&evens, &odds, &twiddleFactorsVar](emitters::IRFunctionEmitter& function, auto k) {
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-            auto w = function.LocalScalar(function.ValueAt(twiddleFactorsVar, k));
-#else
-            // w = e^i(2*pi*k/N)
-            auto kValue = function.LocalScalar(function.CastValue<ValueType>(k));
-            auto w = detail::ImaginaryExp(function.LocalScalar(pi / halfN) * kValue);
-#endif
-
-            auto e = function.LocalScalar(function.ValueAt(evens, k));
-            auto o = function.LocalScalar(function.ValueAt(odds, k));
-            auto wo = detail::ComplexMultiply(w, o); // wo = w*o
-            function.SetValueAt(evens, k, detail::ComplexAdd(e, wo)); // even
-            function.SetValueAt(odds, k, detail::ComplexSubtract(e, wo)); // odd
-        });
-    }
-
-    // Fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    emitters::LLVMFunction FFTNode<ValueType>::GetFFTFunction(emitters::IRModuleEmitter& module, size_t length)
-    {
-#if (USE_FIXED_SMALL_FFT)
-        if (length == 2)
-        {
-            return GetFFTFunction_2(module);
-        }
-        if (length == 4)
-        {
-            return GetFFTFunction_4(module);
-        }
-#endif // USE_FIXED_SMALL_FFT
-
-        auto functionName = detail::GetFFTFunctionName<ValueType>(length);
-        auto existingFunction = module.GetFunction(functionName);
-        if (existingFunction != nullptr)
-        {
-            return existingFunction;
-        }
-
-        // TODO: assert(bitcount(length) == 1)  (i.e., length is a power of 2)
-        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, length);
-        {
-            auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-            auto scratch = function.LocalScalar(&(*arguments++));
-
-            EmitFFT(function, length, input, scratch);
-        }
-        module.EndFunction();
-        return function.GetFunction();
-    }
-
-    // Real-valued fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    void FFTNode<ValueType>::EmitRealFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch, emitters::LLVMValue complexInput)
-    {
-        // TODO: assert(bitcount(length) == 1)  (i.e., length is a power of 2)
-        auto& module = function.GetModule();
-        auto complexType = detail::GetComplexType<ValueType>(module);
-        auto complexPtrType = complexType->getPointerTo();
-
-        auto halfN = length / 2;
-        assert(halfN >= 1);
-
-        Deinterleave(function, input, halfN, scratch);
-        auto evens = input;
-        auto odds = function.PointerOffset(evens, halfN);
-        auto complexEvens = complexInput;
-        auto complexOdds = function.PointerOffset(complexEvens, halfN);
-
-        if (halfN > 1) // call recursive case if necessary
-        {
-            DoRealFFT(function, halfN, evens, scratch, complexEvens);
-            DoRealFFT(function, halfN, odds, scratch, complexOdds);
-        }
-        else // here halfN == 1
-        {
-            // Base case: copy from real to complex
-            function.FillStruct(complexEvens, { function.Load(evens), function.Literal<ValueType>(0) });
-            function.FillStruct(complexOdds, { function.Load(odds), function.Literal<ValueType>(0) });
-        }
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-        auto twiddleFactors = detail::GetTwiddleFactors<ValueType>(halfN);
-        std::vector<ValueType> twiddleFactorsUnwrapped(twiddleFactors.size() * 2);
-        ValueType* dataPtr = reinterpret_cast<ValueType*>(twiddleFactors.data());
-        std::copy(dataPtr, dataPtr + twiddleFactorsUnwrapped.size(), twiddleFactorsUnwrapped.begin());
-        auto twiddleFactorsUnwrappedVar = module.ConstantArray(std::string("twiddles_") + std::to_string(halfN), twiddleFactorsUnwrapped);
-        auto twiddleFactorsVar = function.CastPointer(twiddleFactorsUnwrappedVar, complexPtrType);
-#else
-        bool twiddleFactorsVar = false; // Just here to appease the compiler
-#endif
-
-        function.For(halfN, [&evens, &odds, &complexEvens, complexOdds, &twiddleFactorsVar](emitters::IRFunctionEmitter& function, auto k) {
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-            auto w = function.LocalScalar(function.ValueAt(twiddleFactorsVar, k));
-#else
-            // w = e^i(2*pi*k/N)
-            auto kValue = function.LocalScalar(function.CastValue<ValueType>(k));
-            auto w = detail::ImaginaryExp(function.LocalScalar(pi / halfN) * kValue);
-#endif
-
-            auto e = function.LocalScalar(function.ValueAt(evens, k));
-            auto o = function.LocalScalar(function.ValueAt(odds, k));
-            auto wo = detail::ComplexRealMultiply(w, o); // wo = w*o
-            function.SetValueAt(complexEvens, k, detail::RealComplexAdd(e, wo)); // even
-            function.SetValueAt(complexOdds, k, detail::RealComplexSubtract(e, wo)); // odd
-        });
-    }
-
-    // Real-valued fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    emitters::LLVMFunction FFTNode<ValueType>::GetRealFFTFunction(emitters::IRModuleEmitter& module, size_t length)
-    {
-        auto functionName = detail::GetRealFFTFunctionName<ValueType>(length);
-        auto existingFunction = module.GetFunction(functionName);
-        if (existingFunction != nullptr)
-        {
-            return existingFunction;
-        }
-
-        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, length);
-        {
-            auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-            auto scratch = function.LocalScalar(&(*arguments++));
-            auto complexInput = function.LocalScalar(&(*arguments++));
-
-            EmitRealFFT(function, length, input, scratch, complexInput);
-        }
-        module.EndFunction();
-        return function.GetFunction();
-    }
-
-    // Perform fixed-size FFT: size is known at compile time
-    template <typename ValueType>
-    void FFTNode<ValueType>::DoFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch)
+    void FFTNode<ValueType>::Compute() const
     {
-        const bool inlineFFT = length <= MAX_INLINE_FFT_SIZE;
-        if (inlineFFT)
-        {
-            EmitFFT(function, length, input, scratch);
-        }
-        else
+        std::vector<ValueType> signal = _input.GetValue();
+        if (_fftSize != signal.size())
         {
-            auto& module = function.GetModule();
-            auto fftFunction = GetFFTFunction(module, length);
-            function.Call(fftFunction, { input, scratch });
+            signal.resize(_fftSize);
         }
-    }
 
-    // Fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    void FFTNode<ValueType>::DoRealFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch, emitters::LLVMValue complexInput)
-    {
-        const bool inlineFFT = length <= MAX_INLINE_FFT_SIZE;
-        if (inlineFFT)
-        {
-            EmitRealFFT(function, length, input, scratch, complexInput);
-        }
-        else
-        {
-            auto& module = function.GetModule();
-            auto fftFunction = GetRealFFTFunction(module, length);
-            function.Call(fftFunction, { input, scratch, complexInput });
-        }
-    }
+        std::vector<std::complex<ValueType>> spectrum(_fftSize / 2 + 1);
+        _plan.TransformReal(signal.data(), spectrum.data());
 
-    template <typename ValueType>
-    void FFTNode<ValueType>::Compute() const
-    {
-        std::vector<ValueType> temp = _input.GetValue();
-        if (_fftSize != temp.size())
+        std::vector<ValueType> result(output.Size());
+        for (size_t index = 0; index < result.size(); ++index)
         {
-            temp.resize(_fftSize);
+            result[index] = std::abs(spectrum[index]);
         }
-        dsp::FFT(temp);
-        temp.resize(output.Size());
-        _output.SetOutput(temp);
+        _output.SetOutput(result);
     };
 
     template <typename ValueType>
@@ -664,61 +216,99 @@ namespace nodes
     template <typename ValueType>
     void FFTNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        auto& module = function.GetModule();
-        auto& emitter = module.GetIREmitter();
-        auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-        auto complexType = detail::GetComplexType(module, valueType);
+        using emitters::IRLocalScalar;
 
-        auto inputSize = input.Size();
-        auto outputSize = output.Size();
+        const int fftSize = static_cast<int>(_fftSize);
+        const int halfSize = fftSize / 2;
+        const int inputSize = std::min(static_cast<int>(input.Size()), fftSize);
 
         // Get port variables
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
-
-        // Buffer for complex data
-        emitters::LLVMValue complexBuffer = function.Variable(complexType, _fftSize);
-
-        if (inputSize > _fftSize)
+        if (halfSize == 0)
         {
-            // truncate input to _fftSize
-            inputSize = _fftSize;
+            return;
         }
 
-#if (USE_REAL_FFT)
-
-        emitters::LLVMValue scratch = function.Variable(valueType, _fftSize / 2);
-        DoRealFFT(function, _fftSize, pInput, scratch, complexBuffer);
-
-#else // Complex-input FFT
-
-        emitters::LLVMValue scratch = function.Variable(complexType, _fftSize / 2);
-        emitters::LLVMValue temp = function.Variable(complexType, "temp");
-
-        // Convert real-valued data to complex
-        function.For(inputSize, [pInput, complexBuffer, temp](emitters::IRFunctionEmitter& function, auto index) {
-            function.FillStruct(temp, { function.ValueAt(pInput, index), function.Literal<ValueType>(0) });
-            function.SetValueAt(complexBuffer, index, function.Load(temp));
-        });
-
-        if (_fftSize > inputSize)
+        // Zero-pad the input up to the FFT size
+        emitters::LLVMValue signal = pInput;
+        if (inputSize < fftSize)
         {
-            // zero-pad up to _fftSize
-            emitters::LLVMValue zero_complex = function.Variable(complexType, "zero_complex");
-            function.FillStruct(zero_complex, { function.Literal<ValueType>(0), function.Literal<ValueType>(0) });
-            function.For(inputSize, _fftSize, [zero_complex, complexBuffer](emitters::IRFunctionEmitter& function, auto index) {
-                function.SetValueAt(complexBuffer, index, function.Load(zero_complex));
+            auto valueType = function.GetEmitter().Type(emitters::GetVariableType<ValueType>());
+            signal = function.Variable(valueType, fftSize);
+            function.For(inputSize, [pInput, signal](emitters::IRFunctionEmitter& function, IRLocalScalar index) {
+                function.SetValueAt(signal, index, function.ValueAt(pInput, index));
+            });
+            function.For(inputSize, fftSize, [signal](emitters::IRFunctionEmitter& function, IRLocalScalar index) {
+                function.SetValueAt(signal, index, function.Literal<ValueType>(0));
             });
         }
 
-        DoFFT(function, _fftSize, complexBuffer, scratch);
+        EmitFFTMagnitudes(compiler, function, *this, _plan, signal, pOutput);
+    }
 
-#endif // USE_REAL_FFT
+    template <typename ValueType>
+    void EmitFFTMagnitudes(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<ValueType>& plan, emitters::LLVMValue signal, emitters::LLVMValue magnitudes)
+    {
+        using emitters::IRLocalScalar;
+
+        const int halfSize = static_cast<int>(plan.Size() / 2);
+        if (halfSize == 0)
+        {
+            return;
+        }
+
+        emitters::LLVMValue twiddles;
+        auto complexBuffer = detail::EmitPackedRealFFT(compiler, function, node, plan, signal, twiddles);
+
+        // Separate the transforms of the evens (E) and odds (O) and combine them into the magnitudes of the spectrum:
+        //   X[k] = E[k] + w^k * O[k], and |X[N/2-k]| = |E[k] - w^k * O[k]|
+        auto z0 = detail::LoadComplex(function, complexBuffer, function.LocalScalar(0));
+        function.SetValueAt(magnitudes, function.Literal<int>(0), emitters::Abs(z0.re + z0.im));
+        function.For(1, halfSize / 2 + 1, [complexBuffer, twiddles, magnitudes, halfSize](emitters::IRFunctionEmitter& function, IRLocalScalar k) {
+            auto mirrorIndex = function.LocalScalar(halfSize) - k;
+            auto zk = detail::LoadComplex(function, complexBuffer, k);
+            auto zMirror = detail::LoadComplex(function, complexBuffer, mirrorIndex);
+            detail::ComplexValue e = { (zk.re + zMirror.re) * ValueType{ 0.5 }, (zk.im - zMirror.im) * ValueType{ 0.5 } };
+            detail::ComplexValue o = { (zk.im + zMirror.im) * ValueType{ 0.5 }, (zMirror.re - zk.re) * ValueType{ 0.5 } };
+            auto wo = detail::LoadComplex(function, twiddles, k) * o;
+            function.SetValueAt(magnitudes, k, detail::Abs(e + wo));
+            function.SetValueAt(magnitudes, mirrorIndex, detail::Abs(e - wo));
+        });
+    }
 
-        function.For(outputSize, [pOutput, complexBuffer](emitters::IRFunctionEmitter& function, auto index) {
-            auto complexValue = function.LocalScalar(function.ValueAt(complexBuffer, index));
-            auto absValue = detail::ComplexAbs(complexValue);
-            function.SetValueAt(pOutput, index, absValue);
+    template <typename ValueType>
+    void EmitRealFFT(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<ValueType>& plan, emitters::LLVMValue signal, emitters::LLVMValue spectrum)
+    {
+        using emitters::IRLocalScalar;
+
+        const int halfSize = static_cast<int>(plan.Size() / 2);
+        if (halfSize == 0)
+        {
+            function.SetValueAt(spectrum, function.Literal<int>(0), function.ValueAt(signal, function.Literal<int>(0)));
+            function.SetValueAt(spectrum, function.Literal<int>(1), function.Literal<ValueType>(0));
+            return;
+        }
+
+        emitters::LLVMValue twiddles;
+        auto complexBuffer = detail::EmitPackedRealFFT(compiler, function, node, plan, signal, twiddles);
+
+        // Separate the transforms of the evens (E) and odds (O) and combine them: X[k] = E[k] + w^k * O[k], and
+        // X[N/2-k] = conj(E[k] - w^k * O[k])
+        auto zero = function.LocalScalar(0);
+        auto z0 = detail::LoadComplex(function, complexBuffer, zero);
+        detail::StoreComplex(function, spectrum, zero, { z0.re + z0.im, function.LocalScalar(ValueType{ 0 }) });
+        detail::StoreComplex(function, spectrum, function.LocalScalar(halfSize), { z0.re - z0.im, function.LocalScalar(ValueType{ 0 }) });
+        function.For(1, halfSize / 2 + 1, [complexBuffer, twiddles, spectrum, halfSize](emitters::IRFunctionEmitter& function, IRLocalScalar k) {
+            auto mirrorIndex = function.LocalScalar(halfSize) - k;
+            auto zk = detail::LoadComplex(function, complexBuffer, k);
+            auto zMirror = detail::LoadComplex(function, complexBuffer, mirrorIndex);
+            detail::ComplexValue e = { (zk.re + zMirror.re) * ValueType{ 0.5 }, (zk.im - zMirror.im) * ValueType{ 0.5 } };
+            detail::ComplexValue o = { (zk.im + zMirror.im) * ValueType{ 0.5 }, (zMirror.re - zk.re) * ValueType{ 0.5 } };
+            auto wo = detail::LoadComplex(function, twiddles, k) * o;
+            auto mirror = e - wo;
+            detail::StoreComplex(function, spectrum, k, e + wo);
+            detail::StoreComplex(function, spectrum, mirrorIndex, { mirror.re, -mirror.im });
         });
     }
 
@@ -747,10 +337,15 @@ namespace nodes
             _fftSize = _input.Size();
         }
         _output.SetSize(_fftSize / 2);
+        _plan = dsp::FFTPlan<ValueType>(_fftSize);
     }
 
     // Explicit instantiations
     template class FFTNode<float>;
     template class FFTNode<double>;
+    template void EmitFFTMagnitudes<float>(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<float>& plan, emitters::LLVMValue signal, emitters::LLVMValue magnitudes);
+    template void EmitFFTMagnitudes<double>(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<double>& plan, emitters::LLVMValue signal, emitters::LLVMValue magnitudes);
+    template void EmitRealFFT<float>(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<float>& plan, emitters::LLVMValue signal, emitters::LLVMValue spectrum);
+    template void EmitRealFFT<double>(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::FFTPlan<double>& plan, emitters::LLVMValue signal, emitters::LLVMValue spectrum);
 } // namespace nodes
 } // namespace ell
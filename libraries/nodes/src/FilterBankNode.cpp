@@ -48,64 +48,54 @@ namespace nodes
     template <typename ValueType>
     void FilterBankNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        using namespace std::string_literals;
+        // Get port variables
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        EmitFilterBank<ValueType>(compiler, function, *this, _filters, pInput, pOutput);
+    }
 
+    template <typename ValueType>
+    void EmitFilterBank(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::TriangleFilterBank& filters, emitters::LLVMValue input, emitters::LLVMValue output)
+    {
         auto& module = function.GetModule();
-        auto numFilters = output.Size();
+        const int numFilters = static_cast<int>(filters.NumActiveFilters());
 
-        // Write out global variables with bin info
-        std::vector<int> startBins;
-        std::vector<int> centerBins;
-        std::vector<int> endBins;
-        for (size_t filterIndex = _filters.GetBeginFilter(); filterIndex < _filters.GetEndFilter(); ++filterIndex)
-        {
-            auto f = _filters.GetFilter(filterIndex);
-            startBins.push_back(f.GetStart());
-            centerBins.push_back(f.GetCenter());
-            endBins.push_back(f.GetEnd());
-        }
-        if (numFilters != startBins.size())
+        // The filters' coefficients, packed to their nonzero support
+        const auto& coefficients = filters.GetPackedCoefficients();
+        if (numFilters + 1 != static_cast<int>(coefficients.offsets.size()))
         {
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input sizes must match");
         }
-        auto beginVar = module.ConstantArray("filterStart_"s + GetInternalStateIdentifier(), startBins);
-        auto centerVar = module.ConstantArray("filterCenter_"s + GetInternalStateIdentifier(), centerBins);
-        auto endVar = module.ConstantArray("filterEnd_"s + GetInternalStateIdentifier(), endBins);
 
-        auto offset = function.LocalScalar<ValueType>(_filters.GetOffset());
-        
-        // Get port variables
-        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
-        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        if (coefficients.values.empty())
+        {
+            function.For(numFilters, [output](emitters::IRFunctionEmitter& function, emitters::LLVMValue filterIndex) {
+                function.SetValueAt(output, filterIndex, function.Literal<ValueType>(0));
+            });
+            return;
+        }
 
-        function.For(numFilters, [pInput, pOutput, offset, beginVar, centerVar, endVar](emitters::IRFunctionEmitter& function, auto filterIndex) {
-            auto sum = function.Variable(emitters::GetVariableType<ValueType>());
-            auto begin = function.LocalScalar(function.ValueAt(beginVar, filterIndex));
-            auto center = function.LocalScalar(function.ValueAt(centerVar, filterIndex));
-            auto end = function.LocalScalar(function.ValueAt(endVar, filterIndex));
+        std::vector<ValueType> values(coefficients.values.begin(), coefficients.values.end());
+        auto pOffsets = module.ConstantArray(compiler.GetGlobalName(node, "filterOffsets"), coefficients.offsets);
+        auto pStartBins = module.ConstantArray(compiler.GetGlobalName(node, "filterStart"), coefficients.startBins);
+        auto pValues = module.ConstantArray(compiler.GetGlobalName(node, "filterCoefficients"), values);
+
+        auto sum = function.Variable(emitters::GetVariableType<ValueType>(), "sum");
+        function.For(numFilters, [input, output, pOffsets, pStartBins, pValues, sum](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto filterIndex = function.LocalScalar(i);
+            auto begin = function.LocalScalar(function.ValueAt(pOffsets, filterIndex));
+            auto end = function.LocalScalar(function.ValueAt(pOffsets, filterIndex + 1));
+            auto binOffset = function.LocalScalar(function.ValueAt(pStartBins, filterIndex)) - begin;
             function.StoreZero(sum);
 
-            // for index in [begin, center)
-            function.For(begin, center, [pInput, offset, sum, begin, center](emitters::IRFunctionEmitter& function, auto index) {
-                // sum += signal[i] * ((i-begin+0.5) / (center-begin))
-                auto inputVal = function.LocalScalar(function.ValueAt(pInput, index));
-                auto numer = index - begin;
-                auto denom = center - begin;
-                auto val = inputVal * ((function.LocalScalar(function.CastValue<ValueType>(numer)) + offset) / function.LocalScalar(function.CastValue<ValueType>(denom)));
-                function.Store(sum, function.LocalScalar(function.Load(sum)) + val);
-            });
-
-            // for index in [center, end)
-            function.For(center, end, [pInput, offset, sum, center, end](emitters::IRFunctionEmitter& function, auto index) {
-                // sum += signal[i] * ((end-i-0.5) / (end-center))
-                auto inputVal = function.LocalScalar(function.ValueAt(pInput, index));
-                auto numer = end - index;
-                auto denom = end - center;
-                auto val = inputVal * ((function.LocalScalar(function.CastValue<ValueType>(numer)) - offset) / function.LocalScalar(function.CastValue<ValueType>(denom)));
-                function.Store(sum, function.LocalScalar(function.Load(sum)) + val);
+            // sum += signal[startBin + (index - begin)] * coefficient[index] for index in [begin, end)
+            function.For(begin, end, [input, pValues, sum, binOffset](emitters::IRFunctionEmitter& function, auto index) {
+                auto coefficient = function.LocalScalar(function.ValueAt(pValues, index));
+                auto inputVal = function.LocalScalar(function.ValueAt(input, index + binOffset));
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + coefficient * inputVal);
             });
 
-            function.SetValueAt(pOutput, filterIndex, function.Load(sum));
+            function.SetValueAt(output, filterIndex, function.Load(sum));
         });
     }
 
@@ -210,5 +200,7 @@ namespace nodes
     template class LinearFilterBankNode<double>;
     template class MelFilterBankNode<float>;
     template class MelFilterBankNode<double>;
+    template void EmitFilterBank<float>(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::TriangleFilterBank& filters, emitters::LLVMValue input, emitters::LLVMValue output);
+    template void EmitFilterBank<double>(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, const model::Node& node, const dsp::TriangleFilterBank& filters, emitters::LLVMValue input, emitters::LLVMValue output);
 } // namespace nodes
 } // namespace ell
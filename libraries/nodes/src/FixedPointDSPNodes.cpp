@@ -0,0 +1,827 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FixedPointDSPNodes.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FixedPointDSPNodes.h"
+
+#include <emitters/include/IRLocalScalar.h>
+
+#include <dsp/include/DCT.h>
+#include <dsp/include/IIRFilter.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace nodes
+{
+    using emitters::IRLocalScalar;
+    using emitters::TypedOperator;
+
+    namespace
+    {
+        // Emits `value >> shift`, an arithmetic shift
+        template <typename IntType>
+        IRLocalScalar EmitShiftRight(emitters::IRFunctionEmitter& function, IRLocalScalar value, int shift)
+        {
+            return function.LocalScalar(function.Operator(TypedOperator::arithmeticShiftRight, value, function.Literal<IntType>(static_cast<IntType>(shift))));
+        }
+
+        // Emits `dsp::RoundingShiftRight(value, shift)`
+        template <typename IntType>
+        IRLocalScalar EmitRoundingShiftRight(emitters::IRFunctionEmitter& function, IRLocalScalar value, int shift)
+        {
+            if (shift <= 0)
+            {
+                return value;
+            }
+            return EmitShiftRight<IntType>(function, value + (static_cast<IntType>(1) << (shift - 1)), shift);
+        }
+
+        // Emits `dsp::SaturateQ15(value)`, as a 32-bit value
+        template <typename IntType>
+        IRLocalScalar EmitSaturateQ15(emitters::IRFunctionEmitter& function, IRLocalScalar value)
+        {
+            auto minValue = function.LocalScalar<IntType>(dsp::q15Min);
+            auto maxValue = function.LocalScalar<IntType>(dsp::q15Max);
+            auto clamped = function.LocalScalar(function.Select(value < minValue, minValue, value));
+            clamped = function.LocalScalar(function.Select(clamped > maxValue, maxValue, clamped));
+            return function.LocalScalar(function.CastValue<int>(clamped));
+        }
+
+        // Emits the 64-bit product of two Q15 values. Their product fits in 32 bits, so the multiplication is done in 32 bits.
+        IRLocalScalar EmitWideProduct(emitters::IRFunctionEmitter& function, IRLocalScalar a, IRLocalScalar b)
+        {
+            return function.LocalScalar(function.CastValue<int64_t>(a * b));
+        }
+
+        // Returns the Q15 value of each coefficient
+        std::vector<int> ToQ15(const std::vector<double>& values)
+        {
+            std::vector<int> result;
+            result.reserve(values.size());
+            for (auto value : values)
+            {
+                result.push_back(dsp::ToQ15(value));
+            }
+            return result;
+        }
+
+        void ThrowIfNegativeShift(int outputShift)
+        {
+            if (outputShift < 0 || outputShift > 31)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Output shift must be in [0, 31]");
+            }
+        }
+    } // namespace
+
+    //
+    // ToFixedPointNode
+    //
+    template <typename ValueType>
+    ToFixedPointNode<ValueType>::ToFixedPointNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    ToFixedPointNode<ValueType>::ToFixedPointNode(const model::OutputPort<ValueType>& input, double scale) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, input.Size()),
+        _scale(scale)
+    {
+        if (!(scale > 0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "ToFixedPointNode: scale must be positive");
+        }
+    }
+
+    template <typename ValueType>
+    void ToFixedPointNode<ValueType>::Compute() const
+    {
+        std::vector<int> result(_input.Size());
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            result[i] = dsp::ToQ15(static_cast<double>(_input[i]) / _scale);
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void ToFixedPointNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        const auto factor = static_cast<ValueType>(std::ldexp(1.0, dsp::q15FractionalBits) / _scale);
+
+        function.For(static_cast<int>(_input.Size()), [pInput, pOutput, factor](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            auto scaledValue = function.LocalScalar(function.ValueAt(pInput, i)) * factor;
+            auto minValue = function.LocalScalar<ValueType>(dsp::q15Min);
+            auto maxValue = function.LocalScalar<ValueType>(dsp::q15Max);
+            auto clampedValue = function.LocalScalar(function.Select(scaledValue < minValue, minValue, scaledValue));
+            clampedValue = function.LocalScalar(function.Select(clampedValue > maxValue, maxValue, clampedValue));
+            auto roundedValue = function.Select(clampedValue >= static_cast<ValueType>(0), clampedValue + static_cast<ValueType>(0.5), clampedValue - static_cast<ValueType>(0.5));
+            function.SetValueAt(pOutput, i, function.CastValue<int>(roundedValue));
+        });
+    }
+
+    template <typename ValueType>
+    void ToFixedPointNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<ToFixedPointNode<ValueType>>(newInput, _scale);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void ToFixedPointNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["scale"] << _scale;
+    }
+
+    template <typename ValueType>
+    void ToFixedPointNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["scale"] >> _scale;
+        _output.SetSize(_input.Size());
+    }
+
+    //
+    // FromFixedPointNode
+    //
+    template <typename ValueType>
+    FromFixedPointNode<ValueType>::FromFixedPointNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    FromFixedPointNode<ValueType>::FromFixedPointNode(const model::OutputPort<int>& input, double scale) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, input.Size()),
+        _scale(scale)
+    {
+    }
+
+    template <typename ValueType>
+    void FromFixedPointNode<ValueType>::Compute() const
+    {
+        std::vector<ValueType> result(_input.Size());
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            result[i] = static_cast<ValueType>(dsp::FromQ15(_input[i]) * _scale);
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void FromFixedPointNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        const auto factor = static_cast<ValueType>(std::ldexp(_scale, -dsp::q15FractionalBits));
+
+        function.For(static_cast<int>(_input.Size()), [pInput, pOutput, factor](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            auto value = function.LocalScalar(function.CastValue<ValueType>(function.ValueAt(pInput, i)));
+            function.SetValueAt(pOutput, i, value * factor);
+        });
+    }
+
+    template <typename ValueType>
+    void FromFixedPointNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<FromFixedPointNode<ValueType>>(newInput, _scale);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void FromFixedPointNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["scale"] << _scale;
+    }
+
+    template <typename ValueType>
+    void FromFixedPointNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["scale"] >> _scale;
+        _output.SetSize(_input.Size());
+    }
+
+    //
+    // FixedPointWindowNode
+    //
+    FixedPointWindowNode::FixedPointWindowNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    FixedPointWindowNode::FixedPointWindowNode(const model::OutputPort<int>& input, const std::vector<int>& window) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, input.Size()),
+        _window(window)
+    {
+        if (window.size() != input.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "FixedPointWindowNode: window size must match the input size");
+        }
+    }
+
+    void FixedPointWindowNode::Compute() const
+    {
+        std::vector<int> result(_input.Size());
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            result[i] = dsp::MultiplyQ15(_input[i], _window[i]);
+        }
+        _output.SetOutput(result);
+    }
+
+    void FixedPointWindowNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        auto pWindow = function.GetModule().ConstantArray(compiler.GetGlobalName(*this, "window"), _window);
+
+        function.For(static_cast<int>(_input.Size()), [pInput, pOutput, pWindow](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            auto product = function.LocalScalar(function.ValueAt(pInput, i)) * function.LocalScalar(function.ValueAt(pWindow, i));
+            function.SetValueAt(pOutput, i, EmitSaturateQ15<int>(function, EmitRoundingShiftRight<int>(function, product, dsp::q15FractionalBits)));
+        });
+    }
+
+    void FixedPointWindowNode::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<FixedPointWindowNode>(newInput, _window);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    void FixedPointWindowNode::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["window"] << _window;
+    }
+
+    void FixedPointWindowNode::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["window"] >> _window;
+        _output.SetSize(_input.Size());
+    }
+
+    //
+    // FixedPointFFTNode
+    //
+    FixedPointFFTNode::FixedPointFFTNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    FixedPointFFTNode::FixedPointFFTNode(const model::OutputPort<int>& input, size_t fftSize) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, fftSize / 2),
+        _plan(fftSize)
+    {
+        if (input.Size() > fftSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FixedPointFFTNode: input size must not be larger than the FFT size");
+        }
+    }
+
+    void FixedPointFFTNode::Compute() const
+    {
+        auto signal = _input.GetValue();
+        std::vector<int> result(_plan.Size() / 2);
+        _plan.TransformMagnitudes(signal.data(), signal.size(), result.data());
+        _output.SetOutput(result);
+    }
+
+    void FixedPointFFTNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        // This emits exactly what `dsp::FixedPointFFTPlan::TransformMagnitudes` does
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        const int fftSize = static_cast<int>(_plan.Size());
+        auto& module = function.GetModule();
+        auto pCosines = module.ConstantArray(compiler.GetGlobalName(*this, "cosines"), _plan.GetCosines());
+        auto pSines = module.ConstantArray(compiler.GetGlobalName(*this, "sines"), _plan.GetSines());
+        auto pBitReversal = module.ConstantArray(compiler.GetGlobalName(*this, "bitReversal"), _plan.GetBitReversalPermutation());
+
+        auto re = function.Variable(emitters::VariableType::Int32, fftSize);
+        auto im = function.Variable(emitters::VariableType::Int32, fftSize);
+        function.For(fftSize, [re, im](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            function.SetValueAt(re, i, function.Literal<int>(0));
+            function.SetValueAt(im, i, function.Literal<int>(0));
+        });
+        function.For(static_cast<int>(_input.Size()), [pInput, pBitReversal, re](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            auto value = EmitSaturateQ15<int>(function, function.LocalScalar(function.ValueAt(pInput, i)));
+            function.SetValueAt(re, function.ValueAt(pBitReversal, i), value);
+        });
+
+        for (int half = 1; half < fftSize; half *= 2)
+        {
+            const int twiddleStride = fftSize / (2 * half);
+            function.For(fftSize / 2, [=](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+                auto k = i & function.LocalScalar<int>(half - 1);
+                auto top = (i - k) * 2 + k;
+                auto bottom = top + half;
+                auto c = function.LocalScalar(function.ValueAt(pCosines, k * twiddleStride));
+                auto s = function.LocalScalar(function.ValueAt(pSines, k * twiddleStride));
+                auto bRe = function.LocalScalar(function.ValueAt(re, bottom));
+                auto bIm = function.LocalScalar(function.ValueAt(im, bottom));
+                auto aRe = function.LocalScalar(function.ValueAt(re, top));
+                auto aIm = function.LocalScalar(function.ValueAt(im, top));
+                auto tRe = EmitRoundingShiftRight<int>(function, bRe * c + bIm * s, dsp::q15FractionalBits);
+                auto tIm = EmitRoundingShiftRight<int>(function, bIm * c - bRe * s, dsp::q15FractionalBits);
+                function.SetValueAt(re, top, EmitRoundingShiftRight<int>(function, aRe + tRe, 1));
+                function.SetValueAt(im, top, EmitRoundingShiftRight<int>(function, aIm + tIm, 1));
+                function.SetValueAt(re, bottom, EmitRoundingShiftRight<int>(function, aRe - tRe, 1));
+                function.SetValueAt(im, bottom, EmitRoundingShiftRight<int>(function, aIm - tIm, 1));
+            });
+        }
+
+        function.For(fftSize / 2, [re, im, pOutput](emitters::IRFunctionEmitter& function, IRLocalScalar k) {
+            auto minValue = function.LocalScalar<int>(-dsp::q15Max);
+            auto x = EmitSaturateQ15<int>(function, function.LocalScalar(function.ValueAt(re, k)));
+            auto y = EmitSaturateQ15<int>(function, function.LocalScalar(function.ValueAt(im, k)));
+            x = function.LocalScalar(function.Select(x < minValue, minValue, x));
+            y = function.LocalScalar(function.Select(y < minValue, minValue, y));
+
+            // The integer square root, as `dsp::IntegerSquareRoot`, unrolled
+            auto value = x * x + y * y;
+            auto result = function.LocalScalar<int>(0);
+            for (int bitIndex = 0; bitIndex < 16; ++bitIndex)
+            {
+                const int bit = 1 << (30 - 2 * bitIndex);
+                auto candidate = result + bit;
+                auto isBitSet = value >= candidate;
+                value = function.LocalScalar(function.Select(isBitSet, value - candidate, value));
+                result = function.LocalScalar(function.Select(isBitSet, EmitShiftRight<int>(function, result, 1) + bit, EmitShiftRight<int>(function, result, 1)));
+            }
+            function.SetValueAt(pOutput, k, EmitSaturateQ15<int>(function, result));
+        });
+    }
+
+    void FixedPointFFTNode::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<FixedPointFFTNode>(newInput, _plan.Size());
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    void FixedPointFFTNode::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["fftSize"] << _plan.Size();
+    }
+
+    void FixedPointFFTNode::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        size_t fftSize = 0;
+        archiver["fftSize"] >> fftSize;
+        _plan = dsp::FixedPointFFTPlan(fftSize);
+        _output.SetSize(fftSize / 2);
+    }
+
+    //
+    // FixedPointFilterBankNode
+    //
+    FixedPointFilterBankNode::FixedPointFilterBankNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    FixedPointFilterBankNode::FixedPointFilterBankNode(const model::OutputPort<int>& input, const dsp::TriangleFilterBank& filters, int outputShift) :
+        FixedPointFilterBankNode(input, filters.GetPackedCoefficients().offsets, filters.GetPackedCoefficients().startBins, ToQ15(filters.GetPackedCoefficients().values), outputShift)
+    {
+    }
+
+    FixedPointFilterBankNode::FixedPointFilterBankNode(const model::OutputPort<int>& input, const std::vector<int>& offsets, const std::vector<int>& startBins, const std::vector<int>& coefficients, int outputShift) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, offsets.empty() ? 0 : offsets.size() - 1),
+        _offsets(offsets),
+        _startBins(startBins),
+        _coefficients(coefficients),
+        _outputShift(outputShift)
+    {
+        ThrowIfNegativeShift(outputShift);
+        if (offsets.empty() || startBins.size() + 1 != offsets.size() || static_cast<size_t>(offsets.back()) != coefficients.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "FixedPointFilterBankNode: wrong number of offsets or coefficients");
+        }
+    }
+
+    double FixedPointFilterBankNode::GetMaxGain(const dsp::TriangleFilterBank& filters)
+    {
+        const auto& packed = filters.GetPackedCoefficients();
+        double result = 0;
+        for (size_t filterIndex = 0; filterIndex + 1 < packed.offsets.size(); ++filterIndex)
+        {
+            double sum = 0;
+            for (int index = packed.offsets[filterIndex]; index < packed.offsets[filterIndex + 1]; ++index)
+            {
+                sum += std::abs(packed.values[index]);
+            }
+            result = std::max(result, sum);
+        }
+        return result;
+    }
+
+    void FixedPointFilterBankNode::Compute() const
+    {
+        std::vector<int> result(_offsets.size() - 1);
+        for (size_t filterIndex = 0; filterIndex < result.size(); ++filterIndex)
+        {
+            int64_t sum = 0;
+            for (int index = _offsets[filterIndex]; index < _offsets[filterIndex + 1]; ++index)
+            {
+                sum += static_cast<int64_t>(_coefficients[index]) * _input[_startBins[filterIndex] + (index - _offsets[filterIndex])];
+            }
+            result[filterIndex] = dsp::SaturateQ15(dsp::RoundingShiftRight(sum, dsp::q15FractionalBits + _outputShift));
+        }
+        _output.SetOutput(result);
+    }
+
+    void FixedPointFilterBankNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        const int numFilters = static_cast<int>(_offsets.size() - 1);
+        const int shift = dsp::q15FractionalBits + _outputShift;
+
+        if (_coefficients.empty())
+        {
+            function.For(numFilters, [pOutput](emitters::IRFunctionEmitter& function, IRLocalScalar filterIndex) {
+                function.SetValueAt(pOutput, filterIndex, function.Literal<int>(0));
+            });
+            return;
+        }
+
+        auto& module = function.GetModule();
+        auto pOffsets = module.ConstantArray(compiler.GetGlobalName(*this, "filterOffsets"), _offsets);
+        auto pStartBins = module.ConstantArray(compiler.GetGlobalName(*this, "filterStart"), _startBins);
+        auto pValues = module.ConstantArray(compiler.GetGlobalName(*this, "filterCoefficients"), _coefficients);
+
+        auto sum = function.Variable(emitters::VariableType::Int64, "sum");
+        function.For(numFilters, [pInput, pOutput, pOffsets, pStartBins, pValues, sum, shift](emitters::IRFunctionEmitter& function, IRLocalScalar filterIndex) {
+            auto begin = function.LocalScalar(function.ValueAt(pOffsets, filterIndex));
+            auto end = function.LocalScalar(function.ValueAt(pOffsets, filterIndex + 1));
+            auto binOffset = function.LocalScalar(function.ValueAt(pStartBins, filterIndex)) - begin;
+            function.StoreZero(sum);
+
+            function.For(begin, end, [pInput, pValues, sum, binOffset](emitters::IRFunctionEmitter& function, auto index) {
+                auto coefficient = function.LocalScalar(function.ValueAt(pValues, index));
+                auto inputValue = function.LocalScalar(function.ValueAt(pInput, index + binOffset));
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + EmitWideProduct(function, coefficient, inputValue));
+            });
+
+            auto result = EmitRoundingShiftRight<int64_t>(function, function.LocalScalar(function.Load(sum)), shift);
+            function.SetValueAt(pOutput, filterIndex, EmitSaturateQ15<int64_t>(function, result));
+        });
+    }
+
+    void FixedPointFilterBankNode::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<FixedPointFilterBankNode>(newInput, _offsets, _startBins, _coefficients, _outputShift);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    void FixedPointFilterBankNode::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["offsets"] << _offsets;
+        archiver["startBins"] << _startBins;
+        archiver["coefficients"] << _coefficients;
+        archiver["outputShift"] << _outputShift;
+    }
+
+    void FixedPointFilterBankNode::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["offsets"] >> _offsets;
+        archiver["startBins"] >> _startBins;
+        archiver["coefficients"] >> _coefficients;
+        archiver["outputShift"] >> _outputShift;
+        _output.SetSize(_offsets.empty() ? 0 : _offsets.size() - 1);
+    }
+
+    //
+    // FixedPointDCTNode
+    //
+    FixedPointDCTNode::FixedPointDCTNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    FixedPointDCTNode::FixedPointDCTNode(const model::OutputPort<int>& input, size_t numFilters, int outputShift) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, numFilters),
+        _outputShift(outputShift)
+    {
+        ThrowIfNegativeShift(outputShift);
+        Initialize(numFilters);
+    }
+
+    void FixedPointDCTNode::Initialize(size_t numFilters)
+    {
+        const auto inputSize = _input.Size();
+        auto dctMatrix = dsp::GetDCTMatrix<double>(inputSize, numFilters);
+        _numFilters = numFilters;
+        _coefficients.clear();
+        _coefficients.reserve(numFilters * inputSize);
+        for (size_t k = 0; k < numFilters; ++k)
+        {
+            for (size_t n = 0; n < inputSize; ++n)
+            {
+                _coefficients.push_back(dsp::ToQ15(dctMatrix(k, n)));
+            }
+        }
+    }
+
+    void FixedPointDCTNode::Compute() const
+    {
+        const auto inputSize = _input.Size();
+        std::vector<int> result(_numFilters);
+        for (size_t k = 0; k < _numFilters; ++k)
+        {
+            int64_t sum = 0;
+            for (size_t n = 0; n < inputSize; ++n)
+            {
+                sum += static_cast<int64_t>(_coefficients[k * inputSize + n]) * _input[n];
+            }
+            result[k] = dsp::SaturateQ15(dsp::RoundingShiftRight(sum, dsp::q15FractionalBits + _outputShift));
+        }
+        _output.SetOutput(result);
+    }
+
+    void FixedPointDCTNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        const int inputSize = static_cast<int>(_input.Size());
+        const int shift = dsp::q15FractionalBits + _outputShift;
+        auto pCoefficients = function.GetModule().ConstantArray(compiler.GetGlobalName(*this, "dctCoefficients"), _coefficients);
+
+        auto sum = function.Variable(emitters::VariableType::Int64, "sum");
+        function.For(static_cast<int>(_numFilters), [pInput, pOutput, pCoefficients, sum, inputSize, shift](emitters::IRFunctionEmitter& function, IRLocalScalar k) {
+            function.StoreZero(sum);
+            function.For(inputSize, [pInput, pCoefficients, sum, inputSize, k](emitters::IRFunctionEmitter& function, IRLocalScalar n) {
+                auto coefficient = function.LocalScalar(function.ValueAt(pCoefficients, k * inputSize + n));
+                auto inputValue = function.LocalScalar(function.ValueAt(pInput, n));
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + EmitWideProduct(function, coefficient, inputValue));
+            });
+            auto result = EmitRoundingShiftRight<int64_t>(function, function.LocalScalar(function.Load(sum)), shift);
+            function.SetValueAt(pOutput, k, EmitSaturateQ15<int64_t>(function, result));
+        });
+    }
+
+    void FixedPointDCTNode::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<FixedPointDCTNode>(newInput, _numFilters, _outputShift);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    void FixedPointDCTNode::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["numFilters"] << _numFilters;
+        archiver["outputShift"] << _outputShift;
+    }
+
+    void FixedPointDCTNode::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        size_t numFilters = 0;
+        archiver["numFilters"] >> numFilters;
+        archiver["outputShift"] >> _outputShift;
+        Initialize(numFilters);
+        _output.SetSize(numFilters);
+    }
+
+    //
+    // FixedPointIIRFilterNode
+    //
+    FixedPointIIRFilterNode::FixedPointIIRFilterNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    FixedPointIIRFilterNode::FixedPointIIRFilterNode(const model::OutputPort<int>& input, const std::vector<double>& b, const std::vector<double>& a, int outputShift) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, input.Size()),
+        _originalB(b),
+        _originalA(a),
+        _outputShift(outputShift)
+    {
+        ThrowIfNegativeShift(outputShift);
+        Initialize();
+    }
+
+    void FixedPointIIRFilterNode::Initialize()
+    {
+        // Divide the feedforward coefficients by 2^outputShift, and use as many fractional bits as fit the largest coefficient in 16 bits
+        std::vector<double> b;
+        for (auto value : _originalB)
+        {
+            b.push_back(std::ldexp(value, -_outputShift));
+        }
+        double maxCoefficient = 0;
+        for (auto value : b)
+        {
+            maxCoefficient = std::max(maxCoefficient, std::abs(value));
+        }
+        for (auto value : _originalA)
+        {
+            maxCoefficient = std::max(maxCoefficient, std::abs(value));
+        }
+        _coefficientBits = dsp::q15FractionalBits - std::min(dsp::GetHeadroomShift(maxCoefficient), dsp::q15FractionalBits);
+
+        auto quantize = [this](double value) { return dsp::SaturateQ15(static_cast<int64_t>(std::round(std::ldexp(value, _coefficientBits)))); };
+        _b.clear();
+        _a.clear();
+        std::transform(b.begin(), b.end(), std::back_inserter(_b), quantize);
+        std::transform(_originalA.begin(), _originalA.end(), std::back_inserter(_a), quantize);
+        _previousInput.assign(_b.size(), 0);
+        _previousOutput.assign(_a.size(), 0);
+    }
+
+    double FixedPointIIRFilterNode::GetMaxGain(const std::vector<double>& b, const std::vector<double>& a)
+    {
+        // The sum of the magnitudes of the impulse response bounds the output for an input bounded by 1
+        dsp::IIRFilter<double> filter(b, a);
+        double result = 0;
+        for (int index = 0; index < 4096; ++index)
+        {
+            result += std::abs(filter.FilterSample(index == 0 ? 1.0 : 0.0));
+        }
+        return result;
+    }
+
+    void FixedPointIIRFilterNode::Compute() const
+    {
+        std::vector<int> result(_input.Size());
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            if (!_previousInput.empty())
+            {
+                std::copy_backward(_previousInput.begin(), _previousInput.end() - 1, _previousInput.end());
+                _previousInput[0] = dsp::SaturateQ15(_input[i]);
+            }
+
+            int64_t sum = 0;
+            for (size_t j = 0; j < _b.size(); ++j)
+            {
+                sum += static_cast<int64_t>(_b[j]) * _previousInput[j];
+            }
+            for (size_t j = 0; j < _a.size(); ++j)
+            {
+                sum -= static_cast<int64_t>(_a[j]) * _previousOutput[j];
+            }
+            auto y = dsp::SaturateQ15(dsp::RoundingShiftRight(sum, _coefficientBits));
+
+            if (!_previousOutput.empty())
+            {
+                std::copy_backward(_previousOutput.begin(), _previousOutput.end() - 1, _previousOutput.end());
+                _previousOutput[0] = y;
+            }
+            result[i] = y;
+        }
+        _output.SetOutput(result);
+    }
+
+    void FixedPointIIRFilterNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        auto& module = function.GetModule();
+        const int bSize = static_cast<int>(_b.size());
+        const int aSize = static_cast<int>(_a.size());
+        const int coefficientBits = _coefficientBits;
+
+        // Past inputs and outputs, most recent first, are kept in global shift registers
+        emitters::LLVMValue previousInput = bSize > 0 ? module.GlobalArray("prevInput_"s + GetInternalStateIdentifier(), std::vector<int>(bSize, 0)) : nullptr;
+        emitters::LLVMValue previousOutput = aSize > 0 ? module.GlobalArray("prevOutput_"s + GetInternalStateIdentifier(), std::vector<int>(aSize, 0)) : nullptr;
+        emitters::LLVMValue bCoefficients = bSize > 0 ? module.ConstantArray("bCoeffs_"s + GetInternalStateIdentifier(), _b) : nullptr;
+        emitters::LLVMValue aCoefficients = aSize > 0 ? module.ConstantArray("aCoeffs_"s + GetInternalStateIdentifier(), _a) : nullptr;
+
+        auto emitShift = [](emitters::IRFunctionEmitter& function, emitters::LLVMValue registers, int size, IRLocalScalar newValue) {
+            function.For(size - 1, [registers, size](emitters::IRFunctionEmitter& function, IRLocalScalar j) {
+                auto index = function.LocalScalar(size - 1) - j;
+                function.SetValueAt(registers, index, function.ValueAt(registers, index - 1));
+            });
+            function.SetValueAt(registers, function.Literal<int>(0), newValue);
+        };
+
+        auto sum = function.Variable(emitters::VariableType::Int64, "sum");
+        function.For(static_cast<int>(_input.Size()), [=](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            function.StoreZero(sum);
+            if (bSize > 0)
+            {
+                emitShift(function, previousInput, bSize, EmitSaturateQ15<int>(function, function.LocalScalar(function.ValueAt(pInput, i))));
+                function.For(bSize, [previousInput, bCoefficients, sum](emitters::IRFunctionEmitter& function, IRLocalScalar j) {
+                    auto product = EmitWideProduct(function, function.LocalScalar(function.ValueAt(bCoefficients, j)), function.LocalScalar(function.ValueAt(previousInput, j)));
+                    function.Store(sum, function.LocalScalar(function.Load(sum)) + product);
+                });
+            }
+            if (aSize > 0)
+            {
+                function.For(aSize, [previousOutput, aCoefficients, sum](emitters::IRFunctionEmitter& function, IRLocalScalar j) {
+                    auto product = EmitWideProduct(function, function.LocalScalar(function.ValueAt(aCoefficients, j)), function.LocalScalar(function.ValueAt(previousOutput, j)));
+                    function.Store(sum, function.LocalScalar(function.Load(sum)) - product);
+                });
+            }
+
+            auto y = EmitSaturateQ15<int64_t>(function, EmitRoundingShiftRight<int64_t>(function, function.LocalScalar(function.Load(sum)), coefficientBits));
+            if (aSize > 0)
+            {
+                emitShift(function, previousOutput, aSize, y);
+            }
+            function.SetValueAt(pOutput, i, y);
+        });
+    }
+
+    void FixedPointIIRFilterNode::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<FixedPointIIRFilterNode>(newInput, _originalB, _originalA, _outputShift);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    void FixedPointIIRFilterNode::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["b"] << _originalB;
+        archiver["a"] << _originalA;
+        archiver["outputShift"] << _outputShift;
+    }
+
+    void FixedPointIIRFilterNode::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["b"] >> _originalB;
+        archiver["a"] >> _originalA;
+        archiver["outputShift"] >> _outputShift;
+        Initialize();
+        _output.SetSize(_input.Size());
+    }
+
+    // Explicit instantiations
+    template class ToFixedPointNode<float>;
+    template class ToFixedPointNode<double>;
+    template class FromFixedPointNode<float>;
+    template class FromFixedPointNode<double>;
+} // namespace nodes
+} // namespace ell
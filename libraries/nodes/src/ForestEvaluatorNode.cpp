@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestEvaluatorNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ForestEvaluatorNode.h"
+
+#include <emitters/include/IRLocalScalar.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        // The number of trees the compiled code walks at once
+        const int treeBlockSize = 4;
+
+        const int sinkNode = 0;
+    } // namespace
+
+    //
+    // FlatForest
+    //
+    size_t FlatForest::GetInputSize() const
+    {
+        return featureIndices.empty() ? 0 : static_cast<size_t>(*std::max_element(featureIndices.begin(), featureIndices.end())) + 1;
+    }
+
+    FlatForest GetFlatForest(const predictors::SimpleForestPredictor& forest)
+    {
+        const auto& interiorNodes = forest.GetInteriorNodes();
+
+        FlatForest result;
+        result.numTrees = forest.NumTrees();
+        result.numEdges = forest.NumEdges();
+        result.bias = forest.GetBias();
+
+        auto addNode = [&result](size_t featureIndex, double threshold) {
+            result.featureIndices.push_back(static_cast<int>(featureIndex));
+            result.thresholds.push_back(threshold);
+            result.children.insert(result.children.end(), { sinkNode, sinkNode });
+            result.edgeValues.insert(result.edgeValues.end(), { 0.0, 0.0 });
+            result.edgeIndices.insert(result.edgeIndices.end(), 2, static_cast<int>(result.numEdges));
+        };
+
+        addNode(0, 0.0); // the sink
+        for (size_t treeIndex = 0; treeIndex < result.numTrees; ++treeIndex)
+        {
+            // Number the tree's interior nodes breadth-first: the node at position `q` in the queue becomes node `first + q`
+            const int first = static_cast<int>(result.featureIndices.size());
+            std::vector<size_t> queue = { forest.GetRootIndex(treeIndex) };
+            std::vector<int> levels = { 1 };
+            int depth = 0;
+            for (size_t q = 0; q < queue.size(); ++q)
+            {
+                const auto& interiorNode = interiorNodes[queue[q]];
+                const auto& edges = interiorNode.GetOutgoingEdges();
+                if (edges.size() != 2)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "GetFlatForest: interior nodes must have exactly 2 outgoing edges");
+                }
+
+                const auto& splitRule = interiorNode.GetSplitRule();
+                const auto flatIndex = first + static_cast<int>(q);
+                addNode(splitRule.GetElementIndex(), splitRule.GetThreshold());
+                depth = std::max(depth, levels[q]);
+                for (size_t edgePosition = 0; edgePosition < 2; ++edgePosition)
+                {
+                    const auto& edge = edges[edgePosition];
+                    const auto slot = 2 * flatIndex + static_cast<int>(edgePosition);
+                    result.edgeValues[slot] = edge.GetPredictor().GetValue();
+                    result.edgeIndices[slot] = static_cast<int>(interiorNode.GetFirstEdgeIndex() + edgePosition);
+                    if (edge.IsTargetInterior())
+                    {
+                        result.children[slot] = first + static_cast<int>(queue.size());
+                        queue.push_back(edge.GetTargetNodeIndex());
+                        levels.push_back(levels[q] + 1);
+                    }
+                }
+            }
+            result.roots.push_back(first);
+            result.depths.push_back(depth);
+        }
+        return result;
+    }
+
+    //
+    // ForestEvaluatorNode
+    //
+    ForestEvaluatorNode::ForestEvaluatorNode() :
+        CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 1),
+        _treeOutputs(this, treeOutputsPortName, 0),
+        _edgeIndicatorVector(this, edgeIndicatorVectorPortName, 0)
+    {
+    }
+
+    ForestEvaluatorNode::ForestEvaluatorNode(const model::OutputPort<double>& input, const FlatForest& forest) :
+        CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, 1),
+        _treeOutputs(this, treeOutputsPortName, forest.numTrees),
+        _edgeIndicatorVector(this, edgeIndicatorVectorPortName, forest.numEdges),
+        _forest(forest)
+    {
+        ValidateForest();
+        if (input.Size() < _forest.GetInputSize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "ForestEvaluatorNode: the forest reads past the end of the input");
+        }
+    }
+
+    void ForestEvaluatorNode::ValidateForest() const
+    {
+        const auto numNodes = _forest.featureIndices.size();
+        if (numNodes == 0 || _forest.thresholds.size() != numNodes || _forest.children.size() != 2 * numNodes || _forest.edgeValues.size() != 2 * numNodes || _forest.edgeIndices.size() != 2 * numNodes || _forest.roots.size() != _forest.numTrees || _forest.depths.size() != _forest.numTrees)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "ForestEvaluatorNode: wrong number of node, edge or tree entries");
+        }
+
+        auto isNode = [numNodes](int node) { return node >= 0 && node < static_cast<int>(numNodes); };
+        auto isEdge = [this](int edge) { return edge >= 0 && edge <= static_cast<int>(_forest.numEdges); };
+        if (!std::all_of(_forest.children.begin(), _forest.children.end(), isNode) || !std::all_of(_forest.roots.begin(), _forest.roots.end(), isNode) || !std::all_of(_forest.edgeIndices.begin(), _forest.edgeIndices.end(), isEdge))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "ForestEvaluatorNode: node or edge index out of range");
+        }
+
+        if (std::any_of(_forest.featureIndices.begin(), _forest.featureIndices.end(), [](int feature) { return feature < 0; }))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "ForestEvaluatorNode: negative feature index");
+        }
+    }
+
+    void ForestEvaluatorNode::Compute() const
+    {
+        const auto& input = _input.GetValue();
+        std::vector<double> treeOutputs(_forest.numTrees);
+        std::vector<bool> edgeIndicator(_forest.numEdges + 1);
+        for (size_t treeIndex = 0; treeIndex < _forest.numTrees; ++treeIndex)
+        {
+            double value = 0;
+            for (auto node = _forest.roots[treeIndex]; node != sinkNode;)
+            {
+                auto edge = 2 * node + (input[_forest.featureIndices[node]] > _forest.thresholds[node] ? 1 : 0);
+                value += _forest.edgeValues[edge];
+                edgeIndicator[_forest.edgeIndices[edge]] = true;
+                node = _forest.children[edge];
+            }
+            treeOutputs[treeIndex] = value;
+        }
+
+        double sum = _forest.bias;
+        for (auto value : treeOutputs)
+        {
+            sum += value;
+        }
+        edgeIndicator.pop_back(); // the sink's edge
+
+        _output.SetOutput({ sum });
+        _treeOutputs.SetOutput(std::move(treeOutputs));
+        _edgeIndicatorVector.SetOutput(std::move(edgeIndicator));
+    }
+
+    void ForestEvaluatorNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        emitters::LLVMValue pTreeOutputs = compiler.EnsurePortEmitted(treeOutputs);
+        emitters::LLVMValue pEdgeIndicator = compiler.EnsurePortEmitted(edgeIndicatorVector);
+
+        const int numTrees = static_cast<int>(_forest.numTrees);
+        const int numEdges = static_cast<int>(_forest.numEdges);
+        if (numTrees == 0)
+        {
+            function.SetValueAt(pOutput, 0, function.Literal<double>(_forest.bias));
+            return;
+        }
+
+        // Group the trees into blocks, padded with empty trees (rooted at the sink), and walk each block for the
+        // depth of its deepest tree
+        const int numBlocks = (numTrees + treeBlockSize - 1) / treeBlockSize;
+        std::vector<int> roots(numBlocks * treeBlockSize, sinkNode);
+        std::vector<int> blockDepths(numBlocks, 0);
+        for (int treeIndex = 0; treeIndex < numTrees; ++treeIndex)
+        {
+            roots[treeIndex] = _forest.roots[treeIndex];
+            blockDepths[treeIndex / treeBlockSize] = std::max(blockDepths[treeIndex / treeBlockSize], _forest.depths[treeIndex]);
+        }
+
+        auto& module = function.GetModule();
+        auto pRoots = module.ConstantArray(compiler.GetGlobalName(*this, "roots"), roots);
+        auto pBlockDepths = module.ConstantArray(compiler.GetGlobalName(*this, "blockDepths"), blockDepths);
+        auto pFeatureIndices = module.ConstantArray(compiler.GetGlobalName(*this, "featureIndices"), _forest.featureIndices);
+        auto pThresholds = module.ConstantArray(compiler.GetGlobalName(*this, "thresholds"), _forest.thresholds);
+        auto pChildren = module.ConstantArray(compiler.GetGlobalName(*this, "children"), _forest.children);
+        auto pEdgeValues = module.ConstantArray(compiler.GetGlobalName(*this, "edgeValues"), _forest.edgeValues);
+        auto pEdgeIndices = module.ConstantArray(compiler.GetGlobalName(*this, "edgeIndices"), _forest.edgeIndices);
+
+        // The edge indicator has an extra entry for the sink's edges; the tree values have an entry for each padding tree
+        auto edgeIndicator = function.Variable(emitters::VariableType::Byte, numEdges + 1);
+        auto treeValues = function.Variable(emitters::VariableType::Double, numBlocks * treeBlockSize);
+        function.MemorySet<uint8_t>(edgeIndicator, 0, function.Literal<uint8_t>(0), numEdges + 1);
+
+        // The state of each tree in the block being walked
+        std::vector<emitters::LLVMValue> nodes;
+        std::vector<emitters::LLVMValue> values;
+        for (int lane = 0; lane < treeBlockSize; ++lane)
+        {
+            nodes.push_back(function.Variable(emitters::VariableType::Int32, "node"));
+            values.push_back(function.Variable(emitters::VariableType::Double, "value"));
+        }
+
+        function.For(numBlocks, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar block) {
+            auto firstTree = block * treeBlockSize;
+            for (int lane = 0; lane < treeBlockSize; ++lane)
+            {
+                function.Store(nodes[lane], function.ValueAt(pRoots, firstTree + lane));
+                function.StoreZero(values[lane]);
+            }
+
+            function.For(function.ValueAt(pBlockDepths, block), [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar) {
+                for (int lane = 0; lane < treeBlockSize; ++lane)
+                {
+                    // Select the edge with a compare, so the walk doesn't branch on the data
+                    auto node = function.LocalScalar(function.Load(nodes[lane]));
+                    auto x = function.LocalScalar(function.ValueAt(pInput, function.ValueAt(pFeatureIndices, node)));
+                    auto threshold = function.LocalScalar(function.ValueAt(pThresholds, node));
+                    auto edge = node * 2 + function.LocalScalar(function.Select(x > threshold, function.Literal(1), function.Literal(0)));
+
+                    auto value = function.LocalScalar(function.Load(values[lane]));
+                    function.Store(values[lane], value + function.LocalScalar(function.ValueAt(pEdgeValues, edge)));
+                    function.SetValueAt(edgeIndicator, function.ValueAt(pEdgeIndices, edge), function.Literal<uint8_t>(1));
+                    function.Store(nodes[lane], function.ValueAt(pChildren, edge));
+                }
+            });
+
+            for (int lane = 0; lane < treeBlockSize; ++lane)
+            {
+                function.SetValueAt(treeValues, firstTree + lane, function.Load(values[lane]));
+            }
+        });
+
+        if (numEdges > 0)
+        {
+            function.MemoryCopy<uint8_t>(edgeIndicator, pEdgeIndicator, numEdges);
+        }
+        function.MemoryCopy<double>(treeValues, pTreeOutputs, numTrees);
+
+        // Sum the trees and the bias
+        auto sum = function.Variable(emitters::VariableType::Double, "sum");
+        function.Store(sum, function.Literal<double>(_forest.bias));
+        function.For(numTrees, [treeValues, sum](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar treeIndex) {
+            function.Store(sum, function.LocalScalar(function.Load(sum)) + function.LocalScalar(function.ValueAt(treeValues, treeIndex)));
+        });
+        function.SetValueAt(pOutput, 0, function.Load(sum));
+    }
+
+    void ForestEvaluatorNode::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<ForestEvaluatorNode>(newInput, _forest);
+        transformer.MapNodeOutput(output, newNode->output);
+        transformer.MapNodeOutput(treeOutputs, newNode->treeOutputs);
+        transformer.MapNodeOutput(edgeIndicatorVector, newNode->edgeIndicatorVector);
+    }
+
+    void ForestEvaluatorNode::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["numTrees"] << _forest.numTrees;
+        archiver["numEdges"] << _forest.numEdges;
+        archiver["bias"] << _forest.bias;
+        archiver["roots"] << _forest.roots;
+        archiver["depths"] << _forest.depths;
+        archiver["featureIndices"] << _forest.featureIndices;
+        archiver["thresholds"] << _forest.thresholds;
+        archiver["children"] << _forest.children;
+        archiver["edgeValues"] << _forest.edgeValues;
+        archiver["edgeIndices"] << _forest.edgeIndices;
+    }
+
+    void ForestEvaluatorNode::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["numTrees"] >> _forest.numTrees;
+        archiver["numEdges"] >> _forest.numEdges;
+        archiver["bias"] >> _forest.bias;
+        archiver["roots"] >> _forest.roots;
+        archiver["depths"] >> _forest.depths;
+        archiver["featureIndices"] >> _forest.featureIndices;
+        archiver["thresholds"] >> _forest.thresholds;
+        archiver["children"] >> _forest.children;
+        archiver["edgeValues"] >> _forest.edgeValues;
+        archiver["edgeIndices"] >> _forest.edgeIndices;
+        ValidateForest();
+
+        _treeOutputs.SetSize(_forest.numTrees);
+        _edgeIndicatorVector.SetSize(_forest.numEdges);
+    }
+} // namespace nodes
+} // namespace ell
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FusedLinearActivation.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FusedLinearActivation.h"
+#include "ActivationFunctions.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    FusedLinearActivation<ValueType>::FusedLinearActivation(std::vector<ValueType> scale, std::vector<ValueType> bias) :
+        _scale(std::move(scale)),
+        _bias(std::move(bias))
+    {
+        if (!_scale.empty() && !_bias.empty() && _scale.size() != _bias.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Scale and bias must have one value per channel");
+        }
+    }
+
+    template <typename ValueType>
+    FusedLinearActivation<ValueType> FusedLinearActivation<ValueType>::ThenLinear(const std::vector<ValueType>& scale, const std::vector<ValueType>& bias) const
+    {
+        auto numChannels = static_cast<int>(scale.empty() ? bias.size() : scale.size());
+        if (!CanAppendLinear(numChannels))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Can't compose these linear functions");
+        }
+
+        // s2 * (s1 * x + b1) + b2 == (s2 * s1) * x + (s2 * b1 + b2)
+        auto newScale = _scale;
+        if (newScale.empty())
+        {
+            newScale = scale;
+        }
+        else if (!scale.empty())
+        {
+            for (int index = 0; index < numChannels; ++index)
+            {
+                newScale[index] *= scale[index];
+            }
+        }
+
+        auto newBias = _bias;
+        if (!newBias.empty() && !scale.empty())
+        {
+            for (int index = 0; index < numChannels; ++index)
+            {
+                newBias[index] *= scale[index];
+            }
+        }
+        if (newBias.empty())
+        {
+            newBias = bias;
+        }
+        else if (!bias.empty())
+        {
+            for (int index = 0; index < numChannels; ++index)
+            {
+                newBias[index] += bias[index];
+            }
+        }
+        return { newScale, newBias };
+    }
+
+    template <typename ValueType>
+    FusedLinearActivation<ValueType> FusedLinearActivation<ValueType>::ThenActivation(const ActivationType& activation) const
+    {
+        if (HasActivation())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Can't apply two activations");
+        }
+
+        // Fail now, rather than when compiling, if the activation can't be compiled
+        GetNodeActivationFunction(activation);
+
+        auto result = *this;
+        result._activation = std::make_shared<const ActivationType>(activation);
+        return result;
+    }
+
+    template <typename ValueType>
+    void FusedLinearActivation<ValueType>::Apply(std::vector<ValueType>& values) const
+    {
+        const auto numChannels = GetNumChannels();
+        for (size_t index = 0; index < values.size(); ++index)
+        {
+            auto value = values[index];
+            if (numChannels > 0)
+            {
+                const auto channel = index % numChannels;
+                value = _scale.empty() ? value : value * _scale[channel];
+                value = _bias.empty() ? value : value + _bias[channel];
+            }
+            values[index] = HasActivation() ? _activation->Apply(value) : value;
+        }
+    }
+
+    template <typename ValueType>
+    typename FusedLinearActivation<ValueType>::EmittedCoefficients FusedLinearActivation<ValueType>::EmitCoefficients(model::IRMapCompiler& compiler, const model::Node& node, emitters::IRFunctionEmitter& function) const
+    {
+        auto& module = function.GetModule();
+        EmittedCoefficients result;
+        if (!_scale.empty())
+        {
+            result.scale = module.ConstantArray(compiler.GetGlobalName(node, "outputScale"), _scale);
+        }
+        if (!_bias.empty())
+        {
+            result.bias = module.ConstantArray(compiler.GetGlobalName(node, "outputBias"), _bias);
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    void FusedLinearActivation<ValueType>::EmitApply(emitters::IRFunctionEmitter& function, const EmittedCoefficients& coefficients, emitters::LLVMValue values, int size) const
+    {
+        std::unique_ptr<ActivationFunction<ValueType>> activationFunction;
+        if (HasActivation())
+        {
+            activationFunction = GetNodeActivationFunction(*_activation);
+        }
+
+        const auto numChannels = std::max(GetNumChannels(), 1);
+        function.For(size / numChannels, [&](emitters::IRFunctionEmitter& function, emitters::LLVMValue pixel) {
+            auto pixelValues = function.PointerOffset(values, function.LocalScalar(pixel) * numChannels);
+            function.For(numChannels, [&](emitters::IRFunctionEmitter& function, emitters::LLVMValue channel) {
+                emitters::LLVMValue value = function.ValueAt(pixelValues, channel);
+                if (coefficients.scale != nullptr)
+                {
+                    value = function.LocalScalar(value) * function.LocalScalar(function.ValueAt(coefficients.scale, channel));
+                }
+                if (coefficients.bias != nullptr)
+                {
+                    value = function.LocalScalar(value) + function.LocalScalar(function.ValueAt(coefficients.bias, channel));
+                }
+                if (activationFunction)
+                {
+                    value = activationFunction->Compile(function, value);
+                }
+                function.SetValueAt(pixelValues, channel, value);
+            });
+        });
+    }
+
+    template <typename ValueType>
+    void FusedLinearActivation<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        archiver["outputScale"] << _scale;
+        archiver["outputBias"] << _bias;
+        archiver["hasOutputActivation"] << HasActivation();
+        if (HasActivation())
+        {
+            _activation->WriteToArchive(archiver);
+        }
+    }
+
+    template <typename ValueType>
+    void FusedLinearActivation<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        archiver.OptionalProperty("outputScale", std::vector<ValueType>{}) >> _scale;
+        archiver.OptionalProperty("outputBias", std::vector<ValueType>{}) >> _bias;
+
+        bool hasActivation = false;
+        archiver.OptionalProperty("hasOutputActivation", false) >> hasActivation;
+        _activation = nullptr;
+        if (hasActivation)
+        {
+            auto activation = std::make_shared<ActivationType>();
+            activation->ReadFromArchive(archiver);
+            _activation = activation;
+        }
+    }
+
+    // Explicitly instantiate versions
+    template class FusedLinearActivation<float>;
+    template class FusedLinearActivation<double>;
+} // namespace nodes
+} // namespace ell
@@ -35,14 +35,15 @@ namespace nodes
                                 const model::OutputPort<ValueType>& hiddenBias,
                                 const ActivationType& activation,
                                 const ActivationType& recurrentActivation,
+                                size_t sequenceLength,
                                 bool validateWeights) :
-        LSTMNode<ValueType>(input, resetTrigger, hiddenUnits, inputWeights, hiddenWeights, inputBias, hiddenBias, activation, recurrentActivation, false)
+        LSTMNode<ValueType>(input, resetTrigger, hiddenUnits, inputWeights, hiddenWeights, inputBias, hiddenBias, activation, recurrentActivation, sequenceLength, false)
     {
         if (validateWeights)
         {
             size_t stackHeight = 3; // GRU has 3 stacked weights for (input, reset, hidden).
             size_t numRows = stackHeight * hiddenUnits;
-            size_t numColumns = input.Size();
+            size_t numColumns = this->GetFrameSize();
 
             if (inputWeights.Size() != numRows * numColumns)
             {
@@ -80,7 +81,7 @@ namespace nodes
         const auto& newHiddenWeights = transformer.GetCorrespondingInputs(this->_hiddenWeights);
         const auto& newInputBias = transformer.GetCorrespondingInputs(this->_inputBias);
         const auto& newHiddenBias = transformer.GetCorrespondingInputs(this->_hiddenBias);
-        auto newNode = transformer.AddNode<GRUNode>(newInput, newResetTrigger, this->_hiddenUnits, newInputWeights, newHiddenWeights, newInputBias, newHiddenBias, this->_activation, this->_recurrentActivation);
+        auto newNode = transformer.AddNode<GRUNode>(newInput, newResetTrigger, this->_hiddenUnits, newInputWeights, newHiddenWeights, newInputBias, newHiddenBias, this->_activation, this->_recurrentActivation, this->_sequenceLength);
         transformer.MapNodeOutput(this->output, newNode->output);
     }
 
@@ -97,9 +98,10 @@ namespace nodes
         */
         size_t hiddenUnits = this->_hiddenUnits;
         size_t stackHeight = 3; // GRU has 3 stacked weights for (input, reset, hidden)
-        VectorType inputVector = this->_input.GetValue();
+        size_t frameSize = this->GetFrameSize();
+        std::vector<ValueType> inputValue = this->_input.GetValue();
         size_t numRows = stackHeight * hiddenUnits;
-        size_t numColumns = inputVector.Size();
+        size_t numColumns = frameSize;
         std::vector<ValueType> inputWeightsValue = this->_inputWeights.GetValue();
         ConstMatrixReferenceType inputWeights(inputWeightsValue.data(), numRows, numColumns);
         numColumns = hiddenUnits;
@@ -111,51 +113,55 @@ namespace nodes
         auto alpha = static_cast<ValueType>(1); // GEMV scale multiplication
         auto beta = alpha; // GEMV scale bias
 
-        // W_i * x + b_i
-        VectorType istack(inputBias); // add input bias
-        math::MultiplyScaleAddUpdate(alpha, inputWeights, inputVector, beta, istack);
-
-        // W_h * h + b_h
-        VectorType hstack(hiddenBias); // add hidden bias
-        math::MultiplyScaleAddUpdate(alpha, hiddenWeights, this->_hiddenState, beta, hstack);
-
-        // the weights are stacked in 3 slices for (input, reset, hidden).
-        size_t slice1 = 0;
-        size_t slice2 = hiddenUnits;
-        size_t slice3 = 2 * hiddenUnits;
-
-        // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
-        VectorType input_gate(hiddenUnits);
-        input_gate.CopyFrom(istack.GetSubVector(slice1, hiddenUnits));
-        input_gate += hstack.GetSubVector(slice1, hiddenUnits);
-        this->_recurrentActivation.Apply(input_gate);
-
-        // reset_gate = sigma(W_{ ir } x + b_{ ir } + W_{ hr } h + b_{ hr })
-        VectorType reset_gate(hiddenUnits);
-        reset_gate.CopyFrom(istack.GetSubVector(slice2, hiddenUnits));
-        reset_gate += hstack.GetSubVector(slice2, hiddenUnits);
-        this->_recurrentActivation.Apply(reset_gate);
-
-        // hidden_gate = tanh(W_{ in } x + b_{ in } + reset_gate * (W_{ hn } h + b_{ hn }))
-        VectorType hidden_gate(hiddenUnits);
-        hidden_gate.CopyFrom(hstack.GetSubVector(slice3, hiddenUnits));
-        ElementwiseMultiplySet(hidden_gate, reset_gate, hidden_gate);
-        hidden_gate += istack.GetSubVector(slice3, hiddenUnits);
-        this->_activation.Apply(hidden_gate);
-
-        // ht = (1 - input_gate) * hidden_gate + input_gate * h
-        //    = hidden_gate - input_gate * hidden_gate + input_gate * h
-        //    = hidden_gate + input_gate (h - hidden_gate )
-        this->_hiddenState -= hidden_gate;
-        ElementwiseMultiplySet(this->_hiddenState, input_gate, this->_hiddenState);
-        this->_hiddenState += hidden_gate;
-
-        if (this->ShouldReset())
+        std::vector<ValueType> output;
+        for (size_t t = 0; t < this->_sequenceLength; ++t)
         {
-            const_cast<GRUNode<ValueType>*>(this)->Reset();
+            math::ConstColumnVectorReference<ValueType> inputVector(inputValue.data() + t * frameSize, frameSize);
+
+            // W_i * x + b_i
+            VectorType istack(inputBias); // add input bias
+            math::MultiplyScaleAddUpdate(alpha, inputWeights, inputVector, beta, istack);
+
+            // W_h * h + b_h
+            VectorType hstack(hiddenBias); // add hidden bias
+            math::MultiplyScaleAddUpdate(alpha, hiddenWeights, this->_hiddenState, beta, hstack);
+
+            // the weights are stacked in 3 slices for (input, reset, hidden).
+            size_t slice1 = 0;
+            size_t slice2 = hiddenUnits;
+            size_t slice3 = 2 * hiddenUnits;
+
+            // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
+            VectorType input_gate(hiddenUnits);
+            input_gate.CopyFrom(istack.GetSubVector(slice1, hiddenUnits));
+            input_gate += hstack.GetSubVector(slice1, hiddenUnits);
+            this->_recurrentActivation.Apply(input_gate);
+
+            // reset_gate = sigma(W_{ ir } x + b_{ ir } + W_{ hr } h + b_{ hr })
+            VectorType reset_gate(hiddenUnits);
+            reset_gate.CopyFrom(istack.GetSubVector(slice2, hiddenUnits));
+            reset_gate += hstack.GetSubVector(slice2, hiddenUnits);
+            this->_recurrentActivation.Apply(reset_gate);
+
+            // hidden_gate = tanh(W_{ in } x + b_{ in } + reset_gate * (W_{ hn } h + b_{ hn }))
+            VectorType hidden_gate(hiddenUnits);
+            hidden_gate.CopyFrom(hstack.GetSubVector(slice3, hiddenUnits));
+            ElementwiseMultiplySet(hidden_gate, reset_gate, hidden_gate);
+            hidden_gate += istack.GetSubVector(slice3, hiddenUnits);
+            this->_activation.Apply(hidden_gate);
+
+            // ht = (1 - input_gate) * hidden_gate + input_gate * h
+            //    = hidden_gate - input_gate * hidden_gate + input_gate * h
+            //    = hidden_gate + input_gate (h - hidden_gate )
+            this->_hiddenState -= hidden_gate;
+            ElementwiseMultiplySet(this->_hiddenState, input_gate, this->_hiddenState);
+            this->_hiddenState += hidden_gate;
+
+            auto hiddenState = this->_hiddenState.ToArray();
+            output.insert(output.end(), hiddenState.begin(), hiddenState.end());
         }
 
-        this->_output.SetOutput(this->_hiddenState.ToArray());
+        this->SetSequenceOutput(output);
     }
 
     template <typename ValueType>
@@ -173,19 +179,14 @@ namespace nodes
     void GRUNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
         const int hiddenUnits = static_cast<int>(this->_hiddenUnits);
-        const int inputSize = static_cast<int>(this->input.Size());
         const int outputSize = static_cast<int>(this->_hiddenUnits);
+        const int stackHeight = 3; // GRU has 3 stacked weights for (input, reset, hidden).
 
         // Get LLVM references for all node inputs
-        auto input = compiler.EnsurePortEmitted(this->input);
         auto resetTrigger = compiler.EnsurePortEmitted(this->resetTrigger);
-        auto inputWeights = compiler.EnsurePortEmitted(this->inputWeights);
-        auto hiddenWeights = compiler.EnsurePortEmitted(this->hiddenWeights);
-        auto inputBias = compiler.EnsurePortEmitted(this->inputBias);
-        auto hiddenBias = compiler.EnsurePortEmitted(this->hiddenBias);
 
         // Get LLVM reference for node output
-        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
+        auto output = compiler.EnsurePortEmitted(this->output);
 
         // Allocate global buffer for hidden state
         emitters::IRModuleEmitter& module = function.GetModule();
@@ -193,67 +194,44 @@ namespace nodes
         auto hiddenStateValue = module.EnsureEmitted(*hiddenStateVariable);
         auto hiddenStatePointer = function.PointerOffset(hiddenStateValue, 0); // convert "global variable" to a pointer
         auto hiddenState = function.LocalArray(hiddenStatePointer);
-        auto& prevHiddenState = hiddenState;
-
-        // Allocate local variables
-        const size_t stackSize = hiddenUnits * 3;
-        auto istack = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), stackSize));
-        auto hstack = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), stackSize));
-        auto inputGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
-        auto resetGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
-        auto hiddenGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
-
-        auto alpha = static_cast<ValueType>(1.0); // GEMV scaling of the matrix multipication
-        auto beta = static_cast<ValueType>(1.0); // GEMV scaling of the bias addition
-
-        // W_i * x + b, one matrix multiplication for all 3 gates (input,reset,hidden)
-        function.MemoryCopy<ValueType>(inputBias, istack, stackSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(stackSize, inputSize, alpha, inputWeights, inputSize, input, 1, beta, istack, 1);
-
-        // W_h * h + b
-        function.MemoryCopy<ValueType>(hiddenBias, hstack, stackSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(stackSize, hiddenUnits, alpha, hiddenWeights, hiddenUnits, hiddenState, 1, beta, hstack, 1);
-
-        // the weights are stacked in 3 slices for (input, reset, hidden).
-        auto istack_slice0 = istack;
-        auto istack_slice1 = function.LocalArray(function.PointerOffset(istack, function.LocalScalar(hiddenUnits)));
-        auto istack_slice2 = function.LocalArray(function.PointerOffset(istack, function.LocalScalar(hiddenUnits * 2)));
-        auto hstack_slice0 = hstack;
-        auto hstack_slice1 = function.LocalArray(function.PointerOffset(hstack, function.LocalScalar(hiddenUnits)));
-        auto hstack_slice2 = function.LocalArray(function.PointerOffset(hstack, function.LocalScalar(hiddenUnits * 2)));
-
-        // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
-        function.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            inputGate[i] = istack_slice0[i] + hstack_slice0[i];
-        });
-        this->ApplyActivation(function, this->_recurrentActivation, inputGate, hiddenUnits);
-
-        // reset_gate = sigma(W_{ ir } x + b_{ ir } + W_{ hr } h + b_{ hr })
-        function.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            resetGate[i] = istack_slice1[i] + hstack_slice1[i];
-        });
-        this->ApplyActivation(function, this->_recurrentActivation, resetGate, hiddenUnits);
 
-        // hidden_gate = tanh(W_{ in } x + b_{ in } + reset_gate * (W_{ hn } h + b_{ hn }))
-        function.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            hiddenGate[i] = istack_slice2[i] + resetGate[i] * hstack_slice2[i];
+        // W_i * x + b_i + W_h * h + b_h, one stack holding (input, reset, hidden input term, hidden hidden term).
+        // The hidden gate's terms are kept apart because the reset gate only scales the hidden term.
+        const int numFusedGates = 2;
+        const size_t stackSize = hiddenUnits * (2 * stackHeight - numFusedGates);
+        auto stack = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), stackSize));
+        auto activationFunction = GetNodeActivationFunction(this->_activation);
+        auto recurrentActivationFunction = GetNodeActivationFunction(this->_recurrentActivation);
+        auto activation = activationFunction.get();
+        auto recurrentActivation = recurrentActivationFunction.get();
+        this->EmitTimeSteps(compiler, function, stackHeight, [&](emitters::IRFunctionEmitter& fn, emitters::LLVMValue inputProjection, emitters::IRLocalScalar t) {
+            this->EmitGatePreactivations(compiler, fn, stackHeight, numFusedGates, hiddenStatePointer, stack, inputProjection);
+
+            // Apply the gate activations and update the hidden state in a single pass over the hidden units
+            fn.For(outputSize, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
+                emitters::IRLocalScalar inputPreactivation = stack[i];
+                emitters::IRLocalScalar resetPreactivation = stack[i + hiddenUnits];
+                emitters::IRLocalScalar hiddenInputTerm = stack[i + 2 * hiddenUnits];
+                emitters::IRLocalScalar hiddenHiddenTerm = stack[i + 3 * hiddenUnits];
+
+                // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
+                auto z_i = fn.LocalScalar(recurrentActivation->Compile(fn, inputPreactivation));
+
+                // reset_gate = sigma(W_{ ir } x + b_{ ir } + W_{ hr } h + b_{ hr })
+                auto r_i = fn.LocalScalar(recurrentActivation->Compile(fn, resetPreactivation));
+
+                // hidden_gate = tanh(W_{ in } x + b_{ in } + reset_gate * (W_{ hn } h + b_{ hn }))
+                auto n_i = fn.LocalScalar(activation->Compile(fn, hiddenInputTerm + r_i * hiddenHiddenTerm));
+
+                //ht = (1 - input_gate) * hidden_gate + input_gate * h
+                //   = hidden_gate + input_gate (h - hidden_gate )
+                emitters::IRLocalScalar h_i = hiddenState[i];
+                hiddenState[i] = n_i + z_i * (h_i - n_i);
+            });
+
+            // Copy hidden state to the output.
+            fn.MemoryCopy<ValueType>(hiddenState, fn.PointerOffset(output, t * hiddenUnits), hiddenUnits);
         });
-        this->ApplyActivation(function, this->_activation, hiddenGate, hiddenUnits);
-
-        //ht = (1 - input_gate) * hidden_gate + input_gate * h
-        //   = hidden_gate - input_gate * hidden_gate + input_gate * h
-        //   = hidden_gate + input_gate (h - hidden_gate )
-
-        function.For(outputSize, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            auto z_i = inputGate[i];
-            auto n_i = hiddenGate[i];
-            auto h_i = prevHiddenState[i];
-            auto newValue = n_i + z_i * (h_i - n_i);
-            hiddenState[i] = newValue;
-        });
-
-        // Copy hidden state to the output.
-        function.MemoryCopy<ValueType>(hiddenState, output, hiddenUnits);
 
         // Add the internal reset function
         std::string resetFunctionName = compiler.GetGlobalName(*this, "GRUNodeReset");
@@ -0,0 +1,261 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     HalfPrecisionMatrixVectorProductNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "HalfPrecisionMatrixVectorProductNode.h"
+
+#include <emitters/include/IRLocalScalar.h>
+
+#include <llvm/IR/Type.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        uint32_t FloatToBits(float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        float BitsToFloat(uint32_t bits)
+        {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        uint16_t ToBFloat16(float value)
+        {
+            auto bits = FloatToBits(value);
+            if (std::isnan(value))
+            {
+                return static_cast<uint16_t>((bits >> 16) | 0x0040); // keep it a (quiet) NaN
+            }
+
+            const uint32_t sign = bits & 0x80000000;
+            const uint32_t maxFinite = 0x7f7f0000; // largest finite bfloat16, as single precision bits
+            if ((bits & 0x7fffffff) >= maxFinite + 0x8000) // would round to infinity
+            {
+                return static_cast<uint16_t>((sign | maxFinite) >> 16);
+            }
+            bits += 0x7fff + ((bits >> 16) & 1); // round to nearest even
+            return static_cast<uint16_t>(bits >> 16);
+        }
+
+        uint16_t ToFloat16(float value)
+        {
+            const auto bits = FloatToBits(value);
+            const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+            if (std::isnan(value))
+            {
+                return static_cast<uint16_t>(sign | 0x7e00);
+            }
+
+            const float magnitude = std::fabs(value);
+            const float maxFinite = 65504.0f;
+            if (magnitude >= 65520.0f) // values at or above this would round to infinity
+            {
+                return static_cast<uint16_t>(sign | 0x7bff);
+            }
+            if (magnitude < 6.103515625e-05f) // subnormal: a multiple of 2^-24, rounded to nearest even by the FPU
+            {
+                return static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(magnitude * 16777216.0f)));
+            }
+
+            auto magnitudeBits = FloatToBits(std::fmin(magnitude, maxFinite));
+            magnitudeBits += 0x0fff + ((magnitudeBits >> 13) & 1); // round to nearest even at the 10th mantissa bit
+            const uint32_t exponent = (magnitudeBits >> 23) - 127 + 15;
+            const uint32_t mantissa = (magnitudeBits >> 13) & 0x3ff;
+            return static_cast<uint16_t>(sign | (exponent << 10) | mantissa);
+        }
+
+        float FromFloat16(uint16_t bits)
+        {
+            const uint32_t sign = static_cast<uint32_t>(bits & 0x8000) << 16;
+            const uint32_t exponent = (bits >> 10) & 0x1f;
+            const uint32_t mantissa = bits & 0x3ff;
+            float magnitude;
+            if (exponent == 0x1f)
+            {
+                magnitude = BitsToFloat(0x7f800000 | (mantissa << 13));
+            }
+            else if (exponent == 0)
+            {
+                magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+            }
+            else
+            {
+                magnitude = BitsToFloat(((exponent - 15 + 127) << 23) | (mantissa << 13));
+            }
+            return BitsToFloat(FloatToBits(magnitude) | sign);
+        }
+
+        bool HasNativeFloat16Conversion(const emitters::TargetDevice& target)
+        {
+            // ARMv8 has instructions to convert between half and single precision; elsewhere LLVM may call
+            // a runtime library function for each conversion, so we emit the bit manipulation instead
+            return target.triple.find("aarch64") == 0 || target.architecture == "aarch64" || target.features.find("fp16") != std::string::npos;
+        }
+    } // namespace
+
+    uint16_t ToHalfPrecision(float value, HalfPrecisionFormat format)
+    {
+        return format == HalfPrecisionFormat::bfloat16 ? ToBFloat16(value) : ToFloat16(value);
+    }
+
+    float FromHalfPrecision(uint16_t bits, HalfPrecisionFormat format)
+    {
+        return format == HalfPrecisionFormat::bfloat16 ? BitsToFloat(static_cast<uint32_t>(bits) << 16) : FromFloat16(bits);
+    }
+
+    template <typename ValueType>
+    HalfPrecisionMatrixVectorProductNode<ValueType>::HalfPrecisionMatrixVectorProductNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    HalfPrecisionMatrixVectorProductNode<ValueType>::HalfPrecisionMatrixVectorProductNode(const model::OutputPort<ValueType>& input, const HalfPrecisionMatrix& weights) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, weights.numRows),
+        _weights(weights)
+    {
+        if (input.Size() != weights.numColumns)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "HalfPrecisionMatrixVectorProductNode: input size must match the number of columns in the matrix");
+        }
+
+        if (weights.values.size() != weights.numRows * weights.numColumns)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "HalfPrecisionMatrixVectorProductNode: wrong number of values");
+        }
+    }
+
+    template <typename ValueType>
+    void HalfPrecisionMatrixVectorProductNode<ValueType>::Compute() const
+    {
+        const auto m = _weights.numRows;
+        const auto n = _weights.numColumns;
+
+        std::vector<ValueType> result(m);
+        for (size_t i = 0; i < m; ++i)
+        {
+            ValueType accumulator = 0;
+            for (size_t j = 0; j < n; ++j)
+            {
+                accumulator += static_cast<ValueType>(FromHalfPrecision(_weights.values[i * n + j], _weights.format)) * _input[j];
+            }
+            result[i] = accumulator;
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    emitters::LLVMValue HalfPrecisionMatrixVectorProductNode<ValueType>::EmitWidenWeight(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, emitters::LLVMValue weight) const
+    {
+        using emitters::TypedOperator;
+        if (_weights.format == HalfPrecisionFormat::float16 && HasNativeFloat16Conversion(compiler.GetCompilerOptions().targetDevice))
+        {
+            auto halfValue = function.BitCast(weight, llvm::Type::getHalfTy(function.GetLLVMContext()));
+            return function.CastValue<ValueType>(halfValue);
+        }
+
+        auto bits = function.CastUnsignedValue<int>(weight);
+        if (_weights.format == HalfPrecisionFormat::bfloat16)
+        {
+            auto singleBits = function.Operator(TypedOperator::shiftLeft, bits, function.Literal<int>(16));
+            return function.CastValue<ValueType>(function.BitCast(singleBits, emitters::VariableType::Float));
+        }
+
+        // Move the exponent and mantissa into place and multiply by 2^(127 - 15) to rebias the exponent, which
+        // also gets subnormal values right, then put the sign back
+        auto magnitudeBits = function.Operator(TypedOperator::shiftLeft, function.Operator(TypedOperator::logicalAnd, bits, function.Literal<int>(0x7fff)), function.Literal<int>(13));
+        auto magnitude = function.Operator(TypedOperator::multiplyFloat, function.BitCast(magnitudeBits, emitters::VariableType::Float), function.Literal<float>(5.192296858534828e+33f));
+        auto signBits = function.Operator(TypedOperator::shiftLeft, function.Operator(TypedOperator::logicalAnd, bits, function.Literal<int>(0x8000)), function.Literal<int>(16));
+        auto singleBits = function.Operator(TypedOperator::logicalOr, function.BitCast(magnitude, emitters::VariableType::Int32), signBits);
+        return function.CastValue<ValueType>(function.BitCast(singleBits, emitters::VariableType::Float));
+    }
+
+    template <typename ValueType>
+    void HalfPrecisionMatrixVectorProductNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        const int m = static_cast<int>(_weights.numRows);
+        const int n = static_cast<int>(_weights.numColumns);
+
+        auto& module = function.GetModule();
+        std::vector<int16_t> weightValues(_weights.values.begin(), _weights.values.end());
+        auto pWeights = module.ConstantArray(compiler.GetGlobalName(*this, "weights"), weightValues);
+
+        auto accumulator = function.Variable(emitters::GetVariableType<ValueType>(), "accumulator");
+        function.For(m, [this, &compiler, pWeights, pInput, pOutput, accumulator, n](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto rowIndex = function.LocalScalar(i);
+            function.Store(accumulator, function.Literal<ValueType>(0));
+            function.For(n, [this, &compiler, pWeights, pInput, accumulator, rowIndex, n](emitters::IRFunctionEmitter& function, emitters::LLVMValue j) {
+                auto columnIndex = function.LocalScalar(j);
+                auto weight = function.LocalScalar(EmitWidenWeight(compiler, function, function.ValueAt(pWeights, rowIndex * n + columnIndex)));
+                auto value = function.LocalScalar(function.ValueAt(pInput, columnIndex));
+                function.Store(accumulator, function.LocalScalar(function.Load(accumulator)) + weight * value);
+            });
+            function.SetValueAt(pOutput, rowIndex, function.Load(accumulator));
+        });
+    }
+
+    template <typename ValueType>
+    void HalfPrecisionMatrixVectorProductNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<HalfPrecisionMatrixVectorProductNode<ValueType>>(newInput, _weights);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void HalfPrecisionMatrixVectorProductNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["numRows"] << _weights.numRows;
+        archiver["numColumns"] << _weights.numColumns;
+        archiver["format"] << static_cast<int>(_weights.format);
+        std::vector<int> values(_weights.values.begin(), _weights.values.end());
+        archiver["values"] << values;
+    }
+
+    template <typename ValueType>
+    void HalfPrecisionMatrixVectorProductNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["numRows"] >> _weights.numRows;
+        archiver["numColumns"] >> _weights.numColumns;
+        int format = 0;
+        archiver["format"] >> format;
+        _weights.format = static_cast<HalfPrecisionFormat>(format);
+        std::vector<int> values;
+        archiver["values"] >> values;
+        _weights.values.assign(values.begin(), values.end());
+    }
+
+    // Explicitly instantiate versions
+    template class HalfPrecisionMatrixVectorProductNode<float>;
+    template class HalfPrecisionMatrixVectorProductNode<double>;
+} // namespace nodes
+} // namespace ell
@@ -0,0 +1,304 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ImagePreprocessingNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ImagePreprocessingNode.h"
+
+#include <emitters/include/EmitterTypes.h>
+#include <emitters/include/IRLocalScalar.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        // An `int` input holds the 8-bit values of the frame, packed 4 to an element
+        template <typename InputValueType>
+        constexpr bool IsPackedInput()
+        {
+            return std::is_same<InputValueType, int>::value;
+        }
+
+        template <typename InputValueType>
+        constexpr int GetValuesPerElement()
+        {
+            return IsPackedInput<InputValueType>() ? static_cast<int>(sizeof(int)) : 1;
+        }
+
+        std::vector<int> Multiply(const std::vector<int>& indices, int stride)
+        {
+            std::vector<int> result(indices.size());
+            std::transform(indices.begin(), indices.end(), result.begin(), [stride](int index) { return index * stride; });
+            return result;
+        }
+    } // namespace
+
+    template <typename InputValueType, typename ValueType>
+    ImagePreprocessingNode<InputValueType, ValueType>::ImagePreprocessingNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename InputValueType, typename ValueType>
+    ImagePreprocessingNode<InputValueType, ValueType>::ImagePreprocessingNode(const model::OutputPort<InputValueType>& input,
+                                                                             int inputRows,
+                                                                             int inputColumns,
+                                                                             int outputRows,
+                                                                             int outputColumns,
+                                                                             bool centerCrop,
+                                                                             const std::vector<int>& channelOrder,
+                                                                             const std::vector<ValueType>& mean,
+                                                                             const std::vector<ValueType>& scale) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0),
+        _inputRows(inputRows),
+        _inputColumns(inputColumns),
+        _outputRows(outputRows),
+        _outputColumns(outputColumns),
+        _centerCrop(centerCrop),
+        _channelOrder(channelOrder),
+        _mean(mean),
+        _scale(scale)
+    {
+        Initialize();
+    }
+
+    template <typename InputValueType, typename ValueType>
+    void ImagePreprocessingNode<InputValueType, ValueType>::Initialize()
+    {
+        const int numPixels = _inputRows * _inputColumns;
+        const int numOutputChannels = NumOutputChannels();
+        if (numPixels <= 0 || _outputRows <= 0 || _outputColumns <= 0 || numOutputChannels == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "ImagePreprocessingNode: image sizes and the number of channels must be positive");
+        }
+
+        // Packed inputs may have up to 3 bytes of padding at the end
+        const int valuesPerElement = GetValuesPerElement<InputValueType>();
+        _inputChannels = static_cast<int>(_input.Size()) * valuesPerElement / numPixels;
+        if (_inputChannels == 0 || (numPixels * _inputChannels + valuesPerElement - 1) / valuesPerElement != static_cast<int>(_input.Size()))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "ImagePreprocessingNode: input size doesn't match the input image size");
+        }
+        if (std::any_of(_channelOrder.begin(), _channelOrder.end(), [this](int channel) { return channel < 0 || channel >= _inputChannels; }))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "ImagePreprocessingNode: channel order refers to a channel the input doesn't have");
+        }
+        if (_mean.empty())
+        {
+            _mean.assign(numOutputChannels, 0);
+        }
+        if (_scale.empty())
+        {
+            _scale.assign(numOutputChannels, 1);
+        }
+        if (static_cast<int>(_mean.size()) != numOutputChannels || static_cast<int>(_scale.size()) != numOutputChannels)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "ImagePreprocessingNode: mean and scale must have one entry per output channel");
+        }
+
+        // The center crop is the largest region with the aspect ratio of the output
+        int cropRows = _inputRows;
+        int cropColumns = _inputColumns;
+        if (_centerCrop)
+        {
+            if (static_cast<int64_t>(_inputRows) * _outputColumns > static_cast<int64_t>(_inputColumns) * _outputRows)
+            {
+                cropRows = std::max(1, static_cast<int>(static_cast<int64_t>(_inputColumns) * _outputRows / _outputColumns));
+            }
+            else
+            {
+                cropColumns = std::max(1, static_cast<int>(static_cast<int64_t>(_inputRows) * _outputColumns / _outputRows));
+            }
+        }
+        _rows = GetSampleTable(_inputRows, cropRows, _outputRows);
+        _columns = GetSampleTable(_inputColumns, cropColumns, _outputColumns);
+
+        _output.SetMemoryLayout(model::PortMemoryLayout(model::MemoryShape{ _outputRows, _outputColumns, numOutputChannels }));
+    }
+
+    template <typename InputValueType, typename ValueType>
+    typename ImagePreprocessingNode<InputValueType, ValueType>::SampleTable ImagePreprocessingNode<InputValueType, ValueType>::GetSampleTable(int inputSize, int cropSize, int outputSize) const
+    {
+        // Output pixel i samples the crop at (i + 0.5) * cropSize / outputSize - 0.5, clamped to the crop, as OpenCV does
+        SampleTable table;
+        const int cropBegin = (inputSize - cropSize) / 2;
+        const double ratio = static_cast<double>(cropSize) / outputSize;
+        for (int index = 0; index < outputSize; ++index)
+        {
+            const double source = std::max((index + 0.5) * ratio - 0.5, 0.0);
+            const int index0 = std::min(static_cast<int>(source), cropSize - 1);
+            const int index1 = std::min(index0 + 1, cropSize - 1);
+            table.index0.push_back(cropBegin + index0);
+            table.index1.push_back(cropBegin + index1);
+            table.weight.push_back(index0 == index1 ? 0 : static_cast<ValueType>(source - index0));
+        }
+        return table;
+    }
+
+    template <typename InputValueType, typename ValueType>
+    ValueType ImagePreprocessingNode<InputValueType, ValueType>::GetInputValue(const std::vector<InputValueType>& input, int index) const
+    {
+        if (IsPackedInput<InputValueType>())
+        {
+            return static_cast<ValueType>(reinterpret_cast<const uint8_t*>(input.data())[index]);
+        }
+        return static_cast<ValueType>(input[index]);
+    }
+
+    template <typename InputValueType, typename ValueType>
+    void ImagePreprocessingNode<InputValueType, ValueType>::Compute() const
+    {
+        const auto input = _input.GetValue();
+        const int rowStride = _inputColumns * _inputChannels;
+        const int numOutputChannels = NumOutputChannels();
+        std::vector<ValueType> result(_output.Size());
+        for (int row = 0; row < _outputRows; ++row)
+        {
+            const int row0 = _rows.index0[row] * rowStride;
+            const int row1 = _rows.index1[row] * rowStride;
+            const auto rowWeight = _rows.weight[row];
+            for (int column = 0; column < _outputColumns; ++column)
+            {
+                const int column0 = _columns.index0[column] * _inputChannels;
+                const int column1 = _columns.index1[column] * _inputChannels;
+                const auto columnWeight = _columns.weight[column];
+                for (int channel = 0; channel < numOutputChannels; ++channel)
+                {
+                    const int source = _channelOrder[channel];
+                    const auto p00 = GetInputValue(input, row0 + column0 + source);
+                    const auto p01 = GetInputValue(input, row0 + column1 + source);
+                    const auto p10 = GetInputValue(input, row1 + column0 + source);
+                    const auto p11 = GetInputValue(input, row1 + column1 + source);
+                    const auto top = p00 + columnWeight * (p01 - p00);
+                    const auto bottom = p10 + columnWeight * (p11 - p10);
+                    const auto value = top + rowWeight * (bottom - top);
+                    result[(row * _outputColumns + column) * numOutputChannels + channel] = (value - _mean[channel]) * _scale[channel];
+                }
+            }
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename InputValueType, typename ValueType>
+    void ImagePreprocessingNode<InputValueType, ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<ImagePreprocessingNode<InputValueType, ValueType>>(newInput, _inputRows, _inputColumns, _outputRows, _outputColumns, _centerCrop, _channelOrder, _mean, _scale);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename InputValueType, typename ValueType>
+    emitters::LLVMValue ImagePreprocessingNode<InputValueType, ValueType>::EmitInputValue(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::IRLocalScalar index) const
+    {
+        auto value = function.ValueAt(input, index);
+        return IsPackedInput<InputValueType>() ? function.CastUnsignedValue<ValueType>(value) : function.CastValue<ValueType>(value);
+    }
+
+    template <typename InputValueType, typename ValueType>
+    void ImagePreprocessingNode<InputValueType, ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        if (IsPackedInput<InputValueType>())
+        {
+            pInput = function.CastPointer(pInput, emitters::VariableType::BytePointer);
+        }
+
+        // The sample tables, with the indices scaled to offsets into the input
+        auto& module = function.GetModule();
+        const int rowStride = _inputColumns * _inputChannels;
+        auto rowOffsets0 = module.ConstantArray(compiler.GetGlobalName(*this, "rowOffsets0"), Multiply(_rows.index0, rowStride));
+        auto rowOffsets1 = module.ConstantArray(compiler.GetGlobalName(*this, "rowOffsets1"), Multiply(_rows.index1, rowStride));
+        auto rowWeights = module.ConstantArray(compiler.GetGlobalName(*this, "rowWeights"), _rows.weight);
+        auto columnOffsets0 = module.ConstantArray(compiler.GetGlobalName(*this, "columnOffsets0"), Multiply(_columns.index0, _inputChannels));
+        auto columnOffsets1 = module.ConstantArray(compiler.GetGlobalName(*this, "columnOffsets1"), Multiply(_columns.index1, _inputChannels));
+        auto columnWeights = module.ConstantArray(compiler.GetGlobalName(*this, "columnWeights"), _columns.weight);
+
+        const int outputColumns = _outputColumns;
+        const int numOutputChannels = NumOutputChannels();
+        const auto channelOrder = _channelOrder;
+        const auto mean = _mean;
+        const auto scale = _scale;
+        function.For(_outputRows, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar row) {
+            auto row0 = function.LocalScalar(function.ValueAt(rowOffsets0, row));
+            auto row1 = function.LocalScalar(function.ValueAt(rowOffsets1, row));
+            auto rowWeight = function.LocalScalar(function.ValueAt(rowWeights, row));
+            function.For(outputColumns, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar column) {
+                auto column0 = function.LocalScalar(function.ValueAt(columnOffsets0, column));
+                auto column1 = function.LocalScalar(function.ValueAt(columnOffsets1, column));
+                auto columnWeight = function.LocalScalar(function.ValueAt(columnWeights, column));
+                auto outputOffset = (row * outputColumns + column) * numOutputChannels;
+
+                // The channels are few, so their loop is unrolled
+                for (int channel = 0; channel < numOutputChannels; ++channel)
+                {
+                    const int source = channelOrder[channel];
+                    auto p00 = function.LocalScalar(EmitInputValue(function, pInput, row0 + column0 + source));
+                    auto p01 = function.LocalScalar(EmitInputValue(function, pInput, row0 + column1 + source));
+                    auto p10 = function.LocalScalar(EmitInputValue(function, pInput, row1 + column0 + source));
+                    auto p11 = function.LocalScalar(EmitInputValue(function, pInput, row1 + column1 + source));
+                    auto top = p00 + columnWeight * (p01 - p00);
+                    auto bottom = p10 + columnWeight * (p11 - p10);
+                    auto value = top + rowWeight * (bottom - top);
+                    auto centered = mean[channel] != 0 ? value - mean[channel] : value;
+                    auto normalized = scale[channel] != 1 ? centered * scale[channel] : centered;
+                    function.SetValueAt(pOutput, outputOffset + channel, normalized);
+                }
+            });
+        });
+    }
+
+    template <typename InputValueType, typename ValueType>
+    void ImagePreprocessingNode<InputValueType, ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["inputRows"] << _inputRows;
+        archiver["inputColumns"] << _inputColumns;
+        archiver["outputRows"] << _outputRows;
+        archiver["outputColumns"] << _outputColumns;
+        archiver["centerCrop"] << _centerCrop;
+        archiver["channelOrder"] << _channelOrder;
+        archiver["mean"] << _mean;
+        archiver["scale"] << _scale;
+    }
+
+    template <typename InputValueType, typename ValueType>
+    void ImagePreprocessingNode<InputValueType, ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["inputRows"] >> _inputRows;
+        archiver["inputColumns"] >> _inputColumns;
+        archiver["outputRows"] >> _outputRows;
+        archiver["outputColumns"] >> _outputColumns;
+        archiver["centerCrop"] >> _centerCrop;
+        archiver["channelOrder"] >> _channelOrder;
+        archiver["mean"] >> _mean;
+        archiver["scale"] >> _scale;
+        Initialize();
+    }
+
+    // Explicit instantiations
+    template class ImagePreprocessingNode<float, float>;
+    template class ImagePreprocessingNode<double, double>;
+    template class ImagePreprocessingNode<int, float>;
+    template class ImagePreprocessingNode<int, double>;
+} // namespace nodes
+} // namespace ell
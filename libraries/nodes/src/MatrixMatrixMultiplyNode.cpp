@@ -7,10 +7,17 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "MatrixMatrixMultiplyNode.h"
+#include "ReorderDataNode.h"
+
+#include <emitters/include/IRSmallMatrixKernels.h>
 
 #include <math/include/Matrix.h>
 #include <math/include/MatrixOperations.h>
 
+#include <model/include/BatchedMap.h>
+
+#include <algorithm>
+
 namespace ell
 {
 namespace nodes
@@ -22,6 +29,9 @@ namespace nodes
         //
         constexpr utilities::ArchiveVersion currentArchiveVersion = { utilities::ArchiveVersionNumbers::v2 };
 
+        // The size of the blocks of output that are finished by the fused output operations right after they're computed
+        constexpr int outputBlockBytes = 32 * 1024;
+
         template <typename ValueType>
         void MatrixMatrixMultiply(bool transposeA, bool transposeB, bool transposeC, int m, int n, int k, const std::vector<ValueType>& matrixAValues, const std::vector<ValueType>& matrixBValues, std::vector<ValueType>& matrixCValues)
         {
@@ -173,7 +183,7 @@ namespace nodes
     }
 
     template <typename ValueType>
-    MatrixMatrixMultiplyNode<ValueType>::MatrixMatrixMultiplyNode(const model::OutputPort<ValueType>& input1, int m, int n, int k, int matrix1Stride, bool transpose1, const model::OutputPort<ValueType>& input2, int matrix2Stride, bool transpose2, int outputMatrixStride, bool transposeOutput) :
+    MatrixMatrixMultiplyNode<ValueType>::MatrixMatrixMultiplyNode(const model::OutputPort<ValueType>& input1, int m, int n, int k, int matrix1Stride, bool transpose1, const model::OutputPort<ValueType>& input2, int matrix2Stride, bool transpose2, int outputMatrixStride, bool transposeOutput, const FusedLinearActivation<ValueType>& outputOperations) :
         CompilableNode({ &_input1, &_input2 }, { &_output }),
         _input1(this, input1, defaultInput1PortName),
         _input2(this, input2, defaultInput2PortName),
@@ -186,7 +196,8 @@ namespace nodes
         _ldc(outputMatrixStride),
         _transpose1(transpose1),
         _transpose2(transpose2),
-        _transposeOutput(transposeOutput)
+        _transposeOutput(transposeOutput),
+        _outputOperations(outputOperations)
     {
         // TODO: reset output layout (incl. transpose info)
         if (static_cast<int>(input1.Size()) != m * k)
@@ -198,6 +209,24 @@ namespace nodes
         {
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input matrix 2 size incorrect");
         }
+
+        if (!_outputOperations.IsEmpty() && !CanFuseOutputOperations(_outputOperations.GetNumChannels()))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Output operations need a contiguous output made of whole pixels");
+        }
+    }
+
+    template <typename ValueType>
+    bool MatrixMatrixMultiplyNode<ValueType>::CanFuseOutputOperations(int numChannels) const
+    {
+        const auto rowLength = _transposeOutput ? _m : _n;
+        return _ldc == rowLength && (numChannels == 0 || rowLength % numChannels == 0);
+    }
+
+    template <typename ValueType>
+    MatrixMatrixMultiplyNode<ValueType>* MatrixMatrixMultiplyNode<ValueType>::AddNodeWithOutputOperations(model::ModelTransformer& transformer, const FusedLinearActivation<ValueType>& outputOperations) const
+    {
+        return transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(_input1.GetReferencedPort(), _m, _n, _k, _lda, _transpose1, _input2.GetReferencedPort(), _ldb, _transpose2, _ldc, _transposeOutput, outputOperations);
     }
 
     template <typename ValueType>
@@ -218,6 +247,7 @@ namespace nodes
         math::RowMatrixReference<ValueType> outputMatrixRef(outputMatrixValues.data(), _m, _n);
 
         MatrixMatrixMultiply(_transpose1, _transpose2, _transposeOutput, (int)_m, (int)_n, (int)_k, inputMatrix1Values, inputMatrix2Values, outputMatrixValues);
+        _outputOperations.Apply(outputMatrixValues);
 
         _output.SetOutput(outputMatrixValues);
     };
@@ -227,10 +257,59 @@ namespace nodes
     {
         const auto& PortElements1 = transformer.GetCorrespondingInputs(_input1);
         const auto& PortElements2 = transformer.GetCorrespondingInputs(_input2);
-        auto newNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(PortElements1, _m, _n, _k, _lda, _transpose1, PortElements2, _ldb, _transpose2, _ldc, _transposeOutput);
+        auto newNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(PortElements1, _m, _n, _k, _lda, _transpose1, PortElements2, _ldb, _transpose2, _ldc, _transposeOutput, _outputOperations);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
+    template <typename ValueType>
+    bool MatrixMatrixMultiplyNode<ValueType>::Batch(model::ModelTransformer& transformer, model::BatchContext& batch) const
+    {
+        const auto& port1 = _input1.GetReferencedPort();
+        const auto& port2 = _input2.GetReferencedPort();
+        const auto isBatched1 = batch.IsBatched(port1);
+        const auto isBatched2 = batch.IsBatched(port2);
+        const auto batchSize = batch.GetBatchSize();
+
+        // The batched output is stacked like a flat output of each sample
+        if (isBatched1 == isBatched2 || _output.GetMemoryLayout().NumDimensions() != 1)
+        {
+            return false;
+        }
+
+        if (isBatched1)
+        {
+            // Stacking the left-hand matrices stacks the products
+            auto stacked1 = _transpose1 || _transposeOutput || _lda != _k || _ldc != _n ? nullptr : batch.GetStackedPort(transformer, port1);
+            if (stacked1 == nullptr)
+            {
+                return false;
+            }
+
+            const auto& newInput1 = static_cast<const model::OutputPort<ValueType>&>(*stacked1);
+            const auto& newInput2 = transformer.GetCorrespondingInputs(_input2);
+            auto newNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(newInput1, batchSize * _m, _n, _k, _lda, false, newInput2, _ldb, _transpose2, _ldc, false, _outputOperations);
+            batch.SetStackedPort(_output, newNode->output);
+            return true;
+        }
+
+        // Putting the right-hand matrices side by side puts the products side by side, and transposing that output
+        // stacks them. This is the product of the weights and the receptive field matrices of an unrolled convolution.
+        auto stacked2 = _transpose2 || !_transposeOutput || _ldb != _n || _ldc != _m ? nullptr : batch.GetStackedPort(transformer, port2);
+        if (stacked2 == nullptr)
+        {
+            return false;
+        }
+
+        model::PortMemoryLayout stackedLayout(model::MemoryShape{ batchSize, _k, _n });
+        model::PortMemoryLayout sideBySideLayout(model::MemoryShape{ _k, batchSize, _n }, model::DimensionOrder{ 1, 0, 2 });
+        auto reorderNode = transformer.AddNode<ReorderDataNode<ValueType>>(static_cast<const model::OutputPort<ValueType>&>(*stacked2), stackedLayout, sideBySideLayout);
+
+        const auto& newInput1 = transformer.GetCorrespondingInputs(_input1);
+        auto newNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(newInput1, _m, batchSize * _n, _k, _lda, _transpose1, reorderNode->output, batchSize * _n, false, _ldc, true, _outputOperations);
+        batch.SetStackedPort(_output, newNode->output);
+        return true;
+    }
+
     template <typename ValueType>
     void MatrixMatrixMultiplyNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -238,13 +317,77 @@ namespace nodes
         emitters::LLVMValue pInput2 = compiler.EnsurePortEmitted(input2);
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
 
+        // Small products are emitted as unrolled code instead of a BLAS call
+        const bool useSmallMatrixKernel = emitters::UseSmallMatrixKernel(function.GetCompilerOptions(), (int)(_m * _n * _k));
+        if (!_outputOperations.IsEmpty() && !useSmallMatrixKernel)
+        {
+            EmitBlockedGEMM(compiler, function, pInput1, pInput2, pOutput);
+            return;
+        }
+
         if (_transposeOutput)
         {
-            function.CallGEMM<ValueType>(!_transpose2, !_transpose1, (int)_n, (int)_m, (int)_k, pInput2, (int)_ldb, pInput1, (int)_lda, pOutput, (int)_ldc);
+            if (useSmallMatrixKernel)
+            {
+                emitters::EmitSmallGEMM<ValueType>(function, !_transpose2, !_transpose1, (int)_n, (int)_m, (int)_k, pInput2, (int)_ldb, pInput1, (int)_lda, pOutput, (int)_ldc);
+            }
+            else
+            {
+                function.CallGEMM<ValueType>(!_transpose2, !_transpose1, (int)_n, (int)_m, (int)_k, pInput2, (int)_ldb, pInput1, (int)_lda, pOutput, (int)_ldc);
+            }
         }
         else
         {
-            function.CallGEMM<ValueType>(_transpose1, _transpose2, (int)_m, (int)_n, (int)_k, pInput1, (int)_lda, pInput2, (int)_ldb, pOutput, (int)_ldc);
+            if (useSmallMatrixKernel)
+            {
+                emitters::EmitSmallGEMM<ValueType>(function, _transpose1, _transpose2, (int)_m, (int)_n, (int)_k, pInput1, (int)_lda, pInput2, (int)_ldb, pOutput, (int)_ldc);
+            }
+            else
+            {
+                function.CallGEMM<ValueType>(_transpose1, _transpose2, (int)_m, (int)_n, (int)_k, pInput1, (int)_lda, pInput2, (int)_ldb, pOutput, (int)_ldc);
+            }
+        }
+
+        if (!_outputOperations.IsEmpty())
+        {
+            auto coefficients = _outputOperations.EmitCoefficients(compiler, *this, function);
+            _outputOperations.EmitApply(function, coefficients, pOutput, _m * _n);
+        }
+    }
+
+    template <typename ValueType>
+    void MatrixMatrixMultiplyNode<ValueType>::EmitBlockedGEMM(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, emitters::LLVMValue pInput1, emitters::LLVMValue pInput2, emitters::LLVMValue pOutput)
+    {
+        // The product is computed a block of stored output rows at a time, and the output operations are applied to
+        // each block right after it's computed, while it's still in the cache, instead of in another pass over the output
+        const auto numRows = _transposeOutput ? _n : _m;
+        const auto rowLength = _transposeOutput ? _m : _n;
+        const auto blockRows = std::max(outputBlockBytes / static_cast<int>(sizeof(ValueType) * rowLength), 1);
+        const auto numFullBlocks = numRows / blockRows;
+        const auto coefficients = _outputOperations.EmitCoefficients(compiler, *this, function);
+
+        auto emitBlock = [&](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar firstRow, int numBlockRows) {
+            auto pBlockOutput = function.PointerOffset(pOutput, firstRow * _ldc);
+            if (_transposeOutput)
+            {
+                // Rows of C' = B' * A' are rows of op(B')
+                auto pBlockInput2 = function.PointerOffset(pInput2, _transpose2 ? firstRow * _ldb : firstRow);
+                function.CallGEMM<ValueType>(!_transpose2, !_transpose1, numBlockRows, (int)_m, (int)_k, pBlockInput2, (int)_ldb, pInput1, (int)_lda, pBlockOutput, (int)_ldc);
+            }
+            else
+            {
+                auto pBlockInput1 = function.PointerOffset(pInput1, _transpose1 ? firstRow : firstRow * _lda);
+                function.CallGEMM<ValueType>(_transpose1, _transpose2, numBlockRows, (int)_n, (int)_k, pBlockInput1, (int)_lda, pInput2, (int)_ldb, pBlockOutput, (int)_ldc);
+            }
+            _outputOperations.EmitApply(function, coefficients, pBlockOutput, numBlockRows * rowLength);
+        };
+
+        function.For(numFullBlocks, [&](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockIndex) {
+            emitBlock(function, function.LocalScalar(blockIndex) * blockRows, blockRows);
+        });
+        if (numRows % blockRows != 0)
+        {
+            emitBlock(function, function.LocalScalar(numFullBlocks * blockRows), numRows % blockRows);
         }
     }
 
@@ -276,6 +419,7 @@ namespace nodes
         archiver["transpose1"] << _transpose1;
         archiver["transpose2"] << _transpose2;
         archiver["transposeOutput"] << _transposeOutput;
+        _outputOperations.WriteToArchive(archiver);
     }
 
     template <typename ValueType>
@@ -295,6 +439,7 @@ namespace nodes
         archiver["transpose1"] >> _transpose1;
         archiver["transpose2"] >> _transpose2;
         archiver.OptionalProperty("transposeOutput", false) >> _transposeOutput;
+        _outputOperations.ReadFromArchive(archiver);
     }
 
     // Explicitly instantiate versions
@@ -7,14 +7,30 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "MatrixVectorMultiplyNode.h"
+#include "ConstantNode.h"
+#include "MatrixMatrixMultiplyNode.h"
+
+#include <emitters/include/IRSmallMatrixKernels.h>
 
 #include <math/include/Matrix.h>
 #include <math/include/MatrixOperations.h>
 
+#include <model/include/BatchedMap.h>
+
 namespace ell
 {
 namespace nodes
 {
+    namespace
+    {
+        template <typename ValueType>
+        const ConstantNode<ValueType>* GetConstantInputNode(const model::InputPort<ValueType>& input)
+        {
+            auto node = dynamic_cast<const ConstantNode<ValueType>*>(input.GetReferencedPort().GetNode());
+            return node != nullptr && node->GetValues().size() == input.Size() ? node : nullptr;
+        }
+    } // namespace
+
     template <typename ValueType>
     MatrixVectorMultiplyNode<ValueType>::MatrixVectorMultiplyNode() :
         CompilableNode({ &_inputMatrix, &_inputVector }, { &_output }),
@@ -29,7 +45,7 @@ namespace nodes
     }
 
     template <typename ValueType>
-    MatrixVectorMultiplyNode<ValueType>::MatrixVectorMultiplyNode(const model::OutputPort<ValueType>& inputMatrix, size_t m, size_t n, size_t matrixStride, const model::OutputPort<ValueType>& inputVector) :
+    MatrixVectorMultiplyNode<ValueType>::MatrixVectorMultiplyNode(const model::OutputPort<ValueType>& inputMatrix, size_t m, size_t n, size_t matrixStride, const model::OutputPort<ValueType>& inputVector, const FusedLinearActivation<ValueType>& outputOperations) :
         CompilableNode({ &_inputMatrix, &_inputVector }, { &_output }),
         _inputMatrix(this, inputMatrix, inputMatrixPortName),
         _inputVector(this, inputVector, inputVectorPortName),
@@ -37,7 +53,8 @@ namespace nodes
         _m(m),
         _n(n),
         _lda(matrixStride),
-        _incx(1)
+        _incx(1),
+        _outputOperations(outputOperations)
     {
         if (inputMatrix.Size() != m * n)
         {
@@ -48,6 +65,17 @@ namespace nodes
         {
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input sizes must match");
         }
+
+        if (!CanFuseOutputOperations(_outputOperations.GetNumChannels()))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Output operations need an output made of whole pixels");
+        }
+    }
+
+    template <typename ValueType>
+    MatrixVectorMultiplyNode<ValueType>* MatrixVectorMultiplyNode<ValueType>::AddNodeWithOutputOperations(model::ModelTransformer& transformer, const FusedLinearActivation<ValueType>& outputOperations) const
+    {
+        return transformer.AddNode<MatrixVectorMultiplyNode<ValueType>>(_inputMatrix.GetReferencedPort(), _m, _n, _lda, _inputVector.GetReferencedPort(), outputOperations);
     }
 
     template <typename ValueType>
@@ -64,6 +92,7 @@ namespace nodes
         math::ColumnVectorReference<ValueType> outputVectorRef(outputVectorValues.data(), _m);
 
         math::MultiplyScaleAddUpdate(static_cast<ValueType>(1.0), inputMatrixRef, inputVectorRef, static_cast<ValueType>(0.0), outputVectorRef);
+        _outputOperations.Apply(outputVectorValues);
 
         _output.SetOutput(outputVectorValues);
     };
@@ -73,10 +102,35 @@ namespace nodes
     {
         const auto& matrixElements = transformer.GetCorrespondingInputs(_inputMatrix);
         const auto& vectorElements = transformer.GetCorrespondingInputs(_inputVector);
-        auto newNode = transformer.AddNode<MatrixVectorMultiplyNode<ValueType>>(matrixElements, _m, _n, _lda, vectorElements);
+        auto newNode = transformer.AddNode<MatrixVectorMultiplyNode<ValueType>>(matrixElements, _m, _n, _lda, vectorElements, _outputOperations);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
+    template <typename ValueType>
+    bool MatrixVectorMultiplyNode<ValueType>::Batch(model::ModelTransformer& transformer, model::BatchContext& batch) const
+    {
+        if (batch.IsBatched(_inputMatrix.GetReferencedPort()))
+        {
+            return false;
+        }
+
+        auto stackedVectors = batch.GetStackedPort(transformer, _inputVector.GetReferencedPort());
+        if (stackedVectors == nullptr)
+        {
+            return false;
+        }
+
+        // With the same matrix for every sample, the batch is a single matrix product: the vectors are the rows of X,
+        // and the rows of X * A^T are the products of A with each of them
+        const auto& matrix = transformer.GetCorrespondingInputs(_inputMatrix);
+        const auto& vectors = static_cast<const model::OutputPort<ValueType>&>(*stackedVectors);
+        const auto m = static_cast<int>(_m);
+        const auto n = static_cast<int>(_n);
+        auto newNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(vectors, batch.GetBatchSize(), m, n, n, false, matrix, static_cast<int>(_lda), true, m, false, _outputOperations);
+        batch.SetStackedPort(_output, newNode->output);
+        return true;
+    }
+
     template <typename ValueType>
     void MatrixVectorMultiplyNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -84,7 +138,31 @@ namespace nodes
         emitters::LLVMValue pInputVector = compiler.EnsurePortEmitted(inputVector);
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
 
-        function.CallGEMV<ValueType>((int)_m, (int)_n, pInputMatrix, (int)_lda, pInputVector, _incx, pOutput, 1);
+        // Small products are emitted as unrolled code, with the weights baked in if they're constant and stay in the module
+        const auto& compilerSettings = function.GetCompilerOptions();
+        if (emitters::UseSmallMatrixKernel(compilerSettings, (int)(_m * _n)))
+        {
+            auto matrixNode = GetConstantInputNode(inputMatrix);
+            if (matrixNode != nullptr && !compilerSettings.externalWeights)
+            {
+                emitters::EmitSmallGEMV<ValueType>(function, (int)_m, (int)_n, matrixNode->GetValues(), (int)_lda, pInputVector, _incx, pOutput, 1);
+            }
+            else
+            {
+                emitters::EmitSmallGEMV<ValueType>(function, (int)_m, (int)_n, pInputMatrix, (int)_lda, pInputVector, _incx, pOutput, 1);
+            }
+        }
+        else
+        {
+            function.CallGEMV<ValueType>((int)_m, (int)_n, pInputMatrix, (int)_lda, pInputVector, _incx, pOutput, 1);
+        }
+
+        // The output is a single vector, so it's still in the cache when the output operations are applied
+        if (!_outputOperations.IsEmpty())
+        {
+            auto coefficients = _outputOperations.EmitCoefficients(compiler, *this, function);
+            _outputOperations.EmitApply(function, coefficients, pOutput, (int)_m);
+        }
     }
 
     template <typename ValueType>
@@ -98,6 +176,7 @@ namespace nodes
         archiver["n"] << _n;
         archiver["lda"] << _lda;
         archiver["incx"] << _incx;
+        _outputOperations.WriteToArchive(archiver);
     }
 
     template <typename ValueType>
@@ -111,6 +190,7 @@ namespace nodes
         archiver["n"] >> _n;
         archiver["lda"] >> _lda;
         archiver["incx"] >> _incx;
+        _outputOperations.ReadFromArchive(archiver);
     }
 
     // Explicitly instantiate versions
@@ -0,0 +1,343 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MultichannelFFTNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MultichannelFFTNode.h"
+
+#include <emitters/include/EmitterTypes.h>
+#include <emitters/include/IRLocalScalar.h>
+#include <emitters/include/IRVectorUtilities.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        using emitters::IRFunctionEmitter;
+        using emitters::IRLocalScalar;
+        using emitters::LLVMType;
+        using emitters::LLVMValue;
+
+        // The values of a block of channels are vectors of `blockSize` values, or scalars if `blockSize` is 1
+        template <typename ValueType>
+        LLVMType GetBlockType(IRFunctionEmitter& function, int blockSize)
+        {
+            const auto valueType = emitters::GetVariableType<ValueType>();
+            return blockSize > 1 ? function.GetEmitter().VectorType(valueType, blockSize) : function.GetEmitter().Type(valueType);
+        }
+
+        template <typename ValueType>
+        LLVMValue LoadBlock(IRFunctionEmitter& function, LLVMValue pointer, IRLocalScalar offset, int blockSize)
+        {
+            return blockSize > 1 ? emitters::LoadVector<ValueType>(function, pointer, offset, blockSize) : function.ValueAt(pointer, offset);
+        }
+
+        template <typename ValueType>
+        void StoreBlock(IRFunctionEmitter& function, LLVMValue pointer, IRLocalScalar offset, LLVMValue value, int blockSize)
+        {
+            if (blockSize > 1)
+            {
+                emitters::StoreVector<ValueType>(function, pointer, offset, value);
+            }
+            else
+            {
+                function.SetValueAt(pointer, offset, value);
+            }
+        }
+
+        template <typename ValueType>
+        LLVMValue Splat(IRFunctionEmitter& function, LLVMValue value, int blockSize)
+        {
+            return blockSize > 1 ? emitters::BroadcastToVector<ValueType>(function, blockSize, value) : value;
+        }
+
+        // A complex value of each channel of a block
+        struct BlockComplex
+        {
+            LLVMValue re;
+            LLVMValue im;
+        };
+
+        // Emits the complex arithmetic of the butterflies on blocks of channels
+        template <typename ValueType>
+        struct BlockArithmetic
+        {
+            LLVMValue Add(LLVMValue a, LLVMValue b) const { return function.Operator(emitters::GetAddForValueType<ValueType>(), a, b); }
+            LLVMValue Subtract(LLVMValue a, LLVMValue b) const { return function.Operator(emitters::GetSubtractForValueType<ValueType>(), a, b); }
+            LLVMValue Multiply(LLVMValue a, LLVMValue b) const { return function.Operator(emitters::GetMultiplyForValueType<ValueType>(), a, b); }
+
+            BlockComplex Add(BlockComplex a, BlockComplex b) const { return { Add(a.re, b.re), Add(a.im, b.im) }; }
+            BlockComplex Subtract(BlockComplex a, BlockComplex b) const { return { Subtract(a.re, b.re), Subtract(a.im, b.im) }; }
+            BlockComplex Multiply(BlockComplex a, BlockComplex b) const { return { Subtract(Multiply(a.re, b.re), Multiply(a.im, b.im)), Add(Multiply(a.re, b.im), Multiply(a.im, b.re)) }; }
+            BlockComplex TimesI(BlockComplex a) const { return { Subtract(Splat<ValueType>(function, function.Literal<ValueType>(0), blockSize), a.im), a.re }; }
+
+            LLVMValue Abs(BlockComplex a) const
+            {
+                auto sqrt = function.GetModule().GetRuntime().GetSqrtFunction(GetBlockType<ValueType>(function, blockSize));
+                return function.Call(sqrt, { Add(Multiply(a.re, a.re), Multiply(a.im, a.im)) });
+            }
+
+            BlockComplex Load(LLVMValue data, IRLocalScalar index) const { return { function.ValueAt(data, index * 2), function.ValueAt(data, index * 2 + 1) }; }
+
+            void Store(LLVMValue data, IRLocalScalar index, BlockComplex value) const
+            {
+                function.SetValueAt(data, index * 2, value.re);
+                function.SetValueAt(data, index * 2 + 1, value.im);
+            }
+
+            // Loads the twiddle factor w^index, the same for every channel
+            BlockComplex LoadTwiddle(LLVMValue twiddles, IRLocalScalar index) const
+            {
+                return { Splat<ValueType>(function, function.ValueAt(twiddles, index * 2), blockSize), Splat<ValueType>(function, function.ValueAt(twiddles, index * 2 + 1), blockSize) };
+            }
+
+            IRFunctionEmitter& function;
+            int blockSize;
+        };
+
+        template <typename ValueType>
+        std::vector<ValueType> GetInterleavedTwiddleFactors(const dsp::FFTPlan<ValueType>& plan)
+        {
+            std::vector<ValueType> result;
+            for (const auto& w : plan.GetTwiddleFactors())
+            {
+                result.push_back(w.real());
+                result.push_back(w.imag());
+            }
+            return result;
+        }
+    } // namespace
+
+    template <typename ValueType>
+    MultichannelFFTNode<ValueType>::MultichannelFFTNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    MultichannelFFTNode<ValueType>::MultichannelFFTNode(const model::OutputPort<ValueType>& input, size_t numChannels, size_t fftSize) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0),
+        _numChannels(numChannels),
+        _fftSize(fftSize)
+    {
+        Initialize();
+    }
+
+    template <typename ValueType>
+    void MultichannelFFTNode<ValueType>::Initialize()
+    {
+        if (_numChannels == 0 || _input.Size() % _numChannels != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "MultichannelFFTNode: input size must be a multiple of the number of channels");
+        }
+        _plan = dsp::FFTPlan<ValueType>(_fftSize);
+        _output.SetSize((_fftSize / 2) * _numChannels);
+    }
+
+    template <typename ValueType>
+    void MultichannelFFTNode<ValueType>::Compute() const
+    {
+        const auto numSamples = std::min(_input.Size() / _numChannels, _fftSize);
+        std::vector<ValueType> signal(_fftSize);
+        std::vector<std::complex<ValueType>> spectrum(_fftSize / 2 + 1);
+        std::vector<ValueType> result(_output.Size());
+        for (size_t channel = 0; channel < _numChannels; ++channel)
+        {
+            std::fill(signal.begin(), signal.end(), ValueType{ 0 });
+            for (size_t index = 0; index < numSamples; ++index)
+            {
+                signal[index] = _input[index * _numChannels + channel];
+            }
+            _plan.TransformReal(signal.data(), spectrum.data());
+            for (size_t index = 0; index < _fftSize / 2; ++index)
+            {
+                result[index * _numChannels + channel] = std::abs(spectrum[index]);
+            }
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void MultichannelFFTNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<MultichannelFFTNode<ValueType>>(newInput, _numChannels, _fftSize);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void MultichannelFFTNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        if (_fftSize < 2)
+        {
+            return;
+        }
+
+        // Zero-pad the input up to the FFT size
+        const int numChannels = static_cast<int>(_numChannels);
+        const int numValues = static_cast<int>(std::min(_input.Size() / _numChannels, _fftSize) * _numChannels);
+        const int fftValues = static_cast<int>(_fftSize) * numChannels;
+        emitters::LLVMValue signal = pInput;
+        if (numValues < fftValues)
+        {
+            signal = function.Variable(emitters::GetVariableType<ValueType>(), fftValues);
+            function.For(numValues, [pInput, signal](emitters::IRFunctionEmitter& function, IRLocalScalar index) {
+                function.SetValueAt(signal, index, function.ValueAt(pInput, index));
+            });
+            function.For(numValues, fftValues, [signal](emitters::IRFunctionEmitter& function, IRLocalScalar index) {
+                function.SetValueAt(signal, index, function.Literal<ValueType>(0));
+            });
+        }
+
+        // One set of tables for all the channels
+        auto& module = function.GetModule();
+        auto twiddles = module.ConstantArray(compiler.GetGlobalName(*this, "twiddles"), GetInterleavedTwiddleFactors(_plan));
+        auto bitReversal = module.ConstantArray(compiler.GetGlobalName(*this, "bitReversal"), _plan.GetBitReversalPermutation(_fftSize / 2));
+
+        // Transform the channels in blocks of the vector width, and the leftover channels one at a time
+        const auto& compilerSettings = function.GetCompilerOptions();
+        const int vectorSize = compilerSettings.allowVectorInstructions ? compilerSettings.vectorWidth : 1;
+        const int numVectorBlocks = vectorSize > 1 ? numChannels / vectorSize : 0;
+        const int firstScalarChannel = numVectorBlocks * vectorSize;
+        if (numVectorBlocks > 0)
+        {
+            function.For(numVectorBlocks, [=](emitters::IRFunctionEmitter& function, IRLocalScalar blockIndex) {
+                EmitChannelBlock(function, signal, pOutput, twiddles, bitReversal, blockIndex * vectorSize, vectorSize);
+            });
+        }
+        if (firstScalarChannel < numChannels)
+        {
+            function.For(firstScalarChannel, numChannels, 1, [=](emitters::IRFunctionEmitter& function, IRLocalScalar channel) {
+                EmitChannelBlock(function, signal, pOutput, twiddles, bitReversal, channel, 1);
+            });
+        }
+    }
+
+    template <typename ValueType>
+    void MultichannelFFTNode<ValueType>::EmitChannelBlock(emitters::IRFunctionEmitter& function, emitters::LLVMValue signal, emitters::LLVMValue output, emitters::LLVMValue twiddles, emitters::LLVMValue bitReversal, emitters::LLVMValue channelValue, int blockSize) const
+    {
+        const int numChannels = static_cast<int>(_numChannels);
+        const int halfSize = static_cast<int>(_fftSize / 2);
+        const auto channel = function.LocalScalar(channelValue);
+        const BlockArithmetic<ValueType> block{ function, blockSize };
+
+        // Pack the even and odd samples into the real and imaginary parts of a complex signal z of half the size, in
+        // bit-reversed order, as `dsp::FFTPlan::TransformReal` does
+        LLVMValue buffer = function.Variable(GetBlockType<ValueType>(function, blockSize), 2 * halfSize);
+        function.For(halfSize, [=](IRFunctionEmitter& function, IRLocalScalar index) {
+            auto sourceIndex = function.LocalScalar(function.ValueAt(bitReversal, index));
+            auto re = LoadBlock<ValueType>(function, signal, (sourceIndex * 2) * numChannels + channel, blockSize);
+            auto im = LoadBlock<ValueType>(function, signal, (sourceIndex * 2 + 1) * numChannels + channel, blockSize);
+            BlockArithmetic<ValueType>{ function, blockSize }.Store(buffer, index, { re, im });
+        });
+
+        if (halfSize == 2)
+        {
+            auto zero = function.LocalScalar(0);
+            auto one = function.LocalScalar(1);
+            auto x0 = block.Load(buffer, zero);
+            auto x1 = block.Load(buffer, one);
+            block.Store(buffer, zero, block.Add(x0, x1));
+            block.Store(buffer, one, block.Subtract(x0, x1));
+        }
+        else if (halfSize >= 4)
+        {
+            // The first two radix-2 stages together: with twiddle factors 1 and i, they need no multiplications
+            function.For(halfSize / 4, [=](IRFunctionEmitter& function, IRLocalScalar group) {
+                const BlockArithmetic<ValueType> block{ function, blockSize };
+                auto index = group * 4;
+                auto x0 = block.Load(buffer, index);
+                auto x1 = block.Load(buffer, index + 1);
+                auto x2 = block.Load(buffer, index + 2);
+                auto x3 = block.Load(buffer, index + 3);
+                auto sum01 = block.Add(x0, x1);
+                auto diff01 = block.Subtract(x0, x1);
+                auto sum23 = block.Add(x2, x3);
+                auto iDiff23 = block.TimesI(block.Subtract(x2, x3));
+                block.Store(buffer, index, block.Add(sum01, sum23));
+                block.Store(buffer, index + 1, block.Add(diff01, iDiff23));
+                block.Store(buffer, index + 2, block.Subtract(sum01, sum23));
+                block.Store(buffer, index + 3, block.Subtract(diff01, iDiff23));
+            });
+
+            // The remaining radix-2 stages. The twiddle factors of the transform of size N/2 are every other one of size N.
+            for (int stageLength = 8; stageLength <= halfSize; stageLength *= 2)
+            {
+                const int halfLength = stageLength / 2;
+                const int stride = 2 * (halfSize / stageLength);
+                function.For(halfSize / stageLength, [=](IRFunctionEmitter& function, IRLocalScalar group) {
+                    auto begin = group * stageLength;
+                    function.For(halfLength, [=](IRFunctionEmitter& function, IRLocalScalar k) {
+                        const BlockArithmetic<ValueType> block{ function, blockSize };
+                        auto w = block.LoadTwiddle(twiddles, k * stride);
+                        auto evenIndex = begin + k;
+                        auto oddIndex = evenIndex + halfLength;
+                        auto e = block.Load(buffer, evenIndex);
+                        auto wo = block.Multiply(w, block.Load(buffer, oddIndex));
+                        block.Store(buffer, evenIndex, block.Add(e, wo));
+                        block.Store(buffer, oddIndex, block.Subtract(e, wo));
+                    });
+                });
+            }
+        }
+
+        // Separate the transforms of the evens (E) and odds (O) and combine them into the magnitudes of the spectrum:
+        //   X[k] = E[k] + w^k * O[k], and |X[N/2-k]| = |E[k] - w^k * O[k]|
+        auto half = Splat<ValueType>(function, function.Literal<ValueType>(0.5), blockSize);
+        auto z0 = block.Load(buffer, function.LocalScalar(0));
+        auto abs = function.GetModule().GetRuntime().GetAbsFunction(GetBlockType<ValueType>(function, blockSize));
+        StoreBlock<ValueType>(function, output, channel, function.Call(abs, { block.Add(z0.re, z0.im) }), blockSize);
+        function.For(1, halfSize / 2 + 1, [=](IRFunctionEmitter& function, IRLocalScalar k) {
+            const BlockArithmetic<ValueType> block{ function, blockSize };
+            auto mirrorIndex = function.LocalScalar(halfSize) - k;
+            auto zk = block.Load(buffer, k);
+            auto zMirror = block.Load(buffer, mirrorIndex);
+            BlockComplex e = { block.Multiply(block.Add(zk.re, zMirror.re), half), block.Multiply(block.Subtract(zk.im, zMirror.im), half) };
+            BlockComplex o = { block.Multiply(block.Add(zk.im, zMirror.im), half), block.Multiply(block.Subtract(zMirror.re, zk.re), half) };
+            auto wo = block.Multiply(block.LoadTwiddle(twiddles, k), o);
+            StoreBlock<ValueType>(function, output, k * numChannels + channel, block.Abs(block.Add(e, wo)), blockSize);
+            StoreBlock<ValueType>(function, output, mirrorIndex * numChannels + channel, block.Abs(block.Subtract(e, wo)), blockSize);
+        });
+    }
+
+    template <typename ValueType>
+    void MultichannelFFTNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["numChannels"] << _numChannels;
+        archiver["fftSize"] << _fftSize;
+    }
+
+    template <typename ValueType>
+    void MultichannelFFTNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["numChannels"] >> _numChannels;
+        archiver["fftSize"] >> _fftSize;
+        Initialize();
+    }
+
+    // Explicit instantiations
+    template class MultichannelFFTNode<float>;
+    template class MultichannelFFTNode<double>;
+} // namespace nodes
+} // namespace ell
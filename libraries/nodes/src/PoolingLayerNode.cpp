@@ -9,6 +9,9 @@
 #include "PoolingLayerNode.h"
 #include "ConstantNode.h"
 
+#include <emitters/include/IRLoopTiling.h>
+#include <emitters/include/IRVectorUtilities.h>
+
 #include <predictors/neural/include/MaxPoolingFunction.h>
 #include <predictors/neural/include/MeanPoolingFunction.h>
 
@@ -71,6 +74,73 @@ namespace nodes
             }
             return result;
         }
+
+        // The (row, column, channel) data isn't aligned to the vector size, so load and store vectors with the element alignment
+        emitters::LLVMValue LoadVector(emitters::IRFunctionEmitter& function, emitters::LLVMValue pointer, emitters::LLVMType vectorPointerType, unsigned alignment)
+        {
+            auto vectorPointer = function.CastPointer(pointer, vectorPointerType);
+            return function.GetEmitter().GetIRBuilder().CreateAlignedLoad(vectorPointer, alignment);
+        }
+
+        void StoreVector(emitters::IRFunctionEmitter& function, emitters::LLVMValue pointer, emitters::LLVMType vectorPointerType, unsigned alignment, emitters::LLVMValue value)
+        {
+            auto vectorPointer = function.CastPointer(pointer, vectorPointerType);
+            function.GetEmitter().GetIRBuilder().CreateAlignedStore(value, vectorPointer, alignment);
+        }
+
+        // Pools a vector of consecutive channels over the part of the window given by the region bounds. The loops over
+        // the window are unrolled, and max pooling selects rather than branches.
+        template <typename ValueType>
+        emitters::LLVMValue GetVectorPoolingWindowValue(emitters::IRFunctionEmitter& function,
+                                                        bool isMaxPooling,
+                                                        int windowSize,
+                                                        ValueType paddingValue,
+                                                        const RegionBounds& rowBounds,
+                                                        const RegionBounds& columnBounds,
+                                                        emitters::IRLocalScalar inputRow,
+                                                        emitters::IRLocalScalar inputColumn,
+                                                        emitters::IRLocalScalar inputChannel,
+                                                        emitters::LLVMValue inputBuffer,
+                                                        const model::MemoryShape& inputIncrement,
+                                                        llvm::VectorType* vectorType)
+        {
+            const int numCells = (rowBounds.windowBounds.end - rowBounds.windowBounds.begin) * (columnBounds.windowBounds.end - columnBounds.windowBounds.begin);
+            const unsigned alignment = sizeof(ValueType);
+
+            // As in the scalar version, a window that hangs off the edge of the input includes the padding value in its maximum
+            emitters::LLVMValue result = nullptr;
+            if (isMaxPooling && numCells != windowSize * windowSize)
+            {
+                result = emitters::FillVector<ValueType>(function, vectorType, paddingValue);
+            }
+
+            for (int poolingRow = rowBounds.windowBounds.begin; poolingRow < rowBounds.windowBounds.end; ++poolingRow)
+            {
+                for (int poolingColumn = columnBounds.windowBounds.begin; poolingColumn < columnBounds.windowBounds.end; ++poolingColumn)
+                {
+                    auto inputIndex = ((inputRow + poolingRow) * inputIncrement[0]) + ((inputColumn + poolingColumn) * inputIncrement[1]) + inputChannel;
+                    auto value = LoadVector(function, function.PointerOffset(inputBuffer, inputIndex), vectorType->getPointerTo(), alignment);
+                    if (result == nullptr)
+                    {
+                        result = value;
+                    }
+                    else if (isMaxPooling)
+                    {
+                        result = function.Select(function.Comparison(emitters::TypedComparison::greaterThanFloat, value, result), value, result);
+                    }
+                    else
+                    {
+                        result = function.Operator(emitters::GetAddForValueType<ValueType>(), result, value);
+                    }
+                }
+            }
+
+            if (!isMaxPooling)
+            {
+                result = function.Operator(emitters::TypedOperator::divideFloat, result, emitters::FillVector<ValueType>(function, vectorType, static_cast<ValueType>(numCells)));
+            }
+            return result;
+        }
     } // end anonymous namespace
 
     //
@@ -106,9 +176,9 @@ namespace nodes
 
         void Accumulate(emitters::IRFunctionEmitter& function, emitters::LLVMValue value)
         {
-            function.If(emitters::TypedComparison::greaterThanFloat, value, function.Load(_accumValueVar), [this, value](emitters::IRFunctionEmitter& function) {
-                function.Store(_accumValueVar, value);
-            });
+            auto accumValue = function.Load(_accumValueVar);
+            auto isGreater = function.Comparison(emitters::TypedComparison::greaterThanFloat, value, accumValue);
+            function.Store(_accumValueVar, function.Select(isGreater, value, accumValue));
         }
 
         emitters::LLVMValue GetValueAtPadding(emitters::IRFunctionEmitter& function)
@@ -462,6 +532,18 @@ namespace nodes
         auto inputBuffer = function.PointerOffset(pInput, inputBufferOffset);
         auto outputBuffer = function.PointerOffset(pOutput, outputBufferOffset);
 
+        // Channels are contiguous, so pool them in blocks of the vector width, and the leftover channels one at a time
+        const auto& compilerSettings = function.GetCompilerOptions();
+        const int vectorSize = compilerSettings.allowVectorInstructions ? compilerSettings.vectorWidth : 1;
+        const int numVectorBlocks = vectorSize > 1 ? outputDepth / vectorSize : 0;
+        const int firstScalarChannel = numVectorBlocks * vectorSize;
+        auto vectorType = numVectorBlocks > 0 ? function.GetEmitter().VectorType(emitters::GetVariableType<ValueType>(), vectorSize) : nullptr;
+        const bool isMaxPooling = std::is_same<FType, MaxPoolingFunction<ValueType>>::value;
+
+        // The output rows and columns of each region are tiled, so the input rows a tile's windows overlap on stay in the cache
+        const std::vector<emitters::LoopNestArrayAccess> arrays = { { { 0, 1 }, static_cast<size_t>(stride * stride * inputDepth) * sizeof(ValueType) },
+                                                                    { { 0, 1 }, static_cast<size_t>(outputDepth) * sizeof(ValueType) } };
+
         // Divide the output into regions that have different support over the pooling window. There are `windowSize` regions in each dimension.
         for (int rowsRegion = negWindowExtent; rowsRegion <= posWindowExtent; ++rowsRegion)
         {
@@ -482,32 +564,48 @@ namespace nodes
 
                 if (maxOutputRow > minOutputRow && maxOutputCol > minOutputCol)
                 {
+                    const auto tiledRanges = emitters::GetCacheTiledLoopRanges(function.GetCompilerOptions().targetDevice, { { minOutputRow, maxOutputRow }, { minOutputCol, maxOutputCol } }, arrays);
                     // BUG: explicit by-ref captures of `usesPadding` and `negWindowExtent` are here to work around a GCC bug
-                    function.For(minOutputRow, maxOutputRow, 1, [=, &outputIncrement, &usesPadding, &negWindowExtent, &poolingFunction](emitters::IRFunctionEmitter& function, emitters::LLVMValue loopIndex1) {
-                        auto outputRow = function.LocalScalar(loopIndex1);
-                        auto inputRow = outputRow * function.LocalScalar<int>(stride);
-                        if (!usesPadding)
-                        {
-                            inputRow = inputRow + function.LocalScalar<int>(-negWindowExtent);
-                        }
-
-                        function.For(minOutputCol, maxOutputCol, 1, [=, &outputIncrement, &poolingFunction, &inputRow](emitters::IRFunctionEmitter& function, emitters::LLVMValue loopIndex2) {
-                            auto outputColumn = function.LocalScalar(loopIndex2);
-                            auto inputColumn = outputColumn * function.LocalScalar<int>(stride);
+                    function.For(tiledRanges, [=, &outputIncrement, &usesPadding, &negWindowExtent, &poolingFunction](emitters::IRFunctionEmitter& function, std::vector<emitters::IRFunctionEmitter::BlockInterval> tiles) {
+                        function.For(tiles[0].begin, tiles[0].end, [=, &outputIncrement, &usesPadding, &negWindowExtent, &poolingFunction](emitters::IRFunctionEmitter& function, emitters::LLVMValue loopIndex1) {
+                            auto outputRow = function.LocalScalar(loopIndex1);
+                            auto inputRow = outputRow * function.LocalScalar<int>(stride);
                             if (!usesPadding)
                             {
-                                inputColumn = inputColumn + function.LocalScalar<int>(-negWindowExtent);
+                                inputRow = inputRow + function.LocalScalar<int>(-negWindowExtent);
                             }
 
-                            function.For(outputDepth, [=, &outputIncrement, &poolingFunction, &inputRow, &inputColumn](emitters::IRFunctionEmitter& function, emitters::LLVMValue loopIndex3) {
-                                auto channel = function.LocalScalar(loopIndex3);
-                                // Get the pooled value
-                                auto pooledValue = GetPoolingWindowValue(function, rowRegionBounds.windowBounds.begin, rowRegionBounds.windowBounds.end, columnRegionBounds.windowBounds.begin, columnRegionBounds.windowBounds.end, inputRow, inputColumn, channel, inputBuffer, inputIncrement, poolingFunction);
-                                // and store it in the output
-                                auto outputIndex = (outputRow * function.LocalScalar<int>(outputIncrement[0])) +
-                                                   (outputColumn * function.LocalScalar<int>(outputIncrement[1])) +
-                                                   channel;
-                                function.SetValueAt(outputBuffer, outputIndex, pooledValue);
+                            function.For(tiles[1].begin, tiles[1].end, [=, &outputIncrement, &poolingFunction, &inputRow](emitters::IRFunctionEmitter& function, emitters::LLVMValue loopIndex2) {
+                                auto outputColumn = function.LocalScalar(loopIndex2);
+                                auto inputColumn = outputColumn * function.LocalScalar<int>(stride);
+                                if (!usesPadding)
+                                {
+                                    inputColumn = inputColumn + function.LocalScalar<int>(-negWindowExtent);
+                                }
+
+                                if (numVectorBlocks > 0)
+                                {
+                                    function.For(numVectorBlocks, [=, &outputIncrement, &inputIncrement, &inputRow, &inputColumn](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockIndex) {
+                                        auto channel = function.LocalScalar(blockIndex) * vectorSize;
+                                        auto pooledValue = GetVectorPoolingWindowValue<ValueType>(function, isMaxPooling, windowSize, paddingValue, rowRegionBounds, columnRegionBounds, inputRow, inputColumn, channel, inputBuffer, inputIncrement, vectorType);
+                                        auto outputIndex = (outputRow * outputIncrement[0]) + (outputColumn * outputIncrement[1]) + channel;
+                                        StoreVector(function, function.PointerOffset(outputBuffer, outputIndex), vectorType->getPointerTo(), sizeof(ValueType), pooledValue);
+                                    });
+                                }
+
+                                if (firstScalarChannel < outputDepth)
+                                {
+                                    function.For(firstScalarChannel, outputDepth, 1, [=, &outputIncrement, &poolingFunction, &inputRow, &inputColumn](emitters::IRFunctionEmitter& function, emitters::LLVMValue loopIndex3) {
+                                        auto channel = function.LocalScalar(loopIndex3);
+                                        // Get the pooled value
+                                        auto pooledValue = GetPoolingWindowValue(function, rowRegionBounds.windowBounds.begin, rowRegionBounds.windowBounds.end, columnRegionBounds.windowBounds.begin, columnRegionBounds.windowBounds.end, inputRow, inputColumn, channel, inputBuffer, inputIncrement, poolingFunction);
+                                        // and store it in the output
+                                        auto outputIndex = (outputRow * function.LocalScalar<int>(outputIncrement[0])) +
+                                                           (outputColumn * function.LocalScalar<int>(outputIncrement[1])) +
+                                                           channel;
+                                        function.SetValueAt(outputBuffer, outputIndex, pooledValue);
+                                    });
+                                }
                             });
                         });
                     });
@@ -16,10 +16,14 @@
 #include "SquaredEuclideanDistanceNode.h"
 #include "UnaryOperationNode.h"
 
+#include <emitters/include/IRLocalScalar.h>
+#include <emitters/include/IRMath.h>
+
 #include <utilities/include/Exception.h>
 
 #include <data/include/DenseDataVector.h>
 
+#include <cmath>
 #include <functional>
 #include <string>
 #include <vector>
@@ -29,14 +33,14 @@ namespace ell
 namespace nodes
 {
     ProtoNNPredictorNode::ProtoNNPredictorNode() :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, {}, defaultInputPortName),
         _output(this, defaultOutputPortName, 0)
     {
     }
 
     ProtoNNPredictorNode::ProtoNNPredictorNode(const model::OutputPort<double>& input, const predictors::ProtoNNPredictor& predictor) :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, predictor.GetNumLabels()),
         _predictor(predictor)
@@ -111,6 +115,97 @@ namespace nodes
         _output.SetOutput(prediction.ToArray());
     }
 
+    void ProtoNNPredictorNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using emitters::IRLocalScalar;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        const auto& projection = _predictor.GetProjectionMatrix();
+        const auto& prototypes = _predictor.GetPrototypes();
+        const auto& labelEmbeddings = _predictor.GetLabelEmbeddings();
+        const int dimension = static_cast<int>(_predictor.GetDimension());
+        const int projectedDimension = static_cast<int>(_predictor.GetProjectedDimension());
+        const int numPrototypes = static_cast<int>(_predictor.GetNumPrototypes());
+        const int numLabels = static_cast<int>(_predictor.GetNumLabels());
+        const double gammaSquared = _predictor.GetGamma() * _predictor.GetGamma();
+
+        // The projection is stored row by row, and the prototypes and their label embeddings prototype by prototype,
+        // so every pass reads its constants sequentially
+        std::vector<double> projectionValues;
+        projectionValues.reserve(projectedDimension * dimension);
+        for (int row = 0; row < projectedDimension; ++row)
+        {
+            for (int column = 0; column < dimension; ++column)
+            {
+                projectionValues.push_back(projection(row, column));
+            }
+        }
+        std::vector<double> prototypeValues;
+        std::vector<double> labelEmbeddingValues;
+        prototypeValues.reserve(numPrototypes * projectedDimension);
+        labelEmbeddingValues.reserve(numPrototypes * numLabels);
+        for (int prototype = 0; prototype < numPrototypes; ++prototype)
+        {
+            for (int index = 0; index < projectedDimension; ++index)
+            {
+                prototypeValues.push_back(prototypes(index, prototype));
+            }
+            for (int label = 0; label < numLabels; ++label)
+            {
+                labelEmbeddingValues.push_back(labelEmbeddings(label, prototype));
+            }
+        }
+
+        auto& module = function.GetModule();
+        auto pProjection = function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "projection"), projectionValues), 0);
+        auto pPrototypes = function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "prototypes"), prototypeValues), 0);
+        auto pLabelEmbeddings = function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "labelEmbeddings"), labelEmbeddingValues), 0);
+
+        // Project the input
+        emitters::LLVMValue projectedInput = function.Variable(emitters::VariableType::Double, projectedDimension);
+        function.CallGEMV<double>(projectedDimension, dimension, pProjection, dimension, pInput, 1, projectedInput, 1);
+
+        function.For(numLabels, [pOutput](emitters::IRFunctionEmitter& function, IRLocalScalar label) {
+            function.SetValueAt(pOutput, label, function.Literal<double>(0));
+        });
+
+        // A prototype's similarity is below the threshold exactly when its squared distance is above this
+        const double threshold = compiler.GetModelOptimizerOptions(*this).GetEntry<double>("protoNNSimilarityThreshold", 0.0);
+        const bool skipDistantPrototypes = threshold > 0 && gammaSquared > 0;
+        const double maxDistance = skipDistantPrototypes ? -std::log(threshold) / gammaSquared : 0;
+
+        auto distanceVar = function.Variable(emitters::VariableType::Double, "protoNNDistance");
+        function.For(numPrototypes, [=](emitters::IRFunctionEmitter& function, IRLocalScalar prototype) {
+            auto coordinates = function.PointerOffset(pPrototypes, prototype * projectedDimension);
+            function.StoreZero(distanceVar);
+            function.For(projectedDimension, [coordinates, projectedInput, distanceVar](emitters::IRFunctionEmitter& function, IRLocalScalar index) {
+                auto difference = function.LocalScalar(function.ValueAt(coordinates, index)) - function.ValueAt(projectedInput, index);
+                function.Store(distanceVar, function.LocalScalar(function.Load(distanceVar)) + (difference * difference));
+            });
+            auto distance = function.LocalScalar(function.Load(distanceVar));
+
+            // Add the prototype's label embedding, scaled by its similarity, to the scores
+            auto labelEmbedding = function.PointerOffset(pLabelEmbeddings, prototype * numLabels);
+            auto accumulateScores = [distance, labelEmbedding, pOutput, gammaSquared, numLabels](emitters::IRFunctionEmitter& function) {
+                auto similarity = emitters::Exp(distance * -gammaSquared);
+                function.For(numLabels, [similarity, labelEmbedding, pOutput](emitters::IRFunctionEmitter& function, IRLocalScalar label) {
+                    auto score = function.LocalScalar(function.ValueAt(pOutput, label));
+                    function.SetValueAt(pOutput, label, score + (similarity * function.ValueAt(labelEmbedding, label)));
+                });
+            };
+            if (skipDistantPrototypes)
+            {
+                function.If(distance <= maxDistance, accumulateScores);
+            }
+            else
+            {
+                accumulateScores(function);
+            }
+        });
+    }
+
     ProtoNNPredictorNode* AddNodeToModelTransformer(const model::PortElements<double>& input, const predictors::ProtoNNPredictor& predictor, model::ModelTransformer& transformer)
     {
         return transformer.AddNode<ProtoNNPredictorNode>(input, predictor);
@@ -0,0 +1,352 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedConvolutionNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedConvolutionNode.h"
+
+#include <emitters/include/IRLocalScalar.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    QuantizedConvolutionNode<ValueType>::QuantizedConvolutionNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    QuantizedConvolutionNode<ValueType>::QuantizedConvolutionNode(const model::OutputPort<ValueType>& input,
+                                                                  const model::PortMemoryLayout& inputMemoryLayout,
+                                                                  const model::PortMemoryLayout& outputMemoryLayout,
+                                                                  const QuantizedMatrix<ValueType>& filterWeights,
+                                                                  int filterSize,
+                                                                  int stride,
+                                                                  ValueType inputScale) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, outputMemoryLayout),
+        _inputMemoryLayout(inputMemoryLayout),
+        _filterWeights(filterWeights),
+        _filterSize(filterSize),
+        _stride(stride),
+        _inputScale(inputScale)
+    {
+        CheckLayouts();
+
+        const auto inputDepth = static_cast<size_t>(inputMemoryLayout.GetLogicalDimensionActiveSize(2));
+        const auto numFilters = static_cast<size_t>(outputMemoryLayout.GetLogicalDimensionActiveSize(2));
+        if (filterWeights.numRows != numFilters || filterWeights.numColumns != static_cast<size_t>(filterSize * filterSize) * inputDepth)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "QuantizedConvolutionNode: weights must have a row per filter and a column per entry of a receptive field");
+        }
+
+        if (filterWeights.values.size() != filterWeights.numRows * filterWeights.numColumns || filterWeights.rowScales.size() != filterWeights.numRows)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "QuantizedConvolutionNode: wrong number of quantized values or scales");
+        }
+
+        if (!(inputScale > 0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "QuantizedConvolutionNode: input scale must be positive");
+        }
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::CheckLayouts() const
+    {
+        // Each row of a receptive field is read as one contiguous run of (column, channel) entries
+        const auto& inputLayout = GetInputMemoryLayout();
+        if (inputLayout.GetLogicalDimensionOrder() != utilities::RowMajorTensorOrder ||
+            inputLayout.GetLogicalDimensionOffset(2) != 0 ||
+            inputLayout.GetLogicalDimensionExtent(2) != inputLayout.GetLogicalDimensionActiveSize(2))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "QuantizedConvolutionNode: input must be in (row, column, channel) order with no padding between channels");
+        }
+
+        const auto outputLayout = GetOutputMemoryLayout();
+        if (!outputLayout.IsCanonicalOrder() || outputLayout.HasPadding())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "QuantizedConvolutionNode: output must be in (row, column, channel) order with no padding");
+        }
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> QuantizedConvolutionNode<ValueType>::GetOutputScales() const
+    {
+        std::vector<ValueType> result(_filterWeights.numRows);
+        for (size_t i = 0; i < _filterWeights.numRows; ++i)
+        {
+            result[i] = _filterWeights.rowScales[i] * _inputScale;
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::Compute() const
+    {
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int outputRows = outputLayout.GetLogicalDimensionActiveSize(0);
+        const int outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        const int m = static_cast<int>(_filterWeights.numRows);
+        const int k = static_cast<int>(_filterWeights.numColumns);
+        const int rowIncrement = inputLayout.GetCumulativeIncrement()[0];
+        const int columnIncrement = inputLayout.GetCumulativeIncrement()[1];
+        const int fieldRowSize = k / _filterSize;
+
+        // The input includes its padding, which supplies the zeros around the edges of the image
+        std::vector<int> quantizedInput(_input.Size());
+        for (size_t j = 0; j < quantizedInput.size(); ++j)
+        {
+            quantizedInput[j] = QuantizeValue(_input[j], _inputScale);
+        }
+
+        auto outputScales = GetOutputScales();
+        std::vector<ValueType> result(outputRows * outputColumns * m);
+        for (int row = 0; row < outputRows; ++row)
+        {
+            for (int column = 0; column < outputColumns; ++column)
+            {
+                const auto fieldOffset = (row * _stride * rowIncrement) + (column * _stride * columnIncrement);
+                for (int filter = 0; filter < m; ++filter)
+                {
+                    int32_t accumulator = 0;
+                    for (int fieldRow = 0; fieldRow < _filterSize; ++fieldRow)
+                    {
+                        for (int j = 0; j < fieldRowSize; ++j)
+                        {
+                            auto weight = static_cast<int32_t>(_filterWeights.values[(filter * k) + (fieldRow * fieldRowSize) + j]);
+                            accumulator += weight * quantizedInput[fieldOffset + (fieldRow * rowIncrement) + j];
+                        }
+                    }
+                    result[(((row * outputColumns) + column) * m) + filter] = static_cast<ValueType>(accumulator) * outputScales[filter];
+                }
+            }
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        if (compiler.GetCompilerOptions().targetDevice.HasDSPExtension())
+        {
+            CompileWithDSPExtension(compiler, function);
+            return;
+        }
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(this->input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(this->output);
+
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        const int outputElements = outputLayout.GetLogicalDimensionActiveSize(0) * outputColumns;
+        const int rowIncrement = inputLayout.GetCumulativeIncrement()[0];
+        const int columnIncrement = inputLayout.GetCumulativeIncrement()[1];
+        const int m = static_cast<int>(_filterWeights.numRows);
+        const int k = static_cast<int>(_filterWeights.numColumns);
+        const int fieldRowSize = k / _filterSize;
+        const int filterSize = _filterSize;
+        const int stride = _stride;
+        const auto inputScale = _inputScale;
+
+        auto& module = function.GetModule();
+        std::vector<char> weightValues(_filterWeights.values.begin(), _filterWeights.values.end());
+        auto pWeights = module.ConstantArray(compiler.GetGlobalName(*this, "weights"), weightValues);
+        auto pOutputScales = module.ConstantArray(compiler.GetGlobalName(*this, "scales"), GetOutputScales());
+
+        // Pick the number of output pixels per tile so that the 8-bit panel (pixels x k) stays small. The input is
+        // quantized as it's gathered, rather than all at once, so no buffer the size of the image is needed.
+        const int defaultPanelSize = 16 * 1024;
+        const auto panelSize = compiler.GetModelOptimizerOptions(*this).template GetEntry<int>("implicitGemmPanelSize", defaultPanelSize);
+        const int tileSize = std::max(1, std::min(outputElements, panelSize / k));
+        const int numFullTiles = outputElements / tileSize;
+        const int remainder = outputElements % tileSize;
+        auto panel = function.Variable(emitters::VariableType::Char8, tileSize * k);
+
+        auto emitTile = [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar tileStart, int numPixels) {
+            // Gather the quantized receptive fields of the tile's output pixels into the rows of the panel
+            function.For(numPixels, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue indexValue) {
+                auto index = function.LocalScalar(indexValue);
+                auto pixel = tileStart + index;
+                auto fieldOffset = ((pixel / outputColumns) * (stride * rowIncrement)) + ((pixel % outputColumns) * (stride * columnIncrement));
+                auto panelOffset = index * k;
+                for (int fieldRow = 0; fieldRow < filterSize; ++fieldRow)
+                {
+                    auto source = function.PointerOffset(pInput, fieldOffset + (fieldRow * rowIncrement));
+                    auto destination = function.PointerOffset(panel, panelOffset + (fieldRow * fieldRowSize));
+                    function.For(fieldRowSize, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue j) {
+                        function.SetValueAt(destination, j, EmitQuantizeValue(function, function.ValueAt(source, j), inputScale));
+                    });
+                }
+            });
+
+            // output (pixels x filters) = panel (pixels x k) * weights' (k x filters)
+            function.For(numPixels, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue indexValue) {
+                auto index = function.LocalScalar(indexValue);
+                auto panelRow = function.PointerOffset(panel, index * k);
+                auto outputOffset = (tileStart + index) * m;
+                function.For(m, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue filterValue) {
+                    auto filter = function.LocalScalar(filterValue);
+                    auto dotProduct = EmitInt8DotProduct(function, function.PointerOffset(pWeights, filter * k), panelRow, k);
+                    auto sum = function.LocalScalar(function.CastValue<ValueType>(dotProduct));
+                    function.SetValueAt(pOutput, outputOffset + filter, sum * function.ValueAt(pOutputScales, filter));
+                });
+            });
+        };
+
+        function.For(numFullTiles, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue tileValue) {
+            emitTile(function, function.LocalScalar(tileValue) * tileSize, tileSize);
+        });
+        if (remainder > 0)
+        {
+            emitTile(function, function.LocalScalar(numFullTiles * tileSize), remainder);
+        }
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::CompileWithDSPExtension(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using emitters::VariableType;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(this->input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(this->output);
+
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const int outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        const int outputElements = outputLayout.GetLogicalDimensionActiveSize(0) * outputColumns;
+        const int rowIncrement = inputLayout.GetCumulativeIncrement()[0];
+        const int columnIncrement = inputLayout.GetCumulativeIncrement()[1];
+        const int m = static_cast<int>(_filterWeights.numRows);
+        const int k = static_cast<int>(_filterWeights.numColumns);
+        const int wordsPerRow = (k + 3) / 4;
+        const int packedRowSize = 2 * wordsPerRow;
+        const int fieldRowSize = k / _filterSize;
+        const int filterSize = _filterSize;
+        const int stride = _stride;
+        const auto inputScale = _inputScale;
+
+        // The filters stay 8-bit, packed 4 to a 32-bit word
+        auto& module = function.GetModule();
+        auto pWeights = module.ConstantArray(compiler.GetGlobalName(*this, "packedWeights"), PackInt8ValuesIntoWords(_filterWeights.values, _filterWeights.numRows, _filterWeights.numColumns));
+        auto pOutputScales = module.ConstantArray(compiler.GetGlobalName(*this, "scales"), GetOutputScales());
+
+        // Each row of the panel is a receptive field paired up for SMLAD, at 2 bytes per value. The panel is kept to
+        // the same number of bytes as the generic kernel's, so a tile has fewer pixels.
+        const int defaultPanelSize = 16 * 1024;
+        const auto panelSize = compiler.GetModelOptimizerOptions(*this).template GetEntry<int>("implicitGemmPanelSize", defaultPanelSize);
+        const int tileSize = std::max(1, std::min(outputElements, panelSize / (4 * packedRowSize)));
+        const int numFullTiles = outputElements / tileSize;
+        const int remainder = outputElements % tileSize;
+        auto panel = function.Variable(VariableType::Int32, tileSize * packedRowSize);
+
+        // The receptive field being gathered, one quantized value per 32-bit integer, zero-padded to a whole number of words
+        auto field = function.Variable(VariableType::Int32, 4 * wordsPerRow);
+        function.For(k, 4 * wordsPerRow, [field](emitters::IRFunctionEmitter& function, emitters::LLVMValue j) {
+            function.SetValueAt(field, j, function.Literal<int>(0));
+        });
+
+        auto emitTile = [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar tileStart, int numPixels) {
+            // Gather and pair up the quantized receptive fields of the tile's output pixels into the rows of the panel
+            function.For(numPixels, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue indexValue) {
+                auto index = function.LocalScalar(indexValue);
+                auto pixel = tileStart + index;
+                auto fieldOffset = ((pixel / outputColumns) * (stride * rowIncrement)) + ((pixel % outputColumns) * (stride * columnIncrement));
+                for (int fieldRow = 0; fieldRow < filterSize; ++fieldRow)
+                {
+                    auto source = function.PointerOffset(pInput, fieldOffset + (fieldRow * rowIncrement));
+                    auto destination = function.PointerOffset(field, fieldRow * fieldRowSize);
+                    function.For(fieldRowSize, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue j) {
+                        function.SetValueAt(destination, j, function.CastValue<int>(EmitQuantizeValue(function, function.ValueAt(source, j), inputScale)));
+                    });
+                }
+                EmitPackDualMACInput(function, field, function.PointerOffset(panel, index * packedRowSize), wordsPerRow);
+            });
+
+            // output (pixels x filters) = panel (pixels x k) * weights' (k x filters)
+            function.For(numPixels, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue indexValue) {
+                auto index = function.LocalScalar(indexValue);
+                auto panelRow = function.PointerOffset(panel, index * packedRowSize);
+                auto outputOffset = (tileStart + index) * m;
+                function.For(m, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue filterValue) {
+                    auto filter = function.LocalScalar(filterValue);
+                    auto dotProduct = EmitDualMACDotProduct(function, function.PointerOffset(pWeights, filter * wordsPerRow), panelRow, wordsPerRow);
+                    auto sum = function.LocalScalar(function.CastValue<ValueType>(dotProduct));
+                    function.SetValueAt(pOutput, outputOffset + filter, sum * function.ValueAt(pOutputScales, filter));
+                });
+            });
+        };
+
+        function.For(numFullTiles, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue tileValue) {
+            emitTile(function, function.LocalScalar(tileValue) * tileSize, tileSize);
+        });
+        if (remainder > 0)
+        {
+            emitTile(function, function.LocalScalar(numFullTiles * tileSize), remainder);
+        }
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<QuantizedConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, GetOutputMemoryLayout(), _filterWeights, _filterSize, _stride, _inputScale);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["inputLayout"] << _inputMemoryLayout;
+        archiver["outputLayout"] << GetOutputMemoryLayout();
+        archiver["filterSize"] << _filterSize;
+        archiver["stride"] << _stride;
+        archiver["numRows"] << _filterWeights.numRows;
+        archiver["numColumns"] << _filterWeights.numColumns;
+        std::vector<int> values(_filterWeights.values.begin(), _filterWeights.values.end());
+        archiver["values"] << values;
+        archiver["rowScales"] << _filterWeights.rowScales;
+        archiver["inputScale"] << _inputScale;
+    }
+
+    template <typename ValueType>
+    void QuantizedConvolutionNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["inputLayout"] >> _inputMemoryLayout;
+        model::PortMemoryLayout outputMemoryLayout;
+        archiver["outputLayout"] >> outputMemoryLayout;
+        _output.SetMemoryLayout(outputMemoryLayout);
+        archiver["filterSize"] >> _filterSize;
+        archiver["stride"] >> _stride;
+        archiver["numRows"] >> _filterWeights.numRows;
+        archiver["numColumns"] >> _filterWeights.numColumns;
+        std::vector<int> values;
+        archiver["values"] >> values;
+        _filterWeights.values.assign(values.begin(), values.end());
+        archiver["rowScales"] >> _filterWeights.rowScales;
+        archiver["inputScale"] >> _inputScale;
+    }
+
+    // Explicitly instantiate versions
+    template class QuantizedConvolutionNode<float>;
+    template class QuantizedConvolutionNode<double>;
+} // namespace nodes
+} // namespace ell
@@ -0,0 +1,303 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixVectorProductNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedMatrixVectorProductNode.h"
+
+#include <emitters/include/IRLocalScalar.h>
+#include <emitters/include/IRVectorUtilities.h>
+
+namespace ell
+{
+namespace nodes
+{
+    std::vector<int> PackInt8ValuesIntoWords(const std::vector<int8_t>& values, size_t numRows, size_t numColumns)
+    {
+        const auto wordsPerRow = (numColumns + 3) / 4;
+        std::vector<int> result(numRows * wordsPerRow, 0);
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                auto byte = static_cast<uint32_t>(static_cast<uint8_t>(values[i * numColumns + j]));
+                auto& word = result[i * wordsPerRow + j / 4];
+                word = static_cast<int>(static_cast<uint32_t>(word) | (byte << (8 * (j % 4))));
+            }
+        }
+        return result;
+    }
+
+    void EmitPackDualMACInput(emitters::IRFunctionEmitter& function, emitters::LLVMValue values, emitters::LLVMValue packedValues, int numWords)
+    {
+        using emitters::TypedOperator;
+
+        function.For(numWords, [values, packedValues](emitters::IRFunctionEmitter& function, emitters::LLVMValue g) {
+            auto word = function.LocalScalar(g);
+            auto pack = [&](int first) {
+                auto low = function.Operator(TypedOperator::logicalAnd, function.ValueAt(values, word * 4 + first), function.Literal<int>(0xffff));
+                auto high = function.Operator(TypedOperator::shiftLeft, function.ValueAt(values, word * 4 + first + 2), function.Literal<int>(16));
+                return function.Operator(TypedOperator::logicalOr, low, high);
+            };
+            function.SetValueAt(packedValues, word * 2, pack(0));
+            function.SetValueAt(packedValues, word * 2 + 1, pack(1));
+        });
+    }
+
+    emitters::LLVMValue EmitDualMACDotProduct(emitters::IRFunctionEmitter& function, emitters::LLVMValue packedWeights, emitters::LLVMValue packedInput, int numWords)
+    {
+        using emitters::TypedOperator;
+        using emitters::VariableType;
+
+        auto& module = function.GetModule();
+        auto smlad = module.DeclareFunction("llvm.arm.smlad", VariableType::Int32, { VariableType::Int32, VariableType::Int32, VariableType::Int32 });
+        auto sxtb16 = module.DeclareFunction("llvm.arm.sxtb16", VariableType::Int32, { VariableType::Int32 });
+
+        auto accumulator = function.Variable(VariableType::Int32, "dualMACSum");
+        function.Store(accumulator, function.Literal<int>(0));
+        function.For(numWords, [packedWeights, packedInput, accumulator, smlad, sxtb16](emitters::IRFunctionEmitter& function, emitters::LLVMValue g) {
+            auto word = function.LocalScalar(g);
+            emitters::LLVMValue weights = function.ValueAt(packedWeights, word);
+            emitters::LLVMValue rotatedWeights = function.Operator(TypedOperator::logicalOr, function.Operator(TypedOperator::logicalShiftRight, weights, function.Literal<int>(8)), function.Operator(TypedOperator::shiftLeft, weights, function.Literal<int>(24)));
+            auto evenWeights = function.Call(sxtb16, { weights });
+            auto oddWeights = function.Call(sxtb16, { rotatedWeights });
+            auto sum = function.Call(smlad, { evenWeights, function.ValueAt(packedInput, word * 2), function.Load(accumulator) });
+            sum = function.Call(smlad, { oddWeights, function.ValueAt(packedInput, word * 2 + 1), sum });
+            function.Store(accumulator, sum);
+        });
+        return function.Load(accumulator);
+    }
+
+    emitters::LLVMValue EmitInt8DotProduct(emitters::IRFunctionEmitter& function, emitters::LLVMValue a, emitters::LLVMValue b, int size)
+    {
+        using emitters::VariableType;
+
+        // Use one lane per byte of a vector register, which holds `vectorWidth` 32-bit values. The horizontal sum at
+        // the end needs a power of 2.
+        int vectorSize = 1;
+        while (2 * vectorSize <= 4 * function.GetCompilerOptions().vectorWidth)
+        {
+            vectorSize *= 2;
+        }
+        const int numBlocks = vectorSize > 1 ? size / vectorSize : 0;
+        const int firstScalarIndex = numBlocks * vectorSize;
+
+        auto sum = function.Variable(VariableType::Int32, "dotProduct");
+        function.StoreZero(sum);
+        if (numBlocks > 0)
+        {
+            auto& emitter = function.GetEmitter();
+            auto int16VectorType = emitter.VectorType(VariableType::Int16, vectorSize);
+            auto int32VectorType = emitter.VectorType(VariableType::Int32, vectorSize);
+            auto sumVector = function.Variable(int32VectorType, "dotProductVector");
+            function.Store(sumVector, emitters::FillVector<int>(function, int32VectorType, 0));
+            function.For(numBlocks, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockIndex) {
+                auto& irBuilder = function.GetEmitter().GetIRBuilder();
+                auto offset = function.LocalScalar(blockIndex) * vectorSize;
+                auto aValues = irBuilder.CreateSExt(emitters::LoadVector<char>(function, a, offset, vectorSize), int16VectorType);
+                auto bValues = irBuilder.CreateSExt(emitters::LoadVector<char>(function, b, offset, vectorSize), int16VectorType);
+
+                // The products of values in [-127, 127] fit in 16 bits
+                auto products = irBuilder.CreateSExt(irBuilder.CreateMul(aValues, bValues), int32VectorType);
+                function.Store(sumVector, irBuilder.CreateAdd(function.Load(sumVector), products));
+            });
+            function.Store(sum, emitters::HorizontalVectorSum<int>(function, function.Load(sumVector)));
+        }
+        if (firstScalarIndex < size)
+        {
+            function.For(firstScalarIndex, size, 1, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue index) {
+                auto aValue = function.LocalScalar(function.CastValue<int>(function.ValueAt(a, index)));
+                auto bValue = function.LocalScalar(function.CastValue<int>(function.ValueAt(b, index)));
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + aValue * bValue);
+            });
+        }
+        return function.Load(sum);
+    }
+
+    template <typename ValueType>
+    QuantizedMatrixVectorProductNode<ValueType>::QuantizedMatrixVectorProductNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    QuantizedMatrixVectorProductNode<ValueType>::QuantizedMatrixVectorProductNode(const model::OutputPort<ValueType>& input, const QuantizedMatrix<ValueType>& weights, ValueType inputScale) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, weights.numRows),
+        _weights(weights),
+        _inputScale(inputScale)
+    {
+        if (input.Size() != weights.numColumns)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "QuantizedMatrixVectorProductNode: input size must match the number of columns in the matrix");
+        }
+
+        if (weights.values.size() != weights.numRows * weights.numColumns || weights.rowScales.size() != weights.numRows)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "QuantizedMatrixVectorProductNode: wrong number of quantized values or scales");
+        }
+
+        if (!(inputScale > 0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "QuantizedMatrixVectorProductNode: input scale must be positive");
+        }
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> QuantizedMatrixVectorProductNode<ValueType>::GetOutputScales() const
+    {
+        std::vector<ValueType> result(_weights.numRows);
+        for (size_t i = 0; i < _weights.numRows; ++i)
+        {
+            result[i] = _weights.rowScales[i] * _inputScale;
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorProductNode<ValueType>::Compute() const
+    {
+        const auto m = _weights.numRows;
+        const auto n = _weights.numColumns;
+
+        std::vector<int> quantizedInput(n);
+        for (size_t j = 0; j < n; ++j)
+        {
+            quantizedInput[j] = QuantizeValue(_input[j], _inputScale);
+        }
+
+        auto outputScales = GetOutputScales();
+        std::vector<ValueType> result(m);
+        for (size_t i = 0; i < m; ++i)
+        {
+            int32_t accumulator = 0;
+            for (size_t j = 0; j < n; ++j)
+            {
+                accumulator += static_cast<int32_t>(_weights.values[i * n + j]) * quantizedInput[j];
+            }
+            result[i] = static_cast<ValueType>(accumulator) * outputScales[i];
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorProductNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        if (compiler.GetCompilerOptions().targetDevice.HasDSPExtension())
+        {
+            CompileWithDSPExtension(compiler, function);
+            return;
+        }
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        const int m = static_cast<int>(_weights.numRows);
+        const int n = static_cast<int>(_weights.numColumns);
+        const auto inputScale = _inputScale;
+
+        auto& module = function.GetModule();
+        std::vector<char> weightValues(_weights.values.begin(), _weights.values.end());
+        auto pWeights = module.ConstantArray(compiler.GetGlobalName(*this, "weights"), weightValues);
+        auto pOutputScales = module.ConstantArray(compiler.GetGlobalName(*this, "scales"), GetOutputScales());
+
+        // Quantize the input once, then reuse it for every row
+        auto pQuantizedInput = function.Variable(emitters::VariableType::Char8, n);
+        function.For(n, [pInput, pQuantizedInput, inputScale](emitters::IRFunctionEmitter& function, emitters::LLVMValue j) {
+            function.SetValueAt(pQuantizedInput, j, EmitQuantizeValue(function, function.ValueAt(pInput, j), inputScale));
+        });
+
+        function.For(m, [pWeights, pOutputScales, pQuantizedInput, pOutput, n](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto rowIndex = function.LocalScalar(i);
+            auto dotProduct = EmitInt8DotProduct(function, function.PointerOffset(pWeights, rowIndex * n), pQuantizedInput, n);
+            auto sum = function.LocalScalar(function.CastValue<ValueType>(dotProduct));
+            function.SetValueAt(pOutput, rowIndex, sum * function.ValueAt(pOutputScales, rowIndex));
+        });
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorProductNode<ValueType>::CompileWithDSPExtension(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using emitters::VariableType;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        const int m = static_cast<int>(_weights.numRows);
+        const int n = static_cast<int>(_weights.numColumns);
+        const int wordsPerRow = (n + 3) / 4;
+        const auto inputScale = _inputScale;
+
+        // The weights stay 8-bit, packed 4 to a 32-bit word, and each SMLAD does two multiply-accumulates
+        auto& module = function.GetModule();
+        auto pWeights = module.ConstantArray(compiler.GetGlobalName(*this, "packedWeights"), PackInt8ValuesIntoWords(_weights.values, _weights.numRows, _weights.numColumns));
+        auto pOutputScales = module.ConstantArray(compiler.GetGlobalName(*this, "scales"), GetOutputScales());
+
+        // Quantize the input once, zero-padded to a whole number of words
+        auto pQuantizedInput = function.Variable(VariableType::Int32, 4 * wordsPerRow);
+        function.For(n, [pInput, pQuantizedInput, inputScale](emitters::IRFunctionEmitter& function, emitters::LLVMValue j) {
+            function.SetValueAt(pQuantizedInput, j, function.CastValue<int>(EmitQuantizeValue(function, function.ValueAt(pInput, j), inputScale)));
+        });
+        function.For(n, 4 * wordsPerRow, [pQuantizedInput](emitters::IRFunctionEmitter& function, emitters::LLVMValue j) {
+            function.SetValueAt(pQuantizedInput, j, function.Literal<int>(0));
+        });
+
+        auto pPackedInput = function.Variable(VariableType::Int32, 2 * wordsPerRow);
+        EmitPackDualMACInput(function, pQuantizedInput, pPackedInput, wordsPerRow);
+
+        function.For(m, [pWeights, pOutputScales, pPackedInput, pOutput, wordsPerRow](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto rowIndex = function.LocalScalar(i);
+            auto dotProduct = EmitDualMACDotProduct(function, function.PointerOffset(pWeights, rowIndex * wordsPerRow), pPackedInput, wordsPerRow);
+            auto sum = function.LocalScalar(function.CastValue<ValueType>(dotProduct));
+            function.SetValueAt(pOutput, rowIndex, sum * function.ValueAt(pOutputScales, rowIndex));
+        });
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorProductNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<QuantizedMatrixVectorProductNode<ValueType>>(newInput, _weights, _inputScale);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorProductNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["numRows"] << _weights.numRows;
+        archiver["numColumns"] << _weights.numColumns;
+        std::vector<int> values(_weights.values.begin(), _weights.values.end());
+        archiver["values"] << values;
+        archiver["rowScales"] << _weights.rowScales;
+        archiver["inputScale"] << _inputScale;
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixVectorProductNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["numRows"] >> _weights.numRows;
+        archiver["numColumns"] >> _weights.numColumns;
+        std::vector<int> values;
+        archiver["values"] >> values;
+        _weights.values.assign(values.begin(), values.end());
+        archiver["rowScales"] >> _weights.rowScales;
+        archiver["inputScale"] >> _inputScale;
+    }
+
+    // Explicitly instantiate versions
+    template class QuantizedMatrixVectorProductNode<float>;
+    template class QuantizedMatrixVectorProductNode<double>;
+} // namespace nodes
+} // namespace ell
@@ -8,6 +8,7 @@
 
 #include "RNNNode.h"
 #include "ActivationFunctions.h"
+#include "ConstantNode.h"
 
 #include <emitters/include/IRMath.h>
 
@@ -15,10 +16,21 @@
 
 #include <utilities/include/Exception.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace nodes
 {
+    namespace
+    {
+        template <typename ValueType>
+        const ConstantNode<ValueType>* GetConstantInputNode(const model::InputPort<ValueType>& input)
+        {
+            return dynamic_cast<const ConstantNode<ValueType>*>(input.GetReferencedPort().GetNode());
+        }
+    } // namespace
+
     template <typename ValueType>
     RNNNode<ValueType>::RNNNode() :
         CompilableNode(
@@ -44,6 +56,7 @@ namespace nodes
                                 const model::OutputPort<ValueType>& inputBias,
                                 const model::OutputPort<ValueType>& hiddenBias,
                                 const ActivationType& activation,
+                                size_t sequenceLength,
                                 bool validateWeights) :
         CompilableNode({ &_input, &_resetTrigger, &_inputWeights, &_hiddenWeights, &_inputBias, &_hiddenBias },
                        { &_output }),
@@ -56,12 +69,14 @@ namespace nodes
         _hiddenBias(this, hiddenBias, hiddenBiasPortName),
         _output(this, defaultOutputPortName, hiddenUnits),
         _activation(activation),
+        _sequenceLength(sequenceLength),
         _hiddenState(hiddenUnits)
     {
+        ValidateSequenceLength();
         if (validateWeights)
         {
             size_t numRows = hiddenUnits;
-            size_t numColumns = input.Size();
+            size_t numColumns = GetFrameSize();
 
             if (inputWeights.Size() != numRows * numColumns)
             {
@@ -90,6 +105,17 @@ namespace nodes
         }
     }
 
+    template <typename ValueType>
+    void RNNNode<ValueType>::ValidateSequenceLength()
+    {
+        if (_sequenceLength == 0 || _input.Size() % _sequenceLength != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
+                                            ell::utilities::FormatString("The RNNNode input size %zu isn't a multiple of the sequence length %zu", _input.Size(), _sequenceLength));
+        }
+        _output.SetSize(_hiddenUnits * _sequenceLength);
+    }
+
     template <typename ValueType>
     void RNNNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
@@ -99,7 +125,7 @@ namespace nodes
         const auto& newHiddenWeights = transformer.GetCorrespondingInputs(this->_hiddenWeights);
         const auto& newInputBias = transformer.GetCorrespondingInputs(this->_inputBias);
         const auto& newHiddenBias = transformer.GetCorrespondingInputs(this->_hiddenBias);
-        auto newNode = transformer.AddNode<RNNNode>(newInput, newResetTrigger, this->_hiddenUnits, newInputWeights, newHiddenWeights, newInputBias, newHiddenBias, this->_activation);
+        auto newNode = transformer.AddNode<RNNNode>(newInput, newResetTrigger, this->_hiddenUnits, newInputWeights, newHiddenWeights, newInputBias, newHiddenBias, this->_activation, this->_sequenceLength);
         transformer.MapNodeOutput(this->output, newNode->output);
     }
 
@@ -112,9 +138,10 @@ namespace nodes
         // h = tanh(it)
 
         size_t hiddenUnits = this->_hiddenUnits;
-        VectorType inputVector(this->_input.GetValue());
+        size_t frameSize = GetFrameSize();
+        std::vector<ValueType> inputValue = this->_input.GetValue();
         size_t numRows = hiddenUnits;
-        size_t numColumns = inputVector.Size();
+        size_t numColumns = frameSize;
         std::vector<ValueType> inputWeightsValue = this->_inputWeights.GetValue();
         ConstMatrixReferenceType inputWeights(inputWeightsValue.data(), numRows, numColumns);
         numColumns = hiddenUnits;
@@ -126,30 +153,47 @@ namespace nodes
         auto alpha = static_cast<ValueType>(1); // GEMV scale multiplication
         auto beta = static_cast<ValueType>(1); // GEMV scale bias
 
-        // W_i * x + b_i
-        VectorType input_gate(inputBias); // add input bias
-        math::MultiplyScaleAddUpdate(alpha, inputWeights, inputVector, beta, input_gate);
+        std::vector<ValueType> output;
+        for (size_t t = 0; t < _sequenceLength; ++t)
+        {
+            math::ConstColumnVectorReference<ValueType> inputVector(inputValue.data() + t * frameSize, frameSize);
 
-        // Wh * h + b_h
-        VectorType hidden_gate(hiddenBias); // add hidden bias
-        math::MultiplyScaleAddUpdate(alpha, hiddenWeights, this->_hiddenState, beta, hidden_gate);
+            // W_i * x + b_i
+            VectorType input_gate(inputBias); // add input bias
+            math::MultiplyScaleAddUpdate(alpha, inputWeights, inputVector, beta, input_gate);
 
-        // compute: W_{ ii } x + b_{ ii } +W_{ hi } h + b_{ hi }
-        input_gate += hidden_gate;
+            // Wh * h + b_h
+            VectorType hidden_gate(hiddenBias); // add hidden bias
+            math::MultiplyScaleAddUpdate(alpha, hiddenWeights, this->_hiddenState, beta, hidden_gate);
 
-        // tanh(...)
-        this->_activation.Apply(input_gate);
+            // compute: W_{ ii } x + b_{ ii } +W_{ hi } h + b_{ hi }
+            input_gate += hidden_gate;
 
-        // save new state.
-        this->_hiddenState.CopyFrom(input_gate);
+            // tanh(...)
+            this->_activation.Apply(input_gate);
 
+            // save new state.
+            this->_hiddenState.CopyFrom(input_gate);
+            auto hiddenState = this->_hiddenState.ToArray();
+            output.insert(output.end(), hiddenState.begin(), hiddenState.end());
+        }
+
+        SetSequenceOutput(output);
+    }
+
+    template <typename ValueType>
+    void RNNNode<ValueType>::SetSequenceOutput(std::vector<ValueType>& output) const
+    {
         if (ShouldReset())
         {
             const_cast<RNNNode<ValueType>*>(this)->Reset();
+
+            // the last frame gets the reset state
+            std::fill(output.end() - _hiddenUnits, output.end(), static_cast<ValueType>(0));
         }
 
         // copy to output.
-        this->_output.SetOutput(this->_hiddenState.ToArray());
+        this->_output.SetOutput(output);
     }
 
     template <typename ValueType>
@@ -188,6 +232,165 @@ namespace nodes
         });
     }
 
+    template <typename ValueType>
+    bool RNNNode<ValueType>::GetPackedGateWeights(int numGates, int numFusedGates, std::vector<ValueType>& weights, std::vector<ValueType>& bias) const
+    {
+        auto inputWeightsNode = GetConstantInputNode(_inputWeights);
+        auto hiddenWeightsNode = GetConstantInputNode(_hiddenWeights);
+        auto inputBiasNode = GetConstantInputNode(_inputBias);
+        auto hiddenBiasNode = GetConstantInputNode(_hiddenBias);
+        if (inputWeightsNode == nullptr || hiddenWeightsNode == nullptr || inputBiasNode == nullptr || hiddenBiasNode == nullptr)
+        {
+            return false;
+        }
+
+        const auto& inputWeights = inputWeightsNode->GetValues();
+        const auto& hiddenWeights = hiddenWeightsNode->GetValues();
+        const auto& inputBias = inputBiasNode->GetValues();
+        const auto& hiddenBias = hiddenBiasNode->GetValues();
+
+        const int hiddenUnits = static_cast<int>(_hiddenUnits);
+        const int inputSize = static_cast<int>(GetFrameSize());
+        const int packedColumns = inputSize + hiddenUnits;
+        const int packedRows = (2 * numGates - numFusedGates) * hiddenUnits;
+        weights.assign(packedRows * packedColumns, 0);
+        bias.assign(packedRows, 0);
+
+        auto copyRow = [&](int packedRow, int sourceRow, bool includeInput, bool includeHidden) {
+            auto packedRowBegin = weights.begin() + packedRow * packedColumns;
+            if (includeInput)
+            {
+                std::copy_n(inputWeights.begin() + sourceRow * inputSize, inputSize, packedRowBegin);
+                bias[packedRow] += inputBias[sourceRow];
+            }
+            if (includeHidden)
+            {
+                std::copy_n(hiddenWeights.begin() + sourceRow * hiddenUnits, hiddenUnits, packedRowBegin + inputSize);
+                bias[packedRow] += hiddenBias[sourceRow];
+            }
+        };
+
+        for (int gate = 0; gate < numGates; ++gate)
+        {
+            for (int unit = 0; unit < hiddenUnits; ++unit)
+            {
+                const int sourceRow = gate * hiddenUnits + unit;
+                if (gate < numFusedGates)
+                {
+                    copyRow(sourceRow, sourceRow, true, true);
+                }
+                else
+                {
+                    const int inputRow = (numFusedGates + 2 * (gate - numFusedGates)) * hiddenUnits + unit;
+                    copyRow(inputRow, sourceRow, true, false);
+                    copyRow(inputRow + hiddenUnits, sourceRow, false, true);
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename ValueType>
+    void RNNNode<ValueType>::EmitGatePreactivations(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int numGates, int numFusedGates, emitters::LLVMValue hiddenState, emitters::IRLocalArray preactivations, emitters::LLVMValue inputProjection)
+    {
+        const int hiddenUnits = static_cast<int>(this->_hiddenUnits);
+        const int inputSize = static_cast<int>(GetFrameSize());
+        const int stackSize = numGates * hiddenUnits;
+        auto alpha = static_cast<ValueType>(1.0); // GEMV scaling of the matrix multipication
+        auto beta = static_cast<ValueType>(1.0); // GEMV scaling of the bias addition
+
+        auto input = compiler.EnsurePortEmitted(this->input);
+
+        std::vector<ValueType> packedWeights;
+        std::vector<ValueType> packedBias;
+        if (inputProjection == nullptr && GetPackedGateWeights(numGates, numFusedGates, packedWeights, packedBias))
+        {
+            // [W_i | W_h] * [x; h] + (b_i + b_h), one matrix multiplication for all the gates
+            const int packedColumns = inputSize + hiddenUnits;
+            const int packedRows = static_cast<int>(packedBias.size());
+            auto& module = function.GetModule();
+            auto weights = function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "packedWeights"), packedWeights), 0);
+            auto bias = function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "packedBias"), packedBias), 0);
+
+            auto inputAndHiddenState = function.Variable(emitters::GetVariableType<ValueType>(), packedColumns);
+            function.MemoryCopy<ValueType>(input, 0, inputAndHiddenState, 0, inputSize);
+            function.MemoryCopy<ValueType>(hiddenState, 0, inputAndHiddenState, inputSize, hiddenUnits);
+
+            function.MemoryCopy<ValueType>(bias, preactivations, packedRows); // Copy bias values into output so GEMM call accumulates them
+            function.CallGEMV(packedRows, packedColumns, alpha, weights, packedColumns, inputAndHiddenState, 1, beta, preactivations, 1);
+            return;
+        }
+
+        auto hiddenWeights = compiler.EnsurePortEmitted(this->hiddenWeights);
+        auto hiddenBias = compiler.EnsurePortEmitted(this->hiddenBias);
+        auto hstack = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), stackSize));
+
+        // W_i * x + b_i and W_h * h + b_h, one matrix multiplication each for all the gates
+        if (inputProjection == nullptr)
+        {
+            auto inputWeights = compiler.EnsurePortEmitted(this->inputWeights);
+            auto inputBias = compiler.EnsurePortEmitted(this->inputBias);
+            inputProjection = function.Variable(emitters::GetVariableType<ValueType>(), stackSize);
+            function.MemoryCopy<ValueType>(inputBias, inputProjection, stackSize); // Copy bias values into output so GEMM call accumulates them
+            function.CallGEMV(stackSize, inputSize, alpha, inputWeights, inputSize, input, 1, beta, inputProjection, 1);
+        }
+        auto istack = function.LocalArray(inputProjection);
+        function.MemoryCopy<ValueType>(hiddenBias, hstack, stackSize);
+        function.CallGEMV(stackSize, hiddenUnits, alpha, hiddenWeights, hiddenUnits, hiddenState, 1, beta, hstack, 1);
+
+        const int fusedSize = numFusedGates * hiddenUnits;
+        function.For(fusedSize, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
+            preactivations[i] = istack[i] + hstack[i];
+        });
+        for (int gate = numFusedGates; gate < numGates; ++gate)
+        {
+            const int sourceOffset = gate * hiddenUnits;
+            const int inputOffset = (numFusedGates + 2 * (gate - numFusedGates)) * hiddenUnits;
+            function.MemoryCopy<ValueType>(istack, sourceOffset, preactivations, inputOffset, hiddenUnits);
+            function.MemoryCopy<ValueType>(hstack, sourceOffset, preactivations, inputOffset + hiddenUnits, hiddenUnits);
+        }
+    }
+
+    template <typename ValueType>
+    emitters::LLVMValue RNNNode<ValueType>::EmitInputProjections(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int numGates)
+    {
+        const int sequenceLength = static_cast<int>(_sequenceLength);
+        const int inputSize = static_cast<int>(GetFrameSize());
+        const int stackSize = numGates * static_cast<int>(_hiddenUnits);
+
+        auto input = compiler.EnsurePortEmitted(this->input);
+        auto inputWeights = compiler.EnsurePortEmitted(this->inputWeights);
+        auto inputBias = compiler.EnsurePortEmitted(this->inputBias);
+        auto projections = function.Variable(emitters::GetVariableType<ValueType>(), sequenceLength * stackSize);
+
+        // Copy the bias into every row so the GEMM call accumulates it
+        function.For(sequenceLength, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar t) {
+            fn.MemoryCopy<ValueType>(inputBias, fn.PointerOffset(projections, t * stackSize), stackSize);
+        });
+
+        // X * W_i' + b_i, where row t of X is frame t of the input
+        auto alpha = static_cast<ValueType>(1.0);
+        auto beta = static_cast<ValueType>(1.0);
+        function.CallGEMM<ValueType>(false, true, sequenceLength, stackSize, inputSize, alpha, input, inputSize, inputWeights, inputSize, beta, projections, stackSize);
+        return projections;
+    }
+
+    template <typename ValueType>
+    void RNNNode<ValueType>::EmitTimeSteps(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function, int numGates, TimeStepFunction step)
+    {
+        if (_sequenceLength == 1)
+        {
+            step(function, nullptr, function.LocalScalar<int>(0));
+            return;
+        }
+
+        const int stackSize = numGates * static_cast<int>(_hiddenUnits);
+        auto projections = EmitInputProjections(compiler, function, numGates);
+        function.For(static_cast<int>(_sequenceLength), [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar t) {
+            step(fn, fn.PointerOffset(projections, t * stackSize), t);
+        });
+    }
+
     template <typename ValueType>
     void RNNNode<ValueType>::ApplySoftmax(emitters::IRFunctionEmitter& function, emitters::LLVMValue dataValue, size_t dataLength)
     {
@@ -212,18 +415,12 @@ namespace nodes
         // it = sigma(W_{ ii } x + b_{ ii } +W_{ hi } h + b_{ hi })
         // h = tanh(it)
         const int hiddenUnits = static_cast<int>(this->_hiddenUnits);
-        const int inputSize = static_cast<int>(this->input.Size());
 
         // Get LLVM references for all node inputs
-        auto input = compiler.EnsurePortEmitted(this->input);
         auto resetTrigger = compiler.EnsurePortEmitted(this->resetTrigger);
-        auto inputWeights = compiler.EnsurePortEmitted(this->inputWeights);
-        auto hiddenWeights = compiler.EnsurePortEmitted(this->hiddenWeights);
-        auto inputBias = compiler.EnsurePortEmitted(this->inputBias);
-        auto hiddenBias = compiler.EnsurePortEmitted(this->hiddenBias);
 
         // Get LLVM reference for node output
-        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
+        auto output = compiler.EnsurePortEmitted(this->output);
 
         // Allocate global buffer for hidden state
         emitters::IRModuleEmitter& module = function.GetModule();
@@ -231,37 +428,24 @@ namespace nodes
         auto hiddenStateValue = module.EnsureEmitted(*hiddenStateVariable);
         auto hiddenStatePointer = function.PointerOffset(hiddenStateValue, 0); // convert "global variable" to a pointer
         auto hiddenState = function.LocalArray(hiddenStatePointer);
-        auto& prevHiddenState = hiddenState;
 
-        // Allocate local variables
         auto inputGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
-        auto hiddenGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
-
-        auto alpha = static_cast<ValueType>(1.0); // GEMV scaling of the matrix multipication
-        auto beta = static_cast<ValueType>(1.0); // GEMV scaling of the bias addition
-
-        // W_i * x + b_i
-        function.MemoryCopy<ValueType>(inputBias, inputGate, hiddenUnits); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenUnits, inputSize, alpha, inputWeights, inputSize, input, 1, beta, inputGate, 1);
-
-        // W_h * h + b_h
-        function.MemoryCopy<ValueType>(hiddenBias, hiddenGate, hiddenUnits); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenUnits, hiddenUnits, alpha, hiddenWeights, hiddenUnits, prevHiddenState, 1, beta, hiddenGate, 1);
-
-        // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
-        function.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            inputGate[i] = inputGate[i] + hiddenGate[i];
+        auto activationFunction = GetNodeActivationFunction(this->_activation);
+        auto activation = activationFunction.get();
+        EmitTimeSteps(compiler, function, 1, [&](emitters::IRFunctionEmitter& fn, emitters::LLVMValue inputProjection, emitters::IRLocalScalar t) {
+            // W_i * x + b_i + W_h * h + b_h
+            EmitGatePreactivations(compiler, fn, 1, 1, hiddenStatePointer, inputGate, inputProjection);
+
+            // tanh, written straight to the new hidden state
+            fn.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
+                emitters::IRLocalScalar preactivation = inputGate[i];
+                hiddenState[i] = activation->Compile(fn, preactivation);
+            });
+
+            // Copy hidden state to the output.
+            fn.MemoryCopy<ValueType>(hiddenState, fn.PointerOffset(output, t * hiddenUnits), hiddenUnits);
         });
 
-        // tanh
-        this->ApplyActivation(function, this->_activation, inputGate, hiddenUnits);
-
-        // save new HiddenState
-        function.MemoryCopy<ValueType>(inputGate, hiddenState, hiddenUnits);
-
-        // Copy hidden state to the output.
-        function.MemoryCopy<ValueType>(hiddenState, output, hiddenUnits);
-
         // Add the internal reset function
         std::string resetFunctionName = compiler.GetGlobalName(*this, "RNNNodeReset");
         emitters::IRFunctionEmitter& resetFunction = module.BeginResetFunction(resetFunctionName);
@@ -292,6 +476,7 @@ namespace nodes
         archiver[hiddenWeightsPortName] << _hiddenWeights;
         archiver[inputBiasPortName] << _inputBias;
         archiver[hiddenBiasPortName] << _hiddenBias;
+        archiver["sequenceLength"] << _sequenceLength;
 
         _activation.WriteToArchive(archiver);
     }
@@ -307,11 +492,12 @@ namespace nodes
         archiver[hiddenWeightsPortName] >> _hiddenWeights;
         archiver[inputBiasPortName] >> _inputBias;
         archiver[hiddenBiasPortName] >> _hiddenBias;
+        archiver.OptionalProperty("sequenceLength", size_t{ 1 }) >> _sequenceLength;
 
         _activation.ReadFromArchive(archiver);
 
         _hiddenState.Resize(_hiddenUnits);
-        this->_output.SetSize(_hiddenUnits);
+        ValidateSequenceLength();
     }
 
     // Explicit instantiations
@@ -9,6 +9,7 @@
 #include "RegionDetectionLayerNode.h"
 #include "ActivationLayerNode.h"
 #include "ActivationFunctions.h"
+#include "SoftmaxLayerNode.h"
 
 #include <emitters/include/IRMath.h>
 
@@ -110,10 +111,7 @@ namespace nodes
                     auto confidenceOffset = boxOffset + numAnchors;
                     auto classProbabilityOffset = confidenceOffset + 1;
 
-                    for (int anchorIndex = 0; anchorIndex < numAnchors; ++anchorIndex)
-                    {
-                        output({ i, j, boxOffset + anchorIndex }) = input({ i, j, boxOffset + anchorIndex });
-                    }
+                    fn.template MemoryCopy<ValueType>(input.PointerTo({ i, j, boxOffset }), output.PointerTo({ i, j, boxOffset }), fn.LocalScalar(numAnchors));
 
                     SigmoidActivationFunction<ValueType> sigmoid;
                     emitters::IRLocalScalar e = input({ i, j, confidenceOffset });
@@ -122,32 +120,7 @@ namespace nodes
                     // output[classProbabilityOffset : classProbabilityOffset + numClasses] = softmax(input[classProbabilityOffset : classProbabilityOffset + numClasses])
                     if (params.applySoftmax)
                     {
-                        // set the initial max value to the first element
-                        auto classProbMax = fn.LocalScalar(fn.Variable(emitters::GetVariableType<ValueType>()));
-                        fn.Store(classProbMax, static_cast<emitters::IRLocalScalar>(input({ i, j, classProbabilityOffset })));
-
-                        // find the max value in the rest of the probabilities
-                        fn.For(classProbabilityOffset + 1, classProbabilityOffset + numClasses, [classProbMax, input, i, j](auto& fn, auto c) {
-                            emitters::IRLocalScalar val = input({ i, j, c });
-                            fn.If(val > fn.Load(classProbMax), [classProbMax, val](auto& fn) {
-                                fn.Store(classProbMax, val);
-                            });
-                        });
-
-                        // Calculate the sum of the all the euler values, which are calculated using the max above
-                        auto sum = fn.Variable(emitters::GetVariableType<ValueType>());
-                        fn.Store(sum, fn.Literal(ValueType{ 0 }));
-                        fn.For(classProbabilityOffset, classProbabilityOffset + numClasses, [sum, classProbMax, input, output, i, j](auto& fn, auto c) {
-                            emitters::IRLocalScalar inputVal = input({ i, j, c });
-                            auto eulerVal = Exp(inputVal - fn.Load(classProbMax));
-                            fn.Store(sum, eulerVal + fn.Load(sum));
-                            output({ i, j, c }) = eulerVal;
-                        });
-
-                        // Divide each element by the sum
-                        fn.For(classProbabilityOffset, classProbabilityOffset + numClasses, [sum, output, i, j](auto& fn, auto c) {
-                            output({ i, j, c }) = (output({ i, j, c }) / fn.Load(sum));
-                        });
+                        EmitSoftmax<ValueType>(fn, input.PointerTo({ i, j, classProbabilityOffset }), output.PointerTo({ i, j, classProbabilityOffset }), numClasses);
                     }
                     else
                     {
@@ -11,6 +11,8 @@
 
 #include <dsp/include/Convolution.h>
 
+#include <emitters/include/IRLoopTiling.h>
+
 #include <math/include/Matrix.h>
 
 namespace ell
@@ -43,62 +45,72 @@ namespace nodes
 
             auto inputMemoryIncrements = inputLayout.GetCumulativeIncrement();
 
+            // Tile the output rows and columns, so the part of the input a tile reads stays in the cache
+            const auto outputRows = outputLayout.GetLogicalDimensionActiveSize(0);
+            const auto outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+            const size_t inputDepth = inputLayout.GetLogicalDimensionActiveSize(2);
+            const std::vector<LoopNestArrayAccess> arrays = { { { 0, 1 }, stride * stride * inputDepth * sizeof(ValueType) },
+                                                              { { 0, 1 }, sizeof(ValueType) },
+                                                              { {}, filterSize * filterSize * inputDepth * sizeof(ValueType) } };
+            const auto tiledRanges = GetCacheTiledLoopRanges(function.GetCompilerOptions().targetDevice, { { 0, outputRows }, { 0, outputColumns } }, arrays);
+
             // For each filter
             const auto numFilters = outputLayout.GetLogicalDimensionActiveSize(2);
-            function.ParallelFor(numFilters, { input, filterWeights, result }, [inputLayout, outputLayout, inputMemoryIncrements, filterSize, stride](IRFunctionEmitter& function, IRLocalScalar filterIndex, const std::vector<LLVMValue>& capturedValues) {
+            function.ParallelFor(numFilters, { input, filterWeights, result }, [inputLayout, outputLayout, inputMemoryIncrements, filterSize, stride, tiledRanges](IRFunctionEmitter& function, IRLocalScalar filterIndex, const std::vector<LLVMValue>& capturedValues) {
                 auto input = capturedValues[0];
                 auto filterWeights = capturedValues[1];
                 auto result = capturedValues[2];
                 auto outputTensor = function.LocalTensor(result, outputLayout.GetLogicalDimensionExtent().ToVector(), RowMajorTensorLayout);
 
-                // For each output row
-                const auto outputRows = outputLayout.GetLogicalDimensionActiveSize(0);
-                function.For(outputRows, [filterIndex, input, filterWeights, inputLayout, outputLayout, inputMemoryIncrements, outputTensor, filterSize, stride](IRFunctionEmitter& function, LLVMValue loopIndex2) {
-                    auto outputRow = function.LocalScalar(loopIndex2);
+                // For each tile of output rows and columns
+                function.For(tiledRanges, [filterIndex, input, filterWeights, inputLayout, inputMemoryIncrements, outputTensor, filterSize, stride](IRFunctionEmitter& function, std::vector<IRFunctionEmitter::BlockInterval> tiles) {
+                    // For each output row
+                    function.For(tiles[0].begin, tiles[0].end, [filterIndex, input, filterWeights, inputLayout, inputMemoryIncrements, outputTensor, filterSize, stride, tiles](IRFunctionEmitter& function, LLVMValue loopIndex2) {
+                        auto outputRow = function.LocalScalar(loopIndex2);
 
-                    // For each output column
-                    const auto outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
-                    function.For(outputColumns, [outputRow, filterIndex, input, filterWeights, inputLayout, inputMemoryIncrements, outputTensor, filterSize, stride](IRFunctionEmitter& function, LLVMValue loopIndex3) {
-                        auto outputColumn = function.LocalScalar(loopIndex3);
+                        // For each output column
+                        function.For(tiles[1].begin, tiles[1].end, [outputRow, filterIndex, input, filterWeights, inputLayout, inputMemoryIncrements, outputTensor, filterSize, stride](IRFunctionEmitter& function, LLVMValue loopIndex3) {
+                            auto outputColumn = function.LocalScalar(loopIndex3);
 
-                        const bool canCombineColumns = (inputLayout.GetLogicalDimensionActiveSize(1) == inputLayout.GetLogicalDimensionExtent(1)) && (stride == 1);
-                        const auto inputDepth = inputLayout.GetLogicalDimensionActiveSize(2);
+                            const bool canCombineColumns = (inputLayout.GetLogicalDimensionActiveSize(1) == inputLayout.GetLogicalDimensionExtent(1)) && (stride == 1);
+                            const auto inputDepth = inputLayout.GetLogicalDimensionActiveSize(2);
 
-                        // The filters are typically small, so we unroll the loops here
-                        auto val = function.LocalScalar(ValueType{ 0 });
-                        for (int windowRow = 0; windowRow < filterSize; ++windowRow)
-                        {
-                            // Note: if the memory storage from consecutive columns is contiguous, we can process them together and avoid a loop
-                            if (canCombineColumns)
-                            {
-                                auto inputOffset = ((outputRow + windowRow) * inputMemoryIncrements[0]) +
-                                                   (outputColumn * inputMemoryIncrements[1]);
-                                auto imageRow = function.PointerOffset(input, inputOffset);
-                                auto filterOffset = inputDepth * (filterSize * windowRow) +
-                                                    filterIndex * (filterSize * filterSize * inputDepth);
-                                auto filterRow = function.PointerOffset(filterWeights, filterOffset);
-                                val = val + function.DotProduct(filterSize * inputDepth, imageRow, filterRow);
-                            }
-                            else
+                            // The filters are typically small, so we unroll the loops here
+                            auto val = function.LocalScalar(ValueType{ 0 });
+                            for (int windowRow = 0; windowRow < filterSize; ++windowRow)
                             {
-                                for (int windowColumn = 0; windowColumn < filterSize; ++windowColumn)
+                                // Note: if the memory storage from consecutive columns is contiguous, we can process them together and avoid a loop
+                                if (canCombineColumns)
                                 {
-                                    // I[r+wc, c+wc]
-                                    auto inputRow = outputRow * stride;
-                                    auto inputColumn = outputColumn * stride;
-                                    auto inputOffset = ((inputRow + windowRow) * inputMemoryIncrements[0]) +
-                                                       ((inputColumn + windowColumn) * inputMemoryIncrements[1]);
+                                    auto inputOffset = ((outputRow + windowRow) * inputMemoryIncrements[0]) +
+                                                       (outputColumn * inputMemoryIncrements[1]);
                                     auto imageRow = function.PointerOffset(input, inputOffset);
-                                    auto filterOffset = inputDepth * (filterSize * windowRow + windowColumn) +
+                                    auto filterOffset = inputDepth * (filterSize * windowRow) +
                                                         filterIndex * (filterSize * filterSize * inputDepth);
                                     auto filterRow = function.PointerOffset(filterWeights, filterOffset);
-                                    val = val + function.DotProduct(inputDepth, imageRow, filterRow);
+                                    val = val + function.DotProduct(filterSize * inputDepth, imageRow, filterRow);
                                 }
+                                else
+                                {
+                                    for (int windowColumn = 0; windowColumn < filterSize; ++windowColumn)
+                                    {
+                                        // I[r+wc, c+wc]
+                                        auto inputRow = outputRow * stride;
+                                        auto inputColumn = outputColumn * stride;
+                                        auto inputOffset = ((inputRow + windowRow) * inputMemoryIncrements[0]) +
+                                                           ((inputColumn + windowColumn) * inputMemoryIncrements[1]);
+                                        auto imageRow = function.PointerOffset(input, inputOffset);
+                                        auto filterOffset = inputDepth * (filterSize * windowRow + windowColumn) +
+                                                            filterIndex * (filterSize * filterSize * inputDepth);
+                                        auto filterRow = function.PointerOffset(filterWeights, filterOffset);
+                                        val = val + function.DotProduct(inputDepth, imageRow, filterRow);
+                                    }
+                                }
+                                outputTensor({ outputRow, outputColumn, filterIndex }) = val;
                             }
-                            outputTensor({ outputRow, outputColumn, filterIndex }) = val;
-                        }
-                    }); // End outputColumns loop
-                }); // End outputRows loop
+                        }); // End outputColumns loop
+                    }); // End outputRows loop
+                }); // End tiles loop
             }); // End numFilters loop
         }
 
@@ -10,6 +10,9 @@
 #include "BroadcastFunctionNode.h"
 #include "ConstantNode.h"
 
+#include <emitters/include/IRMath.h>
+#include <emitters/include/IRVectorUtilities.h>
+
 namespace ell
 {
 namespace nodes
@@ -63,7 +66,6 @@ namespace nodes
             {
                 auto valueType = emitters::GetVariableType<ValueType>();
                 _accumValueVar = function.Variable(valueType, "eulerSumAccumValue");
-                _expFunc = function.GetModule().GetRuntime().GetExpFunction<ValueType>();
                 Reset(function);
             }
 
@@ -77,7 +79,7 @@ namespace nodes
                 const auto plusFloat = emitters::TypedOperator::addFloat;
                 const auto minusFloat = emitters::TypedOperator::subtractFloat;
                 auto valueMinusMax = function.Operator(minusFloat, x, _maxValue);
-                auto eulerVal = function.Call(_expFunc, { valueMinusMax });
+                auto eulerVal = emitters::Exp(function.LocalScalar(valueMinusMax)).value;
                 function.OperationAndUpdate(_accumValueVar, plusFloat, eulerVal);
                 return eulerVal;
             }
@@ -88,7 +90,6 @@ namespace nodes
             }
 
         private:
-            emitters::LLVMFunction _expFunc;
             emitters::LLVMValue _maxValue;
             emitters::LLVMValue _accumValueVar;
         };
@@ -116,8 +117,111 @@ namespace nodes
             emitters::LLVMValue _sum;
         };
 
+        // The values aren't necessarily aligned to the vector size, so load and store vectors with the element alignment
+        emitters::LLVMValue LoadVector(emitters::IRFunctionEmitter& function, emitters::LLVMValue pointer, emitters::LLVMType vectorPointerType, unsigned alignment)
+        {
+            auto vectorPointer = function.CastPointer(pointer, vectorPointerType);
+            return function.GetEmitter().GetIRBuilder().CreateAlignedLoad(vectorPointer, alignment);
+        }
+
+        void StoreVector(emitters::IRFunctionEmitter& function, emitters::LLVMValue pointer, emitters::LLVMType vectorPointerType, unsigned alignment, emitters::LLVMValue value)
+        {
+            auto vectorPointer = function.CastPointer(pointer, vectorPointerType);
+            function.GetEmitter().GetIRBuilder().CreateAlignedStore(value, vectorPointer, alignment);
+        }
+
+        emitters::LLVMValue EmitMax(emitters::IRFunctionEmitter& function, emitters::LLVMValue a, emitters::LLVMValue b)
+        {
+            return function.Select(function.Comparison(emitters::TypedComparison::greaterThanFloat, a, b), a, b);
+        }
     } // end anonymous namespace
 
+    template <typename ValueType>
+    void EmitSoftmax(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::LLVMValue output, int size)
+    {
+        if (size <= 0)
+        {
+            return;
+        }
+
+        // Process the values in blocks of the vector width, and the leftover values one at a time
+        const auto& compilerSettings = function.GetCompilerOptions();
+        const int vectorSize = compilerSettings.allowVectorInstructions ? compilerSettings.vectorWidth : 1;
+        const int numVectorBlocks = vectorSize > 1 ? size / vectorSize : 0;
+        const int firstScalarIndex = numVectorBlocks * vectorSize;
+        const auto valueType = emitters::GetVariableType<ValueType>();
+        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+        auto vectorType = numVectorBlocks > 0 ? function.GetEmitter().VectorType(valueType, vectorSize) : nullptr;
+        auto vectorPointerType = numVectorBlocks > 0 ? vectorType->getPointerTo() : nullptr;
+        const unsigned alignment = sizeof(ValueType);
+        const auto lowest = std::numeric_limits<ValueType>::lowest();
+
+        // Find the max value, which is subtracted before taking exponentials so they can't overflow
+        auto maxVar = function.Variable(valueType, "softmaxMax");
+        function.Store(maxVar, function.Literal<ValueType>(lowest));
+        if (numVectorBlocks > 0)
+        {
+            auto maxVectorVar = function.Variable(vectorType, "softmaxMaxVector");
+            function.Store(maxVectorVar, emitters::FillVector<ValueType>(function, vectorType, lowest));
+            function.For(numVectorBlocks, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockIndex) {
+                auto value = LoadVector(function, function.PointerOffset(input, function.LocalScalar(blockIndex) * vectorSize), vectorPointerType, alignment);
+                function.Store(maxVectorVar, EmitMax(function, value, function.Load(maxVectorVar)));
+            });
+            function.Store(maxVar, emitters::HorizontalVectorMax<ValueType>(function, function.Load(maxVectorVar)));
+        }
+        if (firstScalarIndex < size)
+        {
+            function.For(firstScalarIndex, size, 1, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue index) {
+                function.Store(maxVar, EmitMax(function, function.ValueAt(input, index), function.Load(maxVar)));
+            });
+        }
+        auto maxValue = function.Load(maxVar);
+
+        // Compute the exponentials, store them in the output, and sum them
+        auto sumVar = function.Variable(valueType, "softmaxSum");
+        function.StoreZero(sumVar);
+        if (numVectorBlocks > 0)
+        {
+            auto maxVector = irBuilder.CreateVectorSplat(vectorSize, maxValue);
+            auto sumVectorVar = function.Variable(vectorType, "softmaxSumVector");
+            function.Store(sumVectorVar, emitters::FillVector<ValueType>(function, vectorType, 0));
+            function.For(numVectorBlocks, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockIndex) {
+                auto offset = function.LocalScalar(blockIndex) * vectorSize;
+                auto value = LoadVector(function, function.PointerOffset(input, offset), vectorPointerType, alignment);
+                auto eulerValue = emitters::Exp(function.LocalScalar(function.Operator(emitters::GetSubtractForValueType<ValueType>(), value, maxVector))).value;
+                StoreVector(function, function.PointerOffset(output, offset), vectorPointerType, alignment, eulerValue);
+                function.Store(sumVectorVar, function.Operator(emitters::GetAddForValueType<ValueType>(), function.Load(sumVectorVar), eulerValue));
+            });
+            function.Store(sumVar, emitters::HorizontalVectorSum<ValueType>(function, function.Load(sumVectorVar)));
+        }
+        if (firstScalarIndex < size)
+        {
+            function.For(firstScalarIndex, size, 1, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue index) {
+                auto eulerValue = emitters::Exp(function.LocalScalar(function.ValueAt(input, index)) - maxValue);
+                function.SetValueAt(output, index, eulerValue);
+                function.Store(sumVar, eulerValue + function.Load(sumVar));
+            });
+        }
+
+        // Scale the exponentials by the reciprocal of their sum
+        auto scale = function.Operator(emitters::GetDivideForValueType<ValueType>(), function.Literal<ValueType>(1), function.Load(sumVar));
+        if (numVectorBlocks > 0)
+        {
+            auto scaleVector = irBuilder.CreateVectorSplat(vectorSize, scale);
+            function.For(numVectorBlocks, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue blockIndex) {
+                auto pointer = function.PointerOffset(output, function.LocalScalar(blockIndex) * vectorSize);
+                auto value = LoadVector(function, pointer, vectorPointerType, alignment);
+                StoreVector(function, pointer, vectorPointerType, alignment, function.Operator(emitters::GetMultiplyForValueType<ValueType>(), value, scaleVector));
+            });
+        }
+        if (firstScalarIndex < size)
+        {
+            function.For(firstScalarIndex, size, 1, [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue index) {
+                function.SetValueAt(output, index, function.LocalScalar(function.ValueAt(output, index)) * scale);
+            });
+        }
+    }
+
     template <typename ValueType>
     SoftmaxLayerNode<ValueType>::SoftmaxLayerNode(const model::OutputPort<ValueType>& input, const predictors::neural::SoftmaxLayer<ValueType>& layer) :
         NeuralNetworkLayerNode<SoftmaxLayerNode<ValueType>, predictors::neural::SoftmaxLayer<ValueType>, ValueType>(input, layer)
@@ -130,6 +234,13 @@ namespace nodes
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
 
+        // Unpadded input and output can be treated as flat arrays
+        if (this->GetInputMemoryLayout().IsContiguous() && this->GetOutputMemoryLayout().IsContiguous())
+        {
+            EmitSoftmax<ValueType>(function, pInput, pOutput, static_cast<int>(this->GetInputMemoryLayout().NumElements()));
+            return;
+        }
+
         emitters::LLVMValue prevInputDimensionOffset = nullptr;
         emitters::LLVMValue prevOutputDimensionOffset = nullptr;
 
@@ -268,6 +379,8 @@ namespace nodes
     }
 
     // Explicit specialization
+    template void EmitSoftmax<float>(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::LLVMValue output, int size);
+    template void EmitSoftmax<double>(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::LLVMValue output, int size);
     template class SoftmaxLayerNode<float>;
     template class SoftmaxLayerNode<double>;
 } // namespace nodes
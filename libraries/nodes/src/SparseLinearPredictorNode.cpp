@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseLinearPredictorNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SparseLinearPredictorNode.h"
+
+#include <emitters/include/IRLocalScalar.h>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    SparseLinearPredictorNode<ValueType>::SparseLinearPredictorNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 1)
+    {
+    }
+
+    template <typename ValueType>
+    SparseLinearPredictorNode<ValueType>::SparseLinearPredictorNode(const model::OutputPort<ValueType>& input, const LinearPredictorType& predictor) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, 1),
+        _weights(predictor.GetWeights().ToArray()),
+        _bias(predictor.GetBias())
+    {
+        ValidateInputSize();
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::ValidateInputSize() const
+    {
+        if (_input.Size() % 2 != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SparseLinearPredictorNode: input must be a list of (index, value) pairs");
+        }
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::Compute() const
+    {
+        const auto size = static_cast<ValueType>(_weights.size());
+        ValueType sum = _bias;
+        for (size_t i = 0; i < GetMaxNonZeros(); ++i)
+        {
+            auto index = _input[2 * i];
+            if (index >= 0 && index < size)
+            {
+                sum += _weights[static_cast<size_t>(index)] * _input[2 * i + 1];
+            }
+        }
+        _output.SetOutput({ sum });
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        auto accumulator = function.Variable(emitters::GetVariableType<ValueType>(), "accumulator");
+        function.Store(accumulator, function.Literal<ValueType>(_bias));
+
+        // Only the weights of the nonzero entries are read, so the dense input is never built
+        if (!_weights.empty())
+        {
+            auto pWeights = function.GetModule().ConstantArray(compiler.GetGlobalName(*this, "weights"), _weights);
+            const auto size = static_cast<ValueType>(_weights.size());
+            function.For(static_cast<int>(GetMaxNonZeros()), [pInput, pWeights, accumulator, size](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+                auto pairIndex = function.LocalScalar(i) * 2;
+                auto index = function.LocalScalar(function.ValueAt(pInput, pairIndex));
+                auto isInRange = (index >= static_cast<ValueType>(0)) && (index < size);
+                function.If(isInRange, [pInput, pWeights, accumulator, pairIndex, index](emitters::IRFunctionEmitter& function) {
+                    auto weight = function.LocalScalar(function.ValueAt(pWeights, function.CastValue<int>(index)));
+                    auto value = function.LocalScalar(function.ValueAt(pInput, pairIndex + 1));
+                    function.Store(accumulator, function.LocalScalar(function.Load(accumulator)) + weight * value);
+                });
+            });
+        }
+        function.SetValueAt(pOutput, function.Literal(0), function.Load(accumulator));
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<SparseLinearPredictorNode<ValueType>>(newInput, LinearPredictorType(math::ColumnVector<ValueType>(_weights), _bias));
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["weights"] << _weights;
+        archiver["bias"] << _bias;
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["weights"] >> _weights;
+        archiver["bias"] >> _bias;
+        ValidateInputSize();
+    }
+
+    // Explicitly instantiate versions
+    template class SparseLinearPredictorNode<float>;
+    template class SparseLinearPredictorNode<double>;
+} // namespace nodes
+} // namespace ell
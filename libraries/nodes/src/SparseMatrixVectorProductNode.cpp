@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseMatrixVectorProductNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SparseMatrixVectorProductNode.h"
+
+#include <emitters/include/IRLocalScalar.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    SparseMatrixVectorProductNode<ValueType>::SparseMatrixVectorProductNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    SparseMatrixVectorProductNode<ValueType>::SparseMatrixVectorProductNode(const model::OutputPort<ValueType>& input, const SparseMatrix<ValueType>& weights) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, weights.numRows),
+        _weights(weights)
+    {
+        if (input.Size() != weights.numColumns)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SparseMatrixVectorProductNode: input size must match the number of columns in the matrix");
+        }
+        ValidateWeights();
+    }
+
+    template <typename ValueType>
+    void SparseMatrixVectorProductNode<ValueType>::ValidateWeights() const
+    {
+        if (_weights.rowOffsets.size() != _weights.numRows + 1 || _weights.columnIndices.size() != _weights.values.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "SparseMatrixVectorProductNode: wrong number of row offsets or column indices");
+        }
+
+        if (_weights.rowOffsets.front() != 0 || _weights.rowOffsets.back() != static_cast<int>(_weights.values.size()) || !std::is_sorted(_weights.rowOffsets.begin(), _weights.rowOffsets.end()))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SparseMatrixVectorProductNode: row offsets must be nondecreasing and span the nonzero entries");
+        }
+
+        for (auto column : _weights.columnIndices)
+        {
+            if (column < 0 || column >= static_cast<int>(_weights.numColumns))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "SparseMatrixVectorProductNode: column index out of range");
+            }
+        }
+    }
+
+    template <typename ValueType>
+    void SparseMatrixVectorProductNode<ValueType>::Compute() const
+    {
+        const auto m = _weights.numRows;
+        std::vector<ValueType> result(m);
+        for (size_t i = 0; i < m; ++i)
+        {
+            ValueType sum = 0;
+            for (int index = _weights.rowOffsets[i]; index < _weights.rowOffsets[i + 1]; ++index)
+            {
+                sum += _weights.values[index] * _input[_weights.columnIndices[index]];
+            }
+            result[i] = sum;
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void SparseMatrixVectorProductNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        const int m = static_cast<int>(_weights.numRows);
+
+        // A matrix with no nonzero entries has nothing to multiply
+        if (_weights.values.empty())
+        {
+            function.For(m, [pOutput](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+                function.SetValueAt(pOutput, i, function.Literal<ValueType>(0));
+            });
+            return;
+        }
+
+        auto& module = function.GetModule();
+        auto pRowOffsets = module.ConstantArray(compiler.GetGlobalName(*this, "rowOffsets"), _weights.rowOffsets);
+        auto pColumnIndices = module.ConstantArray(compiler.GetGlobalName(*this, "columnIndices"), _weights.columnIndices);
+        auto pValues = module.ConstantArray(compiler.GetGlobalName(*this, "values"), _weights.values);
+
+        auto accumulator = function.Variable(emitters::GetVariableType<ValueType>(), "accumulator");
+        function.For(m, [pRowOffsets, pColumnIndices, pValues, pInput, pOutput, accumulator](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            auto rowIndex = function.LocalScalar(i);
+            auto rowBegin = function.ValueAt(pRowOffsets, rowIndex);
+            auto rowEnd = function.ValueAt(pRowOffsets, rowIndex + 1);
+            function.Store(accumulator, function.Literal<ValueType>(0));
+            function.For(rowBegin, rowEnd, [pColumnIndices, pValues, pInput, accumulator](emitters::IRFunctionEmitter& function, emitters::LLVMValue index) {
+                auto column = function.ValueAt(pColumnIndices, index);
+                auto weight = function.LocalScalar(function.ValueAt(pValues, index));
+                auto value = function.LocalScalar(function.ValueAt(pInput, column));
+                function.Store(accumulator, function.LocalScalar(function.Load(accumulator)) + weight * value);
+            });
+            function.SetValueAt(pOutput, rowIndex, function.Load(accumulator));
+        });
+    }
+
+    template <typename ValueType>
+    void SparseMatrixVectorProductNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<SparseMatrixVectorProductNode<ValueType>>(newInput, _weights);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void SparseMatrixVectorProductNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["numRows"] << _weights.numRows;
+        archiver["numColumns"] << _weights.numColumns;
+        archiver["rowOffsets"] << _weights.rowOffsets;
+        archiver["columnIndices"] << _weights.columnIndices;
+        archiver["values"] << _weights.values;
+    }
+
+    template <typename ValueType>
+    void SparseMatrixVectorProductNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["numRows"] >> _weights.numRows;
+        archiver["numColumns"] >> _weights.numColumns;
+        archiver["rowOffsets"] >> _weights.rowOffsets;
+        archiver["columnIndices"] >> _weights.columnIndices;
+        archiver["values"] >> _weights.values;
+        ValidateWeights();
+    }
+
+    // Explicitly instantiate versions
+    template class SparseMatrixVectorProductNode<float>;
+    template class SparseMatrixVectorProductNode<double>;
+} // namespace nodes
+} // namespace ell
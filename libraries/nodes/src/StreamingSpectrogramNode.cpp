@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StreamingSpectrogramNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StreamingSpectrogramNode.h"
+#include "FFTNode.h"
+#include "FilterBankNode.h"
+
+#include <dsp/include/DCT.h>
+#include <dsp/include/WindowFunctions.h>
+
+#include <emitters/include/IRLocalScalar.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    StreamingSpectrogramNode<ValueType>::StreamingSpectrogramNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0),
+        _dctCoeffs(0, 0)
+    {
+    }
+
+    template <typename ValueType>
+    StreamingSpectrogramNode<ValueType>::StreamingSpectrogramNode(const model::OutputPort<ValueType>& input, size_t windowSize, size_t fftSize, const dsp::MelFilterBank& filters, size_t numDCTCoefficients) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0),
+        _windowSize(windowSize),
+        _fftSize(fftSize),
+        _filters(filters),
+        _numDCTCoefficients(numDCTCoefficients),
+        _dctCoeffs(0, 0)
+    {
+        Initialize();
+    }
+
+    template <typename ValueType>
+    void StreamingSpectrogramNode<ValueType>::Initialize()
+    {
+        if (_input.Size() == 0 || _input.Size() > _windowSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "StreamingSpectrogramNode: the hop size must be positive and no larger than the window size");
+        }
+
+        double power = std::log2(_fftSize);
+        if (_fftSize < _windowSize || std::floor(power) != power)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "StreamingSpectrogramNode: fftSize must be a power of 2 that is at least the window size");
+        }
+
+        // The filters may only read the fftSize / 2 magnitudes
+        const auto& coefficients = _filters.GetPackedCoefficients();
+        const auto numFilters = _filters.NumActiveFilters();
+        if (coefficients.offsets.size() != numFilters + 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "StreamingSpectrogramNode: bad filter coefficients");
+        }
+        for (size_t index = 0; index < numFilters; ++index)
+        {
+            if (coefficients.startBins[index] + coefficients.offsets[index + 1] - coefficients.offsets[index] > static_cast<int>(_fftSize / 2))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "StreamingSpectrogramNode: the filters are too wide for the FFT size");
+            }
+        }
+
+        _window = dsp::HammingWindow<ValueType>(_windowSize);
+        _plan = dsp::FFTPlan<ValueType>(_fftSize);
+        if (_numDCTCoefficients > 0)
+        {
+            // A (numDCTCoefficients x numFilters) matrix: the DCT-II of the filter bank energies
+            _dctCoeffs = dsp::GetDCTMatrix<ValueType>(numFilters, _numDCTCoefficients);
+        }
+        Reset();
+        _output.SetSize(_numDCTCoefficients > 0 ? _numDCTCoefficients : numFilters);
+    }
+
+    template <typename ValueType>
+    void StreamingSpectrogramNode<ValueType>::Reset()
+    {
+        _samples.assign(_windowSize, 0);
+    }
+
+    template <typename ValueType>
+    void StreamingSpectrogramNode<ValueType>::Compute() const
+    {
+        // Slide the window by one hop
+        const auto hopSize = _input.Size();
+        std::copy(_samples.begin() + hopSize, _samples.end(), _samples.begin());
+        const auto& input = _input.GetValue();
+        std::copy(input.begin(), input.end(), _samples.end() - hopSize);
+
+        std::vector<ValueType> signal(_fftSize);
+        for (size_t index = 0; index < _windowSize; ++index)
+        {
+            signal[index] = _samples[index] * _window[index];
+        }
+
+        std::vector<std::complex<ValueType>> spectrum(_fftSize / 2 + 1);
+        _plan.TransformReal(signal.data(), spectrum.data());
+        std::vector<ValueType> magnitudes(_fftSize / 2);
+        for (size_t index = 0; index < magnitudes.size(); ++index)
+        {
+            magnitudes[index] = std::abs(spectrum[index]);
+        }
+
+        auto energies = _filters.FilterFrequencyMagnitudes(magnitudes);
+        if (_numDCTCoefficients == 0)
+        {
+            _output.SetOutput(energies);
+            return;
+        }
+
+        std::vector<ValueType> result(_numDCTCoefficients);
+        for (size_t row = 0; row < _numDCTCoefficients; ++row)
+        {
+            ValueType sum = 0;
+            for (size_t column = 0; column < energies.size(); ++column)
+            {
+                sum += _dctCoeffs(row, column) * energies[column];
+            }
+            result[row] = sum;
+        }
+        _output.SetOutput(result);
+    }
+
+    template <typename ValueType>
+    void StreamingSpectrogramNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using emitters::IRLocalScalar;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        const int hopSize = static_cast<int>(_input.Size());
+        const int windowSize = static_cast<int>(_windowSize);
+        const int fftSize = static_cast<int>(_fftSize);
+        auto& module = function.GetModule();
+        auto valueType = function.GetEmitter().Type(emitters::GetVariableType<ValueType>());
+
+        // The ring buffer holds each sample twice, at `i` and `i + windowSize`, and `head` is the index of the oldest
+        // sample, so the current window is always samples[head, head + windowSize)
+        auto samplesVar = module.Variables().AddVectorVariable<ValueType>(emitters::VariableScope::global, 2 * windowSize);
+        module.AllocateVariable(*samplesVar);
+        emitters::LLVMValue samples = module.EnsureEmitted(*samplesVar);
+        auto headVar = module.Variables().AddScalarVariable<int>(emitters::VariableScope::global, 0);
+        module.AllocateVariable(*headVar);
+        emitters::LLVMValue pHead = module.EnsureEmitted(*headVar);
+
+        // Overwrite the oldest hop with the new one
+        auto head = function.LocalScalar(function.Load(pHead));
+        function.For(hopSize, [=](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            auto position = head + i;
+            auto index = function.LocalScalar(function.Select(position >= windowSize, position - windowSize, position));
+            auto value = function.ValueAt(pInput, i);
+            function.SetValueAt(samples, index, value);
+            function.SetValueAt(samples, index + windowSize, value);
+        });
+        auto newHead = head + hopSize;
+        newHead = function.LocalScalar(function.Select(newHead >= windowSize, newHead - windowSize, newHead));
+        function.Store(pHead, newHead);
+
+        // Apply the window, and zero-pad up to the FFT size
+        auto window = module.ConstantArray(compiler.GetGlobalName(*this, "window"), _window);
+        auto currentWindow = function.PointerOffset(samples, newHead);
+        emitters::LLVMValue signal = function.Variable(valueType, fftSize);
+        function.For(windowSize, [window, currentWindow, signal](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            auto sample = function.LocalScalar(function.ValueAt(currentWindow, i));
+            function.SetValueAt(signal, i, sample * function.ValueAt(window, i));
+        });
+        function.For(windowSize, fftSize, [signal](emitters::IRFunctionEmitter& function, IRLocalScalar i) {
+            function.SetValueAt(signal, i, function.Literal<ValueType>(0));
+        });
+
+        emitters::LLVMValue magnitudes = function.Variable(valueType, fftSize / 2);
+        EmitFFTMagnitudes(compiler, function, *this, _plan, signal, magnitudes);
+
+        if (_numDCTCoefficients == 0)
+        {
+            EmitFilterBank<ValueType>(compiler, function, *this, _filters, magnitudes, pOutput);
+            return;
+        }
+
+        const int numFilters = static_cast<int>(_filters.NumActiveFilters());
+        emitters::LLVMValue energies = function.Variable(valueType, numFilters);
+        EmitFilterBank<ValueType>(compiler, function, *this, _filters, magnitudes, energies);
+
+        std::vector<ValueType> dctCoeffs;
+        dctCoeffs.reserve(_dctCoeffs.NumRows() * _dctCoeffs.NumColumns());
+        for (size_t row = 0; row < _dctCoeffs.NumRows(); ++row)
+        {
+            for (size_t column = 0; column < _dctCoeffs.NumColumns(); ++column)
+            {
+                dctCoeffs.push_back(_dctCoeffs(row, column));
+            }
+        }
+        auto pDCT = module.ConstantArray(compiler.GetGlobalName(*this, "dctCoefficients"), dctCoeffs);
+        function.CallGEMV<ValueType>(static_cast<int>(_numDCTCoefficients), numFilters, function.PointerOffset(pDCT, 0), numFilters, energies, 1, pOutput, 1);
+    }
+
+    template <typename ValueType>
+    void StreamingSpectrogramNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<StreamingSpectrogramNode<ValueType>>(newInput, _windowSize, _fftSize, _filters, _numDCTCoefficients);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void StreamingSpectrogramNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["windowSize"] << _windowSize;
+        archiver["fftSize"] << _fftSize;
+        archiver["filters"] << _filters;
+        archiver["numDCTCoefficients"] << _numDCTCoefficients;
+    }
+
+    template <typename ValueType>
+    void StreamingSpectrogramNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["windowSize"] >> _windowSize;
+        archiver["fftSize"] >> _fftSize;
+        archiver["filters"] >> _filters;
+        archiver["numDCTCoefficients"] >> _numDCTCoefficients;
+        Initialize();
+    }
+
+    // Explicit instantiations
+    template class StreamingSpectrogramNode<float>;
+    template class StreamingSpectrogramNode<double>;
+} // namespace nodes
+} // namespace ell
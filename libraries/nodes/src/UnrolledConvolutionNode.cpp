@@ -14,6 +14,8 @@
 
 #include <utilities/include/Unused.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace nodes
@@ -198,9 +200,99 @@ namespace nodes
         return true;
     }
 
+    template <typename ValueType>
+    bool UnrolledConvolutionNode<ValueType>::CanCompileImplicitGemm(const model::MapCompiler* compiler) const
+    {
+        if (_isDepthwiseSeparable || compiler == nullptr || !compiler->GetModelOptimizerOptions(*this).template GetEntry<bool>("implicitGemmConvolution", true))
+        {
+            return false;
+        }
+
+        // Each row of a receptive field is copied into the panel with a single memcpy, so the input must be in
+        // (row, column, channel) order with no padding between channels, and the output must be unpadded
+        const auto& inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        return inputLayout.GetLogicalDimensionOrder() == utilities::RowMajorTensorOrder &&
+               inputLayout.GetLogicalDimensionOffset(2) == 0 &&
+               inputLayout.GetLogicalDimensionExtent(2) == inputLayout.GetLogicalDimensionActiveSize(2) &&
+               outputLayout.IsCanonicalOrder() &&
+               !outputLayout.HasPadding();
+    }
+
+    template <typename ValueType>
+    void UnrolledConvolutionNode<ValueType>::CompileImplicitGemm(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(this->input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(this->output);
+
+        const auto& inputLayout = this->GetInputMemoryLayout();
+        const auto outputLayout = this->GetOutputMemoryLayout();
+        const int inputDepth = inputLayout.GetLogicalDimensionActiveSize(2);
+        const int outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        const int outputElements = outputLayout.GetLogicalDimensionActiveSize(0) * outputColumns;
+
+        // The input buffer includes its padding, which supplies the zeros around the edges of the image
+        const auto inputIncrement = inputLayout.GetCumulativeIncrement();
+        const int rowIncrement = inputIncrement[0];
+        const int columnIncrement = inputIncrement[1];
+        const int fieldRowSize = _filterSize * inputDepth; // the (column, channel) entries of one row of a receptive field are contiguous in the input
+
+        // weights: numFilters x fieldVolumeSize == m x k, in (row, column, channel) order
+        const auto m = static_cast<int>(_filterWeights.NumRows());
+        const auto k = static_cast<int>(_filterWeights.NumColumns());
+        auto pVarWeights = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(_filterWeights.ToArray());
+        auto weights = function.GetModule().EnsureEmitted(*pVarWeights);
+
+        // Pick the number of output pixels per tile so that the panel (pixels x k) fits in the cache
+        const int defaultPanelSize = (32 * 1024) / sizeof(ValueType);
+        const auto panelSize = compiler.GetModelOptimizerOptions(*this).template GetEntry<int>("implicitGemmPanelSize", defaultPanelSize);
+        const int tileSize = std::max(1, std::min(outputElements, panelSize / k));
+        const int numFullTiles = outputElements / tileSize;
+        const int remainder = outputElements % tileSize;
+        llvm::AllocaInst* panel = function.Variable(emitters::GetVariableType<ValueType>(), tileSize * k);
+
+        auto emitTile = [this, pInput, pOutput, panel, weights, m, k, outputColumns, rowIncrement, columnIncrement, fieldRowSize](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar tileStart, int numPixels) {
+            // Gather the receptive fields of the tile's output pixels into the rows of the panel
+            function.For(numPixels, [&](emitters::IRFunctionEmitter& function, emitters::LLVMValue indexValue) {
+                auto index = function.LocalScalar(indexValue);
+                auto pixel = tileStart + index;
+                auto inputRow = (pixel / outputColumns) * _stride;
+                auto inputColumn = (pixel % outputColumns) * _stride;
+                auto fieldOffset = (inputRow * rowIncrement) + (inputColumn * columnIncrement);
+                auto panelOffset = index * k;
+
+                // Unroll this inner loop since _filterSize is generally small
+                for (int fieldRow = 0; fieldRow < _filterSize; ++fieldRow)
+                {
+                    auto source = function.PointerOffset(pInput, fieldOffset + (fieldRow * rowIncrement));
+                    auto destination = function.PointerOffset(panel, panelOffset + (fieldRow * fieldRowSize));
+                    function.MemoryCopy<ValueType>(source, destination, fieldRowSize);
+                }
+            });
+
+            // output (pixels x filters) = panel (pixels x k) * weights' (k x filters), written straight into the tile's rows of the output
+            auto outputPtr = function.PointerOffset(pOutput, tileStart * m);
+            function.CallGEMM<ValueType>(false, true, numPixels, m, k, panel, k, weights, k, outputPtr, m);
+        };
+
+        function.For(numFullTiles, [&](emitters::IRFunctionEmitter& function, emitters::LLVMValue tileValue) {
+            emitTile(function, function.LocalScalar(tileValue) * tileSize, tileSize);
+        });
+        if (remainder > 0)
+        {
+            emitTile(function, function.LocalScalar(numFullTiles * tileSize), remainder);
+        }
+    }
+
     template <typename ValueType>
     void UnrolledConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
+        if (!_isDepthwiseSeparable)
+        {
+            CompileImplicitGemm(compiler, function);
+            return;
+        }
+
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(this->input);
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(this->output);
 
@@ -33,11 +33,12 @@ namespace nodes
                                                          double gainAtt,
                                                          double thresholdUp,
                                                          double thresholdDown,
-                                                         double levelThreshold) :
+                                                         double levelThreshold,
+                                                         int decimation) :
         CompilableCodeNode("VoiceActivityDetector", { &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, ell::model::Port::PortType::integer, utilities::ScalarLayout),
-        _vad(sampleRate, input.Size(), frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold)
+        _vad(sampleRate, input.Size(), frameDuration, tauUp, tauDown, largeInput, gainAtt, thresholdUp, thresholdDown, levelThreshold, decimation)
     {
     }
 
@@ -56,7 +57,7 @@ namespace nodes
     void VoiceActivityDetectorNode::Copy(model::ModelTransformer& transformer) const
     {
         const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
-        auto newNode = transformer.AddNode<VoiceActivityDetectorNode>(newPortElements, _vad.GetSampleRate(), _vad.GetFrameDuration(), _vad.GetTauUp(), _vad.GetTauDown(), _vad.GetLargeInput(), _vad.GetGainAtt(), _vad.GetThresholdUp(), _vad.GetThresholdDown(), _vad.GetLevelThreshold());
+        auto newNode = transformer.AddNode<VoiceActivityDetectorNode>(newPortElements, _vad.GetSampleRate(), _vad.GetFrameDuration(), _vad.GetTauUp(), _vad.GetTauDown(), _vad.GetLargeInput(), _vad.GetGainAtt(), _vad.GetThresholdUp(), _vad.GetThresholdDown(), _vad.GetLevelThreshold(), _vad.GetDecimation());
         transformer.MapNodeOutput(output, newNode->output);
     }
 
@@ -1093,16 +1093,21 @@ namespace nodes
                                                                 const model::PortMemoryLayout& inputMemoryLayout,
                                                                 const model::PortMemoryLayout& outputMemoryLayout,
                                                                 const ConstTensorReferenceType& filterWeights,
-                                                                int stride) :
+                                                                int stride,
+                                                                int tileSize) :
         CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, outputMemoryLayout),
         _inputMemoryLayout(inputMemoryLayout),
-        _stride(stride)
+        _stride(stride),
+        _tileSize(tileSize)
     {
         using FilterOrder = typename WinogradConvolutionNode<ValueType>::FilterOrder;
 
-        _tileSize = 2;
+        if (_tileSize < 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "WinogradConvolutionNode tileSize must be positive");
+        }
         const int numFilters = outputMemoryLayout.GetLogicalDimensionActiveSize(2);
         const int numFilterChannels = static_cast<int>(filterWeights.NumChannels());
         const int filtersFirstThreshold = 4; // empirically determined
@@ -38,6 +38,7 @@ struct SimpleOptions
 
 struct UnrolledOptions
 {
+    bool implicitGemm;
 };
 
 struct DiagonalOptions
@@ -46,11 +47,14 @@ struct DiagonalOptions
 
 union ConvolutionOptions
 {
-    ConvolutionOptions() {}
+    ConvolutionOptions() :
+        unrolledOptions({ true }) {}
     ConvolutionOptions(int tileSize, ell::dsp::WinogradFilterOrder order) :
         winogradOptions({ tileSize, order }) {}
     ConvolutionOptions(int tileSize) :
         winogradOptions({ tileSize, ell::dsp::WinogradFilterOrder::tilesFirst }) {}
+    ConvolutionOptions(bool implicitGemm) :
+        unrolledOptions({ implicitGemm }) {}
 
     WinogradOptions winogradOptions;
     SimpleOptions simpleOptions;
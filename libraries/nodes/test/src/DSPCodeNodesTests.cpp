@@ -14,6 +14,8 @@
 
 #include <common/include/DataLoaders.h>
 
+#include <dsp/include/VoiceActivityDetector.h>
+
 #include <data/include/Dataset.h>
 #include <data/include/Example.h>
 #include <data/include/WeightLabel.h>
@@ -129,6 +131,48 @@ static void TestVoiceActivityDetectorNode(const std::string& path)
     });
 }
 
+static void TestDecimatedVoiceActivityDetectorNodeOnLevels()
+{
+    using ElementType = float;
+    const int decimation = 4;
+
+    // An input of size 1 is the level of the frame, which the front end has already computed
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(1);
+    auto outputNode = model.AddNode<nodes::VoiceActivityDetectorNode>(inputNode->output, SampleRate, FrameDuration, TauUp, TauDown, LargeInput, GainAtt, ThresholdUp, ThresholdDown, LevelThreshold, decimation);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", outputNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    model::IRMapCompiler compiler(settings, {});
+    auto compiledMap = compiler.Compile(map);
+
+    // Silence, then a loud signal, then silence again
+    dsp::VoiceActivityDetector reference(SampleRate, 1, FrameDuration, TauUp, TauDown, LargeInput, GainAtt, ThresholdUp, ThresholdDown, LevelThreshold, decimation);
+    int refErrors = 0;
+    int compileErrors = 0;
+    for (int frame = 0; frame < 80; ++frame)
+    {
+        ElementType level = (frame >= 50 && frame < 60) ? 1.0f : 0.01f;
+        int expectedSignal = reference.ProcessLevel(level);
+
+        map.SetInputValue("input", std::vector<ElementType>{ level });
+        if (map.ComputeOutput<int>("output")[0] != expectedSignal)
+        {
+            ++refErrors;
+        }
+
+        compiledMap.SetInputValue(0, std::vector<ElementType>{ level });
+        if (compiledMap.ComputeOutput<int>(0)[0] != expectedSignal)
+        {
+            ++compileErrors;
+        }
+    }
+
+    testing::ProcessTest(utilities::FormatString("Testing decimated VoiceActivityDetectorNode on levels Compute, %d errors", refErrors), refErrors == 0);
+    testing::ProcessTest(utilities::FormatString("Testing decimated VoiceActivityDetectorNode on levels Compiled, %d errors", compileErrors), compileErrors == 0);
+}
+
 void TestGRUNodeWithVADReset(const std::string& path)
 {
     using ElementType = double;
@@ -224,5 +268,6 @@ void TestGRUNodeWithVADReset(const std::string& path)
 void TestDSPCodeNodes(const std::string& path)
 {
     TestVoiceActivityDetectorNode(path);
+    TestDecimatedVoiceActivityDetectorNodeOnLevels();
     TestGRUNodeWithVADReset(path);
 }
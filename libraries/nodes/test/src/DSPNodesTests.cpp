@@ -15,7 +15,10 @@
 
 #include <common/include/LoadModel.h>
 
+#include <dsp/include/BiquadFilter.h>
 #include <dsp/include/Convolution.h>
+#include <dsp/include/DCT.h>
+#include <dsp/include/IIRFilter.h>
 
 #include <math/include/MathConstants.h>
 #include <math/include/Tensor.h>
@@ -26,19 +29,25 @@
 #include <model/include/Model.h>
 #include <model/include/Node.h>
 
+#include <nodes/include/BiquadFilterNode.h>
+#include <nodes/include/BlockedConvolutionNode.h>
 #include <nodes/include/BufferNode.h>
 #include <nodes/include/ConstantNode.h>
+#include <nodes/include/DCTNode.h>
 #include <nodes/include/DTWDistanceNode.h>
 #include <nodes/include/DelayNode.h>
+#include <nodes/include/DepthwiseConvolutionNode.h>
 #include <nodes/include/DiagonalConvolutionNode.h>
 #include <nodes/include/FFTNode.h>
 #include <nodes/include/FilterBankNode.h>
 #include <nodes/include/GRUNode.h>
+#include <nodes/include/HammingWindowNode.h>
 #include <nodes/include/IIRFilterNode.h>
 #include <nodes/include/LSTMNode.h>
 #include <nodes/include/RNNNode.h>
 #include <nodes/include/ReorderDataNode.h>
 #include <nodes/include/SimpleConvolutionNode.h>
+#include <nodes/include/StreamingSpectrogramNode.h>
 #include <nodes/include/UnrolledConvolutionNode.h>
 #include <nodes/include/WinogradConvolutionNode.h>
 
@@ -87,6 +96,8 @@ std::string GetConvAlgName(dsp::ConvolutionMethodOption alg)
         return "diagonal";
     case dsp::ConvolutionMethodOption::winograd:
         return "winograd";
+    case dsp::ConvolutionMethodOption::fft:
+        return "fft";
     }
     return "";
 }
@@ -100,6 +111,32 @@ model::PortMemoryLayout CalculateMemoryLayout(int numRows, int numColumns, int n
 
     return { size, stride, offset };
 }
+
+// Runs `numSteps` copies of `frame` through a recurrent node as one sequence, and checks that the output holds the hidden
+// states `h_t` after each step. `addNode` adds the node to the model, given its input and sequence length, and returns its output.
+template <typename AddNodeFunction>
+void VerifyRecurrentNodeSequence(const std::string& name, const std::vector<double>& frame, const double* const* h_t, size_t hiddenSize, size_t numSteps, AddNodeFunction addNode)
+{
+    std::vector<double> sequence;
+    std::vector<double> expectedOutput;
+    for (size_t i = 0; i < numSteps; i++)
+    {
+        sequence.insert(sequence.end(), frame.begin(), frame.end());
+        expectedOutput.insert(expectedOutput.end(), h_t[i], h_t[i] + hiddenSize);
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(sequence.size());
+    const auto& output = addNode(model, inputNode->output, numSteps);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", output } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.useBlas = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    VerifyCompiledOutputAndResult<double, double>(map, compiledMap, { sequence }, { expectedOutput }, name + " sequence");
+}
 } // namespace
 
 //
@@ -367,6 +404,62 @@ static void TestIIRFilterNode4()
     }
 }
 
+template <typename ValueType>
+static void TestBiquadFilterNode(size_t numChannels)
+{
+    const ValueType epsilon = static_cast<ValueType>(1e-4);
+    const size_t numFrames = 10;
+
+    // A 4th-order Butterworth lowpass filter (scipy.signal.butter(4, 0.2))
+    std::vector<ValueType> b = { static_cast<ValueType>(0.00482434), static_cast<ValueType>(0.01929737), static_cast<ValueType>(0.02894606), static_cast<ValueType>(0.01929737), static_cast<ValueType>(0.00482434) };
+    std::vector<ValueType> a = { static_cast<ValueType>(-2.36951301), static_cast<ValueType>(2.31398841), static_cast<ValueType>(-1.05466541), static_cast<ValueType>(0.18737949) };
+
+    // The reference: a direct-form filter per channel, over several calls
+    std::vector<std::vector<ValueType>> data;
+    std::vector<std::vector<ValueType>> expected(4, std::vector<ValueType>(numFrames * numChannels));
+    for (size_t index = 0; index < expected.size(); ++index)
+    {
+        std::vector<ValueType> frames(numFrames * numChannels);
+        FillRandomVector(frames);
+        data.push_back(frames);
+    }
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        dsp::IIRFilter<ValueType> filter(b, a);
+        for (size_t index = 0; index < data.size(); ++index)
+        {
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                expected[index][frame * numChannels + channel] = filter.FilterSample(data[index][frame * numChannels + channel]);
+            }
+        }
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(numFrames * numChannels);
+    auto filterNode = model.AddNode<nodes::BiquadFilterNode<ValueType>>(inputNode->output, dsp::GetSecondOrderSections(b, a), numChannels);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", filterNode->output } });
+
+    TestWithSerialization(map, "TestBiquadFilterNode", [&](model::Map& map, int iteration) {
+        model::MapCompilerOptions settings;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+
+        bool computeOk = true;
+        bool compileOk = true;
+        map.Reset();
+        for (size_t index = 0; index < data.size(); ++index)
+        {
+            computeOk &= testing::IsEqual(map.Compute<ValueType>(data[index]), expected[index], epsilon);
+            compiledMap.SetInputValue(0, data[index]);
+            compileOk &= testing::IsEqual(compiledMap.ComputeOutput<ValueType>(0), expected[index], epsilon);
+        }
+        testing::ProcessTest(utilities::FormatString("Testing BiquadFilterNode with %d channels compute iteration %d", static_cast<int>(numChannels), iteration), computeOk);
+        testing::ProcessTest(utilities::FormatString("Testing BiquadFilterNode with %d channels compile iteration %d", static_cast<int>(numChannels), iteration), compileOk);
+    });
+}
+
 template <typename ValueType>
 static void TestMelFilterBankNode()
 {
@@ -450,6 +543,120 @@ static void TestBufferNode()
     });
 }
 
+template <typename ValueType>
+static void TestDCTNode(size_t windowSize, size_t numFilters)
+{
+    const ValueType epsilon = static_cast<ValueType>(std::is_same<ValueType, float>::value ? 1e-3 : 1e-8);
+
+    // The reference: multiply by the DCT matrix
+    auto dctMatrix = dsp::GetDCTMatrix<double>(windowSize, numFilters);
+    std::vector<std::vector<ValueType>> data;
+    std::vector<std::vector<ValueType>> expected;
+    for (int index = 0; index < 4; ++index)
+    {
+        std::vector<ValueType> signal(windowSize);
+        FillRandomVector(signal);
+        std::vector<ValueType> result(numFilters);
+        for (size_t k = 0; k < numFilters; ++k)
+        {
+            double sum = 0;
+            for (size_t n = 0; n < windowSize; ++n)
+            {
+                sum += dctMatrix(k, n) * signal[n];
+            }
+            result[k] = static_cast<ValueType>(sum);
+        }
+        data.push_back(signal);
+        expected.push_back(result);
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(windowSize);
+    auto dctNode = model.AddNode<nodes::DCTNode<ValueType>>(inputNode->output, numFilters);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", dctNode->output } });
+    const auto name = utilities::FormatString("DCTNode of size %d with %d coefficients (%s)", static_cast<int>(windowSize), static_cast<int>(numFilters), dctNode->UsesFastDCT() ? "FFT" : "matrix");
+
+    TestWithSerialization(map, "TestDCTNode", [&](model::Map& map, int iteration) {
+        model::MapCompilerOptions settings;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+
+        bool computeOk = true;
+        bool compileOk = true;
+        for (size_t index = 0; index < data.size(); ++index)
+        {
+            computeOk &= testing::IsEqual(map.Compute<ValueType>(data[index]), expected[index], epsilon);
+            compiledMap.SetInputValue(0, data[index]);
+            compileOk &= testing::IsEqual(compiledMap.ComputeOutput<ValueType>(0), expected[index], epsilon);
+        }
+        testing::ProcessTest(utilities::FormatString("Testing %s compute iteration %d", name.c_str(), iteration), computeOk);
+        testing::ProcessTest(utilities::FormatString("Testing %s compile iteration %d", name.c_str(), iteration), compileOk);
+    });
+}
+
+template <typename ValueType>
+static void TestStreamingSpectrogramNode(bool useDCT)
+{
+    const ValueType epsilon = static_cast<ValueType>(std::is_same<ValueType, float>::value ? 1e-3 : 1e-8);
+    const size_t hopSize = 24;
+    const size_t windowSize = 100;
+    const size_t fftSize = 128;
+    const size_t numFilters = 13;
+    const double sampleRate = 16000;
+    auto filters = dsp::MelFilterBank(fftSize, sampleRate, numFilters);
+    const size_t numDCTCoefficients = useDCT ? filters.NumActiveFilters() : 0;
+
+    // The unfused front end, for reference
+    model::Model referenceModel;
+    auto referenceInputNode = referenceModel.AddNode<model::InputNode<ValueType>>(hopSize);
+    auto bufferNode = referenceModel.AddNode<nodes::BufferNode<ValueType>>(referenceInputNode->output, windowSize);
+    auto windowNode = referenceModel.AddNode<nodes::HammingWindowNode<ValueType>>(bufferNode->output);
+    auto fftNode = referenceModel.AddNode<nodes::FFTNode<ValueType>>(windowNode->output, fftSize);
+    auto melNode = referenceModel.AddNode<nodes::MelFilterBankNode<ValueType>>(fftNode->output, filters);
+    const model::OutputPort<ValueType>* referenceOutput = &melNode->output;
+    if (useDCT)
+    {
+        referenceOutput = &referenceModel.AddNode<nodes::DCTNode<ValueType>>(melNode->output, numDCTCoefficients)->output;
+    }
+    auto referenceMap = model::Map(referenceModel, { { "input", referenceInputNode } }, { { "output", *referenceOutput } });
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(hopSize);
+    auto spectrogramNode = model.AddNode<nodes::StreamingSpectrogramNode<ValueType>>(inputNode->output, windowSize, fftSize, filters, numDCTCoefficients);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", spectrogramNode->output } });
+
+    // Enough hops for the ring buffer to wrap around several times
+    std::vector<std::vector<ValueType>> data;
+    std::vector<std::vector<ValueType>> expected;
+    for (int index = 0; index < 12; ++index)
+    {
+        std::vector<ValueType> hop(hopSize);
+        FillRandomVector(hop);
+        data.push_back(hop);
+        expected.push_back(referenceMap.Compute<ValueType>(hop));
+    }
+
+    TestWithSerialization(map, "TestStreamingSpectrogramNode", [&](model::Map& map, int iteration) {
+        model::MapCompilerOptions settings;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+
+        bool computeOk = true;
+        bool compileOk = true;
+        map.Reset();
+        for (size_t index = 0; index < data.size(); ++index)
+        {
+            computeOk &= testing::IsEqual(map.Compute<ValueType>(data[index]), expected[index], epsilon);
+            compiledMap.SetInputValue(0, data[index]);
+            compileOk &= testing::IsEqual(compiledMap.ComputeOutput<ValueType>(0), expected[index], epsilon);
+        }
+        testing::ProcessTest(utilities::FormatString("Testing StreamingSpectrogramNode compute iteration %d", iteration), computeOk);
+        testing::ProcessTest(utilities::FormatString("Testing StreamingSpectrogramNode compile iteration %d", iteration), compileOk);
+    });
+}
+
 template <typename ValueType>
 static void TestConvolutionNodeCompile(dsp::ConvolutionMethodOption convolutionMethod)
 {
@@ -581,6 +788,10 @@ static void TestConvolutionNodeCompileVsReference(ImageShape inputShape, Filters
     settings.compilerSettings.useBlas = true;
     settings.verifyJittedModule = true;
     model::ModelOptimizerOptions optimizerOptions;
+    if (convolutionMethod == dsp::ConvolutionMethodOption::unrolled)
+    {
+        optimizerOptions["implicitGemmConvolution"] = options.unrolledOptions.implicitGemm;
+    }
     model::IRMapCompiler compiler(settings, optimizerOptions);
 
     // Create "test" model
@@ -681,6 +892,114 @@ static void TestConvolutionNodeCompileVsReference(ImageShape inputShape, Filters
     }
 }
 
+template <typename ValueType>
+static void TestDepthwiseConvolutionNodeCompile(ImageShape inputShape, int filterSize, int stride, bool allowVectorInstructions)
+{
+    using Tensor = math::ChannelColumnRowTensor<ValueType>;
+
+    const int inputRows = inputShape.numRows;
+    const int inputColumns = inputShape.numColumns;
+    const int numChannels = inputShape.numChannels;
+    const int inputPadding = (filterSize - 1) / 2;
+    const int outputRows = inputRows / stride;
+    const int outputColumns = inputColumns / stride;
+    const ValueType epsilon = static_cast<ValueType>(1e-4);
+
+    auto filter = std::vector<ValueType>(numChannels * filterSize * filterSize);
+    FillRandomVector(filter);
+    auto filterWeights = Tensor(numChannels * filterSize, filterSize, 1, filter);
+
+    auto rawData = std::vector<ValueType>(inputRows * inputColumns * numChannels);
+    FillRandomVector(rawData);
+    auto rawDataTensor = Tensor(inputRows, inputColumns, numChannels, rawData);
+    auto paddedDataTensor = Tensor(inputRows + 2 * inputPadding, inputColumns + 2 * inputPadding, numChannels);
+    paddedDataTensor.Fill(0);
+    paddedDataTensor.GetSubTensor(inputPadding, inputPadding, 0, inputRows, inputColumns, numChannels).CopyFrom(rawDataTensor);
+    auto paddedDataArray = paddedDataTensor.ToArray();
+
+    auto inputMemoryLayout = CalculateMemoryLayout(inputRows, inputColumns, numChannels, inputPadding);
+    auto outputMemoryLayout = CalculateMemoryLayout(outputRows, outputColumns, numChannels, 0);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(inputMemoryLayout.GetMemorySize());
+    auto convNode = model.AddNode<nodes::DepthwiseConvolutionNode<ValueType>>(inputNode->output, inputMemoryLayout, outputMemoryLayout, filterWeights, stride);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", convNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = allowVectorInstructions;
+    settings.compilerSettings.vectorWidth = 4;
+    settings.verifyJittedModule = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    auto reference = dsp::Convolve2DDepthwiseSeparable(paddedDataTensor, filterWeights, numChannels, stride).ToArray();
+    map.SetInputValue(0, paddedDataArray);
+    auto computedResult = map.ComputeOutput<ValueType>(0);
+    compiledMap.SetInputValue(0, paddedDataArray);
+    auto compiledResult = compiledMap.ComputeOutput<ValueType>(0);
+
+    auto description = std::to_string(inputRows) + " x " + std::to_string(inputColumns) + " x " + std::to_string(numChannels) + " image and " + std::to_string(filterSize) + " x " + std::to_string(filterSize) + " filters, stride " + std::to_string(stride) + (allowVectorInstructions ? ", vectorized" : "");
+    testing::ProcessTest("Testing depthwise convolution node compute for " + description, testing::IsEqual(reference, computedResult, epsilon));
+    testing::ProcessTest("Testing compiled depthwise convolution node for " + description, testing::IsEqual(reference, compiledResult, epsilon));
+}
+
+template <typename ValueType>
+static void TestBlockedConvolutionNodeCompile(ImageShape inputShape, int numFilters, int filterSize, int stride, int channelBlockSize)
+{
+    using Tensor = math::ChannelColumnRowTensor<ValueType>;
+
+    const int inputRows = inputShape.numRows;
+    const int inputColumns = inputShape.numColumns;
+    const int numChannels = inputShape.numChannels;
+    const int inputPadding = (filterSize - 1) / 2;
+    const int outputRows = inputRows / stride;
+    const int outputColumns = inputColumns / stride;
+    const ValueType epsilon = static_cast<ValueType>(1e-4);
+
+    auto filter = std::vector<ValueType>(numFilters * filterSize * filterSize * numChannels);
+    FillRandomVector(filter);
+    auto filterWeights = Tensor(numFilters * filterSize, filterSize, numChannels, filter);
+
+    auto rawData = std::vector<ValueType>(inputRows * inputColumns * numChannels);
+    FillRandomVector(rawData);
+    auto rawDataTensor = Tensor(inputRows, inputColumns, numChannels, rawData);
+    auto paddedDataTensor = Tensor(inputRows + 2 * inputPadding, inputColumns + 2 * inputPadding, numChannels);
+    paddedDataTensor.Fill(0);
+    paddedDataTensor.GetSubTensor(inputPadding, inputPadding, 0, inputRows, inputColumns, numChannels).CopyFrom(rawDataTensor);
+    auto paddedDataArray = paddedDataTensor.ToArray();
+
+    auto inputMemoryLayout = CalculateMemoryLayout(inputRows, inputColumns, numChannels, inputPadding);
+    auto outputMemoryLayout = CalculateMemoryLayout(outputRows, outputColumns, numFilters, 0);
+    auto blockedInputMemoryLayout = model::GetChannelBlockedLayout(inputMemoryLayout, channelBlockSize);
+    auto blockedOutputMemoryLayout = model::GetChannelBlockedLayout(outputMemoryLayout, channelBlockSize);
+
+    // Block the input channels, convolve, and unblock the output channels
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(inputMemoryLayout.GetMemorySize());
+    auto blockNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(inputNode->output, inputMemoryLayout, blockedInputMemoryLayout);
+    auto convNode = model.AddNode<nodes::BlockedConvolutionNode<ValueType>>(blockNode->output, blockedInputMemoryLayout, blockedOutputMemoryLayout, filterWeights, stride);
+    auto unblockNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(convNode->output, blockedOutputMemoryLayout, outputMemoryLayout);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", unblockNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.vectorWidth = channelBlockSize;
+    settings.verifyJittedModule = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    auto reference = dsp::Convolve2D(paddedDataTensor, filterWeights, numFilters, stride).ToArray();
+    map.SetInputValue(0, paddedDataArray);
+    auto computedResult = map.ComputeOutput<ValueType>(0);
+    compiledMap.SetInputValue(0, paddedDataArray);
+    auto compiledResult = compiledMap.ComputeOutput<ValueType>(0);
+
+    auto description = std::to_string(inputRows) + " x " + std::to_string(inputColumns) + " x " + std::to_string(numChannels) + " image and " + std::to_string(numFilters) + " " + std::to_string(filterSize) + " x " + std::to_string(filterSize) + " filters, stride " + std::to_string(stride) + ", channel blocks of " + std::to_string(channelBlockSize);
+    testing::ProcessTest("Testing blocked convolution node compute for " + description, testing::IsEqual(reference, computedResult, epsilon));
+    testing::ProcessTest("Testing compiled blocked convolution node for " + description, testing::IsEqual(reference, compiledResult, epsilon));
+}
+
 //
 // Recurrent layer nodes (Recurrent, GRU, LSTM)
 //
@@ -839,6 +1158,16 @@ void TestGRUNode()
             VerifyCompiledOutputAndResult<ElementType, ElementType>(map, compiledMap, signal, { expectedOutput.ToArray() }, message);
         }
     });
+
+    // The same 3 steps as one sequence
+    VerifyRecurrentNodeSequence("GRUNode", input.ToArray(), h_t, hiddenSize, 3, [&](model::Model& model, const model::OutputPort<ElementType>& sequence, size_t sequenceLength) -> const model::OutputPort<ElementType>& {
+        auto resetTriggerNode = model.AddNode<nodes::ConstantNode<int>>(0);
+        auto inputWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(inputWeights.ToArray());
+        auto hiddenWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(hiddenWeights.ToArray());
+        auto inputBiasNode = model.AddNode<nodes::ConstantNode<ElementType>>(inputBias.ToArray());
+        auto hiddenBiasNode = model.AddNode<nodes::ConstantNode<ElementType>>(hiddenBias.ToArray());
+        return model.AddNode<nodes::GRUNode<ElementType>>(sequence, resetTriggerNode->output, hiddenSize, inputWeightsNode->output, hiddenWeightsNode->output, inputBiasNode->output, hiddenBiasNode->output, activation, recurrentActivation, sequenceLength)->output;
+    });
 }
 
 void TestLSTMNode()
@@ -916,6 +1245,16 @@ void TestLSTMNode()
             VerifyCompiledOutputAndResult<ElementType, ElementType>(map, compiledMap, signal, { expectedOutput.ToArray() }, message);
         }
     });
+
+    // The same 3 steps as one sequence
+    VerifyRecurrentNodeSequence("LSTMNode", input.ToArray(), h_t, hiddenSize, 3, [&](model::Model& model, const model::OutputPort<ElementType>& sequence, size_t sequenceLength) -> const model::OutputPort<ElementType>& {
+        auto resetTriggerNode = model.AddNode<nodes::ConstantNode<int>>(0);
+        auto inputWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(inputWeights.ToArray());
+        auto hiddenWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(hiddenWeights.ToArray());
+        auto inputBiasNode = model.AddNode<nodes::ConstantNode<ElementType>>(inputBias.ToArray());
+        auto hiddenBiasNode = model.AddNode<nodes::ConstantNode<ElementType>>(hiddenBias.ToArray());
+        return model.AddNode<nodes::LSTMNode<ElementType>>(sequence, resetTriggerNode->output, hiddenSize, inputWeightsNode->output, hiddenWeightsNode->output, inputBiasNode->output, hiddenBiasNode->output, ell::predictors::neural::Activation<ElementType>(new ell::predictors::neural::TanhActivation<ElementType>()), ell::predictors::neural::Activation<ElementType>(new ell::predictors::neural::SigmoidActivation<ElementType>()), sequenceLength)->output;
+    });
 }
 
 //
@@ -945,11 +1284,24 @@ void TestDSPNodes(const std::string& path)
     TestIIRFilterNode3<float>();
     TestIIRFilterNode4<float>();
 
+    TestBiquadFilterNode<float>(1);
+    TestBiquadFilterNode<float>(16);
+    TestBiquadFilterNode<double>(13); // vector blocks and leftover channels
+
     TestMelFilterBankNode<float>();
     TestMelFilterBankNode<double>();
 
     TestBufferNode<float>();
 
+    TestDCTNode<float>(40, 13); // matrix
+    TestDCTNode<float>(128, 13); // matrix
+    TestDCTNode<float>(128, 40); // FFT, truncated
+    TestDCTNode<double>(64, 64); // FFT
+    TestDCTNode<double>(256, 200); // FFT, truncated past the middle of the spectrum
+
+    TestStreamingSpectrogramNode<float>(false);
+    TestStreamingSpectrogramNode<double>(true);
+
     TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::simple);
     // TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::diagonal); // ERROR: diagonal test currently broken
     TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::unrolled);
@@ -995,6 +1347,23 @@ void TestDSPNodes(const std::string& path)
     TestConvolutionNodeCompileVsReference<float>({ 120, 80, 8 }, { 16, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::unrolled);
     TestConvolutionNodeCompileVsReference<float>({ 120, 80, 8 }, { 16, 3, 3, 0 }, 2, dsp::ConvolutionMethodOption::unrolled);
 
+    // Test unrolled convolution with the receptive field matrix materialized
+    TestConvolutionNodeCompileVsReference<float>({ 5, 15, 4 }, { 7, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::unrolled, ConvolutionOptions(false));
+    TestConvolutionNodeCompileVsReference<float>({ 32, 32, 8 }, { 8, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::unrolled, ConvolutionOptions(false));
+    TestConvolutionNodeCompileVsReference<float>({ 120, 80, 8 }, { 16, 3, 3, 0 }, 2, dsp::ConvolutionMethodOption::unrolled, ConvolutionOptions(false));
+
+    // Test depthwise convolution, with and without a partial block of channels
+    TestDepthwiseConvolutionNodeCompile<float>({ 5, 5, 8 }, 3, 1, false);
+    TestDepthwiseConvolutionNodeCompile<float>({ 5, 5, 8 }, 3, 1, true);
+    TestDepthwiseConvolutionNodeCompile<float>({ 8, 6, 6 }, 3, 1, true);
+    TestDepthwiseConvolutionNodeCompile<float>({ 16, 16, 11 }, 3, 2, true);
+    TestDepthwiseConvolutionNodeCompile<double>({ 7, 9, 5 }, 5, 1, true);
+
+    // Test blocked convolution, with and without partial blocks of input and output channels
+    TestBlockedConvolutionNodeCompile<float>({ 5, 5, 8 }, 8, 3, 1, 4);
+    TestBlockedConvolutionNodeCompile<float>({ 8, 6, 3 }, 5, 3, 1, 4);
+    TestBlockedConvolutionNodeCompile<float>({ 16, 16, 11 }, 16, 3, 2, 8);
+    TestBlockedConvolutionNodeCompile<double>({ 7, 9, 6 }, 3, 5, 1, 4);
     // Test Winograd convolution with tile size 2
     TestConvolutionNodeCompileVsReference<float>({ 2, 2, 1 }, { 1, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 2, dsp::WinogradFilterOrder::tilesFirst });
     TestConvolutionNodeCompileVsReference<float>({ 2, 3, 1 }, { 1, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 2, dsp::WinogradFilterOrder::tilesFirst });
@@ -1071,6 +1440,14 @@ void TestDSPNodes(const std::string& path)
     TestConvolutionNodeCompileVsReference<float>({ 64, 64, 8 }, { 8, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 4, dsp::WinogradFilterOrder::filtersFirst });
     TestConvolutionNodeCompileVsReference<float>({ 120, 80, 8 }, { 16, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 4, dsp::WinogradFilterOrder::filtersFirst });
 
+    // Test Winograd convolution with tile size 6 (transform matrices generated at runtime; double to keep the larger transforms' rounding error down)
+    TestConvolutionNodeCompileVsReference<double>({ 3, 3, 1 }, { 1, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 6, dsp::WinogradFilterOrder::tilesFirst });
+    TestConvolutionNodeCompileVsReference<double>({ 5, 15, 4 }, { 7, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 6, dsp::WinogradFilterOrder::tilesFirst });
+    TestConvolutionNodeCompileVsReference<double>({ 32, 32, 8 }, { 8, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 6, dsp::WinogradFilterOrder::tilesFirst });
+    TestConvolutionNodeCompileVsReference<double>({ 3, 3, 1 }, { 1, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 6, dsp::WinogradFilterOrder::filtersFirst });
+    TestConvolutionNodeCompileVsReference<double>({ 5, 15, 4 }, { 7, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 6, dsp::WinogradFilterOrder::filtersFirst });
+    TestConvolutionNodeCompileVsReference<double>({ 32, 32, 8 }, { 8, 3, 3, 0 }, 1, dsp::ConvolutionMethodOption::winograd, { 6, dsp::WinogradFilterOrder::filtersFirst });
+
     //
     // Depthwise-separable convolution tests
     //
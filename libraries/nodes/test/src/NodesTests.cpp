@@ -706,8 +706,11 @@ static void TestProtoNNPredictorNode()
 
     auto protonnPredictorNode = model.AddNode<nodes::ProtoNNPredictorNode>(inputNode->output, protonnPredictor);
 
+    // The node is compilable, so it must be told to refine itself
     model::ModelTransformer transformer;
-    auto refinedModel = RefineModel(model, transformer);
+    model::TransformContext context{ [](const model::Node&) { return model::NodeAction::refine; } };
+    model::RefineTransformation refineTransformation;
+    auto refinedModel = refineTransformation.TransformModel(model, transformer, context);
     auto refinedInputNode = transformer.GetCorrespondingInputNode(inputNode);
     const auto& refinedScoreOutputElements = transformer.GetCorrespondingOutputs(protonnPredictorNode->output);
 
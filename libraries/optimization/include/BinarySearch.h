@@ -23,12 +23,15 @@ namespace optimization
         Interval searchInterval; // the search interval
         bool useSearchIntervalValues = false; // tells the binary search to use precomputed SearchIntervalValues and save two calls to the function
         Interval searchIntervalValues = {}; // the values of the function when applied to the boundary of the search interval
+        size_t numPoints = 1; // the number of points evaluated concurrently on each iteration, or 0 for one per thread of the host thread pool
     };
 
     /// <summary> Given a function, a search interval, and a target interval of function values, binary search attempts to find an argument
     /// in the search interval whose function value is in the target interval. The function does not necessarily have to be monotonic, but the search
     /// interval [a,b] should be such that [f(a), f(b)] overlaps with the target interval. If an argument that satisfies the requirements is found,
-    /// the current search interval shrinks to length zero (its upper and lower bounds become equal). </summary>
+    /// the current search interval shrinks to length zero (its upper and lower bounds become equal). With more than one point per
+    /// iteration, the search evaluates evenly spaced points concurrently and shrinks the interval by a factor of numPoints + 1,
+    /// so the function must be safe to call from several threads at once. </summary>
     template <typename FunctionType>
     class BinarySearch
     {
@@ -39,8 +42,9 @@ namespace optimization
         /// <param name="parameters"> Binary search parameters. </param>
         BinarySearch(FunctionType function, BinarySearchParameters parameters);
 
-        /// <summary> Performs binary search updates until a desired precision is reached or until a max number of function calls is made. </summary>
-        void Update(size_t maxFunctionCalls = 1);
+        /// <summary> Performs binary search updates until a desired precision is reached or until a max number of iterations is made.
+        /// Each iteration makes numPoints function calls. </summary>
+        void Update(size_t maxIterations = 1);
 
         /// <summary> Resets the binary search with new parameters. </summary>
         void Reset(BinarySearchParameters parameters);
@@ -55,10 +59,13 @@ namespace optimization
         bool IsSuccessful() const { return _isSuccessful; }
 
     private:
+        void UpdateConcurrently();
+
         FunctionType _function;
         Interval _targetInterval = {};
         Interval _searchInterval = {};
         Interval _searchIntervalValues = {};
+        size_t _numPoints = 1;
         bool _isSuccessful = false;
     };
 } // namespace optimization
@@ -68,6 +75,8 @@ namespace optimization
 
 #include "Common.h"
 
+#include <vector>
+
 namespace ell
 {
 namespace optimization
@@ -80,28 +89,35 @@ namespace optimization
     }
 
     template <typename FunctionType>
-    void BinarySearch<FunctionType>::Update(size_t maxFunctionCalls)
+    void BinarySearch<FunctionType>::Update(size_t maxIterations)
     {
         if (_isSuccessful)
         {
             return;
         }
 
-        for (size_t i = 0; i < maxFunctionCalls; ++i)
+        for (size_t i = 0; i < maxIterations; ++i)
         {
-            double candidateArgument = _searchInterval.GetCenter();
-            double candidateValue = _function(candidateArgument);
-
-            if (candidateValue <= _targetInterval.End())
+            if (_numPoints > 1)
             {
-                _searchInterval = { candidateArgument, _searchInterval.End() };
-                _searchIntervalValues = { candidateValue, _searchIntervalValues.End() };
+                UpdateConcurrently();
             }
-
-            if (candidateValue >= _targetInterval.Begin())
+            else
             {
-                _searchInterval = { _searchInterval.Begin(), candidateArgument };
-                _searchIntervalValues = { _searchIntervalValues.Begin(), candidateValue };
+                double candidateArgument = _searchInterval.GetCenter();
+                double candidateValue = _function(candidateArgument);
+
+                if (candidateValue <= _targetInterval.End())
+                {
+                    _searchInterval = { candidateArgument, _searchInterval.End() };
+                    _searchIntervalValues = { candidateValue, _searchIntervalValues.End() };
+                }
+
+                if (candidateValue >= _targetInterval.Begin())
+                {
+                    _searchInterval = { _searchInterval.Begin(), candidateArgument };
+                    _searchIntervalValues = { _searchIntervalValues.Begin(), candidateValue };
+                }
             }
 
             if (_searchInterval.Size() == 0)
@@ -112,9 +128,52 @@ namespace optimization
         }
     }
 
+    template <typename FunctionType>
+    void BinarySearch<FunctionType>::UpdateConcurrently()
+    {
+        std::vector<double> candidateArguments(_numPoints);
+        double step = _searchInterval.Size() / (_numPoints + 1);
+        for (size_t j = 0; j < _numPoints; ++j)
+        {
+            candidateArguments[j] = _searchInterval.Begin() + (j + 1) * step;
+        }
+        auto candidateValues = EvaluateConcurrently(_function, candidateArguments);
+
+        for (size_t j = 0; j < _numPoints; ++j)
+        {
+            if (_targetInterval.Contains(candidateValues[j]))
+            {
+                _searchInterval = { candidateArguments[j], candidateArguments[j] };
+                _searchIntervalValues = { candidateValues[j], candidateValues[j] };
+                return;
+            }
+        }
+
+        // like a binary search step at each candidate in turn, keep the subinterval that ends at the first candidate above the target
+        double begin = _searchInterval.Begin();
+        double end = _searchInterval.End();
+        double beginValue = _searchIntervalValues.Begin();
+        double endValue = _searchIntervalValues.End();
+        for (size_t j = 0; j < _numPoints; ++j)
+        {
+            if (candidateValues[j] > _targetInterval.End())
+            {
+                end = candidateArguments[j];
+                endValue = candidateValues[j];
+                break;
+            }
+            begin = candidateArguments[j];
+            beginValue = candidateValues[j];
+        }
+        _searchInterval = { begin, end };
+        _searchIntervalValues = { beginValue, endValue };
+    }
+
     template <typename FunctionType>
     void BinarySearch<FunctionType>::Reset(BinarySearchParameters parameters)
     {
+        _isSuccessful = false;
+        _numPoints = parameters.numPoints == 0 ? utilities::GetHostThreadPool().NumThreads() : parameters.numPoints;
         _targetInterval = parameters.targetInterval;
         _searchInterval = parameters.searchInterval;
 
@@ -7,9 +7,13 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <utilities/include/ThreadPool.h>
+
 #include <exception>
+#include <future>
 #include <string>
 #include <utility>
+#include <vector>
 
 #ifndef NDEBUG
 #define DEBUG_CHECK(goodCondition, message) \
@@ -50,5 +54,52 @@ namespace optimization
         maximize
     };
 
+    /// <summary> Evaluates a univariate function at several arguments concurrently, on the host thread pool. The function
+    /// must be safe to call from several threads at once. </summary>
+    ///
+    /// <param name="function"> A function of the form double(double). </param>
+    /// <param name="arguments"> The arguments. </param>
+    ///
+    /// <returns> The values of the function at the arguments. </returns>
+    template <typename FunctionType>
+    std::vector<double> EvaluateConcurrently(FunctionType& function, const std::vector<double>& arguments)
+    {
+        auto& threadPool = utilities::GetHostThreadPool();
+        std::vector<std::future<double>> futures;
+        for (size_t i = 1; i < arguments.size(); ++i)
+        {
+            futures.push_back(threadPool.AddTask([&function, argument = arguments[i]]() { return static_cast<double>(function(argument)); }));
+        }
+
+        std::vector<double> values(arguments.size());
+        try
+        {
+            // the calling thread evaluates the first argument
+            if (!arguments.empty())
+            {
+                values[0] = function(arguments[0]);
+            }
+        }
+        catch (...)
+        {
+            // the other tasks refer to the function
+            for (auto& future : futures)
+            {
+                threadPool.Wait(future);
+            }
+            throw;
+        }
+
+        for (size_t i = 1; i < arguments.size(); ++i)
+        {
+            threadPool.Wait(futures[i - 1]);
+        }
+        for (size_t i = 1; i < arguments.size(); ++i)
+        {
+            values[i] = futures[i - 1].get();
+        }
+        return values;
+    }
+
 } // namespace optimization
 } // namespace ell
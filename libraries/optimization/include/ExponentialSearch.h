@@ -11,6 +11,8 @@
 #include "Common.h"
 #include "Interval.h"
 
+#include <vector>
+
 namespace ell
 {
 namespace optimization
@@ -21,10 +23,13 @@ namespace optimization
         Interval targetInterval; // the exponential search can return any value in this interval
         double argumentGuess = 0.0; // where to start the search, a good guess of an argument whose value falls in the target interval
         double base = 2.0; // the base of the exponent, setting this to 2 means that the search interval doubles on each iteration
+        size_t numPoints = 1; // the number of points evaluated concurrently on each iteration, or 0 for one per thread of the host thread pool
     };
 
     /// <summary> Given a monotonic function and a target interval of function values, exponential search attempts to find an interval
-    /// of arguments that contains at least one argument whose function value is contained in the target interval. </summary>
+    /// of arguments that contains at least one argument whose function value is contained in the target interval. With more than one
+    /// point per iteration, the search evaluates the next numPoints exponentially growing shifts concurrently and takes the first one that
+    /// succeeds, so it finds the same interval as the one-point search; the function must be safe to call from several threads at once. </summary>
     template <typename FunctionType>
     class ExponentialSearch
     {
@@ -32,8 +37,9 @@ namespace optimization
         /// <summary> Constructor. </summary>
         ExponentialSearch(FunctionType function, ExponentialSearchParameters parameters);
 
-        /// <summary> Performs exponential search updates until an acceptable target interval is found or until a max number of function calls is made. </summary>
-        void Update(size_t maxFunctionCalls = 1);
+        /// <summary> Performs exponential search updates until an acceptable target interval is found or until a max number of iterations is made.
+        /// Each iteration makes numPoints function calls. </summary>
+        void Update(size_t maxIterations = 1);
 
         /// <summary> Resets the exponential search with new parameters. </summary>
         void Reset(ExponentialSearchParameters parameters);
@@ -49,6 +55,7 @@ namespace optimization
 
     private:
         void CheckNewArgumentShift();
+        void CheckCandidate(double candidateArgument, double candidateValue);
 
         FunctionType _function;
         Interval _targetInterval = {};
@@ -60,6 +67,7 @@ namespace optimization
         double _argumentShift = 0;
         double _currentArgument = 0;
         double _currentValue = 0;
+        size_t _numPoints = 1;
         bool _isSuccessful = false;
     };
 } // namespace optimization
@@ -79,12 +87,33 @@ namespace optimization
     }
 
     template <typename FunctionType>
-    void ExponentialSearch<FunctionType>::Update(size_t maxFunctionCalls)
+    void ExponentialSearch<FunctionType>::Update(size_t maxIterations)
     {
-        for (size_t i = 0; i < maxFunctionCalls && !_isSuccessful; ++i)
+        for (size_t i = 0; i < maxIterations && !_isSuccessful; ++i)
         {
-            _argumentShift *= _base;
-            CheckNewArgumentShift();
+            if (_numPoints == 1)
+            {
+                _argumentShift *= _base;
+                CheckNewArgumentShift();
+                continue;
+            }
+
+            std::vector<double> argumentShifts(_numPoints);
+            std::vector<double> candidateArguments(_numPoints);
+            double argumentShift = _argumentShift;
+            for (size_t j = 0; j < _numPoints; ++j)
+            {
+                argumentShift *= _base;
+                argumentShifts[j] = argumentShift;
+                candidateArguments[j] = _initialArgument + argumentShift;
+            }
+            auto candidateValues = EvaluateConcurrently(_function, candidateArguments);
+
+            for (size_t j = 0; j < _numPoints && !_isSuccessful; ++j)
+            {
+                _argumentShift = argumentShifts[j];
+                CheckCandidate(candidateArguments[j], candidateValues[j]);
+            }
         }
     }
 
@@ -92,6 +121,8 @@ namespace optimization
     void ExponentialSearch<FunctionType>::Reset(ExponentialSearchParameters parameters)
     {
         // initialize
+        _isSuccessful = false;
+        _numPoints = parameters.numPoints == 0 ? utilities::GetHostThreadPool().NumThreads() : parameters.numPoints;
         _targetInterval = parameters.targetInterval;
         _currentArgument = _initialArgument = parameters.argumentGuess;
         _base = parameters.base;
@@ -120,7 +151,12 @@ namespace optimization
         // find new candidate
         double candidateArgument = _initialArgument + _argumentShift;
         double candidateValue = _function(candidateArgument);
+        CheckCandidate(candidateArgument, candidateValue);
+    }
 
+    template <typename FunctionType>
+    void ExponentialSearch<FunctionType>::CheckCandidate(double candidateArgument, double candidateValue)
+    {
         // if we're lucky, we found the answer
         if (_targetInterval.Contains(candidateValue))
         {
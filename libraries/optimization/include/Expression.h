@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <math/include/SparseMatrix.h>
 #include <math/include/Vector.h>
 
 #include <type_traits>
@@ -66,6 +67,14 @@ namespace optimization
     template <typename ElementType>
     ScaledColumnVectorExpression<ElementType> operator*(math::ConstColumnVectorReference<ElementType> vectorReference, double scalar);
 
+    /// <summary> Convenient abbreviation of a sparse vector-scalar product expression. </summary>
+    template <typename ElementType>
+    using ScaledSparseColumnVectorExpression = Expression<Operation::product, math::ConstSparseColumnVectorReference<ElementType>, double>;
+
+    /// <summary> Multiplication operator for scalar and sparse column vector. </summary>
+    template <typename ElementType>
+    ScaledSparseColumnVectorExpression<ElementType> operator*(math::ConstSparseColumnVectorReference<ElementType> vectorReference, double scalar);
+
     /// <summary> Convenient abbreviation of a vector-vector outer product expression. </summary>
     template <typename ElementType>
     using OuterProductExpression = Expression<Operation::product, math::ConstColumnVectorReference<ElementType>, math::ConstRowVectorReference<double>>;
@@ -110,6 +119,12 @@ namespace optimization
         return MakeExpression<Operation::product>(vectorReference, scalar);
     }
 
+    template <typename ElementType>
+    ScaledSparseColumnVectorExpression<ElementType> operator*(math::ConstSparseColumnVectorReference<ElementType> vectorReference, double scalar)
+    {
+        return MakeExpression<Operation::product>(vectorReference, scalar);
+    }
+
     template <typename ElementType>
     OuterProductExpression<ElementType> operator*(math::ConstColumnVectorReference<ElementType> columnVectorReference, math::ConstRowVectorReference<double> rowVectorReference)
     {
@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     KSectionSearch.h (optimization)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Common.h"
+#include "Interval.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace optimization
+{
+    struct KSectionSearchParameters
+    {
+        Interval interval; // the search interval
+        double earlyExitIntervalWidth = 0; // stop updating if the interval is smaller than this value
+        Objective objective = Objective::minimize; // are we minimizing or maximizing
+        size_t numPoints = 0; // the number of points evaluated concurrently on each iteration, at least 2, or 0 for one per thread of the host thread pool
+    };
+
+    /// <summary> Implements k-section search, a parallel counterpart of golden section search for a univariate quasiconvex
+    /// function. Each iteration evaluates k evenly spaced points of the search interval concurrently, and shrinks the
+    /// interval to the neighbors of the best point found so far, which is at most 2 / (k + 1) of its size. The function
+    /// must be safe to call from several threads at once. </summary>
+    template <typename FunctionType>
+    class KSectionSearch
+    {
+    public:
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="function"> A quasiconvex function of the form double(double). </param>
+        /// <param name="parameters"> Search parameters. </param>
+        KSectionSearch(FunctionType function, KSectionSearchParameters parameters);
+
+        /// <summary> Performs multiple iterations of the algorithm, each of which makes NumPoints() concurrent function calls. </summary>
+        void Update(size_t maxIterations);
+
+        /// <summary> Resets the k-section search with new parameters. </summary>
+        void Reset(KSectionSearchParameters parameters);
+
+        /// <summary> Returns the current search interval. </summary>
+        Interval GetCurrentInterval() const;
+
+        /// <summary> Returns an approximate optimizer, or the center of the search interval before the first update. </summary>
+        double GetBestArgument() const { return _current; }
+
+        /// <summary> Returns the approximate optimum. </summary>
+        double GetBestValue() const { return _currentValue; }
+
+        /// <summary> Returns the number of points evaluated on each iteration. </summary>
+        size_t NumPoints() const { return _numPoints; }
+
+        /// <summary> Returns true if the search interval is below the early exit interval width. </summary>
+        bool IsSuccessful() const { return _isSuccessful; }
+
+    private:
+        FunctionType _function;
+        double _optimizationDirectionMultiplier = 1.0; // -1.0 for minimization, 1.0 for maximization
+        double _earlyExitIntervalWidth = 0;
+        double _boundary1 = 0;
+        double _boundary2 = 0;
+        double _current = 0;
+        double _currentValue = 0;
+        bool _hasCurrent = false;
+        size_t _numPoints = 2;
+        bool _isSuccessful = false;
+    };
+} // namespace optimization
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace optimization
+{
+    template <typename FunctionType>
+    KSectionSearch<FunctionType>::KSectionSearch(FunctionType function, KSectionSearchParameters parameters) :
+        _function(std::move(function))
+    {
+        Reset(parameters);
+    }
+
+    template <typename FunctionType>
+    void KSectionSearch<FunctionType>::Update(size_t maxIterations)
+    {
+        for (size_t i = 0; i < maxIterations && !_isSuccessful; ++i)
+        {
+            std::vector<double> candidates(_numPoints);
+            double step = (_boundary2 - _boundary1) / (_numPoints + 1);
+            for (size_t j = 0; j < _numPoints; ++j)
+            {
+                candidates[j] = _boundary1 + (j + 1) * step;
+            }
+            auto candidateValues = EvaluateConcurrently(_function, candidates);
+
+            // the evaluated points inside the interval, in order, including the best point of the previous iterations
+            std::vector<std::pair<double, double>> points;
+            for (size_t j = 0; j < _numPoints; ++j)
+            {
+                points.emplace_back(candidates[j], candidateValues[j]);
+            }
+            if (_hasCurrent)
+            {
+                points.emplace_back(_current, _currentValue);
+                std::sort(points.begin(), points.end());
+            }
+
+            size_t best = 0;
+            for (size_t j = 1; j < points.size(); ++j)
+            {
+                if (_optimizationDirectionMultiplier * (points[j].second - points[best].second) > 0)
+                {
+                    best = j;
+                }
+            }
+
+            // a quasiconvex function has its optimum between the neighbors of the best point
+            double boundary1 = best > 0 ? points[best - 1].first : _boundary1;
+            double boundary2 = best + 1 < points.size() ? points[best + 1].first : _boundary2;
+            _boundary1 = boundary1;
+            _boundary2 = boundary2;
+            _current = points[best].first;
+            _currentValue = points[best].second;
+            _hasCurrent = true;
+
+            if (_boundary2 - _boundary1 <= _earlyExitIntervalWidth)
+            {
+                _isSuccessful = true;
+            }
+        }
+    }
+
+    template <typename FunctionType>
+    void KSectionSearch<FunctionType>::Reset(KSectionSearchParameters parameters)
+    {
+        _isSuccessful = false;
+        _hasCurrent = false;
+
+        if (parameters.objective == Objective::minimize)
+        {
+            _optimizationDirectionMultiplier = -1;
+        }
+        else
+        {
+            _optimizationDirectionMultiplier = 1;
+        }
+
+        // a single point does not always shrink the interval
+        _numPoints = parameters.numPoints == 0 ? utilities::GetHostThreadPool().NumThreads() : parameters.numPoints;
+        _numPoints = std::max<size_t>(_numPoints, 2);
+
+        _earlyExitIntervalWidth = parameters.earlyExitIntervalWidth;
+        _boundary1 = parameters.interval.Begin();
+        _boundary2 = parameters.interval.End();
+        _current = parameters.interval.GetCenter();
+        _currentValue = 0;
+
+        if (parameters.interval.Size() <= _earlyExitIntervalWidth)
+        {
+            _currentValue = _function(_current);
+            _hasCurrent = true;
+            _isSuccessful = true;
+        }
+    }
+
+    template <typename FunctionType>
+    Interval KSectionSearch<FunctionType>::GetCurrentInterval() const
+    {
+        return Interval{ _boundary1, _boundary2 };
+    }
+} // namespace optimization
+} // namespace ell
+
+#pragma endregion implementation
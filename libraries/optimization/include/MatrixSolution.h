@@ -48,6 +48,13 @@ namespace optimization
         /// <summary> Returns a vector reference to the matrix. </summary>
         math::ColumnVectorReference<double> GetVector() { return _weights.ReferenceAsVector(); }
 
+        /// <summary> Returns the bias. </summary>
+        template <bool B = isBiased, typename Concept = std::enable_if_t<B>>
+        math::RowVector<double>& GetBias()
+        {
+            return _bias;
+        }
+
         /// <summary> Returns the bias. </summary>
         template <bool B = isBiased, typename Concept = std::enable_if_t<B>>
         const math::RowVector<double>& GetBias() const
@@ -73,6 +80,12 @@ namespace optimization
         /// <summary> Computes input * weights, or input * weights + bias (if a bias exists). </summary>
         math::RowVector<double> Multiply(const InputType& input) const;
 
+        /// <summary> Computes the predictions of a batch of inputs, one per row, into the rows of predictions. </summary>
+        void MultiplyBatch(math::ConstRowMatrixReference<double> inputs, math::RowMatrixReference<double> predictions) const;
+
+        /// <summary> Scales this solution and adds transpose(inputs) * derivatives to it. </summary>
+        void ScaleAddBatchUpdate(double thisScale, math::ConstRowMatrixReference<double> inputs, math::ConstRowMatrixReference<double> derivatives);
+
         /// <summary> Returns the squared 2-norm of a given input. </summary>
         static double GetNorm2SquaredOf(const InputType& input);
 
@@ -272,6 +285,33 @@ namespace optimization
         return result;
     }
 
+    template <typename IOElementType, bool isBiased>
+    void MatrixSolution<IOElementType, isBiased>::MultiplyBatch(math::ConstRowMatrixReference<double> inputs, math::RowMatrixReference<double> predictions) const
+    {
+        math::MultiplyScaleAddUpdate(1.0, inputs, _weights, 0.0, predictions);
+
+        if constexpr (isBiased)
+        {
+            for (size_t i = 0; i < predictions.NumRows(); ++i)
+            {
+                predictions.GetRow(i) += _bias;
+            }
+        }
+    }
+
+    template <typename IOElementType, bool isBiased>
+    void MatrixSolution<IOElementType, isBiased>::ScaleAddBatchUpdate(double thisScale, math::ConstRowMatrixReference<double> inputs, math::ConstRowMatrixReference<double> derivatives)
+    {
+        math::MultiplyScaleAddUpdate(1.0, inputs.Transpose(), derivatives, thisScale, _weights);
+
+        if constexpr (isBiased)
+        {
+            math::RowVector<double> sum(derivatives.NumColumns());
+            math::ColumnwiseSum(derivatives, sum);
+            math::ScaleAddUpdate(1.0, sum, thisScale, _bias);
+        }
+    }
+
     template <typename IOElementType, bool isBiased>
     double MatrixSolution<IOElementType, isBiased>::GetNorm2SquaredOf(const InputType& input)
     {
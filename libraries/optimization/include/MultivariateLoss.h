@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <math/include/Matrix.h>
 #include <math/include/Vector.h>
 
 namespace ell
@@ -44,6 +45,13 @@ namespace optimization
         template <typename OutputElementType>
         math::RowVector<double> Derivative(math::ConstRowVectorReference<double> prediction, math::ConstRowVectorReference<OutputElementType> output) const;
 
+        /// <summary> Computes the loss gradients of a batch of vector predictions, one per row. </summary>
+        ///
+        /// <param name="predictions"> The predicted outputs. </param>
+        /// <param name="outputs"> The true outputs. </param>
+        /// <param name="derivatives"> The loss gradients, with the same size as the predictions. </param>
+        void Derivative(math::ConstRowMatrixReference<double> predictions, math::ConstRowMatrixReference<double> outputs, math::RowMatrixReference<double> derivatives) const;
+
         /// <summary> Returns the value of the loss conjugate at a given vector point. </summary>
         ///
         /// <param name="dual"> The dual variable. </param>
@@ -124,6 +132,18 @@ namespace optimization
         return result;
     }
 
+    template <typename LossType>
+    void MultivariateLoss<LossType>::Derivative(math::ConstRowMatrixReference<double> predictions, math::ConstRowMatrixReference<double> outputs, math::RowMatrixReference<double> derivatives) const
+    {
+        for (size_t i = 0; i < predictions.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < predictions.NumColumns(); ++j)
+            {
+                derivatives(i, j) = _univariateLoss.Derivative(predictions(i, j), outputs(i, j));
+            }
+        }
+    }
+
     template <typename LossType>
     template <typename OutputElementType>
     double MultivariateLoss<LossType>::Conjugate(math::ConstRowVectorReference<double> dual, math::ConstRowVectorReference<OutputElementType> output) const
@@ -13,6 +13,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 namespace ell
 {
@@ -23,6 +24,19 @@ namespace optimization
     {
         double regularizationParameter;
         bool permuteData = true;
+
+        /// <summary>
+        /// The number of consecutive examples that are kept together when the data is permuted. The blocks are visited in a
+        /// random order, and the examples of each block in a random order, so larger blocks read the examples more locally.
+        /// Since the same examples are always visited together, larger blocks can take more epochs to converge.
+        /// </summary>
+        size_t permutationBlockSize = 1;
+
+        /// <summary>
+        /// The number of threads to use. With more than one thread, each epoch splits the examples between the threads, each
+        /// thread updates its own copy of the solution, and the updates are combined at the end of the epoch.
+        /// </summary>
+        size_t numThreads = 1;
     };
 
     /// <summary> Information about the current solution found by SDCA. </summary>
@@ -96,9 +110,20 @@ namespace optimization
         };
         std::vector<ExampleInfo> _exampleInfo;
 
+        // sums over the examples visited in an epoch, to estimate the duality gap without another pass over the data
+        struct EpochSums
+        {
+            double primalLoss = 0; // losses of the predictions made just before each example's update
+            double dualLossChange = 0;
+        };
+
         void OneTimeSetup(std::shared_ptr<const DatasetType> examples, std::string randomSeedString);
         void InitializeDuals();
-        void Step(ExampleType example, ExampleInfo& exampleInfo);
+        void GetPermutation(std::vector<size_t>& permutation);
+        void Epoch(const std::vector<size_t>& permutation, EpochSums& sums);
+        void ParallelEpoch(const std::vector<size_t>& permutation, size_t numThreads, EpochSums& sums);
+        void Step(ExampleType example, ExampleInfo& exampleInfo, SolutionType& v, SolutionType& w, double stepScale, EpochSums& sums);
+        double GetDualLossSum() const;
 
         std::shared_ptr<const DatasetType> _examples;
         LossFunctionType _lossFunction;
@@ -110,11 +135,14 @@ namespace optimization
 
         mutable SDCASolutionInfo _solutionInfo;
         mutable bool _areObjectivesValid = false;
+        mutable double _dualLossSum = 0;
 
         double _t = 0;
         double _lambda = 1.0;
         double _normalizedInverseLambda = 1.0;
         bool _permuteData = true;
+        size_t _permutationBlockSize = 1;
+        size_t _numThreads = 1;
         bool _isInitialized = false;
     };
 
@@ -129,7 +157,10 @@ namespace optimization
 #include "Common.h"
 #include "Expression.h"
 
+#include <utilities/include/ThreadPool.h>
+
 #include <algorithm>
+#include <future>
 #include <memory>
 #include <numeric>
 #include <random>
@@ -159,6 +190,7 @@ namespace optimization
     {
         std::vector<size_t> permutation(_examples->Size());
         std::iota(permutation.begin(), permutation.end(), 0);
+        const auto numThreads = std::min(_numThreads, _examples->Size());
 
         // epochs
         for (size_t e = 0; e < maxEpochs; ++e)
@@ -166,22 +198,33 @@ namespace optimization
             // generate random permutation
             if (_permuteData)
             {
-                std::shuffle(permutation.begin(), permutation.end(), _randomEngine);
+                GetPermutation(permutation);
             }
 
             // process each example
-            for (size_t index : permutation)
+            EpochSums sums;
+            if (numThreads > 1)
+            {
+                ParallelEpoch(permutation, numThreads, sums);
+            }
+            else
             {
-                Step(_examples->Get(index), _exampleInfo[index]);
+                Epoch(permutation, sums);
             }
 
             _areObjectivesValid = false;
+            _dualLossSum += sums.dualLossChange;
             _solutionInfo.numEpochsPerformed++;
 
             // early exit
             if (earlyExitDualityGap > 0)
             {
-                if (GetSolutionInfo().DualityGap() <= earlyExitDualityGap)
+                // The losses of the predictions made during the epoch stand in for the primal losses of the final solution, which
+                // would take another pass over the data. The exact duality gap is only computed when the estimate is small enough.
+                double numExamples = static_cast<double>(_examples->Size());
+                double estimatedPrimalObjective = sums.primalLoss / numExamples + _lambda * _regularizer.Value(_w);
+                double dualObjective = -_dualLossSum / numExamples - _lambda * _regularizer.Conjugate(_v);
+                if (estimatedPrimalObjective - dualObjective <= earlyExitDualityGap && GetSolutionInfo().DualityGap() <= earlyExitDualityGap)
                 {
                     break;
                 }
@@ -208,12 +251,16 @@ namespace optimization
         _lambda = parameters.regularizationParameter;
         _normalizedInverseLambda = 1.0 / (_examples->Size() * parameters.regularizationParameter);
         _permuteData = parameters.permuteData;
+        _permutationBlockSize = std::max<size_t>(parameters.permutationBlockSize, 1);
+        _numThreads = std::max<size_t>(parameters.numThreads, 1);
     }
 
     template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
     void SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::SetLossFunction(LossFunctionType lossFunction)
     {
         _lossFunction = std::move(lossFunction);
+        _areObjectivesValid = false;
+        _dualLossSum = GetDualLossSum();
     }
 
     template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
@@ -243,6 +290,9 @@ namespace optimization
             _solutionInfo.primalObjective = primalSum / _examples->Size() + _lambda * _regularizer.Value(_w);
             _solutionInfo.dualObjective = -dualSum / _examples->Size() - _lambda * _regularizer.Conjugate(_v);
 
+            // resynchronize the running sum, which drifts as it is updated
+            _dualLossSum = dualSum;
+
             _areObjectivesValid = true;
         }
 
@@ -295,31 +345,135 @@ namespace optimization
         {
             _w.InitializeAuxiliaryVariable(_exampleInfo[i].dual);
         }
+        _dualLossSum = GetDualLossSum();
+    }
+
+    template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
+    double SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::GetDualLossSum() const
+    {
+        double dualSum = 0;
+        for (size_t i = 0; i < _examples->Size(); ++i)
+        {
+            dualSum += _lossFunction.Conjugate(_exampleInfo[i].dual, _examples->Get(i).output);
+        }
+        return dualSum;
+    }
+
+    template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
+    void SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::GetPermutation(std::vector<size_t>& permutation)
+    {
+        if (_permutationBlockSize <= 1)
+        {
+            std::shuffle(permutation.begin(), permutation.end(), _randomEngine);
+            return;
+        }
+
+        // shuffle the order of the blocks, and the examples within each block
+        const size_t numExamples = permutation.size();
+        std::vector<size_t> blocks((numExamples + _permutationBlockSize - 1) / _permutationBlockSize);
+        std::iota(blocks.begin(), blocks.end(), 0);
+        std::shuffle(blocks.begin(), blocks.end(), _randomEngine);
+
+        auto it = permutation.begin();
+        for (auto block : blocks)
+        {
+            auto begin = block * _permutationBlockSize;
+            auto end = std::min(begin + _permutationBlockSize, numExamples);
+            std::iota(it, it + (end - begin), begin);
+            std::shuffle(it, it + (end - begin), _randomEngine);
+            it += end - begin;
+        }
     }
 
     template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
-    void SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::Step(ExampleType example, ExampleInfo& exampleInfo)
+    void SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::Epoch(const std::vector<size_t>& permutation, EpochSums& sums)
+    {
+        for (size_t index : permutation)
+        {
+            Step(_examples->Get(index), _exampleInfo[index], _v, _w, 1.0, sums);
+        }
+    }
+
+    // Each thread runs SDCA on its share of the examples, starting from the current solution, and the changes are added up,
+    // as in CoCoA+ (Ma et al., "Adding vs. Averaging in Distributed Primal-Dual Optimization"). The threads don't see each
+    // other's updates during the epoch, so each one takes steps as if the other threads' changes were the same as its own,
+    // which keeps the dual objective from decreasing when the changes are added.
+    template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
+    void SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::ParallelEpoch(const std::vector<size_t>& permutation, size_t numThreads, EpochSums& sums)
+    {
+        const size_t numExamples = permutation.size();
+        const size_t examplesPerThread = (numExamples + numThreads - 1) / numThreads;
+        numThreads = (numExamples + examplesPerThread - 1) / examplesPerThread;
+        const double stepScale = static_cast<double>(numThreads);
+
+        std::vector<SolutionType> threadV(numThreads, _v);
+        std::vector<SolutionType> threadW(numThreads, _w);
+        std::vector<EpochSums> threadSums(numThreads);
+        auto runThread = [&](size_t threadIndex) {
+            auto begin = threadIndex * examplesPerThread;
+            auto end = std::min(begin + examplesPerThread, numExamples);
+            for (auto i = begin; i < end; ++i)
+            {
+                auto index = permutation[i];
+                Step(_examples->Get(index), _exampleInfo[index], threadV[threadIndex], threadW[threadIndex], stepScale, threadSums[threadIndex]);
+            }
+        };
+
+        std::vector<std::future<void>> tasks;
+        for (size_t threadIndex = 1; threadIndex < numThreads; ++threadIndex)
+        {
+            tasks.emplace_back(utilities::GetHostThreadPool().AddTask([&runThread, threadIndex]() { runThread(threadIndex); }));
+        }
+
+        // The calling thread takes the first share
+        runThread(0);
+        for (auto& task : tasks)
+        {
+            utilities::GetHostThreadPool().GetResult(task);
+        }
+
+        // The threads scaled their changes by the number of threads, so the sum of the changes is the average of the solutions
+        const double scale = 1.0 / numThreads;
+        _v = _v * 0.0 + threadV[0] * scale;
+        for (size_t threadIndex = 1; threadIndex < numThreads; ++threadIndex)
+        {
+            _v = _v * 1.0 + threadV[threadIndex] * scale;
+        }
+        _regularizer.ConjugateGradient(_v, _w);
+
+        for (const auto& threadSum : threadSums)
+        {
+            sums.primalLoss += threadSum.primalLoss;
+            sums.dualLossChange += threadSum.dualLossChange;
+        }
+    }
+
+    template <typename SolutionType, typename LossFunctionType, typename RegularizerType>
+    void SDCAOptimizer<SolutionType, LossFunctionType, RegularizerType>::Step(ExampleType example, ExampleInfo& exampleInfo, SolutionType& v, SolutionType& w, double stepScale, EpochSums& sums)
     {
         const double tolerance = 1.0e-8;
 
         auto& dual = exampleInfo.dual;
 
-        auto lipschitz = exampleInfo.norm2Squared * _normalizedInverseLambda;
+        auto prediction = example.input * w;
+        sums.primalLoss += _lossFunction.Value(prediction, example.output);
+
+        auto lipschitz = exampleInfo.norm2Squared * _normalizedInverseLambda * stepScale;
         if (lipschitz < tolerance)
         {
             return;
         }
 
-        auto prediction = example.input * _w;
         prediction /= lipschitz;
         prediction += dual;
 
         auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, prediction, example.output);
+        sums.dualLossChange += _lossFunction.Conjugate(newDual, example.output) - _lossFunction.Conjugate(dual, example.output);
         dual -= newDual;
-        dual *= _normalizedInverseLambda;
+        dual *= _normalizedInverseLambda * stepScale;
 
-        _v += Transpose(example.input) * dual;
-        _regularizer.ConjugateGradient(_v, _w);
+        v += Transpose(example.input) * dual;
+        _regularizer.ConjugateGradient(v, w);
         exampleInfo.dual = newDual;
     }
 
@@ -7,9 +7,13 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <math/include/Matrix.h>
+
 #include <cstddef>
 #include <memory>
 #include <random>
+#include <string>
+#include <vector>
 
 namespace ell
 {
@@ -20,6 +24,12 @@ namespace optimization
     {
         double regularizationParameter;
         std::string randomSeedString = "abc123";
+
+        /// <summary>
+        /// The number of examples in each step. A batch of more than one example is gathered into a matrix and
+        /// processed with matrix-matrix operations, which requires a dense solution.
+        /// </summary>
+        size_t batchSize = 1;
     };
 
     /// <summary> Stochastic gradient descent optimizer. </summary>
@@ -50,6 +60,7 @@ namespace optimization
 
     private:
         void Step(ExampleType example);
+        void BatchStep(const std::vector<size_t>& permutation, size_t firstIndex, size_t size);
 
         std::shared_ptr<const DatasetType> _examples;
         LossFunctionType _lossFunction;
@@ -58,6 +69,14 @@ namespace optimization
         SolutionType _averagedW;
         double _t = 0;
         double _lambda;
+
+        // the buffers of a batch step, with one row per example
+        size_t _batchSize;
+        math::RowMatrix<double> _batchInputs = { 0, 0 };
+        math::RowMatrix<double> _batchOutputs = { 0, 0 };
+        math::RowMatrix<double> _batchPredictions = { 0, 0 };
+        math::RowMatrix<double> _batchDerivatives = { 0, 0 };
+        std::vector<double> _batchWeights;
     };
 
     /// <summary> Convenience function for constructing an SGD optimizer. </summary>
@@ -74,24 +93,48 @@ namespace optimization
 #include <algorithm>
 #include <numeric>
 #include <random>
+#include <type_traits>
 #include <vector>
 
 namespace ell
 {
 namespace optimization
 {
+    namespace detail
+    {
+        // true if a solution can take a step on a batch of examples
+        template <typename SolutionType, typename = void>
+        struct SupportsBatchSteps : std::false_type
+        {};
+
+        template <typename SolutionType>
+        struct SupportsBatchSteps<SolutionType, std::void_t<decltype(&SolutionType::ScaleAddBatchUpdate)>> : std::true_type
+        {};
+    } // namespace detail
+
     /// <summary> </summary>
     template <typename SolutionType, typename LossFunctionType>
     SGDOptimizer<SolutionType, LossFunctionType>::SGDOptimizer(std::shared_ptr<const DatasetType> examples, LossFunctionType lossFunction, SGDOptimizerParameters parameters) :
         _examples(examples),
         _lossFunction(std::move(lossFunction)),
-        _lambda(parameters.regularizationParameter)
+        _lambda(parameters.regularizationParameter),
+        _batchSize(parameters.batchSize)
     {
         if (examples.get() == nullptr || examples->Size() == 0)
         {
             throw OptimizationException("Empty dataset");
         }
 
+        if (_batchSize == 0)
+        {
+            throw OptimizationException("Batch size must be positive");
+        }
+
+        if (_batchSize > 1 && !detail::SupportsBatchSteps<SolutionType>::value)
+        {
+            throw OptimizationException("Batches of more than one example require a dense solution");
+        }
+
         // check that all the outputs are compatible with the loss
         for (size_t i = 0; i < examples->Size(); ++i)
         {
@@ -110,6 +153,25 @@ namespace optimization
         auto example = examples->Get(0);
         _lastW.Resize(example.input, example.output);
         _averagedW.Resize(example.input, example.output);
+
+        if constexpr (detail::SupportsBatchSteps<SolutionType>::value)
+        {
+            if (_batchSize > 1)
+            {
+                auto batchSize = std::min(_batchSize, examples->Size());
+                size_t outputSize = 1;
+                if constexpr (!std::is_arithmetic_v<typename ExampleType::OutputType>)
+                {
+                    outputSize = example.output.Size();
+                }
+
+                _batchInputs = math::RowMatrix<double>(batchSize, example.input.Size());
+                _batchOutputs = math::RowMatrix<double>(batchSize, outputSize);
+                _batchPredictions = math::RowMatrix<double>(batchSize, outputSize);
+                _batchDerivatives = math::RowMatrix<double>(batchSize, outputSize);
+                _batchWeights.resize(batchSize);
+            }
+        }
     }
 
     template <typename SolutionType, typename LossFunctionType>
@@ -124,6 +186,16 @@ namespace optimization
             // generate random permutation
             std::shuffle(permutation.begin(), permutation.end(), _randomEngine);
 
+            // process each batch
+            if (_batchSize > 1)
+            {
+                for (size_t firstIndex = 0; firstIndex < permutation.size(); firstIndex += _batchSize)
+                {
+                    BatchStep(permutation, firstIndex, std::min(_batchSize, permutation.size() - firstIndex));
+                }
+                continue;
+            }
+
             // process each example
             for (size_t index : permutation)
             {
@@ -154,6 +226,62 @@ namespace optimization
         _averagedW = _averagedW * (1.0 - inverseT) + _lastW * inverseT;
     }
 
+    template <typename SolutionType, typename LossFunctionType>
+    void SGDOptimizer<SolutionType, LossFunctionType>::BatchStep(const std::vector<size_t>& permutation, size_t firstIndex, size_t size)
+    {
+        if constexpr (detail::SupportsBatchSteps<SolutionType>::value)
+        {
+            ++_t;
+
+            auto inputs = _batchInputs.GetSubMatrix(0, 0, size, _batchInputs.NumColumns());
+            auto outputs = _batchOutputs.GetSubMatrix(0, 0, size, _batchOutputs.NumColumns());
+            auto predictions = _batchPredictions.GetSubMatrix(0, 0, size, _batchPredictions.NumColumns());
+            auto derivatives = _batchDerivatives.GetSubMatrix(0, 0, size, _batchDerivatives.NumColumns());
+
+            // gather the batch into contiguous rows
+            for (size_t i = 0; i < size; ++i)
+            {
+                auto example = _examples->Get(permutation[firstIndex + i]);
+                inputs.GetRow(i).CopyFrom(example.input);
+                if constexpr (std::is_arithmetic_v<typename ExampleType::OutputType>)
+                {
+                    outputs(i, 0) = example.output;
+                }
+                else
+                {
+                    outputs.GetRow(i).CopyFrom(example.output);
+                }
+                _batchWeights[i] = example.weight;
+            }
+
+            // predict
+            _lastW.MultiplyBatch(inputs, predictions);
+
+            // calculate the loss derivatives
+            if constexpr (std::is_arithmetic_v<typename ExampleType::OutputType>)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    derivatives(i, 0) = _lossFunction.Derivative(predictions(i, 0), outputs(i, 0));
+                }
+            }
+            else
+            {
+                _lossFunction.Derivative(predictions, outputs, derivatives);
+            }
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                derivatives.GetRow(i) *= -_batchWeights[i] / (_lambda * _t * size);
+            }
+
+            // update the solution
+            double inverseT = 1.0 / _t;
+            _lastW.ScaleAddBatchUpdate(1.0 - inverseT, inputs, derivatives);
+            _averagedW = _averagedW * (1.0 - inverseT) + _lastW * inverseT;
+        }
+    }
+
     template <typename SolutionType, typename LossFunctionType>
     SGDOptimizer<SolutionType, LossFunctionType> MakeSGDOptimizer(std::shared_ptr<const typename SolutionType::DatasetType> examples, LossFunctionType lossFunction, SGDOptimizerParameters parameters)
     {
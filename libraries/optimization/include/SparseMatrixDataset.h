@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseMatrixDataset.h (optimization)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "IndexedContainer.h"
+#include "OptimizationExample.h"
+
+#include <math/include/SparseMatrix.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace optimization
+{
+    /// <summary>
+    /// An example set stored as a compressed sparse row matrix of inputs, one row per example, and a vector of
+    /// scalar outputs. The examples refer to the rows of the matrix, so no input is copied, and the whole matrix is
+    /// available for full-batch computations, such as math::MultiplyScaleAddUpdate.
+    /// </summary>
+    template <typename ElementType>
+    class SparseMatrixDataset : public IndexedContainer<Example<math::ConstSparseRowVectorReference<ElementType>, ElementType>>
+    {
+    public:
+        using ExampleType = Example<math::ConstSparseRowVectorReference<ElementType>, ElementType>;
+
+        /// <summary> Constructor. </summary>
+        SparseMatrixDataset(math::CompressedRowMatrix<ElementType> input, std::vector<ElementType> output);
+
+        /// <summary> Constructor with example weights. </summary>
+        SparseMatrixDataset(math::CompressedRowMatrix<ElementType> input, std::vector<ElementType> output, std::vector<double> weights);
+
+        /// <summary> Returns the number of elements in the container </summary>
+        size_t Size() const override { return _input.NumRows(); }
+
+        /// <summary> Gets a reference to the elements that corresponds to a given index. </summary>
+        ExampleType Get(size_t index) const override;
+
+        /// <summary> Returns a reference to the input matrix. </summary>
+        math::ConstSparseMatrixReference<ElementType, math::MatrixLayout::rowMajor> GetInput() const { return _input; }
+
+        /// <summary> Returns the outputs. </summary>
+        const std::vector<ElementType>& GetOutput() const { return _output; }
+
+    private:
+        math::CompressedRowMatrix<ElementType> _input;
+        std::vector<ElementType> _output;
+        std::vector<double> _weights;
+    };
+} // namespace optimization
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+
+namespace ell
+{
+namespace optimization
+{
+    template <typename ElementType>
+    SparseMatrixDataset<ElementType>::SparseMatrixDataset(math::CompressedRowMatrix<ElementType> input, std::vector<ElementType> output) :
+        SparseMatrixDataset(std::move(input), std::move(output), {})
+    {
+    }
+
+    template <typename ElementType>
+    SparseMatrixDataset<ElementType>::SparseMatrixDataset(math::CompressedRowMatrix<ElementType> input, std::vector<ElementType> output, std::vector<double> weights) :
+        _input(std::move(input)),
+        _output(std::move(output)),
+        _weights(std::move(weights))
+    {
+        if (_input.NumRows() != _output.size())
+        {
+            throw OptimizationException("Number of inputs and outputs don't match");
+        }
+
+        if (!_weights.empty() && _weights.size() != _output.size())
+        {
+            throw OptimizationException("Number of weights and outputs don't match");
+        }
+    }
+
+    template <typename ElementType>
+    auto SparseMatrixDataset<ElementType>::Get(size_t index) const -> ExampleType
+    {
+        return ExampleType(_input.GetMajorVector(index), _output[index], _weights.empty() ? 1.0 : _weights[index]);
+    }
+} // namespace optimization
+} // namespace ell
+
+#pragma endregion implementation
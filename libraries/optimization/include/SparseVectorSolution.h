@@ -0,0 +1,277 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseVectorSolution.h (optimization)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Expression.h"
+#include "IndexedContainer.h"
+#include "OptimizationExample.h"
+
+#include <math/include/SparseMatrix.h>
+#include <math/include/Vector.h>
+
+#include <type_traits>
+
+namespace ell
+{
+namespace optimization
+{
+    /// <summary>
+    /// A vector solution that applies to sparse vector inputs and scalar outputs. Predictions and updates only touch
+    /// the weights of the nonzero input elements.
+    /// </summary>
+    template <typename IOElementType, bool isBiased = false>
+    class SparseVectorSolution : public Scalable
+    {
+    public:
+        using InputType = math::ConstSparseRowVectorReference<IOElementType>;
+        using OutputType = IOElementType;
+        using AuxiliaryDoubleType = double;
+        using ExampleType = Example<InputType, OutputType>;
+        using DatasetType = IndexedContainer<ExampleType>;
+
+        /// <summary> Default constructor. </summary>
+        SparseVectorSolution() = default;
+
+        /// <summary> Constructs a solution of a given size. </summary>
+        SparseVectorSolution(size_t size) :
+            _weights(size) {}
+
+        /// <summary> Resize the solution to match the sizes of an input and an output. </summary>
+        void Resize(const InputType& inputExample, OutputType);
+
+        /// <summary> Resets the solution to zero. </summary>
+        void Reset();
+
+        /// <summary> Returns a reference to the vector. </summary>
+        math::ColumnVectorReference<double> GetVector() { return _weights; }
+
+        /// <summary> Returns a const reference to the vector. </summary>
+        math::ConstColumnVectorReference<double> GetVector() const { return _weights; }
+
+        /// <summary> Returns the bias. </summary>
+        template <bool B = isBiased, typename Concept = std::enable_if_t<B>>
+        double& GetBias()
+        {
+            return _bias;
+        }
+
+        /// <summary> Returns the bias. </summary>
+        template <bool B = isBiased, typename Concept = std::enable_if_t<B>>
+        double GetBias() const
+        {
+            return _bias;
+        }
+
+        /// <summary> Assignment operator. </summary>
+        void operator=(const SparseVectorSolution<IOElementType, isBiased>& other);
+
+        /// <summary> Adds another scaled solution to a scaled version of this solution. </summary>
+        void operator=(SumExpression<ScaledExpression<SparseVectorSolution<IOElementType, isBiased>>, ScaledExpression<SparseVectorSolution<IOElementType, isBiased>>> expression);
+
+        /// <summary> Adds a scaled sparse column vector to a scaled version of this solution. </summary>
+        void operator=(SumExpression<ScaledExpression<SparseVectorSolution<IOElementType, isBiased>>, ScaledSparseColumnVectorExpression<IOElementType>> expression);
+
+        /// <summary> Subtracts another solution from this one. </summary>
+        void operator-=(const SparseVectorSolution<IOElementType, isBiased>& other);
+
+        /// <summary> Adds a scaled sparse column vector to this solution. </summary>
+        void operator+=(ScaledSparseColumnVectorExpression<IOElementType> expression);
+
+        /// <summary> Computes input * weights, or input * weights + bias (if a bias exists). </summary>
+        double Multiply(const InputType& input) const;
+
+        /// <summary> Returns the squared 2-norm of a given input. </summary>
+        static double GetNorm2SquaredOf(const InputType& input);
+
+        /// <summary> Initializes an auxiliary double variable. </summary>
+        void InitializeAuxiliaryVariable(AuxiliaryDoubleType& aux) { aux = 0; }
+
+    private:
+        math::ColumnVector<double> _weights;
+
+        struct Nothing
+        {};
+
+        // if the solution is biased, allocate a bias term
+        std::conditional_t<isBiased, double, Nothing> _bias = {};
+    };
+
+    /// <summary> Returns the squared 2-norm of a SparseVectorSolution. </summary>
+    template <typename IOElementType, bool isBiased>
+    double Norm2Squared(const SparseVectorSolution<IOElementType, isBiased>& solution);
+
+    /// <summary> sparse vector-solution product. </summary>
+    template <typename IOElementType, bool isBiased>
+    double operator*(math::ConstSparseRowVectorReference<IOElementType> input, const SparseVectorSolution<IOElementType, isBiased>& solution);
+
+    /// <summary> An unbiased vector solution that applies to sparse vector inputs and scalar outputs. </summary>
+    template <typename IOElementType>
+    using UnbiasedSparseVectorSolution = SparseVectorSolution<IOElementType, false>;
+
+    /// <summary> A biased vector solution that applies to sparse vector inputs and scalar outputs. </summary>
+    template <typename IOElementType>
+    using BiasedSparseVectorSolution = SparseVectorSolution<IOElementType, true>;
+} // namespace optimization
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+
+#include <math/include/SparseMatrixOperations.h>
+#include <math/include/VectorOperations.h>
+
+namespace ell
+{
+namespace optimization
+{
+    template <typename IOElementType, bool isBiased>
+    void SparseVectorSolution<IOElementType, isBiased>::Resize(const InputType& inputExample, OutputType)
+    {
+        _weights.Resize(inputExample.Size());
+    }
+
+    template <typename IOElementType, bool isBiased>
+    void SparseVectorSolution<IOElementType, isBiased>::Reset()
+    {
+        _weights.Reset();
+
+        if constexpr (isBiased)
+        {
+            _bias = 0;
+        }
+    }
+
+    template <typename IOElementType, bool isBiased>
+    void SparseVectorSolution<IOElementType, isBiased>::operator=(const SparseVectorSolution<IOElementType, isBiased>& other)
+    {
+        _weights.CopyFrom(other._weights);
+
+        if constexpr (isBiased)
+        {
+            _bias = other._bias;
+        }
+    }
+
+    template <typename IOElementType, bool isBiased>
+    void SparseVectorSolution<IOElementType, isBiased>::operator=(SumExpression<ScaledExpression<SparseVectorSolution<IOElementType, isBiased>>, ScaledExpression<SparseVectorSolution<IOElementType, isBiased>>> expression)
+    {
+        const auto& thisTerm = expression.lhs;
+        const auto& otherTerm = expression.rhs;
+
+        if (&(thisTerm.lhs.get()) != this)
+        {
+            throw OptimizationException("First term should be a scaled version of this solution");
+        }
+
+        double thisScale = thisTerm.rhs;
+        const auto& otherSolution = otherTerm.lhs.get();
+        double otherScale = otherTerm.rhs;
+        math::ScaleAddUpdate(otherScale, otherSolution.GetVector(), thisScale, _weights);
+
+        if constexpr (isBiased)
+        {
+            _bias = thisScale * _bias + otherScale * otherSolution.GetBias();
+        }
+    }
+
+    template <typename IOElementType, bool isBiased>
+    void SparseVectorSolution<IOElementType, isBiased>::operator=(SumExpression<ScaledExpression<SparseVectorSolution<IOElementType, isBiased>>, ScaledSparseColumnVectorExpression<IOElementType>> expression)
+    {
+        const auto& thisTerm = expression.lhs;
+        const auto& updateTerm = expression.rhs;
+
+        if (&(thisTerm.lhs.get()) != this)
+        {
+            throw OptimizationException("One of the terms should be a scaled version of this solution");
+        }
+
+        double thisScale = thisTerm.rhs;
+        double updateScale = updateTerm.rhs;
+        if (thisScale != 1.0)
+        {
+            math::ScaleUpdate(thisScale, _weights);
+        }
+        math::ScaleAddUpdate(updateScale, updateTerm.lhs, math::One(), _weights);
+
+        if constexpr (isBiased)
+        {
+            _bias = thisScale * _bias + updateScale;
+        }
+    }
+
+    template <typename IOElementType, bool isBiased>
+    void SparseVectorSolution<IOElementType, isBiased>::operator-=(const SparseVectorSolution<IOElementType, isBiased>& other)
+    {
+        _weights -= other._weights;
+        if constexpr (isBiased)
+        {
+            _bias -= other._bias;
+        }
+    }
+
+    template <typename IOElementType, bool isBiased>
+    void SparseVectorSolution<IOElementType, isBiased>::operator+=(ScaledSparseColumnVectorExpression<IOElementType> expression)
+    {
+        double updateScale = expression.rhs;
+        math::ScaleAddUpdate(updateScale, expression.lhs, math::One(), _weights);
+
+        if constexpr (isBiased)
+        {
+            _bias += updateScale;
+        }
+    }
+
+    template <typename IOElementType, bool isBiased>
+    double SparseVectorSolution<IOElementType, isBiased>::Multiply(const InputType& input) const
+    {
+        double result = math::Dot(input, _weights);
+
+        if constexpr (isBiased)
+        {
+            result += _bias;
+        }
+
+        return result;
+    }
+
+    template <typename IOElementType, bool isBiased>
+    double SparseVectorSolution<IOElementType, isBiased>::GetNorm2SquaredOf(const InputType& input)
+    {
+        double result = input.Norm2Squared();
+
+        if constexpr (isBiased)
+        {
+            result += 1.0;
+        }
+
+        return result;
+    }
+
+    template <typename IOElementType, bool isBiased>
+    double Norm2Squared(const SparseVectorSolution<IOElementType, isBiased>& solution)
+    {
+        double result = solution.GetVector().Norm2Squared();
+
+        if constexpr (isBiased)
+        {
+            result += solution.GetBias() * solution.GetBias();
+        }
+
+        return result;
+    }
+
+    template <typename IOElementType, bool isBiased>
+    double operator*(math::ConstSparseRowVectorReference<IOElementType> input, const SparseVectorSolution<IOElementType, isBiased>& solution)
+    {
+        return solution.Multiply(input);
+    }
+} // namespace optimization
+} // namespace ell
+
+#pragma endregion implementation
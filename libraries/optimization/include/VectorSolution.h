@@ -11,6 +11,7 @@
 #include "IndexedContainer.h"
 #include "OptimizationExample.h"
 
+#include <math/include/Matrix.h>
 #include <math/include/Vector.h>
 #include <math/include/VectorOperations.h>
 
@@ -82,6 +83,12 @@ namespace optimization
         /// <summary> Computes input * weights, or input * weights + bias (if a bias exists). </summary>
         double Multiply(const InputType& input) const;
 
+        /// <summary> Computes the predictions of a batch of inputs, one per row, into a single column of predictions. </summary>
+        void MultiplyBatch(math::ConstRowMatrixReference<double> inputs, math::RowMatrixReference<double> predictions) const;
+
+        /// <summary> Scales this solution and adds transpose(inputs) * derivatives to it, where derivatives has a single column. </summary>
+        void ScaleAddBatchUpdate(double thisScale, math::ConstRowMatrixReference<double> inputs, math::ConstRowMatrixReference<double> derivatives);
+
         /// <summary> Returns the squared 2-norm of a given input. </summary>
         static double GetNorm2SquaredOf(const InputType& input);
 
@@ -124,6 +131,7 @@ namespace optimization
 
 #include "Common.h"
 
+#include <math/include/MatrixOperations.h>
 #include <math/include/VectorOperations.h>
 
 namespace ell
@@ -273,6 +281,38 @@ namespace optimization
         return result;
     }
 
+    template <typename IOElementType, bool isBiased>
+    void VectorSolution<IOElementType, isBiased>::MultiplyBatch(math::ConstRowMatrixReference<double> inputs, math::RowMatrixReference<double> predictions) const
+    {
+        auto column = predictions.GetColumn(0);
+        if constexpr (isBiased)
+        {
+            column.Fill(_bias);
+            math::MultiplyScaleAddUpdate(1.0, inputs, _weights, 1.0, column);
+        }
+        else
+        {
+            math::MultiplyScaleAddUpdate(1.0, inputs, _weights, 0.0, column);
+        }
+    }
+
+    template <typename IOElementType, bool isBiased>
+    void VectorSolution<IOElementType, isBiased>::ScaleAddBatchUpdate(double thisScale, math::ConstRowMatrixReference<double> inputs, math::ConstRowMatrixReference<double> derivatives)
+    {
+        auto column = derivatives.GetColumn(0);
+        math::MultiplyScaleAddUpdate(1.0, inputs.Transpose(), column, thisScale, _weights);
+
+        if constexpr (isBiased)
+        {
+            double sum = 0;
+            for (size_t i = 0; i < column.Size(); ++i)
+            {
+                sum += column[i];
+            }
+            _bias = thisScale * _bias + sum;
+        }
+    }
+
     template <typename IOElementType, bool isBiased>
     double VectorSolution<IOElementType, isBiased>::GetNorm2SquaredOf(const InputType& input)
     {
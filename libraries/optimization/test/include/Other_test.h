@@ -16,3 +16,6 @@ void TestLInfinityProx();
 
 /// <summary> Exercises the compilation path for MatrixDataset. </summary>
 void TestMatrixDataset();
+
+/// <summary> Checks that SDCA and SGD on a SparseMatrixDataset find the same solutions as on the equivalent dense dataset. </summary>
+void TestSparseMatrixDataset();
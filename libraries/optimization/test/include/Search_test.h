@@ -10,4 +10,5 @@
 
 void TestExponentialSearch();
 void TestBinarySearch();
-void TestGoldenSectionSearch();
\ No newline at end of file
+void TestGoldenSectionSearch();
+void TestKSectionSearch();
\ No newline at end of file
@@ -13,12 +13,17 @@
 #include <optimization/include/MatrixSolution.h>
 #include <optimization/include/MultivariateLoss.h>
 #include <optimization/include/NormProx.h>
+#include <optimization/include/SDCAOptimizer.h>
 #include <optimization/include/SGDOptimizer.h>
+#include <optimization/include/SparseMatrixDataset.h>
+#include <optimization/include/SparseVectorSolution.h>
 #include <optimization/include/SquareLoss.h>
+#include <optimization/include/VectorSolution.h>
 
 #include <testing/include/testing.h>
 
 #include <math/include/Matrix.h>
+#include <math/include/SparseMatrix.h>
 #include <math/include/Vector.h>
 
 #include <memory>
@@ -131,3 +136,49 @@ void TestMatrixDataset()
     auto optimizer = MakeSGDOptimizer<MatrixSolution<double>>(examples, MultivariateLoss<SquareLoss>{}, { 0.0001 });
     optimizer.Update();
 }
+
+void TestSparseMatrixDataset()
+{
+    size_t numRows = 200;
+    size_t numColumns = 30;
+
+    // generate a random matrix in which most of the entries are zero
+    std::default_random_engine randomEngine;
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::normal_distribution<double> normal;
+
+    math::RowMatrix<double> input(numRows, numColumns);
+    input.Generate([&]() { return uniform(randomEngine) < 0.2 ? normal(randomEngine) : 0.0; });
+    std::vector<double> output(numRows);
+    for (auto& y : output)
+    {
+        y = normal(randomEngine);
+    }
+
+    using DenseExampleType = Example<math::RowVector<double>, double>;
+    using DenseRefExampleType = Example<math::ConstRowVectorReference<double>, double>;
+    auto denseExamples = std::make_shared<VectorIndexedContainer<DenseExampleType, DenseRefExampleType>>();
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        math::RowVector<double> row(numColumns);
+        row.CopyFrom(input.GetRow(i));
+        denseExamples->push_back(DenseExampleType{ std::move(row), output[i] });
+    }
+    auto sparseExamples = std::make_shared<SparseMatrixDataset<double>>(math::CompressedRowMatrix<double>(input), output);
+
+    auto denseSDCA = MakeSDCAOptimizer<VectorSolution<double, true>>(denseExamples, SquareLoss{}, L2Regularizer{}, { 0.01 });
+    auto sparseSDCA = MakeSDCAOptimizer<SparseVectorSolution<double, true>>(sparseExamples, SquareLoss{}, L2Regularizer{}, { 0.01 });
+    denseSDCA.Update(5);
+    sparseSDCA.Update(5);
+
+    auto denseSGD = MakeSGDOptimizer<VectorSolution<double, true>>(denseExamples, SquareLoss{}, { 1.0 });
+    auto sparseSGD = MakeSGDOptimizer<SparseVectorSolution<double, true>>(sparseExamples, SquareLoss{}, { 1.0 });
+    denseSGD.Update(5);
+    sparseSGD.Update(5);
+
+    const double tolerance = 1.0e-8;
+    bool sdcaMatches = denseSDCA.GetSolution().GetVector().IsEqual(sparseSDCA.GetSolution().GetVector(), tolerance) && std::abs(denseSDCA.GetSolution().GetBias() - sparseSDCA.GetSolution().GetBias()) < tolerance;
+    bool sgdMatches = denseSGD.GetSolution().GetVector().IsEqual(sparseSGD.GetSolution().GetVector(), tolerance) && std::abs(denseSGD.GetSolution().GetBias() - sparseSGD.GetSolution().GetBias()) < tolerance;
+
+    testing::ProcessTest("TestSparseMatrixDataset", sdcaMatches && sgdMatches);
+}
@@ -9,6 +9,7 @@
 #include <optimization/include/BinarySearch.h>
 #include <optimization/include/ExponentialSearch.h>
 #include <optimization/include/GoldenSectionSearch.h>
+#include <optimization/include/KSectionSearch.h>
 
 #include <testing/include/testing.h>
 
@@ -30,6 +31,13 @@ void TestExponentialSearch()
     auto solutionValue2 = search2.GetBoundingValues();
 
     testing::ProcessTest("TestExponentialSearch", target1.Intersects(solutionValue1) && target2.Intersects(solutionValue2));
+
+    // evaluating several shifts at once finds the same bounding interval as evaluating them one at a time
+    auto search3 = ExponentialSearch(f, { target1, 0.0, 2.0, 4 });
+    search3.Update(8);
+    auto solutionArgument3 = search3.GetBoundingArguments();
+    auto solutionArgument1 = search1.GetBoundingArguments();
+    testing::ProcessTest("TestExponentialSearch, concurrent", search3.IsSuccessful() && solutionArgument3.Begin() == solutionArgument1.Begin() && solutionArgument3.End() == solutionArgument1.End());
 }
 
 void TestBinarySearch()
@@ -56,6 +64,12 @@ void TestBinarySearch()
                          (searchInterval.Contains(1)) ||
                              (searchInterval.Contains(1 - s7)) ||
                              (searchInterval.Contains(1 + s7)));
+
+    // five points per iteration shrink the interval six times
+    auto search3 = BinarySearch([](double x) { return x * x; }, { valueInterval1, { 0.0, 5.0 }, false, {}, 5 });
+    search3.Update(8);
+    auto resultInterval3 = search3.GetCurrentSearchIntervalValues();
+    testing::ProcessTest("TestBinarySearch, concurrent", valueInterval1.Intersects(resultInterval3));
 }
 
 void TestGoldenSectionSearch()
@@ -67,4 +81,19 @@ void TestGoldenSectionSearch()
     auto search2 = GoldenSectionSearch([](double x) { return -(x - 2) * x; }, { { -2.0, 2.0 }, 0, Objective::maximize });
     search2.Update(20);
     testing::ProcessTest("TestGoldenSectionSearch", std::abs(search2.GetBestArgument() - 1) < 1.0e-4);
-}
\ No newline at end of file
+}
+void TestKSectionSearch()
+{
+    auto search1 = KSectionSearch([](double x) { return (x - 2) * x; }, { { -2.0, 2.0 }, 1.0e-4, Objective::minimize, 4 });
+    search1.Update(20);
+    testing::ProcessTest("TestKSectionSearch", search1.IsSuccessful() && std::abs(search1.GetBestArgument() - 1) < 1.0e-4 && search1.GetCurrentInterval().Contains(1));
+
+    auto search2 = KSectionSearch([](double x) { return -(x - 2) * x; }, { { -2.0, 2.0 }, 0, Objective::maximize, 3 });
+    search2.Update(20);
+    testing::ProcessTest("TestKSectionSearch", std::abs(search2.GetBestArgument() - 1) < 1.0e-4);
+
+    // the optimum at the boundary of the interval
+    auto search3 = KSectionSearch([](double x) { return x; }, { { 0.0, 1.0 }, 1.0e-6 });
+    search3.Update(100);
+    testing::ProcessTest("TestKSectionSearch", search3.IsSuccessful() && search3.GetCurrentInterval().Begin() == 0);
+}
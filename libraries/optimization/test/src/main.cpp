@@ -106,6 +106,12 @@ int main()
     TestSDCARegressionConvergence(SquareLoss{}, MaxRegularizer{ 0 }, { .1, true }, 1.0e-4, 1.0, 1.0, 1.0);
     TestSDCARegressionConvergence(SquareLoss{}, MaxRegularizer{ 1 }, { 1, true }, 1.0e-4, 1.0, 1.0, 1.0);
 
+    // Test convergence of SDCA with block-permuted data and with several threads
+    TestSDCARegressionConvergence(HuberLoss{}, L2Regularizer{}, { .1, true, 16 }, 1.0e-4, 1.0, 1.0, 1.0);
+    TestSDCARegressionConvergence(SquareLoss{}, ElasticNetRegularizer{ .5 }, { .1, true, 16 }, 1.0e-4, 1.0, 1.0, 1.0);
+    TestSDCARegressionConvergence(SquareLoss{}, L2Regularizer{}, { .1, true, 1, 4 }, 1.0e-4, 1.0, 1.0, 1.0);
+    TestSDCARegressionConvergence(HuberLoss{}, ElasticNetRegularizer{ 0 }, { .1, true, 16, 4 }, 1.0e-4, 1.0, 1.0, 1.0);
+
     // Test convergence of SDCA on a synthetic classification problem
 
     TestSDCAClassificationConvergence(HingeLoss{}, L2Regularizer{}, { .1, true }, 1.0e-4, 1.0, 1.0, 3.0);
@@ -165,6 +171,13 @@ int main()
     TestSolutionEquivalenceSGD<double, SquaredHingeLoss, L2Regularizer>(1.0e+3);
     TestSolutionEquivalenceSGD<int, SquaredHingeLoss, L2Regularizer>(1.0e+3);
 
+    // the same tests with mini-batch steps
+    TestSolutionEquivalenceSGD<double, HuberLoss, L2Regularizer>(0.001, 2);
+    TestSolutionEquivalenceSGD<double, SquareLoss, L2Regularizer>(1.0e+3, 2);
+    TestSolutionEquivalenceSGD<double, LogisticLoss, L2Regularizer>(0.0001, 2);
+    TestSolutionEquivalenceSGD<float, LogisticLoss, L2Regularizer>(0.0001, 3);
+    TestSolutionEquivalenceSGD<int, HingeLoss, L2Regularizer>(0.001, 4);
+
     // SDCA solution equivalence tests, confirms that the four solution types behave identically when given equivalent problems
 
     TestSolutionEquivalenceSDCA<double, AbsoluteLoss, L2Regularizer>(0.001);
@@ -200,6 +213,7 @@ int main()
     TestExponentialSearch();
     TestBinarySearch();
     TestGoldenSectionSearch();
+    TestKSectionSearch();
 
     // Other tests
     TestRegularizerEquivalence(1.0e-1);
@@ -209,6 +223,7 @@ int main()
     TestL1Prox();
     TestLInfinityProx();
     TestMatrixDataset();
+    TestSparseMatrixDataset();
 
     return testing::DidTestFail();
 }
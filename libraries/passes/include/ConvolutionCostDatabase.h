@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionCostDatabase.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <predictors/neural/include/ConvolutionalLayer.h>
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <iosfwd>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> The parts of a convolutional layer that affect the running time of a convolution method. </summary>
+    struct ConvolutionLayerDescription
+    {
+        std::string valueType;
+        size_t inputRows = 0; // including padding
+        size_t inputColumns = 0; // including padding
+        size_t inputChannels = 0;
+        size_t inputPadding = 0;
+        size_t outputRows = 0; // including padding
+        size_t outputColumns = 0; // including padding
+        size_t outputChannels = 0;
+        size_t outputPadding = 0;
+        size_t receptiveField = 0;
+        size_t stride = 0;
+    };
+    bool operator==(const ConvolutionLayerDescription& a, const ConvolutionLayerDescription& b);
+
+    /// <summary> Gets the description of a convolutional layer used as a key in a `ConvolutionCostDatabase`. </summary>
+    template <typename ValueType>
+    ConvolutionLayerDescription GetDescription(const predictors::neural::ConvolutionalLayer<ValueType>& layer);
+
+    /// <summary> A single timing measurement of a convolution method on a target device. </summary>
+    struct ConvolutionCostMeasurement : public utilities::IArchivable
+    {
+        std::string deviceName;
+        ConvolutionLayerDescription layer;
+        predictors::neural::ConvolutionMethod method = predictors::neural::ConvolutionMethod::automatic;
+        double time = 0; // milliseconds per evaluation
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "ConvolutionCostMeasurement"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+    };
+
+    /// <summary>
+    /// A persistent database of the measured running times of the different convolution methods, keyed on the
+    /// target device name and the shape of the layer. Used by `SetConvolutionMethodTransformation` to pick the
+    /// fastest method for each layer.
+    /// </summary>
+    class ConvolutionCostDatabase : public utilities::IArchivable
+    {
+    public:
+        using ConvolutionMethod = predictors::neural::ConvolutionMethod;
+
+        /// <summary> Indicates if the database holds a measurement for the given method on the given layer and device. </summary>
+        bool HasCostMeasurement(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod method) const;
+
+        /// <summary> Gets the measured time, in milliseconds, for the given method on the given layer and device. </summary>
+        double GetCostMeasurement(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod method) const;
+
+        /// <summary> Adds (or replaces) the measured time, in milliseconds, for the given method on the given layer and device. </summary>
+        void AddCostMeasurement(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod method, double time);
+
+        /// <summary> Finds the fastest measured method for the given layer and device. </summary>
+        ///
+        /// <param name="deviceName"> The name of the target device. </param>
+        /// <param name="layer"> The description of the layer. </param>
+        /// <param name="method"> Receives the fastest method, if there are any measurements. </param>
+        ///
+        /// <returns> `true` if there were any measurements for the layer and device, else `false`. </returns>
+        bool TryGetFastestMethod(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod& method) const;
+
+        /// <summary> Returns the number of measurements in the database. </summary>
+        size_t NumMeasurements() const { return _measurements.size(); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "ConvolutionCostDatabase"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        using Key = std::tuple<std::string, ConvolutionLayerDescription, int>;
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const;
+        };
+
+        static Key GetKey(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod method);
+
+        std::unordered_map<Key, double, KeyHash> _measurements;
+    };
+
+    /// <summary> Loads a cost database from a JSON file. </summary>
+    ConvolutionCostDatabase LoadConvolutionCostDatabase(const std::string& filename);
+
+    /// <summary> Loads a cost database from a JSON stream. </summary>
+    ConvolutionCostDatabase LoadConvolutionCostDatabase(std::istream& stream);
+
+    /// <summary> Saves a cost database to a JSON file. </summary>
+    void SaveConvolutionCostDatabase(const ConvolutionCostDatabase& database, const std::string& filename);
+
+    /// <summary> Saves a cost database to a JSON stream. </summary>
+    void SaveConvolutionCostDatabase(const ConvolutionCostDatabase& database, std::ostream& stream);
+} // namespace passes
+} // namespace ell
+
+namespace std
+{
+template <>
+struct hash<ell::passes::ConvolutionLayerDescription>
+{
+    size_t operator()(const ell::passes::ConvolutionLayerDescription& arg) const;
+};
+} // namespace std
+
+#pragma region implementation
+
+namespace ell
+{
+namespace passes
+{
+    template <typename ValueType>
+    ConvolutionLayerDescription GetDescription(const predictors::neural::ConvolutionalLayer<ValueType>& layer)
+    {
+        const auto& layerParameters = layer.GetLayerParameters();
+        const auto& convolutionalParameters = layer.GetConvolutionalParameters();
+        auto inputShape = layer.GetInputShape();
+        auto outputShape = layer.GetOutputShape();
+
+        ConvolutionLayerDescription result;
+        result.valueType = utilities::GetTypeName<ValueType>();
+        result.inputRows = inputShape.NumRows();
+        result.inputColumns = inputShape.NumColumns();
+        result.inputChannels = inputShape.NumChannels();
+        result.inputPadding = layerParameters.inputPaddingParameters.paddingSize;
+        result.outputRows = outputShape.NumRows();
+        result.outputColumns = outputShape.NumColumns();
+        result.outputChannels = outputShape.NumChannels();
+        result.outputPadding = layerParameters.outputPaddingParameters.paddingSize;
+        result.receptiveField = convolutionalParameters.receptiveField;
+        result.stride = convolutionalParameters.stride;
+        return result;
+    }
+} // namespace passes
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     EliminateCommonSubexpressionsTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/ModelTransformer.h>
+#include <model/include/Submodel.h>
+#include <model/include/Transformation.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// Merges nodes that compute the same thing: nodes of the same type, with the same parameters, reading the same inputs.
+    /// Nodes are compared by their serialized description, after their inputs have been redirected to the nodes they were
+    /// merged with, so whole duplicated chains (e.g., two copies of the same feature extractor on the same input) collapse
+    /// into one. Only pure nodes (see `Node::IsPure`) are merged. The duplicates are removed when the map is pruned.
+    /// Controlled by the "eliminateCommonSubexpressions" option.
+    /// </summary>
+    class EliminateCommonSubexpressionsTransformation : public ell::model::Transformation
+    {
+    public:
+        ell::model::Submodel Transform(const ell::model::Submodel& submodel, ell::model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        std::string GetRuntimeTypeName() const override
+        {
+            return "EliminateCommonSubexpressionsTransformation";
+        }
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     EliminateRedundantConversionsTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/ModelTransformer.h>
+#include <model/include/Submodel.h>
+#include <model/include/Transformation.h>
+
+#include <memory>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// Removes type casts and data reorderings that cancel out, each of which would otherwise cost a pass over
+    /// memory. A cast that follows an exact cast (e.g., float -> double -> float) is replaced by a single cast from
+    /// the original type, or removed if that type is the output type. A reordering whose output only flows through
+    /// elementwise nodes (unary operations and casts) into another reordering is moved past them and combined with
+    /// the second one, which removes both if they are inverses. Controlled by the "eliminateRedundantConversions" option.
+    /// </summary>
+    class EliminateRedundantConversionsTransformation : public ell::model::Transformation
+    {
+    public:
+        EliminateRedundantConversionsTransformation();
+        EliminateRedundantConversionsTransformation(EliminateRedundantConversionsTransformation&&);
+        ~EliminateRedundantConversionsTransformation();
+
+        ell::model::Submodel Transform(const ell::model::Submodel& submodel, ell::model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        std::string GetRuntimeTypeName() const override
+        {
+            return "EliminateRedundantConversionsTransformation";
+        }
+
+    private:
+        struct State;
+        std::unique_ptr<State> _state;
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FixedPointDSPTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+#include <string>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A transformation that replaces the nodes of a floating point audio front end with the fixed-point nodes in
+    /// `FixedPointDSPNodes.h`, for processors without floating point hardware. `HammingWindowNode`s, `IIRFilterNode`s
+    /// and `FFTNode`s are converted, and so are filter bank nodes and `DCTNode`s whose input comes from a converted node,
+    /// since only then is the range of their input known. Each converted node gets the right output shift to prevent
+    /// overflow, and a signal's scale is tracked through the chain, so `ToFixedPointNode`s are only inserted where the
+    /// chain starts and `FromFixedPointNode`s where a floating point node (such as a log) uses its result.
+    /// </summary>
+    class FixedPointDSPTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="inputRange"> The largest magnitude of the floating point signals fed to the front end. </param>
+        FixedPointDSPTransformation(double inputRange = 1.0);
+
+        /// <summary> Converts the DSP nodes in the submodel to fixed point. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "FixedPointDSPTransformation" }; };
+
+    private:
+        double _inputRange;
+    };
+} // namespace passes
+} // namespace ell
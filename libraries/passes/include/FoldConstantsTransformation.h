@@ -0,0 +1,36 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FoldConstantsTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/ModelTransformer.h>
+#include <model/include/Submodel.h>
+#include <model/include/Transformation.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// Computes the nodes whose inputs are all constant (e.g., reshapes, scalings and type casts of weights) ahead of time,
+    /// replacing them with `ConstantNode`s. Only pure nodes (see `Node::IsPure`) are folded, and only if their outputs are no
+    /// bigger than their inputs, so folding never increases the size of the model's data. The constant nodes left without
+    /// any dependents are removed when the map is pruned. Controlled by the "foldConstants" option.
+    /// </summary>
+    class FoldConstantsTransformation : public ell::model::Transformation
+    {
+    public:
+        ell::model::Submodel Transform(const ell::model::Submodel& submodel, ell::model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        std::string GetRuntimeTypeName() const override
+        {
+            return "FoldConstantsTransformation";
+        }
+    };
+} // namespace passes
+} // namespace ell
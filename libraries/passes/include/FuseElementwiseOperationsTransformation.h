@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseElementwiseOperationsTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/ModelTransformer.h>
+#include <model/include/Submodel.h>
+#include <model/include/Transformation.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// Fuses elementwise operations into the nodes that produce their input, so that the intermediate results are
+    /// never written to memory. Linear function nodes with constant per-channel coefficients (refined bias, scaling
+    /// and batch normalization layers) and activation function nodes are folded into the output operations of the
+    /// matrix product (a refined fully-connected layer, or an unrolled convolution) that computes their input, which
+    /// applies them to each block of its output as it's written. An activation that can't be folded into a product
+    /// is fused into the linear function node that produces its input instead. Controlled by the
+    /// "fuseElementwiseOperations" option.
+    /// </summary>
+    class FuseElementwiseOperationsTransformation : public ell::model::Transformation
+    {
+    public:
+        ell::model::Submodel Transform(const ell::model::Submodel& submodel, ell::model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        std::string GetRuntimeTypeName() const override
+        {
+            return "FuseElementwiseOperationsTransformation";
+        }
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseSoftmaxTopKTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/ModelTransformer.h>
+#include <model/include/Submodel.h>
+#include <model/include/Transformation.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// Replaces a softmax layer node whose only user is a top-k node with a normalized top-k node on the softmax's
+    /// input, so only the `k` largest probabilities are computed and written instead of the whole distribution.
+    /// Controlled by the "fuseSoftmaxTopK" option.
+    /// </summary>
+    class FuseSoftmaxTopKTransformation : public ell::model::Transformation
+    {
+    public:
+        ell::model::Submodel Transform(const ell::model::Submodel& submodel, ell::model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        std::string GetRuntimeTypeName() const override
+        {
+            return "FuseSoftmaxTopKTransformation";
+        }
+    };
+} // namespace passes
+} // namespace ell
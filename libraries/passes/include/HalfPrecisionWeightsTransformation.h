@@ -0,0 +1,44 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     HalfPrecisionWeightsTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+#include <nodes/include/HalfPrecisionMatrixVectorProductNode.h>
+
+#include <string>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A transformation that replaces `FullyConnectedLayerNode`s and `MatrixVectorProductNode`s with
+    /// `HalfPrecisionMatrixVectorProductNode`s, which store their weights as 16-bit floating point values and widen
+    /// them to single precision as they're loaded.
+    /// </summary>
+    class HalfPrecisionWeightsTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="format"> The 16-bit format to store the weights in. </param>
+        HalfPrecisionWeightsTransformation(nodes::HalfPrecisionFormat format = nodes::HalfPrecisionFormat::float16);
+
+        /// <summary> Convert the weights of the layers in the submodel to 16-bit values. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "HalfPrecisionWeightsTransformation" }; };
+
+    private:
+        nodes::HalfPrecisionFormat _format;
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LearnedCostModel.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Model.h>
+#include <model/include/ModelProfileData.h>
+#include <model/include/Node.h>
+
+#include <model/optimizer/include/Cost.h>
+#include <model/optimizer/include/CostModel.h>
+#include <model/optimizer/include/Environment.h>
+
+#include <predictors/include/ForestPredictor.h>
+
+#include <utilities/include/IArchivable.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> The settings for training a `LearnedCostModel`. </summary>
+    struct LearnedCostModelParameters
+    {
+        size_t numRounds = 50;
+        size_t maxSplitsPerRound = 4;
+        double minSplitGain = 0.0;
+    };
+
+    /// <summary>
+    /// A cost model that predicts the running time of each node from its type, the shapes of its first input and
+    /// output, and the target device, with a regression forest trained on profile data (see `LearnedCostModelTrainer`).
+    /// The cost of a submodel is the sum of the predicted times of its nodes, in a single heuristic "runtime" component
+    /// in milliseconds per evaluation, so the global optimizer can compare candidates without compiling and running them.
+    /// Nodes without inputs (input and constant nodes) are free.
+    /// </summary>
+    class LearnedCostModel : public model::optimizer::CostModel
+        , public utilities::IArchivable
+    {
+    public:
+        LearnedCostModel() = default;
+
+        /// <summary> Returns `true` if the model was trained on the target device and on every node type in the submodel. </summary>
+        bool HasCost(const model::Submodel& submodel, const model::optimizer::Environment& environment) const override;
+
+        /// <summary> Returns the predicted runtime of the submodel. </summary>
+        model::optimizer::Cost GetCost(const model::Submodel& submodel, const model::optimizer::Environment& environment) const override;
+
+        /// <summary> Indicates if the model can predict the time of the given node on the given device. </summary>
+        bool CanPredictNodeTime(const model::Node& node, const std::string& deviceName) const;
+
+        /// <summary> Gets the predicted time of the given node on the given device, in milliseconds per evaluation. </summary>
+        double PredictNodeTime(const model::Node& node, const std::string& deviceName) const;
+
+        /// <summary> Gets the node types the model was trained on. </summary>
+        const std::vector<std::string>& GetNodeTypes() const { return _nodeTypes; }
+
+        /// <summary> Gets the devices the model was trained on. </summary>
+        const std::vector<std::string>& GetDeviceNames() const { return _deviceNames; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "LearnedCostModel"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        friend class LearnedCostModelTrainer;
+
+        LearnedCostModel(std::vector<std::string> nodeTypes, std::vector<std::string> deviceNames, predictors::SimpleForestPredictor forest);
+
+        std::vector<std::string> _nodeTypes;
+        std::vector<std::string> _deviceNames;
+        predictors::SimpleForestPredictor _forest;
+    };
+
+    /// <summary> Collects per-node timings from profiled models and trains a `LearnedCostModel` on them. </summary>
+    class LearnedCostModelTrainer
+    {
+    public:
+        /// <summary> Adds the node timings of a profiled model. </summary>
+        ///
+        /// <param name="model"> The model that was compiled with profiling enabled, before refinement. </param>
+        /// <param name="profileData"> The profile data gathered by running it. </param>
+        /// <param name="deviceName"> The name of the device it ran on. </param>
+        void AddProfile(const model::Model& model, const model::ModelProfileData& profileData, const std::string& deviceName);
+
+        /// <summary> Adds a single node timing. </summary>
+        ///
+        /// <param name="node"> The node. </param>
+        /// <param name="deviceName"> The name of the device it ran on. </param>
+        /// <param name="time"> The time of one evaluation of the node, in milliseconds. </param>
+        void AddNodeTime(const model::Node& node, const std::string& deviceName, double time);
+
+        /// <summary> Returns the number of node timings added so far. </summary>
+        size_t NumExamples() const { return _examples.size(); }
+
+        /// <summary> Trains a cost model on the node timings added so far. </summary>
+        LearnedCostModel Train(const LearnedCostModelParameters& parameters = {}) const;
+
+    private:
+        struct NodeExample
+        {
+            std::string nodeType;
+            std::string deviceName;
+            std::vector<double> shapeFeatures;
+            double time;
+        };
+
+        std::vector<NodeExample> _examples;
+    };
+
+    /// <summary> Loads a learned cost model from a JSON file. </summary>
+    LearnedCostModel LoadLearnedCostModel(const std::string& filename);
+
+    /// <summary> Loads a learned cost model from a JSON stream. </summary>
+    LearnedCostModel LoadLearnedCostModel(std::istream& stream);
+
+    /// <summary> Saves a learned cost model to a JSON file. </summary>
+    void SaveLearnedCostModel(const LearnedCostModel& costModel, const std::string& filename);
+
+    /// <summary> Saves a learned cost model to a JSON stream. </summary>
+    void SaveLearnedCostModel(const LearnedCostModel& costModel, std::ostream& stream);
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PruneChannelsTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+#include <data/include/Dataset.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> How the importance of a channel is measured when pruning channels </summary>
+    enum class ChannelPruningCriterion
+    {
+        weights, // the average magnitude of the weights of the filter that computes the channel
+        activations // the average magnitude of the channel's values, measured on a set of representative inputs
+    };
+
+    /// <summary> The channels to keep, for each layer node that loses some of its input or output channels </summary>
+    struct ChannelPruningPlan
+    {
+        std::unordered_map<const model::Node*, std::vector<size_t>> keptInputChannels;
+        std::unordered_map<const model::Node*, std::vector<size_t>> keptOutputChannels;
+    };
+
+    /// <summary> Chooses the channels to remove from the layers of a refined model, as `PruneChannelsTransformation` does. </summary>
+    ///
+    /// <param name="model"> The model. Pruning by activations requires the model to have a single input node. </param>
+    /// <param name="threshold"> The fraction of the importance of a layer's most important channel below which channels are removed. </param>
+    /// <param name="criterion"> How the importance of a channel is measured. </param>
+    /// <param name="calibrationInputs"> The representative inputs the channels are measured on, when pruning by activations. </param>
+    ///
+    /// <returns> The channels to keep. </returns>
+    ChannelPruningPlan GetChannelPruningPlan(const model::Model& model, double threshold, ChannelPruningCriterion criterion, const std::vector<std::vector<double>>& calibrationInputs);
+
+    /// <summary>
+    /// Adds a copy of a layer node without its pruned channels, after adding copies of the layers in front of it that
+    /// lose output channels. This lets other transformations, like fine-tuning, replace the layers that read pruned
+    /// channels themselves, since pruned layers change the size of their output and can't be mapped to the originals.
+    /// </summary>
+    ///
+    /// <param name="node"> The layer node to copy. </param>
+    /// <param name="transformer"> The transformer copying the model. </param>
+    /// <param name="plan"> The channels to keep. </param>
+    ///
+    /// <returns> The output of the new node. </returns>
+    const model::OutputPortBase& AddPrunedLayers(const model::Node& node, model::ModelTransformer& transformer, const ChannelPruningPlan& plan);
+
+    /// <summary>
+    /// A transformation that removes unimportant output channels from `ConvolutionalLayerNode`s, along with the
+    /// matching input channels of the convolutional or fully-connected layer that reads them. The layers in between,
+    /// which must each work on every channel separately (`BatchNormalizationLayerNode`, `BiasLayerNode`,
+    /// `ScalingLayerNode` and `ActivationLayerNode`), lose the same channels. A channel is removed when its importance
+    /// is less than `threshold` times the importance of the most important channel of the same layer. Removing a
+    /// channel drops its contribution to the next layer, so the model should usually be fine-tuned afterwards.
+    /// </summary>
+    class PruneChannelsTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Constructor for pruning by the magnitude of the weights </summary>
+        ///
+        /// <param name="threshold"> The fraction of the importance of a layer's most important channel below which channels are removed. </param>
+        PruneChannelsTransformation(double threshold);
+
+        /// <summary> Constructor for pruning by the measured magnitude of the channels </summary>
+        ///
+        /// <param name="threshold"> The fraction of the importance of a layer's most important channel below which channels are removed. </param>
+        /// <param name="calibrationData"> The representative inputs the channels are measured on. </param>
+        PruneChannelsTransformation(double threshold, const data::AutoSupervisedDataset& calibrationData);
+
+        /// <summary> Constructor for pruning by the measured magnitude of the channels </summary>
+        ///
+        /// <param name="threshold"> The fraction of the importance of a layer's most important channel below which channels are removed. </param>
+        /// <param name="calibrationInputs"> The representative inputs the channels are measured on. </param>
+        PruneChannelsTransformation(double threshold, std::vector<std::vector<double>> calibrationInputs);
+
+        /// <summary> Prune the channels of the layers in the submodel. Pruning by activations requires the model to have a single input node. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "PruneChannelsTransformation" }; };
+
+    private:
+        double _threshold;
+        ChannelPruningCriterion _criterion;
+        std::vector<std::vector<double>> _calibrationInputs;
+    };
+} // namespace passes
+} // namespace ell
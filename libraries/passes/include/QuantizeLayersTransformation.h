@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeLayersTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+#include <data/include/Dataset.h>
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A transformation that replaces `FullyConnectedLayerNode`s and `MatrixVectorProductNode`s with
+    /// `QuantizedMatrixVectorProductNode`s, and `ConvolutionalLayerNode`s (except depthwise-separable ones) with
+    /// `QuantizedConvolutionNode`s. These store their weights as 8-bit integers with a scale per output channel, and
+    /// accumulate in 32-bit integers. The scale used to quantize each node's input is calibrated by running the model
+    /// on a set of representative inputs.
+    /// </summary>
+    class QuantizeLayersTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="calibrationData"> The representative inputs used to calibrate the quantization of the layer inputs. </param>
+        QuantizeLayersTransformation(const data::AutoSupervisedDataset& calibrationData);
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="calibrationInputs"> The representative inputs used to calibrate the quantization of the layer inputs. </param>
+        QuantizeLayersTransformation(std::vector<std::vector<double>> calibrationInputs);
+
+        /// <summary> Quantize the layers in the submodel. The model must have a single input node. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "QuantizeLayersTransformation" }; };
+
+    private:
+        std::vector<std::vector<double>> _calibrationInputs;
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparsifyMatrixVectorProductsTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+#include <string>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A transformation that replaces matrix-vector products whose matrix is constant and mostly zero (e.g., pruned
+    /// `FullyConnectedLayerNode`s) with `SparseMatrixVectorProductNode`s, which store and multiply only the nonzero
+    /// entries. A node is replaced if the fraction of nonzero entries in its matrix is below the "sparseDensityThreshold"
+    /// option (0.25 by default). Controlled by the "sparsifyMatrixVectorProducts" option.
+    /// </summary>
+    class SparsifyMatrixVectorProductsTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Replace the sparse matrix-vector products in the submodel. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "SparsifyMatrixVectorProductsTransformation" }; };
+    };
+} // namespace passes
+} // namespace ell
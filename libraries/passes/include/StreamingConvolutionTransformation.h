@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StreamingConvolutionTransformation.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+#include <string>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A transformation that makes `CausalConvolutionNode`s that read a sliding window from a `BufferNode` compute
+    /// only their newest output frame. Since the window advances one input frame at a time, every other output frame
+    /// was already computed on an earlier step. The transformation replaces
+    ///     BufferNode(window) -> CausalConvolutionNode
+    /// with
+    ///     BufferNode(filterSize frames) -> CausalConvolutionNode -> BufferNode(output frames)
+    /// which produces the same outputs, but convolves `filterSize` frames per step instead of the whole window. A stack of
+    /// convolutions is rewritten layer by layer, since each replacement ends in a `BufferNode` that the next layer reads.
+    /// Controlled by the "streamingConvolution" option.
+    /// </summary>
+    class StreamingConvolutionTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Replace the windowed convolutions in the submodel with streaming ones. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "StreamingConvolutionTransformation" }; };
+    };
+} // namespace passes
+} // namespace ell
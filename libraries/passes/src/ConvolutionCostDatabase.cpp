@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionCostDatabase.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvolutionCostDatabase.h"
+
+#include <utilities/include/Archiver.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/Hash.h>
+#include <utilities/include/JsonArchiver.h>
+
+#include <limits>
+
+namespace ell
+{
+namespace passes
+{
+    bool operator==(const ConvolutionLayerDescription& a, const ConvolutionLayerDescription& b)
+    {
+        return std::tie(a.valueType, a.inputRows, a.inputColumns, a.inputChannels, a.inputPadding, a.outputRows, a.outputColumns, a.outputChannels, a.outputPadding, a.receptiveField, a.stride) ==
+               std::tie(b.valueType, b.inputRows, b.inputColumns, b.inputChannels, b.inputPadding, b.outputRows, b.outputColumns, b.outputChannels, b.outputPadding, b.receptiveField, b.stride);
+    }
+
+    //
+    // ConvolutionCostMeasurement
+    //
+    void ConvolutionCostMeasurement::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        archiver["deviceName"] << deviceName;
+        archiver["valueType"] << layer.valueType;
+        archiver["inputRows"] << layer.inputRows;
+        archiver["inputColumns"] << layer.inputColumns;
+        archiver["inputChannels"] << layer.inputChannels;
+        archiver["inputPadding"] << layer.inputPadding;
+        archiver["outputRows"] << layer.outputRows;
+        archiver["outputColumns"] << layer.outputColumns;
+        archiver["outputChannels"] << layer.outputChannels;
+        archiver["outputPadding"] << layer.outputPadding;
+        archiver["receptiveField"] << layer.receptiveField;
+        archiver["stride"] << layer.stride;
+        archiver["method"] << static_cast<int>(method);
+        archiver["time"] << time;
+    }
+
+    void ConvolutionCostMeasurement::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        archiver["deviceName"] >> deviceName;
+        archiver["valueType"] >> layer.valueType;
+        archiver["inputRows"] >> layer.inputRows;
+        archiver["inputColumns"] >> layer.inputColumns;
+        archiver["inputChannels"] >> layer.inputChannels;
+        archiver["inputPadding"] >> layer.inputPadding;
+        archiver["outputRows"] >> layer.outputRows;
+        archiver["outputColumns"] >> layer.outputColumns;
+        archiver["outputChannels"] >> layer.outputChannels;
+        archiver["outputPadding"] >> layer.outputPadding;
+        archiver["receptiveField"] >> layer.receptiveField;
+        archiver["stride"] >> layer.stride;
+        int methodValue = 0;
+        archiver["method"] >> methodValue;
+        method = static_cast<predictors::neural::ConvolutionMethod>(methodValue);
+        archiver["time"] >> time;
+    }
+
+    //
+    // ConvolutionCostDatabase
+    //
+    bool ConvolutionCostDatabase::HasCostMeasurement(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod method) const
+    {
+        return _measurements.find(GetKey(deviceName, layer, method)) != _measurements.end();
+    }
+
+    double ConvolutionCostDatabase::GetCostMeasurement(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod method) const
+    {
+        auto iter = _measurements.find(GetKey(deviceName, layer, method));
+        if (iter == _measurements.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "ConvolutionCostDatabase: no measurement for this layer and method");
+        }
+        return iter->second;
+    }
+
+    void ConvolutionCostDatabase::AddCostMeasurement(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod method, double time)
+    {
+        _measurements[GetKey(deviceName, layer, method)] = time;
+    }
+
+    bool ConvolutionCostDatabase::TryGetFastestMethod(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod& method) const
+    {
+        bool found = false;
+        double bestTime = std::numeric_limits<double>::max();
+        for (auto candidate : { ConvolutionMethod::unrolled, ConvolutionMethod::simple, ConvolutionMethod::diagonal, ConvolutionMethod::winograd, ConvolutionMethod::depthwise, ConvolutionMethod::blocked })
+        {
+            auto iter = _measurements.find(GetKey(deviceName, layer, candidate));
+            if (iter != _measurements.end() && iter->second < bestTime)
+            {
+                bestTime = iter->second;
+                method = candidate;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    void ConvolutionCostDatabase::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        std::vector<ConvolutionCostMeasurement> measurements;
+        measurements.reserve(_measurements.size());
+        for (const auto& [key, time] : _measurements)
+        {
+            ConvolutionCostMeasurement measurement;
+            measurement.deviceName = std::get<0>(key);
+            measurement.layer = std::get<1>(key);
+            measurement.method = static_cast<ConvolutionMethod>(std::get<2>(key));
+            measurement.time = time;
+            measurements.push_back(measurement);
+        }
+        archiver["measurements"] << measurements;
+    }
+
+    void ConvolutionCostDatabase::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        std::vector<ConvolutionCostMeasurement> measurements;
+        archiver["measurements"] >> measurements;
+        _measurements.clear();
+        for (const auto& measurement : measurements)
+        {
+            AddCostMeasurement(measurement.deviceName, measurement.layer, measurement.method, measurement.time);
+        }
+    }
+
+    ConvolutionCostDatabase::Key ConvolutionCostDatabase::GetKey(const std::string& deviceName, const ConvolutionLayerDescription& layer, ConvolutionMethod method)
+    {
+        return { deviceName, layer, static_cast<int>(method) };
+    }
+
+    size_t ConvolutionCostDatabase::KeyHash::operator()(const Key& key) const
+    {
+        return utilities::HashValue(key);
+    }
+
+    //
+    // Loading and saving
+    //
+    ConvolutionCostDatabase LoadConvolutionCostDatabase(const std::string& filename)
+    {
+        if (!utilities::IsFileReadable(filename))
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound);
+        }
+
+        auto filestream = utilities::OpenIfstream(filename);
+        return LoadConvolutionCostDatabase(filestream);
+    }
+
+    ConvolutionCostDatabase LoadConvolutionCostDatabase(std::istream& stream)
+    {
+        utilities::SerializationContext context;
+        utilities::JsonUnarchiver unarchiver(stream, context);
+        ConvolutionCostDatabase database;
+        unarchiver.Unarchive(database);
+        return database;
+    }
+
+    void SaveConvolutionCostDatabase(const ConvolutionCostDatabase& database, const std::string& filename)
+    {
+        if (!utilities::IsFileWritable(filename))
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable);
+        }
+
+        auto filestream = utilities::OpenOfstream(filename);
+        SaveConvolutionCostDatabase(database, filestream);
+    }
+
+    void SaveConvolutionCostDatabase(const ConvolutionCostDatabase& database, std::ostream& stream)
+    {
+        utilities::JsonArchiver archiver(stream);
+        archiver.Archive(database);
+    }
+} // namespace passes
+} // namespace ell
+
+namespace std
+{
+size_t hash<ell::passes::ConvolutionLayerDescription>::operator()(const ell::passes::ConvolutionLayerDescription& arg) const
+{
+    using ::ell::utilities::HashCombine;
+
+    size_t hash = 0;
+    HashCombine(hash, arg.valueType);
+    HashCombine(hash, arg.inputRows);
+    HashCombine(hash, arg.inputColumns);
+    HashCombine(hash, arg.inputChannels);
+    HashCombine(hash, arg.inputPadding);
+    HashCombine(hash, arg.outputRows);
+    HashCombine(hash, arg.outputColumns);
+    HashCombine(hash, arg.outputChannels);
+    HashCombine(hash, arg.outputPadding);
+    HashCombine(hash, arg.receptiveField);
+    HashCombine(hash, arg.stride);
+    return hash;
+}
+} // namespace std
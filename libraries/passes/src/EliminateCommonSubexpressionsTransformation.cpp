@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     EliminateCommonSubexpressionsTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "EliminateCommonSubexpressionsTransformation.h"
+
+#include <model/include/InputNodeBase.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/OutputNodeBase.h>
+
+#include <utilities/include/JsonArchiver.h>
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ell;
+using namespace ell::model;
+using namespace ell::utilities::logging;
+
+//
+// Implementation
+//
+namespace
+{
+std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+{
+    return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+}
+
+bool CanMergeNode(const Node& node)
+{
+    return node.IsPure() && node.NumOutputPorts() != 0 &&
+           dynamic_cast<const InputNodeBase*>(&node) == nullptr && dynamic_cast<const OutputNodeBase*>(&node) == nullptr;
+}
+
+// Returns a description of everything that determines the node's outputs: its type, its parameters, and the ports it reads.
+// The node's own id is replaced by a placeholder, so identical nodes get identical descriptions.
+std::string GetNodeDescription(const Node& node)
+{
+    std::stringstream stream;
+    {
+        utilities::JsonArchiver archiver(stream);
+        archiver.Archive(node);
+    }
+
+    auto description = stream.str();
+    auto id = "\"" + node.GetId().ToString() + "\"";
+    for (auto pos = description.find(id); pos != std::string::npos; pos = description.find(id, pos))
+    {
+        description.replace(pos, id.size(), "\"\"");
+    }
+    return description;
+}
+} // namespace
+
+namespace ell
+{
+namespace passes
+{
+    Submodel EliminateCommonSubexpressionsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto compiler = context.GetCompiler();
+
+        // The nodes already in the new model, by description
+        std::unordered_map<std::string, const Node*> uniqueNodes;
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        auto result = transformer.TransformSubmodelOnto(submodel, onto, context, [compiler, &uniqueNodes](const Node& node, ModelTransformer& transformer) {
+            transformer.CopyNode(node);
+
+            bool canMergeNode = compiler == nullptr || compiler->GetModelOptimizerOptions(node).GetEntry<bool>("eliminateCommonSubexpressions", true);
+            if (!canMergeNode || !CanMergeNode(node))
+            {
+                return;
+            }
+
+            // The copy reads from the nodes its inputs' duplicates were merged into, so a duplicate of an earlier node
+            // has the same description as the earlier node's copy
+            auto newNode = transformer.GetCorrespondingOutputs(*node.GetOutputPort(0)).GetNode();
+            std::string description;
+            try
+            {
+                description = GetNodeDescription(*newNode);
+            }
+            catch (const std::exception& exception)
+            {
+                Log() << "Not merging node " << node.GetRuntimeTypeName() << " [id = " << node.GetId().ToString() << "], because it couldn't be serialized: " << exception.what() << EOL;
+                return;
+            }
+
+            auto it = uniqueNodes.find(description);
+            if (it == uniqueNodes.end())
+            {
+                uniqueNodes.emplace(std::move(description), newNode);
+                return;
+            }
+
+            // Redirect the node's outputs to the equivalent node; the copy is left unused, and is pruned later
+            Log() << "Merging node " << node.GetRuntimeTypeName() << " [id = " << node.GetId().ToString() << "] with node [id = " << it->second->GetId().ToString() << "]" << EOL;
+            const auto& existingOutputs = it->second->GetOutputPorts();
+            const auto& outputs = node.GetOutputPorts();
+            for (size_t index = 0; index < outputs.size(); ++index)
+            {
+                transformer.MapNodeOutput(*outputs[index], *existingOutputs[index]);
+            }
+        });
+
+        return result;
+    }
+} // namespace passes
+} // namespace ell
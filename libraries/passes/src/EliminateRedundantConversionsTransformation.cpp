@@ -0,0 +1,303 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     EliminateRedundantConversionsTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "EliminateRedundantConversionsTransformation.h"
+
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/ReorderDataNode.h>
+#include <nodes/include/TypeCastNode.h>
+#include <nodes/include/UnaryOperationNode.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+
+using namespace model;
+using namespace nodes;
+using namespace utilities;
+using namespace utilities::logging;
+
+namespace passes
+{
+    namespace
+    {
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        // Calls `f` with a value of each port type until it returns `true`
+        template <typename Function>
+        bool AnyPortType(Function&& f)
+        {
+            return f(bool{}) || f(int{}) || f(int64_t{}) || f(float{}) || f(double{});
+        }
+
+        // Returns `true` if every value of `InputType` survives a cast to `OutputType` unchanged, so a cast from
+        // `OutputType` afterwards is the same as casting from the original value
+        template <typename InputType, typename OutputType>
+        constexpr bool IsExactCast()
+        {
+            return std::is_same<InputType, OutputType>::value ||
+                   std::is_same<InputType, bool>::value ||
+                   (std::is_same<InputType, int>::value && (std::is_same<OutputType, int64_t>::value || std::is_same<OutputType, double>::value)) ||
+                   (std::is_same<InputType, float>::value && std::is_same<OutputType, double>::value);
+        }
+
+        bool IsTypeCastNode(const Node& node)
+        {
+            return AnyPortType([&node](auto inputValue) {
+                return AnyPortType([&node, inputValue](auto outputValue) {
+                    return dynamic_cast<const TypeCastNode<decltype(inputValue), decltype(outputValue)>*>(&node) != nullptr;
+                });
+            });
+        }
+
+        bool IsUnaryOperationNode(const Node& node)
+        {
+            return dynamic_cast<const UnaryOperationNode<bool>*>(&node) != nullptr ||
+                   dynamic_cast<const UnaryOperationNode<int>*>(&node) != nullptr ||
+                   dynamic_cast<const UnaryOperationNode<float>*>(&node) != nullptr ||
+                   dynamic_cast<const UnaryOperationNode<double>*>(&node) != nullptr;
+        }
+
+        // Elementwise nodes with a single input compute the same values whatever order the input is in
+        bool IsLayoutAgnosticNode(const Node& node)
+        {
+            return IsUnaryOperationNode(node) || IsTypeCastNode(node);
+        }
+
+        const Node* GetReorderDataNode(const Node& node)
+        {
+            if (dynamic_cast<const ReorderDataNode<float>*>(&node) != nullptr || dynamic_cast<const ReorderDataNode<double>*>(&node) != nullptr)
+            {
+                return &node;
+            }
+            return nullptr;
+        }
+
+        template <typename ValueType>
+        bool TryGetLayouts(const Node& node, PortMemoryLayout& inputLayout, PortMemoryLayout& outputLayout)
+        {
+            auto reorderNode = dynamic_cast<const ReorderDataNode<ValueType>*>(&node);
+            if (reorderNode == nullptr)
+            {
+                return false;
+            }
+            inputLayout = reorderNode->GetInputMemoryLayout();
+            outputLayout = reorderNode->GetOutputMemoryLayout();
+            return true;
+        }
+
+        void GetReorderLayouts(const Node& node, PortMemoryLayout& inputLayout, PortMemoryLayout& outputLayout)
+        {
+            TryGetLayouts<float>(node, inputLayout, outputLayout) || TryGetLayouts<double>(node, inputLayout, outputLayout);
+        }
+
+        // Returns the only node that uses the (only) output of `node`, or `nullptr`
+        const Node* GetOnlyDependentNode(const Node& node)
+        {
+            if (node.NumOutputPorts() != 1 || node.GetOutputPort(0)->GetReferences().size() != 1)
+            {
+                return nullptr;
+            }
+            return node.GetOutputPort(0)->GetReferences()[0]->GetNode();
+        }
+    } // namespace
+
+    struct EliminateRedundantConversionsTransformation::State
+    {
+        // If the output of an elementwise chain that starts with the reordering `node` ends in another reordering,
+        // records which layout the chain's data will be in once the first reordering is removed
+        bool TryMoveReorderPastElementwiseNodes(const Node& node)
+        {
+            PortMemoryLayout inputLayout;
+            PortMemoryLayout outputLayout;
+            GetReorderLayouts(node, inputLayout, outputLayout);
+
+            // Without the reordering, the elementwise nodes have to produce outputs of the same size
+            if (node.GetInputPort(0)->Size() != node.GetOutputPort(0)->Size() || inputLayout.GetMemorySize() != outputLayout.GetMemorySize())
+            {
+                return false;
+            }
+
+            auto current = GetOnlyDependentNode(node);
+            while (current != nullptr && IsLayoutAgnosticNode(*current))
+            {
+                current = GetOnlyDependentNode(*current);
+            }
+            if (current == nullptr || GetReorderDataNode(*current) == nullptr)
+            {
+                return false;
+            }
+
+            PortMemoryLayout finalInputLayout;
+            PortMemoryLayout finalOutputLayout;
+            GetReorderLayouts(*current, finalInputLayout, finalOutputLayout);
+            if (finalInputLayout != outputLayout)
+            {
+                return false;
+            }
+
+            Log() << "Moving ReorderDataNode [id = " << node.GetId().ToString() << "] past elementwise nodes to ReorderDataNode [id = " << current->GetId().ToString() << "]" << EOL;
+            movedReorderLayouts[current] = inputLayout;
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryOptimizeReorderNode(const Node& node, ModelTransformer& transformer)
+        {
+            auto reorderNode = dynamic_cast<const ReorderDataNode<ValueType>*>(&node);
+            if (reorderNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& newInput = transformer.GetCorrespondingInputs(reorderNode->input);
+            auto movedLayout = movedReorderLayouts.find(&node);
+            if (movedLayout == movedReorderLayouts.end())
+            {
+                if (TryMoveReorderPastElementwiseNodes(node))
+                {
+                    // The elementwise nodes are copied onto the input, in its original order
+                    transformer.MapNodeOutput(reorderNode->output, newInput);
+                }
+                else
+                {
+                    transformer.CopyNode(node);
+                }
+                return true;
+            }
+
+            // This reordering ends a chain whose first reordering was removed
+            const auto& inputLayout = movedLayout->second;
+            auto outputLayout = reorderNode->GetOutputMemoryLayout();
+            if (inputLayout == outputLayout)
+            {
+                Log() << "Removing ReorderDataNode [id = " << node.GetId().ToString() << "] since it undoes an earlier reordering" << EOL;
+                transformer.MapNodeOutput(reorderNode->output, newInput);
+            }
+            else
+            {
+                auto newNode = transformer.AddNode<ReorderDataNode<ValueType>>(newInput, inputLayout, outputLayout, reorderNode->GetPaddingValue());
+                transformer.MapNodeOutput(reorderNode->output, newNode->output);
+            }
+            return true;
+        }
+
+        std::unordered_map<const Node*, PortMemoryLayout> movedReorderLayouts;
+    };
+
+    namespace
+    {
+        // Replaces `castNode` with a cast from the input of a preceding exact cast, if there is one
+        template <typename InputType, typename MiddleType, typename OutputType>
+        bool TryCombineCasts(const TypeCastNode<MiddleType, OutputType>& castNode, ModelTransformer& transformer)
+        {
+            auto inputCastNode = dynamic_cast<const TypeCastNode<InputType, MiddleType>*>(castNode.input.GetReferencedPort().GetNode());
+            if (inputCastNode == nullptr || !IsExactCast<InputType, MiddleType>() || castNode.input.Size() != inputCastNode->output.Size())
+            {
+                return false;
+            }
+
+            const auto& newInput = transformer.GetCorrespondingInputs(inputCastNode->input);
+            if constexpr (std::is_same<InputType, OutputType>::value)
+            {
+                Log() << "Removing TypeCastNode [id = " << castNode.GetId().ToString() << "] since it undoes an exact cast" << EOL;
+                transformer.MapNodeOutput(castNode.output, newInput);
+            }
+            else
+            {
+                auto newNode = transformer.AddNode<TypeCastNode<InputType, OutputType>>(newInput);
+                transformer.MapNodeOutput(castNode.output, newNode->output);
+            }
+            return true;
+        }
+
+        template <typename MiddleType, typename OutputType>
+        bool TryOptimizeTypeCastNode(const Node& node, ModelTransformer& transformer)
+        {
+            auto castNode = dynamic_cast<const TypeCastNode<MiddleType, OutputType>*>(&node);
+            if (castNode == nullptr)
+            {
+                return false;
+            }
+
+            if constexpr (std::is_same<MiddleType, OutputType>::value)
+            {
+                transformer.MapNodeOutput(castNode->output, transformer.GetCorrespondingInputs(castNode->input));
+                return true;
+            }
+
+            if (!AnyPortType([&](auto inputValue) { return TryCombineCasts<decltype(inputValue)>(*castNode, transformer); }))
+            {
+                transformer.CopyNode(node);
+            }
+            return true;
+        }
+
+        bool TryOptimizeTypeCastNode(const Node& node, ModelTransformer& transformer)
+        {
+            return AnyPortType([&](auto inputValue) {
+                return AnyPortType([&](auto outputValue) {
+                    return TryOptimizeTypeCastNode<decltype(inputValue), decltype(outputValue)>(node, transformer);
+                });
+            });
+        }
+    } // namespace
+
+    EliminateRedundantConversionsTransformation::EliminateRedundantConversionsTransformation() :
+        _state(new EliminateRedundantConversionsTransformation::State)
+    {
+    }
+
+    EliminateRedundantConversionsTransformation::EliminateRedundantConversionsTransformation(EliminateRedundantConversionsTransformation&&) = default;
+
+    EliminateRedundantConversionsTransformation::~EliminateRedundantConversionsTransformation() = default;
+
+    Submodel EliminateRedundantConversionsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        _state->movedReorderLayouts.clear();
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        auto result = transformer.TransformSubmodelOnto(submodel, onto, context, [this, context](const Node& node, ModelTransformer& transformer) {
+            const model::MapCompiler* compiler = context.GetCompiler();
+            bool canOptimizeNode = true;
+            if (compiler)
+            {
+                canOptimizeNode = compiler->GetModelOptimizerOptions(node).GetEntry<bool>("eliminateRedundantConversions", true);
+            }
+
+            // A reordering recorded as the end of a chain has to be replaced even if this node can't be optimized
+            if (canOptimizeNode || _state->movedReorderLayouts.count(&node) != 0)
+            {
+                if (_state->TryOptimizeReorderNode<float>(node, transformer) || _state->TryOptimizeReorderNode<double>(node, transformer))
+                {
+                    return;
+                }
+            }
+            if (canOptimizeNode && TryOptimizeTypeCastNode(node, transformer))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        });
+
+        _state->movedReorderLayouts.clear();
+        return result;
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FixedPointDSPTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FixedPointDSPTransformation.h"
+
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/DCTNode.h>
+#include <nodes/include/FFTNode.h>
+#include <nodes/include/FilterBankNode.h>
+#include <nodes/include/FixedPointDSPNodes.h>
+#include <nodes/include/HammingWindowNode.h>
+#include <nodes/include/IIRFilterNode.h>
+
+#include <dsp/include/FixedPoint.h>
+#include <dsp/include/WindowFunctions.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        // A Q15 signal in the transformed model, representing the value `q * scale / 2^15`
+        struct FixedPointSignal
+        {
+            const OutputPort<int>* port;
+            double scale;
+        };
+
+        // The fixed-point signals, keyed by the output port of the original model that they compute
+        using FixedPointSignals = std::map<const OutputPortBase*, FixedPointSignal>;
+
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        bool HasFixedPointInput(const InputPortBase& input, const FixedPointSignals& signals)
+        {
+            return signals.find(&input.GetReferencedPort()) != signals.end();
+        }
+
+        // Gets the fixed-point version of an input, converting it if it comes from a floating point node
+        template <typename ValueType>
+        FixedPointSignal GetFixedPointInput(const InputPort<ValueType>& input, ModelTransformer& transformer, FixedPointSignals& signals, double inputRange)
+        {
+            const auto& referencedPort = input.GetReferencedPort();
+            auto it = signals.find(&referencedPort);
+            if (it != signals.end())
+            {
+                return it->second;
+            }
+
+            const auto& newInput = transformer.GetCorrespondingInputs(input);
+            auto newNode = transformer.AddNode<nodes::ToFixedPointNode<ValueType>>(newInput, inputRange);
+            FixedPointSignal signal{ &newNode->output, inputRange };
+            signals[&referencedPort] = signal;
+            return signal;
+        }
+
+        // Records the fixed-point signal that replaces a node's output, and converts it back for any floating point nodes that use it
+        template <typename ValueType>
+        void MapFixedPointOutput(const OutputPort<ValueType>& output, const FixedPointSignal& signal, ModelTransformer& transformer, FixedPointSignals& signals)
+        {
+            signals[&output] = signal;
+            auto newNode = transformer.AddNode<nodes::FromFixedPointNode<ValueType>>(*signal.port, signal.scale);
+            transformer.MapNodeOutput(output, newNode->output);
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryConvertNode(const Node& node, ModelTransformer& transformer, FixedPointSignals& signals, double inputRange)
+        {
+            if (auto windowNode = dynamic_cast<const nodes::HammingWindowNode<ValueType>*>(&node))
+            {
+                auto input = GetFixedPointInput(windowNode->input, transformer, signals, inputRange);
+                auto hammingWindow = dsp::HammingWindow<double>(windowNode->input.Size());
+                auto window = utilities::TransformVector(hammingWindow.begin(), hammingWindow.end(), [](double w) { return static_cast<int>(dsp::ToQ15(w)); });
+                auto newNode = transformer.AddNode<nodes::FixedPointWindowNode>(*input.port, window);
+                MapFixedPointOutput(windowNode->output, { &newNode->output, input.scale }, transformer, signals);
+            }
+            else if (auto iirNode = dynamic_cast<const nodes::IIRFilterNode<ValueType>*>(&node))
+            {
+                auto input = GetFixedPointInput(iirNode->input, transformer, signals, inputRange);
+                auto feedforwardCoefficients = iirNode->GetFeedforwardCoefficients();
+                auto recursiveCoefficients = iirNode->GetRecursiveCoefficients();
+                std::vector<double> b(feedforwardCoefficients.begin(), feedforwardCoefficients.end());
+                std::vector<double> a(recursiveCoefficients.begin(), recursiveCoefficients.end());
+                auto shift = dsp::GetHeadroomShift(nodes::FixedPointIIRFilterNode::GetMaxGain(b, a));
+                auto newNode = transformer.AddNode<nodes::FixedPointIIRFilterNode>(*input.port, b, a, shift);
+                MapFixedPointOutput(iirNode->output, { &newNode->output, std::ldexp(input.scale, shift) }, transformer, signals);
+            }
+            else if (auto fftNode = dynamic_cast<const nodes::FFTNode<ValueType>*>(&node))
+            {
+                auto fftSize = fftNode->GetFFTSize();
+                if (fftNode->input.Size() > fftSize)
+                {
+                    return false;
+                }
+
+                // The fixed-point FFT divides its result by the FFT size
+                auto input = GetFixedPointInput(fftNode->input, transformer, signals, inputRange);
+                auto newNode = transformer.AddNode<nodes::FixedPointFFTNode>(*input.port, fftSize);
+                MapFixedPointOutput(fftNode->output, { &newNode->output, input.scale * fftSize }, transformer, signals);
+            }
+            else if (auto filterBankNode = dynamic_cast<const nodes::FilterBankNode<ValueType>*>(&node))
+            {
+                if (!HasFixedPointInput(filterBankNode->input, signals))
+                {
+                    return false;
+                }
+
+                auto input = GetFixedPointInput(filterBankNode->input, transformer, signals, inputRange);
+                const auto& filters = filterBankNode->GetFilters();
+                auto shift = dsp::GetHeadroomShift(nodes::FixedPointFilterBankNode::GetMaxGain(filters));
+                auto newNode = transformer.AddNode<nodes::FixedPointFilterBankNode>(*input.port, filters, shift);
+                MapFixedPointOutput(filterBankNode->output, { &newNode->output, std::ldexp(input.scale, shift) }, transformer, signals);
+            }
+            else if (auto dctNode = dynamic_cast<const nodes::DCTNode<ValueType>*>(&node))
+            {
+                if (!HasFixedPointInput(dctNode->input, signals))
+                {
+                    return false;
+                }
+
+                auto input = GetFixedPointInput(dctNode->input, transformer, signals, inputRange);
+                auto shift = dsp::GetHeadroomShift(nodes::FixedPointDCTNode::GetMaxGain(dctNode->input.Size()));
+                auto newNode = transformer.AddNode<nodes::FixedPointDCTNode>(*input.port, dctNode->GetNumFilters(), shift);
+                MapFixedPointOutput(dctNode->output, { &newNode->output, std::ldexp(input.scale, shift) }, transformer, signals);
+            }
+            else
+            {
+                return false;
+            }
+
+            Log() << "Converting node " << node.GetId() << " (" << node.GetRuntimeTypeName() << ") to fixed point" << EOL;
+            return true;
+        }
+
+        void ConvertNode(const Node& node, ModelTransformer& transformer, FixedPointSignals& signals, double inputRange)
+        {
+            if (TryConvertNode<float>(node, transformer, signals, inputRange))
+            {
+                return;
+            }
+            if (TryConvertNode<double>(node, transformer, signals, inputRange))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    //
+    // FixedPointDSPTransformation methods
+    //
+    FixedPointDSPTransformation::FixedPointDSPTransformation(double inputRange) :
+        _inputRange(inputRange)
+    {
+    }
+
+    Submodel FixedPointDSPTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(submodel.GetInputs()));
+        model::Model destModel = submodel.GetModel().ShallowCopy();
+        auto inputRange = _inputRange;
+        FixedPointSignals signals;
+        return transformer.TransformSubmodelOnto(submodel, destModel, onto, context, [&signals, inputRange](const Node& node, ModelTransformer& transformer) {
+            ConvertNode(node, transformer, signals, inputRange);
+        });
+    }
+} // namespace passes
+} // namespace ell
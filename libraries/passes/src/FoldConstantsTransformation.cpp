@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FoldConstantsTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FoldConstantsTransformation.h"
+
+#include <model/include/InputNodeBase.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/OutputNodeBase.h>
+
+#include <nodes/include/ConstantNode.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+using namespace ell;
+using namespace ell::model;
+using namespace ell::utilities::logging;
+
+//
+// Implementation
+//
+namespace
+{
+std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+{
+    return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+}
+
+bool IsConstantNode(const Node& node)
+{
+    return dynamic_cast<const nodes::ConstantNode<bool>*>(&node) != nullptr ||
+           dynamic_cast<const nodes::ConstantNode<int>*>(&node) != nullptr ||
+           dynamic_cast<const nodes::ConstantNode<int64_t>*>(&node) != nullptr ||
+           dynamic_cast<const nodes::ConstantNode<float>*>(&node) != nullptr ||
+           dynamic_cast<const nodes::ConstantNode<double>*>(&node) != nullptr;
+}
+
+template <typename ValueType>
+const OutputPortBase& AddConstantNode(const OutputPortBase& port, ModelTransformer& transformer)
+{
+    auto newNode = transformer.AddNode<nodes::ConstantNode<ValueType>>(port.GetOutput<ValueType>(), port.GetMemoryLayout());
+    return newNode->output;
+}
+
+const OutputPortBase& AddConstantNode(const OutputPortBase& port, ModelTransformer& transformer)
+{
+    switch (port.GetType())
+    {
+    case Port::PortType::boolean:
+        return AddConstantNode<bool>(port, transformer);
+    case Port::PortType::integer:
+        return AddConstantNode<int>(port, transformer);
+    case Port::PortType::bigInt:
+        return AddConstantNode<int64_t>(port, transformer);
+    case Port::PortType::smallReal:
+        return AddConstantNode<float>(port, transformer);
+    case Port::PortType::real:
+        return AddConstantNode<double>(port, transformer);
+    default:
+        throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Unexpected port type when folding constants");
+    }
+}
+
+bool CanFoldNode(const Node& node, const std::unordered_set<const Node*>& constantNodes)
+{
+    if (!node.IsPure() || node.NumInputPorts() == 0 || node.NumOutputPorts() == 0 ||
+        dynamic_cast<const InputNodeBase*>(&node) != nullptr || dynamic_cast<const OutputNodeBase*>(&node) != nullptr)
+    {
+        return false;
+    }
+
+    auto parents = node.GetParentNodes();
+    if (!std::all_of(parents.begin(), parents.end(), [&](const Node* parent) { return constantNodes.count(parent) != 0; }))
+    {
+        return false;
+    }
+
+    // Don't replace a cheap computation (like a broadcast) with a bigger constant
+    size_t inputSize = 0;
+    for (auto input : node.GetInputPorts())
+    {
+        inputSize += input->Size();
+    }
+    size_t outputSize = 0;
+    for (auto output : node.GetOutputPorts())
+    {
+        outputSize += output->Size();
+    }
+    return outputSize <= inputSize;
+}
+
+// Computes a node whose inputs are all constant, and maps its outputs to new constant nodes
+bool TryFoldNode(const Node& node, const std::unordered_set<const Node*>& constantNodes, ModelTransformer& transformer)
+{
+    if (!CanFoldNode(node, constantNodes))
+    {
+        return false;
+    }
+
+    try
+    {
+        node.Compute();
+    }
+    catch (const std::exception& exception)
+    {
+        Log() << "Not folding node " << node.GetRuntimeTypeName() << " [id = " << node.GetId().ToString() << "], because computing it failed: " << exception.what() << EOL;
+        return false;
+    }
+
+    Log() << "Folding node " << node.GetRuntimeTypeName() << " [id = " << node.GetId().ToString() << "] into a constant" << EOL;
+    for (auto output : node.GetOutputPorts())
+    {
+        transformer.MapNodeOutput(*output, AddConstantNode(*output, transformer));
+    }
+    return true;
+}
+} // namespace
+
+namespace ell
+{
+namespace passes
+{
+    Submodel FoldConstantsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto compiler = context.GetCompiler();
+
+        // The nodes of the source submodel whose outputs have been computed, because they're constant
+        std::unordered_set<const Node*> constantNodes;
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        auto result = transformer.TransformSubmodelOnto(submodel, onto, context, [compiler, &constantNodes](const Node& node, ModelTransformer& transformer) {
+            bool canFoldNode = compiler == nullptr || compiler->GetModelOptimizerOptions(node).GetEntry<bool>("foldConstants", true);
+            if (canFoldNode)
+            {
+                if (IsConstantNode(node))
+                {
+                    node.Compute();
+                    constantNodes.insert(&node);
+                }
+                else if (TryFoldNode(node, constantNodes, transformer))
+                {
+                    constantNodes.insert(&node);
+                    return;
+                }
+            }
+
+            transformer.CopyNode(node);
+        });
+
+        return result;
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,389 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseElementwiseOperationsTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FuseElementwiseOperationsTransformation.h"
+
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/ActivationFunctions.h>
+#include <nodes/include/BroadcastFunctionNode.h>
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/FusedLinearActivation.h>
+#include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
+#include <nodes/include/ReorderDataNode.h>
+
+#include <predictors/neural/include/HardSigmoidActivation.h>
+#include <predictors/neural/include/LeakyReLUActivation.h>
+#include <predictors/neural/include/ReLUActivation.h>
+#include <predictors/neural/include/SigmoidActivation.h>
+#include <predictors/neural/include/TanhActivation.h>
+
+#include <utilities/include/StlVectorUtil.h>
+
+#include <optional>
+#include <vector>
+
+using namespace ell;
+using namespace ell::model;
+
+//
+// Implementation
+//
+namespace
+{
+std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+{
+    return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+}
+
+template <typename ValueType>
+const nodes::ConstantNode<ValueType>* GetConstantInputNode(const model::InputPort<ValueType>& input)
+{
+    if (input.Size() == 0)
+    {
+        return nullptr;
+    }
+    return dynamic_cast<const nodes::ConstantNode<ValueType>*>(input.GetReferencedPort().GetNode());
+}
+
+// Returns `true` if the linear function's coefficients are constant, and at least one of them is present
+template <typename ValueType>
+bool HasConstantCoefficients(const nodes::BroadcastLinearFunctionNode<ValueType>& node)
+{
+    auto scaleSize = node.secondaryInput1.Size();
+    auto biasSize = node.secondaryInput2.Size();
+    if (scaleSize == 0 && biasSize == 0)
+    {
+        return false;
+    }
+    if (scaleSize > 0 && biasSize > 0 && scaleSize != biasSize)
+    {
+        return false;
+    }
+
+    return (scaleSize == 0 || GetConstantInputNode(node.secondaryInput1) != nullptr) &&
+           (biasSize == 0 || GetConstantInputNode(node.secondaryInput2) != nullptr);
+}
+
+// Returns the full scale and bias vectors of a linear function with constant coefficients. Missing coefficients
+// are filled in explicitly, because the combined function has no way to tell a missing scale from a missing bias.
+template <typename ValueType>
+std::pair<std::vector<ValueType>, std::vector<ValueType>> GetLinearCoefficients(const nodes::BroadcastLinearFunctionNode<ValueType>& node)
+{
+    auto scaleNode = GetConstantInputNode(node.secondaryInput1);
+    auto biasNode = GetConstantInputNode(node.secondaryInput2);
+    auto size = scaleNode != nullptr ? scaleNode->GetValues().size() : biasNode->GetValues().size();
+
+    auto scale = scaleNode != nullptr ? scaleNode->GetValues() : std::vector<ValueType>(size, static_cast<ValueType>(1));
+    auto bias = biasNode != nullptr ? biasNode->GetValues() : std::vector<ValueType>(size, static_cast<ValueType>(0));
+    return { scale, bias };
+}
+
+//
+// Fusing elementwise operations into the matrix product that produces their input
+//
+
+// Returns the port of the old model that an elementwise operation reads, looking through reorders that don't change
+// the layout, or `nullptr` if anything else reads it. The product has to be computed without the operation otherwise.
+template <typename ValueType>
+const model::OutputPort<ValueType>* GetExclusiveProducerPort(const model::InputPort<ValueType>& input)
+{
+    const auto* port = &input.GetReferencedPort();
+    if (input.Size() != port->Size())
+    {
+        return nullptr;
+    }
+
+    while (port->GetReferences().size() == 1)
+    {
+        auto reorderNode = dynamic_cast<const nodes::ReorderDataNode<ValueType>*>(port->GetNode());
+        if (reorderNode == nullptr || !(reorderNode->GetInputMemoryLayout() == reorderNode->GetOutputMemoryLayout()))
+        {
+            return port;
+        }
+        port = &reorderNode->input.GetReferencedPort();
+    }
+    return nullptr;
+}
+
+// The output operations see the product's output as a flat sequence of pixels with the channels innermost
+bool IsFlatChannelsLastLayout(const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout)
+{
+    return inputLayout == outputLayout && !inputLayout.HasPadding() && inputLayout.IsCanonicalOrder();
+}
+
+template <typename ValueType>
+using OutputOperations = nodes::FusedLinearActivation<ValueType>;
+
+// Adds a copy of the matrix product node of the new model that computes `port` with more output operations, if
+// `port` is the whole output of such a node. `addOperations` returns the new operations, or nothing if they can't be
+// composed with the node's current ones.
+template <typename NodeType, typename ValueType, typename AddOperationsFunction>
+const model::OutputPort<ValueType>* TryAddOutputOperations(const model::OutputPort<ValueType>& port, int numChannels, AddOperationsFunction addOperations, model::ModelTransformer& transformer)
+{
+    auto productNode = dynamic_cast<const NodeType*>(port.GetNode());
+    if (productNode == nullptr || &productNode->output != &port || !productNode->CanFuseOutputOperations(numChannels))
+    {
+        return nullptr;
+    }
+
+    std::optional<OutputOperations<ValueType>> operations = addOperations(productNode->GetOutputOperations());
+    if (!operations)
+    {
+        return nullptr;
+    }
+    return &productNode->AddNodeWithOutputOperations(transformer, *operations)->output;
+}
+
+// Returns 'true' if the elementwise node was fused into the matrix product that produces its input
+template <typename ValueType, typename AddOperationsFunction>
+bool TryFuseIntoMatrixProduct(const model::InputPort<ValueType>& input, const model::OutputPort<ValueType>& output, int numChannels, AddOperationsFunction addOperations, model::ModelTransformer& transformer)
+{
+    auto producerPort = GetExclusiveProducerPort(input);
+    if (producerPort == nullptr)
+    {
+        return false;
+    }
+
+    const auto& newProducerPort = transformer.GetCorrespondingOutputs(*producerPort);
+    auto newOutput = TryAddOutputOperations<nodes::MatrixMatrixMultiplyNode<ValueType>>(newProducerPort, numChannels, addOperations, transformer);
+    if (newOutput == nullptr)
+    {
+        newOutput = TryAddOutputOperations<nodes::MatrixVectorMultiplyNode<ValueType>>(newProducerPort, numChannels, addOperations, transformer);
+    }
+    if (newOutput == nullptr)
+    {
+        return false;
+    }
+
+    transformer.MapNodeOutput(output, *newOutput);
+    return true;
+}
+
+template <typename ValueType>
+std::vector<ValueType> GetConstantValues(const model::InputPort<ValueType>& input)
+{
+    auto constantNode = GetConstantInputNode(input);
+    return constantNode != nullptr ? constantNode->GetValues() : std::vector<ValueType>{};
+}
+
+template <typename ValueType>
+bool TryFuseLinearNode(const model::Node& node, model::ModelTransformer& transformer)
+{
+    auto thisNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(&node);
+    if (thisNode == nullptr || !HasConstantCoefficients(*thisNode))
+    {
+        return false;
+    }
+
+    const auto layout = thisNode->GetInputMemoryLayout();
+    if (!IsFlatChannelsLastLayout(layout, thisNode->GetOutputMemoryLayout()) || static_cast<int>(thisNode->GetBroadcastDimension()) != layout.NumDimensions() - 1)
+    {
+        return false;
+    }
+
+    auto scale = GetConstantValues(thisNode->secondaryInput1);
+    auto bias = GetConstantValues(thisNode->secondaryInput2);
+    auto numChannels = static_cast<int>(scale.empty() ? bias.size() : scale.size());
+    if (numChannels != layout.GetLogicalDimensionActiveSize(layout.NumDimensions() - 1))
+    {
+        return false;
+    }
+
+    auto addOperations = [&](const OutputOperations<ValueType>& operations) -> std::optional<OutputOperations<ValueType>> {
+        if (!operations.CanAppendLinear(numChannels))
+        {
+            return std::nullopt;
+        }
+        return operations.ThenLinear(scale, bias);
+    };
+    return TryFuseIntoMatrixProduct(thisNode->primaryInput, thisNode->output, numChannels, addOperations, transformer);
+}
+
+template <typename ValueType>
+predictors::neural::Activation<ValueType> GetNeuralActivation(const nodes::ReLUActivationFunction<ValueType>&)
+{
+    return { new predictors::neural::ReLUActivation<ValueType>() };
+}
+
+template <typename ValueType>
+predictors::neural::Activation<ValueType> GetNeuralActivation(const nodes::LeakyReLUActivationFunction<ValueType>& function)
+{
+    return { new predictors::neural::LeakyReLUActivation<ValueType>(function.GetLeakyFactor()) };
+}
+
+template <typename ValueType>
+predictors::neural::Activation<ValueType> GetNeuralActivation(const nodes::SigmoidActivationFunction<ValueType>&)
+{
+    return { new predictors::neural::SigmoidActivation<ValueType>() };
+}
+
+template <typename ValueType>
+predictors::neural::Activation<ValueType> GetNeuralActivation(const nodes::HardSigmoidActivationFunction<ValueType>&)
+{
+    return { new predictors::neural::HardSigmoidActivation<ValueType>() };
+}
+
+template <typename ValueType>
+predictors::neural::Activation<ValueType> GetNeuralActivation(const nodes::TanhActivationFunction<ValueType>&)
+{
+    return { new predictors::neural::TanhActivation<ValueType>() };
+}
+
+template <typename ValueType, typename ActivationFunctionType>
+bool TryFuseActivationIntoMatrixProduct(const nodes::BroadcastUnaryFunctionNode<ValueType, ActivationFunctionType>& node, model::ModelTransformer& transformer)
+{
+    if (!IsFlatChannelsLastLayout(node.GetInputMemoryLayout(), node.GetOutputMemoryLayout()))
+    {
+        return false;
+    }
+
+    auto activation = GetNeuralActivation(node.GetFunction());
+    auto addOperations = [&](const OutputOperations<ValueType>& operations) -> std::optional<OutputOperations<ValueType>> {
+        if (operations.HasActivation())
+        {
+            return std::nullopt;
+        }
+        return operations.ThenActivation(activation);
+    };
+    return TryFuseIntoMatrixProduct(node.primaryInput, node.output, 0, addOperations, transformer);
+}
+
+//
+// Fusing an activation into the linear function that produces its input
+//
+
+template <typename ValueType, typename ActivationFunctionType>
+bool CanFuseWithPrimaryInput(const nodes::BroadcastUnaryFunctionNode<ValueType, ActivationFunctionType>& node)
+{
+    auto linearNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(node.primaryInput.GetReferencedPort().GetNode());
+    if (linearNode == nullptr)
+    {
+        return false; // primary input must be a linear function
+    }
+
+    // If anything else uses the output of the linear function, it has to be computed anyway
+    if (linearNode->output.GetReferences().size() != 1)
+    {
+        return false;
+    }
+
+    if (!HasConstantCoefficients(*linearNode))
+    {
+        return false;
+    }
+
+    // The activation must read the linear function's output in the order it was written
+    return node.GetInputMemoryLayout() == linearNode->GetOutputMemoryLayout();
+}
+
+// returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other activation functions
+template <typename ValueType, typename ActivationFunctionType>
+bool TryFuseActivationNode(const model::Node& node, model::ModelTransformer& transformer)
+{
+    auto thisNode = dynamic_cast<const nodes::BroadcastUnaryFunctionNode<ValueType, ActivationFunctionType>*>(&node);
+    if (thisNode == nullptr)
+    {
+        return false;
+    }
+
+    if (TryFuseActivationIntoMatrixProduct(*thisNode, transformer))
+    {
+        return true;
+    }
+
+    if (!CanFuseWithPrimaryInput(*thisNode))
+    {
+        transformer.CopyNode(node);
+        return true;
+    }
+
+    // This is the node in the new model that corresponds to the linear function attached to our primaryInput
+    const auto& primaryInputElements = transformer.GetCorrespondingInputs(thisNode->primaryInput);
+    auto linearNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(primaryInputElements.GetNode());
+    if (linearNode == nullptr || !HasConstantCoefficients(*linearNode))
+    {
+        transformer.CopyNode(node);
+        return true;
+    }
+
+    using FusedFunctionType = nodes::LinearActivationFunction<ValueType, ActivationFunctionType>;
+    auto coefficients = GetLinearCoefficients(*linearNode);
+    auto scaleValuesNode = transformer.AddNode<nodes::ConstantNode<ValueType>>(coefficients.first);
+    auto biasValuesNode = transformer.AddNode<nodes::ConstantNode<ValueType>>(coefficients.second);
+    auto newNode = transformer.AddNode<nodes::BroadcastTernaryFunctionNode<ValueType, FusedFunctionType>>(linearNode->primaryInput.GetReferencedPort(),
+                                                                                                          linearNode->GetInputMemoryLayout(),
+                                                                                                          scaleValuesNode->output,
+                                                                                                          biasValuesNode->output,
+                                                                                                          linearNode->GetBroadcastDimension(),
+                                                                                                          thisNode->GetOutputMemoryLayout(),
+                                                                                                          FusedFunctionType{ thisNode->GetFunction() },
+                                                                                                          thisNode->GetOutputPadding());
+    transformer.MapNodeOutput(thisNode->output, newNode->output);
+    return true;
+}
+
+template <typename ValueType>
+bool TryFuseElementwiseNodes(const model::Node& node, model::ModelTransformer& transformer)
+{
+    return TryFuseLinearNode<ValueType>(node, transformer) ||
+           TryFuseActivationNode<ValueType, nodes::ReLUActivationFunction<ValueType>>(node, transformer) ||
+           TryFuseActivationNode<ValueType, nodes::LeakyReLUActivationFunction<ValueType>>(node, transformer) ||
+           TryFuseActivationNode<ValueType, nodes::SigmoidActivationFunction<ValueType>>(node, transformer) ||
+           TryFuseActivationNode<ValueType, nodes::HardSigmoidActivationFunction<ValueType>>(node, transformer) ||
+           TryFuseActivationNode<ValueType, nodes::TanhActivationFunction<ValueType>>(node, transformer);
+}
+
+void FuseElementwiseNodes(const model::Node& node, model::ModelTransformer& transformer)
+{
+    if (TryFuseElementwiseNodes<float>(node, transformer))
+    {
+        return;
+    }
+    if (TryFuseElementwiseNodes<double>(node, transformer))
+    {
+        return;
+    }
+    transformer.CopyNode(node);
+}
+} // namespace
+
+//
+// FuseElementwiseOperationsTransformation methods
+//
+namespace ell
+{
+namespace passes
+{
+    Submodel FuseElementwiseOperationsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto compiler = context.GetCompiler();
+        if (!compiler)
+        {
+            return submodel;
+        }
+
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        auto result = transformer.TransformSubmodelOnto(submodel, onto, context, [compiler](const Node& node, ModelTransformer& transformer) {
+            bool canFuseNodes = compiler->GetModelOptimizerOptions(node).GetEntry<bool>("fuseElementwiseOperations", true);
+
+            if (canFuseNodes)
+            {
+                FuseElementwiseNodes(node, transformer);
+            }
+            else
+            {
+                transformer.CopyNode(node);
+            }
+        });
+
+        return result;
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseSoftmaxTopKTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FuseSoftmaxTopKTransformation.h"
+
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/SoftmaxLayerNode.h>
+#include <nodes/include/TopKNode.h>
+
+#include <utilities/include/StlVectorUtil.h>
+
+#include <vector>
+
+using namespace ell;
+using namespace ell::model;
+
+//
+// Implementation
+//
+namespace
+{
+std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+{
+    return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+}
+
+// Returns the softmax node that computes the whole input of the top-k node, if nothing else uses its output
+template <typename ValueType>
+const nodes::SoftmaxLayerNode<ValueType>* GetFusableSoftmaxNode(const nodes::TopKNode<ValueType>& node)
+{
+    if (node.IsNormalized())
+    {
+        return nullptr;
+    }
+
+    auto softmaxNode = dynamic_cast<const nodes::SoftmaxLayerNode<ValueType>*>(node.input.GetReferencedPort().GetNode());
+    if (softmaxNode == nullptr || softmaxNode->output.GetReferences().size() != 1)
+    {
+        return nullptr;
+    }
+
+    // Padded layouts would make the top-k indices refer to different positions than the softmax output
+    if (!softmaxNode->GetInputMemoryLayout().IsContiguous() || !softmaxNode->GetOutputMemoryLayout().IsContiguous())
+    {
+        return nullptr;
+    }
+
+    if (node.input.Size() != softmaxNode->output.Size() || softmaxNode->input.Size() != softmaxNode->output.Size())
+    {
+        return nullptr;
+    }
+    return softmaxNode;
+}
+
+// returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other value types
+template <typename ValueType>
+bool TryFuseSoftmaxTopKNode(const model::Node& node, model::ModelTransformer& transformer)
+{
+    auto thisNode = dynamic_cast<const nodes::TopKNode<ValueType>*>(&node);
+    if (thisNode == nullptr)
+    {
+        return false;
+    }
+
+    auto softmaxNode = GetFusableSoftmaxNode(*thisNode);
+    if (softmaxNode == nullptr)
+    {
+        transformer.CopyNode(node);
+        return true;
+    }
+
+    // The softmax node has already been copied; it's pruned once nothing uses its output
+    const auto& newInput = transformer.GetCorrespondingInputs(softmaxNode->input);
+    auto newNode = transformer.AddNode<nodes::TopKNode<ValueType>>(newInput, thisNode->GetK(), true);
+    transformer.MapNodeOutput(thisNode->val, newNode->val);
+    transformer.MapNodeOutput(thisNode->argVal, newNode->argVal);
+    return true;
+}
+
+void FuseSoftmaxTopKNode(const model::Node& node, model::ModelTransformer& transformer)
+{
+    if (TryFuseSoftmaxTopKNode<float>(node, transformer))
+    {
+        return;
+    }
+    if (TryFuseSoftmaxTopKNode<double>(node, transformer))
+    {
+        return;
+    }
+    transformer.CopyNode(node);
+}
+} // namespace
+
+//
+// FuseSoftmaxTopKTransformation methods
+//
+namespace ell
+{
+namespace passes
+{
+    Submodel FuseSoftmaxTopKTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto compiler = context.GetCompiler();
+        if (!compiler)
+        {
+            return submodel;
+        }
+
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        auto result = transformer.TransformSubmodelOnto(submodel, onto, context, [compiler](const Node& node, ModelTransformer& transformer) {
+            bool canFuseNodes = compiler->GetModelOptimizerOptions(node).GetEntry<bool>("fuseSoftmaxTopK", true);
+
+            if (canFuseNodes)
+            {
+                FuseSoftmaxTopKNode(node, transformer);
+            }
+            else
+            {
+                transformer.CopyNode(node);
+            }
+        });
+
+        return result;
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     HalfPrecisionWeightsTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "HalfPrecisionWeightsTransformation.h"
+
+#include <model/include/ModelTransformer.h>
+#include <model/include/RefineTransformation.h>
+
+#include <nodes/include/FullyConnectedLayerNode.h>
+#include <nodes/include/MatrixVectorProductNode.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        bool IsNeuralNetworkPredictorNode(const Node& node)
+        {
+            return (node.GetRuntimeTypeName().find("NeuralNetworkPredictorNode") == 0);
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryConvertNode(const Node& node, ModelTransformer& transformer, nodes::HalfPrecisionFormat format)
+        {
+            const InputPort<ValueType>* input = nullptr;
+            nodes::HalfPrecisionMatrix weights;
+            if (auto fullyConnectedNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node))
+            {
+                input = &fullyConnectedNode->input;
+                weights = nodes::ToHalfPrecisionMatrix(fullyConnectedNode->GetLayer().GetWeights().GetConstReference(), format);
+            }
+            else if (auto rowMajorNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>*>(&node))
+            {
+                input = &rowMajorNode->input;
+                weights = nodes::ToHalfPrecisionMatrix(rowMajorNode->GetProjectionMatrix().GetConstReference(), format);
+            }
+            else if (auto columnMajorNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::columnMajor>*>(&node))
+            {
+                input = &columnMajorNode->input;
+                weights = nodes::ToHalfPrecisionMatrix(columnMajorNode->GetProjectionMatrix().GetConstReference(), format);
+            }
+            else
+            {
+                return false;
+            }
+
+            const auto& newInput = transformer.GetCorrespondingInputs(*input);
+            auto newNode = transformer.AddNode<nodes::HalfPrecisionMatrixVectorProductNode<ValueType>>(newInput, weights);
+            newNode->GetMetadata() = node.GetMetadata();
+
+            Log() << "Storing the weights of node " << node.GetId() << " as 16-bit values" << EOL;
+            const auto& output = static_cast<const OutputPort<ValueType>&>(*node.GetOutputPort(0));
+            transformer.MapNodeOutput(output, newNode->output);
+            return true;
+        }
+
+        void ConvertNode(const Node& node, ModelTransformer& transformer, nodes::HalfPrecisionFormat format)
+        {
+            if (TryConvertNode<float>(node, transformer, format))
+            {
+                return;
+            }
+            if (TryConvertNode<double>(node, transformer, format))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    //
+    // HalfPrecisionWeightsTransformation methods
+    //
+    HalfPrecisionWeightsTransformation::HalfPrecisionWeightsTransformation(nodes::HalfPrecisionFormat format) :
+        _format(format)
+    {
+    }
+
+    Submodel HalfPrecisionWeightsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        // First refine any NeuralNetworkPredictorNodes, so we can see their layers
+        auto refineNNPredictorFn = [](const model::Node& node) {
+            return IsNeuralNetworkPredictorNode(node) ? model::NodeAction::refine : model::NodeAction::compile;
+        };
+        model::TransformContext refineNNPredictorContext{ refineNNPredictorFn };
+        RefineTransformation refineTransformation;
+        auto result1 = refineTransformation.Transform(submodel, transformer, refineNNPredictorContext);
+
+        // Now replace the layers with 16-bit ones, using an in-place transformation
+        auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(result1.GetInputs()));
+        model::Model destModel = result1.GetModel().ShallowCopy();
+        auto format = _format;
+        return transformer.TransformSubmodelOnto(result1, destModel, onto, context, [format](const Node& node, ModelTransformer& transformer) {
+            ConvertNode(node, transformer, format);
+        });
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,298 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LearnedCostModel.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LearnedCostModel.h"
+
+#include <data/include/Dataset.h>
+#include <data/include/DenseDataVector.h>
+
+#include <functions/include/SquaredLoss.h>
+
+#include <trainers/include/SortingForestTrainer.h>
+#include <trainers/include/SquaredLossBooster.h>
+
+#include <utilities/include/Archiver.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/JsonArchiver.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace passes
+{
+    namespace
+    {
+        const std::string c_hostDeviceName = "host";
+
+        std::string GetDeviceName(const model::optimizer::Environment& environment)
+        {
+            if (!environment.HasTargetDevice() || environment.GetTargetDevice().deviceName.empty())
+            {
+                return c_hostDeviceName;
+            }
+            return environment.GetTargetDevice().deviceName;
+        }
+
+        int IndexOf(const std::vector<std::string>& names, const std::string& name)
+        {
+            auto iter = std::find(names.begin(), names.end(), name);
+            return iter == names.end() ? -1 : static_cast<int>(iter - names.begin());
+        }
+
+        void AddName(std::vector<std::string>& names, const std::string& name)
+        {
+            if (IndexOf(names, name) < 0)
+            {
+                names.push_back(name);
+            }
+        }
+
+        // Sizes are spread over orders of magnitude, so they're log-scaled. A missing port or dimension counts as size 1.
+        double LogSize(size_t size)
+        {
+            return std::log2(1.0 + static_cast<double>(size));
+        }
+
+        void AddLayoutFeatures(const model::PortMemoryLayout& layout, std::vector<double>& features)
+        {
+            const auto& shape = layout.GetActiveSize();
+            auto numDimensions = shape.NumDimensions();
+            features.push_back(LogSize(layout.NumElements()));
+
+            // The last three dimensions, which are rows, columns, and channels for images
+            for (int index = numDimensions - 3; index < numDimensions; ++index)
+            {
+                features.push_back(LogSize(index >= 0 ? shape[index] : 1));
+            }
+        }
+
+        void AddPortFeatures(const model::Port* port, std::vector<double>& features)
+        {
+            if (port == nullptr)
+            {
+                AddLayoutFeatures(model::PortMemoryLayout({ 1 }), features);
+            }
+            else
+            {
+                AddLayoutFeatures(port->GetMemoryLayout(), features);
+            }
+        }
+
+        std::vector<double> GetShapeFeatures(const model::Node& node)
+        {
+            const auto& inputs = node.GetInputPorts();
+            const auto& outputs = node.GetOutputPorts();
+
+            std::vector<double> features;
+            features.push_back(static_cast<double>(inputs.size()));
+            features.push_back(static_cast<double>(outputs.size()));
+            features.push_back(outputs.empty() ? 0.0 : static_cast<double>(model::GetPortElementSize(outputs[0]->GetType())));
+            AddPortFeatures(inputs.empty() ? nullptr : inputs[0], features);
+            AddPortFeatures(outputs.empty() ? nullptr : outputs[0], features);
+            return features;
+        }
+
+        // One-hot encodings of the node type and the device, followed by the shape features
+        std::vector<double> GetFeatures(int nodeTypeIndex, size_t numNodeTypes, int deviceIndex, size_t numDevices, const std::vector<double>& shapeFeatures)
+        {
+            std::vector<double> features(numNodeTypes + numDevices, 0.0);
+            features[nodeTypeIndex] = 1.0;
+            features[numNodeTypes + deviceIndex] = 1.0;
+            features.insert(features.end(), shapeFeatures.begin(), shapeFeatures.end());
+            return features;
+        }
+
+        bool IsFree(const model::Node& node)
+        {
+            return node.NumInputPorts() == 0;
+        }
+    } // namespace
+
+    //
+    // LearnedCostModel
+    //
+    LearnedCostModel::LearnedCostModel(std::vector<std::string> nodeTypes, std::vector<std::string> deviceNames, predictors::SimpleForestPredictor forest) :
+        _nodeTypes(std::move(nodeTypes)),
+        _deviceNames(std::move(deviceNames)),
+        _forest(std::move(forest))
+    {
+    }
+
+    bool LearnedCostModel::HasCost(const model::Submodel& submodel, const model::optimizer::Environment& environment) const
+    {
+        auto deviceName = GetDeviceName(environment);
+        bool hasCost = !_nodeTypes.empty();
+        submodel.Visit([&](const model::Node& node) {
+            hasCost = hasCost && (IsFree(node) || CanPredictNodeTime(node, deviceName));
+        });
+        return hasCost;
+    }
+
+    model::optimizer::Cost LearnedCostModel::GetCost(const model::Submodel& submodel, const model::optimizer::Environment& environment) const
+    {
+        if (!HasCost(submodel, environment))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "LearnedCostModel: the model wasn't trained on this device or on some of these nodes");
+        }
+
+        auto deviceName = GetDeviceName(environment);
+        double time = 0;
+        submodel.Visit([&](const model::Node& node) {
+            if (!IsFree(node))
+            {
+                time += PredictNodeTime(node, deviceName);
+            }
+        });
+
+        model::optimizer::Cost cost;
+        cost["runtime"] = model::optimizer::HeuristicCostValue(time);
+        return cost;
+    }
+
+    bool LearnedCostModel::CanPredictNodeTime(const model::Node& node, const std::string& deviceName) const
+    {
+        return IndexOf(_nodeTypes, node.GetRuntimeTypeName()) >= 0 && IndexOf(_deviceNames, deviceName) >= 0;
+    }
+
+    double LearnedCostModel::PredictNodeTime(const model::Node& node, const std::string& deviceName) const
+    {
+        auto nodeTypeIndex = IndexOf(_nodeTypes, node.GetRuntimeTypeName());
+        auto deviceIndex = IndexOf(_deviceNames, deviceName);
+        if (nodeTypeIndex < 0 || deviceIndex < 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "LearnedCostModel: unknown node type or device");
+        }
+
+        // The forest predicts the log of the time, so relative errors count the same for small and large nodes
+        auto features = GetFeatures(nodeTypeIndex, _nodeTypes.size(), deviceIndex, _deviceNames.size(), GetShapeFeatures(node));
+        return std::exp(_forest.Predict(data::FloatDataVector(features)));
+    }
+
+    void LearnedCostModel::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        archiver["nodeTypes"] << _nodeTypes;
+        archiver["deviceNames"] << _deviceNames;
+        archiver["forest"] << _forest;
+    }
+
+    void LearnedCostModel::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        archiver["nodeTypes"] >> _nodeTypes;
+        archiver["deviceNames"] >> _deviceNames;
+        archiver["forest"] >> _forest;
+    }
+
+    //
+    // LearnedCostModelTrainer
+    //
+    void LearnedCostModelTrainer::AddProfile(const model::Model& model, const model::ModelProfileData& profileData, const std::string& deviceName)
+    {
+        model.Visit([&](const model::Node& node) {
+            if (IsFree(node))
+            {
+                return;
+            }
+
+            auto nodeId = to_string(node.GetId());
+            for (const auto& nodeProfile : profileData.GetNodes())
+            {
+                if (nodeProfile.nodeId == nodeId && nodeProfile.count > 0 && nodeProfile.totalTime > 0)
+                {
+                    AddNodeTime(node, deviceName, nodeProfile.totalTime / nodeProfile.count);
+                    break;
+                }
+            }
+        });
+    }
+
+    void LearnedCostModelTrainer::AddNodeTime(const model::Node& node, const std::string& deviceName, double time)
+    {
+        if (time <= 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "LearnedCostModelTrainer: node times must be positive");
+        }
+        _examples.push_back({ node.GetRuntimeTypeName(), deviceName, GetShapeFeatures(node), time });
+    }
+
+    LearnedCostModel LearnedCostModelTrainer::Train(const LearnedCostModelParameters& parameters) const
+    {
+        if (_examples.empty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "LearnedCostModelTrainer: no node times to train on");
+        }
+
+        std::vector<std::string> nodeTypes;
+        std::vector<std::string> deviceNames;
+        for (const auto& example : _examples)
+        {
+            AddName(nodeTypes, example.nodeType);
+            AddName(deviceNames, example.deviceName);
+        }
+
+        data::AutoSupervisedDataset dataset;
+        for (const auto& example : _examples)
+        {
+            auto features = GetFeatures(IndexOf(nodeTypes, example.nodeType), nodeTypes.size(), IndexOf(deviceNames, example.deviceName), deviceNames.size(), example.shapeFeatures);
+            dataset.AddExample({ features, { 1.0, std::log(example.time) } });
+        }
+
+        trainers::SortingForestTrainerParameters forestParameters;
+        forestParameters.numRounds = parameters.numRounds;
+        forestParameters.maxSplitsPerRound = parameters.maxSplitsPerRound;
+        forestParameters.minSplitGain = parameters.minSplitGain;
+        auto trainer = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::SquaredLossBooster(), forestParameters);
+        trainer->SetDataset(dataset.GetAnyDataset());
+        trainer->Update();
+
+        return { std::move(nodeTypes), std::move(deviceNames), trainer->GetPredictor() };
+    }
+
+    //
+    // Loading and saving
+    //
+    LearnedCostModel LoadLearnedCostModel(const std::string& filename)
+    {
+        if (!utilities::IsFileReadable(filename))
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound);
+        }
+
+        auto filestream = utilities::OpenIfstream(filename);
+        return LoadLearnedCostModel(filestream);
+    }
+
+    LearnedCostModel LoadLearnedCostModel(std::istream& stream)
+    {
+        utilities::SerializationContext context;
+        utilities::JsonUnarchiver unarchiver(stream, context);
+        LearnedCostModel costModel;
+        unarchiver.Unarchive(costModel);
+        return costModel;
+    }
+
+    void SaveLearnedCostModel(const LearnedCostModel& costModel, const std::string& filename)
+    {
+        if (!utilities::IsFileWritable(filename))
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable);
+        }
+
+        auto filestream = utilities::OpenOfstream(filename);
+        SaveLearnedCostModel(costModel, filestream);
+    }
+
+    void SaveLearnedCostModel(const LearnedCostModel& costModel, std::ostream& stream)
+    {
+        utilities::JsonArchiver archiver(stream);
+        archiver.Archive(costModel);
+    }
+} // namespace passes
+} // namespace ell
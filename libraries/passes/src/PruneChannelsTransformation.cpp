@@ -0,0 +1,516 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PruneChannelsTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PruneChannelsTransformation.h"
+
+#include <model/include/InputNode.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/RefineTransformation.h>
+
+#include <nodes/include/ActivationLayerNode.h>
+#include <nodes/include/BatchNormalizationLayerNode.h>
+#include <nodes/include/BiasLayerNode.h>
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
+#include <nodes/include/ScalingLayerNode.h>
+
+#include <predictors/neural/include/ParametricReLUActivation.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        using ChannelList = std::vector<size_t>;
+
+        // A convolutional layer whose outputs only reach one convolutional or fully-connected layer, through layers that work on each channel separately
+        template <typename ValueType>
+        struct ChannelChain
+        {
+            const nodes::ConvolutionalLayerNode<ValueType>* producer = nullptr;
+            std::vector<const nodes::NeuralNetworkLayerNodeBase<ValueType>*> channelwiseNodes;
+            const nodes::NeuralNetworkLayerNodeBase<ValueType>* consumer = nullptr;
+
+            const nodes::NeuralNetworkLayerNodeBase<ValueType>& Last() const
+            {
+                if (channelwiseNodes.empty())
+                {
+                    return *producer;
+                }
+                return *channelwiseNodes.back();
+            }
+        };
+
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        bool IsNeuralNetworkPredictorNode(const Node& node)
+        {
+            return (node.GetRuntimeTypeName().find("NeuralNetworkPredictorNode") == 0);
+        }
+
+        ChannelList AllChannels(size_t numChannels)
+        {
+            ChannelList result(numChannels);
+            std::iota(result.begin(), result.end(), 0);
+            return result;
+        }
+
+        const ChannelList* FindChannels(const std::unordered_map<const Node*, ChannelList>& channels, const Node& node)
+        {
+            auto it = channels.find(&node);
+            return it == channels.end() ? nullptr : &it->second;
+        }
+
+        math::TensorShape WithChannels(const math::TensorShape& shape, size_t numChannels)
+        {
+            return { shape.NumRows(), shape.NumColumns(), numChannels };
+        }
+
+        template <typename ValueType>
+        math::ColumnVector<ValueType> SelectChannels(const math::ColumnVector<ValueType>& values, const ChannelList& channels)
+        {
+            math::ColumnVector<ValueType> result(channels.size());
+            for (size_t index = 0; index < channels.size(); ++index)
+            {
+                result[index] = values[channels[index]];
+            }
+            return result;
+        }
+
+        template <typename ValueType>
+        const nodes::ConvolutionalLayerNode<ValueType>* GetPrunableConvolutionalNode(const Node& node)
+        {
+            // Depthwise-separable layers have one input channel per output channel, so they can't be pruned alone
+            auto convolutionalNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (convolutionalNode == nullptr || convolutionalNode->GetLayer().IsDepthwiseSeparable())
+            {
+                return nullptr;
+            }
+            return convolutionalNode;
+        }
+
+        template <typename ValueType>
+        bool IsChannelwiseNode(const Node& node)
+        {
+            if (dynamic_cast<const nodes::BatchNormalizationLayerNode<ValueType>*>(&node) || dynamic_cast<const nodes::BiasLayerNode<ValueType>*>(&node) || dynamic_cast<const nodes::ScalingLayerNode<ValueType>*>(&node))
+            {
+                return true;
+            }
+
+            // Parametric ReLU has a parameter per value, not per channel
+            auto activationNode = dynamic_cast<const nodes::ActivationLayerNode<ValueType>*>(&node);
+            return activationNode != nullptr && dynamic_cast<const predictors::neural::ParametricReLUActivation<ValueType>*>(activationNode->GetLayer().GetActivationFunction().GetImpl()) == nullptr;
+        }
+
+        // Returns the only node that reads the node's output, if it's a layer node that reads all of it, else `nullptr`
+        template <typename ValueType>
+        const nodes::NeuralNetworkLayerNodeBase<ValueType>* GetOnlyLayerUser(const nodes::NeuralNetworkLayerNodeBase<ValueType>& node)
+        {
+            const auto& references = node.output.GetReferences();
+            if (references.size() != 1)
+            {
+                return nullptr;
+            }
+
+            auto user = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<ValueType>*>(references[0]->GetNode());
+            if (user == nullptr || references[0] != &user->input || user->input.Size() != node.output.Size())
+            {
+                return nullptr;
+            }
+            return user;
+        }
+
+        template <typename ValueType>
+        std::vector<ChannelChain<ValueType>> FindChannelChains(const Model& model)
+        {
+            std::vector<ChannelChain<ValueType>> chains;
+            auto iter = model.GetNodeIterator();
+            while (iter.IsValid())
+            {
+                auto node = iter.Get();
+                iter.Next();
+
+                ChannelChain<ValueType> chain;
+                chain.producer = GetPrunableConvolutionalNode<ValueType>(*node);
+                if (chain.producer == nullptr)
+                {
+                    continue;
+                }
+
+                auto user = GetOnlyLayerUser<ValueType>(*chain.producer);
+                while (user != nullptr && IsChannelwiseNode<ValueType>(*user))
+                {
+                    chain.channelwiseNodes.push_back(user);
+                    user = GetOnlyLayerUser<ValueType>(*user);
+                }
+
+                if (user != nullptr && (GetPrunableConvolutionalNode<ValueType>(*user) || dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(user)))
+                {
+                    chain.consumer = user;
+                    chains.push_back(chain);
+                }
+            }
+            return chains;
+        }
+
+        // The average magnitude of the weights of each filter
+        template <typename ValueType>
+        std::vector<double> GetFilterMagnitudes(const ChannelChain<ValueType>& chain)
+        {
+            const auto& layer = chain.producer->GetLayer();
+            const auto& weights = layer.GetWeights();
+            auto filterSize = layer.GetConvolutionalParameters().receptiveField;
+            auto numFilters = layer.GetOutputShape().NumChannels();
+
+            std::vector<double> result(numFilters);
+            for (size_t filter = 0; filter < numFilters; ++filter)
+            {
+                double sum = 0;
+                for (size_t row = 0; row < filterSize; ++row)
+                {
+                    for (size_t column = 0; column < filterSize; ++column)
+                    {
+                        for (size_t channel = 0; channel < weights.NumChannels(); ++channel)
+                        {
+                            sum += std::abs(weights(filter * filterSize + row, column, channel));
+                        }
+                    }
+                }
+                result[filter] = sum / (filterSize * filterSize * weights.NumChannels());
+            }
+            return result;
+        }
+
+        // The average magnitude of each channel read by the consumer of each chain, over the calibration inputs
+        template <typename ValueType>
+        std::vector<std::vector<double>> GetActivationMagnitudes(const Model& model, const std::vector<ChannelChain<ValueType>>& chains, const std::vector<std::vector<double>>& calibrationInputs)
+        {
+            std::vector<std::vector<double>> result;
+            for (const auto& chain : chains)
+            {
+                result.emplace_back(chain.Last().GetLayerParameters().outputShape.NumChannels());
+            }
+
+            auto inputNodes = model.GetNodesByType<InputNode<ValueType>>();
+            if (chains.empty() || inputNodes.size() != 1)
+            {
+                return result;
+            }
+
+            auto inputNode = const_cast<InputNode<ValueType>*>(inputNodes[0]);
+            for (const auto& calibrationInput : calibrationInputs)
+            {
+                std::vector<ValueType> inputValues(inputNode->Size());
+                std::transform(calibrationInput.begin(), calibrationInput.begin() + std::min(calibrationInput.size(), inputValues.size()), inputValues.begin(), [](double x) { return static_cast<ValueType>(x); });
+                inputNode->SetInput(inputValues);
+
+                for (size_t chainIndex = 0; chainIndex < chains.size(); ++chainIndex)
+                {
+                    // Only the values inside the padding count
+                    auto parameters = chains[chainIndex].Last().GetLayerParameters();
+                    const auto& shape = parameters.outputShape;
+                    auto padding = parameters.outputPaddingParameters.paddingSize;
+                    auto values = model.ComputeOutput(chains[chainIndex].Last().output);
+                    auto& magnitudes = result[chainIndex];
+                    for (size_t row = padding; row + padding < shape.NumRows(); ++row)
+                    {
+                        for (size_t column = padding; column + padding < shape.NumColumns(); ++column)
+                        {
+                            for (size_t channel = 0; channel < shape.NumChannels(); ++channel)
+                            {
+                                magnitudes[channel] += std::abs(values[(row * shape.NumColumns() + column) * shape.NumChannels() + channel]);
+                            }
+                        }
+                    }
+                }
+            }
+            return result;
+        }
+
+        ChannelList GetKeptChannels(const std::vector<double>& importance, double threshold)
+        {
+            auto mostImportant = std::max_element(importance.begin(), importance.end());
+            ChannelList result;
+            for (size_t channel = 0; channel < importance.size(); ++channel)
+            {
+                if (importance[channel] >= threshold * *mostImportant)
+                {
+                    result.push_back(channel);
+                }
+            }
+
+            // Always keep at least one channel
+            if (result.empty())
+            {
+                result.push_back(mostImportant - importance.begin());
+            }
+            return result;
+        }
+
+        template <typename ValueType>
+        void PlanPruning(const Model& model, double threshold, ChannelPruningCriterion criterion, const std::vector<std::vector<double>>& calibrationInputs, ChannelPruningPlan& plan)
+        {
+            auto chains = FindChannelChains<ValueType>(model);
+            std::vector<std::vector<double>> activationMagnitudes;
+            if (criterion == ChannelPruningCriterion::activations)
+            {
+                activationMagnitudes = GetActivationMagnitudes(model, chains, calibrationInputs);
+            }
+
+            for (size_t chainIndex = 0; chainIndex < chains.size(); ++chainIndex)
+            {
+                const auto& chain = chains[chainIndex];
+                auto importance = criterion == ChannelPruningCriterion::activations ? activationMagnitudes[chainIndex] : GetFilterMagnitudes(chain);
+                auto keptChannels = GetKeptChannels(importance, threshold);
+                if (keptChannels.size() == importance.size())
+                {
+                    continue;
+                }
+
+                Log() << "Pruning node " << chain.producer->GetId() << " from " << importance.size() << " to " << keptChannels.size() << " channels" << EOL;
+                plan.keptOutputChannels[chain.producer] = keptChannels;
+                for (auto node : chain.channelwiseNodes)
+                {
+                    plan.keptOutputChannels[node] = keptChannels;
+                }
+                plan.keptInputChannels[chain.consumer] = keptChannels;
+            }
+        }
+
+        template <typename NodeType, typename ValueType, typename LayerType>
+        const OutputPort<ValueType>& AddPrunedNode(const Node& node, const OutputPort<ValueType>& newInput, const LayerType& layer, ModelTransformer& transformer)
+        {
+            auto newNode = transformer.AddNode<NodeType>(newInput, layer);
+            newNode->GetMetadata() = node.GetMetadata();
+            return newNode->output;
+        }
+
+        // Adds a copy of a layer node without the pruned channels, after first adding the layers it reads from that lose channels
+        template <typename ValueType>
+        const OutputPort<ValueType>& AddPrunedLayerNodes(const nodes::NeuralNetworkLayerNodeBase<ValueType>& node, ModelTransformer& transformer, const ChannelPruningPlan& plan)
+        {
+            using Layer = predictors::neural::Layer<ValueType>;
+            auto keptInputs = FindChannels(plan.keptInputChannels, node);
+            auto keptOutputs = FindChannels(plan.keptOutputChannels, node);
+
+            auto inputNode = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<ValueType>*>(node.input.GetReferencedPort().GetNode());
+            const auto& newInput = (inputNode != nullptr && FindChannels(plan.keptOutputChannels, *inputNode)) ? AddPrunedLayerNodes(*inputNode, transformer, plan) : transformer.GetCorrespondingInputs(node.input);
+
+            // Layers that work on each channel separately lose the same input and output channels
+            auto parameters = node.GetLayerParameters();
+            auto inputChannels = keptInputs ? *keptInputs : (keptOutputs && IsChannelwiseNode<ValueType>(node) ? *keptOutputs : AllChannels(parameters.input.NumChannels()));
+            auto outputChannels = keptOutputs ? *keptOutputs : AllChannels(parameters.outputShape.NumChannels());
+
+            typename Layer::TensorType inputPlaceholder(WithChannels(parameters.input.GetShape(), inputChannels.size()));
+            typename Layer::ConstTensorReferenceType inputPlaceholderRef(inputPlaceholder);
+            typename Layer::LayerParameters newParameters{ inputPlaceholderRef, parameters.inputPaddingParameters, WithChannels(parameters.outputShape, outputChannels.size()), parameters.outputPaddingParameters };
+
+            if (auto convolutionalNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node))
+            {
+                const auto& layer = convolutionalNode->GetLayer();
+                const auto& weights = layer.GetWeights();
+                auto filterSize = layer.GetConvolutionalParameters().receptiveField;
+                typename Layer::TensorType newWeights(outputChannels.size() * filterSize, filterSize, inputChannels.size());
+                for (size_t filter = 0; filter < outputChannels.size(); ++filter)
+                {
+                    for (size_t row = 0; row < filterSize; ++row)
+                    {
+                        for (size_t column = 0; column < filterSize; ++column)
+                        {
+                            for (size_t channel = 0; channel < inputChannels.size(); ++channel)
+                            {
+                                newWeights(filter * filterSize + row, column, channel) = weights(outputChannels[filter] * filterSize + row, column, inputChannels[channel]);
+                            }
+                        }
+                    }
+                }
+                predictors::neural::ConvolutionalLayer<ValueType> newLayer(newParameters, layer.GetConvolutionalParameters(), newWeights);
+                return AddPrunedNode<nodes::ConvolutionalLayerNode<ValueType>>(node, newInput, newLayer, transformer);
+            }
+            if (auto fullyConnectedNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node))
+            {
+                // The input is flattened in (row, column, channel) order
+                const auto& weights = fullyConnectedNode->GetLayer().GetWeights();
+                auto oldNumChannels = parameters.input.NumChannels();
+                auto numPixels = parameters.input.NumRows() * parameters.input.NumColumns();
+                math::RowMatrix<ValueType> newWeights(weights.NumRows(), numPixels * inputChannels.size());
+                for (size_t row = 0; row < weights.NumRows(); ++row)
+                {
+                    for (size_t pixel = 0; pixel < numPixels; ++pixel)
+                    {
+                        for (size_t channel = 0; channel < inputChannels.size(); ++channel)
+                        {
+                            newWeights(row, pixel * inputChannels.size() + channel) = weights(row, pixel * oldNumChannels + inputChannels[channel]);
+                        }
+                    }
+                }
+                auto newWeightsRef = newWeights.GetConstReference();
+                predictors::neural::FullyConnectedLayer<ValueType> newLayer(newParameters, newWeightsRef);
+                return AddPrunedNode<nodes::FullyConnectedLayerNode<ValueType>>(node, newInput, newLayer, transformer);
+            }
+            if (auto batchNormalizationNode = dynamic_cast<const nodes::BatchNormalizationLayerNode<ValueType>*>(&node))
+            {
+                // Only the combined scale and bias are kept, so recover a mean and variance that give the same ones
+                auto scale = SelectChannels(batchNormalizationNode->GetLayer().GetScale(), outputChannels);
+                auto bias = SelectChannels(batchNormalizationNode->GetLayer().GetBias(), outputChannels);
+                math::ColumnVector<ValueType> mean(outputChannels.size());
+                math::ColumnVector<ValueType> variance(outputChannels.size());
+                for (size_t channel = 0; channel < outputChannels.size(); ++channel)
+                {
+                    variance[channel] = 1 / (scale[channel] * scale[channel]);
+                    mean[channel] = -bias[channel] / scale[channel];
+                }
+                predictors::neural::BatchNormalizationLayer<ValueType> newLayer(newParameters, mean, variance, 0, predictors::neural::EpsilonSummand::SqrtVariance);
+                return AddPrunedNode<nodes::BatchNormalizationLayerNode<ValueType>>(node, newInput, newLayer, transformer);
+            }
+            if (auto biasNode = dynamic_cast<const nodes::BiasLayerNode<ValueType>*>(&node))
+            {
+                predictors::neural::BiasLayer<ValueType> newLayer(newParameters, SelectChannels(biasNode->GetLayer().GetBias(), outputChannels));
+                return AddPrunedNode<nodes::BiasLayerNode<ValueType>>(node, newInput, newLayer, transformer);
+            }
+            if (auto scalingNode = dynamic_cast<const nodes::ScalingLayerNode<ValueType>*>(&node))
+            {
+                predictors::neural::ScalingLayer<ValueType> newLayer(newParameters, SelectChannels(scalingNode->GetLayer().GetScale(), outputChannels));
+                return AddPrunedNode<nodes::ScalingLayerNode<ValueType>>(node, newInput, newLayer, transformer);
+            }
+
+            // Only the kinds of layers above are planned to lose channels
+            auto activationNode = dynamic_cast<const nodes::ActivationLayerNode<ValueType>*>(&node);
+            predictors::neural::ActivationLayer<ValueType> newLayer(newParameters, activationNode->GetLayer().GetActivationFunction());
+            return AddPrunedNode<nodes::ActivationLayerNode<ValueType>>(node, newInput, newLayer, transformer);
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryPruneNode(const Node& node, ModelTransformer& transformer, const ChannelPruningPlan& plan)
+        {
+            auto layerNode = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<ValueType>*>(&node);
+            if (layerNode == nullptr)
+            {
+                return false;
+            }
+
+            // The layers that lose output channels change the size of their output, so they are added with the
+            // layer that reads them, which only loses input channels and keeps the size of its output
+            if (FindChannels(plan.keptOutputChannels, node))
+            {
+                return true;
+            }
+            if (!FindChannels(plan.keptInputChannels, node))
+            {
+                return false;
+            }
+
+            const auto& newOutput = AddPrunedLayerNodes(*layerNode, transformer, plan);
+            transformer.MapNodeOutput(layerNode->output, newOutput);
+            return true;
+        }
+
+        void PruneNode(const Node& node, ModelTransformer& transformer, const ChannelPruningPlan& plan)
+        {
+            if (TryPruneNode<float>(node, transformer, plan))
+            {
+                return;
+            }
+            if (TryPruneNode<double>(node, transformer, plan))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    ChannelPruningPlan GetChannelPruningPlan(const Model& model, double threshold, ChannelPruningCriterion criterion, const std::vector<std::vector<double>>& calibrationInputs)
+    {
+        ChannelPruningPlan plan;
+        PlanPruning<float>(model, threshold, criterion, calibrationInputs, plan);
+        PlanPruning<double>(model, threshold, criterion, calibrationInputs, plan);
+        return plan;
+    }
+
+    const OutputPortBase& AddPrunedLayers(const Node& node, ModelTransformer& transformer, const ChannelPruningPlan& plan)
+    {
+        if (auto floatNode = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<float>*>(&node))
+        {
+            return AddPrunedLayerNodes(*floatNode, transformer, plan);
+        }
+        if (auto doubleNode = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<double>*>(&node))
+        {
+            return AddPrunedLayerNodes(*doubleNode, transformer, plan);
+        }
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "AddPrunedLayers requires a neural network layer node");
+    }
+
+    //
+    // PruneChannelsTransformation methods
+    //
+    PruneChannelsTransformation::PruneChannelsTransformation(double threshold) :
+        _threshold(threshold),
+        _criterion(ChannelPruningCriterion::weights)
+    {
+    }
+
+    PruneChannelsTransformation::PruneChannelsTransformation(double threshold, const data::AutoSupervisedDataset& calibrationData) :
+        _threshold(threshold),
+        _criterion(ChannelPruningCriterion::activations)
+    {
+        _calibrationInputs.reserve(calibrationData.NumExamples());
+        for (size_t index = 0; index < calibrationData.NumExamples(); ++index)
+        {
+            _calibrationInputs.push_back(calibrationData.GetExample(index).GetDataVector().ToArray());
+        }
+    }
+
+    PruneChannelsTransformation::PruneChannelsTransformation(double threshold, std::vector<std::vector<double>> calibrationInputs) :
+        _threshold(threshold),
+        _criterion(ChannelPruningCriterion::activations),
+        _calibrationInputs(std::move(calibrationInputs))
+    {
+    }
+
+    Submodel PruneChannelsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        // First refine any NeuralNetworkPredictorNodes, so we can see their layers
+        auto refineNNPredictorFn = [](const model::Node& node) {
+            return IsNeuralNetworkPredictorNode(node) ? model::NodeAction::refine : model::NodeAction::compile;
+        };
+        model::TransformContext refineNNPredictorContext{ refineNNPredictorFn };
+        RefineTransformation refineTransformation;
+        auto result1 = refineTransformation.Transform(submodel, transformer, refineNNPredictorContext);
+
+        // Choose the channels to remove from each chain of layers
+        auto plan = GetChannelPruningPlan(result1.GetModel(), _threshold, _criterion, _calibrationInputs);
+
+        // Now rewrite the layers that lose channels, using an in-place transformation
+        auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(result1.GetInputs()));
+        model::Model destModel = result1.GetModel().ShallowCopy();
+        return transformer.TransformSubmodelOnto(result1, destModel, onto, context, [&plan](const Node& node, ModelTransformer& transformer) {
+            PruneNode(node, transformer, plan);
+        });
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeLayersTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeLayersTransformation.h"
+
+#include <model/include/InputNode.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/RefineTransformation.h>
+
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
+#include <nodes/include/MatrixVectorProductNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
+#include <nodes/include/QuantizedMatrixVectorProductNode.h>
+#include <nodes/include/ReorderDataNode.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        // Largest absolute value seen on the input of each quantizable node during calibration
+        using InputRanges = std::unordered_map<const Node*, double>;
+
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        bool IsNeuralNetworkPredictorNode(const Node& node)
+        {
+            return (node.GetRuntimeTypeName().find("NeuralNetworkPredictorNode") == 0);
+        }
+
+        // Returns the input port of the node if we know how to quantize it, else `nullptr`
+        template <typename ValueType>
+        const InputPort<ValueType>* GetQuantizableInput(const Node& node)
+        {
+            // Depthwise-separable convolutions have too little work per input value to be worth quantizing
+            if (auto convolutionalNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node))
+            {
+                return convolutionalNode->GetLayer().IsDepthwiseSeparable() ? nullptr : &convolutionalNode->input;
+            }
+            if (auto fullyConnectedNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node))
+            {
+                return &fullyConnectedNode->input;
+            }
+            if (auto rowMajorNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>*>(&node))
+            {
+                return &rowMajorNode->input;
+            }
+            if (auto columnMajorNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::columnMajor>*>(&node))
+            {
+                return &columnMajorNode->input;
+            }
+            return nullptr;
+        }
+
+        template <typename ValueType>
+        nodes::QuantizedMatrix<ValueType> QuantizeNodeWeights(const Node& node)
+        {
+            if (auto fullyConnectedNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node))
+            {
+                return nodes::QuantizeMatrix(fullyConnectedNode->GetLayer().GetWeights().GetConstReference());
+            }
+            if (auto rowMajorNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>*>(&node))
+            {
+                return nodes::QuantizeMatrix(rowMajorNode->GetProjectionMatrix().GetConstReference());
+            }
+            auto columnMajorNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::columnMajor>*>(&node);
+            return nodes::QuantizeMatrix(columnMajorNode->GetProjectionMatrix().GetConstReference());
+        }
+
+        // Reshapes the filters into a matrix with one filter per row, in (row, column, channel) order, and quantizes it
+        template <typename ValueType>
+        nodes::QuantizedMatrix<ValueType> QuantizeFilterWeights(const predictors::neural::ConvolutionalLayer<ValueType>& layer)
+        {
+            const auto& weights = layer.GetWeights();
+            const auto filterSize = weights.NumColumns();
+            const auto numFilters = weights.NumRows() / filterSize;
+            const auto fieldRowSize = filterSize * weights.NumChannels();
+            math::RowMatrix<ValueType> weightsMatrix(numFilters, filterSize * fieldRowSize);
+            auto flattened = weights.ReferenceAsMatrix();
+            for (size_t filter = 0; filter < numFilters; ++filter)
+            {
+                for (size_t row = 0; row < filterSize; ++row)
+                {
+                    auto weightsVector = flattened.GetMajorVector(filter * filterSize + row);
+                    for (size_t i = 0; i < weightsVector.Size(); ++i)
+                    {
+                        weightsMatrix(filter, row * fieldRowSize + i) = weightsVector[i];
+                    }
+                }
+            }
+            return nodes::QuantizeMatrix(weightsMatrix.GetConstReference());
+        }
+
+        // Replaces a convolutional layer with a quantized convolution, reordering its input and output as needed
+        template <typename ValueType>
+        const OutputPort<ValueType>& AddQuantizedConvolution(const nodes::ConvolutionalLayerNode<ValueType>& node, const OutputPort<ValueType>& newInput, ModelTransformer& transformer, ValueType inputScale)
+        {
+            const auto& layer = node.GetLayer();
+            const auto& originalInputLayout = node.GetInputMemoryLayout();
+            const auto originalOutputLayout = node.GetOutputMemoryLayout();
+            const auto convInputLayout = originalInputLayout.ReorderedCopy({ utilities::RowMajorTensorOrder });
+            const PortMemoryLayout convOutputLayout(originalOutputLayout.GetLogicalDimensionActiveSize());
+            const auto filterSize = static_cast<int>(layer.GetWeights().NumColumns());
+            const auto stride = static_cast<int>(layer.GetConvolutionalParameters().stride);
+
+            auto preConvReorderNode = transformer.AddNode<nodes::ReorderDataNode<ValueType>>(newInput, originalInputLayout, convInputLayout);
+            auto convNode = transformer.AddNode<nodes::QuantizedConvolutionNode<ValueType>>(preConvReorderNode->output, convInputLayout, convOutputLayout, QuantizeFilterWeights(layer), filterSize, stride, inputScale);
+            convNode->GetMetadata() = node.GetMetadata();
+            auto postConvReorderNode = transformer.AddNode<nodes::ReorderDataNode<ValueType>>(convNode->output, convOutputLayout, originalOutputLayout);
+            return postConvReorderNode->output;
+        }
+
+        template <typename ValueType>
+        void CalibrateInputRanges(const Model& model, const std::vector<std::vector<double>>& calibrationInputs, InputRanges& ranges)
+        {
+            auto inputNodes = model.GetNodesByType<InputNode<ValueType>>();
+            if (inputNodes.size() != 1)
+            {
+                return;
+            }
+
+            std::vector<std::pair<const Node*, const InputPort<ValueType>*>> quantizableNodes;
+            auto iter = model.GetNodeIterator();
+            while (iter.IsValid())
+            {
+                auto node = iter.Get();
+                if (auto input = GetQuantizableInput<ValueType>(*node))
+                {
+                    quantizableNodes.emplace_back(node, input);
+                }
+                iter.Next();
+            }
+
+            if (quantizableNodes.empty())
+            {
+                return;
+            }
+
+            auto inputNode = const_cast<InputNode<ValueType>*>(inputNodes[0]);
+            for (const auto& calibrationInput : calibrationInputs)
+            {
+                std::vector<ValueType> inputValues(inputNode->Size());
+                std::transform(calibrationInput.begin(), calibrationInput.begin() + std::min(calibrationInput.size(), inputValues.size()), inputValues.begin(), [](double x) { return static_cast<ValueType>(x); });
+                inputNode->SetInput(inputValues);
+
+                for (const auto& [node, input] : quantizableNodes)
+                {
+                    auto& range = ranges[node];
+                    for (auto value : model.ComputeOutput(input->GetReferencedPort()))
+                    {
+                        range = std::max(range, static_cast<double>(std::abs(value)));
+                    }
+                }
+            }
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryQuantizeNode(const Node& node, ModelTransformer& transformer, const InputRanges& ranges)
+        {
+            auto input = GetQuantizableInput<ValueType>(node);
+            if (input == nullptr)
+            {
+                return false;
+            }
+
+            auto range = ranges.find(&node);
+            if (range == ranges.end())
+            {
+                Log() << "No calibration data for node " << node.GetId() << ", not quantizing it" << EOL;
+                return false;
+            }
+
+            // An input that was always zero during calibration can use any scale
+            auto inputScale = range->second > 0 ? static_cast<ValueType>(range->second / 127) : static_cast<ValueType>(1);
+
+            Log() << "Quantizing node " << node.GetId() << " with input scale " << inputScale << EOL;
+            const auto& newInput = transformer.GetCorrespondingInputs(*input);
+            const auto& output = static_cast<const OutputPort<ValueType>&>(*node.GetOutputPort(0));
+            if (auto convolutionalNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node))
+            {
+                transformer.MapNodeOutput(output, AddQuantizedConvolution(*convolutionalNode, newInput, transformer, inputScale));
+                return true;
+            }
+
+            auto newNode = transformer.AddNode<nodes::QuantizedMatrixVectorProductNode<ValueType>>(newInput, QuantizeNodeWeights<ValueType>(node), inputScale);
+            newNode->GetMetadata() = node.GetMetadata();
+            transformer.MapNodeOutput(output, newNode->output);
+            return true;
+        }
+
+        void QuantizeNode(const Node& node, ModelTransformer& transformer, const InputRanges& ranges)
+        {
+            if (TryQuantizeNode<float>(node, transformer, ranges))
+            {
+                return;
+            }
+            if (TryQuantizeNode<double>(node, transformer, ranges))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    //
+    // QuantizeLayersTransformation methods
+    //
+    QuantizeLayersTransformation::QuantizeLayersTransformation(const data::AutoSupervisedDataset& calibrationData)
+    {
+        _calibrationInputs.reserve(calibrationData.NumExamples());
+        for (size_t index = 0; index < calibrationData.NumExamples(); ++index)
+        {
+            _calibrationInputs.push_back(calibrationData.GetExample(index).GetDataVector().ToArray());
+        }
+    }
+
+    QuantizeLayersTransformation::QuantizeLayersTransformation(std::vector<std::vector<double>> calibrationInputs) :
+        _calibrationInputs(std::move(calibrationInputs))
+    {
+    }
+
+    Submodel QuantizeLayersTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        // First refine any NeuralNetworkPredictorNodes, so we can see their layers
+        auto refineNNPredictorFn = [](const model::Node& node) {
+            return IsNeuralNetworkPredictorNode(node) ? model::NodeAction::refine : model::NodeAction::compile;
+        };
+        model::TransformContext refineNNPredictorContext{ refineNNPredictorFn };
+        RefineTransformation refineTransformation;
+        auto result1 = refineTransformation.Transform(submodel, transformer, refineNNPredictorContext);
+
+        // Find the range of the inputs to each layer on the calibration data
+        InputRanges ranges;
+        CalibrateInputRanges<float>(result1.GetModel(), _calibrationInputs, ranges);
+        CalibrateInputRanges<double>(result1.GetModel(), _calibrationInputs, ranges);
+
+        // Now replace the layers with quantized ones, using an in-place transformation
+        auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(result1.GetInputs()));
+        model::Model destModel = result1.GetModel().ShallowCopy();
+        return transformer.TransformSubmodelOnto(result1, destModel, onto, context, [&ranges](const Node& node, ModelTransformer& transformer) {
+            QuantizeNode(node, transformer, ranges);
+        });
+    }
+} // namespace passes
+} // namespace ell
@@ -7,7 +7,12 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SetConvolutionMethodTransformation.h"
+#include "ConvolutionCostDatabase.h"
 
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputNode.h>
+#include <model/include/Map.h>
 #include <model/include/ModelTransformer.h>
 #include <model/include/RefineTransformation.h>
 
@@ -16,9 +21,11 @@
 #include <predictors/neural/include/ConvolutionalLayer.h>
 
 #include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/StlVectorUtil.h>
 
+#include <string>
 #include <vector>
 
 namespace ell
@@ -64,13 +71,46 @@ namespace passes
                 return predictors::neural::ConvolutionMethod::diagonal;
             case model::PreferredConvolutionMethod::winograd:
                 return predictors::neural::ConvolutionMethod::winograd;
+            case model::PreferredConvolutionMethod::depthwise:
+                return predictors::neural::ConvolutionMethod::depthwise;
+            case model::PreferredConvolutionMethod::blocked:
+                return predictors::neural::ConvolutionMethod::blocked;
             default:
                 throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument);
             }
         }
 
-        bool IsMethodCompatible(predictors::neural::ConvolutionMethod method, const predictors::neural::ConvolutionalParameters& convolutionalParameters)
+        model::PreferredConvolutionMethod GetPreferredConvolutionMethod(predictors::neural::ConvolutionMethod method)
         {
+            switch (method)
+            {
+            case predictors::neural::ConvolutionMethod::unrolled:
+                return model::PreferredConvolutionMethod::unrolled;
+            case predictors::neural::ConvolutionMethod::simple:
+                return model::PreferredConvolutionMethod::simple;
+            case predictors::neural::ConvolutionMethod::diagonal:
+                return model::PreferredConvolutionMethod::diagonal;
+            case predictors::neural::ConvolutionMethod::winograd:
+                return model::PreferredConvolutionMethod::winograd;
+            case predictors::neural::ConvolutionMethod::depthwise:
+                return model::PreferredConvolutionMethod::depthwise;
+            case predictors::neural::ConvolutionMethod::blocked:
+                return model::PreferredConvolutionMethod::blocked;
+            default:
+                return model::PreferredConvolutionMethod::automatic;
+            }
+        }
+
+        bool IsMethodCompatible(predictors::neural::ConvolutionMethod method, const predictors::neural::ConvolutionalParameters& convolutionalParameters, bool isDepthwiseSeparable)
+        {
+            if (method == predictors::neural::ConvolutionMethod::depthwise)
+            {
+                return isDepthwiseSeparable;
+            }
+            if (method == predictors::neural::ConvolutionMethod::blocked)
+            {
+                return !isDepthwiseSeparable;
+            }
             if (method == predictors::neural::ConvolutionMethod::winograd)
             {
                 if (convolutionalParameters.stride != 1)
@@ -103,7 +143,7 @@ namespace passes
 
             auto method = GetConvolutionMethod(preferredMethod);
             convolutionalParameters.method = method;
-            if (!IsMethodCompatible(method, convolutionalParameters))
+            if (!IsMethodCompatible(method, convolutionalParameters, layer.IsDepthwiseSeparable()))
             {
                 Log() << "Invalid convolution method: " << static_cast<int>(method) << " for node " << thisNode->GetId() << std::endl;
                 return false;
@@ -119,8 +159,107 @@ namespace passes
             return true;
         }
 
-        void SetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod)
+        // Settings for choosing the convolution method from measured costs
+        struct AutotuneSettings
+        {
+            ConvolutionCostDatabase* database = nullptr; // no database: just use the preferred method
+            bool autotune = false; // measure any methods missing from the database
+            std::string deviceName;
+            MapCompilerOptions compilerSettings;
+        };
+
+        constexpr int numAutotuneIterations = 10;
+
+        // Returns the average time, in milliseconds, of the given convolution method on the host, as measured by the model profiler
+        template <typename ValueType>
+        double MeasureConvolutionMethod(const predictors::neural::ConvolutionalLayer<ValueType>& layer, predictors::neural::ConvolutionMethod method, const MapCompilerOptions& compilerSettings)
+        {
+            auto convolutionalParameters = layer.GetConvolutionalParameters();
+            convolutionalParameters.method = method;
+            predictors::neural::ConvolutionalLayer<ValueType> newLayer = { layer.GetLayerParameters(), convolutionalParameters, layer.GetWeights() };
+
+            model::Model model;
+            auto inputNode = model.AddNode<model::InputNode<ValueType>>(layer.GetInputShape().Size());
+            auto convNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, newLayer);
+            model::Map map(model, { { "input", inputNode } }, { { "output", convNode->output } });
+
+            // Compile just this layer with the method fixed, and with profiling turned on
+            auto settings = compilerSettings;
+            settings.profile = true;
+            settings.mapFunctionName = "autotune";
+            settings.moduleName = "autotune";
+            model::ModelOptimizerOptions optimizerOptions;
+            optimizerOptions["preferredConvolutionMethod"] = GetPreferredConvolutionMethod(method);
+            model::IRMapCompiler compiler(settings, optimizerOptions);
+            auto compiledMap = compiler.Compile(map);
+
+            std::vector<ValueType> input(inputNode->Size());
+            for (size_t index = 0; index < input.size(); ++index)
+            {
+                input[index] = static_cast<ValueType>(index % 17) / 17;
+            }
+            compiledMap.SetInputValue(0, input);
+
+            // Warm up caches before measuring
+            compiledMap.ComputeOutput<ValueType>(0);
+            compiledMap.ResetModelProfilingInfo();
+            for (int iteration = 0; iteration < numAutotuneIterations; ++iteration)
+            {
+                compiledMap.ComputeOutput<ValueType>(0);
+            }
+
+            auto counters = compiledMap.GetModelPerformanceCounters();
+            return counters->count > 0 ? counters->totalTime / counters->count : 0.0;
+        }
+
+        // Returns 'true' if the node is a ConvolutionalLayerNode<ValueType> and we found a measured method for it
+        template <typename ValueType>
+        bool TryGetFastestConvolutionMethod(const model::Node& node, const AutotuneSettings& autotuneSettings, model::PreferredConvolutionMethod& preferredMethod)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            auto& database = *autotuneSettings.database;
+            const auto& layer = thisNode->GetLayer();
+            auto description = GetDescription(layer);
+            if (autotuneSettings.autotune)
+            {
+                for (auto method : { predictors::neural::ConvolutionMethod::unrolled, predictors::neural::ConvolutionMethod::simple, predictors::neural::ConvolutionMethod::diagonal, predictors::neural::ConvolutionMethod::winograd, predictors::neural::ConvolutionMethod::depthwise, predictors::neural::ConvolutionMethod::blocked })
+                {
+                    if (!IsMethodCompatible(method, layer.GetConvolutionalParameters(), layer.IsDepthwiseSeparable()) || database.HasCostMeasurement(autotuneSettings.deviceName, description, method))
+                    {
+                        continue;
+                    }
+
+                    auto time = MeasureConvolutionMethod(layer, method, autotuneSettings.compilerSettings);
+                    Log() << "Measured convolution method " << static_cast<int>(method) << " for node " << thisNode->GetId() << ": " << time << " ms" << EOL;
+                    database.AddCostMeasurement(autotuneSettings.deviceName, description, method, time);
+                }
+            }
+
+            predictors::neural::ConvolutionMethod fastestMethod;
+            if (!database.TryGetFastestMethod(autotuneSettings.deviceName, description, fastestMethod))
+            {
+                return false;
+            }
+
+            preferredMethod = GetPreferredConvolutionMethod(fastestMethod);
+            return true;
+        }
+
+        void SetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod, const AutotuneSettings& autotuneSettings)
         {
+            if (preferredMethod == model::PreferredConvolutionMethod::automatic && autotuneSettings.database != nullptr)
+            {
+                if (!TryGetFastestConvolutionMethod<float>(node, autotuneSettings, preferredMethod))
+                {
+                    TryGetFastestConvolutionMethod<double>(node, autotuneSettings, preferredMethod);
+                }
+            }
+
             if (preferredMethod != model::PreferredConvolutionMethod::automatic)
             {
                 if (TrySetConvolutionMethod<float>(node, transformer, preferredMethod))
@@ -154,10 +293,45 @@ namespace passes
         RefineTransformation refineTransformation;
         auto result1 = refineTransformation.Transform(submodel, transformer, refineNNPredictorContext);
 
+        // Load the cost database, if there is one, so we can pick the fastest method for layers without a preferred method
+        ConvolutionCostDatabase database;
+        AutotuneSettings autotuneSettings;
+        std::string databaseFilename;
+        auto compiler = context.GetCompiler();
+        if (compiler)
+        {
+            auto optimizerOptions = compiler->GetModelOptimizerOptions(result1.GetModel());
+            databaseFilename = optimizerOptions.GetEntry<std::string>("convolutionCostDatabase", "");
+            autotuneSettings.autotune = optimizerOptions.GetEntry<bool>("autotuneConvolutionMethod", false);
+            autotuneSettings.compilerSettings = compiler->GetMapCompilerOptions(result1.GetModel());
+            autotuneSettings.deviceName = autotuneSettings.compilerSettings.compilerSettings.targetDevice.deviceName;
+            if (autotuneSettings.deviceName.empty())
+            {
+                autotuneSettings.deviceName = "host";
+            }
+
+            // The measurements are taken by running JIT-compiled code, so they only make sense for the host
+            if (autotuneSettings.autotune && autotuneSettings.deviceName != "host")
+            {
+                Log() << "Can't autotune convolution methods for device " << autotuneSettings.deviceName << ", using existing measurements only" << EOL;
+                autotuneSettings.autotune = false;
+            }
+
+            if (!databaseFilename.empty())
+            {
+                if (utilities::IsFileReadable(databaseFilename))
+                {
+                    database = LoadConvolutionCostDatabase(databaseFilename);
+                }
+                autotuneSettings.database = &database;
+            }
+        }
+        auto numMeasurements = database.NumMeasurements();
+
         // Now set the method on any ConvolutionalLayerNodes, using an in-place transformation
         auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(result1.GetInputs()));
         model::Model destModel = result1.GetModel().ShallowCopy();
-        auto result2 = transformer.TransformSubmodelOnto(result1, destModel, onto, context, [context](const Node& node, ModelTransformer& transformer) {
+        auto result2 = transformer.TransformSubmodelOnto(result1, destModel, onto, context, [context, &autotuneSettings](const Node& node, ModelTransformer& transformer) {
             model::PreferredConvolutionMethod preferredMethod = model::PreferredConvolutionMethod::automatic;
             auto compiler = context.GetCompiler();
             if (compiler)
@@ -165,9 +339,15 @@ namespace passes
                 preferredMethod = compiler->GetModelOptimizerOptions(node).GetEntry<PreferredConvolutionMethod>("preferredConvolutionMethod", PreferredConvolutionMethod::automatic);
             }
 
-            SetConvolutionMethod(node, transformer, preferredMethod);
+            SetConvolutionMethod(node, transformer, preferredMethod, autotuneSettings);
         });
 
+        // Save any new measurements for later compiles
+        if (autotuneSettings.database != nullptr && database.NumMeasurements() != numMeasurements)
+        {
+            SaveConvolutionCostDatabase(database, databaseFilename);
+        }
+
         // Finally, refine any ConvolutionalLayerNodes
         auto refineConvLayerFn = [](const model::Node& node) {
             return IsConvolutionalLayerNode(node) ? model::NodeAction::refine : model::NodeAction::compile;
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparsifyMatrixVectorProductsTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SparsifyMatrixVectorProductsTransformation.h"
+
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
+#include <nodes/include/MatrixVectorProductNode.h>
+#include <nodes/include/SparseMatrixVectorProductNode.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        const double defaultDensityThreshold = 0.25;
+
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        template <typename ValueType, math::MatrixLayout layout>
+        double GetDensity(math::ConstMatrixReference<ValueType, layout> matrix)
+        {
+            size_t numNonzeros = 0;
+            for (size_t i = 0; i < matrix.NumRows(); ++i)
+            {
+                for (size_t j = 0; j < matrix.NumColumns(); ++j)
+                {
+                    numNonzeros += (matrix(i, j) != 0) ? 1 : 0;
+                }
+            }
+            return matrix.Size() == 0 ? 1.0 : static_cast<double>(numNonzeros) / matrix.Size();
+        }
+
+        // Replaces a matrix-vector product with a sparse one, if its matrix is sparse enough
+        template <typename ValueType, math::MatrixLayout layout>
+        bool TrySparsify(const Node& node, const InputPort<ValueType>& input, math::ConstMatrixReference<ValueType, layout> matrix, double densityThreshold, ModelTransformer& transformer)
+        {
+            if (input.Size() != matrix.NumColumns())
+            {
+                return false;
+            }
+
+            auto density = GetDensity(matrix);
+            if (density >= densityThreshold)
+            {
+                return false;
+            }
+
+            const auto& newInput = transformer.GetCorrespondingInputs(input);
+            auto newNode = transformer.AddNode<nodes::SparseMatrixVectorProductNode<ValueType>>(newInput, nodes::GetSparseMatrix(matrix));
+            newNode->GetMetadata() = node.GetMetadata();
+
+            Log() << "Replacing node " << node.GetRuntimeTypeName() << " [id = " << node.GetId().ToString() << "] with a sparse matrix-vector product, matrix density " << density << EOL;
+            const auto& output = static_cast<const OutputPort<ValueType>&>(*node.GetOutputPort(0));
+            transformer.MapNodeOutput(output, newNode->output);
+            return true;
+        }
+
+        // returns 'true' if we replaced the node, else 'false'
+        template <typename ValueType>
+        bool TrySparsifyNode(const Node& node, double densityThreshold, ModelTransformer& transformer)
+        {
+            if (auto fullyConnectedNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node))
+            {
+                return TrySparsify(node, fullyConnectedNode->input, fullyConnectedNode->GetLayer().GetWeights().GetConstReference(), densityThreshold, transformer);
+            }
+            if (auto rowMajorNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>*>(&node))
+            {
+                return TrySparsify(node, rowMajorNode->input, rowMajorNode->GetProjectionMatrix().GetConstReference(), densityThreshold, transformer);
+            }
+            if (auto columnMajorNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::columnMajor>*>(&node))
+            {
+                return TrySparsify(node, columnMajorNode->input, columnMajorNode->GetProjectionMatrix().GetConstReference(), densityThreshold, transformer);
+            }
+            if (auto multiplyNode = dynamic_cast<const nodes::MatrixVectorMultiplyNode<ValueType>*>(&node))
+            {
+                // Refined layers multiply by a constant matrix
+                auto matrixNode = dynamic_cast<const nodes::ConstantNode<ValueType>*>(multiplyNode->inputMatrix.GetReferencedPort().GetNode());
+                if (matrixNode == nullptr)
+                {
+                    return false;
+                }
+
+                const auto& values = matrixNode->GetValues();
+                const auto m = multiplyNode->GetNumRows();
+                const auto n = multiplyNode->GetNumColumns();
+                const auto stride = multiplyNode->GetMatrixStride();
+                if (m == 0 || n == 0 || stride < n || values.size() < (m - 1) * stride + n)
+                {
+                    return false;
+                }
+                math::ConstRowMatrixReference<ValueType> matrix(values.data(), m, n, stride);
+                return TrySparsify(node, multiplyNode->inputVector, matrix, densityThreshold, transformer);
+            }
+            return false;
+        }
+    } // namespace
+
+    Submodel SparsifyMatrixVectorProductsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto compiler = context.GetCompiler();
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        return transformer.TransformSubmodelOnto(submodel, onto, context, [compiler](const Node& node, ModelTransformer& transformer) {
+            auto enabled = compiler == nullptr || compiler->GetModelOptimizerOptions(node).GetEntry<bool>("sparsifyMatrixVectorProducts", true);
+            auto densityThreshold = compiler == nullptr ? defaultDensityThreshold : compiler->GetModelOptimizerOptions(node).GetEntry<double>("sparseDensityThreshold", defaultDensityThreshold);
+            if (enabled && (TrySparsifyNode<float>(node, densityThreshold, transformer) || TrySparsifyNode<double>(node, densityThreshold, transformer)))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        });
+    }
+} // namespace passes
+} // namespace ell
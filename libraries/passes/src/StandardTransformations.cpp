@@ -7,9 +7,16 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "StandardTransformations.h"
+#include "EliminateCommonSubexpressionsTransformation.h"
+#include "EliminateRedundantConversionsTransformation.h"
+#include "FoldConstantsTransformation.h"
+#include "FuseElementwiseOperationsTransformation.h"
 #include "FuseLinearOperationsTransformation.h"
+#include "FuseSoftmaxTopKTransformation.h"
 #include "OptimizeReorderDataNodesTransformation.h"
 #include "SetConvolutionMethodTransformation.h"
+#include "SparsifyMatrixVectorProductsTransformation.h"
+#include "StreamingConvolutionTransformation.h"
 
 #include <model/include/RefineTransformation.h>
 
@@ -34,7 +41,14 @@ namespace passes
         {
             registry.AddTransformation<SetConvolutionMethodTransformation>();
             registry.AddTransformation<model::RefineTransformation>();
+            registry.AddTransformation<FoldConstantsTransformation>();
+            registry.AddTransformation<EliminateCommonSubexpressionsTransformation>();
+            registry.AddTransformation<SparsifyMatrixVectorProductsTransformation>();
+            registry.AddTransformation<StreamingConvolutionTransformation>();
             registry.AddTransformation<FuseLinearOperationsTransformation>();
+            registry.AddTransformation<FuseElementwiseOperationsTransformation>();
+            registry.AddTransformation<FuseSoftmaxTopKTransformation>();
+            registry.AddTransformation<EliminateRedundantConversionsTransformation>();
             registry.AddTransformation<OptimizeReorderDataNodesTransformation>();
             done = true;
         }
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StreamingConvolutionTransformation.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StreamingConvolutionTransformation.h"
+
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/BufferNode.h>
+#include <nodes/include/CausalConvolutionNode.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return utilities::TransformVector(inputs.begin(), inputs.end(), [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        // returns 'true' if we replaced the node, else 'false'
+        template <typename ValueType>
+        bool TryMakeStreaming(const Node& node, ModelTransformer& transformer)
+        {
+            auto convolutionNode = dynamic_cast<const nodes::CausalConvolutionNode<ValueType>*>(&node);
+            if (convolutionNode == nullptr || convolutionNode->GetNumInputFrames() == convolutionNode->GetFilterSize())
+            {
+                return false;
+            }
+
+            // The window must advance by exactly one frame per step, so that only the newest output frame is new
+            const auto& newInput = transformer.GetCorrespondingInputs(convolutionNode->input);
+            auto bufferNode = dynamic_cast<const nodes::BufferNode<ValueType>*>(newInput.GetNode());
+            const auto frameSize = convolutionNode->GetFrameSize();
+            if (bufferNode == nullptr || bufferNode->input.Size() != frameSize)
+            {
+                return false;
+            }
+
+            const auto& frame = bufferNode->input.GetReferencedPort();
+            auto window = transformer.AddNode<nodes::BufferNode<ValueType>>(frame, convolutionNode->GetFilterSize() * frameSize);
+            auto newestOutput = transformer.AddNode<nodes::CausalConvolutionNode<ValueType>>(window->output, frameSize, convolutionNode->GetFilterSize(), convolutionNode->GetWeights());
+            auto outputs = transformer.AddNode<nodes::BufferNode<ValueType>>(newestOutput->output, convolutionNode->output.Size());
+            newestOutput->GetMetadata() = node.GetMetadata();
+
+            Log() << "Replacing node " << node.GetRuntimeTypeName() << " [id = " << node.GetId().ToString() << "] with a streaming convolution over " << convolutionNode->GetFilterSize() << " of " << convolutionNode->GetNumInputFrames() << " frames" << EOL;
+            transformer.MapNodeOutput(convolutionNode->output, outputs->output);
+            return true;
+        }
+    } // namespace
+
+    Submodel StreamingConvolutionTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto compiler = context.GetCompiler();
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        return transformer.TransformSubmodelOnto(submodel, onto, context, [compiler](const Node& node, ModelTransformer& transformer) {
+            auto enabled = compiler == nullptr || compiler->GetModelOptimizerOptions(node).GetEntry<bool>("streamingConvolution", true);
+            if (enabled && (TryMakeStreaming<float>(node, transformer) || TryMakeStreaming<double>(node, transformer)))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        });
+    }
+} // namespace passes
+} // namespace ell
@@ -9,6 +9,12 @@
 #pragma once
 
 void TestFuseLinearOpsPass();
+void TestFuseElementwiseOpsPass();
+void TestFuseElementwiseOpsIntoMatrixProduct();
+void TestFoldConstantsPass();
+void TestEliminateCommonSubexpressionsPass();
+void TestFuseSoftmaxTopKPass();
+void TestEliminateRedundantConversionsPass();
 
 void TestOptimizeReorderDataNodes1();
 void TestOptimizeReorderDataNodes2();
@@ -16,4 +16,13 @@ void TestTransformations();
 
 void TestFuseLinearOperationsTransformation();
 void TestSetConvolutionMethodTransformation();
+void TestConvolutionCostDatabase();
+void TestLearnedCostModel();
 void TestOptimizeReorderDataNodesTransformation();
+void TestQuantizeLayersTransformation();
+void TestQuantizeConvolutionalLayers();
+void TestHalfPrecisionWeightsTransformation();
+void TestFixedPointDSPTransformation();
+void TestSparsifyMatrixVectorProductsTransformation();
+void TestStreamingConvolutionTransformation();
+void TestPruneChannelsTransformation();
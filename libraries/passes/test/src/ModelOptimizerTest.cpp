@@ -15,15 +15,24 @@
 #include <model/include/OptimizeModelTransformation.h>
 #include <model/include/PortMemoryLayout.h>
 
+#include <nodes/include/ActivationFunctions.h>
+#include <nodes/include/BinaryOperationNode.h>
 #include <nodes/include/BroadcastFunctionNode.h>
 #include <nodes/include/ConstantNode.h>
 #include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/DelayNode.h>
 #include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
 #include <nodes/include/ReorderDataNode.h>
+#include <nodes/include/SoftmaxLayerNode.h>
+#include <nodes/include/TopKNode.h>
+#include <nodes/include/TypeCastNode.h>
+#include <nodes/include/UnaryOperationNode.h>
 
 #include <passes/include/StandardTransformations.h>
 
 #include <predictors/neural/include/ConvolutionalLayer.h>
+#include <predictors/neural/include/SoftmaxLayer.h>
 
 #include <predictors/neural/include/ConvolutionalLayer.h>
 
@@ -219,6 +228,446 @@ void TestFuseLinearOpsPass()
     TestFuseLinearOpsPass({ linear, bias, bias });
 }
 
+template <typename ActivationFunctionType>
+void TestFuseElementwiseOpsPass(std::pair<bool, bool> functionInfo)
+{
+    using ValueType = float;
+    using FusedNodeType = nodes::BroadcastTernaryFunctionNode<ValueType, nodes::LinearActivationFunction<ValueType, ActivationFunctionType>>;
+
+    int numRows = 2;
+    int numColumns = 2;
+    int numChannels = 3;
+    model::PortMemoryLayout layout({ numRows, numColumns, numChannels });
+
+    // input -> linear function -> activation
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(numRows * numColumns * numChannels);
+    std::vector<ValueType> scaleValues(numChannels);
+    std::generate(scaleValues.begin(), scaleValues.end(), Increment<ValueType>(0.5f));
+    std::vector<ValueType> biasValues(numChannels);
+    std::generate(biasValues.begin(), biasValues.end(), Increment<ValueType>(-1.0f));
+    auto scaleNode = functionInfo.first ? model.AddNode<nodes::ConstantNode<ValueType>>(scaleValues, model::MemoryShape{ 1, 1, numChannels }) : model.AddNode<nodes::ConstantNode<ValueType>>();
+    auto biasNode = functionInfo.second ? model.AddNode<nodes::ConstantNode<ValueType>>(biasValues, model::MemoryShape{ 1, 1, numChannels }) : model.AddNode<nodes::ConstantNode<ValueType>>();
+    auto linearNode = model.AddNode<nodes::BroadcastLinearFunctionNode<ValueType>>(inputNode->output, layout, scaleNode->output, biasNode->output, 2, layout);
+    auto activationNode = model.AddNode<nodes::BroadcastUnaryFunctionNode<ValueType, ActivationFunctionType>>(linearNode->output, layout, layout);
+    model::Map map(model, { { "input", inputNode } }, { { "output", activationNode->output } });
+
+    // Generate test data, with both negative and positive values
+    std::vector<ValueType> testInput(numRows * numColumns * numChannels);
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-10.0f));
+
+    // Evaluate it pre-optimization
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ValueType>("output");
+
+    // Initialize transformation registry
+    passes::AddStandardTransformationsToRegistry();
+
+    // Optimize it
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["fuseElementwiseOperations"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+
+    model::Map optimizedMap(map);
+    model::TransformContext context(&compiler);
+    model::OptimizeModelTransformation optimizer;
+    optimizedMap.Transform(optimizer, context);
+    optimizedMap.Prune();
+
+#if PRINT_MODELS
+    PrintMap(optimizedMap);
+#endif
+
+    auto numFusedNodes = optimizedMap.GetModel().GetNodesByType<FusedNodeType>().size();
+    auto numLinearNodes = optimizedMap.GetModel().GetNodesByType<nodes::BroadcastLinearFunctionNode<ValueType>>().size();
+    testing::ProcessTest("Testing fused elementwise ops count", numFusedNodes == 1 && numLinearNodes == 0);
+
+    // Evaluate model post-optimization
+    optimizedMap.SetInputValue("input", testInput);
+    auto optimizedOutput = optimizedMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing fused elementwise ops result", testing::IsEqual(referenceOutput, optimizedOutput));
+
+    // Compile the model and evaluate it
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue("input", testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing compiled fused elementwise ops result", testing::IsEqual(referenceOutput, compiledOutput));
+}
+
+void TestFuseElementwiseOpsPass()
+{
+    using ValueType = float;
+    std::pair<bool, bool> linear = { true, true };
+    std::pair<bool, bool> scale = { true, false };
+    std::pair<bool, bool> bias = { false, true };
+
+    TestFuseElementwiseOpsPass<nodes::ReLUActivationFunction<ValueType>>(linear);
+    TestFuseElementwiseOpsPass<nodes::ReLUActivationFunction<ValueType>>(scale);
+    TestFuseElementwiseOpsPass<nodes::ReLUActivationFunction<ValueType>>(bias);
+    TestFuseElementwiseOpsPass<nodes::SigmoidActivationFunction<ValueType>>(linear);
+    TestFuseElementwiseOpsPass<nodes::TanhActivationFunction<ValueType>>(linear);
+    TestFuseElementwiseOpsPass<nodes::HardSigmoidActivationFunction<ValueType>>(bias);
+}
+
+void TestFuseElementwiseOpsIntoMatrixProduct(bool useMatrixVectorProduct)
+{
+    using ValueType = float;
+
+    // Big enough for the matrix-matrix product to be computed in blocks, with a partial block at the end
+    int numRows = useMatrixVectorProduct ? 2 : 44;
+    int numColumns = useMatrixVectorProduct ? 3 : 25;
+    int numChannels = 8;
+    int k = 4;
+    int numPixels = numRows * numColumns;
+    model::PortMemoryLayout layout({ numRows, numColumns, numChannels });
+
+    // input -> matrix product -> bias -> scale -> activation
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(useMatrixVectorProduct ? k : numPixels * k);
+    const model::OutputPort<ValueType>* productOutput = nullptr;
+    if (useMatrixVectorProduct)
+    {
+        std::vector<ValueType> weights(numPixels * numChannels * k);
+        std::generate(weights.begin(), weights.end(), Increment<ValueType>(-1.0f, 0.01f));
+        auto weightsNode = model.AddNode<nodes::ConstantNode<ValueType>>(weights);
+        productOutput = &model.AddNode<nodes::MatrixVectorMultiplyNode<ValueType>>(weightsNode->output, numPixels * numChannels, k, k, inputNode->output)->output;
+    }
+    else
+    {
+        std::vector<ValueType> weights(k * numChannels);
+        std::generate(weights.begin(), weights.end(), Increment<ValueType>(-1.0f, 0.125f));
+        auto weightsNode = model.AddNode<nodes::ConstantNode<ValueType>>(weights);
+        productOutput = &model.AddNode<nodes::MatrixMatrixMultiplyNode<ValueType>>(inputNode->output, numPixels, numChannels, k, k, weightsNode->output, numChannels, numChannels)->output;
+    }
+
+    std::vector<ValueType> scaleValues(numChannels);
+    std::generate(scaleValues.begin(), scaleValues.end(), Increment<ValueType>(0.5f));
+    std::vector<ValueType> biasValues(numChannels);
+    std::generate(biasValues.begin(), biasValues.end(), Increment<ValueType>(-2.0f));
+    auto biasNode = model.AddNode<nodes::ConstantNode<ValueType>>(biasValues, model::MemoryShape{ 1, 1, numChannels });
+    auto scaleNode = model.AddNode<nodes::ConstantNode<ValueType>>(scaleValues, model::MemoryShape{ 1, 1, numChannels });
+    auto noValuesNode = model.AddNode<nodes::ConstantNode<ValueType>>();
+    auto addBiasNode = model.AddNode<nodes::BroadcastLinearFunctionNode<ValueType>>(*productOutput, layout, noValuesNode->output, biasNode->output, 2, layout);
+    auto scaleOutputNode = model.AddNode<nodes::BroadcastLinearFunctionNode<ValueType>>(addBiasNode->output, layout, scaleNode->output, noValuesNode->output, 2, layout);
+    auto activationNode = model.AddNode<nodes::BroadcastUnaryFunctionNode<ValueType, nodes::LeakyReLUActivationFunction<ValueType>>>(scaleOutputNode->output, layout, layout);
+    model::Map map(model, { { "input", inputNode } }, { { "output", activationNode->output } });
+
+    // Generate test data, with both negative and positive values
+    std::vector<ValueType> testInput(inputNode->output.Size());
+    std::generate(testInput.begin(), testInput.end(), [index = 0]() mutable { return static_cast<ValueType>(index++ % 7 - 3); });
+
+    // Evaluate it pre-optimization
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ValueType>("output");
+
+    // Initialize transformation registry
+    passes::AddStandardTransformationsToRegistry();
+
+    // Optimize it
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["fuseElementwiseOperations"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+
+    model::Map optimizedMap(map);
+    model::TransformContext context(&compiler);
+    model::OptimizeModelTransformation optimizer;
+    optimizedMap.Transform(optimizer, context);
+    optimizedMap.Prune();
+
+#if PRINT_MODELS
+    PrintMap(optimizedMap);
+#endif
+
+    const auto& optimizedModel = optimizedMap.GetModel();
+    auto numProductNodes = optimizedModel.GetNodesByType<nodes::MatrixMatrixMultiplyNode<ValueType>>().size() + optimizedModel.GetNodesByType<nodes::MatrixVectorMultiplyNode<ValueType>>().size();
+    auto numLinearNodes = optimizedModel.GetNodesByType<nodes::BroadcastLinearFunctionNode<ValueType>>().size();
+    auto numActivationNodes = optimizedModel.GetNodesByType<nodes::BroadcastUnaryFunctionNode<ValueType, nodes::LeakyReLUActivationFunction<ValueType>>>().size();
+    testing::ProcessTest("Testing elementwise ops fused into matrix product count", numProductNodes == 1 && numLinearNodes == 0 && numActivationNodes == 0);
+
+    // Evaluate model post-optimization
+    optimizedMap.SetInputValue("input", testInput);
+    auto optimizedOutput = optimizedMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing elementwise ops fused into matrix product result", testing::IsEqual(referenceOutput, optimizedOutput, 1.0e-4f));
+
+    // Compile the model and evaluate it
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue("input", testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing compiled elementwise ops fused into matrix product result", testing::IsEqual(referenceOutput, compiledOutput, 1.0e-4f));
+}
+
+void TestFuseElementwiseOpsIntoMatrixProduct()
+{
+    TestFuseElementwiseOpsIntoMatrixProduct(false);
+    TestFuseElementwiseOpsIntoMatrixProduct(true);
+}
+
+void TestFoldConstantsPass()
+{
+    using ValueType = float;
+    constexpr int size = 6;
+
+    // input + (sqrt(a) * b) + delay(a): the sqrt and multiply only depend on constants, but the delay node has state
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(size);
+    std::vector<ValueType> aValues(size);
+    std::generate(aValues.begin(), aValues.end(), Increment<ValueType>(1.0f));
+    std::vector<ValueType> bValues(size);
+    std::generate(bValues.begin(), bValues.end(), Increment<ValueType>(-2.0f));
+    auto aNode = model.AddNode<nodes::ConstantNode<ValueType>>(aValues);
+    auto bNode = model.AddNode<nodes::ConstantNode<ValueType>>(bValues);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<ValueType>>(aNode->output, nodes::UnaryOperationType::sqrt);
+    auto scaledNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(sqrtNode->output, bNode->output, nodes::BinaryOperationType::multiply);
+    auto sumNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(inputNode->output, scaledNode->output, nodes::BinaryOperationType::add);
+    auto delayNode = model.AddNode<nodes::DelayNode<ValueType>>(aNode->output, 1);
+    auto outputNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(sumNode->output, delayNode->output, nodes::BinaryOperationType::add);
+    model::Map map(model, { { "input", inputNode } }, { { "output", outputNode->output } });
+
+    // Generate test data
+    std::vector<ValueType> testInput(size);
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(0.0f));
+
+    // Evaluate it pre-optimization, twice, so the delay node outputs its input
+    model::Map referenceMap(map);
+    referenceMap.SetInputValue("input", testInput);
+    referenceMap.ComputeOutput<ValueType>("output");
+    auto referenceOutput = referenceMap.ComputeOutput<ValueType>("output");
+
+    // Initialize transformation registry
+    passes::AddStandardTransformationsToRegistry();
+
+    // Optimize it
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["foldConstants"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+
+    model::Map optimizedMap(map);
+    model::TransformContext context(&compiler);
+    model::OptimizeModelTransformation optimizer;
+    optimizedMap.Transform(optimizer, context);
+    optimizedMap.Prune();
+
+#if PRINT_MODELS
+    PrintMap(optimizedMap);
+#endif
+
+    const auto& optimizedModel = optimizedMap.GetModel();
+    auto numUnaryNodes = optimizedModel.GetNodesByType<nodes::UnaryOperationNode<ValueType>>().size();
+    auto numBinaryNodes = optimizedModel.GetNodesByType<nodes::BinaryOperationNode<ValueType>>().size();
+    auto numConstantNodes = optimizedModel.GetNodesByType<nodes::ConstantNode<ValueType>>().size();
+    auto numDelayNodes = optimizedModel.GetNodesByType<nodes::DelayNode<ValueType>>().size();
+    testing::ProcessTest("Testing folded constants node count", numUnaryNodes == 0 && numBinaryNodes == 2 && numConstantNodes == 2);
+    testing::ProcessTest("Testing stateful nodes aren't folded", numDelayNodes == 1);
+
+    // Evaluate model post-optimization
+    optimizedMap.SetInputValue("input", testInput);
+    optimizedMap.ComputeOutput<ValueType>("output");
+    auto optimizedOutput = optimizedMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing folded constants result", testing::IsEqual(referenceOutput, optimizedOutput));
+
+    // Compile the model and evaluate it
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue("input", testInput);
+    compiledMap.ComputeOutput<ValueType>("output");
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing compiled folded constants result", testing::IsEqual(referenceOutput, compiledOutput));
+}
+
+void TestEliminateCommonSubexpressionsPass()
+{
+    using ValueType = float;
+    constexpr int size = 6;
+
+    // abs(input * a) + abs(input * a), with each side built separately
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(size);
+    std::vector<ValueType> scaleValues(size);
+    std::generate(scaleValues.begin(), scaleValues.end(), Increment<ValueType>(-2.0f));
+    std::vector<const model::OutputPort<ValueType>*> branches;
+    for (int i = 0; i < 2; ++i)
+    {
+        auto scaleNode = model.AddNode<nodes::ConstantNode<ValueType>>(scaleValues);
+        auto scaledNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(inputNode->output, scaleNode->output, nodes::BinaryOperationType::multiply);
+        auto absNode = model.AddNode<nodes::UnaryOperationNode<ValueType>>(scaledNode->output, nodes::UnaryOperationType::abs);
+        branches.push_back(&absNode->output);
+    }
+    auto sumNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(*branches[0], *branches[1], nodes::BinaryOperationType::add);
+    model::Map map(model, { { "input", inputNode } }, { { "output", sumNode->output } });
+
+    // Generate test data
+    std::vector<ValueType> testInput(size);
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(0.0f));
+
+    // Evaluate it pre-optimization
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ValueType>("output");
+
+    // Initialize transformation registry
+    passes::AddStandardTransformationsToRegistry();
+
+    // Optimize it
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["eliminateCommonSubexpressions"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+
+    model::Map optimizedMap(map);
+    model::TransformContext context(&compiler);
+    model::OptimizeModelTransformation optimizer;
+    optimizedMap.Transform(optimizer, context);
+    optimizedMap.Prune();
+
+#if PRINT_MODELS
+    PrintMap(optimizedMap);
+#endif
+
+    const auto& optimizedModel = optimizedMap.GetModel();
+    auto numUnaryNodes = optimizedModel.GetNodesByType<nodes::UnaryOperationNode<ValueType>>().size();
+    auto numBinaryNodes = optimizedModel.GetNodesByType<nodes::BinaryOperationNode<ValueType>>().size();
+    auto numConstantNodes = optimizedModel.GetNodesByType<nodes::ConstantNode<ValueType>>().size();
+    testing::ProcessTest("Testing common subexpressions node count", numUnaryNodes == 1 && numBinaryNodes == 2 && numConstantNodes == 1);
+
+    // Evaluate model post-optimization
+    optimizedMap.SetInputValue("input", testInput);
+    auto optimizedOutput = optimizedMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing common subexpressions result", testing::IsEqual(referenceOutput, optimizedOutput));
+
+    // Compile the model and evaluate it
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue("input", testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing compiled common subexpressions result", testing::IsEqual(referenceOutput, compiledOutput));
+}
+
+void TestFuseSoftmaxTopKPass()
+{
+    using ValueType = float;
+    using LayerType = predictors::neural::SoftmaxLayer<ValueType>;
+    constexpr int size = 20;
+    constexpr int k = 3;
+
+    // input -> softmax -> top-k
+    typename LayerType::TensorType layerInput(1, 1, size);
+    typename LayerType::LayerParameters layerParameters{ layerInput, predictors::neural::NoPadding(), { 1, 1, size }, predictors::neural::NoPadding() };
+    LayerType layer(layerParameters);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(size);
+    auto softmaxNode = model.AddNode<nodes::SoftmaxLayerNode<ValueType>>(inputNode->output, layer);
+    auto topKNode = model.AddNode<nodes::TopKNode<ValueType>>(softmaxNode->output, k);
+    model::Map map(model, { { "input", inputNode } }, { { "output", topKNode->val }, { "index", topKNode->argVal } });
+
+    // Generate test data, with a tie for the second-largest value
+    std::vector<ValueType> testInput(size);
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-4.0f));
+    std::reverse(testInput.begin() + 5, testInput.end());
+    testInput[2] = testInput[6];
+
+    // Evaluate it pre-optimization
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ValueType>("output");
+    auto referenceIndices = map.ComputeOutput<int>("index");
+
+    // Initialize transformation registry
+    passes::AddStandardTransformationsToRegistry();
+
+    // Optimize it
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["fuseSoftmaxTopK"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+
+    model::Map optimizedMap(map);
+    model::TransformContext context(&compiler);
+    model::OptimizeModelTransformation optimizer;
+    optimizedMap.Transform(optimizer, context);
+    optimizedMap.Prune();
+
+#if PRINT_MODELS
+    PrintMap(optimizedMap);
+#endif
+
+    const auto& optimizedModel = optimizedMap.GetModel();
+    auto numSoftmaxNodes = optimizedModel.GetNodesByType<nodes::SoftmaxLayerNode<ValueType>>().size();
+    auto topKNodes = optimizedModel.GetNodesByType<nodes::TopKNode<ValueType>>();
+    testing::ProcessTest("Testing fused softmax and top-k node count", numSoftmaxNodes == 0 && topKNodes.size() == 1 && topKNodes[0]->IsNormalized());
+
+    // Evaluate model post-optimization
+    optimizedMap.SetInputValue("input", testInput);
+    auto optimizedOutput = optimizedMap.ComputeOutput<ValueType>("output");
+    auto optimizedIndices = optimizedMap.ComputeOutput<int>("index");
+    testing::ProcessTest("Testing fused softmax and top-k result", testing::IsEqual(referenceOutput, optimizedOutput, 1e-6f) && testing::IsEqual(referenceIndices, optimizedIndices));
+
+    // Compile the model and evaluate it. Compiled maps have a single output, so only the probabilities are compared.
+    model::Map valueMap(model, { { "input", inputNode } }, { { "output", topKNode->val } });
+    auto compiledMap = compiler.Compile(valueMap);
+    compiledMap.SetInputValue("input", testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing compiled fused softmax and top-k result", testing::IsEqual(referenceOutput, compiledOutput, 1e-6f));
+}
+
+void TestEliminateRedundantConversionsPass()
+{
+    using ValueType = float;
+
+    // input -> reorder -> abs -> cast to double -> cast to float -> undo the reorder
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(model::MemoryShape{ 2, 3, 4 });
+    auto reorderNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(inputNode->output, model::DimensionOrder{ 2, 0, 1 });
+    auto absNode = model.AddNode<nodes::UnaryOperationNode<ValueType>>(reorderNode->output, nodes::UnaryOperationType::abs);
+    auto doubleNode = model.AddNode<nodes::TypeCastNode<ValueType, double>>(absNode->output);
+    auto floatNode = model.AddNode<nodes::TypeCastNode<double, ValueType>>(doubleNode->output);
+    auto undoReorderNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(floatNode->output, reorderNode->GetOutputMemoryLayout(), inputNode->output.GetMemoryLayout());
+    model::Map map(model, { { "input", inputNode } }, { { "output", undoReorderNode->output } });
+
+    // Generate test data
+    std::vector<ValueType> testInput(2 * 3 * 4);
+    std::generate(testInput.begin(), testInput.end(), Increment<ValueType>(-10.5f));
+
+    // Evaluate it pre-optimization
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ValueType>("output");
+
+    // Initialize transformation registry
+    passes::AddStandardTransformationsToRegistry();
+
+    // Optimize it
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["eliminateRedundantConversions"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+
+    model::Map optimizedMap(map);
+    model::TransformContext context(&compiler);
+    model::OptimizeModelTransformation optimizer;
+    optimizedMap.Transform(optimizer, context);
+    optimizedMap.Prune();
+
+#if PRINT_MODELS
+    PrintMap(optimizedMap);
+#endif
+
+    const auto& optimizedModel = optimizedMap.GetModel();
+    auto numReorderNodes = optimizedModel.GetNodesByType<nodes::ReorderDataNode<ValueType>>().size();
+    auto numCastNodes = optimizedModel.GetNodesByType<nodes::TypeCastNode<ValueType, double>>().size() + optimizedModel.GetNodesByType<nodes::TypeCastNode<double, ValueType>>().size();
+    auto numUnaryNodes = optimizedModel.GetNodesByType<nodes::UnaryOperationNode<ValueType>>().size();
+    testing::ProcessTest("Testing redundant conversions node count", numReorderNodes == 0 && numCastNodes == 0 && numUnaryNodes == 1);
+
+    // Evaluate model post-optimization
+    optimizedMap.SetInputValue("input", testInput);
+    auto optimizedOutput = optimizedMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing redundant conversions result", testing::IsEqual(referenceOutput, optimizedOutput));
+
+    // Compile the model and evaluate it
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue("input", testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>("output");
+    testing::ProcessTest("Testing compiled redundant conversions result", testing::IsEqual(referenceOutput, compiledOutput));
+}
+
 void TestOptimizeReorderDataNodes1()
 {
     using ValueType = float;
@@ -258,6 +707,7 @@ void TestOptimizeReorderDataNodes1()
     model::MapCompilerOptions settings;
     model::ModelOptimizerOptions optimizerOptions;
     optimizerOptions["fuseLinearFunctionNodes"] = true;
+    optimizerOptions["foldConstants"] = false;
     model::IRMapCompiler compiler(settings, optimizerOptions);
     auto compiledMap = compiler.Compile(map);
     auto newSize = compiledMap.GetModel().Size();
@@ -308,6 +758,7 @@ void TestOptimizeReorderDataNodes2()
     model::MapCompilerOptions settings;
     model::ModelOptimizerOptions optimizerOptions;
     optimizerOptions["fuseLinearFunctionNodes"] = true;
+    optimizerOptions["foldConstants"] = false;
     model::IRMapCompiler compiler(settings, optimizerOptions);
     auto compiledMap = compiler.Compile(map);
     auto newSize = compiledMap.GetModel().Size();
@@ -358,6 +809,7 @@ void TestOptimizeReorderDataNodes3()
     model::MapCompilerOptions settings;
     model::ModelOptimizerOptions optimizerOptions;
     optimizerOptions["fuseLinearFunctionNodes"] = true;
+    optimizerOptions["foldConstants"] = false;
     model::IRMapCompiler compiler(settings, optimizerOptions);
     auto compiledMap = compiler.Compile(map);
     auto newSize = compiledMap.GetModel().Size();
@@ -414,6 +866,7 @@ void TestOptimizeReorderDataNodes4()
     model::MapCompilerOptions settings;
     model::ModelOptimizerOptions optimizerOptions;
     optimizerOptions["fuseLinearFunctionNodes"] = true;
+    optimizerOptions["foldConstants"] = false;
     model::IRMapCompiler compiler(settings, optimizerOptions);
     auto compiledMap = compiler.Compile(map);
     auto newSize = compiledMap.GetModel().Size();
@@ -8,27 +8,55 @@
 
 #include "TransformationTest.h"
 
+#include <passes/include/ConvolutionCostDatabase.h>
+#include <passes/include/FixedPointDSPTransformation.h>
 #include <passes/include/FuseLinearOperationsTransformation.h>
 #include <passes/include/OptimizeReorderDataNodesTransformation.h>
+#include <passes/include/HalfPrecisionWeightsTransformation.h>
+#include <passes/include/LearnedCostModel.h>
+#include <passes/include/PruneChannelsTransformation.h>
+#include <passes/include/QuantizeLayersTransformation.h>
 #include <passes/include/SetConvolutionMethodTransformation.h>
+#include <passes/include/SparsifyMatrixVectorProductsTransformation.h>
+#include <passes/include/StreamingConvolutionTransformation.h>
 
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/InputNode.h>
+#include <model/include/ModelProfileData.h>
+#include <model/include/Submodel.h>
 #include <model/include/TransformContext.h>
 #include <model/include/Transformation.h>
 
+#include <nodes/include/ActivationLayerNode.h>
+#include <nodes/include/BatchNormalizationLayerNode.h>
 #include <nodes/include/BroadcastFunctionNode.h>
+#include <nodes/include/BufferNode.h>
+#include <nodes/include/CausalConvolutionNode.h>
 #include <nodes/include/ConstantNode.h>
 #include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/DCTNode.h>
+#include <nodes/include/FFTNode.h>
+#include <nodes/include/FilterBankNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
+#include <nodes/include/HammingWindowNode.h>
 #include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorProductNode.h>
 #include <nodes/include/ReorderDataNode.h>
+#include <nodes/include/SparseMatrixVectorProductNode.h>
+#include <nodes/include/UnaryOperationNode.h>
 
 #include <predictors/neural/include/ConvolutionalLayer.h>
+#include <predictors/neural/include/ReLUActivation.h>
 
 #include <testing/include/testing.h>
 
 #include <utilities/include/JsonArchiver.h>
 
+#include <cmath>
 #include <iostream>
+#include <memory>
+#include <sstream>
 
 #define PRINT_MODELS 0
 
@@ -131,7 +159,16 @@ void TestTransformations()
 {
     TestFuseLinearOperationsTransformation();
     TestSetConvolutionMethodTransformation();
+    TestConvolutionCostDatabase();
+    TestLearnedCostModel();
     TestOptimizeReorderDataNodesTransformation();
+    TestQuantizeLayersTransformation();
+    TestQuantizeConvolutionalLayers();
+    TestHalfPrecisionWeightsTransformation();
+    TestFixedPointDSPTransformation();
+    TestSparsifyMatrixVectorProductsTransformation();
+    TestStreamingConvolutionTransformation();
+    TestPruneChannelsTransformation();
 }
 
 void TestFuseLinearOperationsTransformation(std::vector<std::pair<bool, bool>> functionInfos)
@@ -230,7 +267,18 @@ void TestFuseLinearOperationsTransformation()
     TestFuseLinearOperationsTransformation({ linear, bias, bias });
 }
 
-void TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod convolutionMethod, std::string expectedNodeTypeName)
+namespace
+{
+using ConvolutionalLayerType = predictors::neural::ConvolutionalLayer<float>;
+
+// Keeps the input tensor alive, since the layer refers to it
+struct ConvolutionalLayerTestData
+{
+    std::unique_ptr<typename ConvolutionalLayerType::TensorType> inputWithPadding;
+    std::unique_ptr<ConvolutionalLayerType> layer;
+};
+
+ConvolutionalLayerTestData CreateConvolutionalLayer()
 {
     using namespace predictors::neural;
 
@@ -242,7 +290,9 @@ void TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod co
 
     const size_t inputPaddingSize = 1;
     const size_t outputPaddingSize = 0;
-    TensorType inputWithPadding(1 + 2 * inputPaddingSize, 2 + 2 * inputPaddingSize, 2);
+    ConvolutionalLayerTestData result;
+    result.inputWithPadding = std::make_unique<TensorType>(1 + 2 * inputPaddingSize, 2 + 2 * inputPaddingSize, 2);
+    auto& inputWithPadding = *result.inputWithPadding;
     TensorReferenceType input = inputWithPadding.GetSubTensor({ inputPaddingSize, inputPaddingSize, 0 }, { 1, 2, 2 });
     inputWithPadding.Fill(0);
     input(0, 0, 0) = 2;
@@ -257,12 +307,18 @@ void TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod co
     ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::automatic, 2 };
 
     TensorType weights(convolutionalParams.receptiveField * outputShape.NumChannels(), convolutionalParams.receptiveField, input.NumChannels());
-    ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
+    result.layer = std::make_unique<ConvolutionalLayerType>(parameters, convolutionalParams, weights);
+    return result;
+}
+
+bool HasConvolutionMethodNode(const model::ModelOptimizerOptions& optimizerOptions, std::string expectedNodeTypeName)
+{
+    auto testData = CreateConvolutionalLayer();
 
     // Create model
     model::Model model;
-    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
-    auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
+    auto inputNode = model.AddNode<model::InputNode<float>>(testData.inputWithPadding->Size());
+    auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<float>>(inputNode->output, *testData.layer);
 
     auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
 #if PRINT_MODELS
@@ -270,8 +326,6 @@ void TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod co
 #endif
 
     model::MapCompilerOptions settings;
-    model::ModelOptimizerOptions optimizerOptions;
-    optimizerOptions["preferredConvolutionMethod"] = convolutionMethod;
     model::IRMapCompiler compiler(settings, optimizerOptions);
     model::TransformContext context(&compiler);
     passes::SetConvolutionMethodTransformation setConvMethod;
@@ -282,7 +336,15 @@ void TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod co
     PrintModel(map.GetModel());
 #endif
 
-    testing::ProcessTest("Testing SetConvolutionMethodTransformation for " + expectedNodeTypeName, HasNodeWithTypeName(map.GetModel(), expectedNodeTypeName));
+    return HasNodeWithTypeName(map.GetModel(), expectedNodeTypeName);
+}
+} // namespace
+
+void TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod convolutionMethod, std::string expectedNodeTypeName)
+{
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["preferredConvolutionMethod"] = convolutionMethod;
+    testing::ProcessTest("Testing SetConvolutionMethodTransformation for " + expectedNodeTypeName, HasConvolutionMethodNode(optimizerOptions, expectedNodeTypeName));
 }
 
 void TestSetConvolutionMethodTransformation()
@@ -293,6 +355,88 @@ void TestSetConvolutionMethodTransformation()
     TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod::unrolled, "UnrolledConvolutionNode<float>");
 }
 
+void TestConvolutionCostDatabase()
+{
+    using predictors::neural::ConvolutionMethod;
+
+    auto testData = CreateConvolutionalLayer();
+    auto description = passes::GetDescription(*testData.layer);
+
+    passes::ConvolutionCostDatabase database;
+    ConvolutionMethod method;
+    bool ok = !database.TryGetFastestMethod("host", description, method);
+    database.AddCostMeasurement("host", description, ConvolutionMethod::simple, 3.0);
+    database.AddCostMeasurement("host", description, ConvolutionMethod::winograd, 1.0);
+    database.AddCostMeasurement("host", description, ConvolutionMethod::unrolled, 2.0);
+    database.AddCostMeasurement("pi3", description, ConvolutionMethod::simple, 0.5);
+    ok &= database.TryGetFastestMethod("host", description, method) && method == ConvolutionMethod::winograd;
+
+    // Round-trip through the archived form
+    std::stringstream stream;
+    passes::SaveConvolutionCostDatabase(database, stream);
+    auto loadedDatabase = passes::LoadConvolutionCostDatabase(stream);
+    ok &= loadedDatabase.NumMeasurements() == 4;
+    ok &= loadedDatabase.GetCostMeasurement("host", description, ConvolutionMethod::unrolled) == 2.0;
+    ok &= loadedDatabase.TryGetFastestMethod("pi3", description, method) && method == ConvolutionMethod::simple;
+    testing::ProcessTest("Testing ConvolutionCostDatabase", ok);
+
+    // The transformation picks the fastest method from the database when no method is preferred
+    const std::string filename = "convolutionCostDatabase_test.json";
+    passes::SaveConvolutionCostDatabase(database, filename);
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["convolutionCostDatabase"] = filename;
+    testing::ProcessTest("Testing SetConvolutionMethodTransformation with cost database", HasConvolutionMethodNode(optimizerOptions, "WinogradConvolutionNode<float>"));
+}
+
+void TestLearnedCostModel()
+{
+    using ValueType = float;
+
+    // Profile a unary operation on inputs of different sizes, with a time proportional to the size
+    passes::LearnedCostModelTrainer trainer;
+    for (int size : { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 })
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ValueType>>(size);
+        auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<ValueType>>(inputNode->output, nodes::UnaryOperationType::sqrt);
+        model::ModelProfileData profileData;
+        profileData.AddNodeTime(to_string(sqrtNode->GetId()), sqrtNode->GetRuntimeTypeName(), 10, 10 * 0.001 * size);
+        trainer.AddProfile(model, profileData, "host");
+    }
+    bool ok = trainer.NumExamples() == 9;
+
+    passes::LearnedCostModelParameters parameters;
+    parameters.numRounds = 20;
+    auto costModel = trainer.Train(parameters);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(2048);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<ValueType>>(inputNode->output, nodes::UnaryOperationType::sqrt);
+    model::Model smallModel;
+    auto smallInputNode = smallModel.AddNode<model::InputNode<ValueType>>(32);
+    auto smallSqrtNode = smallModel.AddNode<nodes::UnaryOperationNode<ValueType>>(smallInputNode->output, nodes::UnaryOperationType::sqrt);
+    auto time = costModel.PredictNodeTime(*sqrtNode, "host");
+    ok &= std::abs(std::log(time / 2.048)) < 0.5;
+    ok &= costModel.PredictNodeTime(*smallSqrtNode, "host") < time;
+
+    // The cost of a submodel is the predicted time of its nodes; the input node is free
+    model::optimizer::Environment environment;
+    model::Submodel submodel(model);
+    ok &= costModel.HasCost(submodel, environment);
+    ok &= costModel.GetCost(submodel, environment).GetCostComponent("runtime").GetValue() == time;
+    ok &= !costModel.CanPredictNodeTime(*sqrtNode, "pi3");
+    auto absNode = model.AddNode<nodes::UnaryOperationNode<double>>(model.AddNode<model::InputNode<double>>(16)->output, nodes::UnaryOperationType::abs);
+    ok &= !costModel.HasCost(model::Submodel(model, { &absNode->output }), environment);
+
+    // Round-trip through the archived form
+    std::stringstream stream;
+    passes::SaveLearnedCostModel(costModel, stream);
+    auto loadedCostModel = passes::LoadLearnedCostModel(stream);
+    ok &= loadedCostModel.GetNodeTypes() == costModel.GetNodeTypes();
+    ok &= std::abs(loadedCostModel.PredictNodeTime(*sqrtNode, "host") - time) < 1e-6 * time;
+    testing::ProcessTest("Testing LearnedCostModel", ok);
+}
+
 void TestOptimizeReorderDataNodesTransformation1()
 {
     using ValueType = float;
@@ -472,3 +616,378 @@ void TestOptimizeReorderDataNodesTransformation()
     TestOptimizeReorderDataNodesTransformation3();
     TestOptimizeReorderDataNodesTransformation4();
 }
+
+void TestQuantizeLayersTransformation()
+{
+    using ValueType = float;
+    constexpr int m = 4, n = 6;
+
+    math::RowMatrix<ValueType> w(m, n);
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            w(i, j) = static_cast<ValueType>((i + 1) * (j % 3 - 1)) + static_cast<ValueType>(0.25) * j;
+        }
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(n);
+    auto computeNode = model.AddNode<nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>>(inputNode->output, w);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+
+    std::vector<std::vector<double>> calibrationInputs = { { 1, -2, 3, -4, 5, -6 }, { 0.5, 0.25, -1, 2, 0, 1 } };
+    std::vector<ValueType> input = { 1, -2, 3, -4, 5, -6 };
+    auto referenceOutput = map.Compute<ValueType>(input);
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    model::MapCompilerOptions settings;
+    model::IRMapCompiler compiler(settings, {});
+    model::TransformContext context(&compiler);
+    passes::QuantizeLayersTransformation quantizeLayers(calibrationInputs);
+    map.Transform(quantizeLayers, context);
+    map.Prune();
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    auto quantizedOutput = map.Compute<ValueType>(input);
+    testing::ProcessTest("Testing QuantizeLayersTransformation replaced node", HasNodeWithTypeName(map.GetModel(), "QuantizedMatrixVectorProductNode<float>") && !HasNodeWithTypeName(map.GetModel(), nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>::GetTypeName()));
+    testing::ProcessTest("Testing QuantizeLayersTransformation result", testing::IsEqual(referenceOutput, quantizedOutput, 0.5f));
+}
+
+void TestHalfPrecisionWeightsTransformation()
+{
+    using ValueType = float;
+    constexpr int m = 4, n = 6;
+
+    // Check the conversions round to nearest even and clamp instead of overflowing
+    testing::ProcessTest("Testing float16 conversion", nodes::ToHalfPrecision(1.0f, nodes::HalfPrecisionFormat::float16) == 0x3c00 && nodes::ToHalfPrecision(-2.0f, nodes::HalfPrecisionFormat::float16) == 0xc000 && nodes::ToHalfPrecision(1.0f + 1.0f / 2048, nodes::HalfPrecisionFormat::float16) == 0x3c00 && nodes::ToHalfPrecision(1e6f, nodes::HalfPrecisionFormat::float16) == 0x7bff && nodes::FromHalfPrecision(0x0001, nodes::HalfPrecisionFormat::float16) == 5.9604644775390625e-08f);
+    testing::ProcessTest("Testing bfloat16 conversion", nodes::ToHalfPrecision(1.0f, nodes::HalfPrecisionFormat::bfloat16) == 0x3f80 && nodes::ToHalfPrecision(1.0f + 1.0f / 256, nodes::HalfPrecisionFormat::bfloat16) == 0x3f80 && nodes::FromHalfPrecision(0xc040, nodes::HalfPrecisionFormat::bfloat16) == -3.0f);
+
+    math::RowMatrix<ValueType> w(m, n);
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            w(i, j) = static_cast<ValueType>((i + 1) * (j % 3 - 1)) + static_cast<ValueType>(0.1) * j;
+        }
+    }
+
+    std::vector<ValueType> input = { 1, -2, 3, -4, 5, -6 };
+    for (auto format : { nodes::HalfPrecisionFormat::float16, nodes::HalfPrecisionFormat::bfloat16 })
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ValueType>>(n);
+        auto computeNode = model.AddNode<nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>>(inputNode->output, w);
+        auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+        auto referenceOutput = map.Compute<ValueType>(input);
+
+        model::MapCompilerOptions settings;
+        model::IRMapCompiler compiler(settings, {});
+        model::TransformContext context(&compiler);
+        passes::HalfPrecisionWeightsTransformation halfPrecisionWeights(format);
+        map.Transform(halfPrecisionWeights, context);
+        map.Prune();
+
+#if PRINT_MODELS
+        PrintModel(map.GetModel());
+#endif
+
+        auto halfPrecisionOutput = map.Compute<ValueType>(input);
+        auto formatName = std::string(format == nodes::HalfPrecisionFormat::float16 ? " (float16)" : " (bfloat16)");
+        testing::ProcessTest("Testing HalfPrecisionWeightsTransformation replaced node" + formatName, HasNodeWithTypeName(map.GetModel(), "HalfPrecisionMatrixVectorProductNode<float>") && !HasNodeWithTypeName(map.GetModel(), nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>::GetTypeName()));
+        testing::ProcessTest("Testing HalfPrecisionWeightsTransformation result" + formatName, testing::IsEqual(referenceOutput, halfPrecisionOutput, 0.2f));
+    }
+}
+
+void TestFixedPointDSPTransformation()
+{
+    using ValueType = float;
+    constexpr int windowSize = 64;
+    constexpr int numFilters = 8;
+    constexpr int numCoefficients = 4;
+
+    // A window -> FFT -> mel filter bank -> DCT front end
+    dsp::MelFilterBank filters(windowSize / 2, 8000, numFilters);
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(windowSize);
+    auto windowNode = model.AddNode<nodes::HammingWindowNode<ValueType>>(inputNode->output);
+    auto fftNode = model.AddNode<nodes::FFTNode<ValueType>>(windowNode->output, windowSize);
+    auto filterBankNode = model.AddNode<nodes::MelFilterBankNode<ValueType>>(fftNode->output, filters);
+    auto dctNode = model.AddNode<nodes::DCTNode<ValueType>>(filterBankNode->output, numCoefficients);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", dctNode->output } });
+
+    std::vector<ValueType> input(windowSize);
+    for (int index = 0; index < windowSize; ++index)
+    {
+        input[index] = static_cast<ValueType>(0.5 * std::sin(0.7 * index) + 0.25 * std::cos(2.1 * index));
+    }
+    auto referenceOutput = map.Compute<ValueType>(input);
+
+    model::MapCompilerOptions settings;
+    model::IRMapCompiler compiler(settings, {});
+    model::TransformContext context(&compiler);
+    passes::FixedPointDSPTransformation fixedPointDSP;
+    map.Transform(fixedPointDSP, context);
+    map.Prune();
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    auto fixedPointOutput = map.Compute<ValueType>(input);
+    const auto& transformedModel = map.GetModel();
+    bool replacedNodes = HasNodeWithTypeName(transformedModel, "FixedPointWindowNode") && HasNodeWithTypeName(transformedModel, "FixedPointFFTNode") && HasNodeWithTypeName(transformedModel, "FixedPointFilterBankNode") && HasNodeWithTypeName(transformedModel, "FixedPointDCTNode");
+    testing::ProcessTest("Testing FixedPointDSPTransformation replaced nodes", replacedNodes && !HasNodeWithTypeName(transformedModel, nodes::FFTNode<ValueType>::GetTypeName()));
+    testing::ProcessTest("Testing FixedPointDSPTransformation result", testing::IsEqual(referenceOutput, fixedPointOutput, 0.05f));
+}
+
+void TestSparsifyMatrixVectorProductsTransformation()
+{
+    using ValueType = float;
+    using MatrixVectorProductNodeType = nodes::MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>;
+    constexpr int m = 8, n = 10;
+
+    // A pruned matrix, with about 1 in 7 entries nonzero, and a dense one
+    math::RowMatrix<ValueType> sparseWeights(m, n);
+    math::RowMatrix<ValueType> denseWeights(n, m);
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            sparseWeights(i, j) = ((i * n + j) % 7 == 0) ? static_cast<ValueType>(i - j) + static_cast<ValueType>(0.5) : 0;
+            denseWeights(j, i) = static_cast<ValueType>(i + 1) - static_cast<ValueType>(0.25) * j;
+        }
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(n);
+    auto sparseNode = model.AddNode<MatrixVectorProductNodeType>(inputNode->output, sparseWeights);
+    auto denseNode = model.AddNode<MatrixVectorProductNodeType>(sparseNode->output, denseWeights);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", denseNode->output } });
+
+    std::vector<ValueType> input = { 1, -2, 3, -4, 5, -6, 7, -8, 9, -10 };
+    auto referenceOutput = map.Compute<ValueType>(input);
+
+    model::TransformContext context;
+    passes::SparsifyMatrixVectorProductsTransformation sparsify;
+    map.Transform(sparsify, context);
+    map.Prune();
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    auto sparseOutput = map.Compute<ValueType>(input);
+    testing::ProcessTest("Testing SparsifyMatrixVectorProductsTransformation replaced sparse node", HasNodeWithTypeName(map.GetModel(), nodes::SparseMatrixVectorProductNode<ValueType>::GetTypeName()));
+    testing::ProcessTest("Testing SparsifyMatrixVectorProductsTransformation kept dense node", HasNodeWithTypeName(map.GetModel(), MatrixVectorProductNodeType::GetTypeName()));
+    testing::ProcessTest("Testing SparsifyMatrixVectorProductsTransformation result", testing::IsEqual(referenceOutput, sparseOutput, 1e-4f));
+}
+
+void TestStreamingConvolutionTransformation()
+{
+    using ValueType = float;
+    constexpr size_t frameSize = 3, numFrames = 8, filterSize1 = 3, numFilters1 = 4, filterSize2 = 2, numFilters2 = 2;
+
+    // A window of frames convolved by a stack of two causal convolutions
+    auto getMap = [&] {
+        std::vector<ValueType> weights1(numFilters1 * filterSize1 * frameSize);
+        std::vector<ValueType> weights2(numFilters2 * filterSize2 * numFilters1);
+        std::generate(weights1.begin(), weights1.end(), Increment<ValueType>(-1.0f, 0.125f));
+        std::generate(weights2.begin(), weights2.end(), Increment<ValueType>(0.5f, -0.0625f));
+
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ValueType>>(frameSize);
+        auto bufferNode = model.AddNode<nodes::BufferNode<ValueType>>(inputNode->output, numFrames * frameSize);
+        auto convolution1 = model.AddNode<nodes::CausalConvolutionNode<ValueType>>(bufferNode->output, frameSize, filterSize1, weights1);
+        auto convolution2 = model.AddNode<nodes::CausalConvolutionNode<ValueType>>(convolution1->output, numFilters1, filterSize2, weights2);
+        return model::Map(model, { { "input", inputNode } }, { { "output", convolution2->output } });
+    };
+
+    std::vector<std::vector<ValueType>> signal;
+    for (size_t step = 0; step < 2 * numFrames; ++step)
+    {
+        std::vector<ValueType> frame(frameSize);
+        std::generate(frame.begin(), frame.end(), Increment<ValueType>(static_cast<ValueType>(step % 5) - 2, 0.75f));
+        signal.push_back(frame);
+    }
+
+    auto referenceMap = getMap();
+    std::vector<std::vector<ValueType>> referenceOutputs;
+    for (const auto& frame : signal)
+    {
+        referenceOutputs.push_back(referenceMap.Compute<ValueType>(frame));
+    }
+
+    auto map = getMap();
+    model::TransformContext context;
+    passes::StreamingConvolutionTransformation streamingConvolution;
+    map.Transform(streamingConvolution, context);
+    map.Prune();
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    // Each convolution should now read a window of exactly its filter size
+    bool streaming = true;
+    auto iter = map.GetModel().GetNodeIterator();
+    while (iter.IsValid())
+    {
+        if (auto node = dynamic_cast<const nodes::CausalConvolutionNode<ValueType>*>(iter.Get()))
+        {
+            streaming &= node->GetNumOutputFrames() == 1;
+        }
+        iter.Next();
+    }
+    testing::ProcessTest("Testing StreamingConvolutionTransformation replaced windowed convolutions", streaming);
+
+    model::MapCompilerOptions settings;
+    model::IRMapCompiler compiler(settings, {});
+    auto compiledMap = compiler.Compile(getMap());
+    bool ok = true;
+    bool compiledOk = true;
+    for (size_t step = 0; step < signal.size(); ++step)
+    {
+        ok &= testing::IsEqual(referenceOutputs[step], map.Compute<ValueType>(signal[step]), 1e-4f);
+        compiledMap.SetInputValue(0, signal[step]);
+        compiledOk &= testing::IsEqual(referenceOutputs[step], compiledMap.ComputeOutput<ValueType>(0), 1e-4f);
+    }
+    testing::ProcessTest("Testing StreamingConvolutionTransformation result", ok);
+    testing::ProcessTest("Testing StreamingConvolutionTransformation compiled result", compiledOk);
+}
+
+namespace
+{
+// in -> conv -> batch norm -> relu -> fully connected, where two of the convolution's four filters are zero
+model::Map GetChannelPruningTestMap()
+{
+    using namespace predictors::neural;
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using VectorType = typename Layer<ElementType>::VectorType;
+
+    const size_t size = 4, inputChannels = 2, filters = 4, outputs = 3;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>((size + 2) * (size + 2) * inputChannels);
+
+    TensorType convInput(size + 2, size + 2, inputChannels);
+    TensorType convWeights(3 * filters, 3, inputChannels);
+    for (size_t row = 0; row < 3 * filters; ++row)
+    {
+        for (size_t column = 0; column < 3; ++column)
+        {
+            for (size_t channel = 0; channel < inputChannels; ++channel)
+            {
+                auto filter = row / 3;
+                convWeights(row, column, channel) = filter % 2 == 1 ? 0 : static_cast<ElementType>((row + column + channel) % 5) / 4 - 0.25f;
+            }
+        }
+    }
+    LayerParameters convParameters{ convInput, ZeroPadding(1), { size, size, filters }, NoPadding() };
+    ConvolutionalLayer<ElementType> convLayer(convParameters, { 3, 1, ConvolutionMethod::unrolled, 1 }, convWeights);
+    auto convNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, convLayer);
+
+    TensorType channelInput(size, size, filters);
+    LayerParameters channelParameters{ channelInput, NoPadding(), { size, size, filters }, NoPadding() };
+    VectorType mean({ 0, 0, 0, 0 });
+    VectorType variance({ 1, 4, 0.25, 1 });
+    BatchNormalizationLayer<ElementType> batchNormLayer(channelParameters, mean, variance, 0, EpsilonSummand::SqrtVariance);
+    auto batchNormNode = model.AddNode<nodes::BatchNormalizationLayerNode<ElementType>>(convNode->output, batchNormLayer);
+    ActivationLayer<ElementType> reluLayer(channelParameters, new ReLUActivation<ElementType>());
+    auto reluNode = model.AddNode<nodes::ActivationLayerNode<ElementType>>(batchNormNode->output, reluLayer);
+
+    math::RowMatrix<ElementType> fullyConnectedWeights(outputs, size * size * filters);
+    for (size_t row = 0; row < outputs; ++row)
+    {
+        for (size_t column = 0; column < size * size * filters; ++column)
+        {
+            fullyConnectedWeights(row, column) = static_cast<ElementType>((row * 7 + column) % 9) / 8 - 0.5f;
+        }
+    }
+    LayerParameters fullyConnectedParameters{ channelInput, NoPadding(), { 1, 1, outputs }, NoPadding() };
+    auto fullyConnectedWeightsRef = fullyConnectedWeights.GetConstReference();
+    FullyConnectedLayer<ElementType> fullyConnectedLayer(fullyConnectedParameters, fullyConnectedWeightsRef);
+    auto fullyConnectedNode = model.AddNode<nodes::FullyConnectedLayerNode<ElementType>>(reluNode->output, fullyConnectedLayer);
+
+    return model::Map(model, { { "input", inputNode } }, { { "output", fullyConnectedNode->output } });
+}
+
+size_t GetNumConvolutionFilters(const model::Model& model)
+{
+    auto convNodes = model.GetNodesByType<nodes::ConvolutionalLayerNode<float>>();
+    return convNodes.size() == 1 ? convNodes[0]->GetLayer().GetOutputShape().NumChannels() : 0;
+}
+} // namespace
+
+void TestPruneChannelsTransformation()
+{
+    std::vector<float> input(6 * 6 * 2);
+    for (size_t index = 0; index < input.size(); ++index)
+    {
+        auto row = index / 12, column = (index / 2) % 6;
+        input[index] = (row == 0 || row == 5 || column == 0 || column == 5) ? 0 : static_cast<float>(index % 7) - 3;
+    }
+    std::vector<std::vector<double>> calibrationInputs = { std::vector<double>(input.begin(), input.end()) };
+
+    for (auto criterion : { ChannelPruningCriterion::weights, ChannelPruningCriterion::activations })
+    {
+        auto map = GetChannelPruningTestMap();
+        auto referenceOutput = map.Compute<float>(input);
+
+        model::MapCompilerOptions settings;
+        model::IRMapCompiler compiler(settings, {});
+        model::TransformContext context(&compiler);
+        auto pruneChannels = criterion == ChannelPruningCriterion::weights ? passes::PruneChannelsTransformation(0.1) : passes::PruneChannelsTransformation(0.1, calibrationInputs);
+        map.Transform(pruneChannels, context);
+        map.Prune();
+
+#if PRINT_MODELS
+        PrintModel(map.GetModel());
+#endif
+
+        auto prunedOutput = map.Compute<float>(input);
+        auto criterionName = std::string(criterion == ChannelPruningCriterion::weights ? " (weights)" : " (activations)");
+        testing::ProcessTest("Testing PruneChannelsTransformation removed channels" + criterionName, GetNumConvolutionFilters(map.GetModel()) == 2);
+        testing::ProcessTest("Testing PruneChannelsTransformation result" + criterionName, testing::IsEqual(referenceOutput, prunedOutput, 1e-5f));
+    }
+}
+
+void TestQuantizeConvolutionalLayers()
+{
+    std::vector<float> input(6 * 6 * 2);
+    for (size_t index = 0; index < input.size(); ++index)
+    {
+        auto row = index / 12, column = (index / 2) % 6;
+        input[index] = (row == 0 || row == 5 || column == 0 || column == 5) ? 0 : static_cast<float>(index % 7) - 3;
+    }
+    std::vector<std::vector<double>> calibrationInputs = { std::vector<double>(input.begin(), input.end()) };
+
+    auto map = GetChannelPruningTestMap();
+    auto referenceOutput = map.Compute<float>(input);
+
+    model::MapCompilerOptions settings;
+    model::IRMapCompiler compiler(settings, {});
+    model::TransformContext context(&compiler);
+    passes::QuantizeLayersTransformation quantizeLayers(calibrationInputs);
+    map.Transform(quantizeLayers, context);
+    map.Prune();
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    auto quantizedOutput = map.Compute<float>(input);
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue(0, input);
+    auto compiledOutput = compiledMap.ComputeOutput<float>(0);
+    testing::ProcessTest("Testing QuantizeLayersTransformation replaced convolution", HasNodeWithTypeName(map.GetModel(), "QuantizedConvolutionNode<float>") && !HasNodeWithTypeName(map.GetModel(), nodes::ConvolutionalLayerNode<float>::GetTypeName()));
+    testing::ProcessTest("Testing QuantizeLayersTransformation convolution result", testing::IsEqual(referenceOutput, quantizedOutput, 0.1f));
+    testing::ProcessTest("Testing QuantizeLayersTransformation compiled convolution result", testing::IsEqual(quantizedOutput, compiledOutput, 1e-4f));
+}
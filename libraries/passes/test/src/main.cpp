@@ -26,6 +26,12 @@ int main()
     try
     {
         TestFuseLinearOpsPass();
+        TestFuseElementwiseOpsPass();
+        TestFuseElementwiseOpsIntoMatrixProduct();
+        TestFoldConstantsPass();
+        TestEliminateCommonSubexpressionsPass();
+        TestFuseSoftmaxTopKPass();
+        TestEliminateRedundantConversionsPass();
 
         TestOptimizeReorderDataNodes1();
         TestOptimizeReorderDataNodes2();
@@ -18,7 +18,10 @@
 
 #include <algorithm>
 #include <functional>
+#include <future>
 #include <iterator>
+#include <memory>
+#include <thread>
 #include <vector>
 
 namespace ell
@@ -250,6 +253,17 @@ namespace predictors
         /// <returns> The prediction. </returns>
         double Predict(const DataVectorType& input, size_t interiorNodeIndex) const;
 
+        /// <summary>
+        /// Returns the output of the forest for each of a batch of inputs. The batch is split across threads, and each
+        /// thread walks a few inputs through each tree at a time, so that their memory accesses overlap.
+        /// </summary>
+        ///
+        /// <param name="inputs"> The input vectors. </param>
+        /// <param name="numThreads"> The maximum number of threads to use, or 0 to use one per hardware thread. </param>
+        ///
+        /// <returns> The predictions, one per input. </returns>
+        std::vector<double> Predict(const std::vector<DataVectorType>& inputs, size_t numThreads = 0) const;
+
         /// <summary> Generates the edge path indicator vector of the entire forest. </summary>
         ///
         /// <param name="input"> The input vector. </param>
@@ -330,9 +344,25 @@ namespace predictors
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
     protected:
+        // The trees, with each tree's interior nodes stored contiguously in breadth-first order, and the split rules
+        // and edge predictors copied into flat arrays. Built when first needed, and discarded when the forest changes.
+        struct FlatTrees
+        {
+            std::vector<int> roots; // the root node of each tree
+            std::vector<SplitRuleType> splitRules; // per node
+            std::vector<int> firstEdges; // per node: the index of its first outgoing edge
+            std::vector<EdgePredictorType> edgePredictors; // per edge
+            std::vector<int> targets; // per edge: the node the edge leads to, or -1 for a leaf
+        };
+
         //
         // protected member functions
         //
+        std::shared_ptr<const FlatTrees> GetFlatTrees() const;
+        void InvalidateFlatTrees();
+        template <typename OutputIteratorType>
+        void PredictInterleaved(const FlatTrees& trees, const DataVectorType* inputs, size_t count, OutputIteratorType outputs) const;
+
         void SetEdgeIndicatorVector(const DataVectorType& input, std::vector<bool>& edgeIndicator, size_t interiorNodeIndex) const;
 
         size_t AddInteriorNode(const SplitAction& splitAction);
@@ -349,6 +379,7 @@ namespace predictors
         std::vector<size_t> _rootIndices;
         double _bias = 0.0;
         size_t _numEdges = 0;
+        mutable std::shared_ptr<const FlatTrees> _flatTrees;
     };
 
     /// <summary> A simple binary tree with single-input threshold rules and constant predictors in its edges. </summary>
@@ -359,6 +390,7 @@ namespace predictors
 #pragma region implementation
 
 #include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
 
 namespace ell
 {
@@ -453,12 +485,139 @@ namespace predictors
     template <typename SplitRuleType, typename EdgePredictorType>
     double ForestPredictor<SplitRuleType, EdgePredictorType>::Predict(const DataVectorType& input) const
     {
-        double output = _bias;
-        for (auto treeRootIndex : _rootIndices)
+        double output = 0;
+        PredictInterleaved(*GetFlatTrees(), &input, 1, &output);
+        return output;
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    std::vector<double> ForestPredictor<SplitRuleType, EdgePredictorType>::Predict(const std::vector<DataVectorType>& inputs, size_t numThreads) const
+    {
+        // Don't bother starting a thread for fewer than this many inputs
+        const size_t minInputsPerThread = 64;
+
+        const auto trees = GetFlatTrees();
+        std::vector<double> outputs(inputs.size());
+        if (numThreads == 0)
         {
-            output += Predict(input, treeRootIndex);
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
         }
-        return output;
+        numThreads = std::max<size_t>(std::min(numThreads, inputs.size() / minInputsPerThread), 1);
+
+        const auto inputsPerThread = (inputs.size() + numThreads - 1) / numThreads;
+        std::vector<std::future<void>> tasks;
+        for (size_t begin = inputsPerThread; begin < inputs.size(); begin += inputsPerThread)
+        {
+            auto count = std::min(inputsPerThread, inputs.size() - begin);
+            tasks.emplace_back(utilities::GetHostThreadPool().AddTask([this, &trees, &inputs, &outputs, begin, count]() {
+                PredictInterleaved(*trees, inputs.data() + begin, count, outputs.begin() + begin);
+            }));
+        }
+
+        // The calling thread takes the first range
+        PredictInterleaved(*trees, inputs.data(), std::min(inputsPerThread, inputs.size()), outputs.begin());
+        for (auto& task : tasks)
+        {
+            utilities::GetHostThreadPool().GetResult(task);
+        }
+        return outputs;
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    template <typename OutputIteratorType>
+    void ForestPredictor<SplitRuleType, EdgePredictorType>::PredictInterleaved(const FlatTrees& trees, const DataVectorType* inputs, size_t count, OutputIteratorType outputs) const
+    {
+        // The number of inputs walked through a tree together
+        const size_t blockSize = 8;
+
+        for (size_t blockBegin = 0; blockBegin < count; blockBegin += blockSize)
+        {
+            const auto blockCount = std::min(blockSize, count - blockBegin);
+            const auto blockInputs = inputs + blockBegin;
+            double blockOutputs[blockSize];
+            std::fill(blockOutputs, blockOutputs + blockCount, _bias);
+
+            int nodes[blockSize];
+            for (auto root : trees.roots)
+            {
+                std::fill(nodes, nodes + blockCount, root);
+                for (bool isActive = true; isActive;)
+                {
+                    // Advance each input that hasn't reached a leaf by one level
+                    isActive = false;
+                    for (size_t index = 0; index < blockCount; ++index)
+                    {
+                        auto node = nodes[index];
+                        if (node < 0)
+                        {
+                            continue;
+                        }
+
+                        int edgePosition = static_cast<int>(trees.splitRules[node].Predict(blockInputs[index]));
+                        if (edgePosition < 0) // early eject
+                        {
+                            nodes[index] = -1;
+                            continue;
+                        }
+
+                        auto edge = trees.firstEdges[node] + edgePosition;
+                        blockOutputs[index] += trees.edgePredictors[edge].Predict(blockInputs[index]);
+                        nodes[index] = trees.targets[edge];
+                        isActive = isActive || nodes[index] >= 0;
+                    }
+                }
+            }
+            std::copy(blockOutputs, blockOutputs + blockCount, outputs + blockBegin);
+        }
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    auto ForestPredictor<SplitRuleType, EdgePredictorType>::GetFlatTrees() const -> std::shared_ptr<const FlatTrees>
+    {
+        // Concurrent callers may each build the flat trees; they build the same thing, and one of them is kept
+        auto result = std::atomic_load(&_flatTrees);
+        if (result != nullptr)
+        {
+            return result;
+        }
+
+        auto trees = std::make_shared<FlatTrees>();
+        for (auto rootIndex : _rootIndices)
+        {
+            // The node at position `q` in the breadth-first queue becomes flat node `first + q`
+            const auto first = static_cast<int>(trees->splitRules.size());
+            std::vector<size_t> queue = { rootIndex };
+            for (size_t q = 0; q < queue.size(); ++q)
+            {
+                const auto& interiorNode = _interiorNodes[queue[q]];
+                trees->splitRules.push_back(interiorNode._splitRule);
+                trees->firstEdges.push_back(static_cast<int>(trees->edgePredictors.size()));
+                for (const auto& edge : interiorNode._outgoingEdges)
+                {
+                    trees->edgePredictors.push_back(edge._predictor);
+                    if (edge.IsTargetInterior())
+                    {
+                        trees->targets.push_back(first + static_cast<int>(queue.size()));
+                        queue.push_back(edge.GetTargetNodeIndex());
+                    }
+                    else
+                    {
+                        trees->targets.push_back(-1);
+                    }
+                }
+            }
+            trees->roots.push_back(first);
+        }
+
+        result = trees;
+        std::atomic_store(&_flatTrees, result);
+        return result;
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictor<SplitRuleType, EdgePredictorType>::InvalidateFlatTrees()
+    {
+        std::atomic_store(&_flatTrees, std::shared_ptr<const FlatTrees>());
     }
 
     template <typename SplitRuleType, typename EdgePredictorType>
@@ -526,6 +685,7 @@ namespace predictors
     template <typename SplitRuleType, typename EdgePredictorType>
     size_t ForestPredictor<SplitRuleType, EdgePredictorType>::Split(const SplitAction& splitAction)
     {
+        InvalidateFlatTrees();
         if (splitAction._nodeId._isRoot)
         {
             // add interior Node
@@ -579,6 +739,7 @@ namespace predictors
         archiver["rootIndices"] >> _rootIndices;
         archiver["bias"] >> _bias;
         archiver["numEdges"] >> _numEdges;
+        InvalidateFlatTrees();
     }
 
     template <typename SplitRuleType, typename EdgePredictorType>
@@ -40,7 +40,11 @@
 #include <utilities/include/IArchivable.h>
 
 #include <cstddef>
+#include <future>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace ell
 {
@@ -123,6 +127,21 @@ namespace predictors
         /// <returns> The prediction. </returns>
         const std::vector<ElementType>& Predict(const std::vector<ElementType>& input) const;
 
+        /// <summary>
+        /// Returns the output of the network for each of a batch of inputs. The inputs are fed through the network a few
+        /// at a time, one layer at a time, so that the fully connected and convolutional layers compute all of them with
+        /// a single matrix product. The batch can also be split across threads. The inputs are computed in private
+        /// copies of the network, so this doesn't change the state of the predictor and can be called from several
+        /// threads at once.
+        /// </summary>
+        ///
+        /// <param name="inputs"> The input data. </param>
+        /// <param name="numThreads"> The maximum number of threads to use, or 0 to use one per hardware thread. </param>
+        /// <param name="batchSize"> The number of inputs fed through the layers together. </param>
+        ///
+        /// <returns> The predictions, one per input. </returns>
+        std::vector<std::vector<ElementType>> Predict(const std::vector<std::vector<ElementType>>& inputs, size_t numThreads = 0, size_t batchSize = 32) const;
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -152,7 +171,13 @@ namespace predictors
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
     private:
+        using TensorType = typename neural::Layer<ElementType>::TensorType;
+        using ConstTensorReferenceType = typename neural::Layer<ElementType>::ConstTensorReferenceType;
+
         void Compute() const;
+        void ComputeBatch(const std::vector<std::vector<ElementType>>& inputs, size_t begin, size_t count, std::vector<std::vector<ElementType>>& outputs) const;
+        static void CopyOutput(ConstTensorReferenceType output, std::vector<ElementType>& vector);
+
         InputLayerReference _inputLayer;
         Layers _layers;
         mutable std::vector<ElementType> _output;
@@ -162,7 +187,11 @@ namespace predictors
 
 #pragma region implementation
 
+#include <utilities/include/BinaryArchiver.h>
+#include <utilities/include/ThreadPool.h>
+
 #include <iostream>
+#include <sstream>
 
 namespace ell
 {
@@ -236,6 +265,68 @@ namespace predictors
         return _output;
     }
 
+    template <typename ElementType>
+    std::vector<std::vector<ElementType>> NeuralNetworkPredictor<ElementType>::Predict(const std::vector<std::vector<ElementType>>& inputs, size_t numThreads, size_t batchSize) const
+    {
+        if (batchSize == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Batch size must be at least 1");
+        }
+
+        std::vector<std::vector<ElementType>> outputs(inputs.size());
+        if (inputs.empty())
+        {
+            return outputs;
+        }
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        // Don't bother starting a thread for less than a full batch
+        numThreads = std::max<size_t>(std::min(numThreads, inputs.size() / batchSize), 1);
+
+        // The layers compute into their own tensors, so each thread gets a copy of the network to use as scratch space
+        std::stringstream archiveStream;
+        utilities::BinaryArchiver archiver(archiveStream);
+        archiver << *this;
+        const auto archive = archiveStream.str();
+        auto predictRange = [&archive, &inputs, &outputs, batchSize](size_t begin, size_t count) {
+            utilities::SerializationContext context;
+            RegisterNeuralNetworkPredictorTypes(context);
+            context.GetTypeFactory().template AddType<neural::ActivationImpl<ElementType>, neural::HardSigmoidActivation<ElementType>>();
+            context.GetTypeFactory().template AddType<neural::ActivationImpl<ElementType>, neural::LeakyReLUActivation<ElementType>>();
+            context.GetTypeFactory().template AddType<neural::ActivationImpl<ElementType>, neural::ParametricReLUActivation<ElementType>>();
+            context.GetTypeFactory().template AddType<neural::ActivationImpl<ElementType>, neural::ReLUActivation<ElementType>>();
+            context.GetTypeFactory().template AddType<neural::ActivationImpl<ElementType>, neural::SigmoidActivation<ElementType>>();
+            context.GetTypeFactory().template AddType<neural::ActivationImpl<ElementType>, neural::TanhActivation<ElementType>>();
+            utilities::BinaryUnarchiver unarchiver(archive.data(), archive.size(), context);
+            NeuralNetworkPredictor<ElementType> network;
+            unarchiver >> network;
+
+            for (auto batchBegin = begin; batchBegin < begin + count; batchBegin += batchSize)
+            {
+                network.ComputeBatch(inputs, batchBegin, std::min(batchSize, begin + count - batchBegin), outputs);
+            }
+        };
+
+        const auto inputsPerThread = (inputs.size() + numThreads - 1) / numThreads;
+        std::vector<std::future<void>> tasks;
+        for (size_t begin = inputsPerThread; begin < inputs.size(); begin += inputsPerThread)
+        {
+            auto count = std::min(inputsPerThread, inputs.size() - begin);
+            tasks.emplace_back(utilities::GetHostThreadPool().AddTask([&predictRange, begin, count]() { predictRange(begin, count); }));
+        }
+
+        // The calling thread takes the first range
+        predictRange(0, std::min(inputsPerThread, inputs.size()));
+        for (auto& task : tasks)
+        {
+            utilities::GetHostThreadPool().GetResult(task);
+        }
+        return outputs;
+    }
+
     template <typename ElementType>
     void NeuralNetworkPredictor<ElementType>::Compute() const
     {
@@ -249,24 +340,66 @@ namespace predictors
 
         if (_layers.size() > 0)
         {
-            auto output = _layers.back()->GetOutput();
-            size_t vectorIndex = 0;
+            CopyOutput(_layers.back()->GetOutput(), _output);
+        }
+        else
+        {
+            _output.assign(_output.size(), 0);
+        }
+    }
 
-            //_output.resize(output.NumElements());
-            for (size_t i = 0; i < output.NumRows(); i++)
+    template <typename ElementType>
+    void NeuralNetworkPredictor<ElementType>::ComputeBatch(const std::vector<std::vector<ElementType>>& inputs, size_t begin, size_t count, std::vector<std::vector<ElementType>>& outputs) const
+    {
+        if (_inputLayer == nullptr || _layers.empty())
+        {
+            for (auto index = begin; index < begin + count; ++index)
             {
-                for (size_t j = 0; j < output.NumColumns(); j++)
-                {
-                    for (size_t k = 0; k < output.NumChannels(); k++)
-                    {
-                        _output[vectorIndex++] = output(i, j, k);
-                    }
-                }
+                outputs[index] = Predict(inputs[index]);
             }
+            return;
         }
-        else
+
+        std::vector<TensorType> layerOutputs;
+        layerOutputs.reserve(count);
+        for (auto index = begin; index < begin + count; ++index)
         {
-            _output.assign(_output.size(), 0);
+            _inputLayer->SetInput(inputs[index]);
+            _inputLayer->Compute();
+            layerOutputs.emplace_back(_inputLayer->GetOutput());
+        }
+
+        // Feed the whole batch through each layer in turn
+        std::vector<ConstTensorReferenceType> layerInputs;
+        std::vector<TensorType> nextLayerOutputs;
+        for (const auto& layer : _layers)
+        {
+            layerInputs.assign(layerOutputs.begin(), layerOutputs.end());
+            layer->ComputeBatch(layerInputs, nextLayerOutputs);
+            std::swap(layerOutputs, nextLayerOutputs);
+        }
+
+        for (size_t sample = 0; sample < count; ++sample)
+        {
+            auto& output = outputs[begin + sample];
+            output.resize(layerOutputs[sample].Size());
+            CopyOutput(layerOutputs[sample], output);
+        }
+    }
+
+    template <typename ElementType>
+    void NeuralNetworkPredictor<ElementType>::CopyOutput(ConstTensorReferenceType output, std::vector<ElementType>& vector)
+    {
+        size_t vectorIndex = 0;
+        for (size_t i = 0; i < output.NumRows(); i++)
+        {
+            for (size_t j = 0; j < output.NumColumns(); j++)
+            {
+                for (size_t k = 0; k < output.NumChannels(); k++)
+                {
+                    vector[vectorIndex++] = output(i, j, k);
+                }
+            }
         }
     }
 
@@ -334,20 +467,21 @@ namespace predictors
         context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::SoftmaxLayer<ElementType>>();
         context.GetTypeFactory().AddType<NeuralNetworkPredictor<ElementType>, NeuralNetworkPredictor<ElementType>>();
 
-        // Map the old type names to the new ones for compatibility reasons.
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<float>>("ActivationLayer<float,SigmoidActivation>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<float>>("ActivationLayer<float,HardSigmoidActivation<float>>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<float>>("ActivationLayer<float,ReLUActivation>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<float>>("ActivationLayer<float,LeakyReLUActivation>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<float>>("ActivationLayer<float,TanhActivation>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<float>>("ActivationLayer<float,ParametricReLUActivation>");
-
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<double>>("ActivationLayer<double,SigmoidActivation>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<double>>("ActivationLayer<double,HardSigmoidActivation<double>>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<double>>("ActivationLayer<double,ReLUActivation>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<double>>("ActivationLayer<double,LeakyReLUActivation>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<double>>("ActivationLayer<double,TanhActivation>");
-        context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<double>>("ActivationLayer<double,ParametricReLUActivation>");
+        // Map the old type names to the new ones for compatibility reasons. The old names encoded the activation
+        // in the layer type, so register each of them for the layer with this predictor's element type.
+        const auto elementTypeName = utilities::TypeName<ElementType>::GetName();
+        const std::vector<std::string> oldActivationNames = {
+            "SigmoidActivation",
+            "HardSigmoidActivation<" + elementTypeName + ">",
+            "ReLUActivation",
+            "LeakyReLUActivation",
+            "TanhActivation",
+            "ParametricReLUActivation"
+        };
+        for (const auto& activationName : oldActivationNames)
+        {
+            context.GetTypeFactory().AddType<neural::Layer<ElementType>, neural::ActivationLayer<ElementType>>("ActivationLayer<" + elementTypeName + "," + activationName + ">");
+        }
     }
 
     template <typename ElementType>
@@ -173,12 +173,13 @@ namespace predictors
 
 #pragma region implementation
 
-// TODO: let's make a popcount function that does the right thing
+// The number of set bits in a 64-bit value (`long` is only 32 bits on some platforms, so use the `long long` builtin).
+// The compiled model (see `BinaryXnorNode`) uses LLVM's vector popcount instead.
 #if defined(_MSC_VER)
 #include <intrin.h>
 #define POPCOUNT64 __popcnt64
 #else
-#define POPCOUNT64 __builtin_popcountl
+#define POPCOUNT64 __builtin_popcountll
 #endif
 
 namespace ell
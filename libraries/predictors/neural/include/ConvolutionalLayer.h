@@ -31,7 +31,11 @@ namespace predictors
             /// <summary> An implementation that performs convolution with fewer arithmetic operations. </summary>
             winograd,
             /// <summary> Normal method of doing convolution via reshaping input into columns and performing a gemm operation. </summary>
-            unrolled
+            unrolled,
+            /// <summary> A vectorized implementation for depthwise separable convolutions that works on blocks of channels at a time. </summary>
+            depthwise,
+            /// <summary> A vectorized implementation that stores the channels in blocks of the vector width, and computes a block of output channels at a time. </summary>
+            blocked
         };
 
         /// <summary> Specifies the hyper parameters of the convolutional layer. </summary>
@@ -75,11 +79,19 @@ namespace predictors
             /// <summary> Instantiates a blank instance. Used for unarchiving purposes only. </summary>
             ConvolutionalLayer() :
                 _weights(math::IntegerTriplet{ 0, 0, 0 }),
+                _transformedWeights(math::IntegerTriplet{ 0, 0, 0 }),
                 _outputMatrix(0, 0) {}
 
             /// <summary> Feeds the input forward through the layer and returns a reference to the output. </summary>
             void Compute() override;
 
+            /// <summary> Computes the outputs for a batch of inputs. With the unrolled and blocked methods, the receptive fields of all the
+            ///           samples are unrolled side by side so that the batch takes a single matrix product. </summary>
+            ///
+            /// <param name="inputs"> The inputs, each with the shape of the input tensor, including padding. </param>
+            /// <param name="outputs"> Receives the outputs, one per input, each with the shape of the output tensor, including padding. </param>
+            void ComputeBatch(const std::vector<ConstTensorReferenceType>& inputs, std::vector<TensorType>& outputs) override;
+
             /// <summary> Indicates the kind of layer. </summary>
             ///
             /// <returns> An enum indicating the layer type. </returns>
@@ -95,6 +107,11 @@ namespace predictors
             /// <returns> The weights, packed into a Tensor. </returns>
             const TensorType& GetWeights() const { return _weights; }
 
+            /// <summary> Indicates if the layer is depthwise separable: it has one single-channel filter per input channel. </summary>
+            ///
+            /// <returns> `true` if the layer is depthwise separable. </returns>
+            bool IsDepthwiseSeparable() const;
+
             /// <summary> Gets the name of this type (for serialization). </summary>
             ///
             /// <returns> The name of this type. </returns>
@@ -117,7 +134,7 @@ namespace predictors
             void InitializeIOMatrices();
             void Validate() const;
             void CalculateConvolutionMethod();
-            bool IsDepthwiseSeparable() const;
+            void TransformWeights();
             void ComputeSimpleMethod();
             void ComputeUnrolledMethod();
             void ComputeWinogradMethod();
@@ -130,6 +147,10 @@ namespace predictors
             ConvolutionalParameters _convolutionalParameters;
             TensorType _weights;
 
+            // The Winograd-transformed weights, which are computed when the weights are set if the layer uses the Winograd method
+            static constexpr int _winogradTileSize = 2;
+            TensorType _transformedWeights;
+
             MatrixType _outputMatrix;
 
             ConvolutionMethod _originalConvolutionMethod;
@@ -156,11 +177,13 @@ namespace predictors
             Layer<ElementType>(layerParameters),
             _convolutionalParameters(convolutionalParameters),
             _weights(std::move(weights)),
+            _transformedWeights(math::IntegerTriplet{ 0, 0, 0 }),
             _outputMatrix{ NumOutputChannels(), NumOutputRowsMinusPadding() * NumOutputColumnsMinusPadding() },
             _originalConvolutionMethod(convolutionalParameters.method)
         {
             Validate();
             CalculateConvolutionMethod();
+            TransformWeights();
         }
 
         template <typename ElementType>
@@ -175,6 +198,7 @@ namespace predictors
                     break;
 
                 case ConvolutionMethod::unrolled:
+                case ConvolutionMethod::blocked: // fallthrough
                     ComputeUnrolledMethod();
                     break;
 
@@ -196,6 +220,55 @@ namespace predictors
             }
         }
 
+        template <typename ElementType>
+        void ConvolutionalLayer<ElementType>::ComputeBatch(const std::vector<ConstTensorReferenceType>& inputs, std::vector<TensorType>& outputs)
+        {
+            const auto method = _convolutionalParameters.method;
+            if (IsDepthwiseSeparable() || (method != ConvolutionMethod::unrolled && method != ConvolutionMethod::blocked))
+            {
+                Layer<ElementType>::ComputeBatch(inputs, outputs);
+                return;
+            }
+
+            const auto batchSize = inputs.size();
+            const auto numFilters = NumOutputChannels();
+            const auto numOutputRows = NumOutputRowsMinusPadding();
+            const auto numOutputColumns = NumOutputColumnsMinusPadding();
+            const auto numOutputPixels = numOutputRows * numOutputColumns;
+            const auto fieldVolumeSize = _weights.Size() / numFilters;
+            const auto filterSize = static_cast<int>(_convolutionalParameters.receptiveField);
+            const auto stride = static_cast<int>(_convolutionalParameters.stride);
+
+            // Unroll the receptive fields of each sample into its own block of columns
+            MatrixType shapedInputs(fieldVolumeSize, batchSize * numOutputPixels);
+            for (size_t sample = 0; sample < batchSize; sample++)
+            {
+                dsp::ReceptiveFieldToColumns(inputs[sample], filterSize, stride, shapedInputs.GetSubMatrix(0, sample * numOutputPixels, fieldVolumeSize, numOutputPixels));
+            }
+
+            // The filters are stored one after another in (row, column, channel) order, which is the order of the unrolled receptive fields
+            MatrixType weightsMatrix(numFilters, fieldVolumeSize, _weights.ToArray());
+            MatrixType outputMatrix(numFilters, batchSize * numOutputPixels);
+            math::MultiplyScaleAddUpdate(static_cast<ElementType>(1.0), weightsMatrix, shapedInputs, static_cast<ElementType>(0.0), outputMatrix);
+
+            // Re-shape the output, starting from copies of the output tensor so they get its padding
+            outputs.assign(batchSize, _output);
+            for (size_t sample = 0; sample < batchSize; sample++)
+            {
+                auto output = GetOutputMinusPadding(outputs[sample]);
+                for (size_t i = 0; i < numOutputRows; i++)
+                {
+                    for (size_t j = 0; j < numOutputColumns; j++)
+                    {
+                        for (size_t k = 0; k < numFilters; k++)
+                        {
+                            output(i, j, k) = outputMatrix(k, (sample * numOutputPixels) + (i * numOutputColumns) + j);
+                        }
+                    }
+                }
+            }
+        }
+
         template <typename ElementType>
         void ConvolutionalLayer<ElementType>::ComputeSimpleMethod()
         {
@@ -223,7 +296,8 @@ namespace predictors
             auto output = GetOutputMinusPadding();
             auto& input = _layerParameters.input;
             const int numFilters = static_cast<int>(output.NumChannels());
-            auto result = dsp::Convolve2DWinograd(input, _weights, numFilters);
+            const int filterSize = static_cast<int>(_convolutionalParameters.receptiveField);
+            auto result = dsp::Convolve2DWinogradPretransformed(input, _transformedWeights, numFilters, _winogradTileSize, filterSize, dsp::WinogradFilterOrder::tilesFirst);
             output.CopyFrom(result);
         }
 
@@ -300,6 +374,7 @@ namespace predictors
                 switch (_convolutionalParameters.method)
                 {
                 case ConvolutionMethod::simple:
+                case ConvolutionMethod::depthwise: // fallthrough
                 {
                     auto result = dsp::Convolve2DSimpleDepthwiseSeparable(inputChannelTensor, weights, numFilters, stride);
                     outputChannelTensor.CopyFrom(result);
@@ -313,7 +388,8 @@ namespace predictors
                 break;
                 case ConvolutionMethod::winograd:
                 {
-                    auto result = dsp::Convolve2DWinogradDepthwiseSeparable(inputChannelTensor, weights, numFilters); // Stide of 1 is assumed
+                    const auto transformedWeights = _transformedWeights.GetSubTensor(channel, 0, 0, 1, 1, _transformedWeights.NumChannels());
+                    auto result = dsp::Convolve2DWinogradDepthwiseSeparablePretransformed(inputChannelTensor, transformedWeights, numFilters, _winogradTileSize, static_cast<int>(filterRows), dsp::WinogradFilterOrder::filtersFirst); // Stide of 1 is assumed
                     outputChannelTensor.CopyFrom(result);
                 }
                 break;
@@ -352,6 +428,7 @@ namespace predictors
 
             math::TensorArchiver::Read(_weights, "weights", archiver);
             CalculateConvolutionMethod();
+            TransformWeights();
             InitializeIOMatrices();
         }
 
@@ -409,17 +486,53 @@ namespace predictors
                     _convolutionalParameters.method = IsDepthwiseSeparable() ? ConvolutionMethod::simple : ConvolutionMethod::unrolled;
                 }
                 break;
+            case ConvolutionMethod::depthwise:
+                // Only depthwise separable convolutions can use the depthwise method
+                if (!IsDepthwiseSeparable())
+                {
+                    _convolutionalParameters.method = ConvolutionMethod::unrolled;
+                }
+                break;
+            case ConvolutionMethod::blocked:
+                // Depthwise separable convolutions don't mix the channels, so they can't use the blocked method
+                if (IsDepthwiseSeparable())
+                {
+                    _convolutionalParameters.method = ConvolutionMethod::simple;
+                }
+                break;
             }
             if (IsDepthwiseSeparable())
             {
                 // Verify we can use a workable method for depthwise separable convolutions.
-                if ((_convolutionalParameters.method != ConvolutionMethod::unrolled) && (_convolutionalParameters.method != ConvolutionMethod::simple) && (_convolutionalParameters.method != ConvolutionMethod::winograd))
+                if ((_convolutionalParameters.method != ConvolutionMethod::unrolled) && (_convolutionalParameters.method != ConvolutionMethod::simple) && (_convolutionalParameters.method != ConvolutionMethod::winograd) && (_convolutionalParameters.method != ConvolutionMethod::depthwise))
                 {
                     _convolutionalParameters.method = ConvolutionMethod::simple;
                 }
             }
         }
 
+        template <typename ElementType>
+        void ConvolutionalLayer<ElementType>::TransformWeights()
+        {
+            if (_convolutionalParameters.method != ConvolutionMethod::winograd)
+            {
+                _transformedWeights = TensorType(math::IntegerTriplet{ 0, 0, 0 });
+                return;
+            }
+
+            if (IsDepthwiseSeparable())
+            {
+                // One single-channel filter per channel, in filters-first order, so row `channel` is the transformed filter of that channel
+                const int numChannels = static_cast<int>(_weights.NumRows() / _convolutionalParameters.receptiveField);
+                _transformedWeights = dsp::GetTransformedFilters(_weights, numChannels, _winogradTileSize, dsp::WinogradFilterOrder::filtersFirst);
+            }
+            else
+            {
+                const int numFilters = static_cast<int>(NumOutputChannels());
+                _transformedWeights = dsp::GetTransformedFilters(_weights, numFilters, _winogradTileSize, dsp::WinogradFilterOrder::tilesFirst);
+            }
+        }
+
         template <typename ElementType>
         bool ConvolutionalLayer<ElementType>::IsDepthwiseSeparable() const
         {
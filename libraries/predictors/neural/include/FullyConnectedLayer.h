@@ -27,6 +27,7 @@ namespace predictors
             using VectorType = typename Layer<ElementType>::VectorType;
             using MatrixType = typename Layer<ElementType>::MatrixType;
             using ConstMatrixReferenceType = typename Layer<ElementType>::ConstMatrixReferenceType;
+            using TensorType = typename Layer<ElementType>::TensorType;
             using ConstTensorReferenceType = typename Layer<ElementType>::ConstTensorReferenceType;
             using Layer<ElementType>::GetOutputMinusPadding;
             using Layer<ElementType>::NumOutputRowsMinusPadding;
@@ -54,6 +55,12 @@ namespace predictors
             /// <summary> Feeds the input forward through the layer and returns a reference to the output. </summary>
             void Compute() override;
 
+            /// <summary> Computes the outputs for a batch of inputs with a single matrix product. </summary>
+            ///
+            /// <param name="inputs"> The inputs, each with the shape of the input tensor, including padding. </param>
+            /// <param name="outputs"> Receives the outputs, one per input, each with the shape of the output tensor, including padding. </param>
+            void ComputeBatch(const std::vector<ConstTensorReferenceType>& inputs, std::vector<TensorType>& outputs) override;
+
             /// <summary> Indicates the kind of layer. </summary>
             ///
             /// <returns> An enum indicating the layer type. </returns>
@@ -171,6 +178,51 @@ namespace predictors
             }
         }
 
+        template <typename ElementType>
+        void FullyConnectedLayer<ElementType>::ComputeBatch(const std::vector<ConstTensorReferenceType>& inputs, std::vector<TensorType>& outputs)
+        {
+            const auto batchSize = inputs.size();
+
+            // Reshape each input into a column of a matrix
+            math::ColumnMatrix<ElementType> shapedInputs(_weights.NumColumns(), batchSize);
+            for (size_t sample = 0; sample < batchSize; sample++)
+            {
+                const auto& input = inputs[sample];
+                size_t rowIndex = 0;
+                for (size_t i = 0; i < input.NumRows(); i++)
+                {
+                    for (size_t j = 0; j < input.NumColumns(); j++)
+                    {
+                        for (size_t k = 0; k < input.NumChannels(); k++)
+                        {
+                            shapedInputs(rowIndex++, sample) = input(i, j, k);
+                        }
+                    }
+                }
+            }
+
+            math::ColumnMatrix<ElementType> shapedOutputs(_weights.NumRows(), batchSize);
+            math::MultiplyScaleAddUpdate((ElementType)1.0f, _weights, shapedInputs, (ElementType)0.0f, shapedOutputs);
+
+            // Reshape the outputs, starting from copies of the output tensor so they get its padding
+            outputs.assign(batchSize, _output);
+            for (size_t sample = 0; sample < batchSize; sample++)
+            {
+                auto output = GetOutputMinusPadding(outputs[sample]);
+                size_t rowIndex = 0;
+                for (size_t i = 0; i < output.NumRows(); i++)
+                {
+                    for (size_t j = 0; j < output.NumColumns(); j++)
+                    {
+                        for (size_t k = 0; k < output.NumChannels(); k++)
+                        {
+                            output(i, j, k) = shapedOutputs(rowIndex++, sample);
+                        }
+                    }
+                }
+            }
+        }
+
         template <typename ElementType>
         const typename FullyConnectedLayer<ElementType>::MatrixType& FullyConnectedLayer<ElementType>::GetWeights() const
         {
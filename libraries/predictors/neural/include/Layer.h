@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <memory>
 #include <ostream>
+#include <vector>
 
 namespace ell
 {
@@ -231,6 +232,14 @@ namespace predictors
             ///           This is a no-op for this layer type. </summary>
             virtual void Compute(){};
 
+            /// <summary> Computes the outputs of the layer for a batch of inputs. Layers that can share work across the batch, such as
+            ///           doing one matrix product for all the samples, override this; by default each sample is computed in turn with `Compute`,
+            ///           which uses the output tensor of the layer as scratch space. </summary>
+            ///
+            /// <param name="inputs"> The inputs, each with the shape of the input tensor, including padding. </param>
+            /// <param name="outputs"> Receives the outputs, one per input, each with the shape of the output tensor, including padding. </param>
+            virtual void ComputeBatch(const std::vector<ConstTensorReferenceType>& inputs, std::vector<TensorType>& outputs);
+
             /// <summary> Resets the state of the layer </summary>
             virtual void Reset(){};
 
@@ -279,6 +288,13 @@ namespace predictors
             /// <returns> Read/write reference to the output tensor. </returns>
             TensorReferenceType GetOutputMinusPadding();
 
+            /// <summary> Returns a read/write reference to the sub tensor of an output tensor of this layer that does not contain padding. </summary>
+            ///
+            /// <param name="output"> A tensor with the shape of the output of this layer. </param>
+            ///
+            /// <returns> Read/write reference to the output tensor, minus padding. </returns>
+            TensorReferenceType GetOutputMinusPadding(TensorType& output);
+
             /// <summary> Returns number of output rows minus padding. </summary>
             size_t NumOutputRowsMinusPadding() const { return _output.NumRows() - 2 * _layerParameters.outputPaddingParameters.paddingSize; }
 
@@ -406,6 +422,21 @@ namespace predictors
             return { outputShape.NumRows() - 2 * paddingSize, outputShape.NumColumns() - 2 * paddingSize, outputShape.NumChannels() };
         }
 
+        template <typename ElementType>
+        void Layer<ElementType>::ComputeBatch(const std::vector<ConstTensorReferenceType>& inputs, std::vector<TensorType>& outputs)
+        {
+            const auto input = _layerParameters.input;
+            outputs.clear();
+            outputs.reserve(inputs.size());
+            for (const auto& sampleInput : inputs)
+            {
+                _layerParameters.input = sampleInput;
+                Compute();
+                outputs.emplace_back(_output);
+            }
+            _layerParameters.input = input;
+        }
+
         template <typename ElementType>
         void Layer<ElementType>::InitializeOutputValues(TensorType& output, PaddingParameters outputPaddingParameters)
         {
@@ -542,10 +573,16 @@ namespace predictors
 
         template <typename ElementType>
         typename Layer<ElementType>::TensorReferenceType Layer<ElementType>::GetOutputMinusPadding()
+        {
+            return GetOutputMinusPadding(_output);
+        }
+
+        template <typename ElementType>
+        typename Layer<ElementType>::TensorReferenceType Layer<ElementType>::GetOutputMinusPadding(TensorType& output)
         {
             auto padding = _layerParameters.outputPaddingParameters.paddingSize;
-            return _output.GetSubTensor({ padding, padding, 0 },
-                                        { _output.NumRows() - 2 * padding, _output.NumColumns() - 2 * padding, _output.NumChannels() });
+            return output.GetSubTensor({ padding, padding, 0 },
+                                       { output.NumRows() - 2 * padding, output.NumColumns() - 2 * padding, output.NumChannels() });
         }
 
         template <typename ElementType>
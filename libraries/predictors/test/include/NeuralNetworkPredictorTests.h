@@ -59,6 +59,9 @@ void ConvolutionalArchiveTest();
 template <typename ElementType>
 void BinaryConvolutionalArchiveTest();
 
+template <typename ElementType>
+void ActivationArchiveTest();
+
 #pragma region implementation
 
 #include <common/include/LoadModel.h>
@@ -76,6 +79,7 @@ void BinaryConvolutionalArchiveTest();
 #include <testing/include/testing.h>
 
 #include <utilities/include/JsonArchiver.h>
+#include <utilities/include/StringUtil.h>
 
 using namespace ell;
 using namespace ell::common;
@@ -476,12 +480,36 @@ void ConvolutionalLayerTest()
     auto outputUnrolled = convolutionalLayerUnrolled.GetOutput();
     testing::ProcessTest("Testing ConvolutionalLayer (unrolled), values", Equals(outputUnrolled(0, 0, 0), 10) && Equals(outputUnrolled(0, 0, 1), 15) && Equals(outputUnrolled(0, 1, 0), 18) && Equals(outputUnrolled(0, 1, 1), 18));
 
+    // Verify that a batch computed with a single matrix product matches computing each input on its own
+    TensorType input2(input);
+    input2(1, 1, 0) = 1;
+    input2(1, 2, 1) = 4;
+    LayerParameters parameters2{ input2, ZeroPadding(1), outputShape, NoPadding() };
+    convolutionalParams.method = ConvolutionMethod::simple;
+    ConvolutionalLayer<ElementType> convolutionalLayerSimple2(parameters2, convolutionalParams, weights);
+    convolutionalLayerSimple2.Compute();
+    std::vector<TensorType> batchOutputs;
+    convolutionalLayerUnrolled.ComputeBatch({ input, input2 }, batchOutputs);
+    testing::ProcessTest("Testing ConvolutionalLayer (unrolled), batch values", batchOutputs.size() == 2 && batchOutputs[0] == outputUnrolled && batchOutputs[1] == convolutionalLayerSimple2.GetOutput());
+
     // Verify ConvolutionalLayer with diagonal method
     convolutionalParams.method = ConvolutionMethod::diagonal;
     ConvolutionalLayer<ElementType> convolutionalLayerDiagonal(parameters, convolutionalParams, weights);
     convolutionalLayerDiagonal.Compute();
     auto outputDiagonal = convolutionalLayerDiagonal.GetOutput();
     testing::ProcessTest("Testing ConvolutionalLayer (diagonal), values", Equals(outputDiagonal(0, 0, 0), 10) && Equals(outputDiagonal(0, 0, 1), 15) && Equals(outputDiagonal(0, 1, 0), 18) && Equals(outputDiagonal(0, 1, 1), 18));
+
+    // Verify ConvolutionalLayer with winograd method, which reuses the transformed weights on every call
+    convolutionalParams.method = ConvolutionMethod::winograd;
+    ConvolutionalLayer<ElementType> convolutionalLayerWinograd(parameters, convolutionalParams, weights);
+    bool winogradOk = true;
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+        convolutionalLayerWinograd.Compute();
+        auto outputWinograd = convolutionalLayerWinograd.GetOutput();
+        winogradOk = winogradOk && Equals(outputWinograd(0, 0, 0), 10) && Equals(outputWinograd(0, 0, 1), 15) && Equals(outputWinograd(0, 1, 0), 18) && Equals(outputWinograd(0, 1, 1), 18);
+    }
+    testing::ProcessTest("Testing ConvolutionalLayer (winograd), values", winogradOk);
 }
 
 template <typename ElementType>
@@ -772,6 +800,29 @@ void NeuralNetworkPredictorTest()
     output = neuralNetwork.Predict(DataVectorType({ 1, 1 }));
     testing::ProcessTest("Testing NeuralNetworkPredictor, Predict of XOR net for 1 1 ", Equals(output[0], 0.0));
 
+    // Check a batch of inputs, split across threads
+    std::vector<std::vector<ElementType>> batch;
+    for (int index = 0; index < 100; ++index)
+    {
+        batch.push_back({ static_cast<ElementType>(index % 2), static_cast<ElementType>((index / 2) % 2) });
+    }
+    auto batchOutputs = neuralNetwork.Predict(batch, 4);
+    bool batchOutputsOk = batchOutputs.size() == batch.size();
+    for (size_t index = 0; batchOutputsOk && index < batch.size(); ++index)
+    {
+        batchOutputsOk = Equals(batchOutputs[index][0], batch[index][0] != batch[index][1] ? 1.0 : 0.0);
+    }
+    testing::ProcessTest("Testing NeuralNetworkPredictor, batch Predict of XOR net", batchOutputsOk);
+
+    // Check the same batch on one thread, in batches that don't divide it evenly
+    batchOutputs = neuralNetwork.Predict(batch, 1, 7);
+    batchOutputsOk = batchOutputs.size() == batch.size();
+    for (size_t index = 0; batchOutputsOk && index < batch.size(); ++index)
+    {
+        batchOutputsOk = Equals(batchOutputs[index][0], batch[index][0] != batch[index][1] ? 1.0 : 0.0);
+    }
+    testing::ProcessTest("Testing NeuralNetworkPredictor, batch Predict of XOR net on one thread", batchOutputsOk);
+
     // Verify that we can archive and unarchive the predictor
     utilities::SerializationContext context;
     NeuralNetworkPredictor<ElementType>::RegisterNeuralNetworkPredictorTypes(context);
@@ -903,4 +954,53 @@ void BinaryConvolutionalArchiveTest()
     testing::ProcessTest("Testing Binary convolutional predictor from archive", testing::IsEqual(output, output2));
 }
 
+template <typename ElementType>
+void ActivationArchiveTest()
+{
+    using namespace ell::predictors;
+    using namespace ell::predictors::neural;
+    using InputParameters = typename InputLayer<ElementType>::InputParameters;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using DataVectorType = typename NeuralNetworkPredictor<ElementType>::DataVectorType;
+
+    // Build a net
+    typename NeuralNetworkPredictor<ElementType>::InputLayerReference inputLayer;
+    typename NeuralNetworkPredictor<ElementType>::Layers layers;
+
+    InputParameters inputParams = { { 1, 1, 4 }, NoPadding(), { 1, 1, 4 }, NoPadding(), 1 };
+    inputLayer = std::make_unique<InputLayer<ElementType>>(inputParams);
+
+    LayerParameters layerParameters{ inputLayer->GetOutput(), NoPadding(), { 1, 1, 4 }, NoPadding() };
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new ActivationLayer<ElementType>(layerParameters, new ReLUActivation<ElementType>())));
+
+    NeuralNetworkPredictor<ElementType> neuralNetwork(std::move(inputLayer), std::move(layers));
+    DataVectorType input({ -2, -1, 1, 2 });
+    auto output = neuralNetwork.Predict(input);
+
+    utilities::SerializationContext context;
+    NeuralNetworkPredictor<ElementType>::RegisterNeuralNetworkPredictorTypes(context);
+    std::stringstream strstream;
+    utilities::JsonArchiver archiver(strstream);
+    archiver << neuralNetwork;
+    auto archive = strstream.str();
+
+    std::stringstream newStream(archive);
+    utilities::JsonUnarchiver unarchiver(newStream, context);
+    NeuralNetworkPredictor<ElementType> neuralNetwork2;
+    unarchiver >> neuralNetwork2;
+    auto output2 = neuralNetwork2.Predict(input);
+    const auto elementTypeName = utilities::TypeName<ElementType>::GetName();
+    testing::ProcessTest("Testing activation predictor from archive for " + elementTypeName, testing::IsEqual(output, output2));
+
+    // Archives written before the activation was a property of the layer name it in the layer's type
+    auto oldArchive = archive;
+    utilities::ReplaceAll(oldArchive, "\"ActivationLayer<" + elementTypeName + ">\"", "\"ActivationLayer<" + elementTypeName + ",ReLUActivation>\"");
+    std::stringstream oldStream(oldArchive);
+    utilities::JsonUnarchiver oldUnarchiver(oldStream, context);
+    NeuralNetworkPredictor<ElementType> neuralNetwork3;
+    oldUnarchiver >> neuralNetwork3;
+    auto output3 = neuralNetwork3.Predict(input);
+    testing::ProcessTest("Testing activation predictor from archive with old layer type name for " + elementTypeName, oldArchive != archive && testing::IsEqual(output, output3));
+}
+
 #pragma endregion implementation
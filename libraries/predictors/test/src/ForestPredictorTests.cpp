@@ -65,3 +65,47 @@ void ForestPredictorTest()
     auto edgeIndicator = forest.GetEdgeIndicatorVector(ExampleType{ 0.25, 0.7, 0.0 });
     testing::ProcessTest("Testing ForestPredictor, SetEdgeIndicatorVector()", testing::IsEqual(edgeIndicator, std::vector<bool>{ 1, 0, 0, 1, 0, 0, 0, 1 }));
 }
+
+void ForestPredictorBatchTest()
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+    using ExampleType = predictors::SimpleForestPredictor::DataVectorType;
+
+    predictors::SimpleForestPredictor forest;
+    forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.3 }, EdgePredictorVector{ -1.0, 1.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(0, 0), SplitRule{ 1, 0.6 }, EdgePredictorVector{ -2.0, 2.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(0, 1), SplitRule{ 2, 0.9 }, EdgePredictorVector{ -4.0, 4.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(1, 1), SplitRule{ 2, 0.4 }, EdgePredictorVector{ -0.5, 0.5 } });
+    forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.2 }, EdgePredictorVector{ -3.0, 3.0 } });
+    forest.AddToBias(0.25);
+
+    auto getInputs = [](size_t count) {
+        std::vector<ExampleType> inputs;
+        for (size_t index = 0; index < count; ++index)
+        {
+            inputs.push_back(ExampleType{ 0.01 + (index % 7) / 7.0, 0.01 + (index % 11) / 11.0, 0.01 + (index % 13) / 13.0 });
+        }
+        return inputs;
+    };
+    auto inputs = getInputs(500);
+    auto smallBatch = getInputs(5);
+
+    auto expected = [&forest](const std::vector<ExampleType>& inputs) {
+        std::vector<double> result;
+        for (const auto& input : inputs)
+        {
+            result.push_back(forest.Predict(input, forest.GetRootIndex(0)) + forest.Predict(input, forest.GetRootIndex(1)) + forest.GetBias());
+        }
+        return result;
+    };
+
+    testing::ProcessTest("Testing ForestPredictor, batch Predict()", testing::IsEqual(forest.Predict(inputs), expected(inputs), 1.0e-8));
+    testing::ProcessTest("Testing ForestPredictor, batch Predict() with 3 threads", testing::IsEqual(forest.Predict(inputs, 3), expected(inputs), 1.0e-8));
+    testing::ProcessTest("Testing ForestPredictor, batch Predict() with a small batch", testing::IsEqual(forest.Predict(smallBatch), expected(smallBatch), 1.0e-8));
+
+    // Splitting the forest again discards the flattened trees
+    forest.Split(SplitAction{ forest.GetChildId(4, 0), SplitRule{ 1, 0.5 }, EdgePredictorVector{ -7.0, 7.0 } });
+    testing::ProcessTest("Testing ForestPredictor, batch Predict() after Split()", testing::IsEqual(forest.Predict(inputs), expected(inputs), 1.0e-8));
+}
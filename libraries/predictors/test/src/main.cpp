@@ -19,6 +19,7 @@ int main()
 {
     // ForestPredictor
     ForestPredictorTest();
+    ForestPredictorBatchTest();
 
     // LinearPredictor
     LinearPredictorTest<double>();
@@ -57,6 +58,8 @@ int main()
 
     ConvolutionalArchiveTest<float>();
     BinaryConvolutionalArchiveTest<float>();
+    ActivationArchiveTest<float>();
+    ActivationArchiveTest<double>();
 
     ProtoNNPredictorTest();
 
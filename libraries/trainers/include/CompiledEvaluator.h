@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompiledEvaluator.h (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <evaluators/include/Evaluator.h>
+
+#include <model/include/Map.h>
+#include <model/include/MapCompilerOptions.h>
+
+#include <predictors/include/ForestPredictor.h>
+#include <predictors/include/LinearPredictor.h>
+
+#include <memory>
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary> Describes whether a predictor type can be compiled by a `CompiledEvaluator`, and the element type of its map. </summary>
+    template <typename PredictorType>
+    struct CompiledPredictorTraits
+    {
+        static constexpr bool isCompilable = false;
+    };
+
+    template <>
+    struct CompiledPredictorTraits<predictors::SimpleForestPredictor>
+    {
+        static constexpr bool isCompilable = true;
+        using ValueType = double;
+    };
+
+    template <typename ElementType>
+    struct CompiledPredictorTraits<predictors::LinearPredictor<ElementType>>
+    {
+        static constexpr bool isCompilable = true;
+        using ValueType = ElementType;
+    };
+
+    /// <summary> Makes a map with a single input of the given size and a single output, the prediction of the given forest. </summary>
+    model::Map GetPredictorMap(const predictors::SimpleForestPredictor& forest, size_t inputSize);
+
+    /// <summary> Makes a map with a single input of the given size and a single output, the prediction of the given linear predictor. </summary>
+    template <typename ElementType>
+    model::Map GetPredictorMap(const predictors::LinearPredictor<ElementType>& predictor, size_t inputSize);
+
+    /// <summary> Gets the smallest input size that holds every feature the forest reads. </summary>
+    size_t GetPredictorInputSize(const predictors::SimpleForestPredictor& forest);
+
+    /// <summary> Gets the smallest input size that holds every feature the linear predictor reads. </summary>
+    template <typename ElementType>
+    size_t GetPredictorInputSize(const predictors::LinearPredictor<ElementType>& predictor);
+
+    /// <summary>
+    /// An evaluator that compiles the predictor to native code with the map compiler before each evaluation, instead of
+    /// calling its `Predict` function on each example. Compiling takes a fixed amount of time per evaluation, so this
+    /// pays off on large evaluation sets, where walking the predictor's data structures dominates. The predictions are
+    /// computed on a single thread (the compiled map isn't reentrant) and aggregated like the base `Evaluator`.
+    /// </summary>
+    ///
+    /// <typeparam name="PredictorType"> The predictor type, either `SimpleForestPredictor` or a `LinearPredictor`. </typeparam>
+    /// <typeparam name="AggregatorTypes"> The aggregator types. </typeparam>
+    template <typename PredictorType, typename... AggregatorTypes>
+    class CompiledEvaluator : public evaluators::Evaluator<PredictorType, AggregatorTypes...>
+    {
+    public:
+        using BaseClassType = evaluators::Evaluator<PredictorType, AggregatorTypes...>;
+
+        /// <summary> Constructs an instance of CompiledEvaluator with a given data set and given aggregators. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        /// <param name="evaluatorParameters"> The evaluation parameters. </param>
+        /// <param name="settings"> The settings the predictor is compiled with. </param>
+        /// <param name="aggregators"> The aggregators. </param>
+        CompiledEvaluator(const data::AnyDataset& anyDataset, const evaluators::EvaluatorParameters& evaluatorParameters, const model::MapCompilerOptions& settings, AggregatorTypes... aggregators);
+
+        /// <summary> Compiles the given predictor, runs it on the evaluation set, invokes each of the aggregators on the output, and logs the result. </summary>
+        ///
+        /// <param name="predictor"> The predictor. </param>
+        void Evaluate(const PredictorType& predictor) override;
+
+    private:
+        using ValueType = typename CompiledPredictorTraits<PredictorType>::ValueType;
+
+        model::MapCompilerOptions _settings;
+        size_t _inputSize = 0;
+        std::vector<double> _predictions;
+    };
+
+    /// <summary> Makes an evaluator that compiles the predictor before each evaluation. </summary>
+    ///
+    /// <typeparam name="PredictorType"> The predictor type. </typeparam>
+    /// <typeparam name="AggregatorTypes"> The aggregator types. </typeparam>
+    /// <param name="anyDataset"> A dataset. </param>
+    /// <param name="evaluatorParameters"> The evaluation parameters. </param>
+    /// <param name="aggregators"> The aggregators. </param>
+    ///
+    /// <returns> A shared_ptr to an IEvaluator. </returns>
+    template <typename PredictorType, typename... AggregatorTypes>
+    std::shared_ptr<evaluators::IEvaluator<PredictorType>> MakeCompiledEvaluator(const data::AnyDataset& anyDataset, const evaluators::EvaluatorParameters& evaluatorParameters, AggregatorTypes... aggregators);
+} // namespace trainers
+} // namespace ell
+
+#pragma region implementation
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputNode.h>
+#include <model/include/Model.h>
+#include <model/include/ModelOptimizerOptions.h>
+
+#include <nodes/include/LinearPredictorNode.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace trainers
+{
+    template <typename ElementType>
+    model::Map GetPredictorMap(const predictors::LinearPredictor<ElementType>& predictor, size_t inputSize)
+    {
+        predictors::LinearPredictor<ElementType> resizedPredictor(predictor);
+        resizedPredictor.Resize(inputSize);
+
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputSize);
+        auto predictorNode = model.AddNode<nodes::LinearPredictorNode<ElementType>>(inputNode->output, resizedPredictor);
+        return { model, { { "input", inputNode } }, { { "output", predictorNode->output } } };
+    }
+
+    template <typename ElementType>
+    size_t GetPredictorInputSize(const predictors::LinearPredictor<ElementType>& predictor)
+    {
+        return predictor.Size();
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    CompiledEvaluator<PredictorType, AggregatorTypes...>::CompiledEvaluator(const data::AnyDataset& anyDataset, const evaluators::EvaluatorParameters& evaluatorParameters, const model::MapCompilerOptions& settings, AggregatorTypes... aggregators) :
+        BaseClassType(anyDataset, evaluatorParameters, aggregators...),
+        _settings(settings)
+    {
+        static_assert(CompiledPredictorTraits<PredictorType>::isCompilable, "CompiledEvaluator can't compile this predictor type");
+
+        const auto& dataset = BaseClassType::_dataset;
+        for (size_t index = 0; index < dataset.NumExamples(); ++index)
+        {
+            _inputSize = std::max(_inputSize, dataset[index].GetDataVector().PrefixLength());
+        }
+        _predictions.resize(dataset.NumExamples());
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    void CompiledEvaluator<PredictorType, AggregatorTypes...>::Evaluate(const PredictorType& predictor)
+    {
+        ++BaseClassType::_evaluateCounter;
+        if (BaseClassType::_evaluateCounter % BaseClassType::_evaluatorParameters.evaluationFrequency != 0)
+        {
+            return;
+        }
+
+        // The predictor can read features past the end of the evaluation examples, which are implicitly zero
+        auto inputSize = std::max<size_t>(std::max(_inputSize, GetPredictorInputSize(predictor)), 1);
+        auto settings = _settings;
+        settings.moduleName = "evaluate";
+        settings.mapFunctionName = "evaluate";
+        model::IRMapCompiler compiler(settings, model::ModelOptimizerOptions{});
+        auto compiledMap = compiler.Compile(GetPredictorMap(predictor, inputSize));
+
+        const auto& dataset = BaseClassType::_dataset;
+        std::vector<ValueType> input(inputSize);
+        for (size_t index = 0; index < dataset.NumExamples(); ++index)
+        {
+            std::fill(input.begin(), input.end(), static_cast<ValueType>(0));
+            auto features = dataset[index].GetDataVector().ToArray();
+            std::copy(features.begin(), features.end(), input.begin());
+            compiledMap.SetInputValue(0, input);
+            _predictions[index] = static_cast<double>(compiledMap.template ComputeOutput<ValueType>(0)[0]);
+        }
+
+        BaseClassType::EvaluateExamples([this](size_t index, const typename BaseClassType::ExampleType&) { return _predictions[index]; }, true);
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    std::shared_ptr<evaluators::IEvaluator<PredictorType>> MakeCompiledEvaluator(const data::AnyDataset& anyDataset, const evaluators::EvaluatorParameters& evaluatorParameters, AggregatorTypes... aggregators)
+    {
+        return std::make_shared<CompiledEvaluator<PredictorType, AggregatorTypes...>>(anyDataset, evaluatorParameters, model::MapCompilerOptions{}, aggregators...);
+    }
+} // namespace trainers
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvergenceMonitor.h (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <data/include/Dataset.h>
+#include <data/include/Example.h>
+
+#include <predictors/include/LinearPredictor.h>
+
+#include <cstddef>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary> The quantity that decides when a linear trainer has converged. </summary>
+    enum class ConvergenceCriterion
+    {
+        /// <summary> Never stop early. </summary>
+        none,
+        /// <summary> Stop when the duality gap is at most the tolerance. Only dual trainers (SDCA) have a duality gap. </summary>
+        dualityGap,
+        /// <summary> Stop when the loss on an evenly spaced sample of the training set changes by at most the tolerance, relative to its previous value. </summary>
+        relativeLoss,
+        /// <summary> Stop when the loss on the validation set has not improved by more than the tolerance, relative to its best value, for `patience` checks in a row. </summary>
+        validationPlateau
+    };
+
+    /// <summary> Parameters of the early termination of a linear trainer. </summary>
+    struct ConvergenceParameters
+    {
+        /// <summary> The convergence criterion. </summary>
+        ConvergenceCriterion criterion = ConvergenceCriterion::none;
+
+        /// <summary> The duality gap, or the relative loss change, at which the trainer has converged. </summary>
+        double tolerance = 1.0e-4;
+
+        /// <summary> The number of examples between checks, or 0 to check at the end of each epoch. Only serial epochs of
+        /// in-memory datasets are checked in the middle; other epochs are checked at their end. </summary>
+        size_t checkInterval = 0;
+
+        /// <summary> The number of checks in a row without improvement that make a validation plateau. </summary>
+        size_t patience = 3;
+
+        /// <summary> The number of training examples whose loss is measured by the relative loss criterion. </summary>
+        size_t lossSampleSize = 1000;
+    };
+
+    /// <summary>
+    /// Keeps the state of the convergence criterion of a linear trainer: when the next check is due, the measurements of
+    /// the previous checks, and the examples whose loss is measured. The trainer measures the criterion and adds it.
+    /// </summary>
+    class ConvergenceMonitor
+    {
+    public:
+        /// <summary> Constructs an instance of ConvergenceMonitor. </summary>
+        ///
+        /// <param name="parameters"> The convergence parameters. </param>
+        ConvergenceMonitor(const ConvergenceParameters& parameters);
+
+        /// <summary> Returns the convergence parameters. </summary>
+        ///
+        /// <returns> The convergence parameters. </returns>
+        const ConvergenceParameters& GetParameters() const { return _parameters; }
+
+        /// <summary> Returns the convergence criterion. </summary>
+        ///
+        /// <returns> The convergence criterion. </returns>
+        ConvergenceCriterion GetCriterion() const { return _parameters.criterion; }
+
+        /// <summary> Returns true if the trainer should check the criterion at the end of each epoch. </summary>
+        ///
+        /// <returns> true if the checks are made at the end of each epoch. </returns>
+        bool IsCheckedPerEpoch() const { return _parameters.criterion != ConvergenceCriterion::none && _parameters.checkInterval == 0; }
+
+        /// <summary> Counts a training step, and returns true if the criterion should be checked after it. </summary>
+        ///
+        /// <returns> true if a check is due. </returns>
+        bool CountStep();
+
+        /// <summary> Adds the value of the criterion at a check: the duality gap, or the loss. </summary>
+        ///
+        /// <param name="value"> The value of the criterion. </param>
+        ///
+        /// <returns> true if the trainer has converged. </returns>
+        bool AddCheck(double value);
+
+        /// <summary> Returns true if the trainer has converged. </summary>
+        ///
+        /// <returns> true if the trainer has converged. </returns>
+        bool HasConverged() const { return _hasConverged; }
+
+        /// <summary> Returns the number of checks made. </summary>
+        ///
+        /// <returns> The number of checks. </returns>
+        size_t NumChecks() const { return _numChecks; }
+
+        /// <summary> Returns the value of the criterion at the last check. </summary>
+        ///
+        /// <returns> The value of the criterion. </returns>
+        double GetLastValue() const { return _lastValue; }
+
+        /// <summary> Keeps the sample of the training set whose loss the relative loss criterion measures. Other criteria ignore it. </summary>
+        ///
+        /// <param name="anyDataset"> The training set. </param>
+        void SetTrainingDataset(const data::AnyDataset& anyDataset);
+
+        /// <summary> Keeps the validation set whose loss the validation plateau criterion measures. </summary>
+        ///
+        /// <param name="anyDataset"> The validation set. </param>
+        void SetValidationDataset(const data::AnyDataset& anyDataset);
+
+        /// <summary> Returns the weighted mean loss of a predictor on the examples that the criterion measures. </summary>
+        ///
+        /// <typeparam name="LossFunctionType"> A callable with the signature double(double prediction, double label). </typeparam>
+        /// <param name="predictor"> The predictor. </param>
+        /// <param name="lossFunction"> The loss function. </param>
+        ///
+        /// <returns> The mean loss. </returns>
+        template <typename LossFunctionType>
+        double GetLoss(const predictors::LinearPredictor<double>& predictor, LossFunctionType lossFunction) const;
+
+    private:
+        ConvergenceParameters _parameters;
+        data::AutoSupervisedDataset _lossExamples;
+        size_t _stepsSinceCheck = 0;
+        size_t _numChecks = 0;
+        size_t _checksWithoutImprovement = 0;
+        double _lastValue = 0;
+        double _bestValue = 0;
+        bool _hasConverged = false;
+    };
+} // namespace trainers
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Exception.h>
+
+namespace ell
+{
+namespace trainers
+{
+    template <typename LossFunctionType>
+    double ConvergenceMonitor::GetLoss(const predictors::LinearPredictor<double>& predictor, LossFunctionType lossFunction) const
+    {
+        if (_lossExamples.NumExamples() == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, _parameters.criterion == ConvergenceCriterion::validationPlateau ? "the validation plateau criterion needs a validation dataset" : "the relative loss criterion needs a training dataset");
+        }
+
+        const auto& weights = _lossExamples.GetWeights();
+        const auto& labels = _lossExamples.GetLabels();
+        double loss = 0;
+        double totalWeight = 0;
+        for (size_t index = 0; index < _lossExamples.NumExamples(); ++index)
+        {
+            auto prediction = predictor.Predict(_lossExamples.GetExample(index).GetDataVector());
+            loss += weights[index] * lossFunction(prediction, labels[index]);
+            totalWeight += weights[index];
+        }
+        return totalWeight > 0 ? loss / totalWeight : 0.0;
+    }
+} // namespace trainers
+} // namespace ell
+
+#pragma endregion implementation
@@ -20,7 +20,8 @@ namespace trainers
 {
     /// <summary>
     /// Implements an evaluating incremental trainer. This trainer contains another incremental
-    /// trainer and an evaluator, and performs an evaluation after each update.
+    /// trainer and an evaluator, and performs an evaluation after each update. The predictor is
+    /// only requested from the internal trainer when the evaluation is due.
     /// </summary>
     ///
     /// <typeparam name="PredictorType"> The predictor type. </typeparam>
@@ -50,6 +51,16 @@ namespace trainers
         /// <returns> A const reference to the current predictor. </returns>
         const PredictorType& GetPredictor() const override { return _internalTrainer->GetPredictor(); }
 
+        /// <summary> Sets the validation dataset of the internal trainer. </summary>
+        ///
+        /// <param name="anyDataset"> The validation dataset. </param>
+        void SetValidationDataset(const data::AnyDataset& anyDataset) override { _internalTrainer->SetValidationDataset(anyDataset); }
+
+        /// <summary> Returns true if the internal trainer has converged. </summary>
+        ///
+        /// <returns> true if the internal trainer has converged. </returns>
+        bool HasConverged() const override { return _internalTrainer->HasConverged(); }
+
         /// <summary> Gets a const reference to the evaluator. </summary>
         ///
         /// <returns> A shared pointer to the evaluator. </returns>
@@ -103,7 +114,16 @@ namespace trainers
     void EvaluatingTrainer<PredictorType>::Update()
     {
         _internalTrainer->Update();
-        _evaluator->Evaluate(_internalTrainer->GetPredictor());
+
+        // some trainers compute their predictor lazily, so skipped evaluations don't ask for it
+        if (_evaluator->IsEvaluationDue())
+        {
+            _evaluator->Evaluate(_internalTrainer->GetPredictor());
+        }
+        else
+        {
+            _evaluator->SkipEvaluation();
+        }
     }
 
     template <typename PredictorType>
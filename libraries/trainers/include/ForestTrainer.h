@@ -20,6 +20,9 @@
 #include <iostream> // For std::cout in VERBOSE_MODE
 #include <memory>
 #include <queue>
+#include <random>
+#include <string>
+#include <tuple>
 
 namespace ell
 {
@@ -32,6 +35,19 @@ namespace trainers
         double minSplitGain = 0.0;
         size_t maxSplitsPerRound = 0;
         size_t numRounds = 0;
+
+        // the fraction of the examples, chosen uniformly at random, that each tree is trained on
+        double baggingFraction = 1.0;
+
+        // gradient-based one-side sampling: each tree is trained on the fraction gossTopFraction of the examples with
+        // the largest gradients (weak weight times absolute weak label), and on the fraction gossOtherFraction of all
+        // the examples chosen at random from the rest, whose weak weights are scaled up to compensate. Used instead of
+        // bagging when gossOtherFraction > 0
+        double gossTopFraction = 0.0;
+        double gossOtherFraction = 0.0;
+
+        // the random seed of bagging and gradient-based one-side sampling
+        std::string samplingRandomSeed;
     };
 
     /// <summary> Nontemplated base class for forest trainers, provides some reusable internal classes. </summary>
@@ -84,6 +100,9 @@ namespace trainers
 
             // the output of the forest on this example
             double currentOutput = 0;
+
+            // the position of the example in the dataset that was given to SetDataset, which doesn't change when the dataset is sorted
+            size_t exampleIndex = 0;
         };
 
         // keeps statistics about tree nodes
@@ -173,6 +192,14 @@ namespace trainers
         // runs the booster and sets the weak weight and weak labels
         Sums SetWeakWeightsLabels();
 
+        // adds the bias and a tree fit to the weak weights and labels of the dataset, whose sums are `sums`, and returns
+        // false if the root of the tree isn't worth splitting
+        bool AddTree(Sums sums);
+
+        // moves the examples that the next tree is trained on to the start of the dataset, reweights them if
+        // necessary, and returns their number and sums
+        std::tuple<size_t, Sums> SampleExamples();
+
         // updates the currentOutput field in the metadata of a range of examples
         void UpdateCurrentOutputs(double value);
         void UpdateCurrentOutputs(Range range, const EdgePredictorType& edgePredictor);
@@ -187,6 +214,9 @@ namespace trainers
         virtual SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) = 0;
         virtual std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) = 0;
 
+        // finds the split candidates of the children of a node that was just split, by default one child at a time
+        virtual std::vector<SplitCandidate> GetBestSplitRulesAtChildren(size_t interiorNodeIndex, const SplitCandidate& splitCandidate);
+
         //
         // member variables
         //
@@ -203,12 +233,23 @@ namespace trainers
 
         // the data set
         data::Dataset<TrainerExampleType> _dataset;
+
+        // the random engine of bagging and gradient-based one-side sampling
+        std::default_random_engine _samplingRandom;
     };
 } // namespace trainers
 } // namespace ell
 
 #pragma region implementation
 
+#include <utilities/include/Exception.h>
+#include <utilities/include/RandomEngines.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+
 //#define VERBOSE_MODE( x ) x   // uncomment this for very verbose mode
 #define VERBOSE_MODE(x) // uncomment this for nonverbose mode
 
@@ -220,8 +261,18 @@ namespace trainers
     ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ForestTrainer(const BoosterType& booster, const ForestTrainerParameters& parameters) :
         _booster(booster),
         _parameters(parameters),
-        _forest()
+        _forest(),
+        _samplingRandom(utilities::GetRandomEngine(parameters.samplingRandomSeed))
     {
+        if (!(parameters.baggingFraction > 0.0 && parameters.baggingFraction <= 1.0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "baggingFraction must be in (0, 1]");
+        }
+
+        if (parameters.gossTopFraction < 0.0 || parameters.gossOtherFraction < 0.0 || parameters.gossTopFraction + parameters.gossOtherFraction > 1.0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "gossTopFraction and gossOtherFraction must be nonnegative and add up to at most 1");
+        }
     }
 
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
@@ -236,6 +287,7 @@ namespace trainers
             auto& example = _dataset[rowIndex];
             auto prediction = _forest.Predict(example.GetDataVector());
             auto& metadata = example.GetMetadata();
+            metadata.exampleIndex = rowIndex;
             metadata.currentOutput = prediction;
             metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, prediction);
         }
@@ -249,35 +301,56 @@ namespace trainers
         {
             // call the booster and compute sums for the entire data set
             Sums sums = SetWeakWeightsLabels();
+            if (!AddTree(sums))
+            {
+                return;
+            }
+        }
+    }
 
-            // use the computed sums to calaculate the bias term, set it in the forest and the data set
-            double bias = sums.GetMeanLabel();
-            _forest.AddToBias(bias);
-            UpdateCurrentOutputs(bias);
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    bool ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::AddTree(Sums sums)
+    {
+        // use the computed sums to calaculate the bias term, set it in the forest and the data set
+        double bias = sums.GetMeanLabel();
+        _forest.AddToBias(bias);
+        UpdateCurrentOutputs(bias);
 
-            VERBOSE_MODE(_dataset.Print(std::cout));
-            VERBOSE_MODE(std::cout << "\nBoosting iteration\n");
-            VERBOSE_MODE(_forest.PrintLine(std::cout, 1));
+        // the tree is trained on a prefix of the dataset
+        size_t sampleSize;
+        std::tie(sampleSize, sums) = SampleExamples();
 
-            // find split candidate for root node and push it onto the priority queue
-            auto rootSplit = GetBestSplitRuleAtNode(_forest.GetNewRootId(), Range{ 0, _dataset.NumExamples() }, sums);
+        VERBOSE_MODE(_dataset.Print(std::cout));
+        VERBOSE_MODE(std::cout << "\nBoosting iteration\n");
+        VERBOSE_MODE(_forest.PrintLine(std::cout, 1));
 
-            // check for positive gain
-            if (rootSplit.gain < _parameters.minSplitGain || _parameters.maxSplitsPerRound == 0)
-            {
-                return;
-            }
+        // find split candidate for root node and push it onto the priority queue
+        auto rootSplit = GetBestSplitRuleAtNode(_forest.GetNewRootId(), Range{ 0, sampleSize }, sums);
 
-            // reset the queue and add the root split from the graph
-            if (_queue.size() > 0)
-            {
-                _queue = SplitCandidatePriorityQueue();
-            }
-            _queue.push(std::move(rootSplit));
+        // check for positive gain
+        if (rootSplit.gain < _parameters.minSplitGain || _parameters.maxSplitsPerRound == 0)
+        {
+            return false;
+        }
 
-            // start performing splits until the maximum is reached or the queue is empty
-            PerformSplits(_parameters.maxSplitsPerRound);
+        // reset the queue and add the root split from the graph
+        if (_queue.size() > 0)
+        {
+            _queue = SplitCandidatePriorityQueue();
+        }
+        _queue.push(std::move(rootSplit));
+
+        // start performing splits until the maximum is reached or the queue is empty
+        auto treeRootIndex = _forest.NumInteriorNodes();
+        PerformSplits(_parameters.maxSplitsPerRound);
+
+        // the examples that weren't sampled get the output of the new tree too
+        for (size_t rowIndex = sampleSize; rowIndex < _dataset.NumExamples(); ++rowIndex)
+        {
+            auto& example = _dataset[rowIndex];
+            example.GetMetadata().currentOutput += _forest.Predict(example.GetDataVector(), treeRootIndex);
         }
+        return true;
     }
 
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
@@ -309,6 +382,68 @@ namespace trainers
         return sums;
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    auto ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SampleExamples() -> std::tuple<size_t, Sums>
+    {
+        auto numExamples = _dataset.NumExamples();
+        auto useGoss = _parameters.gossOtherFraction > 0.0;
+        if (!useGoss && _parameters.baggingFraction >= 1.0)
+        {
+            Sums sums;
+            for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+            {
+                sums.Increment(_dataset[rowIndex].GetMetadata().weak);
+            }
+            return std::make_tuple(numExamples, sums);
+        }
+
+        size_t sampleSize = 0;
+        if (useGoss)
+        {
+            // move the examples with the largest gradients to the front
+            auto topSize = static_cast<size_t>(_parameters.gossTopFraction * numExamples);
+            auto otherSize = std::min(std::max<size_t>(static_cast<size_t>(_parameters.gossOtherFraction * numExamples), 1), numExamples - topSize);
+            if (topSize > 0)
+            {
+                std::vector<std::pair<double, size_t>> weights(numExamples);
+                for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+                {
+                    const auto& metadata = _dataset[rowIndex].GetMetadata();
+                    weights[rowIndex] = { metadata.weak.weight * std::abs(metadata.weak.label), metadata.exampleIndex };
+                }
+                std::nth_element(weights.begin(), weights.begin() + (topSize - 1), weights.end(), std::greater<std::pair<double, size_t>>());
+
+                std::vector<bool> isTop(numExamples);
+                for (size_t i = 0; i < topSize; ++i)
+                {
+                    isTop[weights[i].second] = true;
+                }
+                _dataset.Partition([&isTop](const TrainerExampleType& example) { return isTop[example.GetMetadata().exampleIndex]; }, 0, numExamples);
+            }
+
+            // sample the other examples uniformly from the rest, and scale their weights up
+            _dataset.RandomPermute(_samplingRandom, topSize, numExamples - topSize, otherSize);
+            double scale = static_cast<double>(numExamples - topSize) / otherSize;
+            for (size_t rowIndex = topSize; rowIndex < topSize + otherSize; ++rowIndex)
+            {
+                _dataset[rowIndex].GetMetadata().weak.weight *= scale;
+            }
+            sampleSize = topSize + otherSize;
+        }
+        else
+        {
+            sampleSize = std::max<size_t>(static_cast<size_t>(_parameters.baggingFraction * numExamples), 1);
+            _dataset.RandomPermute(_samplingRandom, 0, numExamples, sampleSize);
+        }
+
+        Sums sums;
+        for (size_t rowIndex = 0; rowIndex < sampleSize; ++rowIndex)
+        {
+            sums.Increment(_dataset[rowIndex].GetMetadata().weak);
+        }
+        return std::make_tuple(sampleSize, sums);
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::UpdateCurrentOutputs(double value)
     {
@@ -373,17 +508,27 @@ namespace trainers
             }
 
             // queue new split candidates
-            for (size_t i = 0; i < splitCandidate.splitRule.NumOutputs(); ++i)
+            for (auto& childSplitCandidate : GetBestSplitRulesAtChildren(interiorNodeIndex, splitCandidate))
             {
-                auto splitCandidate = GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i));
-                if (splitCandidate.gain > _parameters.minSplitGain)
+                if (childSplitCandidate.gain > _parameters.minSplitGain)
                 {
-                    _queue.push(std::move(splitCandidate));
+                    _queue.push(std::move(childSplitCandidate));
                 }
             }
         }
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    auto ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::GetBestSplitRulesAtChildren(size_t interiorNodeIndex, const SplitCandidate& splitCandidate) -> std::vector<SplitCandidate>
+    {
+        std::vector<SplitCandidate> childSplitCandidates;
+        for (size_t i = 0; i < splitCandidate.splitRule.NumOutputs(); ++i)
+        {
+            childSplitCandidates.push_back(GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), splitCandidate.ranges.GetChildRange(i), splitCandidate.stats.GetChildSums(i)));
+        }
+        return childSplitCandidates;
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SortNodeDataset(Range range, const SplitRuleType& splitRule)
     {
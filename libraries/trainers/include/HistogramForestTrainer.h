@@ -14,8 +14,11 @@
 #include <predictors/include/ConstantPredictor.h>
 #include <predictors/include/SingleElementThresholdPredictor.h>
 
+#include <cstdint>
+#include <map>
 #include <random>
-#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace ell
 {
@@ -29,7 +32,14 @@ namespace trainers
         size_t candidatesPerInput;
     };
 
-    /// <summary> A histogram trainer for binary decision forests with threshold split rules and constant outputs. </summary>
+    /// <summary>
+    /// A histogram trainer for binary decision forests with threshold split rules and constant outputs. When the
+    /// dataset is set, the threshold finder chooses the thresholds of each feature from a sample of the examples,
+    /// and each feature value is replaced by the index of its bin between two thresholds, stored column-wise as a
+    /// byte. The split of a node is chosen from the per-bin sums of the node's examples, which are collected on
+    /// several threads, and the sums of the larger child of a split are the sums of its parent minus the sums of
+    /// its sibling.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> The loss function type. </typeparam>
     /// <typeparam name="BoosterType"> The booster type. </typeparam>
@@ -38,6 +48,9 @@ namespace trainers
     class HistogramForestTrainer : public ForestTrainer<predictors::SingleElementThresholdPredictor, predictors::ConstantPredictor, BoosterType>
     {
     public:
+        /// <summary> The maximum number of bins of a feature, so that a bin index fits in a byte. </summary>
+        static constexpr size_t maxBinsPerFeature = 255;
+
         /// <summary> Constructs an instance of HistogramForestTrainer. </summary>
         ///
         /// <param name="lossFunction"> The loss function. </param>
@@ -51,24 +64,39 @@ namespace trainers
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplitCandidate;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplittableNodeId;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeStats;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeRanges;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Range;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Sums;
 
+        /// <summary> Sets the trainer's dataset, and assigns each feature value to its bin. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
+
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_forest;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_parameters;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
+        std::vector<SplitCandidate> GetBestSplitRulesAtChildren(size_t interiorNodeIndex, const SplitCandidate& splitCandidate) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
     private:
-        struct EvaluateSplitRuleResult
+        // the sums and the number of examples of a bin
+        struct BinStats
         {
-            Sums sums0;
-            size_t size0;
+            Sums sums;
+            size_t size = 0;
         };
 
+        // the bins of all the features, one feature after the other
+        using Histogram = std::vector<BinStats>;
+
         double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
         std::vector<SplitRuleType> CallThresholdFinder(Range range);
-        std::tuple<Sums, size_t> EvaluateSplitRule(const SplitRuleType& splitRule, const Range& range) const;
+        void BinFeatures();
+        Histogram BuildHistogram(const Range& range) const;
+        SplitCandidate GetBestSplitRuleFromHistogram(SplittableNodeId nodeId, Range range, Sums sums, const Histogram& histogram) const;
 
         // member variables
         LossFunctionType _lossFunction;
@@ -76,6 +104,18 @@ namespace trainers
         std::default_random_engine _random;
         size_t _thresholdFinderSampleSize;
         size_t _candidatesPerInput;
+
+        // the sorted thresholds of each feature, where bin i holds the values in (threshold[i - 1], threshold[i]]
+        std::vector<std::vector<double>> _thresholds;
+
+        // the index of the first bin of each feature in a histogram, followed by the total number of bins
+        std::vector<size_t> _binOffsets;
+
+        // the bin of each feature value, column-wise, where each column is indexed by the example index in the metadata
+        std::vector<uint8_t> _bins;
+
+        // the histograms of the nodes that may still be split in the current tree, keyed by their ranges
+        std::map<std::pair<size_t, size_t>, Histogram> _histograms;
     };
 
     /// <summary> Makes a simple forest trainer. </summary>
@@ -93,6 +133,11 @@ namespace trainers
 #pragma region implementation
 
 #include <utilities/include/RandomEngines.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <future>
+#include <thread>
 
 namespace ell
 {
@@ -110,33 +155,66 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
-    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
+    void HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::SetDataset(const data::AnyDataset& anyDataset)
     {
-        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+        ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SetDataset(anyDataset);
+        BinFeatures();
+    }
 
-        auto splitRuleCandidates = CallThresholdFinder(range);
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
+    {
+        // this is only called for the root of a new tree, the children of a split are handled by GetBestSplitRulesAtChildren
+        _histograms.clear();
 
-        for (const auto& splitRuleCandidate : splitRuleCandidates)
-        {
-            Sums sums0;
-            size_t size0;
+        auto histogram = BuildHistogram(range);
+        auto splitCandidate = GetBestSplitRuleFromHistogram(nodeId, range, sums, histogram);
+        _histograms[{ range.firstIndex, range.size }] = std::move(histogram);
+        return splitCandidate;
+    }
 
-            std::tie(sums0, size0) = EvaluateSplitRule(splitRuleCandidate, range);
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRulesAtChildren(size_t interiorNodeIndex, const SplitCandidate& splitCandidate) -> std::vector<SplitCandidate>
+    {
+        auto totalRange = splitCandidate.ranges.GetTotalRange();
+        Range childRanges[] = { splitCandidate.ranges.GetChildRange(0), splitCandidate.ranges.GetChildRange(1) };
+        Histogram childHistograms[2];
 
-            Sums sums1 = sums - sums0;
-            double gain = CalculateGain(sums, sums0, sums1);
+        // build the histogram of the smaller child, and subtract it from the parent's to get the larger child's
+        size_t smallerChild = childRanges[0].size <= childRanges[1].size ? 0 : 1;
+        size_t largerChild = 1 - smallerChild;
+        childHistograms[smallerChild] = BuildHistogram(childRanges[smallerChild]);
 
-            // find gain maximizer
-            if (gain > bestSplitCandidate.gain)
+        auto parentIterator = _histograms.find({ totalRange.firstIndex, totalRange.size });
+        if (parentIterator != _histograms.end())
+        {
+            childHistograms[largerChild] = std::move(parentIterator->second);
+            _histograms.erase(parentIterator);
+            for (size_t i = 0; i < childHistograms[largerChild].size(); ++i)
             {
-                bestSplitCandidate.gain = gain;
-                bestSplitCandidate.splitRule = splitRuleCandidate;
-                bestSplitCandidate.ranges.SplitChildRange(0, size0);
-                bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
+                auto& binStats = childHistograms[largerChild][i];
+                const auto& siblingBinStats = childHistograms[smallerChild][i];
+                binStats.sums = binStats.sums - siblingBinStats.sums;
+                binStats.size -= siblingBinStats.size;
             }
         }
+        else
+        {
+            childHistograms[largerChild] = BuildHistogram(childRanges[largerChild]);
+        }
 
-        return bestSplitCandidate;
+        std::vector<SplitCandidate> childSplitCandidates;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            childSplitCandidates.push_back(GetBestSplitRuleFromHistogram(_forest.GetChildId(interiorNodeIndex, i), childRanges[i], splitCandidate.stats.GetChildSums(i), childHistograms[i]));
+
+            // only the children that are queued for a split need their histograms
+            if (childSplitCandidates.back().gain > _parameters.minSplitGain)
+            {
+                _histograms[{ childRanges[i].firstIndex, childRanges[i].size }] = std::move(childHistograms[i]);
+            }
+        }
+        return childSplitCandidates;
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
@@ -164,34 +242,174 @@ namespace trainers
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
     auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::CallThresholdFinder(Range range) -> std::vector<SplitRuleType>
     {
-        // uniformly choose _candidatesPerInput from the range, without replacement
-        _dataset.RandomPermute(_random, range.firstIndex, range.size, _thresholdFinderSampleSize);
+        // uniformly choose _thresholdFinderSampleSize examples from the range, without replacement
+        auto sampleSize = std::min(_thresholdFinderSampleSize, range.size);
+        _dataset.RandomPermute(_random, range.firstIndex, range.size, sampleSize);
 
-        auto thresholds = _thresholdFinder.GetThresholds(_dataset.GetExampleReferenceIterator(range.firstIndex, _thresholdFinderSampleSize));
+        auto thresholds = _thresholdFinder.GetThresholds(_dataset.GetExampleReferenceIterator(range.firstIndex, sampleSize));
         return thresholds;
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
-    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::EvaluateSplitRule(const SplitRuleType& splitRule, const Range& range) const -> std::tuple<Sums, size_t>
+    void HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::BinFeatures()
     {
-        Sums sums0;
-        size_t size0 = 0;
+        auto numExamples = _dataset.NumExamples();
+        _thresholds.clear();
+        _histograms.clear();
+        if (numExamples > 0)
+        {
+            for (const auto& splitRule : CallThresholdFinder(Range{ 0, numExamples }))
+            {
+                auto index = splitRule.GetElementIndex();
+                if (_thresholds.size() <= index)
+                {
+                    _thresholds.resize(index + 1);
+                }
+                _thresholds[index].push_back(splitRule.GetThreshold());
+            }
+        }
 
-        auto exampleIterator = _dataset.GetExampleIterator(range.firstIndex, range.size);
-        while (exampleIterator.IsValid())
+        // keep evenly spaced thresholds of the features that have too many of them
+        auto maxThresholds = std::min(_candidatesPerInput, maxBinsPerFeature - 1);
+        for (auto& featureThresholds : _thresholds)
         {
-            const auto& example = exampleIterator.Get();
-            auto prediction = splitRule.Predict(example.GetDataVector());
-            if (prediction == 0)
+            std::sort(featureThresholds.begin(), featureThresholds.end());
+            featureThresholds.erase(std::unique(featureThresholds.begin(), featureThresholds.end()), featureThresholds.end());
+            if (featureThresholds.size() > maxThresholds)
             {
-                sums0.Increment(example.GetMetadata().weak);
-                ++size0;
+                std::vector<double> keptThresholds(maxThresholds);
+                for (size_t i = 0; i < maxThresholds; ++i)
+                {
+                    keptThresholds[i] = featureThresholds[((i + 1) * featureThresholds.size()) / (maxThresholds + 1)];
+                }
+                featureThresholds = std::move(keptThresholds);
             }
-            exampleIterator.Next();
         }
 
-        return std::make_tuple(sums0, size0);
-    };
+        auto numFeatures = _thresholds.size();
+        _binOffsets.assign(1, 0);
+        for (const auto& featureThresholds : _thresholds)
+        {
+            _binOffsets.push_back(_binOffsets.back() + featureThresholds.size() + 1);
+        }
+
+        _bins.assign(numFeatures * numExamples, 0);
+        for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+        {
+            const auto& example = _dataset[rowIndex];
+            const auto& dataVector = example.GetDataVector();
+            auto exampleIndex = example.GetMetadata().exampleIndex;
+            auto prefixLength = std::min(dataVector.PrefixLength(), numFeatures);
+            for (size_t j = 0; j < numFeatures; ++j)
+            {
+                // the bin of a value is the number of thresholds that are smaller than it
+                double value = j < prefixLength ? dataVector[j] : 0.0;
+                const auto& featureThresholds = _thresholds[j];
+                auto bin = std::lower_bound(featureThresholds.begin(), featureThresholds.end(), value) - featureThresholds.begin();
+                _bins[j * numExamples + exampleIndex] = static_cast<uint8_t>(bin);
+            }
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::BuildHistogram(const Range& range) const -> Histogram
+    {
+        Histogram histogram(_binOffsets.back());
+        auto numExamples = _dataset.NumExamples();
+        auto numFeatures = _thresholds.size();
+        if (numFeatures == 0 || range.size == 0)
+        {
+            return histogram;
+        }
+
+        // gather the example indices and weak labels of the range once, for all features
+        std::vector<size_t> exampleIndices(range.size);
+        std::vector<data::WeightLabel> weightLabels(range.size);
+        for (size_t i = 0; i < range.size; ++i)
+        {
+            const auto& metadata = _dataset[range.firstIndex + i].GetMetadata();
+            exampleIndices[i] = metadata.exampleIndex;
+            weightLabels[i] = metadata.weak;
+        }
+
+        // each thread fills the bins of a different set of features
+        auto addFeatures = [&](size_t firstFeature, size_t endFeature) {
+            for (size_t j = firstFeature; j < endFeature; ++j)
+            {
+                const auto* column = _bins.data() + j * numExamples;
+                auto* featureHistogram = histogram.data() + _binOffsets[j];
+                for (size_t i = 0; i < range.size; ++i)
+                {
+                    auto& binStats = featureHistogram[column[exampleIndices[i]]];
+                    binStats.sums.Increment(weightLabels[i]);
+                    ++binStats.size;
+                }
+            }
+        };
+
+        const size_t minBinUpdatesPerThread = 1 << 16;
+        size_t numThreads = std::min<size_t>({ std::max(std::thread::hardware_concurrency(), 1u), numFeatures, (range.size * numFeatures) / minBinUpdatesPerThread });
+        if (numThreads <= 1)
+        {
+            addFeatures(0, numFeatures);
+            return histogram;
+        }
+
+        std::vector<std::future<void>> tasks;
+        for (size_t t = 1; t < numThreads; ++t)
+        {
+            tasks.push_back(utilities::GetHostThreadPool().AddTask(addFeatures, (t * numFeatures) / numThreads, ((t + 1) * numFeatures) / numThreads));
+        }
+        addFeatures(0, numFeatures / numThreads);
+        for (auto& task : tasks)
+        {
+            utilities::GetHostThreadPool().GetResult(task);
+        }
+        return histogram;
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRuleFromHistogram(SplittableNodeId nodeId, Range range, Sums sums, const Histogram& histogram) const -> SplitCandidate
+    {
+        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+
+        for (size_t j = 0; j < _thresholds.size(); ++j)
+        {
+            // the examples in bins 0 to i go to child 0 of a split at threshold i
+            const auto* featureHistogram = histogram.data() + _binOffsets[j];
+            Sums sums0;
+            size_t size0 = 0;
+            for (size_t i = 0; i < _thresholds[j].size(); ++i)
+            {
+                sums0.sumWeights += featureHistogram[i].sums.sumWeights;
+                sums0.sumWeightedLabels += featureHistogram[i].sums.sumWeightedLabels;
+                size0 += featureHistogram[i].size;
+                if (size0 == 0)
+                {
+                    continue;
+                }
+                if (size0 == range.size)
+                {
+                    break;
+                }
+
+                Sums sums1 = sums - sums0;
+                double gain = CalculateGain(sums, sums0, sums1);
+
+                // find gain maximizer
+                if (gain > bestSplitCandidate.gain)
+                {
+                    bestSplitCandidate.gain = gain;
+                    bestSplitCandidate.splitRule = SplitRuleType{ j, _thresholds[j][i] };
+                    bestSplitCandidate.ranges = NodeRanges(range);
+                    bestSplitCandidate.ranges.SplitChildRange(0, size0);
+                    bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
+                }
+            }
+        }
+
+        return bestSplitCandidate;
+    }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
     std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeHistogramForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters)
@@ -40,6 +40,16 @@ namespace trainers
         ///
         /// <returns> A const reference to the current predictor. </returns>
         virtual const PredictorType& GetPredictor() const = 0;
+
+        /// <summary> Sets the dataset whose loss a validation plateau convergence criterion measures. Trainers without one ignore it. </summary>
+        ///
+        /// <param name="anyDataset"> The validation dataset. </param>
+        virtual void SetValidationDataset(const data::AnyDataset& anyDataset) {}
+
+        /// <summary> Returns true if the trainer has met its convergence criterion, after which updates do nothing. </summary>
+        ///
+        /// <returns> true if the trainer has converged. </returns>
+        virtual bool HasConverged() const { return false; }
     };
 } // namespace trainers
 } // namespace ell
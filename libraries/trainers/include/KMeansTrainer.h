@@ -13,12 +13,16 @@
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace ell
 {
 namespace trainers
 {
-    /// <summary> Impements KMeansTrainer++ algorithm </summary>
+    /// <summary>
+    /// Impements KMeansTrainer++ algorithm. The iterations keep Hamerly's bounds on the distance of each point to its
+    /// closest and second closest mean, and skip the distance computations that the triangle inequality rules out.
+    /// </summary>
     ///
     class KMeansTrainer
     {
@@ -32,16 +36,18 @@ namespace trainers
         /// <param name="dimension"> The input dimension. </param>
         /// <param name="numClusters"> The number of clusters. </param>
         /// <param name="iterations"> The number of iterations. </param>
+        /// <param name="numThreads"> The number of threads, or 0 to use all the hardware threads. </param>
         ///
-        KMeansTrainer(size_t dimension, size_t numClusters, size_t iterations);
+        KMeansTrainer(size_t dimension, size_t numClusters, size_t iterations, size_t numThreads = 1);
 
         /// <summary> Constructs an instance of KMeansTrainer trainer </summary>
         ///
         /// <param name="numClusters"> The number of clusters. </param>
         /// <param name="iterations"> The number of iterations. </param>
         /// <param name="means"> The cluster means. </param>
+        /// <param name="numThreads"> The number of threads, or 0 to use all the hardware threads. </param>
         ///
-        KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means);
+        KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means, size_t numThreads = 1);
 
         /// <summary> Runs the KMeansTrainer algorithm. </summary>
         ///
@@ -49,6 +55,17 @@ namespace trainers
         ///
         void RunKMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X);
 
+        /// <summary>
+        /// Runs one step of mini-batch k-means: each point of the batch is assigned to its closest mean, and moves
+        /// that mean towards it with a step size of one over the number of points that the mean has been assigned
+        /// so far. Calling this on a stream of batches clusters datasets that do not fit in memory. The first batch
+        /// initializes the means, unless they were given to the constructor.
+        /// </summary>
+        ///
+        /// <param name="batch"> The batch, with one point in each column. </param>
+        ///
+        void UpdateMiniBatch(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> batch);
+
         /// <summary> Returns the underlying cluster means. </summary>
         ///
         /// <returns> The underlying cluster means matrix. </returns>
@@ -66,11 +83,18 @@ namespace trainers
         // Distance of points to all the cluster means.
         math::RowMatrix<double> pairwiseDistance(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> mu);
 
-        // Assign each point to the closest mean.
-        double assignClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment);
+        // Assign each point to the closest mean, and set the bounds of its distances to the closest and second closest means.
+        void assignClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment);
+
+        // Update the bounds after the means moved, and reassign the points whose bounds do not rule out a closer mean. Returns the number of reassigned points.
+        size_t updateClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment);
+
+        // Recompute the cluster means, and the distance that each mean moved.
+        void recomputeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, const math::ColumnVector<size_t>& clusterAssignment);
 
-        // Recompute the cluster means.
-        void recomputeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, const math::ColumnVector<size_t> clusterAssignment);
+        // Calls task(begin, end) on slices of [0, count) in parallel, with at least minCountPerThread elements in each slice.
+        template <typename TaskType>
+        void forEachRange(size_t count, size_t minCountPerThread, TaskType task) const;
 
         // Weighted sampling.
         size_t weightedSample(math::ColumnVector<double> weights);
@@ -89,6 +113,19 @@ namespace trainers
 
         // Number of clusters.
         size_t _numClusters = 0;
+
+        // Number of threads.
+        size_t _numThreads = 1;
+
+        // Upper bound of the distance of each point to its mean, and lower bound of its distance to any other mean.
+        std::vector<double> _upperBounds;
+        std::vector<double> _lowerBounds;
+
+        // Distance that each mean moved in the last iteration.
+        std::vector<double> _meanMovements;
+
+        // Number of points assigned to each mean by the mini-batch steps.
+        std::vector<double> _miniBatchCounts;
     };
 } // namespace trainers
 } // namespace ell
@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MulticlassHistogramForestTrainer.h (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "HistogramForestTrainer.h"
+#include "ITrainer.h"
+#include "LogitBooster.h"
+#include "SoftmaxBooster.h"
+
+#include <data/include/Dataset.h>
+
+#include <functions/include/SquaredLoss.h>
+
+#include <predictors/include/ForestPredictor.h>
+
+#include <memory>
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary>
+    /// A histogram trainer for multi-class decision forests with the softmax loss. There is one forest per class, and
+    /// each boosting round adds a tree to each of them. The examples' labels are the indices of their classes. The
+    /// thresholds and the binned feature values are computed once, when the dataset is set, and every class's trees
+    /// are grown from histograms of the same bins, so training a forest for each class costs about as much as the
+    /// trees themselves, rather than a separate trainer per class.
+    /// </summary>
+    ///
+    /// <typeparam name="ThresholdFinderType"> Type of the threshold finder to use. </typeparam>
+    template <typename ThresholdFinderType>
+    class MulticlassHistogramForestTrainer : public ITrainer<std::vector<predictors::SimpleForestPredictor>>
+    {
+    public:
+        /// <summary> Constructs an instance of MulticlassHistogramForestTrainer. </summary>
+        ///
+        /// <param name="numClasses"> The number of classes. </param>
+        /// <param name="thresholdFinder"> The threshold finder. </param>
+        /// <param name="parameters"> Training Parameters. </param>
+        MulticlassHistogramForestTrainer(size_t numClasses, const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters);
+
+        /// <summary> Sets the trainer's dataset, and assigns each feature value to its bin. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset, whose labels are class indices. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
+
+        /// <summary> Performs the boosting rounds, adding a tree to the forest of each class per round. </summary>
+        void Update() override;
+
+        /// <summary> Gets the forest of each class, whose outputs are the logits of the class probabilities. </summary>
+        ///
+        /// <returns> The forests. </returns>
+        const std::vector<predictors::SimpleForestPredictor>& GetPredictor() const override { return _forests; }
+
+    private:
+        // grows the trees of one class at a time, on the bins shared by all the classes
+        class ClassTrainer : public HistogramForestTrainer<functions::SquaredLoss, LogitBooster, ThresholdFinderType>
+        {
+        public:
+            using BaseType = HistogramForestTrainer<functions::SquaredLoss, LogitBooster, ThresholdFinderType>;
+            using typename BaseType::Sums;
+
+            ClassTrainer(const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters);
+
+            // sets the output of each class on each example, indexed by the example index and then by class
+            void InitializeOutputs(const std::vector<predictors::SimpleForestPredictor>& forests, std::vector<double>& outputs) const;
+
+            // runs the booster on every example, for all the classes at once
+            void SetWeakWeightLabels(const SoftmaxBooster& booster, size_t numClasses, const std::vector<double>& outputs, std::vector<data::WeightLabel>& weakWeightLabels) const;
+
+            // adds a tree to the forest of a class, and updates the class's outputs
+            void AddClassTree(size_t classIndex, size_t numClasses, const std::vector<data::WeightLabel>& weakWeightLabels, std::vector<double>& outputs, predictors::SimpleForestPredictor& forest);
+
+        private:
+            using BaseType::_dataset;
+            using BaseType::_forest;
+        };
+
+        size_t _numClasses;
+        HistogramForestTrainerParameters _parameters;
+        SoftmaxBooster _booster;
+        ClassTrainer _classTrainer;
+        std::vector<predictors::SimpleForestPredictor> _forests;
+
+        // the output of each class and the weak weight and label of each class, per example
+        std::vector<double> _outputs;
+        std::vector<data::WeightLabel> _weakWeightLabels;
+    };
+
+    /// <summary> Makes a multi-class histogram forest trainer. </summary>
+    ///
+    /// <typeparam name="ThresholdFinderType"> Type of the threshold finder to use. </typeparam>
+    /// <param name="numClasses"> The number of classes. </param>
+    /// <param name="thresholdFinder"> The threshold finder. </param>
+    /// <param name="parameters"> The trainer parameters. </param>
+    ///
+    /// <returns> A unique_ptr to a multi-class forest trainer. </returns>
+    template <typename ThresholdFinderType>
+    std::unique_ptr<ITrainer<std::vector<predictors::SimpleForestPredictor>>> MakeMulticlassHistogramForestTrainer(size_t numClasses, const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters);
+} // namespace trainers
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Exception.h>
+
+#include <utility>
+
+namespace ell
+{
+namespace trainers
+{
+    template <typename ThresholdFinderType>
+    MulticlassHistogramForestTrainer<ThresholdFinderType>::ClassTrainer::ClassTrainer(const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters) :
+        BaseType(functions::SquaredLoss(), LogitBooster(), thresholdFinder, parameters)
+    {
+    }
+
+    template <typename ThresholdFinderType>
+    void MulticlassHistogramForestTrainer<ThresholdFinderType>::ClassTrainer::InitializeOutputs(const std::vector<predictors::SimpleForestPredictor>& forests, std::vector<double>& outputs) const
+    {
+        auto numClasses = forests.size();
+        outputs.assign(_dataset.NumExamples() * numClasses, 0.0);
+        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
+        {
+            const auto& example = _dataset[rowIndex];
+            auto exampleIndex = example.GetMetadata().exampleIndex;
+            for (size_t c = 0; c < numClasses; ++c)
+            {
+                outputs[exampleIndex * numClasses + c] = forests[c].Predict(example.GetDataVector());
+            }
+        }
+    }
+
+    template <typename ThresholdFinderType>
+    void MulticlassHistogramForestTrainer<ThresholdFinderType>::ClassTrainer::SetWeakWeightLabels(const SoftmaxBooster& booster, size_t numClasses, const std::vector<double>& outputs, std::vector<data::WeightLabel>& weakWeightLabels) const
+    {
+        weakWeightLabels.resize(outputs.size());
+        std::vector<double> predictions(numClasses);
+        std::vector<data::WeightLabel> exampleWeakWeightLabels(numClasses);
+        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
+        {
+            const auto& metadata = _dataset[rowIndex].GetMetadata();
+            auto offset = metadata.exampleIndex * numClasses;
+            if (metadata.strong.label < 0 || metadata.strong.label >= static_cast<double>(numClasses))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "MulticlassHistogramForestTrainer: example labels must be class indices");
+            }
+
+            std::copy(outputs.begin() + offset, outputs.begin() + offset + numClasses, predictions.begin());
+            booster.GetWeakWeightLabels(metadata.strong, predictions, exampleWeakWeightLabels);
+            std::copy(exampleWeakWeightLabels.begin(), exampleWeakWeightLabels.end(), weakWeightLabels.begin() + offset);
+        }
+    }
+
+    template <typename ThresholdFinderType>
+    void MulticlassHistogramForestTrainer<ThresholdFinderType>::ClassTrainer::AddClassTree(size_t classIndex, size_t numClasses, const std::vector<data::WeightLabel>& weakWeightLabels, std::vector<double>& outputs, predictors::SimpleForestPredictor& forest)
+    {
+        Sums sums;
+        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
+        {
+            auto& metadata = _dataset[rowIndex].GetMetadata();
+            auto index = metadata.exampleIndex * numClasses + classIndex;
+            metadata.weak = weakWeightLabels[index];
+            metadata.currentOutput = outputs[index];
+            sums.Increment(metadata.weak);
+        }
+
+        if (sums.sumWeights == 0.0)
+        {
+            return;
+        }
+
+        // the trainer grows the class's forest in place of its own
+        std::swap(_forest, forest);
+        this->AddTree(sums);
+        std::swap(_forest, forest);
+
+        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
+        {
+            const auto& metadata = _dataset[rowIndex].GetMetadata();
+            outputs[metadata.exampleIndex * numClasses + classIndex] = metadata.currentOutput;
+        }
+    }
+
+    template <typename ThresholdFinderType>
+    MulticlassHistogramForestTrainer<ThresholdFinderType>::MulticlassHistogramForestTrainer(size_t numClasses, const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters) :
+        _numClasses(numClasses),
+        _parameters(parameters),
+        _classTrainer(thresholdFinder, parameters),
+        _forests(numClasses)
+    {
+        if (numClasses < 2)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "MulticlassHistogramForestTrainer: there must be at least two classes");
+        }
+    }
+
+    template <typename ThresholdFinderType>
+    void MulticlassHistogramForestTrainer<ThresholdFinderType>::SetDataset(const data::AnyDataset& anyDataset)
+    {
+        _classTrainer.SetDataset(anyDataset);
+        _classTrainer.InitializeOutputs(_forests, _outputs);
+    }
+
+    template <typename ThresholdFinderType>
+    void MulticlassHistogramForestTrainer<ThresholdFinderType>::Update()
+    {
+        for (size_t round = 0; round < _parameters.numRounds; ++round)
+        {
+            // the class probabilities depend on the outputs of all the classes, so the booster runs before any of the round's trees are added
+            _classTrainer.SetWeakWeightLabels(_booster, _numClasses, _outputs, _weakWeightLabels);
+            for (size_t c = 0; c < _numClasses; ++c)
+            {
+                _classTrainer.AddClassTree(c, _numClasses, _weakWeightLabels, _outputs, _forests[c]);
+            }
+        }
+    }
+
+    template <typename ThresholdFinderType>
+    std::unique_ptr<ITrainer<std::vector<predictors::SimpleForestPredictor>>> MakeMulticlassHistogramForestTrainer(size_t numClasses, const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters)
+    {
+        return std::make_unique<MulticlassHistogramForestTrainer<ThresholdFinderType>>(numClasses, thresholdFinder, parameters);
+    }
+} // namespace trainers
+} // namespace ell
+
+#pragma endregion implementation
@@ -21,10 +21,13 @@ namespace trainers
     class ProtoNNInit
     {
     public:
-        /// <summary> Returns the underlying projection matrix. </summary>
+        /// <summary> Constructs the ProtoNN initializer. </summary>
         ///
-        /// <returns> The underlying projection matrix. </returns>
-        ProtoNNInit(size_t dim, size_t numLabels, size_t numPrototypesPerLabel);
+        /// <param name="dim"> The projected dimension. </param>
+        /// <param name="numLabels"> The number of labels. </param>
+        /// <param name="numPrototypesPerLabel"> The number of prototypes per label. </param>
+        /// <param name="numThreads"> The number of threads of the k-means clustering, or 0 to use all the hardware threads. </param>
+        ProtoNNInit(size_t dim, size_t numLabels, size_t numPrototypesPerLabel, size_t numThreads = 1);
 
         /// <summary> Returns the underlying projection matrix. </summary>
         ///
@@ -51,6 +54,8 @@ namespace trainers
 
         size_t _numPrototypesPerLabel;
 
+        size_t _numThreads;
+
         // Returns the underlying projection matrix.
         math::ColumnMatrix<double> _B;
 
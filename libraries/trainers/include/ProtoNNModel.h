@@ -68,6 +68,15 @@ namespace trainers
 
         ///<summary>Whether to output diagnostic information to std::cout.</summary>
         bool verbose;
+
+        ///<summary>The number of examples in each mini-batch of the gradient steps, or 0 for the default of min(256, number of examples)</summary>
+        size_t batchSize = 0;
+
+        ///<summary>The number of threads, or 0 to use all the hardware threads</summary>
+        size_t numThreads = 1;
+
+        ///<summary>Whether to shuffle the examples once, so that the consecutive examples of each mini-batch are a random sample</summary>
+        bool shuffleExamples = true;
     };
 
 } // namespace trainers
@@ -69,6 +69,9 @@ namespace trainers
         // Initalize parameters in the first iteration
         void Initialize();
 
+        // Shuffle the columns of the data and label matrices
+        void ShuffleExamples();
+
         // The Similarity Kernel.
         math::ColumnMatrix<double> SimilarityKernel(ConstColumnMatrixReference X, math::ColumnMatrixReference<double> WX, const double gamma, const size_t begin, const size_t end, bool recomputeWX = false);
 
@@ -103,6 +106,8 @@ namespace trainers
 
         ProtoNNTrainerParameters _parameters;
 
+        size_t _numThreads;
+
         predictors::ProtoNNPredictor _protoNNPredictor;
 
         // Map holding the model parameters
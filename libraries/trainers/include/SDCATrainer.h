@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include "ConvergenceMonitor.h"
 #include "ITrainer.h"
+#include "SharedWeights.h"
 
 #include <predictors/include/LinearPredictor.h>
 
@@ -17,7 +19,10 @@
 
 #include <math/include/Vector.h>
 
+#include <atomic>
+#include <optional>
 #include <random>
+#include <vector>
 
 namespace ell
 {
@@ -31,6 +36,15 @@ namespace trainers
         size_t maxEpochs;
         bool permute;
         std::string randomSeedString;
+
+        /// <summary>
+        /// The number of threads that update the dual variables of an in-memory dataset in each epoch, or 0 to use
+        /// all the hardware threads. A value of 1 updates the dual variables one after the other.
+        /// </summary>
+        size_t numThreads = 1;
+
+        /// <summary> When to stop training early. Each duality gap check in the middle of an epoch costs a pass over the dataset. </summary>
+        ConvergenceParameters convergence;
     };
 
     /// <summary> Information about the result of an SDCA training session. </summary>
@@ -41,7 +55,11 @@ namespace trainers
         size_t numEpochsPerformed = 0;
     };
 
-    /// <summary> Implements the stochastic dual coordinate ascent linear trainer. </summary>
+    /// <summary>
+    /// Implements the stochastic dual coordinate ascent linear trainer. With more than one thread, each thread
+    /// updates the dual variables of its own part of the dataset, and adds the changes to the shared primal state
+    /// without locks, as in PassCoDe-Atomic. The regularizer must be a sum of functions of the coordinates.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     /// <typeparam name="RegularizerType"> Regularizer type. </typeparam>
@@ -56,7 +74,10 @@ namespace trainers
         /// <param name="parameters"> Trainer parameters. </param>
         SDCATrainer(const LossFunctionType& lossFunction, const RegularizerType& regularizer, const SDCATrainerParameters& parameters);
 
-        /// <summary> Sets the trainer's dataset. </summary>
+        /// <summary>
+        /// Sets the trainer's dataset. A StreamingDataset is read from disk in each epoch, and only its dual
+        /// variables are kept in memory; any other dataset is copied into memory.
+        /// </summary>
         ///
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
@@ -74,6 +95,21 @@ namespace trainers
         /// <returns> Information on the trained predictor. </returns>
         SDCAPredictorInfo GetPredictorInfo() const { return _predictorInfo; }
 
+        /// <summary> Sets the dataset whose loss the validation plateau criterion measures. </summary>
+        ///
+        /// <param name="anyDataset"> The validation dataset. </param>
+        void SetValidationDataset(const data::AnyDataset& anyDataset) override { _convergenceMonitor.SetValidationDataset(anyDataset); }
+
+        /// <summary> Returns true if the trainer has met its convergence criterion, after which updates do nothing. </summary>
+        ///
+        /// <returns> true if the trainer has converged. </returns>
+        bool HasConverged() const override { return _convergenceMonitor.HasConverged(); }
+
+        /// <summary> Returns the state of the convergence criterion. </summary>
+        ///
+        /// <returns> The convergence monitor. </returns>
+        const ConvergenceMonitor& GetConvergenceMonitor() const { return _convergenceMonitor; }
+
     private:
         struct TrainerMetadata
         {
@@ -93,19 +129,31 @@ namespace trainers
         using TrainerExampleType = data::Example<DataVectorType, TrainerMetadata>;
 
         void Step(TrainerExampleType& x);
+        void ParallelEpoch();
+        void ParallelStep(TrainerExampleType& example, SharedWeights& v, std::atomic<double>& d);
         void ComputeObjectives();
+        bool CheckConvergence(bool areObjectivesCurrent);
+        size_t NumExamples() const;
+
+        // calls function(TrainerExampleType&) on each example of a new epoch of the streaming dataset
+        template <typename FunctionType>
+        void ForEachStreamingExample(FunctionType function);
         void ResizeTo(const data::AutoDataVector& x);
 
         LossFunctionType _lossFunction;
         RegularizerType _regularizer;
         SDCATrainerParameters _parameters;
         std::default_random_engine _random;
+        size_t _numThreads;
         double _inverseScaledRegularization;
 
         data::Dataset<TrainerExampleType> _dataset;
+        std::optional<data::AnyDataset> _streamingDataset;
+        std::vector<double> _streamingDualVariables;
 
         predictors::LinearPredictor<double> _predictor;
         SDCAPredictorInfo _predictorInfo;
+        ConvergenceMonitor _convergenceMonitor;
 
         math::ColumnVector<double> _v;
         double _d = 0;
@@ -133,6 +181,11 @@ namespace trainers
 #include <data/include/DataVectorOperations.h>
 
 #include <utilities/include/RandomEngines.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <future>
+#include <thread>
 
 namespace ell
 {
@@ -142,7 +195,9 @@ namespace trainers
     SDCATrainer<LossFunctionType, RegularizerType>::SDCATrainer(const LossFunctionType& lossFunction, const RegularizerType& regularizer, const SDCATrainerParameters& parameters) :
         _lossFunction(lossFunction),
         _regularizer(regularizer),
-        _parameters(parameters)
+        _parameters(parameters),
+        _numThreads(parameters.numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : parameters.numThreads),
+        _convergenceMonitor(parameters.convergence)
     {
         _random = utilities::GetRandomEngine(parameters.randomSeedString);
     }
@@ -152,13 +207,29 @@ namespace trainers
     {
         DEBUG_THROW(_v.Norm0() != 0, utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "can only call SetDataset before updates"));
 
+        _predictorInfo.primalObjective = 0;
+        _predictorInfo.dualObjective = 0;
+
+        if (anyDataset.IsStreaming())
+        {
+            _streamingDataset = anyDataset;
+            auto numExamples = NumExamples();
+            _streamingDualVariables.assign(numExamples, 0);
+            _inverseScaledRegularization = 1.0 / (numExamples * _parameters.regularization);
+
+            ForEachStreamingExample([&](TrainerExampleType& example) {
+                auto label = example.GetMetadata().weightLabel.label;
+                _predictorInfo.primalObjective += _lossFunction(0, label) / numExamples;
+            });
+            _convergenceMonitor.SetTrainingDataset(anyDataset);
+            return;
+        }
+
         _dataset = data::Dataset<TrainerExampleType>(anyDataset);
+        _streamingDataset.reset();
         auto numExamples = _dataset.NumExamples();
         _inverseScaledRegularization = 1.0 / (numExamples * _parameters.regularization);
 
-        _predictorInfo.primalObjective = 0;
-        _predictorInfo.dualObjective = 0;
-
         // precompute the norm of each example
         for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
         {
@@ -168,24 +239,57 @@ namespace trainers
             auto label = example.GetMetadata().weightLabel.label;
             _predictorInfo.primalObjective += _lossFunction(0, label) / numExamples;
         }
+        _convergenceMonitor.SetTrainingDataset(anyDataset);
     }
 
     template <typename LossFunctionType, typename RegularizerType>
     void SDCATrainer<LossFunctionType, RegularizerType>::Update()
     {
-        if (_parameters.permute)
+        if (HasConverged())
         {
-            _dataset.RandomPermute(_random);
+            return;
         }
 
-        // Iterate
-        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+        bool isCheckedInEpoch = false;
+        if (_streamingDataset)
         {
-            Step(_dataset[i]);
+            // the streaming dataset shuffles each epoch as it reads it
+            ForEachStreamingExample([this](TrainerExampleType& example) { Step(example); });
+        }
+        else
+        {
+            if (_parameters.permute)
+            {
+                _dataset.RandomPermute(_random);
+            }
+
+            // Iterate
+            if (_numThreads > 1)
+            {
+                ParallelEpoch();
+            }
+            else
+            {
+                isCheckedInEpoch = true;
+                for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+                {
+                    Step(_dataset[i]);
+                    if (_convergenceMonitor.CountStep() && CheckConvergence(false))
+                    {
+                        break;
+                    }
+                }
+            }
         }
 
         // Finish
         ComputeObjectives();
+
+        // epochs that weren't checked as they went are checked at their end
+        if (_convergenceMonitor.GetCriterion() != ConvergenceCriterion::none && (_convergenceMonitor.IsCheckedPerEpoch() || !isCheckedInEpoch) && !HasConverged())
+        {
+            CheckConvergence(true);
+        }
     }
 
     template <typename LossFunctionType, typename RegularizerType>
@@ -221,29 +325,149 @@ namespace trainers
         }
     }
 
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ParallelEpoch()
+    {
+        auto numExamples = _dataset.NumExamples();
+        auto numFeatures = _dataset.NumFeatures();
+        if (numFeatures > _predictor.Size())
+        {
+            _predictor.Resize(numFeatures);
+            _v.Resize(numFeatures);
+        }
+
+        // each thread owns the dual variables of an interval of the permuted dataset; small datasets use fewer
+        // threads, since starting a thread costs more than a few steps
+        const size_t minExamplesPerThread = 1 << 10;
+        auto numThreads = std::min(_numThreads, std::max<size_t>(numExamples / minExamplesPerThread, 1));
+        SharedWeights v(_v);
+        std::atomic<double> d(_d);
+        auto processExamples = [this, &v, &d](size_t fromIndex, size_t toIndex) {
+            for (size_t i = fromIndex; i < toIndex; ++i)
+            {
+                ParallelStep(_dataset[i], v, d);
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        for (size_t i = 1; i < numThreads; ++i)
+        {
+            workers.push_back(utilities::GetHostThreadPool().AddTask(processExamples, i * numExamples / numThreads, (i + 1) * numExamples / numThreads));
+        }
+        processExamples(0, numExamples / numThreads);
+        for (auto& worker : workers)
+        {
+            utilities::GetHostThreadPool().GetResult(worker);
+        }
+
+        // the primal predictor is computed once per epoch, from the final dual state
+        v.CopyTo(_v);
+        _d = d.load();
+        _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ParallelStep(TrainerExampleType& example, SharedWeights& v, std::atomic<double>& d)
+    {
+        const auto& dataVector = example.GetDataVector();
+        auto weightLabel = example.GetMetadata().weightLabel;
+        auto norm2Squared = example.GetMetadata().norm2Squared + 1; // add one because of bias term
+        auto lipschitz = norm2Squared * _inverseScaledRegularization;
+        auto dual = example.GetMetadata().dualVariable;
+
+        if (lipschitz > 0)
+        {
+            // the primal weights are the conjugate gradient of the shared dual state, computed one coordinate at a time
+            auto conjugateGradient = [this](double value) { return _regularizer.ConjugateGradient(value); };
+            auto prediction = v.Dot(dataVector, conjugateGradient) + conjugateGradient(d.load(std::memory_order_relaxed));
+
+            auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, weightLabel.label);
+            auto dualDiff = newDual - dual;
+
+            if (dualDiff != 0)
+            {
+                v.Add(dataVector, -dualDiff * _inverseScaledRegularization);
+                AtomicAdd(d, -dualDiff * _inverseScaledRegularization);
+                example.GetMetadata().dualVariable = newDual;
+            }
+        }
+    }
+
     template <typename LossFunctionType, typename RegularizerType>
     void SDCATrainer<LossFunctionType, RegularizerType>::ComputeObjectives()
     {
-        double invSize = 1.0 / _dataset.NumExamples();
+        double invSize = 1.0 / NumExamples();
 
         _predictorInfo.primalObjective = 0;
         _predictorInfo.dualObjective = 0;
 
-        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
-        {
-            const auto& example = _dataset.GetExample(i);
+        auto addObjectives = [&](const TrainerExampleType& example) {
             auto label = example.GetMetadata().weightLabel.label;
             auto prediction = _predictor.Predict(example.GetDataVector());
             auto dualVariable = example.GetMetadata().dualVariable;
 
             _predictorInfo.primalObjective += invSize * _lossFunction(prediction, label);
             _predictorInfo.dualObjective -= invSize * _lossFunction.Conjugate(dualVariable, label);
+        };
+
+        if (_streamingDataset)
+        {
+            ForEachStreamingExample(addObjectives);
+        }
+        else
+        {
+            for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+            {
+                addObjectives(_dataset.GetExample(i));
+            }
         }
 
         _predictorInfo.primalObjective += _parameters.regularization * _regularizer(_predictor.GetWeights(), _predictor.GetBias());
         _predictorInfo.dualObjective -= _parameters.regularization * _regularizer.Conjugate(_v, _d);
     }
 
+    template <typename LossFunctionType, typename RegularizerType>
+    bool SDCATrainer<LossFunctionType, RegularizerType>::CheckConvergence(bool areObjectivesCurrent)
+    {
+        if (_convergenceMonitor.GetCriterion() == ConvergenceCriterion::dualityGap)
+        {
+            if (!areObjectivesCurrent)
+            {
+                ComputeObjectives();
+            }
+            return _convergenceMonitor.AddCheck(_predictorInfo.primalObjective - _predictorInfo.dualObjective);
+        }
+
+        auto loss = _convergenceMonitor.GetLoss(_predictor, [this](double prediction, double label) { return _lossFunction(prediction, label); });
+        return _convergenceMonitor.AddCheck(loss);
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    size_t SDCATrainer<LossFunctionType, RegularizerType>::NumExamples() const
+    {
+        return _streamingDataset ? _streamingDataset->NumExamples() : _dataset.NumExamples();
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    template <typename FunctionType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ForEachStreamingExample(FunctionType function)
+    {
+        // the norms are recomputed as the examples are read, and the dual variables are kept by example index
+        auto reader = _streamingDataset->GetStreamingReader();
+        while (reader.IsValid())
+        {
+            auto example = reader.Get().template CopyAs<TrainerExampleType>();
+            auto& metadata = example.GetMetadata();
+            metadata.norm2Squared = example.GetDataVector().Norm2Squared();
+            metadata.dualVariable = _streamingDualVariables[reader.GetIndex()];
+
+            function(example);
+
+            _streamingDualVariables[reader.GetIndex()] = metadata.dualVariable;
+            reader.Next();
+        }
+    }
+
     template <typename LossFunctionType, typename RegularizerType>
     void SDCATrainer<LossFunctionType, RegularizerType>::ResizeTo(const data::AutoDataVector& x)
     {
@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include "ConvergenceMonitor.h"
 #include "ITrainer.h"
+#include "SharedWeights.h"
 
 #include <predictors/include/LinearPredictor.h>
 
@@ -17,6 +19,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <random>
 #include <string>
 
@@ -29,6 +32,15 @@ namespace trainers
     {
         double regularization;
         std::string randomSeedString;
+
+        /// <summary>
+        /// The number of threads that share the weights of the sparse data trainers in each epoch of an in-memory
+        /// dataset, or 0 to use all the hardware threads. A value of 1 performs the steps one after the other.
+        /// </summary>
+        size_t numThreads = 1;
+
+        /// <summary> When to stop training early. SGD has no duality gap, so it supports the relative loss and validation plateau criteria. </summary>
+        ConvergenceParameters convergence;
     };
 
     /// <summary>
@@ -40,7 +52,10 @@ namespace trainers
     public:
         using PredictorType = predictors::LinearPredictor<double>;
 
-        /// <summary> Sets the trainer's dataset. </summary>
+        /// <summary>
+        /// Sets the trainer's dataset. A StreamingDataset is read from disk in each epoch, and is shuffled by its
+        /// shuffle buffer; any other dataset is copied into memory, and permuted in each epoch.
+        /// </summary>
         ///
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
@@ -53,16 +68,50 @@ namespace trainers
         /// <returns> A const reference to the averaged predictor. </returns>
         const predictors::LinearPredictor<double>& GetPredictor() const override { return GetAveragedPredictor(); }
 
+        /// <summary> Sets the dataset whose loss the validation plateau criterion measures. </summary>
+        ///
+        /// <param name="anyDataset"> The validation dataset. </param>
+        void SetValidationDataset(const data::AnyDataset& anyDataset) override { _convergenceMonitor.SetValidationDataset(anyDataset); }
+
+        /// <summary> Returns true if the trainer has met its convergence criterion, after which updates do nothing. </summary>
+        ///
+        /// <returns> true if the trainer has converged. </returns>
+        bool HasConverged() const override { return _convergenceMonitor.HasConverged(); }
+
+        /// <summary> Returns the state of the convergence criterion. </summary>
+        ///
+        /// <returns> The convergence monitor. </returns>
+        const ConvergenceMonitor& GetConvergenceMonitor() const { return _convergenceMonitor; }
+
     protected:
         // Instances of the base class cannot be created directly
-        SGDTrainerBase(std::string randomSeedString);
+        SGDTrainerBase(std::string randomSeedString, size_t numThreads = 1, const ConvergenceParameters& convergence = {});
         virtual void DoFirstStep(const data::AutoDataVector& x, double y, double weight) = 0;
         virtual void DoNextStep(const data::AutoDataVector& x, double y, double weight) = 0;
         virtual const PredictorType& GetAveragedPredictor() const = 0;
+        virtual double GetLoss(double prediction, double label) const = 0;
+
+        // Performs an epoch of the permuted in-memory dataset with several threads; the default performs the steps one after the other
+        virtual void DoParallelEpoch();
+
+        // Splits the in-memory dataset between the threads, and calls stepFunction(x, y, weight, stepIndex) on each
+        // example, where stepIndex is the zero-based index of the step in the epoch that the thread claimed
+        template <typename StepFunctionType>
+        void ForEachExampleInParallel(StepFunctionType stepFunction);
 
         data::AutoSupervisedDataset _dataset;
+        std::optional<data::AnyDataset> _streamingDataset;
         std::default_random_engine _random;
+        size_t _numThreads;
         bool _firstIteration = true;
+
+    private:
+        // performs the steps of an epoch, and checks the convergence criterion as it goes if isCheckedInEpoch is true
+        template <typename ExampleIteratorType>
+        void DoEpoch(ExampleIteratorType& exampleIterator, bool isCheckedInEpoch);
+        bool CheckConvergence();
+
+        ConvergenceMonitor _convergenceMonitor;
     };
 
     //
@@ -97,6 +146,7 @@ namespace trainers
     protected:
         void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
         void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        double GetLoss(double prediction, double label) const override { return _lossFunction(prediction, label); }
 
     private:
         LossFunctionType _lossFunction;
@@ -113,7 +163,10 @@ namespace trainers
     // SparseDataSGDTrainer - Sparse Data Stochastic Gradient Descent
     //
 
-    /// <summary> Implements the steps of Sparse Data Stochastic Gradient Descent. </summary>
+    /// <summary>
+    /// Implements the steps of Sparse Data Stochastic Gradient Descent. With more than one thread, the threads of an epoch
+    /// share the weights and update them without locks.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     template <typename LossFunctionType>
@@ -141,6 +194,8 @@ namespace trainers
     protected:
         void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
         void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        void DoParallelEpoch() override;
+        double GetLoss(double prediction, double label) const override { return _lossFunction(prediction, label); }
 
     private:
         LossFunctionType _lossFunction;
@@ -165,7 +220,10 @@ namespace trainers
     // SparseDataCenteredSGDTrainer - Sparse Data Centered Stochastic Gradient Descent
     //
 
-    /// <summary> Implements the steps of Sparse Data Centered Stochastic Gradient Descent. </summary>
+    /// <summary>
+    /// Implements the steps of Sparse Data Centered Stochastic Gradient Descent. With more than one thread, the threads of an epoch
+    /// share the weights and update them without locks.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     template <typename LossFunctionType>
@@ -194,6 +252,8 @@ namespace trainers
     protected:
         void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
         void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        void DoParallelEpoch() override;
+        double GetLoss(double prediction, double label) const override { return _lossFunction(prediction, label); }
 
     private:
         LossFunctionType _lossFunction;
@@ -260,7 +320,11 @@ namespace trainers
 
 #pragma region implementation
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <future>
+#include <vector>
 
 #include <data/include/DataVector.h>
 #include <data/include/DataVectorOperations.h>
@@ -268,19 +332,80 @@ namespace trainers
 
 #include <math/include/VectorOperations.h>
 
+#include <utilities/include/ThreadPool.h>
+
 namespace ell
 {
 namespace trainers
 {
     // the code in this file follows the notation and pseudocode in https://arxiv.org/abs/1612.09147
 
+    namespace detail
+    {
+        // returns the harmonic numbers of the steps t, t+1, ..., t+numSteps, given the harmonic number h of step t
+        inline std::vector<double> GetHarmonicNumbers(double t, double h, size_t numSteps)
+        {
+            std::vector<double> harmonicNumbers(numSteps + 1);
+            harmonicNumbers[0] = h;
+            for (size_t i = 1; i <= numSteps; ++i)
+            {
+                harmonicNumbers[i] = harmonicNumbers[i - 1] + 1.0 / (t + i);
+            }
+            return harmonicNumbers;
+        }
+    } // namespace detail
+
+    //
+    // SGDTrainerBase
+    //
+
+    template <typename StepFunctionType>
+    void SGDTrainerBase::ForEachExampleInParallel(StepFunctionType stepFunction)
+    {
+        auto numExamples = _dataset.NumExamples();
+        if (numExamples == 0)
+        {
+            return;
+        }
+
+        // each thread traverses its own interval of the permuted dataset, and claims the index of each step it
+        // performs; small datasets use fewer threads, since starting a thread costs more than a few steps
+        const size_t minExamplesPerThread = 1 << 10;
+        auto numThreads = std::min(_numThreads, std::max<size_t>(numExamples / minExamplesPerThread, 1));
+        std::atomic<size_t> nextStepIndex(0);
+        auto processExamples = [this, &stepFunction, &nextStepIndex](size_t fromIndex, size_t size) {
+            auto exampleIterator = _dataset.GetExampleReferenceIterator(fromIndex, size);
+            while (exampleIterator.IsValid())
+            {
+                const auto& example = exampleIterator.Get();
+                auto stepIndex = nextStepIndex.fetch_add(1, std::memory_order_relaxed);
+                stepFunction(example.GetDataVector(), example.GetMetadata().label, example.GetMetadata().weight, stepIndex);
+                exampleIterator.Next();
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        for (size_t i = 1; i < numThreads; ++i)
+        {
+            auto fromIndex = i * numExamples / numThreads;
+            auto toIndex = (i + 1) * numExamples / numThreads;
+            workers.push_back(utilities::GetHostThreadPool().AddTask(processExamples, fromIndex, toIndex - fromIndex));
+        }
+        processExamples(0, numExamples / numThreads);
+        for (auto& worker : workers)
+        {
+            utilities::GetHostThreadPool().GetResult(worker);
+        }
+        _firstIteration = false;
+    }
+
     //
     // SGDTrainer
     //
 
     template <typename LossFunctionType>
     SGDTrainer<LossFunctionType>::SGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters) :
-        SGDTrainerBase(parameters.randomSeedString),
+        SGDTrainerBase(parameters.randomSeedString, 1, parameters.convergence),
         _lossFunction(lossFunction),
         _parameters(parameters)
     {
@@ -347,7 +472,7 @@ namespace trainers
 
     template <typename LossFunctionType>
     SparseDataSGDTrainer<LossFunctionType>::SparseDataSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters) :
-        SGDTrainerBase(parameters.randomSeedString),
+        SGDTrainerBase(parameters.randomSeedString, parameters.numThreads, parameters.convergence),
         _lossFunction(lossFunction),
         _parameters(parameters)
     {
@@ -387,6 +512,61 @@ namespace trainers
         _h += 1.0 / _t;
     }
 
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::DoParallelEpoch()
+    {
+        auto numSteps = _dataset.NumExamples();
+        auto numFeatures = _dataset.NumFeatures();
+        if (numFeatures > _v.Size())
+        {
+            _v.Resize(numFeatures);
+            _u.Resize(numFeatures);
+        }
+
+        // the threads only add to _v, _u, _a, and to the harmonic-weighted gradient sum of the bias, so each step
+        // can be applied in any order; _h and _c are recovered from these sums at the end of the epoch
+        const double lambda = _parameters.regularization;
+        const double t0 = _t;
+        const double h0 = _h;
+        const double a0 = _a;
+        auto harmonicNumbers = detail::GetHarmonicNumbers(_t, _h, numSteps);
+        SharedWeights v(_v);
+        SharedWeights u(_u);
+        std::atomic<double> a(_a);
+        std::atomic<double> b(0);
+
+        ForEachExampleInParallel([&](const data::AutoDataVector& x, double y, double weight, size_t stepIndex) {
+            double t = t0 + stepIndex + 1;
+
+            // apply the predictor, which is zero before the first step
+            double p = 0;
+            if (t > 1.0)
+            {
+                double d = v.Dot(x);
+                p = -(d + a.load(std::memory_order_relaxed)) / (lambda * (t - 1.0));
+            }
+
+            // get the derivative
+            double g = weight * _lossFunction.GetDerivative(p, y);
+
+            // update
+            double h = harmonicNumbers[stepIndex];
+            v.Add(x, g);
+            u.Add(x, h * g);
+            AtomicAdd(a, g);
+            AtomicAdd(b, h * g);
+        });
+
+        v.CopyTo(_v);
+        u.CopyTo(_u);
+        _a = a.load();
+        _t = t0 + numSteps;
+        _h = harmonicNumbers[numSteps];
+
+        // the sum of _a / t over the steps of the epoch
+        _c += _h * _a - h0 * a0 - b.load();
+    }
+
     template <typename LossFunctionType>
     auto SparseDataSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
     {
@@ -434,7 +614,7 @@ namespace trainers
 
     template <typename LossFunctionType>
     SparseDataCenteredSGDTrainer<LossFunctionType>::SparseDataCenteredSGDTrainer(const LossFunctionType& lossFunction, math::RowVector<double> center, const SGDTrainerParameters& parameters) :
-        SGDTrainerBase(parameters.randomSeedString),
+        SGDTrainerBase(parameters.randomSeedString, parameters.numThreads, parameters.convergence),
         _lossFunction(lossFunction),
         _parameters(parameters),
         _center(std::move(center))
@@ -490,6 +670,74 @@ namespace trainers
         _s += _r / _t;
     }
 
+    template <typename LossFunctionType>
+    void SparseDataCenteredSGDTrainer<LossFunctionType>::DoParallelEpoch()
+    {
+        auto numSteps = _dataset.NumExamples();
+        auto numFeatures = _dataset.NumFeatures();
+        if (numFeatures > _v.Size())
+        {
+            _v.Resize(numFeatures);
+            _u.Resize(numFeatures);
+        }
+
+        // as in SparseDataSGDTrainer::DoParallelEpoch, the threads only add to commutative sums, and _h, _c, _r,
+        // and _s are recovered from them at the end of the epoch
+        const double lambda = _parameters.regularization;
+        const double t0 = _t;
+        const double h0 = _h;
+        const double a0 = _a;
+        const double z0 = _z;
+        auto harmonicNumbers = detail::GetHarmonicNumbers(_t, _h, numSteps);
+        SharedWeights v(_v);
+        SharedWeights u(_u);
+        std::atomic<double> a(_a);
+        std::atomic<double> b(0);
+        std::atomic<double> z(_z);
+        std::atomic<double> zh(0);
+
+        ForEachExampleInParallel([&](const data::AutoDataVector& x, double y, double weight, size_t stepIndex) {
+            double t = t0 + stepIndex + 1;
+            double q = x * _center.Transpose();
+
+            // apply the predictor, which is zero before the first step
+            double p = 0;
+            if (t > 1.0)
+            {
+                double d = v.Dot(x);
+                double currentA = a.load(std::memory_order_relaxed);
+                double r = currentA * _theta - z.load(std::memory_order_relaxed);
+                p = -(d + r - currentA * q) / (lambda * (t - 1.0));
+            }
+
+            // get the derivative
+            double g = weight * _lossFunction.GetDerivative(p, y);
+
+            // update
+            double h = harmonicNumbers[stepIndex];
+            v.Add(x, g);
+            u.Add(x, h * g);
+            AtomicAdd(a, g);
+            AtomicAdd(b, h * g);
+            AtomicAdd(z, g * q);
+            AtomicAdd(zh, h * g * q);
+        });
+
+        v.CopyTo(_v);
+        u.CopyTo(_u);
+        _a = a.load();
+        _z = z.load();
+        _t = t0 + numSteps;
+        _h = harmonicNumbers[numSteps];
+
+        // the sums of _a / t and of _z / t over the steps of the epoch
+        double deltaC = _h * _a - h0 * a0 - b.load();
+        double deltaZ = _h * _z - h0 * z0 - zh.load();
+        _c += deltaC;
+        _r = _a * _theta - _z;
+        _s += _theta * deltaC - deltaZ;
+    }
+
     template <typename LossFunctionType>
     auto SparseDataCenteredSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
     {
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SharedWeights.h (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <data/include/AutoDataVector.h>
+
+#include <math/include/Vector.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary> Adds a value to an atomic double, without ordering any other memory access. </summary>
+    ///
+    /// <param name="target"> The atomic double. </param>
+    /// <param name="value"> The value to add. </param>
+    inline void AtomicAdd(std::atomic<double>& target, double value);
+
+    /// <summary>
+    /// A copy of a weight vector that several threads read and update without locks, as in Hogwild. Each element
+    /// is read and updated atomically, but the updates of a data vector are not applied as one transaction.
+    /// </summary>
+    class SharedWeights
+    {
+    public:
+        /// <summary> Constructs a copy of a weight vector. </summary>
+        ///
+        /// <param name="weights"> The weight vector. </param>
+        SharedWeights(const math::ColumnVector<double>& weights);
+
+        /// <summary> Returns the number of weights. </summary>
+        ///
+        /// <returns> The number of weights. </returns>
+        size_t Size() const { return _size; }
+
+        /// <summary> Computes the dot product of a data vector with the weights. </summary>
+        ///
+        /// <param name="x"> The data vector, whose indices are smaller than Size(). </param>
+        ///
+        /// <returns> The dot product. </returns>
+        double Dot(const data::AutoDataVector& x) const;
+
+        /// <summary> Computes the dot product of a data vector with a transformation of the weights. </summary>
+        ///
+        /// <typeparam name="TransformationType"> A functor that takes a weight and returns a double. </typeparam>
+        /// <param name="x"> The data vector, whose indices are smaller than Size(). </param>
+        /// <param name="transformation"> The transformation that is applied to each weight. </param>
+        ///
+        /// <returns> The dot product. </returns>
+        template <typename TransformationType>
+        double Dot(const data::AutoDataVector& x, TransformationType transformation) const;
+
+        /// <summary> Adds a scaled data vector to the weights. </summary>
+        ///
+        /// <param name="x"> The data vector, whose indices are smaller than Size(). </param>
+        /// <param name="scale"> The scale. </param>
+        void Add(const data::AutoDataVector& x, double scale);
+
+        /// <summary> Copies the weights to a vector of the same size. </summary>
+        ///
+        /// <param name="weights"> [out] The vector. </param>
+        void CopyTo(math::ColumnVector<double>& weights) const;
+
+    private:
+        size_t _size;
+        std::unique_ptr<std::atomic<double>[]> _weights;
+    };
+} // namespace trainers
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace trainers
+{
+    inline void AtomicAdd(std::atomic<double>& target, double value)
+    {
+        auto current = target.load(std::memory_order_relaxed);
+        while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    inline SharedWeights::SharedWeights(const math::ColumnVector<double>& weights) :
+        _size(weights.Size()),
+        _weights(std::make_unique<std::atomic<double>[]>(_size))
+    {
+        for (size_t i = 0; i < _size; ++i)
+        {
+            _weights[i].store(weights[i], std::memory_order_relaxed);
+        }
+    }
+
+    inline double SharedWeights::Dot(const data::AutoDataVector& x) const
+    {
+        return Dot(x, [](double weight) { return weight; });
+    }
+
+    template <typename TransformationType>
+    double SharedWeights::Dot(const data::AutoDataVector& x, TransformationType transformation) const
+    {
+        double result = 0;
+        x.VisitElements<data::IterationPolicy::skipZeros>([this, &result, &transformation](data::IndexValue indexValue) {
+            result += indexValue.value * transformation(_weights[indexValue.index].load(std::memory_order_relaxed));
+        });
+        return result;
+    }
+
+    inline void SharedWeights::Add(const data::AutoDataVector& x, double scale)
+    {
+        x.VisitElements<data::IterationPolicy::skipZeros>([this, scale](data::IndexValue indexValue) {
+            AtomicAdd(_weights[indexValue.index], scale * indexValue.value);
+        });
+    }
+
+    inline void SharedWeights::CopyTo(math::ColumnVector<double>& weights) const
+    {
+        for (size_t i = 0; i < _size; ++i)
+        {
+            weights[i] = _weights[i].load(std::memory_order_relaxed);
+        }
+    }
+} // namespace trainers
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SoftmaxBooster.h (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <data/include/Example.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary>
+    /// A booster for multi-class problems with the softmax (multinomial log) loss, where each class has its own
+    /// forest and the strong label of an example is the index of its class. The weak weights and labels of a class
+    /// make the weighted mean label of a set of examples the Newton step of the loss for that class's output.
+    /// </summary>
+    class SoftmaxBooster
+    {
+    public:
+        /// <summary> Calculates the weak weights and weak labels of every class. </summary>
+        ///
+        /// <param name="strongWeightLabel"> The strong weight and label, which is the index of the example's class. </param>
+        /// <param name="predictions"> The prediction of each class. </param>
+        /// <param name="weakWeightLabels"> [out] The weak weight and label of each class. </param>
+        void GetWeakWeightLabels(const data::WeightLabel& strongWeightLabel, const std::vector<double>& predictions, std::vector<data::WeightLabel>& weakWeightLabels) const;
+    };
+} // namespace trainers
+} // namespace ell
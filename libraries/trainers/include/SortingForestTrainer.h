@@ -14,6 +14,9 @@
 #include <predictors/include/ConstantPredictor.h>
 #include <predictors/include/SingleElementThresholdPredictor.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace ell
 {
 namespace trainers
@@ -24,7 +27,9 @@ namespace trainers
     };
 
     /// <summary> A trainer for binary decision forests with threshold split rules and constant outputs
-    /// that operates by sorting the data set by each feature. </summary>
+    /// that operates by sorting the data set by each feature. Each feature is sorted once, when the dataset is set,
+    /// and the sorted lists are stably partitioned when a node is split, so that the examples of each node stay
+    /// sorted by each feature. </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     /// <typeparam name="BoosterType"> Booster type. </typeparam>
@@ -50,18 +55,49 @@ namespace trainers
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::PredictorType;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::DataVectorType;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::TrainerExampleType;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeRanges;
+
+        /// <summary> Sets the trainer's dataset, and sorts the examples by each feature. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
 
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_forest;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
+        std::vector<SplitCandidate> GetBestSplitRulesAtChildren(size_t interiorNodeIndex, const SplitCandidate& splitCandidate) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
     private:
-        void SortNodeDataset(Range range, size_t featureIndex);
+        // an entry in the sorted list of a feature
+        struct FeatureValue
+        {
+            float value;
+            uint32_t exampleIndex;
+        };
+
+        void SortFeatures();
+        void PartitionFeatureLists(const SplitCandidate& splitCandidate);
+        SplitCandidate GetBestSplitRuleInRange(SplittableNodeId nodeId, Range range, Sums sums) const;
         double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
 
         // member variables
         LossFunctionType _lossFunction;
+
+        // the values of each feature in ascending order, over the entire dataset
+        std::vector<std::vector<FeatureValue>> _sortedFeatures;
+
+        // the same lists, where the range of each node of the current tree holds the node's examples in ascending order
+        std::vector<std::vector<FeatureValue>> _nodeFeatures;
+
+        // the weak weight and label of each example of the current tree, indexed by the example index in the metadata
+        std::vector<data::WeightLabel> _weakWeightLabels;
+
+        // scratch space for partitioning a feature list, and the side of each example in the last split, or whether it
+        // belongs to the root of the current tree
+        std::vector<FeatureValue> _partitionBuffer;
+        std::vector<bool> _isInChild0;
     };
 
     /// <summary> Makes a simple forest trainer. </summary>
@@ -78,6 +114,11 @@ namespace trainers
 
 #pragma region implementation
 
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <limits>
+
 namespace ell
 {
 namespace trainers
@@ -89,30 +130,140 @@ namespace trainers
     {
     }
 
+    template <typename LossFunctionType, typename BoosterType>
+    void SortingForestTrainer<LossFunctionType, BoosterType>::SetDataset(const data::AnyDataset& anyDataset)
+    {
+        ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SetDataset(anyDataset);
+        SortFeatures();
+    }
+
     template <typename LossFunctionType, typename BoosterType>
     auto SortingForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
     {
+        // this is only called for the root of a new tree, whose examples are a prefix of the dataset
+        std::fill(_isInChild0.begin(), _isInChild0.end(), false);
+        for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size; ++rowIndex)
+        {
+            const auto& metadata = _dataset[rowIndex].GetMetadata();
+            _weakWeightLabels[metadata.exampleIndex] = metadata.weak;
+            _isInChild0[metadata.exampleIndex] = true;
+        }
+
+        // the root's lists are the sorted lists of the entire dataset, restricted to its examples
+        _nodeFeatures.resize(_sortedFeatures.size());
+        for (size_t j = 0; j < _sortedFeatures.size(); ++j)
+        {
+            _nodeFeatures[j].resize(_sortedFeatures[j].size());
+            std::copy_if(_sortedFeatures[j].begin(), _sortedFeatures[j].end(), _nodeFeatures[j].begin() + range.firstIndex, [this](const FeatureValue& featureValue) { return _isInChild0[featureValue.exampleIndex]; });
+        }
+
+        return GetBestSplitRuleInRange(nodeId, range, sums);
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto SortingForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRulesAtChildren(size_t interiorNodeIndex, const SplitCandidate& splitCandidate) -> std::vector<SplitCandidate>
+    {
+        PartitionFeatureLists(splitCandidate);
+
+        std::vector<SplitCandidate> childSplitCandidates;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            childSplitCandidates.push_back(GetBestSplitRuleInRange(_forest.GetChildId(interiorNodeIndex, i), splitCandidate.ranges.GetChildRange(i), splitCandidate.stats.GetChildSums(i)));
+        }
+        return childSplitCandidates;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void SortingForestTrainer<LossFunctionType, BoosterType>::SortFeatures()
+    {
+        auto numExamples = _dataset.NumExamples();
+        if (numExamples > std::numeric_limits<uint32_t>::max())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidSize, "SortingForestTrainer stores example indices as 32 bit integers");
+        }
+
         auto numFeatures = _dataset.NumFeatures();
+        _sortedFeatures.assign(numFeatures, std::vector<FeatureValue>(numExamples));
+        for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+        {
+            const auto& example = _dataset[rowIndex];
+            const auto& dataVector = example.GetDataVector();
+            auto exampleIndex = static_cast<uint32_t>(example.GetMetadata().exampleIndex);
+            for (size_t j = 0; j < numFeatures; ++j)
+            {
+                _sortedFeatures[j][rowIndex] = { static_cast<float>(dataVector[j]), exampleIndex };
+            }
+        }
 
+        for (auto& featureValues : _sortedFeatures)
+        {
+            std::sort(featureValues.begin(), featureValues.end(), [](const FeatureValue& a, const FeatureValue& b) { return a.value < b.value; });
+        }
+
+        _weakWeightLabels.resize(numExamples);
+        _isInChild0.resize(numExamples);
+        _partitionBuffer.resize(numExamples);
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void SortingForestTrainer<LossFunctionType, BoosterType>::PartitionFeatureLists(const SplitCandidate& splitCandidate)
+    {
+        // the dataset is already partitioned, so the rows of child 0 come first
+        auto totalRange = splitCandidate.ranges.GetTotalRange();
+        auto size0 = splitCandidate.ranges.GetChildRange(0).size;
+        for (size_t i = 0; i < totalRange.size; ++i)
+        {
+            _isInChild0[_dataset[totalRange.firstIndex + i].GetMetadata().exampleIndex] = i < size0;
+        }
+
+        // a stable partition keeps each child's examples sorted
+        for (auto& featureValues : _nodeFeatures)
+        {
+            auto begin = featureValues.begin() + totalRange.firstIndex;
+            auto end = begin + totalRange.size;
+            auto child0End = begin;
+            auto child1Begin = _partitionBuffer.begin();
+            for (auto iter = begin; iter != end; ++iter)
+            {
+                if (_isInChild0[iter->exampleIndex])
+                {
+                    *child0End++ = *iter;
+                }
+                else
+                {
+                    *child1Begin++ = *iter;
+                }
+            }
+            std::copy(_partitionBuffer.begin(), child1Begin, child0End);
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto SortingForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRuleInRange(SplittableNodeId nodeId, Range range, Sums sums) const -> SplitCandidate
+    {
         SplitCandidate bestSplitCandidate(nodeId, range, sums);
+        if (range.size == 0)
+        {
+            return bestSplitCandidate;
+        }
 
-        for (size_t inputIndex = 0; inputIndex < numFeatures; ++inputIndex)
+        for (size_t inputIndex = 0; inputIndex < _nodeFeatures.size(); ++inputIndex)
         {
-            // sort the relevant rows of data set in ascending order by inputIndex
-            SortNodeDataset(range, inputIndex);
+            // the examples of the node, in ascending order by inputIndex
+            const auto* featureValues = _nodeFeatures[inputIndex].data() + range.firstIndex;
 
             Sums sums0;
 
             // consider all thresholds
-            double nextFeatureValue = _dataset[range.firstIndex].GetDataVector()[inputIndex];
-            for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size - 1; ++rowIndex)
+            double nextFeatureValue = featureValues[0].value;
+            for (size_t i = 0; i + 1 < range.size; ++i)
             {
                 // get friendly names
                 double currentFeatureValue = nextFeatureValue;
-                nextFeatureValue = _dataset[rowIndex + 1].GetDataVector()[inputIndex];
+                nextFeatureValue = featureValues[i + 1].value;
 
                 // increment sums
-                sums0.Increment(_dataset[rowIndex].GetMetadata().weak);
+                sums0.Increment(_weakWeightLabels[featureValues[i].exampleIndex]);
 
                 // only split between rows with different feature values
                 if (currentFeatureValue == nextFeatureValue)
@@ -129,7 +280,8 @@ namespace trainers
                 {
                     bestSplitCandidate.gain = gain;
                     bestSplitCandidate.splitRule = SplitRuleType{ inputIndex, 0.5 * (currentFeatureValue + nextFeatureValue) };
-                    bestSplitCandidate.ranges.SplitChildRange(0, rowIndex - range.firstIndex + 1);
+                    bestSplitCandidate.ranges = NodeRanges(range);
+                    bestSplitCandidate.ranges.SplitChildRange(0, i + 1);
                     bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
                 }
             }
@@ -146,14 +298,6 @@ namespace trainers
         return std::vector<EdgePredictorType>{ output0, output1 };
     }
 
-    template <typename LossFunctionType, typename BoosterType>
-    void SortingForestTrainer<LossFunctionType, BoosterType>::SortNodeDataset(Range range, size_t inputIndex)
-    {
-        _dataset.Sort([inputIndex](const data::Example<DataVectorType, TrainerMetadata>& example) { return example.GetDataVector()[inputIndex]; },
-                      range.firstIndex,
-                      range.size);
-    }
-
     template <typename LossFunctionType, typename BoosterType>
     double SortingForestTrainer<LossFunctionType, BoosterType>::CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const
     {
@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SquaredLossBooster.h (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <data/include/Example.h>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary> A booster for least-squares regression: each weak predictor is fit to the residual of the current prediction. </summary>
+    class SquaredLossBooster
+    {
+    public:
+        /// <summary> Calculates weak weight and weak label. </summary>
+        ///
+        /// <param name="strongWeightLabel"> The strong weight and label. </param>
+        /// <param name="prediction"> The prediction. </param>
+        ///
+        /// <returns> The weak weight and label: the strong weight and the residual. </returns>
+        data::WeightLabel GetWeakWeightLabel(const data::WeightLabel& strongWeightLabel, double prediction) const;
+    };
+} // namespace trainers
+} // namespace ell
@@ -15,6 +15,7 @@
 
 #include <evaluators/include/Evaluator.h>
 
+#include <cstddef>
 #include <memory>
 #include <random>
 #include <string>
@@ -25,7 +26,23 @@ namespace ell
 {
 namespace trainers
 {
-    /// <summary> A class that runs multiple internal trainers and chooses the best performing predictor. </summary>
+    /// <summary> Parameters for the sweeping trainer. </summary>
+    struct SweepingTrainerParameters
+    {
+        /// <summary> The number of internal trainers that are updated at the same time, or 0 to use all the hardware threads. </summary>
+        size_t numThreads = 0;
+
+        /// <summary>
+        /// If true, each update drops the worse half of the internal trainers that it updated, until one trainer
+        /// remains, so that later updates only spend time on the promising configurations.
+        /// </summary>
+        bool successiveHalving = false;
+    };
+
+    /// <summary>
+    /// A class that runs multiple internal trainers and chooses the best performing predictor. The internal
+    /// trainers share the examples of one dataset, and are updated concurrently.
+    /// </summary>
     ///
     /// <typeparam name="PredictorType"> The type of predictor returned by this trainer. </typeparam>
     template <typename PredictorType>
@@ -33,19 +50,20 @@ namespace trainers
     {
     public:
         using EvaluatingTrainerType = EvaluatingTrainer<PredictorType>;
-        using ExampleType = data::Example<typename PredictorType::DataVectorType, data::WeightLabel>;
+        using ExampleType = data::AutoSupervisedExample;
 
         /// <summary> Constructs an instance of SweepingTrainer. </summary>
         ///
         /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
-        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers);
+        /// <param name="parameters"> The sweeping trainer parameters. </param>
+        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, const SweepingTrainerParameters& parameters = {});
 
         /// <summary> Sets the trainer's dataset. </summary>
         ///
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
 
-        /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
+        /// <summary> Updates the state of the trainer by performing a learning epoch with each of the remaining internal trainers. </summary>
         void Update() override;
 
         /// <summary> Gets a const reference to the current predictor. </summary>
@@ -53,56 +71,121 @@ namespace trainers
         /// <returns> A const reference to the current predictor. </returns>
         const PredictorType& GetPredictor() const override;
 
+        /// <summary> Returns the number of internal trainers that are still updated. </summary>
+        ///
+        /// <returns> The number of remaining internal trainers. </returns>
+        size_t NumActiveTrainers() const { return _activeTrainers.size(); }
+
     private:
+        // the internal trainers make shallow copies of these examples
         data::Dataset<ExampleType> _dataset;
         std::vector<EvaluatingTrainerType> _evaluatingTrainers;
+        std::vector<size_t> _activeTrainers;
+        size_t _numThreads;
+        bool _successiveHalving;
     };
 
     /// <summary> Makes an incremental trainer that runs multiple internal trainers and chooses the best performing predictor. </summary>
     ///
     /// <typeparam name="PredictorType"> Type of the predictor returned by this trainer. </typeparam>
     /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
+    /// <param name="parameters"> The sweeping trainer parameters. </param>
     ///
     /// <returns> A unique_ptr to a sweeping trainer. </returns>
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers);
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, const SweepingTrainerParameters& parameters = {});
 } // namespace trainers
 } // namespace ell
 
 #pragma region implementation
 
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <thread>
+
 namespace ell
 {
 namespace trainers
 {
     template <typename PredictorType>
-    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers) :
-        _evaluatingTrainers(std::move(evaluatingTrainers))
+    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, const SweepingTrainerParameters& parameters) :
+        _evaluatingTrainers(std::move(evaluatingTrainers)),
+        _activeTrainers(_evaluatingTrainers.size()),
+        _numThreads(parameters.numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : parameters.numThreads),
+        _successiveHalving(parameters.successiveHalving)
     {
         assert(_evaluatingTrainers.size() > 0);
+        std::iota(_activeTrainers.begin(), _activeTrainers.end(), 0);
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::SetDataset(const data::AnyDataset& anyDataset)
     {
+        // a streaming dataset is read by each trainer, since it does not fit in memory
+        if (anyDataset.IsStreaming())
+        {
+            _dataset = data::Dataset<ExampleType>();
+            for (auto& evaluatingTrainer : _evaluatingTrainers)
+            {
+                evaluatingTrainer.SetDataset(anyDataset);
+            }
+            return;
+        }
+
         _dataset = data::Dataset<ExampleType>(anyDataset);
+        auto sharedDataset = _dataset.GetAnyDataset();
+        for (auto& evaluatingTrainer : _evaluatingTrainers)
+        {
+            evaluatingTrainer.SetDataset(sharedDataset);
+        }
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::Update()
     {
-        for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
+        // each thread takes the next trainer that has not been updated yet
+        std::atomic<size_t> nextTrainer{ 0 };
+        auto updateTrainers = [&]() {
+            for (size_t i = nextTrainer++; i < _activeTrainers.size(); i = nextTrainer++)
+            {
+                _evaluatingTrainers[_activeTrainers[i]].Update();
+            }
+        };
+
+        auto numThreads = std::min(_numThreads, _activeTrainers.size());
+        std::vector<std::future<void>> threads;
+        for (size_t thread = 1; thread < numThreads; ++thread)
+        {
+            threads.push_back(utilities::GetHostThreadPool().AddTask(updateTrainers));
+        }
+        updateTrainers();
+
+        for (auto& thread : threads)
+        {
+            utilities::GetHostThreadPool().GetResult(thread);
+        }
+
+        if (_successiveHalving && _activeTrainers.size() > 1)
         {
-            _evaluatingTrainers[i].Update();
+            std::stable_sort(_activeTrainers.begin(), _activeTrainers.end(), [this](size_t a, size_t b) {
+                return _evaluatingTrainers[a].GetEvaluator()->GetGoodness() > _evaluatingTrainers[b].GetEvaluator()->GetGoodness();
+            });
+            _activeTrainers.resize((_activeTrainers.size() + 1) / 2);
+            std::sort(_activeTrainers.begin(), _activeTrainers.end());
         }
     }
 
     template <typename PredictorType>
     const PredictorType& SweepingTrainer<PredictorType>::GetPredictor() const
     {
-        double bestGoodness = _evaluatingTrainers[0].GetEvaluator()->GetGoodness();
-        size_t bestIndex = 0;
-        for (size_t i = 1; i < _evaluatingTrainers.size(); ++i)
+        // the dropped trainers were worse than the remaining ones when they were dropped
+        size_t bestIndex = _activeTrainers[0];
+        double bestGoodness = _evaluatingTrainers[bestIndex].GetEvaluator()->GetGoodness();
+        for (size_t i : _activeTrainers)
         {
             double goodness = _evaluatingTrainers[i].GetEvaluator()->GetGoodness();
             if (goodness > bestGoodness)
@@ -116,9 +199,9 @@ namespace trainers
     }
 
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers)
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, const SweepingTrainerParameters& parameters)
     {
-        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers));
+        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers), parameters);
     }
 } // namespace trainers
 } // namespace ell
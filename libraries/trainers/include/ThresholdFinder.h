@@ -12,7 +12,12 @@
 
 #include <predictors/include/SingleElementThresholdPredictor.h>
 
+#include <utilities/include/ThreadPool.h>
+
 #include <algorithm>
+#include <future>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace ell
@@ -44,8 +49,10 @@ namespace trainers
         template <typename ExampleIteratorType>
         UniqueValuesResult UniqueValues(ExampleIteratorType exampleIterator) const;
 
-    private:
-        size_t SortReduceCopy(std::vector<ValueWeight>::iterator begin, const std::vector<ValueWeight>::iterator end) const;
+        // Adds up to `maxThresholds` thresholds of a feature, at the weighted quantiles of its sorted unique values
+        static void AddQuantileThresholds(size_t featureIndex, const std::vector<ValueWeight>& featureValues, size_t maxThresholds, std::vector<predictors::SingleElementThresholdPredictor>& thresholdPredictors);
+
+        static size_t SortReduceCopy(std::vector<ValueWeight>::iterator begin, const std::vector<ValueWeight>::iterator end);
     };
 
     /// <summary> A threshold finder that finds all possible thresholds. </summary>
@@ -61,6 +68,106 @@ namespace trainers
         template <typename ExampleIteratorType>
         std::vector<predictors::SingleElementThresholdPredictor> GetThresholds(ExampleIteratorType exampleIterator) const;
     };
+
+    /// <summary>
+    /// A threshold finder that finds up to a given number of thresholds per feature, at the weighted quantiles of
+    /// the feature values.
+    /// </summary>
+    class QuantileThresholdFinder : public ThresholdFinder
+    {
+    public:
+        /// <summary> Constructs an instance of QuantileThresholdFinder. </summary>
+        ///
+        /// <param name="maxThresholdsPerFeature"> The maximum number of thresholds per feature. </param>
+        QuantileThresholdFinder(size_t maxThresholdsPerFeature);
+
+        /// <summary> Returns a vector of SingleElementThresholdPredictor, ordered by feature and by threshold. </summary>
+        ///
+        /// <typeparam name="ExampleIteratorType"> Type of example iterator. </typeparam>
+        /// <param name="exampleIterator"> The example iterator. </param>
+        ///
+        /// <returns> The thresholds. </returns>
+        template <typename ExampleIteratorType>
+        std::vector<predictors::SingleElementThresholdPredictor> GetThresholds(ExampleIteratorType exampleIterator) const;
+
+    private:
+        size_t _maxThresholdsPerFeature;
+    };
+
+    /// <summary>
+    /// A mergeable summary of a stream of weighted values, which keeps a bounded number of them and can tell the
+    /// approximate weighted quantiles of the stream. Each kept value carries the weight of the values merged into it, so
+    /// the rank of a quantile is off by at most about the total weight divided by the summary size, per compression.
+    /// </summary>
+    class QuantileSketch
+    {
+    public:
+        /// <summary> Constructs an empty sketch. </summary>
+        ///
+        /// <param name="maxSize"> The number of values the sketch keeps. </param>
+        QuantileSketch(size_t maxSize);
+
+        /// <summary> Adds a value to the sketch. </summary>
+        ///
+        /// <param name="value"> The value. </param>
+        /// <param name="weight"> The value's weight. </param>
+        void Add(double value, double weight);
+
+        /// <summary> Adds the values of another sketch to this one. </summary>
+        ///
+        /// <param name="other"> The other sketch. </param>
+        void Merge(const QuantileSketch& other);
+
+        /// <summary> Gets the kept values, sorted and unique, with their weights. </summary>
+        ///
+        /// <returns> The values and weights. </returns>
+        std::vector<std::pair<double, double>> GetSummary();
+
+    private:
+        struct Entry
+        {
+            double value;
+            double weight;
+        };
+
+        // Sorts the entries, adds up the weights of equal values and keeps at most `_maxSize` of them
+        void Compress();
+
+        size_t _maxSize;
+        std::vector<Entry> _entries;
+        size_t _numSorted = 0; // the first `_numSorted` entries are sorted and compressed, the rest are buffered
+    };
+
+    /// <summary>
+    /// A threshold finder that finds up to a given number of thresholds per feature, at the approximate weighted
+    /// quantiles of the feature values. It summarizes every feature with a `QuantileSketch` in one pass over the
+    /// examples, split across threads, rather than sorting all the values of each feature.
+    /// </summary>
+    class SketchThresholdFinder : public ThresholdFinder
+    {
+    public:
+        /// <summary> Constructs an instance of SketchThresholdFinder. </summary>
+        ///
+        /// <param name="maxThresholdsPerFeature"> The maximum number of thresholds per feature. </param>
+        /// <param name="sketchSizePerThreshold"> The number of values each feature's sketch keeps, per threshold. </param>
+        SketchThresholdFinder(size_t maxThresholdsPerFeature, size_t sketchSizePerThreshold = 16);
+
+        /// <summary> Returns a vector of SingleElementThresholdPredictor, ordered by feature and by threshold. </summary>
+        ///
+        /// <typeparam name="ExampleIteratorType"> Type of example iterator. </typeparam>
+        /// <param name="exampleIterator"> The example iterator. </param>
+        ///
+        /// <returns> The thresholds. </returns>
+        template <typename ExampleIteratorType>
+        std::vector<predictors::SingleElementThresholdPredictor> GetThresholds(ExampleIteratorType exampleIterator) const;
+
+    private:
+        template <typename ExampleIteratorType>
+        std::vector<QuantileSketch> SketchFeatures(ExampleIteratorType exampleIterator, size_t numExamples) const;
+
+        size_t _maxThresholdsPerFeature;
+        size_t _sketchSize;
+    };
 } // namespace trainers
 } // namespace ell
 
@@ -125,6 +232,98 @@ namespace trainers
 
         return thresholdPredictors;
     }
+
+    template <typename ExampleIteratorType>
+    std::vector<predictors::SingleElementThresholdPredictor> trainers::QuantileThresholdFinder::GetThresholds(ExampleIteratorType exampleIterator) const
+    {
+        auto uniqueValuesResult = UniqueValues(exampleIterator);
+        std::vector<predictors::SingleElementThresholdPredictor> thresholdPredictors;
+
+        for (size_t j = 0; j < uniqueValuesResult.weightedValues.size(); ++j)
+        {
+            AddQuantileThresholds(j, uniqueValuesResult.weightedValues[j], _maxThresholdsPerFeature, thresholdPredictors);
+        }
+
+        return thresholdPredictors;
+    }
+
+    template <typename ExampleIteratorType>
+    std::vector<QuantileSketch> SketchThresholdFinder::SketchFeatures(ExampleIteratorType exampleIterator, size_t numExamples) const
+    {
+        std::vector<QuantileSketch> sketches;
+        for (size_t i = 0; i < numExamples; ++i)
+        {
+            const auto& example = exampleIterator.Get();
+            const auto& denseDataVector = example.GetDataVector();
+            double weight = example.GetMetadata().weak.weight;
+
+            if (sketches.size() < denseDataVector.PrefixLength())
+            {
+                sketches.resize(denseDataVector.PrefixLength(), QuantileSketch(_sketchSize));
+            }
+
+            for (size_t j = 0; j < denseDataVector.PrefixLength(); ++j)
+            {
+                sketches[j].Add(denseDataVector[j], weight);
+            }
+
+            exampleIterator.Next();
+        }
+        return sketches;
+    }
+
+    template <typename ExampleIteratorType>
+    std::vector<predictors::SingleElementThresholdPredictor> trainers::SketchThresholdFinder::GetThresholds(ExampleIteratorType exampleIterator) const
+    {
+        // count the examples, since not every iterator knows its size
+        size_t numExamples = 0;
+        for (auto countIterator = exampleIterator; countIterator.IsValid(); countIterator.Next())
+        {
+            ++numExamples;
+        }
+
+        // each thread sketches a different set of examples, and the sketches are merged afterwards
+        const size_t minExamplesPerThread = 1 << 12;
+        size_t numThreads = std::max<size_t>(std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), numExamples / minExamplesPerThread), 1);
+        std::vector<std::future<std::vector<QuantileSketch>>> tasks;
+        for (size_t t = 1; t < numThreads; ++t)
+        {
+            auto threadIterator = exampleIterator;
+            for (size_t i = 0; i < (t * numExamples) / numThreads; ++i)
+            {
+                threadIterator.Next();
+            }
+            auto threadSize = ((t + 1) * numExamples) / numThreads - (t * numExamples) / numThreads;
+            tasks.push_back(utilities::GetHostThreadPool().AddTask([this, threadIterator, threadSize]() { return SketchFeatures(threadIterator, threadSize); }));
+        }
+
+        auto sketches = SketchFeatures(exampleIterator, numExamples / numThreads);
+        for (auto& task : tasks)
+        {
+            auto threadSketches = utilities::GetHostThreadPool().GetResult(task);
+            if (sketches.size() < threadSketches.size())
+            {
+                sketches.resize(threadSketches.size(), QuantileSketch(_sketchSize));
+            }
+            for (size_t j = 0; j < threadSketches.size(); ++j)
+            {
+                sketches[j].Merge(threadSketches[j]);
+            }
+        }
+
+        std::vector<predictors::SingleElementThresholdPredictor> thresholdPredictors;
+        for (size_t j = 0; j < sketches.size(); ++j)
+        {
+            std::vector<ValueWeight> featureValues;
+            for (const auto& valueWeight : sketches[j].GetSummary())
+            {
+                featureValues.push_back({ valueWeight.first, valueWeight.second });
+            }
+            AddQuantileThresholds(j, featureValues, _maxThresholdsPerFeature, thresholdPredictors);
+        }
+
+        return thresholdPredictors;
+    }
 } // namespace trainers
 } // namespace ell
 
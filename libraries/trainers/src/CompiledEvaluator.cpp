@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompiledEvaluator.cpp (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CompiledEvaluator.h"
+
+#include <model/include/InputNode.h>
+#include <model/include/Model.h>
+
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/ForestPredictorNode.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace trainers
+{
+    model::Map GetPredictorMap(const predictors::SimpleForestPredictor& forest, size_t inputSize)
+    {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<double>>(inputSize);
+
+        // A forest without trees (e.g., before the first split that beats the minimum gain) is just its bias
+        if (forest.NumTrees() == 0)
+        {
+            auto biasNode = model.AddNode<nodes::ConstantNode<double>>(forest.GetBias());
+            return { model, { { "input", inputNode } }, { { "output", biasNode->output } } };
+        }
+
+        auto forestNode = model.AddNode<nodes::SimpleForestPredictorNode>(inputNode->output, forest);
+        return { model, { { "input", inputNode } }, { { "output", forestNode->output } } };
+    }
+
+    size_t GetPredictorInputSize(const predictors::SimpleForestPredictor& forest)
+    {
+        size_t inputSize = 0;
+        for (const auto& interiorNode : forest.GetInteriorNodes())
+        {
+            inputSize = std::max(inputSize, interiorNode.GetSplitRule().GetElementIndex() + 1);
+        }
+        return inputSize;
+    }
+} // namespace trainers
+} // namespace ell
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvergenceMonitor.cpp (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvergenceMonitor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace trainers
+{
+    ConvergenceMonitor::ConvergenceMonitor(const ConvergenceParameters& parameters) :
+        _parameters(parameters)
+    {
+        if (_parameters.tolerance < 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "the convergence tolerance must be nonnegative");
+        }
+    }
+
+    bool ConvergenceMonitor::CountStep()
+    {
+        if (_parameters.criterion == ConvergenceCriterion::none || _parameters.checkInterval == 0)
+        {
+            return false;
+        }
+
+        if (++_stepsSinceCheck < _parameters.checkInterval)
+        {
+            return false;
+        }
+        _stepsSinceCheck = 0;
+        return true;
+    }
+
+    bool ConvergenceMonitor::AddCheck(double value)
+    {
+        ++_numChecks;
+        switch (_parameters.criterion)
+        {
+        case ConvergenceCriterion::none:
+            break;
+
+        case ConvergenceCriterion::dualityGap:
+            _hasConverged = value <= _parameters.tolerance;
+            break;
+
+        case ConvergenceCriterion::relativeLoss:
+            // the first check has nothing to compare with
+            _hasConverged = _numChecks > 1 && std::abs(value - _lastValue) <= _parameters.tolerance * std::abs(_lastValue);
+            break;
+
+        case ConvergenceCriterion::validationPlateau:
+            if (_numChecks == 1 || value < _bestValue - _parameters.tolerance * std::abs(_bestValue))
+            {
+                _checksWithoutImprovement = 0;
+            }
+            else
+            {
+                ++_checksWithoutImprovement;
+            }
+            _bestValue = _numChecks == 1 ? value : std::min(_bestValue, value);
+            _hasConverged = _checksWithoutImprovement >= std::max<size_t>(_parameters.patience, 1);
+            break;
+        }
+
+        _lastValue = value;
+        return _hasConverged;
+    }
+
+    void ConvergenceMonitor::SetTrainingDataset(const data::AnyDataset& anyDataset)
+    {
+        if (_parameters.criterion != ConvergenceCriterion::relativeLoss)
+        {
+            return;
+        }
+
+        // evenly spaced examples, so that a sorted training set is still sampled from end to end
+        auto numExamples = anyDataset.NumExamples();
+        auto stride = std::max<size_t>(numExamples / std::max<size_t>(_parameters.lossSampleSize, 1), 1);
+        _lossExamples.Reset();
+        auto exampleIterator = anyDataset.GetExampleIterator<data::AutoSupervisedExample>();
+        for (size_t index = 0; exampleIterator.IsValid() && _lossExamples.NumExamples() < _parameters.lossSampleSize; ++index)
+        {
+            if (index % stride == 0)
+            {
+                _lossExamples.AddExample(exampleIterator.Get());
+            }
+            exampleIterator.Next();
+        }
+    }
+
+    void ConvergenceMonitor::SetValidationDataset(const data::AnyDataset& anyDataset)
+    {
+        if (_parameters.criterion != ConvergenceCriterion::validationPlateau)
+        {
+            return;
+        }
+
+        _lossExamples = data::AutoSupervisedDataset(anyDataset);
+    }
+} // namespace trainers
+} // namespace ell
@@ -10,38 +10,137 @@
 #include <math/include/MatrixOperations.h>
 #include <math/include/VectorOperations.h>
 
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <future>
+#include <limits>
+#include <thread>
 
 namespace ell
 {
 namespace trainers
 {
-    KMeansTrainer::KMeansTrainer(size_t dim, size_t numClusters, size_t iterations) :
+    namespace
+    {
+        // the number of points whose distances to all the means are computed with one matrix product
+        const size_t pointsPerBlock = 1 << 12;
+
+        // the smallest number of points that is worth a thread of its own
+        const size_t minPointsPerThread = 1 << 10;
+
+        double squaredDistance(math::ConstColumnVectorReference<double> a, math::ConstColumnVectorReference<double> b)
+        {
+            double result = 0;
+            for (size_t i = 0; i < a.Size(); ++i)
+            {
+                auto difference = a[i] - b[i];
+                result += difference * difference;
+            }
+            return result;
+        }
+    } // namespace
+
+    KMeansTrainer::KMeansTrainer(size_t dim, size_t numClusters, size_t iterations, size_t numThreads) :
         _means(dim, numClusters),
         _isInitialized(false),
         _iterations(iterations),
-        _numClusters(numClusters) {}
+        _numClusters(numClusters),
+        _numThreads(numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : numThreads) {}
 
-    KMeansTrainer::KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means) :
+    KMeansTrainer::KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means, size_t numThreads) :
         _means(means),
         _isInitialized(true),
         _iterations(iters),
-        _numClusters(numClusters) {}
+        _numClusters(numClusters),
+        _numThreads(numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : numThreads) {}
+
+    template <typename TaskType>
+    void KMeansTrainer::forEachRange(size_t count, size_t minCountPerThread, TaskType task) const
+    {
+        auto numThreads = std::max<size_t>(std::min(_numThreads, count / minCountPerThread), 1);
+        if (numThreads == 1)
+        {
+            task(0, count);
+            return;
+        }
+
+        std::vector<std::future<void>> slices;
+        for (size_t thread = 1; thread < numThreads; ++thread)
+        {
+            slices.push_back(utilities::GetHostThreadPool().AddTask(task, thread * count / numThreads, (thread + 1) * count / numThreads));
+        }
+        task(0, count / numThreads);
+
+        for (auto& slice : slices)
+        {
+            utilities::GetHostThreadPool().GetResult(slice);
+        }
+    }
 
     void KMeansTrainer::RunKMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X)
     {
         if (false == _isInitialized)
             initializeMeans(X);
 
+        // the first iteration computes all the distances, and the next ones only what the bounds do not rule out
         math::ColumnVector<size_t> clusterAssignment(X.NumColumns());
-        double prevDistance = 0.0;
         for (size_t i = 0; i < _iterations; ++i)
         {
-            auto totalDistance = assignClosestCenter(X, clusterAssignment);
-            if (totalDistance == prevDistance)
+            if (i == 0)
+            {
+                assignClosestCenter(X, clusterAssignment);
+            }
+            else if (updateClosestCenter(X, clusterAssignment) == 0)
+            {
                 break;
+            }
             recomputeMeans(X, clusterAssignment);
-            prevDistance = totalDistance;
+        }
+
+        _clusterAssignment = math::ColumnVector<double>(clusterAssignment.Size());
+        for (size_t i = 0; i < clusterAssignment.Size(); ++i)
+        {
+            _clusterAssignment[i] = static_cast<double>(clusterAssignment[i]);
+        }
+    }
+
+    void KMeansTrainer::UpdateMiniBatch(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> batch)
+    {
+        if (batch.NumColumns() == 0)
+        {
+            return;
+        }
+
+        if (false == _isInitialized)
+        {
+            initializeMeans(batch);
+            _isInitialized = true;
+        }
+
+        if (_miniBatchCounts.empty())
+        {
+            _miniBatchCounts.assign(_numClusters, 0);
+        }
+
+        // assign the whole batch to the current means before any of them moves
+        math::ColumnVector<size_t> clusterAssignment(batch.NumColumns());
+        assignClosestCenter(batch, clusterAssignment);
+
+        for (size_t i = 0; i < batch.NumColumns(); ++i)
+        {
+            auto idx = clusterAssignment[i];
+            _miniBatchCounts[idx] += 1;
+            auto stepSize = 1.0 / _miniBatchCounts[idx];
+
+            auto mean = _means.GetColumn(idx);
+            auto point = batch.GetColumn(i);
+            for (size_t j = 0; j < mean.Size(); ++j)
+            {
+                mean[j] += stepSize * (point[j] - mean[j]);
+            }
         }
     }
 
@@ -84,73 +183,204 @@ namespace trainers
         auto n = X.NumColumns();
         auto k = means.NumColumns();
 
-        math::ColumnMatrix<double> xSq(X.NumRows(), n);
-        math::ElementwiseMultiplySet(X, X, xSq);
+        math::RowMatrix<double> distance(n, k);
+        math::MultiplyScaleAddUpdate(-2.0, X.Transpose(), means, 0.0, distance);
 
-        math::ColumnMatrix<double> muSq(means.NumRows(), k);
-        math::ElementwiseMultiplySet(means, means, muSq);
-
-        math::ColumnMatrix<double> xSqNorm(1, xSq.NumColumns());
-        math::ColumnwiseSum(xSq, xSqNorm.GetRow(0));
-
-        math::ColumnMatrix<double> muSqNorm(1, muSq.NumColumns());
-        math::ColumnwiseSum(muSq, muSqNorm.GetRow(0));
-
-        math::RowMatrix<double> onesMultiplier(k, 1);
-        onesMultiplier.Fill(1.0);
-        math::RowMatrix<double> distFactor1(k, n);
-        math::MultiplyScaleAddUpdate(1.0, onesMultiplier, xSqNorm, 0.0, distFactor1);
+        std::vector<double> muSqNorm(k);
+        for (size_t j = 0; j < k; ++j)
+        {
+            muSqNorm[j] = means.GetColumn(j).Norm2Squared();
+        }
 
-        math::ColumnMatrix<double> onesMultiplier1 = math::ColumnMatrix<double>(n, 1);
-        onesMultiplier1.Fill(1.0);
-        math::ColumnMatrix<double> distFactor2(n, k);
-        math::MultiplyScaleAddUpdate(1.0, onesMultiplier1, muSqNorm, 0.0, distFactor2);
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto xSqNorm = X.GetColumn(i).Norm2Squared();
+            auto row = distance.GetRow(i);
+            for (size_t j = 0; j < k; ++j)
+            {
+                // rounding can make the distance of a point to itself slightly negative
+                row[j] = std::max(row[j] + xSqNorm + muSqNorm[j], 0.0);
+            }
+        }
 
-        math::RowMatrix<double> muX(n, k);
-        math::MultiplyScaleAddUpdate(1.0, X.Transpose(), means, 1.0, muX);
+        return distance;
+    }
 
-        math::ColumnMatrix<double> tempD(n, k);
-        math::ScaleAddSet(1.0, distFactor1.Transpose(), -2.0, muX, tempD);
+    void KMeansTrainer::assignClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment)
+    {
+        auto n = X.NumColumns();
+        _upperBounds.assign(n, 0);
+        _lowerBounds.assign(n, 0);
 
-        math::ColumnMatrix<double> distance(n, k);
-        math::ScaleAddSet(1.0, tempD, 1.0, distFactor2, distance);
+        auto numBlocks = (n + pointsPerBlock - 1) / pointsPerBlock;
+        forEachRange(numBlocks, 1, [&](size_t beginBlock, size_t endBlock) {
+            for (size_t block = beginBlock; block < endBlock; ++block)
+            {
+                auto begin = block * pointsPerBlock;
+                auto size = std::min(pointsPerBlock, n - begin);
+                auto D = pairwiseDistance(X.GetSubMatrix(0, begin, X.NumRows(), size), _means);
 
-        return distance;
+                for (size_t i = 0; i < size; ++i)
+                {
+                    auto dist = D.GetRow(i);
+                    size_t closest = 0;
+                    double closestDistance = dist[0];
+                    double secondDistance = std::numeric_limits<double>::infinity();
+                    for (size_t j = 1; j < dist.Size(); ++j)
+                    {
+                        if (dist[j] < closestDistance)
+                        {
+                            secondDistance = closestDistance;
+                            closestDistance = dist[j];
+                            closest = j;
+                        }
+                        else if (dist[j] < secondDistance)
+                        {
+                            secondDistance = dist[j];
+                        }
+                    }
+
+                    clusterAssignment[begin + i] = closest;
+                    _upperBounds[begin + i] = std::sqrt(closestDistance);
+                    _lowerBounds[begin + i] = std::sqrt(secondDistance);
+                }
+            }
+        });
     }
 
-    double KMeansTrainer::assignClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment)
+    size_t KMeansTrainer::updateClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment)
     {
-        auto D = pairwiseDistance(X, _means);
+        // a point is closer to its mean than to any other if its distance is at most half the distance between the means
+        auto meanDistance = pairwiseDistance(_means, _means);
+        std::vector<double> halfMeanDistance(_numClusters, std::numeric_limits<double>::infinity());
+        for (size_t j = 0; j < _numClusters; ++j)
+        {
+            for (size_t l = 0; l < _numClusters; ++l)
+            {
+                if (l != j)
+                {
+                    halfMeanDistance[j] = std::min(halfMeanDistance[j], 0.5 * std::sqrt(meanDistance(j, l)));
+                }
+            }
+        }
 
-        double totalDist = 0;
-        for (size_t i = 0; i < D.NumRows(); ++i)
+        // the lower bound of a point drops by the largest movement of a mean other than its own
+        size_t farthest = 0;
+        double largestMovement = 0;
+        double secondLargestMovement = 0;
+        for (size_t j = 0; j < _numClusters; ++j)
         {
-            auto dist = D.GetRow(i);
-            auto minElement = std::min_element(dist.GetDataPointer(), dist.GetDataPointer() + dist.Size());
-            clusterAssignment[i] = minElement - dist.GetDataPointer();
-            totalDist += *minElement;
+            if (_meanMovements[j] > largestMovement)
+            {
+                secondLargestMovement = largestMovement;
+                largestMovement = _meanMovements[j];
+                farthest = j;
+            }
+            else if (_meanMovements[j] > secondLargestMovement)
+            {
+                secondLargestMovement = _meanMovements[j];
+            }
         }
 
-        return totalDist;
+        std::atomic<size_t> numReassigned{ 0 };
+        forEachRange(X.NumColumns(), minPointsPerThread, [&](size_t begin, size_t end) {
+            size_t numReassignedInRange = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto idx = clusterAssignment[i];
+                auto upperBound = _upperBounds[i] + _meanMovements[idx];
+                auto lowerBound = _lowerBounds[i] - (idx == farthest ? secondLargestMovement : largestMovement);
+                auto bound = std::max(halfMeanDistance[idx], lowerBound);
+                if (upperBound > bound)
+                {
+                    // tighten the upper bound, and compute all the distances only if that is not enough
+                    auto point = X.GetColumn(i);
+                    upperBound = std::sqrt(squaredDistance(point, _means.GetColumn(idx)));
+                    if (upperBound > bound)
+                    {
+                        size_t closest = idx;
+                        double closestDistance = upperBound * upperBound;
+                        double secondDistance = std::numeric_limits<double>::infinity();
+                        for (size_t j = 0; j < _numClusters; ++j)
+                        {
+                            if (j == idx)
+                            {
+                                continue;
+                            }
+
+                            auto distance = squaredDistance(point, _means.GetColumn(j));
+                            if (distance < closestDistance)
+                            {
+                                secondDistance = closestDistance;
+                                closestDistance = distance;
+                                closest = j;
+                            }
+                            else if (distance < secondDistance)
+                            {
+                                secondDistance = distance;
+                            }
+                        }
+
+                        if (closest != idx)
+                        {
+                            clusterAssignment[i] = closest;
+                            ++numReassignedInRange;
+                        }
+                        upperBound = std::sqrt(closestDistance);
+                        lowerBound = std::sqrt(secondDistance);
+                    }
+                }
+
+                _upperBounds[i] = upperBound;
+                _lowerBounds[i] = lowerBound;
+            }
+            numReassigned += numReassignedInRange;
+        });
+
+        return numReassigned;
     }
 
-    void KMeansTrainer::recomputeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, const math::ColumnVector<size_t> clusterAssignment)
+    void KMeansTrainer::recomputeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, const math::ColumnVector<size_t>& clusterAssignment)
     {
-        math::ColumnMatrix<double> clusterSum(X.NumRows(), _numClusters);
-        math::ColumnVector<double> numPointsPerCluster(_numClusters);
-        for (size_t i = 0; i < X.NumColumns(); ++i)
+        // each slice of the points sums into its own matrix
+        auto n = X.NumColumns();
+        auto numSlices = std::max<size_t>(std::min(_numThreads, n / minPointsPerThread), 1);
+        std::vector<math::ColumnMatrix<double>> clusterSums(numSlices, math::ColumnMatrix<double>(X.NumRows(), _numClusters));
+        std::vector<std::vector<double>> numPointsPerCluster(numSlices, std::vector<double>(_numClusters));
+        forEachRange(numSlices, 1, [&](size_t beginSlice, size_t endSlice) {
+            for (size_t slice = beginSlice; slice < endSlice; ++slice)
+            {
+                auto end = (slice + 1) * n / numSlices;
+                for (size_t i = slice * n / numSlices; i < end; ++i)
+                {
+                    auto idx = clusterAssignment[i];
+                    clusterSums[slice].GetColumn(idx) += X.GetColumn(i);
+                    numPointsPerCluster[slice][idx] += 1;
+                }
+            }
+        });
+
+        for (size_t slice = 1; slice < numSlices; ++slice)
         {
-            auto idx = clusterAssignment[i];
-            clusterSum.GetColumn(idx) += X.GetColumn(i);
-            numPointsPerCluster[idx] += 1;
+            clusterSums[0] += clusterSums[slice];
+            for (size_t i = 0; i < _numClusters; ++i)
+            {
+                numPointsPerCluster[0][i] += numPointsPerCluster[slice][i];
+            }
         }
 
+        // a mean without points stays where it is
+        _meanMovements.assign(_numClusters, 0);
         for (size_t i = 0; i < _numClusters; i++)
         {
-            clusterSum.GetColumn(i) /= numPointsPerCluster[i];
+            if (numPointsPerCluster[0][i] > 0)
+            {
+                auto clusterMean = clusterSums[0].GetColumn(i);
+                clusterMean /= numPointsPerCluster[0][i];
+                _meanMovements[i] = std::sqrt(squaredDistance(clusterMean, _means.GetColumn(i)));
+                _means.GetColumn(i).CopyFrom(clusterMean);
+            }
         }
-
-        _means.CopyFrom(clusterSum);
     }
 
     size_t KMeansTrainer::weightedSample(math::ColumnVector<double> weights)
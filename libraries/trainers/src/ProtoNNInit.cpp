@@ -19,9 +19,10 @@ namespace ell
 {
 namespace trainers
 {
-    ProtoNNInit::ProtoNNInit(size_t dim, size_t numLabels, size_t numPrototypesPerLabel) :
+    ProtoNNInit::ProtoNNInit(size_t dim, size_t numLabels, size_t numPrototypesPerLabel, size_t numThreads) :
         _dim(dim),
         _numPrototypesPerLabel(numPrototypesPerLabel),
+        _numThreads(numThreads),
         _B(dim, numLabels * numPrototypesPerLabel),
         _Z(numLabels, numLabels * numPrototypesPerLabel) {}
 
@@ -50,7 +51,7 @@ namespace trainers
             math::ColumnVector<double> label(numLabels);
             label[l] = 1;
 
-            KMeansTrainer kMeans(_dim, _numPrototypesPerLabel, numKmeansIters);
+            KMeansTrainer kMeans(_dim, _numPrototypesPerLabel, numKmeansIters, _numThreads);
             kMeans.RunKMeans(wx_label);
 
             auto clusterMeans = kMeans.GetClusterMeans();
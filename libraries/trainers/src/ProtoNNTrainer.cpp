@@ -15,12 +15,18 @@
 
 #include <data/include/Dataset.h>
 
+#include <utilities/include/ThreadPool.h>
 #include <utilities/include/Unused.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <ctime>
+#include <future>
 #include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
 
 namespace ell
 {
@@ -31,6 +37,8 @@ namespace trainers
         constexpr double ArmijoStepTolerance = 0.02;
 
         constexpr double DefaultStepSize = 0.2;
+
+        constexpr size_t DefaultBatchSize = 1 << 8;
     } // namespace
 
     double safe_div(const double& num, const double& den)
@@ -44,6 +52,7 @@ namespace trainers
     ProtoNNTrainer::ProtoNNTrainer(const ProtoNNTrainerParameters& parameters) :
         _dimemsion(parameters.numFeatures),
         _parameters(parameters),
+        _numThreads(parameters.numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : parameters.numThreads),
         _protoNNPredictor(parameters.numFeatures, parameters.projectedDimension, parameters.numPrototypesPerLabel * parameters.numLabels, parameters.numLabels, parameters.gamma),
         _X(0, 0),
         _Y(0, 0)
@@ -56,9 +65,31 @@ namespace trainers
         _X = math::ColumnMatrix<double>(_dimemsion, numExamples);
         _Y = math::ColumnMatrix<double>(_parameters.numLabels, numExamples),
         ProtoNNTrainerUtils::GetDatasetAsMatrix(anyDataset, _X, _Y);
+        if (_parameters.shuffleExamples)
+        {
+            ShuffleExamples();
+        }
         _firstIteration = true;
     }
 
+    void ProtoNNTrainer::ShuffleExamples()
+    {
+        std::vector<size_t> permutation(_X.NumColumns());
+        std::iota(permutation.begin(), permutation.end(), 0);
+        std::default_random_engine rng;
+        std::shuffle(permutation.begin(), permutation.end(), rng);
+
+        math::ColumnMatrix<double> X(_X.NumRows(), _X.NumColumns());
+        math::ColumnMatrix<double> Y(_Y.NumRows(), _Y.NumColumns());
+        for (size_t i = 0; i < permutation.size(); ++i)
+        {
+            X.GetColumn(i).CopyFrom(_X.GetColumn(permutation[i]));
+            Y.GetColumn(i).CopyFrom(_Y.GetColumn(permutation[i]));
+        }
+        _X = std::move(X);
+        _Y = std::move(Y);
+    }
+
     void ProtoNNTrainer::Update()
     {
         if (_firstIteration)
@@ -94,7 +125,7 @@ namespace trainers
         math::ColumnMatrix<double> WX(W.NumRows(), n);
         math::MultiplyScaleAddUpdate(1.0, W, _X, 0.0, WX);
 
-        ProtoNNInit protonnInit(d, _parameters.numLabels, _parameters.numPrototypesPerLabel);
+        ProtoNNInit protonnInit(d, _parameters.numLabels, _parameters.numPrototypesPerLabel, _numThreads);
         protonnInit.Initialize(WX, _Y);
 
         math::ColumnMatrix<double> B = protonnInit.GetPrototypeMatrix();
@@ -140,62 +171,45 @@ namespace trainers
     math::ColumnMatrix<double> ProtoNNTrainer::SimilarityKernel(ConstColumnMatrixReference X, math::ColumnMatrixReference<double> WX, const double gamma, const size_t begin, const size_t end, bool recomputeWX)
     {
         assert(begin < end);
-        auto B = (_modelMap[ProtoNNParameterIndex::B])->GetData();
-        auto W = (_modelMap[ProtoNNParameterIndex::W])->GetData();
+        const auto& B = _modelMap.at(ProtoNNParameterIndex::B)->GetData();
+        const auto& W = _modelMap.at(ProtoNNParameterIndex::W)->GetData();
 
         auto wx = WX.GetSubMatrix(0, begin, WX.NumRows(), end - begin);
 
         // if W has changed, recompute WX
         if (true == recomputeWX)
         {
-            math::ColumnMatrix<double> wxUpdated(W.NumRows(), end - begin);
             auto x = X.GetSubMatrix(0, begin, X.NumRows(), end - begin);
-            math::MultiplyScaleAddUpdate(1.0, W, x, 0.0, wxUpdated);
-            wx.CopyFrom(wxUpdated);
+            math::MultiplyScaleAddUpdate(1.0, W, x, 0.0, wx);
         }
 
         // full(sum(B. ^ 2, 1));
-        math::ColumnMatrix<double> bSquare(B.NumRows(), B.NumColumns());
-        math::ElementwiseMultiplySet(B, B, bSquare);
-
-        math::ColumnMatrix<double> bColNormSquare(1, bSquare.NumColumns());
-        math::ColumnwiseSum(bSquare, bColNormSquare.GetRow(0));
+        std::vector<double> bColNormSquare(B.NumColumns());
+        for (size_t j = 0; j < B.NumColumns(); ++j)
+        {
+            bColNormSquare[j] = B.GetColumn(j).Norm2Squared();
+        }
 
         // full(sum(WX. ^ 2, 1));
-        math::ColumnMatrix<double> wxSquare(wx.NumRows(), wx.NumColumns());
-        math::ElementwiseMultiplySet(wx, wx, wxSquare);
-
-        math::ColumnMatrix<double> wxColNormSquare(1, wxSquare.NumColumns());
-        math::ColumnwiseSum(wxSquare, wxColNormSquare.GetRow(0));
-
-        // wxb = (2.0 * gamma * gamma) * WX.transpose() * B;
-        math::RowMatrix<double> wxb(wx.NumColumns(), B.NumColumns());
-        math::MultiplyScaleAddUpdate(2 * gamma * gamma, wx.Transpose(), B, 0.0, wxb);
-
-        // repmat of bColNormSquare and scaling by -gamma * gamma
-        math::RowMatrix<double> gammaSquareCol(end - begin, 1);
-        gammaSquareCol.Fill(-gamma * gamma);
-        math::RowMatrix<double> bColNormSquareResized(gammaSquareCol.NumRows(), bColNormSquare.NumColumns());
-        // S1 = gammaSquareCol * bColSum;
-        math::MultiplyScaleAddUpdate(1.0, gammaSquareCol, bColNormSquare, 0.0, bColNormSquareResized);
-
-        // repmat of wxColNormSquare and scaling by -gamma * gamma
-        math::RowMatrix<double> gammaSquareRow(B.NumColumns(), 1);
-        gammaSquareRow.Fill(-gamma * gamma);
-        math::RowMatrix<double> wxColNormSquareResized(gammaSquareRow.NumRows(), wxColNormSquare.NumColumns());
-        // S2 = gammaSquareRow * wxColSum;
-        math::MultiplyScaleAddUpdate(1.0, gammaSquareRow, wxColNormSquare, 0.0, wxColNormSquareResized);
-
-        // D = wxb + bColNormSquareResized
-        math::RowMatrix<double> similarityMatrix(wxb.NumRows(), wxb.NumColumns());
-        math::ScaleAddSet(1.0, wxb, 1.0, bColNormSquareResized, similarityMatrix);
+        std::vector<double> wxColNormSquare(wx.NumColumns());
+        for (size_t i = 0; i < wx.NumColumns(); ++i)
+        {
+            wxColNormSquare[i] = wx.GetColumn(i).Norm2Squared();
+        }
 
-        // D = D + wxColNormSquareResized'
-        math::RowMatrix<double> distance(similarityMatrix.NumRows(), similarityMatrix.NumColumns());
-        math::ScaleAddSet(1.0, similarityMatrix, 1.0, wxColNormSquareResized.Transpose(), distance);
+        // D = (2.0 * gamma * gamma) * WX.transpose() * B;
+        math::ColumnMatrix<double> similarityMatrix(wx.NumColumns(), B.NumColumns());
+        math::MultiplyScaleAddUpdate(2 * gamma * gamma, wx.Transpose(), B, 0.0, similarityMatrix);
 
-        // similarityMatrix = exp(D)
-        similarityMatrix = ProtoNNTrainerUtils::MatrixExp(distance);
+        // similarityMatrix = exp(D - gamma * gamma * (bColNormSquare + wxColNormSquare'))
+        for (size_t j = 0; j < similarityMatrix.NumColumns(); ++j)
+        {
+            auto column = similarityMatrix.GetColumn(j);
+            for (size_t i = 0; i < column.Size(); ++i)
+            {
+                column[i] = std::exp(column[i] - gamma * gamma * (bColNormSquare[j] + wxColNormSquare[i]));
+            }
+        }
 
         return similarityMatrix;
     }
@@ -209,7 +223,7 @@ namespace trainers
     {
         assert(end - begin == D.NumRows());
 
-        auto Z = (_modelMap[ProtoNNParameterIndex::Z])->GetData();
+        const auto& Z = _modelMap.at(ProtoNNParameterIndex::Z)->GetData();
 
         // residual = y - ZD'
         math::ColumnMatrix<double> ZD(Z.NumRows(), D.NumRows());
@@ -264,20 +278,41 @@ namespace trainers
         size_t batchSize = maxBatchSize;
         size_t numBatches = (n + batchSize - 1) / batchSize;
 
-        // Aggregate loss over the batches
-        for (size_t i = 0; i < numBatches; ++i)
-        {
-            size_t idx1 = (i * batchSize) % n;
-            size_t idx2 = ((i + 1) * (batchSize) % n);
-            if (idx2 <= idx1) idx2 = n;
+        // The batches touch disjoint columns of WX, so each thread takes a range of them
+        std::vector<double> batchLosses(numBatches);
+        auto computeLosses = [&](size_t firstBatch, size_t lastBatch) {
+            for (size_t i = firstBatch; i < lastBatch; ++i)
+            {
+                size_t idx1 = (i * batchSize) % n;
+                size_t idx2 = ((i + 1) * (batchSize) % n);
+                if (idx2 <= idx1) idx2 = n;
 
-            assert(idx1 < idx2);
-            assert(idx2 - idx1 <= maxBatchSize);
+                assert(idx1 < idx2);
+                assert(idx2 - idx1 <= maxBatchSize);
 
-            auto D = SimilarityKernel(X, WX, gamma, idx1, idx2, recomputeWX);
-            auto y = Y.GetSubMatrix(0, idx1, Y.NumRows(), idx2 - idx1);
+                auto D = SimilarityKernel(X, WX, gamma, idx1, idx2, recomputeWX);
+                auto y = Y.GetSubMatrix(0, idx1, Y.NumRows(), idx2 - idx1);
+
+                batchLosses[i] = Loss(y, D);
+            }
+        };
+
+        auto numThreads = std::min(_numThreads, numBatches);
+        std::vector<std::future<void>> threads;
+        for (size_t thread = 1; thread < numThreads; ++thread)
+        {
+            threads.push_back(utilities::GetHostThreadPool().AddTask(computeLosses, thread * numBatches / numThreads, (thread + 1) * numBatches / numThreads));
+        }
+        computeLosses(0, numBatches / numThreads);
+        for (auto& thread : threads)
+        {
+            utilities::GetHostThreadPool().GetResult(thread);
+        }
 
-            objective += Loss(y, D);
+        // Aggregate loss over the batches
+        for (auto loss : batchLosses)
+        {
+            objective += loss;
         }
 
         return objective;
@@ -385,7 +420,7 @@ namespace trainers
         size_t n = X.NumColumns(); //numTrainPoints
         size_t epochs = _parameters.numInnerIterations; // number of SGD iterations(epochs) over each of the parameters
 
-        size_t sgdBatchSize = 1 << 8 < n ? 1 << 8 : n; //expose to user parameter structure, default is sqrt(n)
+        size_t sgdBatchSize = std::min(_parameters.batchSize == 0 ? DefaultBatchSize : _parameters.batchSize, n);
 
         double armijoStepTolerance = ArmijoStepTolerance;
 
@@ -440,21 +475,22 @@ namespace trainers
                 math::ColumnMatrix<double> perturbedParameter(parameterMatrix.NumRows(), parameterMatrix.NumColumns());
                 math::ScaleAddSet(1.0, parameterMatrix, -1.0 * coeff, thresholdedGradient, perturbedParameter);
 
-                auto WX_old = WX;
                 _modelMap[parameterIndex]->GetData() = perturbedParameter;
 
-                // Compute gradient_paramS with updated parameter
-                math::MultiplyScaleAddUpdate(1.0, _modelMap[m_projectionIndex]->GetData(), X, 0.0, WX);
-
+                // Compute gradient_paramS with updated parameter, the kernel reprojects the batch if the parameter is the projection
                 math::ColumnMatrix<double> gradientEstimate(parameterMatrix.NumRows(), parameterMatrix.NumColumns());
                 auto grad = _modelMap[parameterIndex]->gradient(_modelMap, X, Y, WX, SimilarityKernel(X, WX, gamma, idx1, idx2, _recomputeWX[parameterIndex]), gamma, idx1, idx2, _parameters.lossFunction);
                 math::ScaleAddSet(1.0, currentGradient, -1.0, grad, gradientEstimate);
 
                 currentGradient = gradientEstimate;
 
-                // revert the old parameter value and projected input
+                // revert the old parameter value and the projected batch
                 _modelMap[parameterIndex]->GetData() = parameterMatrix;
-                WX = WX_old;
+                if (_recomputeWX[parameterIndex])
+                {
+                    auto wx = WX.GetSubMatrix(0, idx1, WX.NumRows(), idx2 - idx1);
+                    math::MultiplyScaleAddUpdate(1.0, _modelMap[m_projectionIndex]->GetData(), X.GetSubMatrix(0, idx1, X.NumRows(), idx2 - idx1), 0.0, wx);
+                }
 
                 if (ProtoNNTrainerUtils::MatrixNorm(currentGradient) <= 1e-20L)
                 {
@@ -478,9 +514,13 @@ namespace trainers
             // Call the accelerated proximal gradient_paramS method for optimizing this parameter
             AcceleratedProximalGradient(parameterIndex, [&](ConstColumnMatrixReference /*W*/, const size_t begin, const size_t end) -> math::ColumnMatrix<double> { return _modelMap[parameterIndex]->gradient(_modelMap, X, Y, WX, SimilarityKernel(X, WX, gamma, begin, end, _recomputeWX[parameterIndex]), gamma, begin, end, _parameters.lossFunction); }, [&](auto arg) { ProtoNNTrainerUtils::HardThresholding(arg, _sparsity[parameterIndex]); }, parameterMatrix, epochs, n, sgdBatchSize, paramStepSize, eta_update);
 
-            math::MultiplyScaleAddUpdate(1.0, _modelMap[m_projectionIndex]->GetData(), X, 0.0, WX);
+            // WX only changes with the projection, and is reused by the other parameters
+            if (_recomputeWX[parameterIndex])
+            {
+                math::MultiplyScaleAddUpdate(1.0, _modelMap[m_projectionIndex]->GetData(), X, 0.0, WX);
+            }
             fOld = fCur;
-            fCur = ComputeObjective(X, Y, WX, gamma, _recomputeWX[parameterIndex]);
+            fCur = ComputeObjective(X, Y, WX, gamma, false);
 
             // Armijo step
             // If function value has increased, decrease the step size else increase
@@ -513,9 +553,9 @@ namespace trainers
         UNUSED(WX);
         assert(end - begin == D.NumRows());
 
-        auto W = modelMap[ProtoNNParameterIndex::W]->GetData();
-        auto B = modelMap[ProtoNNParameterIndex::B]->GetData();
-        auto Z = modelMap[ProtoNNParameterIndex::Z]->GetData();
+        const auto& W = modelMap.at(ProtoNNParameterIndex::W)->GetData();
+        const auto& B = modelMap.at(ProtoNNParameterIndex::B)->GetData();
+        const auto& Z = modelMap.at(ProtoNNParameterIndex::Z)->GetData();
 
         auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin).Transpose();
 
@@ -592,7 +632,7 @@ namespace trainers
 
         assert(end - begin == Similarity.NumRows());
 
-        auto Z = modelMap[ProtoNNParameterIndex::Z]->GetData();
+        const auto& Z = modelMap.at(ProtoNNParameterIndex::Z)->GetData();
 
         auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin);
 
@@ -640,8 +680,8 @@ namespace trainers
         UNUSED(X, WX);
         assert(end - begin == Similarity.NumRows());
 
-        auto B = modelMap[ProtoNNParameterIndex::B]->GetData();
-        auto Z = modelMap[ProtoNNParameterIndex::Z]->GetData();
+        const auto& B = modelMap.at(ProtoNNParameterIndex::B)->GetData();
+        const auto& Z = modelMap.at(ProtoNNParameterIndex::Z)->GetData();
 
         auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin).Transpose();
         auto wx = WX.GetSubMatrix(0, begin, WX.NumRows(), end - begin);
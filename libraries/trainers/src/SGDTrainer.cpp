@@ -8,6 +8,13 @@
 
 #include "SGDTrainer.h"
 
+#include <data/include/StreamingDataset.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <thread>
+
 namespace ell
 {
 namespace trainers
@@ -15,17 +22,72 @@ namespace trainers
 
     void SGDTrainerBase::SetDataset(const data::AnyDataset& anyDataset)
     {
-        _dataset = data::Dataset<data::AutoSupervisedExample>(anyDataset);
+        if (anyDataset.IsStreaming())
+        {
+            _dataset = data::AutoSupervisedDataset();
+            _streamingDataset = anyDataset;
+        }
+        else
+        {
+            _dataset = data::Dataset<data::AutoSupervisedExample>(anyDataset);
+            _streamingDataset.reset();
+        }
+        _convergenceMonitor.SetTrainingDataset(anyDataset);
     }
 
     void SGDTrainerBase::Update()
     {
-        // permute the data
-        _dataset.RandomPermute(_random);
+        if (HasConverged())
+        {
+            return;
+        }
+
+        bool isCheckedInEpoch = false;
+        if (_streamingDataset)
+        {
+            // the streaming dataset shuffles each epoch as it reads it
+            auto reader = _streamingDataset->GetStreamingReader();
+            DoEpoch(reader, false);
+        }
+        else
+        {
+            // permute the data
+            _dataset.RandomPermute(_random);
+            if (_numThreads > 1)
+            {
+                DoParallelEpoch();
+            }
+            else
+            {
+                // get example iterator
+                auto exampleIterator = _dataset.GetExampleReferenceIterator();
+                DoEpoch(exampleIterator, true);
+                isCheckedInEpoch = true;
+            }
+        }
 
-        // get example iterator
+        // epochs that weren't checked as they went are checked at their end
+        if (_convergenceMonitor.GetCriterion() != ConvergenceCriterion::none && (_convergenceMonitor.IsCheckedPerEpoch() || !isCheckedInEpoch))
+        {
+            CheckConvergence();
+        }
+    }
+
+    void SGDTrainerBase::DoParallelEpoch()
+    {
         auto exampleIterator = _dataset.GetExampleReferenceIterator();
+        DoEpoch(exampleIterator, false);
+    }
 
+    bool SGDTrainerBase::CheckConvergence()
+    {
+        auto loss = _convergenceMonitor.GetLoss(GetPredictor(), [this](double prediction, double label) { return GetLoss(prediction, label); });
+        return _convergenceMonitor.AddCheck(loss);
+    }
+
+    template <typename ExampleIteratorType>
+    void SGDTrainerBase::DoEpoch(ExampleIteratorType& exampleIterator, bool isCheckedInEpoch)
+    {
         // first iteration handled separately
         if (_firstIteration && exampleIterator.IsValid())
         {
@@ -39,6 +101,10 @@ namespace trainers
 
             exampleIterator.Next();
             _firstIteration = false;
+            if (isCheckedInEpoch && _convergenceMonitor.CountStep() && CheckConvergence())
+            {
+                return;
+            }
         }
 
         while (exampleIterator.IsValid())
@@ -53,11 +119,22 @@ namespace trainers
             DoNextStep(x, y, weight);
 
             exampleIterator.Next();
+            if (isCheckedInEpoch && _convergenceMonitor.CountStep() && CheckConvergence())
+            {
+                return;
+            }
         }
     }
 
-    SGDTrainerBase::SGDTrainerBase(std::string randomSeedString)
+    SGDTrainerBase::SGDTrainerBase(std::string randomSeedString, size_t numThreads, const ConvergenceParameters& convergence) :
+        _numThreads(numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : numThreads),
+        _convergenceMonitor(convergence)
     {
+        if (convergence.criterion == ConvergenceCriterion::dualityGap)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SGD trainers have no duality gap; use the relative loss or validation plateau criterion");
+        }
+
         std::seed_seq seed(randomSeedString.begin(), randomSeedString.end());
         _random = std::default_random_engine(seed);
     }
@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SoftmaxBooster.cpp (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SoftmaxBooster.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace trainers
+{
+    void SoftmaxBooster::GetWeakWeightLabels(const data::WeightLabel& strongWeightLabel, const std::vector<double>& predictions, std::vector<data::WeightLabel>& weakWeightLabels) const
+    {
+        // the smallest second derivative of the loss, so that the examples the forest is sure about keep a bounded label
+        const double minHessian = 1.0e-6;
+
+        auto numClasses = predictions.size();
+        weakWeightLabels.resize(numClasses);
+        if (numClasses == 0)
+        {
+            return;
+        }
+
+        double maxPrediction = *std::max_element(predictions.begin(), predictions.end());
+        double sum = 0;
+        for (size_t c = 0; c < numClasses; ++c)
+        {
+            sum += std::exp(predictions[c] - maxPrediction);
+        }
+
+        auto label = static_cast<size_t>(strongWeightLabel.label);
+        for (size_t c = 0; c < numClasses; ++c)
+        {
+            double probability = std::exp(predictions[c] - maxPrediction) / sum;
+            double target = c == label ? 1.0 : 0.0;
+            double hessian = std::max(probability * (1.0 - probability), minHessian);
+            weakWeightLabels[c] = { strongWeightLabel.weight * hessian, (target - probability) / hessian };
+        }
+    }
+} // namespace trainers
+} // namespace ell
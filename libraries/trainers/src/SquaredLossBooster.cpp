@@ -0,0 +1,20 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SquaredLossBooster.cpp (trainers)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SquaredLossBooster.h"
+
+namespace ell
+{
+namespace trainers
+{
+    data::WeightLabel SquaredLossBooster::GetWeakWeightLabel(const data::WeightLabel& strongWeightLabel, double prediction) const
+    {
+        return { strongWeightLabel.weight, strongWeightLabel.label - prediction };
+    }
+} // namespace trainers
+} // namespace ell
@@ -16,7 +16,7 @@ namespace ell
 {
 namespace trainers
 {
-    size_t ThresholdFinder::SortReduceCopy(std::vector<ValueWeight>::iterator begin, const std::vector<ValueWeight>::iterator end) const
+    size_t ThresholdFinder::SortReduceCopy(std::vector<ValueWeight>::iterator begin, const std::vector<ValueWeight>::iterator end)
     {
         // sort the values
         std::sort(begin, end, std::less<double>());
@@ -40,5 +40,159 @@ namespace trainers
         }
         return current - begin + 1;
     }
+
+    void ThresholdFinder::AddQuantileThresholds(size_t featureIndex, const std::vector<ValueWeight>& featureValues, size_t maxThresholds, std::vector<predictors::SingleElementThresholdPredictor>& thresholdPredictors)
+    {
+        if (featureValues.size() <= maxThresholds + 1)
+        {
+            for (size_t i = 0; i + 1 < featureValues.size(); ++i)
+            {
+                thresholdPredictors.push_back({ featureIndex, 0.5 * (featureValues[i].value + featureValues[i + 1].value) });
+            }
+            return;
+        }
+
+        // place each threshold after the value where the cumulative weight crosses the next quantile
+        double featureWeight = 0;
+        for (const auto& valueWeight : featureValues)
+        {
+            featureWeight += valueWeight.weight;
+        }
+
+        double cumulativeWeight = 0;
+        size_t numThresholds = 0;
+        for (size_t i = 0; i + 1 < featureValues.size() && numThresholds < maxThresholds; ++i)
+        {
+            // without weights, the quantiles are of the ranks
+            cumulativeWeight += featureWeight > 0 ? featureValues[i].weight : 1.0;
+            auto total = featureWeight > 0 ? featureWeight : static_cast<double>(featureValues.size());
+            if (cumulativeWeight * (maxThresholds + 1) >= total * (numThresholds + 1))
+            {
+                thresholdPredictors.push_back({ featureIndex, 0.5 * (featureValues[i].value + featureValues[i + 1].value) });
+                ++numThresholds;
+            }
+        }
+    }
+
+    QuantileThresholdFinder::QuantileThresholdFinder(size_t maxThresholdsPerFeature) :
+        _maxThresholdsPerFeature(maxThresholdsPerFeature)
+    {
+    }
+
+    //
+    // QuantileSketch
+    //
+    QuantileSketch::QuantileSketch(size_t maxSize) :
+        _maxSize(std::max<size_t>(maxSize, 1))
+    {
+    }
+
+    void QuantileSketch::Add(double value, double weight)
+    {
+        _entries.push_back({ value, weight });
+        if (_entries.size() >= _numSorted + _maxSize)
+        {
+            Compress();
+        }
+    }
+
+    void QuantileSketch::Merge(const QuantileSketch& other)
+    {
+        _entries.insert(_entries.end(), other._entries.begin(), other._entries.end());
+        if (_entries.size() >= _numSorted + _maxSize)
+        {
+            Compress();
+        }
+    }
+
+    std::vector<std::pair<double, double>> QuantileSketch::GetSummary()
+    {
+        Compress();
+        std::vector<std::pair<double, double>> result;
+        result.reserve(_entries.size());
+        for (const auto& entry : _entries)
+        {
+            result.emplace_back(entry.value, entry.weight);
+        }
+        return result;
+    }
+
+    void QuantileSketch::Compress()
+    {
+        if (_numSorted == _entries.size())
+        {
+            return;
+        }
+
+        auto lessValue = [](const Entry& a, const Entry& b) { return a.value < b.value; };
+        std::sort(_entries.begin() + _numSorted, _entries.end(), lessValue);
+        std::inplace_merge(_entries.begin(), _entries.begin() + _numSorted, _entries.end(), lessValue);
+
+        // add up the weights of equal values
+        size_t size = 0;
+        for (size_t i = 0; i < _entries.size(); ++i)
+        {
+            if (size > 0 && _entries[size - 1].value == _entries[i].value)
+            {
+                _entries[size - 1].weight += _entries[i].weight;
+            }
+            else
+            {
+                _entries[size++] = _entries[i];
+            }
+        }
+        _entries.resize(size);
+
+        if (_entries.size() > _maxSize)
+        {
+            double totalWeight = 0;
+            for (const auto& entry : _entries)
+            {
+                totalWeight += entry.weight;
+            }
+
+            // Split the values into `_maxSize` groups of about equal weight (or, without weights, of equal size), and
+            // keep the heaviest value of each group, with the weight of the whole group
+            bool useRanks = totalWeight <= 0;
+            auto total = useRanks ? static_cast<double>(_entries.size()) : totalWeight;
+            double cumulativeWeight = 0;
+            size_t numKept = 0;
+            size_t currentGroup = 0;
+            double heaviestWeight = 0;
+            for (size_t i = 0; i < _entries.size(); ++i)
+            {
+                auto entry = _entries[i];
+                auto bucketWeight = useRanks ? 1.0 : entry.weight;
+                auto group = std::min(static_cast<size_t>(((cumulativeWeight + 0.5 * bucketWeight) * _maxSize) / total), _maxSize - 1);
+                cumulativeWeight += bucketWeight;
+                if (numKept == 0 || group != currentGroup)
+                {
+                    _entries[numKept++] = entry;
+                    currentGroup = group;
+                    heaviestWeight = entry.weight;
+                    continue;
+                }
+
+                auto& kept = _entries[numKept - 1];
+                if (entry.weight > heaviestWeight)
+                {
+                    kept.value = entry.value;
+                    heaviestWeight = entry.weight;
+                }
+                kept.weight += entry.weight;
+            }
+            _entries.resize(numKept);
+        }
+        _numSorted = _entries.size();
+    }
+
+    //
+    // SketchThresholdFinder
+    //
+    SketchThresholdFinder::SketchThresholdFinder(size_t maxThresholdsPerFeature, size_t sketchSizePerThreshold) :
+        _maxThresholdsPerFeature(maxThresholdsPerFeature),
+        _sketchSize(std::max<size_t>(sketchSizePerThreshold, 1) * (maxThresholdsPerFeature + 1))
+    {
+    }
 } // namespace trainers
 } // namespace ell
@@ -7,17 +7,37 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <data/include/Dataset.h>
+#include <data/include/StreamingDataset.h>
 
+#include <evaluators/include/AUCAggregator.h>
+#include <evaluators/include/Evaluator.h>
+#include <evaluators/include/LossAggregator.h>
+
+#include <functions/include/ElasticNetRegularizer.h>
 #include <functions/include/L2Regularizer.h>
 #include <functions/include/LogLoss.h>
 #include <functions/include/SquaredLoss.h>
 
+#include <trainers/include/CompiledEvaluator.h>
+#include <trainers/include/HistogramForestTrainer.h>
+#include <trainers/include/KMeansTrainer.h>
+#include <trainers/include/LogitBooster.h>
 #include <trainers/include/MeanCalculator.h>
+#include <trainers/include/MulticlassHistogramForestTrainer.h>
+#include <trainers/include/ProtoNNTrainer.h>
 #include <trainers/include/SDCATrainer.h>
 #include <trainers/include/SGDTrainer.h>
+#include <trainers/include/SortingForestTrainer.h>
+#include <trainers/include/SweepingTrainer.h>
+#include <trainers/include/ThresholdFinder.h>
 
 #include <testing/include/testing.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
 using namespace ell;
 
 /// Runs all tests
@@ -59,6 +79,100 @@ void TestSDCATrainer()
     return;
 }
 
+void TestStreamingSDCATrainer()
+{
+    data::AutoSupervisedDataset dataset;
+    dataset.AddExample({ { 1.0, 0.0, 2.0, 0.0, 3.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 4.0, 5.0, 6.0, 7.0 }, { 1.0, -1.0 } });
+    dataset.AddExample({ { 8.0, 0.0, 9.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 10.0 }, { 1.0, -1.0 } });
+
+    // without shuffling, streaming the dataset gives the same predictor as holding it in memory
+    data::StreamingDataset streamingDataset([&dataset]() { return dataset.GetExampleIterator(); }, { 1, 3, "XYZ" });
+    auto trainer = trainers::MakeSDCATrainer(functions::LogLoss(), functions::L2Regularizer(), { 1.0e-4, 1.0e-8, 20, false, "XYZ" });
+    auto streamingTrainer = trainers::MakeSDCATrainer(functions::LogLoss(), functions::L2Regularizer(), { 1.0e-4, 1.0e-8, 20, false, "XYZ" });
+    trainer->SetDataset(dataset.GetAnyDataset());
+    streamingTrainer->SetDataset(streamingDataset.GetAnyDataset());
+
+    for (auto i = 0; i < 5; i++)
+    {
+        trainer->Update();
+        streamingTrainer->Update();
+    }
+
+    const auto& predictor = trainer->GetPredictor();
+    const auto& streamingPredictor = streamingTrainer->GetPredictor();
+    testing::ProcessTest("TestStreamingSDCATrainer", predictor.GetWeights() == streamingPredictor.GetWeights() && predictor.GetBias() == streamingPredictor.GetBias());
+}
+
+void TestParallelSDCATrainer()
+{
+    // a small dataset is processed by a single thread, in the order of the serial trainer
+    data::AutoSupervisedDataset smallDataset;
+    smallDataset.AddExample({ { 1.0, 0.0, 2.0, 0.0, 3.0 }, { 1.0, 1.0 } });
+    smallDataset.AddExample({ { 0.0, 4.0, 5.0, 6.0, 7.0 }, { 1.0, -1.0 } });
+    smallDataset.AddExample({ { 8.0, 0.0, 9.0 }, { 1.0, 1.0 } });
+    smallDataset.AddExample({ { 0.0, 10.0 }, { 1.0, -1.0 } });
+
+    using SmallTrainerType = trainers::SDCATrainer<functions::LogLoss, functions::ElasticNetRegularizer>;
+    SmallTrainerType serialTrainer(functions::LogLoss(), functions::ElasticNetRegularizer(0.1), { 1.0e-2, 1.0e-8, 20, false, "XYZ" });
+    SmallTrainerType parallelTrainer(functions::LogLoss(), functions::ElasticNetRegularizer(0.1), { 1.0e-2, 1.0e-8, 20, false, "XYZ", 4 });
+    serialTrainer.SetDataset(smallDataset.GetAnyDataset());
+    parallelTrainer.SetDataset(smallDataset.GetAnyDataset());
+    for (int i = 0; i < 5; ++i)
+    {
+        serialTrainer.Update();
+        parallelTrainer.Update();
+    }
+    const auto& serialPredictor = serialTrainer.GetPredictor();
+    const auto& parallelPredictor = parallelTrainer.GetPredictor();
+    auto serialInfo = serialTrainer.GetPredictorInfo();
+    auto parallelInfo = parallelTrainer.GetPredictorInfo();
+    testing::ProcessTest("TestParallelSDCATrainer, single thread", serialPredictor.GetWeights().IsEqual(parallelPredictor.GetWeights(), 1.0e-8) && std::abs(serialPredictor.GetBias() - parallelPredictor.GetBias()) < 1.0e-8 && std::abs(serialInfo.dualObjective - parallelInfo.dualObjective) < 1.0e-8);
+
+    // a large sparse dataset is split between the threads, which keep the duality gap exact
+    std::default_random_engine random(1357);
+    std::uniform_int_distribution<size_t> indexDistribution(0, 199);
+    std::normal_distribution<double> valueDistribution;
+    std::vector<double> targetWeights(1000);
+    for (auto& weight : targetWeights)
+    {
+        weight = valueDistribution(random);
+    }
+
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        std::vector<data::IndexValue> entries;
+        double score = 0;
+        for (size_t j = 0; j < 5; ++j)
+        {
+            auto index = 200 * j + indexDistribution(random);
+            entries.push_back({ index, 1.0 });
+            score += targetWeights[index];
+        }
+        dataset.AddExample({ data::AutoDataVector(entries), { 1.0, score > 0 ? 1.0 : -1.0 } });
+    }
+
+    using TrainerType = trainers::SDCATrainer<functions::LogLoss, functions::L2Regularizer>;
+    TrainerType largeSerialTrainer(functions::LogLoss(), functions::L2Regularizer(), { 1.0e-4, 1.0e-8, 20, true, "XYZ" });
+    TrainerType largeParallelTrainer(functions::LogLoss(), functions::L2Regularizer(), { 1.0e-4, 1.0e-8, 20, true, "XYZ", 4 });
+    largeSerialTrainer.SetDataset(dataset.GetAnyDataset());
+    largeParallelTrainer.SetDataset(dataset.GetAnyDataset());
+    for (int i = 0; i < 10; ++i)
+    {
+        largeSerialTrainer.Update();
+        largeParallelTrainer.Update();
+    }
+
+    serialInfo = largeSerialTrainer.GetPredictorInfo();
+    parallelInfo = largeParallelTrainer.GetPredictorInfo();
+    auto serialGap = serialInfo.primalObjective - serialInfo.dualObjective;
+    auto parallelGap = parallelInfo.primalObjective - parallelInfo.dualObjective;
+    printf("TestParallelSDCATrainer duality gap, serial: %f parallel: %f\n", serialGap, parallelGap);
+    testing::ProcessTest("TestParallelSDCATrainer, multiple threads", parallelGap >= 0 && parallelGap < 0.01 && std::abs(parallelInfo.primalObjective - serialInfo.primalObjective) < 0.01);
+}
+
 void TestSGDTrainer()
 {
     data::AutoSupervisedDataset dataset;
@@ -114,9 +228,259 @@ void TestSGDTrainer()
     printf("bias == %f\n", bias);
     testing::ProcessTest("TestSDGTrainer, final cumulative error", error < 10);
 
+    // train again on a streaming version of the dataset, which is shuffled by a small buffer
+    data::StreamingDataset streamingDataset([&dataset]() { return dataset.GetExampleIterator(); }, dataset.NumExamples(), { 4, 5, "XYZ" });
+    auto streamingTrainer = trainers::MakeSGDTrainer(functions::SquaredLoss(), { 4, "XYZ" });
+    streamingTrainer->SetDataset(streamingDataset.GetAnyDataset());
+
+    for (auto j = 0; j < 20; j++)
+    {
+        streamingTrainer->Update();
+    }
+
+    functions::SquaredLoss lossFunction;
+    error = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const data::AutoSupervisedExample& example = dataset[i];
+        error += lossFunction(streamingTrainer->GetPredictor().Predict(example.GetDataVector()), example.GetMetadata().label);
+    }
+    testing::ProcessTest("TestSDGTrainer, streaming dataset, final cumulative error", error < 10);
+
     return;
 }
 
+template <typename TrainerType>
+double GetSquaredLoss(const TrainerType& trainer, const data::AutoSupervisedDataset& dataset)
+{
+    functions::SquaredLoss lossFunction;
+    double loss = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        loss += lossFunction(trainer.GetPredictor().Predict(example.GetDataVector()), example.GetMetadata().label);
+    }
+    return loss / dataset.NumExamples();
+}
+
+template <typename TrainerType>
+bool IsPredictorEqual(const TrainerType& trainer1, const TrainerType& trainer2, double tolerance)
+{
+    const auto& predictor1 = trainer1.GetPredictor();
+    const auto& predictor2 = trainer2.GetPredictor();
+    return predictor1.GetWeights().IsEqual(predictor2.GetWeights(), tolerance) && std::abs(predictor1.GetBias() - predictor2.GetBias()) < tolerance;
+}
+
+void TestParallelSparseDataSGDTrainer()
+{
+    // a small dataset is processed by a single thread, in the order of the serial trainer
+    data::AutoSupervisedDataset smallDataset;
+    smallDataset.AddExample({ { 5.1, 1.4 }, { 1.0, 2 } });
+    smallDataset.AddExample({ { 4.9, 0.0, 1.2 }, { 1.0, 2 } });
+    smallDataset.AddExample({ { 0.0, 1.7 }, { 1.0, 4 } });
+    smallDataset.AddExample({ { 4.6, 1.4, 0.0, 2.0 }, { 1.0, 3 } });
+    smallDataset.AddExample({ { 4.3, 1.1 }, { 1.0, 1 } });
+    smallDataset.AddExample({ { 5.7, 1.5 }, { 1.0, 4 } });
+    math::RowVector<double> smallCenter{ 4.1, 1.2, 0.2, 0.3 };
+
+    trainers::SparseDataSGDTrainer<functions::SquaredLoss> serialTrainer(functions::SquaredLoss(), { 4, "XYZ" });
+    trainers::SparseDataSGDTrainer<functions::SquaredLoss> parallelTrainer(functions::SquaredLoss(), { 4, "XYZ", 4 });
+    trainers::SparseDataCenteredSGDTrainer<functions::SquaredLoss> serialCenteredTrainer(functions::SquaredLoss(), smallCenter, { 4, "XYZ" });
+    trainers::SparseDataCenteredSGDTrainer<functions::SquaredLoss> parallelCenteredTrainer(functions::SquaredLoss(), smallCenter, { 4, "XYZ", 4 });
+    serialTrainer.SetDataset(smallDataset.GetAnyDataset());
+    parallelTrainer.SetDataset(smallDataset.GetAnyDataset());
+    serialCenteredTrainer.SetDataset(smallDataset.GetAnyDataset());
+    parallelCenteredTrainer.SetDataset(smallDataset.GetAnyDataset());
+    for (int i = 0; i < 5; ++i)
+    {
+        serialTrainer.Update();
+        parallelTrainer.Update();
+        serialCenteredTrainer.Update();
+        parallelCenteredTrainer.Update();
+    }
+    testing::ProcessTest("TestParallelSparseDataSGDTrainer, single thread", IsPredictorEqual(serialTrainer, parallelTrainer, 1.0e-8));
+    testing::ProcessTest("TestParallelSparseDataSGDTrainer, single thread, centered", IsPredictorEqual(serialCenteredTrainer, parallelCenteredTrainer, 1.0e-8));
+
+    // a large sparse dataset is split between the threads
+    std::default_random_engine random(1357);
+    std::uniform_int_distribution<size_t> indexDistribution(0, 199);
+    std::normal_distribution<double> valueDistribution;
+    std::vector<double> targetWeights(1000);
+    for (auto& weight : targetWeights)
+    {
+        weight = valueDistribution(random);
+    }
+
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        std::vector<data::IndexValue> entries;
+        double label = 0;
+        for (size_t j = 0; j < 5; ++j)
+        {
+            auto index = 200 * j + indexDistribution(random);
+            entries.push_back({ index, 1.0 });
+            label += targetWeights[index];
+        }
+        dataset.AddExample({ data::AutoDataVector(entries), { 1.0, label } });
+    }
+    math::RowVector<double> center(1000);
+    center.Fill(0.005);
+
+    trainers::SparseDataSGDTrainer<functions::SquaredLoss> largeSerialTrainer(functions::SquaredLoss(), { 0.1, "XYZ" });
+    trainers::SparseDataSGDTrainer<functions::SquaredLoss> largeParallelTrainer(functions::SquaredLoss(), { 0.1, "XYZ", 4 });
+    trainers::SparseDataCenteredSGDTrainer<functions::SquaredLoss> largeCenteredTrainer(functions::SquaredLoss(), center, { 0.1, "XYZ", 4 });
+    largeSerialTrainer.SetDataset(dataset.GetAnyDataset());
+    largeParallelTrainer.SetDataset(dataset.GetAnyDataset());
+    largeCenteredTrainer.SetDataset(dataset.GetAnyDataset());
+    for (int i = 0; i < 5; ++i)
+    {
+        largeSerialTrainer.Update();
+        largeParallelTrainer.Update();
+        largeCenteredTrainer.Update();
+    }
+
+    auto serialLoss = GetSquaredLoss(largeSerialTrainer, dataset);
+    auto parallelLoss = GetSquaredLoss(largeParallelTrainer, dataset);
+    auto centeredLoss = GetSquaredLoss(largeCenteredTrainer, dataset);
+    printf("TestParallelSparseDataSGDTrainer loss, serial: %f parallel: %f centered: %f\n", serialLoss, parallelLoss, centeredLoss);
+    testing::ProcessTest("TestParallelSparseDataSGDTrainer, multiple threads", parallelLoss < 1.1 * serialLoss + 0.01);
+    testing::ProcessTest("TestParallelSparseDataSGDTrainer, multiple threads, centered", centeredLoss < 1.1 * serialLoss + 0.01);
+}
+
+void TestConvergenceCriteria()
+{
+    std::default_random_engine random(2468);
+    std::normal_distribution<double> valueDistribution;
+    data::AutoSupervisedDataset dataset;
+    data::AutoSupervisedDataset validationDataset;
+    for (size_t i = 0; i < 400; ++i)
+    {
+        std::vector<double> values(5);
+        for (auto& value : values)
+        {
+            value = valueDistribution(random);
+        }
+        auto label = values[0] - 2 * values[1] + 0.5 * values[2] + 0.1 * valueDistribution(random);
+        (i % 4 == 0 ? validationDataset : dataset).AddExample({ data::AutoDataVector(values), { 1.0, label } });
+    }
+
+    // the duality gap is below the desired precision long before the last epoch
+    trainers::ConvergenceParameters dualityGap{ trainers::ConvergenceCriterion::dualityGap, 1.0e-3 };
+    trainers::SDCATrainer<functions::SquaredLoss, functions::L2Regularizer> sdcaTrainer(functions::SquaredLoss(), functions::L2Regularizer(), { 1.0e-2, 1.0e-3, 100, false, "XYZ", 1, dualityGap });
+    sdcaTrainer.SetDataset(dataset.GetAnyDataset());
+    size_t numSDCAEpochs = 0;
+    for (; numSDCAEpochs < 100 && !sdcaTrainer.HasConverged(); ++numSDCAEpochs)
+    {
+        sdcaTrainer.Update();
+    }
+    auto sdcaWeights = sdcaTrainer.GetPredictor().GetWeights();
+    sdcaTrainer.Update();
+    auto sdcaInfo = sdcaTrainer.GetPredictorInfo();
+    testing::ProcessTest("TestConvergenceCriteria, SDCA duality gap", numSDCAEpochs < 100 && sdcaInfo.primalObjective - sdcaInfo.dualObjective <= 1.0e-3);
+    testing::ProcessTest("TestConvergenceCriteria, no updates after convergence", sdcaTrainer.GetPredictor().GetWeights() == sdcaWeights);
+
+    // checks in the middle of an epoch stop it early
+    trainers::ConvergenceParameters relativeLoss{ trainers::ConvergenceCriterion::relativeLoss, 1.0e-2, 50 };
+    trainers::SparseDataSGDTrainer<functions::SquaredLoss> sgdTrainer(functions::SquaredLoss(), { 1.0, "XYZ", 1, relativeLoss });
+    sgdTrainer.SetDataset(dataset.GetAnyDataset());
+    size_t numSGDEpochs = 0;
+    for (; numSGDEpochs < 100 && !sgdTrainer.HasConverged(); ++numSGDEpochs)
+    {
+        sgdTrainer.Update();
+    }
+    testing::ProcessTest("TestConvergenceCriteria, SGD relative loss", sgdTrainer.HasConverged() && sgdTrainer.GetConvergenceMonitor().NumChecks() < numSGDEpochs * (dataset.NumExamples() / 50));
+
+    trainers::ConvergenceParameters validationPlateau{ trainers::ConvergenceCriterion::validationPlateau, 1.0e-3, 0, 2 };
+    trainers::SGDTrainer<functions::SquaredLoss> plateauTrainer(functions::SquaredLoss(), { 1.0e-2, "XYZ", 1, validationPlateau });
+    plateauTrainer.SetDataset(dataset.GetAnyDataset());
+    plateauTrainer.SetValidationDataset(validationDataset.GetAnyDataset());
+    size_t numPlateauEpochs = 0;
+    for (; numPlateauEpochs < 100 && !plateauTrainer.HasConverged(); ++numPlateauEpochs)
+    {
+        plateauTrainer.Update();
+    }
+    testing::ProcessTest("TestConvergenceCriteria, SGD validation plateau", numPlateauEpochs < 100 && plateauTrainer.GetConvergenceMonitor().NumChecks() == numPlateauEpochs);
+
+    // SGD has no duality gap
+    bool threw = false;
+    try
+    {
+        trainers::SGDTrainer<functions::SquaredLoss> dualityGapTrainer(functions::SquaredLoss(), { 1.0e-2, "XYZ", 1, dualityGap });
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("TestConvergenceCriteria, SGD duality gap throws", threw);
+}
+
+template <typename TrainerType>
+double GetErrorRate(const TrainerType& trainer, const data::AutoSupervisedDataset& dataset)
+{
+    size_t numErrors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        if (trainer.GetPredictor().Predict(example.GetDataVector()) * example.GetMetadata().label <= 0)
+        {
+            ++numErrors;
+        }
+    }
+    return static_cast<double>(numErrors) / dataset.NumExamples();
+}
+
+std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeTestSweepingTrainer(const data::AutoSupervisedDataset& dataset, const trainers::SweepingTrainerParameters& parameters)
+{
+    using PredictorType = predictors::LinearPredictor<double>;
+    std::vector<trainers::EvaluatingTrainer<PredictorType>> evaluatingTrainers;
+    for (auto regularization : { 2.0, 1.0, 0.5, 0.25 })
+    {
+        auto evaluator = evaluators::MakeEvaluator<PredictorType>(dataset.GetAnyDataset(), { 1, false }, evaluators::AUCAggregator());
+        evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(trainers::MakeSGDTrainer(functions::LogLoss(), { regularization, "XYZ" }), evaluator));
+    }
+    return trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), parameters);
+}
+
+void TestSweepingTrainer()
+{
+    data::AutoSupervisedDataset dataset;
+    std::default_random_engine random(2468);
+    std::normal_distribution<double> distribution;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        auto x0 = distribution(random);
+        auto x1 = distribution(random);
+        dataset.AddExample({ { x0, x1 }, { 1.0, 2 * x0 - x1 + 0.1 * distribution(random) > 0 ? 1.0 : -1.0 } });
+    }
+
+    // the concurrent trainers give the same result as the sequential ones
+    auto sequentialTrainer = MakeTestSweepingTrainer(dataset, { 1, false });
+    auto parallelTrainer = MakeTestSweepingTrainer(dataset, { 4, false });
+    sequentialTrainer->SetDataset(dataset.GetAnyDataset());
+    parallelTrainer->SetDataset(dataset.GetAnyDataset());
+    for (int i = 0; i < 3; ++i)
+    {
+        sequentialTrainer->Update();
+        parallelTrainer->Update();
+    }
+    testing::ProcessTest("TestSweepingTrainer, parallel", IsPredictorEqual(*sequentialTrainer, *parallelTrainer, 1.0e-12));
+    testing::ProcessTest("TestSweepingTrainer, error rate", GetErrorRate(*sequentialTrainer, dataset) < 0.1);
+
+    // successive halving keeps half of the trainers after each update
+    auto halvingTrainer = MakeTestSweepingTrainer(dataset, { 4, true });
+    halvingTrainer->SetDataset(dataset.GetAnyDataset());
+    const auto& sweepingTrainer = static_cast<const trainers::SweepingTrainer<predictors::LinearPredictor<double>>&>(*halvingTrainer);
+    std::vector<size_t> numActiveTrainers;
+    for (int i = 0; i < 3; ++i)
+    {
+        halvingTrainer->Update();
+        numActiveTrainers.push_back(sweepingTrainer.NumActiveTrainers());
+    }
+    testing::ProcessTest("TestSweepingTrainer, successive halving", numActiveTrainers == std::vector<size_t>{ 2, 1, 1 });
+    testing::ProcessTest("TestSweepingTrainer, successive halving error rate", GetErrorRate(*halvingTrainer, dataset) < 0.1);
+}
+
 void TestMeanCalculator()
 {
     data::AutoSupervisedDataset dataset;
@@ -131,9 +495,431 @@ void TestMeanCalculator()
     testing::ProcessTest("TestMeanCalculator", mean == r);
 }
 
+// true if every center has a mean within the given distance
+bool HasMeansNear(const math::ColumnMatrix<double>& means, const math::ColumnMatrix<double>& centers, double tolerance)
+{
+    for (size_t i = 0; i < centers.NumColumns(); ++i)
+    {
+        bool found = false;
+        for (size_t j = 0; j < means.NumColumns(); ++j)
+        {
+            math::ColumnVector<double> difference(centers.NumRows());
+            difference.CopyFrom(centers.GetColumn(i));
+            difference -= means.GetColumn(j);
+            found = found || difference.Norm2() < tolerance;
+        }
+
+        if (!found)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestKMeansTrainer()
+{
+    const size_t dimension = 3;
+    const size_t numClusters = 4;
+    const size_t numPoints = 8000;
+    math::ColumnMatrix<double> centers{ { 0, 10, 0, 10 }, { 0, 0, 10, 10 }, { 0, 5, -5, 0 } };
+
+    std::default_random_engine randomEngine(123);
+    std::normal_distribution<double> noise(0, 0.5);
+    math::ColumnMatrix<double> points(dimension, numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        for (size_t j = 0; j < dimension; ++j)
+        {
+            points(j, i) = centers(j, i % numClusters) + noise(randomEngine);
+        }
+    }
+
+    // the bounds and the threads do not change the result
+    std::srand(7);
+    trainers::KMeansTrainer kMeans(dimension, numClusters, 20);
+    kMeans.RunKMeans(points);
+
+    std::srand(7);
+    trainers::KMeansTrainer parallelKMeans(dimension, numClusters, 20, 4);
+    parallelKMeans.RunKMeans(points);
+
+    testing::ProcessTest("TestKMeansTrainer", HasMeansNear(kMeans.GetClusterMeans(), centers, 0.1));
+    testing::ProcessTest("TestKMeansTrainer (parallel)", kMeans.GetClusterMeans().IsEqual(parallelKMeans.GetClusterMeans(), 1.0e-8));
+    testing::ProcessTest("TestKMeansTrainer (assignment)", kMeans.GetClusterAssignment().Size() == numPoints);
+
+    // mini-batches of a stream of points
+    std::srand(7);
+    trainers::KMeansTrainer miniBatchKMeans(dimension, numClusters, 0);
+    const size_t batchSize = 500;
+    for (size_t begin = 0; begin < numPoints; begin += batchSize)
+    {
+        miniBatchKMeans.UpdateMiniBatch(points.GetSubMatrix(0, begin, dimension, batchSize));
+    }
+    testing::ProcessTest("TestKMeansTrainer (mini-batch)", HasMeansNear(miniBatchKMeans.GetClusterMeans(), centers, 0.2));
+}
+
+void TestProtoNNTrainer()
+{
+    // three well separated classes, with the examples sorted by label
+    const size_t numFeatures = 10;
+    const size_t numLabels = 3;
+    std::default_random_engine random(97531);
+    std::normal_distribution<double> distribution;
+    data::AutoSupervisedDataset dataset;
+    for (size_t label = 0; label < numLabels; ++label)
+    {
+        for (size_t i = 0; i < 200; ++i)
+        {
+            std::vector<double> features(numFeatures);
+            for (auto& feature : features)
+            {
+                feature = 0.3 * distribution(random);
+            }
+            features[label] += 2.0;
+            dataset.AddExample({ data::AutoDataVector(features), { 1.0, static_cast<double>(label) } });
+        }
+    }
+
+    trainers::ProtoNNTrainerParameters parameters{ numFeatures, numLabels, 4, 2, 1.0, 1.0, 1.0, -1.0, trainers::ProtoNNLossFunction::L2, 5, 1, false };
+    parameters.batchSize = 32;
+    trainers::ProtoNNTrainer serialTrainer(parameters);
+    parameters.numThreads = 4;
+    trainers::ProtoNNTrainer parallelTrainer(parameters);
+
+    // the k-means initialization draws from rand(), so both trainers start from the same seed
+    for (auto trainer : { &serialTrainer, &parallelTrainer })
+    {
+        std::srand(0);
+        trainer->SetDataset(dataset.GetAnyDataset(0, dataset.NumExamples()));
+        for (size_t i = 0; i < parameters.numIterations; ++i)
+        {
+            trainer->Update();
+        }
+    }
+
+    const auto& predictor = serialTrainer.GetPredictor();
+    size_t numErrors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        auto scores = predictor.Predict(example.GetDataVector());
+        auto maxScore = std::max_element(scores.GetDataPointer(), scores.GetDataPointer() + scores.Size());
+        if (static_cast<double>(maxScore - scores.GetDataPointer()) != example.GetMetadata().label)
+        {
+            ++numErrors;
+        }
+    }
+
+    testing::ProcessTest("TestProtoNNTrainer, error rate", numErrors < dataset.NumExamples() / 10);
+    testing::ProcessTest("TestProtoNNTrainer, parallel", predictor.GetProjectionMatrix().IsEqual(parallelTrainer.GetPredictor().GetProjectionMatrix(), 1.0e-8) && predictor.GetPrototypes().IsEqual(parallelTrainer.GetPredictor().GetPrototypes(), 1.0e-8));
+}
+
+void TestHistogramForestTrainer()
+{
+    // the label depends on the first two of eight features, on more distinct values than there are bins
+    std::default_random_engine random(1234);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        std::vector<double> features(8);
+        for (auto& feature : features)
+        {
+            feature = distribution(random);
+        }
+        double label = (features[0] > 0.3 && features[1] < 0.6) ? 1.0 : -1.0;
+        dataset.AddExample({ features, { 1.0, label } });
+    }
+
+    trainers::HistogramForestTrainerParameters parameters;
+    parameters.numRounds = 4;
+    parameters.maxSplitsPerRound = 3;
+    parameters.minSplitGain = 0.0;
+    parameters.randomSeed = "123456";
+    parameters.thresholdFinderSampleSize = 2000;
+    parameters.candidatesPerInput = 63;
+    auto trainer = trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::QuantileThresholdFinder(parameters.candidatesPerInput), parameters);
+    trainer->SetDataset(dataset.GetAnyDataset());
+    trainer->Update();
+
+    const auto& predictor = trainer->GetPredictor();
+    size_t errors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        auto prediction = predictor.Predict(data::FloatDataVector(example.GetDataVector().ToArray()));
+        if (prediction * example.GetMetadata().label <= 0)
+        {
+            ++errors;
+        }
+    }
+
+    // the thresholds are quantiles of a sample, so they are close to but not exactly at the true boundaries
+    testing::ProcessTest("TestHistogramForestTrainer", predictor.NumTrees() == 4 && errors < dataset.NumExamples() / 50);
+}
+
+void TestMulticlassHistogramForestTrainer()
+{
+    // three classes, one for each region of the first two of four features
+    std::default_random_engine random(1357);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        std::vector<double> features(4);
+        for (auto& feature : features)
+        {
+            feature = distribution(random);
+        }
+        double label = features[0] < 0.4 ? 0.0 : (features[1] < 0.5 ? 1.0 : 2.0);
+        dataset.AddExample({ features, { 1.0, label } });
+    }
+
+    trainers::HistogramForestTrainerParameters parameters;
+    parameters.numRounds = 4;
+    parameters.maxSplitsPerRound = 3;
+    parameters.minSplitGain = 0.0;
+    parameters.randomSeed = "123456";
+    parameters.thresholdFinderSampleSize = 2000;
+    parameters.candidatesPerInput = 63;
+    auto trainer = trainers::MakeMulticlassHistogramForestTrainer(3, trainers::QuantileThresholdFinder(parameters.candidatesPerInput), parameters);
+    trainer->SetDataset(dataset.GetAnyDataset());
+    trainer->Update();
+
+    const auto& forests = trainer->GetPredictor();
+    size_t errors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        data::FloatDataVector dataVector(example.GetDataVector().ToArray());
+        std::vector<double> outputs;
+        for (const auto& forest : forests)
+        {
+            outputs.push_back(forest.Predict(dataVector));
+        }
+        auto prediction = std::max_element(outputs.begin(), outputs.end()) - outputs.begin();
+        if (static_cast<double>(prediction) != example.GetMetadata().label)
+        {
+            ++errors;
+        }
+    }
+
+    testing::ProcessTest("TestMulticlassHistogramForestTrainer", forests.size() == 3 && forests[0].NumTrees() == 4 && errors < dataset.NumExamples() / 50);
+}
+
+// the threshold finders read the weak weight of the forest trainer's examples
+struct SketchTestMetadata
+{
+    data::WeightLabel weak;
+};
+
+void TestSketchThresholdFinder()
+{
+    // one feature is continuous, and the other takes few values, so the sketch has to keep them apart
+    std::default_random_engine random(2468);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    std::uniform_int_distribution<int> smallDistribution(1, 5);
+    std::vector<data::Example<data::FloatDataVector, SketchTestMetadata>> examples;
+    for (size_t i = 0; i < 50000; ++i)
+    {
+        std::vector<double> features = { distribution(random), static_cast<double>(smallDistribution(random)) };
+        examples.emplace_back(data::FloatDataVector(features), SketchTestMetadata{ { 1.0, 1.0 } });
+    }
+
+    const size_t maxThresholds = 31;
+    auto exactThresholds = trainers::QuantileThresholdFinder(maxThresholds).GetThresholds(utilities::MakeStlContainerReferenceIterator(examples.cbegin(), examples.cend()));
+    auto sketchThresholds = trainers::SketchThresholdFinder(maxThresholds).GetThresholds(utilities::MakeStlContainerReferenceIterator(examples.cbegin(), examples.cend()));
+
+    bool ok = exactThresholds.size() == sketchThresholds.size();
+    for (size_t i = 0; ok && i < exactThresholds.size(); ++i)
+    {
+        ok = exactThresholds[i].GetElementIndex() == sketchThresholds[i].GetElementIndex() && std::abs(exactThresholds[i].GetThreshold() - sketchThresholds[i].GetThreshold()) < 0.01;
+    }
+    testing::ProcessTest("TestSketchThresholdFinder", ok);
+
+    // merged sketches keep the weights of all the values
+    trainers::QuantileSketch sketch(8);
+    trainers::QuantileSketch otherSketch(8);
+    for (int i = 0; i < 100; ++i)
+    {
+        sketch.Add(i, 1.0);
+        otherSketch.Add(i + 0.5, 2.0);
+    }
+    sketch.Merge(otherSketch);
+    auto summary = sketch.GetSummary();
+    double totalWeight = 0;
+    for (const auto& valueWeight : summary)
+    {
+        totalWeight += valueWeight.second;
+    }
+    testing::ProcessTest("TestSketchThresholdFinder, merge", summary.size() <= 8 && std::is_sorted(summary.begin(), summary.end()) && testing::IsEqual(totalWeight, 300.0));
+}
+
+void TestSortingForestTrainer()
+{
+    // the label depends on the first two of four features, which take few distinct values so that there are ties
+    std::default_random_engine random(4321);
+    std::uniform_int_distribution<int> distribution(1, 10);
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        std::vector<double> features(4);
+        for (auto& feature : features)
+        {
+            feature = distribution(random);
+        }
+        double label = (features[0] > 2 && features[1] < 7) ? 1.0 : -1.0;
+        dataset.AddExample({ features, { 1.0, label } });
+    }
+
+    trainers::SortingForestTrainerParameters parameters;
+    parameters.numRounds = 4;
+    parameters.maxSplitsPerRound = 3;
+    parameters.minSplitGain = 0.0;
+    auto trainer = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    trainer->SetDataset(dataset.GetAnyDataset());
+    trainer->Update();
+
+    const auto& predictor = trainer->GetPredictor();
+    size_t errors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        auto prediction = predictor.Predict(data::FloatDataVector(example.GetDataVector().ToArray()));
+        if (prediction * example.GetMetadata().label <= 0)
+        {
+            ++errors;
+        }
+    }
+
+    // the exact splits separate the classes
+    testing::ProcessTest("TestSortingForestTrainer", predictor.NumTrees() == 4 && errors == 0);
+}
+
+template <typename PredictorType>
+size_t CountForestErrors(const PredictorType& predictor, const data::AutoSupervisedDataset& dataset)
+{
+    size_t errors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        auto prediction = predictor.Predict(data::FloatDataVector(example.GetDataVector().ToArray()));
+        if (prediction * example.GetMetadata().label <= 0)
+        {
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+void TestForestTrainerSampling()
+{
+    std::default_random_engine random(2468);
+    std::uniform_int_distribution<int> distribution(1, 10);
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 4000; ++i)
+    {
+        std::vector<double> features(4);
+        for (auto& feature : features)
+        {
+            feature = distribution(random);
+        }
+        double label = (features[0] > 2 && features[1] < 7) ? 1.0 : -1.0;
+        dataset.AddExample({ features, { 1.0, label } });
+    }
+
+    // bagging
+    trainers::SortingForestTrainerParameters baggingParameters;
+    baggingParameters.numRounds = 6;
+    baggingParameters.maxSplitsPerRound = 3;
+    baggingParameters.baggingFraction = 0.25;
+    baggingParameters.samplingRandomSeed = "123456";
+    auto baggingTrainer = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), baggingParameters);
+    baggingTrainer->SetDataset(dataset.GetAnyDataset());
+    baggingTrainer->Update();
+    auto baggingErrors = CountForestErrors(baggingTrainer->GetPredictor(), dataset);
+    testing::ProcessTest("TestForestTrainerSampling, bagging", baggingTrainer->GetPredictor().NumTrees() == 6 && baggingErrors < dataset.NumExamples() / 100);
+
+    // gradient-based one-side sampling
+    trainers::HistogramForestTrainerParameters gossParameters;
+    gossParameters.numRounds = 6;
+    gossParameters.maxSplitsPerRound = 3;
+    gossParameters.gossTopFraction = 0.2;
+    gossParameters.gossOtherFraction = 0.1;
+    gossParameters.samplingRandomSeed = "123456";
+    gossParameters.randomSeed = "123456";
+    gossParameters.thresholdFinderSampleSize = 1000;
+    gossParameters.candidatesPerInput = 16;
+    auto gossTrainer = trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::QuantileThresholdFinder(gossParameters.candidatesPerInput), gossParameters);
+    gossTrainer->SetDataset(dataset.GetAnyDataset());
+    gossTrainer->Update();
+    auto gossErrors = CountForestErrors(gossTrainer->GetPredictor(), dataset);
+    testing::ProcessTest("TestForestTrainerSampling, goss", gossTrainer->GetPredictor().NumTrees() == 6 && gossErrors < dataset.NumExamples() / 100);
+}
+
+void TestCompiledEvaluator()
+{
+    std::default_random_engine random(1357);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        std::vector<double> features(3);
+        for (auto& feature : features)
+        {
+            feature = distribution(random);
+        }
+        double label = features[0] + 0.5 * features[1] > 0 ? 1.0 : -1.0;
+        dataset.AddExample({ features, { 1.0, label } });
+    }
+
+    // the compiled forest gives the same loss as the interpreted one
+    trainers::SortingForestTrainerParameters parameters;
+    parameters.numRounds = 5;
+    parameters.maxSplitsPerRound = 3;
+    auto trainer = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    trainer->SetDataset(dataset.GetAnyDataset());
+    trainer->Update();
+    const auto& forest = trainer->GetPredictor();
+
+    using ForestType = predictors::SimpleForestPredictor;
+    auto forestEvaluator = evaluators::MakeEvaluator<ForestType>(dataset.GetAnyDataset(), { 1, false }, evaluators::MakeLossAggregator(functions::SquaredLoss()));
+    auto compiledForestEvaluator = trainers::MakeCompiledEvaluator<ForestType>(dataset.GetAnyDataset(), { 1, false }, evaluators::MakeLossAggregator(functions::SquaredLoss()));
+    forestEvaluator->Evaluate(forest);
+    compiledForestEvaluator->Evaluate(forest);
+    testing::ProcessTest("TestCompiledEvaluator, forest", testing::IsEqual(forestEvaluator->GetGoodness(), compiledForestEvaluator->GetGoodness(), 1.0e-8));
+
+    // ...and so does a linear predictor, including one that reads past the end of the examples
+    using LinearType = predictors::LinearPredictor<double>;
+    LinearType linear(4);
+    linear.GetWeights()[0] = 1.0;
+    linear.GetWeights()[1] = 0.5;
+    linear.GetWeights()[3] = 2.0;
+    linear.GetBias() = -0.1;
+    auto linearEvaluator = evaluators::MakeEvaluator<LinearType>(dataset.GetAnyDataset(), { 1, false }, evaluators::MakeLossAggregator(functions::SquaredLoss()));
+    auto compiledLinearEvaluator = trainers::MakeCompiledEvaluator<LinearType>(dataset.GetAnyDataset(), { 1, false }, evaluators::MakeLossAggregator(functions::SquaredLoss()));
+    linearEvaluator->Evaluate(linear);
+    compiledLinearEvaluator->Evaluate(linear);
+    testing::ProcessTest("TestCompiledEvaluator, linear", testing::IsEqual(linearEvaluator->GetGoodness(), compiledLinearEvaluator->GetGoodness(), 1.0e-8));
+}
+
 int main()
 {
     TestSDCATrainer();
+    TestStreamingSDCATrainer();
+    TestParallelSDCATrainer();
     TestSGDTrainer();
+    TestParallelSparseDataSGDTrainer();
+    TestConvergenceCriteria();
+    TestSweepingTrainer();
     TestMeanCalculator();
+    TestKMeansTrainer();
+    TestProtoNNTrainer();
+    TestHistogramForestTrainer();
+    TestMulticlassHistogramForestTrainer();
+    TestSketchThresholdFinder();
+    TestSortingForestTrainer();
+    TestForestTrainerSampling();
+    TestCompiledEvaluator();
 }
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Benchmark.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> Options for running benchmarks. </summary>
+    struct BenchmarkOptions
+    {
+        /// <summary> The number of untimed calls made before timing, to warm up caches and branch predictors. </summary>
+        size_t numWarmupIterations = 10;
+
+        /// <summary> The minimum number of timed samples. </summary>
+        size_t minSamples = 10;
+
+        /// <summary> The maximum number of timed samples. </summary>
+        size_t maxSamples = 10000;
+
+        /// <summary> Samples are taken until this much time has been spent timing, within the sample count limits. </summary>
+        double minTimeSeconds = 0.5;
+
+        /// <summary> Calls too short to time on their own are repeated until a sample takes at least this long. </summary>
+        double minSampleTimeSeconds = 1e-5;
+
+        /// <summary> The CPU to pin the benchmarking thread to, or -1 to not pin it. </summary>
+        int cpu = -1;
+    };
+
+    /// <summary> Statistics of the time per call of a benchmark, in nanoseconds. </summary>
+    struct BenchmarkStatistics
+    {
+        size_t numSamples = 0;
+        double min = 0;
+        double median = 0;
+        double mean = 0;
+        double p90 = 0;
+        double p99 = 0;
+        double max = 0;
+        double standardDeviation = 0;
+    };
+
+    /// <summary> The result of running a benchmark. </summary>
+    struct BenchmarkResult
+    {
+        std::string name;
+
+        /// <summary> The number of calls per timed sample. </summary>
+        size_t callsPerSample = 1;
+
+        /// <summary> The per-call timer overhead that was subtracted from the samples, in nanoseconds. </summary>
+        double timerOverhead = 0;
+
+        BenchmarkStatistics statistics;
+    };
+
+    /// <summary> Computes the statistics of a set of samples, with percentiles interpolated between the nearest samples. </summary>
+    ///
+    /// <param name="samples"> The samples. </param>
+    ///
+    /// <returns> The statistics. All fields are zero if there are no samples. </returns>
+    BenchmarkStatistics GetBenchmarkStatistics(std::vector<double> samples);
+
+    /// <summary> Returns the median time, in nanoseconds, of timing an empty sample with the benchmark clock. </summary>
+    double GetBenchmarkTimerOverhead();
+
+    /// <summary> Pins the calling thread to a CPU, so the scheduler can't migrate it between samples. </summary>
+    ///
+    /// <param name="cpu"> The index of the CPU. </param>
+    ///
+    /// <returns> True if the thread was pinned, false if pinning isn't supported or the CPU doesn't exist. </returns>
+    bool PinThreadToCpu(int cpu);
+
+    /// <summary> Times a function. The warmup calls are discarded and the timer overhead is subtracted from each sample. </summary>
+    ///
+    /// <param name="name"> The name to report the benchmark with. </param>
+    /// <param name="function"> The function to time. </param>
+    /// <param name="options"> The benchmark options. </param>
+    ///
+    /// <returns> The benchmark result. </returns>
+    BenchmarkResult RunBenchmark(const std::string& name, const std::function<void()>& function, const BenchmarkOptions& options);
+
+    /// <summary> A named collection of benchmarks. </summary>
+    class BenchmarkSuite
+    {
+    public:
+        /// <summary> Adds a benchmark to the suite. </summary>
+        ///
+        /// <param name="name"> The name of the benchmark. </param>
+        /// <param name="setup"> A function, called only if the benchmark runs, that prepares it and returns the function to time. </param>
+        void Add(const std::string& name, std::function<std::function<void()>()> setup);
+
+        /// <summary> Returns the names of the benchmarks in the suite, in the order they were added. </summary>
+        std::vector<std::string> GetNames() const;
+
+        /// <summary> Runs the benchmarks whose names contain a filter string. </summary>
+        ///
+        /// <param name="options"> The benchmark options. </param>
+        /// <param name="filter"> The filter string, or an empty string to run all the benchmarks. </param>
+        ///
+        /// <returns> The results, in the order the benchmarks were added. </returns>
+        std::vector<BenchmarkResult> Run(const BenchmarkOptions& options, const std::string& filter = "") const;
+
+    private:
+        std::vector<std::pair<std::string, std::function<std::function<void()>()>>> _benchmarks;
+    };
+
+    /// <summary> Writes benchmark results as a JSON object, which can be compared between versions. </summary>
+    ///
+    /// <param name="stream"> The stream to write to. </param>
+    /// <param name="results"> The benchmark results. </param>
+    /// <param name="options"> The options the benchmarks were run with. </param>
+    /// <param name="version"> The version of the code that was benchmarked. </param>
+    void WriteBenchmarkResultsJson(std::ostream& stream, const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options, const std::string& version);
+
+    /// <summary> Writes benchmark results as a human readable table. </summary>
+    ///
+    /// <param name="stream"> The stream to write to. </param>
+    /// <param name="results"> The benchmark results. </param>
+    void WriteBenchmarkResultsText(std::ostream& stream, const std::vector<BenchmarkResult>& results);
+} // namespace utilities
+} // namespace ell
@@ -0,0 +1,437 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryArchiver.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Archiver.h"
+#include "Exception.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> Constants of the binary archive format. </summary>
+    struct BinaryArchiveFormat
+    {
+        /// <summary> The first bytes of every binary archive. </summary>
+        static constexpr char magic[4] = { 'E', 'L', 'L', 'B' };
+
+        /// <summary> The version of the format, written after the magic bytes. </summary>
+        static constexpr uint32_t version = 1;
+
+        /// <summary> The size of the header, which holds the magic bytes and the version. </summary>
+        static constexpr size_t headerSize = sizeof(magic) + sizeof(version);
+
+        /// <summary> The alignment of the raw arrays, relative to the start of the archive. </summary>
+        static constexpr size_t arrayAlignment = 64;
+
+        /// <summary> The record tags. </summary>
+        enum class Tag : uint8_t
+        {
+            name,
+            value,
+            string,
+            null,
+            array,
+            stringArray,
+            beginObject,
+            endObject,
+            beginObjectArray,
+            endObjectArray
+        };
+
+        /// <summary> The kinds of fundamental values. </summary>
+        enum class Kind : uint8_t
+        {
+            boolean,
+            signedInteger,
+            unsignedInteger,
+            floatingPoint
+        };
+
+        /// <summary> Returns true if the data starts with the header of a binary archive. </summary>
+        ///
+        /// <param name="data"> The data. </param>
+        /// <param name="size"> The size of the data, in bytes. </param>
+        ///
+        /// <returns> true if the data is a binary archive. </returns>
+        static bool HasHeader(const char* data, size_t size);
+
+        /// <summary> Returns true if the next bytes of a stream are the header of a binary archive, without consuming them. </summary>
+        ///
+        /// <param name="stream"> The stream, which must be able to seek back to its current position. </param>
+        ///
+        /// <returns> true if the stream holds a binary archive. </returns>
+        static bool HasHeader(std::istream& stream);
+    };
+
+    /// <summary>
+    /// An archiver that encodes data in a compact binary format. Names, type names and scalars are stored as
+    /// tagged records, and arrays of fundamental types are stored as raw blocks that are aligned relative to the
+    /// start of the archive, so that a reader of a memory map can copy them without parsing. The values are
+    /// stored in the byte order of the machine that writes them.
+    /// </summary>
+    class BinaryArchiver : public Archiver
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="outputStream"> The stream to write data to, which must be opened in binary mode. </param>
+        BinaryArchiver(std::ostream& outputStream);
+
+    protected:
+#define ARCHIVE_TYPE_OP(t) DECLARE_ARCHIVE_VALUE_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void ArchiveValue(const char* name, const std::string& value) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_ARCHIVE_ARRAY_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void ArchiveNull(const char* name) override;
+
+        void ArchiveArray(const char* name, const std::vector<std::string>& array) override;
+        void ArchiveArray(const char* name, const std::string& baseTypeName, const std::vector<const IArchivable*>& array) override;
+
+        void BeginArchiveObject(const char* name, const IArchivable& value) override;
+        void EndArchiveObject(const char* name, const IArchivable& value) override;
+
+        void EndArchiving() override;
+
+    private:
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void WriteScalar(const char* name, const ValueType& value);
+
+        template <typename ValueType>
+        void WriteArray(const char* name, const std::vector<ValueType>& array);
+
+        void WriteName(const char* name);
+        void WriteTag(BinaryArchiveFormat::Tag tag);
+        void WriteString(const std::string& value);
+        void WriteBytes(const void* data, size_t size);
+
+        template <typename ValueType>
+        void WriteRaw(const ValueType& value);
+
+        std::ostream& _out;
+        size_t _position = 0;
+    };
+
+    /// <summary>
+    /// An unarchiver that reads data encoded by BinaryArchiver. The archive is either read from a stream into a
+    /// buffer, or read in place from memory, typically a memory mapped file.
+    /// </summary>
+    class BinaryUnarchiver : public Unarchiver
+    {
+    public:
+        /// <summary> Constructor that reads the rest of a stream. </summary>
+        ///
+        /// <param name="inputStream"> The stream to read data from, which must be opened in binary mode. </param>
+        /// <param name="context"> The serialization context. </param>
+        BinaryUnarchiver(std::istream& inputStream, SerializationContext context);
+
+        /// <summary> Constructor that reads an archive in place. </summary>
+        ///
+        /// <param name="data"> The archive, which must outlive the unarchiver. </param>
+        /// <param name="size"> The size of the archive, in bytes. </param>
+        /// <param name="context"> The serialization context. </param>
+        BinaryUnarchiver(const char* data, size_t size, SerializationContext context);
+
+        /// <summary> Indicates if a property with the given name is available to be read next </summary>
+        ///
+        /// <param name="name"> The name of the property </param>
+        ///
+        /// <returns> true if a property with the given name can be read next </returns>
+        bool HasNextPropertyName(const std::string& name) override;
+
+    protected:
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_VALUE_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void UnarchiveValue(const char* name, std::string& value) override;
+
+        bool UnarchiveNull(const char* name) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_ARRAY_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void UnarchiveArray(const char* name, std::vector<std::string>& array) override;
+
+        void BeginUnarchiveArray(const char* name, const std::string& typeName) override;
+        bool BeginUnarchiveArrayItem(const std::string& typeName) override;
+        void EndUnarchiveArrayItem(const std::string& typeName) override;
+        void EndUnarchiveArray(const char* name, const std::string& typeName) override;
+
+        ArchivedObjectInfo BeginUnarchiveObject(const char* name, const std::string& typeName) override;
+        void EndUnarchiveObject(const char* name, const std::string& typeName) override;
+        void UnarchiveObjectAsPrimitive(const char* name, IArchivable& value) override;
+
+    private:
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void ReadScalar(const char* name, ValueType& value);
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void ReadArray(const char* name, std::vector<ValueType>& array);
+
+        template <typename ValueType>
+        static ValueType ConvertValue(BinaryArchiveFormat::Kind kind, uint8_t size, const char* data);
+
+        void ReadHeader();
+        void MatchName(const char* name);
+        void MatchTag(BinaryArchiveFormat::Tag tag);
+        bool PeekTag(BinaryArchiveFormat::Tag tag) const;
+        std::string ReadString();
+        const char* ReadBytes(size_t size);
+
+        template <typename ValueType>
+        ValueType ReadRaw();
+
+        std::vector<char> _buffer; // empty when the archive is read in place
+        const char* _data;
+        size_t _size;
+        size_t _position = 0;
+    };
+} // namespace utilities
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace utilities
+{
+    namespace BinaryArchiverImpl
+    {
+        template <typename ValueType>
+        constexpr BinaryArchiveFormat::Kind GetKind()
+        {
+            return std::is_same<ValueType, bool>::value ? BinaryArchiveFormat::Kind::boolean : std::is_floating_point<ValueType>::value ? BinaryArchiveFormat::Kind::floatingPoint : std::is_signed<ValueType>::value ? BinaryArchiveFormat::Kind::signedInteger : BinaryArchiveFormat::Kind::unsignedInteger;
+        }
+
+        template <typename ValueType>
+        constexpr uint8_t GetSize()
+        {
+            // vectors of bool are stored as one byte per element
+            return std::is_same<ValueType, bool>::value ? 1 : static_cast<uint8_t>(sizeof(ValueType));
+        }
+    } // namespace BinaryArchiverImpl
+
+    //
+    // Serialization
+    //
+    template <typename ValueType>
+    void BinaryArchiver::WriteRaw(const ValueType& value)
+    {
+        WriteBytes(&value, sizeof(value));
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryArchiver::WriteScalar(const char* name, const ValueType& value)
+    {
+        WriteName(name);
+        WriteTag(BinaryArchiveFormat::Tag::value);
+        WriteRaw(BinaryArchiverImpl::GetKind<ValueType>());
+        WriteRaw(BinaryArchiverImpl::GetSize<ValueType>());
+        if constexpr (std::is_same<ValueType, bool>::value)
+        {
+            WriteRaw(static_cast<uint8_t>(value ? 1 : 0));
+        }
+        else
+        {
+            WriteRaw(value);
+        }
+    }
+
+    template <typename ValueType>
+    void BinaryArchiver::WriteArray(const char* name, const std::vector<ValueType>& array)
+    {
+        WriteName(name);
+        WriteTag(BinaryArchiveFormat::Tag::array);
+        WriteRaw(BinaryArchiverImpl::GetKind<ValueType>());
+        WriteRaw(BinaryArchiverImpl::GetSize<ValueType>());
+        WriteRaw(static_cast<uint64_t>(array.size()));
+
+        // pad to the alignment of the raw block
+        auto padding = (BinaryArchiveFormat::arrayAlignment - _position % BinaryArchiveFormat::arrayAlignment) % BinaryArchiveFormat::arrayAlignment;
+        const char zeros[BinaryArchiveFormat::arrayAlignment] = {};
+        WriteBytes(zeros, padding);
+
+        if constexpr (std::is_same<ValueType, bool>::value)
+        {
+            for (bool value : array)
+            {
+                WriteRaw(static_cast<uint8_t>(value ? 1 : 0));
+            }
+        }
+        else
+        {
+            WriteBytes(array.data(), array.size() * sizeof(ValueType));
+        }
+    }
+
+    //
+    // Deserialization
+    //
+    template <typename ValueType>
+    ValueType BinaryUnarchiver::ReadRaw()
+    {
+        ValueType value;
+        std::memcpy(&value, ReadBytes(sizeof(ValueType)), sizeof(ValueType));
+        return value;
+    }
+
+    template <typename ValueType>
+    ValueType BinaryUnarchiver::ConvertValue(BinaryArchiveFormat::Kind kind, uint8_t size, const char* data)
+    {
+        // values may be read as a different fundamental type than they were written as, like in text archives
+        switch (kind)
+        {
+        case BinaryArchiveFormat::Kind::boolean:
+            return static_cast<ValueType>(data[0] != 0);
+
+        case BinaryArchiveFormat::Kind::signedInteger:
+            switch (size)
+            {
+            case 1:
+            {
+                int8_t value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            case 2:
+            {
+                int16_t value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            case 4:
+            {
+                int32_t value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            case 8:
+            {
+                int64_t value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            }
+            break;
+
+        case BinaryArchiveFormat::Kind::unsignedInteger:
+            switch (size)
+            {
+            case 1:
+            {
+                uint8_t value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            case 2:
+            {
+                uint16_t value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            case 4:
+            {
+                uint32_t value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            case 8:
+            {
+                uint64_t value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            }
+            break;
+
+        case BinaryArchiveFormat::Kind::floatingPoint:
+            switch (size)
+            {
+            case 4:
+            {
+                float value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            case 8:
+            {
+                double value;
+                std::memcpy(&value, data, size);
+                return static_cast<ValueType>(value);
+            }
+            }
+            break;
+        }
+        throw DataFormatException(DataFormatErrors::badFormat, "Binary archive has a value of an unknown type");
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryUnarchiver::ReadScalar(const char* name, ValueType& value)
+    {
+        MatchName(name);
+        MatchTag(BinaryArchiveFormat::Tag::value);
+        auto kind = ReadRaw<BinaryArchiveFormat::Kind>();
+        auto size = ReadRaw<uint8_t>();
+        value = ConvertValue<ValueType>(kind, size, ReadBytes(size));
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryUnarchiver::ReadArray(const char* name, std::vector<ValueType>& array)
+    {
+        MatchName(name);
+        MatchTag(BinaryArchiveFormat::Tag::array);
+        auto kind = ReadRaw<BinaryArchiveFormat::Kind>();
+        auto size = ReadRaw<uint8_t>();
+        auto numElements = static_cast<size_t>(ReadRaw<uint64_t>());
+        auto padding = (BinaryArchiveFormat::arrayAlignment - _position % BinaryArchiveFormat::arrayAlignment) % BinaryArchiveFormat::arrayAlignment;
+        ReadBytes(padding);
+
+        if (size == 0 || numElements > (_size - _position) / size)
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Binary archive ends in the middle of an array");
+        }
+        const char* data = ReadBytes(numElements * size);
+
+        // a block of the same type is copied as it is
+        array.resize(numElements);
+        if constexpr (!std::is_same<ValueType, bool>::value)
+        {
+            if (kind == BinaryArchiverImpl::GetKind<ValueType>() && size == sizeof(ValueType))
+            {
+                std::memcpy(array.data(), data, numElements * size);
+                return;
+            }
+        }
+
+        for (size_t index = 0; index < numElements; ++index)
+        {
+            array[index] = ConvertValue<ValueType>(kind, size, data + index * size);
+        }
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
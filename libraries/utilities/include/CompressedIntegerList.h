@@ -44,6 +44,17 @@ namespace utilities
             /// <returns> An size_t. </returns>
             size_t Get() const { return _value; }
 
+            /// <summary>
+            /// Decodes a block of integers, starting with the current one, and proceeds to the integer that follows
+            /// them. Runs of small deltas are decoded eight at a time.
+            /// </summary>
+            ///
+            /// <param name="values"> The array that receives the integers. </param>
+            /// <param name="maxCount"> The size of the array. </param>
+            ///
+            /// <returns> The number of integers that were decoded, which is 0 if the iterator isn't valid. </returns>
+            size_t Read(size_t* values, size_t maxCount);
+
         private:
             // private ctor, can only be called from CompressedIntegerList class
             Iterator(const uint8_t* iter, const uint8_t* end);
@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ImageTransforms.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "PPMImageParser.h"
+
+#include <cstddef>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> Crops the largest centered region with the given aspect ratio out of an image. </summary>
+    ///
+    /// <param name="image"> The image. </param>
+    /// <param name="width"> The width of the aspect ratio. </param>
+    /// <param name="height"> The height of the aspect ratio. </param>
+    ///
+    /// <returns> The cropped image. </returns>
+    template <typename ValueType>
+    Image<ValueType> CenterCropImage(const Image<ValueType>& image, size_t width, size_t height);
+
+    /// <summary>
+    /// Resizes an image with bilinear interpolation. Pixel centers are aligned like OpenCV's `resize` with `INTER_LINEAR`,
+    /// so the results match images prepared in python with `cv2.resize`. Integer values are rounded.
+    /// </summary>
+    ///
+    /// <param name="image"> The image. </param>
+    /// <param name="width"> The width of the resized image. </param>
+    /// <param name="height"> The height of the resized image. </param>
+    ///
+    /// <returns> The resized image. </returns>
+    template <typename ValueType>
+    Image<ValueType> ResizeImage(const Image<ValueType>& image, size_t width, size_t height);
+} // namespace utilities
+} // namespace ell
@@ -292,9 +292,12 @@ namespace utilities
             MatchFieldName(name);
         }
 
-        // read string
-        auto valueToken = _tokenizer.ReadNextToken();
-        value = static_cast<ValueType>(std::stod(valueToken));
+        // parse the number in place when possible
+        if (!_tokenizer.TryReadNumber(value))
+        {
+            auto valueToken = _tokenizer.ReadNextToken();
+            value = static_cast<ValueType>(std::stod(valueToken));
+        }
 
         // eat a comma if it exists
         if (hasName)
@@ -363,24 +366,35 @@ namespace utilities
         }
 
         _tokenizer.MatchToken("[");
-        while (true)
-        {
-            auto maybeEndArray = _tokenizer.PeekNextToken();
-            if (maybeEndArray == "]")
-            {
-                break;
-            }
 
-            ValueType obj;
-            Unarchive(obj);
-            array.push_back(obj);
+        // floating-point arrays, which hold most of a model's data, are parsed straight into the array
+        bool isArrayRead = false;
+        if constexpr (std::is_floating_point<ValueType>::value)
+        {
+            isArrayRead = _tokenizer.TryReadNumberArray(array, ']');
+        }
 
-            if (_tokenizer.PeekNextToken() == ",")
+        if (!isArrayRead)
+        {
+            while (true)
             {
-                _tokenizer.ReadNextToken();
+                auto maybeEndArray = _tokenizer.PeekNextToken();
+                if (maybeEndArray == "]")
+                {
+                    break;
+                }
+
+                ValueType obj;
+                Unarchive(obj);
+                array.push_back(obj);
+
+                if (_tokenizer.PeekNextToken() == ",")
+                {
+                    _tokenizer.ReadNextToken();
+                }
             }
+            _tokenizer.MatchToken("]");
         }
-        _tokenizer.MatchToken("]");
 
         // eat a comma if it exists
         if (hasName)
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LockFreeQueue.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A fixed-capacity queue for passing values from one thread to another without taking a lock. Only one
+    /// thread may push values and only one thread may pop them.
+    /// </summary>
+    template <typename T>
+    class LockFreeQueue
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="capacity"> The maximum number of values the queue holds. </param>
+        LockFreeQueue(size_t capacity);
+
+        LockFreeQueue(const LockFreeQueue&) = delete;
+        LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+        /// <summary> Gets the maximum number of values the queue holds. </summary>
+        size_t Capacity() const { return _slots.size() - 1; }
+
+        /// <summary> Checks if the queue is empty. The result is only exact when called from the consumer thread. </summary>
+        bool IsEmpty() const;
+
+        /// <summary> Adds a value to the back of the queue, unless it's full. Only called from the producer thread. </summary>
+        ///
+        /// <param name="value"> The value to add. It is left unchanged if the queue is full. </param>
+        ///
+        /// <returns> true if the value was added. </returns>
+        bool TryPush(T&& value);
+
+        /// <summary> Adds a value to the back of the queue, unless it's full. Only called from the producer thread. </summary>
+        ///
+        /// <param name="value"> The value to add. </param>
+        ///
+        /// <returns> true if the value was added. </returns>
+        bool TryPush(const T& value);
+
+        /// <summary> Removes the value at the front of the queue, unless it's empty. Only called from the consumer thread. </summary>
+        ///
+        /// <param name="value"> Receives the value. </param>
+        ///
+        /// <returns> true if a value was removed. </returns>
+        bool TryPop(T& value);
+
+    private:
+        size_t Next(size_t index) const { return index + 1 == _slots.size() ? 0 : index + 1; }
+
+        std::vector<T> _slots; // one slot is always empty, to tell a full queue from an empty one
+        std::atomic<size_t> _head; // the next slot to pop, written by the consumer
+        std::atomic<size_t> _tail; // the next slot to push, written by the producer
+    };
+} // namespace utilities
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename T>
+    LockFreeQueue<T>::LockFreeQueue(size_t capacity) :
+        _slots(capacity + 1),
+        _head(0),
+        _tail(0)
+    {
+    }
+
+    template <typename T>
+    bool LockFreeQueue<T>::IsEmpty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    template <typename T>
+    bool LockFreeQueue<T>::TryPush(T&& value)
+    {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        auto next = Next(tail);
+        if (next == _head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        _slots[tail] = std::move(value);
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool LockFreeQueue<T>::TryPush(const T& value)
+    {
+        T copy(value);
+        return TryPush(std::move(copy));
+    }
+
+    template <typename T>
+    bool LockFreeQueue<T>::TryPop(T& value)
+    {
+        auto head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value = std::move(_slots[head]);
+        _head.store(Next(head), std::memory_order_release);
+        return true;
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
@@ -10,6 +10,10 @@
 
 #include "OutputStreamImpostor.h"
 
+#include <cstdint>
+#include <ostream>
+#include <string>
+
 namespace ell
 {
 namespace utilities
@@ -68,6 +72,93 @@ namespace utilities
         ///
         /// <returns> Returns a reference to a global OutputStreamImpostor object </returns>
         OutputStreamImpostor& Log();
+
+        //
+        // Tracing
+        //
+
+        /// <summary> The kind of a trace record. A span is a `begin` record followed by an `end` record on the same thread. </summary>
+        enum class TracePhase : uint8_t
+        {
+            begin,
+            end,
+            instant
+        };
+
+        /// <summary> Starts collecting trace records. Each thread writes fixed-size binary records into its own
+        /// lock-free ring buffer, which a background thread drains, so tracing can be left on in hot paths.
+        /// Records collected by a previous session are discarded. Does nothing if tracing is already on. </summary>
+        void StartTracing();
+
+        /// <summary> Stops collecting trace records and drains the records that are still buffered. </summary>
+        void StopTracing();
+
+        /// <summary> Returns true if trace records are being collected. </summary>
+        bool IsTracing();
+
+        /// <summary> Returns the id of the trace event with the given name, registering it if needed.
+        /// Registration takes a lock, so hot paths should register their events once up front. </summary>
+        ///
+        /// <param name="name"> The name of the event, as it appears in the exported trace. </param>
+        ///
+        /// <returns> The event id. </returns>
+        uint32_t RegisterTraceEvent(const std::string& name);
+
+        /// <summary> Records a trace event on the calling thread. Does nothing if tracing is off. If the thread's
+        /// ring buffer is full the record is dropped rather than blocking the caller. </summary>
+        ///
+        /// <param name="eventId"> The event id, as returned by `RegisterTraceEvent`. </param>
+        /// <param name="phase"> The kind of record. </param>
+        /// <param name="payload"> A value stored with the record, such as an iteration number or a size. </param>
+        void TraceEvent(uint32_t eventId, TracePhase phase, uint64_t payload = 0);
+
+        /// <summary> Returns the number of records dropped because a ring buffer was full since tracing started. </summary>
+        size_t GetNumDroppedTraceEvents();
+
+        /// <summary> Writes the records collected so far in the Chrome trace event format, which chrome://tracing
+        /// and Perfetto can open. </summary>
+        ///
+        /// <param name="stream"> The stream to write to. </param>
+        void WriteChromeTrace(std::ostream& stream);
+
+        /// <summary> Records a `begin` event on construction and the matching `end` event on destruction. </summary>
+        class TraceSpan
+        {
+        public:
+            /// <summary> Constructor. </summary>
+            ///
+            /// <param name="eventId"> The event id, as returned by `RegisterTraceEvent`. </param>
+            /// <param name="payload"> A value stored with the `begin` record. </param>
+            TraceSpan(uint32_t eventId, uint64_t payload = 0);
+
+            TraceSpan(const TraceSpan&) = delete;
+            TraceSpan& operator=(const TraceSpan&) = delete;
+
+            ~TraceSpan();
+
+        private:
+            uint32_t _eventId;
+            bool _isTracing;
+        };
+
+        /// <summary> Traces for the lifetime of the object and writes a Chrome trace file when it is destroyed.
+        /// An empty filename turns tracing off, which is how the tools make tracing optional. </summary>
+        class TraceFile
+        {
+        public:
+            /// <summary> Constructor. </summary>
+            ///
+            /// <param name="filename"> The file to write the trace to, or an empty string to not trace. </param>
+            TraceFile(const std::string& filename);
+
+            TraceFile(const TraceFile&) = delete;
+            TraceFile& operator=(const TraceFile&) = delete;
+
+            ~TraceFile();
+
+        private:
+            std::string _filename;
+        };
     } // namespace logging
 } // namespace utilities
 namespace logging = utilities::logging;
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A file mapped into memory. The pages are loaded from the file on demand, and writes to the mapped memory
+    /// are private to the process: they're never written back to the file.
+    /// </summary>
+    class MemoryMappedFile
+    {
+    public:
+        /// <summary> Maps a file into memory, and throws an exception if a problem occurs. </summary>
+        ///
+        /// <param name="filepath"> The path of the file. </param>
+        MemoryMappedFile(const std::string& filepath);
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile(MemoryMappedFile&& other);
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(MemoryMappedFile&& other);
+        ~MemoryMappedFile();
+
+        /// <summary> Gets a pointer to the mapped contents of the file. The pointer is aligned to a page boundary. </summary>
+        ///
+        /// <returns> A pointer to the contents of the file, or nullptr if the file is empty. </returns>
+        void* GetData() const { return _data; }
+
+        /// <summary> Gets the size of the file. </summary>
+        ///
+        /// <returns> The size of the file, in bytes. </returns>
+        size_t GetSize() const { return _size; }
+
+    private:
+        void Unmap();
+
+        void* _data = nullptr;
+        size_t _size = 0;
+    };
+} // namespace utilities
+} // namespace ell
@@ -17,6 +17,7 @@ namespace ell
 {
 namespace utilities
 {
+    /// <summary> An image, with its values stored one channel after another (all of the first channel's rows, then the second's, ...). </summary>
     template <typename ValueType>
     struct Image
     {
@@ -26,9 +27,22 @@ namespace utilities
         std::vector<ValueType> data;
     };
 
+    /// <summary>
+    /// Reads a PGM (grayscale) or PPM (RGB) image in either the text (P2, P3) or the binary (P5, P6) format. Floating-point
+    /// values are scaled to [0, 1] by the image's max value, and integer values are returned as stored.
+    /// </summary>
+    ///
+    /// <param name="in"> The input stream, which must be opened in binary mode for the binary formats. </param>
+    ///
+    /// <returns> The image. </returns>
     template <typename ValueType>
     Image<ValueType> ParsePPMStream(std::istream& in);
 
+    /// <summary> Reads a PGM or PPM image file. </summary>
+    ///
+    /// <param name="filename"> The path of the file. </param>
+    ///
+    /// <returns> The image. </returns>
     template <typename ValueType>
     Image<ValueType> ParsePPMFile(const std::string& filename);
 } // namespace utilities
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "ThreadPool.h"
+
 #include <future>
 #include <thread>
 #include <vector>
@@ -18,7 +20,10 @@ namespace ell
 {
 namespace utilities
 {
-    /// <summary> A read-only forward iterator that transforms the items from an input collection. processes items in parallel when possible </summary>
+    /// <summary>
+    /// A read-only forward iterator that transforms the items from an input collection. processes items in parallel when
+    /// possible, as tasks on the host thread pool
+    /// </summary>
     template <typename InputIteratorType, typename OutType, typename FuncType, int MaxTasks = 0>
     class ParallelTransformIterator
     {
@@ -97,7 +102,7 @@ namespace utilities
                 break;
             }
 
-            _futures.emplace_back(std::async(std::launch::async, _transformFunction, _inIter.Get()));
+            _futures.emplace_back(GetHostThreadPool().AddTask(_transformFunction, _inIter.Get()));
             _inIter.Next();
         }
     }
@@ -114,7 +119,7 @@ namespace utilities
         // If necessary, create new std::future to handle next input
         if (_inIter.IsValid())
         {
-            _futures[_currentIndex] = std::async(std::launch::async, _transformFunction, _inIter.Get());
+            _futures[_currentIndex] = GetHostThreadPool().AddTask(_transformFunction, _inIter.Get());
             _inIter.Next();
         }
         else
@@ -133,7 +138,7 @@ namespace utilities
         // Need to cache output of current std::future, because calling std::future::get() twice is an error
         if (!_currentOutputValid)
         {
-            _currentOutput = _futures[_currentIndex].get();
+            _currentOutput = GetHostThreadPool().GetResult(_futures[_currentIndex]);
             _currentOutputValid = true;
         }
 
@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A pool of host threads that run tasks. Every thread has its own task queue, and threads that run out of
+    /// tasks steal them from the other queues. Tasks added by a pool thread go to its own queue. The number of
+    /// queued tasks is bounded, and a task added to a full pool is run right away on the adding thread instead.
+    /// </summary>
+    class ThreadPool
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="numThreads"> The number of threads, or 0 to use all the hardware threads. </param>
+        /// <param name="maxQueuedTasks"> The maximal number of tasks waiting to run. </param>
+        ThreadPool(size_t numThreads = 0, size_t maxQueuedTasks = 4096);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// <summary> Destructor. Waits for the queued tasks to finish. </summary>
+        ~ThreadPool();
+
+        /// <summary> Gets the number of threads in the pool. </summary>
+        size_t NumThreads() const { return _threads.size(); }
+
+        /// <summary> Adds a task to the pool. </summary>
+        ///
+        /// <param name="function"> The function to run. </param>
+        /// <param name="args"> The arguments to call the function with. They are copied, like with `std::async`. </param>
+        ///
+        /// <returns> A future for the result of the function. </returns>
+        template <typename FunctionType, typename... ArgTypes>
+        auto AddTask(FunctionType&& function, ArgTypes&&... args) -> std::future<std::invoke_result_t<std::decay_t<FunctionType>, std::decay_t<ArgTypes>...>>;
+
+        /// <summary>
+        /// Waits for a task's result. While the result isn't ready, the waiting thread runs queued tasks, so tasks
+        /// can wait for the tasks they add without using up the pool's threads.
+        /// </summary>
+        ///
+        /// <param name="future"> The future returned when the task was added. </param>
+        ///
+        /// <returns> The result of the task. </returns>
+        template <typename ValueType>
+        ValueType GetResult(std::future<ValueType>& future);
+
+        /// <summary> Waits for a task to finish, running queued tasks in the meantime like `GetResult`. </summary>
+        ///
+        /// <param name="future"> The future returned when the task was added. </param>
+        template <typename ValueType>
+        void Wait(const std::future<ValueType>& future);
+
+        /// <summary> Runs one of the queued tasks on the calling thread, if there is one. </summary>
+        ///
+        /// <returns> true if a task was run. </returns>
+        bool RunPendingTask();
+
+    private:
+        using Task = std::function<void()>;
+        struct TaskQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void Submit(Task task);
+        bool TryGetTask(Task& task);
+        void RunThread(size_t queueIndex);
+
+        std::vector<std::unique_ptr<TaskQueue>> _queues;
+        std::vector<std::thread> _threads;
+        size_t _maxQueuedTasks;
+
+        std::mutex _wakeMutex;
+        std::condition_variable _wakeCondition;
+        std::atomic<size_t> _numQueuedTasks{ 0 };
+        std::atomic<size_t> _nextQueue{ 0 };
+        bool _isStopping = false;
+    };
+
+    /// <summary> Gets the thread pool shared by the host-side code, which has one thread per hardware thread. </summary>
+    ///
+    /// <returns> The shared thread pool. </returns>
+    ThreadPool& GetHostThreadPool();
+} // namespace utilities
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename FunctionType, typename... ArgTypes>
+    auto ThreadPool::AddTask(FunctionType&& function, ArgTypes&&... args) -> std::future<std::invoke_result_t<std::decay_t<FunctionType>, std::decay_t<ArgTypes>...>>
+    {
+        using ResultType = std::invoke_result_t<std::decay_t<FunctionType>, std::decay_t<ArgTypes>...>;
+
+        // std::function needs a copyable target, so the packaged task is shared
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(
+            [function = std::forward<FunctionType>(function), arguments = std::make_tuple(std::forward<ArgTypes>(args)...)]() mutable {
+                return std::apply(function, std::move(arguments));
+            });
+        auto result = task->get_future();
+        Submit([task]() { (*task)(); });
+        return result;
+    }
+
+    template <typename ValueType>
+    ValueType ThreadPool::GetResult(std::future<ValueType>& future)
+    {
+        Wait(future);
+        return future.get();
+    }
+
+    template <typename ValueType>
+    void ThreadPool::Wait(const std::future<ValueType>& future)
+    {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            if (!RunPendingTask())
+            {
+                future.wait_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
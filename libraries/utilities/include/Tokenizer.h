@@ -41,18 +41,18 @@ namespace utilities
         /// <summary> Matches the next token from the input stream. Returns 'false' if token doesn't match. </summary>
         ///
         /// <param name="token"> The token to match. </param>
-        bool TryMatchToken(std::string token);
+        bool TryMatchToken(const std::string& token);
 
         /// <summary> Matches the next token from the input stream. Returns 'false' if token doesn't match. </summary>
         ///
         /// <param name="token"> The token to match. </param>
         /// <param name="readToek"> The token actually read. </param>
-        bool TryMatchToken(std::string token, std::string& readToken);
+        bool TryMatchToken(const std::string& token, std::string& readToken);
 
         /// <summary> Matches the next token from the input stream. Throws an exception if token doesn't match. </summary>
         ///
         /// <param name="token"> The token to match. </param>
-        void MatchToken(std::string token);
+        void MatchToken(const std::string& token);
 
         /// <summary> Matches the next token from the input stream. Throws an exception if token doesn't match. </summary>
         ///
@@ -64,6 +64,28 @@ namespace utilities
         /// <returns> The next token, or the empty string if the end of file is reached. </returns>
         std::string PeekNextToken();
 
+        /// <summary>
+        /// Reads a number straight out of the text buffer, without making a token string. Returns 'false' without
+        /// consuming anything if a token has been peeked or put back, in which case the caller must read tokens instead.
+        /// </summary>
+        ///
+        /// <typeparam name="ValueType"> The type of number to read. </typeparam>
+        /// <param name="value"> [out] The value read. </param>
+        template <typename ValueType>
+        bool TryReadNumber(ValueType& value);
+
+        /// <summary>
+        /// Reads the comma-separated numbers of an array whose opening bracket has already been matched, up to and
+        /// including the closing bracket, straight out of the text buffer. Returns 'false' without consuming anything
+        /// if a token has been peeked or put back.
+        /// </summary>
+        ///
+        /// <typeparam name="ValueType"> The type of the array elements. </typeparam>
+        /// <param name="array"> [in,out] The array the values are appended to. </param>
+        /// <param name="endChar"> The character that closes the array. </param>
+        template <typename ValueType>
+        bool TryReadNumberArray(std::vector<ValueType>& array, char endChar);
+
         /// <summary> Consumes entire stream, printing tokens as they're read. For debugging. </summary>
         ///
         /// <param name="os"> The stream to print the tokens to. </param>
@@ -78,6 +100,10 @@ namespace utilities
         int GetNextCharacter();
         void UngetCharacter();
         void ReadData();
+        int SkipWhitespace();
+        const char* GetBufferedText(size_t minLength);
+        void ConsumeBufferedText(const char* position);
+        size_t CountBufferedCharacters(char ch, char endChar) const;
 
         std::vector<char> _textBuffer;
         std::vector<char>::iterator _tokenStart;
@@ -125,3 +151,78 @@ namespace utilities
 
 } // namespace utilities
 } // namespace ell
+
+#pragma region implementation
+
+#include "CStringParser.h"
+#include "Exception.h"
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename ValueType>
+    bool Tokenizer::TryReadNumber(ValueType& value)
+    {
+        if (!_peekedTokens.empty() || SkipWhitespace() == EOF)
+        {
+            return false;
+        }
+
+        // numbers are parsed as double, like the token-based path does, and then cast
+        const size_t maxNumberLength = 64;
+        auto begin = GetBufferedText(maxNumberLength);
+        auto end = begin;
+        double number = 0;
+        if (Parse(end, number) != ParseResult::success)
+        {
+            throw InputException(InputExceptionErrors::badStringFormat, "Failed to parse a number");
+        }
+        ConsumeBufferedText(end);
+        value = static_cast<ValueType>(number);
+        return true;
+    }
+
+    template <typename ValueType>
+    bool Tokenizer::TryReadNumberArray(std::vector<ValueType>& array, char endChar)
+    {
+        if (!_peekedTokens.empty())
+        {
+            return false;
+        }
+
+        // every element but the last one is followed by a comma, so the commas already in the buffer give a good size estimate
+        array.reserve(array.size() + CountBufferedCharacters(',', endChar) + 1);
+        if (SkipWhitespace() == endChar)
+        {
+            GetNextCharacter();
+            _tokenStart = _currentPosition;
+            return true;
+        }
+
+        while (true)
+        {
+            ValueType value;
+            if (!TryReadNumber(value))
+            {
+                throw InputException(InputExceptionErrors::badStringFormat, "Unexpected end of input while reading an array");
+            }
+            array.push_back(value);
+
+            auto next = SkipWhitespace();
+            GetNextCharacter();
+            _tokenStart = _currentPosition;
+            if (next == endChar)
+            {
+                return true;
+            }
+            if (next != ',')
+            {
+                throw InputException(InputExceptionErrors::badStringFormat, std::string{ "Failed to match token , or " } + endChar + " in an array");
+            }
+        }
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
@@ -11,11 +11,14 @@
 #include "Debug.h"
 #include "Exception.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace ell
 {
@@ -79,22 +82,6 @@ namespace utilities
         std::unordered_map<std::string, std::function<std::unique_ptr<BaseType>()>> _typeMap;
     };
 
-    /// <summary>
-    /// An internal class used by GenericTypeFactory
-    /// </summary>
-    class TypeConstructorBase
-    {
-    public:
-        virtual ~TypeConstructorBase() = default;
-
-    private:
-        friend class GenericTypeFactory;
-        template <typename BaseType>
-        friend class TypeConstructor;
-        template <typename BaseType>
-        std::unique_ptr<BaseType> Construct() const;
-    };
-
     /// <summary>
     /// A factory object that can create new objects given their type name and a base type to derive from.
     /// </summary>
@@ -124,8 +111,25 @@ namespace utilities
         template <typename BaseType, typename RuntimeType>
         void AddType(const std::string& typeName);
 
+        /// <summary>
+        /// Makes the types of another factory available from this one, without copying them. Types added to this
+        /// factory are found first, then the other factories' types, in the order they were added. The other
+        /// factory must outlive this one, so it's usually a static factory that is filled once per process.
+        /// </summary>
+        ///
+        /// <param name="factory"> The factory to share the types of. </param>
+        void AddTypes(const GenericTypeFactory& factory);
+
     private:
-        std::unordered_map<std::string, std::shared_ptr<TypeConstructorBase>> _typeConstructorMap;
+        // The constructors are plain function pointers, with the base type erased, so adding a type doesn't allocate
+        // anything besides its entry in the map
+        using ConstructorFunction = void (*)();
+
+        static std::string GetTypeKey(const std::string& baseTypeName, const std::string& typeName);
+        ConstructorFunction FindConstructor(const std::string& key) const;
+
+        std::unordered_map<std::string, ConstructorFunction> _typeConstructorMap;
+        std::vector<const GenericTypeFactory*> _sharedFactories;
     };
 } // namespace utilities
 } // namespace ell
@@ -168,63 +172,51 @@ namespace utilities
     }
 
     //
-    // GenericTypeFactory
+    // GenericTypeFactory implementation
     //
-    template <typename BaseType>
-    class TypeConstructorDerived : public TypeConstructorBase
+    namespace detail
     {
-    public:
-        template <typename RuntimeType>
-        static std::unique_ptr<TypeConstructorDerived<BaseType>> NewTypeConstructor()
-        {
-            auto result = std::make_unique<TypeConstructorDerived<BaseType>>();
-            result->_createFunction = []() {
-                auto runtimePtr = new RuntimeType();
-                auto basePtr = dynamic_cast<BaseType*>(runtimePtr);
-                return std::unique_ptr<BaseType>(basePtr);
-            };
-            return result;
-        }
-
-        std::unique_ptr<BaseType> Construct() const
+        template <typename BaseType, typename RuntimeType>
+        std::unique_ptr<BaseType> ConstructType()
         {
-            return _createFunction();
+            return std::make_unique<RuntimeType>();
         }
+    } // namespace detail
 
-    private:
-        std::function<std::unique_ptr<BaseType>()> _createFunction;
-    };
+    inline std::string GenericTypeFactory::GetTypeKey(const std::string& baseTypeName, const std::string& typeName)
+    {
+        return baseTypeName + "__" + typeName;
+    }
 
-    //
-    // TypeConstructorBase implementation
-    //
-    template <typename BaseType>
-    std::unique_ptr<BaseType> TypeConstructorBase::Construct() const
+    inline GenericTypeFactory::ConstructorFunction GenericTypeFactory::FindConstructor(const std::string& key) const
     {
-        auto thisPtr = dynamic_cast<const TypeConstructorDerived<BaseType>*>(this);
-        if (thisPtr == nullptr)
+        auto entry = _typeConstructorMap.find(key);
+        if (entry != _typeConstructorMap.end())
         {
-            throw InputException(InputExceptionErrors::typeMismatch, std::string{ "TypeConstructorBase::Construct called with wrong type. BaseType: " } + BaseType::GetTypeName());
+            return entry->second;
         }
 
-        return thisPtr->Construct();
+        for (auto factory : _sharedFactories)
+        {
+            if (auto constructor = factory->FindConstructor(key))
+            {
+                return constructor;
+            }
+        }
+        return nullptr;
     }
 
-    //
-    // GenericTypeFactory implementation
-    //
     template <typename BaseType>
     std::unique_ptr<BaseType> GenericTypeFactory::Construct(const std::string& typeName) const
     {
-        auto baseTypeName = std::string{ BaseType::GetTypeName() };
-        auto key = baseTypeName + "__" + typeName;
-        auto entry = _typeConstructorMap.find(key);
-        if (entry == _typeConstructorMap.end())
+        // The key includes the base type's name, so the constructor was added with this base type
+        auto constructor = FindConstructor(GetTypeKey(BaseType::GetTypeName(), typeName));
+        if (constructor == nullptr)
         {
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "type " + typeName + " not registered in TypeFactory<" + BaseType::GetTypeName() + ">");
         }
 
-        return entry->second->Construct<BaseType>();
+        return reinterpret_cast<std::unique_ptr<BaseType> (*)()>(constructor)();
     }
 
     template <typename BaseType, typename RuntimeType>
@@ -237,11 +229,18 @@ namespace utilities
     template <typename BaseType, typename RuntimeType>
     void GenericTypeFactory::AddType(const std::string& typeName)
     {
-        auto baseTypeName = std::string{ BaseType::GetTypeName() };
-        auto key = baseTypeName + "__" + typeName;
+        static_assert(std::is_base_of<BaseType, RuntimeType>::value, "incompatible base and runtime types in GenericTypeFactory::AddType");
 
-        auto derivedCreator = TypeConstructorDerived<BaseType>::template NewTypeConstructor<RuntimeType>().release();
-        _typeConstructorMap[key] = std::shared_ptr<TypeConstructorBase>(derivedCreator);
+        auto constructor = &detail::ConstructType<BaseType, RuntimeType>;
+        _typeConstructorMap[GetTypeKey(BaseType::GetTypeName(), typeName)] = reinterpret_cast<ConstructorFunction>(constructor);
+    }
+
+    inline void GenericTypeFactory::AddTypes(const GenericTypeFactory& factory)
+    {
+        if (&factory != this && std::find(_sharedFactories.begin(), _sharedFactories.end(), &factory) == _sharedFactories.end())
+        {
+            _sharedFactories.push_back(&factory);
+        }
     }
 } // namespace utilities
 } // namespace ell
@@ -10,6 +10,7 @@
 
 #include "IArchivable.h"
 
+#include <atomic>
 #include <functional>
 #include <ostream>
 #include <string>
@@ -72,7 +73,7 @@ namespace utilities
     private:
         friend std::hash<UniqueId>;
         std::string _id = "0";
-        static size_t _nextId;
+        static std::atomic<size_t> _nextId;
     };
 
     std::string to_string(const UniqueId& id);
@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Benchmark.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#if defined(WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ell
+{
+namespace utilities
+{
+    namespace
+    {
+        // high_resolution_clock isn't guaranteed to be monotonic, so it's only used when it is
+        using BenchmarkClock = std::conditional_t<std::chrono::high_resolution_clock::is_steady, std::chrono::high_resolution_clock, std::chrono::steady_clock>;
+
+        double GetNanoseconds(BenchmarkClock::duration duration)
+        {
+            return std::chrono::duration<double, std::nano>(duration).count();
+        }
+
+        double TimeSample(const std::function<void()>& function, size_t numCalls)
+        {
+            auto start = BenchmarkClock::now();
+            for (size_t index = 0; index < numCalls; ++index)
+            {
+                function();
+            }
+            return GetNanoseconds(BenchmarkClock::now() - start);
+        }
+
+        double GetPercentile(const std::vector<double>& sortedSamples, double percentile)
+        {
+            auto position = percentile * static_cast<double>(sortedSamples.size() - 1);
+            auto lower = static_cast<size_t>(std::floor(position));
+            auto upper = std::min(lower + 1, sortedSamples.size() - 1);
+            auto fraction = position - static_cast<double>(lower);
+            return sortedSamples[lower] + fraction * (sortedSamples[upper] - sortedSamples[lower]);
+        }
+
+        void WriteJsonString(std::ostream& stream, const std::string& value)
+        {
+            stream << '"';
+            for (auto ch : value)
+            {
+                if (ch == '"' || ch == '\\')
+                {
+                    stream << '\\';
+                }
+                stream << ch;
+            }
+            stream << '"';
+        }
+    } // namespace
+
+    BenchmarkStatistics GetBenchmarkStatistics(std::vector<double> samples)
+    {
+        BenchmarkStatistics statistics;
+        if (samples.empty())
+        {
+            return statistics;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        auto size = static_cast<double>(samples.size());
+        statistics.numSamples = samples.size();
+        statistics.min = samples.front();
+        statistics.max = samples.back();
+        statistics.median = GetPercentile(samples, 0.5);
+        statistics.p90 = GetPercentile(samples, 0.9);
+        statistics.p99 = GetPercentile(samples, 0.99);
+        statistics.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / size;
+
+        double sumSquares = 0;
+        for (auto sample : samples)
+        {
+            sumSquares += (sample - statistics.mean) * (sample - statistics.mean);
+        }
+        statistics.standardDeviation = std::sqrt(sumSquares / size);
+        return statistics;
+    }
+
+    double GetBenchmarkTimerOverhead()
+    {
+        const size_t numSamples = 1001;
+        std::vector<double> samples;
+        samples.reserve(numSamples);
+        for (size_t index = 0; index < numSamples; ++index)
+        {
+            auto start = BenchmarkClock::now();
+            samples.push_back(GetNanoseconds(BenchmarkClock::now() - start));
+        }
+        return GetBenchmarkStatistics(std::move(samples)).median;
+    }
+
+    bool PinThreadToCpu(int cpu)
+    {
+        if (cpu < 0 || cpu >= static_cast<int>(std::thread::hardware_concurrency()))
+        {
+            return false;
+        }
+#if defined(WIN32)
+        return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{ 1 } << cpu) != 0;
+#elif defined(__linux__)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+        return false;
+#endif
+    }
+
+    BenchmarkResult RunBenchmark(const std::string& name, const std::function<void()>& function, const BenchmarkOptions& options)
+    {
+        BenchmarkResult result;
+        result.name = name;
+
+        for (size_t index = 0; index < options.numWarmupIterations; ++index)
+        {
+            function();
+        }
+
+        // repeat short calls within a sample, so the clock resolution doesn't dominate
+        const auto minSampleTime = options.minSampleTimeSeconds * 1e9;
+        while (result.callsPerSample < (size_t{ 1 } << 20) && TimeSample(function, result.callsPerSample) < minSampleTime)
+        {
+            result.callsPerSample *= 2;
+        }
+
+        result.timerOverhead = GetBenchmarkTimerOverhead() / static_cast<double>(result.callsPerSample);
+
+        std::vector<double> samples;
+        const auto minTime = options.minTimeSeconds * 1e9;
+        double totalTime = 0;
+        while (samples.size() < options.maxSamples && (samples.size() < options.minSamples || totalTime < minTime))
+        {
+            auto sampleTime = TimeSample(function, result.callsPerSample);
+            totalTime += sampleTime;
+            samples.push_back(std::max(sampleTime / static_cast<double>(result.callsPerSample) - result.timerOverhead, 0.0));
+        }
+
+        result.statistics = GetBenchmarkStatistics(std::move(samples));
+        return result;
+    }
+
+    void BenchmarkSuite::Add(const std::string& name, std::function<std::function<void()>()> setup)
+    {
+        _benchmarks.emplace_back(name, std::move(setup));
+    }
+
+    std::vector<std::string> BenchmarkSuite::GetNames() const
+    {
+        std::vector<std::string> names;
+        for (const auto& benchmark : _benchmarks)
+        {
+            names.push_back(benchmark.first);
+        }
+        return names;
+    }
+
+    std::vector<BenchmarkResult> BenchmarkSuite::Run(const BenchmarkOptions& options, const std::string& filter) const
+    {
+        if (options.cpu >= 0)
+        {
+            PinThreadToCpu(options.cpu);
+        }
+
+        std::vector<BenchmarkResult> results;
+        for (const auto& benchmark : _benchmarks)
+        {
+            if (benchmark.first.find(filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            auto function = benchmark.second();
+            results.push_back(RunBenchmark(benchmark.first, function, options));
+        }
+        return results;
+    }
+
+    void WriteBenchmarkResultsJson(std::ostream& stream, const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options, const std::string& version)
+    {
+        auto flags = stream.flags();
+        auto precision = stream.precision(12);
+        stream << std::defaultfloat;
+        stream << "{\n";
+        stream << "  \"context\": {\n";
+        stream << "    \"version\": ";
+        WriteJsonString(stream, version);
+        stream << ",\n";
+        stream << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+        stream << "    \"cpu\": " << options.cpu << ",\n";
+        stream << "    \"num_warmup_iterations\": " << options.numWarmupIterations << ",\n";
+        stream << "    \"time_unit\": \"ns\"\n";
+        stream << "  },\n";
+        stream << "  \"benchmarks\": [";
+        for (size_t index = 0; index < results.size(); ++index)
+        {
+            const auto& result = results[index];
+            const auto& statistics = result.statistics;
+            stream << (index == 0 ? "\n" : ",\n");
+            stream << "    {\n";
+            stream << "      \"name\": ";
+            WriteJsonString(stream, result.name);
+            stream << ",\n";
+            stream << "      \"num_samples\": " << statistics.numSamples << ",\n";
+            stream << "      \"calls_per_sample\": " << result.callsPerSample << ",\n";
+            stream << "      \"timer_overhead\": " << result.timerOverhead << ",\n";
+            stream << "      \"min\": " << statistics.min << ",\n";
+            stream << "      \"median\": " << statistics.median << ",\n";
+            stream << "      \"mean\": " << statistics.mean << ",\n";
+            stream << "      \"p90\": " << statistics.p90 << ",\n";
+            stream << "      \"p99\": " << statistics.p99 << ",\n";
+            stream << "      \"max\": " << statistics.max << ",\n";
+            stream << "      \"stddev\": " << statistics.standardDeviation << "\n";
+            stream << "    }";
+        }
+        stream << "\n  ]\n";
+        stream << "}\n";
+        stream.flags(flags);
+        stream.precision(precision);
+    }
+
+    void WriteBenchmarkResultsText(std::ostream& stream, const std::vector<BenchmarkResult>& results)
+    {
+        auto flags = stream.flags();
+        auto precision = stream.precision(1);
+        size_t nameWidth = 9;
+        for (const auto& result : results)
+        {
+            nameWidth = std::max(nameWidth, result.name.size());
+        }
+
+        stream << std::left << std::setw(static_cast<int>(nameWidth)) << "Benchmark" << std::right;
+        for (auto column : { "median ns", "p90 ns", "p99 ns", "samples" })
+        {
+            stream << std::setw(14) << column;
+        }
+        stream << "\n";
+
+        for (const auto& result : results)
+        {
+            const auto& statistics = result.statistics;
+            stream << std::left << std::setw(static_cast<int>(nameWidth)) << result.name << std::right;
+            stream << std::fixed << std::setw(14) << statistics.median << std::setw(14) << statistics.p90 << std::setw(14) << statistics.p99;
+            stream << std::setw(14) << statistics.numSamples << "\n";
+        }
+        stream.flags(flags);
+        stream.precision(precision);
+    }
+} // namespace utilities
+} // namespace ell
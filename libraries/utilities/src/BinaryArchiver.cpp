@@ -0,0 +1,357 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryArchiver.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryArchiver.h"
+#include "IArchivable.h"
+#include "Unused.h"
+
+#include <algorithm>
+
+namespace ell
+{
+namespace utilities
+{
+    bool BinaryArchiveFormat::HasHeader(const char* data, size_t size)
+    {
+        return size >= headerSize && std::equal(magic, magic + sizeof(magic), data);
+    }
+
+    bool BinaryArchiveFormat::HasHeader(std::istream& stream)
+    {
+        char header[sizeof(magic)] = {};
+        auto position = stream.tellg();
+        stream.read(header, sizeof(header));
+        auto numRead = static_cast<size_t>(stream.gcount());
+        stream.clear();
+        stream.seekg(position);
+        return numRead == sizeof(header) && std::equal(magic, magic + sizeof(magic), header);
+    }
+
+    //
+    // Serialization
+    //
+    BinaryArchiver::BinaryArchiver(std::ostream& outputStream) :
+        _out(outputStream)
+    {
+        WriteBytes(BinaryArchiveFormat::magic, sizeof(BinaryArchiveFormat::magic));
+        WriteRaw(BinaryArchiveFormat::version);
+    }
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_ARCHIVE_VALUE(BinaryArchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    // strings
+    void BinaryArchiver::ArchiveValue(const char* name, const std::string& value)
+    {
+        WriteName(name);
+        WriteTag(BinaryArchiveFormat::Tag::string);
+        WriteString(value);
+    }
+
+    void BinaryArchiver::ArchiveNull(const char* name)
+    {
+        WriteName(name);
+        WriteTag(BinaryArchiveFormat::Tag::null);
+    }
+
+    // IArchivable
+    void BinaryArchiver::BeginArchiveObject(const char* name, const IArchivable& value)
+    {
+        WriteName(name);
+        if (value.ArchiveAsPrimitive())
+        {
+            return;
+        }
+
+        WriteTag(BinaryArchiveFormat::Tag::beginObject);
+        WriteString(GetArchivedTypeName(value));
+        WriteRaw(static_cast<int32_t>(GetArchiveVersion(value).versionNumber));
+    }
+
+    void BinaryArchiver::EndArchiveObject(const char* name, const IArchivable& value)
+    {
+        UNUSED(name);
+        if (!value.ArchiveAsPrimitive())
+        {
+            WriteTag(BinaryArchiveFormat::Tag::endObject);
+        }
+    }
+
+    void BinaryArchiver::EndArchiving()
+    {
+        _out.flush();
+    }
+
+//
+// Arrays
+//
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_ARCHIVE_ARRAY(BinaryArchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    void BinaryArchiver::ArchiveArray(const char* name, const std::vector<std::string>& array)
+    {
+        WriteName(name);
+        WriteTag(BinaryArchiveFormat::Tag::stringArray);
+        WriteRaw(static_cast<uint64_t>(array.size()));
+        for (const auto& value : array)
+        {
+            WriteString(value);
+        }
+    }
+
+    void BinaryArchiver::ArchiveArray(const char* name, const std::string& baseTypeName, const std::vector<const IArchivable*>& array)
+    {
+        WriteName(name);
+        WriteTag(BinaryArchiveFormat::Tag::beginObjectArray);
+        WriteString(baseTypeName);
+        for (const auto& item : array)
+        {
+            Archive(*item);
+        }
+        WriteTag(BinaryArchiveFormat::Tag::endObjectArray);
+    }
+
+    void BinaryArchiver::WriteName(const char* name)
+    {
+        // unnamed values have no name record, like in the text archives
+        if (name[0] != '\0')
+        {
+            WriteTag(BinaryArchiveFormat::Tag::name);
+            WriteString(name);
+        }
+    }
+
+    void BinaryArchiver::WriteTag(BinaryArchiveFormat::Tag tag)
+    {
+        WriteRaw(tag);
+    }
+
+    void BinaryArchiver::WriteString(const std::string& value)
+    {
+        WriteRaw(static_cast<uint64_t>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+
+    void BinaryArchiver::WriteBytes(const void* data, size_t size)
+    {
+        _out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        _position += size;
+    }
+
+    //
+    // Deserialization
+    //
+    BinaryUnarchiver::BinaryUnarchiver(std::istream& inputStream, SerializationContext context) :
+        Unarchiver(std::move(context))
+    {
+        const size_t chunkSize = 1 << 20;
+        while (inputStream)
+        {
+            auto size = _buffer.size();
+            _buffer.resize(size + chunkSize);
+            inputStream.read(_buffer.data() + size, static_cast<std::streamsize>(chunkSize));
+            _buffer.resize(size + static_cast<size_t>(inputStream.gcount()));
+        }
+
+        // the buffer is allocated with the alignment of new, which is enough for all the fundamental types
+        _data = _buffer.data();
+        _size = _buffer.size();
+        ReadHeader();
+    }
+
+    BinaryUnarchiver::BinaryUnarchiver(const char* data, size_t size, SerializationContext context) :
+        Unarchiver(std::move(context)),
+        _data(data),
+        _size(size)
+    {
+        ReadHeader();
+    }
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_VALUE(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    // strings
+    void BinaryUnarchiver::UnarchiveValue(const char* name, std::string& value)
+    {
+        MatchName(name);
+        MatchTag(BinaryArchiveFormat::Tag::string);
+        value = ReadString();
+    }
+
+    bool BinaryUnarchiver::UnarchiveNull(const char* name)
+    {
+        auto position = _position;
+        if (name[0] == '\0' || HasNextPropertyName(name))
+        {
+            MatchName(name);
+            if (PeekTag(BinaryArchiveFormat::Tag::null))
+            {
+                MatchTag(BinaryArchiveFormat::Tag::null);
+                return true;
+            }
+        }
+
+        _position = position;
+        return false;
+    }
+
+    // IArchivable
+    ArchivedObjectInfo BinaryUnarchiver::BeginUnarchiveObject(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        MatchName(name);
+        MatchTag(BinaryArchiveFormat::Tag::beginObject);
+        auto encodedTypeName = ReadString();
+        if (encodedTypeName == "")
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is invalid, expecting a non empty object type name");
+        }
+        auto version = ReadRaw<int32_t>();
+        return { encodedTypeName, version };
+    }
+
+    void BinaryUnarchiver::EndUnarchiveObject(const char* name, const std::string& typeName)
+    {
+        UNUSED(name, typeName);
+        MatchTag(BinaryArchiveFormat::Tag::endObject);
+    }
+
+    void BinaryUnarchiver::UnarchiveObjectAsPrimitive(const char* name, IArchivable& value)
+    {
+        MatchName(name);
+        UnarchiveObject(name, value);
+    }
+
+    bool BinaryUnarchiver::HasNextPropertyName(const std::string& name)
+    {
+        if (!PeekTag(BinaryArchiveFormat::Tag::name))
+        {
+            return false;
+        }
+
+        auto position = _position;
+        MatchTag(BinaryArchiveFormat::Tag::name);
+        auto nextPropertyName = ReadString();
+        _position = position;
+        return nextPropertyName == name;
+    }
+
+//
+// Arrays
+//
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_ARRAY(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    void BinaryUnarchiver::UnarchiveArray(const char* name, std::vector<std::string>& array)
+    {
+        MatchName(name);
+        MatchTag(BinaryArchiveFormat::Tag::stringArray);
+        auto numElements = static_cast<size_t>(ReadRaw<uint64_t>());
+        for (size_t index = 0; index < numElements; ++index)
+        {
+            array.push_back(ReadString());
+        }
+    }
+
+    void BinaryUnarchiver::BeginUnarchiveArray(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        MatchName(name);
+        MatchTag(BinaryArchiveFormat::Tag::beginObjectArray);
+        ReadString(); // the base type name
+    }
+
+    bool BinaryUnarchiver::BeginUnarchiveArrayItem(const std::string& typeName)
+    {
+        UNUSED(typeName);
+        return !PeekTag(BinaryArchiveFormat::Tag::endObjectArray);
+    }
+
+    void BinaryUnarchiver::EndUnarchiveArrayItem(const std::string& typeName)
+    {
+        UNUSED(typeName);
+    }
+
+    void BinaryUnarchiver::EndUnarchiveArray(const char* name, const std::string& typeName)
+    {
+        UNUSED(name, typeName);
+        MatchTag(BinaryArchiveFormat::Tag::endObjectArray);
+    }
+
+    void BinaryUnarchiver::ReadHeader()
+    {
+        if (!BinaryArchiveFormat::HasHeader(_data, _size))
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Data is not a binary archive");
+        }
+
+        ReadBytes(sizeof(BinaryArchiveFormat::magic));
+        auto version = ReadRaw<uint32_t>();
+        if (version > BinaryArchiveFormat::version)
+        {
+            throw InputException(InputExceptionErrors::versionMismatch, "Binary archive has a newer format version than this reader");
+        }
+    }
+
+    void BinaryUnarchiver::MatchName(const char* name)
+    {
+        if (name[0] == '\0')
+        {
+            return;
+        }
+
+        if (!PeekTag(BinaryArchiveFormat::Tag::name))
+        {
+            throw InputException(InputExceptionErrors::badStringFormat, std::string{ "Failed to match field " } + name);
+        }
+
+        MatchTag(BinaryArchiveFormat::Tag::name);
+        auto found = ReadString();
+        if (found != name)
+        {
+            throw InputException(InputExceptionErrors::badStringFormat, std::string{ "Failed to match field " } + name + ", instead found '" + found + "'");
+        }
+    }
+
+    void BinaryUnarchiver::MatchTag(BinaryArchiveFormat::Tag tag)
+    {
+        if (ReadRaw<BinaryArchiveFormat::Tag>() != tag)
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive has an unexpected record");
+        }
+    }
+
+    bool BinaryUnarchiver::PeekTag(BinaryArchiveFormat::Tag tag) const
+    {
+        return _position < _size && static_cast<BinaryArchiveFormat::Tag>(_data[_position]) == tag;
+    }
+
+    std::string BinaryUnarchiver::ReadString()
+    {
+        auto size = static_cast<size_t>(ReadRaw<uint64_t>());
+        auto data = ReadBytes(size);
+        return std::string(data, size);
+    }
+
+    const char* BinaryUnarchiver::ReadBytes(size_t size)
+    {
+        if (size > _size - _position)
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Binary archive ends unexpectedly");
+        }
+
+        auto data = _data + _position;
+        _position += size;
+        return data;
+    }
+} // namespace utilities
+} // namespace ell
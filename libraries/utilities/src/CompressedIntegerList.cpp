@@ -17,31 +17,85 @@ namespace ell
 {
 namespace utilities
 {
-    void CompressedIntegerList::Iterator::Next()
+    namespace
     {
-        size_t delta;
-        _iter += _iter_increment;
-        uint8_t first_val = *_iter;
+        // the top 2 bits of each byte of a run of single byte deltas are zero
+        constexpr uint64_t multiByteMask = 0xc0c0c0c0c0c0c0c0;
 
-        // chop off top 2 bits --- they encode the # of bytes needed for this delta
-        // 00 = 1 byte, 01 = 2 bytes, 10 = 4 bytes, 11 = 8 bytes
-        int total_bytes = 1 << ((first_val >> 6) & 0x03);
-        assert(total_bytes <= 8);
-        if (total_bytes == 1)
+        size_t DecodeDelta(const uint8_t* iter, int& total_bytes)
         {
-            // first_val &= 0x3f; // this is commented out because we don't need to strip off the top 2 bits of first_val in this case, because they're always zero
-            delta = first_val;
+            uint8_t first_val = *iter;
+            total_bytes = 1 << ((first_val >> 6) & 0x03);
+            if (total_bytes == 1)
+            {
+                // we don't need to strip off the top 2 bits of first_val in this case, because they're always zero
+                return first_val;
+            }
+
+            // read in the Next bytes, shift them over to fit the 6 bits of first_val we're using, and Add first_val
+            size_t delta = 0;
+            std::memcpy(&delta, iter + 1, total_bytes - 1);
+            return (delta << 6) | (first_val & 0x3f);
         }
-        else
+    } // namespace
+
+    size_t CompressedIntegerList::Iterator::Read(size_t* values, size_t maxCount)
+    {
+        if (!IsValid() || maxCount == 0)
         {
-            // read in the Next bytes, shift them over to fit the 6 bits of first_val we're using, and Add first_val
-            delta = 0;
-            std::memcpy(&delta, _iter + 1, total_bytes - 1);
-            delta = (delta << 6) | (first_val & 0x3f);
+            return 0;
         }
 
+        size_t count = 0;
+        values[count++] = _value;
+        auto iter = _iter + _iter_increment;
+        while (count < maxCount && iter < _end)
+        {
+            if (count + 8 <= maxCount && iter + 8 <= _end)
+            {
+                uint64_t word;
+                std::memcpy(&word, iter, sizeof(word));
+                if ((word & multiByteMask) == 0)
+                {
+                    for (int i = 0; i < 8; ++i)
+                    {
+                        _value += iter[i];
+                        values[count++] = _value;
+                    }
+                    _iter = iter + 7;
+                    _iter_increment = 1;
+                    iter += 8;
+                    continue;
+                }
+            }
+
+            int total_bytes;
+            _value += DecodeDelta(iter, total_bytes);
+            values[count++] = _value;
+            _iter = iter;
+            _iter_increment = total_bytes;
+            iter += total_bytes;
+        }
+
+        // the iterator now points to the last integer that was read
+        Next();
+        return count;
+    }
+
+    void CompressedIntegerList::Iterator::Next()
+    {
+        _iter += _iter_increment;
+        if (_iter >= _end)
+        {
+            return;
+        }
+
+        // the top 2 bits of the first byte encode the # of bytes needed for this delta
+        // 00 = 1 byte, 01 = 2 bytes, 10 = 4 bytes, 11 = 8 bytes
+        int total_bytes;
+        _value += DecodeDelta(_iter, total_bytes);
+        assert(total_bytes <= 8);
         _iter_increment = total_bytes;
-        _value += delta;
     }
 
     CompressedIntegerList::Iterator::Iterator(const uint8_t* iter, const uint8_t* end) :
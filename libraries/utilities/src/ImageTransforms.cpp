@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ImageTransforms.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ImageTransforms.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    namespace
+    {
+        // The two source indices and the weight of the second one, for each destination index along one dimension
+        struct Interpolation
+        {
+            size_t index0;
+            size_t index1;
+            double weight1;
+        };
+
+        std::vector<Interpolation> GetInterpolation(size_t sourceSize, size_t destinationSize)
+        {
+            std::vector<Interpolation> result(destinationSize);
+            auto scale = static_cast<double>(sourceSize) / destinationSize;
+            for (size_t index = 0; index < destinationSize; ++index)
+            {
+                auto position = std::clamp((index + 0.5) * scale - 0.5, 0.0, static_cast<double>(sourceSize - 1));
+                auto index0 = static_cast<size_t>(position);
+                result[index] = { index0, std::min(index0 + 1, sourceSize - 1), position - index0 };
+            }
+            return result;
+        }
+
+        template <typename ValueType>
+        ValueType GetValue(double value)
+        {
+            if constexpr (std::is_floating_point_v<ValueType>)
+            {
+                return static_cast<ValueType>(value);
+            }
+            else
+            {
+                return static_cast<ValueType>(std::lround(value));
+            }
+        }
+    } // namespace
+
+    template <typename ValueType>
+    Image<ValueType> CenterCropImage(const Image<ValueType>& image, size_t width, size_t height)
+    {
+        if (width == 0 || height == 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Crop size must be positive");
+        }
+
+        // The crop keeps the full width or the full height, whichever is limiting
+        auto cropWidth = std::min(image.width, image.height * width / height);
+        auto cropHeight = std::min(image.height, image.width * height / width);
+        auto left = (image.width - cropWidth) / 2;
+        auto top = (image.height - cropHeight) / 2;
+
+        Image<ValueType> result{ cropWidth, cropHeight, image.numChannels, std::vector<ValueType>(cropWidth * cropHeight * image.numChannels) };
+        for (size_t channel = 0; channel < image.numChannels; ++channel)
+        {
+            for (size_t row = 0; row < cropHeight; ++row)
+            {
+                auto source = image.data.begin() + (channel * image.height + top + row) * image.width + left;
+                std::copy(source, source + cropWidth, result.data.begin() + (channel * cropHeight + row) * cropWidth);
+            }
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    Image<ValueType> ResizeImage(const Image<ValueType>& image, size_t width, size_t height)
+    {
+        if (width == 0 || height == 0 || image.width == 0 || image.height == 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Image sizes must be positive");
+        }
+
+        auto columns = GetInterpolation(image.width, width);
+        auto rows = GetInterpolation(image.height, height);
+        Image<ValueType> result{ width, height, image.numChannels, std::vector<ValueType>(width * height * image.numChannels) };
+        auto output = result.data.begin();
+        for (size_t channel = 0; channel < image.numChannels; ++channel)
+        {
+            auto plane = image.data.data() + channel * image.width * image.height;
+            for (const auto& row : rows)
+            {
+                auto row0 = plane + row.index0 * image.width;
+                auto row1 = plane + row.index1 * image.width;
+                for (const auto& column : columns)
+                {
+                    auto top = row0[column.index0] + column.weight1 * (row0[column.index1] - static_cast<double>(row0[column.index0]));
+                    auto bottom = row1[column.index0] + column.weight1 * (row1[column.index1] - static_cast<double>(row1[column.index0]));
+                    *output++ = GetValue<ValueType>(top + row.weight1 * (bottom - top));
+                }
+            }
+        }
+        return result;
+    }
+
+    template Image<int> CenterCropImage(const Image<int>& image, size_t width, size_t height);
+    template Image<float> CenterCropImage(const Image<float>& image, size_t width, size_t height);
+    template Image<double> CenterCropImage(const Image<double>& image, size_t width, size_t height);
+
+    template Image<int> ResizeImage(const Image<int>& image, size_t width, size_t height);
+    template Image<float> ResizeImage(const Image<float>& image, size_t width, size_t height);
+    template Image<double> ResizeImage(const Image<double>& image, size_t width, size_t height);
+} // namespace utilities
+} // namespace ell
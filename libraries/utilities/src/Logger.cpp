@@ -7,9 +7,19 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Logger.h"
+#include "Files.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ell
 {
@@ -17,6 +27,182 @@ namespace utilities
 {
     namespace logging
     {
+        namespace
+        {
+            const size_t traceBufferSize = 1 << 14; // records per thread, a power of 2
+            const auto traceFlushInterval = std::chrono::milliseconds(10);
+
+            struct TraceRecord
+            {
+                int64_t timestamp; // steady clock nanoseconds
+                uint64_t payload;
+                uint32_t eventId;
+                TracePhase phase;
+            };
+
+            struct CollectedTraceRecord
+            {
+                TraceRecord record;
+                size_t threadIndex;
+            };
+
+            // A single-producer single-consumer ring buffer. The owning thread writes the records, and
+            // the consumer (the flusher thread or a reader holding the trace state lock) drains them.
+            class TraceBuffer
+            {
+            public:
+                TraceBuffer(size_t threadIndex) :
+                    _records(traceBufferSize),
+                    _threadIndex(threadIndex) {}
+
+                bool TryPush(const TraceRecord& record)
+                {
+                    auto head = _head.load(std::memory_order_relaxed);
+                    if (head - _tail.load(std::memory_order_acquire) == traceBufferSize)
+                    {
+                        return false;
+                    }
+                    _records[head & (traceBufferSize - 1)] = record;
+                    _head.store(head + 1, std::memory_order_release);
+                    return true;
+                }
+
+                template <typename FunctionType>
+                void Drain(FunctionType&& function)
+                {
+                    auto tail = _tail.load(std::memory_order_relaxed);
+                    auto head = _head.load(std::memory_order_acquire);
+                    for (; tail != head; ++tail)
+                    {
+                        function(_records[tail & (traceBufferSize - 1)], _threadIndex);
+                    }
+                    _tail.store(tail, std::memory_order_release);
+                }
+
+            private:
+                std::vector<TraceRecord> _records;
+                size_t _threadIndex;
+                std::atomic<size_t> _head{ 0 };
+                std::atomic<size_t> _tail{ 0 };
+            };
+
+            struct TraceState
+            {
+                ~TraceState()
+                {
+                    // tracing may still be on when the program exits
+                    if (flusher.joinable())
+                    {
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            stopFlusher = true;
+                        }
+                        flusherCondition.notify_all();
+                        flusher.join();
+                    }
+                }
+
+                std::atomic<bool> isTracing{ false };
+                std::atomic<size_t> numDropped{ 0 };
+
+                // guards everything below
+                std::mutex mutex;
+                std::condition_variable flusherCondition;
+                std::thread flusher;
+                bool stopFlusher = false;
+                int64_t startTime = 0;
+                std::vector<std::shared_ptr<TraceBuffer>> buffers;
+                std::vector<std::string> eventNames;
+                std::vector<CollectedTraceRecord> records;
+            };
+
+            TraceState& GetTraceState()
+            {
+                static TraceState state;
+                return state;
+            }
+
+            int64_t GetTraceTimestamp()
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            TraceBuffer& GetThreadTraceBuffer()
+            {
+                // the registry shares ownership, so records written by a thread outlive it
+                thread_local std::shared_ptr<TraceBuffer> buffer;
+                if (!buffer)
+                {
+                    auto& state = GetTraceState();
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    buffer = std::make_shared<TraceBuffer>(state.buffers.size());
+                    state.buffers.push_back(buffer);
+                }
+                return *buffer;
+            }
+
+            // Requires the trace state lock
+            void DrainTraceBuffers(TraceState& state)
+            {
+                for (auto& buffer : state.buffers)
+                {
+                    buffer->Drain([&state](const TraceRecord& record, size_t threadIndex) {
+                        state.records.push_back({ record, threadIndex });
+                    });
+                }
+            }
+
+            void RunTraceFlusher()
+            {
+                auto& state = GetTraceState();
+                std::unique_lock<std::mutex> lock(state.mutex);
+                while (!state.stopFlusher)
+                {
+                    state.flusherCondition.wait_for(lock, traceFlushInterval);
+                    DrainTraceBuffers(state);
+                }
+            }
+
+            void WriteJsonString(std::ostream& stream, const std::string& value)
+            {
+                stream << '"';
+                for (auto ch : value)
+                {
+                    switch (ch)
+                    {
+                    case '"':
+                        stream << "\\\"";
+                        break;
+                    case '\\':
+                        stream << "\\\\";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(ch) < 0x20)
+                        {
+                            stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(ch) << std::dec << std::setfill(' ');
+                        }
+                        else
+                        {
+                            stream << ch;
+                        }
+                    }
+                }
+                stream << '"';
+            }
+
+            const char* GetChromeTracePhase(TracePhase phase)
+            {
+                switch (phase)
+                {
+                case TracePhase::begin:
+                    return "B";
+                case TracePhase::end:
+                    return "E";
+                default:
+                    return "i";
+                }
+            }
+        } // namespace
 
         bool& ShouldFlush()
         {
@@ -55,6 +241,171 @@ namespace utilities
             }
         }
 
+        void StartTracing()
+        {
+            auto& state = GetTraceState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (state.isTracing)
+            {
+                return;
+            }
+
+            // discard whatever was left over from a previous session
+            DrainTraceBuffers(state);
+            state.records.clear();
+            state.numDropped = 0;
+            state.startTime = GetTraceTimestamp();
+            state.stopFlusher = false;
+            state.flusher = std::thread(RunTraceFlusher);
+            state.isTracing = true;
+        }
+
+        void StopTracing()
+        {
+            auto& state = GetTraceState();
+            std::thread flusher;
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (!state.isTracing)
+                {
+                    return;
+                }
+
+                state.isTracing = false;
+                state.stopFlusher = true;
+                flusher = std::move(state.flusher);
+            }
+            state.flusherCondition.notify_all();
+            flusher.join();
+
+            std::lock_guard<std::mutex> lock(state.mutex);
+            DrainTraceBuffers(state);
+        }
+
+        bool IsTracing()
+        {
+            return GetTraceState().isTracing.load(std::memory_order_relaxed);
+        }
+
+        uint32_t RegisterTraceEvent(const std::string& name)
+        {
+            auto& state = GetTraceState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            auto it = std::find(state.eventNames.begin(), state.eventNames.end(), name);
+            if (it != state.eventNames.end())
+            {
+                return static_cast<uint32_t>(it - state.eventNames.begin());
+            }
+            state.eventNames.push_back(name);
+            return static_cast<uint32_t>(state.eventNames.size() - 1);
+        }
+
+        void TraceEvent(uint32_t eventId, TracePhase phase, uint64_t payload)
+        {
+            if (!IsTracing())
+            {
+                return;
+            }
+
+            if (!GetThreadTraceBuffer().TryPush({ GetTraceTimestamp(), payload, eventId, phase }))
+            {
+                GetTraceState().numDropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        size_t GetNumDroppedTraceEvents()
+        {
+            return GetTraceState().numDropped;
+        }
+
+        void WriteChromeTrace(std::ostream& stream)
+        {
+            auto& state = GetTraceState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            DrainTraceBuffers(state);
+
+            // the records of each thread are already in order, so a stable sort keeps nested spans intact
+            auto records = state.records;
+            std::stable_sort(records.begin(), records.end(), [](const CollectedTraceRecord& a, const CollectedTraceRecord& b) {
+                return a.record.timestamp < b.record.timestamp;
+            });
+
+            stream << "{\"traceEvents\":[";
+            bool isFirst = true;
+            for (const auto& entry : records)
+            {
+                const auto& record = entry.record;
+                if (record.eventId >= state.eventNames.size())
+                {
+                    continue;
+                }
+                stream << (isFirst ? "\n" : ",\n");
+                isFirst = false;
+
+                stream << "{\"name\":";
+                WriteJsonString(stream, state.eventNames[record.eventId]);
+                stream << ",\"ph\":\"" << GetChromeTracePhase(record.phase) << "\"";
+                if (record.phase == TracePhase::instant)
+                {
+                    stream << ",\"s\":\"t\"";
+                }
+                auto microseconds = static_cast<double>(record.timestamp - state.startTime) / 1000.0;
+                stream << ",\"ts\":" << std::fixed << std::setprecision(3) << microseconds << std::defaultfloat;
+                stream << ",\"pid\":0,\"tid\":" << entry.threadIndex;
+                stream << ",\"args\":{\"payload\":" << record.payload << "}}";
+            }
+            stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        }
+
+        TraceSpan::TraceSpan(uint32_t eventId, uint64_t payload) :
+            _eventId(eventId),
+            _isTracing(IsTracing())
+        {
+            if (_isTracing)
+            {
+                TraceEvent(_eventId, TracePhase::begin, payload);
+            }
+        }
+
+        TraceSpan::~TraceSpan()
+        {
+            // a span that began while tracing always ends, so the exported spans stay balanced
+            if (_isTracing)
+            {
+                if (!GetThreadTraceBuffer().TryPush({ GetTraceTimestamp(), 0, _eventId, TracePhase::end }))
+                {
+                    GetTraceState().numDropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        TraceFile::TraceFile(const std::string& filename) :
+            _filename(filename)
+        {
+            if (!_filename.empty())
+            {
+                StartTracing();
+            }
+        }
+
+        TraceFile::~TraceFile()
+        {
+            if (_filename.empty())
+            {
+                return;
+            }
+
+            StopTracing();
+            try
+            {
+                auto stream = OpenOfstream(_filename);
+                WriteChromeTrace(stream);
+            }
+            catch (...)
+            {
+                std::cerr << "Failed to write trace file " << _filename << std::endl;
+            }
+        }
     } // namespace logging
 } // namespace utilities
 } // namespace ell
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryMappedFile.h"
+#include "Exception.h"
+
+#include <utility>
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#include <windows.h>
+namespace fs = std::filesystem;
+#endif // WIN32
+
+namespace ell
+{
+namespace utilities
+{
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+#ifdef WIN32
+        auto file = CreateFileW(fs::u8path(filepath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            throw utilities::SystemException(SystemExceptionErrors::fileNotFound, "error getting the size of file " + filepath);
+        }
+        _size = static_cast<size_t>(size.QuadPart);
+        if (_size > 0)
+        {
+            // A copy-on-write view, so writes stay private to the process
+            auto mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            if (mapping != nullptr)
+            {
+                _data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        auto file = open(filepath.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+
+        struct stat fileInfo;
+        if (fstat(file, &fileInfo) != 0)
+        {
+            close(file);
+            throw utilities::SystemException(SystemExceptionErrors::fileNotFound, "error getting the size of file " + filepath);
+        }
+        _size = static_cast<size_t>(fileInfo.st_size);
+        if (_size > 0)
+        {
+            // A private mapping, so writes stay private to the process
+            _data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            if (_data == MAP_FAILED)
+            {
+                _data = nullptr;
+            }
+        }
+        close(file);
+#endif // WIN32
+
+        if (_size > 0 && _data == nullptr)
+        {
+            throw utilities::SystemException(SystemExceptionErrors::fileNotFound, "error mapping file " + filepath + " into memory");
+        }
+    }
+
+    MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) :
+        _data(std::exchange(other._data, nullptr)),
+        _size(std::exchange(other._size, 0))
+    {
+    }
+
+    MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other)
+    {
+        if (this != &other)
+        {
+            Unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+        }
+        return *this;
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Unmap();
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+        if (_data != nullptr)
+        {
+#ifdef WIN32
+            UnmapViewOfFile(_data);
+#else
+            munmap(_data, _size);
+#endif // WIN32
+            _data = nullptr;
+        }
+        _size = 0;
+    }
+} // namespace utilities
+} // namespace ell
@@ -11,6 +11,8 @@
 #include "Files.h"
 
 #include <istream>
+#include <limits>
+#include <type_traits>
 
 namespace ell
 {
@@ -20,41 +22,105 @@ namespace utilities
     // PPM format
     //
     //
-    // P3  # channels
+    // P3  # format: P2 and P5 are grayscale, P3 and P6 are RGB; P2 and P3 store the values as text, P5 and P6 in binary
     // 28 28  # width, height
     // 65535  # max value
     // 38371 42017 29740 35984 43756 24554 32129 38649 21556 31277 37201 23208  # pixel values
     // ...
+    //
+    // In the binary formats, the max value is followed by a single whitespace character and the values, which are
+    // 1 byte each if the max value is less than 256, and 2 bytes (most significant first) otherwise.
+
+    namespace
+    {
+        // Reads a number from the header, skipping whitespace and comments
+        size_t ReadHeaderValue(std::istream& in)
+        {
+            while ((in >> std::ws).peek() == '#')
+            {
+                in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            }
+
+            size_t value = 0;
+            if (!(in >> value))
+            {
+                throw DataFormatException(DataFormatErrors::badFormat, "PPM header is truncated");
+            }
+            return value;
+        }
+
+        int ReadBinaryValue(std::istream& in, bool isWide)
+        {
+            auto value = in.get();
+            if (isWide)
+            {
+                value = (value << 8) | in.get();
+            }
+            return value;
+        }
+
+        template <typename ValueType>
+        ValueType GetValue(int rawValue, int maxValue)
+        {
+            if constexpr (std::is_floating_point_v<ValueType>)
+            {
+                return static_cast<ValueType>(rawValue) / static_cast<ValueType>(maxValue);
+            }
+            else
+            {
+                return static_cast<ValueType>(rawValue);
+            }
+        }
+    } // namespace
 
     template <typename ValueType>
     Image<ValueType> ParsePPMStream(std::istream& in)
     {
-        // TODO: throw if we read bad values or hit EOF too soon
         Image<ValueType> result;
-        char p;
-        in >> p;
-        if (p != 'P')
+        char p = 0;
+        char format = 0;
+        in >> p >> format;
+        if (p != 'P' || format < '2' || format > '6' || format == '4')
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Not a PGM or PPM image");
+        }
+        bool isBinary = format >= '5';
+        result.numChannels = (format == '2' || format == '5') ? 1 : 3;
+        result.width = ReadHeaderValue(in);
+        result.height = ReadHeaderValue(in);
+        int maxValue = static_cast<int>(ReadHeaderValue(in));
+        if (maxValue == 0 || maxValue > 65535)
+        {
+            throw DataFormatException(DataFormatErrors::illegalValue, "PPM max value must be between 1 and 65535");
+        }
+        if (isBinary)
         {
-            throw 0;
+            in.get(); // the whitespace character after the max value
         }
-        in >> result.numChannels;
-        in >> result.width;
-        in >> result.height;
-        int maxValue = 0;
-        in >> maxValue;
+
         auto numValues = result.numChannels * result.width * result.height;
         result.data = std::vector<ValueType>(numValues);
         auto numPixels = result.width * result.height;
         for (size_t index = 0; index < numValues; ++index)
         {
-            int rawValue;
-            in >> rawValue;
-            ValueType value = rawValue / static_cast<ValueType>(maxValue);
+            int rawValue = 0;
+            if (isBinary)
+            {
+                rawValue = ReadBinaryValue(in, maxValue > 255);
+            }
+            else
+            {
+                in >> rawValue;
+            }
+            if (!in)
+            {
+                throw DataFormatException(DataFormatErrors::badFormat, "PPM image data is truncated");
+            }
 
             // convert from rgbrgbrgbrgbrgbrgb to rrrrggggbbbb
             int channel = static_cast<int>(index % result.numChannels);
             int outIndex = static_cast<int>(numPixels * channel + index / result.numChannels);
-            result.data[outIndex] = value;
+            result.data[outIndex] = GetValue<ValueType>(rawValue, maxValue);
         }
         return result;
     }
@@ -62,7 +128,7 @@ namespace utilities
     template <typename ValueType>
     Image<ValueType> ParsePPMFile(const std::string& filename)
     {
-        auto inStream = OpenIfstream(filename);
+        auto inStream = OpenBinaryIfstream(filename);
         return ParsePPMStream<ValueType>(inStream);
     }
 
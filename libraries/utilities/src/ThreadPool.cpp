@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace ell
+{
+namespace utilities
+{
+    namespace
+    {
+        // The pool and queue the current thread belongs to, if it's a pool thread
+        thread_local const ThreadPool* currentPool = nullptr;
+        thread_local size_t currentQueue = 0;
+    } // namespace
+
+    ThreadPool::ThreadPool(size_t numThreads, size_t maxQueuedTasks) :
+        _maxQueuedTasks(maxQueuedTasks)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        for (size_t index = 0; index < numThreads; ++index)
+        {
+            _queues.push_back(std::make_unique<TaskQueue>());
+        }
+        for (size_t index = 0; index < numThreads; ++index)
+        {
+            _threads.emplace_back(&ThreadPool::RunThread, this, index);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_wakeMutex);
+            _isStopping = true;
+        }
+        _wakeCondition.notify_all();
+
+        for (auto& thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    bool ThreadPool::RunPendingTask()
+    {
+        Task task;
+        if (!TryGetTask(task))
+        {
+            return false;
+        }
+
+        task();
+        return true;
+    }
+
+    void ThreadPool::Submit(Task task)
+    {
+        if (_numQueuedTasks.fetch_add(1) >= _maxQueuedTasks)
+        {
+            // The pool is full, so the adding thread does the work itself
+            --_numQueuedTasks;
+            task();
+            return;
+        }
+
+        // Pool threads queue their own tasks, other threads spread theirs over the queues
+        auto queueIndex = currentPool == this ? currentQueue : _nextQueue++ % _queues.size();
+        {
+            std::lock_guard<std::mutex> lock(_queues[queueIndex]->mutex);
+            _queues[queueIndex]->tasks.push_back(std::move(task));
+        }
+
+        // Taking the lock makes sure a thread about to wait sees the new task
+        {
+            std::lock_guard<std::mutex> lock(_wakeMutex);
+        }
+        _wakeCondition.notify_one();
+    }
+
+    bool ThreadPool::TryGetTask(Task& task)
+    {
+        // A pool thread takes its newest task first, and steals the oldest tasks of the other queues
+        auto numQueues = _queues.size();
+        auto firstQueue = currentPool == this ? currentQueue : 0;
+        for (size_t offset = 0; offset < numQueues; ++offset)
+        {
+            auto& queue = *_queues[(firstQueue + offset) % numQueues];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+            {
+                continue;
+            }
+
+            if (offset == 0 && currentPool == this)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            --_numQueuedTasks;
+            return true;
+        }
+        return false;
+    }
+
+    void ThreadPool::RunThread(size_t queueIndex)
+    {
+        currentPool = this;
+        currentQueue = queueIndex;
+        while (true)
+        {
+            if (RunPendingTask())
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_wakeMutex);
+            if (_isStopping && _numQueuedTasks == 0)
+            {
+                return;
+            }
+            _wakeCondition.wait(lock, [this] { return _isStopping || _numQueuedTasks > 0; });
+        }
+    }
+
+    ThreadPool& GetHostThreadPool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+} // namespace utilities
+} // namespace ell
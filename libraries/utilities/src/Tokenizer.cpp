@@ -10,6 +10,7 @@
 #include "Exception.h"
 #include "Files.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <istream>
@@ -40,7 +41,7 @@ namespace utilities
     {
         if (!_peekedTokens.empty())
         {
-            auto temp = _peekedTokens.top();
+            auto temp = std::move(_peekedTokens.top());
             _peekedTokens.pop();
             return temp;
         }
@@ -147,7 +148,7 @@ namespace utilities
 
     void Tokenizer::PutBackToken(std::string token)
     {
-        _peekedTokens.push(token);
+        _peekedTokens.push(std::move(token));
     }
 
     void Tokenizer::PrintTokens(std::ostream& os)
@@ -161,18 +162,23 @@ namespace utilities
         }
     }
 
-    bool Tokenizer::TryMatchToken(std::string token)
+    bool Tokenizer::TryMatchToken(const std::string& token)
     {
-        auto nextToken = PeekNextToken();
-        if (nextToken != token)
+        // compare against the peeked token in place, rather than copying it out and back
+        if (_peekedTokens.empty())
+        {
+            _peekedTokens.push(ReadNextToken());
+        }
+
+        if (_peekedTokens.top() != token)
         {
             return false;
         }
-        ReadNextToken();
+        _peekedTokens.pop();
         return true;
     }
 
-    bool Tokenizer::TryMatchToken(std::string token, std::string& readToken)
+    bool Tokenizer::TryMatchToken(const std::string& token, std::string& readToken)
     {
         readToken = PeekNextToken();
         if (readToken != token)
@@ -183,7 +189,7 @@ namespace utilities
         return true;
     }
 
-    void Tokenizer::MatchToken(std::string token)
+    void Tokenizer::MatchToken(const std::string& token)
     {
         std::string readToken;
         if (!TryMatchToken(token, readToken))
@@ -247,12 +253,54 @@ namespace utilities
         auto newPtr = _textBuffer.data() + oldLength;
         auto maxLength = _textBuffer.size() - oldLength;
 
-        // read into buffer
-        _in.read(newPtr, maxLength);
+        // read into buffer, leaving room for a terminating null so numbers can be parsed in place
+        _in.read(newPtr, maxLength - 1);
         auto amountRead = _in.gcount();
         _bufferEnd = _textBuffer.begin() + oldLength + amountRead;
+        *_bufferEnd = '\0';
         _tokenStart = _textBuffer.begin();
         _currentPosition = _tokenStart + oldOffset;
     }
+
+    int Tokenizer::SkipWhitespace()
+    {
+        while (true)
+        {
+            _tokenStart = _currentPosition;
+            auto result = GetNextCharacter();
+            if (result == EOF)
+            {
+                return EOF;
+            }
+            if (!std::isspace(static_cast<unsigned char>(result)))
+            {
+                UngetCharacter();
+                _tokenStart = _currentPosition;
+                return result;
+            }
+        }
+    }
+
+    const char* Tokenizer::GetBufferedText(size_t minLength)
+    {
+        if (static_cast<size_t>(_bufferEnd - _currentPosition) < minLength && _in)
+        {
+            _tokenStart = _currentPosition;
+            ReadData();
+        }
+        return _textBuffer.data() + (_currentPosition - _textBuffer.begin());
+    }
+
+    void Tokenizer::ConsumeBufferedText(const char* position)
+    {
+        _currentPosition += position - GetBufferedText(0);
+        _tokenStart = _currentPosition;
+    }
+
+    size_t Tokenizer::CountBufferedCharacters(char ch, char endChar) const
+    {
+        auto end = std::find(_currentPosition, _bufferEnd, endChar);
+        return static_cast<size_t>(std::count(_currentPosition, end, ch));
+    }
 } // namespace utilities
 } // namespace ell
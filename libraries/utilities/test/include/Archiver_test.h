@@ -18,4 +18,7 @@ void TestJsonUnarchiver();
 
 void TestXmlArchiver();
 void TestXmlUnarchiver();
+
+void TestBinaryArchiver();
+void TestBinaryUnarchiver();
 } // namespace ell
@@ -0,0 +1,16 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Logger_test.h (utilities)
+//  Authors:  Kern Handa
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+namespace ell
+{
+void TestTraceSpans();
+void TestTraceThreads();
+void TestTraceDisabled();
+} // namespace ell
@@ -0,0 +1,18 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool_test.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+namespace ell
+{
+void TestThreadPoolTasks();
+void TestThreadPoolNestedTasks();
+void TestThreadPoolFullQueue();
+void TestThreadPoolException();
+void TestLockFreeQueue();
+} // namespace ell
@@ -11,4 +11,5 @@
 namespace ell
 {
 void TypeFactoryTest();
+void GenericTypeFactorySharedTypesTest();
 }
@@ -9,6 +9,7 @@
 #include "Archiver_test.h"
 
 #include <utilities/include/Archiver.h>
+#include <utilities/include/BinaryArchiver.h>
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/JsonArchiver.h>
 #include <utilities/include/UniqueId.h>
@@ -359,6 +360,35 @@ void TestJsonArchiver()
 void TestJsonUnarchiver()
 {
     TestUnarchiver<utilities::JsonArchiver, utilities::JsonUnarchiver>();
+
+    // arrays larger than the tokenizer's buffer are parsed across buffer refills
+    utilities::SerializationContext context;
+    std::vector<double> doubleVector(200000);
+    std::vector<float> floatVector(doubleVector.size());
+    for (size_t index = 0; index < doubleVector.size(); ++index)
+    {
+        doubleVector[index] = 0.25 * index - 1000.0;
+        floatVector[index] = static_cast<float>(doubleVector[index]);
+    }
+    std::stringstream strstream;
+    {
+        utilities::JsonArchiver archiver(strstream);
+        archiver["doubles"] << doubleVector;
+        archiver["empty"] << std::vector<double>{};
+        archiver["floats"] << floatVector;
+        archiver["x"] << 0.25;
+    }
+
+    utilities::JsonUnarchiver unarchiver(strstream, context);
+    std::vector<double> doubleVectorRead;
+    std::vector<double> emptyVectorRead;
+    std::vector<float> floatVectorRead;
+    double x = 0;
+    unarchiver["doubles"] >> doubleVectorRead;
+    unarchiver["empty"] >> emptyVectorRead;
+    unarchiver["floats"] >> floatVectorRead;
+    unarchiver["x"] >> x;
+    testing::ProcessTest("Deserialize large arrays check", doubleVectorRead == doubleVector && emptyVectorRead.empty() && floatVectorRead == floatVector && x == 0.25);
 }
 
 void TestXmlArchiver()
@@ -370,4 +400,42 @@ void TestXmlUnarchiver()
 {
     TestUnarchiver<utilities::XmlArchiver, utilities::XmlUnarchiver>();
 }
+
+void TestBinaryArchiver()
+{
+    TestArchiver<utilities::BinaryArchiver>();
+}
+
+void TestBinaryUnarchiver()
+{
+    TestUnarchiver<utilities::BinaryArchiver, utilities::BinaryUnarchiver>();
+
+    utilities::SerializationContext context;
+    std::vector<float> floatVector(1000);
+    for (size_t index = 0; index < floatVector.size(); ++index)
+    {
+        floatVector[index] = 0.5f * index;
+    }
+    const std::unique_ptr<int> nullPointer;
+    std::stringstream strstream;
+    {
+        utilities::BinaryArchiver archiver(strstream);
+        archiver["n"] << static_cast<int64_t>(3);
+        archiver["floats"] << floatVector;
+        archiver["x"] << nullPointer;
+    }
+
+    // read the archive in place, and read the values as other types than they were written as
+    auto archive = strstream.str();
+    testing::ProcessTest("Binary archive header", utilities::BinaryArchiveFormat::HasHeader(archive.data(), archive.size()));
+    utilities::BinaryUnarchiver unarchiver(archive.data(), archive.size(), context);
+    int n = 0;
+    std::vector<double> doubleVector;
+    std::unique_ptr<int> x = std::make_unique<int>(1);
+    unarchiver["n"] >> n;
+    unarchiver["floats"] >> doubleVector;
+    unarchiver["x"] >> x;
+    testing::ProcessTest("Binary unarchiver converts values", n == 3 && doubleVector.size() == floatVector.size() && doubleVector.back() == floatVector.back());
+    testing::ProcessTest("Binary unarchiver reads null", x != nullptr && *x == 1);
+}
 } // namespace ell
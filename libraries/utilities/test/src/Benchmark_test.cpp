@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Benchmark_test.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark_test.h"
+
+#include <utilities/include/Benchmark.h>
+
+#include <testing/include/testing.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+void TestBenchmarkStatistics()
+{
+    std::vector<double> samples;
+    for (int index = 100; index >= 0; --index)
+    {
+        samples.push_back(index);
+    }
+
+    auto statistics = utilities::GetBenchmarkStatistics(samples);
+    bool passed = statistics.numSamples == 101;
+    passed = passed && testing::IsEqual(statistics.min, 0.0) && testing::IsEqual(statistics.max, 100.0);
+    passed = passed && testing::IsEqual(statistics.median, 50.0) && testing::IsEqual(statistics.mean, 50.0);
+    passed = passed && testing::IsEqual(statistics.p90, 90.0) && testing::IsEqual(statistics.p99, 99.0);
+
+    // percentiles are interpolated between samples
+    auto interpolated = utilities::GetBenchmarkStatistics({ 1.0, 2.0 });
+    passed = passed && testing::IsEqual(interpolated.median, 1.5) && testing::IsEqual(interpolated.standardDeviation, 0.5);
+
+    auto empty = utilities::GetBenchmarkStatistics({});
+    passed = passed && empty.numSamples == 0 && empty.median == 0;
+    testing::ProcessTest("Benchmark statistics", passed);
+}
+
+void TestRunBenchmark()
+{
+    utilities::BenchmarkOptions options;
+    options.numWarmupIterations = 3;
+    options.minSamples = 5;
+    options.maxSamples = 20;
+    options.minTimeSeconds = 0;
+    options.minSampleTimeSeconds = 1e-6;
+
+    size_t numCalls = 0;
+    volatile double sum = 0;
+    auto function = [&] {
+        ++numCalls;
+        for (int index = 0; index < 100; ++index)
+        {
+            sum = sum + index;
+        }
+    };
+    auto result = utilities::RunBenchmark("loop", function, options);
+
+    bool passed = result.name == "loop" && result.statistics.numSamples == 5 && result.callsPerSample >= 1;
+    passed = passed && numCalls >= options.numWarmupIterations + 5 * result.callsPerSample;
+    passed = passed && result.statistics.min <= result.statistics.median && result.statistics.median <= result.statistics.p99 && result.statistics.p99 <= result.statistics.max;
+    passed = passed && result.timerOverhead >= 0;
+    testing::ProcessTest("Run benchmark", passed);
+}
+
+void TestBenchmarkSuite()
+{
+    utilities::BenchmarkSuite suite;
+    std::vector<std::string> setUp;
+    for (auto name : { "math/dot", "math/gemm", "nodes/sum" })
+    {
+        suite.Add(name, [&setUp, name] {
+            setUp.push_back(name);
+            return [] {};
+        });
+    }
+
+    utilities::BenchmarkOptions options;
+    options.numWarmupIterations = 0;
+    options.minSamples = 2;
+    options.maxSamples = 2;
+    options.minSampleTimeSeconds = 0;
+    auto results = suite.Run(options, "math/");
+
+    // only the benchmarks that match the filter are set up
+    bool passed = suite.GetNames().size() == 3 && results.size() == 2 && setUp.size() == 2;
+    passed = passed && results[0].name == "math/dot" && results[1].name == "math/gemm" && results[1].statistics.numSamples == 2;
+
+    std::stringstream json;
+    utilities::WriteBenchmarkResultsJson(json, results, options, "1.2.3");
+    auto text = json.str();
+    passed = passed && text.find("\"version\": \"1.2.3\"") != std::string::npos;
+    passed = passed && text.find("\"name\": \"math/gemm\"") != std::string::npos;
+    passed = passed && text.find("\"median\": ") != std::string::npos && text.find("\"p99\": ") != std::string::npos;
+    testing::ProcessTest("Benchmark suite", passed);
+}
+} // namespace ell
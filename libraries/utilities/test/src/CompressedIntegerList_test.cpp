@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompressedIntegerList_test.cpp (utilities)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CompressedIntegerList_test.h"
+
+#include <testing/include/testing.h>
+
+#include <utilities/include/CompressedIntegerList.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace
+{
+    // runs of small deltas, separated by deltas that need 2, 4 and 8 bytes
+    std::vector<size_t> GetTestValues()
+    {
+        std::vector<size_t> values;
+        size_t value = 0;
+        const std::vector<size_t> largeDeltas = { 100, 20000, 3000000000, 1000 };
+        for (auto largeDelta : largeDeltas)
+        {
+            for (size_t i = 0; i < 19; ++i)
+            {
+                values.push_back(value);
+                value += 1 + i % 5;
+            }
+            values.push_back(value);
+            value += largeDelta;
+        }
+        return values;
+    }
+
+    utilities::CompressedIntegerList GetList(const std::vector<size_t>& values)
+    {
+        utilities::CompressedIntegerList list;
+        for (auto value : values)
+        {
+            list.Append(value);
+        }
+        return list;
+    }
+} // namespace
+
+void TestCompressedIntegerListIterator()
+{
+    auto values = GetTestValues();
+    auto list = GetList(values);
+
+    std::vector<size_t> result;
+    for (auto iterator = list.GetIterator(); iterator.IsValid(); iterator.Next())
+    {
+        result.push_back(iterator.Get());
+    }
+
+    testing::ProcessTest("CompressedIntegerList::Iterator", testing::IsEqual(list.Size(), values.size()) && testing::IsEqual(list.Max(), values.back()) && result == values);
+}
+
+void TestCompressedIntegerListRead()
+{
+    auto values = GetTestValues();
+    auto list = GetList(values);
+
+    // block sizes that are shorter and longer than a run of small deltas
+    bool ok = true;
+    for (size_t blockSize : { 1, 3, 8, 9, 64, 1000 })
+    {
+        std::vector<size_t> result;
+        std::vector<size_t> block(blockSize);
+        auto iterator = list.GetIterator();
+        while (auto count = iterator.Read(block.data(), blockSize))
+        {
+            ok &= count <= blockSize;
+            result.insert(result.end(), block.begin(), block.begin() + count);
+        }
+        ok &= result == values;
+    }
+
+    // reading continues where Next left off
+    auto iterator = list.GetIterator();
+    iterator.Next();
+    size_t block[4];
+    ok &= testing::IsEqual(iterator.Read(block, 4), size_t{ 4 }) && block[0] == values[1] && block[3] == values[4];
+    ok &= testing::IsEqual(iterator.Get(), values[5]);
+
+    utilities::CompressedIntegerList emptyList;
+    auto emptyIterator = emptyList.GetIterator();
+    ok &= testing::IsEqual(emptyIterator.Read(block, 4), size_t{ 0 });
+
+    testing::ProcessTest("CompressedIntegerList::Iterator::Read", ok);
+}
+} // namespace ell
@@ -10,6 +10,7 @@
 #include "Files_test.h"
 
 #include <utilities/include/Files.h>
+#include <utilities/include/MemoryMappedFile.h>
 #include <utilities/include/StringUtil.h>
 
 #include <testing/include/testing.h>
@@ -49,6 +50,28 @@ void TestJoinPaths(const std::string& basePath)
     testing::ProcessTest("JoinPaths", norm == result);
 }
 
+void TestMemoryMappedFile(const std::string& basePath)
+{
+    std::string testContent = "memory mapped test content";
+    std::string testfile = utilities::JoinPaths(basePath, "MemoryMappedFile_test.bin");
+    {
+        auto outputStream = utilities::OpenBinaryOfstream(testfile);
+        outputStream.write(testContent.data(), testContent.size());
+    }
+
+    utilities::MemoryMappedFile file(testfile);
+    bool ok = file.GetSize() == testContent.size() && std::memcmp(file.GetData(), testContent.data(), testContent.size()) == 0;
+    testing::ProcessTest("MemoryMappedFile contents", ok);
+
+    // Writes to the mapped memory don't change the file
+    static_cast<char*>(file.GetData())[0] = 'M';
+    utilities::MemoryMappedFile otherFile(testfile);
+    testing::ProcessTest("MemoryMappedFile private writes", static_cast<const char*>(otherFile.GetData())[0] == 'm');
+
+    utilities::MemoryMappedFile movedFile(std::move(file));
+    testing::ProcessTest("MemoryMappedFile move", file.GetData() == nullptr && movedFile.GetSize() == testContent.size() && static_cast<const char*>(movedFile.GetData())[0] == 'M');
+}
+
 std::string GetUnicodeTestPath(const std::string& basePath, const std::string& utf8test)
 {
     std::string testing = utilities::JoinPaths(basePath, "Testing");
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Image_test.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Image_test.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ImageTransforms.h>
+#include <utilities/include/PPMImageParser.h>
+
+#include <testing/include/testing.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+void TestParsePPMText()
+{
+    std::istringstream stream("P3\n# a comment\n2 1\n255\n255 0 0  0 0 255\n");
+    auto image = utilities::ParsePPMStream<int>(stream);
+    bool ok = image.width == 2 && image.height == 1 && image.numChannels == 3;
+    testing::ProcessTest("ParsePPMStream text header", ok);
+    testing::ProcessTest("ParsePPMStream text values are planar", image.data == std::vector<int>{ 255, 0, 0, 0, 0, 255 });
+
+    std::istringstream grayStream("P2 2 2 10 0 5 10 5");
+    auto grayImage = utilities::ParsePPMStream<float>(grayStream);
+    testing::ProcessTest("ParsePPMStream grayscale values are scaled", grayImage.numChannels == 1 && testing::IsEqual(grayImage.data, std::vector<float>{ 0.0f, 0.5f, 1.0f, 0.5f }));
+}
+
+void TestParsePPMBinary()
+{
+    std::string bytes = "P6\n2 1\n255\n";
+    bytes += std::string{ '\x01', '\x02', '\x03', '\xfd', '\xfe', '\xff' };
+    std::istringstream stream(bytes, std::ios::binary);
+    auto image = utilities::ParsePPMStream<int>(stream);
+    testing::ProcessTest("ParsePPMStream binary", image.width == 2 && image.data == std::vector<int>{ 1, 253, 2, 254, 3, 255 });
+
+    std::string wideBytes = "P5 1 2 65535\n";
+    wideBytes += std::string{ '\x01', '\x00', '\xff', '\xff' };
+    std::istringstream wideStream(wideBytes, std::ios::binary);
+    auto wideImage = utilities::ParsePPMStream<int>(wideStream);
+    testing::ProcessTest("ParsePPMStream 16-bit binary", wideImage.numChannels == 1 && wideImage.data == std::vector<int>{ 256, 65535 });
+
+    bool threw = false;
+    try
+    {
+        std::istringstream truncatedStream("P6 2 2 255\n\x01\x02", std::ios::binary);
+        utilities::ParsePPMStream<int>(truncatedStream);
+    }
+    catch (const utilities::DataFormatException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("ParsePPMStream truncated image throws", threw);
+}
+
+void TestCenterCropImage()
+{
+    // A 4x2 image with 2 channels
+    utilities::Image<int> image{ 4, 2, 2, { 0, 1, 2, 3, 4, 5, 6, 7, 10, 11, 12, 13, 14, 15, 16, 17 } };
+    auto cropped = utilities::CenterCropImage(image, 1, 1);
+    bool ok = cropped.width == 2 && cropped.height == 2 && cropped.numChannels == 2;
+    testing::ProcessTest("CenterCropImage size", ok);
+    testing::ProcessTest("CenterCropImage values", cropped.data == std::vector<int>{ 1, 2, 5, 6, 11, 12, 15, 16 });
+}
+
+void TestResizeImage()
+{
+    utilities::Image<double> image{ 2, 1, 1, { 0, 10 } };
+    auto resized = utilities::ResizeImage(image, 4, 1);
+    testing::ProcessTest("ResizeImage upsampling", testing::IsEqual(resized.data, std::vector<double>{ 0, 2.5, 7.5, 10 }));
+
+    utilities::Image<int> square{ 2, 2, 1, { 0, 10, 20, 30 } };
+    auto shrunk = utilities::ResizeImage(square, 1, 1);
+    testing::ProcessTest("ResizeImage downsampling", shrunk.data == std::vector<int>{ 15 });
+
+    auto same = utilities::ResizeImage(square, 2, 2);
+    testing::ProcessTest("ResizeImage to the same size", same.data == square.data);
+}
+} // namespace ell
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Logger_test.cpp (utilities)
+//  Authors:  Kern Handa
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Logger_test.h"
+
+#include <utilities/include/Logger.h>
+
+#include <testing/include/testing.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace
+{
+    size_t CountOccurrences(const std::string& text, const std::string& pattern)
+    {
+        size_t count = 0;
+        for (auto position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    std::string GetChromeTrace()
+    {
+        std::stringstream stream;
+        logging::WriteChromeTrace(stream);
+        return stream.str();
+    }
+} // namespace
+
+void TestTraceSpans()
+{
+    auto outerEvent = logging::RegisterTraceEvent("outer \"span\"");
+    auto innerEvent = logging::RegisterTraceEvent("inner");
+    bool passed = logging::RegisterTraceEvent("inner") == innerEvent && outerEvent != innerEvent;
+
+    logging::StartTracing();
+    passed = passed && logging::IsTracing();
+    {
+        logging::TraceSpan outer(outerEvent, 7);
+        for (uint64_t index = 0; index < 3; ++index)
+        {
+            logging::TraceSpan inner(innerEvent, index);
+        }
+        logging::TraceEvent(innerEvent, logging::TracePhase::instant);
+    }
+    logging::StopTracing();
+    passed = passed && !logging::IsTracing();
+
+    auto trace = GetChromeTrace();
+    passed = passed && trace.find("{\"traceEvents\":[") == 0;
+    passed = passed && CountOccurrences(trace, "\"name\":\"outer \\\"span\\\"\"") == 2;
+    passed = passed && CountOccurrences(trace, "\"name\":\"inner\"") == 7;
+    passed = passed && CountOccurrences(trace, "\"ph\":\"B\"") == 4 && CountOccurrences(trace, "\"ph\":\"E\"") == 4;
+    passed = passed && CountOccurrences(trace, "\"ph\":\"i\"") == 1;
+    passed = passed && CountOccurrences(trace, "\"args\":{\"payload\":7}") == 1;
+
+    // the outer span begins first and ends last
+    passed = passed && trace.find("\"ph\":\"B\"") < trace.find("\"name\":\"inner\"");
+    passed = passed && trace.rfind("\"name\":\"outer") > trace.rfind("\"name\":\"inner\"");
+    passed = passed && logging::GetNumDroppedTraceEvents() == 0;
+    testing::ProcessTest("Trace spans", passed);
+}
+
+void TestTraceThreads()
+{
+    auto event = logging::RegisterTraceEvent("worker");
+    const size_t numThreads = 4;
+    const size_t numSpans = 10000; // more than fit in a ring buffer between flushes at worst
+    logging::StartTracing();
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back([event, numSpans] {
+            for (size_t index = 0; index < numSpans; ++index)
+            {
+                logging::TraceSpan span(event, index);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    logging::StopTracing();
+
+    // every record is either in the trace or counted as dropped
+    auto trace = GetChromeTrace();
+    auto numRecords = CountOccurrences(trace, "\"name\":\"worker\"");
+    bool passed = numRecords + logging::GetNumDroppedTraceEvents() == 2 * numThreads * numSpans;
+    passed = passed && CountOccurrences(trace, "\"ph\":\"B\"") > 0;
+    testing::ProcessTest("Trace from multiple threads", passed);
+}
+
+void TestTraceDisabled()
+{
+    auto event = logging::RegisterTraceEvent("untraced");
+    logging::StartTracing();
+    logging::StopTracing();
+    {
+        logging::TraceSpan span(event);
+        logging::TraceEvent(event, logging::TracePhase::instant);
+    }
+
+    // starting a new session discards the previous records
+    logging::StartTracing();
+    logging::StopTracing();
+    auto trace = GetChromeTrace();
+    testing::ProcessTest("Trace disabled", trace.find("\"untraced\"") == std::string::npos && trace.find("\"ph\"") == std::string::npos);
+}
+} // namespace ell
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool_test.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool_test.h"
+
+#include <utilities/include/LockFreeQueue.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <testing/include/testing.h>
+
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+void TestThreadPoolTasks()
+{
+    utilities::ThreadPool pool(3);
+    std::vector<std::future<int>> results;
+    for (int index = 0; index < 100; ++index)
+    {
+        results.push_back(pool.AddTask([](int value) { return value * value; }, index));
+    }
+
+    bool passed = pool.NumThreads() == 3;
+    for (int index = 0; index < 100; ++index)
+    {
+        passed = passed && pool.GetResult(results[index]) == index * index;
+    }
+    testing::ProcessTest("ThreadPool tasks", passed);
+}
+
+void TestThreadPoolNestedTasks()
+{
+    // Every task waits for tasks it adds itself, which needs the waiting threads to help out with a single thread
+    utilities::ThreadPool pool(1);
+    std::atomic<int> count{ 0 };
+    std::vector<std::future<void>> outerTasks;
+    for (int outer = 0; outer < 4; ++outer)
+    {
+        outerTasks.push_back(pool.AddTask([&pool, &count]() {
+            std::vector<std::future<void>> innerTasks;
+            for (int inner = 0; inner < 4; ++inner)
+            {
+                innerTasks.push_back(pool.AddTask([&count]() { ++count; }));
+            }
+            for (auto& task : innerTasks)
+            {
+                pool.GetResult(task);
+            }
+        }));
+    }
+    for (auto& task : outerTasks)
+    {
+        pool.GetResult(task);
+    }
+    testing::ProcessTest("ThreadPool nested tasks", count == 16);
+}
+
+void TestThreadPoolFullQueue()
+{
+    // Tasks added to a full pool run on the adding thread
+    utilities::ThreadPool pool(1, 2);
+    std::vector<std::future<int>> results;
+    for (int index = 0; index < 50; ++index)
+    {
+        results.push_back(pool.AddTask([index]() { return index; }));
+    }
+
+    std::vector<int> values;
+    for (auto& result : results)
+    {
+        values.push_back(pool.GetResult(result));
+    }
+    std::vector<int> expected(50);
+    std::iota(expected.begin(), expected.end(), 0);
+    testing::ProcessTest("ThreadPool full queue", values == expected);
+}
+
+void TestThreadPoolException()
+{
+    auto& pool = utilities::GetHostThreadPool();
+    auto result = pool.AddTask([]() -> int { throw std::runtime_error("task error"); });
+
+    bool caught = false;
+    try
+    {
+        pool.GetResult(result);
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+    testing::ProcessTest("ThreadPool task exception", caught);
+}
+
+void TestLockFreeQueue()
+{
+    utilities::LockFreeQueue<int> queue(3);
+    bool passed = queue.Capacity() == 3 && queue.IsEmpty();
+    passed = passed && queue.TryPush(1) && queue.TryPush(2) && queue.TryPush(3) && !queue.TryPush(4);
+
+    int value = 0;
+    passed = passed && queue.TryPop(value) && value == 1;
+
+    // A consumer thread should see every value in the order it was pushed
+    std::vector<int> values;
+    std::thread consumer([&queue, &values]() {
+        int next = 0;
+        while (values.size() < 1001)
+        {
+            if (queue.TryPop(next))
+            {
+                values.push_back(next);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (int index = 0; index < 999; ++index)
+    {
+        while (!queue.TryPush(index + 4))
+        {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+
+    std::vector<int> expected(1001);
+    std::iota(expected.begin(), expected.end(), 2);
+    testing::ProcessTest("LockFreeQueue", passed && values == expected && queue.IsEmpty());
+}
+} // namespace ell
@@ -92,4 +92,23 @@ void TypeFactoryTest()
 
     testing::ProcessTest("TypeFactory", derived1->GetRuntimeTypeName() == Derived1::GetTypeName() && derived2->GetRuntimeTypeName() == Derived2::GetTypeName());
 }
+
+void GenericTypeFactorySharedTypesTest()
+{
+    utilities::GenericTypeFactory sharedFactory;
+    sharedFactory.AddType<Base, Derived1>();
+    sharedFactory.AddType<Base, Derived2>();
+
+    // Types added to the factory itself are found before the shared ones
+    utilities::GenericTypeFactory factory;
+    factory.AddType<Base, Derived1>(Derived2::GetTypeName());
+    factory.AddTypes(sharedFactory);
+    factory.AddTypes(sharedFactory);
+
+    auto derived1 = factory.Construct<Base>(Derived1::GetTypeName());
+    auto renamed = factory.Construct<Base>(Derived2::GetTypeName());
+    auto derived2 = sharedFactory.Construct<Base>(Derived2::GetTypeName());
+
+    testing::ProcessTest("GenericTypeFactory shared types", derived1->GetRuntimeTypeName() == Derived1::GetTypeName() && renamed->GetRuntimeTypeName() == Derived1::GetTypeName() && derived2->GetRuntimeTypeName() == Derived2::GetTypeName());
+}
 } // namespace ell
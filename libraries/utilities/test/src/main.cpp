@@ -7,14 +7,19 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Archiver_test.h"
+#include "Benchmark_test.h"
+#include "CompressedIntegerList_test.h"
 #include "Files_test.h"
 #include "Format_test.h"
 #include "FunctionUtils_test.h"
 #include "Hash_test.h"
+#include "Image_test.h"
 #include "Iterator_test.h"
+#include "Logger_test.h"
 #include "MemoryLayout_test.h"
 #include "ObjectArchive_test.h"
 #include "PropertyBag_test.h"
+#include "ThreadPool_test.h"
 #include "TypeFactory_test.h"
 #include "TypeName_test.h"
 #include "Variant_test.h"
@@ -42,12 +47,27 @@ int main(int argc, char* argv[])
     {
         std::string basePath = ell::utilities::GetDirectoryPath(argv[0]);
 
+        // Benchmark tests
+        TestBenchmarkStatistics();
+        TestRunBenchmark();
+        TestBenchmarkSuite();
+
+        // CompressedIntegerList tests
+        TestCompressedIntegerListIterator();
+        TestCompressedIntegerListRead();
+
         // Format tests
         TestMatchFormat();
 
         // Hash tests
         Hash_test1();
 
+        // Image tests
+        TestParsePPMText();
+        TestParsePPMBinary();
+        TestCenterCropImage();
+        TestResizeImage();
+
         // Iterator tests
         TestIteratorAdapter();
         TestTransformIterator();
@@ -55,6 +75,18 @@ int main(int argc, char* argv[])
         TestStlStridedIterator();
         TestZipIterator();
 
+        // Logger tests
+        TestTraceSpans();
+        TestTraceThreads();
+        TestTraceDisabled();
+
+        // ThreadPool tests
+        TestThreadPoolTasks();
+        TestThreadPoolNestedTasks();
+        TestThreadPoolFullQueue();
+        TestThreadPoolException();
+        TestLockFreeQueue();
+
         // MemoryLayout tests
         TestDimensionOrder();
         TestMemoryLayoutCtors();
@@ -66,6 +98,7 @@ int main(int argc, char* argv[])
 
         // TypeFactory tests
         TypeFactoryTest();
+        GenericTypeFactorySharedTypesTest();
 
         // Variant tests
         TestScalarVariant();
@@ -88,6 +121,9 @@ int main(int argc, char* argv[])
         TestXmlArchiver();
         TestXmlUnarchiver();
 
+        TestBinaryArchiver();
+        TestBinaryUnarchiver();
+
         // ObjectArchive tests
         TestGetTypeDescription();
         TestGetObjectArchive();
@@ -107,6 +143,7 @@ int main(int argc, char* argv[])
         // File system tests
         TestStringf();
         TestJoinPaths(basePath);
+        TestMemoryMappedFile(basePath);
 #ifdef WIN32
         TestUnicodePaths(basePath);
 #endif
@@ -14,9 +14,12 @@
 
 #include <forward_list>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <stack>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 namespace ell
 {
@@ -34,12 +37,12 @@ namespace value
         const ConstantData& GetConstantData(Value value) const;
 
     private:
-        Value AllocateImpl(ValueType type, MemoryLayout layout) override;
+        Value AllocateImpl(ValueType type, MemoryLayout layout, size_t alignment) override;
 
         std::optional<Value> GetGlobalValue(GlobalAllocationScope scope, std::string name) override;
 
-        Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout) override;
-        Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout) override;
+        Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout, size_t alignment) override;
+        Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout, size_t alignment) override;
 
         detail::ValueTypeDescription GetTypeImpl(Emittable emittable) override;
 
@@ -49,6 +52,9 @@ namespace value
         Value StoreConstantDataImpl(ConstantData data) override;
 
         void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn) override;
+        void ForImpl(MemoryLayout layout, const LoopSchedule& schedule, std::function<void(std::vector<Scalar>)> fn) override;
+
+        void ParallelizeImpl(int numTasks, std::vector<Value> captured, std::function<void(Scalar, std::vector<Value>)> fn) override;
 
         void MoveDataImpl(Value& source, Value& destination) override;
 
@@ -85,6 +91,8 @@ namespace value
         using ConstantDataList = std::forward_list<ConstantData>;
         using Frame = std::pair<std::string, ConstantDataList>;
 
+        std::stack<Frame>& GetStack();
+        const std::stack<Frame>& GetStack() const;
         Frame& GetTopFrame();
         const Frame& GetTopFrame() const;
 
@@ -92,10 +100,29 @@ namespace value
         struct FunctionScope;
 
         std::stack<Frame> _stack;
+
+        // Tasks started by Parallelize run on their own threads, each with its own stack of frames. The mutex guards the
+        // task stacks and the state shared by all the threads: the globals and the defined functions.
+        std::unordered_map<std::thread::id, std::stack<Frame>> _taskStacks;
+        mutable std::mutex _mutex;
         std::map<std::string, std::pair<ConstantData, MemoryLayout>> _globals;
         std::unordered_map<FunctionDeclaration, DefinedFunction> _definedFunctions;
         std::string _moduleName;
     };
 
+    namespace detail
+    {
+        /// <summary> Fast path for whole-value elementwise operations. If the global context is a ComputeContext, applies
+        /// `destination = destination op source` to every element in one native loop, instead of one scalar at a time. </summary>
+        /// <param name="source"> A value with the same logical shape as `destination`, or a scalar applied to every element </param>
+        /// <returns> true if the operation was done, false if the global context isn't a ComputeContext </returns>
+        bool TryComputeElementwise(ValueBinaryOperation op, Value destination, Value source);
+
+        /// <summary> Fast path for sums. If the global context is a ComputeContext, adds the active elements of a value
+        /// to an initial value in one native loop. </summary>
+        /// <returns> The sum, or an empty optional if the global context isn't a ComputeContext or the types don't allow it </returns>
+        std::optional<Scalar> TryComputeAccumulate(Value value, Scalar initialValue);
+    } // namespace detail
+
 } // namespace value
 } // namespace ell
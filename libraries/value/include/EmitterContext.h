@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Emittable.h"
+#include "LoopSchedule.h"
 #include "Scalar.h"
 #include "Value.h"
 #include "ValueType.h"
@@ -93,21 +94,25 @@ namespace value
         /// <summary> Allocates data with the specified type and size </summary>
         /// <param name="type"> The type of the data to allocate </param>
         /// <param name="layout"> The memory layout of the allocation, in number of elements </param>
+        /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
         /// <returns> An instance of Value that contains a referece to the allocated memory </returns>
-        Value Allocate(ValueType type, MemoryLayout layout);
+        /// <remarks> Only the start of the allocation is aligned. To align every row, pad the layout with GetAlignedLayout. </remarks>
+        Value Allocate(ValueType type, MemoryLayout layout, size_t alignment = 0);
 
         /// <summary> Allocates function static data </summary>
         /// <param name="name"> The name of the variable </param>
         /// <param name="type"> The type of the data </param>
         /// <param name="layout"> The layout of the data </param>
-        Value StaticAllocate(std::string name, ValueType type, utilities::MemoryLayout layout);
+        /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
+        Value StaticAllocate(std::string name, ValueType type, utilities::MemoryLayout layout, size_t alignment = 0);
 
         /// <summary> Allocates function static data </summary>
         /// <param name="name"> The name of the variable </param>
         /// <param name="data"> The data </param>
         /// <param name="layout"> The layout of the data </param>
+        /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
         template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, void*> = nullptr>
-        Value StaticAllocate(std::string name, const std::vector<T>& data, std::optional<utilities::MemoryLayout> layout = {})
+        Value StaticAllocate(std::string name, const std::vector<T>& data, std::optional<utilities::MemoryLayout> layout = {}, size_t alignment = 0)
         {
             if (auto globalValue = GetGlobalValue(GlobalAllocationScope::Function, name))
             {
@@ -115,7 +120,7 @@ namespace value
             }
 
             auto optionalLayout = utilities::MemoryLayout({ static_cast<int>(data.size()) });
-            return GlobalAllocateImpl(GlobalAllocationScope::Function, name, data, layout.value_or(optionalLayout));
+            return GlobalAllocateImpl(GlobalAllocationScope::Function, name, data, layout.value_or(optionalLayout), alignment);
         }
 
         /// <summary> Allocates scalar function static data </summary>
@@ -134,14 +139,16 @@ namespace value
         /// <param name="name"> The name of the variable </param>
         /// <param name="type"> The type of the data </param>
         /// <param name="layout"> The layout of the data </param>
-        Value GlobalAllocate(std::string name, ValueType type, utilities::MemoryLayout layout);
+        /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
+        Value GlobalAllocate(std::string name, ValueType type, utilities::MemoryLayout layout, size_t alignment = 0);
 
         /// <summary> Allocates global data </summary>
         /// <param name="name"> The name of the variable </param>
         /// <param name="data"> The data </param>
         /// <param name="layout"> The layout of the data </param>
+        /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
         template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, void*> = nullptr>
-        Value GlobalAllocate(std::string name, const std::vector<T>& data, std::optional<utilities::MemoryLayout> layout = {})
+        Value GlobalAllocate(std::string name, const std::vector<T>& data, std::optional<utilities::MemoryLayout> layout = {}, size_t alignment = 0)
         {
             if (auto globalValue = GetGlobalValue(GlobalAllocationScope::Global, name))
             {
@@ -149,7 +156,7 @@ namespace value
             }
 
             auto optionalLayout = utilities::MemoryLayout({ static_cast<int>(data.size()) });
-            return GlobalAllocateImpl(GlobalAllocationScope::Global, name, data, layout.value_or(optionalLayout));
+            return GlobalAllocateImpl(GlobalAllocationScope::Global, name, data, layout.value_or(optionalLayout), alignment);
         }
 
         /// <summary> Allocates scalar global data </summary>
@@ -189,6 +196,22 @@ namespace value
         /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
         void For(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn);
 
+        /// <summary> Creates a for loop over the memory pointed to with the given layout, emitted according to a schedule </summary>
+        /// <param name="layout"> The layout used to describe the iteration characteristics. Only active elements are iterated over. </param>
+        /// <param name="schedule"> The schedule describing how the loops are split, ordered, unrolled and vectorized.
+        /// Contexts that don't emit code may ignore it. </param>
+        /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
+        void For(MemoryLayout layout, const LoopSchedule& schedule, std::function<void(std::vector<Scalar>)> fn);
+
+        /// <summary> Runs a function once for each of a number of tasks, which may run in parallel </summary>
+        /// <param name="numTasks"> The number of tasks </param>
+        /// <param name="captured"> The values the tasks use. Emitted tasks may run in a separate function, so values from
+        /// the enclosing scope must be passed in here rather than captured by the lambda. </param>
+        /// <param name="fn"> The function to be called for each task, with the index of the task and the task's view of the
+        /// captured values, in the same order </param>
+        /// <remarks> The tasks may run in any order, and all of them have finished when this function returns </remarks>
+        void Parallelize(int numTasks, std::vector<Value> captured, std::function<void(Scalar, std::vector<Value>)> fn);
+
         /// <summary> Moves the data from one location to another </summary>
         /// <param name="source"> The source of the memory to be moved </param>
         /// <param name="destination"> The destination of the memory to be moved </param>
@@ -241,11 +264,11 @@ namespace value
         const std::vector<std::reference_wrapper<FunctionDeclaration>>& GetIntrinsics() const;
 
     private:
-        virtual Value AllocateImpl(ValueType, MemoryLayout) = 0;
+        virtual Value AllocateImpl(ValueType, MemoryLayout, size_t alignment) = 0;
 
         virtual std::optional<Value> GetGlobalValue(GlobalAllocationScope scope, std::string name) = 0;
-        virtual Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout) = 0;
-        virtual Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout) = 0;
+        virtual Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout, size_t alignment) = 0;
+        virtual Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout, size_t alignment) = 0;
 
         virtual detail::ValueTypeDescription GetTypeImpl(Emittable) = 0;
 
@@ -255,6 +278,9 @@ namespace value
         virtual Value StoreConstantDataImpl(ConstantData data) = 0;
 
         virtual void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn) = 0;
+        virtual void ForImpl(MemoryLayout layout, const LoopSchedule& schedule, std::function<void(std::vector<Scalar>)> fn) = 0;
+
+        virtual void ParallelizeImpl(int numTasks, std::vector<Value> captured, std::function<void(Scalar, std::vector<Value>)> fn) = 0;
 
         virtual void MoveDataImpl(Value& source, Value& destination) = 0;
 
@@ -342,8 +368,9 @@ namespace value
     /// <summary> Allocates data with the specified type and size </summary>
     /// <param name="type"> The type of the data to allocate </param>
     /// <param name="layout"> The memory layout of the allocation, in number of elements </param>
+    /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
     /// <returns> An instance of Value that contains a referece to the allocated memory </returns>
-    Value Allocate(ValueType type, utilities::MemoryLayout layout);
+    Value Allocate(ValueType type, utilities::MemoryLayout layout, size_t alignment = 0);
 
     /// <summary> Allocates data with the specified type and size </summary>
     /// <typeparam name="T"> The type of the data to allocate </param>
@@ -358,27 +385,37 @@ namespace value
     /// <summary> Allocates data with the specified type and size </summary>
     /// <typeparam name="T"> The type of the data to allocate </param>
     /// <param name="layout"> The memory layout of the allocation, in number of elements </param>
+    /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
     /// <returns> An instance of Value that contains a referece to the allocated memory </returns>
     template <typename T>
-    Value Allocate(utilities::MemoryLayout layout)
+    Value Allocate(utilities::MemoryLayout layout, size_t alignment = 0)
     {
-        return Allocate(GetValueType<T>(), layout);
+        return Allocate(GetValueType<T>(), layout, alignment);
     }
 
+    /// <summary> Pads the innermost dimension of a layout so that every row of an aligned allocation is aligned </summary>
+    /// <param name="type"> The type of the data </param>
+    /// <param name="layout"> The memory layout of the data </param>
+    /// <param name="alignment"> The alignment of each row, in bytes. Must be a multiple of the size of `type`. </param>
+    /// <returns> The layout with the extent of its innermost physical dimension rounded up to a multiple of `alignment` bytes </returns>
+    utilities::MemoryLayout GetAlignedLayout(ValueType type, utilities::MemoryLayout layout, size_t alignment);
+
     /// <summary> Allocates function static data </summary>
     /// <param name="name"> The name of the variable </param>
     /// <param name="type"> The type of the data </param>
     /// <param name="layout"> The layout of the data </param>
-    Value StaticAllocate(std::string name, ValueType type, utilities::MemoryLayout layout);
+    /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
+    Value StaticAllocate(std::string name, ValueType type, utilities::MemoryLayout layout, size_t alignment = 0);
 
     /// <summary> Allocates function static data </summary>
     /// <param name="name"> The name of the variable </param>
     /// <param name="data"> The data </param>
     /// <param name="layout"> The layout of the data </param>
+    /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
     template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, void*> = nullptr>
-    Value StaticAllocate(std::string name, const std::vector<T>& data, std::optional<utilities::MemoryLayout> layout = {})
+    Value StaticAllocate(std::string name, const std::vector<T>& data, std::optional<utilities::MemoryLayout> layout = {}, size_t alignment = 0)
     {
-        return GetContext().StaticAllocate(name, data, layout);
+        return GetContext().StaticAllocate(name, data, layout, alignment);
     }
 
     /// <summary> Allocates scalar function static data </summary>
@@ -396,22 +433,24 @@ namespace value
     /// <param name="name"> The name of the variable </param>
     /// <param name="type"> The type of the data </param>
     /// <param name="layout"> The layout of the data </param>
-    Value GlobalAllocate(std::string name, ValueType type, utilities::MemoryLayout layout);
+    /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
+    Value GlobalAllocate(std::string name, ValueType type, utilities::MemoryLayout layout, size_t alignment = 0);
 
     template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, void*> = nullptr>
-    Value GlobalAllocate(std::string name, utilities::MemoryLayout layout)
+    Value GlobalAllocate(std::string name, utilities::MemoryLayout layout, size_t alignment = 0)
     {
-        return GlobalAllocate(name, GetValueType<T>(), layout);
+        return GlobalAllocate(name, GetValueType<T>(), layout, alignment);
     }
 
     /// <summary> Allocates global data </summary>
     /// <param name="name"> The name of the variable </param>
     /// <param name="data"> The data </param>
     /// <param name="layout"> The layout of the data </param>
+    /// <param name="alignment"> The alignment of the allocation, in bytes. If 0, the natural alignment of the type is used. </param>
     template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, void*> = nullptr>
-    Value GlobalAllocate(std::string name, const std::vector<T>& data, std::optional<utilities::MemoryLayout> layout = {})
+    Value GlobalAllocate(std::string name, const std::vector<T>& data, std::optional<utilities::MemoryLayout> layout = {}, size_t alignment = 0)
     {
-        return GetContext().GlobalAllocate(name, data, layout);
+        return GetContext().GlobalAllocate(name, data, layout, alignment);
     }
 
     /// <summary> Allocates scalar global data </summary>
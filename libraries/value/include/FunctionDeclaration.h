@@ -12,11 +12,16 @@
 #include "Value.h"
 
 #include <utilities/include/FunctionUtils.h>
+#include <utilities/include/Hash.h>
 #include <utilities/include/StringUtil.h>
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <typeindex>
 #include <vector>
 
 namespace ell
@@ -30,6 +35,38 @@ namespace value
         No
     };
 
+    namespace detail
+    {
+        /// <summary> The values given to FunctionDeclaration::BodyParameters, which can be compared with others </summary>
+        class FunctionBodyParameters
+        {
+        public:
+            virtual ~FunctionBodyParameters() = default;
+
+            virtual bool IsEqual(const FunctionBodyParameters& other) const = 0;
+
+            virtual size_t GetHash() const = 0;
+        };
+
+        template <typename... Types>
+        class FunctionBodyParametersImpl;
+    } // namespace detail
+
+    /// <summary> Identifies the definition of a function: the code that generates its body, the values that code is generated
+    /// from (see FunctionDeclaration::BodyParameters), and the function's return and parameter types. Functions with equal keys
+    /// have identical definitions </summary>
+    struct FunctionDefinitionKey
+    {
+        std::type_index generatorType;
+        std::uintptr_t generatorAddress;
+        std::optional<Value> returnType;
+        std::vector<Value> parameterTypes;
+        std::shared_ptr<const detail::FunctionBodyParameters> bodyParameters;
+    };
+
+    bool operator==(const FunctionDefinitionKey& key1, const FunctionDefinitionKey& key2);
+    bool operator!=(const FunctionDefinitionKey& key1, const FunctionDefinitionKey& key2);
+
     /// <summary> Describes a function that can be acted upon by an EmitterContext instance </summary>
     class [[nodiscard]] FunctionDeclaration
     {
@@ -54,6 +91,17 @@ namespace value
         /// Functions that are declared externally should probably not be decorated </remarks>
         FunctionDeclaration& Decorated(FunctionDecorated shouldDecorate);
 
+        /// <summary> Identifies the body of this function by the parameters it is generated from </summary>
+        /// <param name="bodyParameters"> Zero or more hashable values, other than the function's arguments, that determine the
+        /// body of the function: for instance, the sizes or options a kernel is generated for </param>
+        /// <returns> A reference to this instance </returns>
+        /// <remarks> Functions defined by the same code, with the same parameter types, return type and body parameters are assumed
+        /// to have identical bodies. A context may define this function as a call to a function it has already emitted for another
+        /// such declaration, instead of emitting and compiling the same body again. Functions whose bodies allocate static or global
+        /// data (see StaticAllocate) would then share it, so their body parameters must identify that data as well </remarks>
+        template <typename... Types>
+        FunctionDeclaration& BodyParameters(const Types&... bodyParameters);
+
         /// <summary> Specifies a function definition for this declaration </summary>
         /// <param name="fn"> A function object that takes zero or more Value library observer types and returns void or a Value library observer type.
         /// This function object defines this function. </param>
@@ -92,6 +140,10 @@ namespace value
         /// Otherwise, the std::optional instance is empty </summary>
         const std::optional<Value>& GetReturnType() const;
 
+        /// <summary> Gets the key identifying the definition of the function, if it has been defined and its body parameters were
+        /// specified. Functions with equal definition keys can share one definition. </summary>
+        std::optional<FunctionDefinitionKey> GetDefinitionKey() const;
+
         /// <summary> Returns true if function is defined for current context, false otherwise </summary>
         [[nodiscard]] bool IsDefined() const;
 
@@ -108,6 +160,9 @@ namespace value
         mutable std::optional<std::string> _decoratedFunctionName;
         std::optional<Value> _returnType;
         std::vector<Value> _paramTypes;
+        std::shared_ptr<const detail::FunctionBodyParameters> _bodyParameters;
+        std::optional<std::type_index> _generatorType;
+        std::uintptr_t _generatorAddress = 0;
         bool _isDecorated = true;
         bool _isEmpty = true;
     };
@@ -131,6 +186,14 @@ struct hash<::ell::value::FunctionDeclaration>
 
     size_t operator()(const Type& value) const;
 };
+
+template <>
+struct hash<::ell::value::FunctionDefinitionKey>
+{
+    using Type = ::ell::value::FunctionDefinitionKey;
+
+    size_t operator()(const Type& value) const;
+};
 } // namespace std
 
 #pragma region implementation
@@ -202,6 +265,43 @@ namespace value
 
 #undef FUNCTION_TYPE
 
+    namespace detail
+    {
+        // String literals are kept as strings, so that they're compared by value
+        template <typename T>
+        using FunctionBodyParameterType = std::conditional_t<std::is_convertible_v<std::decay_t<T>, const char*>, std::string, std::decay_t<T>>;
+
+        template <typename... Types>
+        class FunctionBodyParametersImpl : public FunctionBodyParameters
+        {
+        public:
+            FunctionBodyParametersImpl(const Types&... values) :
+                _values(values...)
+            {}
+
+            bool IsEqual(const FunctionBodyParameters& other) const override
+            {
+                auto otherImpl = dynamic_cast<const FunctionBodyParametersImpl*>(&other);
+                return otherImpl != nullptr && otherImpl->_values == _values;
+            }
+
+            size_t GetHash() const override { return utilities::HashValue(_values); }
+
+        private:
+            std::tuple<Types...> _values;
+        };
+    } // namespace detail
+
+    template <typename... Types>
+    FunctionDeclaration& FunctionDeclaration::BodyParameters(const Types&... bodyParameters)
+    {
+        CheckNonEmpty();
+
+        using ParametersType = detail::FunctionBodyParametersImpl<detail::FunctionBodyParameterType<Types>...>;
+        _bodyParameters = std::make_shared<ParametersType>(bodyParameters...);
+        return *this;
+    }
+
     template <typename ReturnT, typename... Args>
     [[maybe_unused]] std::function<ReturnT(Args...)> FunctionDeclaration::DefineImpl(std::function<ReturnT(Args...)> fn) {
         if constexpr (std::is_same_v<ReturnT, void>)
@@ -235,6 +335,13 @@ namespace value
             auto paramTypes = utilities::VectorToTuple<Args...>(_paramTypes);
         }
 
+        // Identify the code that generates the body, for contexts that reuse definitions (see BodyParameters)
+        _generatorType = fn.target_type();
+        if (auto functionPointer = fn.template target<ReturnT (*)(Args...)>())
+        {
+            _generatorAddress = reinterpret_cast<std::uintptr_t>(*functionPointer);
+        }
+
         auto createdFn = GetContext().CreateFunction(*this, [fn = std::move(fn)](std::vector<Value> args) -> std::optional<Value> {
             std::tuple<Args...> tupleArgs = utilities::VectorToTuple<Args...>(args);
             if constexpr (std::is_same_v<ReturnT, void>)
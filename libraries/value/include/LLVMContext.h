@@ -42,13 +42,20 @@ namespace value
 
         const emitters::IRModuleEmitter& GetModuleEmitter() const;
 
+        /// <summary> Gets the emitter for the function currently being defined </summary>
+        emitters::IRFunctionEmitter& GetFunctionEmitter() const;
+
+        /// <summary> Returns a value that refers to emitted data, promoting constant data to a global if necessary </summary>
+        /// <param name="value"> The value </param>
+        Value EnsureEmittable(Value value);
+
     private:
-        Value AllocateImpl(ValueType value, MemoryLayout layout) override;
+        Value AllocateImpl(ValueType value, MemoryLayout layout, size_t alignment) override;
 
         std::optional<Value> GetGlobalValue(GlobalAllocationScope scope, std::string name) override;
 
-        Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout) override;
-        Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout) override;
+        Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout, size_t alignment) override;
+        Value GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout, size_t alignment) override;
 
         detail::ValueTypeDescription GetTypeImpl(Emittable emittable) override;
 
@@ -58,6 +65,9 @@ namespace value
         Value StoreConstantDataImpl(ConstantData data) override;
 
         void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn) override;
+        void ForImpl(MemoryLayout layout, const LoopSchedule& schedule, std::function<void(std::vector<Scalar>)> fn) override;
+
+        void ParallelizeImpl(int numTasks, std::vector<Value> captured, std::function<void(Scalar, std::vector<Value>)> fn) override;
 
         void MoveDataImpl(Value& source, Value& destination) override;
 
@@ -88,8 +98,6 @@ namespace value
         std::string GetGlobalScopedName(std::string name) const;
         std::string GetCurrentFunctionScopedName(std::string name) const;
 
-        emitters::IRFunctionEmitter& GetFunctionEmitter() const;
-
         struct PromotedConstantDataDescription
         {
             const ConstantData* data;
@@ -99,7 +107,6 @@ namespace value
         Value PromoteConstantData(Value value);
         std::optional<PromotedConstantDataDescription> HasBeenPromoted(Value value) const;
         Value Realize(Value value) const;
-        Value EnsureEmittable(Value value);
 
         class IfContextImpl;
         struct FunctionScope;
@@ -114,6 +121,9 @@ namespace value
         std::stack<std::reference_wrapper<emitters::IRFunctionEmitter>> _functionStack;
         std::map<std::string, std::pair<Emittable, MemoryLayout>> _globals;
         std::unordered_map<FunctionDeclaration, DefinedFunction> _definedFunctions;
+
+        // The emitted functions, keyed by the definition key of their declarations, for reuse by later declarations with the same one
+        std::unordered_map<FunctionDefinitionKey, DefinedFunction> _definitionCache;
     };
 
 } // namespace value
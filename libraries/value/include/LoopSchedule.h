@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LoopSchedule.h (value)
+//  Authors:  Kern Handa
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/MemoryLayout.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace value
+{
+    /// <summary> One loop of the loop nest described by a LoopSchedule </summary>
+    struct ScheduledLoop
+    {
+        /// <summary> The (physical) dimension of the layout this loop iterates over </summary>
+        int dimension = 0;
+
+        /// <summary> The number of iterations of the loop </summary>
+        int size = 0;
+
+        /// <summary> The amount the coordinate of `dimension` advances by in each iteration </summary>
+        int stride = 1;
+
+        /// <summary> If true, the loop is emitted as straight-line code, one copy of the body per iteration </summary>
+        bool unrolled = false;
+
+        /// <summary> If true, the iterations of the loop are independent tasks that may run in parallel </summary>
+        bool parallel = false;
+    };
+
+    /// <summary> Describes how the loops of a `For` are emitted, separately from the body of the loop, in the spirit of
+    /// a Halide schedule. A `For` over a layout with N dimensions starts out as N nested loops, one per physical dimension,
+    /// outermost first. Each directive transforms the current loop nest, in the order they're added. Loops are referred to
+    /// by their position in the nest at the time the directive is applied. </summary>
+    /// <remarks> A schedule only changes the order in which the coordinates are visited, never the set of coordinates, so
+    /// a context is free to ignore it, apart from `Parallel` (see there). Split factors that don't divide the loop evenly are
+    /// allowed on the outermost loop of a dimension; the coordinates past the end of the dimension are skipped. </remarks>
+    class LoopSchedule
+    {
+    public:
+        /// <summary> Splits a loop into an outer loop over blocks of `factor` iterations, followed by the inner loop within a block </summary>
+        /// <param name="loop"> The position of the loop in the current nest </param>
+        /// <param name="factor"> The number of iterations of the new inner loop </param>
+        LoopSchedule& Split(int loop, int factor);
+
+        /// <summary> Splits each of the loops of the nest, and moves all the outer (block) loops outside all the inner ones </summary>
+        /// <param name="sizes"> The tile size of each loop. The nest must have exactly `sizes.size()` loops. </param>
+        LoopSchedule& Tile(std::vector<int> sizes);
+
+        /// <summary> Reorders the loops of the nest </summary>
+        /// <param name="order"> A permutation of the current loop positions, from the outermost loop to the innermost </param>
+        LoopSchedule& Reorder(std::vector<int> order);
+
+        /// <summary> Fully unrolls a loop </summary>
+        /// <param name="loop"> The position of the loop in the current nest </param>
+        LoopSchedule& Unroll(int loop);
+
+        /// <summary> Splits the innermost loop by `width` and unrolls the new inner loop, so the body is emitted `width`
+        /// times for consecutive coordinates, ready to be combined in vector instructions </summary>
+        /// <param name="width"> The vector width, in elements </param>
+        LoopSchedule& Vectorize(int width);
+
+        /// <summary> Splits the outermost loop into `numTasks` contiguous blocks of iterations that may run in parallel </summary>
+        /// <param name="numTasks"> The number of tasks </param>
+        /// <remarks> `LLVMContext` doesn't emit parallel loops yet, and throws if a schedule has one: the body of a `For` can't
+        /// be moved into a task function, because it refers to the values it uses through lambda captures. Use `Parallelize`,
+        /// which takes those values explicitly. </remarks>
+        LoopSchedule& Parallel(int numTasks);
+
+        /// <summary> Returns true if the schedule has no directives </summary>
+        bool IsEmpty() const { return _directives.empty(); }
+
+        /// <summary> Applies the schedule to the loops over a layout </summary>
+        /// <param name="size"> The active size of the layout, in physical order </param>
+        /// <returns> The loop nest, from the outermost loop to the innermost </returns>
+        std::vector<ScheduledLoop> GetLoops(const utilities::MemoryShape& size) const;
+
+    private:
+        enum class DirectiveType
+        {
+            split,
+            tile,
+            reorder,
+            unroll,
+            vectorize,
+            parallel
+        };
+
+        struct Directive
+        {
+            DirectiveType type;
+            std::vector<int> arguments;
+        };
+
+        std::vector<Directive> _directives;
+    };
+
+} // namespace value
+} // namespace ell
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "LoopSchedule.h"
 #include "Scalar.h"
 
 #include <utilities/include/MemoryLayout.h>
@@ -29,10 +30,42 @@ namespace value
     /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
     void For(Matrix matrix, std::function<void(Scalar, Scalar)> fn);
 
+    /// <summary> Creates a for loop over the matrix, emitted according to a schedule </summary>
+    /// <param name="matrix"> The instance of Matrix that references the data over which to iterate </param>
+    /// <param name="schedule"> The schedule describing how the loops are emitted. The loops start out in the physical
+    /// order of the matrix, e.g., rows then columns for a row-major matrix. </param>
+    /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
+    void For(Matrix matrix, const LoopSchedule& schedule, std::function<void(Scalar, Scalar)> fn);
+
+    /// <summary> Computes the matrix product m1 * m2 </summary>
+    /// <param name="m1"> The matrix on the left </param>
+    /// <param name="m2"> The matrix on the right </param>
+    /// <returns> A newly allocated matrix containing the product </returns>
     Matrix GEMM(Matrix m1, Matrix m2);
 
+    /// <summary> Accumulates the matrix product A * B into C: C += A * B </summary>
+    /// <param name="A"> The matrix on the left </param>
+    /// <param name="B"> The matrix on the right </param>
+    /// <param name="C"> The matrix to accumulate the product into </param>
+    /// <remarks> Any of the matrices may be row- or column-major, and padded. For float and double matrices,
+    /// ComputeContext calls BLAS, and LLVMContext emits a call to BLAS if the compiler options allow it, or to the
+    /// native cache-blocked GEMM (with block and register tile sizes chosen for the target device) otherwise.
+    /// Other types use a scheduled loop nest. </remarks>
+    void GEMM(Matrix A, Matrix B, Matrix C);
+
+    /// <summary> Computes the matrix-vector product m * v </summary>
+    /// <param name="m"> The matrix </param>
+    /// <param name="v"> The vector </param>
+    /// <returns> A newly allocated vector containing the product </returns>
     Vector GEMV(Matrix m, Vector v);
 
+    /// <summary> Accumulates the matrix-vector product A * x into y: y += A * x </summary>
+    /// <param name="A"> The matrix </param>
+    /// <param name="x"> The vector to multiply </param>
+    /// <param name="y"> The vector to accumulate the product into </param>
+    /// <remarks> Dispatches like the accumulating `GEMM` </remarks>
+    void GEMV(Matrix A, Vector x, Vector y);
+
     Matrix operator+(Matrix, Matrix);
     Matrix operator+(Matrix, Scalar);
 
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     Parallelization.h (value)
+//  Authors:  Kern Handa
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "EmitterContext.h"
+#include "Scalar.h"
+#include "Value.h"
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace value
+{
+    /// <summary> Runs a function once for each of a number of tasks, which may run in parallel </summary>
+    /// <param name="numTasks"> The number of tasks </param>
+    /// <param name="captured"> The values the tasks use, as a tuple of Value, Scalar, Vector, Matrix or Tensor instances.
+    /// Emitted tasks may run in a separate function, so values from the enclosing scope must be passed in here rather than
+    /// captured by the lambda. </param>
+    /// <param name="fn"> The function to be called for each task, with the index of the task as a Scalar, followed by the
+    /// task's view of each of the captured values </param>
+    /// <remarks> `LLVMContext` emits the tasks onto the thread pool when `CompilerOptions::parallelize` is set, and
+    /// `ComputeContext` runs them on host threads. The tasks may run in any order, and all of them have finished when this
+    /// function returns. Tasks may write to disjoint parts of the captured values, but must not otherwise share data. </remarks>
+    /// <example>
+    /// Parallelize(4, std::tuple{ input, output }, [](Scalar task, Vector input, Vector output) { ... });
+    /// </example>
+    template <typename Fn, typename... Captures>
+    void Parallelize(int numTasks, std::tuple<Captures...> captured, Fn&& fn);
+
+} // namespace value
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace value
+{
+    namespace detail
+    {
+        template <typename T>
+        Value GetCapturedValue(const T& captured)
+        {
+            if constexpr (std::is_same_v<T, Value>)
+            {
+                return captured;
+            }
+            else
+            {
+                return captured.GetValue();
+            }
+        }
+
+        template <typename... Captures, typename Fn, size_t... Indices>
+        void CallTaskFunction(Fn& fn, Scalar taskIndex, const std::vector<Value>& values, std::index_sequence<Indices...>)
+        {
+            fn(taskIndex, Captures(values[Indices])...);
+        }
+    } // namespace detail
+
+    template <typename Fn, typename... Captures>
+    void Parallelize(int numTasks, std::tuple<Captures...> captured, Fn&& fn)
+    {
+        std::vector<Value> capturedValues = std::apply(
+            [](const auto&... values) { return std::vector<Value>{ detail::GetCapturedValue(values)... }; },
+            captured);
+
+        GetContext().Parallelize(numTasks, capturedValues, [fn = std::forward<Fn>(fn)](Scalar taskIndex, std::vector<Value> values) mutable {
+            detail::CallTaskFunction<Captures...>(fn, taskIndex, values, std::index_sequence_for<Captures...>{});
+        });
+    }
+
+} // namespace value
+} // namespace ell
+
+#pragma endregion implementation
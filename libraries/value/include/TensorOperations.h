@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "LoopSchedule.h"
 #include "Scalar.h"
 
 #include <utilities/include/MemoryLayout.h>
@@ -33,6 +34,13 @@ namespace value
     /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
     void For(Tensor tensor, std::function<void(Scalar, Scalar, Scalar)> fn);
 
+    /// <summary> Creates a for loop over the tensor, emitted according to a schedule </summary>
+    /// <param name="tensor"> The instance of Tensor that references the data over which to iterate </param>
+    /// <param name="schedule"> The schedule describing how the loops are emitted. The loops start out in the physical
+    /// order of the tensor. </param>
+    /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
+    void For(Tensor tensor, const LoopSchedule& schedule, std::function<void(Scalar, Scalar, Scalar)> fn);
+
     Tensor operator+(Tensor, Scalar);
     Tensor operator-(Tensor, Scalar);
     Tensor operator*(Tensor, Scalar);
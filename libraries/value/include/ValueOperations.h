@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "LoopSchedule.h"
 #include "ValueType.h"
 
 #include <utilities/include/Boolean.h>
@@ -27,6 +28,12 @@ namespace value
     /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
     void For(utilities::MemoryLayout layout, std::function<void(Scalar)> fn);
 
+    /// <summary> Creates a for loop over the given layout, emitted according to a schedule </summary>
+    /// <param name="layout"> The layout used to describe the iteration characteristics. Only active elements are iterated over. </param>
+    /// <param name="schedule"> The schedule describing how the loops are emitted </param>
+    /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
+    void For(utilities::MemoryLayout layout, const LoopSchedule& schedule, std::function<void(Scalar)> fn);
+
     /// <summary> Cast a value to another type, returning a new value </summary>
     /// <param name="value"> The data to convert </param>
     /// <param name="type"> The type to which the data should be casted </param>
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "LoopSchedule.h"
+
 #include <utilities/include/MemoryLayout.h>
 
 #include <functional>
@@ -41,6 +43,12 @@ namespace value
     /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
     void For(Vector vector, std::function<void(Scalar)> fn);
 
+    /// <summary> Creates a for loop over the vector, emitted according to a schedule </summary>
+    /// <param name="vector"> The instance of Vector that references the data over which to iterate </param>
+    /// <param name="schedule"> The schedule describing how the loop is emitted </param>
+    /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
+    void For(Vector vector, const LoopSchedule& schedule, std::function<void(Scalar)> fn);
+
     Vector operator+(Scalar s, Vector v);
     Vector operator+(Vector v, Scalar s);
     Vector operator+(Vector v1, Vector v2);
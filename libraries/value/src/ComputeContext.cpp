@@ -15,9 +15,12 @@
 #include <utilities/include/TypeName.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <exception>
 #include <iostream>
+#include <numeric>
 #include <string>
 
 namespace ell
@@ -32,10 +35,10 @@ namespace value
         FunctionScope(ComputeContext& context, std::string fnName) :
             context(context)
         {
-            context._stack.push({ fnName, {} });
+            context.GetStack().push({ fnName, {} });
         }
 
-        ~FunctionScope() { context._stack.pop(); }
+        ~FunctionScope() { context.GetStack().pop(); }
 
         ComputeContext& context;
     };
@@ -367,8 +370,9 @@ namespace value
         return *it;
     }
 
-    Value ComputeContext::AllocateImpl(ValueType type, MemoryLayout layout)
+    Value ComputeContext::AllocateImpl(ValueType type, MemoryLayout layout, size_t)
     {
+        // The alignment only matters to emitted code, so the host allocation keeps the alignment of std::vector
         // special case the scalar case
         auto size = layout == ScalarLayout ? 1u : layout.GetMemorySize();
 
@@ -382,6 +386,7 @@ namespace value
     {
         std::string adjustedName = GetScopeAdjustedName(scope, name);
 
+        std::lock_guard<std::mutex> lock(_mutex);
         if (auto it = _globals.find(adjustedName); it != _globals.end())
         {
             return ConstantDataToValue(it->second.first, it->second.second);
@@ -390,10 +395,11 @@ namespace value
         return std::nullopt;
     }
 
-    Value ComputeContext::GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout)
+    Value ComputeContext::GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout, size_t)
     {
         std::string adjustedName = GetScopeAdjustedName(scope, name);
 
+        std::lock_guard<std::mutex> lock(_mutex);
         if (_globals.find(adjustedName) != _globals.end())
         {
             throw InputException(InputExceptionErrors::invalidArgument,
@@ -407,12 +413,12 @@ namespace value
         return ConstantDataToValue(globalData.first, globalData.second);
     }
 
-    Value ComputeContext::GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout)
+    Value ComputeContext::GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout, size_t alignment)
     {
         // special case the scalar case
         auto size = layout == ScalarLayout ? 1u : layout.GetMemorySize();
         auto constantData = AllocateConstantData(type, size);
-        return GlobalAllocateImpl(scope, name, constantData, layout);
+        return GlobalAllocateImpl(scope, name, constantData, layout, alignment);
     }
 
     Value ComputeContext::StoreConstantDataImpl(ConstantData data)
@@ -504,6 +510,7 @@ namespace value
 
     bool ComputeContext::IsGlobalValue(Value value)
     {
+        std::lock_guard<std::mutex> lock(_mutex);
         return std::visit(VariantVisitor{ [](Undefined) -> bool {
                                              throw LogicException(LogicExceptionErrors::illegalState);
                                          },
@@ -543,6 +550,7 @@ namespace value
             throw InputException(InputExceptionErrors::invalidArgument, "Specified function is an intrinsic");
         }
 
+        std::lock_guard<std::mutex> lock(_mutex);
         if (auto it = _definedFunctions.find(decl); it != _definedFunctions.end())
         {
             return it->second;
@@ -614,6 +622,7 @@ namespace value
             return true;
         }
 
+        std::lock_guard<std::mutex> lock(_mutex);
         return _definedFunctions.find(decl) != _definedFunctions.end();
     }
 
@@ -672,6 +681,64 @@ namespace value
         } while (IncrementMemoryCoordinate(coordinate, maxCoordinate));
     }
 
+    void ComputeContext::ForImpl(MemoryLayout layout, const LoopSchedule&, std::function<void(std::vector<Scalar>)> fn)
+    {
+        // The schedule doesn't change the result, only the shape of emitted code
+        ForImpl(layout, fn);
+    }
+
+    void ComputeContext::ParallelizeImpl(int numTasks, std::vector<Value> captured, std::function<void(Scalar, std::vector<Value>)> fn)
+    {
+        // Run the tasks on a pool of threads that take the next task index until none are left. Each thread gets a
+        // stack of its own for the temporaries of its tasks, in the scope of the calling function.
+        const auto numThreads = std::min(numTasks, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)));
+        const auto scopeName = GetTopFrame().first;
+        std::atomic<int> nextTask{ 0 };
+        std::exception_ptr firstException;
+
+        auto worker = [&, this] {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _taskStacks[std::this_thread::get_id()].push({ scopeName, {} });
+            }
+
+            try
+            {
+                for (int taskIndex = nextTask++; taskIndex < numTasks; taskIndex = nextTask++)
+                {
+                    fn(Scalar(taskIndex), captured);
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!firstException)
+                {
+                    firstException = std::current_exception();
+                }
+                nextTask = numTasks;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _taskStacks.erase(std::this_thread::get_id());
+        };
+
+        std::vector<std::thread> threads;
+        for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+        {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        if (firstException)
+        {
+            std::rethrow_exception(firstException);
+        }
+    }
+
     Value ComputeContext::UnaryOperationImpl(ValueUnaryOperation op, Value destination)
     {
         throw LogicException(LogicExceptionErrors::notImplemented);
@@ -693,7 +760,13 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        if (destination.GetLayout() != source.GetLayout())
+        // A scalar source is applied to every element of the destination. Otherwise the two only need the same logical
+        // shape: their layouts can differ in padding and dimension order.
+        const auto& destinationLayout = destination.GetLayout();
+        const auto& sourceLayout = source.GetLayout();
+        const bool broadcast = sourceLayout == ScalarLayout && destinationLayout != ScalarLayout;
+        if (!broadcast && destinationLayout != sourceLayout &&
+            destinationLayout.GetLogicalDimensionActiveSize() != sourceLayout.GetLogicalDimensionActiveSize())
         {
             throw InputException(InputExceptionErrors::sizeMismatch);
         }
@@ -701,25 +774,78 @@ namespace value
         std::visit(VariantVisitor{ [](Undefined) {},
                                    [](Emittable) {},
                                    [](Boolean*) {},
-                                   [&destination, &source, op](auto&& destinationData) {
+                                   [&destinationLayout, &sourceLayout, &source, broadcast, op](auto&& destinationData) {
                                        using DestinationDataType =
                                            std::remove_pointer_t<std::decay_t<decltype(destinationData)>>;
 
-                                       std::function<DestinationDataType(DestinationDataType, DestinationDataType)>
-                                           opFn;
+                                       auto sourceData = std::get<DestinationDataType*>(source.GetUnderlyingData());
+
+                                       // The operation is a template parameter of the loops, so it's inlined into them
+                                       auto apply = [&](auto opFn) {
+                                           if (broadcast)
+                                           {
+                                               const auto sourceValue = *sourceData;
+                                               if (destinationLayout.IsContiguous())
+                                               {
+                                                   auto numElements = destinationLayout.NumElements();
+                                                   std::transform(destinationData,
+                                                                  destinationData + numElements,
+                                                                  destinationData,
+                                                                  [&](DestinationDataType dst) { return opFn(dst, sourceValue); });
+                                                   return;
+                                               }
+
+                                               auto maxCoordinate = destinationLayout.GetActiveSize().ToVector();
+                                               decltype(maxCoordinate) coordinate(maxCoordinate.size());
+                                               do
+                                               {
+                                                   auto destinationOffset = destinationLayout.GetEntryOffset(coordinate);
+                                                   *(destinationData + destinationOffset) =
+                                                       opFn(*(destinationData + destinationOffset), sourceValue);
+                                               } while (IncrementMemoryCoordinate(coordinate, maxCoordinate));
+                                               return;
+                                           }
+
+                                           if (sourceLayout == destinationLayout && destinationLayout.IsContiguous())
+                                           {
+                                               auto numElements = destinationLayout.NumElements();
+                                               std::transform(destinationData,
+                                                              destinationData + numElements,
+                                                              sourceData,
+                                                              destinationData,
+                                                              opFn);
+                                               return;
+                                           }
+
+                                           auto maxCoordinate = sourceLayout.GetActiveSize().ToVector();
+                                           decltype(maxCoordinate) coordinate(maxCoordinate.size());
+                                           do
+                                           {
+                                               auto logicalCoordinates = sourceLayout.GetLogicalCoordinates(coordinate);
+                                               auto sourceOffset =
+                                                   sourceLayout.GetLogicalEntryOffset(logicalCoordinates);
+                                               auto destinationOffset =
+                                                   destinationLayout.GetLogicalEntryOffset(logicalCoordinates);
+                                               *(destinationData + destinationOffset) =
+                                                   opFn(*(destinationData + destinationOffset),
+                                                        *(sourceData + sourceOffset));
+                                           } while (IncrementMemoryCoordinate(coordinate, maxCoordinate));
+                                       };
+
+                                       using T = DestinationDataType;
                                        switch (op)
                                        {
                                        case ValueBinaryOperation::add:
-                                           opFn = [](auto dst, auto src) { return dst + src; };
+                                           apply([](T dst, T src) -> T { return dst + src; });
                                            break;
                                        case ValueBinaryOperation::subtract:
-                                           opFn = [](auto dst, auto src) { return dst - src; };
+                                           apply([](T dst, T src) -> T { return dst - src; });
                                            break;
                                        case ValueBinaryOperation::multiply:
-                                           opFn = [](auto dst, auto src) { return dst * src; };
+                                           apply([](T dst, T src) -> T { return dst * src; });
                                            break;
                                        case ValueBinaryOperation::divide:
-                                           opFn = [](auto dst, auto src) { return dst / src; };
+                                           apply([](T dst, T src) -> T { return dst / src; });
                                            break;
 
                                        default:
@@ -728,7 +854,7 @@ namespace value
                                                switch (op)
                                                {
                                                case ValueBinaryOperation::modulus:
-                                                   opFn = [](auto dst, auto src) { return dst % src; };
+                                                   apply([](T dst, T src) -> T { return dst % src; });
                                                    break;
                                                default:
                                                    throw LogicException(LogicExceptionErrors::illegalState);
@@ -739,35 +865,6 @@ namespace value
                                                throw LogicException(LogicExceptionErrors::illegalState);
                                            }
                                        }
-
-                                       auto& sourceData = std::get<DestinationDataType*>(source.GetUnderlyingData());
-                                       if (source.GetLayout().IsContiguous() && destination.GetLayout().IsContiguous())
-                                       {
-                                           auto numElements = destination.GetLayout().NumElements();
-                                           std::transform(destinationData,
-                                                          destinationData + numElements,
-                                                          sourceData,
-                                                          destinationData,
-                                                          opFn);
-                                       }
-                                       else
-                                       {
-                                           auto& sourceLayout = source.GetLayout();
-                                           auto maxCoordinate = sourceLayout.GetActiveSize().ToVector();
-                                           decltype(maxCoordinate) coordinate(maxCoordinate.size());
-
-                                           do
-                                           {
-                                               auto logicalCoordinates = sourceLayout.GetLogicalCoordinates(coordinate);
-                                               auto sourceOffset =
-                                                   sourceLayout.GetLogicalEntryOffset(logicalCoordinates);
-                                               auto destinationOffset =
-                                                   destination.GetLayout().GetLogicalEntryOffset(logicalCoordinates);
-                                               *(destinationData + destinationOffset) =
-                                                   opFn(*(destinationData + destinationOffset),
-                                                        *(sourceData + sourceOffset));
-                                           } while (IncrementMemoryCoordinate(coordinate, maxCoordinate));
-                                       }
                                    } },
                    destination.GetUnderlyingData());
 
@@ -967,9 +1064,17 @@ namespace value
             return IntrinsicCall(func, args);
         }
 
-        if (auto it = _definedFunctions.find(func); it != _definedFunctions.end())
+        std::optional<DefinedFunction> definedFunction;
         {
-            return it->second(args);
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (auto it = _definedFunctions.find(func); it != _definedFunctions.end())
+            {
+                definedFunction = it->second;
+            }
+        }
+        if (definedFunction)
+        {
+            return (*definedFunction)(args);
         }
 
         throw InputException(InputExceptionErrors::invalidArgument, "Specified function is not defined for this context");
@@ -1057,9 +1162,78 @@ namespace value
         return GetGlobalScopedName(GetTopFrame().first + "_" + name);
     }
 
-    ComputeContext::Frame& ComputeContext::GetTopFrame() { return _stack.top(); }
+    std::stack<ComputeContext::Frame>& ComputeContext::GetStack()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (auto it = _taskStacks.find(std::this_thread::get_id()); it != _taskStacks.end())
+        {
+            return it->second;
+        }
+        return _stack;
+    }
+
+    const std::stack<ComputeContext::Frame>& ComputeContext::GetStack() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (auto it = _taskStacks.find(std::this_thread::get_id()); it != _taskStacks.end())
+        {
+            return it->second;
+        }
+        return _stack;
+    }
+
+    ComputeContext::Frame& ComputeContext::GetTopFrame() { return GetStack().top(); }
+
+    const ComputeContext::Frame& ComputeContext::GetTopFrame() const { return GetStack().top(); }
 
-    const ComputeContext::Frame& ComputeContext::GetTopFrame() const { return _stack.top(); }
+    namespace detail
+    {
+        bool TryComputeElementwise(ValueBinaryOperation op, Value destination, Value source)
+        {
+            return InvokeForContext<ComputeContext>([&](ComputeContext& context) {
+                       context.BinaryOperation(op, destination, source);
+                       return true;
+                   })
+                .value_or(false);
+        }
+
+        std::optional<Scalar> TryComputeAccumulate(Value value, Scalar initialValue)
+        {
+            if (value.GetBaseType() != initialValue.GetType() || value.GetBaseType() == ValueType::Boolean)
+            {
+                return std::nullopt;
+            }
+
+            return InvokeForContext<ComputeContext>([&](ComputeContext&) -> std::optional<Scalar> {
+                       return std::visit(
+                           VariantVisitor{ [](Undefined) -> std::optional<Scalar> { return std::nullopt; },
+                                           [](Emittable) -> std::optional<Scalar> { return std::nullopt; },
+                                           [](Boolean*) -> std::optional<Scalar> { return std::nullopt; },
+                                           [&](auto&& data) -> std::optional<Scalar> {
+                                               using Type = std::remove_pointer_t<std::decay_t<decltype(data)>>;
+
+                                               const auto& layout = value.GetLayout();
+                                               auto result = initialValue.Get<Type>();
+                                               if (layout.IsContiguous())
+                                               {
+                                                   result = std::accumulate(data, data + layout.NumElements(), result);
+                                               }
+                                               else
+                                               {
+                                                   auto maxCoordinate = layout.GetActiveSize().ToVector();
+                                                   decltype(maxCoordinate) coordinate(maxCoordinate.size());
+                                                   do
+                                                   {
+                                                       result += *(data + layout.GetEntryOffset(coordinate));
+                                                   } while (IncrementMemoryCoordinate(coordinate, maxCoordinate));
+                                               }
+                                               return Scalar(result);
+                                           } },
+                           value.GetUnderlyingData());
+                   })
+                .value_or(std::nullopt);
+        }
+    } // namespace detail
 
 } // namespace value
 } // namespace ell
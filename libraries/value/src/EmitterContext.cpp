@@ -46,6 +46,42 @@ namespace value
 
     } // namespace detail
 
+    namespace
+    {
+        void ValidateAlignment(size_t alignment)
+        {
+            if ((alignment & (alignment - 1)) != 0)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "Allocation alignment must be a power of 2");
+            }
+        }
+
+        size_t GetValueTypeSize(ValueType type)
+        {
+            switch (type)
+            {
+            case ValueType::Boolean:
+                return sizeof(Boolean);
+            case ValueType::Char8:
+                return sizeof(char);
+            case ValueType::Byte:
+                return sizeof(uint8_t);
+            case ValueType::Int16:
+                return sizeof(int16_t);
+            case ValueType::Int32:
+                return sizeof(int32_t);
+            case ValueType::Int64:
+                return sizeof(int64_t);
+            case ValueType::Float:
+                return sizeof(float);
+            case ValueType::Double:
+                return sizeof(double);
+            default:
+                throw InputException(InputExceptionErrors::invalidArgument, "Type has no size");
+            }
+        }
+    } // namespace
+
     EmitterContext::IfContextImpl::~IfContextImpl() = default;
 
     EmitterContext::IfContext::IfContext(std::unique_ptr<EmitterContext::IfContextImpl> impl) :
@@ -70,10 +106,15 @@ namespace value
 
     Value EmitterContext::Allocate(ValueType type, size_t size) { return Allocate(type, MemoryLayout({ (int)size })); }
 
-    Value EmitterContext::Allocate(ValueType type, MemoryLayout layout) { return AllocateImpl(type, layout); }
+    Value EmitterContext::Allocate(ValueType type, MemoryLayout layout, size_t alignment)
+    {
+        ValidateAlignment(alignment);
+        return AllocateImpl(type, layout, alignment);
+    }
 
-    Value EmitterContext::StaticAllocate(std::string name, ValueType type, utilities::MemoryLayout layout)
+    Value EmitterContext::StaticAllocate(std::string name, ValueType type, utilities::MemoryLayout layout, size_t alignment)
     {
+        ValidateAlignment(alignment);
         if (auto globalValue = GetGlobalValue(GlobalAllocationScope::Function, name))
         {
             Value value = globalValue.value();
@@ -86,11 +127,12 @@ namespace value
             return value;
         }
 
-        return GlobalAllocateImpl(GlobalAllocationScope::Function, name, type, layout);
+        return GlobalAllocateImpl(GlobalAllocationScope::Function, name, type, layout, alignment);
     }
 
-    Value EmitterContext::GlobalAllocate(std::string name, ValueType type, utilities::MemoryLayout layout)
+    Value EmitterContext::GlobalAllocate(std::string name, ValueType type, utilities::MemoryLayout layout, size_t alignment)
     {
+        ValidateAlignment(alignment);
         if (auto globalValue = GetGlobalValue(GlobalAllocationScope::Global, name))
         {
             Value value = globalValue.value();
@@ -103,7 +145,7 @@ namespace value
             return value;
         }
 
-        return GlobalAllocateImpl(GlobalAllocationScope::Global, name, type, layout);
+        return GlobalAllocateImpl(GlobalAllocationScope::Global, name, type, layout, alignment);
     }
 
     detail::ValueTypeDescription EmitterContext::GetType(Emittable emittable) { return GetTypeImpl(emittable); }
@@ -130,6 +172,31 @@ namespace value
         return ForImpl(layout, fn);
     }
 
+    void EmitterContext::For(MemoryLayout layout, const LoopSchedule& schedule, std::function<void(std::vector<Scalar>)> fn)
+    {
+        if (layout.NumElements() == 0)
+        {
+            return;
+        }
+
+        if (schedule.IsEmpty())
+        {
+            return ForImpl(layout, fn);
+        }
+
+        return ForImpl(layout, schedule, fn);
+    }
+
+    void EmitterContext::Parallelize(int numTasks, std::vector<Value> captured, std::function<void(Scalar, std::vector<Value>)> fn)
+    {
+        if (numTasks <= 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Parallelize: the number of tasks must be positive");
+        }
+
+        return ParallelizeImpl(numTasks, captured, fn);
+    }
+
     void EmitterContext::MoveData(Value& source, Value& destination) { return MoveDataImpl(source, destination); }
 
     void EmitterContext::CopyData(const Value& source, Value& destination) { return CopyDataImpl(source, destination); }
@@ -230,7 +297,8 @@ namespace value
 
     namespace
     {
-        EmitterContext* s_context = nullptr;
+        // Each thread has its own current context, so maps can be compiled on several threads at once
+        thread_local EmitterContext* s_context = nullptr;
     }
 
     EmitterContext& GetContext()
@@ -257,11 +325,34 @@ namespace value
 
     Value Allocate(ValueType type, size_t size) { return GetContext().Allocate(type, size); }
 
-    Value Allocate(ValueType type, MemoryLayout layout) { return GetContext().Allocate(type, layout); }
+    Value Allocate(ValueType type, MemoryLayout layout, size_t alignment) { return GetContext().Allocate(type, layout, alignment); }
+
+    MemoryLayout GetAlignedLayout(ValueType type, MemoryLayout layout, size_t alignment)
+    {
+        const auto elementSize = GetValueTypeSize(type);
+        if (alignment == 0 || alignment % elementSize != 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "GetAlignedLayout: the alignment must be a multiple of the element size");
+        }
+        if (layout.NumDimensions() == 0)
+        {
+            return layout;
+        }
+
+        const int rowAlignment = static_cast<int>(alignment / elementSize);
+        auto extent = layout.GetExtent().ToVector();
+        extent.back() = ((extent.back() + rowAlignment - 1) / rowAlignment) * rowAlignment;
+        return { layout.GetActiveSize(), extent, layout.GetOffset(), layout.GetLogicalDimensionOrder() };
+    }
+
+    Value StaticAllocate(std::string name, ValueType type, utilities::MemoryLayout layout, size_t alignment)
+    {
+        return GetContext().StaticAllocate(name, type, layout, alignment);
+    }
 
-    Value GlobalAllocate(std::string name, ValueType type, utilities::MemoryLayout layout)
+    Value GlobalAllocate(std::string name, ValueType type, utilities::MemoryLayout layout, size_t alignment)
     {
-        return GetContext().GlobalAllocate(name, type, layout);
+        return GetContext().GlobalAllocate(name, type, layout, alignment);
     }
 
     EmitterContext::IfContext If(Scalar test, std::function<void()> fn) { return GetContext().If(test, fn); }
@@ -10,6 +10,8 @@
 
 #include <utilities/include/Hash.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace value
@@ -87,6 +89,18 @@ namespace value
         return _returnType;
     }
 
+    std::optional<FunctionDefinitionKey> FunctionDeclaration::GetDefinitionKey() const
+    {
+        CheckNonEmpty();
+
+        if (!_bodyParameters || !_generatorType)
+        {
+            return std::nullopt;
+        }
+
+        return FunctionDefinitionKey{ *_generatorType, _generatorAddress, _returnType, _paramTypes, _bodyParameters };
+    }
+
     bool FunctionDeclaration::IsDefined() const
     {
         CheckNonEmpty();
@@ -104,6 +118,43 @@ namespace value
         }
     }
 
+    namespace
+    {
+        bool IsSameType(const Value& value1, const Value& value2)
+        {
+            if (value1.GetBaseType() != value2.GetBaseType() || value1.PointerLevel() != value2.PointerLevel() || value1.IsConstrained() != value2.IsConstrained())
+            {
+                return false;
+            }
+            return !value1.IsConstrained() || value1.GetLayout() == value2.GetLayout();
+        }
+    } // namespace
+
+    bool operator==(const FunctionDefinitionKey& key1, const FunctionDefinitionKey& key2)
+    {
+        if (key1.generatorType != key2.generatorType || key1.generatorAddress != key2.generatorAddress)
+        {
+            return false;
+        }
+
+        if (key1.returnType.has_value() != key2.returnType.has_value() || (key1.returnType && !IsSameType(*key1.returnType, *key2.returnType)))
+        {
+            return false;
+        }
+
+        if (!std::equal(key1.parameterTypes.begin(), key1.parameterTypes.end(), key2.parameterTypes.begin(), key2.parameterTypes.end(), IsSameType))
+        {
+            return false;
+        }
+
+        return key1.bodyParameters == key2.bodyParameters || (key1.bodyParameters != nullptr && key2.bodyParameters != nullptr && key1.bodyParameters->IsEqual(*key2.bodyParameters));
+    }
+
+    bool operator!=(const FunctionDefinitionKey& key1, const FunctionDefinitionKey& key2)
+    {
+        return !(key1 == key2);
+    }
+
     FunctionDeclaration DeclareFunction(std::string name)
     {
         return FunctionDeclaration(name);
@@ -129,3 +180,16 @@ size_t std::hash<::ell::value::FunctionDeclaration>::operator()(const ::ell::val
     // don't want to support overloading
     return std::hash<std::string>{}(value.GetFunctionName());
 }
+
+size_t std::hash<::ell::value::FunctionDefinitionKey>::operator()(const ::ell::value::FunctionDefinitionKey& value) const
+{
+    using ::ell::utilities::HashCombine;
+
+    size_t hash = 0;
+    HashCombine(hash, value.generatorType);
+    HashCombine(hash, value.generatorAddress);
+    HashCombine(hash, value.returnType);
+    HashCombine(hash, value.parameterTypes);
+    HashCombine(hash, value.bodyParameters ? value.bodyParameters->GetHash() : 0);
+    return hash;
+}
@@ -11,7 +11,10 @@
 #include "Scalar.h"
 #include "Value.h"
 
+#include <emitters/include/IRExternalWeights.h>
+#include <emitters/include/IRLocalScalar.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRReentrancy.h>
 
 #include <utilities/include/StringUtil.h>
 
@@ -461,6 +464,14 @@ namespace value
             context._promotedConstantStack.push({});
         }
 
+        // Enters a function that's already being emitted, like the task function of a parallel loop
+        FunctionScope(LLVMContext& context, IRFunctionEmitter& function) :
+            context(context)
+        {
+            context._functionStack.push(function);
+            context._promotedConstantStack.push({});
+        }
+
         ~FunctionScope()
         {
             context._functionStack.pop();
@@ -479,10 +490,14 @@ namespace value
 
     const IRModuleEmitter& LLVMContext::GetModuleEmitter() const { return _emitter; }
 
-    Value LLVMContext::AllocateImpl(ValueType type, MemoryLayout layout)
+    Value LLVMContext::AllocateImpl(ValueType type, MemoryLayout layout, size_t alignment)
     {
         auto llvmType = ValueTypeToLLVMType(GetFunctionEmitter().GetEmitter(), { type, 0 });
         auto allocatedVariable = GetFunctionEmitter().Variable(llvmType, layout.GetMemorySize());
+        if (alignment != 0)
+        {
+            allocatedVariable->setAlignment(static_cast<unsigned>(alignment));
+        }
 
         auto& fn = GetFunctionEmitter();
         auto& irEmitter = fn.GetEmitter();
@@ -501,7 +516,7 @@ namespace value
         return std::nullopt;
     }
 
-    Value LLVMContext::GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout)
+    Value LLVMContext::GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ConstantData data, MemoryLayout layout, size_t alignment)
     {
         std::string adjustedName = GetScopeAdjustedName(scope, name);
 
@@ -533,6 +548,10 @@ namespace value
                 }
             },
             data);
+        if (alignment != 0)
+        {
+            global->setAlignment(static_cast<unsigned>(alignment));
+        }
         auto dereferencedGlobal = _emitter.GetIREmitter().PointerOffset(global, _emitter.GetIREmitter().Literal(0));
 
         Emittable emittable{ dereferencedGlobal };
@@ -541,7 +560,7 @@ namespace value
         return Value(emittable, layout);
     }
 
-    Value LLVMContext::GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout)
+    Value LLVMContext::GlobalAllocateImpl(GlobalAllocationScope scope, std::string name, ValueType type, MemoryLayout layout, size_t alignment)
     {
         std::string adjustedName = GetScopeAdjustedName(scope, name);
 
@@ -554,6 +573,10 @@ namespace value
         auto global = _emitter.GlobalArray(adjustedName,
                                            ValueTypeToLLVMType(_emitter.GetIREmitter(), { type, 0 }),
                                            layout.GetMemorySize());
+        if (alignment != 0)
+        {
+            global->setAlignment(static_cast<unsigned>(alignment));
+        }
 
         auto dereferencedGlobal = _emitter.GetIREmitter().PointerOffset(global, _emitter.GetIREmitter().Literal(0));
 
@@ -583,6 +606,17 @@ namespace value
             return it->second;
         }
 
+        // If a function with the same definition has already been emitted, define this one as a call to it instead of emitting
+        // and compiling the same body again. The function still exists under its own name, for callers that look it up by name.
+        auto definitionKey = decl.GetDefinitionKey();
+        if (definitionKey)
+        {
+            if (auto it = _definitionCache.find(*definitionKey); it != _definitionCache.end())
+            {
+                fn = it->second;
+            }
+        }
+
         const auto& argValues = decl.GetParameterTypes();
         const auto& returnValue = decl.GetReturnType();
 
@@ -649,6 +683,10 @@ namespace value
         };
 
         _definedFunctions[decl] = returnFn;
+        if (definitionKey)
+        {
+            _definitionCache.try_emplace(*definitionKey, returnFn);
+        }
 
         return returnFn;
     }
@@ -678,6 +716,130 @@ namespace value
         } while (IncrementMemoryCoordinate(coordinate, maxCoordinate));
     }
 
+    void LLVMContext::ForImpl(MemoryLayout layout, const LoopSchedule& schedule, std::function<void(std::vector<Scalar>)> fn)
+    {
+        const auto& size = layout.GetActiveSize();
+        const auto loops = schedule.GetLoops(size);
+        const int numDimensions = size.NumDimensions();
+
+        // The body of a `For` refers to values of the enclosing function through lambda captures, so it can't be moved into
+        // a task function, and running a parallel loop serially would silently drop the request. Parallelize takes the values
+        // its tasks use explicitly.
+        if (std::any_of(loops.begin(), loops.end(), [](const ScheduledLoop& loop) { return loop.parallel; }))
+        {
+            throw LogicException(LogicExceptionErrors::notImplemented, "LLVMContext can't emit parallel loops of a LoopSchedule, use Parallelize instead");
+        }
+
+        // A split that doesn't divide its loop runs past the end of the dimension, which needs a bounds check
+        std::vector<bool> needsBoundsCheck(numDimensions);
+        {
+            std::vector<int> maxCoordinate(numDimensions, 0);
+            for (const auto& loop : loops)
+            {
+                maxCoordinate[loop.dimension] += (loop.size - 1) * loop.stride;
+            }
+            for (int dimension = 0; dimension < numDimensions; ++dimension)
+            {
+                needsBoundsCheck[dimension] = maxCoordinate[dimension] >= size[dimension];
+            }
+        }
+
+        // The coordinates passed to `fn` live in variables that are updated in the innermost loop body
+        std::vector<Value> coordinateValues;
+        for (int dimension = 0; dimension < numDimensions; ++dimension)
+        {
+            coordinateValues.push_back(AllocateImpl(ValueType::Int32, ScalarLayout, 0));
+        }
+        std::vector<Scalar> physicalCoordinates(coordinateValues.begin(), coordinateValues.end());
+        auto logicalCoordinates = physicalCoordinates;
+        const auto& dimensionOrder = layout.GetLogicalDimensionOrder();
+        for (int dimension = 0; dimension < numDimensions; ++dimension)
+        {
+            logicalCoordinates[dimensionOrder[dimension]] = physicalCoordinates[dimension];
+        }
+
+        auto& fnEmitter = GetFunctionEmitter();
+        std::vector<IRLocalScalar> indices;
+        std::function<void()> emitLoop = [&]() {
+            const auto level = indices.size();
+            if (level == loops.size())
+            {
+                std::vector<IRLocalScalar> coordinates(numDimensions, fnEmitter.LocalScalar<int>(0));
+                for (size_t loop = 0; loop < loops.size(); ++loop)
+                {
+                    coordinates[loops[loop].dimension] = coordinates[loops[loop].dimension] + indices[loop] * loops[loop].stride;
+                }
+
+                IRLocalScalar inBounds = fnEmitter.LocalScalar(fnEmitter.TrueBit());
+                for (int dimension = 0; dimension < numDimensions; ++dimension)
+                {
+                    fnEmitter.SetValueAt(ToLLVMValue(coordinateValues[dimension]), 0, coordinates[dimension]);
+                    if (needsBoundsCheck[dimension])
+                    {
+                        inBounds = fnEmitter.LocalScalar(fnEmitter.LogicalAnd(inBounds, coordinates[dimension] < size[dimension]));
+                    }
+                }
+
+                if (std::find(needsBoundsCheck.begin(), needsBoundsCheck.end(), true) != needsBoundsCheck.end())
+                {
+                    fnEmitter.If(inBounds, [&](IRFunctionEmitter&) { fn(logicalCoordinates); });
+                }
+                else
+                {
+                    fn(logicalCoordinates);
+                }
+                return;
+            }
+
+            const auto& loop = loops[level];
+            if (loop.unrolled)
+            {
+                for (int index = 0; index < loop.size; ++index)
+                {
+                    indices.push_back(fnEmitter.LocalScalar<int>(index));
+                    emitLoop();
+                    indices.pop_back();
+                }
+            }
+            else
+            {
+                fnEmitter.For(loop.size, [&](IRFunctionEmitter&, IRLocalScalar index) {
+                    indices.push_back(index);
+                    emitLoop();
+                    indices.pop_back();
+                });
+            }
+        };
+        emitLoop();
+    }
+
+    void LLVMContext::ParallelizeImpl(int numTasks, std::vector<Value> captured, std::function<void(Scalar, std::vector<Value>)> fn)
+    {
+        std::vector<LLVMValue> capturedValues;
+        for (auto& value : captured)
+        {
+            value = EnsureEmittable(value);
+            capturedValues.push_back(ToLLVMValue(value));
+        }
+
+        // One iteration of the parallel loop per task. The loop emitter moves the body into a task function run by the
+        // thread pool if the compiler options allow it, and emits a regular loop otherwise.
+        auto& fnEmitter = GetFunctionEmitter();
+        fnEmitter.ParallelFor(numTasks, ParallelLoopOptions{ numTasks }, capturedValues, [this, &captured, &fn](IRFunctionEmitter& taskFunction, IRLocalScalar taskIndex, std::vector<LLVMValue> taskValues) {
+            FunctionScope scope(*this, taskFunction);
+
+            auto taskCaptured = captured;
+            for (size_t index = 0; index < taskCaptured.size(); ++index)
+            {
+                taskCaptured[index].SetData(Emittable{ taskValues[index] });
+            }
+
+            Value taskIndexValue = AllocateImpl(ValueType::Int32, ScalarLayout, 0);
+            taskFunction.SetValueAt(ToLLVMValue(taskIndexValue), 0, taskIndex);
+            fn(taskIndexValue, taskCaptured);
+        });
+    }
+
     void LLVMContext::MoveDataImpl(Value& source, Value& destination)
     {
         // we treat a move the same as a copy, except we clear out the source
@@ -1363,6 +1525,7 @@ namespace value
                     {
                         globalVariable = _emitter.GlobalArray(globalName, data);
                     }
+                    emitters::MarkGlobalShared(*globalVariable);
 
                     return globalVariable;
                 }
@@ -1370,7 +1533,12 @@ namespace value
                 {
                     auto& fn = GetFunctionEmitter();
 
+                    // Several scopes of the same function, like the tasks of a parallel loop, each count their own promotions
                     std::string globalName = GetCurrentFunctionScopedName("_"s + std::to_string(_promotedConstantStack.top().size()));
+                    for (int suffix = 1; _emitter.GetLLVMModule()->getNamedGlobal(globalName) != nullptr; ++suffix)
+                    {
+                        globalName = GetCurrentFunctionScopedName("_"s + std::to_string(_promotedConstantStack.top().size()) + "_" + std::to_string(suffix));
+                    }
 
                     llvm::GlobalVariable* globalVariable = nullptr;
                     if constexpr (std::is_same_v<DataType, Boolean>)
@@ -1382,6 +1550,11 @@ namespace value
                     {
                         globalVariable = _emitter.GlobalArray(globalName, data);
                     }
+                    emitters::MarkGlobalShared(*globalVariable);
+
+                    // The global is only the source of the copy, so it can be constant (and moved to an external weights blob)
+                    globalVariable->setConstant(true);
+                    emitters::MarkGlobalAsWeights(*globalVariable);
 
                     auto varType =
                         GetVariableType<std::conditional_t<std::is_same_v<DataType, Boolean>, bool, DataType>>();
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LoopSchedule.cpp (value)
+//  Authors:  Kern Handa
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LoopSchedule.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace ell
+{
+namespace value
+{
+    using namespace utilities;
+
+    namespace
+    {
+        void CheckLoopIndex(const std::vector<ScheduledLoop>& loops, int loop)
+        {
+            if (loop < 0 || loop >= static_cast<int>(loops.size()))
+            {
+                throw InputException(InputExceptionErrors::indexOutOfRange, "LoopSchedule: loop index out of range");
+            }
+        }
+
+        void SplitLoop(std::vector<ScheduledLoop>& loops, int loop, int factor)
+        {
+            CheckLoopIndex(loops, loop);
+            if (factor <= 0)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "LoopSchedule: split factor must be positive");
+            }
+
+            auto inner = loops[loop];
+            if (inner.size % factor != 0)
+            {
+                // The coordinates of the last block run past the end of the loop, which is only harmless if nothing
+                // follows the loop in its dimension, i.e., it's the loop with the largest stride
+                auto isOutermost = std::none_of(loops.begin(), loops.end(), [&inner](const ScheduledLoop& other) {
+                    return other.dimension == inner.dimension && other.stride > inner.stride;
+                });
+                if (!isOutermost)
+                {
+                    throw InputException(InputExceptionErrors::invalidArgument, "LoopSchedule: split factor must divide an inner loop");
+                }
+            }
+
+            auto outer = inner;
+            outer.size = (inner.size + factor - 1) / factor;
+            outer.stride = inner.stride * factor;
+            inner.size = factor;
+            inner.parallel = false;
+            loops[loop] = outer;
+            loops.insert(loops.begin() + loop + 1, inner);
+        }
+
+        void ReorderLoops(std::vector<ScheduledLoop>& loops, const std::vector<int>& order)
+        {
+            std::vector<int> sortedOrder = order;
+            std::sort(sortedOrder.begin(), sortedOrder.end());
+            std::vector<int> identity(loops.size());
+            std::iota(identity.begin(), identity.end(), 0);
+            if (sortedOrder != identity)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "LoopSchedule: reorder must be a permutation of the loops");
+            }
+
+            std::vector<ScheduledLoop> reordered;
+            for (auto loop : order)
+            {
+                reordered.push_back(loops[loop]);
+            }
+            loops = reordered;
+        }
+    } // namespace
+
+    LoopSchedule& LoopSchedule::Split(int loop, int factor)
+    {
+        _directives.push_back({ DirectiveType::split, { loop, factor } });
+        return *this;
+    }
+
+    LoopSchedule& LoopSchedule::Tile(std::vector<int> sizes)
+    {
+        _directives.push_back({ DirectiveType::tile, sizes });
+        return *this;
+    }
+
+    LoopSchedule& LoopSchedule::Reorder(std::vector<int> order)
+    {
+        _directives.push_back({ DirectiveType::reorder, order });
+        return *this;
+    }
+
+    LoopSchedule& LoopSchedule::Unroll(int loop)
+    {
+        _directives.push_back({ DirectiveType::unroll, { loop } });
+        return *this;
+    }
+
+    LoopSchedule& LoopSchedule::Vectorize(int width)
+    {
+        _directives.push_back({ DirectiveType::vectorize, { width } });
+        return *this;
+    }
+
+    LoopSchedule& LoopSchedule::Parallel(int numTasks)
+    {
+        _directives.push_back({ DirectiveType::parallel, { numTasks } });
+        return *this;
+    }
+
+    std::vector<ScheduledLoop> LoopSchedule::GetLoops(const MemoryShape& size) const
+    {
+        std::vector<ScheduledLoop> loops;
+        for (int dimension = 0; dimension < size.NumDimensions(); ++dimension)
+        {
+            loops.push_back({ dimension, size[dimension], 1 });
+        }
+
+        for (const auto& directive : _directives)
+        {
+            const auto& arguments = directive.arguments;
+            switch (directive.type)
+            {
+            case DirectiveType::split:
+                SplitLoop(loops, arguments[0], arguments[1]);
+                break;
+
+            case DirectiveType::tile:
+            {
+                const int numLoops = static_cast<int>(arguments.size());
+                if (numLoops != static_cast<int>(loops.size()))
+                {
+                    throw InputException(InputExceptionErrors::sizeMismatch, "LoopSchedule: tile needs one size per loop");
+                }
+
+                // Split from the innermost loop out, so the positions of the loops still to be split don't change,
+                // then move the block loops [0, 2, 4, ...] outside the loops within a block [1, 3, 5, ...]
+                for (int loop = numLoops - 1; loop >= 0; --loop)
+                {
+                    SplitLoop(loops, loop, arguments[loop]);
+                }
+                std::vector<int> order;
+                for (int loop = 0; loop < numLoops; ++loop)
+                {
+                    order.push_back(2 * loop);
+                }
+                for (int loop = 0; loop < numLoops; ++loop)
+                {
+                    order.push_back(2 * loop + 1);
+                }
+                ReorderLoops(loops, order);
+                break;
+            }
+
+            case DirectiveType::reorder:
+                ReorderLoops(loops, arguments);
+                break;
+
+            case DirectiveType::unroll:
+                CheckLoopIndex(loops, arguments[0]);
+                loops[arguments[0]].unrolled = true;
+                break;
+
+            case DirectiveType::vectorize:
+            {
+                const int innermost = static_cast<int>(loops.size()) - 1;
+                SplitLoop(loops, innermost, arguments[0]);
+                loops.back().unrolled = true;
+                break;
+            }
+
+            case DirectiveType::parallel:
+            {
+                if (loops.empty() || arguments[0] <= 0)
+                {
+                    throw InputException(InputExceptionErrors::invalidArgument, "LoopSchedule: the number of tasks must be positive");
+                }
+                const int numTasks = std::min(arguments[0], loops.front().size);
+                SplitLoop(loops, 0, (loops.front().size + numTasks - 1) / numTasks);
+                loops.front().parallel = true;
+                break;
+            }
+            }
+        }
+
+        return loops;
+    }
+
+} // namespace value
+} // namespace ell
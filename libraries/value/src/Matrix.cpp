@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Matrix.h"
+#include "ComputeContext.h"
 #include "EmitterContext.h"
 
 #include <utilities/include/Exception.h>
@@ -136,9 +137,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(m, [this, &m](Scalar row, Scalar column) {
-            (*this)(row, column) += m(row, column);
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::add, _value, m.GetValue()))
+        {
+            For(m, [this, &m](Scalar row, Scalar column) {
+                (*this)(row, column) += m(row, column);
+            });
+        }
 
         return *this;
     }
@@ -155,9 +159,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(m, [this, &m](Scalar row, Scalar column) {
-            (*this)(row, column) -= m(row, column);
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::subtract, _value, m.GetValue()))
+        {
+            For(m, [this, &m](Scalar row, Scalar column) {
+                (*this)(row, column) -= m(row, column);
+            });
+        }
 
         return *this;
     }
@@ -169,9 +176,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [this, &s](Scalar row, Scalar column) {
-            (*this)(row, column) += s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::add, _value, s.GetValue()))
+        {
+            For(*this, [this, &s](Scalar row, Scalar column) {
+                (*this)(row, column) += s;
+            });
+        }
 
         return *this;
     }
@@ -183,9 +193,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [this, &s](Scalar row, Scalar column) {
-            (*this)(row, column) -= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::subtract, _value, s.GetValue()))
+        {
+            For(*this, [this, &s](Scalar row, Scalar column) {
+                (*this)(row, column) -= s;
+            });
+        }
 
         return *this;
     }
@@ -197,9 +210,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [this, &s](Scalar row, Scalar column) {
-            (*this)(row, column) *= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::multiply, _value, s.GetValue()))
+        {
+            For(*this, [this, &s](Scalar row, Scalar column) {
+                (*this)(row, column) *= s;
+            });
+        }
 
         return *this;
     }
@@ -211,9 +227,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [this, &s](Scalar row, Scalar column) {
-            (*this)(row, column) /= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::divide, _value, s.GetValue()))
+        {
+            For(*this, [this, &s](Scalar row, Scalar column) {
+                (*this)(row, column) /= s;
+            });
+        }
 
         return *this;
     }
@@ -7,9 +7,19 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "MatrixOperations.h"
+#include "ComputeContext.h"
 #include "EmitterContext.h"
+#include "LLVMContext.h"
 #include "Matrix.h"
 #include "Scalar.h"
+#include "Vector.h"
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <math/include/BlasWrapper.h>
+#include <math/include/Matrix.h>
+
+#include <algorithm>
 
 namespace ell
 {
@@ -17,8 +27,129 @@ using namespace utilities;
 
 namespace value
 {
+    namespace
+    {
+        // A matrix as BLAS sees it: a (possibly transposed) row-major matrix with a stride between rows
+        struct BlasOperand
+        {
+            Value value;
+            bool transpose;
+            int stride;
+            int offset;
+        };
+
+        BlasOperand GetBlasOperand(const Matrix& matrix)
+        {
+            auto value = matrix.GetValue();
+            const auto& layout = value.GetLayout();
+
+            // The innermost physical dimension is contiguous, so a matrix whose rows are the outer physical dimension
+            // is row-major, and anything else is the transpose of a row-major matrix
+            return { value,
+                     layout.GetLogicalDimensionOrder()[0] != 0,
+                     static_cast<int>(layout.GetCumulativeIncrement(0)),
+                     static_cast<int>(layout.GetFirstEntryOffset()) };
+        }
+
+        BlasOperand GetBlasOperand(const Vector& vector)
+        {
+            auto value = vector.GetValue();
+            const auto& layout = value.GetLayout();
+            return { value, false, static_cast<int>(layout.GetCumulativeIncrement(0)), static_cast<int>(layout.GetFirstEntryOffset()) };
+        }
+
+        // C += op(A) * op(B), where C is row-major: m x n, op(A): m x k, op(B): k x n. Returns false if there's no BLAS
+        // (or native) routine for the current context.
+        template <typename ValueType>
+        bool AccumulateBlasGEMM(const BlasOperand& A, const BlasOperand& B, const BlasOperand& C, int m, int n, int k)
+        {
+            bool done = false;
+            InvokeForContext<ComputeContext>([&](ComputeContext&) {
+                auto transpose = [](const BlasOperand& operand) {
+                    return operand.transpose ? math::MatrixTranspose::transpose : math::MatrixTranspose::noTranspose;
+                };
+                math::Blas::Gemm(math::MatrixLayout::rowMajor,
+                                 transpose(A),
+                                 transpose(B),
+                                 m,
+                                 n,
+                                 k,
+                                 static_cast<ValueType>(1),
+                                 A.value.Get<ValueType*>() + A.offset,
+                                 A.stride,
+                                 B.value.Get<ValueType*>() + B.offset,
+                                 B.stride,
+                                 static_cast<ValueType>(1),
+                                 C.value.Get<ValueType*>() + C.offset,
+                                 C.stride);
+                done = true;
+            });
+
+            InvokeForContext<LLVMContext>([&](LLVMContext& context) {
+                auto& function = context.GetFunctionEmitter();
+                auto pointer = [&](const BlasOperand& operand) {
+                    auto value = context.EnsureEmittable(operand.value);
+                    return function.PointerOffset(value.Get<Emittable>().GetDataAs<emitters::LLVMValue>(), operand.offset);
+                };
+
+                // CallGEMM uses BLAS if the compiler options allow it, and the native blocked GEMM otherwise
+                function.CallGEMM<ValueType>(A.transpose, B.transpose, m, n, k, static_cast<ValueType>(1), pointer(A), A.stride, pointer(B), B.stride, static_cast<ValueType>(1), pointer(C), C.stride);
+                done = true;
+            });
+
+            return done;
+        }
+
+        // y += op(A) * x, where op(A) is m x k
+        template <typename ValueType>
+        bool AccumulateBlasGEMV(const BlasOperand& A, const BlasOperand& x, const BlasOperand& y, int m, int k)
+        {
+            bool done = false;
+            InvokeForContext<ComputeContext>([&](ComputeContext&) {
+                // BLAS takes the size of the stored matrix, before the transpose
+                math::Blas::Gemv(math::MatrixLayout::rowMajor,
+                                 A.transpose ? math::MatrixTranspose::transpose : math::MatrixTranspose::noTranspose,
+                                 A.transpose ? k : m,
+                                 A.transpose ? m : k,
+                                 static_cast<ValueType>(1),
+                                 A.value.Get<ValueType*>() + A.offset,
+                                 A.stride,
+                                 x.value.Get<ValueType*>() + x.offset,
+                                 x.stride,
+                                 static_cast<ValueType>(1),
+                                 y.value.Get<ValueType*>() + y.offset,
+                                 y.stride);
+                done = true;
+            });
+
+            if (!done && A.transpose)
+            {
+                // The emitted GEMV routines only take row-major matrices, so treat x and y as (k x 1) and (m x 1) matrices
+                return AccumulateBlasGEMM<ValueType>(A, x, y, m, 1, k);
+            }
+
+            InvokeForContext<LLVMContext>([&](LLVMContext& context) {
+                auto& function = context.GetFunctionEmitter();
+                auto pointer = [&](const BlasOperand& operand) {
+                    auto value = context.EnsureEmittable(operand.value);
+                    return function.PointerOffset(value.Get<Emittable>().GetDataAs<emitters::LLVMValue>(), operand.offset);
+                };
+
+                function.CallGEMV<ValueType>(m, k, static_cast<ValueType>(1), pointer(A), A.stride, pointer(x), x.stride, static_cast<ValueType>(1), pointer(y), y.stride);
+                done = true;
+            });
+
+            return done;
+        }
+    } // namespace
+
     Scalar Accumulate(Matrix matrix, Scalar initialValue)
     {
+        if (auto result = detail::TryComputeAccumulate(matrix.GetValue(), initialValue))
+        {
+            return *result;
+        }
+
         Scalar result = initialValue;
 
         For(matrix, [&](auto row, auto column) {
@@ -42,9 +173,105 @@ namespace value
         });
     }
 
-    Matrix GEMM(Matrix m1, Matrix m2) { throw LogicException(LogicExceptionErrors::notImplemented); }
+    void For(Matrix matrix, const LoopSchedule& schedule, std::function<void(Scalar, Scalar)> fn)
+    {
+        auto layout = matrix.GetValue().GetLayout();
+        if (layout.NumDimensions() != 2)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument,
+                                 "Layout being looped over must be two-dimensional");
+        }
+
+        GetContext().For(layout, schedule, [fn = std::move(fn)](std::vector<Scalar> coordinates) {
+            fn(coordinates[0], coordinates[1]);
+        });
+    }
+
+    Matrix GEMM(Matrix m1, Matrix m2)
+    {
+        Matrix result = Allocate(m1.Type(), MemoryLayout({ static_cast<int>(m1.Rows()), static_cast<int>(m2.Columns()) }));
+        GEMM(m1, m2, result);
+        return result;
+    }
+
+    void GEMM(Matrix A, Matrix B, Matrix C)
+    {
+        if (A.Columns() != B.Rows() || A.Rows() != C.Rows() || B.Columns() != C.Columns())
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch);
+        }
+        if (A.Type() != B.Type() || A.Type() != C.Type())
+        {
+            throw InputException(InputExceptionErrors::typeMismatch);
+        }
+
+        int m = static_cast<int>(C.Rows());
+        int n = static_cast<int>(C.Columns());
+        const int k = static_cast<int>(A.Columns());
+        if (C.Type() == ValueType::Float || C.Type() == ValueType::Double)
+        {
+            auto a = GetBlasOperand(A);
+            auto b = GetBlasOperand(B);
+            auto c = GetBlasOperand(C);
+            if (c.transpose)
+            {
+                // C is column-major, so compute C' += B' * A' instead
+                std::swap(a, b);
+                a.transpose = !a.transpose;
+                b.transpose = !b.transpose;
+                std::swap(m, n);
+            }
 
-    Vector GEMV(Matrix m, Vector v) { throw LogicException(LogicExceptionErrors::notImplemented); }
+            auto done = C.Type() == ValueType::Float ? AccumulateBlasGEMM<float>(a, b, c, m, n, k) : AccumulateBlasGEMM<double>(a, b, c, m, n, k);
+            if (done)
+            {
+                return;
+            }
+        }
+
+        // Loop over (i, p, j), with j innermost so consecutive iterations touch consecutive elements of B and C
+        GetContext().For(MemoryLayout({ static_cast<int>(C.Rows()), k, static_cast<int>(C.Columns()) }),
+                         LoopSchedule().Vectorize(std::min(static_cast<int>(C.Columns()), 4)),
+                         [&](std::vector<Scalar> coordinates) {
+                             auto i = coordinates[0], p = coordinates[1], j = coordinates[2];
+                             C(i, j) += A(i, p) * B(p, j);
+                         });
+    }
+
+    Vector GEMV(Matrix m, Vector v)
+    {
+        Vector result = Allocate(m.Type(), MemoryLayout({ static_cast<int>(m.Rows()) }));
+        GEMV(m, v, result);
+        return result;
+    }
+
+    void GEMV(Matrix A, Vector x, Vector y)
+    {
+        if (A.Columns() != x.Size() || A.Rows() != y.Size())
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch);
+        }
+        if (A.Type() != x.GetType() || A.Type() != y.GetType())
+        {
+            throw InputException(InputExceptionErrors::typeMismatch);
+        }
+
+        const int m = static_cast<int>(A.Rows());
+        const int k = static_cast<int>(A.Columns());
+        if (A.Type() == ValueType::Float || A.Type() == ValueType::Double)
+        {
+            auto a = GetBlasOperand(A);
+            auto b = GetBlasOperand(x);
+            auto c = GetBlasOperand(y);
+            auto done = A.Type() == ValueType::Float ? AccumulateBlasGEMV<float>(a, b, c, m, k) : AccumulateBlasGEMV<double>(a, b, c, m, k);
+            if (done)
+            {
+                return;
+            }
+        }
+
+        For(A, [&](Scalar i, Scalar p) { y(i) += A(i, p) * x(p); });
+    }
 
     Matrix operator+(Matrix m1, Matrix m2)
     {
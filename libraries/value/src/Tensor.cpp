@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Tensor.h"
+#include "ComputeContext.h"
 #include "EmitterContext.h"
 
 #include <utilities/include/Exception.h>
@@ -182,9 +183,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [&, this](Scalar row, Scalar column, Scalar channel) {
-            (*this)(row, column, channel) += s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::add, _value, s.GetValue()))
+        {
+            For(*this, [&, this](Scalar row, Scalar column, Scalar channel) {
+                (*this)(row, column, channel) += s;
+            });
+        }
 
         return *this;
     }
@@ -196,9 +200,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [&, this](Scalar row, Scalar column, Scalar channel) {
-            (*this)(row, column, channel) -= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::subtract, _value, s.GetValue()))
+        {
+            For(*this, [&, this](Scalar row, Scalar column, Scalar channel) {
+                (*this)(row, column, channel) -= s;
+            });
+        }
 
         return *this;
     }
@@ -210,9 +217,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [&, this](Scalar row, Scalar column, Scalar channel) {
-            (*this)(row, column, channel) *= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::multiply, _value, s.GetValue()))
+        {
+            For(*this, [&, this](Scalar row, Scalar column, Scalar channel) {
+                (*this)(row, column, channel) *= s;
+            });
+        }
 
         return *this;
     }
@@ -224,9 +234,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [&, this](Scalar row, Scalar column, Scalar channel) {
-            (*this)(row, column, channel) /= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::divide, _value, s.GetValue()))
+        {
+            For(*this, [&, this](Scalar row, Scalar column, Scalar channel) {
+                (*this)(row, column, channel) /= s;
+            });
+        }
 
         return *this;
     }
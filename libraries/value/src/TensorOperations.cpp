@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "TensorOperations.h"
+#include "ComputeContext.h"
 #include "EmitterContext.h"
 #include "Scalar.h"
 #include "Tensor.h"
@@ -19,6 +20,11 @@ namespace value
 {
     Scalar Accumulate(Tensor tensor, Scalar initialValue)
     {
+        if (auto result = detail::TryComputeAccumulate(tensor.GetValue(), initialValue))
+        {
+            return *result;
+        }
+
         Scalar result = initialValue;
 
         For(tensor, [&](auto row, auto column, auto channel) {
@@ -42,6 +48,20 @@ namespace value
         });
     }
 
+    void For(Tensor tensor, const LoopSchedule& schedule, std::function<void(Scalar, Scalar, Scalar)> fn)
+    {
+        auto layout = tensor.GetValue().GetLayout();
+        if (layout.NumDimensions() != 3)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument,
+                                 "Layout being looped over must be three-dimensional");
+        }
+
+        GetContext().For(layout, schedule, [fn = std::move(fn)](std::vector<Scalar> coordinates) {
+            fn(coordinates[0], coordinates[1], coordinates[2]);
+        });
+    }
+
     Tensor operator+(Tensor t, Scalar s)
     {
         Tensor copy = t.Copy();
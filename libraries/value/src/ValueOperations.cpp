@@ -28,6 +28,13 @@ namespace value
         });
     }
 
+    void For(MemoryLayout layout, const LoopSchedule& schedule, std::function<void(Scalar)> fn)
+    {
+        GetContext().For(layout, schedule, [&layout, fn = std::move(fn)](std::vector<Scalar> coords) {
+            fn(detail::CalculateOffset(layout, coords));
+        });
+    }
+
     Value Cast(Value value, ValueType type)
     {
         if (value.GetBaseType() == type)
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Vector.h"
+#include "ComputeContext.h"
 #include "EmitterContext.h"
 
 namespace ell
@@ -91,9 +92,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [this, &s](Scalar index) {
-            (*this)(index) += s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::add, _value, s.GetValue()))
+        {
+            For(*this, [this, &s](Scalar index) {
+                (*this)(index) += s;
+            });
+        }
 
         return *this;
     }
@@ -110,9 +114,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(v, [this, &v](Scalar index) {
-            (*this)(index) += v(index);
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::add, _value, v.GetValue()))
+        {
+            For(v, [this, &v](Scalar index) {
+                (*this)(index) += v(index);
+            });
+        }
 
         return *this;
     }
@@ -124,9 +131,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [this, &s](Scalar index) {
-            (*this)(index) -= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::subtract, _value, s.GetValue()))
+        {
+            For(*this, [this, &s](Scalar index) {
+                (*this)(index) -= s;
+            });
+        }
 
         return *this;
     }
@@ -143,9 +153,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(v, [this, &v](Scalar index) {
-            (*this)(index) -= v(index);
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::subtract, _value, v.GetValue()))
+        {
+            For(v, [this, &v](Scalar index) {
+                (*this)(index) -= v(index);
+            });
+        }
 
         return *this;
     }
@@ -157,9 +170,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [this, &s](Scalar index) {
-            (*this)(index) *= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::multiply, _value, s.GetValue()))
+        {
+            For(*this, [this, &s](Scalar index) {
+                (*this)(index) *= s;
+            });
+        }
 
         return *this;
     }
@@ -171,9 +187,12 @@ namespace value
             throw InputException(InputExceptionErrors::typeMismatch);
         }
 
-        For(*this, [this, &s](Scalar index) {
-            (*this)(index) /= s;
-        });
+        if (!detail::TryComputeElementwise(ValueBinaryOperation::divide, _value, s.GetValue()))
+        {
+            For(*this, [this, &s](Scalar index) {
+                (*this)(index) /= s;
+            });
+        }
 
         return *this;
     }
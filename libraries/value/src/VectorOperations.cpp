@@ -26,6 +26,11 @@ namespace value
 {
     Scalar Accumulate(Vector input, Scalar initalValue)
     {
+        if (auto result = detail::TryComputeAccumulate(input.GetValue(), initalValue))
+        {
+            return *result;
+        }
+
         Scalar result = initalValue;
 
         For(input, [&](auto index) { result += input(index); });
@@ -170,6 +175,19 @@ namespace value
         GetContext().For(layout, [fn = std::move(fn)](std::vector<Scalar> coordinates) { fn(coordinates[0]); });
     }
 
+    void For(Vector v, const LoopSchedule& schedule, std::function<void(Scalar)> fn)
+    {
+        auto layout = v.GetValue().GetLayout();
+
+        if (layout.NumDimensions() != 1)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument,
+                                 "Layout being looped over must be one-dimensional");
+        }
+
+        GetContext().For(layout, schedule, [fn = std::move(fn)](std::vector<Scalar> coordinates) { fn(coordinates[0]); });
+    }
+
     Vector operator+(Scalar s, Vector v)
     {
         return v + s;
@@ -18,6 +18,7 @@ namespace ell
 void Value_test1();
 void Scalar_test1();
 void Vector_test1();
+void Vector_test1_scheduled();
 void Vector_test2();
 void Matrix_test1();
 void Matrix_test2();
@@ -32,6 +33,14 @@ void Accumulate_test();
 void Dot_test();
 void Intrinsics_test1();
 void Intrinsics_test2();
+void LoopSchedule_test1();
+void LoopSchedule_test2();
+void GEMM_test();
+void GEMV_test();
+void AlignedAllocate_test();
+void Parallelize_test();
+void ElementwiseFastPath_test();
+void FunctionDefinitionCache_test();
 
 std::vector<std::unique_ptr<value::EmitterContext>> GetContexts();
 
@@ -12,12 +12,16 @@
 #include <value/include/FunctionDeclaration.h>
 #include <value/include/LLVMContext.h>
 #include <value/include/Matrix.h>
+#include <value/include/Parallelization.h>
 #include <value/include/Tensor.h>
 #include <value/include/Value.h>
 #include <value/include/Vector.h>
 
 #include <emitters/include/IRModuleEmitter.h>
 
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+
 #include <math/include/Matrix.h>
 #include <math/include/Tensor.h>
 #include <math/include/Vector.h>
@@ -27,9 +31,11 @@
 #include <testing/include/testing.h>
 
 #include <algorithm>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -91,6 +97,20 @@ struct TestLLVMContext : public LLVMContext
 
     void DebugDump() { _emitter->DebugDump(); }
 
+    bool HasFunction(const std::string& name) { return _emitter->HasFunction(name); }
+
+    bool CallsFunction(const std::string& caller, const std::string& callee)
+    {
+        for (auto& instruction : llvm::instructions(_emitter->GetFunction(caller)))
+        {
+            if (auto call = llvm::dyn_cast<llvm::CallInst>(&instruction); call != nullptr && call->getCalledFunction() != nullptr && call->getCalledFunction()->getName() == callee)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
 private:
     std::unique_ptr<IRModuleEmitter> _emitter;
 };
@@ -337,6 +357,49 @@ void Vector_test1()
     InvokeForContext<TestLLVMContext>(PrintIR);
 }
 
+Vector testScheduledConvolve1D(Vector signal, Vector filter)
+{
+    size_t resultSize = signal.Size() - filter.Size() + 1;
+    Vector result(Allocate(signal.GetType(), resultSize));
+
+    // 14 outputs in blocks of 4, the last one partial
+    For(result, LoopSchedule().Vectorize(4), [&](Scalar index) {
+        Scalar accum;
+        For(filter, [&](Scalar filterIndex) { accum += filter(filterIndex) * signal(index + filterIndex); });
+
+        result(index) = accum;
+    });
+
+    return result;
+}
+
+void Vector_test1_scheduled()
+{
+    auto signal = Get1DReferenceSignal();
+    auto filter = Get1DReferenceFilter();
+    auto referenceResult = Get1DReferenceConvolutionResult();
+    auto valueType = GetValueType<decltype(signal)::value_type>();
+
+    auto convolve1D = DeclareFunction("testScheduledConvolve1D")
+                          .Returns({ valueType, MemoryLayout({ (int)referenceResult.size() }) })
+                          .Parameters(
+                              Value{ valueType, MemoryLayout({ (int)signal.size() }) },
+                              Value{ valueType, MemoryLayout({ (int)filter.size() }) })
+                          .Define(testScheduledConvolve1D);
+
+    InvokeForContext<ComputeContext>([&](auto&) {
+        bool ok = true;
+        Vector result = convolve1D(signal, filter);
+        For(result, [&](Scalar index) {
+            auto indexInt = index.Get<int>();
+            ok &= testing::IsEqual(referenceResult[indexInt], result[index].Get<double>());
+        });
+        testing::ProcessTest("Testing scheduled 1D convolution with Vector", ok);
+    });
+
+    InvokeForContext<TestLLVMContext>(PrintIR);
+}
+
 void Vector_test2()
 {
     auto fn = DeclareFunction("Vector_test2")
@@ -1172,4 +1235,375 @@ void Intrinsics_test2()
         });
 }
 
+void LoopSchedule_test1()
+{
+    // Visits every coordinate of the loop nest, and checks each coordinate of the layout is visited exactly once
+    auto visitsEachCoordinateOnce = [](const std::vector<ScheduledLoop>& loops, std::vector<int> size) {
+        std::map<std::vector<int>, int> visits;
+        std::vector<int> indices(loops.size(), 0);
+        while (true)
+        {
+            std::vector<int> coordinate(size.size(), 0);
+            for (size_t loop = 0; loop < loops.size(); ++loop)
+            {
+                coordinate[loops[loop].dimension] += indices[loop] * loops[loop].stride;
+            }
+            bool inBounds = true;
+            for (size_t dimension = 0; dimension < size.size(); ++dimension)
+            {
+                inBounds &= coordinate[dimension] < size[dimension];
+            }
+            if (inBounds)
+            {
+                ++visits[coordinate];
+            }
+
+            int loop = static_cast<int>(loops.size()) - 1;
+            for (; loop >= 0; --loop)
+            {
+                if (++indices[loop] < loops[loop].size)
+                {
+                    break;
+                }
+                indices[loop] = 0;
+            }
+            if (loop < 0)
+            {
+                break;
+            }
+        }
+
+        int numElements = std::accumulate(size.begin(), size.end(), 1, std::multiplies<int>());
+        return static_cast<int>(visits.size()) == numElements &&
+               std::all_of(visits.begin(), visits.end(), [](const auto& visit) { return visit.second == 1; });
+    };
+
+    bool ok = true;
+    {
+        auto loops = LoopSchedule().Split(0, 4).GetLoops({ 10 });
+        ok &= testing::IsEqual(static_cast<int>(loops.size()), 2);
+        ok &= testing::IsEqual(loops[0].size, 3);
+        ok &= testing::IsEqual(loops[0].stride, 4);
+        ok &= testing::IsEqual(loops[1].size, 4);
+        ok &= visitsEachCoordinateOnce(loops, { 10 });
+    }
+    {
+        auto loops = LoopSchedule().Tile({ 4, 8 }).GetLoops({ 12, 20 });
+        ok &= testing::IsEqual(static_cast<int>(loops.size()), 4);
+        ok &= testing::IsEqual(loops[0].dimension, 0);
+        ok &= testing::IsEqual(loops[1].dimension, 1);
+        ok &= testing::IsEqual(loops[2].dimension, 0);
+        ok &= testing::IsEqual(loops[3].dimension, 1);
+        ok &= testing::IsEqual(loops[3].stride, 1);
+        ok &= visitsEachCoordinateOnce(loops, { 12, 20 });
+    }
+    {
+        auto loops = LoopSchedule().Reorder({ 1, 0 }).Vectorize(4).Unroll(1).GetLoops({ 5, 6 });
+        ok &= testing::IsEqual(static_cast<int>(loops.size()), 3);
+        ok &= testing::IsEqual(loops[0].dimension, 1);
+        ok &= testing::IsEqual(loops[1].dimension, 0);
+        ok &= loops[1].unrolled && loops[2].unrolled && !loops[0].unrolled;
+        ok &= visitsEachCoordinateOnce(loops, { 5, 6 });
+    }
+    {
+        auto loops = LoopSchedule().Parallel(3).Vectorize(8).GetLoops({ 100, 30 });
+        ok &= loops[0].parallel && !loops[1].parallel;
+        ok &= testing::IsEqual(loops[0].size, 3);
+        ok &= visitsEachCoordinateOnce(loops, { 100, 30 });
+    }
+    testing::ProcessTest("Testing LoopSchedule loop nests", ok);
+
+    bool threw = false;
+    try
+    {
+        // An inner loop may only be split evenly
+        LoopSchedule().Split(0, 4).Split(1, 3).GetLoops({ 16 });
+    }
+    catch (const InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("Testing LoopSchedule rejects an uneven split of an inner loop", threw);
+}
+
+void LoopSchedule_test2()
+{
+    auto fn = DeclareFunction("LoopSchedule_test2")
+                  .Parameters(Value{ ValueType::Int32, MemoryLayout{ { 7, 10 } } })
+                  .Define([](Matrix m) {
+                      For(m, LoopSchedule().Tile({ 2, 4 }).Unroll(3), [&](Scalar row, Scalar column) {
+                          m(row, column) = row * 10 + column;
+                      });
+                  });
+
+    InvokeForContext<ComputeContext>([&](auto&) {
+        std::vector<int> data(70);
+        std::iota(data.begin(), data.end(), 0);
+        Matrix m(Value(std::vector<int>(70), MemoryLayout{ { 7, 10 } }));
+        fn(m);
+
+        bool ok = true;
+        For(m, [&](Scalar row, Scalar column) {
+            ok &= testing::IsEqual(m(row, column).Get<int>(), data[row.Get<int>() * 10 + column.Get<int>()]);
+        });
+        testing::ProcessTest("Testing scheduled For over a Matrix", ok);
+    });
+
+    InvokeForContext<TestLLVMContext>(PrintIR);
+}
+
+void GEMM_test()
+{
+    // A: 3 x 4, B: 4 x 5, C: 3 x 5, with C accumulated into
+    const int m = 3, k = 4, n = 5;
+    std::vector<double> aData(m * k), bData(k * n), cData(m * n);
+    std::iota(aData.begin(), aData.end(), 1.0);
+    std::iota(bData.begin(), bData.end(), -3.0);
+    std::iota(cData.begin(), cData.end(), 0.5);
+    std::vector<double> expected(m * n);
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            double sum = cData[i * n + j];
+            for (int p = 0; p < k; ++p)
+            {
+                sum += aData[i * k + p] * bData[p * n + j];
+            }
+            expected[i * n + j] = sum;
+        }
+    }
+
+    auto fn = DeclareFunction("GEMM_test")
+                  .Parameters(Value{ ValueType::Double, MemoryLayout{ { m, k } } },
+                              Value{ ValueType::Double, MemoryLayout{ { n, k }, DimensionOrder{ 1, 0 } } },
+                              Value{ ValueType::Double, MemoryLayout{ { m, n } } },
+                              Value{ ValueType::Double, MemoryLayout{ { n, m }, DimensionOrder{ 1, 0 } } })
+                  .Define([](Matrix A, Matrix B, Matrix C, Matrix columnMajorC) {
+                      GEMM(A, B, C);
+                      GEMM(A, B, columnMajorC);
+                  });
+
+    InvokeForContext<ComputeContext>([&](auto&) {
+        // B is column-major, so its data is stored transposed
+        std::vector<double> bColumnMajorData(k * n), cColumnMajorData(m * n);
+        for (int p = 0; p < k; ++p)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                bColumnMajorData[j * k + p] = bData[p * n + j];
+            }
+        }
+        for (int i = 0; i < m; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                cColumnMajorData[j * m + i] = cData[i * n + j];
+            }
+        }
+
+        Matrix A(Value(aData, MemoryLayout{ { m, k } }));
+        Matrix B(Value(bColumnMajorData, MemoryLayout{ { n, k }, DimensionOrder{ 1, 0 } }));
+        Matrix C(Value(cData, MemoryLayout{ { m, n } }));
+        Matrix columnMajorC(Value(cColumnMajorData, MemoryLayout{ { n, m }, DimensionOrder{ 1, 0 } }));
+        fn(A, B, C, columnMajorC);
+
+        bool ok = true;
+        For(C, [&](Scalar row, Scalar column) {
+            auto index = row.Get<int>() * n + column.Get<int>();
+            ok &= testing::IsEqual(C(row, column).Get<double>(), expected[index]);
+            ok &= testing::IsEqual(columnMajorC(row, column).Get<double>(), expected[index]);
+        });
+        testing::ProcessTest("Testing accumulating GEMM", ok);
+
+        // Integers use the loop nest
+        DeclareFunction("GEMM_test_int").Define([]() -> void {
+            Matrix intA(std::vector<std::vector<int>>{ { 1, 2 }, { 3, 4 } });
+            Matrix intB(std::vector<std::vector<int>>{ { 5, 6 }, { 7, 8 } });
+            Matrix intC = GEMM(intA, intB);
+            testing::ProcessTest("Testing integer GEMM",
+                                 testing::IsEqual(intC(0, 0).Get<int>(), 19) && testing::IsEqual(intC(0, 1).Get<int>(), 22) &&
+                                     testing::IsEqual(intC(1, 0).Get<int>(), 43) && testing::IsEqual(intC(1, 1).Get<int>(), 50));
+        })();
+    });
+
+    InvokeForContext<TestLLVMContext>(PrintIR);
+}
+
+void GEMV_test()
+{
+    auto fn = DeclareFunction("GEMV_test")
+                  .Parameters(Value{ ValueType::Float, MemoryLayout{ { 2, 3 } } },
+                              Value{ ValueType::Float, MemoryLayout{ { 3, 2 }, DimensionOrder{ 1, 0 } } },
+                              Value{ ValueType::Float, MemoryLayout{ { 3 } } },
+                              Value{ ValueType::Float, MemoryLayout{ { 2 } } },
+                              Value{ ValueType::Float, MemoryLayout{ { 2 } } })
+                  .Define([](Matrix A, Matrix columnMajorA, Vector x, Vector y, Vector columnMajorY) {
+                      GEMV(A, x, y);
+                      GEMV(columnMajorA, x, columnMajorY);
+                  });
+
+    InvokeForContext<ComputeContext>([&](auto&) {
+        Matrix A(Value(std::vector<float>{ 1, 2, 3, 4, 5, 6 }, MemoryLayout{ { 2, 3 } }));
+        Matrix columnMajorA(Value(std::vector<float>{ 1, 4, 2, 5, 3, 6 }, MemoryLayout{ { 3, 2 }, DimensionOrder{ 1, 0 } }));
+        Vector x(std::vector<float>{ 1, -1, 2 });
+        Vector y(std::vector<float>{ 10, 20 });
+        Vector columnMajorY(std::vector<float>{ 10, 20 });
+        fn(A, columnMajorA, x, y, columnMajorY);
+
+        // [1 2 3; 4 5 6] * [1 -1 2] = [5 11]
+        bool ok = testing::IsEqual(y(0).Get<float>(), 15.0f) && testing::IsEqual(y(1).Get<float>(), 31.0f);
+        ok &= testing::IsEqual(columnMajorY(0).Get<float>(), 15.0f) && testing::IsEqual(columnMajorY(1).Get<float>(), 31.0f);
+        testing::ProcessTest("Testing accumulating GEMV", ok);
+    });
+
+    InvokeForContext<TestLLVMContext>(PrintIR);
+}
+
+void AlignedAllocate_test()
+{
+    bool ok = true;
+    {
+        auto layout = GetAlignedLayout(ValueType::Float, MemoryLayout({ 3, 5 }), 32);
+        ok &= testing::IsEqual(layout.GetActiveSize().ToVector(), std::vector<int>{ 3, 5 });
+        ok &= testing::IsEqual(layout.GetExtent().ToVector(), std::vector<int>{ 3, 8 });
+        ok &= testing::IsEqual(static_cast<int>(layout.GetCumulativeIncrement(0)), 8);
+    }
+    {
+        auto layout = GetAlignedLayout(ValueType::Double, MemoryLayout({ 4, 6 }, DimensionOrder{ 1, 0 }), 16);
+        ok &= testing::IsEqual(layout.GetExtent().ToVector(), std::vector<int>{ 4, 6 });
+        ok &= testing::IsEqual(layout.GetLogicalDimensionOrder().ToVector(), std::vector<int>{ 1, 0 });
+    }
+    testing::ProcessTest("Testing GetAlignedLayout", ok);
+
+    InvokeForContext<ComputeContext>([&](auto&) {
+        DeclareFunction("AlignedAllocate_test").Define([]() -> void {
+            auto layout = GetAlignedLayout(ValueType::Int32, MemoryLayout({ 2, 3 }), 16);
+            Matrix m = Allocate(ValueType::Int32, layout, 16);
+            m(1, 2) = 7;
+            testing::ProcessTest("Testing aligned Allocate", testing::IsEqual(m.Rows(), 2u) && testing::IsEqual(m.Columns(), 3u) && testing::IsEqual(m(1, 2).Get<int>(), 7));
+
+            bool threw = false;
+            try
+            {
+                Allocate(ValueType::Int32, layout, 12);
+            }
+            catch (const utilities::InputException&)
+            {
+                threw = true;
+            }
+            testing::ProcessTest("Testing Allocate rejects an alignment that isn't a power of 2", threw);
+        })();
+    });
+
+    InvokeForContext<TestLLVMContext>(PrintIR);
+}
+
+void Parallelize_test()
+{
+    constexpr int numTasks = 4;
+    constexpr int taskSize = 3;
+    auto fn = DeclareFunction("Parallelize_test")
+                  .Parameters(Value{ ValueType::Int32, MemoryLayout{ { numTasks * taskSize } } },
+                              Value{ ValueType::Int32, MemoryLayout{ { numTasks * taskSize } } })
+                  .Define([](Vector input, Vector output) {
+                      Parallelize(numTasks, std::tuple{ input, output }, [](Scalar task, Vector input, Vector output) {
+                          Scalar begin = task * taskSize;
+                          For(MemoryLayout{ { taskSize } }, [&](Scalar index) {
+                              output(begin + index) = input(begin + index) * 2 + task;
+                          });
+                      });
+                  });
+
+    InvokeForContext<ComputeContext>([&](auto&) {
+        std::vector<int> inputData(numTasks * taskSize);
+        std::iota(inputData.begin(), inputData.end(), 0);
+        Vector input(inputData);
+        Vector output(std::vector<int>(numTasks * taskSize));
+        fn(input, output);
+
+        bool ok = true;
+        for (int index = 0; index < numTasks * taskSize; ++index)
+        {
+            ok &= testing::IsEqual(output(index).Get<int>(), 2 * index + index / taskSize);
+        }
+        testing::ProcessTest("Testing Parallelize", ok);
+    });
+
+    InvokeForContext<TestLLVMContext>(PrintIR);
+}
+
+void ElementwiseFastPath_test()
+{
+    InvokeForContext<ComputeContext>([&](auto&) {
+        DeclareFunction("ElementwiseFastPath_test").Define([]() -> void {
+            Matrix rowMajor(std::vector<std::vector<int>>{ { 1, 2, 3 }, { 4, 5, 6 } });
+            Matrix columnMajor = Allocate(ValueType::Int32, MemoryLayout({ 2, 3 }, DimensionOrder{ 1, 0 }));
+            columnMajor += Scalar(1);
+            columnMajor *= Scalar(2);
+            columnMajor += rowMajor;
+
+            bool ok = true;
+            For(rowMajor, [&](Scalar row, Scalar column) {
+                ok &= testing::IsEqual(columnMajor(row, column).Get<int>(), rowMajor(row, column).Get<int>() + 2);
+            });
+            testing::ProcessTest("Testing elementwise operators on matrices with different layouts", ok);
+
+            Vector padded = Allocate(ValueType::Int32, MemoryLayout(MemoryShape{ 3 }, MemoryShape{ 4 }, MemoryShape{ 1 }));
+            padded += Scalar(2);
+            testing::ProcessTest("Testing Accumulate of padded data",
+                                 testing::IsEqual(Accumulate(padded, Scalar(1)).Get<int>(), 7) &&
+                                     testing::IsEqual(Accumulate(rowMajor, Scalar(0)).Get<int>(), 21));
+        })();
+    });
+
+    InvokeForContext<TestLLVMContext>(PrintIR);
+}
+
+void FunctionDefinitionCache_test()
+{
+    auto declare = [](std::string name, int scale) {
+        return DeclareFunction(name)
+            .Parameters(Value{ ValueType::Int32, MemoryLayout{ { 4 } } })
+            .BodyParameters("scale", scale);
+    };
+    auto define = [](value::FunctionDeclaration& decl, int scale) {
+        return decl.Define([scale](Vector v) { v *= Scalar(scale); });
+    };
+
+    auto scale2 = declare("FunctionDefinitionCache_test_scale2", 2);
+    auto otherScale2 = declare("FunctionDefinitionCache_test_otherScale2", 2);
+    auto scale3 = declare("FunctionDefinitionCache_test_scale3", 3);
+    auto add2 = declare("FunctionDefinitionCache_test_add2", 2);
+    auto scale2Fn = define(scale2, 2);
+    auto otherScale2Fn = define(otherScale2, 2);
+    auto scale3Fn = define(scale3, 3);
+    auto add2Fn = add2.Define([](Vector v) { v += Scalar(2); });
+
+    testing::ProcessTest("Testing FunctionDeclaration::GetDefinitionKey",
+                         testing::IsTrue(*scale2.GetDefinitionKey() == *otherScale2.GetDefinitionKey()) &&
+                             testing::IsTrue(std::hash<FunctionDefinitionKey>{}(*scale2.GetDefinitionKey()) == std::hash<FunctionDefinitionKey>{}(*otherScale2.GetDefinitionKey())) &&
+                             testing::IsFalse(*scale2.GetDefinitionKey() == *scale3.GetDefinitionKey()) &&
+                             testing::IsFalse(*scale2.GetDefinitionKey() == *add2.GetDefinitionKey()) &&
+                             testing::IsFalse(DeclareFunction("FunctionDefinitionCache_test").GetDefinitionKey().has_value()));
+
+    InvokeForContext<ComputeContext>([&](auto&) {
+        Vector v(std::vector<int>{ 1, 2, 3, 4 });
+        scale2Fn(v);
+        otherScale2Fn(v);
+        scale3Fn(v);
+        add2Fn(v);
+        testing::ProcessTest("Testing functions sharing body parameters", testing::IsEqual(v(3).Get<int>(), 50));
+    });
+
+    InvokeForContext<TestLLVMContext>([&](TestLLVMContext& context) {
+        testing::ProcessTest("Testing LLVMContext reuses emitted functions with the same definition key",
+                             context.HasFunction(otherScale2.GetFunctionName()) &&
+                                 context.CallsFunction(otherScale2.GetFunctionName(), scale2.GetFunctionName()) &&
+                                 !context.CallsFunction(scale3.GetFunctionName(), scale2.GetFunctionName()) &&
+                                 !context.CallsFunction(add2.GetFunctionName(), scale2.GetFunctionName()));
+        PrintIR(context);
+    });
+}
+
 } // namespace ell
@@ -29,6 +29,7 @@ int main()
             Value_test1();
             Scalar_test1();
             Vector_test1();
+            Vector_test1_scheduled();
             Vector_test2();
             Matrix_test1();
             Matrix_test2();
@@ -42,6 +43,14 @@ int main()
             Dot_test();
             Intrinsics_test1();
             Intrinsics_test2();
+            LoopSchedule_test1();
+            LoopSchedule_test2();
+            GEMM_test();
+            GEMV_test();
+            AlignedAllocate_test();
+            Parallelize_test();
+            ElementwiseFastPath_test();
+            FunctionDefinitionCache_test();
         }
     }
     catch (const std::exception& exception)
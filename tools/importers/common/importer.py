@@ -383,19 +383,31 @@ class ImporterEngine:
     def get_padding_for_node(self, node: ImporterNode, nodes: typing.Mapping[str, typing.Any]):
         """
         Returns padding for a node.
+        When the node's output is used by several nodes that want different
+        padding, Convolution nodes can add a ReorderDataNode to re-pad their
+        input but other nodes can't, so the padding wanted by the first of
+        the other nodes is used. If all of them are convolutions, the padding
+        that most of them want is used, so that the fewest reorders are added.
         """
         padding = None
         if node.outputs:
-            # Find the node whose input is this node's output. A special case
+            # Find the nodes whose input is this node's output. A special case
             # exists if node is used to splice or concatenate output, since
             # the padding info needs to come from the next downstream node.
-            next_nodes = self.find_nodes_with_input(node.outputs[0], nodes)
-            if next_nodes:
-                if next_nodes[0]:
-                    if next_nodes[0].operation_type in ("Splice", "Reorder", "Passthrough"):
-                        padding = self.get_padding_for_node(next_nodes[0], nodes)
-                    else:
-                        padding = next_nodes[0].padding
+            next_nodes = [n for n in self.find_nodes_with_input(node.outputs[0], nodes) if n.operation_type != "Skip"]
+            fixed_paddings = []
+            convolution_paddings = []
+            for next_node in next_nodes:
+                if next_node.operation_type in ("Splice", "Reorder", "Passthrough"):
+                    fixed_paddings.append(self.get_padding_for_node(next_node, nodes))
+                elif next_node.operation_type in ("Convolution", "BinaryConvolution") and next_node.padding:
+                    convolution_paddings.append(next_node.padding)
+                else:
+                    fixed_paddings.append(next_node.padding)
+            if fixed_paddings:
+                padding = fixed_paddings[0]
+            elif convolution_paddings:
+                padding = max(convolution_paddings, key=convolution_paddings.count)
         return padding
 
     def set_output_padding_for_nodes(self, nodes: typing.Mapping[str, ImporterNode]):
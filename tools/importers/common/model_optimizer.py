@@ -0,0 +1,238 @@
+####################################################################################################
+#
+# Project:  Embedded Learning Library (ELL)
+# File:     model_optimizer.py (importers)
+# Authors:  Chris Lovett
+#
+# Requires: Python 3.5+
+#
+####################################################################################################
+
+import logging
+import os
+import sys
+import typing
+
+import numpy as np
+
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__))))
+
+from converters import ImporterNode
+
+_logger = logging.getLogger(__name__)
+
+
+class ImporterModelOptimizer:
+    """
+    Rewrites an ImporterModel before the ImporterEngine converts it, so the ELL model does less work at runtime:
+    - BatchNormalization, and scaling or shifting each channel by a constant, that follow a Convolution are
+      folded into the convolution's weights and bias.
+    - Chains of elementwise multiplies (or adds) by constants are merged into a single operation.
+    - Constant nodes that nothing uses any more are removed.
+    """
+    def __init__(self, model):
+        self.model = model
+
+    def optimize(self):
+        """
+        Applies all the optimizations to the model, and returns it.
+        """
+        self.fold_into_convolutions()
+        self.merge_constant_chains()
+        self.remove_unused_constants()
+        return self.model
+
+    def fold_into_convolutions(self):
+        """
+        Folds per-channel affine operations (BatchNormalization, or ElementwiseMul, Plus and Subtract with a
+        constant) into the weights and bias of the Convolution that produces their input.
+        """
+        for node in list(self.model.nodes.values()):
+            if node.id not in self.model.nodes:
+                continue
+            convolution = self.get_foldable_producer(node, ("Convolution",))
+            if convolution is None or "weights" not in convolution.weights or \
+                    "activation" in convolution.attributes:
+                continue
+            affine = self.get_channel_affine(node, convolution.output_shapes[0])
+            if affine is None:
+                continue
+            _logger.info("Folding {}({}) into Convolution({})".format(node.operation_type, node.id, convolution.id))
+            self.fold_affine_into_convolution(convolution, affine[0], affine[1])
+            self.remove_node(node, convolution)
+
+    def merge_constant_chains(self):
+        """
+        Merges an ElementwiseMul (or Plus) by a constant whose input is another ElementwiseMul (or Plus) by a
+        constant of the same shape into a single operation.
+        """
+        combine = {"ElementwiseMul": np.multiply, "Plus": np.add}
+        for node in list(self.model.nodes.values()):
+            if node.id not in self.model.nodes or node.operation_type not in combine:
+                continue
+            producer = self.get_foldable_producer(node, (node.operation_type,))
+            if producer is None:
+                continue
+            constant_id = self.get_constant_input(node)
+            producer_constant_id = self.get_constant_input(producer)
+            if constant_id is None or producer_constant_id is None:
+                continue
+            constant = np.asarray(self.get_tensor(constant_id))
+            producer_constant = np.asarray(self.get_tensor(producer_constant_id))
+            if constant.shape != producer_constant.shape:
+                continue
+            _logger.info("Merging {}({}) into {}({})".format(
+                node.operation_type, node.id, producer.operation_type, producer.id))
+            merged = combine[node.operation_type](producer_constant, constant).astype(producer_constant.dtype)
+            merged_id = self.add_constant_node("{}_merged_constant".format(producer.id), merged,
+                                               self.model.tensors[producer_constant_id][1])
+            producer.inputs = [merged_id if x == producer_constant_id else x for x in producer.inputs]
+            self.remove_node(node, producer)
+
+    def remove_unused_constants(self):
+        """
+        Removes Constant nodes whose outputs aren't an input of any node that gets converted.
+        """
+        used = set()
+        for node in self.model.nodes.values():
+            if node.operation_type != "Skip":
+                used.update(node.inputs)
+        for key in list(self.model.nodes.keys()):
+            node = self.model.nodes[key]
+            if node.operation_type == "Constant" and not any(o in used for o in node.outputs):
+                del self.model.nodes[key]
+
+    def get_foldable_producer(self, node: ImporterNode, operation_types: typing.Sequence[str]):
+        """
+        Returns the node producing the single non-constant input of 'node', if it has one of the operation
+        types and 'node' is the only node using its output. Otherwise returns None.
+        """
+        inputs = [x for x in node.inputs if x not in self.model.tensors]
+        if len(inputs) != 1 or len(node.outputs) != 1:
+            return None
+        producer = self.get_producer(inputs[0])
+        if producer is None or producer.operation_type not in operation_types or len(producer.outputs) != 1:
+            return None
+        if [n.id for n in self.get_consumers(producer.outputs[0])] != [node.id]:
+            return None
+        return producer
+
+    def get_channel_affine(self, node: ImporterNode, shape_entry):
+        """
+        Returns (scale, shift) vectors with one entry per channel, if 'node' computes
+        output[c] = input[c] * scale[c] + shift[c] on an input of the given shape. Otherwise returns None.
+        """
+        shape, order = shape_entry
+        if order != "channel_row_column" or len(shape) != 3:
+            return None
+        channels = shape[0]
+        if node.operation_type == "BatchNormalization":
+            if node.inputs[0] in self.model.tensors:
+                return None
+            weights = [self.get_weight(node, name) if name in node.weights else default
+                       for name, default in (("mean", None), ("variance", None),
+                                             ("scale", np.ones(channels)), ("bias", np.zeros(channels)))]
+            if any(w is None or np.size(w) != channels for w in weights):
+                return None
+            mean, variance, scale, bias = [np.asarray(w, dtype=np.float64).ravel() for w in weights]
+            # Use the same epsilon as ConvertBatchNormalization
+            epsilon = node.attributes.get("epsilon", 1e-5)
+            multiplier = scale / np.sqrt(variance + epsilon)
+            return (multiplier, bias - mean * multiplier)
+
+        constant_id = self.get_constant_input(node)
+        if constant_id is None:
+            return None
+        vector = self.get_channel_vector(self.get_tensor(constant_id), shape)
+        if vector is None:
+            return None
+        if node.operation_type == "ElementwiseMul":
+            return (vector, np.zeros(channels))
+        if node.operation_type == "Plus":
+            return (np.ones(channels), vector)
+        if node.operation_type == "Subtract" and node.inputs[1] == constant_id:
+            return (np.ones(channels), -vector)
+        return None
+
+    def get_channel_vector(self, tensor, shape):
+        """
+        Returns the per-channel values of a constant that's broadcast to a (channel, row, column) shape, or
+        None if it isn't the same across rows and columns.
+        """
+        if tensor is None:
+            return None
+        tensor = np.asarray(tensor, dtype=np.float64)
+        while tensor.ndim > len(shape) and tensor.shape[0] == 1:
+            tensor = tensor[0]
+        try:
+            tensor = np.broadcast_to(tensor, shape)
+        except ValueError:
+            return None
+        if not np.all(tensor == tensor[:, :1, :1]):
+            return None
+        return np.array(tensor[:, 0, 0])
+
+    def fold_affine_into_convolution(self, convolution: ImporterNode, scale, shift):
+        """
+        Replaces the weights and bias of a convolution so that its output is scaled and shifted per channel.
+        """
+        weights_id = convolution.weights["weights"][0]
+        weights, order = self.model.tensors[weights_id]
+        scale_shape = (-1,) + (1,) * (weights.ndim - 1)
+        weights = (weights * scale.reshape(scale_shape)).astype(weights.dtype)
+        if "bias" in convolution.weights:
+            bias = np.asarray(self.get_weight(convolution, "bias"), dtype=np.float64).ravel()
+        else:
+            bias = np.zeros(scale.size)
+        bias = (bias * scale + shift).astype(weights.dtype)
+
+        folded_weights_id = "{}_folded_weights".format(convolution.id)
+        folded_bias_id = "{}_folded_bias".format(convolution.id)
+        self.model.add_tensor(folded_weights_id, weights, order)
+        self.model.add_tensor(folded_bias_id, bias, "channel")
+        convolution.weights = dict(convolution.weights)
+        convolution.weights["weights"] = (folded_weights_id, weights, order)
+        convolution.weights["bias"] = (folded_bias_id, bias, "channel")
+
+    def remove_node(self, node: ImporterNode, producer: ImporterNode):
+        """
+        Removes a node whose work has been folded into the node producing its input. The producer takes over
+        the node's outputs.
+        """
+        producer.outputs = list(node.outputs)
+        producer.output_shapes = list(node.output_shapes)
+        del self.model.nodes[node.id]
+
+    def add_constant_node(self, id: str, tensor, order: str):
+        """
+        Adds a tensor to the model along with the Constant node that outputs it, and returns its id.
+        """
+        self.model.add_tensor(id, tensor, order)
+        node = ImporterNode(id=id, operation_type="Constant", inputs=[], outputs=[id],
+                            attributes={"tensor": tensor}, input_shapes=[], output_shapes=[(tensor.shape, order)])
+        self.model.add_node(id, node)
+        return id
+
+    def get_constant_input(self, node: ImporterNode):
+        """
+        Returns the id of the single constant input of a binary operation, or None.
+        """
+        constants = [x for x in node.inputs if x in self.model.tensors]
+        if len(node.inputs) != 2 or len(constants) != 1:
+            return None
+        return constants[0]
+
+    def get_tensor(self, id: str):
+        return self.model.tensors[id][0] if id in self.model.tensors else None
+
+    def get_weight(self, node: ImporterNode, name: str):
+        return self.get_tensor(node.weights[name][0])
+
+    def get_producer(self, output_id: str):
+        for node in self.model.nodes.values():
+            if node.operation_type != "Skip" and output_id in node.outputs:
+                return node
+        return None
+
+    def get_consumers(self, output_id: str):
+        return [n for n in self.model.nodes.values() if n.operation_type != "Skip" and output_id in n.inputs]
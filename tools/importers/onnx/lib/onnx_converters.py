@@ -1432,8 +1432,30 @@ ONNX_OP_TYPE_TO_CONVERTER_MAP  = {
     "Squeeze"                 : OnnxSqueezeConverter
 }
 
+# Functions that compute the output of an ONNX operation whose inputs are all constant, so the output can be
+# stored as a tensor at import time instead of being computed by the ELL model.
+ONNX_OP_TYPE_TO_CONSTANT_FOLDING_FUNCTION = {
+    "Abs"                     : lambda node, x: np.abs(x),
+    "Add"                     : lambda node, x, y: x + y,
+    "Cos"                     : lambda node, x: np.cos(x),
+    "Dropout"                 : lambda node, x: x,
+    "Exp"                     : lambda node, x: np.exp(x),
+    "Flatten"                 : lambda node, x: np.reshape(x, node.output_shapes[0][0]),
+    "Identity"                : lambda node, x: x,
+    "Log"                     : lambda node, x: np.log(x),
+    "Mul"                     : lambda node, x, y: x * y,
+    "Relu"                    : lambda node, x: np.maximum(x, 0),
+    "Reshape"                 : lambda node, x, shape: np.reshape(x, node.output_shapes[0][0]),
+    "Sigmoid"                 : lambda node, x: 1 / (1 + np.exp(-x)),
+    "Sin"                     : lambda node, x: np.sin(x),
+    "Sqrt"                    : lambda node, x: np.sqrt(x),
+    "Sub"                     : lambda node, x, y: x - y,
+    "Tanh"                    : lambda node, x: np.tanh(x),
+}
+
 class OnnxConverter:
-    def __init__(self):
+    def __init__(self, fold_constants=True):
+        self.fold_constants = fold_constants
         self.model = None
         self.input_tensors = None
         self.next_name = 0
@@ -1507,6 +1529,8 @@ class OnnxConverter:
             # processed before this node is processed... fortunately the onnx graph.node
             # list is already sorted topologically.
             node = self.get_converter(onnx_node).convert(onnx_node)
+            if self.fold_constants:
+                self.fold_constant_node(node)
             self.add_node(node)
 
         return self.model
@@ -1531,6 +1555,31 @@ class OnnxConverter:
         self.model.add_node(node.id, node)
         self.output_shapes[node.id] = node.output_shapes[0]
 
+    def fold_constant_node(self, node):
+        """
+        If all the inputs of the node are constant, compute its output now and turn it into a Constant node,
+        so that nodes using it see a tensor (e.g. weights) rather than an operation to run.
+        """
+        if node.operation_type in ("Skip", "Constant") or len(node.inputs) == 0 or len(node.outputs) != 1:
+            return
+        op_type = node.onnx_node.op_type
+        if op_type not in ONNX_OP_TYPE_TO_CONSTANT_FOLDING_FUNCTION:
+            return
+        if not all(self.is_tensor(x) for x in node.inputs):
+            return
+        inputs = [np.asarray(self.get_tensor(x)[0]) for x in node.inputs]
+        tensor = np.asarray(ONNX_OP_TYPE_TO_CONSTANT_FOLDING_FUNCTION[op_type](node, *inputs))
+        _logger.info("Folding constant {} {}".format(op_type, node.id))
+
+        self.add_tensor(node.outputs[0], tensor)
+        shape = tensor.shape if tensor.shape != () else (1,)
+        node.operation_type = "Constant"
+        node.inputs = []
+        node.input_shapes = []
+        node.attributes = { 'tensor': tensor }
+        node.weights = {}
+        node.output_shapes = [ (shape, self.get_order(shape)) ]
+
     def define_constant_inputs(self, node):
         for x in node.inputs:
             if self.is_tensor(x) and not x in self.model.nodes:
@@ -29,7 +29,7 @@ import ziptools
 
 _logger = logging.getLogger(__name__)
 
-def convert(model, output=None, zip_ell_model=None, step_interval=None, lag_threshold=None):
+def convert(model, output=None, zip_ell_model=None, step_interval=None, lag_threshold=None, optimize=True):
     model_directory, filename = os.path.split(model)
     if output:
         output_directory = output
@@ -40,7 +40,8 @@ def convert(model, output=None, zip_ell_model=None, step_interval=None, lag_thre
     model_file_name = filename_base + '.ell'
     model_file_path = os.path.join(output_directory, model_file_name)
 
-    ell_map, _ = onnx_to_ell.convert_onnx_to_ell(model, step_interval_msec=step_interval, lag_threshold_msec=lag_threshold) 
+    ell_map, _ = onnx_to_ell.convert_onnx_to_ell(model, step_interval_msec=step_interval,
+                                                 lag_threshold_msec=lag_threshold, optimize=optimize)
  
     _logger.info("Saving model file: '" + model_file_path + "'")
     ell_map.Save(model_file_path)
@@ -77,6 +78,9 @@ def main():
         help="number of step intervals to fall behind before notifying the caller.\n"
              "used when step_interval is set\n",
         default=None)
+    model_options.add_argument("--no_optimize",
+        help="don't fold constants and batch normalization into the model's weights during the import",
+        action="store_true")
     args = parser.parse_args()
 
     if args.verbose:
@@ -84,7 +88,8 @@ def main():
     else:
         logging.basicConfig(level=logging.INFO, format="%(message)s")
     
-    convert(args.input, args.output_directory, args.zip_ell_model, args.step_interval, args.lag_threshold)
+    convert(args.input, args.output_directory, args.zip_ell_model, args.step_interval, args.lag_threshold,
+            not args.no_optimize)
 
 if __name__ == "__main__":
     main()
@@ -26,18 +26,22 @@ import find_ell
 import ell
 import common.importer
 import common.converters
+import common.model_optimizer
 import onnx_converters as convert
 
 _logger = logging.getLogger(__name__)
 
-def convert_onnx_to_ell(path, step_interval_msec=None, lag_threshold_msec=None):
+def convert_onnx_to_ell(path, step_interval_msec=None, lag_threshold_msec=None, optimize=True):
     """
     convert the importer model into a ELL model, optionally a steppable model if step_interval_msec
-    and lag_threshold_msec are provided.
+    and lag_threshold_msec are provided. If optimize is True, constant sub-graphs are computed at import
+    time and batch normalization and per-channel scaling that follow a convolution are folded into its weights.
     """
     _logger.info("Pre-processing... ")
-    converter = convert.OnnxConverter()
+    converter = convert.OnnxConverter(fold_constants=optimize)
     importer_model = converter.load_model(path)
+    if optimize:
+        importer_model = common.model_optimizer.ImporterModelOptimizer(importer_model).optimize()
     _logger.info("\n Done pre-processing.")
     try:
         importer_engine = common.importer.ImporterEngine(step_interval_msec=step_interval_msec, lag_threshold_msec=lag_threshold_msec)     
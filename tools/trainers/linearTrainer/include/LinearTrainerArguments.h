@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <trainers/include/ConvergenceMonitor.h>
+
 #include <utilities/include/CommandLineParser.h>
 
 namespace ell
@@ -29,6 +31,13 @@ struct LinearTrainerArguments
     size_t maxEpochs;
     bool permute;
     std::string randomSeedString;
+    size_t numThreads;
+    std::string traceFilename;
+    trainers::ConvergenceCriterion stopWhen = trainers::ConvergenceCriterion::none;
+    double convergenceTolerance;
+    size_t checkInterval;
+    size_t patience;
+    std::string validationDataFilename;
 };
 
 /// <summary> Parsed version of LinearTrainerArguments. </summary>
@@ -55,5 +55,49 @@ void ParsedLinearTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
                      "seed",
                      "The random seed string",
                      "ABCDEFG");
+
+    parser.AddOption(numThreads,
+                     "numThreads",
+                     "nt",
+                     "The number of threads of the SDCA and sparse data SGD trainers, or 0 to use all the hardware threads",
+                     1);
+
+    parser.AddOption(traceFilename,
+                     "traceFile",
+                     "",
+                     "Path to a file to write a Chrome trace of the loading, training and evaluation to",
+                     "");
+
+    parser.AddOption(
+        stopWhen,
+        "stopWhen",
+        "sw",
+        "The convergence criterion at which to stop training before numEpochs epochs (dualityGap is SDCA only, and stops at desiredPrecision)",
+        { { "none", trainers::ConvergenceCriterion::none }, { "dualityGap", trainers::ConvergenceCriterion::dualityGap }, { "relativeLoss", trainers::ConvergenceCriterion::relativeLoss }, { "validationPlateau", trainers::ConvergenceCriterion::validationPlateau } },
+        "none");
+
+    parser.AddOption(convergenceTolerance,
+                     "convergenceTolerance",
+                     "ct",
+                     "The relative loss change at which the relativeLoss and validationPlateau criteria count as converged",
+                     1.0e-4);
+
+    parser.AddOption(checkInterval,
+                     "checkInterval",
+                     "ci",
+                     "The number of examples between convergence checks, or 0 to check at the end of each epoch",
+                     0);
+
+    parser.AddOption(patience,
+                     "patience",
+                     "",
+                     "The number of checks in a row without improvement that make a validation plateau",
+                     3);
+
+    parser.AddOption(validationDataFilename,
+                     "validationDataFilename",
+                     "vdf",
+                     "Path to the validation dataset of the validationPlateau criterion",
+                     "");
 }
 } // namespace ell
@@ -11,6 +11,7 @@
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
+#include <utilities/include/Logger.h>
 #include <utilities/include/OutputStreamImpostor.h>
 
 #include <data/include/Dataset.h>
@@ -95,6 +96,21 @@ int main(int argc, char* argv[])
             throw utilities::CommandLineParserPrintHelpException(commandLineParser.GetHelpString());
         }
 
+        const auto stopWhen = linearTrainerArguments.stopWhen;
+        if (stopWhen == trainers::ConvergenceCriterion::dualityGap && linearTrainerArguments.algorithm != LinearTrainerArguments::Algorithm::SDCA)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "stopWhen=dualityGap needs the SDCA algorithm, the only one with a duality gap");
+        }
+        if (stopWhen == trainers::ConvergenceCriterion::validationPlateau && linearTrainerArguments.validationDataFilename.empty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "stopWhen=validationPlateau needs a validationDataFilename");
+        }
+
+        logging::TraceFile traceFile(linearTrainerArguments.traceFilename);
+        auto loadEvent = logging::RegisterTraceEvent("load data");
+        auto trainEvent = logging::RegisterTraceEvent("train epoch");
+        auto evaluateEvent = logging::RegisterTraceEvent("evaluate epoch");
+
         // load map
         mapLoadArguments.defaultInputSize = dataLoadArguments.parsedDataDimension;
         model::Map map;
@@ -113,11 +129,22 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        logging::TraceEvent(loadEvent, logging::TracePhase::begin);
+        auto parsedDataset = common::GetDataset(dataLoadArguments);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
+        logging::TraceEvent(loadEvent, logging::TracePhase::end);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
+        // load validation dataset
+        auto validationDataset = data::AutoSupervisedDataset();
+        if (stopWhen == trainers::ConvergenceCriterion::validationPlateau)
+        {
+            if (trainerArguments.verbose) std::cout << "Loading validation data ..." << std::endl;
+            auto parsedValidationDataset = common::GetDataset(linearTrainerArguments.validationDataFilename, dataLoadArguments.numParsingThreads);
+            auto mappedValidationDataset = common::TransformDataset(parsedValidationDataset, map);
+            validationDataset.Swap(mappedValidationDataset);
+        }
+
         // normalize data
         if (linearTrainerArguments.normalize)
         {
@@ -135,30 +162,44 @@ int main(int argc, char* argv[])
             auto normalizedDataset = common::TransformDataset(mappedDataset, normalizer);
 
             mappedDataset.Swap(normalizedDataset);
+
+            // the validation data is normalized with the training data statistics
+            if (validationDataset.NumExamples() > 0)
+            {
+                auto normalizedValidationDataset = common::TransformDataset(validationDataset, normalizer);
+                validationDataset.Swap(normalizedValidationDataset);
+            }
         }
 
         // predictor type
         using PredictorType = predictors::LinearPredictor<double>;
 
+        // when to stop training early
+        trainers::ConvergenceParameters convergence;
+        convergence.criterion = stopWhen;
+        convergence.tolerance = stopWhen == trainers::ConvergenceCriterion::dualityGap ? linearTrainerArguments.desiredPrecision : linearTrainerArguments.convergenceTolerance;
+        convergence.checkInterval = linearTrainerArguments.checkInterval;
+        convergence.patience = linearTrainerArguments.patience;
+
         // create linear trainer
         std::unique_ptr<trainers::ITrainer<PredictorType>> trainer;
         switch (linearTrainerArguments.algorithm)
         {
         case LinearTrainerArguments::Algorithm::SGD:
-            trainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString, 1, convergence });
             break;
         case LinearTrainerArguments::Algorithm::SparseDataSGD:
-            trainer = common::MakeSparseDataSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSparseDataSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString, linearTrainerArguments.numThreads, convergence });
             break;
         case LinearTrainerArguments::Algorithm::SparseDataCenteredSGD:
         {
             auto mean = trainers::CalculateMean(mappedDataset.GetAnyDataset());
-            trainer = common::MakeSparseDataCenteredSGDTrainer(trainerArguments.lossFunctionArguments, mean, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSparseDataCenteredSGDTrainer(trainerArguments.lossFunctionArguments, mean, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString, linearTrainerArguments.numThreads, convergence });
             break;
         }
         case LinearTrainerArguments::Algorithm::SDCA:
         {
-            trainer = common::MakeSDCATrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.desiredPrecision, linearTrainerArguments.maxEpochs, linearTrainerArguments.permute, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSDCATrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.desiredPrecision, linearTrainerArguments.maxEpochs, linearTrainerArguments.permute, linearTrainerArguments.randomSeedString, linearTrainerArguments.numThreads, convergence });
             break;
         }
         default:
@@ -171,11 +212,25 @@ int main(int argc, char* argv[])
         // Train the predictor
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
         trainer->SetDataset(mappedDataset.GetAnyDataset());
+        if (validationDataset.NumExamples() > 0)
+        {
+            trainer->SetValidationDataset(validationDataset.GetAnyDataset());
+        }
 
         for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
         {
-            trainer->Update();
+            {
+                logging::TraceSpan span(trainEvent, epoch);
+                trainer->Update();
+            }
+            logging::TraceSpan span(evaluateEvent, epoch);
             evaluator->Evaluate(trainer->GetPredictor());
+
+            if (trainer->HasConverged())
+            {
+                if (trainerArguments.verbose) std::cout << "Converged after " << epoch + 1 << " epochs" << std::endl;
+                break;
+            }
         }
 
         // Print loss and errors
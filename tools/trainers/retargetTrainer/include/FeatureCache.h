@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FeatureCache.h (retargetTrainer)
+//  Authors:  Byron Changuion
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <data/include/Dataset.h>
+
+#include <model/include/Map.h>
+
+#include <string>
+
+namespace ell
+{
+/// <summary>
+/// Gets the name of the file that caches the featurized dataset made by transforming a dataset file with a map. The
+/// name is made from a hash of the map's archive and of the contents of the dataset file, so it changes if either does.
+/// </summary>
+///
+/// <param name="directory"> The directory of the cache. </param>
+/// <param name="map"> The map that featurizes the dataset (the truncated model). </param>
+/// <param name="dataFilename"> The path of the dataset file. </param>
+/// <param name="multiClass"> Whether the dataset is a multi-class dataset. </param>
+///
+/// <returns> The path of the cache file, which may not exist yet. </returns>
+std::string GetFeatureCacheFilename(const std::string& directory, const model::Map& map, const std::string& dataFilename, bool multiClass);
+
+/// <summary> Writes a featurized dataset to a cache file, in the binary dataset format. </summary>
+///
+/// <param name="dataset"> The featurized dataset. </param>
+/// <param name="filename"> The path of the cache file. </param>
+void WriteFeatureCache(const data::AutoSupervisedDataset& dataset, const std::string& filename);
+
+/// <summary> Writes a featurized multi-class dataset to a cache file, in the binary dataset format with the class indices as labels. </summary>
+///
+/// <param name="dataset"> The featurized dataset. </param>
+/// <param name="filename"> The path of the cache file. </param>
+void WriteFeatureCache(const data::AutoSupervisedMultiClassDataset& dataset, const std::string& filename);
+
+/// <summary> Reads a featurized dataset from a cache file. </summary>
+///
+/// <param name="filename"> The path of the cache file. </param>
+///
+/// <returns> The dataset. </returns>
+data::AutoSupervisedDataset ReadFeatureCache(const std::string& filename);
+
+/// <summary> Reads a featurized multi-class dataset from a cache file. </summary>
+///
+/// <param name="filename"> The path of the cache file. </param>
+///
+/// <returns> The dataset. </returns>
+data::AutoSupervisedMultiClassDataset ReadMultiClassFeatureCache(const std::string& filename);
+} // namespace ell
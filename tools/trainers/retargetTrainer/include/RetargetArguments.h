@@ -34,6 +34,7 @@ struct RetargetArguments
     bool multiClass;
     common::LossFunctionArguments lossFunctionArguments;
     bool useBlas;
+    std::string featureCacheDirectory;
 };
 
 /// <summary> Parsed version of RetargetArguments. </summary>
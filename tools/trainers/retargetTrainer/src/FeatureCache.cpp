@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FeatureCache.cpp (retargetTrainer)
+//  Authors:  Byron Changuion
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FeatureCache.h"
+
+#include <common/include/LoadModel.h>
+
+#include <data/include/BinaryDataset.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/Hash.h>
+
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+namespace ell
+{
+namespace
+{
+    // Changing what the cached datasets contain must change this, so old cache files aren't used
+    const size_t featureCacheVersion = 1;
+
+    size_t HashFile(const std::string& filename)
+    {
+        auto stream = utilities::OpenBinaryIfstream(filename);
+        size_t seed = 0;
+        std::vector<char> buffer(1 << 20);
+        while (stream)
+        {
+            stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            auto count = static_cast<size_t>(stream.gcount());
+            if (count == 0)
+            {
+                break;
+            }
+            utilities::HashCombine(seed, std::hash<std::string_view>{}(std::string_view(buffer.data(), count)));
+            utilities::HashCombine(seed, count);
+        }
+        return seed;
+    }
+
+    // Writes to a temporary file that's renamed when it's complete, so an interrupted run doesn't leave a partial cache file
+    template <typename WriteFunction>
+    void WriteCacheFile(const std::string& filename, WriteFunction write)
+    {
+        auto temporaryFilename = filename + ".tmp";
+        {
+            auto stream = utilities::OpenBinaryOfstream(temporaryFilename);
+            write(stream);
+            if (!stream)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Error writing feature cache " + temporaryFilename);
+            }
+        }
+        std::remove(filename.c_str());
+        if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Error renaming feature cache " + temporaryFilename);
+        }
+    }
+} // namespace
+
+std::string GetFeatureCacheFilename(const std::string& directory, const model::Map& map, const std::string& dataFilename, bool multiClass)
+{
+    std::stringstream mapArchive;
+    common::SaveMap(map, mapArchive);
+
+    size_t key = 0;
+    utilities::HashCombine(key, featureCacheVersion);
+    utilities::HashCombine(key, multiClass);
+    utilities::HashCombine(key, mapArchive.str());
+    utilities::HashCombine(key, HashFile(dataFilename));
+
+    std::stringstream filename;
+    filename << "features_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return utilities::JoinPaths(directory, filename.str());
+}
+
+void WriteFeatureCache(const data::AutoSupervisedDataset& dataset, const std::string& filename)
+{
+    WriteCacheFile(filename, [&dataset](std::ostream& stream) {
+        data::WriteBinaryDataset(dataset, stream);
+    });
+}
+
+void WriteFeatureCache(const data::AutoSupervisedMultiClassDataset& dataset, const std::string& filename)
+{
+    WriteCacheFile(filename, [&dataset](std::ostream& stream) {
+        data::BinaryDatasetWriter writer(stream);
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            const auto& example = dataset.GetExample(i);
+            const auto& metadata = example.GetMetadata();
+            writer.Write(data::AutoSupervisedExample(example.GetSharedDataVector(), data::WeightLabel{ metadata.weight, static_cast<double>(metadata.classIndex) }));
+        }
+        writer.Close();
+    });
+}
+
+data::AutoSupervisedDataset ReadFeatureCache(const std::string& filename)
+{
+    return data::BinaryDataset(filename).ToDataset();
+}
+
+data::AutoSupervisedMultiClassDataset ReadMultiClassFeatureCache(const std::string& filename)
+{
+    data::BinaryDataset binaryDataset(filename);
+    data::AutoSupervisedMultiClassDataset dataset;
+    for (size_t i = 0; i < binaryDataset.NumExamples(); ++i)
+    {
+        auto example = binaryDataset.GetExample(i);
+        const auto& metadata = example.GetMetadata();
+        dataset.AddExample(data::AutoSupervisedMultiClassExample(example.GetDataVector().CopyAs<data::AutoDataVector>(), data::WeightClassIndex{ metadata.weight, static_cast<size_t>(metadata.label) }));
+    }
+    return dataset;
+}
+} // namespace ell
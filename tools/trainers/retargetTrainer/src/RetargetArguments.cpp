@@ -116,5 +116,11 @@ void ParsedRetargetArguments::AddArgs(utilities::CommandLineParser& parser)
                      "",
                      "Emit code that calls BLAS, used when compiling the input model to create mapped datasets",
                      true);
+
+    parser.AddOption(featureCacheDirectory,
+                     "featureCacheDirectory",
+                     "fcd",
+                     "Directory to cache the dataset transformed by the input model in, so runs with the same model and dataset skip transforming it (empty for no cache)",
+                     "");
 }
 } // namespace ell
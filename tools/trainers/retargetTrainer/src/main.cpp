@@ -6,10 +6,12 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "FeatureCache.h"
 #include "RetargetArguments.h"
 
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/MillisecondTimer.h>
 
 #include <common/include/DataLoaders.h>
@@ -440,25 +442,49 @@ int main(int argc, char* argv[])
         auto node = output.GetElement(0).ReferencedPort()->GetNode();
         std::cout << "Using output from node of type " << node->GetRuntimeTypeName() << std::endl;
 
+        // The featurized dataset is cached, keyed by the truncated model and the input data, so retargeting the same
+        // model and data again (e.g. with other training parameters) skips transforming the dataset
+        std::string featureCacheFilename;
+        if (!retargetArguments.featureCacheDirectory.empty())
+        {
+            utilities::EnsureDirectoryExists(retargetArguments.featureCacheDirectory);
+            featureCacheFilename = GetFeatureCacheFilename(retargetArguments.featureCacheDirectory, map, retargetArguments.inputDataFilename, retargetArguments.multiClass);
+        }
+
         // load dataset and map the output
         if (retargetArguments.verbose) std::cout << "Loading data ...";
         model::Map result;
         if (retargetArguments.multiClass)
         {
             // This is a multi-class dataset
-            _timer.Start();
-            auto stream = utilities::OpenIfstream(retargetArguments.inputDataFilename);
-            auto multiclassDataset = common::GetMultiClassDataset(stream);
-            if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
-
-            // Obtain a new training dataset for the set of Linear Predictors by running the
-            // multiclassDataset through the modified model
-            if (retargetArguments.verbose) std::cout << std::endl
-                                                     << "Transforming dataset with compiled model...";
-            _timer.Start();
-
-            auto dataset = common::TransformDatasetWithCompiledMap(multiclassDataset, map, retargetArguments.useBlas);
-            if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
+            data::AutoSupervisedMultiClassDataset dataset;
+            if (!featureCacheFilename.empty() && utilities::FileExists(featureCacheFilename))
+            {
+                _timer.Start();
+                dataset = ReadMultiClassFeatureCache(featureCacheFilename);
+                if (retargetArguments.verbose) std::cout << "(read features from " << featureCacheFilename << ", " << _timer.Elapsed() << " ms)" << std::endl;
+            }
+            else
+            {
+                _timer.Start();
+                auto stream = utilities::OpenIfstream(retargetArguments.inputDataFilename);
+                auto multiclassDataset = common::GetMultiClassDataset(stream);
+                if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
+
+                // Obtain a new training dataset for the set of Linear Predictors by running the
+                // multiclassDataset through the modified model
+                if (retargetArguments.verbose) std::cout << std::endl
+                                                         << "Transforming dataset with compiled model...";
+                _timer.Start();
+
+                dataset = common::TransformDatasetWithCompiledMap(multiclassDataset, map, retargetArguments.useBlas);
+                if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
+
+                if (!featureCacheFilename.empty())
+                {
+                    WriteFeatureCache(dataset, featureCacheFilename);
+                }
+            }
 
             // Create binary classification datasets for each one versus rest (OVR) case
             if (retargetArguments.verbose) std::cout << std::endl
@@ -486,18 +512,33 @@ int main(int argc, char* argv[])
         else
         {
             // This is a binary classification dataset
-            _timer.Start();
-            auto stream = utilities::OpenIfstream(retargetArguments.inputDataFilename);
-            auto binaryDataset = common::GetDataset(stream);
-            if (retargetArguments.verbose) std::cout << "Loading dataset took :" << _timer.Elapsed() << " ms" << std::endl;
-            // Obtain a new training dataset for the Linear Predictor by running the
-            // binaryDataset through the modified model
-            if (retargetArguments.verbose) std::cout << std::endl
-                                                     << "Transforming dataset with compiled model...";
-            _timer.Start();
-
-            auto dataset = common::TransformDatasetWithCompiledMap(binaryDataset, map);
-            if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
+            data::AutoSupervisedDataset dataset;
+            if (!featureCacheFilename.empty() && utilities::FileExists(featureCacheFilename))
+            {
+                _timer.Start();
+                dataset = ReadFeatureCache(featureCacheFilename);
+                if (retargetArguments.verbose) std::cout << "(read features from " << featureCacheFilename << ", " << _timer.Elapsed() << " ms)" << std::endl;
+            }
+            else
+            {
+                _timer.Start();
+                auto stream = utilities::OpenIfstream(retargetArguments.inputDataFilename);
+                auto binaryDataset = common::GetDataset(stream);
+                if (retargetArguments.verbose) std::cout << "Loading dataset took :" << _timer.Elapsed() << " ms" << std::endl;
+                // Obtain a new training dataset for the Linear Predictor by running the
+                // binaryDataset through the modified model
+                if (retargetArguments.verbose) std::cout << std::endl
+                                                         << "Transforming dataset with compiled model...";
+                _timer.Start();
+
+                dataset = common::TransformDatasetWithCompiledMap(binaryDataset, map);
+                if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
+
+                if (!featureCacheFilename.empty())
+                {
+                    WriteFeatureCache(dataset, featureCacheFilename);
+                }
+            }
 
             // Train a linear predictor whose input comes from the previous model
             _timer.Start();
@@ -59,6 +59,18 @@ int main(int argc, char* argv[])
         commandLineParser.AddOptionSet(mapLoadArguments);
         commandLineParser.AddOptionSet(modelSaveArguments);
 
+        trainers::SweepingTrainerParameters sweepingParameters;
+        commandLineParser.AddOption(sweepingParameters.numThreads,
+                                    "numThreads",
+                                    "nt",
+                                    "The number of trainers that run at the same time, or 0 to use all the hardware threads",
+                                    0);
+        commandLineParser.AddOption(sweepingParameters.successiveHalving,
+                                    "successiveHalving",
+                                    "sh",
+                                    "Drop the worse half of the remaining trainers after each epoch",
+                                    false);
+
         // parse command line
         commandLineParser.Parse();
 
@@ -81,8 +93,7 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::GetDataset(dataLoadArguments);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
@@ -105,12 +116,15 @@ int main(int argc, char* argv[])
         }
 
         // create meta trainer
-        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers));
+        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), sweepingParameters);
 
         // train
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
         trainer->SetDataset(mappedDataset.GetAnyDataset());
-        trainer->Update();
+        for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
+        {
+            trainer->Update();
+        }
         PredictorType predictor(trainer->GetPredictor());
         predictor.Resize(mappedDatasetDimension);
 
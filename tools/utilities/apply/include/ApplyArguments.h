@@ -22,6 +22,21 @@ struct ApplyArguments
 
     /// <summary> Instead of raw output, report a summary. </summary>
     bool summarize = false;
+
+    /// <summary> The number of threads to compute the map with, or 0 to use all the hardware threads. </summary>
+    size_t numThreads = 1;
+
+    /// <summary> Compile the map and compute it on batches of examples, sharded across the threads. </summary>
+    bool compile = false;
+
+    /// <summary> The number of examples passed to each call of the compiled batch function. </summary>
+    size_t batchSize = 64;
+
+    /// <summary> The number of examples read, computed and written at a time in compiled mode. </summary>
+    size_t chunkSize = 16384;
+
+    /// <summary> Path to a file to write a Chrome trace of the map computations to. </summary>
+    std::string traceFilename;
 };
 
 /// <summary> Parsed command line arguments for the apply executable. </summary>
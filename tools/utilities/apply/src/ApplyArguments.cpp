@@ -25,11 +25,54 @@ void ParsedApplyArguments::AddArgs(utilities::CommandLineParser& parser)
         "s",
         "Aggregate and summarize map output.",
         false);
+
+    parser.AddOption(
+        numThreads,
+        "numThreads",
+        "nt",
+        "The number of threads to compute the map with, or 0 to use all the hardware threads. Without --compile, the threads compute independent nodes of the map; with it, each thread computes its own share of the examples.",
+        1);
+
+    parser.AddOption(
+        compile,
+        "compile",
+        "",
+        "Compile the map and compute it on batches of examples, sharded across the threads (not used in summarization mode).",
+        false);
+
+    parser.AddOption(
+        batchSize,
+        "batchSize",
+        "",
+        "The number of examples passed to each call of the compiled batch function.",
+        64);
+
+    parser.AddOption(
+        chunkSize,
+        "chunkSize",
+        "",
+        "The number of examples read, computed and written at a time in compiled mode.",
+        16384);
+
+    parser.AddOption(
+        traceFilename,
+        "traceFile",
+        "",
+        "Path to a file to write a Chrome trace of the map computations to.",
+        "");
 }
 
 utilities::CommandLineParseResult ParsedApplyArguments::PostProcess(const utilities::CommandLineParser& parser)
 {
     std::vector<std::string> errors;
+    if (batchSize == 0)
+    {
+        errors.push_back("batchSize must be positive");
+    }
+    if (chunkSize == 0)
+    {
+        errors.push_back("chunkSize must be positive");
+    }
     return errors;
 }
 } // namespace ell
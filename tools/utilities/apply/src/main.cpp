@@ -11,7 +11,9 @@
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
+#include <utilities/include/Logger.h>
 #include <utilities/include/OutputStreamImpostor.h>
+#include <utilities/include/ThreadPool.h>
 
 #include <data/include/DataVector.h>
 #include <data/include/DataVectorOperations.h>
@@ -27,15 +29,158 @@
 #include <common/include/LoadModel.h>
 #include <common/include/MapLoadArguments.h>
 
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/Map.h>
 #include <model/include/OutputNode.h>
 
+#include <algorithm>
+#include <future>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace ell;
 
+namespace
+{
+// Computes a range of examples with the batch function of a compiled map, formatting the results
+// into a string the same way the reference path prints them
+template <typename InputType, typename OutputType>
+void ComputeCompiledExamples(model::IRCompiledMap& compiledMap, const std::vector<data::AutoSupervisedExample>& examples, size_t begin, size_t end, size_t batchSize, std::string& output)
+{
+    const auto inputSize = compiledMap.GetInputSize(0);
+    std::ostringstream stream;
+    std::vector<std::vector<InputType>> inputs;
+    for (auto batchBegin = begin; batchBegin < end; batchBegin += batchSize)
+    {
+        auto batchEnd = std::min(batchBegin + batchSize, end);
+        inputs.clear();
+        for (auto index = batchBegin; index < batchEnd; ++index)
+        {
+            auto data = examples[index].GetDataVector().ToArray(inputSize);
+            inputs.emplace_back(data.begin(), data.end());
+        }
+
+        auto outputs = compiledMap.ComputeBatch<InputType, OutputType>(inputs);
+        for (size_t index = 0; index < outputs.size(); ++index)
+        {
+            data::FloatDataVector mappedDataVector(std::vector<float>(outputs[index].begin(), outputs[index].end()));
+            data::DenseSupervisedExample mappedExample(std::move(mappedDataVector), examples[batchBegin + index].GetMetadata());
+            mappedExample.Print(stream);
+            stream << '\n';
+        }
+    }
+    output = stream.str();
+}
+
+template <typename InputType>
+void ComputeCompiledExamples(model::IRCompiledMap& compiledMap, const std::vector<data::AutoSupervisedExample>& examples, size_t begin, size_t end, size_t batchSize, std::string& output)
+{
+    switch (compiledMap.GetOutputType())
+    {
+    case model::Port::PortType::smallReal:
+        ComputeCompiledExamples<InputType, float>(compiledMap, examples, begin, end, batchSize, output);
+        break;
+    case model::Port::PortType::real:
+        ComputeCompiledExamples<InputType, double>(compiledMap, examples, begin, end, batchSize, output);
+        break;
+    default:
+        throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Unexpected output type, expecting float or double");
+    }
+}
+
+void ComputeCompiledExamples(model::IRCompiledMap& compiledMap, const std::vector<data::AutoSupervisedExample>& examples, size_t begin, size_t end, size_t batchSize, std::string& output)
+{
+    switch (compiledMap.GetInputType())
+    {
+    case model::Port::PortType::smallReal:
+        ComputeCompiledExamples<float>(compiledMap, examples, begin, end, batchSize, output);
+        break;
+    case model::Port::PortType::real:
+        ComputeCompiledExamples<double>(compiledMap, examples, begin, end, batchSize, output);
+        break;
+    default:
+        throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Unexpected input type, expecting float or double");
+    }
+}
+
+// Compiles the map once per thread, then reads the examples a chunk at a time and shards each chunk
+// across the compiled copies. The formatted output of a chunk is written in large blocks while the
+// next chunk is computed.
+void ApplyCompiledMap(const model::Map& map, data::AutoSupervisedExampleIterator& exampleIterator, std::ostream& outputStream, const ApplyArguments& applyArguments, uint32_t computeEvent)
+{
+    if (!map.GetSourceNodes().empty() || map.NumInputs() != 1 || map.NumOutputs() != 1)
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "--compile needs a map with one input, one output and no source nodes");
+    }
+
+    auto numThreads = applyArguments.numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : applyArguments.numThreads;
+
+    // Compiled maps keep their state in global buffers, so each thread computes its own copy
+    model::MapCompilerOptions settings;
+    settings.emitBatchFunction = true;
+    std::vector<model::IRCompiledMap> compiledMaps;
+    compiledMaps.reserve(numThreads);
+    for (size_t thread = 0; thread < numThreads; ++thread)
+    {
+        model::IRMapCompiler compiler(settings, {});
+        compiledMaps.push_back(compiler.Compile(map));
+    }
+
+    std::vector<data::AutoSupervisedExample> examples;
+    std::vector<std::string> outputs(numThreads);
+    std::vector<std::string> pendingOutputs(numThreads);
+    size_t chunkIndex = 0;
+    while (true)
+    {
+        examples.clear();
+        while (examples.size() < applyArguments.chunkSize && exampleIterator.IsValid())
+        {
+            examples.push_back(exampleIterator.Get());
+            exampleIterator.Next();
+        }
+
+        auto numExamples = examples.size();
+        auto examplesPerThread = (numExamples + numThreads - 1) / numThreads;
+        auto computeShard = [&](size_t thread) {
+            logging::TraceSpan span(computeEvent, chunkIndex);
+            auto begin = std::min(thread * examplesPerThread, numExamples);
+            auto end = std::min(begin + examplesPerThread, numExamples);
+            ComputeCompiledExamples(compiledMaps[thread], examples, begin, end, applyArguments.batchSize, outputs[thread]);
+        };
+
+        std::vector<std::future<void>> shards;
+        for (size_t thread = 0; thread < numThreads && numExamples > 0; ++thread)
+        {
+            shards.push_back(utilities::GetHostThreadPool().AddTask(computeShard, thread));
+        }
+
+        // write the previous chunk while this one is computed
+        for (auto& output : pendingOutputs)
+        {
+            outputStream.write(output.data(), static_cast<std::streamsize>(output.size()));
+            output.clear();
+        }
+
+        for (auto& shard : shards)
+        {
+            utilities::GetHostThreadPool().GetResult(shard);
+        }
+
+        if (numExamples == 0)
+        {
+            break;
+        }
+        std::swap(outputs, pendingOutputs);
+        ++chunkIndex;
+    }
+}
+} // namespace
+
 int main(int argc, char* argv[])
 {
     try
@@ -57,8 +202,12 @@ int main(int argc, char* argv[])
         // parse command line
         commandLineParser.Parse();
 
+        logging::TraceFile traceFile(applyArguments.traceFilename);
+        auto computeEvent = logging::RegisterTraceEvent("compute example");
+
         // load map
         auto map = common::LoadMap(mapLoadArguments);
+        map.SetNumComputeThreads(applyArguments.numThreads);
 
         // get data iterator
         auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
@@ -74,6 +223,7 @@ int main(int argc, char* argv[])
             if (applyArguments.inputMapFilename2 != "")
             {
                 map2 = common::LoadMap(applyArguments.inputMapFilename2);
+                map2.SetNumComputeThreads(applyArguments.numThreads);
             }
 
             math::RowVector<double> u(map.GetOutputSize());
@@ -83,12 +233,15 @@ int main(int argc, char* argv[])
             while (exampleIterator.IsValid())
             {
                 auto example = exampleIterator.Get();
-                auto mappedDataVector = map.Compute<data::DoubleDataVector>(example.GetDataVector());
                 math::RowVector<double> w(map.GetOutputSize());
-                w += mappedDataVector;
+                {
+                    logging::TraceSpan span(computeEvent, count);
+                    auto mappedDataVector = map.Compute<data::DoubleDataVector>(example.GetDataVector());
+                    w += mappedDataVector;
 
-                auto mappedDataVector2 = map2.Compute<data::DoubleDataVector>(example.GetDataVector());
-                w += (-1.0) * mappedDataVector2;
+                    auto mappedDataVector2 = map2.Compute<data::DoubleDataVector>(example.GetDataVector());
+                    w += (-1.0) * mappedDataVector2;
+                }
 
                 // accumulate vectors for mean and standard deviation computation
                 u += w;
@@ -111,13 +264,21 @@ int main(int argc, char* argv[])
             outputStream << "std:\t" << v << '\n';
         }
 
+        // output new dataset mode, with a compiled map
+        else if (applyArguments.compile)
+        {
+            ApplyCompiledMap(map, exampleIterator, outputStream, applyArguments, computeEvent);
+        }
+
         // output new dataset mode
         else
         {
-            while (exampleIterator.IsValid())
+            for (size_t count = 0; exampleIterator.IsValid(); ++count)
             {
                 auto example = exampleIterator.Get();
+                logging::TraceEvent(computeEvent, logging::TracePhase::begin, count);
                 auto mappedDataVector = map.Compute<data::FloatDataVector>(example.GetDataVector());
+                logging::TraceEvent(computeEvent, logging::TracePhase::end);
                 auto mappedExample = data::DenseSupervisedExample(std::move(mappedDataVector), example.GetMetadata());
                 mappedExample.Print(outputStream);
                 outputStream << '\n';
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BenchmarkArguments.h (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <string>
+
+namespace ell
+{
+/// <summary> Arguments for the benchmarks tool. </summary>
+struct BenchmarkArguments
+{
+    std::string outputFilename;
+    std::string filter;
+    bool listBenchmarks = false;
+    int numWarmupIterations = 10;
+    double minTime = 0.5;
+    int cpu = -1;
+};
+
+/// <summary> Parsed arguments for the benchmarks tool. </summary>
+struct ParsedBenchmarkArguments : public BenchmarkArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
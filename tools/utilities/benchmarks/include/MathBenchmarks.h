@@ -0,0 +1,19 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MathBenchmarks.h (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/Benchmark.h>
+
+namespace ell
+{
+/// <summary> Adds benchmarks of the math library kernels (dot products, GEMV and GEMM) at representative sizes. </summary>
+///
+/// <param name="suite"> The suite to add the benchmarks to. </param>
+void AddMathBenchmarks(utilities::BenchmarkSuite& suite);
+} // namespace ell
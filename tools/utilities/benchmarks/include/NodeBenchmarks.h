@@ -0,0 +1,23 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     NodeBenchmarks.h (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/MapCompilerOptions.h>
+
+#include <utilities/include/Benchmark.h>
+
+namespace ell
+{
+/// <summary> Adds benchmarks of the compiled code of the compilable node types, each in a model of its own at
+/// representative shapes. A model is only compiled if its benchmark runs. </summary>
+///
+/// <param name="suite"> The suite to add the benchmarks to. </param>
+/// <param name="settings"> The options to compile the models with. </param>
+void AddNodeBenchmarks(utilities::BenchmarkSuite& suite, const model::MapCompilerOptions& settings);
+} // namespace ell
@@ -0,0 +1,24 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScaleBenchmarks.h (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/MapCompilerOptions.h>
+
+#include <utilities/include/Benchmark.h>
+
+namespace ell
+{
+/// <summary> Adds benchmarks of the compile time and the latency of the synthetic scale test models of makeExamples,
+/// over sweeps of their depth, width, convolution shape and sequence length, to chart how the costs grow with the
+/// size of a model. A model is only generated if one of its benchmarks runs. </summary>
+///
+/// <param name="suite"> The suite to add the benchmarks to. </param>
+/// <param name="settings"> The options to compile the models with. </param>
+void AddScaleBenchmarks(utilities::BenchmarkSuite& suite, const model::MapCompilerOptions& settings);
+} // namespace ell
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BenchmarkArguments.cpp (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BenchmarkArguments.h"
+
+namespace ell
+{
+void ParsedBenchmarkArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        outputFilename,
+        "outputFilename",
+        "of",
+        "File to write the results to as JSON (blank to print a table to stdout)",
+        "");
+
+    parser.AddOption(
+        filter,
+        "filter",
+        "f",
+        "Only run the benchmarks whose names contain this string",
+        "");
+
+    parser.AddOption(
+        listBenchmarks,
+        "list",
+        "l",
+        "List the benchmarks instead of running them",
+        false);
+
+    parser.AddOption(
+        numWarmupIterations,
+        "warmup",
+        "w",
+        "The number of untimed calls made before timing each benchmark",
+        10);
+
+    parser.AddOption(
+        minTime,
+        "minTime",
+        "t",
+        "The minimum time in seconds to spend timing each benchmark",
+        0.5);
+
+    parser.AddOption(
+        cpu,
+        "cpu",
+        "",
+        "The CPU to pin the benchmarks to (-1 to not pin them)",
+        -1);
+}
+} // namespace ell
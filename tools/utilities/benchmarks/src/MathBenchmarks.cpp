@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MathBenchmarks.cpp (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MathBenchmarks.h"
+
+#include <math/include/Matrix.h>
+#include <math/include/MatrixOperations.h>
+#include <math/include/Vector.h>
+#include <math/include/VectorOperations.h>
+
+#include <utilities/include/RandomEngines.h>
+
+#include <memory>
+#include <random>
+#include <string>
+
+namespace ell
+{
+namespace
+{
+    template <typename ElementType>
+    math::ColumnVector<ElementType> GetRandomVector(size_t size)
+    {
+        auto engine = utilities::GetRandomEngine("123");
+        std::uniform_real_distribution<ElementType> distribution(-1, 1);
+        math::ColumnVector<ElementType> vector(size);
+        vector.Generate([&] { return distribution(engine); });
+        return vector;
+    }
+
+    template <typename ElementType>
+    math::RowMatrix<ElementType> GetRandomMatrix(size_t rows, size_t columns)
+    {
+        auto engine = utilities::GetRandomEngine("123");
+        std::uniform_real_distribution<ElementType> distribution(-1, 1);
+        math::RowMatrix<ElementType> matrix(rows, columns);
+        matrix.Generate([&] { return distribution(engine); });
+        return matrix;
+    }
+
+    template <typename ElementType>
+    void AddVectorBenchmarks(utilities::BenchmarkSuite& suite, const std::string& typeName)
+    {
+        for (size_t size : { 256, 4096, 65536 })
+        {
+            auto shape = std::to_string(size);
+            suite.Add("math/Dot<" + typeName + ">/" + shape, [size] {
+                auto a = std::make_shared<math::ColumnVector<ElementType>>(GetRandomVector<ElementType>(size));
+                auto b = std::make_shared<math::ColumnVector<ElementType>>(GetRandomVector<ElementType>(size));
+                auto result = std::make_shared<ElementType>();
+                return [a, b, result] { *result = math::Dot(*a, *b); };
+            });
+
+            suite.Add("math/AddUpdate<" + typeName + ">/" + shape, [size] {
+                auto a = std::make_shared<math::ColumnVector<ElementType>>(GetRandomVector<ElementType>(size));
+                auto b = std::make_shared<math::ColumnVector<ElementType>>(GetRandomVector<ElementType>(size));
+                return [a, b] { math::AddUpdate(*a, *b); };
+            });
+        }
+    }
+
+    template <typename ElementType>
+    void AddMatrixBenchmarks(utilities::BenchmarkSuite& suite, const std::string& typeName)
+    {
+        for (size_t size : { 64, 256, 1024 })
+        {
+            auto shape = std::to_string(size) + "x" + std::to_string(size);
+            suite.Add("math/GEMV<" + typeName + ">/" + shape, [size] {
+                auto matrix = std::make_shared<math::RowMatrix<ElementType>>(GetRandomMatrix<ElementType>(size, size));
+                auto input = std::make_shared<math::ColumnVector<ElementType>>(GetRandomVector<ElementType>(size));
+                auto output = std::make_shared<math::ColumnVector<ElementType>>(size);
+                return [matrix, input, output] { math::MultiplyScaleAddUpdate(ElementType{ 1 }, *matrix, *input, ElementType{ 0 }, *output); };
+            });
+        }
+
+        for (size_t size : { 32, 128, 256 })
+        {
+            auto shape = std::to_string(size) + "x" + std::to_string(size) + "x" + std::to_string(size);
+            suite.Add("math/GEMM<" + typeName + ">/" + shape, [size] {
+                auto a = std::make_shared<math::RowMatrix<ElementType>>(GetRandomMatrix<ElementType>(size, size));
+                auto b = std::make_shared<math::RowMatrix<ElementType>>(GetRandomMatrix<ElementType>(size, size));
+                auto c = std::make_shared<math::RowMatrix<ElementType>>(size, size);
+                return [a, b, c] { math::MultiplyScaleAddUpdate(ElementType{ 1 }, *a, *b, ElementType{ 0 }, *c); };
+            });
+        }
+    }
+} // namespace
+
+void AddMathBenchmarks(utilities::BenchmarkSuite& suite)
+{
+    AddVectorBenchmarks<float>(suite, "float");
+    AddVectorBenchmarks<double>(suite, "double");
+    AddMatrixBenchmarks<float>(suite, "float");
+    AddMatrixBenchmarks<double>(suite, "double");
+}
+} // namespace ell
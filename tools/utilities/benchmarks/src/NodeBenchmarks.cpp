@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     NodeBenchmarks.cpp (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "NodeBenchmarks.h"
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputNode.h>
+#include <model/include/Map.h>
+#include <model/include/Model.h>
+#include <model/include/OutputNode.h>
+
+#include <nodes/include/BinaryOperationNode.h>
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/DotProductNode.h>
+#include <nodes/include/FFTNode.h>
+#include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorProductNode.h>
+#include <nodes/include/SumNode.h>
+#include <nodes/include/UnaryOperationNode.h>
+
+#include <math/include/Matrix.h>
+
+#include <utilities/include/RandomEngines.h>
+
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace
+{
+    std::vector<float> GetRandomValues(size_t size)
+    {
+        auto engine = utilities::GetRandomEngine("123");
+        std::uniform_real_distribution<float> distribution(0, 1);
+        std::vector<float> values(size);
+        for (auto& value : values)
+        {
+            value = distribution(engine);
+        }
+        return values;
+    }
+
+    // The compiled map keeps the module of the compiler that produced it, so they live together
+    struct CompiledModel
+    {
+        CompiledModel(const model::Map& map, const model::MapCompilerOptions& settings) :
+            compiler(settings, model::ModelOptimizerOptions{}),
+            compiledMap(compiler.Compile(map)),
+            input(GetRandomValues(map.GetInputSize())) {}
+
+        model::IRMapCompiler compiler;
+        model::IRCompiledMap compiledMap;
+        std::vector<float> input;
+    };
+
+    // Adds a benchmark of a model with one input of the given size, whose output is made by `addNodes`
+    void AddNodeBenchmark(utilities::BenchmarkSuite& suite, const std::string& name, const model::MapCompilerOptions& settings, size_t inputSize, std::function<const model::OutputPort<float>&(model::Model&, const model::OutputPort<float>&)> addNodes)
+    {
+        suite.Add("nodes/" + name, [settings, inputSize, addNodes] {
+            model::Model model;
+            auto inputNode = model.AddNode<model::InputNode<float>>(inputSize);
+            const auto& output = addNodes(model, inputNode->output);
+            auto outputNode = model.AddNode<model::OutputNode<float>>(output);
+            model::Map map(model, { { "input", inputNode } }, { { "output", outputNode->output } });
+
+            auto compiled = std::make_shared<CompiledModel>(map, settings);
+            return [compiled] { compiled->compiledMap.Compute<float>(compiled->input); };
+        });
+    }
+
+    const model::OutputPort<float>& AddConstant(model::Model& model, size_t size)
+    {
+        return model.AddNode<nodes::ConstantNode<float>>(GetRandomValues(size))->output;
+    }
+
+    void AddElementwiseNodeBenchmarks(utilities::BenchmarkSuite& suite, const model::MapCompilerOptions& settings)
+    {
+        using nodes::BinaryOperationType;
+        using nodes::UnaryOperationType;
+        for (size_t size : { 256, 4096, 65536 })
+        {
+            auto shape = "/" + std::to_string(size);
+            for (auto operation : { BinaryOperationType::add, BinaryOperationType::multiply })
+            {
+                AddNodeBenchmark(suite, "BinaryOperationNode<" + nodes::ToString(operation) + ">" + shape, settings, size, [operation, size](model::Model& model, const model::OutputPort<float>& input) -> const model::OutputPort<float>& {
+                    return model.AddNode<nodes::BinaryOperationNode<float>>(input, AddConstant(model, size), operation)->output;
+                });
+            }
+
+            for (auto operation : { UnaryOperationType::exp, UnaryOperationType::sqrt, UnaryOperationType::tanh })
+            {
+                AddNodeBenchmark(suite, "UnaryOperationNode<" + nodes::ToString(operation) + ">" + shape, settings, size, [operation](model::Model& model, const model::OutputPort<float>& input) -> const model::OutputPort<float>& {
+                    return model.AddNode<nodes::UnaryOperationNode<float>>(input, operation)->output;
+                });
+            }
+
+            AddNodeBenchmark(suite, "SumNode" + shape, settings, size, [](model::Model& model, const model::OutputPort<float>& input) -> const model::OutputPort<float>& {
+                return model.AddNode<nodes::SumNode<float>>(input)->output;
+            });
+
+            AddNodeBenchmark(suite, "DotProductNode" + shape, settings, size, [size](model::Model& model, const model::OutputPort<float>& input) -> const model::OutputPort<float>& {
+                return model.AddNode<nodes::DotProductNode<float>>(input, AddConstant(model, size))->output;
+            });
+        }
+    }
+
+    void AddLinearAlgebraNodeBenchmarks(utilities::BenchmarkSuite& suite, const model::MapCompilerOptions& settings)
+    {
+        for (size_t size : { 64, 256, 1024 })
+        {
+            auto shape = "/" + std::to_string(size) + "x" + std::to_string(size);
+            AddNodeBenchmark(suite, "MatrixVectorProductNode" + shape, settings, size, [size](model::Model& model, const model::OutputPort<float>& input) -> const model::OutputPort<float>& {
+                math::RowMatrix<float> weights(size, size);
+                auto values = GetRandomValues(size * size);
+                weights.Generate([&values, index = size_t{ 0 }]() mutable { return values[index++]; });
+                return model.AddNode<nodes::MatrixVectorProductNode<float, math::MatrixLayout::rowMajor>>(input, weights)->output;
+            });
+        }
+
+        for (int size : { 32, 128, 256 })
+        {
+            auto shape = "/" + std::to_string(size) + "x" + std::to_string(size) + "x" + std::to_string(size);
+            auto inputSize = static_cast<size_t>(size * size);
+            AddNodeBenchmark(suite, "MatrixMatrixMultiplyNode" + shape, settings, inputSize, [size, inputSize](model::Model& model, const model::OutputPort<float>& input) -> const model::OutputPort<float>& {
+                const auto& weights = AddConstant(model, inputSize);
+                return model.AddNode<nodes::MatrixMatrixMultiplyNode<float>>(input, size, size, size, size, weights, size, size)->output;
+            });
+        }
+
+        for (size_t size : { 256, 1024 })
+        {
+            AddNodeBenchmark(suite, "FFTNode/" + std::to_string(size), settings, size, [](model::Model& model, const model::OutputPort<float>& input) -> const model::OutputPort<float>& {
+                return model.AddNode<nodes::FFTNode<float>>(input)->output;
+            });
+        }
+    }
+} // namespace
+
+void AddNodeBenchmarks(utilities::BenchmarkSuite& suite, const model::MapCompilerOptions& settings)
+{
+    AddElementwiseNodeBenchmarks(suite, settings);
+    AddLinearAlgebraNodeBenchmarks(suite, settings);
+}
+} // namespace ell
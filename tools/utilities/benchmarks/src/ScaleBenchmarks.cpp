@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScaleBenchmarks.cpp (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ScaleBenchmarks.h"
+#include "GenerateScaleTests.h"
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/Map.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace
+{
+    struct CompiledScaleModel
+    {
+        CompiledScaleModel(const model::Map& map, const model::MapCompilerOptions& settings) :
+            compiler(settings, model::ModelOptimizerOptions{}),
+            compiledMap(compiler.Compile(map)),
+            input(map.GetInputSize(), 0.5f) {}
+
+        model::IRMapCompiler compiler;
+        model::IRCompiledMap compiledMap;
+        std::vector<float> input;
+    };
+
+    // Adds a benchmark of compiling the model, and one of computing its compiled map
+    void AddScaleBenchmark(utilities::BenchmarkSuite& suite, const std::string& name, const model::MapCompilerOptions& settings, std::function<model::Map()> generateModel)
+    {
+        suite.Add("scale/" + name + "/compile", [settings, generateModel] {
+            auto map = std::make_shared<model::Map>(generateModel());
+            return [map, settings] { CompiledScaleModel compiled(*map, settings); };
+        });
+
+        suite.Add("scale/" + name + "/compute", [settings, generateModel] {
+            auto compiled = std::make_shared<CompiledScaleModel>(generateModel(), settings);
+            return [compiled] { compiled->compiledMap.Compute<float>(compiled->input); };
+        });
+    }
+} // namespace
+
+void AddScaleBenchmarks(utilities::BenchmarkSuite& suite, const model::MapCompilerOptions& settings)
+{
+    const size_t inputSize = 256;
+    for (size_t depth : { 1, 4, 16 })
+    {
+        for (size_t width : { 64, 256, 1024 })
+        {
+            auto name = "dense/d" + std::to_string(depth) + "_w" + std::to_string(width);
+            AddScaleBenchmark(suite, name, settings, [=] { return GenerateDenseScaleModel(inputSize, depth, width, 0.0); });
+        }
+    }
+
+    const size_t imageSize = 32;
+    const size_t numChannels = 8;
+    const size_t filterSize = 3;
+    for (size_t depth : { 1, 4 })
+    {
+        for (size_t numFilters : { 16, 64 })
+        {
+            auto name = "convolution/32x32x8_d" + std::to_string(depth) + "_f" + std::to_string(numFilters);
+            AddScaleBenchmark(suite, name, settings, [=] { return GenerateConvolutionScaleModel(imageSize, imageSize, numChannels, depth, numFilters, filterSize, 0.0); });
+        }
+    }
+
+    const size_t hiddenUnits = 64;
+    for (size_t depth : { 1, 4 })
+    {
+        for (size_t sequenceLength : { 1, 16, 64 })
+        {
+            auto name = "recurrent/d" + std::to_string(depth) + "_t" + std::to_string(sequenceLength);
+            AddScaleBenchmark(suite, name, settings, [=] { return GenerateRecurrentScaleModel(inputSize, depth, hiddenUnits, sequenceLength, 0.0); });
+        }
+    }
+}
+} // namespace ell
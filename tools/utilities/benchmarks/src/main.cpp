@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (benchmarks)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BenchmarkArguments.h"
+#include "MathBenchmarks.h"
+#include "NodeBenchmarks.h"
+#include "ScaleBenchmarks.h"
+
+#include <common/include/MapCompilerArguments.h>
+
+#include <passes/include/StandardTransformations.h>
+
+#include <utilities/include/Benchmark.h>
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <iostream>
+#include <string>
+
+#ifndef ELL_VERSION
+#define ELL_VERSION "unknown"
+#endif
+
+using namespace ell;
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        ParsedBenchmarkArguments benchmarkArguments;
+        common::ParsedMapCompilerArguments mapCompilerArguments;
+
+        commandLineParser.AddOptionSet(benchmarkArguments);
+        commandLineParser.AddDocumentationString("Code generation options for the node and scale benchmarks");
+        commandLineParser.AddOptionSet(mapCompilerArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        // Initialize the transformation registry
+        passes::AddStandardTransformationsToRegistry();
+
+        auto settings = mapCompilerArguments.GetMapCompilerOptions("");
+        utilities::BenchmarkSuite suite;
+        AddMathBenchmarks(suite);
+        AddNodeBenchmarks(suite, settings);
+        AddScaleBenchmarks(suite, settings);
+
+        if (benchmarkArguments.listBenchmarks)
+        {
+            for (const auto& name : suite.GetNames())
+            {
+                std::cout << name << std::endl;
+            }
+            return 0;
+        }
+
+        utilities::BenchmarkOptions options;
+        options.numWarmupIterations = static_cast<size_t>(benchmarkArguments.numWarmupIterations);
+        options.minTimeSeconds = benchmarkArguments.minTime;
+        options.cpu = benchmarkArguments.cpu;
+        if (options.cpu >= 0 && !utilities::PinThreadToCpu(options.cpu))
+        {
+            std::cerr << "Warning: couldn't pin the benchmarks to CPU " << options.cpu << std::endl;
+        }
+
+        auto results = suite.Run(options, benchmarkArguments.filter);
+        if (benchmarkArguments.outputFilename.empty())
+        {
+            utilities::WriteBenchmarkResultsText(std::cout, results);
+        }
+        else
+        {
+            auto stream = utilities::OpenOfstream(benchmarkArguments.outputFilename);
+            utilities::WriteBenchmarkResultsJson(stream, results, options, ELL_VERSION);
+        }
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
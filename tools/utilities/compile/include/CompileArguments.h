@@ -33,12 +33,24 @@ struct CompileArguments
     bool outputMapWithOptions = false;
     bool outputRefinedMap = false;
     bool outputCompiledMap = false;
+    bool outputMemoryReport = false;
+    bool outputTimings = false;
+    bool outputRemarks = false;
     std::string outputDirectory;
     std::string outputFilenameBase;
     bool verbose = false;
+    std::string traceFilename;
 
     // model-generation options
     int maxRefinementIterations = 0;
+
+    // multi-target options
+    std::string targets; // comma-separated target device or CPU names, e.g. "host,pi3,pi3_64,aarch64,cortex-m4"
+    size_t numCompileThreads = 0;
+
+    // profile-guided compilation options
+    std::string profileDataFilename;
+    double hotNodeTimeFraction = 0.9;
 };
 
 /// <summary> Parsed command line arguments for the compile executable. </summary>
@@ -77,6 +77,27 @@ void ParsedCompileArguments::AddArgs(utilities::CommandLineParser& parser)
         "Write out compiled map",
         false);
 
+    parser.AddOption(
+        outputMemoryReport,
+        "memoryReport",
+        "",
+        "Write out a report of the static memory, stack and per-node buffer memory the compiled code uses",
+        false);
+
+    parser.AddOption(
+        outputTimings,
+        "timings",
+        "",
+        "Print the wall time and peak memory of each compile phase and model transformation",
+        false);
+
+    parser.AddOption(
+        outputRemarks,
+        "remarks",
+        "",
+        "Print LLVM's vectorization, unrolling and inlining remarks for each node. The node functions aren't inlined, so the remarks can be traced back to the nodes",
+        false);
+
     parser.AddOption(
         outputDirectory,
         "outputDirectory",
@@ -100,11 +121,50 @@ void ParsedCompileArguments::AddArgs(utilities::CommandLineParser& parser)
         "The maximal number of refinement iterations (only valid if outputType is 'refinedMap')",
         10);
 
+    parser.AddDocumentationString("Multi-target options");
+
+    parser.AddOption(
+        targets,
+        "targets",
+        "",
+        "Comma-separated list of targets to compile for, each a --target name or a CPU name like cortex-m4. The map is loaded once, and the output for each target is written to a subdirectory named after it. Overrides the target device options",
+        "");
+
+    parser.AddOption(
+        numCompileThreads,
+        "numCompileThreads",
+        "",
+        "The number of targets to compile at the same time, or 0 to use all the hardware threads (only valid with --targets)",
+        0);
+
+    parser.AddDocumentationString("Profile-guided compilation options");
+
+    parser.AddOption(
+        profileDataFilename,
+        "profileData",
+        "pd",
+        "Per-node profile data written by the profile tool's --profileData option. Hot nodes are unrolled, vectorized and parallelized, and the other nodes are compiled for size",
+        "");
+
+    parser.AddOption(
+        hotNodeTimeFraction,
+        "hotNodeTimeFraction",
+        "",
+        "The fraction of the profiled time that the hot nodes account for (only valid with --profileData)",
+        0.9);
+
     parser.AddOption(
         verbose,
         "verbose",
         "v",
         "Print timing information and detail about the network being compiled",
         false);
+
+    parser.AddOption(
+        traceFilename,
+        "traceFile",
+        "",
+        "Path to a file to write a Chrome trace of the compilation steps to",
+        "");
 }
 } // namespace ell
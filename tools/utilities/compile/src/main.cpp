@@ -14,9 +14,14 @@
 #include <common/include/MapCompilerArguments.h>
 #include <common/include/MapLoadArguments.h>
 
+#include <emitters/include/TargetDevice.h>
+
+#include <model/include/CompileTimingReport.h>
 #include <model/include/IRCompiledMap.h>
 #include <model/include/IRMapCompiler.h>
 #include <model/include/Map.h>
+#include <model/include/MapOptimizationRemarks.h>
+#include <model/include/ModelProfileData.h>
 #include <model/include/OutputNode.h>
 #include <model/include/SetCompilerOptionsTransformation.h>
 
@@ -24,13 +29,21 @@
 
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/MillisecondTimer.h>
+#include <utilities/include/StringUtil.h>
+#include <utilities/include/ThreadPool.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace ell;
 using namespace utilities::logging;
@@ -38,6 +51,7 @@ using utilities::logging::Log;
 
 typedef std::function<void(const double*, double*)> FnInputOutput;
 
+// Reports the time of a step when verbose, and traces it as a span named by the message when tracing
 class TimingOutputCollector
 {
 public:
@@ -45,7 +59,10 @@ public:
         _valid(true),
         _enabled(enabled),
         _stream(stream),
-        _message(message) {}
+        _message(message)
+    {
+        BeginTrace();
+    }
 
     ~TimingOutputCollector()
     {
@@ -54,15 +71,19 @@ public:
 
     void Start()
     {
+        EndTrace();
         _timer.Start();
         _valid = true;
+        BeginTrace();
     }
 
     void Start(const std::string& newMessage)
     {
+        EndTrace();
         _message = newMessage;
         _timer.Start();
         _valid = true;
+        BeginTrace();
     }
 
     void Stop()
@@ -77,6 +98,18 @@ private:
     utilities::MillisecondTimer _timer;
     std::ostream& _stream;
     std::string _message;
+    uint32_t _traceEventId = 0;
+    bool _isTracing = false;
+
+    void BeginTrace()
+    {
+        _isTracing = IsTracing();
+        if (_isTracing)
+        {
+            _traceEventId = RegisterTraceEvent(_message);
+            TraceEvent(_traceEventId, TracePhase::begin);
+        }
+    }
 
     void ReportTime()
     {
@@ -85,6 +118,16 @@ private:
             auto elapsed = _timer.Elapsed();
             _stream << _message << ": " << elapsed << " ms\n";
         }
+        EndTrace();
+    }
+
+    void EndTrace()
+    {
+        if (_isTracing)
+        {
+            TraceEvent(_traceEventId, TracePhase::end);
+            _isTracing = false;
+        }
     }
 };
 
@@ -93,96 +136,276 @@ std::string GetObjExtension(model::IRCompiledMap& map)
     return ".o";
 }
 
-void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMapCompilerArguments& mapCompilerArguments, common::MapLoadArguments& mapLoadArguments, model::Map& map)
+utilities::PropertyBag GetProfileGuidedOptionsMetadata(const ParsedCompileArguments& compileArguments)
 {
-    std::stringstream timingOutput;
+    auto profileData = model::LoadModelProfileData(compileArguments.profileDataFilename);
+    auto options = model::ProfileGuidedOptions::GetDefault();
+    options.hotTimeFraction = compileArguments.hotNodeTimeFraction;
+    return profileData.GetCompilerOptions(options);
+}
 
-    auto inputFilename = mapLoadArguments.GetInputFilename();
-    auto outputDirectory = compileArguments.outputDirectory;
+// Merges the options metadata in `source` into `dest`, with the options in `source` taking precedence
+void AddOptionsMetadata(const utilities::PropertyBag& source, utilities::PropertyBag& dest)
+{
+    auto mergeOptions = [](const utilities::PropertyBag& sourceOptions, utilities::PropertyBag& destOptions) {
+        for (const auto& key : sourceOptions.Keys())
+        {
+            destOptions[key] = sourceOptions.GetEntry(key);
+        }
+    };
 
-    auto baseFilename = compileArguments.outputFilenameBase;
-    if (baseFilename.empty())
-    {
-        baseFilename = utilities::RemoveFileExtension(inputFilename);
-    }
-    if (!outputDirectory.empty())
+    if (source.HasEntry("model"))
     {
-        ell::utilities::EnsureDirectoryExists(outputDirectory);
-        baseFilename = utilities::JoinPaths(outputDirectory, utilities::GetFileName(baseFilename));
+        auto modelOptions = dest.GetEntry<utilities::PropertyBag>("model", {});
+        mergeOptions(source.GetEntry<utilities::PropertyBag>("model"), modelOptions);
+        dest["model"] = modelOptions;
     }
 
-    model::MapCompilerOptions settings = mapCompilerArguments.GetMapCompilerOptions(baseFilename);
-
-    // Add model/node-specific parameters to metadata
-    if (mapCompilerArguments.HasOptionsMetadata())
+    if (source.HasEntry("nodes"))
     {
-        utilities::PropertyBag properties = mapCompilerArguments.GetOptionsMetadata();
-        model::SetCompilerOptionsTransformation setOptionsTranformation(properties);
-        map.Transform(setOptionsTranformation);
-    }
-
-    if (compileArguments.outputMapWithOptions)
-    {
-        common::SaveMap(map, baseFilename + "_options.ell");
+        auto nodesOptions = dest.GetEntry<utilities::PropertyBag>("nodes", {});
+        const auto& sourceNodesOptions = source.GetEntry<utilities::PropertyBag>("nodes");
+        for (const auto& nodeId : sourceNodesOptions.Keys())
+        {
+            auto nodeOptions = nodesOptions.GetEntry<utilities::PropertyBag>(nodeId, {});
+            mergeOptions(sourceNodesOptions.GetEntry<utilities::PropertyBag>(nodeId), nodeOptions);
+            nodesOptions[nodeId] = nodeOptions;
+        }
+        dest["nodes"] = nodesOptions;
     }
 
-    if (compileArguments.outputRefinedMap)
+    for (const auto& key : { "rules", "parallelizeMinOutputSize" })
     {
-        TimingOutputCollector timer(timingOutput, "Time to refine map", compileArguments.verbose);
-        map.Refine(compileArguments.maxRefinementIterations);
-        timer.Stop();
-        common::SaveMap(map, baseFilename + "_refined.ell");
+        if (source.HasEntry(key))
+        {
+            dest[key] = source.GetEntry(key);
+        }
     }
+}
 
-    auto optimizerOptions = mapCompilerArguments.GetModelOptimizerOptions();
-
-    model::IRMapCompiler compiler(settings, optimizerOptions);
-    TimingOutputCollector timer(timingOutput, "Time to compile map", compileArguments.verbose);
+// Compiles a map and writes the requested outputs, with filenames starting with `baseFilename`
+void CompileMapOutput(const ParsedCompileArguments& compileArguments, const model::MapCompilerOptions& settings, const model::ModelOptimizerOptions& optimizerOptions, model::Map map, const std::string& baseFilename, const std::string& timingSuffix, std::ostream& timingOutput)
+{
+    auto compilerSettings = settings;
+    compilerSettings.recordCompileTimings = compileArguments.outputTimings;
+    compilerSettings.collectOptimizationRemarks = compileArguments.outputRemarks;
+    model::IRMapCompiler compiler(compilerSettings, optimizerOptions);
+    TimingOutputCollector timer(timingOutput, "Time to compile map" + timingSuffix, compileArguments.verbose);
 
-    auto compiledMap = compiler.Compile(map);
+    auto compiledMap = compiler.Compile(std::move(map));
     timer.Stop();
 
+    // Writing the outputs includes LLVM's code generation, which the compiler's own report doesn't cover
+    model::CompileTimingReport outputTimings(compileArguments.outputTimings);
+
     if (compileArguments.outputCompiledMap)
     {
-        TimingOutputCollector timer(timingOutput, "Time to save compiled map", compileArguments.verbose);
+        TimingOutputCollector timer(timingOutput, "Time to save compiled map" + timingSuffix, compileArguments.verbose);
+        auto phase = outputTimings.BeginPhase("Write compiled map");
         common::SaveMap(compiledMap, baseFilename + "_compiled.ell");
     }
     if (compileArguments.outputHeader)
     {
-        TimingOutputCollector timer(timingOutput, "Time to save header file", compileArguments.verbose);
+        TimingOutputCollector timer(timingOutput, "Time to save header file" + timingSuffix, compileArguments.verbose);
+        auto phase = outputTimings.BeginPhase("Write header");
         compiledMap.WriteCodeHeader(baseFilename + ".h", emitters::ModuleOutputFormat::cHeader);
     }
     if (compileArguments.outputIr)
     {
-        TimingOutputCollector timer(timingOutput, "Time to save LLVM IR", compileArguments.verbose);
+        TimingOutputCollector timer(timingOutput, "Time to save LLVM IR" + timingSuffix, compileArguments.verbose);
+        auto phase = outputTimings.BeginPhase("Write LLVM IR");
         compiledMap.WriteCode(baseFilename + ".ll", emitters::ModuleOutputFormat::ir);
     }
     if (compileArguments.outputBitcode)
     {
-        TimingOutputCollector timer(timingOutput, "Time to save LLVM bitcode", compileArguments.verbose);
+        TimingOutputCollector timer(timingOutput, "Time to save LLVM bitcode" + timingSuffix, compileArguments.verbose);
+        auto phase = outputTimings.BeginPhase("Write LLVM bitcode");
         compiledMap.WriteCode(baseFilename + ".bc", emitters::ModuleOutputFormat::bitcode);
     }
     if (compileArguments.outputAssembly || compileArguments.outputObjectCode)
     {
         if (compileArguments.outputAssembly)
         {
-            TimingOutputCollector timer(timingOutput, "Time to save assembly code", compileArguments.verbose);
+            TimingOutputCollector timer(timingOutput, "Time to save assembly code" + timingSuffix, compileArguments.verbose);
+            auto phase = outputTimings.BeginPhase("Generate assembly code");
             compiledMap.WriteCode(baseFilename + ".s", emitters::ModuleOutputFormat::assembly);
         }
         if (compileArguments.outputObjectCode)
         {
-            TimingOutputCollector timer(timingOutput, "Time to save object code", compileArguments.verbose);
+            TimingOutputCollector timer(timingOutput, "Time to save object code" + timingSuffix, compileArguments.verbose);
+            auto phase = outputTimings.BeginPhase("Generate object code");
             compiledMap.WriteCode(baseFilename + GetObjExtension(compiledMap), emitters::ModuleOutputFormat::objectCode);
         }
     }
+    if (compileArguments.outputMemoryReport)
+    {
+        TimingOutputCollector timer(timingOutput, "Time to save memory report" + timingSuffix, compileArguments.verbose);
+        auto phase = outputTimings.BeginPhase("Write memory report");
+        auto reportStream = utilities::OpenOfstream(baseFilename + "_memory.txt");
+        model::WriteMemoryReport(compiledMap.GetMemoryReport(), reportStream);
+    }
+    if (compiledMap.HasExternalWeights())
+    {
+        TimingOutputCollector timer(timingOutput, "Time to save external weights" + timingSuffix, compileArguments.verbose);
+        auto phase = outputTimings.BeginPhase("Write external weights");
+        compiledMap.WriteExternalWeights(baseFilename + ".weights");
+    }
     if (compileArguments.outputSwigInterface)
     {
-        TimingOutputCollector timer(timingOutput, "Time to save SWIG interface", compileArguments.verbose);
+        TimingOutputCollector timer(timingOutput, "Time to save SWIG interface" + timingSuffix, compileArguments.verbose);
+        auto phase = outputTimings.BeginPhase("Write SWIG interface");
         compiledMap.WriteCodeHeader(baseFilename + ".i.h", emitters::ModuleOutputFormat::cHeader);
         compiledMap.WriteCode(baseFilename + ".i", emitters::ModuleOutputFormat::swigInterface);
     }
 
-    if (compileArguments.verbose)
+    if (compileArguments.outputRemarks)
+    {
+        timingOutput << "Optimization remarks" << timingSuffix << ":\n";
+        model::WriteOptimizationRemarks(compiledMap.GetOptimizationRemarks(), timingOutput);
+    }
+
+    if (compileArguments.outputTimings)
+    {
+        auto report = compiledMap.GetCompileTimingReport();
+        report.Append(outputTimings);
+        timingOutput << "Compile phases" << timingSuffix << ":\n";
+        model::WriteCompileTimingReport(report, timingOutput);
+    }
+}
+
+// Names that --target accepts select a known device, and other names are taken as the CPU to compile for
+emitters::TargetDevice GetTargetDeviceForName(const std::string& name)
+{
+    emitters::TargetDevice targetDevice;
+    if (emitters::IsKnownTargetDeviceName(name))
+    {
+        targetDevice.deviceName = name;
+    }
+    else
+    {
+        targetDevice.cpu = name;
+    }
+    return targetDevice;
+}
+
+std::vector<std::string> GetTargetNames(const std::string& targets)
+{
+    std::vector<std::string> names;
+    for (const auto& name : utilities::Split(targets, ','))
+    {
+        if (!name.empty() && std::find(names.begin(), names.end(), name) == names.end())
+        {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+// Compiles the map for each target on the host thread pool. The target-independent work (loading the map and
+// applying the options metadata) is done once by the caller; each target compiles its own copy of the map into
+// its own LLVM module and context.
+void CompileMapOutputForTargets(const ParsedCompileArguments& compileArguments, const model::MapCompilerOptions& settings, const model::ModelOptimizerOptions& optimizerOptions, const model::Map& map, const std::string& baseFilename, std::ostream& timingOutput)
+{
+    auto targetNames = GetTargetNames(compileArguments.targets);
+    auto numTargets = targetNames.size();
+
+    // Copy the map for each target before starting, so the tasks don't share any model
+    std::vector<model::Map> maps(numTargets, map);
+    std::vector<std::stringstream> timingOutputs(numTargets);
+    std::atomic<size_t> nextTarget{ 0 };
+    auto compileTargets = [&]() {
+        for (auto target = nextTarget++; target < numTargets; target = nextTarget++)
+        {
+            const auto& targetName = targetNames[target];
+            auto targetSettings = settings;
+            targetSettings.compilerSettings.targetDevice = GetTargetDeviceForName(targetName);
+
+            auto targetDirectory = utilities::JoinPaths(utilities::GetDirectoryPath(baseFilename), targetName);
+            utilities::EnsureDirectoryExists(targetDirectory);
+            auto targetBaseFilename = utilities::JoinPaths(targetDirectory, utilities::GetFileName(baseFilename));
+            CompileMapOutput(compileArguments, targetSettings, optimizerOptions, std::move(maps[target]), targetBaseFilename, " (" + targetName + ")", timingOutputs[target]);
+        }
+    };
+
+    auto numThreads = compileArguments.numCompileThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : compileArguments.numCompileThreads;
+    auto numWorkers = std::min(static_cast<size_t>(numThreads), numTargets);
+    std::vector<std::future<void>> workers;
+    for (size_t worker = 1; worker < numWorkers; ++worker)
+    {
+        workers.push_back(utilities::GetHostThreadPool().AddTask(compileTargets));
+    }
+    compileTargets();
+    for (auto& worker : workers)
+    {
+        utilities::GetHostThreadPool().GetResult(worker);
+    }
+
+    for (const auto& output : timingOutputs)
+    {
+        timingOutput << output.str();
+    }
+}
+
+void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMapCompilerArguments& mapCompilerArguments, common::MapLoadArguments& mapLoadArguments, model::Map& map)
+{
+    std::stringstream timingOutput;
+
+    auto inputFilename = mapLoadArguments.GetInputFilename();
+    auto outputDirectory = compileArguments.outputDirectory;
+
+    auto baseFilename = compileArguments.outputFilenameBase;
+    if (baseFilename.empty())
+    {
+        baseFilename = utilities::RemoveFileExtension(inputFilename);
+    }
+    if (!outputDirectory.empty())
+    {
+        ell::utilities::EnsureDirectoryExists(outputDirectory);
+        baseFilename = utilities::JoinPaths(outputDirectory, utilities::GetFileName(baseFilename));
+    }
+
+    model::MapCompilerOptions settings = mapCompilerArguments.GetMapCompilerOptions(baseFilename);
+
+    // Add model/node-specific parameters to metadata
+    utilities::PropertyBag properties;
+    if (!compileArguments.profileDataFilename.empty())
+    {
+        properties = GetProfileGuidedOptionsMetadata(compileArguments);
+    }
+    if (mapCompilerArguments.HasOptionsMetadata())
+    {
+        AddOptionsMetadata(mapCompilerArguments.GetOptionsMetadata(), properties);
+    }
+    if (!properties.IsEmpty())
+    {
+        model::SetCompilerOptionsTransformation setOptionsTranformation(properties);
+        map.Transform(setOptionsTranformation);
+    }
+
+    if (compileArguments.outputMapWithOptions)
+    {
+        common::SaveMap(map, baseFilename + "_options.ell");
+    }
+
+    if (compileArguments.outputRefinedMap)
+    {
+        TimingOutputCollector timer(timingOutput, "Time to refine map", compileArguments.verbose);
+        map.Refine(compileArguments.maxRefinementIterations);
+        timer.Stop();
+        common::SaveMap(map, baseFilename + "_refined.ell");
+    }
+
+    auto optimizerOptions = mapCompilerArguments.GetModelOptimizerOptions();
+    if (GetTargetNames(compileArguments.targets).empty())
+    {
+        CompileMapOutput(compileArguments, settings, optimizerOptions, map, baseFilename, "", timingOutput);
+    }
+    else
+    {
+        CompileMapOutputForTargets(compileArguments, settings, optimizerOptions, map, baseFilename, timingOutput);
+    }
+
+    if (compileArguments.verbose || compileArguments.outputTimings || compileArguments.outputRemarks)
     {
         std::cout << timingOutput.str();
     }
@@ -215,6 +438,7 @@ int main(int argc, char* argv[])
         commandLineParser.Parse();
 
         ShouldLog() = compileArguments.verbose;
+        TraceFile traceFile(compileArguments.traceFilename);
 
         // if no input specified, print help and exit
         if (!mapLoadArguments.HasInputFilename())
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDatasetFromImagesArguments.h (datasetFromImages)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <string>
+
+namespace ell
+{
+/// <summary> The order of the columns of an example list. </summary>
+enum class ExampleOrder
+{
+    labelFirst,
+    fileFirst
+};
+
+/// <summary> Command line arguments for the binaryDatasetFromImages executable. </summary>
+struct BinaryDatasetFromImagesArguments
+{
+    /// <summary> Path to a file listing the examples, one label and image path per line. </summary>
+    std::string exampleList;
+
+    /// <summary> The order of the columns of the example list. </summary>
+    ExampleOrder exampleOrder = ExampleOrder::labelFirst;
+
+    /// <summary> Path to a folder with a sub-folder of images for each class. </summary>
+    std::string folder;
+
+    /// <summary> Path to a file with the class names, one per line, in the order of their indices. </summary>
+    std::string categories;
+
+    /// <summary> The class whose examples get the label 1 in a binary classification dataset, or empty for a multi-class dataset. </summary>
+    std::string positiveCategory;
+
+    /// <summary> The size each image is cropped and scaled to, as "<width>x<height>". </summary>
+    std::string imageSize;
+
+    /// <summary> Whether to store the channels in BGR order (like OpenCV) instead of RGB. </summary>
+    bool bgr = true;
+
+    /// <summary> Path of the binary dataset file to write. </summary>
+    std::string outputDataset;
+
+    /// <summary> The width and height parsed from imageSize. </summary>
+    size_t width = 0;
+    size_t height = 0;
+};
+
+/// <summary> Parsed command line arguments for the binaryDatasetFromImages executable. </summary>
+struct ParsedBinaryDatasetFromImagesArguments : public BinaryDatasetFromImagesArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+
+    /// <summary> Check the parsed arguments. </summary>
+    ///
+    /// <param name="parser"> The parser. </param>
+    ///
+    /// <returns> An utilities::CommandLineParseResult. </returns>
+    utilities::CommandLineParseResult PostProcess(const utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDatasetFromImagesArguments.cpp (datasetFromImages)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDatasetFromImagesArguments.h"
+
+#include <cstdio>
+
+namespace ell
+{
+void ParsedBinaryDatasetFromImagesArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        exampleList,
+        "exampleList",
+        "",
+        "Path to the file containing the list of examples, where each line is a label number followed by whitespace and the path to a PPM or PGM image",
+        "");
+
+    parser.AddOption(
+        exampleOrder,
+        "exampleOrder",
+        "",
+        "The order of the columns in the example list",
+        { { "labelfirst", ExampleOrder::labelFirst }, { "filefirst", ExampleOrder::fileFirst } },
+        "labelfirst");
+
+    parser.AddOption(
+        folder,
+        "folder",
+        "",
+        "Path to a folder, with sub-folders containing PPM or PGM images. Each sub-folder is a class and the images inside are the examples of that class",
+        "");
+
+    parser.AddOption(
+        categories,
+        "categories",
+        "",
+        "If examples define a multi-class classification, the file with the class names, one per line, in the order of their indices (blank to write categories.txt next to the output dataset)",
+        "");
+
+    parser.AddOption(
+        positiveCategory,
+        "positiveCategory",
+        "",
+        "If examples define a binary classification (e.g. A, not A), the class whose examples get the label 1 (the others get -1)",
+        "");
+
+    parser.AddOption(
+        imageSize,
+        "imageSize",
+        "",
+        "Each image is cropped to this aspect ratio around its center and scaled to width x height, e.g. 224x224",
+        "224x224");
+
+    parser.AddOption(
+        bgr,
+        "bgr",
+        "",
+        "Store the channels in BGR order, like images read with OpenCV (otherwise RGB)",
+        true);
+
+    parser.AddOption(
+        outputDataset,
+        "outputDataset",
+        "",
+        "Path of the binary dataset file to write",
+        "dataset.bin");
+}
+
+utilities::CommandLineParseResult ParsedBinaryDatasetFromImagesArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> errors;
+    if (exampleList.empty() == folder.empty())
+    {
+        errors.push_back("Exactly one of exampleList and folder must be given");
+    }
+
+    unsigned long parsedWidth = 0;
+    unsigned long parsedHeight = 0;
+    int numParsedCharacters = 0;
+    if (std::sscanf(imageSize.c_str(), "%lux%lu%n", &parsedWidth, &parsedHeight, &numParsedCharacters) != 2 || numParsedCharacters != static_cast<int>(imageSize.size()) || parsedWidth == 0 || parsedHeight == 0)
+    {
+        errors.push_back("imageSize must be of the form <width>x<height>");
+    }
+    width = parsedWidth;
+    height = parsedHeight;
+    return errors;
+}
+} // namespace ell
@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (datasetFromImages)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDatasetFromImagesArguments.h"
+
+#include <data/include/AutoDataVector.h>
+#include <data/include/BinaryDataset.h>
+#include <data/include/Example.h>
+
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/ImageTransforms.h>
+#include <utilities/include/MillisecondTimer.h>
+#include <utilities/include/PPMImageParser.h>
+#include <utilities/include/ParallelTransformIterator.h>
+#include <utilities/include/StlContainerIterator.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+struct ImageExample
+{
+    double label;
+    std::string path;
+};
+
+struct DecodedExample
+{
+    bool isValid = false;
+    data::AutoSupervisedExample example;
+    std::string error;
+};
+
+std::map<std::string, size_t> LoadCategories(const std::string& filename)
+{
+    std::map<std::string, size_t> categories;
+    auto stream = utilities::OpenIfstream(filename);
+    std::string name;
+    while (std::getline(stream, name))
+    {
+        categories.emplace(name, categories.size());
+    }
+    return categories;
+}
+
+std::vector<ImageExample> GetExamplesFromList(const std::string& filename, ExampleOrder order)
+{
+    std::vector<ImageExample> examples;
+    auto stream = utilities::OpenIfstream(filename);
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        ++lineNumber;
+        std::istringstream lineStream(line);
+        std::string first;
+        std::string second;
+        lineStream >> first >> std::ws;
+        std::getline(lineStream, second);
+        if (first.empty())
+        {
+            continue;
+        }
+
+        auto& label = order == ExampleOrder::labelFirst ? first : second;
+        auto& path = order == ExampleOrder::labelFirst ? second : first;
+        try
+        {
+            examples.push_back({ std::stod(label), path });
+        }
+        catch (const std::exception&)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::badStringFormat, "Couldn't parse line " + std::to_string(lineNumber) + " of " + filename);
+        }
+    }
+    return examples;
+}
+
+// Each sub-folder is a class, whose label is either 1 or -1 (if there's a positive category) or its index in the categories
+std::vector<ImageExample> GetExamplesFromFolder(const BinaryDatasetFromImagesArguments& arguments)
+{
+    std::vector<std::string> classNames;
+    for (const auto& entry : std::filesystem::directory_iterator(arguments.folder))
+    {
+        if (entry.is_directory())
+        {
+            classNames.push_back(entry.path().filename().string());
+        }
+    }
+    std::sort(classNames.begin(), classNames.end());
+
+    std::map<std::string, size_t> categories;
+    if (!arguments.categories.empty())
+    {
+        categories = LoadCategories(arguments.categories);
+    }
+
+    std::vector<ImageExample> examples;
+    for (const auto& className : classNames)
+    {
+        double label = 0;
+        if (!arguments.positiveCategory.empty())
+        {
+            label = className == arguments.positiveCategory ? 1.0 : -1.0;
+        }
+        else
+        {
+            label = static_cast<double>(categories.emplace(className, categories.size()).first->second);
+        }
+
+        std::vector<std::string> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::path(arguments.folder) / className))
+        {
+            if (entry.is_regular_file())
+            {
+                paths.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        for (const auto& path : paths)
+        {
+            examples.push_back({ label, path });
+        }
+    }
+
+    if (arguments.positiveCategory.empty() && arguments.categories.empty())
+    {
+        std::vector<std::string> names(categories.size());
+        for (const auto& category : categories)
+        {
+            names[category.second] = category.first;
+        }
+
+        auto filename = utilities::JoinPaths(utilities::GetDirectoryPath(arguments.outputDataset), "categories.txt");
+        auto stream = utilities::OpenOfstream(filename);
+        for (const auto& name : names)
+        {
+            stream << name << "\n";
+        }
+        std::cout << "Wrote class category labels to " << filename << std::endl;
+    }
+    return examples;
+}
+
+// Crops and scales the image and stores it row by row, with the channels of each pixel together, the layout ELL models take.
+// Grayscale images are stored with 3 equal channels, so all the examples have the same size.
+DecodedExample DecodeImage(const ImageExample& example, size_t width, size_t height, bool bgr)
+{
+    DecodedExample result;
+    try
+    {
+        auto image = utilities::ParsePPMFile<int>(example.path);
+        image = utilities::ResizeImage(utilities::CenterCropImage(image, width, height), width, height);
+
+        const size_t numChannels = 3;
+        auto planeSize = width * height;
+        std::vector<double> values(planeSize * numChannels);
+        for (size_t pixel = 0; pixel < planeSize; ++pixel)
+        {
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                auto sourceChannel = std::min(bgr ? numChannels - 1 - channel : channel, image.numChannels - 1);
+                values[pixel * numChannels + channel] = image.data[sourceChannel * planeSize + pixel];
+            }
+        }
+
+        result.example = data::AutoSupervisedExample(data::AutoDataVector(std::move(values)), data::WeightLabel{ 1.0, example.label });
+        result.isValid = true;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        result.error = exception.GetMessage();
+    }
+    return result;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        ParsedBinaryDatasetFromImagesArguments arguments;
+        commandLineParser.AddOptionSet(arguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        utilities::MillisecondTimer timer;
+        auto examples = arguments.exampleList.empty() ? GetExamplesFromFolder(arguments) : GetExamplesFromList(arguments.exampleList, arguments.exampleOrder);
+        std::cout << "Processing " << examples.size() << " examples, using image size " << arguments.width << "x" << arguments.height << ", bgr=" << arguments.bgr << std::endl;
+
+        auto outputStream = utilities::OpenBinaryOfstream(arguments.outputDataset);
+        data::BinaryDatasetWriter writer(outputStream);
+
+        // The images are decoded on the host thread pool, and written in order as they complete
+        auto exampleIterator = utilities::MakeStlContainerIterator(examples);
+        auto decodedIterator = utilities::MakeParallelTransformIterator(exampleIterator, [&arguments](const ImageExample& example) {
+            return DecodeImage(example, arguments.width, arguments.height, arguments.bgr);
+        });
+
+        size_t numWritten = 0;
+        for (size_t index = 0; decodedIterator.IsValid(); decodedIterator.Next(), ++index)
+        {
+            auto decoded = decodedIterator.Get();
+            if (!decoded.isValid)
+            {
+                std::cerr << "Skipping " << examples[index].path << ", could not open as an image: " << decoded.error << std::endl;
+                continue;
+            }
+            writer.Write(decoded.example);
+            ++numWritten;
+        }
+        writer.Close();
+
+        std::cout << "Wrote " << numWritten << " examples to " << arguments.outputDataset << " in " << timer.Elapsed() / 1000.0 << " seconds" << std::endl;
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
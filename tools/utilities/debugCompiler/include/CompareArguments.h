@@ -29,6 +29,11 @@ struct CompareArguments
     bool writeReport = true;
     bool writeGraph = true;
     bool writePrediction = true;
+
+    // comparison options
+    size_t numLayerSamples = 0;
+    double tolerance = 0;
+    bool parallel = true;
 };
 
 /// <summary> Arguments for parsed print. </summary>
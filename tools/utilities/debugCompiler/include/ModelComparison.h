@@ -25,20 +25,36 @@
 
 #include <utilities/include/Graph.h>
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <vector>
 
 namespace ell
 {
+/// <summary> Options that trade the thoroughness of a comparison for speed. </summary>
+struct ModelComparisonOptions
+{
+    /// <summary> The number of sampled output coordinates to compare per layer, or 0 to compare all of them. </summary>
+    size_t numLayerSamples = 0;
+
+    /// <summary> Stop at the first layer whose largest absolute difference exceeds this, or 0 to compare every layer. </summary>
+    double tolerance = 0;
+
+    /// <summary> Run the compiled map on another thread while the reference map is evaluated. </summary>
+    bool parallel = false;
+};
+
 class ModelComparison
 {
 public:
     /// <summary> Constructor </summary>
     ///
     /// <param name="outputDirectory"> The directory the output files will be written to. </param>
-    ModelComparison(std::string outputDirectory);
+    /// <param name="options"> The comparison options. </param>
+    ModelComparison(std::string outputDirectory, const ModelComparisonOptions& options = {});
 
     /// <summary> Compares the "reference" output vs. compiled otuput of a map. </summary>
     ///
@@ -83,8 +99,9 @@ public:
     ///
     /// <param name="label"> The label for the layer. </param>
     /// <param name="output"> The output data for the layer. </param>
+    /// <param name="compiled"> Indicates whether the output is from the compiled map rather than the reference one. </param>
     template <typename ValueType>
-    void AddLayer(const char* label, const ValueType* output);
+    void AddLayer(const char* label, const ValueType* output, bool compiled);
 
 private:
     struct LayerCaptureData
@@ -99,6 +116,12 @@ private:
         std::vector<int> offset;
         std::vector<float> referenceData;
         std::vector<float> compiledData;
+
+        // the compared values (all of the valid elements, or a sample of them) and their largest absolute difference
+        std::vector<float> referenceValues;
+        std::vector<float> compiledValues;
+        double maxAbsDiff = 0;
+        bool compared = false;
     };
 
     void AddDebugOutputNode(model::ModelTransformer& transformer, const model::Node& node);
@@ -106,6 +129,8 @@ private:
     void AddDebugOutputNode(model::ModelTransformer& transformer, const nodes::NeuralNetworkLayerNodeBase<ValueType>* layerNode);
 
     void SetUpReferenceMap(model::Map& map);
+    void CompareLayer(LayerCaptureData& layerData);
+    std::vector<size_t> GetComparedIndices(const LayerCaptureData& layerData) const;
     void CreateGraph(const model::Model& model);
     void AddStyles();
     void WriteModelInfo(std::ostream& outputStream, const std::vector<float>& reference, const std::vector<float>& compiled, bool writePrediction);
@@ -123,7 +148,12 @@ private:
     std::vector<float> _outputReference;
     std::vector<float> _outputCompiled;
     std::string _outputDirectory;
-    bool _runningCompiled;
+    ModelComparisonOptions _options;
+    std::atomic<bool> _captureCompiledLayers;
+    std::atomic<bool> _stopReference;
+    std::mutex _layerMutex;
+    std::string _firstDivergentLayer;
+    double _firstDivergentLayerDiff;
     std::vector<LayerCaptureData> _layerOutputData;
     size_t _nextIndex;
     double _minError;
@@ -21,5 +21,10 @@ void ParsedCompareArguments::AddArgs(utilities::CommandLineParser& parser)
     parser.AddOption(writeReport, "report", "", "Generate markdown report", true);
     parser.AddOption(writeGraph, "graph", "", "Write DGML graph", true);
     parser.AddOption(writePrediction, "pred", "", "Write prediction to report", true);
+
+    parser.AddDocumentationString("Comparison options");
+    parser.AddOption(numLayerSamples, "layerSamples", "ls", "Number of sampled output coordinates to compare per layer (0 compares all of them)", 0);
+    parser.AddOption(tolerance, "tolerance", "tol", "Stop at the first layer whose largest absolute difference exceeds this (0 compares every layer)", 0.0);
+    parser.AddOption(parallel, "parallel", "", "Run the compiled map while the reference map is evaluated", true);
 }
 } // namespace ell
@@ -18,7 +18,14 @@
 
 #include <utilities/include/Files.h>
 #include <utilities/include/Graph.h>
-
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <iterator>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
 
@@ -28,7 +35,7 @@ void DebugOutput(char* label, float* output, void* userData)
     if (userData != nullptr)
     {
         ell::ModelComparison* self = static_cast<ell::ModelComparison*>(userData);
-        self->AddLayer(label, output);
+        self->AddLayer(label, output, true);
     }
 }
 const float* _input = nullptr;
@@ -228,13 +235,44 @@ std::vector<float> GetMapOutput(model::Map& map, const std::vector<float>& input
     }
 }
 
+template <typename InputType>
+void SetMapInput(model::Map& map, const std::vector<float>& input)
+{
+    std::vector<InputType> typedInput(input.begin(), input.end());
+    map.SetInputValue(0, typedInput);
+}
+
+void SetMapInput(model::Map& map, const std::vector<float>& input)
+{
+    switch (map.GetInputType())
+    {
+    case model::Port::PortType::smallReal:
+        SetMapInput<float>(map, input);
+        break;
+    case model::Port::PortType::real:
+        SetMapInput<double>(map, input);
+        break;
+    case model::Port::PortType::integer:
+        SetMapInput<int>(map, input);
+        break;
+    case model::Port::PortType::bigInt:
+        SetMapInput<int64_t>(map, input);
+        break;
+    default:
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Model has an unsupported input type");
+    }
+}
+
 //
 // ModelComparison implementation
 //
-ModelComparison::ModelComparison(std::string outputDirectory)
+ModelComparison::ModelComparison(std::string outputDirectory, const ModelComparisonOptions& options) :
+    _options(options),
+    _captureCompiledLayers(true),
+    _stopReference(false),
+    _firstDivergentLayerDiff(0)
 {
     _outputDirectory = outputDirectory;
-    _runningCompiled = false;
     _addingReference = false;
     _minError = 0;
     _maxError = 0;
@@ -342,10 +380,6 @@ void ModelComparison::Compare(std::vector<float>& input, model::Map& reference,
     // build the graph
     CreateGraph(compiledMap.GetModel());
 
-    // Compute reference output
-    _runningCompiled = false;
-    _outputReference = GetMapOutput(_referenceMap, input);
-
     // Gather the reference model DebugSinkNode outputs
     std::vector<const ell::model::OutputPortBase*> referenceOutputs;
     for (size_t i = 0, length = _layerOutputData.size(); i < length; i++)
@@ -357,15 +391,6 @@ void ModelComparison::Compare(std::vector<float>& input, model::Map& reference,
         }
     }
 
-    // Now the normal reference.Compute will skip my DebugSinkNodes, so now I have to do another VisitSubmodel to gather that output.
-    // This will cause the DebugSinkNode Sink function to fire which will call AddLayer below.
-    auto compute = [](const model::Node& node) { node.Compute(); };
-    _referenceMap.GetModel().VisitSubmodel(referenceOutputs, compute);
-
-    // Compute compiled output
-    _runningCompiled = true;
-    _outputCompiled = GetMapOutput(compiledMap, input);
-
     // The reference model is run a second time to gather the per-node outputs. We
     // need to do the same thing for the compiled one, so that stateful models will
     // match appropriately.
@@ -374,7 +399,60 @@ void ModelComparison::Compare(std::vector<float>& input, model::Map& reference,
     // This means that the "overall" stats don't actually report a summary of the per-node stats.
     // We should fix this eventually to collect per-node and overall outputs during the same run
     // of the reference model.
-    auto temp = GetMapOutput(compiledMap, input);
+    // When stopping at the first layer past the tolerance, both maps are only run once, with the layers captured.
+    auto computeCompiled = [this, &compiledMap, &input]() {
+        if (_options.tolerance <= 0)
+        {
+            _captureCompiledLayers = false;
+            _outputCompiled = GetMapOutput(compiledMap, input);
+        }
+        _captureCompiledLayers = true;
+        auto temp = GetMapOutput(compiledMap, input);
+    };
+
+    // The compiled map only touches its own state and the compiled halves of the layer data, so it can run while the
+    // reference map is interpreted
+    std::future<void> compiledTask;
+    if (_options.parallel)
+    {
+        compiledTask = utilities::GetHostThreadPool().AddTask(computeCompiled);
+    }
+    else
+    {
+        computeCompiled();
+    }
+
+    // Compute reference output. When stopping at the first layer past the tolerance, the overall output is
+    // skipped, so the only reference interpretation is the per-layer one below, which can stop early.
+    if (_options.tolerance > 0)
+    {
+        SetMapInput(_referenceMap, input);
+    }
+    else
+    {
+        _outputReference = GetMapOutput(_referenceMap, input);
+    }
+
+    // Now the normal reference.Compute will skip my DebugSinkNodes, so now I have to do another VisitSubmodel to gather that output.
+    // This will cause the DebugSinkNode Sink function to fire which will call AddLayer below.
+    // Once a layer diverges past the tolerance, the remaining nodes aren't computed.
+    auto compute = [this](const model::Node& node) {
+        if (!_stopReference)
+        {
+            node.Compute();
+        }
+    };
+    _referenceMap.GetModel().VisitSubmodel(referenceOutputs, compute);
+
+    if (compiledTask.valid())
+    {
+        utilities::GetHostThreadPool().GetResult(compiledTask);
+    }
+
+    if (!_firstDivergentLayer.empty())
+    {
+        std::cout << "layer " << _firstDivergentLayer << " differs by " << _firstDivergentLayerDiff << ", more than the tolerance of " << _options.tolerance << std::endl;
+    }
 }
 
 void ModelComparison::SaveOutput(std::string name, const std::vector<float>& reference, const std::vector<float>& compiled)
@@ -395,7 +473,9 @@ void ModelComparison::SaveOutput(std::string name, const std::vector<float>& ref
 
 size_t ModelComparison::GetOutputSize(const std::string& nodeId)
 {
-    return _outputSizes[nodeId];
+    // Called from the reference and compiled callbacks at the same time, so this mustn't insert into the map
+    auto iter = _outputSizes.find(nodeId);
+    return iter == _outputSizes.end() ? 0 : iter->second;
 }
 
 void ModelComparison::WriteReport(std::ostream& outputStream, std::string modelName, const std::vector<std::string>& testArgs, bool writePrediction)
@@ -413,6 +493,16 @@ void ModelComparison::WriteReport(std::ostream& outputStream, std::string modelN
     outputStream << std::endl;
 
     WriteModelInfo(outputStream, _outputReference, _outputCompiled, writePrediction);
+    if (_options.numLayerSamples > 0)
+    {
+        outputStream << "Layer statistics are computed on " << _options.numLayerSamples << " sampled output coordinates per layer." << std::endl;
+        outputStream << std::endl;
+    }
+    if (!_firstDivergentLayer.empty())
+    {
+        outputStream << "**first layer past tolerance**: " << _firstDivergentLayer << " (largest absolute difference " << _firstDivergentLayerDiff << ", tolerance " << _options.tolerance << ")" << std::endl;
+        outputStream << std::endl;
+    }
     for (auto& layerData : _layerOutputData)
     {
         if (layerData.compiledNodeLabel != "")
@@ -445,6 +535,15 @@ void ModelComparison::WriteStatsRow(std::ostream& outputStream, const VectorStat
 
 void ModelComparison::WriteModelInfo(std::ostream& outputStream, const std::vector<float>& reference, const std::vector<float>& compiled, bool writePrediction)
 {
+    if (_options.tolerance > 0)
+    {
+        // The overall outputs aren't computed when stopping at the first layer past the tolerance
+        outputStream << "## Overall model" << std::endl;
+        outputStream << "Skipped, because the comparison stops at the first layer past the tolerance" << std::endl;
+        outputStream << std::endl;
+        return;
+    }
+
     if (compiled.size() == 0)
     {
         // Layer was pruned from compiled model
@@ -493,23 +592,31 @@ void ModelComparison::WriteNodeRow(std::ostream& outputStream, std::string id, s
         return;
     }
 
-    SaveOutput("Compare_" + name, reference, compiled);
-
-    outputStream << "## " << name << std::endl;
+    if (!layerData.compared || layerData.referenceValues.empty())
+    {
+        // Layer wasn't reached by the reference model before the comparison stopped
+        return;
+    }
 
-    // Get mem layout, extract relevant part, get subtensor
-    math::ChannelColumnRowTensor<float> refTensor(layerData.stride[0], layerData.stride[1], layerData.stride[2], reference);
-    math::ChannelColumnRowTensor<float> compiledTensor(layerData.stride[0], layerData.stride[1], layerData.stride[2], compiled);
-    math::ChannelColumnRowTensor<float> diffTensor(layerData.stride[0], layerData.stride[1], layerData.stride[2], Abs(Subtract(reference, compiled)));
+    // The compared values are the valid part of the layer's output, or a sample of it
+    const auto& referenceValues = layerData.referenceValues;
+    const auto& compiledValues = layerData.compiledValues;
+    if (_options.numLayerSamples > 0)
+    {
+        SaveOutput("Compare_" + name, referenceValues, compiledValues);
+    }
+    else
+    {
+        SaveOutput("Compare_" + name, reference, compiled);
+    }
 
-    auto validRefTensor = refTensor.GetSubTensor(layerData.offset[0], layerData.offset[1], layerData.offset[2], layerData.size[0], layerData.size[1], layerData.size[2]);
-    auto validCompiledTensor = compiledTensor.GetSubTensor(layerData.offset[0], layerData.offset[1], layerData.offset[2], layerData.size[0], layerData.size[1], layerData.size[2]);
+    outputStream << "## " << name << std::endl;
 
-    VectorStatistics refStats(validRefTensor);
-    VectorStatistics compiledStats(validCompiledTensor);
-    VectorStatistics diffStats(Abs(Subtract(validRefTensor, validCompiledTensor)));
+    VectorStatistics refStats(referenceValues);
+    VectorStatistics compiledStats(compiledValues);
+    VectorStatistics diffStats(Abs(Subtract(referenceValues, compiledValues)));
 
-    float absDiffSum = VectorStatistics::Diff(validRefTensor, validCompiledTensor);
+    float absDiffSum = VectorStatistics::Diff(referenceValues, compiledValues);
     if (!_hasMinMax)
     {
         _minError = _maxError = absDiffSum;
@@ -641,46 +748,110 @@ void ModelComparison::AddStyles()
 }
 
 template <typename ValueType>
-void ModelComparison::AddLayer(const char* label, const ValueType* output)
+void ModelComparison::AddLayer(const char* label, const ValueType* output, bool compiled)
 {
+    if (compiled && !_captureCompiledLayers)
+    {
+        return;
+    }
+
     std::string id(label);
     size_t size = GetOutputSize(id);
     std::vector<float> data(output, output + size);
-    if (_runningCompiled)
+
+    // The reference and compiled maps may be computed on different threads
+    std::lock_guard<std::mutex> lock(_layerMutex);
+    LayerCaptureData* found = nullptr;
+    for (auto& layerData : _layerOutputData)
     {
-        bool found = false;
-        for (auto& layerData : _layerOutputData)
+        if (compiled)
         {
-            std::string compiledId = _nodeMap[layerData.referenceNodeLabel];
-            if (compiledId == id)
+            auto compiledId = _nodeMap.find(layerData.referenceNodeLabel);
+            if (compiledId != _nodeMap.end() && compiledId->second == id)
             {
-                found = true;
-                layerData.compiledData = { data.begin(), data.end() };
+                layerData.compiledData = std::move(data);
+                found = &layerData;
                 break;
             }
         }
-        if (!found)
+        else if (layerData.referenceNodeLabel == id)
         {
-            std::cout << "### Error: could not find LayerCaptureData for compiled layer " << id << std::endl;
+            layerData.referenceData = std::move(data);
+            found = &layerData;
+            break;
         }
     }
-    else
+
+    if (found == nullptr)
+    {
+        std::cout << "### Error: could not find LayerCaptureData for " << (compiled ? "compiled" : "reference") << " layer " << id << std::endl;
+    }
+    else if (!found->referenceData.empty() && !found->compiledData.empty())
     {
-        bool found = false;
-        for (auto& layerData : _layerOutputData)
+        CompareLayer(*found);
+    }
+}
+
+std::vector<size_t> ModelComparison::GetComparedIndices(const LayerCaptureData& layerData) const
+{
+    // The valid part of the output is the active area of its memory layout, in (row, column, channel) order
+    std::vector<size_t> indices;
+    if (layerData.size.size() == 3 && layerData.stride.size() == 3 && layerData.offset.size() == 3)
+    {
+        for (int row = 0; row < layerData.size[0]; ++row)
         {
-            if (layerData.referenceNodeLabel == id)
+            for (int column = 0; column < layerData.size[1]; ++column)
             {
-                layerData.referenceData = { data.begin(), data.end() };
-                found = true;
-                break;
+                auto rowStart = (static_cast<size_t>(row + layerData.offset[0]) * layerData.stride[1] + (column + layerData.offset[1])) * layerData.stride[2] + layerData.offset[2];
+                for (int channel = 0; channel < layerData.size[2]; ++channel)
+                {
+                    indices.push_back(rowStart + channel);
+                }
             }
         }
-        if (!found)
+    }
+    else
+    {
+        indices.resize(std::min(layerData.referenceData.size(), layerData.compiledData.size()));
+        std::iota(indices.begin(), indices.end(), 0);
+    }
+
+    // Sample with a fixed seed, so that runs with the same options compare the same coordinates
+    if (_options.numLayerSamples > 0 && _options.numLayerSamples < indices.size())
+    {
+        std::vector<size_t> samples;
+        samples.reserve(_options.numLayerSamples);
+        std::default_random_engine engine(0);
+        std::sample(indices.begin(), indices.end(), std::back_inserter(samples), _options.numLayerSamples, engine);
+        indices = std::move(samples);
+    }
+    return indices;
+}
+
+void ModelComparison::CompareLayer(LayerCaptureData& layerData)
+{
+    const auto& reference = layerData.referenceData;
+    const auto& compiled = layerData.compiledData;
+    layerData.referenceValues.clear();
+    layerData.compiledValues.clear();
+    layerData.maxAbsDiff = 0;
+    for (auto index : GetComparedIndices(layerData))
+    {
+        if (index < reference.size() && index < compiled.size())
         {
-            std::cout << "### Error: could not find LayerCaptureData for reference layer " << id << std::endl;
+            layerData.referenceValues.push_back(reference[index]);
+            layerData.compiledValues.push_back(compiled[index]);
+            layerData.maxAbsDiff = std::max(layerData.maxAbsDiff, static_cast<double>(std::fabs(reference[index] - compiled[index])));
         }
     }
+    layerData.compared = true;
+
+    if (_options.tolerance > 0 && _firstDivergentLayer.empty() && layerData.maxAbsDiff > _options.tolerance)
+    {
+        _firstDivergentLayer = layerData.compiledNodeLabel.empty() ? layerData.referenceNodeLabel : layerData.compiledNodeLabel;
+        _firstDivergentLayerDiff = layerData.maxAbsDiff;
+        _stopReference = true;
+    }
 }
 
 void ModelComparison::CreateGraph(const model::Model& model)
@@ -769,7 +940,7 @@ void ModelComparison::AddDebugOutputNode(model::ModelTransformer& transformer, c
     _outputSizes[label] = size;
 
     auto sinkFunction = [this](const std::string& label, const std::vector<ValueType>& output, void* userData) {
-        AddLayer(label.c_str(), output.data());
+        AddLayer(label.c_str(), output.data(), false);
     };
 
     auto sinkNode = transformer.AddNode<ell::nodes::DebugSinkNode<ValueType>>(
@@ -151,7 +151,11 @@ int main(int argc, char* argv[])
 
         auto pluginArgs = commandLineParser.GetPassthroughArgs();
         auto input = GetInputData<TestDataType>(map, compareArguments, pluginArgs);
-        ModelComparison comparison(compareArguments.outputDirectory);
+        ModelComparisonOptions comparisonOptions;
+        comparisonOptions.numLayerSamples = compareArguments.numLayerSamples;
+        comparisonOptions.tolerance = compareArguments.tolerance;
+        comparisonOptions.parallel = compareArguments.parallel;
+        ModelComparison comparison(compareArguments.outputDirectory, comparisonOptions);
 
         model::MapCompilerOptions settings = compileArguments.GetMapCompilerOptions("");
         model::ModelOptimizerOptions optimizerOptions;
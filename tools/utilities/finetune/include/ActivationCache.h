@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ActivationCache.h (finetune)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "DataUtils.h"
+
+#include <model/include/Model.h>
+#include <model/include/OutputPort.h>
+
+#include <utilities/include/MemoryMappedFile.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// The values of model output ports over a dataset, so that evaluating a later part of the model can start from them
+/// instead of from the model's input. A cache holds activations for a single dataset.
+/// </summary>
+class ActivationCache
+{
+public:
+    /// <summary> Constructor </summary>
+    ///
+    /// <param name="directory"> The directory to write activations to and memory-map them from. If empty, they're kept in memory. </param>
+    ActivationCache(std::string directory = "");
+
+    ActivationCache(const ActivationCache&) = delete;
+    ActivationCache& operator=(const ActivationCache&) = delete;
+
+    /// <summary> Removes the files the cache wrote. </summary>
+    ~ActivationCache();
+
+    /// <summary> Checks if the values of a port are in the cache. </summary>
+    bool Contains(const ell::model::OutputPortBase& port) const;
+
+    /// <summary> Adds the values of a port over the dataset to the cache, one example per dataset row. </summary>
+    void Add(const ell::model::OutputPortBase& port, const UnlabeledDataContainer& activations);
+
+    /// <summary>
+    /// Computes the values of several ports of a model over the dataset and adds them to the cache. The part of the model
+    /// that computes them is copied once, and each example is computed in a single pass of it, with the values of every
+    /// port appended to the cache as they're computed.
+    /// </summary>
+    void Add(const ell::model::Model& model, const std::vector<const ell::model::OutputPortBase*>& ports, const UnlabeledDataContainer& dataset);
+
+    /// <summary> Gets the values of a port over the dataset. </summary>
+    UnlabeledDataContainer Get(const ell::model::OutputPortBase& port) const;
+
+    /// <summary> Gets the number of examples the values of a port were cached for. </summary>
+    size_t GetNumExamples(const ell::model::OutputPortBase& port) const;
+
+    /// <summary> Gets the size of each example cached for a port. </summary>
+    size_t GetExampleSize(const ell::model::OutputPortBase& port) const;
+
+    /// <summary> Gets the values of a port for one example. The pointer is valid for the lifetime of the cache. </summary>
+    const float* GetExample(const ell::model::OutputPortBase& port, size_t index) const;
+
+private:
+    struct Entry
+    {
+        size_t numExamples = 0;
+        size_t exampleSize = 0;
+        std::vector<float> data;
+        std::unique_ptr<ell::utilities::MemoryMappedFile> file;
+
+        const float* GetData() const;
+    };
+
+    // Appends examples to a new entry, in memory or in a new file
+    class EntryWriter
+    {
+    public:
+        EntryWriter(ActivationCache& cache, size_t exampleSize);
+        void Append(const float* example);
+        Entry Finish();
+
+    private:
+        ActivationCache& _cache;
+        Entry _entry;
+        std::string _filename;
+        std::ofstream _stream;
+    };
+
+    const Entry& GetEntry(const ell::model::OutputPortBase& port) const;
+
+    std::string _directory;
+    std::vector<std::string> _filenames;
+    std::unordered_map<const ell::model::OutputPortBase*, Entry> _entries;
+};
@@ -29,6 +29,9 @@ struct FineTuneArguments
     bool fineTuneFullyConnectedNodes = true;
     bool fineTuneConvolutionalNodes = true;
 
+    double pruneChannelsThreshold = 0;
+    bool pruneChannelsByActivation = false;
+
     ell::common::ParsedMapSaveArguments mapSaveArguments;
 
     int maxTrainingRows = -1;
@@ -47,6 +50,8 @@ struct FineTuneArguments
     bool permute = false;
     bool normalizeInputs = false;
     bool normalizeOutputs = false;
+    int numThreads = 1;
+    std::string activationCacheDirectory;
 
     std::string reportFilename;
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ActivationCache.h"
 #include "DataUtils.h"
 #include "FineTuneArguments.h"
 #include "OptimizationUtils.h"
@@ -71,6 +72,7 @@ FineTuningDataset<ElementType> GetFullyConnectedFineTuningDataset(const MultiCla
                                                                   ell::model::Model& model,
                                                                   const ell::model::OutputPort<ElementType>& submodelOutput,
                                                                   const ell::model::OutputPort<ElementType>& destination,
+                                                                  ActivationCache& activationCache,
                                                                   bool normalizeFeatures,
                                                                   bool normalizeLabels);
 
@@ -82,6 +84,7 @@ FineTuningDataset<ElementType> GetConvolutionalFineTuningDataset(const MultiClas
                                                                  ell::model::Model& model,
                                                                  const ell::model::OutputPort<ElementType>& submodelOutput,
                                                                  const ell::model::OutputPort<ElementType>& destination,
+                                                                 ActivationCache& activationCache,
                                                                  bool normalizeFeatures,
                                                                  bool normalizeLabels);
 
@@ -99,6 +102,7 @@ FineTuningLayerResult ApproximateSubmodelWithFullyConnectedLayer(const MultiClas
                                                                  ell::model::Model& model,
                                                                  const ell::model::OutputPort<ElementType>& submodelOutput,
                                                                  const ell::model::OutputPort<ElementType>& destination,
+                                                                 ActivationCache& activationCache,
                                                                  const FineTuneOptimizationParameters& optimizerParameters);
 
 /// <summary> Train a convolutional layer to approximate the output of a submodel, using the training data supplied. </summary>
@@ -111,6 +115,7 @@ FineTuningLayerResult ApproximateSubmodelWithConvolutionalLayer(const MultiClass
                                                                 ell::model::Model& model,
                                                                 const ell::model::OutputPort<ElementType>& submodelOutput,
                                                                 const ell::model::OutputPort<ElementType>& destination,
+                                                                ActivationCache& activationCache,
                                                                 const FineTuneOptimizationParameters& optimizerParameters);
 
 // Report generation & model output
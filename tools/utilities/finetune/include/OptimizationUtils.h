@@ -26,6 +26,7 @@ struct FineTuneOptimizationParameters
     bool normalizeInputs = false;
     bool normalizeOutputs = false;
     std::string randomSeed;
+    int numThreads = 1;
 };
 
 template <typename ElementType>
@@ -57,5 +58,9 @@ using VectorOptimizerResult = OptimizerResult<VectorPredictor>;
 ScalarOptimizerResult TrainScalarPredictor(BinaryLabelDataContainer dataset,
                                            const FineTuneOptimizationParameters& optimizerParameters);
 
+/// <summary>
+/// Trains a predictor for vector labels. If optimizerParameters.numThreads isn't 1, each output is trained separately
+/// and concurrently, which finds the same solution since the loss and regularizer are sums over the outputs.
+/// </summary>
 VectorOptimizerResult TrainVectorPredictor(VectorLabelDataContainer dataset,
                                            const FineTuneOptimizationParameters& optimizerParameters);
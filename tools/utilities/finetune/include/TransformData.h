@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ActivationCache.h"
 #include "DataUtils.h"
 
 #include <model/include/Model.h>
@@ -19,6 +20,13 @@ DataVectorType RemovePadding(const DataVectorType& data, const ell::utilities::M
 template <typename ElementType>
 UnlabeledDataContainer TransformDataWithModel(const UnlabeledDataContainer& dataset, ell::model::Model& model, const ell::model::OutputPort<ElementType>& output);
 
+/// <summary>
+/// Transforms a dataset with a model, evaluating only the part of the model after ports already in the cache and
+/// adding the result to the cache. Falls back to evaluating the whole model if the output doesn't depend on any cached port.
+/// </summary>
+template <typename ElementType>
+UnlabeledDataContainer TransformDataWithModel(const UnlabeledDataContainer& dataset, ell::model::Model& model, const ell::model::OutputPort<ElementType>& output, ActivationCache& cache);
+
 template <typename ElementType>
 BinaryLabelDataContainer TransformDataInputsWithModel(const BinaryLabelDataContainer& dataset, ell::model::Model& model, const ell::model::OutputPort<ElementType>& output);
 
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ActivationCache.cpp (finetune)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ActivationCache.h"
+
+#include <model/include/Submodel.h>
+#include <model/include/TappedSubmodel.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <atomic>
+#include <cstdio>
+
+using namespace ell;
+
+namespace
+{
+std::atomic<int> nextFileIndex{ 0 };
+}
+
+ActivationCache::ActivationCache(std::string directory) :
+    _directory(std::move(directory))
+{
+    if (!_directory.empty())
+    {
+        utilities::EnsureDirectoryExists(_directory);
+    }
+}
+
+ActivationCache::~ActivationCache()
+{
+    _entries.clear();
+    for (const auto& filename : _filenames)
+    {
+        std::remove(filename.c_str());
+    }
+}
+
+bool ActivationCache::Contains(const model::OutputPortBase& port) const
+{
+    return _entries.find(&port) != _entries.end();
+}
+
+void ActivationCache::Add(const model::OutputPortBase& port, const UnlabeledDataContainer& activations)
+{
+    auto exampleSize = activations.IsEmpty() ? 0 : activations[0].Size();
+    EntryWriter writer(*this, exampleSize);
+    for (const auto& example : activations)
+    {
+        if (example.Size() != exampleSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Activations must all have the same size");
+        }
+        writer.Append(example.GetConstDataPointer());
+    }
+    _entries[&port] = writer.Finish();
+}
+
+void ActivationCache::Add(const model::Model& model, const std::vector<const model::OutputPortBase*>& ports, const UnlabeledDataContainer& dataset)
+{
+    model::TappedSubmodel tapped(model::Submodel(model, ports));
+    if (tapped.NumInputs() != 1)
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Ports must be computed from a single input node");
+    }
+
+    std::vector<std::unique_ptr<EntryWriter>> writers;
+    for (size_t index = 0; index < tapped.NumTaps(); ++index)
+    {
+        writers.push_back(std::make_unique<EntryWriter>(*this, tapped.GetTapSize(index)));
+    }
+
+    auto inputSize = tapped.GetInputSize(0);
+    std::vector<float> tapValues;
+    for (const auto& example : dataset)
+    {
+        auto input = example.ToArray();
+        input.resize(inputSize);
+        tapped.SetInputValue(0, input);
+        tapped.Compute([&writers, &tapValues](size_t tapIndex, const std::vector<double>& values) {
+            tapValues.assign(values.begin(), values.end());
+            writers[tapIndex]->Append(tapValues.data());
+        });
+    }
+
+    for (size_t index = 0; index < ports.size(); ++index)
+    {
+        _entries[ports[index]] = writers[index]->Finish();
+    }
+}
+
+UnlabeledDataContainer ActivationCache::Get(const model::OutputPortBase& port) const
+{
+    const auto& entry = GetEntry(port);
+    UnlabeledDataContainer result;
+    for (size_t i = 0; i < entry.numExamples; ++i)
+    {
+        auto example = entry.GetData() + i * entry.exampleSize;
+        result.Add(UnlabeledExample(std::vector<float>(example, example + entry.exampleSize)));
+    }
+    return result;
+}
+
+size_t ActivationCache::GetNumExamples(const model::OutputPortBase& port) const
+{
+    return GetEntry(port).numExamples;
+}
+
+size_t ActivationCache::GetExampleSize(const model::OutputPortBase& port) const
+{
+    return GetEntry(port).exampleSize;
+}
+
+const float* ActivationCache::GetExample(const model::OutputPortBase& port, size_t index) const
+{
+    const auto& entry = GetEntry(port);
+    if (index >= entry.numExamples)
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange);
+    }
+    return entry.GetData() + index * entry.exampleSize;
+}
+
+ActivationCache::EntryWriter::EntryWriter(ActivationCache& cache, size_t exampleSize) :
+    _cache(cache)
+{
+    _entry.exampleSize = exampleSize;
+    if (!_cache._directory.empty() && exampleSize > 0)
+    {
+        _filename = utilities::JoinPaths(_cache._directory, "activations_" + std::to_string(nextFileIndex++) + ".bin");
+        _stream = utilities::OpenBinaryOfstream(_filename);
+        _cache._filenames.push_back(_filename);
+    }
+}
+
+void ActivationCache::EntryWriter::Append(const float* example)
+{
+    if (_stream.is_open())
+    {
+        _stream.write(reinterpret_cast<const char*>(example), _entry.exampleSize * sizeof(float));
+    }
+    else
+    {
+        _entry.data.insert(_entry.data.end(), example, example + _entry.exampleSize);
+    }
+    ++_entry.numExamples;
+}
+
+ActivationCache::Entry ActivationCache::EntryWriter::Finish()
+{
+    if (_stream.is_open())
+    {
+        _stream.close();
+        if (!_stream)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Error writing activations to " + _filename);
+        }
+        if (_entry.numExamples > 0)
+        {
+            _entry.file = std::make_unique<utilities::MemoryMappedFile>(_filename);
+        }
+    }
+    return std::move(_entry);
+}
+
+const ActivationCache::Entry& ActivationCache::GetEntry(const model::OutputPortBase& port) const
+{
+    auto it = _entries.find(&port);
+    if (it == _entries.end())
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port isn't in the activation cache");
+    }
+    return it->second;
+}
+
+const float* ActivationCache::Entry::GetData() const
+{
+    return file ? static_cast<const float*>(file->GetData()) : data.data();
+}
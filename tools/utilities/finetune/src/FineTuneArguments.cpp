@@ -20,7 +20,7 @@ FineTuneOptimizationParameters FineTuneArguments::GetOptimizerParameters() const
     params.regularizationParameter = l2Regularization;
     params.permuteData = permute;
 
-    return { params, l1Regularization, maxEpochs, desiredPrecision, normalizeInputs, normalizeOutputs, randomSeed };
+    return { params, l1Regularization, maxEpochs, desiredPrecision, normalizeInputs, normalizeOutputs, randomSeed, numThreads };
 }
 
 utilities::OutputStreamImpostor FineTuneArguments::GetReportStream() const
@@ -76,6 +76,14 @@ void InitArguments(utilities::CommandLineParser& parser, FineTuneArguments& args
 
     parser.AddOption(args.fineTuneConvolutionalNodes, "conv", "", "Fine-tune convolutional layers", true);
 
+    parser.AddOption(args.pruneChannelsThreshold,
+                     "pruneChannelsThreshold",
+                     "",
+                     "Remove the convolution channels whose importance is below this fraction of the most important channel in their layer, and fine-tune the layers that read them (0 = don't prune)",
+                     0.0);
+
+    parser.AddOption(args.pruneChannelsByActivation, "pruneChannelsByActivation", "", "Measure the importance of channels by their activations on the training data, instead of by their weights", false);
+
     parser.AddOption(args.dataFormat, "format", "", "Dataset format (GSDF, CIFAR, MNIST; default: guess)", "");
 
     parser.AddOption(args.l2Regularization, "l2regularization", "l2", "The L2 regularization parameter", 0.005);
@@ -98,6 +106,18 @@ void InitArguments(utilities::CommandLineParser& parser, FineTuneArguments& args
 
     parser.AddOption(args.randomSeed, "randomSeed", "seed", "The random seed string", "ABCDEFG");
 
+    parser.AddOption(args.numThreads,
+                     "numThreads",
+                     "nt",
+                     "The number of threads to optimize a layer's output channels with, each separately (1 = optimize them together, 0 = one per core)",
+                     1);
+
+    parser.AddOption(args.activationCacheDirectory,
+                     "activationCacheDirectory",
+                     "",
+                     "Directory to write the cached layer outputs to and memory-map them from (empty to keep them in memory)",
+                     "");
+
     parser.AddOption(args.reportFilename,
                      "reportFilename",
                      "",
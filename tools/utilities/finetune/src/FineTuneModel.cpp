@@ -22,6 +22,8 @@
 #include <nodes/include/ConvolutionalLayerNode.h>
 #include <nodes/include/FullyConnectedLayerNode.h>
 
+#include <passes/include/PruneChannelsTransformation.h>
+
 #include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
 #include <utilities/include/MillisecondTimer.h>
@@ -37,18 +39,22 @@ using namespace ell::model;
 // Prototypes
 const OutputPortBase& GetSpecifiedOutput(model::Model& model, const FineTuneArguments& args);
 
+passes::ChannelPruningPlan GetChannelPruningPlan(const Model& model, const MultiClassDataContainer& trainingData, const FineTuneArguments& args);
 bool ShouldConsiderLayer(const Node& node, const FineTuneArguments& args);
-FineTuningLayerResult RetrainLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters);
+FineTuningLayerResult RetrainLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan);
+
+FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan);
 
-FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters);
+FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan);
 
-FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters);
+template <typename ElementType>
+FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan);
 
 template <typename ElementType>
-FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters);
+FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan);
 
 template <typename ElementType>
-FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters);
+const OutputPort<ElementType>& GetRetrainingInput(ModelTransformer& transformer, const InputPort<ElementType>& input, const passes::ChannelPruningPlan& pruningPlan);
 
 template <typename ElementType>
 void WriteModelOutputComparison(model::Model& model, const model::OutputPort<ElementType>& output1, const model::OutputPort<ElementType>& output2, const UnlabeledDataContainer& dataset, Report& report);
@@ -182,32 +188,93 @@ FineTuningOutput FineTuneNodesInSubmodel(Model& model,
     std::chrono::milliseconds::rep optimizationTime = 0;
     std::vector<FineTuningLayerResult> layerResults;
     int skipCount = args.numNodesToSkip;
+    // Layer outputs are cached as they're computed, so each layer's dataset is computed from the previous layers' outputs
+    ActivationCache activationCache(args.activationCacheDirectory);
+    auto pruningPlan = GetChannelPruningPlan(model, trainingData, args);
     Submodel submodel(model, {}, { &submodelOutput });
-    auto resultSubmodel = transformer.TransformSubmodelOnto(submodel, {}, context, [&skipCount, &layerResults, &dataTransformTime, &optimizationTime, &trainingData, &args](const Node& node, ModelTransformer& transformer) {
-        if (ShouldConsiderLayer(node, args))
+
+    // The original outputs of the layers to retrain don't change as layers are retrained, so they're all computed in one pass
+    std::vector<const OutputPortBase*> retrainedLayerOutputs;
+    int layersToSkip = args.numNodesToSkip;
+    submodel.Visit([&retrainedLayerOutputs, &layersToSkip, &pruningPlan, &args](const Node& node) {
+        if (pruningPlan.keptOutputChannels.count(&node) != 0 || !ShouldConsiderLayer(node, args))
+        {
+            return;
+        }
+
+        if (layersToSkip <= 0)
+        {
+            retrainedLayerOutputs.push_back(node.GetOutputPort(0));
+        }
+        else
+        {
+            --layersToSkip;
+        }
+    });
+    if (!retrainedLayerOutputs.empty())
+    {
+        utilities::MillisecondTimer layerOutputsTimer;
+        activationCache.Add(model, retrainedLayerOutputs, GetDatasetInputs(trainingData));
+        layerOutputsTimer.Stop();
+        dataTransformTime += layerOutputsTimer.Elapsed();
+    }
+
+    auto resultSubmodel = transformer.TransformSubmodelOnto(submodel, {}, context, [&skipCount, &layerResults, &dataTransformTime, &optimizationTime, &trainingData, &activationCache, &pruningPlan, &args](const Node& node, ModelTransformer& transformer) {
+        // Layers that lose output channels are added by the layer that reads them, since their output changes size
+        if (pruningPlan.keptOutputChannels.count(&node) != 0)
+        {
+            return;
+        }
+
+        if (ShouldConsiderLayer(node, args) && skipCount <= 0)
+        {
+            auto retrainingResult = RetrainLayer(transformer, node, trainingData, activationCache, args.GetOptimizerParameters(), pruningPlan);
+            dataTransformTime += retrainingResult.dataTransformTime;
+            optimizationTime += retrainingResult.optimizationTime;
+            layerResults.push_back(retrainingResult);
+        }
+        else
         {
-            if (skipCount > 0)
+            if (ShouldConsiderLayer(node, args))
             {
-                transformer.CopyNode(node);
                 --skipCount;
             }
+
+            if (pruningPlan.keptInputChannels.count(&node) != 0)
+            {
+                transformer.MapNodeOutput(*node.GetOutputPort(0), passes::AddPrunedLayers(node, transformer, pruningPlan));
+            }
             else
             {
-                auto retrainingResult = RetrainLayer(transformer, node, trainingData, args.GetOptimizerParameters());
-                dataTransformTime += retrainingResult.dataTransformTime;
-                optimizationTime += retrainingResult.optimizationTime;
-                layerResults.push_back(retrainingResult);
+                transformer.CopyNode(node);
             }
         }
-        else
-        {
-            transformer.CopyNode(node);
-        }
     });
 
     return { resultSubmodel, layerResults, dataTransformTime, optimizationTime };
 }
 
+passes::ChannelPruningPlan GetChannelPruningPlan(const Model& model, const MultiClassDataContainer& trainingData, const FineTuneArguments& args)
+{
+    if (args.pruneChannelsThreshold <= 0)
+    {
+        return {};
+    }
+
+    std::vector<std::vector<double>> calibrationInputs;
+    auto criterion = passes::ChannelPruningCriterion::weights;
+    if (args.pruneChannelsByActivation)
+    {
+        criterion = passes::ChannelPruningCriterion::activations;
+        for (const auto& example : trainingData)
+        {
+            auto input = example.input.ToArray();
+            calibrationInputs.emplace_back(input.begin(), input.end());
+        }
+    }
+    return passes::GetChannelPruningPlan(model, args.pruneChannelsThreshold, criterion, calibrationInputs);
+}
+
 bool ShouldConsiderLayer(const Node& node, const FineTuneArguments& args)
 {
     return (args.fineTuneFullyConnectedNodes && IsFullyConnectedLayerNode(&node)) || (args.fineTuneConvolutionalNodes && IsConvolutionalLayerNode(&node));
@@ -216,15 +283,17 @@ bool ShouldConsiderLayer(const Node& node, const FineTuneArguments& args)
 FineTuningLayerResult RetrainLayer(ModelTransformer& transformer,
                                    const Node& node,
                                    MultiClassDataContainer& trainingData,
-                                   const FineTuneOptimizationParameters& optimizerParameters)
+                                   ActivationCache& activationCache,
+                                   const FineTuneOptimizationParameters& optimizerParameters,
+                                   const passes::ChannelPruningPlan& pruningPlan)
 {
     if (IsFullyConnectedLayerNode(&node)) // TODO: replace with submodel-matcher
     {
-        return RetrainFullyConnectedLayer(transformer, node, trainingData, optimizerParameters);
+        return RetrainFullyConnectedLayer(transformer, node, trainingData, activationCache, optimizerParameters, pruningPlan);
     }
     else if (IsConvolutionalLayerNode(&node)) // TODO: replace with submodel-matcher
     {
-        return RetrainConvolutionalLayer(transformer, node, trainingData, optimizerParameters);
+        return RetrainConvolutionalLayer(transformer, node, trainingData, activationCache, optimizerParameters, pruningPlan);
     }
     else
     {
@@ -232,16 +301,16 @@ FineTuningLayerResult RetrainLayer(ModelTransformer& transformer,
     }
 }
 
-FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters)
+FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan)
 {
     switch (node.GetOutputPort(0)->GetType())
     {
     case model::Port::PortType::smallReal:
-        return RetrainFullyConnectedLayer<float>(transformer, node, trainingData, optimizerParameters);
+        return RetrainFullyConnectedLayer<float>(transformer, node, trainingData, activationCache, optimizerParameters, pruningPlan);
         break;
 
     case model::Port::PortType::real:
-        return RetrainFullyConnectedLayer<double>(transformer, node, trainingData, optimizerParameters);
+        return RetrainFullyConnectedLayer<double>(transformer, node, trainingData, activationCache, optimizerParameters, pruningPlan);
         break;
 
     default:
@@ -249,16 +318,16 @@ FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer,
     }
 }
 
-FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters)
+FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan)
 {
     switch (node.GetOutputPort(0)->GetType())
     {
     case model::Port::PortType::smallReal:
-        return RetrainConvolutionalLayer<float>(transformer, node, trainingData, optimizerParameters);
+        return RetrainConvolutionalLayer<float>(transformer, node, trainingData, activationCache, optimizerParameters, pruningPlan);
         break;
 
     case model::Port::PortType::real:
-        return RetrainConvolutionalLayer<double>(transformer, node, trainingData, optimizerParameters);
+        return RetrainConvolutionalLayer<double>(transformer, node, trainingData, activationCache, optimizerParameters, pruningPlan);
         break;
 
     default:
@@ -268,7 +337,7 @@ FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, c
 
 // Need to pass in training params
 template <typename ElementType>
-FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters)
+FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan)
 {
     // TODO: get input of submodel to retrain
 
@@ -276,15 +345,15 @@ FineTuningLayerResult RetrainFullyConnectedLayer(ModelTransformer& transformer,
     const auto& fcOutput = fcNode->output;
 
     auto& model = transformer.GetModel();
-    const auto& destination = transformer.GetCorrespondingOutputs(fcNode->input.GetReferencedPort());
-    const auto& fineTunedOutput = ApproximateSubmodelWithFullyConnectedLayer(trainingData, model, fcOutput, destination, optimizerParameters);
+    const auto& destination = GetRetrainingInput(transformer, fcNode->input, pruningPlan);
+    const auto& fineTunedOutput = ApproximateSubmodelWithFullyConnectedLayer(trainingData, model, fcOutput, destination, activationCache, optimizerParameters);
     transformer.MapNodeOutput(fcOutput, *fineTunedOutput.fineTunedOutput);
     return fineTunedOutput;
 }
 
 // Need to pass in training params
 template <typename ElementType>
-FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, const FineTuneOptimizationParameters& optimizerParameters)
+FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, const Node& node, MultiClassDataContainer& trainingData, ActivationCache& activationCache, const FineTuneOptimizationParameters& optimizerParameters, const passes::ChannelPruningPlan& pruningPlan)
 {
     // TODO: get input of submodel to retrain
 
@@ -297,22 +366,36 @@ FineTuningLayerResult RetrainConvolutionalLayer(ModelTransformer& transformer, c
     const auto outputPadding = convLayer.GetLayerParameters().outputPaddingParameters.paddingSize;
 
     auto& model = transformer.GetModel();
-    const auto& destination = transformer.GetCorrespondingOutputs(convNode->input.GetReferencedPort());
-    const auto& fineTunedOutput = ApproximateSubmodelWithConvolutionalLayer(trainingData, filterSize, stride, inputPadding, outputPadding, model, convOutput, destination, optimizerParameters);
+    const auto& destination = GetRetrainingInput(transformer, convNode->input, pruningPlan);
+    const auto& fineTunedOutput = ApproximateSubmodelWithConvolutionalLayer(trainingData, filterSize, stride, inputPadding, outputPadding, model, convOutput, destination, activationCache, optimizerParameters);
     transformer.MapNodeOutput(convOutput, *fineTunedOutput.fineTunedOutput);
     return fineTunedOutput;
 }
 
+template <typename ElementType>
+const OutputPort<ElementType>& GetRetrainingInput(ModelTransformer& transformer, const InputPort<ElementType>& input, const passes::ChannelPruningPlan& pruningPlan)
+{
+    // If the layers in front of this one lose output channels, they're added now and the retrained layer reads them,
+    // so it learns to recover the original layer's output from the remaining channels
+    const auto& inputNode = *input.GetReferencedPort().GetNode();
+    if (pruningPlan.keptOutputChannels.count(&inputNode) != 0)
+    {
+        return static_cast<const OutputPort<ElementType>&>(passes::AddPrunedLayers(inputNode, transformer, pruningPlan));
+    }
+    return transformer.GetCorrespondingOutputs(input.GetReferencedPort());
+}
+
 template <typename ElementType>
 FineTuningLayerResult ApproximateSubmodelWithFullyConnectedLayer(const MultiClassDataContainer& imageData,
                                                                  Model& model,
                                                                  const OutputPort<ElementType>& submodelOutput,
                                                                  const OutputPort<ElementType>& destination,
+                                                                 ActivationCache& activationCache,
                                                                  const FineTuneOptimizationParameters& optimizerParameters)
 {
     // Create a dataset from features -> labels
     utilities::MillisecondTimer dataTransformTimer;
-    auto retrainingDataset = GetFullyConnectedFineTuningDataset(imageData, model, submodelOutput, destination, optimizerParameters.normalizeInputs, optimizerParameters.normalizeOutputs);
+    auto retrainingDataset = GetFullyConnectedFineTuningDataset(imageData, model, submodelOutput, destination, activationCache, optimizerParameters.normalizeInputs, optimizerParameters.normalizeOutputs);
     dataTransformTimer.Stop();
 
     // Run SDCA to find weights that map data1->data2
@@ -334,19 +417,20 @@ FineTuningDataset<ElementType> GetFullyConnectedFineTuningDataset(const MultiCla
                                                                   Model& model,
                                                                   const OutputPort<ElementType>& submodelOutput,
                                                                   const OutputPort<ElementType>& destination,
+                                                                  ActivationCache& activationCache,
                                                                   bool normalizeInputs,
                                                                   bool normalizeOutputs)
 {
     auto imageFeatures = GetDatasetInputs(imageData);
 
     // Get statistics of "features" and "labels" so we can normalize them for training
-    auto rawFeatures = TransformDataWithModel(imageFeatures, model, destination);
+    auto rawFeatures = TransformDataWithModel(imageFeatures, model, destination, activationCache);
     UnlabeledDataContainer trainingFeatures;
     const OutputPort<ElementType>* normalizedFeaturesOutput = nullptr;
     normalizedFeaturesOutput = &destination;
     trainingFeatures = rawFeatures;
 
-    auto rawLabels = TransformDataWithModel(imageFeatures, model, submodelOutput);
+    auto rawLabels = TransformDataWithModel(imageFeatures, model, submodelOutput, activationCache);
     UnlabeledDataContainer trainingLabels;
     trainingLabels = rawLabels;
 
@@ -366,13 +450,14 @@ FineTuningLayerResult ApproximateSubmodelWithConvolutionalLayer(const MultiClass
                                                                 Model& model,
                                                                 const OutputPort<ElementType>& submodelOutput,
                                                                 const OutputPort<ElementType>& destination,
+                                                                ActivationCache& activationCache,
                                                                 const FineTuneOptimizationParameters& optimizerParameters)
 {
     const auto numChannels = destination.GetMemoryLayout().GetActiveSize()[2];
     const auto numFilters = submodelOutput.GetMemoryLayout().GetActiveSize()[2];
 
     utilities::MillisecondTimer dataTransformTimer;
-    auto retrainingDataset = GetConvolutionalFineTuningDataset(imageData, filterSize, stride, model, submodelOutput, destination, optimizerParameters.normalizeInputs, optimizerParameters.normalizeOutputs);
+    auto retrainingDataset = GetConvolutionalFineTuningDataset(imageData, filterSize, stride, model, submodelOutput, destination, activationCache, optimizerParameters.normalizeInputs, optimizerParameters.normalizeOutputs);
     dataTransformTimer.Stop();
 
     // Run SDCA to find weights that map data1->data2
@@ -398,19 +483,20 @@ FineTuningDataset<ElementType> GetConvolutionalFineTuningDataset(const MultiClas
                                                                  Model& model,
                                                                  const OutputPort<ElementType>& submodelOutput,
                                                                  const OutputPort<ElementType>& destination,
+                                                                 ActivationCache& activationCache,
                                                                  bool normalizeInputs,
                                                                  bool normalizeOutputs)
 {
     auto imageFeatures = GetDatasetInputs(imageData);
 
     // Get statistics of "features" and "labels" so we can normalize them for training
-    auto rawFeatures = TransformDataWithModel(imageFeatures, model, destination);
+    auto rawFeatures = TransformDataWithModel(imageFeatures, model, destination, activationCache);
     UnlabeledDataContainer imageFeatureData;
     const OutputPort<ElementType>* normalizedFeaturesOutput = nullptr;
     normalizedFeaturesOutput = &destination;
     imageFeatureData = rawFeatures;
 
-    auto rawLabels = TransformDataWithModel(imageFeatures, model, submodelOutput);
+    auto rawLabels = TransformDataWithModel(imageFeatures, model, submodelOutput, activationCache);
     UnlabeledDataContainer imageLabelData;
     imageLabelData = rawLabels;
 
@@ -16,15 +16,47 @@
 #include <optimization/include/SquareLoss.h>
 
 #include <utilities/include/Logger.h>
+#include <utilities/include/ThreadPool.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <future>
 #include <ios>
 #include <limits>
+#include <optional>
+#include <thread>
 
 using namespace ell;
 using namespace logging;
 
+namespace
+{
+// A view of one output of a vector-label dataset, as a scalar-label dataset
+class VectorLabelColumnContainer : public optimization::IndexedContainer<ScalarLabelSolutionExample>
+{
+public:
+    VectorLabelColumnContainer(std::shared_ptr<const VectorLabelDataContainer> dataset, size_t column) :
+        _dataset(std::move(dataset)),
+        _column(column) {}
+
+    size_t Size() const override { return _dataset->Size(); }
+
+    ScalarLabelSolutionExample Get(size_t index) const override
+    {
+        auto example = _dataset->Get(index);
+        return { example.input, example.output[_column], example.weight };
+    }
+
+private:
+    std::shared_ptr<const VectorLabelDataContainer> _dataset;
+    size_t _column;
+};
+} // namespace
+
 // Prototypes
+VectorOptimizerResult TrainVectorPredictorByOutput(std::shared_ptr<const VectorLabelDataContainer> examples, const FineTuneOptimizationParameters& optimizerParameters);
+
 template <typename SolutionType, typename LossType, typename DatasetType>
 OptimizerResult<SolutionType> TrainPredictor(std::shared_ptr<DatasetType> examples, LossType loss, const FineTuneOptimizationParameters& optimizerParameters);
 
@@ -111,10 +143,66 @@ VectorOptimizerResult TrainVectorPredictor(VectorLabelDataContainer dataset, con
 {
     using SolutionType = VectorPredictor;
     auto examples = std::make_shared<VectorLabelDataContainer>(std::move(dataset));
+    if (optimizerParameters.numThreads != 1 && examples->Size() > 0)
+    {
+        return TrainVectorPredictorByOutput(examples, optimizerParameters);
+    }
+
     optimization::MultivariateLoss<optimization::SquareLoss> loss;
     return TrainPredictor<SolutionType>(examples, loss, optimizerParameters);
 }
 
+// The square loss and the regularizers are sums of a term for each output, so each output's weights and bias
+// can be found by a separate scalar problem
+VectorOptimizerResult TrainVectorPredictorByOutput(std::shared_ptr<const VectorLabelDataContainer> examples, const FineTuneOptimizationParameters& optimizerParameters)
+{
+    auto firstExample = examples->Get(0);
+    const auto numOutputs = firstExample.output.Size();
+    // the solutions' assignment operators need solutions of the same size, so the results are constructed in place
+    std::vector<std::optional<ScalarOptimizerResult>> outputResults(numOutputs);
+    std::atomic<size_t> nextOutput{ 0 };
+    auto trainOutputs = [&]() {
+        for (auto output = nextOutput++; output < numOutputs; output = nextOutput++)
+        {
+            auto outputExamples = std::make_shared<VectorLabelColumnContainer>(examples, output);
+            optimization::SquareLoss loss;
+            outputResults[output].emplace(TrainPredictor<ScalarPredictor>(outputExamples, loss, optimizerParameters));
+        }
+    };
+
+    auto numThreads = optimizerParameters.numThreads <= 0 ? std::max(std::thread::hardware_concurrency(), 1u) : static_cast<unsigned>(optimizerParameters.numThreads);
+    auto numWorkers = std::min(static_cast<size_t>(numThreads), numOutputs);
+    std::vector<std::future<void>> workers;
+    for (size_t worker = 1; worker < numWorkers; ++worker)
+    {
+        workers.push_back(utilities::GetHostThreadPool().AddTask(trainOutputs));
+    }
+    trainOutputs();
+    for (auto& worker : workers)
+    {
+        utilities::GetHostThreadPool().GetResult(worker);
+    }
+
+    // Put the outputs' solutions into the columns of one matrix solution
+    VectorOptimizerResult result;
+    result.predictor.Resize(firstExample.input, firstExample.output);
+    auto weights = result.predictor.GetMatrix();
+    for (size_t j = 0; j < numOutputs; ++j)
+    {
+        const auto& outputResult = *outputResults[j];
+        auto outputWeights = outputResult.predictor.GetVector();
+        for (size_t i = 0; i < outputWeights.Size(); ++i)
+        {
+            weights(i, j) = outputWeights[i];
+        }
+        result.predictor.GetBias()[j] = outputResult.predictor.GetBias();
+        result.info.primalObjective += outputResult.info.primalObjective;
+        result.info.dualObjective += outputResult.info.dualObjective;
+        result.info.numEpochsPerformed = std::max(result.info.numEpochsPerformed, outputResult.info.numEpochsPerformed);
+    }
+    return result;
+}
+
 template <typename SolutionType, typename LossType, typename DatasetType>
 OptimizerResult<SolutionType> TrainPredictor(std::shared_ptr<DatasetType> examples, LossType loss, const FineTuneOptimizationParameters& optimizerParameters)
 {
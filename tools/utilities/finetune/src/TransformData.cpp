@@ -10,11 +10,14 @@
 #include "DataUtils.h"
 #include "ModelUtils.h"
 
+#include <model/include/InputNode.h>
 #include <model/include/Map.h>
 
 #include <utilities/include/MemoryLayout.h>
 
+#include <algorithm>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 using namespace ell;
@@ -107,6 +110,96 @@ void Visit(const DataVectorType& data, const utilities::MemoryLayout& layout, Vi
 {
     Visit(data, layout, 0, 0, visitor);
 }
+
+// Finds the input ports where the part of the model that computes `output` reads from ports in the cache. Returns
+// false if that part also reaches one of the model's inputs, or reads a cached port of a different type.
+bool FindCachedInputs(const OutputPortBase& output, const ActivationCache& cache, std::vector<const InputPortBase*>& cachedInputs)
+{
+    std::unordered_set<const Node*> visited;
+    std::vector<const Node*> stack = { output.GetNode() };
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+        if (!visited.insert(node).second)
+        {
+            continue;
+        }
+
+        if (dynamic_cast<const InputNodeBase*>(node) != nullptr)
+        {
+            return false;
+        }
+
+        for (auto input : node->GetInputPorts())
+        {
+            const auto& referencedPort = input->GetReferencedPort();
+            if (cache.Contains(referencedPort))
+            {
+                if (referencedPort.GetType() != output.GetType())
+                {
+                    return false;
+                }
+                cachedInputs.push_back(input);
+            }
+            else
+            {
+                stack.push_back(referencedPort.GetNode());
+            }
+        }
+    }
+    return !cachedInputs.empty();
+}
+
+// Evaluates the part of the model between the cached ports read by `cachedInputs` and `output`
+template <typename ElementType>
+UnlabeledDataContainer TransformCachedDataWithModel(size_t numExamples, Model& model, const OutputPort<ElementType>& output, const std::vector<const InputPortBase*>& cachedInputs, const ActivationCache& cache)
+{
+    // Make a model with an input node for each cached port, and copy the part of the model after them onto it
+    Model segmentModel;
+    std::vector<const OutputPortBase*> cachedPorts;
+    std::vector<InputNode<ElementType>*> inputNodes;
+    std::vector<const OutputPortBase*> onto;
+    for (auto input : cachedInputs)
+    {
+        const auto& cachedPort = input->GetReferencedPort();
+        auto index = static_cast<size_t>(std::find(cachedPorts.begin(), cachedPorts.end(), &cachedPort) - cachedPorts.begin());
+        if (index == cachedPorts.size())
+        {
+            cachedPorts.push_back(&cachedPort);
+            inputNodes.push_back(segmentModel.AddNode<InputNode<ElementType>>(cachedPort.GetMemoryLayout()));
+        }
+        onto.push_back(&inputNodes[index]->output);
+    }
+
+    TransformContext context;
+    ModelTransformer transformer;
+    Submodel submodel(model, cachedInputs, { &output });
+    auto segment = transformer.TransformSubmodelOnto(submodel, segmentModel, onto, context, [](const Node& node, ModelTransformer& transformer) {
+        transformer.CopyNode(node);
+    });
+
+    std::vector<std::pair<std::string, InputNodeBase*>> mapInputs;
+    for (size_t i = 0; i < inputNodes.size(); ++i)
+    {
+        mapInputs.push_back({ "input" + std::to_string(i), inputNodes[i] });
+    }
+    Map map(segment.GetModel(), mapInputs, { { "output", *segment.GetOutputs()[0] } });
+
+    UnlabeledDataContainer result;
+    for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+    {
+        for (size_t i = 0; i < cachedPorts.size(); ++i)
+        {
+            auto example = cache.GetExample(*cachedPorts[i], exampleIndex);
+            std::vector<ElementType> input(example, example + cache.GetExampleSize(*cachedPorts[i]));
+            input.resize(map.GetInputSize(i));
+            map.SetInputValue(static_cast<int>(i), input);
+        }
+        result.Add(CastVector<float>(map.ComputeOutput<ElementType>(0)));
+    }
+    return result;
+}
 } // namespace
 
 // prototypes
@@ -193,6 +286,20 @@ UnlabeledDataContainer TransformDataWithModel(const UnlabeledDataContainer& data
     return TransformDataInputsWithModelImpl(dataset, model, output);
 }
 
+template <typename ElementType>
+UnlabeledDataContainer TransformDataWithModel(const UnlabeledDataContainer& dataset, Model& model, const OutputPort<ElementType>& output, ActivationCache& cache)
+{
+    if (cache.Contains(output))
+    {
+        return cache.Get(output);
+    }
+
+    std::vector<const InputPortBase*> cachedInputs;
+    auto result = FindCachedInputs(output, cache, cachedInputs) ? TransformCachedDataWithModel(dataset.Size(), model, output, cachedInputs, cache) : TransformDataWithModel(dataset, model, output);
+    cache.Add(output, result);
+    return result;
+}
+
 template <typename ElementType>
 BinaryLabelDataContainer TransformDataInputsWithModel(const BinaryLabelDataContainer& dataset, Model& model, const OutputPort<ElementType>& output)
 {
@@ -272,11 +379,13 @@ double GetModelAccuracyImpl(Model& model, const OutputPort<ElementType>& output,
 
 // Explicit instantiation definitions
 template UnlabeledDataContainer TransformDataWithModel(const UnlabeledDataContainer& dataset, Model& model, const OutputPort<float>& output);
+template UnlabeledDataContainer TransformDataWithModel(const UnlabeledDataContainer& dataset, Model& model, const OutputPort<float>& output, ActivationCache& cache);
 template BinaryLabelDataContainer TransformDataInputsWithModel(const BinaryLabelDataContainer& dataset, Model& model, const OutputPort<float>& output);
 template MultiClassDataContainer TransformDataInputsWithModel(const MultiClassDataContainer& dataset, Model& model, const OutputPort<float>& output);
 template VectorLabelDataContainer TransformDataInputsWithModel(const VectorLabelDataContainer& dataset, Model& model, const OutputPort<float>& output);
 
 template UnlabeledDataContainer TransformDataWithModel(const UnlabeledDataContainer& dataset, Model& model, const OutputPort<double>& output);
+template UnlabeledDataContainer TransformDataWithModel(const UnlabeledDataContainer& dataset, Model& model, const OutputPort<double>& output, ActivationCache& cache);
 template BinaryLabelDataContainer TransformDataInputsWithModel(const BinaryLabelDataContainer& dataset, Model& model, const OutputPort<double>& output);
 template MultiClassDataContainer TransformDataInputsWithModel(const MultiClassDataContainer& dataset, Model& model, const OutputPort<double>& output);
 template VectorLabelDataContainer TransformDataInputsWithModel(const VectorLabelDataContainer& dataset, Model& model, const OutputPort<double>& output);
@@ -8,8 +8,12 @@
 
 #pragma once
 
+#include <string>
+
 // Main driver function
 void TestTransformData();
 
 // Individual tests
 void TestRemovePadding();
+void TestTransformDataWithActivationCache(const std::string& cacheDirectory);
+void TestActivationCacheSinglePass(const std::string& cacheDirectory);
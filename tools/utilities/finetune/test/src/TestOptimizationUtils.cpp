@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "TestOptimizationUtils.h"
+#include "OptimizationUtils.h"
 
 #include <math/include/Matrix.h>
 
@@ -25,7 +26,50 @@ using namespace ell::testing;
 
 void TestOptimizationUtils()
 {
-    NoFailOnUnimplemented([]() {
-        throw TestNotImplementedException("TestOptimizationUtils");
-    });
+    FailOnException(TestTrainVectorPredictorByOutput);
+}
+
+void TestTrainVectorPredictorByOutput()
+{
+    const int numExamples = 50;
+    const int inputSize = 6;
+    const int outputSize = 4;
+    auto engine = utilities::GetRandomEngine("123");
+    std::normal_distribution<float> distribution(0, 1);
+    UnlabeledDataContainer features;
+    UnlabeledDataContainer labels;
+    for (int i = 0; i < numExamples; ++i)
+    {
+        std::vector<float> feature(inputSize);
+        std::generate(feature.begin(), feature.end(), [&]() { return distribution(engine); });
+        std::vector<float> label(outputSize);
+        for (int j = 0; j < outputSize; ++j)
+        {
+            label[j] = (j + 1) * feature[j] - feature[j + 1] + 0.1f * distribution(engine);
+        }
+        features.Add(UnlabeledExample(feature));
+        labels.Add(UnlabeledExample(label));
+    }
+    auto dataset = CreateVectorLabelDataContainer(features, labels);
+
+    FineTuneOptimizationParameters parameters;
+    parameters.optimizerParameters.regularizationParameter = 0.01;
+    parameters.maxEpochs = 500;
+    parameters.desiredPrecision = 1.0e-8;
+    parameters.randomSeed = "123";
+
+    auto together = GetWeightsAndBias<float>(TrainVectorPredictor(dataset, parameters).predictor);
+    parameters.numThreads = 2;
+    auto byOutput = GetWeightsAndBias<float>(TrainVectorPredictor(dataset, parameters).predictor);
+
+    bool ok = true;
+    for (int j = 0; j < outputSize; ++j)
+    {
+        for (int i = 0; i < inputSize; ++i)
+        {
+            ok &= IsEqual(together.weights(j, i), byOutput.weights(j, i), 1.0e-3f);
+        }
+        ok &= IsEqual(together.bias[j], byOutput.bias[j], 1.0e-3f);
+    }
+    ProcessTest("TrainVectorPredictor with the outputs trained separately", ok);
 }
@@ -7,14 +7,21 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "TestTransformData.h"
+#include "ActivationCache.h"
+#include "LoadTestModels.h"
+#include "ModelUtils.h"
 #include "TransformData.h"
 
 #include <testing/include/testing.h>
 
 #include <utilities/include/MemoryLayout.h>
+#include <utilities/include/RandomEngines.h>
 
+#include <algorithm>
 #include <iostream>
 #include <numeric>
+#include <random>
+#include <string>
 #include <vector>
 
 using namespace ell;
@@ -23,6 +30,10 @@ using namespace ell::testing;
 void TestTransformData()
 {
     FailOnException(TestRemovePadding);
+    FailOnException(TestTransformDataWithActivationCache, "");
+    FailOnException(TestTransformDataWithActivationCache, ".");
+    FailOnException(TestActivationCacheSinglePass, "");
+    FailOnException(TestActivationCacheSinglePass, ".");
 }
 
 void TestRemovePaddingNoPadding()
@@ -62,3 +73,68 @@ void TestRemovePadding()
     TestRemovePaddingNoPadding();
     TestRemovePaddingWithPadding();
 }
+
+// test model nodes:   0: input, 1: conv, 2: fully-connected, 3: output
+void TestTransformDataWithActivationCache(const std::string& cacheDirectory)
+{
+    auto model = GetNodeFindingTestModel();
+    const auto& modelOutput = GetOutputNode<float>(model)->output;
+    const auto& convOutput = GetConvolutionalLayerNodes<float>(model, modelOutput)[0]->output;
+    const auto& fcOutput = GetFullyConnectedLayerNodes<float>(model, modelOutput)[0]->output;
+
+    auto engine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    UnlabeledDataContainer dataset;
+    for (int i = 0; i < 5; ++i)
+    {
+        std::vector<float> example(GetInputNode<float>(model, modelOutput)->output.Size());
+        std::generate(example.begin(), example.end(), [&]() { return distribution(engine); });
+        dataset.Add(UnlabeledExample(example));
+    }
+
+    auto expected = TransformDataWithModel(dataset, model, fcOutput);
+
+    ActivationCache cache(cacheDirectory);
+    TransformDataWithModel(dataset, model, convOutput, cache);
+    auto actual = TransformDataWithModel(dataset, model, fcOutput, cache);
+    auto cached = TransformDataWithModel(dataset, model, fcOutput, cache);
+
+    bool ok = actual.Size() == expected.Size() && cached.Size() == expected.Size();
+    for (size_t i = 0; ok && i < expected.Size(); ++i)
+    {
+        ok &= IsEqual(actual[i].ToArray(), expected[i].ToArray(), 1.0e-5f) && IsEqual(cached[i].ToArray(), expected[i].ToArray(), 1.0e-5f);
+    }
+    ProcessTest("TransformDataWithModel from cached activations" + (cacheDirectory.empty() ? std::string{} : " (memory-mapped)"), ok);
+}
+
+void TestActivationCacheSinglePass(const std::string& cacheDirectory)
+{
+    auto model = GetNodeFindingTestModel();
+    const auto& modelOutput = GetOutputNode<float>(model)->output;
+    const auto& convOutput = GetConvolutionalLayerNodes<float>(model, modelOutput)[0]->output;
+    const auto& fcOutput = GetFullyConnectedLayerNodes<float>(model, modelOutput)[0]->output;
+
+    auto engine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    UnlabeledDataContainer dataset;
+    for (int i = 0; i < 5; ++i)
+    {
+        std::vector<float> example(GetInputNode<float>(model, modelOutput)->output.Size());
+        std::generate(example.begin(), example.end(), [&]() { return distribution(engine); });
+        dataset.Add(UnlabeledExample(example));
+    }
+
+    auto expectedConv = TransformDataWithModel(dataset, model, convOutput);
+    auto expectedFc = TransformDataWithModel(dataset, model, fcOutput);
+
+    ActivationCache cache(cacheDirectory);
+    cache.Add(model, { &convOutput, &fcOutput }, dataset);
+    bool ok = cache.Contains(convOutput) && cache.Contains(fcOutput) && cache.GetNumExamples(fcOutput) == dataset.Size();
+    auto actualConv = cache.Get(convOutput);
+    auto actualFc = cache.Get(fcOutput);
+    for (size_t i = 0; ok && i < dataset.Size(); ++i)
+    {
+        ok &= IsEqual(actualConv[i].ToArray(), expectedConv[i].ToArray(), 1.0e-5f) && IsEqual(actualFc[i].ToArray(), expectedFc[i].ToArray(), 1.0e-5f);
+    }
+    ProcessTest("ActivationCache of several ports in a single pass" + (cacheDirectory.empty() ? std::string{} : " (memory-mapped)"), ok);
+}
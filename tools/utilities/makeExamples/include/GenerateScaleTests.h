@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GenerateScaleTests.h (makeExamples)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Map.h>
+
+#include <ostream>
+#include <string>
+
+namespace ell
+{
+/// <summary>
+/// Generates a multilayer perceptron with random float weights: `depth` fully connected layers of `width` units, each
+/// followed by a bias and, except for the last one, a ReLU activation. A `sparsity` fraction of the weights is zero.
+/// </summary>
+///
+/// <param name="inputSize"> The size of the input. </param>
+/// <param name="depth"> The number of fully connected layers. </param>
+/// <param name="width"> The number of units of each layer. </param>
+/// <param name="sparsity"> The fraction of the weights that are zero, from 0 to 1. </param>
+/// <param name="seed"> The seed of the random weights. </param>
+///
+/// <returns> A map with an input of size `inputSize` and an output of size `width`. </returns>
+model::Map GenerateDenseScaleModel(size_t inputSize, size_t depth, size_t width, double sparsity, const std::string& seed = "123");
+
+/// <summary>
+/// Generates a stack of `depth` convolutional layers with random float weights, each with `numFilters` square filters
+/// of size `filterSize`, stride 1 and zero padding that keeps the image size, and followed by a ReLU activation.
+/// A `sparsity` fraction of the weights is zero.
+/// </summary>
+///
+/// <param name="imageRows"> The number of rows of the input image. </param>
+/// <param name="imageColumns"> The number of columns of the input image. </param>
+/// <param name="numChannels"> The number of channels of the input image. </param>
+/// <param name="depth"> The number of convolutional layers. </param>
+/// <param name="numFilters"> The number of filters of each layer. </param>
+/// <param name="filterSize"> The width and height of the filters, which must be odd. </param>
+/// <param name="sparsity"> The fraction of the weights that are zero, from 0 to 1. </param>
+/// <param name="seed"> The seed of the random weights. </param>
+///
+/// <returns> A map with an image input of size rows x columns x channels and an output of size rows x columns x filters. </returns>
+model::Map GenerateConvolutionScaleModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t depth, size_t numFilters, size_t filterSize, double sparsity, const std::string& seed = "123");
+
+/// <summary>
+/// Generates a stack of `depth` RNN nodes with random float weights and tanh activations, which process a sequence of
+/// `sequenceLength` frames per call. The first node reads frames of size `inputSize`, the others read the hidden state
+/// sequence of the node below.
+/// </summary>
+///
+/// <param name="inputSize"> The size of an input frame. </param>
+/// <param name="depth"> The number of RNN nodes. </param>
+/// <param name="hiddenUnits"> The number of hidden units of each node. </param>
+/// <param name="sequenceLength"> The number of frames per call. </param>
+/// <param name="sparsity"> The fraction of the weights that are zero, from 0 to 1. </param>
+/// <param name="seed"> The seed of the random weights. </param>
+///
+/// <returns> A map with an input of size `inputSize * sequenceLength` and an output of size `hiddenUnits * sequenceLength`. </returns>
+model::Map GenerateRecurrentScaleModel(size_t inputSize, size_t depth, size_t hiddenUnits, size_t sequenceLength, double sparsity, const std::string& seed = "123");
+
+/// <summary> The file formats of the generated datasets. </summary>
+enum class ScaleDatasetFormat
+{
+    /// <summary> Text, with the label followed by every feature value of an example on each line. </summary>
+    dense,
+    /// <summary> Text, with the label followed by index:value pairs of the nonzero features of an example on each line. </summary>
+    sparse,
+    /// <summary> The binary dataset format (see data/include/BinaryDataset.h). </summary>
+    binary
+};
+
+/// <summary>
+/// Writes a dataset of random examples, which are generated and written one at a time, so datasets much larger than
+/// memory can be made. A `sparsity` fraction of the features of each example is zero, and the others are uniform in
+/// [-1, 1]. The labels are those of a random linear model, so the dataset is learnable: -1 or 1 if there are two classes,
+/// and the class index otherwise.
+/// </summary>
+///
+/// <param name="stream"> The output stream. It must be binary and seekable for the binary format. </param>
+/// <param name="format"> The format of the dataset. </param>
+/// <param name="numExamples"> The number of examples. </param>
+/// <param name="numFeatures"> The number of features of each example. </param>
+/// <param name="sparsity"> The fraction of the features that are zero, from 0 to 1. </param>
+/// <param name="numClasses"> The number of classes, at least 2. </param>
+/// <param name="seed"> The seed of the random examples. </param>
+void WriteScaleDataset(std::ostream& stream, ScaleDatasetFormat format, size_t numExamples, size_t numFeatures, double sparsity, size_t numClasses, const std::string& seed = "123");
+} // namespace ell
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScaleTestArguments.h (makeExamples)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <string>
+
+namespace ell
+{
+/// <summary> A struct that holds command line parameters for generating synthetic scale test models and datasets. </summary>
+struct ScaleTestArguments
+{
+    /// <summary> The kind of scale test model to generate. </summary>
+    enum class ModelKind
+    {
+        none,
+        dense,
+        convolution,
+        recurrent
+    };
+    ModelKind model = ModelKind::none;
+    size_t inputSize = 256;
+    size_t depth = 4;
+    size_t width = 256;
+    double sparsity = 0.0;
+    size_t imageSize = 32;
+    size_t numChannels = 8;
+    size_t numFilters = 16;
+    size_t filterSize = 3;
+    size_t hiddenUnits = 64;
+    size_t sequenceLength = 16;
+
+    /// <summary> The format of the scale test dataset to generate, if any. </summary>
+    enum class DatasetKind
+    {
+        none,
+        dense,
+        sparse,
+        binary
+    };
+    DatasetKind dataset = DatasetKind::none;
+    size_t numExamples = 1000;
+    size_t numFeatures = 256;
+    double datasetSparsity = 0.0;
+    size_t numClasses = 2;
+
+    std::string seed = "123";
+};
+
+/// <summary> A version of ScaleTestArguments that adds its members to the command line parser. </summary>
+struct ParsedScaleTestArguments : public ScaleTestArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+
+    /// <summary> Checks the parsed arguments. </summary>
+    ///
+    /// <param name="parser"> The parser. </param>
+    ///
+    /// <returns> An empty CommandLineParseResult if the arguments are valid, or the errors otherwise. </returns>
+    utilities::CommandLineParseResult PostProcess(const utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
@@ -0,0 +1,289 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GenerateScaleTests.cpp (makeExamples)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GenerateScaleTests.h"
+
+#include <data/include/AutoDataVector.h>
+#include <data/include/BinaryDataset.h>
+#include <data/include/Example.h>
+#include <data/include/WeightLabel.h>
+
+#include <model/include/InputNode.h>
+#include <model/include/Model.h>
+
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/NeuralNetworkPredictorNode.h>
+#include <nodes/include/RNNNode.h>
+
+#include <predictors/include/NeuralNetworkPredictor.h>
+
+#include <predictors/neural/include/ActivationLayer.h>
+#include <predictors/neural/include/BiasLayer.h>
+#include <predictors/neural/include/ConvolutionalLayer.h>
+#include <predictors/neural/include/FullyConnectedLayer.h>
+#include <predictors/neural/include/InputLayer.h>
+#include <predictors/neural/include/Layer.h>
+#include <predictors/neural/include/ReLUActivation.h>
+#include <predictors/neural/include/TanhActivation.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/RandomEngines.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ell
+{
+using namespace predictors::neural;
+
+namespace
+{
+    using ElementType = float;
+    using NeuralLayer = Layer<ElementType>;
+    using NeuralNetwork = predictors::NeuralNetworkPredictor<ElementType>;
+
+    // Draws values uniformly from [-1, 1], except for a `sparsity` fraction of them, which are zero
+    class SparseUniform
+    {
+    public:
+        SparseUniform(double sparsity, const std::string& seed) :
+            _engine(utilities::GetRandomEngine(seed)),
+            _sparsity(sparsity)
+        {
+            if (sparsity < 0 || sparsity > 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The sparsity must be between 0 and 1");
+            }
+        }
+
+        double operator()()
+        {
+            if (_sparsity > 0 && _zeroDistribution(_engine) < _sparsity)
+            {
+                return 0;
+            }
+            return _valueDistribution(_engine);
+        }
+
+    private:
+        std::default_random_engine _engine;
+        std::uniform_real_distribution<double> _zeroDistribution{ 0, 1 };
+        std::uniform_real_distribution<double> _valueDistribution{ -1, 1 };
+        double _sparsity;
+    };
+
+    std::vector<ElementType> GetRandomValues(size_t size, SparseUniform& random)
+    {
+        std::vector<ElementType> values(size);
+        std::generate(values.begin(), values.end(), [&random] { return static_cast<ElementType>(random()); });
+        return values;
+    }
+
+    void CheckPositive(size_t value, const std::string& name)
+    {
+        if (value == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The " + name + " must be positive");
+        }
+    }
+
+    model::Map GetNeuralNetworkMap(NeuralNetwork::InputLayerReference inputLayer, NeuralNetwork::Layers layers)
+    {
+        NeuralNetwork neuralNetwork(std::move(inputLayer), std::move(layers));
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ElementType>>(neuralNetwork.GetInputShape().Size());
+        auto predictorNode = model.AddNode<nodes::NeuralNetworkPredictorNode<ElementType>>(inputNode->output, neuralNetwork);
+        return { model, { { "input", inputNode } }, { { "output", predictorNode->output } } };
+    }
+} // namespace
+
+model::Map GenerateDenseScaleModel(size_t inputSize, size_t depth, size_t width, double sparsity, const std::string& seed)
+{
+    CheckPositive(inputSize, "input size");
+    CheckPositive(depth, "depth");
+    CheckPositive(width, "width");
+    SparseUniform random(sparsity, seed);
+
+    InputLayer<ElementType>::InputParameters inputParameters{ { 1, 1, inputSize }, NoPadding(), { 1, 1, inputSize }, NoPadding(), 1 };
+    auto inputLayer = std::make_unique<InputLayer<ElementType>>(inputParameters);
+
+    NeuralNetwork::Layers layers;
+    for (size_t layerIndex = 0; layerIndex < depth; ++layerIndex)
+    {
+        const auto& layerInput = layers.empty() ? inputLayer->GetOutput() : layers.back()->GetOutput();
+        auto layerInputSize = layers.empty() ? inputSize : width;
+
+        NeuralLayer::MatrixType weights(width, layerInputSize);
+        weights.Generate([&random] { return static_cast<ElementType>(random()); });
+        layers.push_back(std::make_unique<FullyConnectedLayer<ElementType>>(NeuralLayer::LayerParameters{ layerInput, NoPadding(), { 1, 1, width }, NoPadding() }, weights));
+
+        NeuralLayer::VectorType bias(GetRandomValues(width, random));
+        layers.push_back(std::make_unique<BiasLayer<ElementType>>(NeuralLayer::LayerParameters{ layers.back()->GetOutput(), NoPadding(), { 1, 1, width }, NoPadding() }, bias));
+
+        if (layerIndex + 1 < depth)
+        {
+            layers.push_back(std::make_unique<ActivationLayer<ElementType>>(NeuralLayer::LayerParameters{ layers.back()->GetOutput(), NoPadding(), { 1, 1, width }, NoPadding() }, new ReLUActivation<ElementType>()));
+        }
+    }
+
+    return GetNeuralNetworkMap(std::move(inputLayer), std::move(layers));
+}
+
+model::Map GenerateConvolutionScaleModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t depth, size_t numFilters, size_t filterSize, double sparsity, const std::string& seed)
+{
+    CheckPositive(imageRows, "number of image rows");
+    CheckPositive(imageColumns, "number of image columns");
+    CheckPositive(numChannels, "number of channels");
+    CheckPositive(depth, "depth");
+    CheckPositive(numFilters, "number of filters");
+    if (filterSize % 2 == 0)
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The filter size must be odd");
+    }
+    SparseUniform random(sparsity, seed);
+
+    // Each layer's input is zero padded by the layer before it, so the convolutions keep the image size
+    const size_t padding = (filterSize - 1) / 2;
+    const ConvolutionalParameters convolutionalParameters{ filterSize, 1, ConvolutionMethod::automatic, 1 };
+    auto paddedShape = [=](size_t channels) { return math::TensorShape{ imageRows + 2 * padding, imageColumns + 2 * padding, channels }; };
+
+    InputLayer<ElementType>::InputParameters inputParameters{ { imageRows, imageColumns, numChannels }, NoPadding(), paddedShape(numChannels), ZeroPadding(padding), 1 };
+    auto inputLayer = std::make_unique<InputLayer<ElementType>>(inputParameters);
+
+    NeuralNetwork::Layers layers;
+    for (size_t layerIndex = 0; layerIndex < depth; ++layerIndex)
+    {
+        const auto& layerInput = layers.empty() ? inputLayer->GetOutput() : layers.back()->GetOutput();
+        auto layerChannels = layers.empty() ? numChannels : numFilters;
+
+        NeuralLayer::TensorType weights(filterSize * numFilters, filterSize, layerChannels);
+        weights.Generate([&random] { return static_cast<ElementType>(random()); });
+        layers.push_back(std::make_unique<ConvolutionalLayer<ElementType>>(NeuralLayer::LayerParameters{ layerInput, ZeroPadding(padding), { imageRows, imageColumns, numFilters }, NoPadding() }, convolutionalParameters, weights));
+
+        auto isLastLayer = layerIndex + 1 == depth;
+        auto outputShape = isLastLayer ? math::TensorShape{ imageRows, imageColumns, numFilters } : paddedShape(numFilters);
+        auto outputPadding = isLastLayer ? NoPadding() : ZeroPadding(padding);
+        layers.push_back(std::make_unique<ActivationLayer<ElementType>>(NeuralLayer::LayerParameters{ layers.back()->GetOutput(), NoPadding(), outputShape, outputPadding }, new ReLUActivation<ElementType>()));
+    }
+
+    return GetNeuralNetworkMap(std::move(inputLayer), std::move(layers));
+}
+
+model::Map GenerateRecurrentScaleModel(size_t inputSize, size_t depth, size_t hiddenUnits, size_t sequenceLength, double sparsity, const std::string& seed)
+{
+    CheckPositive(inputSize, "input size");
+    CheckPositive(depth, "depth");
+    CheckPositive(hiddenUnits, "number of hidden units");
+    CheckPositive(sequenceLength, "sequence length");
+    SparseUniform random(sparsity, seed);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputSize * sequenceLength);
+    auto resetTriggerNode = model.AddNode<nodes::ConstantNode<int>>(0);
+    const model::OutputPort<ElementType>* layerInput = &inputNode->output;
+    for (size_t layerIndex = 0; layerIndex < depth; ++layerIndex)
+    {
+        auto frameSize = layerIndex == 0 ? inputSize : hiddenUnits;
+        auto inputWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(GetRandomValues(hiddenUnits * frameSize, random));
+        auto hiddenWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(GetRandomValues(hiddenUnits * hiddenUnits, random));
+        auto inputBiasNode = model.AddNode<nodes::ConstantNode<ElementType>>(GetRandomValues(hiddenUnits, random));
+        auto hiddenBiasNode = model.AddNode<nodes::ConstantNode<ElementType>>(GetRandomValues(hiddenUnits, random));
+        Activation<ElementType> activation(new TanhActivation<ElementType>());
+
+        auto rnnNode = model.AddNode<nodes::RNNNode<ElementType>>(*layerInput, resetTriggerNode->output, hiddenUnits, inputWeightsNode->output, hiddenWeightsNode->output, inputBiasNode->output, hiddenBiasNode->output, activation, sequenceLength);
+        layerInput = &rnnNode->output;
+    }
+
+    return { model, { { "input", inputNode } }, { { "output", *layerInput } } };
+}
+
+void WriteScaleDataset(std::ostream& stream, ScaleDatasetFormat format, size_t numExamples, size_t numFeatures, double sparsity, size_t numClasses, const std::string& seed)
+{
+    CheckPositive(numFeatures, "number of features");
+    if (numClasses < 2)
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "A dataset needs at least 2 classes");
+    }
+    SparseUniform random(sparsity, seed);
+
+    // The labels come from a dense random linear model, with a weight vector per class (or just one for 2 classes)
+    SparseUniform teacherRandom(0.0, seed + "_teacher");
+    auto numScores = numClasses == 2 ? 1 : numClasses;
+    std::vector<std::vector<double>> teacherWeights(numScores, std::vector<double>(numFeatures));
+    for (auto& weights : teacherWeights)
+    {
+        std::generate(weights.begin(), weights.end(), [&teacherRandom] { return teacherRandom(); });
+    }
+
+    std::unique_ptr<data::BinaryDatasetWriter> binaryWriter;
+    if (format == ScaleDatasetFormat::binary)
+    {
+        binaryWriter = std::make_unique<data::BinaryDatasetWriter>(stream);
+    }
+
+    std::vector<double> features(numFeatures);
+    std::vector<double> scores(numScores);
+    for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+    {
+        std::fill(scores.begin(), scores.end(), 0.0);
+        for (size_t featureIndex = 0; featureIndex < numFeatures; ++featureIndex)
+        {
+            features[featureIndex] = random();
+            for (size_t scoreIndex = 0; scoreIndex < numScores; ++scoreIndex)
+            {
+                scores[scoreIndex] += teacherWeights[scoreIndex][featureIndex] * features[featureIndex];
+            }
+        }
+
+        double label = 0;
+        if (numClasses == 2)
+        {
+            label = scores[0] >= 0 ? 1.0 : -1.0;
+        }
+        else
+        {
+            label = static_cast<double>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+        }
+
+        switch (format)
+        {
+        case ScaleDatasetFormat::dense:
+            stream << label;
+            for (auto value : features)
+            {
+                stream << '\t' << value;
+            }
+            stream << '\n';
+            break;
+
+        case ScaleDatasetFormat::sparse:
+            stream << label;
+            for (size_t featureIndex = 0; featureIndex < numFeatures; ++featureIndex)
+            {
+                if (features[featureIndex] != 0)
+                {
+                    stream << '\t' << featureIndex << ':' << features[featureIndex];
+                }
+            }
+            stream << '\n';
+            break;
+
+        case ScaleDatasetFormat::binary:
+            binaryWriter->Write(data::AutoSupervisedExample(data::AutoDataVector(features), data::WeightLabel{ 1.0, label }));
+            break;
+        }
+    }
+
+    if (binaryWriter)
+    {
+        binaryWriter->Close();
+    }
+}
+} // namespace ell
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScaleTestArguments.cpp (makeExamples)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ScaleTestArguments.h"
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+void ParsedScaleTestArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddDocumentationString("Synthetic scale test models (written instead of the example models)");
+    parser.AddOption(
+        model,
+        "scaleModel",
+        "sm",
+        "Choice of scale test model: none, dense (fully connected layers), convolution (convolutional layers), recurrent (RNN layers)",
+        { { "none", ModelKind::none }, { "dense", ModelKind::dense }, { "convolution", ModelKind::convolution }, { "recurrent", ModelKind::recurrent } },
+        "none");
+
+    parser.AddOption(
+        depth,
+        "depth",
+        "",
+        "The number of layers of the scale test model",
+        4);
+
+    parser.AddOption(
+        inputSize,
+        "inputSize",
+        "",
+        "The input size of the dense model, and the frame size of the recurrent model",
+        256);
+
+    parser.AddOption(
+        width,
+        "width",
+        "",
+        "The number of units of each layer of the dense model",
+        256);
+
+    parser.AddOption(
+        sparsity,
+        "sparsity",
+        "",
+        "The fraction of the weights that are zero",
+        0.0);
+
+    parser.AddOption(
+        imageSize,
+        "imageSize",
+        "",
+        "The width and height of the input image of the convolution model",
+        32);
+
+    parser.AddOption(
+        numChannels,
+        "numChannels",
+        "",
+        "The number of channels of the input image of the convolution model",
+        8);
+
+    parser.AddOption(
+        numFilters,
+        "numFilters",
+        "",
+        "The number of filters of each layer of the convolution model",
+        16);
+
+    parser.AddOption(
+        filterSize,
+        "filterSize",
+        "",
+        "The width and height of the filters of the convolution model (odd)",
+        3);
+
+    parser.AddOption(
+        hiddenUnits,
+        "hiddenUnits",
+        "",
+        "The number of hidden units of each layer of the recurrent model",
+        64);
+
+    parser.AddOption(
+        sequenceLength,
+        "sequenceLength",
+        "",
+        "The number of frames the recurrent model processes per call",
+        16);
+
+    parser.AddDocumentationString("Synthetic scale test datasets (written instead of the example models)");
+    parser.AddOption(
+        dataset,
+        "scaleDataset",
+        "sd",
+        "Choice of scale test dataset format: none, dense (text), sparse (text with index:value pairs), binary",
+        { { "none", DatasetKind::none }, { "dense", DatasetKind::dense }, { "sparse", DatasetKind::sparse }, { "binary", DatasetKind::binary } },
+        "none");
+
+    parser.AddOption(
+        numExamples,
+        "numExamples",
+        "",
+        "The number of examples of the dataset",
+        1000);
+
+    parser.AddOption(
+        numFeatures,
+        "numFeatures",
+        "",
+        "The number of features of each example",
+        256);
+
+    parser.AddOption(
+        datasetSparsity,
+        "datasetSparsity",
+        "",
+        "The fraction of the features that are zero",
+        0.0);
+
+    parser.AddOption(
+        numClasses,
+        "numClasses",
+        "",
+        "The number of classes (2 for labels of -1 and 1)",
+        2);
+
+    parser.AddOption(
+        seed,
+        "seed",
+        "",
+        "The seed of the random weights and examples",
+        "123");
+}
+
+utilities::CommandLineParseResult ParsedScaleTestArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> errors;
+    if (sparsity < 0 || sparsity > 1 || datasetSparsity < 0 || datasetSparsity > 1)
+    {
+        errors.push_back("sparsity and datasetSparsity must be between 0 and 1");
+    }
+
+    if (model == ModelKind::convolution && filterSize % 2 == 0)
+    {
+        errors.push_back("filterSize must be odd");
+    }
+
+    if (dataset != DatasetKind::none && numClasses < 2)
+    {
+        errors.push_back("numClasses must be at least 2");
+    }
+    return errors;
+}
+} // namespace ell
@@ -7,7 +7,9 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "GenerateModels.h"
+#include "GenerateScaleTests.h"
 #include "ModelGenerateArguments.h"
+#include "ScaleTestArguments.h"
 
 #include <common/include/LoadModel.h>
 
@@ -15,6 +17,7 @@
 #include <utilities/include/Files.h>
 
 #include <iostream>
+#include <string>
 
 using namespace ell;
 
@@ -51,21 +54,109 @@ void SaveModels(const std::string& ext, std::string outputPath)
     common::SaveModel(GenerateBroadcastTimesTwoModel<float>(256), outputPath + "/broadcast_times_two." + ext);
 }
 
+std::string GetSparsitySuffix(double sparsity)
+{
+    return sparsity > 0 ? "_s" + std::to_string(static_cast<int>(sparsity * 100)) : "";
+}
+
+void SaveScaleTestModel(const ModelGenerateArguments& generateArguments, const ScaleTestArguments& arguments, std::string outputPath)
+{
+    if (outputPath.empty())
+    {
+        outputPath = ".";
+    }
+    ell::utilities::EnsureDirectoryExists(outputPath);
+
+    model::Map map;
+    std::string name;
+    switch (arguments.model)
+    {
+    case ScaleTestArguments::ModelKind::dense:
+        map = GenerateDenseScaleModel(arguments.inputSize, arguments.depth, arguments.width, arguments.sparsity, arguments.seed);
+        name = "dense_i" + std::to_string(arguments.inputSize) + "_d" + std::to_string(arguments.depth) + "_w" + std::to_string(arguments.width);
+        break;
+    case ScaleTestArguments::ModelKind::convolution:
+        map = GenerateConvolutionScaleModel(arguments.imageSize, arguments.imageSize, arguments.numChannels, arguments.depth, arguments.numFilters, arguments.filterSize, arguments.sparsity, arguments.seed);
+        name = "convolution_" + std::to_string(arguments.imageSize) + "x" + std::to_string(arguments.imageSize) + "x" + std::to_string(arguments.numChannels) + "_d" + std::to_string(arguments.depth) + "_f" + std::to_string(arguments.numFilters) + "_k" + std::to_string(arguments.filterSize);
+        break;
+    case ScaleTestArguments::ModelKind::recurrent:
+        map = GenerateRecurrentScaleModel(arguments.inputSize, arguments.depth, arguments.hiddenUnits, arguments.sequenceLength, arguments.sparsity, arguments.seed);
+        name = "recurrent_i" + std::to_string(arguments.inputSize) + "_d" + std::to_string(arguments.depth) + "_h" + std::to_string(arguments.hiddenUnits) + "_t" + std::to_string(arguments.sequenceLength);
+        break;
+    case ScaleTestArguments::ModelKind::none:
+        return;
+    }
+    name += GetSparsitySuffix(arguments.sparsity);
+
+    if (generateArguments.outputType == ModelGenerateArguments::OutputType::map)
+    {
+        common::SaveMap(map, outputPath + "/" + name + ".map");
+    }
+    else
+    {
+        common::SaveModel(map.GetModel(), outputPath + "/" + name + ".model");
+    }
+}
+
+void SaveScaleTestDataset(const ScaleTestArguments& arguments, std::string outputPath)
+{
+    if (outputPath.empty())
+    {
+        outputPath = ".";
+    }
+    ell::utilities::EnsureDirectoryExists(outputPath);
+
+    auto name = outputPath + "/dataset_n" + std::to_string(arguments.numExamples) + "_f" + std::to_string(arguments.numFeatures) + "_c" + std::to_string(arguments.numClasses) + GetSparsitySuffix(arguments.datasetSparsity);
+    switch (arguments.dataset)
+    {
+    case ScaleTestArguments::DatasetKind::dense:
+    {
+        auto stream = utilities::OpenOfstream(name + ".txt");
+        WriteScaleDataset(stream, ScaleDatasetFormat::dense, arguments.numExamples, arguments.numFeatures, arguments.datasetSparsity, arguments.numClasses, arguments.seed);
+        break;
+    }
+    case ScaleTestArguments::DatasetKind::sparse:
+    {
+        auto stream = utilities::OpenOfstream(name + ".sparse.txt");
+        WriteScaleDataset(stream, ScaleDatasetFormat::sparse, arguments.numExamples, arguments.numFeatures, arguments.datasetSparsity, arguments.numClasses, arguments.seed);
+        break;
+    }
+    case ScaleTestArguments::DatasetKind::binary:
+    {
+        auto stream = utilities::OpenBinaryOfstream(name + ".bin");
+        WriteScaleDataset(stream, ScaleDatasetFormat::binary, arguments.numExamples, arguments.numFeatures, arguments.datasetSparsity, arguments.numClasses, arguments.seed);
+        break;
+    }
+    case ScaleTestArguments::DatasetKind::none:
+        break;
+    }
+}
+
 int main(int argc, char* argv[])
 {
     try
     {
         ParsedModelGenerateArguments arguments;
+        ParsedScaleTestArguments scaleTestArguments;
 
         // create a command line parser
         utilities::CommandLineParser commandLineParser(argc, argv);
 
         // add arguments to the command line parser
         commandLineParser.AddOptionSet(arguments);
+        commandLineParser.AddOptionSet(scaleTestArguments);
 
         // parse command line
         commandLineParser.Parse();
 
+        if (scaleTestArguments.model != ScaleTestArguments::ModelKind::none || scaleTestArguments.dataset != ScaleTestArguments::DatasetKind::none)
+        {
+            // generate the synthetic scale test model and dataset
+            SaveScaleTestModel(arguments, scaleTestArguments, arguments.outputPath);
+            SaveScaleTestDataset(scaleTestArguments, arguments.outputPath);
+            return 0;
+        }
+
         // generate models
         SaveModels("model", arguments.outputPath);
     }
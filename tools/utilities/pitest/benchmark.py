@@ -0,0 +1,289 @@
+#!/usr/bin/env python3
+####################################################################################################
+#
+#  Project:  Embedded Learning Library (ELL)
+#  File:     benchmark.py
+#  Authors:  Chris Lovett
+#
+#  Requires: Python 3.x
+#
+####################################################################################################
+
+import argparse
+import datetime
+import os
+import re
+import sqlite3
+import subprocess
+import sys
+import threading
+from concurrent.futures import ThreadPoolExecutor
+
+# this script may be called from a different location, so we need the path
+# relative to it
+current_path = os.path.dirname(os.path.abspath(__file__))
+sys.path.append(os.path.join(current_path, "../pythonlibs"))
+import logger
+import picluster
+from remoterunner import RemoteRunner
+
+# the platform reported by the cluster's monitor for each target, as matched in drivetest.py
+target_platforms = {
+    "pi0": "ARMv6.*",
+    "pi3": "ARMv7.*",
+}
+
+node_line = re.compile(r"Node\[(.*)\]:\t(.*)\ttime: ([0-9.]+) ms\tcount: ([0-9]+)")
+latency_line = re.compile(r"count: ([0-9]+)\tmin: ([0-9.]+) ms\tmean: ([0-9.]+) ms\tp50: ([0-9.]+) ms\t"
+                          r"p90: ([0-9.]+) ms\tp99: ([0-9.]+) ms\tmax: ([0-9.]+) ms")
+variant_line = re.compile(r"Running ELL profiler tool -- (.*)")
+energy_line = re.compile(r"Energy: joules: ([0-9.]+) J\tseconds: ([0-9.]+) s\tmean power: ([0-9.]+) W\t"
+                         r"samples: ([0-9]+)")
+
+schema = """
+create table if not exists runs (
+    id integer primary key,
+    release text, model text, target text, device text, platform text, variant text, timestamp text,
+    count integer, min_ms real, mean_ms real, p50_ms real, p90_ms real, p99_ms real, max_ms real,
+    energy_j real, energy_s real, mean_w real);
+create table if not exists nodes (
+    run_id integer references runs(id), name text, type text, time_ms real, count integer);
+"""
+
+# columns added to the runs table after it was first made, so older databases get them too
+energy_columns = [("energy_j", "real"), ("energy_s", "real"), ("mean_w", "real")]
+
+
+def parse_profiler_output(output):
+    """Parses the output of build_and_run.sh into one result per profiler variant, each with the
+    per-iteration latency statistics, the per-node timings and the energy used by the run, if it was measured"""
+    results = []
+    result = None
+    in_nodes = False
+    for line in output:
+        if not isinstance(line, str):
+            continue
+        line = line.rstrip()
+        match = variant_line.match(line)
+        energy = energy_line.match(line)
+        if match:
+            result = {"variant": match.group(1), "latency": None, "nodes": [], "energy": None}
+            results.append(result)
+            in_nodes = False
+        elif result is None:
+            continue
+        elif energy:
+            values = [float(x) for x in energy.groups()[0:3]]
+            result["energy"] = dict(zip(["joules", "seconds", "watts"], values))
+        elif line == "Node statistics":
+            in_nodes = True
+        elif line == "Node type statistics":
+            in_nodes = False
+        elif in_nodes:
+            match = node_line.match(line)
+            if match:
+                result["nodes"].append({"name": match.group(1), "type": match.group(2).strip(),
+                                        "time_ms": float(match.group(3)), "count": int(match.group(4))})
+        else:
+            match = latency_line.match(line)
+            if match:
+                values = [float(x) for x in match.groups()]
+                result["latency"] = dict(zip(["count", "min", "mean", "p50", "p90", "p99", "max"], values))
+    return [r for r in results if r["latency"] is not None]
+
+
+class ResultsDatabase:
+    """A sqlite database of benchmark results, one row per profiler run on a device"""
+    def __init__(self, filename):
+        self.connection = sqlite3.connect(filename, check_same_thread=False)
+        self.connection.executescript(schema)
+        columns = [row[1] for row in self.connection.execute("pragma table_info(runs)")]
+        for name, column_type in energy_columns:
+            if name not in columns:
+                self.connection.execute("alter table runs add column {} {}".format(name, column_type))
+        self.lock = threading.Lock()
+
+    def add(self, release, model, target, device, platform, result):
+        latency = result["latency"]
+        energy = result.get("energy") or {}
+        timestamp = datetime.datetime.now().strftime("%Y-%m-%d %H:%M:%S")
+        with self.lock, self.connection:
+            cursor = self.connection.execute(
+                "insert into runs (release, model, target, device, platform, variant, timestamp, count, min_ms, "
+                "mean_ms, p50_ms, p90_ms, p99_ms, max_ms, energy_j, energy_s, mean_w) "
+                "values (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+                (release, model, target, device, platform, result["variant"], timestamp, int(latency["count"]),
+                 latency["min"], latency["mean"], latency["p50"], latency["p90"], latency["p99"], latency["max"],
+                 energy.get("joules"), energy.get("seconds"), energy.get("watts")))
+            run_id = cursor.lastrowid
+            self.connection.executemany(
+                "insert into nodes (run_id, name, type, time_ms, count) values (?, ?, ?, ?, ?)",
+                [(run_id, n["name"], n["type"], n["time_ms"], n["count"]) for n in result["nodes"]])
+
+    def summarize(self, release=None):
+        """Returns the results aggregated by release, model, device type and profiler variant. The energy per
+        inference is the mean power of a run times its mean latency, in millijoules, and is null for runs
+        without an energy meter"""
+        query = ("select release, model, target, variant, count(distinct device), count(*), avg(mean_ms), "
+                 "avg(p50_ms), max(p90_ms), max(p99_ms), avg(mean_w), avg(mean_w * mean_ms) from runs {} "
+                 "group by release, model, target, variant order by release, model, target, variant")
+        if release:
+            return self.connection.execute(query.format("where release = ?"), (release,)).fetchall()
+        return self.connection.execute(query.format("")).fetchall()
+
+    def summarize_nodes(self, release, model, target, variant):
+        """Returns the average time per evaluation of each node type for one device type, and its energy in
+        millijoules. A power meter can't resolve single nodes, so a node type's energy is its share of the time
+        at the mean power of the run"""
+        query = ("select nodes.type, avg(nodes.time_ms / nodes.count) as t, "
+                 "avg(nodes.time_ms / nodes.count * runs.mean_w) from nodes "
+                 "join runs on nodes.run_id = runs.id "
+                 "where runs.release = ? and runs.model = ? and runs.target = ? and runs.variant = ? "
+                 "group by nodes.type order by t desc")
+        return self.connection.execute(query, (release, model, target, variant)).fetchall()
+
+
+class ClusterBenchmark:
+    """Runs profilers made by make_profiler.sh on many devices of the cluster at once"""
+    def __init__(self, cluster, apikey, username, password, database, release, devices_per_target=1, timeout=None,
+                 energy_meter=None, energy_interval=0.01):
+        self.cluster = cluster
+        self.apikey = apikey
+        self.username = username
+        self.password = password
+        self.database = database
+        self.release = release
+        self.devices_per_target = devices_per_target
+        self.timeout = timeout
+        self.energy_meter = energy_meter
+        self.energy_interval = energy_interval
+        self.logger = logger.get()
+
+    def run_on_device(self, target, profiler_dir, index):
+        """Locks a free device for the target, runs the profiler and stores the results"""
+        # each thread gets its own connection to the cluster manager
+        cluster = picluster.PiBoardTable(self.cluster, self.apikey)
+        task = "benchmark {} {}".format(os.path.basename(profiler_dir), index)
+        machine = cluster.wait_for_free_machine(task, rePlatform=target_platforms.get(target))
+        try:
+            self.logger.info("Benchmarking {} on {}".format(profiler_dir, machine.ip_address))
+            target_dir = "/home/pi/" + os.path.basename(os.path.abspath(profiler_dir))
+            command = "build_and_run.sh"
+            if self.energy_meter:
+                command += " {} {}".format(self.energy_meter, self.energy_interval)
+            # the machine is already locked, so the runner doesn't get the cluster
+            runner = RemoteRunner(cluster=None, ipaddress=machine.ip_address, username=self.username,
+                                  password=self.password, source_dir=profiler_dir, target_dir=target_dir,
+                                  command=command, start_clean=True, cleanup=True,
+                                  timeout=self.timeout)
+            results = parse_profiler_output(runner.run_command())
+            if not results:
+                self.logger.error("No profile results from {}".format(machine.ip_address))
+            model = os.path.basename(os.path.abspath(profiler_dir))
+            for result in results:
+                if self.energy_meter and result["energy"] is None:
+                    self.logger.error("No energy measured for {} on {}".format(result["variant"], machine.ip_address))
+                self.database.add(self.release, model, target, machine.ip_address, machine.platform, result)
+            return len(results)
+        finally:
+            cluster.unlock(machine.ip_address)
+
+    def run(self, profilers):
+        """Runs each (target, profiler directory) pair on devices_per_target devices concurrently"""
+        jobs = [(target, profiler_dir, index) for target, profiler_dir in profilers
+                for index in range(self.devices_per_target)]
+        with ThreadPoolExecutor(max_workers=len(jobs)) as executor:
+            futures = [executor.submit(self.run_on_device, *job) for job in jobs]
+            failures = 0
+            for future in futures:
+                try:
+                    future.result()
+                except Exception as e:
+                    self.logger.error("### Benchmark failed: {}".format(e))
+                    failures += 1
+        return failures
+
+
+def get_release():
+    try:
+        return subprocess.check_output(["git", "describe", "--always", "--dirty"], cwd=current_path,
+                                       stderr=subprocess.DEVNULL).decode("utf-8").strip()
+    except Exception:
+        return "unknown"
+
+
+def format_energy(value, width=12):
+    return "{:>{}.3f}".format(value, width) if value is not None else "{:>{}}".format("-", width)
+
+
+def print_summary(database, release, log):
+    log.info("{:<20}{:<30}{:<12}{:<10}{:>8}{:>8}{:>12}{:>12}{:>12}{:>12}{:>12}{:>12}{:>12}".format(
+        "release", "model", "target", "variant", "devices", "runs", "mean ms", "p50 ms", "p90 ms", "p99 ms",
+        "mean W", "mJ/inf", "inf/J"))
+    for row in database.summarize(release):
+        watts, millijoules = row[10], row[11]
+        inferences_per_joule = 1000 / millijoules if millijoules else None
+        log.info("{:<20}{:<30}{:<12}{:<10}{:>8}{:>8}{:>12.3f}{:>12.3f}{:>12.3f}{:>12.3f}".format(*row[0:10]) +
+                 format_energy(watts) + format_energy(millijoules) + format_energy(inferences_per_joule))
+        for node_type, time_ms, node_millijoules in database.summarize_nodes(*row[0:4])[0:5]:
+            log.verbose("    {:<60}{:>12.4f} ms{} mJ".format(node_type, time_ms, format_energy(node_millijoules)))
+
+
+if __name__ == "__main__":
+    arg_parser = argparse.ArgumentParser(
+        "This script pushes compiled profilers made by make_profiler.sh to many devices of a Raspberry Pi\n"
+        "cluster in parallel, builds and runs them there, and stores the per-node timings and the latency\n"
+        "percentiles of each run in a results database, so releases can be compared on real hardware.\n"
+        "Example: benchmark.py --cluster http://... --profiler pi3=model_pi3 --profiler pi0=model_pi0 -n 4")
+
+    arg_parser.add_argument("--profiler", action="append", default=[],
+                            help="a target and the profiler directory made for it, as target=directory")
+    arg_parser.add_argument("--cluster", default=os.getenv("RPI_CLUSTER", None),
+                            help="http address of the cluster server that controls access to the devices")
+    arg_parser.add_argument("--key", default=os.getenv("RPI_APIKEY", None), help="the api key for the cluster")
+    arg_parser.add_argument("--username", default=os.getenv("RPI_USERNAME", "pi"),
+                            help="the username for the target devices")
+    arg_parser.add_argument("--password", default=os.getenv("RPI_PASSWORD", "raspberry"),
+                            help="the password for the target devices")
+    arg_parser.add_argument("--devices", "-n", type=int, default=1,
+                            help="the number of devices to run each profiler on at once (default 1)")
+    arg_parser.add_argument("--database", default="benchmarks.db",
+                            help="the sqlite results database (default 'benchmarks.db')")
+    arg_parser.add_argument("--release", default=None,
+                            help="the release to record the results under (default from 'git describe')")
+    arg_parser.add_argument("--timeout", type=int, default=600,
+                            help="the timeout for each remote run in seconds (default 600)")
+    arg_parser.add_argument("--energy_meter", default=None,
+                            help="measure the energy of each profiler run with this meter on the devices, such as "
+                            "hwmon:ina219, powercap or ina219:1:0x40:0.1 (see energymeter.py in the profiler)")
+    arg_parser.add_argument("--energy_interval", type=float, default=0.01,
+                            help="the time between samples of the energy meter in seconds (default 0.01)")
+    arg_parser.add_argument("--summary", action="store_true",
+                            help="only print the results in the database, aggregated by device type")
+
+    logger.add_logging_args(arg_parser)
+    args = arg_parser.parse_args()
+    log = logger.setup(args)
+
+    database = ResultsDatabase(args.database)
+    release = args.release if args.release else get_release()
+
+    if not args.summary:
+        if not args.profiler:
+            arg_parser.error("at least one --profiler is required")
+        if not args.cluster:
+            arg_parser.error("--cluster is required")
+        profilers = []
+        for profiler in args.profiler:
+            target, _, profiler_dir = profiler.partition("=")
+            if not profiler_dir or not os.path.isdir(profiler_dir):
+                arg_parser.error("profiler directory for '{}' not found".format(profiler))
+            profilers.append((target, profiler_dir))
+
+        benchmark = ClusterBenchmark(args.cluster, args.key, args.username, args.password, database, release,
+                                     args.devices, args.timeout, args.energy_meter, args.energy_interval)
+        failures = benchmark.run(profilers)
+        print_summary(database, release, log)
+        sys.exit(1 if failures else 0)
+
+    print_summary(database, args.release, log)
@@ -43,7 +43,7 @@ class DriveTest:
                  model=None, labels=None, target="pi3", target_dir="/home/pi/test",
                  username="pi", password="raspberry", iterations=1, expected=None,
                  blas=True, compile=COMPILE_INCREMENTAL, test=True, timeout=None, apikey=None,
-                 gitrepo=None, wrap_options=None):
+                 gitrepo=None, wrap_options=None, cache_dir=None):
         self.ipaddress = ipaddress
         self.build_root = find_ell.find_ell_build()
         self.ell_root = os.path.dirname(self.build_root)
@@ -83,6 +83,7 @@ class DriveTest:
         if wrap_options and type(wrap_options) is not list:
             raise Exception("'wrap_options' should be a list")
         self.wrap_options = wrap_options
+        self.cache_dir = cache_dir
 
         # initialize state from the args
         if not self.output_dir:
@@ -291,6 +292,8 @@ class DriveTest:
         builder_args.append(self.logger.getVerbosity())
         if self.profile:
             builder_args.append("--profile")
+        if self.cache_dir:
+            builder_args += ["--cache_dir", self.cache_dir]
 
         if self.wrap_options:
             builder_args += ['--'] + self.wrap_options
@@ -447,6 +450,9 @@ used as the model name")
     arg_parser.add_argument("--blas", default="True",
                             help="enable or disable the use of Blas on the target device (default 'True')")
     arg_parser.add_argument("--timeout", help="set remote test run timeout in seconds (default '300')", default="300")
+    arg_parser.add_argument("--cache_dir", default=os.getenv("ELL_BUILD_CACHE", None),
+                            help="a directory for caching the wrapped model, so it isn't compiled again when the model \
+and options haven't changed (default is the ELL_BUILD_CACHE environment variable)")
 
     logger.add_logging_args(arg_parser)
     args = arg_parser.parse_args()
@@ -461,5 +467,6 @@ used as the model name")
     with DriveTest(args.ipaddress, args.cluster, args.outdir, args.profile,
                    args.model, args.labels, args.target, args.target_dir, args.username,
                    args.password, args.iterations, args.expected, str2bool(args.blas),
-                   str2bool(args.compile), str2bool(args.test), args.timeout) as tester:
+                   str2bool(args.compile), str2bool(args.test), args.timeout,
+                   cache_dir=args.cache_dir) as tester:
         tester.run_test()
@@ -9,6 +9,7 @@
 #
 ####################################################################################################
 import argparse
+import os
 import sys
 import unittest
 import logging
@@ -25,6 +26,7 @@ password = None
 key = None
 targets = ["pi3", "pi0"]
 gitrepo = None
+cache_dir = None
 
 
 class PiTestBase(unittest.TestCase):
@@ -40,7 +42,7 @@ class PiTestBase(unittest.TestCase):
             log.info("=============== Testing platform: {} ===================".format(target))
             with drivetest.DriveTest(cluster=cluster, target=target, target_dir="/home/pi/test",
                                      username="pi", password=password, expected="coffee mug", timeout=300, apikey=key,
-                                     gitrepo=gitrepo) as driver:
+                                     gitrepo=gitrepo, cache_dir=cache_dir) as driver:
                 driver.run_test()
 
 
@@ -61,6 +63,8 @@ if __name__ == '__main__':
         '--gitrepo', help='The URL from where to get test models')
     parser.add_argument(
         '--targets', help='The raspberry pi targets (pi3, pi0, etc)', default="pi0,pi3")
+    parser.add_argument(
+        '--cache_dir', help='The directory for caching wrapped models', default=os.getenv("ELL_BUILD_CACHE", None))
 
     logger.add_logging_args(parser)
     args, argv = parser.parse_known_args()
@@ -69,6 +73,7 @@ if __name__ == '__main__':
     cluster = args.cluster
     password = args.password
     gitrepo = args.gitrepo
+    cache_dir = args.cache_dir
     if args.targets:
         targets = [x.strip() for x in args.targets.split(',')]
     key = args.key
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CostReport.h (print)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Model.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+/// <summary> The compute and memory throughput of a target device, for roofline estimates. </summary>
+struct DeviceProfile
+{
+    std::string name;
+    double peakGFlops = 0;
+    double memoryBandwidthGBytesPerSecond = 0;
+};
+
+/// <summary> The statically estimated cost of computing a node. </summary>
+struct NodeCost
+{
+    std::string nodeId;
+    std::string nodeType;
+    double flops = 0;
+    size_t parameterBytes = 0;
+    size_t inputBytes = 0;
+    size_t activationBytes = 0;
+};
+
+/// <summary> Gets the nominal profile of a target device, by the name `--target` takes or a CPU name like cortex-m4. </summary>
+///
+/// <param name="target"> The target device name or CPU name. Unknown names get the host profile. </param>
+///
+/// <returns> The device profile. </returns>
+DeviceProfile GetDeviceProfile(const std::string& target);
+
+/// <summary> Estimates the cost of each node of a model, in the order the model is visited. </summary>
+///
+/// <param name="model"> The model. </param>
+///
+/// <returns> The node costs. </returns>
+std::vector<NodeCost> GetNodeCosts(const model::Model& model);
+
+/// <summary> Estimates the largest total size of the node outputs that are live at once, if nodes are computed in visit order. </summary>
+///
+/// <param name="model"> The model. </param>
+///
+/// <returns> The peak live activation memory, in bytes. Constants don't count, since they're parameters. </returns>
+size_t GetPeakLiveActivationBytes(const model::Model& model);
+
+/// <summary> Writes a table of per-node FLOPs, parameter bytes, activation bytes and arithmetic intensity, with each
+/// node classified as compute or memory bound against a device profile, followed by the model totals. </summary>
+///
+/// <param name="model"> The model. </param>
+/// <param name="device"> The device profile to classify nodes against. </param>
+/// <param name="out"> The stream to write to. </param>
+void PrintCostReport(const model::Model& model, const DeviceProfile& device, std::ostream& out);
+} // namespace ell
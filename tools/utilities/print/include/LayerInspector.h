@@ -63,6 +63,10 @@ static std::string ConvolutionMethodToString(ell::predictors::neural::Convolutio
         return "winograd";
     case ell::predictors::neural::ConvolutionMethod::unrolled:
         return "unrolled";
+    case ell::predictors::neural::ConvolutionMethod::depthwise:
+        return "depthwise";
+    case ell::predictors::neural::ConvolutionMethod::blocked:
+        return "blocked";
     }
     return "";
 }
@@ -24,6 +24,8 @@ struct PrintArguments
     bool compile;
     bool includeNodeId;
     bool nodeDetails;
+    double peakGFlops;
+    double memoryBandwidth;
     utilities::OutputStreamImpostor outputStream;
 };
 
@@ -0,0 +1,414 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CostReport.cpp (print)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CostReport.h"
+
+#include <model/include/InputPort.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+
+#include <nodes/include/MatrixVectorProductNode.h>
+#include <nodes/include/NeuralNetworkLayerNode.h>
+
+#include <predictors/neural/include/BinaryConvolutionalLayer.h>
+#include <predictors/neural/include/ConvolutionalLayer.h>
+#include <predictors/neural/include/FullyConnectedLayer.h>
+#include <predictors/neural/include/Layer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace ell
+{
+namespace
+{
+    // Nominal numbers, from the clock rate, core count and SIMD width of each device's CPU and the sustained
+    // bandwidth of its memory. They are only meant to tell compute bound nodes from memory bound ones.
+    const std::map<std::string, DeviceProfile> KnownDeviceProfiles = {
+        { "host", { "host", 100.0, 20.0 } },
+        { "pi0", { "pi0", 0.7, 0.5 } },
+        { "pi3", { "pi3", 38.4, 2.0 } },
+        { "pi3_64", { "pi3_64", 38.4, 2.0 } },
+        { "orangepi0", { "orangepi0", 19.2, 1.0 } },
+        { "aarch64", { "aarch64", 38.4, 2.0 } },
+        { "ios", { "ios", 50.0, 10.0 } },
+        { "cortex-m0", { "cortex-m0", 0.005, 0.1 } },
+        { "cortex-m4", { "cortex-m4", 0.2, 0.4 } },
+        { "cortex-m7", { "cortex-m7", 0.8, 1.0 } }
+    };
+
+    // Nodes that only move or hold data, and don't compute anything
+    const std::set<std::string> DataMovementNodeTypes = {
+        "ClockNode",
+        "ConstantNode",
+        "DebugSinkNode",
+        "InputNode",
+        "OutputNode",
+        "ReceptiveFieldMatrixNode",
+        "ReorderDataNode",
+        "SinkNode",
+        "SourceNode",
+        "SpliceNode"
+    };
+
+    // Nodes whose output is the product of their two inputs, as matrices or vectors
+    const std::set<std::string> ProductNodeTypes = {
+        "DotProductNode",
+        "MatrixMatrixMultiplyNode",
+        "MatrixVectorMultiplyNode"
+    };
+
+    std::string GetBaseTypeName(const model::Node& node)
+    {
+        auto typeName = node.GetRuntimeTypeName();
+        return typeName.substr(0, typeName.find('<'));
+    }
+
+    size_t GetElementSize(model::Port::PortType type)
+    {
+        switch (type)
+        {
+        case model::Port::PortType::boolean:
+            return sizeof(bool);
+        case model::Port::PortType::integer:
+            return sizeof(int);
+        case model::Port::PortType::bigInt:
+            return sizeof(int64_t);
+        case model::Port::PortType::smallReal:
+            return sizeof(float);
+        case model::Port::PortType::real:
+            return sizeof(double);
+        default:
+            return 0;
+        }
+    }
+
+    size_t GetOutputBytes(const model::Node& node)
+    {
+        size_t bytes = 0;
+        for (auto port : node.GetOutputPorts())
+        {
+            bytes += port->GetMemoryLayout().GetMemorySize() * GetElementSize(port->GetType());
+        }
+        return bytes;
+    }
+
+    size_t GetOutputElements(const model::Node& node)
+    {
+        size_t elements = 0;
+        for (auto port : node.GetOutputPorts())
+        {
+            elements += port->GetMemoryLayout().NumElements();
+        }
+        return elements;
+    }
+
+    template <typename ValueType>
+    void GetLayerCost(const predictors::neural::Layer<ValueType>& layer, NodeCost& cost)
+    {
+        using namespace predictors::neural;
+        auto outputElements = static_cast<double>(layer.GetOutputShapeMinusPadding().Size());
+        switch (layer.GetLayerType())
+        {
+        case LayerType::convolution:
+        {
+            const auto& convolutionalLayer = static_cast<const ConvolutionalLayer<ValueType>&>(layer);
+            const auto& weights = convolutionalLayer.GetWeights();
+            auto receptiveField = static_cast<double>(convolutionalLayer.GetConvolutionalParameters().receptiveField);
+            cost.flops = 2 * outputElements * receptiveField * receptiveField * weights.NumChannels();
+            cost.parameterBytes = weights.Size() * sizeof(ValueType);
+            break;
+        }
+        case LayerType::binaryConvolution:
+        {
+            // Counted as though the binarized weights were real ones
+            const auto& binaryLayer = static_cast<const BinaryConvolutionalLayer<ValueType>&>(layer);
+            auto receptiveField = static_cast<double>(binaryLayer.GetConvolutionalParameters().receptiveField);
+            cost.flops = 2 * outputElements * receptiveField * receptiveField * layer.GetInputShapeMinusPadding().NumChannels();
+            break;
+        }
+        case LayerType::fullyConnected:
+        {
+            const auto& weights = static_cast<const FullyConnectedLayer<ValueType>&>(layer).GetWeights();
+            cost.flops = 2 * static_cast<double>(weights.NumRows()) * weights.NumColumns();
+            cost.parameterBytes = weights.NumRows() * weights.NumColumns() * sizeof(ValueType);
+            break;
+        }
+        case LayerType::batchNormalization:
+            cost.flops = 2 * outputElements;
+            cost.parameterBytes = 2 * layer.GetOutputShapeMinusPadding().NumChannels() * sizeof(ValueType);
+            break;
+        case LayerType::bias:
+        case LayerType::scaling:
+            cost.flops = outputElements;
+            cost.parameterBytes = layer.GetOutputShapeMinusPadding().NumChannels() * sizeof(ValueType);
+            break;
+        case LayerType::pooling:
+        {
+            auto inputElements = static_cast<double>(layer.GetInputShapeMinusPadding().Size());
+            cost.flops = std::max(inputElements, outputElements);
+            break;
+        }
+        case LayerType::softmax:
+            cost.flops = 3 * outputElements;
+            break;
+        default:
+            cost.flops = outputElements;
+            break;
+        }
+    }
+
+    template <typename ValueType>
+    bool TryGetLayerNodeCost(const model::Node& node, NodeCost& cost)
+    {
+        auto layerNode = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<ValueType>*>(&node);
+        if (layerNode == nullptr)
+        {
+            return false;
+        }
+        GetLayerCost(layerNode->GetBaseLayer(), cost);
+        return true;
+    }
+
+    template <typename ValueType, math::MatrixLayout layout>
+    bool TryGetMatrixVectorProductNodeCost(const model::Node& node, NodeCost& cost)
+    {
+        auto productNode = dynamic_cast<const nodes::MatrixVectorProductNode<ValueType, layout>*>(&node);
+        if (productNode == nullptr)
+        {
+            return false;
+        }
+        const auto& matrix = productNode->GetProjectionMatrix();
+        cost.flops = 2 * static_cast<double>(matrix.NumRows()) * matrix.NumColumns();
+        cost.parameterBytes = matrix.NumRows() * matrix.NumColumns() * sizeof(ValueType);
+        return true;
+    }
+
+    template <typename ValueType>
+    bool TryGetMatrixVectorProductNodeCost(const model::Node& node, NodeCost& cost)
+    {
+        return TryGetMatrixVectorProductNodeCost<ValueType, math::MatrixLayout::rowMajor>(node, cost) ||
+               TryGetMatrixVectorProductNodeCost<ValueType, math::MatrixLayout::columnMajor>(node, cost);
+    }
+
+    void GetGenericNodeCost(const model::Node& node, NodeCost& cost)
+    {
+        auto typeName = GetBaseTypeName(node);
+        auto outputElements = static_cast<double>(GetOutputElements(node));
+        if (DataMovementNodeTypes.count(typeName) != 0)
+        {
+            cost.flops = 0;
+        }
+        else if (ProductNodeTypes.count(typeName) != 0 && node.NumInputPorts() == 2 && outputElements > 0)
+        {
+            // For an (m x k) times (k x n) product, the inputs have mk and kn elements and the output mn, which gives k
+            auto input1Size = static_cast<double>(node.GetInputPort(0)->Size());
+            auto input2Size = static_cast<double>(node.GetInputPort(1)->Size());
+            auto innerSize = std::sqrt(input1Size * input2Size / outputElements);
+            cost.flops = 2 * outputElements * innerSize;
+        }
+        else if (auto filterWeights = node.GetInputPort("filterWeights"))
+        {
+            // Each output element of a convolution is a dot product with one filter, and there's a filter per output channel
+            auto outputLayout = node.GetOutputPort(0)->GetMemoryLayout();
+            auto outputChannels = static_cast<double>(outputLayout.NumDimensions() == 3 ? outputLayout.GetLogicalDimensionActiveSize(2) : 1);
+            cost.flops = 2 * outputElements * static_cast<double>(filterWeights->Size()) / std::max(outputChannels, 1.0);
+        }
+        else
+        {
+            // Elementwise nodes do about one operation per output element
+            cost.flops = outputElements;
+        }
+    }
+
+    std::string FormatBytes(double bytes)
+    {
+        std::stringstream stream;
+        stream << std::fixed << std::setprecision(1);
+        if (bytes >= 1024 * 1024)
+        {
+            stream << bytes / (1024 * 1024) << " MB";
+        }
+        else if (bytes >= 1024)
+        {
+            stream << bytes / 1024 << " KB";
+        }
+        else
+        {
+            stream << bytes << " B";
+        }
+        return stream.str();
+    }
+
+    double GetArithmeticIntensity(const NodeCost& cost)
+    {
+        auto bytes = static_cast<double>(cost.parameterBytes + cost.inputBytes + cost.activationBytes);
+        return bytes > 0 ? cost.flops / bytes : 0;
+    }
+
+    // The roofline time: the longer of the time to do the arithmetic and the time to move the data
+    double GetEstimatedSeconds(const NodeCost& cost, const DeviceProfile& device)
+    {
+        auto bytes = static_cast<double>(cost.parameterBytes + cost.inputBytes + cost.activationBytes);
+        auto computeSeconds = device.peakGFlops > 0 ? cost.flops / (device.peakGFlops * 1e9) : 0;
+        auto memorySeconds = device.memoryBandwidthGBytesPerSecond > 0 ? bytes / (device.memoryBandwidthGBytesPerSecond * 1e9) : 0;
+        return std::max(computeSeconds, memorySeconds);
+    }
+} // namespace
+
+DeviceProfile GetDeviceProfile(const std::string& target)
+{
+    auto iter = KnownDeviceProfiles.find(target);
+    if (iter == KnownDeviceProfiles.end())
+    {
+        auto profile = KnownDeviceProfiles.at("host");
+        profile.name = target;
+        return profile;
+    }
+    return iter->second;
+}
+
+std::vector<NodeCost> GetNodeCosts(const model::Model& model)
+{
+    std::vector<NodeCost> costs;
+    model.Visit([&costs](const model::Node& node) {
+        NodeCost cost;
+        cost.nodeId = to_string(node.GetId());
+        cost.nodeType = node.GetRuntimeTypeName();
+        if (!TryGetLayerNodeCost<float>(node, cost) && !TryGetLayerNodeCost<double>(node, cost) &&
+            !TryGetMatrixVectorProductNodeCost<float>(node, cost) && !TryGetMatrixVectorProductNodeCost<double>(node, cost))
+        {
+            GetGenericNodeCost(node, cost);
+        }
+
+        // Constants are the parameters of the refined model
+        if (GetBaseTypeName(node) == "ConstantNode")
+        {
+            cost.parameterBytes = GetOutputBytes(node);
+        }
+        else
+        {
+            cost.activationBytes = GetOutputBytes(node);
+            for (auto port : node.GetInputPorts())
+            {
+                if (GetBaseTypeName(*port->GetReferencedPort().GetNode()) != "ConstantNode")
+                {
+                    cost.inputBytes += port->Size() * GetElementSize(port->GetType());
+                }
+            }
+        }
+        costs.push_back(cost);
+    });
+    return costs;
+}
+
+size_t GetPeakLiveActivationBytes(const model::Model& model)
+{
+    // Find the step at which each node's output is last read. Outputs nothing reads stay live to the end.
+    std::vector<const model::Node*> order;
+    model.Visit([&order](const model::Node& node) { order.push_back(&node); });
+
+    std::unordered_map<const model::Node*, size_t> steps;
+    for (size_t step = 0; step < order.size(); ++step)
+    {
+        steps[order[step]] = step;
+    }
+
+    std::vector<std::vector<const model::Node*>> releases(order.size());
+    for (size_t step = 0; step < order.size(); ++step)
+    {
+        auto node = order[step];
+        auto lastUse = order.size() - 1;
+        auto dependents = node->GetDependentNodes();
+        if (!dependents.empty())
+        {
+            lastUse = step;
+            for (auto dependent : dependents)
+            {
+                auto iter = steps.find(dependent);
+                if (iter != steps.end())
+                {
+                    lastUse = std::max(lastUse, iter->second);
+                }
+            }
+        }
+        releases[lastUse].push_back(node);
+    }
+
+    size_t liveBytes = 0;
+    size_t peakBytes = 0;
+    for (size_t step = 0; step < order.size(); ++step)
+    {
+        if (GetBaseTypeName(*order[step]) != "ConstantNode")
+        {
+            liveBytes += GetOutputBytes(*order[step]);
+        }
+        peakBytes = std::max(peakBytes, liveBytes);
+        for (auto node : releases[step])
+        {
+            if (GetBaseTypeName(*node) != "ConstantNode")
+            {
+                liveBytes -= GetOutputBytes(*node);
+            }
+        }
+    }
+    return peakBytes;
+}
+
+void PrintCostReport(const model::Model& model, const DeviceProfile& device, std::ostream& out)
+{
+    auto costs = GetNodeCosts(model);
+    auto ridgePoint = device.memoryBandwidthGBytesPerSecond > 0 ? device.peakGFlops / device.memoryBandwidthGBytesPerSecond : 0;
+
+    out << "Device: " << device.name << " (" << device.peakGFlops << " GFLOP/s, " << device.memoryBandwidthGBytesPerSecond << " GB/s, ridge point " << std::setprecision(3) << ridgePoint << " FLOP/byte)\n\n";
+
+    size_t typeWidth = 4;
+    for (const auto& cost : costs)
+    {
+        typeWidth = std::max(typeWidth, cost.nodeType.size());
+    }
+
+    out << std::left << std::setw(8) << "id" << std::setw(static_cast<int>(typeWidth) + 2) << "type" << std::right;
+    out << std::setw(12) << "MFLOPs" << std::setw(12) << "params" << std::setw(12) << "inputs" << std::setw(12) << "outputs";
+    out << std::setw(12) << "FLOP/byte" << std::setw(9) << "bound" << std::setw(12) << "est. us" << "\n";
+
+    double totalFlops = 0;
+    size_t totalParameterBytes = 0;
+    size_t totalActivationBytes = 0;
+    double totalSeconds = 0;
+    for (const auto& cost : costs)
+    {
+        auto intensity = GetArithmeticIntensity(cost);
+        auto seconds = GetEstimatedSeconds(cost, device);
+        std::string bound = cost.flops == 0 ? "-" : (intensity >= ridgePoint ? "compute" : "memory");
+
+        out << std::left << std::setw(8) << cost.nodeId << std::setw(static_cast<int>(typeWidth) + 2) << cost.nodeType << std::right;
+        out << std::fixed << std::setprecision(3) << std::setw(12) << cost.flops / 1e6;
+        out << std::setw(12) << FormatBytes(static_cast<double>(cost.parameterBytes)) << std::setw(12) << FormatBytes(static_cast<double>(cost.inputBytes)) << std::setw(12) << FormatBytes(static_cast<double>(cost.activationBytes));
+        out << std::setprecision(2) << std::setw(12) << intensity << std::setw(9) << bound << std::setw(12) << seconds * 1e6 << "\n";
+        out << std::defaultfloat;
+
+        totalFlops += cost.flops;
+        totalParameterBytes += cost.parameterBytes;
+        totalActivationBytes += cost.activationBytes;
+        totalSeconds += seconds;
+    }
+
+    out << "\nTotal: " << std::fixed << std::setprecision(3) << totalFlops / 1e6 << " MFLOPs, ";
+    out << FormatBytes(static_cast<double>(totalParameterBytes)) << " of parameters, ";
+    out << FormatBytes(static_cast<double>(totalActivationBytes)) << " of activations, ";
+    out << FormatBytes(static_cast<double>(GetPeakLiveActivationBytes(model))) << " peak live activations\n";
+    out << "Estimated time: " << std::setprecision(1) << totalSeconds * 1e6 << " us\n";
+    out << std::defaultfloat;
+}
+} // namespace ell
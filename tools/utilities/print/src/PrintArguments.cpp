@@ -15,11 +15,13 @@ namespace ell
 void ParsedPrintArguments::AddArgs(utilities::CommandLineParser& parser)
 {
     parser.AddOption(outputFilename, "outputFilename", "of", "Path to the output file", "");
-    parser.AddOption(outputFormat, "outputFormat", "fmt", "What output format to generate [text|dgml|dot] (default text)", "text");
+    parser.AddOption(outputFormat, "outputFormat", "fmt", "What output format to generate [text|dgml|dot|cost] (default text)", "text");
     parser.AddOption(refine, "refineIterations", "ri", "If not 0, the model is refined using the specified the number of refinement iterations", 0);
     parser.AddOption(compile, "compile", "c", "If true, the model is compiled before being printed", false);
     parser.AddOption(includeNodeId, "includeNodeId", "incid", "Include the node id in the print", false);
     parser.AddOption(nodeDetails, "nodeDetails", "", "Include node details", true);
+    parser.AddOption(peakGFlops, "peakGFlops", "", "For the cost report, the peak GFLOP/s of the device, or 0 to use the profile of the compile target", 0.0);
+    parser.AddOption(memoryBandwidth, "memoryBandwidth", "", "For the cost report, the memory bandwidth of the device in GB/s, or 0 to use the profile of the compile target", 0.0);
 }
 
 utilities::CommandLineParseResult ParsedPrintArguments::PostProcess(const utilities::CommandLineParser& parser)
@@ -38,6 +40,10 @@ utilities::CommandLineParseResult ParsedPrintArguments::PostProcess(const utilit
     }
 
     std::vector<std::string> parseErrorMessages;
+    if (peakGFlops < 0 || memoryBandwidth < 0)
+    {
+        parseErrorMessages.push_back("peakGFlops and memoryBandwidth can't be negative");
+    }
     return parseErrorMessages;
 }
 } // namespace ell
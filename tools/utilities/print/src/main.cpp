@@ -6,6 +6,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "CostReport.h"
 #include "PrintArguments.h"
 #include "PrintGraph.h"
 #include "PrintModel.h"
@@ -119,6 +120,20 @@ int main(int argc, char* argv[])
         {
             PrintGraph(model, lowerOutputFormat, out, printArguments.includeNodeId);
         }
+        else if (lowerOutputFormat == "cost")
+        {
+            const auto& target = mapCompilerArguments.cpu.empty() ? mapCompilerArguments.target : mapCompilerArguments.cpu;
+            auto device = GetDeviceProfile(target.empty() ? "host" : target);
+            if (printArguments.peakGFlops > 0)
+            {
+                device.peakGFlops = printArguments.peakGFlops;
+            }
+            if (printArguments.memoryBandwidth > 0)
+            {
+                device.memoryBandwidthGBytesPerSecond = printArguments.memoryBandwidth;
+            }
+            PrintCostReport(model, device, out);
+        }
         else
         {
             PrintModel(model, out, { printArguments.includeNodeId, printArguments.nodeDetails });
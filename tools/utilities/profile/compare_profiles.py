@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+####################################################################################################
+#
+#  Project:  Embedded Learning Library (ELL)
+#  File:     compare_profiles.py
+#  Authors:  Chuck Jacobs
+#
+#  Requires: Python 3.x
+#
+####################################################################################################
+
+"""Compares two sets of profile tool reports ('profile --format json') of the same model on the same device,
+and reports the nodes, node types and model totals that got significantly slower.
+
+Each report is one run. The per-node average times of the runs of each side form two samples, which are
+compared with a one-sided Mann-Whitney U test, and the p-values are corrected for the number of comparisons
+with the Holm-Bonferroni method. A comparison is a regression if it is significant and the median time grew by
+more than the threshold. The script exits with a nonzero code if there are regressions, so it can gate a build.
+"""
+
+import argparse
+import json
+import math
+import statistics
+import sys
+
+# Exit codes
+NO_REGRESSIONS = 0
+REGRESSIONS = 1
+ERROR = 2
+
+# Above this many orderings of the two samples, p-values use the normal approximation instead of the exact distribution
+MAX_EXACT_COMBINATIONS = 1000000
+
+
+class ProfileError(Exception):
+    pass
+
+
+def num_combinations(n, k):
+    return math.factorial(n) // (math.factorial(k) * math.factorial(n - k))
+
+
+def load_profile(filename):
+    """ Loads a profile report and returns (node times, model time), where node times maps (node name, node type)
+        to the average time per call in ms, and model time is the average time per model evaluation in ms, or None """
+    with open(filename, "r") as f:
+        try:
+            report = json.load(f)
+        except ValueError as e:
+            raise ProfileError("{} isn't a JSON profile report: {}".format(filename, e))
+    if "node_statistics" not in report:
+        raise ProfileError("{} has no node statistics (was it written with '--format json'?)".format(filename))
+
+    nodes = {}
+    for node in report["node_statistics"]:
+        if node["count"] > 0:
+            nodes[(node["name"], node["type"])] = node["total_time"] / node["count"]
+
+    model_time = None
+    model = report.get("model_statistics")
+    if model is not None and model["count"] > 0:
+        model_time = model["total_time"] / model["count"]
+    return nodes, model_time
+
+
+def mann_whitney_u(baseline, candidate):
+    """ Returns the one-sided p-value of the Mann-Whitney U test for the hypothesis that candidate values tend to be
+        larger than baseline values """
+    m = len(baseline)
+    n = len(candidate)
+    values = sorted([(value, 0) for value in baseline] + [(value, 1) for value in candidate])
+
+    # Rank the values, giving tied values their average rank
+    ranks = [0.0] * len(values)
+    tie_sizes = []
+    start = 0
+    while start < len(values):
+        end = start
+        while end + 1 < len(values) and values[end + 1][0] == values[start][0]:
+            end += 1
+        for index in range(start, end + 1):
+            ranks[index] = (start + end) / 2.0 + 1
+        tie_sizes.append(end - start + 1)
+        start = end + 1
+
+    candidate_rank_sum = sum(rank for rank, (_, side) in zip(ranks, values) if side == 1)
+    u = candidate_rank_sum - n * (n + 1) / 2.0
+    has_ties = any(size > 1 for size in tie_sizes)
+
+    if not has_ties and num_combinations(m + n, n) <= MAX_EXACT_COMBINATIONS:
+        # counts[k] is the number of orderings of the two samples with U == k
+        counts = u_distribution(m, n)
+        tail = sum(counts[int(u):])
+        return tail / num_combinations(m + n, n)
+
+    # Normal approximation, with tie and continuity corrections
+    mean = m * n / 2.0
+    tie_term = sum(size ** 3 - size for size in tie_sizes) / ((m + n) * (m + n - 1))
+    variance = m * n / 12.0 * ((m + n + 1) - tie_term)
+    if variance <= 0:
+        return 1.0
+    z = (u - mean - 0.5) / math.sqrt(variance)
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def u_distribution(m, n):
+    """ Returns the number of orderings of m baseline and n candidate values with each value of U, from 0 to m * n """
+    # table[i][j] holds the counts for i baseline and j candidate values, built with the recurrence
+    # f(u; i, j) = f(u - i; i, j - 1) + f(u; i - 1, j), on whether the largest value is a candidate value or not
+    table = [[None] * (n + 1) for _ in range(m + 1)]
+    for i in range(m + 1):
+        for j in range(n + 1):
+            if i == 0 or j == 0:
+                table[i][j] = [1]
+                continue
+            counts = [0] * (i * j + 1)
+            for u, count in enumerate(table[i][j - 1]):
+                counts[u + i] += count
+            for u, count in enumerate(table[i - 1][j]):
+                counts[u] += count
+            table[i][j] = counts
+    return table[m][n]
+
+
+def holm_correction(p_values):
+    """ Returns the Holm-Bonferroni adjusted p-values, in the same order """
+    order = sorted(range(len(p_values)), key=lambda index: p_values[index])
+    adjusted = [1.0] * len(p_values)
+    running_max = 0.0
+    for rank, index in enumerate(order):
+        running_max = max(running_max, min(1.0, (len(p_values) - rank) * p_values[index]))
+        adjusted[index] = running_max
+    return adjusted
+
+
+def get_samples(runs):
+    """ Returns the per-run samples of each node, node type, and the model total, keyed on ('node', name, type),
+        ('type', type) and ('model',) """
+    samples = {}
+    for nodes, model_time in runs:
+        type_times = {}
+        for (name, node_type), time in nodes.items():
+            samples.setdefault(("node", name, node_type), []).append(time)
+            type_times[node_type] = type_times.get(node_type, 0.0) + time
+        for node_type, time in type_times.items():
+            samples.setdefault(("type", node_type), []).append(time)
+        if model_time is not None:
+            samples.setdefault(("model",), []).append(model_time)
+    return samples
+
+
+def compare(baseline_runs, candidate_runs, threshold=0.05, alpha=0.05, min_time=0.0):
+    """ Compares the runs of the two sides, and returns a dictionary with the comparisons, the names of the nodes
+        that only appear on one side, and the regressions """
+    baseline_nodes = set(key for nodes, _ in baseline_runs for key in nodes)
+    candidate_nodes = set(key for nodes, _ in candidate_runs for key in nodes)
+    common_nodes = baseline_nodes & candidate_nodes
+    if not common_nodes or len(common_nodes) < 0.5 * max(len(baseline_nodes), len(candidate_nodes)):
+        raise ProfileError("the profiles have few nodes in common, so they don't appear to be from the same model")
+
+    # Only nodes that are on both sides are compared, so the node type sums cover the same nodes
+    def common_runs(runs):
+        return [({key: time for key, time in nodes.items() if key in common_nodes}, model_time)
+                for nodes, model_time in runs]
+    baseline_samples = get_samples(common_runs(baseline_runs))
+    candidate_samples = get_samples(common_runs(candidate_runs))
+
+    comparisons = []
+    for key in sorted(baseline_samples.keys() & candidate_samples.keys()):
+        baseline = baseline_samples[key]
+        candidate = candidate_samples[key]
+        if len(baseline) != len(baseline_runs) or len(candidate) != len(candidate_runs):
+            continue
+        baseline_median = statistics.median(baseline)
+        candidate_median = statistics.median(candidate)
+        if baseline_median < min_time and candidate_median < min_time:
+            continue
+        change = (candidate_median - baseline_median) / baseline_median if baseline_median > 0 else math.inf
+        comparisons.append({
+            "kind": key[0],
+            "name": key[1] if key[0] == "node" else "",
+            "type": key[-1] if key[0] != "model" else "",
+            "baseline_median": baseline_median,
+            "candidate_median": candidate_median,
+            "change": change,
+            "p_value": mann_whitney_u(baseline, candidate)
+        })
+
+    for comparison, adjusted in zip(comparisons, holm_correction([c["p_value"] for c in comparisons])):
+        comparison["adjusted_p_value"] = adjusted
+        comparison["regression"] = adjusted <= alpha and comparison["change"] > threshold
+
+    def node_names(keys):
+        return sorted("{} ({})".format(name, node_type) for name, node_type in keys)
+
+    return {
+        "baseline_runs": len(baseline_runs),
+        "candidate_runs": len(candidate_runs),
+        "min_p_value": 1.0 / num_combinations(len(baseline_runs) + len(candidate_runs), len(candidate_runs)),
+        "comparisons": comparisons,
+        "removed_nodes": node_names(baseline_nodes - candidate_nodes),
+        "added_nodes": node_names(candidate_nodes - baseline_nodes),
+        "regressions": [c for c in comparisons if c["regression"]]
+    }
+
+
+def write_text_report(result, alpha, out):
+    def describe(comparison):
+        if comparison["kind"] == "model":
+            return "Model"
+        if comparison["kind"] == "type":
+            return "Type[{}]".format(comparison["type"])
+        return "Node[{}] {}".format(comparison["name"], comparison["type"])
+
+    out.write("Compared {} baseline runs with {} candidate runs\n".format(result["baseline_runs"],
+                                                                         result["candidate_runs"]))
+    if result["min_p_value"] > alpha / max(len(result["comparisons"]), 1):
+        out.write("Warning: there are too few runs for any comparison to be significant, add more runs to each side\n")
+
+    regressions = sorted(result["regressions"], key=lambda c: -c["change"])
+    out.write("\nRegressions: {}\n".format(len(regressions)))
+    for comparison in regressions:
+        out.write("{}:\tbaseline: {:.5f} ms\tcandidate: {:.5f} ms\tchange: {:+.1f}%\tp: {:.4g}\n".format(
+            describe(comparison), comparison["baseline_median"], comparison["candidate_median"],
+            100 * comparison["change"], comparison["adjusted_p_value"]))
+
+    for title, names in [("Nodes only in the baseline", result["removed_nodes"]),
+                         ("Nodes only in the candidate", result["added_nodes"])]:
+        if names:
+            out.write("\n{}: {}\n".format(title, ", ".join(names)))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+        description="Compares profile tool reports ('profile --format json') of two builds of the same model on "
+        "the same device, and reports significant per-node, per-node-type and model slowdowns. Each report is one "
+        "run; use several runs per side. Exits with 1 if there are regressions.")
+    parser.add_argument("--baseline", "-b", nargs="+", required=True, help="Profile reports of the baseline runs")
+    parser.add_argument("--candidate", "-c", nargs="+", required=True, help="Profile reports of the candidate runs")
+    parser.add_argument("--threshold", "-t", type=float, default=0.05,
+                        help="Smallest relative growth of the median time that counts as a regression")
+    parser.add_argument("--alpha", "-a", type=float, default=0.05,
+                        help="Significance level, after correcting for the number of comparisons")
+    parser.add_argument("--min_time", type=float, default=0.0,
+                        help="Ignore nodes and node types whose median time is below this on both sides (ms)")
+    parser.add_argument("--format", "-f", choices=["text", "json"], default="text", help="Format of the report")
+    args = parser.parse_args(argv)
+
+    try:
+        baseline_runs = [load_profile(filename) for filename in args.baseline]
+        candidate_runs = [load_profile(filename) for filename in args.candidate]
+        result = compare(baseline_runs, candidate_runs, args.threshold, args.alpha, args.min_time)
+    except (OSError, KeyError, ProfileError) as e:
+        print("Error: {}".format(e), file=sys.stderr)
+        return ERROR
+
+    if args.format == "json":
+        json.dump(result, sys.stdout, indent=2)
+        sys.stdout.write("\n")
+    else:
+        write_text_report(result, args.alpha, sys.stdout)
+    return REGRESSIONS if result["regressions"] else NO_REGRESSIONS
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
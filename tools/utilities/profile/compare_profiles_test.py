@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+####################################################################################################
+#
+#  Project:  Embedded Learning Library (ELL)
+#  File:     compare_profiles_test.py
+#  Authors:  Chuck Jacobs
+#
+#  Requires: Python 3.x
+#
+####################################################################################################
+
+import json
+import os
+import random
+import sys
+import tempfile
+import unittest
+
+script_path = os.path.dirname(os.path.abspath(__file__))
+sys.path.append(script_path)
+
+import compare_profiles
+
+
+def make_run(node_times, rng, noise=0.02):
+    """ Returns a run of the given {(name, type): time} nodes, with multiplicative noise """
+    nodes = {key: time * (1 + rng.uniform(-noise, noise)) for key, time in node_times.items()}
+    return nodes, sum(nodes.values())
+
+
+class CompareProfilesTest(unittest.TestCase):
+    node_times = {
+        ("1", "InputNode<float>"): 0.01,
+        ("2", "ConvolutionalLayerNode<float>"): 2.0,
+        ("3", "ConvolutionalLayerNode<float>"): 1.5,
+        ("4", "ReLUActivationLayerNode<float>"): 0.2,
+        ("5", "SoftmaxLayerNode<float>"): 0.1
+    }
+
+    def test_exact_p_value(self):
+        # With 3 runs per side, the candidate values all being larger has probability 1 / C(6, 3)
+        self.assertAlmostEqual(compare_profiles.mann_whitney_u([1, 2, 3], [4, 5, 6]), 1 / 20)
+        self.assertAlmostEqual(compare_profiles.mann_whitney_u([4, 5, 6], [1, 2, 3]), 1.0)
+        self.assertAlmostEqual(sum(compare_profiles.u_distribution(4, 5)), compare_profiles.num_combinations(9, 4))
+
+    def test_holm_correction(self):
+        adjusted = compare_profiles.holm_correction([0.01, 0.04, 0.03])
+        self.assertEqual(len(adjusted), 3)
+        self.assertAlmostEqual(adjusted[0], 0.03)
+        self.assertAlmostEqual(adjusted[1], 0.06)
+        self.assertAlmostEqual(adjusted[2], 0.06)
+
+    def test_no_regression(self):
+        rng = random.Random(1)
+        baseline = [make_run(self.node_times, rng) for _ in range(10)]
+        candidate = [make_run(self.node_times, rng) for _ in range(10)]
+        result = compare_profiles.compare(baseline, candidate)
+        self.assertEqual(result["regressions"], [])
+
+    def test_node_regression(self):
+        rng = random.Random(2)
+        slower_times = dict(self.node_times)
+        slower_times[("4", "ReLUActivationLayerNode<float>")] *= 1.5
+        baseline = [make_run(self.node_times, rng) for _ in range(10)]
+        candidate = [make_run(slower_times, rng) for _ in range(10)]
+        result = compare_profiles.compare(baseline, candidate)
+        regressions = set((c["kind"], c["name"], c["type"]) for c in result["regressions"])
+        self.assertIn(("node", "4", "ReLUActivationLayerNode<float>"), regressions)
+        self.assertIn(("type", "", "ReLUActivationLayerNode<float>"), regressions)
+        self.assertNotIn(("node", "2", "ConvolutionalLayerNode<float>"), regressions)
+
+        # The same slowdown isn't a regression if it's under the threshold
+        result = compare_profiles.compare(baseline, candidate, threshold=0.6)
+        self.assertEqual(result["regressions"], [])
+
+    def test_different_models(self):
+        rng = random.Random(3)
+        other_times = {("1" + name, node_type): time for (name, node_type), time in self.node_times.items()}
+        baseline = [make_run(self.node_times, rng) for _ in range(3)]
+        candidate = [make_run(other_times, rng) for _ in range(3)]
+        with self.assertRaises(compare_profiles.ProfileError):
+            compare_profiles.compare(baseline, candidate)
+
+    def test_exit_code(self):
+        rng = random.Random(4)
+        slower_times = {key: 2 * time for key, time in self.node_times.items()}
+        with tempfile.TemporaryDirectory() as directory:
+            def write_runs(prefix, node_times):
+                filenames = []
+                for index in range(6):
+                    nodes, model_time = make_run(node_times, rng)
+                    report = {
+                        "node_statistics": [{"name": name, "type": node_type, "total_time": 10 * time,
+                                             "average_time": time, "count": 10}
+                                            for (name, node_type), time in nodes.items()],
+                        "model_statistics": {"total_time": 10 * model_time, "average_time": model_time, "count": 10}
+                    }
+                    filename = os.path.join(directory, "{}{}.json".format(prefix, index))
+                    with open(filename, "w") as f:
+                        json.dump(report, f)
+                    filenames.append(filename)
+                return filenames
+
+            baseline = write_runs("baseline", self.node_times)
+            same = write_runs("same", self.node_times)
+            slower = write_runs("slower", slower_times)
+            with open(os.devnull, "w") as null:
+                stdout = sys.stdout
+                sys.stdout = null
+                try:
+                    self.assertEqual(compare_profiles.main(["-b"] + baseline + ["-c"] + same),
+                                     compare_profiles.NO_REGRESSIONS)
+                    self.assertEqual(compare_profiles.main(["-b"] + baseline + ["-c"] + slower),
+                                     compare_profiles.REGRESSIONS)
+                finally:
+                    sys.stdout = stdout
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+####################################################################################################
+#
+#  Project:  Embedded Learning Library (ELL)
+#  File:     energymeter.py
+#  Authors:  Chris Lovett
+#
+#  Requires: Python 3.x
+#
+####################################################################################################
+
+"""Runs a command, such as a profiler, while measuring the energy the device uses, and prints the energy after
+the command's output, on a line that pitest's benchmark.py parses.
+
+The energy is read from one of these meters:
+
+    hwmon[:NAME]                        a Linux hwmon device, such as the ina2xx driver of an INA219 or INA226
+                                        power monitor, or a SoC sensor. Its energy1_input counter is used if it
+                                        has one, otherwise its power1_input is sampled and integrated. NAME picks
+                                        the device by the contents of its 'name' file.
+    powercap[:ZONE]                     a powercap energy counter, such as intel-rapl:0 (often only readable by root)
+    ina219[:BUS[:ADDRESS[:SHUNT]]]      an INA219 read directly over I2C (default bus 1, address 0x40, 0.1 ohm shunt),
+                                        which needs the smbus2 or smbus python package
+
+A power monitor on the supply measures the whole board, so compare runs on the same device with the same peripherals.
+"""
+
+import argparse
+import glob
+import os
+import subprocess
+import sys
+import threading
+import time
+
+# The line printed after the command's output
+ENERGY_FORMAT = "Energy: joules: {:.6f} J\tseconds: {:.3f} s\tmean power: {:.4f} W\tsamples: {}"
+
+
+class EnergyMeterError(Exception):
+    pass
+
+
+def read_number(path):
+    with open(path, "r") as f:
+        return int(f.read().strip())
+
+
+class CounterSource:
+    """A cumulative energy counter in microjoules, which wraps around at max_range if that is given"""
+    is_counter = True
+
+    def __init__(self, path, max_range=None):
+        self.path = path
+        self.max_range = max_range
+
+    def read(self):
+        return read_number(self.path)
+
+    def to_joules(self, previous, current):
+        delta = current - previous
+        if delta < 0 and self.max_range:
+            delta += self.max_range
+        return delta * 1.0e-6
+
+
+class PowerSource:
+    """Instantaneous power in microwatts, from a sysfs file"""
+    is_counter = False
+
+    def __init__(self, path):
+        self.path = path
+
+    def read(self):
+        return read_number(self.path) * 1.0e-6
+
+
+class INA219Source:
+    """Instantaneous power from an INA219 over I2C, with the chip in its default continuous mode"""
+    is_counter = False
+    SHUNT_VOLTAGE_REGISTER = 0x01
+    BUS_VOLTAGE_REGISTER = 0x02
+
+    def __init__(self, bus=1, address=0x40, shunt_ohms=0.1):
+        try:
+            import smbus2 as smbus
+        except ImportError:
+            try:
+                import smbus
+            except ImportError:
+                raise EnergyMeterError("reading an INA219 needs the smbus2 or smbus package")
+        self.bus = smbus.SMBus(bus)
+        self.address = address
+        self.shunt_ohms = shunt_ohms
+
+    def read_register(self, register):
+        # SMBus words are little-endian, the INA219's registers are big-endian
+        value = self.bus.read_word_data(self.address, register)
+        return ((value & 0xff) << 8) | (value >> 8)
+
+    def read(self):
+        shunt = self.read_register(self.SHUNT_VOLTAGE_REGISTER)
+        if shunt & 0x8000:
+            shunt -= 0x10000
+        shunt_volts = shunt * 10.0e-6
+        bus_volts = (self.read_register(self.BUS_VOLTAGE_REGISTER) >> 3) * 4.0e-3
+        return bus_volts * shunt_volts / self.shunt_ohms
+
+
+def find_hwmon_source(hwmon_root, name=None):
+    for device in sorted(glob.glob(os.path.join(hwmon_root, "hwmon*"))):
+        name_file = os.path.join(device, "name")
+        if name and (not os.path.isfile(name_file) or open(name_file).read().strip() != name):
+            continue
+        if os.path.isfile(os.path.join(device, "energy1_input")):
+            return CounterSource(os.path.join(device, "energy1_input"))
+        if os.path.isfile(os.path.join(device, "power1_input")):
+            return PowerSource(os.path.join(device, "power1_input"))
+    raise EnergyMeterError("no hwmon device{} with an energy or power sensor".format(
+        " named '{}'".format(name) if name else ""))
+
+
+def find_powercap_source(powercap_root, zone=None):
+    zones = [os.path.join(powercap_root, zone)] if zone else sorted(glob.glob(os.path.join(powercap_root, "*")))
+    for path in zones:
+        energy_file = os.path.join(path, "energy_uj")
+        if os.path.isfile(energy_file):
+            range_file = os.path.join(path, "max_energy_range_uj")
+            max_range = read_number(range_file) if os.path.isfile(range_file) else None
+            return CounterSource(energy_file, max_range)
+    raise EnergyMeterError("no powercap zone{} with an energy counter".format(" '{}'".format(zone) if zone else ""))
+
+
+def make_source(spec, sysfs_class_root="/sys/class"):
+    """Returns the energy source for a meter given as kind[:options]"""
+    kind, _, options = spec.partition(":")
+    if kind == "hwmon":
+        return find_hwmon_source(os.path.join(sysfs_class_root, "hwmon"), options or None)
+    if kind == "powercap":
+        return find_powercap_source(os.path.join(sysfs_class_root, "powercap"), options or None)
+    if kind == "ina219":
+        values = options.split(":") if options else []
+        bus = int(values[0]) if len(values) > 0 and values[0] else 1
+        address = int(values[1], 0) if len(values) > 1 and values[1] else 0x40
+        shunt_ohms = float(values[2]) if len(values) > 2 and values[2] else 0.1
+        return INA219Source(bus, address, shunt_ohms)
+    raise EnergyMeterError("unknown energy meter '{}'".format(spec))
+
+
+def integrate_power(samples):
+    """Returns the energy in joules of (time, watts) samples, by the trapezoidal rule"""
+    joules = 0.0
+    for (t0, p0), (t1, p1) in zip(samples, samples[1:]):
+        joules += (t1 - t0) * (p0 + p1) / 2
+    return joules
+
+
+class EnergyMeter:
+    """Samples an energy source on a thread between start() and stop(). Counters are sampled too, so that
+    their wraparounds are seen."""
+    def __init__(self, source, interval=0.01):
+        self.source = source
+        self.interval = interval
+        self.samples = []
+        self.stopping = threading.Event()
+        self.thread = None
+
+    def sample(self):
+        self.samples.append((time.monotonic(), self.source.read()))
+
+    def run(self):
+        while not self.stopping.wait(self.interval):
+            self.sample()
+
+    def start(self):
+        self.samples = []
+        self.stopping.clear()
+        self.sample()
+        self.thread = threading.Thread(target=self.run, daemon=True)
+        self.thread.start()
+
+    def stop(self):
+        """Stops sampling and returns (joules, seconds, number of samples)"""
+        self.stopping.set()
+        self.thread.join()
+        self.sample()
+        seconds = self.samples[-1][0] - self.samples[0][0]
+        if self.source.is_counter:
+            joules = sum(self.source.to_joules(a[1], b[1]) for a, b in zip(self.samples, self.samples[1:]))
+        else:
+            joules = integrate_power(self.samples)
+        return joules, seconds, len(self.samples)
+
+
+def format_energy(joules, seconds, num_samples):
+    return ENERGY_FORMAT.format(joules, seconds, joules / seconds if seconds > 0 else 0.0, num_samples)
+
+
+def main(argv):
+    arg_parser = argparse.ArgumentParser(
+        "Runs a command while measuring the energy the device uses, and prints the energy after its output\n"
+        "Example: energymeter.py --meter hwmon:ina219 -- ./profile 100 20",
+        formatter_class=argparse.RawDescriptionHelpFormatter, epilog=__doc__)
+    arg_parser.add_argument("--meter", required=True, help="the energy meter, as kind[:options]")
+    arg_parser.add_argument("--interval", type=float, default=0.01,
+                            help="the time between samples of the meter in seconds (default 0.01)")
+    arg_parser.add_argument("command", nargs=argparse.REMAINDER, help="the command to run, after --")
+    args = arg_parser.parse_args(argv)
+
+    command = args.command[1:] if args.command[:1] == ["--"] else args.command
+    if not command:
+        arg_parser.error("a command is required")
+
+    try:
+        meter = EnergyMeter(make_source(args.meter), args.interval)
+        meter.start()
+    except (EnergyMeterError, OSError) as e:
+        print("### Energy meter failed: {}".format(e), file=sys.stderr)
+        return subprocess.call(command)
+
+    try:
+        result = subprocess.call(command)
+    finally:
+        energy = meter.stop()
+    sys.stdout.flush()
+    print(format_energy(*energy))
+    return result
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
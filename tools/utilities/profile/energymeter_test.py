@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+####################################################################################################
+#
+#  Project:  Embedded Learning Library (ELL)
+#  File:     energymeter_test.py
+#  Authors:  Chris Lovett
+#
+#  Requires: Python 3.x
+#
+####################################################################################################
+
+import os
+import sys
+import tempfile
+import time
+import unittest
+
+script_path = os.path.dirname(os.path.abspath(__file__))
+sys.path.append(script_path)
+
+import energymeter
+
+
+def write_file(path, contents):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as f:
+        f.write(contents)
+
+
+class EnergyMeterTest(unittest.TestCase):
+    def test_integrate_power(self):
+        self.assertAlmostEqual(energymeter.integrate_power([(0.0, 2.0), (1.0, 2.0), (3.0, 2.0)]), 6.0)
+        self.assertAlmostEqual(energymeter.integrate_power([(0.0, 1.0), (2.0, 3.0)]), 4.0)
+        self.assertEqual(energymeter.integrate_power([(0.0, 1.0)]), 0.0)
+
+    def test_counter_wraparound(self):
+        source = energymeter.CounterSource("energy_uj", max_range=1000000)
+        self.assertAlmostEqual(source.to_joules(200000, 700000), 0.5)
+        self.assertAlmostEqual(source.to_joules(900000, 100000), 0.2)
+
+    def test_find_sources(self):
+        with tempfile.TemporaryDirectory() as root:
+            write_file(os.path.join(root, "hwmon", "hwmon0", "name"), "cpu_thermal\n")
+            write_file(os.path.join(root, "hwmon", "hwmon0", "temp1_input"), "45000\n")
+            write_file(os.path.join(root, "hwmon", "hwmon1", "name"), "ina219\n")
+            write_file(os.path.join(root, "hwmon", "hwmon1", "power1_input"), "2500000\n")
+            write_file(os.path.join(root, "powercap", "intel-rapl:0", "energy_uj"), "123\n")
+            write_file(os.path.join(root, "powercap", "intel-rapl:0", "max_energy_range_uj"), "1000\n")
+
+            source = energymeter.make_source("hwmon:ina219", root)
+            self.assertFalse(source.is_counter)
+            self.assertAlmostEqual(source.read(), 2.5)
+            self.assertAlmostEqual(energymeter.make_source("hwmon", root).read(), 2.5)
+
+            source = energymeter.make_source("powercap", root)
+            self.assertTrue(source.is_counter)
+            self.assertEqual(source.read(), 123)
+            self.assertEqual(source.max_range, 1000)
+
+            with self.assertRaises(energymeter.EnergyMeterError):
+                energymeter.make_source("hwmon:cpu_thermal", root)
+            with self.assertRaises(energymeter.EnergyMeterError):
+                energymeter.make_source("multimeter", root)
+
+    def test_meter(self):
+        with tempfile.TemporaryDirectory() as root:
+            write_file(os.path.join(root, "hwmon", "hwmon0", "power1_input"), "2000000\n")
+            meter = energymeter.EnergyMeter(energymeter.make_source("hwmon", root), interval=0.005)
+            meter.start()
+            time.sleep(0.05)
+            joules, seconds, num_samples = meter.stop()
+            self.assertGreater(num_samples, 2)
+            self.assertAlmostEqual(joules, 2 * seconds)
+
+        line = energymeter.format_energy(1.5, 3.0, 10)
+        self.assertEqual(line, "Energy: joules: 1.500000 J\tseconds: 3.000 s\tmean power: 0.5000 W\tsamples: 10")
+
+
+if __name__ == "__main__":
+    unittest.main()
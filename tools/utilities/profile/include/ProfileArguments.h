@@ -22,6 +22,7 @@ struct ProfileArguments
     std::string inputConverter;
     std::string outputFilename;
     std::string timingOutputFilename;
+    std::string profileDataFilename;
     ProfileOutputFormat outputFormat = ProfileOutputFormat::text;
     std::string outputComment;
 
@@ -30,6 +31,14 @@ struct ProfileArguments
     bool filterTrivialNodes = true;
     bool summaryOnly = false;
 
+    int numInstances = 1;
+    std::string cpus;
+    bool memoryReport = false;
+
+    bool efficiencyReport = false;
+    double peakGFlops = 0; // 0 to use the nominal peak of the target device
+    double peakGBytesPerSecond = 0;
+
     // TODO: something about regions
 };
 
@@ -43,3 +43,41 @@ void WriteUserComment(const std::string& comment, ProfileOutputFormat format, st
 void WriteModelStatistics(const ELL_PerformanceCounters* modelStats, ProfileOutputFormat format, std::ostream& out);
 void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCounters>>& nodeInfo, std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCounters>>& nodeTypeInfo, ProfileOutputFormat format, std::ostream& out);
 void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileOutputFormat format, std::ostream& out);
+
+//
+// End-to-end latency, throughput and memory statistics
+//
+struct LatencyStatistics
+{
+    size_t count = 0;
+    double min = 0;
+    double mean = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+    std::vector<std::pair<double, size_t>> histogram; // (upper bound, count) of equal-width buckets from min to max
+};
+
+struct NodeMemoryInfo
+{
+    std::string name;
+    std::string type;
+    size_t bufferSize; // bytes of the node's output buffers
+};
+
+struct NodeEfficiencyInfo
+{
+    std::string name;
+    std::string type;
+    double flops; // statically estimated floating-point operations per call
+    double bytes; // statically estimated bytes read and written per call
+    int count; // number of profiled calls
+    double totalTime; // ms
+};
+
+LatencyStatistics GetLatencyStatistics(std::vector<double> latencies, size_t numHistogramBuckets = 10);
+void WriteLatencyStatistics(const std::vector<double>& latencies, ProfileOutputFormat format, std::ostream& out);
+void WriteThroughputStatistics(size_t numInstances, size_t numIterations, double totalTime, ProfileOutputFormat format, std::ostream& out);
+void WriteMemoryStatistics(size_t peakResidentSetSize, const std::vector<NodeMemoryInfo>& nodes, ProfileOutputFormat format, std::ostream& out);
+void WriteEfficiencyStatistics(const std::vector<NodeEfficiencyInfo>& nodes, double peakGFlops, double peakGBytesPerSecond, ProfileOutputFormat format, std::ostream& out);
@@ -12,6 +12,7 @@
 #include "compiled_model.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <random>
@@ -139,15 +140,20 @@ void ProfileModel(const ProfileArguments& profileArguments)
     }
     ResetProfilingInfo();
 
-    // Now evaluate the model and record the profiling info
+    // Now evaluate the model and record the profiling info, and the latency of each evaluation
+    std::vector<double> latencies;
+    latencies.reserve(profileArguments.numIterations);
     for (int iter = 0; iter < profileArguments.numIterations; ++iter)
     {
+        auto start = std::chrono::steady_clock::now();
+
         // Exercise the model
 #ifdef ELL_WRAPPER_CLASS
         wrapper.Predict(input, output);
 #else
         ELL_Predict(nullptr, input.data(), output.data());
 #endif
+        latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
     }
 
     auto format = profileArguments.outputFormat;
@@ -162,6 +168,7 @@ void ProfileModel(const ProfileArguments& profileArguments)
         WriteNodeStatistics(format, profileOutputStream);
         WriteRegionStatistics(format, profileOutputStream);
         WriteModelStatistics(format, profileOutputStream);
+        WriteLatencyStatistics(latencies, format, profileOutputStream);
     }
     else
     {
@@ -176,6 +183,8 @@ void ProfileModel(const ProfileArguments& profileArguments)
         WriteRegionStatistics(format, profileOutputStream);
         profileOutputStream << ",\n";
         WriteModelStatistics(format, profileOutputStream);
+        profileOutputStream << ",\n";
+        WriteLatencyStatistics(latencies, format, profileOutputStream);
         profileOutputStream << "}\n";
     }
 }
@@ -35,6 +35,13 @@ void ParsedProfileArguments::AddArgs(utilities::CommandLineParser& parser)
         "",
         "<cout>");
 
+    parser.AddOption(
+        profileDataFilename,
+        "profileData",
+        "pd",
+        "File for per-node profile data that can be passed to the compile tool's --profileData option (blank for no output)",
+        "");
+
     parser.AddOption(
         outputFormat,
         "format",
@@ -78,5 +85,47 @@ void ParsedProfileArguments::AddArgs(utilities::CommandLineParser& parser)
         "",
         "Print timing summary only",
         false);
+
+    parser.AddOption(
+        numInstances,
+        "instances",
+        "",
+        "Number of model instances to run concurrently, each on its own thread, to measure throughput (implies --summary)",
+        1);
+
+    parser.AddOption(
+        cpus,
+        "cpus",
+        "",
+        "Comma-separated list of the CPUs to pin the model instances to, in order (blank to not pin them)",
+        "");
+
+    parser.AddOption(
+        memoryReport,
+        "memory",
+        "",
+        "Report the peak resident set size and the buffer size of each node",
+        false);
+
+    parser.AddOption(
+        efficiencyReport,
+        "efficiency",
+        "",
+        "Report each node's achieved GFLOP/s and GB/s, from its estimated FLOP and byte counts and its measured time, and the percent of the device's peak it reaches",
+        false);
+
+    parser.AddOption(
+        peakGFlops,
+        "peakGFlops",
+        "",
+        "The device's peak compute throughput for --efficiency, in GFLOP/s (0 to use the nominal peak of the target device)",
+        0.0);
+
+    parser.AddOption(
+        peakGBytesPerSecond,
+        "peakBandwidth",
+        "",
+        "The device's peak memory bandwidth for --efficiency, in GB/s (0 to use the nominal peak of the target device)",
+        0.0);
 }
 } // namespace ell
@@ -9,7 +9,9 @@
 #include "ProfileReport.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <numeric>
 #include <iomanip>
 #include <ostream>
 #include <sstream>
@@ -146,7 +148,6 @@ void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCoun
         out << "],\n";
 
         out << "\"node_type_statistics\": [\n";
-        out << "  [";
         for (const auto& info : nodeTypeInfo)
         {
             out << "  {\n";
@@ -167,10 +168,17 @@ void WriteNodeStatistics(std::vector<std::pair<ELL_NodeInfo, ELL_PerformanceCoun
     }
 }
 
+// Returns true if the model was compiled with hardware counters enabled (on a machine where they could be read)
+bool HasHardwareCounters(const std::vector<ELL_ProfileRegionInfo>& regions)
+{
+    return std::any_of(regions.begin(), regions.end(), [](const auto& info) { return info.cycles != 0 || info.instructions != 0; });
+}
+
 void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileOutputFormat format, std::ostream& out)
 {
     // Write region statistics
     auto numRegions = regions.size();
+    auto hasHardwareCounters = HasHardwareCounters(regions);
     if (format == ProfileOutputFormat::text)
     {
         if (numRegions > 0)
@@ -188,7 +196,14 @@ void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileO
             out << "\nRegion statistics" << std::endl;
             for (const auto& info : regions)
             {
-                out << "Region[" << info.name << "]:\t" << std::setw(maxNameLength) << std::left << "\ttime: " << info.totalTime << " ms\tcount: " << info.count << "\n";
+                out << "Region[" << info.name << "]:\t" << std::setw(maxNameLength) << std::left << "\ttime: " << info.totalTime << " ms\tcount: " << info.count;
+                if (hasHardwareCounters)
+                {
+                    auto instructionsPerCycle = info.cycles == 0 ? 0.0 : static_cast<double>(info.instructions) / info.cycles;
+                    out << "\tcycles: " << info.cycles << "\tinstructions: " << info.instructions << "\tIPC: " << instructionsPerCycle
+                        << "\tL1 misses: " << info.l1CacheMisses << "\tLLC misses: " << info.lastLevelCacheMisses << "\tbranch misses: " << info.branchMisses;
+                }
+                out << "\n";
             }
 
             out << "\n\n";
@@ -205,6 +220,14 @@ void WriteRegionStatistics(std::vector<ELL_ProfileRegionInfo>& regions, ProfileO
                 << "\"" << EncodeJSONString((const char*)(info.name)) << "\",\n";
             out << "    \"total_time\": " << info.totalTime << ",\n";
             out << "    \"average_time\": " << info.totalTime / info.count << ",\n";
+            if (hasHardwareCounters)
+            {
+                out << "    \"cycles\": " << info.cycles << ",\n";
+                out << "    \"instructions\": " << info.instructions << ",\n";
+                out << "    \"l1_cache_misses\": " << info.l1CacheMisses << ",\n";
+                out << "    \"last_level_cache_misses\": " << info.lastLevelCacheMisses << ",\n";
+                out << "    \"branch_misses\": " << info.branchMisses << ",\n";
+            }
             out << "    \"count\": " << info.count << "\n";
             out << "  }";
             bool isLast = (&info == &regions.back());
@@ -224,3 +247,208 @@ void fun()
     // Not sure why the windows linker is not resolving it anyway.
     printf("hi");
 }
+
+namespace
+{
+double GetPercentile(const std::vector<double>& sortedValues, double percentile)
+{
+    auto position = percentile * static_cast<double>(sortedValues.size() - 1);
+    auto lower = static_cast<size_t>(std::floor(position));
+    auto upper = std::min(lower + 1, sortedValues.size() - 1);
+    auto fraction = position - static_cast<double>(lower);
+    return sortedValues[lower] + fraction * (sortedValues[upper] - sortedValues[lower]);
+}
+} // namespace
+
+LatencyStatistics GetLatencyStatistics(std::vector<double> latencies, size_t numHistogramBuckets)
+{
+    LatencyStatistics statistics;
+    if (latencies.empty())
+    {
+        return statistics;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    statistics.count = latencies.size();
+    statistics.min = latencies.front();
+    statistics.max = latencies.back();
+    statistics.mean = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+    statistics.p50 = GetPercentile(latencies, 0.5);
+    statistics.p90 = GetPercentile(latencies, 0.9);
+    statistics.p99 = GetPercentile(latencies, 0.99);
+
+    numHistogramBuckets = std::max<size_t>(numHistogramBuckets, 1);
+    auto bucketWidth = (statistics.max - statistics.min) / numHistogramBuckets;
+    auto latency = latencies.begin();
+    for (size_t bucket = 0; bucket < numHistogramBuckets; ++bucket)
+    {
+        // the last bucket ends at the maximum exactly, so rounding can't leave latencies out
+        auto upperBound = bucket + 1 == numHistogramBuckets ? statistics.max : statistics.min + (bucket + 1) * bucketWidth;
+        auto bucketEnd = std::upper_bound(latency, latencies.end(), upperBound);
+        statistics.histogram.emplace_back(upperBound, static_cast<size_t>(bucketEnd - latency));
+        latency = bucketEnd;
+    }
+    return statistics;
+}
+
+void WriteLatencyStatistics(const std::vector<double>& latencies, ProfileOutputFormat format, std::ostream& out)
+{
+    auto statistics = GetLatencyStatistics(latencies);
+    if (format == ProfileOutputFormat::text)
+    {
+        std::ios::fmtflags savedFlags(out.flags());
+        out << std::fixed;
+        out.precision(5);
+
+        out << "\nLatency statistics" << std::endl;
+        out << "count: " << statistics.count << "\tmin: " << statistics.min << " ms\tmean: " << statistics.mean << " ms\tp50: " << statistics.p50 << " ms\tp90: " << statistics.p90 << " ms\tp99: " << statistics.p99 << " ms\tmax: " << statistics.max << " ms" << std::endl;
+        for (const auto& bucket : statistics.histogram)
+        {
+            out << "  <= " << bucket.first << " ms:\t" << bucket.second << "\n";
+        }
+
+        out.flags(savedFlags);
+    }
+    else // json
+    {
+        out << "\"latency_statistics\": {\n";
+        out << "  \"count\": " << statistics.count << ",\n";
+        out << "  \"min\": " << statistics.min << ",\n";
+        out << "  \"mean\": " << statistics.mean << ",\n";
+        out << "  \"p50\": " << statistics.p50 << ",\n";
+        out << "  \"p90\": " << statistics.p90 << ",\n";
+        out << "  \"p99\": " << statistics.p99 << ",\n";
+        out << "  \"max\": " << statistics.max << ",\n";
+        out << "  \"histogram\": [";
+        for (const auto& bucket : statistics.histogram)
+        {
+            out << (&bucket == &statistics.histogram.front() ? "\n" : ",\n");
+            out << "    { \"upper_bound\": " << bucket.first << ", \"count\": " << bucket.second << " }";
+        }
+        out << "\n  ]\n";
+        out << "}";
+    }
+}
+
+void WriteThroughputStatistics(size_t numInstances, size_t numIterations, double totalTime, ProfileOutputFormat format, std::ostream& out)
+{
+    auto throughput = totalTime > 0 ? 1000.0 * numIterations / totalTime : 0.0;
+    if (format == ProfileOutputFormat::text)
+    {
+        std::ios::fmtflags savedFlags(out.flags());
+        out << std::fixed;
+        out.precision(5);
+
+        out << "\nThroughput statistics" << std::endl;
+        out << "Instances: " << numInstances << "\titerations: " << numIterations << "\ttotal time: " << totalTime << " ms\tthroughput: " << throughput << " iterations/s" << std::endl;
+
+        out.flags(savedFlags);
+    }
+    else // json
+    {
+        out << "\"throughput_statistics\": {\n";
+        out << "  \"num_instances\": " << numInstances << ",\n";
+        out << "  \"count\": " << numIterations << ",\n";
+        out << "  \"total_time\": " << totalTime << ",\n";
+        out << "  \"throughput\": " << throughput << "\n";
+        out << "}";
+    }
+}
+
+void WriteMemoryStatistics(size_t peakResidentSetSize, const std::vector<NodeMemoryInfo>& nodes, ProfileOutputFormat format, std::ostream& out)
+{
+    auto totalBufferSize = std::accumulate(nodes.begin(), nodes.end(), size_t{ 0 }, [](size_t total, const NodeMemoryInfo& node) { return total + node.bufferSize; });
+    if (format == ProfileOutputFormat::text)
+    {
+        size_t maxTypeLength = 0;
+        for (const auto& node : nodes)
+        {
+            maxTypeLength = std::max(maxTypeLength, node.type.size());
+        }
+
+        out << "\nMemory statistics" << std::endl;
+        out << "Peak resident set size: " << peakResidentSetSize << " bytes\ttotal node buffer size: " << totalBufferSize << " bytes" << std::endl;
+        for (const auto& node : nodes)
+        {
+            out << "Node[" << node.name << "]:\t" << std::setw(maxTypeLength) << std::left << node.type << std::right << "\tbuffer size: " << node.bufferSize << " bytes\n";
+        }
+    }
+    else // json
+    {
+        out << "\"memory_statistics\": {\n";
+        out << "  \"peak_resident_set_size\": " << peakResidentSetSize << ",\n";
+        out << "  \"total_buffer_size\": " << totalBufferSize << ",\n";
+        out << "  \"nodes\": [";
+        for (const auto& node : nodes)
+        {
+            out << (&node == &nodes.front() ? "\n" : ",\n");
+            out << "    { \"name\": \"" << EncodeJSONString(node.name) << "\", \"type\": \"" << EncodeJSONString(node.type) << "\", \"buffer_size\": " << node.bufferSize << " }";
+        }
+        out << "\n  ]\n";
+        out << "}";
+    }
+}
+
+void WriteEfficiencyStatistics(const std::vector<NodeEfficiencyInfo>& nodes, double peakGFlops, double peakGBytesPerSecond, ProfileOutputFormat format, std::ostream& out)
+{
+    struct Efficiency
+    {
+        const NodeEfficiencyInfo* node;
+        double gflops;
+        double gbytesPerSecond;
+        double percentOfPeak; // the roofline time for the node's FLOPs and bytes, as a percent of the measured time
+        bool isComputeBound;
+    };
+
+    std::vector<Efficiency> efficiencies;
+    for (const auto& node : nodes)
+    {
+        if (node.count == 0 || node.totalTime <= 0 || (node.flops == 0 && node.bytes == 0))
+        {
+            continue;
+        }
+
+        auto seconds = node.totalTime / node.count / 1000.0;
+        auto computeSeconds = peakGFlops > 0 ? node.flops / (peakGFlops * 1e9) : 0;
+        auto memorySeconds = peakGBytesPerSecond > 0 ? node.bytes / (peakGBytesPerSecond * 1e9) : 0;
+        efficiencies.push_back({ &node, node.flops / seconds / 1e9, node.bytes / seconds / 1e9, 100.0 * std::max(computeSeconds, memorySeconds) / seconds, computeSeconds >= memorySeconds });
+    }
+
+    if (format == ProfileOutputFormat::text)
+    {
+        std::ios::fmtflags savedFlags(out.flags());
+        out << std::fixed;
+        out.precision(3);
+
+        size_t maxTypeLength = 0;
+        for (const auto& efficiency : efficiencies)
+        {
+            maxTypeLength = std::max(maxTypeLength, efficiency.node->type.size());
+        }
+
+        out << "\nEfficiency statistics (peak " << peakGFlops << " GFLOP/s, " << peakGBytesPerSecond << " GB/s)" << std::endl;
+        for (const auto& efficiency : efficiencies)
+        {
+            out << "Node[" << efficiency.node->name << "]:\t" << std::setw(maxTypeLength) << std::left << efficiency.node->type << std::right
+                << "\tGFLOP/s: " << efficiency.gflops << "\tGB/s: " << efficiency.gbytesPerSecond
+                << "\t% of peak: " << efficiency.percentOfPeak << (efficiency.isComputeBound ? " (compute bound)" : " (memory bound)") << "\n";
+        }
+        out.flags(savedFlags);
+    }
+    else // json
+    {
+        out << "\"efficiency_statistics\": {\n";
+        out << "  \"peak_gflops\": " << peakGFlops << ",\n";
+        out << "  \"peak_gbytes_per_second\": " << peakGBytesPerSecond << ",\n";
+        out << "  \"nodes\": [";
+        for (const auto& efficiency : efficiencies)
+        {
+            out << (&efficiency == &efficiencies.front() ? "\n" : ",\n");
+            out << "    { \"name\": \"" << EncodeJSONString(efficiency.node->name) << "\", \"type\": \"" << EncodeJSONString(efficiency.node->type) << "\""
+                << ", \"gflops\": " << efficiency.gflops << ", \"gbytes_per_second\": " << efficiency.gbytesPerSecond
+                << ", \"percent_of_peak\": " << efficiency.percentOfPeak << ", \"bound\": \"" << (efficiency.isComputeBound ? "compute" : "memory") << "\" }";
+        }
+        out << "\n  ]\n";
+        out << "}";
+    }
+}
@@ -13,6 +13,8 @@
 
 #include <pythonPlugins/include/InvokePython.h>
 
+#include <print/include/CostReport.h>
+
 #include <common/include/LoadModel.h>
 #include <common/include/MapCompilerArguments.h>
 #include <common/include/ModelLoadArguments.h>
@@ -21,24 +23,39 @@
 #include <model/include/IRMapCompiler.h>
 #include <model/include/IRModelProfiler.h>
 #include <model/include/Map.h>
+#include <model/include/ModelProfileData.h>
 #include <model/include/PortMemoryLayout.h>
 
 #include <passes/include/StandardTransformations.h>
 
+#include <utilities/include/Benchmark.h>
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
-#include <utilities/include/MillisecondTimer.h>
 #include <utilities/include/OutputStreamImpostor.h>
 #include <utilities/include/RandomEngines.h>
 #include <utilities/include/TypeName.h>
 #include <utilities/include/Unused.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <numeric>
 #include <random>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
+#if defined(WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
 
 using namespace ell;
 
@@ -111,6 +128,121 @@ std::vector<InputType> GetModelInput(model::Map& map, const ProfileArguments& pr
     }
 }
 
+//
+// Latency and memory measurement
+//
+using LatencyClock = std::chrono::steady_clock;
+
+double GetMilliseconds(LatencyClock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+size_t GetPeakResidentSetSize()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss); // bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
+
+size_t GetPortElementSize(model::Port::PortType type)
+{
+    switch (type)
+    {
+    case model::Port::PortType::smallReal:
+        return sizeof(float);
+    case model::Port::PortType::real:
+        return sizeof(double);
+    case model::Port::PortType::integer:
+        return sizeof(int32_t);
+    case model::Port::PortType::bigInt:
+        return sizeof(int64_t);
+    case model::Port::PortType::boolean:
+        return sizeof(bool);
+    default:
+        return 0;
+    }
+}
+
+// The output buffers of the nodes of the compiled (refined) model
+std::vector<NodeMemoryInfo> GetNodeMemoryInfo(const model::Map& map)
+{
+    std::vector<NodeMemoryInfo> nodes;
+    map.GetModel().Visit([&nodes](const model::Node& node) {
+        size_t bufferSize = 0;
+        for (auto output : node.GetOutputPorts())
+        {
+            bufferSize += output->Size() * GetPortElementSize(output->GetType());
+        }
+        nodes.push_back({ to_string(node.GetId()), node.GetRuntimeTypeName(), bufferSize });
+    });
+    return nodes;
+}
+
+// Combines the static cost estimates of the nodes with their profiled times
+std::vector<NodeEfficiencyInfo> GetNodeEfficiencyInfo(model::IRCompiledMap& map)
+{
+    std::unordered_map<std::string, NodeCost> costs;
+    for (const auto& cost : GetNodeCosts(map.GetModel()))
+    {
+        costs[cost.nodeId] = cost;
+    }
+
+    std::vector<NodeEfficiencyInfo> nodes;
+    auto numNodes = map.GetNumProfiledNodes();
+    for (int index = 0; index < numNodes; ++index)
+    {
+        auto info = map.GetNodeInfo(index);
+        auto stats = map.GetNodePerformanceCounters(index);
+        auto cost = costs.find(info->nodeName);
+        if (cost != costs.end())
+        {
+            auto bytes = static_cast<double>(cost->second.parameterBytes + cost->second.inputBytes + cost->second.activationBytes);
+            nodes.push_back({ info->nodeName, info->nodeType, cost->second.flops, bytes, stats->count, stats->totalTime });
+        }
+    }
+    return nodes;
+}
+
+void WriteEfficiencyStatistics(model::IRCompiledMap& map, const ProfileArguments& profileArguments, const common::MapCompilerArguments& mapCompilerArguments, ProfileOutputFormat format, std::ostream& out)
+{
+    auto device = GetDeviceProfile(mapCompilerArguments.target.empty() ? "host" : mapCompilerArguments.target);
+    auto peakGFlops = profileArguments.peakGFlops > 0 ? profileArguments.peakGFlops : device.peakGFlops;
+    auto peakGBytesPerSecond = profileArguments.peakGBytesPerSecond > 0 ? profileArguments.peakGBytesPerSecond : device.memoryBandwidthGBytesPerSecond;
+    WriteEfficiencyStatistics(GetNodeEfficiencyInfo(map), peakGFlops, peakGBytesPerSecond, format, out);
+}
+
+std::vector<int> ParseCpuList(const std::string& cpus)
+{
+    std::vector<int> result;
+    std::stringstream stream(cpus);
+    std::string cpu;
+    while (std::getline(stream, cpu, ','))
+    {
+        if (!cpu.empty())
+        {
+            result.push_back(std::stoi(cpu));
+        }
+    }
+    return result;
+}
+
 //
 // Output-related
 //
@@ -252,35 +384,100 @@ void TimeModel(model::Map& map, const std::vector<InputType>& input, const Profi
 
     model::ModelOptimizerOptions optimizerOptions;
     optimizerOptions["fuseLinearFunctionNodes"] = true;
-    model::IRMapCompiler compiler(settings, optimizerOptions);
 
-    std::cout << "Compiling model" << std::endl;
-    auto compiledMap = compiler.Compile(map);
+    // Each instance has its own compiled code, so the instances don't share buffers
+    auto numInstances = static_cast<size_t>(std::max(profileArguments.numInstances, 1));
+    std::vector<std::unique_ptr<model::IRMapCompiler>> compilers;
+    std::vector<model::IRCompiledMap> compiledMaps;
+    compiledMaps.reserve(numInstances);
+    std::cout << "Compiling model" << (numInstances > 1 ? " instances" : "") << std::endl;
+    for (size_t instance = 0; instance < numInstances; ++instance)
+    {
+        compilers.push_back(std::make_unique<model::IRMapCompiler>(settings, optimizerOptions));
+        compiledMaps.push_back(compilers.back()->Compile(map));
+    }
 
-    // Warm up the system by evaluating the model some number of times
-    WarmUpModel<InputType, OutputType>(compiledMap, input, profileArguments.numBurnInIterations, false);
+    // Run the instances concurrently, timing each evaluation
+    auto cpus = ParseCpuList(profileArguments.cpus);
+    std::vector<std::vector<double>> instanceLatencies(numInstances);
+    std::vector<LatencyClock::time_point> startTimes(numInstances);
+    std::vector<LatencyClock::time_point> endTimes(numInstances);
+    auto runInstance = [&](size_t instance) {
+        if (!cpus.empty())
+        {
+            utilities::PinThreadToCpu(cpus[instance % cpus.size()]);
+        }
 
-    // Now evaluate the model and time it
-    utilities::MillisecondTimer timer;
-    for (int iter = 0; iter < profileArguments.numIterations; ++iter)
+        // Warm up the system by evaluating the model some number of times
+        auto& compiledMap = compiledMaps[instance];
+        WarmUpModel<InputType, OutputType>(compiledMap, input, profileArguments.numBurnInIterations, false);
+
+        auto& latencies = instanceLatencies[instance];
+        latencies.reserve(profileArguments.numIterations);
+        startTimes[instance] = LatencyClock::now();
+        for (int iter = 0; iter < profileArguments.numIterations; ++iter)
+        {
+            auto start = LatencyClock::now();
+            auto output = compiledMap.Compute<OutputType>(input);
+            latencies.push_back(GetMilliseconds(LatencyClock::now() - start));
+        }
+        endTimes[instance] = LatencyClock::now();
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t instance = 1; instance < numInstances; ++instance)
     {
-        auto output = compiledMap.Compute<OutputType>(input);
+        threads.emplace_back(runInstance, instance);
+    }
+    runInstance(0);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<double> latencies;
+    for (const auto& instance : instanceLatencies)
+    {
+        latencies.insert(latencies.end(), instance.begin(), instance.end());
     }
-    float totalTime = static_cast<float>(timer.Elapsed());
+    auto wallTime = GetMilliseconds(*std::max_element(endTimes.begin(), endTimes.end()) - *std::min_element(startTimes.begin(), startTimes.end()));
+    auto totalTime = std::accumulate(instanceLatencies[0].begin(), instanceLatencies[0].end(), 0.0);
+    auto numIterations = numInstances * static_cast<size_t>(profileArguments.numIterations);
 
-    if (profileArguments.outputFormat == ProfileOutputFormat::text)
+    auto format = profileArguments.outputFormat;
+    if (format == ProfileOutputFormat::text)
     {
         outputStream << "Num iterations: " << profileArguments.numIterations << std::endl;
         outputStream << "Total time: " << totalTime << " ms" << std::endl;
         outputStream << "Average time: " << totalTime / profileArguments.numIterations << " ms" << std::endl;
+        WriteLatencyStatistics(latencies, format, outputStream);
+        if (numInstances > 1)
+        {
+            WriteThroughputStatistics(numInstances, numIterations, wallTime, format, outputStream);
+        }
+        if (profileArguments.memoryReport)
+        {
+            WriteMemoryStatistics(GetPeakResidentSetSize(), GetNodeMemoryInfo(compiledMaps[0]), format, outputStream);
+        }
     }
     else // json
     {
         outputStream << "{\n";
         outputStream << "\"total_time\": " << totalTime << ",\n";
         outputStream << "\"average_time\": " << totalTime / profileArguments.numIterations << ",\n";
-        outputStream << "\"count\": " << profileArguments.numIterations << "\n";
-        outputStream << "}\n";
+        outputStream << "\"count\": " << profileArguments.numIterations << ",\n";
+        WriteLatencyStatistics(latencies, format, outputStream);
+        if (numInstances > 1)
+        {
+            outputStream << ",\n";
+            WriteThroughputStatistics(numInstances, numIterations, wallTime, format, outputStream);
+        }
+        if (profileArguments.memoryReport)
+        {
+            outputStream << ",\n";
+            WriteMemoryStatistics(GetPeakResidentSetSize(), GetNodeMemoryInfo(compiledMaps[0]), format, outputStream);
+        }
+        outputStream << "\n}\n";
     }
 }
 
@@ -302,7 +499,7 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
     // In "summary only" mode, we don't compile the model with profiling enabled
     // (because we just want the overall run time), so we have a separate codepath
     // for that option
-    if (profileArguments.summaryOnly)
+    if (profileArguments.summaryOnly || profileArguments.numInstances > 1)
     {
         TimeModel<InputType, OutputType>(map, input, profileArguments, mapCompilerArguments);
         return;
@@ -331,10 +528,13 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
     WarmUpModel<InputType, OutputType>(compiledMap, input, profileArguments.numBurnInIterations, true);
 
     // Now evaluate the model and record the profiling info
+    std::vector<double> latencies;
     for (int iter = 0; iter < profileArguments.numIterations; ++iter)
     {
         // Exercise the model
+        auto start = LatencyClock::now();
         auto output = compiledMap.Compute<OutputType>(input);
+        latencies.push_back(GetMilliseconds(LatencyClock::now() - start));
 
         if (printTimingChart)
         {
@@ -353,6 +553,11 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
         WriteTimingDetail(timingOutputStream, format, nodeTimings);
     }
 
+    if (!profileArguments.profileDataFilename.empty())
+    {
+        model::SaveModelProfileData(model::ModelProfileData(compiledMap), profileArguments.profileDataFilename);
+    }
+
     // print profile info
     if (format == ProfileOutputFormat::text)
     {
@@ -363,6 +568,15 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
         WriteNodeStatistics(compiledMap, format, profileOutputStream);
         WriteRegionStatistics(compiledMap, format, profileOutputStream);
         WriteModelStatistics(compiledMap, format, profileOutputStream);
+        WriteLatencyStatistics(latencies, format, profileOutputStream);
+        if (profileArguments.memoryReport)
+        {
+            WriteMemoryStatistics(GetPeakResidentSetSize(), GetNodeMemoryInfo(compiledMap), format, profileOutputStream);
+        }
+        if (profileArguments.efficiencyReport)
+        {
+            WriteEfficiencyStatistics(compiledMap, profileArguments, mapCompilerArguments, format, profileOutputStream);
+        }
     }
     else
     {
@@ -377,7 +591,19 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
         WriteRegionStatistics(compiledMap, format, profileOutputStream);
         profileOutputStream << ",\n";
         WriteModelStatistics(compiledMap, format, profileOutputStream);
-        profileOutputStream << "}\n";
+        profileOutputStream << ",\n";
+        WriteLatencyStatistics(latencies, format, profileOutputStream);
+        if (profileArguments.memoryReport)
+        {
+            profileOutputStream << ",\n";
+            WriteMemoryStatistics(GetPeakResidentSetSize(), GetNodeMemoryInfo(compiledMap), format, profileOutputStream);
+        }
+        if (profileArguments.efficiencyReport)
+        {
+            profileOutputStream << ",\n";
+            WriteEfficiencyStatistics(compiledMap, profileArguments, mapCompilerArguments, format, profileOutputStream);
+        }
+        profileOutputStream << "\n}\n";
     }
 }
 
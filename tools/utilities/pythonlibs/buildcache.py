@@ -0,0 +1,114 @@
+####################################################################################################
+#
+#  Project:  Embedded Learning Library (ELL)
+#  File:     buildcache.py
+#  Authors:  Chris Lovett
+#
+#  Requires: Python 3.x
+#
+####################################################################################################
+import hashlib
+import json
+import os
+import shutil
+import sys
+import uuid
+
+sys.path += [os.path.dirname(os.path.abspath(__file__))]
+import logger
+
+# The environment variable that sets the default cache directory
+ELL_BUILD_CACHE = "ELL_BUILD_CACHE"
+
+# Changing what gets stored in a cache entry must change this, so old entries aren't used
+CACHE_VERSION = 1
+
+
+def get_default_cache_dir():
+    """ Returns the cache directory set by the ELL_BUILD_CACHE environment variable, or None """
+    return os.getenv(ELL_BUILD_CACHE, None)
+
+
+class BuildCache:
+    """
+    A content-addressed cache of the files the build tools generate for a model (e.g. the object file, header,
+    and SWIG wrappers made by compile, opt, llc and swig). An entry is keyed on the contents of the model file,
+    the options used to build it, and the versions of the tools, so any change to them makes a new entry.
+    """
+    def __init__(self, cache_dir):
+        self.cache_dir = os.path.abspath(cache_dir)
+        self.logger = logger.get()
+        os.makedirs(self.cache_dir, exist_ok=True)
+
+    def get_key(self, model_file, options, tools=[]):
+        """
+        Returns the key for building 'model_file' with the given options (a dictionary that can be serialized to
+        json), with the given tool executables. The tools are identified by their size and modification time, so a
+        rebuilt tool invalidates the entries it made.
+        """
+        digest = hashlib.sha256()
+        digest.update(str(CACHE_VERSION).encode("utf-8"))
+        with open(model_file, "rb") as f:
+            for chunk in iter(lambda: f.read(1 << 20), b""):
+                digest.update(chunk)
+        digest.update(json.dumps(options, sort_keys=True).encode("utf-8"))
+        for tool in tools:
+            if tool and os.path.isfile(tool):
+                stat = os.stat(tool)
+                digest.update("{}:{}:{}".format(os.path.basename(tool), stat.st_size, stat.st_mtime).encode("utf-8"))
+            else:
+                digest.update(str(tool).encode("utf-8"))
+        return digest.hexdigest()
+
+    def get_entry_dir(self, key):
+        return os.path.join(self.cache_dir, key)
+
+    def contains(self, key):
+        return os.path.isdir(self.get_entry_dir(key))
+
+    def restore(self, key, output_dir):
+        """ Copies the files of a cache entry into output_dir. Returns False if there is no such entry. """
+        entry_dir = self.get_entry_dir(key)
+        if not os.path.isdir(entry_dir):
+            return False
+        os.makedirs(output_dir, exist_ok=True)
+        for name in os.listdir(entry_dir):
+            shutil.copyfile(os.path.join(entry_dir, name), os.path.join(output_dir, name))
+        self.logger.info("restored {} files from build cache entry {}".format(len(os.listdir(entry_dir)), key))
+        return True
+
+    def store(self, key, files):
+        """
+        Stores the given files as the cache entry for the key. The entry is written to a temporary directory that's
+        renamed when it's complete, so concurrent builds and interrupted builds don't leave a partial entry.
+        """
+        entry_dir = self.get_entry_dir(key)
+        if os.path.isdir(entry_dir):
+            return
+        temp_dir = os.path.join(self.cache_dir, "{}.{}.tmp".format(key, uuid.uuid4().hex))
+        os.makedirs(temp_dir)
+        try:
+            for path in files:
+                shutil.copyfile(path, os.path.join(temp_dir, os.path.basename(path)))
+            os.rename(temp_dir, entry_dir)
+            self.logger.info("stored {} files in build cache entry {}".format(len(files), key))
+        except OSError:
+            # another build stored the same entry first
+            shutil.rmtree(temp_dir, ignore_errors=True)
+
+
+def get_modified_files(directory, snapshot):
+    """
+    Returns the files in a directory that are new or modified since the snapshot, which is a previous result of
+    get_snapshot.
+    """
+    current = get_snapshot(directory)
+    return sorted(os.path.join(directory, name) for name, mtime in current.items() if snapshot.get(name) != mtime)
+
+
+def get_snapshot(directory):
+    """ Returns the modification times of the files in a directory, to pass to get_modified_files """
+    if not os.path.isdir(directory):
+        return {}
+    return {name: os.path.getmtime(os.path.join(directory, name)) for name in os.listdir(directory)
+            if os.path.isfile(os.path.join(directory, name))}
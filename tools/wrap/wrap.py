@@ -20,6 +20,7 @@ __script_path = os.path.dirname(os.path.abspath(__file__))
 sys.path += [os.path.join(__script_path, "..", "utilities", "pythonlibs")]
 
 import find_ell
+import buildcache
 import buildtools
 import logger
 
@@ -145,6 +146,13 @@ If '0' or 'g', opt is not run (default '3')",
             "short": "dbg",
             "default": False,
             "help": "emit debug code"
+        },
+        "cache_dir":
+        {
+            "short": "cache",
+            "default": None,
+            "help": "a directory for caching the generated files, which are reused when the model, options and \
+tools haven't changed (default is the ELL_BUILD_CACHE environment variable, if it is set)"
         }
     }
 
@@ -166,6 +174,7 @@ If '0' or 'g', opt is not run (default '3')",
         self.fuse_linear_ops = True
         self.optimize_reorder = True
         self.debug = False
+        self.cache_dir = None
         self.model_name = ""
         self.func_name = "Predict"
         self.objext = "o"
@@ -245,6 +254,7 @@ Please specify a different outdir.".format(self.output_dir + ".py", self.output_
         self.swig = self.language != "cpp"
         self.cpp_header = self.language == "cpp"
         self.compile_args = compile_args
+        self.cache_dir = args.cache_dir or buildcache.get_default_cache_dir()
 
     def find_files(self):
         __script_path = os.path.dirname(os.path.abspath(__file__))
@@ -310,6 +320,49 @@ Please specify a different outdir.".format(self.output_dir + ".py", self.output_
         self.find_files()
         self.copy_files(self.files, "")
         self.copy_files(self.includes, "include")
+        cache = None
+        if self.cache_dir:
+            cache = buildcache.BuildCache(self.cache_dir)
+            key = cache.get_key(self.model_file, self.get_cache_options(), [
+                self.tools.compiler, self.tools.swigexe, self.tools.optexe, self.tools.llcexe])
+        if not cache or not cache.restore(key, self.output_dir):
+            snapshot = buildcache.get_snapshot(self.output_dir)
+            self.generate_code()
+            if cache:
+                cache.store(key, buildcache.get_modified_files(self.output_dir, snapshot))
+        self.create_cmake_file()
+        if self.language == "python":
+            self.create_module_init_file()
+        if self.target == "host":
+            self.logger.info("success, now you can build the '" + self.output_dir + "' folder")
+        else:
+            self.logger.info("success, now copy the '{}' folder to your target machine and build it there".format(
+                self.output_dir))
+
+    def get_cache_options(self):
+        """ Returns the options that change the generated code, for keying the build cache """
+        return {
+            "model_file_base": self.model_file_base,
+            "model_name": self.model_name,
+            "func_name": self.func_name,
+            "target": self.target,
+            "language": self.language,
+            "llvm_format": self.llvm_format,
+            "profile": self.profile,
+            "blas": self.blas and (self.target != "host" or bool(self.tools.blas)),
+            "optimize": self.optimize,
+            "optimization_level": self.optimization_level,
+            "fuse_linear_ops": self.fuse_linear_ops,
+            "optimize_reorder": self.optimize_reorder,
+            "debug": self.debug,
+            "no_opt_tool": self.no_opt_tool,
+            "no_llc_tool": self.no_llc_tool,
+            "objext": self.objext,
+            "compile_args": self.compile_args
+        }
+
+    def generate_code(self):
+        """ Runs compile, swig, opt and llc to generate the code for the model in the output directory """
         out_file = self.tools.compile(
             model_file=self.model_file,
             func_name=self.func_name,
@@ -335,14 +388,6 @@ Please specify a different outdir.".format(self.output_dir + ".py", self.output_
         if not self.no_llc_tool:
             out_file = self.tools.llc(self.output_dir, out_file, self.target, self.optimization_level,
                                       "." + self.objext)
-        self.create_cmake_file()
-        if self.language == "python":
-            self.create_module_init_file()
-        if self.target == "host":
-            self.logger.info("success, now you can build the '" + self.output_dir + "' folder")
-        else:
-            self.logger.info("success, now copy the '{}' folder to your target machine and build it there".format(
-                self.output_dir))
 
 
 if __name__ == "__main__":